@@ -258,6 +258,14 @@ struct iperf_test {
 	int udp_counters_64bit;		/* --use-64-bit-udp-counters */
 	int forceflush;				/* --forceflush - flushing output at every interval */
 	int no_fq_socket_pacing;	/* --no-fq-socket-pacing */
+#ifdef CONFIG_NET_PERF_STATS
+	int netstats;				/* -x option - per-layer receive path timing */
+	struct timeval netstats_start;	/* When the counters were cleared */
+	uint32_t netstats_nrecv;	/* Stream reads that returned data */
+	uint32_t netstats_recv_max;	/* Longest stream read in cycles */
+	uint64_t netstats_recv;		/* Time in stream reads in cycles */
+	uint64_t netstats_wait;		/* Time blocked in select() in cycles */
+#endif
 	int multisend;
 
 	char *json_output_string;	/* rendered JSON output if json_output is set */
@@ -93,6 +93,19 @@
 #include "iperf_units.h"
 #include "iperf_tcp_window_size.h"
 #include "iperf_util.h"
+
+#ifdef CONFIG_NET_PERF_STATS
+#include <tinyara/arch.h>
+#include <tinyara/net/netperf.h>
+
+/* Per-layer receive path counters of the network stack (-x option) */
+
+#define NETSTATS_PATH "/proc/net/stats"
+
+/* Convert cycles of up_perf_gettime() to nanoseconds */
+
+#define NETSTATS_NSEC(c) ((uint64_t)(c) * 1000 / CONFIG_ARCH_PERF_CYCLES_PER_USEC)
+#endif
 #include "iperf_locale.h"
 #include "iperf_version.h"
 
@@ -606,7 +619,7 @@ int iperf_parse_arguments(struct iperf_test *test, int argc, char **argv)
 
 	blksize = 0;
 	server_flag = client_flag = rate_flag = duration_flag = 0;
-	while ((flag = getopt(argc, argv, "p:f:D1VJvsc:t:i:ub:n:k:l:P:Rw:B:M:N46S:L:ZO:F:A:T:C:dI:hX:")) != -1) {
+	while ((flag = getopt(argc, argv, "p:f:D1VJvsc:t:i:ub:n:k:l:P:Rw:B:M:N46S:L:ZO:F:A:T:C:dI:hX:x")) != -1) {
 		switch (flag) {
 		case 'p':
 			test->server_port = atoi(optarg);
@@ -854,6 +867,14 @@ int iperf_parse_arguments(struct iperf_test *test, int argc, char **argv)
 		case 'd':
 			test->debug = 1;
 			break;
+		case 'x':
+#ifdef CONFIG_NET_PERF_STATS
+			test->netstats = 1;
+#else
+			i_errno = IEUNIMP;
+			goto err;
+#endif
+			break;
 		case 'I':
 			test->pidfile = strdup(optarg);
 			server_flag = 1;
@@ -1077,6 +1098,108 @@ int iperf_recv(struct iperf_test *test, fd_set *read_setP)
 	return 0;
 }
 
+/*
+ * select() on the test sockets.  With -x the time blocked waiting for
+ * data is accounted, so that it is not mistaken for application time.
+ */
+int iperf_select(struct iperf_test *test, fd_set *read_setP, fd_set *write_setP, struct timeval *timeout)
+{
+#ifdef CONFIG_NET_PERF_STATS
+	uint32_t start = up_perf_gettime();
+	int result;
+
+	result = select(test->max_fd + 1, read_setP, write_setP, NULL, timeout);
+	if (test->netstats) {
+		test->netstats_wait += up_perf_gettime() - start;
+	}
+
+	return result;
+#else
+	return select(test->max_fd + 1, read_setP, write_setP, NULL, timeout);
+#endif
+}
+
+#ifdef CONFIG_NET_PERF_STATS
+/* Account a stream read that started at 'start' and returned 'r' */
+
+void iperf_netstats_recv(struct iperf_test *test, uint32_t start, int r)
+{
+	uint32_t elapsed;
+
+	if (!test->netstats || r <= 0) {
+		return;
+	}
+
+	elapsed = up_perf_gettime() - start;
+	test->netstats_nrecv++;
+	test->netstats_recv += elapsed;
+	if (elapsed > test->netstats_recv_max) {
+		test->netstats_recv_max = elapsed;
+	}
+}
+
+/* Clear the stack and the local counters at the start of the test */
+
+static void iperf_netstats_start(struct iperf_test *test)
+{
+	int fd;
+
+	fd = open(NETSTATS_PATH, O_WRONLY);
+	if (fd < 0) {
+		warning("cannot open " NETSTATS_PATH);
+	} else {
+		(void)write(fd, "0", 1);
+		close(fd);
+	}
+
+	test->netstats_nrecv = 0;
+	test->netstats_recv_max = 0;
+	test->netstats_recv = 0;
+	test->netstats_wait = 0;
+	(void)gettimeofday(&test->netstats_start, NULL);
+}
+
+/*
+ * Print the stages of the stack followed by the socket reads of iperf and
+ * the time left to the application: the test time not spent in reads nor
+ * blocked in select().
+ */
+static void iperf_netstats_print(struct iperf_test *test)
+{
+	struct timeval now;
+	uint64_t elapsed;
+	uint64_t recv_us;
+	uint64_t wait_us;
+	uint64_t app_us;
+	char buf[128];
+	ssize_t n;
+	int fd;
+
+	iprintf(test, "\nNetwork stack receive path:\n");
+
+	fd = open(NETSTATS_PATH, O_RDONLY);
+	if (fd < 0) {
+		warning("cannot open " NETSTATS_PATH);
+	} else {
+		while ((n = read(fd, buf, sizeof(buf) - 1)) > 0) {
+			buf[n] = '\0';
+			iprintf(test, "%s", buf);
+		}
+		close(fd);
+	}
+
+	(void)gettimeofday(&now, NULL);
+	elapsed = (uint64_t)(now.tv_sec - test->netstats_start.tv_sec) * 1000000 + now.tv_usec - test->netstats_start.tv_usec;
+	recv_us = NETSTATS_NSEC(test->netstats_recv) / 1000;
+	wait_us = NETSTATS_NSEC(test->netstats_wait) / 1000;
+	app_us = elapsed > recv_us + wait_us ? elapsed - recv_us - wait_us : 0;
+
+	iprintf(test, "%-12s %10lu %10lu %10lu %12llu\n", "socket_recv", (unsigned long)test->netstats_nrecv, (unsigned long)(test->netstats_nrecv > 0 ? NETSTATS_NSEC(test->netstats_recv / test->netstats_nrecv) : 0), (unsigned long)NETSTATS_NSEC(test->netstats_recv_max), (unsigned long long)recv_us);
+	iprintf(test, "%-12s %10lu %10lu %10s %12llu\n", "application", (unsigned long)test->netstats_nrecv, (unsigned long)(test->netstats_nrecv > 0 ? app_us * 1000 / test->netstats_nrecv : 0), "-", (unsigned long long)app_us);
+	iprintf(test, "%-12s %10s %10s %10s %12llu\n", "idle", "-", "-", "-", (unsigned long long)wait_us);
+}
+#endif							/* CONFIG_NET_PERF_STATS */
+
 int iperf_init_test(struct iperf_test *test)
 {
 	struct timeval now;
@@ -1097,6 +1220,12 @@ int iperf_init_test(struct iperf_test *test)
 		sp->result->start_time = sp->result->start_time_fixed = now;
 	}
 
+#ifdef CONFIG_NET_PERF_STATS
+	if (test->netstats) {
+		iperf_netstats_start(test);
+	}
+#endif
+
 	if (test->on_test_start) {
 		test->on_test_start(test);
 	}
@@ -2525,6 +2654,12 @@ static void iperf_print_results(struct iperf_test *test)
 				test->server_output_text = NULL;
 			}
 		}
+
+#ifdef CONFIG_NET_PERF_STATS
+		if (test->netstats) {
+			iperf_netstats_print(test);
+		}
+#endif
 	}
 }
 
@@ -230,6 +230,10 @@ int iperf_set_send_state(struct iperf_test *test, signed char state);
 void iperf_check_throttle(struct iperf_stream *sp, struct timeval *nowP);
 int iperf_send(struct iperf_test *, fd_set *) /* __attribute__((hot)) */ ;
 int iperf_recv(struct iperf_test *, fd_set *);
+int iperf_select(struct iperf_test *, fd_set *, fd_set *, struct timeval *);
+#ifdef CONFIG_NET_PERF_STATS
+void iperf_netstats_recv(struct iperf_test *test, uint32_t start, int r);
+#endif
 void iperf_got_sigend(struct iperf_test *test) __attribute__((noreturn));
 void iperf_usage(void);
 void iperf_usage_long(void);
@@ -402,7 +402,7 @@ int iperf_run_client(struct iperf_test *test)
 		memcpy(&write_set, &test->write_set, sizeof(fd_set));
 		(void)gettimeofday(&now, NULL);
 		timeout = tmr_timeout(&now);
-		result = select(test->max_fd + 1, &read_set, &write_set, NULL, timeout);
+		result = iperf_select(test, &read_set, &write_set, timeout);
 		if (result < 0 && errno != EINTR) {
 			i_errno = IESELECT;
 			return -1;
@@ -115,6 +115,9 @@ extern    "C"
 #if defined(HAVE_CPU_AFFINITY)
 								 "  -A, --affinity n/n,m      set CPU affinity\n"
 #endif							/* HAVE_CPU_AFFINITY */
+#if defined(CONFIG_NET_PERF_STATS)
+								 "  -x                        report where the receive path spends its time\n"
+#endif
 								 "  -B, --bind      <host>    bind to a specific interface\n" "  -V, --verbose             more detailed output\n" "  -J, --json                output in JSON format\n" "  --logfile f               send output to a log file\n" "  --forceflush              force flushing output at every interval\n" "  -d, --debug               emit debugging output\n" "  -v, --version             show version information and quit\n" "  -h, --help                show this message and quit\n" "Server specific:\n" "  -s, --server              run in server mode\n" "  -D, --daemon              run the server as a daemon\n" "  -I, --pidfile file        write PID file\n" "  -1, --one-off             handle one client connection then exit\n" "Client specific:\n" "  -c, --client    <host>    run in client mode, connecting to <host>\n"
 #if defined(HAVE_SCTP)
 								 "  --sctp                    use SCTP rather than TCP\n" "  -X, --xbind <name>        bind SCTP association to links\n" "  --nstreams      #         number of SCTP streams\n"
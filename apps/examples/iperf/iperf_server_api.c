@@ -499,7 +499,7 @@ int iperf_run_server(struct iperf_test *test)
 
 		(void)gettimeofday(&now, NULL);
 		timeout = tmr_timeout(&now);
-		result = select(test->max_fd + 1, &read_set, &write_set, NULL, timeout);
+		result = iperf_select(test, &read_set, &write_set, timeout);
 		if (result < 0 && errno != EINTR) {
 			cleanup_server(test);
 			i_errno = IESELECT;
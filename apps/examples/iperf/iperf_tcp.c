@@ -55,6 +55,10 @@
 #include <sys/time.h>
 #include <sys/select.h>
 
+#ifdef CONFIG_NET_PERF_STATS
+#include <tinyara/arch.h>
+#endif
+
 #include "iperf.h"
 #include "iperf_api.h"
 #include "iperf_tcp.h"
@@ -71,8 +75,14 @@
 int iperf_tcp_recv(struct iperf_stream *sp)
 {
 	int r;
+#ifdef CONFIG_NET_PERF_STATS
+	uint32_t start = up_perf_gettime();
+#endif
 
 	r = Nread(sp->socket, sp->buffer, sp->settings->blksize, Ptcp);
+#ifdef CONFIG_NET_PERF_STATS
+	iperf_netstats_recv(sp->test, start, r);
+#endif
 
 	if (r < 0) {
 		return r;
@@ -0,0 +1,635 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/kbench/kbench_main.c
+ *
+ * Kernel microbenchmarks.  Every benchmark takes one latency per sample and
+ * prints one CSV line, in nanoseconds:
+ *
+ *   kbench,<name>,<samples>,<min>,<avg>,<p50>,<p90>,<p99>,<max>
+ *
+ * Timestamps come from the CPU cycle counter (up_perf_gettime()) when the
+ * architecture has one, else from the microsecond counter behind
+ * up_boottime(), else from clock_gettime().  The benchmarks run on threads
+ * of priority CONFIG_EXAMPLES_KBENCH_PRIORITY and above so that the rest of
+ * the system stays out of the way.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <mqueue.h>
+#include <signal.h>
+#include <time.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/boottime.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_KBENCH_SAMPLES
+#define CONFIG_EXAMPLES_KBENCH_SAMPLES 1000
+#endif
+
+#ifndef CONFIG_EXAMPLES_KBENCH_PRIORITY
+#define CONFIG_EXAMPLES_KBENCH_PRIORITY 200
+#endif
+
+#define KBENCH_PRIORITY         CONFIG_EXAMPLES_KBENCH_PRIORITY
+#define KBENCH_STACKSIZE        2048
+
+/* The hardware counters can only be read directly in a flat build */
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+#if defined(CONFIG_ARCH_HAVE_PERF_COUNTER)
+#define KBENCH_CLOCK_NAME       "cycle counter"
+#define KBENCH_TICKS_PER_USEC   CONFIG_ARCH_PERF_CYCLES_PER_USEC
+#define kbench_now()            up_perf_gettime()
+#elif defined(CONFIG_ARCH_HAVE_BOOTTIME)
+#define KBENCH_CLOCK_NAME       "boot time counter"
+#define KBENCH_TICKS_PER_USEC   1
+#define kbench_now()            up_boottime()
+#endif
+#endif
+
+#ifndef KBENCH_CLOCK_NAME
+#define KBENCH_CLOCK_NAME       "clock_gettime"
+#define KBENCH_TICKS_PER_USEC   1
+#endif
+
+/* Timer jitter is measured at the tick rate, on a 10 msec period */
+
+#define KBENCH_TIMER_USEC       (((10000 + CONFIG_USEC_PER_TICK - 1) / CONFIG_USEC_PER_TICK) * CONFIG_USEC_PER_TICK)
+#define KBENCH_TIMER_SIGNO      SIGUSR1
+
+/* Blocks kept allocated by the heap benchmarks */
+
+#define KBENCH_HEAP_SLOTS       32
+#define KBENCH_HEAP_MINSIZE     16
+#define KBENCH_HEAP_MAXSIZE     1024
+
+#define KBENCH_MQ_REQ           "kbench_req"
+#define KBENCH_MQ_RSP           "kbench_rsp"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A benchmark fills samples with up to n latencies, in kbench_now() ticks,
+ * and returns how many it took.
+ */
+
+typedef int (*kbench_fn_t)(FAR uint32_t *samples, int n);
+
+struct kbench_s {
+	FAR const char *name;
+	kbench_fn_t fn;
+};
+
+struct kbench_run_s {
+	FAR const struct kbench_s *bench;
+	FAR uint32_t *samples;
+	int n;
+	int count;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Shared between a benchmark and the threads it starts */
+
+static FAR uint32_t *g_samples;
+static int g_nsamples;
+static volatile int g_index;
+static volatile uint32_t g_stamp;
+static volatile bool g_started;
+static sem_t g_sem;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifndef kbench_now
+static uint32_t kbench_now(void)
+{
+	struct timespec ts;
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+static int kbench_thread(FAR pthread_t *thread, int priority, pthread_startroutine_t entry, pthread_addr_t arg)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	int ret;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	param.sched_priority = priority;
+	pthread_attr_setschedparam(&attr, &param);
+	pthread_attr_setstacksize(&attr, KBENCH_STACKSIZE);
+
+	ret = pthread_create(thread, &attr, entry, arg);
+	pthread_attr_destroy(&attr);
+	return ret;
+}
+
+/* Context switch: two threads of equal priority hand the CPU to each other
+ * with sched_yield(), each sample is one yield and switch.
+ */
+
+static pthread_addr_t kbench_yield_thread(pthread_addr_t arg)
+{
+	uint32_t now;
+
+	while (g_index < g_nsamples) {
+		now = kbench_now();
+		if (g_started) {
+			g_samples[g_index++] = now - g_stamp;
+		}
+		g_started = true;
+		g_stamp = kbench_now();
+		sched_yield();
+	}
+
+	return NULL;
+}
+
+static int kbench_ctxsw(FAR uint32_t *samples, int n)
+{
+	pthread_t threads[2];
+	int i;
+
+	g_samples = samples;
+	g_nsamples = n;
+	g_index = 0;
+	g_started = false;
+
+	/* Same priority as this thread: neither starts before the join */
+
+	for (i = 0; i < 2; i++) {
+		if (kbench_thread(&threads[i], KBENCH_PRIORITY, kbench_yield_thread, NULL) != 0) {
+			g_nsamples = 0;
+			break;
+		}
+	}
+
+	while (--i >= 0) {
+		pthread_join(threads[i], NULL);
+	}
+
+	return g_index;
+}
+
+/* Semaphore wake-up: a higher priority thread blocked in sem_wait() runs as
+ * soon as sem_post() is called, each sample is post to wake-up.
+ */
+
+static pthread_addr_t kbench_sem_thread(pthread_addr_t arg)
+{
+	while (g_index < g_nsamples) {
+		while (sem_wait(&g_sem) != 0) {
+		}
+		g_samples[g_index++] = kbench_now() - g_stamp;
+	}
+
+	return NULL;
+}
+
+static int kbench_sem(FAR uint32_t *samples, int n)
+{
+	pthread_t thread;
+	int i;
+
+	g_samples = samples;
+	g_nsamples = n;
+	g_index = 0;
+	sem_init(&g_sem, 0, 0);
+
+	if (kbench_thread(&thread, KBENCH_PRIORITY + 1, kbench_sem_thread, NULL) != 0) {
+		sem_destroy(&g_sem);
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		g_stamp = kbench_now();
+		sem_post(&g_sem);
+	}
+
+	pthread_join(thread, NULL);
+	sem_destroy(&g_sem);
+	return g_index;
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+/* Message queue round trip: a higher priority thread echoes every message
+ * back on a second queue, each sample is send to reply received.
+ */
+
+static mqd_t kbench_mq_open(FAR const char *name, int oflags)
+{
+	struct mq_attr attr;
+
+	attr.mq_maxmsg = 1;
+	attr.mq_msgsize = sizeof(uint32_t);
+	attr.mq_flags = 0;
+	return mq_open(name, oflags | O_CREAT, 0666, &attr);
+}
+
+static pthread_addr_t kbench_mq_thread(pthread_addr_t arg)
+{
+	uint32_t msg;
+	mqd_t req;
+	mqd_t rsp;
+	int i;
+
+	req = kbench_mq_open(KBENCH_MQ_REQ, O_RDONLY);
+	rsp = kbench_mq_open(KBENCH_MQ_RSP, O_WRONLY);
+
+	/* Ready to receive */
+
+	sem_post(&g_sem);
+
+	for (i = 0; i < g_nsamples; i++) {
+		if (mq_receive(req, (FAR char *)&msg, sizeof(msg), NULL) < 0) {
+			break;
+		}
+		mq_send(rsp, (FAR const char *)&msg, sizeof(msg), 0);
+	}
+
+	mq_close(req);
+	mq_close(rsp);
+	return NULL;
+}
+
+static int kbench_mq(FAR uint32_t *samples, int n)
+{
+	pthread_t thread;
+	uint32_t msg;
+	uint32_t start;
+	mqd_t req;
+	mqd_t rsp;
+	int i;
+
+	g_nsamples = n;
+	sem_init(&g_sem, 0, 0);
+
+	req = kbench_mq_open(KBENCH_MQ_REQ, O_WRONLY);
+	rsp = kbench_mq_open(KBENCH_MQ_RSP, O_RDONLY);
+	if (req == (mqd_t)ERROR || rsp == (mqd_t)ERROR || kbench_thread(&thread, KBENCH_PRIORITY + 1, kbench_mq_thread, NULL) != 0) {
+		n = 0;
+		goto errout;
+	}
+
+	while (sem_wait(&g_sem) != 0) {
+	}
+
+	for (i = 0; i < n; i++) {
+		msg = i;
+		start = kbench_now();
+		if (mq_send(req, (FAR const char *)&msg, sizeof(msg), 0) < 0 || mq_receive(rsp, (FAR char *)&msg, sizeof(msg), NULL) < 0) {
+			break;
+		}
+		samples[i] = kbench_now() - start;
+	}
+
+	n = i;
+	pthread_join(thread, NULL);
+
+errout:
+	if (req != (mqd_t)ERROR) {
+		mq_close(req);
+	}
+	if (rsp != (mqd_t)ERROR) {
+		mq_close(rsp);
+	}
+	mq_unlink(KBENCH_MQ_REQ);
+	mq_unlink(KBENCH_MQ_RSP);
+	sem_destroy(&g_sem);
+	return n;
+}
+#endif
+
+/* Thread life cycle: pthread_create() of a higher priority thread that
+ * returns at once, then pthread_join(); each sample covers both.
+ */
+
+static pthread_addr_t kbench_empty_thread(pthread_addr_t arg)
+{
+	return arg;
+}
+
+static int kbench_pthread(FAR uint32_t *samples, int n)
+{
+	pthread_t thread;
+	uint32_t start;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		start = kbench_now();
+		if (kbench_thread(&thread, KBENCH_PRIORITY + 1, kbench_empty_thread, NULL) != 0) {
+			break;
+		}
+		pthread_join(thread, NULL);
+		samples[i] = kbench_now() - start;
+	}
+
+	return i;
+}
+
+/* Heap: a ring of KBENCH_HEAP_SLOTS blocks of pseudo random sizes, each
+ * sample frees the oldest block and allocates a new one.  Either the
+ * malloc() or the free() is timed.
+ */
+
+static size_t kbench_heap_size(FAR uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return KBENCH_HEAP_MINSIZE + (*seed >> 16) % (KBENCH_HEAP_MAXSIZE - KBENCH_HEAP_MINSIZE);
+}
+
+static int kbench_heap(FAR uint32_t *samples, int n, bool timefree)
+{
+	FAR void *slots[KBENCH_HEAP_SLOTS];
+	uint32_t seed = 0x2545f491;
+	uint32_t start;
+	uint32_t elapsed;
+	size_t size;
+	int slot;
+	int i;
+
+	/* Fill the ring first so that every timed free() has a block */
+
+	for (slot = 0; slot < KBENCH_HEAP_SLOTS; slot++) {
+		slots[slot] = malloc(kbench_heap_size(&seed));
+	}
+
+	for (i = 0; i < n; i++) {
+		slot = i % KBENCH_HEAP_SLOTS;
+		size = kbench_heap_size(&seed);
+
+		start = kbench_now();
+		free(slots[slot]);
+		elapsed = kbench_now() - start;
+
+		start = kbench_now();
+		slots[slot] = malloc(size);
+		if (!timefree) {
+			elapsed = kbench_now() - start;
+		}
+
+		if (slots[slot] == NULL) {
+			break;
+		}
+
+		samples[i] = elapsed;
+	}
+
+	for (slot = 0; slot < KBENCH_HEAP_SLOTS; slot++) {
+		free(slots[slot]);
+	}
+
+	return i;
+}
+
+static int kbench_malloc(FAR uint32_t *samples, int n)
+{
+	return kbench_heap(samples, n, false);
+}
+
+static int kbench_free(FAR uint32_t *samples, int n)
+{
+	return kbench_heap(samples, n, true);
+}
+
+#if !defined(CONFIG_DISABLE_POSIX_TIMERS) && !defined(CONFIG_DISABLE_SIGNALS)
+/* Timer jitter: a periodic POSIX timer, each sample is how far the interval
+ * between two expirations is off the period.
+ */
+
+static int kbench_timer(FAR uint32_t *samples, int n)
+{
+	struct sigevent sev;
+	struct itimerspec its;
+	sigset_t set;
+	sigset_t oset;
+	timer_t timer;
+	uint32_t period = KBENCH_TIMER_USEC * KBENCH_TICKS_PER_USEC;
+	uint32_t last = 0;
+	uint32_t now;
+	uint32_t interval;
+	int i;
+
+	n = n / 10 > 0 ? n / 10 : 1;
+
+	sigemptyset(&set);
+	sigaddset(&set, KBENCH_TIMER_SIGNO);
+	sigprocmask(SIG_BLOCK, &set, &oset);
+
+	memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_SIGNAL;
+	sev.sigev_signo = KBENCH_TIMER_SIGNO;
+	if (timer_create(CLOCK_REALTIME, &sev, &timer) != 0) {
+		sigprocmask(SIG_SETMASK, &oset, NULL);
+		return 0;
+	}
+
+	its.it_value.tv_sec = KBENCH_TIMER_USEC / 1000000;
+	its.it_value.tv_nsec = (KBENCH_TIMER_USEC % 1000000) * 1000;
+	its.it_interval = its.it_value;
+	timer_settime(timer, 0, &its, NULL);
+
+	/* The first expiration only sets the reference */
+
+	for (i = -1; i < n; i++) {
+		if (sigwaitinfo(&set, NULL) < 0) {
+			break;
+		}
+
+		now = kbench_now();
+		if (i >= 0) {
+			interval = now - last;
+			samples[i] = interval > period ? interval - period : period - interval;
+		}
+		last = now;
+	}
+
+	timer_delete(timer);
+	sigprocmask(SIG_SETMASK, &oset, NULL);
+	return i < 0 ? 0 : i;
+}
+#endif
+
+static const struct kbench_s g_benchmarks[] = {
+	{ "ctxsw",   kbench_ctxsw   },
+	{ "sem",     kbench_sem     },
+#ifndef CONFIG_DISABLE_MQUEUE
+	{ "mq",      kbench_mq      },
+#endif
+	{ "pthread", kbench_pthread },
+	{ "malloc",  kbench_malloc  },
+	{ "free",    kbench_free    },
+#if !defined(CONFIG_DISABLE_POSIX_TIMERS) && !defined(CONFIG_DISABLE_SIGNALS)
+	{ "timer",   kbench_timer   },
+#endif
+};
+
+/* Runs a benchmark on a thread of its own at KBENCH_PRIORITY */
+
+static pthread_addr_t kbench_driver(pthread_addr_t arg)
+{
+	FAR struct kbench_run_s *run = (FAR struct kbench_run_s *)arg;
+
+	run->count = run->bench->fn(run->samples, run->n);
+	return NULL;
+}
+
+static int kbench_compare(FAR const void *a, FAR const void *b)
+{
+	uint32_t x = *(FAR const uint32_t *)a;
+	uint32_t y = *(FAR const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static unsigned long kbench_nsec(uint64_t ticks)
+{
+	return (unsigned long)(ticks * 1000 / KBENCH_TICKS_PER_USEC);
+}
+
+static void kbench_report(FAR const char *name, FAR uint32_t *samples, int n)
+{
+	uint64_t sum = 0;
+	int i;
+
+	if (n <= 0) {
+		printf("kbench,%s,0,,,,,,\n", name);
+		return;
+	}
+
+	qsort(samples, n, sizeof(uint32_t), kbench_compare);
+	for (i = 0; i < n; i++) {
+		sum += samples[i];
+	}
+
+	printf("kbench,%s,%d,%lu,%lu,%lu,%lu,%lu,%lu\n", name, n, kbench_nsec(samples[0]), kbench_nsec(sum / n), kbench_nsec(samples[n / 2]), kbench_nsec(samples[n * 90 / 100]), kbench_nsec(samples[n * 99 / 100]), kbench_nsec(samples[n - 1]));
+}
+
+static void kbench_usage(FAR const char *progname)
+{
+	int i;
+
+	printf("Usage: %s [-n samples] [benchmark...]\n", progname);
+	printf("Benchmarks:");
+	for (i = 0; i < sizeof(g_benchmarks) / sizeof(g_benchmarks[0]); i++) {
+		printf(" %s", g_benchmarks[i].name);
+	}
+	printf("\n");
+}
+
+/****************************************************************************
+ * kbench_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int kbench_main(int argc, char *argv[])
+#endif
+{
+	struct kbench_run_s run;
+	pthread_t driver;
+	int nsamples = CONFIG_EXAMPLES_KBENCH_SAMPLES;
+	bool selected;
+	int option;
+	int i;
+	int j;
+
+	while ((option = getopt(argc, argv, "n:h")) != ERROR) {
+		switch (option) {
+		case 'n':
+			nsamples = atoi(optarg);
+			if (nsamples > 0) {
+				break;
+			}
+		/* Fall through */
+
+		default:
+			kbench_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	run.samples = (FAR uint32_t *)malloc(nsamples * sizeof(uint32_t));
+	if (run.samples == NULL) {
+		printf("kbench: no memory for %d samples\n", nsamples);
+		return EXIT_FAILURE;
+	}
+
+	printf("# clock: %s, %d ticks/usec\n", KBENCH_CLOCK_NAME, KBENCH_TICKS_PER_USEC);
+	printf("# kbench,name,samples,min_ns,avg_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+
+	for (i = 0; i < sizeof(g_benchmarks) / sizeof(g_benchmarks[0]); i++) {
+		selected = optind >= argc;
+		for (j = optind; j < argc; j++) {
+			if (strcmp(argv[j], g_benchmarks[i].name) == 0) {
+				selected = true;
+			}
+		}
+
+		if (!selected) {
+			continue;
+		}
+
+		run.bench = &g_benchmarks[i];
+		run.n = nsamples;
+		run.count = 0;
+		if (kbench_thread(&driver, KBENCH_PRIORITY, kbench_driver, (pthread_addr_t)&run) == 0) {
+			pthread_join(driver, NULL);
+		}
+
+		kbench_report(run.bench->name, run.samples, run.count);
+	}
+
+	free(run.samples);
+	return EXIT_SUCCESS;
+}
@@ -962,6 +962,7 @@ int main(int argc, char **argv)
 	int result;
 	coap_tick_t now;
 	coap_queue_t *nextpdu;
+	coap_tick_t delay = 0;
 	coap_pdu_t *pdu;
 	static str server;
 	unsigned short port = COAP_DEFAULT_PORT;
@@ -1146,18 +1147,19 @@ int main(int argc, char **argv)
 		FD_ZERO(&readfds);
 		FD_SET(ctx->sockfd, &readfds);
 
+		coap_ticks(&now);
+		coap_check_retransmit(ctx, now);
 		nextpdu = coap_peek_next(ctx);
 
-		coap_ticks(&now);
-		while (nextpdu && nextpdu->t <= now - ctx->sendqueue_basetime) {
-			coap_retransmit(ctx, coap_pop_next(ctx));
-			nextpdu = coap_peek_next(ctx);
+		if (nextpdu) {
+			/* ticks until the next retransmission */
+			delay = nextpdu->t - (now - ctx->sendqueue_basetime);
 		}
 
-		if (nextpdu && nextpdu->t < min(obs_wait ? obs_wait : max_wait, max_wait) - now) {
+		if (nextpdu && delay < min(obs_wait ? obs_wait : max_wait, max_wait) - now) {
 			/* set timeout if there is a pdu to send */
-			tv.tv_usec = ((nextpdu->t) % COAP_TICKS_PER_SECOND) * 1000000 / COAP_TICKS_PER_SECOND;
-			tv.tv_sec = (nextpdu->t) / COAP_TICKS_PER_SECOND;
+			tv.tv_usec = (delay % COAP_TICKS_PER_SECOND) * 1000000 / COAP_TICKS_PER_SECOND;
+			tv.tv_sec = delay / COAP_TICKS_PER_SECOND;
 		} else {
 			/* check if obs_wait fires before max_wait */
 			if (obs_wait && obs_wait < max_wait) {
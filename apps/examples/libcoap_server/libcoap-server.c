@@ -159,7 +159,7 @@ void hnd_put_time(coap_context_t *ctx, struct coap_resource_t *resource, coap_ad
 	/* if my_clock_base was deleted, we pretend to have no such resource */
 	response->hdr->code = my_clock_base ? COAP_RESPONSE_CODE(204) : COAP_RESPONSE_CODE(201);
 
-	resource->dirty = 1;
+	coap_resource_set_dirty(resource);
 
 	coap_get_data(request, &size, &data);
 
@@ -359,6 +359,7 @@ int main(int argc, char **argv)
 	int result;
 	coap_tick_t now;
 	coap_queue_t *nextpdu;
+	coap_tick_t delay = 0;
 	char *addr_str = NULL;
 	char port_str[NI_MAXSERV] = "5683\0";
 	int opt;
@@ -434,18 +435,19 @@ int main(int argc, char **argv)
 		FD_ZERO(&readfds);
 		FD_SET(ctx->sockfd, &readfds);
 
+		coap_ticks(&now);
+		coap_check_retransmit(ctx, now);
 		nextpdu = coap_peek_next(ctx);
 
-		coap_ticks(&now);
-		while (nextpdu && nextpdu->t <= now - ctx->sendqueue_basetime) {
-			coap_retransmit(ctx, coap_pop_next(ctx));
-			nextpdu = coap_peek_next(ctx);
+		if (nextpdu) {
+			/* ticks until the next retransmission */
+			delay = nextpdu->t - (now - ctx->sendqueue_basetime);
 		}
 
-		if (nextpdu && nextpdu->t <= COAP_RESOURCE_CHECK_TIME) {
+		if (nextpdu && delay <= COAP_RESOURCE_CHECK_TIME * COAP_TICKS_PER_SECOND) {
 			/* set timeout if there is a pdu to send before our automatic timeout occurs */
-			tv.tv_usec = ((nextpdu->t) % COAP_TICKS_PER_SECOND) * 1000000 / COAP_TICKS_PER_SECOND;
-			tv.tv_sec = (nextpdu->t) / COAP_TICKS_PER_SECOND;
+			tv.tv_usec = (delay % COAP_TICKS_PER_SECOND) * 1000000 / COAP_TICKS_PER_SECOND;
+			tv.tv_sec = delay / COAP_TICKS_PER_SECOND;
 			timeout = &tv;
 		} else {
 			tv.tv_usec = 0;
@@ -465,7 +467,7 @@ int main(int argc, char **argv)
 			}
 		} else {				/* timeout */
 			if (time_resource) {
-				time_resource->dirty = 1;
+				coap_resource_set_dirty(time_resource);
 			}
 		}
 
@@ -0,0 +1,917 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/perf_suite/perf_suite_main.c
+ *
+ * Runs every benchmark of this configuration back to back and prints one
+ * report of CSV lines that a script can compare against the report of
+ * another release:
+ *
+ *   perf,info,<key>,<value>            board, chip, version, config, ...
+ *   perf,<section>,<test>,<value>,<unit>
+ *   perf,section,<section>,<ok|fail|skip>,<msec>
+ *   perf,end,<sections failed>
+ *
+ * The kernel and file system sections run kbench and fsbench, whose own
+ * CSV lines ("kbench,..." and "fsbench,...") appear inside the section.
+ * A section whose feature is not in the image reports "skip", so reports
+ * of different configurations still have the same shape.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/version.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#ifdef CONFIG_NET_LWIP_LOOPBACK_INTERFACE
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#ifdef CONFIG_NET_SECURITY_TLS
+#include "tls/config.h"
+#include "tls/aes.h"
+#include "tls/gcm.h"
+#include "tls/sha256.h"
+#include "tls/ssl.h"
+#include "tls/entropy.h"
+#include "tls/ctr_drbg.h"
+#include "tls/certs.h"
+#include "tls/x509_crt.h"
+#include "tls/pk.h"
+#endif
+
+#ifdef CONFIG_NETUTILS_JSON
+#include <apps/netutils/cJSON.h>
+#endif
+
+#ifdef CONFIG_ARASTORAGE
+#include <arastorage/arastorage.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bumped whenever the meaning of an existing line changes */
+
+#define PERF_SUITE_FORMAT       1
+
+#ifndef PERF_SUITE_CONFIG_ID
+#define PERF_SUITE_CONFIG_ID    "unknown"
+#endif
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define PERF_SUITE_CLOCK        CLOCK_MONOTONIC
+#else
+#define PERF_SUITE_CLOCK        CLOCK_REALTIME
+#endif
+
+#define PERF_NET_PORT           5099
+#define PERF_NET_CONNECTS       16
+#define PERF_NET_CHUNK          1460
+
+#define PERF_CRYPTO_CHUNK       1024
+#define PERF_TLS_HANDSHAKES     3
+#define PERF_TLS_PIPESIZE       4096
+
+#define PERF_JSON_ITEMS         64
+#define PERF_JSON_ROUNDS        20
+
+#define PERF_DB_RELATION        "perfsuite"
+#define PERF_DB_QUERYLEN        96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct perf_section_s {
+	FAR const char *name;
+	int (*fn)(void);			/* NULL when not in this configuration */
+};
+
+#ifdef CONFIG_NET_SECURITY_TLS
+/* One direction of the in-memory transport of the TLS handshake */
+
+struct perf_tls_pipe_s {
+	unsigned char buf[PERF_TLS_PIPESIZE];
+	size_t len;
+};
+
+/* One end of it: it sends into the pipe the other end receives from */
+
+struct perf_tls_end_s {
+	FAR struct perf_tls_pipe_s *tx;
+	FAR struct perf_tls_pipe_s *rx;
+};
+#endif
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_EXAMPLES_KBENCH
+extern int kbench_main(int argc, char *argv[]);
+#endif
+#ifdef CONFIG_SYSTEM_FSBENCH
+extern int fsbench_main(int argc, char *argv[]);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t perf_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(PERF_SUITE_CLOCK, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void perf_report(FAR const char *section, FAR const char *test, unsigned long value, FAR const char *unit)
+{
+	printf("perf,%s,%s,%lu,%s\n", section, test, value, unit);
+}
+
+/* KB/s of nbytes done in usec microseconds */
+
+static inline unsigned long perf_kbps(uint64_t nbytes, uint64_t usec)
+{
+	if (usec == 0) {
+		usec = 1;
+	}
+	return (unsigned long)(nbytes * 1000000 / usec / 1024);
+}
+
+#if defined(CONFIG_EXAMPLES_KBENCH) || defined(CONFIG_SYSTEM_FSBENCH)
+/* Runs the entry point of another application inline, so that its output
+ * lands inside the section.  getopt() is reset for it first.
+ */
+
+static int perf_run(int (*entry)(int argc, char *argv[]), int argc, FAR char **argv)
+{
+	optind = -1;
+	return entry(argc, argv) == EXIT_SUCCESS ? OK : ERROR;
+}
+#endif
+
+/****************************************************************************
+ * Kernel
+ ****************************************************************************/
+
+#ifdef CONFIG_EXAMPLES_KBENCH
+static int perf_kernel(void)
+{
+	FAR char *argv[] = { "kbench", NULL };
+
+	return perf_run(kbench_main, 1, argv);
+}
+#endif
+
+/****************************************************************************
+ * File system
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_FSBENCH
+static int perf_fs(void)
+{
+	FAR char *argv[] = { "fsbench", "-d", CONFIG_EXAMPLES_PERF_SUITE_FSDIR, NULL };
+
+	return perf_run(fsbench_main, 3, argv);
+}
+#endif
+
+/****************************************************************************
+ * Network: TCP over the loopback interface
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LWIP_LOOPBACK_INTERFACE
+/* Accepts PERF_NET_CONNECTS connections that are closed right away, then
+ * one that streams CONFIG_EXAMPLES_PERF_SUITE_NETBYTES bytes and gets a
+ * byte back once all of them are in.
+ */
+
+static pthread_addr_t perf_net_server(pthread_addr_t arg)
+{
+	static char buf[PERF_NET_CHUNK];
+	int listenfd = (int)arg;
+	size_t total;
+	ssize_t n;
+	int fd;
+	int i;
+
+	for (i = 0; i < PERF_NET_CONNECTS; i++) {
+		fd = accept(listenfd, NULL, NULL);
+		if (fd < 0) {
+			return (pthread_addr_t)ERROR;
+		}
+		close(fd);
+	}
+
+	fd = accept(listenfd, NULL, NULL);
+	if (fd < 0) {
+		return (pthread_addr_t)ERROR;
+	}
+
+	for (total = 0; total < CONFIG_EXAMPLES_PERF_SUITE_NETBYTES; total += n) {
+		n = recv(fd, buf, sizeof(buf), 0);
+		if (n <= 0) {
+			break;
+		}
+	}
+
+	n = send(fd, buf, 1, 0);
+	close(fd);
+	return (pthread_addr_t)(n == 1 ? OK : ERROR);
+}
+
+static int perf_net_connect(FAR const struct sockaddr_in *addr)
+{
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return ERROR;
+	}
+
+	if (connect(fd, (FAR const struct sockaddr *)addr, sizeof(*addr)) < 0) {
+		close(fd);
+		return ERROR;
+	}
+
+	return fd;
+}
+
+static int perf_net(void)
+{
+	static char buf[PERF_NET_CHUNK];
+	struct sockaddr_in addr;
+	pthread_addr_t status;
+	pthread_t server;
+	uint64_t start;
+	uint64_t usec;
+	size_t total;
+	ssize_t n;
+	int listenfd;
+	int ret = ERROR;
+	int fd;
+	int i;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PERF_NET_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenfd < 0) {
+		return ERROR;
+	}
+
+	if (bind(listenfd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenfd, 1) < 0) {
+		close(listenfd);
+		return ERROR;
+	}
+
+	if (pthread_create(&server, NULL, perf_net_server, (pthread_addr_t)listenfd) != 0) {
+		close(listenfd);
+		return ERROR;
+	}
+
+	start = perf_usec();
+	for (i = 0; i < PERF_NET_CONNECTS; i++) {
+		fd = perf_net_connect(&addr);
+		if (fd < 0) {
+			goto errout;
+		}
+		close(fd);
+	}
+	usec = perf_usec() - start;
+	perf_report("net", "tcp_connect", (unsigned long)(usec / PERF_NET_CONNECTS), "usec");
+
+	fd = perf_net_connect(&addr);
+	if (fd < 0) {
+		goto errout;
+	}
+
+	memset(buf, 0x5a, sizeof(buf));
+	start = perf_usec();
+	for (total = 0; total < CONFIG_EXAMPLES_PERF_SUITE_NETBYTES; total += n) {
+		n = send(fd, buf, sizeof(buf), 0);
+		if (n <= 0) {
+			break;
+		}
+	}
+
+	if (total >= CONFIG_EXAMPLES_PERF_SUITE_NETBYTES && recv(fd, buf, 1, 0) == 1) {
+		usec = perf_usec() - start;
+		perf_report("net", "tcp_stream", perf_kbps(total, usec), "KB/s");
+		ret = OK;
+	}
+	close(fd);
+
+errout:
+	/* A server still waiting in accept() for a client that failed to
+	 * connect would wait forever
+	 */
+
+	if (ret != OK) {
+		pthread_cancel(server);
+	}
+
+	pthread_join(server, &status);
+	close(listenfd);
+	return ret == OK && status == (pthread_addr_t)OK ? OK : ERROR;
+}
+#endif
+
+/****************************************************************************
+ * Crypto: mbedTLS
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SECURITY_TLS
+static int perf_crypto_aes_cbc(FAR unsigned char *buf)
+{
+	mbedtls_aes_context aes;
+	unsigned char key[16];
+	unsigned char iv[16];
+	uint64_t start;
+	size_t done;
+	int ret = OK;
+
+	memset(key, 0x11, sizeof(key));
+	memset(iv, 0x22, sizeof(iv));
+	mbedtls_aes_init(&aes);
+	mbedtls_aes_setkey_enc(&aes, key, 128);
+
+	start = perf_usec();
+	for (done = 0; done < CONFIG_EXAMPLES_PERF_SUITE_CRYPTOBYTES && ret == OK; done += PERF_CRYPTO_CHUNK) {
+		ret = mbedtls_aes_crypt_cbc(&aes, MBEDTLS_AES_ENCRYPT, PERF_CRYPTO_CHUNK, iv, buf, buf);
+	}
+	if (ret == OK) {
+		perf_report("crypto", "aes128_cbc", perf_kbps(done, perf_usec() - start), "KB/s");
+	}
+
+	mbedtls_aes_free(&aes);
+	return ret;
+}
+
+#ifdef MBEDTLS_GCM_C
+static int perf_crypto_aes_gcm(FAR unsigned char *buf)
+{
+	mbedtls_gcm_context gcm;
+	unsigned char key[16];
+	unsigned char iv[12];
+	unsigned char tag[16];
+	uint64_t start;
+	size_t done;
+	int ret;
+
+	memset(key, 0x33, sizeof(key));
+	memset(iv, 0x44, sizeof(iv));
+	mbedtls_gcm_init(&gcm);
+	ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 128);
+
+	start = perf_usec();
+	for (done = 0; done < CONFIG_EXAMPLES_PERF_SUITE_CRYPTOBYTES && ret == OK; done += PERF_CRYPTO_CHUNK) {
+		ret = mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, PERF_CRYPTO_CHUNK, iv, sizeof(iv), NULL, 0, buf, buf, sizeof(tag), tag);
+	}
+	if (ret == OK) {
+		perf_report("crypto", "aes128_gcm", perf_kbps(done, perf_usec() - start), "KB/s");
+	}
+
+	mbedtls_gcm_free(&gcm);
+	return ret;
+}
+#endif
+
+static int perf_crypto_sha256(FAR const unsigned char *buf)
+{
+	mbedtls_sha256_context sha;
+	unsigned char digest[32];
+	uint64_t start;
+	size_t done;
+
+	mbedtls_sha256_init(&sha);
+
+	start = perf_usec();
+	mbedtls_sha256_starts(&sha, 0);
+	for (done = 0; done < CONFIG_EXAMPLES_PERF_SUITE_CRYPTOBYTES; done += PERF_CRYPTO_CHUNK) {
+		mbedtls_sha256_update(&sha, buf, PERF_CRYPTO_CHUNK);
+	}
+	mbedtls_sha256_finish(&sha, digest);
+	perf_report("crypto", "sha256", perf_kbps(done, perf_usec() - start), "KB/s");
+
+	mbedtls_sha256_free(&sha);
+	return OK;
+}
+
+#if defined(MBEDTLS_CERTS_C) && defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C)
+/* Both ends of the handshake run on this task, each one stepping until it
+ * has to wait for the other, over a pair of memory buffers.  No network
+ * is involved, so this times the crypto of the handshake alone.
+ */
+
+static struct perf_tls_pipe_s g_tls_pipe[2];
+static struct perf_tls_end_s g_tls_client = { &g_tls_pipe[0], &g_tls_pipe[1] };
+static struct perf_tls_end_s g_tls_server = { &g_tls_pipe[1], &g_tls_pipe[0] };
+
+static int perf_tls_send(FAR void *ctx, FAR const unsigned char *buf, size_t len)
+{
+	FAR struct perf_tls_pipe_s *pipe = ((FAR struct perf_tls_end_s *)ctx)->tx;
+
+	if (len > sizeof(pipe->buf) - pipe->len) {
+		len = sizeof(pipe->buf) - pipe->len;
+		if (len == 0) {
+			return MBEDTLS_ERR_SSL_WANT_WRITE;
+		}
+	}
+
+	memcpy(pipe->buf + pipe->len, buf, len);
+	pipe->len += len;
+	return len;
+}
+
+static int perf_tls_recv(FAR void *ctx, FAR unsigned char *buf, size_t len)
+{
+	FAR struct perf_tls_pipe_s *pipe = ((FAR struct perf_tls_end_s *)ctx)->rx;
+
+	if (pipe->len == 0) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	if (len > pipe->len) {
+		len = pipe->len;
+	}
+
+	memcpy(buf, pipe->buf, len);
+	pipe->len -= len;
+	memmove(pipe->buf, pipe->buf + len, pipe->len);
+	return len;
+}
+
+static bool perf_tls_fatal(int ret)
+{
+	return ret != 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+static int perf_crypto_tls(void)
+{
+	FAR const char *pers = "perf_suite";
+	mbedtls_entropy_context entropy;
+	mbedtls_ctr_drbg_context drbg;
+	mbedtls_ssl_config ccfg;
+	mbedtls_ssl_config scfg;
+	mbedtls_ssl_context cli;
+	mbedtls_ssl_context srv;
+	mbedtls_x509_crt crt;
+	mbedtls_pk_context key;
+	uint64_t usec = 0;
+	uint64_t start;
+	int cret;
+	int sret;
+	int ret;
+	int i;
+
+	mbedtls_entropy_init(&entropy);
+	mbedtls_ctr_drbg_init(&drbg);
+	mbedtls_ssl_config_init(&ccfg);
+	mbedtls_ssl_config_init(&scfg);
+	mbedtls_ssl_init(&cli);
+	mbedtls_ssl_init(&srv);
+	mbedtls_x509_crt_init(&crt);
+	mbedtls_pk_init(&key);
+
+	ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, (FAR const unsigned char *)pers, strlen(pers));
+	if (ret == 0) {
+		ret = mbedtls_x509_crt_parse(&crt, (FAR const unsigned char *)mbedtls_test_srv_crt, mbedtls_test_srv_crt_len);
+	}
+	if (ret == 0) {
+		ret = mbedtls_pk_parse_key(&key, (FAR const unsigned char *)mbedtls_test_srv_key, mbedtls_test_srv_key_len, NULL, 0);
+	}
+	if (ret == 0) {
+		ret = mbedtls_ssl_config_defaults(&ccfg, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+	}
+	if (ret == 0) {
+		ret = mbedtls_ssl_config_defaults(&scfg, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+	}
+	if (ret == 0) {
+		ret = mbedtls_ssl_conf_own_cert(&scfg, &crt, &key);
+	}
+	if (ret != 0) {
+		goto errout;
+	}
+
+	mbedtls_ssl_conf_authmode(&ccfg, MBEDTLS_SSL_VERIFY_NONE);
+	mbedtls_ssl_conf_rng(&ccfg, mbedtls_ctr_drbg_random, &drbg);
+	mbedtls_ssl_conf_rng(&scfg, mbedtls_ctr_drbg_random, &drbg);
+
+	ret = mbedtls_ssl_setup(&cli, &ccfg);
+	if (ret == 0) {
+		ret = mbedtls_ssl_setup(&srv, &scfg);
+	}
+	if (ret != 0) {
+		goto errout;
+	}
+
+	mbedtls_ssl_set_bio(&cli, &g_tls_client, perf_tls_send, perf_tls_recv, NULL);
+	mbedtls_ssl_set_bio(&srv, &g_tls_server, perf_tls_send, perf_tls_recv, NULL);
+
+	for (i = 0; i < PERF_TLS_HANDSHAKES && ret == 0; i++) {
+		g_tls_pipe[0].len = 0;
+		g_tls_pipe[1].len = 0;
+
+		start = perf_usec();
+		do {
+			cret = mbedtls_ssl_handshake(&cli);
+			sret = mbedtls_ssl_handshake(&srv);
+		} while ((cret != 0 || sret != 0) && !perf_tls_fatal(cret) && !perf_tls_fatal(sret));
+		usec += perf_usec() - start;
+
+		ret = perf_tls_fatal(cret) ? cret : sret;
+		if (ret == 0) {
+			ret = mbedtls_ssl_session_reset(&cli);
+		}
+		if (ret == 0) {
+			ret = mbedtls_ssl_session_reset(&srv);
+		}
+	}
+
+	if (ret == 0) {
+		perf_report("crypto", "tls_handshake", (unsigned long)(usec / PERF_TLS_HANDSHAKES / 1000), "msec");
+	}
+
+errout:
+	mbedtls_ssl_free(&srv);
+	mbedtls_ssl_free(&cli);
+	mbedtls_ssl_config_free(&scfg);
+	mbedtls_ssl_config_free(&ccfg);
+	mbedtls_pk_free(&key);
+	mbedtls_x509_crt_free(&crt);
+	mbedtls_ctr_drbg_free(&drbg);
+	mbedtls_entropy_free(&entropy);
+	return ret;
+}
+#endif
+
+static int perf_crypto(void)
+{
+	FAR unsigned char *buf;
+	int ret;
+
+	buf = (FAR unsigned char *)malloc(PERF_CRYPTO_CHUNK);
+	if (buf == NULL) {
+		return ERROR;
+	}
+	memset(buf, 0xa5, PERF_CRYPTO_CHUNK);
+
+	ret = perf_crypto_aes_cbc(buf);
+#ifdef MBEDTLS_GCM_C
+	ret |= perf_crypto_aes_gcm(buf);
+#endif
+	ret |= perf_crypto_sha256(buf);
+	free(buf);
+
+#if defined(MBEDTLS_CERTS_C) && defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C)
+	ret |= perf_crypto_tls();
+#endif
+	return ret == 0 ? OK : ERROR;
+}
+#endif
+
+/****************************************************************************
+ * JSON: cJSON
+ ****************************************************************************/
+
+#ifdef CONFIG_NETUTILS_JSON
+/* A document the size of a typical device state report */
+
+static FAR cJSON *perf_json_build(void)
+{
+	FAR cJSON *root;
+	FAR cJSON *items;
+	FAR cJSON *item;
+	char name[16];
+	int i;
+
+	root = cJSON_CreateObject();
+	items = cJSON_CreateArray();
+	if (root == NULL || items == NULL) {
+		cJSON_Delete(root);
+		cJSON_Delete(items);
+		return NULL;
+	}
+
+	cJSON_AddStringToObject(root, "device", "perf_suite");
+	cJSON_AddNumberToObject(root, "format", PERF_SUITE_FORMAT);
+	cJSON_AddItemToObject(root, "items", items);
+
+	for (i = 0; i < PERF_JSON_ITEMS; i++) {
+		item = cJSON_CreateObject();
+		if (item == NULL) {
+			cJSON_Delete(root);
+			return NULL;
+		}
+
+		snprintf(name, sizeof(name), "sensor%d", i);
+		cJSON_AddStringToObject(item, "name", name);
+		cJSON_AddNumberToObject(item, "value", i * 37);
+		cJSON_AddItemToObject(item, "valid", cJSON_CreateBool(i & 1));
+		cJSON_AddItemToArray(items, item);
+	}
+
+	return root;
+}
+
+static int perf_json(void)
+{
+	FAR cJSON *root;
+	FAR char *text;
+	uint64_t parse = 0;
+	uint64_t print = 0;
+	uint64_t start;
+	size_t len;
+	int ret = OK;
+	int i;
+
+	root = perf_json_build();
+	if (root == NULL) {
+		return ERROR;
+	}
+
+	text = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+	if (text == NULL) {
+		return ERROR;
+	}
+	len = strlen(text);
+
+	for (i = 0; i < PERF_JSON_ROUNDS; i++) {
+		FAR char *out;
+
+		start = perf_usec();
+		root = cJSON_Parse(text);
+		parse += perf_usec() - start;
+		if (root == NULL) {
+			ret = ERROR;
+			break;
+		}
+
+		start = perf_usec();
+		out = cJSON_PrintUnformatted(root);
+		print += perf_usec() - start;
+		cJSON_Delete(root);
+		if (out == NULL) {
+			ret = ERROR;
+			break;
+		}
+		free(out);
+	}
+	free(text);
+
+	if (ret == OK) {
+		perf_report("json", "parse", perf_kbps((uint64_t)len * PERF_JSON_ROUNDS, parse), "KB/s");
+		perf_report("json", "print", perf_kbps((uint64_t)len * PERF_JSON_ROUNDS, print), "KB/s");
+	}
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Arastorage
+ ****************************************************************************/
+
+#ifdef CONFIG_ARASTORAGE
+static int perf_db_exec(FAR const char *query)
+{
+	char buf[PERF_DB_QUERYLEN];
+
+	strncpy(buf, query, sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = '\0';
+	return DB_SUCCESS(db_exec(buf)) ? OK : ERROR;
+}
+
+static int perf_db(void)
+{
+	char query[PERF_DB_QUERYLEN];
+	FAR db_cursor_t *cursor;
+	FAR db_stmt_t *stmt;
+	db_result_t res;
+	uint64_t start;
+	uint64_t usec;
+	int rows = 0;
+	int ret = ERROR;
+	int i;
+
+	if (DB_ERROR(db_init())) {
+		return ERROR;
+	}
+
+	/* Left over by an interrupted run, if any */
+
+	perf_db_exec("REMOVE RELATION " PERF_DB_RELATION ";");
+
+	if (perf_db_exec("CREATE RELATION " PERF_DB_RELATION ";") != OK ||
+		perf_db_exec("CREATE ATTRIBUTE id DOMAIN int IN " PERF_DB_RELATION ";") != OK ||
+		perf_db_exec("CREATE ATTRIBUTE value DOMAIN long IN " PERF_DB_RELATION ";") != OK ||
+		perf_db_exec("CREATE INDEX " PERF_DB_RELATION ".id TYPE bplustree;") != OK) {
+		goto errout;
+	}
+
+	strncpy(query, "INSERT (?, ?) INTO " PERF_DB_RELATION ";", sizeof(query));
+	stmt = db_prepare(query);
+	if (stmt == NULL) {
+		goto errout;
+	}
+
+	start = perf_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_PERF_SUITE_ROWS; i++) {
+		if (DB_ERROR(db_bind_int(stmt, 0, i)) || DB_ERROR(db_bind_long(stmt, 1, (long)i * 7)) || DB_ERROR(db_stmt_exec(stmt))) {
+			break;
+		}
+	}
+	usec = perf_usec() - start;
+	db_finalize(stmt);
+	if (i < CONFIG_EXAMPLES_PERF_SUITE_ROWS) {
+		goto errout;
+	}
+	perf_report("db", "insert", (unsigned long)(usec / CONFIG_EXAMPLES_PERF_SUITE_ROWS), "usec/row");
+
+	snprintf(query, sizeof(query), "SELECT id, value FROM %s WHERE id >= %d;", PERF_DB_RELATION, CONFIG_EXAMPLES_PERF_SUITE_ROWS / 2);
+	start = perf_usec();
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		goto errout;
+	}
+	for (res = cursor_move_first(cursor); DB_SUCCESS(res); res = cursor_move_next(cursor)) {
+		cursor_get_int_value(cursor, 0);
+		rows++;
+	}
+	usec = perf_usec() - start;
+	db_cursor_free(cursor);
+
+	if (rows == CONFIG_EXAMPLES_PERF_SUITE_ROWS - CONFIG_EXAMPLES_PERF_SUITE_ROWS / 2) {
+		perf_report("db", "select", (unsigned long)usec, "usec");
+		ret = OK;
+	}
+
+errout:
+	perf_db_exec("REMOVE RELATION " PERF_DB_RELATION ";");
+	db_deinit();
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* In the order they run; the names are those of the report */
+
+static const struct perf_section_s g_sections[] = {
+#ifdef CONFIG_EXAMPLES_KBENCH
+	{ "kernel", perf_kernel },
+#else
+	{ "kernel", NULL },
+#endif
+#ifdef CONFIG_SYSTEM_FSBENCH
+	{ "fs", perf_fs },
+#else
+	{ "fs", NULL },
+#endif
+#ifdef CONFIG_NET_LWIP_LOOPBACK_INTERFACE
+	{ "net", perf_net },
+#else
+	{ "net", NULL },
+#endif
+#ifdef CONFIG_NET_SECURITY_TLS
+	{ "crypto", perf_crypto },
+#else
+	{ "crypto", NULL },
+#endif
+#ifdef CONFIG_NETUTILS_JSON
+	{ "json", perf_json },
+#else
+	{ "json", NULL },
+#endif
+#ifdef CONFIG_ARASTORAGE
+	{ "db", perf_db },
+#else
+	{ "db", NULL },
+#endif
+};
+
+#define PERF_NSECTIONS (sizeof(g_sections) / sizeof(g_sections[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void perf_info(void)
+{
+	printf("perf,info,format,%d\n", PERF_SUITE_FORMAT);
+	printf("perf,info,board,%s\n", CONFIG_ARCH_BOARD);
+	printf("perf,info,chip,%s\n", CONFIG_ARCH_CHIP);
+	printf("perf,info,version,%s\n", CONFIG_VERSION_STRING);
+	printf("perf,info,build,%s\n", CONFIG_VERSION_BUILD);
+	printf("perf,info,config,%s\n", PERF_SUITE_CONFIG_ID);
+	printf("perf,info,tick_usec,%d\n", CONFIG_USEC_PER_TICK);
+}
+
+static void perf_usage(FAR const char *progname)
+{
+	int i;
+
+	printf("Usage: %s [section...]\n", progname);
+	printf("Sections:");
+	for (i = 0; i < PERF_NSECTIONS; i++) {
+		printf(" %s", g_sections[i].name);
+	}
+	printf("\nAll of them run when none is given.\n");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int perf_suite_main(int argc, char *argv[])
+{
+	FAR const struct perf_section_s *section;
+	FAR const char *status;
+	uint64_t start;
+	int failed = 0;
+	bool selected;
+	int i;
+	int j;
+
+	for (j = 1; j < argc; j++) {
+		for (i = 0; i < PERF_NSECTIONS; i++) {
+			if (strcmp(argv[j], g_sections[i].name) == 0) {
+				break;
+			}
+		}
+		if (i == PERF_NSECTIONS) {
+			perf_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	perf_info();
+
+	for (i = 0; i < PERF_NSECTIONS; i++) {
+		section = &g_sections[i];
+
+		selected = argc < 2;
+		for (j = 1; j < argc; j++) {
+			selected |= strcmp(argv[j], section->name) == 0;
+		}
+		if (!selected) {
+			continue;
+		}
+
+		start = perf_usec();
+		if (section->fn == NULL) {
+			status = "skip";
+		} else if (section->fn() == OK) {
+			status = "ok";
+		} else {
+			status = "fail";
+			failed++;
+		}
+
+		printf("perf,section,%s,%s,%lu\n", section->name, status, (unsigned long)((perf_usec() - start) / 1000));
+		fflush(stdout);
+	}
+
+	printf("perf,end,%d\n", failed);
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
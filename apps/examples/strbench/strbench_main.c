@@ -0,0 +1,311 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/strbench/strbench_main.c
+ *
+ * Measures the throughput of the string functions linked into the image
+ * (the generic C ones, or the assembly ones selected by CONFIG_ARCH_xxx)
+ * next to a byte loop doing the same work.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STRBENCH_BUFSIZE     4096
+#define STRBENCH_BYTES       (1024 * 1024)	/* Bytes processed per test */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define STRBENCH_CLOCK       CLOCK_MONOTONIC
+#else
+#define STRBENCH_CLOCK       CLOCK_REALTIME
+#endif
+
+/* Keep the compiler from turning the reference loops into library calls */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define STRBENCH_NOLIB       __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+#else
+#define STRBENCH_NOLIB       __attribute__((noinline))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every test runs one call of the function under test on len bytes at
+ * the given source and destination misalignments.
+ */
+
+typedef int (*strbench_fn_t)(FAR char *dst, FAR char *src, size_t len, int lib);
+
+struct strbench_test_s {
+	FAR const char *name;
+	strbench_fn_t fn;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static char g_src[STRBENCH_BUFSIZE + 8] __attribute__((aligned(8)));
+static char g_dst[STRBENCH_BUFSIZE + 8] __attribute__((aligned(8)));
+
+static const size_t g_sizes[] = { 8, 32, 128, 512, 2048 };
+
+static const int g_misalign[][2] = {
+	{ 0, 0 }, { 1, 1 }, { 0, 3 },
+};
+
+/* Called through volatile pointers so that small constant sizes are not
+ * expanded inline by the compiler.
+ */
+
+static FAR void *(*volatile g_memcpy)(FAR void *, FAR const void *, size_t) = memcpy;
+static FAR void *(*volatile g_memset)(FAR void *, int, size_t) = memset;
+static int (*volatile g_memcmp)(FAR const void *, FAR const void *, size_t) = memcmp;
+static FAR void *(*volatile g_memmove)(FAR void *, FAR const void *, size_t) = memmove;
+static size_t (*volatile g_strlen)(FAR const char *) = strlen;
+static int (*volatile g_strcmp)(FAR const char *, FAR const char *) = strcmp;
+static FAR char *(*volatile g_strchr)(FAR const char *, int) = strchr;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static STRBENCH_NOLIB void byte_memcpy(FAR char *dst, FAR const char *src, size_t len)
+{
+	while (len-- > 0) {
+		*dst++ = *src++;
+	}
+}
+
+static STRBENCH_NOLIB void byte_memset(FAR char *dst, int c, size_t len)
+{
+	while (len-- > 0) {
+		*dst++ = c;
+	}
+}
+
+static STRBENCH_NOLIB void byte_memmove(FAR char *dst, FAR const char *src, size_t len)
+{
+	while (len-- > 0) {
+		dst[len] = src[len];
+	}
+}
+
+static STRBENCH_NOLIB int byte_memcmp(FAR const char *s1, FAR const char *s2, size_t len)
+{
+	for (; len > 0; len--, s1++, s2++) {
+		if (*s1 != *s2) {
+			return (unsigned char)*s1 - (unsigned char)*s2;
+		}
+	}
+
+	return 0;
+}
+
+static STRBENCH_NOLIB size_t byte_strlen(FAR const char *s)
+{
+	FAR const char *p = s;
+
+	while (*p) {
+		p++;
+	}
+
+	return p - s;
+}
+
+static STRBENCH_NOLIB int byte_strcmp(FAR const char *s1, FAR const char *s2)
+{
+	while (*s1 && *s1 == *s2) {
+		s1++;
+		s2++;
+	}
+
+	return (unsigned char)*s1 - (unsigned char)*s2;
+}
+
+static STRBENCH_NOLIB FAR char *byte_strchr(FAR const char *s, int c)
+{
+	for (; *s != (char)c; s++) {
+		if (*s == '\0') {
+			return NULL;
+		}
+	}
+
+	return (FAR char *)s;
+}
+
+static int test_memcpy(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	if (lib) {
+		g_memcpy(dst, src, len);
+	} else {
+		byte_memcpy(dst, src, len);
+	}
+
+	return dst[len - 1];
+}
+
+static int test_memset(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	if (lib) {
+		g_memset(dst, 0x5a, len);
+	} else {
+		byte_memset(dst, 0x5a, len);
+	}
+
+	return dst[len - 1];
+}
+
+static int test_memcmp(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	return lib ? g_memcmp(dst, src, len) : byte_memcmp(dst, src, len);
+}
+
+static int test_memmove(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	/* Overlapping move towards higher addresses, the backward case */
+
+	if (lib) {
+		g_memmove(dst + 1, dst, len - 1);
+	} else {
+		byte_memmove(dst + 1, dst, len - 1);
+	}
+
+	return dst[len - 1];
+}
+
+static int test_strlen(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	return lib ? g_strlen(src) : byte_strlen(src);
+}
+
+static int test_strcmp(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	return lib ? g_strcmp(dst, src) : byte_strcmp(dst, src);
+}
+
+static int test_strchr(FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	return (lib ? g_strchr(src, '!') : byte_strchr(src, '!')) != NULL;
+}
+
+static const struct strbench_test_s g_tests[] = {
+	{ "memcpy",  test_memcpy  },
+	{ "memset",  test_memset  },
+	{ "memcmp",  test_memcmp  },
+	{ "memmove", test_memmove },
+	{ "strlen",  test_strlen  },
+	{ "strcmp",  test_strcmp  },
+	{ "strchr",  test_strchr  },
+};
+
+/* Fill both buffers with equal strings of len - 1 characters, so that the
+ * compare functions run to the end and strchr() finds nothing.
+ */
+
+static void strbench_prepare(FAR char *dst, FAR char *src, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len - 1; i++) {
+		src[i] = dst[i] = 'a' + i % 26;
+	}
+
+	src[len - 1] = dst[len - 1] = '\0';
+}
+
+static unsigned long strbench_run(FAR const struct strbench_test_s *test, FAR char *dst, FAR char *src, size_t len, int lib)
+{
+	struct timespec start;
+	struct timespec end;
+	unsigned long usec;
+	unsigned long loops;
+	volatile int sink = 0;
+
+	loops = STRBENCH_BYTES / len;
+
+	strbench_prepare(dst, src, len);
+	clock_gettime(STRBENCH_CLOCK, &start);
+	while (loops-- > 0) {
+		sink += test->fn(dst, src, len, lib);
+	}
+
+	clock_gettime(STRBENCH_CLOCK, &end);
+	(void)sink;
+
+	usec = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+	return usec > 0 ? usec : 1;
+}
+
+/****************************************************************************
+ * strbench_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int strbench_main(int argc, char *argv[])
+#endif
+{
+	FAR const struct strbench_test_s *test;
+	unsigned long lib;
+	unsigned long ref;
+	int i;
+	int j;
+	int k;
+
+	printf("%-8s %5s %5s %10s %10s\n", "func", "size", "align", "lib KB/s", "byte KB/s");
+
+	for (i = 0; i < sizeof(g_tests) / sizeof(g_tests[0]); i++) {
+		test = &g_tests[i];
+		if (argc > 1 && strcmp(argv[1], test->name) != 0) {
+			continue;
+		}
+
+		for (j = 0; j < sizeof(g_sizes) / sizeof(g_sizes[0]); j++) {
+			for (k = 0; k < sizeof(g_misalign) / sizeof(g_misalign[0]); k++) {
+				FAR char *dst = g_dst + g_misalign[k][0];
+				FAR char *src = g_src + g_misalign[k][1];
+
+				lib = strbench_run(test, dst, src, g_sizes[j], 1);
+				ref = strbench_run(test, dst, src, g_sizes[j], 0);
+
+				/* KB/s is the KB processed times 10^6 over the elapsed usec */
+
+				printf("%-8s %5u   %d/%d %10lu %10lu\n", test->name, (unsigned)g_sizes[j], g_misalign[k][0], g_misalign[k][1], (STRBENCH_BYTES / 1024) * 1000000UL / lib, (STRBENCH_BYTES / 1024) * 1000000UL / ref);
+			}
+		}
+	}
+
+	return 0;
+}
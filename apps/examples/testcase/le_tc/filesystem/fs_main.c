@@ -1860,11 +1860,17 @@ static int fs_sample_launcher(int argc, char **args)
 #ifndef CONFIG_DISABLE_POLL
 	fs_vfs_poll_tc();
 	fs_vfs_select_tc();
+#endif
+#ifdef CONFIG_TC_FS_EPOLL
+	tc_fs_epoll_main();
 #endif
 	fs_vfs_rename_tc();
 	fs_vfs_ioctl_tc();
 #ifdef CONFIG_TC_FS_PROCFS
 	tc_fs_procfs_main();
+#endif
+#ifdef CONFIG_TC_FS_EVENTFD
+	tc_fs_eventfd_main();
 #endif
 	libc_stdio_fdopen_tc();
 	libc_stdio_fopen_tc();
@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_fs_epoll.c
+
+/// @brief Test Case Example for epoll
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#include <sys/socket.h>
+#endif
+#include "tc_common.h"
+#include "tc_internal.h"
+
+#define EPOLL_WAIT_MSEC     100
+#define EPOLL_MAXEVENTS     4
+
+/* Posts to an eventfd after a while, for a blocking epoll_wait() */
+
+static pthread_addr_t epoll_post_thread(pthread_addr_t arg)
+{
+	usleep(EPOLL_WAIT_MSEC * 1000);
+	eventfd_write((int)arg, 1);
+	return NULL;
+}
+
+static int epoll_add(int epfd, int fd, uint32_t events)
+{
+	struct epoll_event ev;
+
+	ev.events = events;
+	ev.data.fd = fd;
+	return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+/**
+ * @testcase         tc_fs_epoll_ctl
+ * @brief            Registration of descriptors and argument checks
+ * @scenario         Add, modify and remove an eventfd, and check the errors
+ *                   of duplicated, missing and invalid registrations
+ * @apicovered       epoll_create, epoll_create1, epoll_ctl
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_epoll_ctl(void)
+{
+	struct epoll_event ev;
+	int epfd;
+	int ret;
+	int fd;
+
+	ret = epoll_create(0);
+	TC_ASSERT_EQ("epoll_create", ret, ERROR);
+	TC_ASSERT_EQ("epoll_create", errno, EINVAL);
+
+	ret = epoll_create1(~EPOLL_CLOEXEC);
+	TC_ASSERT_EQ("epoll_create1", ret, ERROR);
+	TC_ASSERT_EQ("epoll_create1", errno, EINVAL);
+
+	epfd = epoll_create1(0);
+	TC_ASSERT_GEQ("epoll_create1", epfd, 0);
+
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd, 0, close(epfd));
+
+	ret = epoll_add(epfd, fd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	ret = epoll_add(epfd, fd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, EEXIST, close(fd); close(epfd));
+
+	ev.events = EPOLLIN | EPOLLOUT;
+	ev.data.u32 = 0x5a5a;
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	/* The modified registration reports POLLOUT with the new data */
+
+	ev.events = 0;
+	ev.data.u32 = 0;
+	ret = epoll_wait(epfd, &ev, 1, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev.events, EPOLLOUT, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev.data.u32, 0x5a5a, close(fd); close(epfd));
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, ENOENT, close(fd); close(epfd));
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, ENOENT, close(fd); close(epfd));
+
+	/* An instance cannot watch itself, and other files are not instances */
+
+	ret = epoll_add(epfd, epfd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, EINVAL, close(fd); close(epfd));
+
+	ret = epoll_add(fd, epfd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, EINVAL, close(fd); close(epfd));
+
+	ret = epoll_wait(epfd, &ev, 0, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, ERROR, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", errno, EINVAL, close(fd); close(epfd));
+
+	close(fd);
+	close(epfd);
+
+	ret = epoll_wait(epfd, &ev, 1, 0);
+	TC_ASSERT_EQ("epoll_wait", ret, ERROR);
+	TC_ASSERT_EQ("epoll_wait", errno, EBADF);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_epoll_wait
+ * @brief            epoll_wait() times out, and wakes up on an event
+ * @scenario         Wait on an idle eventfd with a timeout, then wait without
+ *                   one while a thread writes to a second eventfd
+ * @apicovered       epoll_wait
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_epoll_wait(void)
+{
+	struct epoll_event ev[EPOLL_MAXEVENTS];
+	struct timespec start;
+	struct timespec end;
+	pthread_t thread;
+	eventfd_t value;
+	long elapsed;
+	int epfd;
+	int fd1;
+	int fd2;
+	int ret;
+
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	TC_ASSERT_GEQ("epoll_create1", epfd, 0);
+
+	fd1 = eventfd(0, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd1, 0, close(epfd));
+	fd2 = eventfd(0, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd2, 0, close(fd1); close(epfd));
+
+	ret = epoll_add(epfd, fd1, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd2); close(fd1); close(epfd));
+	ret = epoll_add(epfd, fd2, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd2); close(fd1); close(epfd));
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, EPOLL_WAIT_MSEC);
+	clock_gettime(CLOCK_REALTIME, &end);
+	elapsed = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(fd2); close(fd1); close(epfd));
+	TC_ASSERT_GEQ_CLEANUP("epoll_wait", elapsed, EPOLL_WAIT_MSEC - 10, close(fd2); close(fd1); close(epfd));
+
+	ret = pthread_create(&thread, NULL, epoll_post_thread, (pthread_addr_t)fd2);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret, 0, close(fd2); close(fd1); close(epfd));
+
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, -1);
+	pthread_join(thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd2); close(fd1); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev[0].events, EPOLLIN, close(fd2); close(fd1); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev[0].data.fd, fd2, close(fd2); close(fd1); close(epfd));
+
+	eventfd_read(fd2, &value);
+	close(fd2);
+	close(fd1);
+	close(epfd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_epoll_trigger
+ * @brief            Level-triggered, edge-triggered and one-shot reporting
+ * @scenario         A readable level-triggered eventfd is reported until it
+ *                   is read; an edge-triggered one once per write; a one-shot
+ *                   one once until it is modified
+ * @apicovered       epoll_ctl, epoll_wait
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_epoll_trigger(void)
+{
+	struct epoll_event ev[EPOLL_MAXEVENTS];
+	eventfd_t value;
+	int epfd;
+	int ret;
+	int fd;
+
+	epfd = epoll_create1(0);
+	TC_ASSERT_GEQ("epoll_create1", epfd, 0);
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd, 0, close(epfd));
+
+	/* Level-triggered */
+
+	ret = epoll_add(epfd, fd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	eventfd_write(fd, 1);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+
+	eventfd_read(fd, &value);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(fd); close(epfd));
+
+	/* Edge-triggered: still readable, but reported again only on a write */
+
+	ev[0].events = EPOLLIN | EPOLLET;
+	ev[0].data.fd = fd;
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev[0]);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	eventfd_write(fd, 1);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(fd); close(epfd));
+
+	eventfd_write(fd, 1);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev[0].data.fd, fd, close(fd); close(epfd));
+
+	/* One-shot: disabled after the first report until EPOLL_CTL_MOD */
+
+	ev[0].events = EPOLLIN | EPOLLONESHOT;
+	ev[0].data.fd = fd;
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev[0]);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+	eventfd_write(fd, 1);
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(fd); close(epfd));
+
+	ev[0].events = EPOLLIN | EPOLLONESHOT;
+	ev[0].data.fd = fd;
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev[0]);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+	ret = epoll_wait(epfd, ev, EPOLL_MAXEVENTS, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd));
+
+	eventfd_read(fd, &value);
+	close(fd);
+	close(epfd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_epoll_dup
+ * @brief            A duplicated epoll descriptor shares the instance
+ * @scenario         Register an eventfd through the original, close it and
+ *                   wait through the copy
+ * @apicovered       epoll_ctl, epoll_wait, dup
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_epoll_dup(void)
+{
+	struct epoll_event ev;
+	eventfd_t value;
+	int epfd2;
+	int epfd;
+	int ret;
+	int fd;
+
+	epfd = epoll_create1(0);
+	TC_ASSERT_GEQ("epoll_create1", epfd, 0);
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd, 0, close(epfd));
+
+	ret = epoll_add(epfd, fd, EPOLLIN);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd));
+
+	epfd2 = dup(epfd);
+	close(epfd);
+	TC_ASSERT_GEQ_CLEANUP("dup", epfd2, 0, close(fd));
+
+	eventfd_write(fd, 1);
+	ret = epoll_wait(epfd2, &ev, 1, EPOLL_WAIT_MSEC);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(fd); close(epfd2));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev.data.fd, fd, close(fd); close(epfd2));
+
+	ret = epoll_ctl(epfd2, EPOLL_CTL_DEL, fd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(fd); close(epfd2));
+
+	eventfd_read(fd, &value);
+	close(fd);
+	close(epfd2);
+	TC_SUCCESS_RESULT();
+}
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+/**
+ * @testcase         tc_fs_epoll_socket
+ * @brief            A socket closed while registered can still be removed
+ * @scenario         Register a writable UDP socket, see it reported, close it
+ *                   and check it is no longer reported and can be removed
+ * @apicovered       epoll_ctl, epoll_wait, socket
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_epoll_socket(void)
+{
+	struct epoll_event ev;
+	int epfd;
+	int sd;
+	int ret;
+
+	epfd = epoll_create1(0);
+	TC_ASSERT_GEQ("epoll_create1", epfd, 0);
+
+	sd = socket(AF_INET, SOCK_DGRAM, 0);
+	TC_ASSERT_GEQ_CLEANUP("socket", sd, 0, close(epfd));
+
+	ret = epoll_add(epfd, sd, EPOLLOUT);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(sd); close(epfd));
+
+	ret = epoll_wait(epfd, &ev, 1, EPOLL_WAIT_MSEC);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(sd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev.events, EPOLLOUT, close(sd); close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ev.data.fd, sd, close(sd); close(epfd));
+
+	close(sd);
+
+	ret = epoll_wait(epfd, &ev, 1, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd));
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, sd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, OK, close(epfd));
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, sd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, ERROR, close(epfd));
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, ENOENT, close(epfd));
+
+	close(epfd);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+void tc_fs_epoll_main(void)
+{
+	tc_fs_epoll_ctl();
+	tc_fs_epoll_wait();
+	tc_fs_epoll_trigger();
+	tc_fs_epoll_dup();
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+	tc_fs_epoll_socket();
+#endif
+}
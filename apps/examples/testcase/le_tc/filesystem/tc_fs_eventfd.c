@@ -0,0 +1,322 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_fs_eventfd.c
+
+/// @brief Test Case Example for eventfd
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/eventfd.h>
+#include "tc_common.h"
+#include "tc_internal.h"
+
+#define EVENTFD_MAX         ((eventfd_t)0xfffffffffffffffeull)
+#define EVENTFD_WAIT_MSEC   100
+#define EVENTFD_STACKSIZE   2048
+
+static volatile bool g_eventfd_done;
+
+/* Adds 1 to a full counter, which blocks until the counter is read */
+
+static pthread_addr_t eventfd_overflow_thread(pthread_addr_t arg)
+{
+	int fd = (int)arg;
+
+	eventfd_write(fd, 1);
+	g_eventfd_done = true;
+	return NULL;
+}
+
+/* Posts to the eventfd inherited from the parent, its number in argv[1] */
+
+static int eventfd_child_task(int argc, char *argv[])
+{
+	int fd = atoi(argv[1]);
+
+	return eventfd_write(fd, 5) == 0 ? OK : ERROR;
+}
+
+/**
+ * @testcase         tc_fs_eventfd_counter
+ * @brief            Writes add to the counter, a read returns and resets it
+ * @scenario         Write 3 and 4, read 7; read again on a non-blocking eventfd
+ * @apicovered       eventfd, read, write
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_eventfd_counter(void)
+{
+	eventfd_t value;
+	int ret;
+	int fd;
+
+	fd = eventfd(0, EFD_NONBLOCK);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	ret = eventfd_write(fd, 3);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret, 0, close(fd));
+	ret = eventfd_write(fd, 4);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret, 0, close(fd));
+
+	value = 0;
+	ret = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, 7, close(fd));
+
+	/* Nothing left: EAGAIN rather than blocking */
+
+	ret = read(fd, &value, sizeof(value));
+	TC_ASSERT_EQ_CLEANUP("read", ret, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("read", errno, EAGAIN, close(fd));
+
+	/* Buffers smaller than the counter are rejected */
+
+	ret = read(fd, &value, sizeof(value) - 1);
+	TC_ASSERT_EQ_CLEANUP("read", ret, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("read", errno, EINVAL, close(fd));
+
+	close(fd);
+
+	fd = eventfd(0, 0x1234);
+	TC_ASSERT_EQ_CLEANUP("eventfd", fd, ERROR, close(fd));
+	TC_ASSERT_EQ("eventfd", errno, EINVAL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_eventfd_semaphore
+ * @brief            EFD_SEMAPHORE reads take one at a time
+ * @scenario         Create with 2, read 1 twice, then EAGAIN
+ * @apicovered       eventfd, read
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_eventfd_semaphore(void)
+{
+	eventfd_t value;
+	int ret;
+	int fd;
+
+	fd = eventfd(2, EFD_SEMAPHORE | EFD_NONBLOCK);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	ret = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, 1, close(fd));
+
+	ret = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, 1, close(fd));
+
+	ret = read(fd, &value, sizeof(value));
+	TC_ASSERT_EQ_CLEANUP("read", ret, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("read", errno, EAGAIN, close(fd));
+
+	close(fd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_eventfd_overflow
+ * @brief            A write that would overflow the counter waits for a read
+ * @scenario         Fill the counter; a non-blocking write fails with EAGAIN,
+ *                   a blocking one from a thread completes once the counter is read
+ * @apicovered       eventfd, read, write
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_eventfd_overflow(void)
+{
+	pthread_t thread;
+	eventfd_t value;
+	int nbfd;
+	int ret;
+	int fd;
+
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	ret = eventfd_write(fd, EVENTFD_MAX);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret, 0, close(fd));
+
+	/* The maximum plus one is not a valid value at all */
+
+	value = EVENTFD_MAX + 1;
+	ret = write(fd, &value, sizeof(value));
+	TC_ASSERT_EQ_CLEANUP("write", ret, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("write", errno, EINVAL, close(fd));
+
+	nbfd = eventfd(0, EFD_NONBLOCK);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", nbfd, 0, close(fd));
+	eventfd_write(nbfd, EVENTFD_MAX);
+	value = 1;
+	ret = write(nbfd, &value, sizeof(value));
+	close(nbfd);
+	TC_ASSERT_EQ_CLEANUP("write", ret, ERROR, close(fd));
+	TC_ASSERT_EQ_CLEANUP("write", errno, EAGAIN, close(fd));
+
+	g_eventfd_done = false;
+	ret = pthread_create(&thread, NULL, eventfd_overflow_thread, (pthread_addr_t)fd);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret, 0, close(fd));
+
+	usleep(EVENTFD_WAIT_MSEC * 1000);
+	TC_ASSERT_EQ_CLEANUP("write", g_eventfd_done, false, eventfd_read(fd, &value); pthread_join(thread, NULL); close(fd));
+
+	ret = eventfd_read(fd, &value);
+	pthread_join(thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value == EVENTFD_MAX, true, close(fd));
+	TC_ASSERT_EQ_CLEANUP("write", g_eventfd_done, true, close(fd));
+
+	ret = eventfd_read(fd, &value);
+	close(fd);
+	TC_ASSERT_EQ("eventfd_read", ret, 0);
+	TC_ASSERT_EQ("eventfd_read", value, 1);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_eventfd_poll
+ * @brief            poll() reports the counter
+ * @scenario         Writable and not readable while zero, readable after a write
+ * @apicovered       eventfd, poll
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_eventfd_poll(void)
+{
+	struct pollfd pfd;
+	eventfd_t value;
+	int ret;
+	int fd;
+
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	pfd.fd = fd;
+	pfd.events = POLLIN | POLLOUT;
+	pfd.revents = 0;
+	ret = poll(&pfd, 1, 0);
+	TC_ASSERT_EQ_CLEANUP("poll", ret, 1, close(fd));
+	TC_ASSERT_EQ_CLEANUP("poll", pfd.revents, POLLOUT, close(fd));
+
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	ret = poll(&pfd, 1, EVENTFD_WAIT_MSEC);
+	TC_ASSERT_EQ_CLEANUP("poll", ret, 0, close(fd));
+
+	eventfd_write(fd, 1);
+	pfd.revents = 0;
+	ret = poll(&pfd, 1, EVENTFD_WAIT_MSEC);
+	TC_ASSERT_EQ_CLEANUP("poll", ret, 1, close(fd));
+	TC_ASSERT_EQ_CLEANUP("poll", pfd.revents, POLLIN, close(fd));
+
+	eventfd_read(fd, &value);
+	close(fd);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @testcase         tc_fs_eventfd_dup
+ * @brief            Duplicated and inherited descriptors share the counter
+ * @scenario         Write through dup() and dup2() copies, read through the
+ *                   original; close the original and keep using the copies;
+ *                   a child task posts through the descriptor it inherited
+ * @apicovered       eventfd, dup, dup2, task_create
+ * @precondition     none
+ * @postcondition    none
+ */
+static void tc_fs_eventfd_dup(void)
+{
+	char arg[12];
+	FAR char *argv[2];
+	eventfd_t value;
+	int fd2;
+	int fd3;
+	int ret;
+	int fd;
+
+	fd = eventfd(0, 0);
+	TC_ASSERT_GEQ("eventfd", fd, 0);
+
+	fd2 = dup(fd);
+	TC_ASSERT_GEQ_CLEANUP("dup", fd2, 0, close(fd));
+
+	ret = eventfd_write(fd2, 2);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret, 0, close(fd2); close(fd));
+	ret = eventfd_read(fd, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd2); close(fd));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, 2, close(fd2); close(fd));
+
+	/* Close the original: the copies keep the counter */
+
+	close(fd);
+
+	/* dup2() over another eventfd drops that one and shares ours */
+
+	fd3 = eventfd(7, 0);
+	TC_ASSERT_GEQ_CLEANUP("eventfd", fd3, 0, close(fd2));
+	ret = dup2(fd2, fd3);
+	TC_ASSERT_NEQ_CLEANUP("dup2", ret, ERROR, close(fd3); close(fd2));
+
+	ret = eventfd_write(fd3, 3);
+	TC_ASSERT_EQ_CLEANUP("eventfd_write", ret, 0, close(fd3); close(fd2));
+	ret = eventfd_read(fd2, &value);
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", ret, 0, close(fd3); close(fd2));
+	TC_ASSERT_EQ_CLEANUP("eventfd_read", value, 3, close(fd3); close(fd2));
+	close(fd3);
+
+	/* A child task inherits the descriptor */
+
+	snprintf(arg, sizeof(arg), "%d", fd2);
+	argv[0] = arg;
+	argv[1] = NULL;
+	ret = task_create("eventfd_child", SCHED_PRIORITY_DEFAULT, EVENTFD_STACKSIZE, eventfd_child_task, argv);
+	TC_ASSERT_GT_CLEANUP("task_create", ret, 0, close(fd2));
+
+	ret = eventfd_read(fd2, &value);
+	close(fd2);
+	TC_ASSERT_EQ("eventfd_read", ret, 0);
+	TC_ASSERT_EQ("eventfd_read", value, 5);
+
+	TC_SUCCESS_RESULT();
+}
+
+void tc_fs_eventfd_main(void)
+{
+	tc_fs_eventfd_counter();
+	tc_fs_eventfd_semaphore();
+	tc_fs_eventfd_overflow();
+	tc_fs_eventfd_poll();
+	tc_fs_eventfd_dup();
+}
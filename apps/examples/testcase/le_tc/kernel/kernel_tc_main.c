@@ -68,6 +68,10 @@ int kernel_tc_main(int argc, char *argv[])
 	errno_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_EVENT
+	event_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_GROUP
 #if (!defined CONFIG_SCHED_HAVE_PARENT) || (!defined CONFIG_SCHED_CHILD_STATUS)
 #error CONFIG_SCHED_HAVE_PARENT and CONFIG_SCHED_CHILD_STATUS are needed for testing GROUP TC
@@ -178,6 +182,10 @@ int kernel_tc_main(int argc, char *argv[])
 	signal_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_SYSBATCH
+	sysbatch_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_TASK
 #if (!defined CONFIG_SCHED_ATEXIT) || (!defined CONFIG_SCHED_ONEXIT) || (!defined CONFIG_TASK_NAME_SIZE)
 #error CONFIG_SCHED_ATEXIT, CONFIG_SCHED_ONEXIT and CONFIG_TASK_NAME_SIZE are needed for testing TASK TC
@@ -0,0 +1,276 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_event.c
+
+/// @brief Test Case Example for Event Group API
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <tinyara/event.h>
+#include "tc_internal.h"
+
+#define EVENT_A        (1 << 0)
+#define EVENT_B        (1 << 1)
+#define EVENT_C        (1 << 2)
+#define EVENT_WAIT_MSEC 100
+
+static event_t g_event;
+static volatile bool g_waiter_done;
+static event_set_t g_waiter_result;
+static int g_waiter_errno;
+
+/* Waits for A and B together and clears them */
+
+static pthread_addr_t event_waitall_thread(pthread_addr_t arg)
+{
+	int ret;
+
+	ret = event_wait(&g_event, EVENT_A | EVENT_B, EVENT_WAITALL | EVENT_CLEAR, &g_waiter_result);
+	g_waiter_errno = ret == OK ? OK : get_errno();
+	g_waiter_done = true;
+	return NULL;
+}
+
+/* Waits for C, which is never posted */
+
+static pthread_addr_t event_intr_thread(pthread_addr_t arg)
+{
+	int ret;
+
+	ret = event_wait(&g_event, EVENT_C, 0, NULL);
+	g_waiter_errno = ret == OK ? OK : get_errno();
+	g_waiter_done = true;
+	return NULL;
+}
+
+static void event_sighandler(int signo)
+{
+}
+
+static void event_abstime(FAR struct timespec *abstime, int msec)
+{
+	clock_gettime(CLOCK_REALTIME, abstime);
+	abstime->tv_nsec += (msec % 1000) * 1000000;
+	abstime->tv_sec += msec / 1000 + abstime->tv_nsec / 1000000000;
+	abstime->tv_nsec %= 1000000000;
+}
+
+/**
+ * @fn                  :tc_event_post_wait_any
+ * @brief               :Wait for any of the events of a set
+ * @scenario            :Post A, wait for A or B without and with EVENT_CLEAR
+ * API's covered        :event_init, event_post, event_wait, event_clear, event_destroy
+ * Preconditions        :none
+ * Postconditions       :none
+ * @return              :void
+ */
+static void tc_event_post_wait_any(void)
+{
+	event_set_t result;
+	int ret;
+
+	ret = event_init(&g_event);
+	TC_ASSERT_EQ("event_init", ret, OK);
+
+	ret = event_post(&g_event, EVENT_A);
+	TC_ASSERT_EQ("event_post", ret, OK);
+
+	/* Already posted: returns at once and leaves A posted */
+
+	result = 0;
+	ret = event_wait(&g_event, EVENT_A | EVENT_B, 0, &result);
+	TC_ASSERT_EQ("event_wait", ret, OK);
+	TC_ASSERT_EQ("event_wait", result, EVENT_A);
+	TC_ASSERT_EQ("event_wait", g_event.set, EVENT_A);
+
+	result = 0;
+	ret = event_wait(&g_event, EVENT_A | EVENT_B, EVENT_CLEAR, &result);
+	TC_ASSERT_EQ("event_wait", ret, OK);
+	TC_ASSERT_EQ("event_wait", result, EVENT_A);
+	TC_ASSERT_EQ("event_wait", g_event.set, 0);
+
+	ret = event_post(&g_event, EVENT_A | EVENT_B);
+	TC_ASSERT_EQ("event_post", ret, OK);
+	ret = event_clear(&g_event, EVENT_B);
+	TC_ASSERT_EQ("event_clear", ret, OK);
+	TC_ASSERT_EQ("event_clear", g_event.set, EVENT_A);
+
+	/* An empty set is rejected */
+
+	ret = event_wait(&g_event, 0, 0, NULL);
+	TC_ASSERT_EQ("event_wait", ret, ERROR);
+	TC_ASSERT_EQ("event_wait", get_errno(), EINVAL);
+
+	ret = event_destroy(&g_event);
+	TC_ASSERT_EQ("event_destroy", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                  :tc_event_waitall_clear
+ * @brief               :Wait for all the events of a set
+ * @scenario            :A thread waits for A and B with EVENT_WAITALL | EVENT_CLEAR;
+ *                       posting A alone does not wake it, posting B does and clears both
+ * API's covered        :event_post, event_wait
+ * Preconditions        :none
+ * Postconditions       :none
+ * @return              :void
+ */
+static void tc_event_waitall_clear(void)
+{
+	pthread_t thread;
+	int ret;
+
+	ret = event_init(&g_event);
+	TC_ASSERT_EQ("event_init", ret, OK);
+
+	g_waiter_done = false;
+	g_waiter_result = 0;
+	g_waiter_errno = ERROR;
+	ret = pthread_create(&thread, NULL, event_waitall_thread, NULL);
+	TC_ASSERT_EQ("pthread_create", ret, OK);
+
+	usleep(EVENT_WAIT_MSEC * 1000);
+	event_post(&g_event, EVENT_A);
+	usleep(EVENT_WAIT_MSEC * 1000);
+	TC_ASSERT_EQ_CLEANUP("event_wait", g_waiter_done, false, event_post(&g_event, EVENT_B); pthread_join(thread, NULL));
+
+	/* The waiter is queued on the group, which cannot go away */
+
+	ret = event_destroy(&g_event);
+	TC_ASSERT_EQ_CLEANUP("event_destroy", ret, ERROR, event_post(&g_event, EVENT_B); pthread_join(thread, NULL));
+	TC_ASSERT_EQ_CLEANUP("event_destroy", get_errno(), EBUSY, event_post(&g_event, EVENT_B); pthread_join(thread, NULL));
+
+	event_post(&g_event, EVENT_B);
+	pthread_join(thread, NULL);
+
+	TC_ASSERT_EQ("event_wait", g_waiter_done, true);
+	TC_ASSERT_EQ("event_wait", g_waiter_errno, OK);
+	TC_ASSERT_EQ("event_wait", g_waiter_result & (EVENT_A | EVENT_B), EVENT_A | EVENT_B);
+	TC_ASSERT_EQ("event_wait", g_event.set & (EVENT_A | EVENT_B), 0);
+
+	ret = event_destroy(&g_event);
+	TC_ASSERT_EQ("event_destroy", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                  :tc_event_timedwait_timeout
+ * @brief               :Give up waiting at the absolute time given
+ * @scenario            :Wait for an event that is never posted, with a timeout
+ * API's covered        :event_timedwait
+ * Preconditions        :none
+ * Postconditions       :none
+ * @return              :void
+ */
+static void tc_event_timedwait_timeout(void)
+{
+	struct timespec abstime;
+	struct timespec now;
+	int ret;
+
+	ret = event_init(&g_event);
+	TC_ASSERT_EQ("event_init", ret, OK);
+
+	event_abstime(&abstime, EVENT_WAIT_MSEC);
+	ret = event_timedwait(&g_event, EVENT_A, 0, &abstime, NULL);
+	TC_ASSERT_EQ("event_timedwait", ret, ERROR);
+	TC_ASSERT_EQ("event_timedwait", get_errno(), ETIMEDOUT);
+
+	/* Not before the time given */
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	TC_ASSERT("event_timedwait", now.tv_sec > abstime.tv_sec || (now.tv_sec == abstime.tv_sec && now.tv_nsec >= abstime.tv_nsec));
+
+	/* The timed out waiter was removed from the group */
+
+	ret = event_destroy(&g_event);
+	TC_ASSERT_EQ("event_destroy", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                  :tc_event_wait_eintr
+ * @brief               :A signal interrupts the wait
+ * @scenario            :A thread waits for an event that is never posted and gets a signal
+ * API's covered        :event_wait
+ * Preconditions        :none
+ * Postconditions       :none
+ * @return              :void
+ */
+static void tc_event_wait_eintr(void)
+{
+	struct sigaction act;
+	struct sigaction oact;
+	pthread_t thread;
+	int ret;
+
+	ret = event_init(&g_event);
+	TC_ASSERT_EQ("event_init", ret, OK);
+
+	act.sa_handler = event_sighandler;
+	act.sa_flags = 0;
+	sigemptyset(&act.sa_mask);
+	ret = sigaction(SIGUSR1, &act, &oact);
+	TC_ASSERT_EQ("sigaction", ret, OK);
+
+	g_waiter_done = false;
+	g_waiter_errno = OK;
+	ret = pthread_create(&thread, NULL, event_intr_thread, NULL);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret, OK, sigaction(SIGUSR1, &oact, NULL));
+
+	usleep(EVENT_WAIT_MSEC * 1000);
+	pthread_kill(thread, SIGUSR1);
+	pthread_join(thread, NULL);
+	sigaction(SIGUSR1, &oact, NULL);
+
+	TC_ASSERT_EQ("event_wait", g_waiter_done, true);
+	TC_ASSERT_EQ("event_wait", g_waiter_errno, EINTR);
+
+	ret = event_destroy(&g_event);
+	TC_ASSERT_EQ("event_destroy", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Name: event
+ ****************************************************************************/
+
+int event_main(void)
+{
+	tc_event_post_wait_any();
+	tc_event_waitall_clear();
+	tc_event_timedwait_timeout();
+	tc_event_wait_eintr();
+
+	return 0;
+}
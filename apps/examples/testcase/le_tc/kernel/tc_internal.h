@@ -65,6 +65,7 @@ extern int total_fail;
 int clock_main(void);
 int environ_main(void);
 int errno_main(void);
+int event_main(void);
 int group_main(void);
 int libc_fixedmath_main(void);
 int libc_libgen_main(void);
@@ -89,6 +90,7 @@ int roundrobin_main(void);
 int sched_main(void);
 int semaphore_main(void);
 int signal_main(void);
+int sysbatch_main(void);
 int task_main(void);
 int termios_main(void);
 int timer_main(void);
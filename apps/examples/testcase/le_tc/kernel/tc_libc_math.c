@@ -873,6 +873,18 @@ static void tc_libc_math_cosf(void)
 		TC_ASSERT_LEQ("cosf", fabsf(sol_val[cosf_idx] - ret_val[cosf_idx]), FLT_EPSILON);
 	}
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+	/* Arguments far beyond the period, reduced exactly */
+	{
+		const float large_in[] = { 524288.0f, -16777215.0f, 1e9f, 1e20f, -2.57e22f, 3e38f };
+		const float large_sol[] = { 0.985852016f, -0.317576460f, 0.837887181f, 0.754259283f, 0.918812358f, -0.484294784f };
+
+		for (cosf_idx = 0; cosf_idx < SIZE(large_in, float); cosf_idx++) {
+			TC_ASSERT_LEQ("cosf", fabsf(large_sol[cosf_idx] - cosf(large_in[cosf_idx])), FLT_EPSILON);
+		}
+	}
+#endif
+
 	TC_SUCCESS_RESULT();
 }
 
@@ -2763,6 +2775,18 @@ static void tc_libc_math_sinf(void)
 		TC_ASSERT_LEQ("sinf", fabsf(sol_val[sinf_idx] - ret_val[sinf_idx]), FLT_EPSILON);
 	}
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+	/* Arguments far beyond the period, reduced exactly */
+	{
+		const float large_in[] = { 524288.0f, -16777215.0f, 1e9f, 1e20f, -2.57e22f, 3e38f };
+		const float large_sol[] = { 0.167618027f, 0.948232668f, 0.545843449f, 0.656576678f, 0.394694630f, 0.874904888f };
+
+		for (sinf_idx = 0; sinf_idx < SIZE(large_in, float); sinf_idx++) {
+			TC_ASSERT_LEQ("sinf", fabsf(large_sol[sinf_idx] - sinf(large_in[sinf_idx])), FLT_EPSILON);
+		}
+	}
+#endif
+
 	TC_SUCCESS_RESULT();
 }
 
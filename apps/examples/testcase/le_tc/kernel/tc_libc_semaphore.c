@@ -65,11 +65,10 @@ static void tc_libc_semaphore_sem_init(void)
 	TC_ASSERT_EQ("sem_init", sem.semcount, value);
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	TC_ASSERT_EQ("sem_init", sem.flags, 0);
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-	TC_ASSERT_EQ("sem_init", sem.hhead, NULL);
-#else
 	TC_ASSERT_EQ("sem_init", sem.holder.htcb, NULL);
 	TC_ASSERT_EQ("sem_init", sem.holder.counts, 0);
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+	TC_ASSERT_EQ("sem_init", sem.hhead, NULL);
 #endif
 #endif
 
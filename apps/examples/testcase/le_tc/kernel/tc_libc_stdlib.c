@@ -43,6 +43,11 @@
 #define BINARY 2
 #define QSORT_SMALL_ARRSIZE 6
 #define QSORT_BIG_ARRSIZE 45
+#define QSORT_WORST_ARRSIZE 512
+#define QSORT_WORST_LOG2 9
+#define RADIX_ARRSIZE 40
+#define RADIX_ELEMSIZE 7
+#define RADIX_KEYOFFSET 3
 #define BSEARCH_ARRSIZE 10
 
 /**
@@ -66,6 +71,70 @@ static int compare(const void *a, const void *b)
 	return (*(int *)a - *(int *)b);
 }
 
+/**
+ * @fn                   :compare_r
+ * @description          :Function for tc_libc_stdlib_qsort_r, sorts in the direction given by arg
+ *                        and counts the calls
+ * @return               :int
+ */
+struct qsort_r_ctx_s {
+	int direction;
+	int ncalls;
+};
+
+static int compare_r(const void *a, const void *b, void *arg)
+{
+	struct qsort_r_ctx_s *ctx = (struct qsort_r_ctx_s *)arg;
+
+	ctx->ncalls++;
+	return ctx->direction * (*(int *)a - *(int *)b);
+}
+
+/**
+ * @fn                   :compare_adversary
+ * @description          :Function for tc_libc_stdlib_qsort_worstcase.  McIlroy's "A Killer Adversary
+ *                        for Quicksort": values are fixed only when compared, so that every pivot
+ *                        ends up next to the smallest value of its partition
+ * @return               :int
+ */
+struct qsort_adversary_s {
+	int *val;
+	int gas;
+	int nsolid;
+	int candidate;
+	int ncalls;
+};
+
+static int compare_adversary(const void *a, const void *b, void *arg)
+{
+	struct qsort_adversary_s *adv = (struct qsort_adversary_s *)arg;
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	adv->ncalls++;
+	if (adv->val[x] == adv->gas && adv->val[y] == adv->gas) {
+		if (x == adv->candidate) {
+			adv->val[x] = adv->nsolid++;
+		} else {
+			adv->val[y] = adv->nsolid++;
+		}
+	}
+
+	if (adv->val[x] == adv->gas) {
+		adv->candidate = x;
+	} else if (adv->val[y] == adv->gas) {
+		adv->candidate = y;
+	}
+
+	return adv->val[x] - adv->val[y];
+}
+
+static int compare_count(const void *a, const void *b, void *arg)
+{
+	(*(int *)arg)++;
+	return (*(int *)a - *(int *)b);
+}
+
 /**
  * @fn                   :tc_abs_labs_llabs
  * @brief                :Returns the absolute value of parameter
@@ -233,6 +302,176 @@ static void tc_libc_stdlib_qsort(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+ * @fn                   :tc_libc_stdlib_qsort_r
+ * @brief                :Sorts the elements of the array with a comparison taking a context
+ * @Scenario             :Sorts the same array in both directions, chosen by the context argument,
+ *                        and checks that the comparison got the context on every call.
+ * API's covered         :qsort_r
+ * Preconditions         :None
+ * Postconditions        :None
+ * @return               :void
+ */
+static void tc_libc_stdlib_qsort_r(void)
+{
+	int qsort_data[QSORT_BIG_ARRSIZE] = { 16, 10, 27, 49, 18, 82, 27, 31, 11, 13, 101, 2, 99, 32, 51,
+				72, 182, 939, 1, 61, 83, 5, 60, 131, 52, 39, 33, 127, 29, 19,
+				12, 81, 281, 8, 931, 17, 111, 356, 14, 93, 20, 40, 30, 37, 73 };
+	struct qsort_r_ctx_s ctx;
+	int data_idx;
+
+	ctx.direction = 1;
+	ctx.ncalls = 0;
+	qsort_r(qsort_data, QSORT_BIG_ARRSIZE, sizeof(int), compare_r, &ctx);
+	TC_ASSERT_GT("qsort_r", ctx.ncalls, 0);
+	for (data_idx = 0; data_idx < QSORT_BIG_ARRSIZE - 1; data_idx++) {
+		TC_ASSERT_LEQ("qsort_r", qsort_data[data_idx], qsort_data[data_idx + 1]);
+	}
+
+	ctx.direction = -1;
+	ctx.ncalls = 0;
+	qsort_r(qsort_data, QSORT_BIG_ARRSIZE, sizeof(int), compare_r, &ctx);
+	TC_ASSERT_GT("qsort_r", ctx.ncalls, 0);
+	for (data_idx = 0; data_idx < QSORT_BIG_ARRSIZE - 1; data_idx++) {
+		TC_ASSERT_GEQ("qsort_r", qsort_data[data_idx], qsort_data[data_idx + 1]);
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                   :tc_libc_stdlib_qsort_worstcase
+ * @brief                :Sorts inputs that defeat the quicksort pivot selection
+ * @Scenario             :Sorts sorted, organ-pipe and adversarial input.  The adversary makes a plain
+ *                        quicksort quadratic, so staying within 4 n log2(n) comparisons shows that
+ *                        deep partitions fall back to the heap sort.
+ * API's covered         :qsort_r
+ * Preconditions         :None
+ * Postconditions        :None
+ * @return               :void
+ */
+static void tc_libc_stdlib_qsort_worstcase(void)
+{
+	static int data[QSORT_WORST_ARRSIZE];
+	static int val[QSORT_WORST_ARRSIZE];
+	struct qsort_adversary_s adv;
+	int ncalls;
+	int data_idx;
+	int n = QSORT_WORST_ARRSIZE;
+	int limit = 4 * QSORT_WORST_ARRSIZE * QSORT_WORST_LOG2;
+
+	/* Sorted */
+
+	for (data_idx = 0; data_idx < n; data_idx++) {
+		data[data_idx] = data_idx;
+	}
+
+	ncalls = 0;
+	qsort_r(data, n, sizeof(int), compare_count, &ncalls);
+	TC_ASSERT_LEQ("qsort_r", ncalls, limit);
+	for (data_idx = 0; data_idx < n; data_idx++) {
+		TC_ASSERT_EQ("qsort_r", data[data_idx], data_idx);
+	}
+
+	/* Organ pipe: 0 1 2 ... 2 1 0 */
+
+	for (data_idx = 0; data_idx < n; data_idx++) {
+		data[data_idx] = data_idx < n / 2 ? data_idx : n - 1 - data_idx;
+	}
+
+	ncalls = 0;
+	qsort_r(data, n, sizeof(int), compare_count, &ncalls);
+	TC_ASSERT_LEQ("qsort_r", ncalls, limit);
+	for (data_idx = 0; data_idx < n; data_idx++) {
+		TC_ASSERT_EQ("qsort_r", data[data_idx], data_idx / 2);
+	}
+
+	/* Adversary: sorts indexes by values decided during the sort */
+
+	for (data_idx = 0; data_idx < n; data_idx++) {
+		data[data_idx] = data_idx;
+		val[data_idx] = n - 1;
+	}
+
+	adv.val = val;
+	adv.gas = n - 1;
+	adv.nsolid = 0;
+	adv.candidate = 0;
+	adv.ncalls = 0;
+	qsort_r(data, n, sizeof(int), compare_adversary, &adv);
+	TC_ASSERT_LEQ("qsort_r", adv.ncalls, limit);
+	for (data_idx = 0; data_idx < n - 1; data_idx++) {
+		TC_ASSERT_LEQ("qsort_r", val[data[data_idx]], val[data[data_idx + 1]]);
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                   :tc_libc_stdlib_radixsort_u32
+ * @brief                :Sorts elements by a uint32_t key, keeping the order of equal keys
+ * @Scenario             :Sorts a plain uint32_t array, then 7-byte elements whose key is at the
+ *                        unaligned offset 3 and whose first bytes hold the original position.
+ *                        Equal keys must keep that order and the other bytes must move with the key.
+ * API's covered         :radixsort_u32
+ * Preconditions         :None
+ * Postconditions        :None
+ * @return               :void
+ */
+static void tc_libc_stdlib_radixsort_u32(void)
+{
+	static const uint32_t keys[] = { 0x80000001, 0x00010000, 0x7fffff00, 0x80000001, 0x00000100, 0x00010000, 0 };
+	uint32_t plain[RADIX_ARRSIZE];
+	unsigned char elem[RADIX_ARRSIZE][RADIX_ELEMSIZE];
+	uint32_t key;
+	uint32_t prev_key;
+	uint16_t tag;
+	uint16_t prev_tag;
+	int data_idx;
+	int ret;
+
+	for (data_idx = 0; data_idx < RADIX_ARRSIZE; data_idx++) {
+		plain[data_idx] = keys[data_idx % 7] ^ (uint32_t)data_idx;
+	}
+
+	ret = radixsort_u32(plain, RADIX_ARRSIZE, sizeof(uint32_t), 0);
+	TC_ASSERT_EQ("radixsort_u32", ret, 0);
+	for (data_idx = 0; data_idx < RADIX_ARRSIZE - 1; data_idx++) {
+		TC_ASSERT_LEQ("radixsort_u32", plain[data_idx], plain[data_idx + 1]);
+	}
+
+	for (data_idx = 0; data_idx < RADIX_ARRSIZE; data_idx++) {
+		tag = (uint16_t)data_idx;
+		key = keys[data_idx % 7];
+		memcpy(&elem[data_idx][0], &tag, sizeof(tag));
+		elem[data_idx][2] = (unsigned char)(key >> 24);
+		memcpy(&elem[data_idx][RADIX_KEYOFFSET], &key, sizeof(key));
+	}
+
+	ret = radixsort_u32(elem, RADIX_ARRSIZE, RADIX_ELEMSIZE, RADIX_KEYOFFSET);
+	TC_ASSERT_EQ("radixsort_u32", ret, 0);
+
+	prev_key = 0;
+	prev_tag = 0;
+	for (data_idx = 0; data_idx < RADIX_ARRSIZE; data_idx++) {
+		memcpy(&tag, &elem[data_idx][0], sizeof(tag));
+		memcpy(&key, &elem[data_idx][RADIX_KEYOFFSET], sizeof(key));
+		TC_ASSERT_EQ("radixsort_u32", key, keys[tag % 7]);
+		TC_ASSERT_EQ("radixsort_u32", elem[data_idx][2], (unsigned char)(key >> 24));
+		if (data_idx > 0) {
+			TC_ASSERT_LEQ("radixsort_u32", prev_key, key);
+			if (key == prev_key) {
+				TC_ASSERT_LT("radixsort_u32", prev_tag, tag);
+			}
+		}
+
+		prev_key = key;
+		prev_tag = tag;
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
  * @fn                   :tc_libc_stdlib_rand
  * @brief                :Returns a pseudo-random integral number
@@ -679,6 +918,9 @@ int libc_stdlib_main(void)
 	tc_libc_stdlib_imaxabs();
 	tc_libc_stdlib_itoa();
 	tc_libc_stdlib_qsort();
+	tc_libc_stdlib_qsort_r();
+	tc_libc_stdlib_qsort_worstcase();
+	tc_libc_stdlib_radixsort_u32();
 	tc_libc_stdlib_rand();
 	tc_libc_stdlib_strtol();
 	tc_libc_stdlib_strtoll();
@@ -0,0 +1,255 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_sysbatch.c
+
+/// @brief Test Case Example for batched system calls
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/sysbatch.h>
+#include "tc_internal.h"
+
+#define SYSBATCH_NENTRIES 8
+
+static struct sysbatch_sqe_s g_sqes[SYSBATCH_NENTRIES];
+static struct sysbatch_cqe_s g_cqes[SYSBATCH_NENTRIES];
+static struct sysbatch_sqe_s g_nested_sqes[2];
+static struct sysbatch_cqe_s g_nested_cqes[2];
+
+static void sysbatch_queue(FAR struct sysbatch_s *batch, int nbr, uint16_t flags, uintptr_t parm1, uintptr_t parm2, uintptr_t parm3)
+{
+	FAR struct sysbatch_sqe_s *sqe;
+
+	sqe = sysbatch_get_sqe(batch);
+	if (sqe != NULL) {
+		sqe->nbr = (uint16_t)nbr;
+		sqe->flags = flags;
+		sqe->user_data = batch->sq_tail;
+		sqe->parm[0] = parm1;
+		sqe->parm[1] = parm2;
+		sqe->parm[2] = parm3;
+	}
+}
+
+/**
+ * @fn                   :tc_sysbatch_mixed
+ * @brief                :Runs several different system calls in one batch
+ * @scenario             :Queue getpid(), write() to /dev/null, a close() that fails and getpid()
+ *                        again; all four complete in order with their results and errno values
+ * API's covered         :sysbatch_submit
+ * Preconditions         :none
+ * Postconditions        :none
+ * @return               :void
+ */
+static void tc_sysbatch_mixed(void)
+{
+	static const char msg[] = "sysbatch";
+	struct sysbatch_s batch;
+	FAR struct sysbatch_cqe_s *cqe;
+	pid_t pid = getpid();
+	int ret;
+	int fd;
+
+	fd = open("/dev/null", O_WRONLY);
+	TC_ASSERT_GEQ("open", fd, 0);
+
+	sysbatch_init(&batch, g_sqes, g_cqes, SYSBATCH_NENTRIES);
+	sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+	sysbatch_queue(&batch, SYS_write, 0, (uintptr_t)fd, (uintptr_t)msg, sizeof(msg));
+	sysbatch_queue(&batch, SYS_close, 0, (uintptr_t)-1, 0, 0);
+	sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+
+	ret = sysbatch_submit(&batch);
+	close(fd);
+	TC_ASSERT_EQ("sysbatch_submit", ret, 4);
+	TC_ASSERT_EQ("sysbatch_submit", batch.sq_head, batch.sq_tail);
+	TC_ASSERT_EQ("sysbatch_submit", batch.cq_tail, 4);
+
+	cqe = sysbatch_get_cqe(&batch);
+	TC_ASSERT_NOT_NULL("sysbatch_get_cqe", cqe);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->user_data, 1);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, 0);
+	TC_ASSERT_EQ("sysbatch_submit", (pid_t)cqe->result, pid);
+	sysbatch_cqe_seen(&batch);
+
+	cqe = sysbatch_get_cqe(&batch);
+	TC_ASSERT_NOT_NULL("sysbatch_get_cqe", cqe);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->user_data, 2);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, 0);
+	TC_ASSERT_EQ("sysbatch_submit", (int)cqe->result, (int)sizeof(msg));
+	sysbatch_cqe_seen(&batch);
+
+	cqe = sysbatch_get_cqe(&batch);
+	TC_ASSERT_NOT_NULL("sysbatch_get_cqe", cqe);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->user_data, 3);
+	TC_ASSERT_EQ("sysbatch_submit", (int)cqe->result, ERROR);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, EBADF);
+	sysbatch_cqe_seen(&batch);
+
+	cqe = sysbatch_get_cqe(&batch);
+	TC_ASSERT_NOT_NULL("sysbatch_get_cqe", cqe);
+	TC_ASSERT_EQ("sysbatch_submit", cqe->user_data, 4);
+	TC_ASSERT_EQ("sysbatch_submit", (pid_t)cqe->result, pid);
+	sysbatch_cqe_seen(&batch);
+
+	TC_ASSERT_EQ("sysbatch_get_cqe", sysbatch_get_cqe(&batch), NULL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                   :tc_sysbatch_reject
+ * @brief                :Nested batches and unknown system call numbers are rejected
+ * @scenario             :Queue sysbatch_submit() itself and numbers outside the system call table
+ *                        between two getpid() calls; they complete with ENOSYS and the batch goes on.
+ *                        A malformed batch fails with EINVAL.
+ * API's covered         :sysbatch_submit
+ * Preconditions         :none
+ * Postconditions        :none
+ * @return               :void
+ */
+static void tc_sysbatch_reject(void)
+{
+	struct sysbatch_s batch;
+	struct sysbatch_s nested;
+	FAR struct sysbatch_cqe_s *cqe;
+	int ret;
+	int i;
+
+	sysbatch_init(&nested, g_nested_sqes, g_nested_cqes, 2);
+	sysbatch_queue(&nested, SYS_getpid, 0, 0, 0, 0);
+
+	sysbatch_init(&batch, g_sqes, g_cqes, SYSBATCH_NENTRIES);
+	sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+	sysbatch_queue(&batch, SYS_sysbatch_submit, 0, (uintptr_t)&nested, 0, 0);
+	sysbatch_queue(&batch, SYS_maxsyscall, 0, 0, 0, 0);
+	sysbatch_queue(&batch, 0xffff, 0, 0, 0, 0);
+#if CONFIG_SYS_RESERVED > 0
+	sysbatch_queue(&batch, CONFIG_SYS_RESERVED - 1, 0, 0, 0, 0);
+#endif
+	sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, (int)batch.sq_tail);
+
+	for (i = 0; i < ret; i++) {
+		cqe = sysbatch_get_cqe(&batch);
+		TC_ASSERT_NOT_NULL("sysbatch_get_cqe", cqe);
+		if (i == 0 || i == ret - 1) {
+			TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, 0);
+			TC_ASSERT_EQ("sysbatch_submit", (pid_t)cqe->result, getpid());
+		} else {
+			TC_ASSERT_EQ("sysbatch_submit", (int)cqe->result, ERROR);
+			TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, ENOSYS);
+		}
+
+		sysbatch_cqe_seen(&batch);
+	}
+
+	/* The batch that was not run stays untouched */
+
+	TC_ASSERT_EQ("sysbatch_submit", nested.sq_tail, 1);
+	TC_ASSERT_EQ("sysbatch_submit", nested.sq_head, 0);
+	TC_ASSERT_EQ("sysbatch_submit", nested.cq_tail, 0);
+
+	ret = sysbatch_submit(NULL);
+	TC_ASSERT_EQ("sysbatch_submit", ret, ERROR);
+	TC_ASSERT_EQ("sysbatch_submit", errno, EINVAL);
+
+	sysbatch_init(&batch, g_sqes, g_cqes, SYSBATCH_NENTRIES - 1);
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, ERROR);
+	TC_ASSERT_EQ("sysbatch_submit", errno, EINVAL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                   :tc_sysbatch_partial
+ * @brief                :A batch stops on a failed SYSBATCH_F_STOP call or a full completion ring
+ * @scenario             :The calls after a failed SYSBATCH_F_STOP call stay queued for the next
+ *                        submission; with unreaped completions only as many calls run as fit
+ * API's covered         :sysbatch_submit
+ * Preconditions         :none
+ * Postconditions        :none
+ * @return               :void
+ */
+static void tc_sysbatch_partial(void)
+{
+	struct sysbatch_s batch;
+	FAR struct sysbatch_cqe_s *cqe;
+	int ret;
+	int i;
+
+	sysbatch_init(&batch, g_sqes, g_cqes, SYSBATCH_NENTRIES);
+	sysbatch_queue(&batch, SYS_getpid, SYSBATCH_F_STOP, 0, 0, 0);
+	sysbatch_queue(&batch, SYS_close, SYSBATCH_F_STOP, (uintptr_t)-1, 0, 0);
+	sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, 2);
+	TC_ASSERT_EQ("sysbatch_submit", batch.sq_head, 2);
+	cqe = &g_cqes[1];
+	TC_ASSERT_EQ("sysbatch_submit", cqe->errcode, EBADF);
+
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, 1);
+	TC_ASSERT_EQ("sysbatch_submit", batch.sq_head, batch.sq_tail);
+
+	/* Three completions are left unreaped: only five more calls fit */
+
+	for (i = 0; i < SYSBATCH_NENTRIES; i++) {
+		sysbatch_queue(&batch, SYS_getpid, 0, 0, 0, 0);
+	}
+
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, SYSBATCH_NENTRIES - 3);
+	TC_ASSERT_EQ("sysbatch_submit", batch.sq_tail - batch.sq_head, 3);
+
+	while (sysbatch_get_cqe(&batch) != NULL) {
+		sysbatch_cqe_seen(&batch);
+	}
+
+	ret = sysbatch_submit(&batch);
+	TC_ASSERT_EQ("sysbatch_submit", ret, 3);
+	TC_ASSERT_EQ("sysbatch_submit", batch.sq_head, batch.sq_tail);
+
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Name: sysbatch
+ ****************************************************************************/
+int sysbatch_main(void)
+{
+	tc_sysbatch_mixed();
+	tc_sysbatch_reject();
+	tc_sysbatch_partial();
+
+	return 0;
+}
@@ -128,6 +128,14 @@ typedef struct cJSON_Hooks {
 	void (*free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* Caller-supplied memory for cJSON_ParseInArena(). */
+
+typedef struct cJSON_Arena {
+	char *buffer;
+	size_t size;
+	size_t used;			/* Bytes taken from the start of buffer */
+} cJSON_Arena;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -142,6 +150,21 @@ void cJSON_InitHooks(cJSON_Hooks *hooks);
 
 cJSON *cJSON_Parse(const char *value);
 
+/* Parse without any heap allocation.  The items are taken from 'arena',
+ * initialized with cJSON_InitArena() over a buffer of the caller, and the
+ * strings are unescaped in place in 'value', which the tree points into:
+ * the text is modified and must outlive the tree.  The whole tree is
+ * released with cJSON_ResetArena() or by dropping the buffer; do not call
+ * cJSON_Delete() on it or on any of its items, nor the functions that
+ * replace or delete items.  Returns 0 on a parse error or when the arena
+ * is too small, in which case cJSON_GetErrorPtr() returns 0.  About 40
+ * bytes of arena are used per value.
+ */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size);
+void cJSON_ResetArena(cJSON_Arena *arena);
+cJSON *cJSON_ParseInArena(char *value, cJSON_Arena *arena);
+
 /* Render a cJSON entity to text for transfer/storage. Free the char* when
  * finished.
  */
@@ -154,6 +177,20 @@ char *cJSON_Print(cJSON *item);
 
 char *cJSON_PrintUnformatted(cJSON *item);
 
+/* Render a cJSON entity to text using a buffer of 'prebuffer' bytes, grown
+ * by doubling if it is too small.  A good guess of the final size avoids
+ * any reallocation.  Free the char* when finished.
+ */
+
+char *cJSON_PrintBuffered(cJSON *item, int prebuffer, int fmt);
+
+/* Render a cJSON entity to text in the 'length' bytes of 'buffer', without
+ * any allocation.  Returns 1 on success, 0 if the text and its terminating
+ * NUL do not fit.
+ */
+
+int cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const int fmt);
+
 /* Delete a cJSON entity and all subentities. */
 
 void cJSON_Delete(cJSON *c);
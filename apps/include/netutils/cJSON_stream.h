@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/include/netutils/cJSON_stream.h
+ *
+ * Streaming JSON: a push tokenizer that reports the document through a
+ * callback as it is fed, and a writer that emits JSON as it is produced.
+ * Both work in constant memory, whatever the size of the document.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_NETUTILS_CJSON_STREAM_H
+#define __APPS_INCLUDE_NETUTILS_CJSON_STREAM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <tinyara/streams.h>
+#include <apps/netutils/cJSON.h>
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+extern "C"
+{
+// *INDENT-ON*
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NETUTILS_JSON_STREAM_DEPTH
+#define CONFIG_NETUTILS_JSON_STREAM_DEPTH   16
+#endif
+
+#ifndef CONFIG_NETUTILS_JSON_STREAM_TOKEN
+#define CONFIG_NETUTILS_JSON_STREAM_TOKEN   128
+#endif
+
+#ifndef CONFIG_NETUTILS_JSON_STREAM_BUFSIZE
+#define CONFIG_NETUTILS_JSON_STREAM_BUFSIZE 128
+#endif
+
+/* Events reported by the tokenizer.  Keys, strings and numbers come with
+ * their text, unescaped and NUL terminated.  A string longer than
+ * CONFIG_NETUTILS_JSON_STREAM_TOKEN bytes is reported as a series of
+ * cJSON_StreamStringPart events followed by a cJSON_StreamString event with
+ * the last part; the parts are split on bytes, not on characters.  Keys and
+ * numbers must fit in CONFIG_NETUTILS_JSON_STREAM_TOKEN bytes.
+ */
+
+#define cJSON_StreamObjectStart 0
+#define cJSON_StreamObjectEnd   1
+#define cJSON_StreamArrayStart  2
+#define cJSON_StreamArrayEnd    3
+#define cJSON_StreamKey         4
+#define cJSON_StreamString      5
+#define cJSON_StreamStringPart  6
+#define cJSON_StreamNumber      7
+#define cJSON_StreamTrue        8
+#define cJSON_StreamFalse       9
+#define cJSON_StreamNull        10
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Called for every event.  'data' and 'len' are the text of keys, strings
+ * and numbers, NULL and 0 otherwise.  A non-zero return stops the parse.
+ */
+
+typedef int (*cJSON_StreamCallback)(void *arg, int event, const char *data, size_t len);
+
+/* Tokenizer state, see cJSON_StreamInit() */
+
+typedef struct cJSON_Stream {
+	cJSON_StreamCallback cb;
+	void *arg;
+	int error;				/* Sticky error, negated errno */
+	uint8_t state;
+	uint8_t depth;			/* Number of open objects and arrays */
+	uint8_t iskey;			/* The string being read is a key */
+	uint8_t pos;			/* Position in a literal or a \u escape */
+	const char *literal;	/* The literal being read */
+	uint16_t uc;			/* Code unit of a \u escape */
+	uint16_t high;			/* High surrogate waiting for its low half */
+	uint16_t toklen;
+	char stack[CONFIG_NETUTILS_JSON_STREAM_DEPTH];	/* '{' or '[' per level */
+	char token[CONFIG_NETUTILS_JSON_STREAM_TOKEN + 1];
+} cJSON_Stream;
+
+/* Output of the writer: returns 0 or a negated errno. */
+
+typedef int (*cJSON_WriterSink)(void *arg, const char *buf, size_t len);
+
+/* Writer state, see cJSON_WriterInit() */
+
+typedef struct cJSON_Writer {
+	cJSON_WriterSink sink;
+	void *arg;
+	int error;				/* Sticky error, negated errno */
+	uint8_t depth;			/* Number of open objects and arrays */
+	uint8_t first;			/* Nothing written yet in the open container */
+	uint8_t afterkey;		/* A key was written, its value is expected */
+	char stack[CONFIG_NETUTILS_JSON_STREAM_DEPTH];	/* '{' or '[' per level */
+	size_t len;
+	char buf[CONFIG_NETUTILS_JSON_STREAM_BUFSIZE];
+} cJSON_Writer;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Prepare a tokenizer for a new document, reported to 'cb' */
+
+void cJSON_StreamInit(cJSON_Stream *stream, cJSON_StreamCallback cb, void *arg);
+
+/* Feed the next 'len' bytes of the document.  The callback is called for
+ * the events completed by these bytes.  Returns 0, -EINVAL on a syntax
+ * error, -E2BIG if the document nests deeper than
+ * CONFIG_NETUTILS_JSON_STREAM_DEPTH or has a too long key or number, or
+ * -ECANCELED if the callback stopped the parse.  Errors are sticky.
+ */
+
+int cJSON_StreamFeed(cJSON_Stream *stream, const char *data, size_t len);
+
+/* Tell the tokenizer that the document ended.  Returns 0 if it was a
+ * complete JSON value, a negated errno otherwise.
+ */
+
+int cJSON_StreamFinish(cJSON_Stream *stream);
+
+/* Prepare a writer that emits to 'sink', to the file or socket 'fd', or to
+ * 'outstream'.  The writer buffers CONFIG_NETUTILS_JSON_STREAM_BUFSIZE
+ * bytes: call cJSON_WriterFlush() when the document is complete.
+ */
+
+void cJSON_WriterInit(cJSON_Writer *writer, cJSON_WriterSink sink, void *arg);
+void cJSON_WriterInitFd(cJSON_Writer *writer, int fd);
+void cJSON_WriterInitStream(cJSON_Writer *writer, FAR struct lib_outstream_s *outstream);
+
+/* Emit the document element by element.  In an object, every value is
+ * preceded by cJSON_WriteKey().  The functions return 0 or a negated
+ * errno: -EINVAL if the element is not allowed here, -E2BIG if the
+ * document nests deeper than CONFIG_NETUTILS_JSON_STREAM_DEPTH, or the
+ * error of the sink.  Errors are sticky.
+ */
+
+int cJSON_WriteObjectStart(cJSON_Writer *writer);
+int cJSON_WriteObjectEnd(cJSON_Writer *writer);
+int cJSON_WriteArrayStart(cJSON_Writer *writer);
+int cJSON_WriteArrayEnd(cJSON_Writer *writer);
+int cJSON_WriteKey(cJSON_Writer *writer, const char *key);
+int cJSON_WriteString(cJSON_Writer *writer, const char *str);
+int cJSON_WriteNumber(cJSON_Writer *writer, double num);
+int cJSON_WriteBool(cJSON_Writer *writer, int value);
+int cJSON_WriteNull(cJSON_Writer *writer);
+
+/* Emit a cJSON tree, unformatted, without building its text in memory */
+
+int cJSON_WriteItem(cJSON_Writer *writer, cJSON *item);
+
+/* Pass the buffered output to the sink */
+
+int cJSON_WriterFlush(cJSON_Writer *writer);
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+}
+// *INDENT-ON*
+#endif
+
+#endif							/* __APPS_INCLUDE_NETUTILS_CJSON_STREAM_H */
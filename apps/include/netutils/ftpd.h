@@ -80,7 +80,7 @@
  *   CONFIG_FTPD_CMDBUFFERSIZE - The maximum size of one command.  Default:
  *     128 bytes.
  *   CONFIG_FTPD_DATABUFFERSIZE - The size of the I/O buffer for data
- *     transfers.  Default: 512 bytes.
+ *     transfers and directory listings.  Default: 2048 bytes.
  *   CONFIG_FTPD_WORKERSTACKSIZE - The stacksize to allocate for each
  *     FTP daemon worker thread.  Default:  2048 bytes.
  */
@@ -106,7 +106,7 @@
 #endif
 
 #ifndef CONFIG_FTPD_DATABUFFERSIZE
-#define CONFIG_FTPD_DATABUFFERSIZE 512
+#define CONFIG_FTPD_DATABUFFERSIZE 2048
 #endif
 
 #ifndef CONFIG_FTPD_WORKERSTACKSIZE
@@ -50,8 +50,12 @@ struct coap_queue_t;
 
 typedef struct coap_queue_t {
 	struct coap_queue_t *next;
+	struct coap_queue_t *prev;
+	/**< previous message in the same slot of the retransmission wheel */
+	struct coap_queue_t *id_next;
+	/**< next message in the same bucket of the transaction index */
 
-	coap_tick_t t;		/**< when to send PDU for the next time */
+	coap_tick_t t;		/**< when to send PDU for the next time, relative to sendqueue_basetime */
 	unsigned char retransmit_cnt;
 	/**< retransmission counter, will be removed when zero */
 	unsigned int timeout;
@@ -93,7 +97,24 @@ typedef struct {
 	coap_key_t item[COAP_MID_CACHE_SIZE];
 } coap_mid_cache_t;
 
+#ifndef COAP_SENDWHEEL_SIZE
+/** Number of slots of the retransmission wheel of a context. */
+#define COAP_SENDWHEEL_SIZE 32
+#endif							/* COAP_SENDWHEEL_SIZE */
+
+#ifndef COAP_SENDWHEEL_TICKS
+/** Ticks covered by one slot of the retransmission wheel. */
+#define COAP_SENDWHEEL_TICKS (COAP_TICKS_PER_SECOND / 4)
+#endif							/* COAP_SENDWHEEL_TICKS */
+
 /** The CoAP stack's global state is stored in a coap_context_t object */
+#ifndef COAP_OBSERVER_HASH_SIZE
+/** Number of buckets of the observer index of a context. */
+#define COAP_OBSERVER_HASH_SIZE 16
+#endif							/* COAP_OBSERVER_HASH_SIZE */
+
+struct coap_subscription_t;
+
 typedef struct coap_context_t {
 	coap_opt_filter_t known_options;
 #ifndef WITH_CONTIKI
@@ -105,10 +126,24 @@ typedef struct coap_context_t {
 	struct coap_async_state_t *async_state;
 #endif							/* WITHOUT_ASYNC */
 	/**
-	 * The time stamp in the first element of the sendqeue is relative
-	 * to sendqueue_basetime. */
+	 * The time stamps of the confirmable messages waiting for
+	 * retransmission are relative to sendqueue_basetime. */
 	coap_tick_t sendqueue_basetime;
-	coap_queue_t *sendqueue, *recvqueue;
+	/**
+	 * The messages waiting for retransmission, in slots of
+	 * COAP_SENDWHEEL_TICKS ticks by their time stamp. */
+	coap_queue_t *sendwheel[COAP_SENDWHEEL_SIZE];
+	/**
+	 * Time stamp up to which coap_check_retransmit() has handled the
+	 * wheel. No message in the wheel is due before it. */
+	coap_tick_t sendwheel_time;
+	/**
+	 * The messages waiting for retransmission, hashed by their
+	 * transaction id. */
+	coap_queue_t *sendids[COAP_SENDWHEEL_SIZE];
+	/** The message that is due first, @c NULL if there is none */
+	coap_queue_t *sendqueue;
+	coap_queue_t *recvqueue;
 #if WITH_POSIX
 	int sockfd;		/**< send/receive socket */
 #endif							/* WITH_POSIX */
@@ -149,6 +184,16 @@ typedef struct coap_context_t {
 	 */
 	unsigned int observe;
 
+	/**
+	 * Resources that have been marked with coap_resource_set_dirty()
+	 * and are waiting for coap_check_notify(). */
+	struct coap_resource_t *dirty_resources;
+
+	/**
+	 * The subscriptions of all resources, hashed by the address of
+	 * the subscriber. */
+	struct coap_subscription_t *observers[COAP_OBSERVER_HASH_SIZE];
+
 	coap_response_handler_t response_handler;
 } coap_context_t;
 
@@ -178,8 +223,8 @@ coap_register_option(coap_context_t *ctx, unsigned char type)
 
 /**
  * Set sendqueue_basetime in the given context object @p ctx to @p
- * now. This function returns the number of elements in the queue
- * head that have timed out.
+ * now. This function returns the number of messages waiting for
+ * retransmission that have timed out.
  */
 unsigned int coap_adjust_basetime(coap_context_t *ctx, coap_tick_t now);
 
@@ -189,6 +234,18 @@ coap_queue_t *coap_peek_next(coap_context_t *context);
 /** Returns the next pdu to send and removes it from the sendqeue. */
 coap_queue_t *coap_pop_next(coap_context_t *context);
 
+/**
+ * Retransmits every confirmable message of @p context that is due at
+ * @p now. Only the slots of the retransmission wheel between the last
+ * call and @p now are visited, so this is meant to be called once per
+ * turn of the main loop instead of coap_pop_next() and
+ * coap_retransmit().
+ *
+ * @param context The context in use.
+ * @param now     The current time.
+ */
+void coap_check_retransmit(coap_context_t *context, coap_tick_t now);
+
 /** Creates a new coap_context_t object that will hold the CoAP stack status.  */
 coap_context_t *coap_new_context(const coap_address_t *listen_addr);
 
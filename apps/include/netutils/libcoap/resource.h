@@ -64,6 +64,7 @@ typedef struct coap_resource_t {
 	unsigned int observable: 1;
 	/**< can be observed */
 	unsigned int cacheable: 1; /**< can be cached */
+	unsigned int queued: 1;	/**< set to 1 while on the dirty queue of its context */
 
 	/**
 	 * Used to store handlers for the four coap methods @c GET, @c POST,
@@ -99,6 +100,11 @@ typedef struct coap_resource_t {
 	str uri;
 	int flags;
 
+	struct coap_context_t *context;
+	/**< the context the resource is registered with */
+	struct coap_resource_t *dirty_next;
+	/**< next resource on the dirty queue of the context */
+
 } coap_resource_t;
 
 /**
@@ -302,8 +308,19 @@ void coap_touch_observer(coap_context_t *context, const coap_address_t *observer
 void coap_delete_observer(coap_resource_t *resource, const coap_address_t *observer, const str *token);
 
 /**
- * Checks for all known resources, if they are dirty and notifies
- * subscribed observers.
+ * Marks @p resource as changed. Its observers are notified by the
+ * next call to coap_check_notify() for the context the resource is
+ * registered with.
+ *
+ * @param resource The resource that has changed.
+ */
+void coap_resource_set_dirty(coap_resource_t *resource);
+
+/**
+ * Notifies the observers of the resources that have been marked with
+ * coap_resource_set_dirty(). Resources whose observers could not all
+ * be notified stay queued for the next call. A resource must not be
+ * deleted from a GET handler that is run by this function.
  */
 void coap_check_notify(coap_context_t *context);
 
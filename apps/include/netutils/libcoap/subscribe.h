@@ -40,6 +40,9 @@
 typedef struct coap_subscription_t {
 	struct coap_subscription_t *next;
 	/**< next element in linked list */
+	struct coap_subscription_t *hash_next;
+	/**< next subscription in the same bucket of the observer index */
+	struct coap_resource_t *resource;	/**< the observed resource */
 	coap_address_t subscriber;		/**< address and port of subscriber */
 
 	unsigned int non: 1;		/**< send non-confirmable notifies if @c 1  */
@@ -84,6 +84,10 @@
 typedef struct http_client_response_t *httprsp;
 typedef void (*wget_callback_t)(httprsp);
 
+/* Receives the entity of a response piece by piece, as it arrives */
+
+typedef void (*wget_entity_callback_t)(httprsp response, const char *data, int len);
+
 #ifdef CONFIG_NET_SECURITY_TLS
 /**
  * @brief HTTP client TLS structure.
@@ -134,6 +138,7 @@ struct http_client_request_t {
 	struct http_client_ssl_config_t ssl_config;
 #endif
 	int async_flag;
+	wget_entity_callback_t entity_callback;
 };
 
 /**
@@ -210,6 +215,18 @@ int http_client_response_init(struct http_client_response_t *response);
 
 void http_client_response_release(struct http_client_response_t *response);
 
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+/**
+ * @brief http_client_close_connections() closes the idle connections kept
+ *                                        open for the next requests.
+ *
+ * @return N/A.
+ * @since Tizen RT v1.0
+ */
+
+void http_client_close_connections(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
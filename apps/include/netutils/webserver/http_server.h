@@ -85,13 +85,18 @@
 #define HTTP_CONF_CLIENT_STACKSIZE              8192
 #define HTTP_CONF_MIN_TLS_MEMORY                80000
 #define HTTP_CONF_SOCKET_TIMEOUT_MSEC           5000
+#ifdef CONFIG_NETUTILS_WEBSERVER_CLIENT_HANDLERS
+#define HTTP_CONF_MAX_CLIENT_HANDLE             CONFIG_NETUTILS_WEBSERVER_CLIENT_HANDLERS
+#else
 #define HTTP_CONF_MAX_CLIENT_HANDLE             1
+#endif
 #define HTTP_CONF_SERVER_MQ_MAX_MSG             10
 #define HTTP_CONF_SERVER_MQ_PRIO                50
 #define HTTP_CONF_SERVER_SIGWAKEUP              18
 
 #define HTTP_CONF_MAX_REQUEST_LENGTH            4096
 #define HTTP_CONF_MAX_REQUEST_LINE_LENGTH       256
+#define HTTP_CONF_MAX_REQUEST_HEADERS           32
 #define HTTP_CONF_MAX_REQUEST_HEADER_URL_LENGTH 128
 #define HTTP_CONF_MAX_URL_QUERY_LENGTH          64
 #define HTTP_CONF_MAX_URL_PARAMS_LENGTH         256
@@ -100,6 +105,8 @@
 #define HTTP_CONF_MAX_DIVIDED_PATH_LENGTH       32
 #define HTTP_CONF_MAX_SLASH_COUNT               32
 #define HTTP_CONF_MAX_QUERY_HANDLER_COUNT       64
+#define HTTP_CONF_QUERY_HASH_SIZE               16
+#define HTTP_CONF_MAX_PATH_PARAMS               8
 #define HTTP_CONF_MAX_ENTITY_LENGTH             2048
 
 #define HTTP_ERROR_400            "Bad Request"
@@ -138,6 +145,8 @@ typedef enum {
  * @brief http request message.
  */
 
+struct http_req_parser_t;
+
 struct http_req_message {
 	char *req_msg;
 	int method;
@@ -147,6 +156,12 @@ struct http_req_message {
 	char *entity;
 	char *query_string;
 	int encoding;
+	/* The ':name' segments of the route that matched the URL, valid in the callback */
+	int path_param_count;
+	const char *path_param_keys[HTTP_CONF_MAX_PATH_PARAMS];
+	const char *path_param_values[HTTP_CONF_MAX_PATH_PARAMS];
+	/* Parser of the connection, indexes the headers of the request */
+	struct http_req_parser_t *parser;
 };
 
 /**
@@ -167,6 +182,11 @@ struct http_server_t {
 	pthread_t tid;
 	pthread_t c_tid[HTTP_CONF_MAX_CLIENT_HANDLE];
 	mqd_t msg_q;
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	int  c_listen_fd[HTTP_CONF_MAX_CLIENT_HANDLE];	/* One listening socket per client handler */
+	int  c_next;			/* Next listening socket to take, under sem_thread_sync */
+	int  c_running;			/* Client handlers still running, under sem_thread_sync */
+#endif
 
 	int                       tls_init;
 #ifdef CONFIG_NET_SECURITY_TLS
@@ -181,8 +201,9 @@ struct http_server_t {
 
 	struct sockaddr_in             servaddr;
 	http_cb_t cb[4];
-	struct http_query_handler_t
-	*query_handlers[HTTP_CONF_MAX_QUERY_HANDLER_COUNT];
+	struct http_query_handler_t *query_table[HTTP_CONF_QUERY_HASH_SIZE];	/* Routes without parameters */
+	struct http_query_handler_t *query_params;	/* Routes with parameters, in registration order */
+	int query_handler_count;
 #ifdef CONFIG_NETUTILS_WEBSOCKET
 	websocket_cb_t ws_cb;
 #endif
@@ -241,7 +262,9 @@ void http_server_release(struct http_server_t **server);
  *                   - HTTP_METHOD_PUT
  *                   - HTTP_METHOD_POST
  *                   - HTTP_METHOD_DELETE
- * @param[in] url_format url to register cb.
+ * @param[in] url_format url to register cb. A segment starting with ':',
+ *                       as in '/device/:id', matches any segment of the URL,
+ *                       passed to the callback as a path parameter.
  * @param[in] func pointer of the callback function.
  * @return On success, HTTP_OK(0) is returned.
  *         On failure, HTTP_ERROR(-1) is returned.
@@ -265,6 +288,28 @@ int http_server_register_cb(struct http_server_t *server, int method, const char
  */
 int http_server_deregister_cb(struct http_server_t *server, int method, const char *url_format);
 
+/**
+ * @brief http_get_path_param() returns a path parameter of a request.
+ *
+ * @param[in] req request message passed to the callback.
+ * @param[in] key name of the parameter, ':id' in the url format being 'id'.
+ * @return On success, the value of the parameter is returned.
+ *         If the route has no such parameter, NULL is returned.
+ * @since Tizen RT v1.0
+ */
+const char *http_get_path_param(struct http_req_message *req, const char *key);
+
+/**
+ * @brief http_get_header() returns a header of a request.
+ *
+ * @param[in] req request message passed to the callback.
+ * @param[in] key name of the header, compared without case.
+ * @return On success, the value of the header is returned.
+ *         If the request has no such header, NULL is returned.
+ * @since Tizen RT v1.0
+ */
+const char *http_get_header(struct http_req_message *req, const char *key);
+
 /**
  * @brief http_send_response() sends the response.
  *        If receive request, you must send a response by this function.
@@ -280,6 +325,20 @@ int http_server_deregister_cb(struct http_server_t *server, int method, const ch
  */
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers);
 
+/**
+ * @brief http_send_file() sends a file as the response.
+ *        The response carries an ETag, and is a 304 without the file if
+ *        the If-None-Match header of the request holds the same tag.
+ *
+ * @param[in] client a pointer of HTTP client.
+ * @param[in] req request message, or NULL to always send the file.
+ * @param[in] path path of the file. If it does not exist, a 404 is sent.
+ * @return On success, HTTP_OK(0) is returned.
+ *         On failure, HTTP_ERROR(-1) is returned.
+ * @since Tizen RT v1.0
+ */
+int http_send_file(struct http_client_t *client, struct http_req_message *req, const char *path);
+
 #ifdef CONFIG_NET_SECURITY_TLS
 /**
  * @brief http_tls_init() initializes the TLS configuere for webserver.
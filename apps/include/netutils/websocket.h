@@ -99,6 +99,10 @@
  * @brief Websocket http handshake buffer size
  */
 #define WEBSOCKET_HANDSHAKE_HEADER_SIZE              (2048)
+/**
+ * @brief Websocket http handshake Sec-WebSocket-Extensions line buffer size
+ */
+#define WEBSOCKET_EXTENSION_HEADER_SIZE              (160)
 
 /**
  * @brief Websocket socket input timeout value, msec.
@@ -383,6 +387,12 @@ typedef struct {
 ///< Websocket event handler thread ID
 	pthread_attr_t thread_attr;
 ///< Websocket event handler thread attribute
+	int no_buffering;
+///< 1 - data frames are only delivered in place, through on_frame_recv_chunk_callback, without being copied into a message
+	int deflate_enabled;
+///< 1 - offer/accept permessage-deflate (RFC 7692) in the handshake, needs CONFIG_NETUTILS_WEBSOCKET_DEFLATE and buffering
+	struct websocket_deflate_s *deflate;
+///< Negotiated permessage-deflate state, NULL when messages are sent uncompressed
 } websocket_t;
 
 /**
@@ -140,6 +140,71 @@ fotahal_return_t fotahal_update_bootparam(fotahal_handle_t handle);
  *   close fotahal
  ****************************************************************************/
 fotahal_return_t fotahal_close(fotahal_handle_t handle);
+
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+/****************************************************************************
+ * Name: fotahal_stream_open
+ *
+ * Description:
+ *   Start a pipelined write of a bin_size bytes image to the partition and
+ *   binary set before.  Chunks are received into one buffer while the
+ *   previous one is programmed by a writer thread.
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_open(fotahal_handle_t handle, uint32_t bin_size);
+
+/****************************************************************************
+ * Name: fotahal_stream_getbuf
+ *
+ * Description:
+ *   Get the buffer to receive the next chunk into, and its size.
+ *   Return NULL on failure
+ ****************************************************************************/
+char *fotahal_stream_getbuf(fotahal_handle_t handle, uint32_t *size);
+
+/****************************************************************************
+ * Name: fotahal_stream_put
+ *
+ * Description:
+ *   Queue len bytes of the buffer from fotahal_stream_getbuf for writing
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_put(fotahal_handle_t handle, uint32_t len);
+
+/****************************************************************************
+ * Name: fotahal_stream_close
+ *
+ * Description:
+ *   Finish the pipelined write, checking the image against the SHA-256
+ *   digest sha256 unless it is NULL
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_close(fotahal_handle_t handle, const uint8_t *sha256);
+#endif
+
+#ifdef CONFIG_SYSTEM_FOTA_HAL_DELTA
+/****************************************************************************
+ * Name: fotahal_delta_open
+ *
+ * Description:
+ *   Start applying a delta patch against the running image, read in place
+ *   from old_image, to the partition and binary set before
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_open(fotahal_handle_t handle, const uint8_t *old_image, uint32_t old_size);
+
+/****************************************************************************
+ * Name: fotahal_delta_write
+ *
+ * Description:
+ *   Apply the next len bytes of the patch
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_write(fotahal_handle_t handle, const char *patch, uint32_t len);
+
+/****************************************************************************
+ * Name: fotahal_delta_close
+ *
+ * Description:
+ *   Finish the patch and check the new image
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_close(fotahal_handle_t handle);
+#endif
 #undef EXTERN
 #ifdef __cplusplus
 }
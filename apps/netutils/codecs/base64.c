@@ -70,6 +70,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
@@ -79,28 +80,58 @@
 #ifdef CONFIG_CODECS_BASE64
 
 /****************************************************************************
- * Private Functions
+ * Private Data
  ****************************************************************************/
 
+static const unsigned char g_base64_table[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const unsigned char g_base64w_table[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/* Reverse tables: the 6-bit value of each character, 0 for the pad
+ * character and 0x80 for characters that are skipped.
+ */
+
+static const unsigned char g_base64_dtable[256] = {
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x00, 0x80, 0x80,
+	0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+static const unsigned char g_base64w_dtable[256] = {
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x00, 0x80,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x3f,
+	0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
 /****************************************************************************
- * Name: base64_tab
+ * Private Functions
  ****************************************************************************/
 
-static void base64_tab(unsigned char *tab, size_t len, bool websafe)
-{
-	static const char *_tab = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-	memset(tab, 0, len);
-	if (len >= 64) {
-		memcpy(tab, _tab, 64);
-	}
-
-	if (websafe) {
-		tab[62] = '-';
-		tab[63] = '_';
-	}
-}
-
 /****************************************************************************
  * Name: _base64_encode
  *
@@ -130,14 +161,15 @@ static unsigned char *_base64_encode(const unsigned char *src, size_t len, unsig
 	const unsigned char *in;
 	size_t olen;
 	/*int line_len; */
-	unsigned char base64_table[64];
+	const unsigned char *base64_table = g_base64_table;
 	char ch = '=';
+	uint32_t v;
 
 	if (websafe) {
+		base64_table = g_base64w_table;
 		ch = '.';
 	}
 
-	base64_tab(base64_table, sizeof(base64_table), websafe);
 	olen = len * 4 / 3 + 4;		/* 3-byte blocks to 4-byte */
 
 #if 0
@@ -162,11 +194,34 @@ static unsigned char *_base64_encode(const unsigned char *src, size_t len, unsig
 	}
 
 	/*line_len = 0; */
-	while (end - in >= 3) {
-		*pos++ = base64_table[in[0] >> 2];
-		*pos++ = base64_table[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-		*pos++ = base64_table[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
-		*pos++ = base64_table[in[2] & 0x3f];
+
+	/* Each group of 3 bytes is loaded as one 24-bit word and split into
+	 * four 6-bit indices; two groups per iteration.
+	 */
+
+	while (end - in >= 6) {
+		v = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+		pos[0] = base64_table[v >> 18];
+		pos[1] = base64_table[(v >> 12) & 0x3f];
+		pos[2] = base64_table[(v >> 6) & 0x3f];
+		pos[3] = base64_table[v & 0x3f];
+		v = ((uint32_t)in[3] << 16) | ((uint32_t)in[4] << 8) | in[5];
+		pos[4] = base64_table[v >> 18];
+		pos[5] = base64_table[(v >> 12) & 0x3f];
+		pos[6] = base64_table[(v >> 6) & 0x3f];
+		pos[7] = base64_table[v & 0x3f];
+		pos += 8;
+		in += 6;
+		/* line_len += 8; */
+	}
+
+	if (end - in >= 3) {
+		v = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+		pos[0] = base64_table[v >> 18];
+		pos[1] = base64_table[(v >> 12) & 0x3f];
+		pos[2] = base64_table[(v >> 6) & 0x3f];
+		pos[3] = base64_table[v & 0x3f];
+		pos += 4;
 		in += 3;
 		/* line_len += 4; */
 	}
@@ -219,28 +274,22 @@ static unsigned char *_base64_encode(const unsigned char *src, size_t len, unsig
 
 static unsigned char *_base64_decode(const unsigned char *src, size_t len, unsigned char *dst, size_t *out_len, bool websafe)
 {
-	unsigned char dtable[256];
+	const unsigned char *dtable = g_base64_dtable;
 	unsigned char *out;
 	unsigned char *pos;
 	unsigned char in[4];
 	unsigned char block[4];
+	const unsigned char *last = in;
 	unsigned char tmp;
 	size_t count;
 	size_t i;
-	unsigned char base64_table[64];
+	uint32_t v;
 	char ch = '=';
 
 	if (websafe) {
+		dtable = g_base64w_dtable;
 		ch = '.';
 	}
-	base64_tab(base64_table, sizeof(base64_table), websafe);
-
-	memset(dtable, 0x80, 256);
-	for (i = 0; i < sizeof(base64_table); i++) {
-		dtable[base64_table[i]] = i;
-	}
-
-	dtable[(int)ch] = 0;		/* dtable['='] = 0; */
 
 	count = 0;
 	for (i = 0; i < len; i++) {
@@ -263,27 +312,51 @@ static unsigned char *_base64_decode(const unsigned char *src, size_t len, unsig
 	}
 
 	count = 0;
-	for (i = 0; i < len; i++) {
-		tmp = dtable[src[i]];
+	i = 0;
+	while (i < len) {
+		/* Four valid characters in a row are merged into one 24-bit word;
+		 * anything else (line breaks, a group split by them) goes through
+		 * the character at a time path below.
+		 */
+
+		if (count == 0 && len - i >= 4) {
+			block[0] = dtable[src[i]];
+			block[1] = dtable[src[i + 1]];
+			block[2] = dtable[src[i + 2]];
+			block[3] = dtable[src[i + 3]];
+			if (((block[0] | block[1] | block[2] | block[3]) & 0x80) == 0) {
+				v = ((uint32_t)block[0] << 18) | ((uint32_t)block[1] << 12) | ((uint32_t)block[2] << 6) | block[3];
+				pos[0] = v >> 16;
+				pos[1] = v >> 8;
+				pos[2] = v;
+				pos += 3;
+				last = &src[i];
+				i += 4;
+				continue;
+			}
+		}
+
+		tmp = dtable[src[i++]];
 		if (tmp == 0x80) {
 			continue;
 		}
 
-		in[count] = src[i];
+		in[count] = src[i - 1];
 		block[count] = tmp;
 		count++;
 		if (count == 4) {
 			*pos++ = (block[0] << 2) | (block[1] >> 4);
 			*pos++ = (block[1] << 4) | (block[2] >> 2);
 			*pos++ = (block[2] << 6) | block[3];
+			last = in;
 			count = 0;
 		}
 	}
 
 	if (pos > out) {
-		if (in[2] == ch) {		/* if (in[2] == '=') */
+		if (last[2] == ch) {	/* if (in[2] == '=') */
 			pos -= 2;
-		} else if (in[3] == ch) {	/* else if (in[3] == '=') */
+		} else if (last[3] == ch) {	/* else if (in[3] == '=') */
 			pos--;
 		}
 	}
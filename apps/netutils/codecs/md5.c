@@ -196,7 +196,20 @@ void MD5Update(struct MD5Context *ctx, unsigned char const *buf, unsigned len)
 		len -= t;
 	}
 
-	/* Process data in 64-byte chunks */
+	/* Process data in 64-byte chunks.  On little-endian targets the
+	 * message words are already in host order, so word-aligned input is
+	 * transformed where it lies instead of being staged in ctx->in.
+	 */
+
+#ifndef CONFIG_ENDIAN_BIG
+	if (((uintptr_t)buf & 3) == 0) {
+		while (len >= 64) {
+			MD5Transform(ctx->buf, (uint32_t const *)buf);
+			buf += 64;
+			len -= 64;
+		}
+	}
+#endif
 
 	while (len >= 64) {
 		memcpy(ctx->in, buf, 64);
@@ -116,6 +116,8 @@
 
 #define BUFFER_SIZE             256
 
+#define CNT_MAX_REBOOT          2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -157,6 +159,16 @@ struct dhcpc_state_s {
 static const uint8_t g_dhcpc_xid[4] = { 0xad, 0xde, 0x12, 0x23 };
 static const uint8_t magic_cookie[4] = { 99, 130, 83, 99 };
 
+#ifdef CONFIG_NETUTILS_DHCPC_INIT_REBOOT
+/* The last lease obtained, asked for again before discovering */
+
+static struct {
+	char nic[10];
+	uint8_t macaddr[16];
+	struct in_addr ipaddr;
+} g_dhcpc_lease;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -247,8 +259,14 @@ static int dhcpc_sendmsg(struct dhcpc_state_s *pdhcpc, struct dhcpc_state *presu
 
 	case DHCPREQUEST:
 		pdhcpc->packet.flags = HTONS(BOOTP_BROADCAST);	/*  Broadcast bit. */
-		memcpy(pdhcpc->packet.ciaddr, &pdhcpc->ipaddr.s_addr, 4);
-		pend = dhcpc_addserverid(&pdhcpc->serverid, pend);
+		if (pdhcpc->serverid.s_addr != INADDR_ANY) {
+			memcpy(pdhcpc->packet.ciaddr, &pdhcpc->ipaddr.s_addr, 4);
+			pend = dhcpc_addserverid(&pdhcpc->serverid, pend);
+		} else {
+			/* INIT-REBOOT: no server yet, ciaddr stays zero (RFC 2131, 4.3.2) */
+
+			pend = dhcpc_addreqoptions(pend);
+		}
 		pend = dhcpc_addreqipaddr(&pdhcpc->ipaddr, pend);
 		break;
 
@@ -352,6 +370,88 @@ static uint8_t dhcpc_parsemsg(struct dhcpc_state_s *pdhcpc, int buflen, struct d
 	return 0;
 }
 
+#ifdef CONFIG_NETUTILS_DHCPC_INIT_REBOOT
+/****************************************************************************
+ * Name: dhcpc_reboot
+ *
+ * Description:
+ *   Ask for the last lease on this interface with a broadcast REQUEST and
+ *   no preceding DISCOVER/OFFER.  Servers that know the address ACK it,
+ *   which saves a round trip and the OFFER delay; a NAK or silence sends
+ *   the caller back to DISCOVER.
+ *
+ ****************************************************************************/
+
+static int dhcpc_reboot(struct dhcpc_state_s *pdhcpc, struct dhcpc_state *presult)
+{
+	struct timeval tv;
+	uint8_t msgtype;
+	int retries;
+	int result;
+	int ret = ERROR;
+
+	if (g_dhcpc_lease.ipaddr.s_addr == INADDR_ANY || strncmp(g_dhcpc_lease.nic, pdhcpc->nic, sizeof(g_dhcpc_lease.nic)) != 0 || memcmp(g_dhcpc_lease.macaddr, pdhcpc->ds_macaddr, pdhcpc->ds_maclen) != 0) {
+		return ERROR;
+	}
+
+	pdhcpc->ipaddr.s_addr = g_dhcpc_lease.ipaddr.s_addr;
+	pdhcpc->serverid.s_addr = INADDR_ANY;
+
+	/* Do not wait the full DISCOVER timeout for a server that stays silent */
+
+	tv.tv_sec = CONFIG_NETUTILS_DHCPC_INIT_REBOOT_TIMEOUT / 1000;
+	tv.tv_usec = (CONFIG_NETUTILS_DHCPC_INIT_REBOOT_TIMEOUT % 1000) * 1000;
+	(void)setsockopt(pdhcpc->sockfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(struct timeval));
+
+	for (retries = 0; retries < CNT_MAX_REBOOT && ret != OK; retries++) {
+		ndbg("Send INIT-REBOOT Request Packet\n");
+		result = dhcpc_sendmsg(pdhcpc, presult, DHCPREQUEST);
+		if (result < 0) {
+			break;
+		}
+
+		result = recv(pdhcpc->sockfd, &pdhcpc->packet, sizeof(struct dhcp_msg), 0);
+		if (result <= 0) {
+			continue;
+		}
+
+		msgtype = dhcpc_parsemsg(pdhcpc, result, presult);
+		if (msgtype == DHCPACK && presult->ipaddr.s_addr == g_dhcpc_lease.ipaddr.s_addr) {
+			ndbg("Received ACK for the last lease\n");
+			pdhcpc->serverid.s_addr = presult->serverid.s_addr;
+			(void)netlib_set_ipv4addr(pdhcpc->nic, &presult->ipaddr);
+			ret = OK;
+		} else if (msgtype == DHCPNAK) {
+			ndbg("Received NAK, forget the last lease\n");
+			g_dhcpc_lease.ipaddr.s_addr = INADDR_ANY;
+			break;
+		}
+	}
+
+	tv.tv_sec = 10;
+	tv.tv_usec = 0;
+	(void)setsockopt(pdhcpc->sockfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(struct timeval));
+
+	if (ret != OK) {
+		pdhcpc->ipaddr.s_addr = INADDR_ANY;
+		memset(presult, 0, sizeof(struct dhcpc_state));
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: dhcpc_savelease
+ ****************************************************************************/
+
+static void dhcpc_savelease(struct dhcpc_state_s *pdhcpc, struct dhcpc_state *presult)
+{
+	memcpy(g_dhcpc_lease.nic, pdhcpc->nic, sizeof(g_dhcpc_lease.nic));
+	memcpy(g_dhcpc_lease.macaddr, pdhcpc->ds_macaddr, sizeof(g_dhcpc_lease.macaddr));
+	g_dhcpc_lease.ipaddr.s_addr = presult->ipaddr.s_addr;
+}
+#endif
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -485,6 +585,13 @@ int dhcpc_request(void *handle, struct dhcpc_state *presult)
 		ndbg("netlib_set_ipv4addr failed\n");
 	}
 
+#ifdef CONFIG_NETUTILS_DHCPC_INIT_REBOOT
+	if (dhcpc_reboot(pdhcpc, presult) == OK) {
+		g_dhcpc_state = STATE_HAVE_LEASE;
+		goto have_lease;
+	}
+#endif
+
 	/* Loop sending DISCOVER until we receive an OFFER from a DHCP
 	 * server.  We will lock on to the first OFFER and decline any
 	 * subsequent offers (which will happen if there are more than one
@@ -618,6 +725,13 @@ int dhcpc_request(void *handle, struct dhcpc_state *presult)
 		 */
 	} while (g_dhcpc_state == STATE_HAVE_OFFER);
 
+#ifdef CONFIG_NETUTILS_DHCPC_INIT_REBOOT
+have_lease:
+	if (g_dhcpc_state == STATE_HAVE_LEASE) {
+		dhcpc_savelease(pdhcpc, presult);
+	}
+#endif
+
 	ndbg("Got IP address %d.%d.%d.%d\n", (presult->ipaddr.s_addr) & 0xff, (presult->ipaddr.s_addr >> 8) & 0xff, (presult->ipaddr.s_addr >> 16) & 0xff, (presult->ipaddr.s_addr >> 24) & 0xff);
 	ndbg("Got netmask %d.%d.%d.%d\n", (presult->netmask.s_addr) & 0xff, (presult->netmask.s_addr >> 8) & 0xff, (presult->netmask.s_addr >> 16) & 0xff, (presult->netmask.s_addr >> 24) & 0xff);
 	ndbg("Got DNS server %d.%d.%d.%d\n", (presult->dnsaddr.s_addr) & 0xff, (presult->dnsaddr.s_addr >> 8) & 0xff, (presult->dnsaddr.s_addr >> 16) & 0xff, (presult->dnsaddr.s_addr >> 24) & 0xff);
@@ -65,6 +65,11 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/select.h>
+#include <sys/ioctl.h>
+#ifdef CONFIG_NET_SENDFILE
+#include <sys/sendfile.h>
+#include <tinyara/fs/ioctl.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -134,6 +139,8 @@ static off_t ftpd_offsatoi(FAR const char *filename, off_t offset);
 static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype);
 static uint8_t ftpd_listoption(FAR char **param);
 static int ftpd_listbuffer(FAR struct ftpd_session_s *session, FAR char *path, FAR struct stat *st, FAR char *buffer, size_t buflen, unsigned int opton);
+static int ftpd_listflush(FAR struct ftpd_session_s *session, FAR size_t *used);
+static int ftpd_listentry(FAR struct ftpd_session_s *session, FAR char *path, FAR struct stat *st, FAR struct dirent *entry, unsigned int opton, FAR size_t *used);
 static int fptd_listscan(FAR struct ftpd_session_s *session, FAR char *path, unsigned int opton);
 static int ftpd_list(FAR struct ftpd_session_s *session, unsigned int opton);
 
@@ -159,6 +166,7 @@ static int ftpd_command_pasv(FAR struct ftpd_session_s *session);
 static int ftpd_command_epsv(FAR struct ftpd_session_s *session);
 static int ftpd_command_list(FAR struct ftpd_session_s *session);
 static int ftpd_command_nlst(FAR struct ftpd_session_s *session);
+static int ftpd_command_mlsd(FAR struct ftpd_session_s *session);
 static int ftpd_command_acct(FAR struct ftpd_session_s *session);
 static int ftpd_command_size(FAR struct ftpd_session_s *session);
 static int ftpd_command_stru(FAR struct ftpd_session_s *session);
@@ -213,6 +221,7 @@ static const struct ftpd_cmd_s g_ftpdcmdtab[] = {
 	{"LPSV", ftpd_command_epsv, FTPD_CMDFLAG_LOGIN},	/* LPSV ??? */
 	{"LIST", ftpd_command_list, FTPD_CMDFLAG_LOGIN},	/* LIST [<SP> <pathname>] <CRLF> */
 	{"NLST", ftpd_command_nlst, FTPD_CMDFLAG_LOGIN},	/* NLST [<SP> <pathname>] <CRLF> */
+	{"MLSD", ftpd_command_mlsd, FTPD_CMDFLAG_LOGIN},	/* MLSD [<SP> <pathname>] <CRLF> */
 	{"ACCT", ftpd_command_acct, FTPD_CMDFLAG_LOGIN},	/* ACCT <SP> <account-information> <CRLF> */
 	{"SIZE", ftpd_command_size, FTPD_CMDFLAG_LOGIN},	/* SIZE <SP> <pathname> <CRLF> */
 	{"STRU", ftpd_command_stru, FTPD_CMDFLAG_LOGIN},	/* STRU <SP> <structure-code> <CRLF> */
@@ -252,7 +261,7 @@ static const char *g_ftpdhelp[] = {
 	"NOOP    FEAT*   OPTS    AUTH*   CCC*    CONF*   ENC*    MIC*",
 	"PBSZ*   PROT*   TYPE    STRU*   MODE*   RETR    STOR    STOU*",
 	"APPE    REST    ABOR    USER    PASS    ACCT*   REIN*   LIST",
-	"NLST    STAT*   SITE*   MLSD*   MLST*",
+	"NLST    STAT*   SITE*   MLSD    MLST*",
 	"Direct comments to " CONFIG_FTPD_VENDORID,
 	NULL
 };
@@ -824,13 +833,20 @@ static ssize_t ftpd_send(int sd, FAR const void *data, size_t size, int timeout)
 	}
 #endif
 
-	/* Then send the data (waiting if necessary) */
+	/* Then send the data (waiting if necessary).  A large buffer may be
+	 * accepted in pieces as the send window opens.
+	 */
 
-	ret = send(sd, data, size, 0);
-	if (ret < 0) {
-		ssize_t errval = errno;
-		ndbg("send() failed: %d\n", errval);
-		return -errval;
+	ret = 0;
+	while ((size_t)ret < size) {
+		ssize_t nsent = send(sd, (FAR const uint8_t *)data + ret, size - ret, 0);
+		if (nsent < 0) {
+			ssize_t errval = errno;
+			ndbg("send() failed: %d\n", errval);
+			return -errval;
+		}
+
+		ret += nsent;
 	}
 
 	return ret;
@@ -1589,6 +1605,37 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
 		goto errout_with_session;
 	}
 
+#ifdef CONFIG_NET_SENDFILE
+	/* A binary download of a file that the file system maps in memory is
+	 * queued to the socket in place, without passing through the buffer.
+	 */
+
+	if (cmdtype == 0 && session->type != FTPD_SESSIONTYPE_A) {
+		FAR void *base = NULL;
+		struct stat st;
+
+		if (ioctl(session->fd, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) == OK && base && fstat(session->fd, &st) == OK) {
+			ret = 0;
+			while (pos < st.st_size) {
+				wrbytes = sendfile(session->data.sd, session->fd, &pos, st.st_size - pos);
+				if (wrbytes <= 0) {
+					ret = wrbytes < 0 ? -errno : -EIO;
+					ndbg("sendfile failed: %d\n", ret);
+					break;
+				}
+			}
+
+			if (ret < 0) {
+				(void)ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 550, ' ', "Data send error !");
+			} else {
+				(void)ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 226, ' ', "Transfer complete");
+			}
+
+			goto errout_with_session;
+		}
+	}
+#endif
+
 	for (;;) {
 		/* Read from the source (file or TCP connection) */
 
@@ -1934,6 +1981,75 @@ static int ftpd_listbuffer(FAR struct ftpd_session_s *session, FAR char *path, F
 	return 0;
 }
 
+/****************************************************************************
+ * Name: ftpd_listflush
+ *
+ * Description:
+ *   Send the listing lines collected in the data buffer.
+ *
+ ****************************************************************************/
+
+static int ftpd_listflush(FAR struct ftpd_session_s *session, FAR size_t *used)
+{
+	ssize_t ret = 0;
+
+	if (*used > 0) {
+		ret = ftpd_send(session->data.sd, session->data.buffer, *used, session->txtimeout);
+		*used = 0;
+	}
+
+	return ret < 0 ? (int)ret : 0;
+}
+
+/****************************************************************************
+ * Name: ftpd_listentry
+ *
+ * Description:
+ *   Append the listing line of one entry to the data buffer, sending the
+ *   lines collected so far first if it does not fit.  MLSD lines are made
+ *   from the directory entry alone ('entry' is not NULL), other listings
+ *   from the stat() data in 'st'.
+ *
+ ****************************************************************************/
+
+static int ftpd_listentry(FAR struct ftpd_session_s *session, FAR char *path, FAR struct stat *st, FAR struct dirent *entry, unsigned int opton, FAR size_t *used)
+{
+	FAR char *buffer;
+	size_t avail;
+	size_t len;
+	int ret;
+
+	for (;;) {
+		buffer = &session->data.buffer[*used];
+		avail = session->data.buflen - *used;
+
+		if (entry) {
+			snprintf(buffer, avail, "type=%s; %s\r\n", DIRENT_ISDIRECTORY(entry->d_type) ? "dir" : "file", entry->d_name);
+		} else {
+			ret = ftpd_listbuffer(session, path, st, buffer, avail, opton);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		/* A line that filled the space may have been cut short.  Send what
+		 * is pending and format it again, unless it already had the whole
+		 * buffer.
+		 */
+
+		len = strlen(buffer);
+		if (len + 1 < avail || *used == 0) {
+			*used += len;
+			return 0;
+		}
+
+		ret = ftpd_listflush(session, used);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+}
+
 /****************************************************************************
  * Name: fptd_listscan
  ****************************************************************************/
@@ -1944,6 +2060,7 @@ static int fptd_listscan(FAR struct ftpd_session_s *session, FAR char *path, uns
 	DIR *dir;
 	struct dirent *entry;
 	struct stat st;
+	size_t used = 0;
 	int ret;
 
 	ret = stat(path, &st);
@@ -1952,9 +2069,13 @@ static int fptd_listscan(FAR struct ftpd_session_s *session, FAR char *path, uns
 	}
 
 	if (!S_ISDIR(st.st_mode)) {
-		ret = ftpd_listbuffer(session, path, &st, session->data.buffer, session->data.buflen, opton);
+		if ((opton & FTPD_LISTOPTION_MLSD) != 0) {
+			return -ENOTDIR;
+		}
+
+		ret = ftpd_listentry(session, path, &st, NULL, opton, &used);
 		if (ret == 0) {
-			ret = ftpd_response(session->data.sd, session->txtimeout, "%s", (FAR char *)session->data.buffer);
+			ret = ftpd_listflush(session, &used);
 		}
 
 		return ret;
@@ -1979,21 +2100,28 @@ static int fptd_listscan(FAR struct ftpd_session_s *session, FAR char *path, uns
 			}
 		}
 
+		/* MLSD needs only the type, which the directory entry carries */
+
+		if ((opton & FTPD_LISTOPTION_MLSD) != 0) {
+			ret = ftpd_listentry(session, NULL, NULL, entry, opton, &used);
+			if (ret < 0) {
+				break;
+			}
+
+			continue;
+		}
+
 		asprintf(&temp, "%s/%s", path, entry->d_name);
 		if (!temp) {
 			continue;
 		}
 
-		ret = stat(temp, &st);
-		if (ret < 0) {
+		if (stat(temp, &st) < 0) {
 			free(temp);
 			continue;
 		}
 
-		ret = ftpd_listbuffer(session, temp, &st, session->data.buffer, session->data.buflen, opton);
-		if (ret >= 0) {
-			ret = ftpd_response(session->data.sd, session->txtimeout, "%s", session->data.buffer);
-		}
+		ret = ftpd_listentry(session, temp, &st, NULL, opton, &used);
 
 		free(temp);
 		if (ret < 0) {
@@ -2001,6 +2129,10 @@ static int fptd_listscan(FAR struct ftpd_session_s *session, FAR char *path, uns
 		}
 	}
 
+	if (ret >= 0) {
+		ret = ftpd_listflush(session, &used);
+	}
+
 	(void)closedir(dir);
 	return ret;
 }
@@ -2798,6 +2930,38 @@ static int ftpd_command_nlst(FAR struct ftpd_session_s *session)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: ftpd_command_mlsd
+ ****************************************************************************/
+
+static int ftpd_command_mlsd(FAR struct ftpd_session_s *session)
+{
+	int ret;
+
+	ret = ftpd_dataopen(session);
+	if (ret < 0) {
+		return 0;
+	}
+
+	ret = ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 150, ' ', "Opening ASCII mode data connection for MLSD");
+	if (ret < 0) {
+		(void)ftpd_dataclose(session);
+		return ret;
+	}
+
+	/* MLSD takes no options and lists hidden entries as well */
+
+	ret = ftpd_list(session, FTPD_LISTOPTION_MLSD | FTPD_LISTOPTION_A);
+	if (ret == -ENOTDIR) {
+		ret = ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 501, ' ', "Not a directory");
+	} else {
+		ret = ftpd_response(session->cmd.sd, session->txtimeout, g_respfmt1, 226, ' ', "Transfer complete");
+	}
+
+	(void)ftpd_dataclose(session);
+	return ret;
+}
+
 /****************************************************************************
  * Name: ftpd_command_acct
  ****************************************************************************/
@@ -77,6 +77,7 @@
 #define FTPD_LISTOPTION_L           (1 << 1)	/* List option 'L' */
 #define FTPD_LISTOPTION_F           (1 << 2)	/* List option 'F' */
 #define FTPD_LISTOPTION_R           (1 << 3)	/* List option 'R' */
+#define FTPD_LISTOPTION_MLSD        (1 << 4)	/* Machine listing (MLSD) */
 #define FTPD_LISTOPTION_UNKNOWN     (1 << 7)	/* Unknown list option */
 
 #define FTPD_CMDFLAG_LOGIN          (1 << 0)	/* Command requires login */
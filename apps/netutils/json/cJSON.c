@@ -51,6 +51,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -66,6 +67,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Output of the print functions */
+
+typedef struct {
+	char *buffer;
+	size_t length;				/* Size of buffer */
+	size_t offset;				/* Length of the text so far */
+	int noalloc;				/* The buffer belongs to the caller */
+} printbuffer;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -81,12 +95,12 @@ static void (*cJSON_free)(void *ptr) = free;
  * Private Prototypes
  ****************************************************************************/
 
-static const char *parse_value(cJSON *item, const char *value);
-static char *print_value(cJSON *item, int depth, int fmt);
-static const char *parse_array(cJSON *item, const char *value);
-static char *print_array(cJSON *item, int depth, int fmt);
-static const char *parse_object(cJSON *item, const char *value);
-static char *print_object(cJSON *item, int depth, int fmt);
+static const char *parse_value(cJSON *item, const char *value, cJSON_Arena *arena);
+static int print_value(cJSON *item, int depth, int fmt, printbuffer *p);
+static const char *parse_array(cJSON *item, const char *value, cJSON_Arena *arena);
+static int print_array(cJSON *item, int depth, int fmt, printbuffer *p);
+static const char *parse_object(cJSON *item, const char *value, cJSON_Arena *arena);
+static int print_object(cJSON *item, int depth, int fmt, printbuffer *p);
 
 /****************************************************************************
  * Private Functions
@@ -118,6 +132,39 @@ static cJSON *cJSON_New_Item(void)
 	return node;
 }
 
+/* Allocate from an arena, aligned for any member of cJSON. */
+
+static void *cJSON_arena_alloc(cJSON_Arena *arena, size_t size)
+{
+	uintptr_t start = ((uintptr_t)arena->buffer + arena->used + sizeof(double) - 1) & ~(uintptr_t)(sizeof(double) - 1);
+	size_t used = start - (uintptr_t)arena->buffer + size;
+
+	if (used > arena->size) {
+		return 0;
+	}
+
+	arena->used = used;
+	return (void *)start;
+}
+
+/* Constructor for the parser: from the arena if there is one. */
+
+static cJSON *cJSON_New_Parse_Item(cJSON_Arena *arena)
+{
+	cJSON *node;
+
+	if (!arena) {
+		return cJSON_New_Item();
+	}
+
+	node = (cJSON *)cJSON_arena_alloc(arena, sizeof(cJSON));
+	if (node) {
+		memset(node, 0, sizeof(cJSON));
+	}
+
+	return node;
+}
+
 static int cJSON_strcasecmp(const char *s1, const char *s2)
 {
 	if (!s1) {
@@ -205,41 +252,150 @@ static const char *parse_number(cJSON *item, const char *num)
 	return num;
 }
 
-/* Render the number nicely from the given item into a string. */
+/* Make room for 'needed' more bytes at the end of the output, plus the
+ * terminating NUL, and return where to write them.  A buffer of the
+ * caller is never grown.
+ */
 
-static char *print_number(cJSON *item)
+static char *ensure(printbuffer *p, size_t needed)
 {
-	char *str;
+	char *newbuffer;
+	size_t newsize;
+
+	needed += p->offset + 1;
+	if (needed <= p->length) {
+		return p->buffer + p->offset;
+	}
+
+	if (p->noalloc) {
+		return 0;
+	}
+
+	newsize = p->length ? p->length : 64;
+	while (newsize < needed) {
+		newsize *= 2;
+	}
+
+	newbuffer = (char *)cJSON_malloc(newsize);
+	if (!newbuffer) {
+		return 0;
+	}
+
+	if (p->buffer) {
+		memcpy(newbuffer, p->buffer, p->offset);
+		cJSON_free(p->buffer);
+	}
+
+	p->buffer = newbuffer;
+	p->length = newsize;
+	return p->buffer + p->offset;
+}
+
+static int print_raw(printbuffer *p, const char *str, size_t len)
+{
+	char *out = ensure(p, len);
+	if (!out) {
+		return 0;
+	}
+
+	memcpy(out, str, len);
+	p->offset += len;
+	return 1;
+}
+
+static int print_tabs(printbuffer *p, int count)
+{
+	char *out = ensure(p, count);
+	if (!out) {
+		return 0;
+	}
+
+	memset(out, '\t', count);
+	p->offset += count;
+	return 1;
+}
+
+/* Write the decimal digits of n backwards, ending before 'end'.  The
+ * 64-bit divisions are only done for the digits that need them.
+ */
+
+static char *print_digits(char *end, unsigned long long n)
+{
+	unsigned long n32;
+
+	while (n > 0xffffffffULL) {
+		*--end = '0' + (int)(n % 10);
+		n /= 10;
+	}
+
+	n32 = (unsigned long)n;
+	do {
+		*--end = '0' + (int)(n32 % 10);
+		n32 /= 10;
+	} while (n32);
+
+	return end;
+}
+
+/* Render the number nicely from the given item.  Integers and numbers in
+ * the "%f" range are formatted here, which is the common case; only
+ * exponents are left to the C library.  NaN and infinity have no JSON
+ * form and are rendered as null.
+ */
+
+static int print_number(cJSON *item, printbuffer *p)
+{
+	char str[32];
+	char *end = str + sizeof(str);
+	char *ptr;
 	double d = item->valuedouble;
+	double a = fabs(d);
+	unsigned long whole;
+	unsigned long frac;
+	int i;
 
-	if (fabs(((double)item->valueint) - d) <= DBL_EPSILON) {	/* && d<=INT_MAX && d>=INT_MIN) */
-		/* 2^64+1 can be represented in 21 chars. */
+	if (d != d || a > DBL_MAX) {
+		return print_raw(p, "null", 4);
+	}
 
-		str = (char *)cJSON_malloc(21);
-		if (str) {
-			sprintf(str, "%d", item->valueint);
-		}
+	if (a < 1.0e15 && floor(a) == a) {
+		ptr = print_digits(end, (unsigned long long)a);
+	} else if (a < 1.0e-6 || a > 1.0e9) {
+		i = snprintf(str, sizeof(str), "%e", d);
+		return i > 0 && i < (int)sizeof(str) && print_raw(p, str, i);
 	} else {
-		/* This is a nice tradeoff. */
-
-		str = (char *)cJSON_malloc(64);
-		if (str) {
-			if (fabs(floor(d) - d) <= DBL_EPSILON) {
-				sprintf(str, "%d", item->valueint);
-			} else if (fabs(d) < 1.0e-6 || fabs(d) > 1.0e9) {
-				sprintf(str, "%e", d);
-			} else {
-				sprintf(str, " %f", d);
-			}
+		/* Six decimals, rounded, like "%f" */
+
+		whole = (unsigned long)a;
+		frac = (unsigned long)((a - whole) * 1.0e6 + 0.5);
+		if (frac >= 1000000) {
+			whole++;
+			frac -= 1000000;
 		}
+
+		ptr = end;
+		for (i = 0; i < 6; i++) {
+			*--ptr = '0' + frac % 10;
+			frac /= 10;
+		}
+
+		*--ptr = '.';
+		ptr = print_digits(ptr, whole);
 	}
 
-	return str;
+	if (d < 0) {
+		*--ptr = '-';
+	}
+
+	return print_raw(p, ptr, end - ptr);
 }
 
-/* Parse the input text into an unescaped cstring, and populate item. */
+/* Parse the input text into an unescaped cstring, and populate item.  With
+ * an arena, the string is unescaped in place: it is never longer than its
+ * escaped form, and its closing quote is overwritten by the terminator.
+ */
 
-static const char *parse_string(cJSON *item, const char *str)
+static const char *parse_string(cJSON *item, const char *str, cJSON_Arena *arena)
 {
 	const char *ptr = str + 1;
 	char *ptr2;
@@ -265,9 +421,13 @@ static const char *parse_string(cJSON *item, const char *str)
 
 	/* This is how long we need for the string, roughly. */
 
-	out = (char *)cJSON_malloc(len + 1);
-	if (!out) {
-		return 0;
+	if (arena) {
+		out = (char *)str + 1;
+	} else {
+		out = (char *)cJSON_malloc(len + 1);
+		if (!out) {
+			return 0;
+		}
 	}
 
 	ptr = str + 1;
@@ -366,10 +526,12 @@ static const char *parse_string(cJSON *item, const char *str)
 		}
 	}
 
-	*ptr2 = 0;
+	/* Step over the closing quote before it may be overwritten in place */
+
 	if (*ptr == '\"') {
 		ptr++;
 	}
+	*ptr2 = 0;
 
 	item->valuestring = out;
 	item->type = cJSON_String;
@@ -378,15 +540,15 @@ static const char *parse_string(cJSON *item, const char *str)
 
 /* Render the cstring provided to an escaped version that can be printed. */
 
-static char *print_string_ptr(const char *str)
+static int print_string_ptr(const char *str, printbuffer *p)
 {
 	const char *ptr;
-	char *ptr2, *out;
+	char *ptr2;
 	int len = 0;
 	unsigned char token;
 
 	if (!str) {
-		return cJSON_strdup("");
+		return 1;
 	}
 
 	ptr = str;
@@ -400,12 +562,12 @@ static char *print_string_ptr(const char *str)
 		ptr++;
 	}
 
-	out = (char *)cJSON_malloc(len + 3);
-	if (!out) {
+	ptr2 = ensure(p, len + 2);
+	if (!ptr2) {
 		return 0;
 	}
 
-	ptr2 = out;
+	p->offset += len + 2;
 	ptr = str;
 	*ptr2++ = '\"';
 	while (*ptr) {
@@ -445,23 +607,25 @@ static char *print_string_ptr(const char *str)
 			default:
 				/* Escape and print */
 
-				sprintf(ptr2, "u%04x", token);
-				ptr2 += 5;
+				*ptr2++ = 'u';
+				*ptr2++ = '0';
+				*ptr2++ = '0';
+				*ptr2++ = "0123456789abcdef"[token >> 4];
+				*ptr2++ = "0123456789abcdef"[token & 15];
 				break;
 			}
 		}
 	}
 
-	*ptr2++ = '\"';
-	*ptr2++ = 0;
-	return out;
+	*ptr2 = '\"';
+	return 1;
 }
 
 /* Invote print_string_ptr (which is useful) on an item. */
 
-static char *print_string(cJSON *item)
+static int print_string(cJSON *item, printbuffer *p)
 {
-	return print_string_ptr(item->valuestring);
+	return print_string_ptr(item->valuestring, p);
 }
 
 /* Utility to jump whitespace and cr/lf */
@@ -477,7 +641,7 @@ static const char *skip(const char *in)
 
 /* Parser core - when encountering text, process appropriately. */
 
-static const char *parse_value(cJSON *item, const char *value)
+static const char *parse_value(cJSON *item, const char *value, cJSON_Arena *arena)
 {
 	if (!value) {
 		/* Fail on null. */
@@ -502,7 +666,7 @@ static const char *parse_value(cJSON *item, const char *value)
 	}
 
 	if (*value == '\"') {
-		return parse_string(item, value);
+		return parse_string(item, value, arena);
 	}
 
 	if (*value == '-' || (*value >= '0' && *value <= '9')) {
@@ -510,11 +674,11 @@ static const char *parse_value(cJSON *item, const char *value)
 	}
 
 	if (*value == '[') {
-		return parse_array(item, value);
+		return parse_array(item, value, arena);
 	}
 
 	if (*value == '{') {
-		return parse_object(item, value);
+		return parse_object(item, value, arena);
 	}
 
 	/* Failure. */
@@ -525,49 +689,41 @@ static const char *parse_value(cJSON *item, const char *value)
 
 /* Render a value to text. */
 
-static char *print_value(cJSON *item, int depth, int fmt)
+static int print_value(cJSON *item, int depth, int fmt, printbuffer *p)
 {
-	char *out = 0;
 	if (!item) {
 		return 0;
 	}
 
 	switch ((item->type) & 255) {
 	case cJSON_NULL:
-		out = cJSON_strdup("null");
-		break;
+		return print_raw(p, "null", 4);
 
 	case cJSON_False:
-		out = cJSON_strdup("false");
-		break;
+		return print_raw(p, "false", 5);
 
 	case cJSON_True:
-		out = cJSON_strdup("true");
-		break;
+		return print_raw(p, "true", 4);
 
 	case cJSON_Number:
-		out = print_number(item);
-		break;
+		return print_number(item, p);
 
 	case cJSON_String:
-		out = print_string(item);
-		break;
+		return print_string(item, p);
 
 	case cJSON_Array:
-		out = print_array(item, depth, fmt);
-		break;
+		return print_array(item, depth, fmt, p);
 
 	case cJSON_Object:
-		out = print_object(item, depth, fmt);
-		break;
+		return print_object(item, depth, fmt, p);
 	}
 
-	return out;
+	return 0;
 }
 
 /* Build an array from input text. */
 
-static const char *parse_array(cJSON *item, const char *value)
+static const char *parse_array(cJSON *item, const char *value, cJSON_Arena *arena)
 {
 	cJSON *child;
 
@@ -586,7 +742,7 @@ static const char *parse_array(cJSON *item, const char *value)
 		return value + 1;
 	}
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = cJSON_New_Parse_Item(arena);
 	if (!item->child) {
 		/* Memory fail */
 
@@ -595,14 +751,14 @@ static const char *parse_array(cJSON *item, const char *value)
 
 	/* Skip any spacing, get the value. */
 
-	value = skip(parse_value(child, skip(value)));
+	value = skip(parse_value(child, skip(value), arena));
 	if (!value) {
 		return 0;
 	}
 
 	while (*value == ',') {
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item())) {
+		if (!(new_item = cJSON_New_Parse_Item(arena))) {
 			/* <emory fail */
 
 			return 0;
@@ -611,7 +767,7 @@ static const char *parse_array(cJSON *item, const char *value)
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(child, skip(value + 1), arena));
 		if (!value) {
 			/* Memory fail */
 
@@ -633,101 +789,30 @@ static const char *parse_array(cJSON *item, const char *value)
 
 /* Render an array to text */
 
-static char *print_array(cJSON *item, int depth, int fmt)
+static int print_array(cJSON *item, int depth, int fmt, printbuffer *p)
 {
-	char **entries;
-	char *out = 0;
-	char *ptr;
-	char *ret;
-	int len = 5;
-	cJSON *child = item->child;
-	int numentries = 0;
-	int i = 0;
-	int fail = 0;
-
-	/* How many entries in the array? */
-
-	while (child) {
-		numentries++, child = child->next;
-	}
-
-	/* Allocate an array to hold the values for each */
+	cJSON *child;
 
-	entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-	if (!entries) {
+	if (!print_raw(p, "[", 1)) {
 		return 0;
 	}
 
-	memset(entries, 0, numentries * sizeof(char *));
-
-	/* Retrieve all the results: */
-
-	child = item->child;
-	while (child && !fail) {
-		ret = print_value(child, depth + 1, fmt);
-		entries[i++] = ret;
-		if (ret) {
-			len += strlen(ret) + 2 + (fmt ? 1 : 0);
-		} else {
-			fail = 1;
-		}
-
-		child = child->next;
-	}
-
-	/* If we didn't fail, try to malloc the output string */
-
-	if (!fail) {
-		out = (char *)cJSON_malloc(len);
-	}
-
-	/* If that fails, we fail. */
-
-	if (!out) {
-		fail = 1;
-	}
-
-	/* Handle failure. */
-
-	if (fail) {
-		for (i = 0; i < numentries; i++) {
-			if (entries[i]) {
-				cJSON_free(entries[i]);
-			}
+	for (child = item->child; child; child = child->next) {
+		if (!print_value(child, depth + 1, fmt, p)) {
+			return 0;
 		}
 
-		cJSON_free(entries);
-		return 0;
-	}
-
-	/* Compose the output array. */
-
-	*out = '[';
-	ptr = out + 1;
-	*ptr = 0;
-	for (i = 0; i < numentries; i++) {
-		strcpy(ptr, entries[i]);
-		ptr += strlen(entries[i]);
-		if (i != numentries - 1) {
-			*ptr++ = ',';
-			if (fmt) {
-				*ptr++ = ' ';
-			}
-
-			*ptr = 0;
+		if (child->next && !print_raw(p, ", ", fmt ? 2 : 1)) {
+			return 0;
 		}
-		cJSON_free(entries[i]);
 	}
 
-	cJSON_free(entries);
-	*ptr++ = ']';
-	*ptr++ = 0;
-	return out;
+	return print_raw(p, "]", 1);
 }
 
 /* Build an object from the text. */
 
-static const char *parse_object(cJSON *item, const char *value)
+static const char *parse_object(cJSON *item, const char *value, cJSON_Arena *arena)
 {
 	cJSON *child;
 	if (*value != '{') {
@@ -745,12 +830,12 @@ static const char *parse_object(cJSON *item, const char *value)
 		return value + 1;
 	}
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = cJSON_New_Parse_Item(arena);
 	if (!item->child) {
 		return 0;
 	}
 
-	value = skip(parse_string(child, skip(value)));
+	value = skip(parse_string(child, skip(value), arena));
 	if (!value) {
 		return 0;
 	}
@@ -764,14 +849,14 @@ static const char *parse_object(cJSON *item, const char *value)
 
 	/* Skip any spacing, get the value. */
 
-	value = skip(parse_value(child, skip(value + 1)));
+	value = skip(parse_value(child, skip(value + 1), arena));
 	if (!value) {
 		return 0;
 	}
 
 	while (*value == ',') {
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item())) {
+		if (!(new_item = cJSON_New_Parse_Item(arena))) {
 			/* Memory fail */
 
 			return 0;
@@ -780,7 +865,7 @@ static const char *parse_object(cJSON *item, const char *value)
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		value = skip(parse_string(child, skip(value + 1), arena));
 		if (!value) {
 			return 0;
 		}
@@ -794,7 +879,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
 		/* Skip any spacing, get the value. */
 
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(child, skip(value + 1), arena));
 		if (!value) {
 			return 0;
 		}
@@ -814,140 +899,42 @@ static const char *parse_object(cJSON *item, const char *value)
 
 /* Render an object to text. */
 
-static char *print_object(cJSON *item, int depth, int fmt)
+static int print_object(cJSON *item, int depth, int fmt, printbuffer *p)
 {
-	char **entries = 0;
-	char **names = 0;
-	char *out = 0;
-	char *ptr;
-	char *ret;
-	char *str;
-	int len = 7;
-	int i = 0;
-	int j;
-	cJSON *child = item->child;
-	int numentries = 0;
-	int fail = 0;
-
-	/* Count the number of entries. */
-
-	while (child) {
-		numentries++, child = child->next;
-	}
-
-	/* Allocate space for the names and the objects */
-
-	entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-	if (!entries) {
-		return 0;
-	}
-
-	names = (char **)cJSON_malloc(numentries * sizeof(char *));
-	if (!names) {
-		cJSON_free(entries);
-		return 0;
-	}
-
-	memset(entries, 0, sizeof(char *) * numentries);
-	memset(names, 0, sizeof(char *) * numentries);
-
-	/* Collect all the results into our arrays: */
+	cJSON *child;
 
-	child = item->child;
 	depth++;
-	if (fmt) {
-		len += depth;
-	}
-
-	while (child) {
-		names[i] = str = print_string_ptr(child->string);
-		entries[i++] = ret = print_value(child, depth, fmt);
-		if (str && ret) {
-			len += strlen(ret) + strlen(str) + 2 + (fmt ? 2 + depth : 0);
-		} else {
-			fail = 1;
-		}
-
-		child = child->next;
-	}
-
-	/* Try to allocate the output string */
-
-	if (!fail) {
-		out = (char *)cJSON_malloc(len);
-	}
-
-	if (!out) {
-		fail = 1;
-	}
-
-	/* Handle failure */
-
-	if (fail) {
-		for (i = 0; i < numentries; i++) {
-			if (names[i]) {
-				cJSON_free(names[i]);
-			}
-
-			if (entries[i]) {
-				cJSON_free(entries[i]);
-			}
-		}
-
-		cJSON_free(names);
-		cJSON_free(entries);
+	if (!print_raw(p, "{\n", fmt ? 2 : 1)) {
 		return 0;
 	}
 
-	/* Compose the output: */
-
-	*out = '{';
-	ptr = out + 1;
-	if (fmt) {
-		*ptr++ = '\n';
-	}
-	*ptr = 0;
-
-	for (i = 0; i < numentries; i++) {
-		if (fmt) {
-			for (j = 0; j < depth; j++) {
-				*ptr++ = '\t';
-			}
+	for (child = item->child; child; child = child->next) {
+		if (fmt && !print_tabs(p, depth)) {
+			return 0;
 		}
 
-		strcpy(ptr, names[i]);
-		ptr += strlen(names[i]);
-		*ptr++ = ':';
-		if (fmt) {
-			*ptr++ = '\t';
+		if (!print_string_ptr(child->string, p) || !print_raw(p, ":\t", fmt ? 2 : 1)) {
+			return 0;
 		}
 
-		strcpy(ptr, entries[i]);
-		ptr += strlen(entries[i]);
-		if (i != numentries - 1) {
-			*ptr++ = ',';
+		if (!print_value(child, depth, fmt, p)) {
+			return 0;
 		}
 
-		if (fmt) {
-			*ptr++ = '\n';
+		if (child->next && !print_raw(p, ",", 1)) {
+			return 0;
 		}
 
-		*ptr = 0;
-		cJSON_free(names[i]);
-		cJSON_free(entries[i]);
+		if (fmt && !print_raw(p, "\n", 1)) {
+			return 0;
+		}
 	}
 
-	cJSON_free(names);
-	cJSON_free(entries);
-	if (fmt) {
-		for (i = 0; i < depth - 1; i++) {
-			*ptr++ = '\t';
-		}
+	if (fmt && !print_tabs(p, depth - 1)) {
+		return 0;
 	}
 
-	*ptr++ = '}';
-	*ptr++ = 0;
-	return out;
+	return print_raw(p, "}", 1);
 }
 
 /* Utility for array list handling. */
@@ -1035,7 +1022,7 @@ cJSON *cJSON_ParseWithOpts(const char *value, const char **return_parse_end, int
 		return 0;
 	}
 
-	if (!parse_value(c, skip(value))) {
+	if (!parse_value(c, skip(value), 0)) {
 		cJSON_Delete(c);
 		return 0;
 	}
@@ -1069,7 +1056,7 @@ cJSON *cJSON_Parse(const char *value)
 		return 0;
 	}
 
-	if (!parse_value(c, skip(value))) {
+	if (!parse_value(c, skip(value), 0)) {
 		cJSON_Delete(c);
 		return 0;
 	}
@@ -1077,16 +1064,96 @@ cJSON *cJSON_Parse(const char *value)
 	return c;
 }
 
+/* Arena parsing: nothing is allocated from the heap. */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size)
+{
+	arena->buffer = (char *)buffer;
+	arena->size = size;
+	arena->used = 0;
+}
+
+void cJSON_ResetArena(cJSON_Arena *arena)
+{
+	arena->used = 0;
+}
+
+cJSON *cJSON_ParseInArena(char *value, cJSON_Arena *arena)
+{
+	cJSON *c = cJSON_New_Parse_Item(arena);
+	ep = 0;
+	if (!c) {
+		/* Arena full */
+
+		return 0;
+	}
+
+	if (!parse_value(c, skip(value), arena)) {
+		return 0;
+	}
+
+	return c;
+}
+
 /* Render a cJSON item/entity/structure to text. */
 
 char *cJSON_Print(cJSON *item)
 {
-	return print_value(item, 0, 1);
+	return cJSON_PrintBuffered(item, 256, 1);
 }
 
 char *cJSON_PrintUnformatted(cJSON *item)
 {
-	return print_value(item, 0, 0);
+	return cJSON_PrintBuffered(item, 256, 0);
+}
+
+char *cJSON_PrintBuffered(cJSON *item, int prebuffer, int fmt)
+{
+	printbuffer p;
+
+	p.buffer = 0;
+	p.length = 0;
+	p.offset = 0;
+	p.noalloc = 0;
+	if (prebuffer > 0) {
+		p.buffer = (char *)cJSON_malloc(prebuffer);
+		if (!p.buffer) {
+			return 0;
+		}
+
+		p.length = prebuffer;
+	}
+
+	if (!print_value(item, 0, fmt, &p) || !ensure(&p, 0)) {
+		if (p.buffer) {
+			cJSON_free(p.buffer);
+		}
+
+		return 0;
+	}
+
+	p.buffer[p.offset] = 0;
+	return p.buffer;
+}
+
+int cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const int fmt)
+{
+	printbuffer p;
+
+	if (!buffer || length <= 0) {
+		return 0;
+	}
+
+	p.buffer = buffer;
+	p.length = length;
+	p.offset = 0;
+	p.noalloc = 1;
+	if (!print_value(item, 0, fmt, &p)) {
+		return 0;
+	}
+
+	buffer[p.offset] = 0;
+	return 1;
 }
 
 /* Get Array size/item / object item. */
@@ -0,0 +1,891 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/netutils/json/cJSON_stream.c
+ *
+ * Streaming JSON tokenizer and writer.  The tokenizer is a byte-at-a-time
+ * state machine: the document can be fed in pieces of any size, as they
+ * are received, and only the current key, string or number is buffered.
+ * The writer formats its output in a small buffer that is handed to a sink
+ * (a socket, a file or a lib_outstream_s) whenever it fills up.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <apps/netutils/cJSON_stream.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Tokenizer states */
+
+#define STREAM_VALUE        0	/* A value */
+#define STREAM_ARRAY_FIRST  1	/* After '[': a value or ']' */
+#define STREAM_OBJECT_FIRST 2	/* After '{': a key or '}' */
+#define STREAM_KEY          3	/* After ',' in an object: a key */
+#define STREAM_COLON        4	/* After a key: ':' */
+#define STREAM_NEXT         5	/* After a value in a container: ',' or the end */
+#define STREAM_STRING       6	/* In a key or a string */
+#define STREAM_ESCAPE       7	/* After '\' */
+#define STREAM_UNICODE      8	/* In the hex digits of a \u escape */
+#define STREAM_LOW_ESCAPE   9	/* After a high surrogate: '\' */
+#define STREAM_LOW_U        10	/* After a high surrogate and '\': 'u' */
+#define STREAM_NUMBER       11	/* In a number */
+#define STREAM_LITERAL      12	/* In true, false or null */
+#define STREAM_DONE         13	/* After the top-level value */
+
+#define STREAM_ISSPACE(c)   ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int stream_emit(cJSON_Stream *s, int event, const char *data, size_t len)
+{
+	if (s->cb(s->arg, event, data, len) != 0) {
+		return -ECANCELED;
+	}
+
+	return 0;
+}
+
+static int stream_emit_token(cJSON_Stream *s, int event)
+{
+	size_t len = s->toklen;
+
+	s->token[len] = '\0';
+	s->toklen = 0;
+	return stream_emit(s, event, s->token, len);
+}
+
+/* A value is complete: what follows depends on the enclosing container */
+
+static void stream_value_done(cJSON_Stream *s)
+{
+	s->state = s->depth == 0 ? STREAM_DONE : STREAM_NEXT;
+}
+
+/* Append bytes to a key or a string.  The parts of long strings are passed
+ * to the callback as the buffer fills up; keys must fit.
+ */
+
+static int stream_append(cJSON_Stream *s, const char *data, size_t len)
+{
+	int ret;
+
+	if (s->toklen + len > CONFIG_NETUTILS_JSON_STREAM_TOKEN) {
+		if (s->iskey) {
+			return -E2BIG;
+		}
+
+		ret = stream_emit_token(s, cJSON_StreamStringPart);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	memcpy(&s->token[s->toklen], data, len);
+	s->toklen += len;
+	return 0;
+}
+
+/* Append a code point, encoded in UTF-8 as parse_string() does */
+
+static int stream_append_utf8(cJSON_Stream *s, unsigned long uc)
+{
+	char utf8[4];
+	size_t len;
+
+	if (uc < 0x80) {
+		utf8[0] = uc;
+		len = 1;
+	} else if (uc < 0x800) {
+		utf8[0] = 0xc0 | (uc >> 6);
+		utf8[1] = 0x80 | (uc & 0x3f);
+		len = 2;
+	} else if (uc < 0x10000) {
+		utf8[0] = 0xe0 | (uc >> 12);
+		utf8[1] = 0x80 | ((uc >> 6) & 0x3f);
+		utf8[2] = 0x80 | (uc & 0x3f);
+		len = 3;
+	} else {
+		utf8[0] = 0xf0 | (uc >> 18);
+		utf8[1] = 0x80 | ((uc >> 12) & 0x3f);
+		utf8[2] = 0x80 | ((uc >> 6) & 0x3f);
+		utf8[3] = 0x80 | (uc & 0x3f);
+		len = 4;
+	}
+
+	return stream_append(s, utf8, len);
+}
+
+static int stream_push(cJSON_Stream *s, char type, int event, int state)
+{
+	if (s->depth >= CONFIG_NETUTILS_JSON_STREAM_DEPTH) {
+		return -E2BIG;
+	}
+
+	s->stack[s->depth++] = type;
+	s->state = state;
+	return stream_emit(s, event, NULL, 0);
+}
+
+static int stream_pop(cJSON_Stream *s, int event)
+{
+	s->depth--;
+	stream_value_done(s);
+	return stream_emit(s, event, NULL, 0);
+}
+
+static int stream_begin_value(cJSON_Stream *s, int ch)
+{
+	switch (ch) {
+	case '{':
+		return stream_push(s, '{', cJSON_StreamObjectStart, STREAM_OBJECT_FIRST);
+	case '[':
+		return stream_push(s, '[', cJSON_StreamArrayStart, STREAM_ARRAY_FIRST);
+	case '"':
+		s->iskey = 0;
+		s->toklen = 0;
+		s->state = STREAM_STRING;
+		return 0;
+	case 't':
+		s->literal = "true";
+		break;
+	case 'f':
+		s->literal = "false";
+		break;
+	case 'n':
+		s->literal = "null";
+		break;
+	default:
+		if (ch == '-' || (ch >= '0' && ch <= '9')) {
+			s->token[0] = ch;
+			s->toklen = 1;
+			s->state = STREAM_NUMBER;
+			return 0;
+		}
+		return -EINVAL;
+	}
+
+	s->pos = 1;
+	s->state = STREAM_LITERAL;
+	return 0;
+}
+
+static int stream_begin_key(cJSON_Stream *s)
+{
+	s->iskey = 1;
+	s->toklen = 0;
+	s->state = STREAM_STRING;
+	return 0;
+}
+
+/* The number ended: check that strtod() takes all of it, as parse_number()
+ * would, and report its text.
+ */
+
+static int stream_end_number(cJSON_Stream *s)
+{
+	char *end;
+
+	s->token[s->toklen] = '\0';
+	strtod(s->token, &end);
+	if (end != &s->token[s->toklen]) {
+		return -EINVAL;
+	}
+
+	stream_value_done(s);
+	return stream_emit_token(s, cJSON_StreamNumber);
+}
+
+static int stream_hex(int ch)
+{
+	if (ch >= '0' && ch <= '9') {
+		return ch - '0';
+	} else if (ch >= 'a' && ch <= 'f') {
+		return ch - 'a' + 10;
+	} else if (ch >= 'A' && ch <= 'F') {
+		return ch - 'A' + 10;
+	}
+
+	return -1;
+}
+
+/* The four hex digits of a \u escape were read */
+
+static int stream_end_unicode(cJSON_Stream *s)
+{
+	unsigned long uc = s->uc;
+
+	if (s->high != 0) {
+		if (uc < 0xdc00 || uc > 0xdfff) {
+			return -EINVAL;
+		}
+
+		uc = 0x10000 + (((unsigned long)s->high - 0xd800) << 10) + (uc - 0xdc00);
+		s->high = 0;
+	} else if (uc >= 0xd800 && uc <= 0xdbff) {
+		s->high = uc;
+		s->state = STREAM_LOW_ESCAPE;
+		return 0;
+	} else if (uc >= 0xdc00 && uc <= 0xdfff) {
+		return -EINVAL;
+	}
+
+	s->state = STREAM_STRING;
+	return stream_append_utf8(s, uc);
+}
+
+static int stream_char(cJSON_Stream *s, int ch)
+{
+	char c;
+	int ret;
+	int x;
+
+	switch (s->state) {
+	case STREAM_STRING:
+		if (ch == '"') {
+			if (s->iskey) {
+				s->state = STREAM_COLON;
+				return stream_emit_token(s, cJSON_StreamKey);
+			}
+
+			stream_value_done(s);
+			return stream_emit_token(s, cJSON_StreamString);
+		} else if (ch == '\\') {
+			s->state = STREAM_ESCAPE;
+			return 0;
+		} else if (ch < 0x20) {
+			return -EINVAL;
+		}
+
+		c = ch;
+		return stream_append(s, &c, 1);
+
+	case STREAM_ESCAPE:
+		switch (ch) {
+		case 'b':
+			c = '\b';
+			break;
+		case 'f':
+			c = '\f';
+			break;
+		case 'n':
+			c = '\n';
+			break;
+		case 'r':
+			c = '\r';
+			break;
+		case 't':
+			c = '\t';
+			break;
+		case '"':
+		case '\\':
+		case '/':
+			c = ch;
+			break;
+		case 'u':
+			s->uc = 0;
+			s->pos = 0;
+			s->state = STREAM_UNICODE;
+			return 0;
+		default:
+			return -EINVAL;
+		}
+
+		s->state = STREAM_STRING;
+		return stream_append(s, &c, 1);
+
+	case STREAM_UNICODE:
+		x = stream_hex(ch);
+		if (x < 0) {
+			return -EINVAL;
+		}
+
+		s->uc = (s->uc << 4) | x;
+		if (++s->pos < 4) {
+			return 0;
+		}
+
+		return stream_end_unicode(s);
+
+	case STREAM_LOW_ESCAPE:
+		if (ch != '\\') {
+			return -EINVAL;
+		}
+
+		s->state = STREAM_LOW_U;
+		return 0;
+
+	case STREAM_LOW_U:
+		if (ch != 'u') {
+			return -EINVAL;
+		}
+
+		s->uc = 0;
+		s->pos = 0;
+		s->state = STREAM_UNICODE;
+		return 0;
+
+	case STREAM_NUMBER:
+		if ((ch >= '0' && ch <= '9') || ch == '.' || ch == 'e' || ch == 'E' || ch == '+' || ch == '-') {
+			if (s->toklen >= CONFIG_NETUTILS_JSON_STREAM_TOKEN) {
+				return -E2BIG;
+			}
+
+			s->token[s->toklen++] = ch;
+			return 0;
+		}
+
+		/* The character after the number belongs to the container */
+
+		ret = stream_end_number(s);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return stream_char(s, ch);
+
+	case STREAM_LITERAL:
+		if (ch != s->literal[s->pos]) {
+			return -EINVAL;
+		}
+
+		if (s->literal[++s->pos] != '\0') {
+			return 0;
+		}
+
+		stream_value_done(s);
+		switch (s->literal[0]) {
+		case 't':
+			return stream_emit(s, cJSON_StreamTrue, NULL, 0);
+		case 'f':
+			return stream_emit(s, cJSON_StreamFalse, NULL, 0);
+		default:
+			return stream_emit(s, cJSON_StreamNull, NULL, 0);
+		}
+
+	default:
+		break;
+	}
+
+	/* Between tokens */
+
+	if (STREAM_ISSPACE(ch)) {
+		return 0;
+	}
+
+	switch (s->state) {
+	case STREAM_VALUE:
+		return stream_begin_value(s, ch);
+
+	case STREAM_ARRAY_FIRST:
+		if (ch == ']') {
+			return stream_pop(s, cJSON_StreamArrayEnd);
+		}
+
+		return stream_begin_value(s, ch);
+
+	case STREAM_OBJECT_FIRST:
+		if (ch == '}') {
+			return stream_pop(s, cJSON_StreamObjectEnd);
+		}
+		/* Fall through */
+
+	case STREAM_KEY:
+		if (ch != '"') {
+			return -EINVAL;
+		}
+
+		return stream_begin_key(s);
+
+	case STREAM_COLON:
+		if (ch != ':') {
+			return -EINVAL;
+		}
+
+		s->state = STREAM_VALUE;
+		return 0;
+
+	case STREAM_NEXT:
+		if (ch == ',') {
+			s->state = s->stack[s->depth - 1] == '{' ? STREAM_KEY : STREAM_VALUE;
+			return 0;
+		} else if (ch == '}' && s->stack[s->depth - 1] == '{') {
+			return stream_pop(s, cJSON_StreamObjectEnd);
+		} else if (ch == ']' && s->stack[s->depth - 1] == '[') {
+			return stream_pop(s, cJSON_StreamArrayEnd);
+		}
+
+		return -EINVAL;
+
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Writer output */
+
+static int writer_fd_sink(void *arg, const char *buf, size_t len)
+{
+	int fd = (int)(intptr_t)arg;
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = write(fd, buf, len);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -errno;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int writer_outstream_sink(void *arg, const char *buf, size_t len)
+{
+	FAR struct lib_outstream_s *outstream = (FAR struct lib_outstream_s *)arg;
+
+	if (outstream->puts) {
+		outstream->puts(outstream, buf, len);
+		return 0;
+	}
+
+	while (len-- > 0) {
+		outstream->put(outstream, *buf++);
+	}
+
+	return 0;
+}
+
+static int writer_put(cJSON_Writer *w, const char *data, size_t len)
+{
+	size_t n;
+	int ret;
+
+	while (len > 0) {
+		if (w->len == sizeof(w->buf)) {
+			ret = cJSON_WriterFlush(w);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		n = sizeof(w->buf) - w->len;
+		if (n > len) {
+			n = len;
+		}
+
+		memcpy(&w->buf[w->len], data, n);
+		w->len += n;
+		data += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int writer_putc(cJSON_Writer *w, char c)
+{
+	return writer_put(w, &c, 1);
+}
+
+/* Write the separator before a value, if any, and check that a value is
+ * allowed here.
+ */
+
+static int writer_begin_value(cJSON_Writer *w)
+{
+	int ret;
+
+	if (w->error < 0) {
+		return w->error;
+	}
+
+	if (w->depth > 0 && w->stack[w->depth - 1] == '{' && !w->afterkey) {
+		return -EINVAL;
+	}
+
+	if (w->depth > 0 && !w->afterkey && !w->first) {
+		ret = writer_putc(w, ',');
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	w->afterkey = 0;
+	w->first = 0;
+	return 0;
+}
+
+static int writer_error(cJSON_Writer *w, int ret)
+{
+	if (ret < 0 && w->error == 0) {
+		w->error = ret;
+	}
+
+	return ret;
+}
+
+static int writer_start(cJSON_Writer *w, char type)
+{
+	int ret;
+
+	ret = writer_begin_value(w);
+	if (ret < 0) {
+		return writer_error(w, ret);
+	}
+
+	if (w->depth >= CONFIG_NETUTILS_JSON_STREAM_DEPTH) {
+		return writer_error(w, -E2BIG);
+	}
+
+	w->stack[w->depth++] = type;
+	w->first = 1;
+	return writer_error(w, writer_putc(w, type));
+}
+
+static int writer_end(cJSON_Writer *w, char type)
+{
+	if (w->error < 0) {
+		return w->error;
+	}
+
+	if (w->depth == 0 || w->stack[w->depth - 1] != type || w->afterkey) {
+		return writer_error(w, -EINVAL);
+	}
+
+	w->depth--;
+	w->first = 0;
+	return writer_error(w, writer_putc(w, type == '{' ? '}' : ']'));
+}
+
+/* Write a quoted string, escaped like print_string_ptr() does */
+
+static int writer_string(cJSON_Writer *w, const char *str)
+{
+	const char *run;
+	char esc[7];
+	int ret;
+
+	ret = writer_putc(w, '"');
+	while (ret == 0 && *str) {
+		/* Copy the run of characters that need no escaping at once */
+
+		for (run = str; *str && (unsigned char)*str >= ' ' && *str != '"' && *str != '\\'; str++) ;
+		if (str > run) {
+			ret = writer_put(w, run, str - run);
+			continue;
+		}
+
+		esc[0] = '\\';
+		switch (*str) {
+		case '\\':
+		case '"':
+			esc[1] = *str;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			snprintf(esc + 1, sizeof(esc) - 1, "u%04x", (unsigned char)*str);
+			ret = writer_put(w, esc, 6);
+			str++;
+			continue;
+		}
+
+		ret = writer_put(w, esc, 2);
+		str++;
+	}
+
+	if (ret == 0) {
+		ret = writer_putc(w, '"');
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void cJSON_StreamInit(cJSON_Stream *stream, cJSON_StreamCallback cb, void *arg)
+{
+	memset(stream, 0, sizeof(cJSON_Stream));
+	stream->cb = cb;
+	stream->arg = arg;
+	stream->state = STREAM_VALUE;
+}
+
+int cJSON_StreamFeed(cJSON_Stream *stream, const char *data, size_t len)
+{
+	int ret;
+
+	if (stream->error < 0) {
+		return stream->error;
+	}
+
+	while (len-- > 0) {
+		ret = stream_char(stream, (unsigned char)*data++);
+		if (ret < 0) {
+			stream->error = ret;
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int cJSON_StreamFinish(cJSON_Stream *stream)
+{
+	int ret;
+
+	if (stream->error < 0) {
+		return stream->error;
+	}
+
+	/* A top-level number only ends with the document */
+
+	if (stream->state == STREAM_NUMBER) {
+		ret = stream_end_number(stream);
+		if (ret < 0) {
+			stream->error = ret;
+			return ret;
+		}
+	}
+
+	if (stream->state != STREAM_DONE) {
+		stream->error = -EINVAL;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void cJSON_WriterInit(cJSON_Writer *writer, cJSON_WriterSink sink, void *arg)
+{
+	memset(writer, 0, sizeof(cJSON_Writer));
+	writer->sink = sink;
+	writer->arg = arg;
+}
+
+void cJSON_WriterInitFd(cJSON_Writer *writer, int fd)
+{
+	cJSON_WriterInit(writer, writer_fd_sink, (void *)(intptr_t)fd);
+}
+
+void cJSON_WriterInitStream(cJSON_Writer *writer, FAR struct lib_outstream_s *outstream)
+{
+	cJSON_WriterInit(writer, writer_outstream_sink, outstream);
+}
+
+int cJSON_WriteObjectStart(cJSON_Writer *writer)
+{
+	return writer_start(writer, '{');
+}
+
+int cJSON_WriteObjectEnd(cJSON_Writer *writer)
+{
+	return writer_end(writer, '{');
+}
+
+int cJSON_WriteArrayStart(cJSON_Writer *writer)
+{
+	return writer_start(writer, '[');
+}
+
+int cJSON_WriteArrayEnd(cJSON_Writer *writer)
+{
+	return writer_end(writer, '[');
+}
+
+int cJSON_WriteKey(cJSON_Writer *writer, const char *key)
+{
+	int ret;
+
+	if (writer->error < 0) {
+		return writer->error;
+	}
+
+	if (writer->depth == 0 || writer->stack[writer->depth - 1] != '{' || writer->afterkey) {
+		return writer_error(writer, -EINVAL);
+	}
+
+	ret = 0;
+	if (!writer->first) {
+		ret = writer_putc(writer, ',');
+	}
+
+	if (ret == 0) {
+		ret = writer_string(writer, key);
+	}
+
+	if (ret == 0) {
+		ret = writer_putc(writer, ':');
+	}
+
+	writer->afterkey = 1;
+	writer->first = 0;
+	return writer_error(writer, ret);
+}
+
+int cJSON_WriteString(cJSON_Writer *writer, const char *str)
+{
+	int ret;
+
+	ret = writer_begin_value(writer);
+	if (ret == 0) {
+		ret = writer_string(writer, str);
+	}
+
+	return writer_error(writer, ret);
+}
+
+/* Formatted like print_number() */
+
+int cJSON_WriteNumber(cJSON_Writer *writer, double num)
+{
+	char str[64];
+	int ret;
+
+	ret = writer_begin_value(writer);
+	if (ret < 0) {
+		return writer_error(writer, ret);
+	}
+
+	if (fabs(((double)(int)num) - num) <= DBL_EPSILON && num <= INT_MAX && num >= INT_MIN) {
+		snprintf(str, sizeof(str), "%d", (int)num);
+	} else if (fabs(floor(num) - num) <= DBL_EPSILON && fabs(num) < 1.0e60) {
+		snprintf(str, sizeof(str), "%.0f", num);
+	} else if (fabs(num) < 1.0e-6 || fabs(num) > 1.0e9) {
+		snprintf(str, sizeof(str), "%e", num);
+	} else {
+		snprintf(str, sizeof(str), "%f", num);
+	}
+
+	return writer_error(writer, writer_put(writer, str, strlen(str)));
+}
+
+int cJSON_WriteBool(cJSON_Writer *writer, int value)
+{
+	int ret;
+
+	ret = writer_begin_value(writer);
+	if (ret == 0) {
+		ret = value ? writer_put(writer, "true", 4) : writer_put(writer, "false", 5);
+	}
+
+	return writer_error(writer, ret);
+}
+
+int cJSON_WriteNull(cJSON_Writer *writer)
+{
+	int ret;
+
+	ret = writer_begin_value(writer);
+	if (ret == 0) {
+		ret = writer_put(writer, "null", 4);
+	}
+
+	return writer_error(writer, ret);
+}
+
+int cJSON_WriteItem(cJSON_Writer *writer, cJSON *item)
+{
+	cJSON *child;
+	int ret;
+
+	switch ((item->type) & 255) {
+	case cJSON_NULL:
+		return cJSON_WriteNull(writer);
+	case cJSON_False:
+		return cJSON_WriteBool(writer, 0);
+	case cJSON_True:
+		return cJSON_WriteBool(writer, 1);
+	case cJSON_Number:
+		return cJSON_WriteNumber(writer, item->valuedouble);
+	case cJSON_String:
+		return cJSON_WriteString(writer, item->valuestring);
+	case cJSON_Array:
+		ret = cJSON_WriteArrayStart(writer);
+		for (child = item->child; ret == 0 && child; child = child->next) {
+			ret = cJSON_WriteItem(writer, child);
+		}
+
+		return ret < 0 ? ret : cJSON_WriteArrayEnd(writer);
+	case cJSON_Object:
+		ret = cJSON_WriteObjectStart(writer);
+		for (child = item->child; ret == 0 && child; child = child->next) {
+			ret = cJSON_WriteKey(writer, child->string);
+			if (ret == 0) {
+				ret = cJSON_WriteItem(writer, child);
+			}
+		}
+
+		return ret < 0 ? ret : cJSON_WriteObjectEnd(writer);
+	default:
+		return writer_error(writer, -EINVAL);
+	}
+}
+
+int cJSON_WriterFlush(cJSON_Writer *writer)
+{
+	int ret;
+
+	if (writer->len > 0) {
+		ret = writer->sink(writer->arg, writer->buf, writer->len);
+		writer->len = 0;
+		if (ret < 0) {
+			return writer_error(writer, ret);
+		}
+	}
+
+	return writer->error;
+}
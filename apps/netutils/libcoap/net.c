@@ -138,35 +138,153 @@ int print_wellknown(coap_context_t *, unsigned char *, size_t *, size_t, coap_op
 
 void coap_handle_failed_notify(coap_context_t *, const coap_address_t *, const str *);
 
+#define COAP_SENDWHEEL_SLOT(T) (((T) / COAP_SENDWHEEL_TICKS) % COAP_SENDWHEEL_SIZE)
+#define COAP_SENDID_BUCKET(Id) ((unsigned int)(Id) % COAP_SENDWHEEL_SIZE)
+
+/**
+ * Finds the message in the retransmission wheel of @p context that is
+ * due first. The slots are visited from the one of sendwheel_time on,
+ * and only the messages due in the current turn of the wheel count, so
+ * the search usually ends at the first slot that is not empty.
+ */
+static coap_queue_t *coap_sendwheel_first(coap_context_t *context)
+{
+	coap_queue_t *q, *first = NULL;
+	coap_tick_t slot_end;
+	unsigned int i, slot;
+
+	slot = COAP_SENDWHEEL_SLOT(context->sendwheel_time);
+	slot_end = (context->sendwheel_time / COAP_SENDWHEEL_TICKS + 1) * COAP_SENDWHEEL_TICKS;
+	for (i = 0; i < COAP_SENDWHEEL_SIZE; i++) {
+		for (q = context->sendwheel[slot]; q; q = q->next) {
+			if (q->t < slot_end && (!first || q->t < first->t)) {
+				first = q;
+			}
+		}
+		if (first) {
+			return first;
+		}
+		slot = (slot + 1) % COAP_SENDWHEEL_SIZE;
+		slot_end += COAP_SENDWHEEL_TICKS;
+	}
+
+	/* all messages are due after a full turn of the wheel */
+	for (slot = 0; slot < COAP_SENDWHEEL_SIZE; slot++) {
+		for (q = context->sendwheel[slot]; q; q = q->next) {
+			if (!first || q->t < first->t) {
+				first = q;
+			}
+		}
+	}
+
+	return first;
+}
+
+/** Adds @p node to the retransmission wheel of @p context by node->t. */
+static void coap_sendwheel_insert(coap_context_t *context, coap_queue_t *node)
+{
+	unsigned int slot, bucket;
+
+	/* nothing may be due before the part of the wheel that is handled */
+	if ((coap_tick_diff_t)(node->t - context->sendwheel_time) < 0) {
+		node->t = context->sendwheel_time;
+	}
+
+	slot = COAP_SENDWHEEL_SLOT(node->t);
+	node->prev = NULL;
+	node->next = context->sendwheel[slot];
+	if (node->next) {
+		node->next->prev = node;
+	}
+	context->sendwheel[slot] = node;
+
+	bucket = COAP_SENDID_BUCKET(node->id);
+	node->id_next = context->sendids[bucket];
+	context->sendids[bucket] = node;
+
+	if (!context->sendqueue || node->t < context->sendqueue->t) {
+		context->sendqueue = node;
+	}
+}
+
+/** Removes @p node from the retransmission wheel of @p context. */
+static void coap_sendwheel_unlink(coap_context_t *context, coap_queue_t *node)
+{
+	coap_queue_t **p;
+
+	if (node->prev) {
+		node->prev->next = node->next;
+	} else {
+		context->sendwheel[COAP_SENDWHEEL_SLOT(node->t)] = node->next;
+	}
+	if (node->next) {
+		node->next->prev = node->prev;
+	}
+	node->next = NULL;
+	node->prev = NULL;
+
+	for (p = &context->sendids[COAP_SENDID_BUCKET(node->id)]; *p; p = &(*p)->id_next) {
+		if (*p == node) {
+			*p = node->id_next;
+			break;
+		}
+	}
+	node->id_next = NULL;
+
+	if (node == context->sendqueue) {
+		context->sendqueue = coap_sendwheel_first(context);
+	}
+}
+
+/** Returns the message of @p context that waits for retransmission with transaction @p id. */
+static coap_queue_t *coap_sendwheel_find(coap_context_t *context, coap_tid_t id)
+{
+	coap_queue_t *q;
+
+	for (q = context->sendids[COAP_SENDID_BUCKET(id)]; q; q = q->id_next) {
+		if (q->id == id) {
+			return q;
+		}
+	}
+
+	return NULL;
+}
+
 unsigned int coap_adjust_basetime(coap_context_t *ctx, coap_tick_t now)
 {
 	unsigned int result = 0;
 	coap_tick_diff_t delta = now - ctx->sendqueue_basetime;
+	coap_queue_t *all = NULL, *q;
+	unsigned int slot;
+
+	/* The slots depend on the time stamps, so the wheel is rebuilt. For
+	 * every message that has timed out, its relative time is set to zero
+	 * and the result counter is increased. */
+	for (slot = 0; slot < COAP_SENDWHEEL_SIZE; slot++) {
+		while ((q = ctx->sendwheel[slot])) {
+			ctx->sendwheel[slot] = q->next;
+			q->next = all;
+			all = q;
+		}
+		ctx->sendids[slot] = NULL;
+	}
+	ctx->sendqueue = NULL;
 
-	if (ctx->sendqueue) {
-		/* delta < 0 means that the new time stamp is before the old. */
-		if (delta <= 0) {
-			ctx->sendqueue->t -= delta;
-		} else {
-			/* This case is more complex: The time must be advanced forward,
-			 * thus possibly leading to timed out elements at the queue's
-			 * start. For every element that has timed out, its relative
-			 * time is set to zero and the result counter is increased. */
-
-			coap_queue_t *q = ctx->sendqueue;
-			coap_tick_t t = 0;
-			while (q && (t + q->t < (coap_tick_t) delta)) {
-				t += q->t;
-				q->t = 0;
-				result++;
-				q = q->next;
-			}
+	if ((coap_tick_diff_t)(ctx->sendwheel_time - delta) > 0) {
+		ctx->sendwheel_time -= delta;
+	} else {
+		ctx->sendwheel_time = 0;
+	}
 
-			/* finally adjust the first element that has not expired */
-			if (q) {
-				q->t = (coap_tick_t) delta - t;
-			}
+	while ((q = all)) {
+		all = q->next;
+		if ((coap_tick_diff_t)(q->t - delta) <= 0) {
+			q->t = 0;
+			result++;
+		} else {
+			q->t -= delta;
 		}
+		coap_sendwheel_insert(ctx, q);
 	}
 
 	/* adjust basetime */
@@ -269,14 +387,50 @@ coap_queue_t *coap_pop_next(coap_context_t *context)
 	}
 
 	next = context->sendqueue;
-	context->sendqueue = context->sendqueue->next;
-	if (context->sendqueue) {
-		context->sendqueue->t += next->t;
-	}
-	next->next = NULL;
+	coap_sendwheel_unlink(context, next);
 	return next;
 }
 
+void coap_check_retransmit(coap_context_t *context, coap_tick_t now)
+{
+	coap_tick_t elapsed, t;
+	coap_queue_t *q, *next, *due = NULL;
+	unsigned int i;
+
+	if (!context) {
+		return;
+	}
+
+	elapsed = now - context->sendqueue_basetime;
+	if ((coap_tick_diff_t)(elapsed - context->sendwheel_time) < 0) {
+		return;
+	}
+
+	/* Collect the due messages from the slots passed since the last call,
+	 * the first message is looked up once they are all taken out. */
+	context->sendqueue = NULL;
+	t = context->sendwheel_time;
+	for (i = 0; i < COAP_SENDWHEEL_SIZE && (coap_tick_diff_t)(elapsed - t) >= 0; i++) {
+		for (q = context->sendwheel[COAP_SENDWHEEL_SLOT(t)]; q; q = next) {
+			next = q->next;
+			if ((coap_tick_diff_t)(elapsed - q->t) >= 0) {
+				coap_sendwheel_unlink(context, q);
+				q->next = due;
+				due = q;
+			}
+		}
+		t = (t / COAP_SENDWHEEL_TICKS + 1) * COAP_SENDWHEEL_TICKS;
+	}
+	context->sendwheel_time = elapsed + 1;
+	context->sendqueue = coap_sendwheel_first(context);
+
+	while ((q = due)) {
+		due = q->next;
+		q->next = NULL;
+		coap_retransmit(context, q);
+	}
+}
+
 #ifdef COAP_DEFAULT_WKC_HASHKEY
 /** Checks if @p Key is equal to the pre-defined hash key for.well-known/core. */
 #define is_wkc(Key)							\
@@ -347,6 +501,7 @@ coap_context_t *coap_new_context(const coap_address_t *listen_addr)
 #endif							/* WITH_CONTIKI */
 
 	memset(c, 0, sizeof(coap_context_t));
+	coap_ticks(&c->sendqueue_basetime);
 
 	/* initialize message id */
 	prng((unsigned char *)&c->message_id, sizeof(unsigned short));
@@ -433,12 +588,17 @@ void coap_free_context(coap_context_t *context)
 	coap_resource_t *rtmp;
 #endif
 #endif							/* WITH_POSIX || WITH_LWIP */
+	int i;
+
 	if (!context) {
 		return;
 	}
 
 	coap_delete_all(context->recvqueue);
-	coap_delete_all(context->sendqueue);
+	for (i = 0; i < COAP_SENDWHEEL_SIZE; i++) {
+		coap_delete_all(context->sendwheel[i]);
+		context->sendwheel[i] = NULL;
+	}
 
 #ifdef WITH_LWIP
 	context->sendqueue = NULL;
@@ -713,24 +873,14 @@ coap_tid_t coap_send_confirmed(coap_context_t *context, const coap_address_t *ds
 	memcpy(&node->remote, dst, sizeof(coap_address_t));
 	node->pdu = pdu;
 
-	/* Set timer for pdu retransmission. If this is the first element in
-	 * the retransmission queue, the base time is set to the current
-	 * time and the retransmission time is node->timeout. If there is
-	 * already an entry in the sendqueue, we must check if this node is
-	 * to be retransmitted earlier. Therefore, node->timeout is first
-	 * normalized to the base time and then inserted into the queue with
-	 * an adjusted relative time.
+	/* Set timer for pdu retransmission. node->timeout is normalized to
+	 * the base time and the node is put into the slot of the
+	 * retransmission wheel that it falls into.
 	 */
 	coap_ticks(&now);
-	if (context->sendqueue == NULL) {
-		node->t = node->timeout;
-		context->sendqueue_basetime = now;
-	} else {
-		/* make node->t relative to context->sendqueue_basetime */
-		node->t = (now - context->sendqueue_basetime) + node->timeout;
-	}
+	node->t = (now - context->sendqueue_basetime) + node->timeout;
 
-	coap_insert_node(&context->sendqueue, node);
+	coap_sendwheel_insert(context, node);
 
 #ifdef WITH_LWIP
 	if (node == context->sendqueue) {	/* don't bother with timer stuff if there are earlier retransmits */
@@ -747,7 +897,7 @@ coap_tid_t coap_send_confirmed(coap_context_t *context, const coap_address_t *ds
 
 		/* must set timer within the context of the retransmit process */
 		PROCESS_CONTEXT_BEGIN(&coap_retransmit_process);
-		etimer_set(&context->retransmit_timer, nextpdu->t);
+		etimer_set(&context->retransmit_timer, nextpdu->t - (now - context->sendqueue_basetime));
 		PROCESS_CONTEXT_END(&coap_retransmit_process);
 	}
 #endif							/* WITH_CONTIKI */
@@ -757,6 +907,8 @@ coap_tid_t coap_send_confirmed(coap_context_t *context, const coap_address_t *ds
 
 coap_tid_t coap_retransmit(coap_context_t *context, coap_queue_t *node)
 {
+	coap_tick_t now;
+
 	if (!context || !node) {
 		return COAP_INVALID_TID;
 	}
@@ -764,17 +916,21 @@ coap_tid_t coap_retransmit(coap_context_t *context, coap_queue_t *node)
 	/* re-initialize timeout when maximum number of retransmissions are not reached yet */
 	if (node->retransmit_cnt < COAP_DEFAULT_MAX_RETRANSMIT) {
 		node->retransmit_cnt++;
-		node->t = node->timeout << node->retransmit_cnt;
-		coap_insert_node(&context->sendqueue, node);
+
+		debug("** retransmission #%d of transaction %d\n", node->retransmit_cnt, ntohs(node->pdu->hdr->id));
+
+		/* the transaction id is the key of the node in the wheel */
+		node->id = coap_send_impl(context, &node->remote, node->pdu);
+
+		coap_ticks(&now);
+		node->t = (now - context->sendqueue_basetime) + (node->timeout << node->retransmit_cnt);
+		coap_sendwheel_insert(context, node);
 #ifdef WITH_LWIP
 		if (node == context->sendqueue) {	/* don't bother with timer stuff if there are earlier retransmits */
 			coap_retransmittimer_restart(context);
 		}
 #endif
 
-		debug("** retransmission #%d of transaction %d\n", node->retransmit_cnt, ntohs(node->pdu->hdr->id));
-
-		node->id = coap_send_impl(context, &node->remote, node->pdu);
 		return node->id;
 	}
 
@@ -994,33 +1150,18 @@ void coap_cancel_all_messages(coap_context_t *context, const coap_address_t *dst
 {
 	/* cancel all messages in sendqueue that are for dst
 	 * and use the specified token */
-	coap_queue_t *p, *q;
+	coap_queue_t *q, *next;
+	unsigned int slot;
 
 	debug("cancel_all_messages\n");
-	while (context->sendqueue && coap_address_equals(dst, &context->sendqueue->remote) && token_match(token, token_length, context->sendqueue->pdu->hdr->token, context->sendqueue->pdu->hdr->token_length)) {
-		q = context->sendqueue;
-		context->sendqueue = q->next;
-		debug("**** removed transaction %d\n", ntohs(q->pdu->hdr->id));
-		coap_delete_node(q);
-	}
-
-	if (!context->sendqueue) {
-		return;
-	}
-
-	p = context->sendqueue;
-	q = p->next;
-
-	/* when q is not NULL, it does not match (dst, token), so we can skip it */
-	while (q) {
-		if (coap_address_equals(dst, &q->remote) && token_match(token, token_length, q->pdu->hdr->token, q->pdu->hdr->token_length)) {
-			p->next = q->next;
-			debug("**** removed transaction %d\n", ntohs(q->pdu->hdr->id));
-			coap_delete_node(q);
-			q = p->next;
-		} else {
-			p = q;
-			q = q->next;
+	for (slot = 0; slot < COAP_SENDWHEEL_SIZE; slot++) {
+		for (q = context->sendwheel[slot]; q; q = next) {
+			next = q->next;
+			if (coap_address_equals(dst, &q->remote) && token_match(token, token_length, q->pdu->hdr->token, q->pdu->hdr->token_length)) {
+				coap_sendwheel_unlink(context, q);
+				debug("**** removed transaction %d\n", ntohs(q->pdu->hdr->id));
+				coap_delete_node(q);
+			}
 		}
 	}
 }
@@ -1438,7 +1579,11 @@ void coap_dispatch(coap_context_t *context)
 		switch (rcvd->pdu->hdr->type) {
 		case COAP_MESSAGE_ACK:
 			/* find transaction in sendqueue to stop retransmission */
-			coap_remove_from_queue(&context->sendqueue, rcvd->id, &sent);
+			sent = coap_sendwheel_find(context, rcvd->id);
+			if (sent) {
+				coap_sendwheel_unlink(context, sent);
+				debug("*** removed transaction %u\n", rcvd->id);
+			}
 
 			if (rcvd->pdu->hdr->code == 0) {
 				goto cleanup;
@@ -1461,7 +1606,11 @@ void coap_dispatch(coap_context_t *context)
 			coap_log(LOG_ALERT, "got RST for message %u\n", ntohs(rcvd->pdu->hdr->id));
 
 			/* find transaction in sendqueue to stop retransmission */
-			coap_remove_from_queue(&context->sendqueue, rcvd->id, &sent);
+			sent = coap_sendwheel_find(context, rcvd->id);
+			if (sent) {
+				coap_sendwheel_unlink(context, sent);
+				debug("*** removed transaction %u\n", rcvd->id);
+			}
 
 			if (sent) {
 				coap_handle_rst(context, sent);
@@ -1541,16 +1690,12 @@ PROCESS_THREAD(coap_retransmit_process, ev, data)
 		if (ev == PROCESS_EVENT_TIMER) {
 			if (etimer_expired(&the_coap_context.retransmit_timer)) {
 
-				nextpdu = coap_peek_next(&the_coap_context);
-
 				coap_ticks(&now);
-				while (nextpdu && nextpdu->t <= now) {
-					coap_retransmit(&the_coap_context, coap_pop_next(&the_coap_context));
-					nextpdu = coap_peek_next(&the_coap_context);
-				}
+				coap_check_retransmit(&the_coap_context, now);
+				nextpdu = coap_peek_next(&the_coap_context);
 
 				/* need to set timer to some value even if no nextpdu is available */
-				etimer_set(&the_coap_context.retransmit_timer, nextpdu ? nextpdu->t - now : 0xFFFF);
+				etimer_set(&the_coap_context.retransmit_timer, nextpdu ? nextpdu->t - (now - the_coap_context.sendqueue_basetime) : 0xFFFF);
 			}
 #ifndef WITHOUT_OBSERVE
 			if (etimer_expired(&the_coap_context.notify_timer)) {
@@ -1586,28 +1731,11 @@ static void coap_retransmittimer_execute(void *arg)
 {
 	coap_context_t *ctx = (coap_context_t *) arg;
 	coap_tick_t now;
-	coap_tick_t elapsed;
-	coap_queue_t *nextinqueue;
 
 	ctx->timer_configured = 0;
 
 	coap_ticks(&now);
-
-	elapsed = now - ctx->sendqueue_basetime;	/* that's positive for sure, and unless we haven't been called for a complete wrapping cycle, did not wrap */
-
-	nextinqueue = coap_peek_next(ctx);
-	while (nextinqueue != NULL) {
-		if (nextinqueue->t > elapsed) {
-			nextinqueue->t -= elapsed;
-			break;
-		} else {
-			elapsed -= nextinqueue->t;
-			coap_retransmit(ctx, coap_pop_next(ctx));
-			nextinqueue = coap_peek_next(ctx);
-		}
-	}
-
-	ctx->sendqueue_basetime = now;
+	coap_check_retransmit(ctx, now);
 
 	coap_retransmittimer_restart(ctx);
 }
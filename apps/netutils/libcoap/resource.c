@@ -438,8 +438,94 @@ void coap_hash_request_uri(const coap_pdu_t *request, coap_key_t key)
 	}
 }
 
+#ifndef WITHOUT_OBSERVE
+/**
+ * Returns the bucket of the observer index of a context that holds
+ * the subscriptions of @p peer.
+ */
+static unsigned int coap_observer_bucket(const coap_address_t *peer)
+{
+	unsigned int h;
+#ifdef WITH_POSIX
+	uint32_t a[4];
+
+	switch (peer->addr.sa.sa_family) {
+	case AF_INET:
+		h = peer->addr.sin.sin_addr.s_addr ^ peer->addr.sin.sin_port;
+		break;
+	case AF_INET6:
+		memcpy(a, &peer->addr.sin6.sin6_addr, sizeof(a));
+		h = a[0] ^ a[1] ^ a[2] ^ a[3] ^ peer->addr.sin6.sin6_port;
+		break;
+	default:
+		h = 0;
+	}
+#elif defined(WITH_LWIP)
+	h = peer->addr.addr ^ peer->port;
+#else							/* WITH_CONTIKI */
+	h = peer->port;
+#endif
+	h ^= h >> 16;
+	h ^= h >> 8;
+
+	return h % COAP_OBSERVER_HASH_SIZE;
+}
+
+/**
+ * Checks if @p s is the subscription of @p peer with @p token, or
+ * with any token if @p token is @c NULL.
+ */
+static int coap_observer_matches(const coap_subscription_t *s, const coap_address_t *peer, const str *token)
+{
+	return coap_address_equals(&s->subscriber, peer)
+		   && (!token || (token->length == s->token_length && memcmp(token->s, s->token, token->length) == 0));
+}
+
+/**
+ * Removes @p s from the observer index of @p context.
+ */
+static void coap_observer_unindex(coap_context_t *context, coap_subscription_t *s)
+{
+	coap_subscription_t **p;
+
+	if (!context) {
+		return;
+	}
+
+	for (p = &context->observers[coap_observer_bucket(&s->subscriber)]; *p; p = &(*p)->hash_next) {
+		if (*p == s) {
+			*p = s->hash_next;
+			break;
+		}
+	}
+	s->hash_next = NULL;
+}
+
+/**
+ * Takes @p resource off the dirty queue of @p context.
+ */
+static void coap_unqueue_dirty(coap_context_t *context, coap_resource_t *resource)
+{
+	coap_resource_t **p;
+
+	if (!resource->queued) {
+		return;
+	}
+
+	for (p = &context->dirty_resources; *p; p = &(*p)->dirty_next) {
+		if (*p == resource) {
+			*p = resource->dirty_next;
+			break;
+		}
+	}
+	resource->dirty_next = NULL;
+	resource->queued = 0;
+}
+#endif							/* WITHOUT_OBSERVE */
+
 void coap_add_resource(coap_context_t *context, coap_resource_t *resource)
 {
+	resource->context = context;
 #ifndef WITH_CONTIKI
 #ifdef COAP_RESOURCES_NOHASH
 	LL_PREPEND(context->resources, resource);
@@ -453,7 +539,7 @@ int coap_delete_resource(coap_context_t *context, coap_key_t key)
 {
 	coap_resource_t *resource;
 	coap_attr_t *attr, *tmp;
-#ifdef WITH_CONTIKI
+#if defined(WITH_CONTIKI) || !defined(WITHOUT_OBSERVE)
 	coap_subscription_t *obs;
 #endif
 
@@ -467,6 +553,10 @@ int coap_delete_resource(coap_context_t *context, coap_key_t key)
 		return 0;
 	}
 
+#ifndef WITHOUT_OBSERVE
+	coap_unqueue_dirty(context, resource);
+#endif
+
 #if defined(WITH_POSIX) || defined(WITH_LWIP)
 #ifdef COAP_RESOURCES_NOHASH
 	LL_DELETE(context->resources, resource);
@@ -474,6 +564,14 @@ int coap_delete_resource(coap_context_t *context, coap_key_t key)
 	HASH_DELETE(hh, context->resources, resource);
 #endif
 
+#ifndef WITHOUT_OBSERVE
+	/* delete subscribers */
+	while ((obs = list_pop(resource->subscribers))) {
+		coap_observer_unindex(context, obs);
+		COAP_FREE_TYPE(subscription, obs);
+	}
+#endif
+
 	/* delete registered attributes */
 	LL_FOREACH_SAFE(resource->link_attr, attr, tmp) coap_delete_attr(attr);
 
@@ -496,6 +594,9 @@ int coap_delete_resource(coap_context_t *context, coap_key_t key)
 	/* delete subscribers */
 	while ((obs = list_pop(resource->subscribers))) {
 		/* FIXME: notify observer that its subscription has been removed */
+#ifndef WITHOUT_OBSERVE
+		coap_observer_unindex(context, obs);
+#endif
 		memb_free(&subscription_storage, obs);
 	}
 
@@ -594,9 +695,18 @@ coap_subscription_t *coap_find_observer(coap_resource_t *resource, const coap_ad
 	assert(resource);
 	assert(peer);
 
+	if (resource->context) {
+		s = resource->context->observers[coap_observer_bucket(peer)];
+		for (; s; s = s->hash_next) {
+			if (s->resource == resource && coap_observer_matches(s, peer, token)) {
+				return s;
+			}
+		}
+		return NULL;
+	}
+
 	for (s = list_head(resource->subscribers); s; s = list_item_next(s)) {
-		if (coap_address_equals(&s->subscriber, peer)
-			&& (!token || (token->length == s->token_length && memcmp(token->s, s->token, token->length) == 0))) {
+		if (coap_observer_matches(s, peer, token)) {
 			return s;
 		}
 	}
@@ -607,6 +717,7 @@ coap_subscription_t *coap_find_observer(coap_resource_t *resource, const coap_ad
 coap_subscription_t *coap_add_observer(coap_resource_t *resource, const coap_address_t *observer, const str *token)
 {
 	coap_subscription_t *s;
+	unsigned int bucket;
 
 	assert(observer);
 
@@ -636,38 +747,27 @@ coap_subscription_t *coap_add_observer(coap_resource_t *resource, const coap_add
 
 	/* add subscriber to resource */
 	list_add(resource->subscribers, s);
+	s->resource = resource;
+
+	/* and to the observer index of its context */
+	if (resource->context) {
+		bucket = coap_observer_bucket(observer);
+		s->hash_next = resource->context->observers[bucket];
+		resource->context->observers[bucket] = s;
+	}
 
 	return s;
 }
 
 void coap_touch_observer(coap_context_t *context, const coap_address_t *observer, const str *token)
 {
-	coap_resource_t *r;
 	coap_subscription_t *s;
 
-#ifndef WITH_CONTIKI
-#ifdef COAP_RESOURCES_NOHASH
-	LL_FOREACH(context->resources, r) {
-#else
-	coap_resource_t *tmp;
-	HASH_ITER(hh, context->resources, r, tmp) {
-#endif
-		s = coap_find_observer(r, observer, token);
-		if (s) {
+	for (s = context->observers[coap_observer_bucket(observer)]; s; s = s->hash_next) {
+		if (coap_observer_matches(s, observer, token)) {
 			s->fail_cnt = 0;
 		}
 	}
-#else							/* WITH_CONTIKI */
-	r = (coap_resource_t *) resource_storage.mem;
-	for (i = 0; i < resource_storage.num; ++i, ++r) {
-		if (resource_storage.count[i]) {
-			s = coap_find_observer(r, observer, token);
-			if (s) {
-				s->fail_cnt = 0;
-			}
-		}
-	}
-#endif							/* WITH_CONTIKI */
 }
 
 void coap_delete_observer(coap_resource_t *resource, const coap_address_t *observer, const str *token)
@@ -678,11 +778,24 @@ void coap_delete_observer(coap_resource_t *resource, const coap_address_t *obser
 
 	if (s) {
 		list_remove(resource->subscribers, s);
+		coap_observer_unindex(resource->context, s);
 
 		COAP_FREE_TYPE(subscription, s);
 	}
 }
 
+void coap_resource_set_dirty(coap_resource_t *resource)
+{
+	coap_context_t *context = resource->context;
+
+	resource->dirty = 1;
+	if (context && !resource->queued) {
+		resource->queued = 1;
+		resource->dirty_next = context->dirty_resources;
+		context->dirty_resources = resource;
+	}
+}
+
 static void coap_notify_observers(coap_context_t *context, coap_resource_t *r)
 {
 	coap_method_handler_t h;
@@ -763,98 +876,75 @@ static void coap_notify_observers(coap_context_t *context, coap_resource_t *r)
 
 void coap_check_notify(coap_context_t *context)
 {
-	coap_resource_t *r;
-#ifndef WITH_CONTIKI
+	coap_resource_t *r, *queue;
+
+	/* Resources marked dirty by the handlers go to the next round */
+	queue = context->dirty_resources;
+	context->dirty_resources = NULL;
+
+	while (queue) {
+		r = queue;
+		queue = r->dirty_next;
+		r->dirty_next = NULL;
+		r->queued = 0;
 
-#ifdef COAP_RESOURCES_NOHASH
-	LL_FOREACH(context->resources, r) {
-#else
-	coap_resource_t *tmp;
-	HASH_ITER(hh, context->resources, r, tmp) {
-#endif
 		coap_notify_observers(context, r);
-	}
-#else							/* WITH_CONTIKI */
-	int i;
 
-	r = (coap_resource_t *) resource_storage.mem;
-	for (i = 0; i < resource_storage.num; ++i, ++r) {
-		if (resource_storage.count[i]) {
-			coap_notify_observers(context, r);
+		if (r->partiallydirty && !r->queued) {
+			r->queued = 1;
+			r->dirty_next = context->dirty_resources;
+			context->dirty_resources = r;
 		}
 	}
-#endif							/* WITH_CONTIKI */
 }
 
 /**
- * Checks the failure counter for (peer, token) and removes peer from
- * the list of observers for the given resource when COAP_OBS_MAX_FAIL
- * is reached.
+ * Checks the failure counter for (peer, token) and removes the
+ * subscription from the list of observers of its resource when
+ * COAP_OBS_MAX_FAIL is reached.
  *
  * @param context  The CoAP context to use
- * @param resource The resource to check for (peer, token)
  * @param peer     The observer's address
  * @param token    The token that has been used for subscription.
  */
-static void coap_remove_failed_observers(coap_context_t *context, coap_resource_t *resource, const coap_address_t *peer, const str *token)
+void coap_handle_failed_notify(coap_context_t *context, const coap_address_t *peer, const str *token)
 {
-	coap_subscription_t *obs;
+	coap_subscription_t **p, *obs;
 
-	for (obs = list_head(resource->subscribers); obs; obs = list_item_next(obs)) {
-		if (coap_address_equals(peer, &obs->subscriber) && token->length == obs->token_length && memcmp(token->s, obs->token, token->length) == 0) {
+	p = &context->observers[coap_observer_bucket(peer)];
+	while ((obs = *p)) {
+		if (!coap_observer_matches(obs, peer, token)) {
+			p = &obs->hash_next;
+			continue;
+		}
 
-			/* count failed notifies and remove when
-			 * COAP_MAX_FAILED_NOTIFY is reached */
-			if (obs->fail_cnt < COAP_OBS_MAX_FAIL) {
-				obs->fail_cnt++;
-			} else {
-				list_remove(resource->subscribers, obs);
-				obs->fail_cnt = 0;
+		/* count failed notifies and remove when
+		 * COAP_MAX_FAILED_NOTIFY is reached */
+		if (obs->fail_cnt < COAP_OBS_MAX_FAIL) {
+			obs->fail_cnt++;
+			p = &obs->hash_next;
+			continue;
+		}
+
+		*p = obs->hash_next;
+		list_remove(obs->resource->subscribers, obs);
+		obs->fail_cnt = 0;
 
 #ifndef NDEBUG
-				if (LOG_DEBUG <= coap_get_log_level()) {
+		if (LOG_DEBUG <= coap_get_log_level()) {
 #ifndef INET6_ADDRSTRLEN
 #define INET6_ADDRSTRLEN 40
 #endif
-					unsigned char addr[INET6_ADDRSTRLEN + 8];
-
-					if (coap_print_addr(&obs->subscriber, addr, INET6_ADDRSTRLEN + 8)) {
-						debug("** removed observer %s\n", addr);
-					}
-				}
-#endif
-				coap_cancel_all_messages(context, &obs->subscriber, obs->token, obs->token_length);
+			unsigned char addr[INET6_ADDRSTRLEN + 8];
 
-				COAP_FREE_TYPE(subscription, obs);
+			if (coap_print_addr(&obs->subscriber, addr, INET6_ADDRSTRLEN + 8)) {
+				debug("** removed observer %s\n", addr);
 			}
 		}
-		break;					/* break loop if observer was found */
-	}
-}
-
-void coap_handle_failed_notify(coap_context_t *context, const coap_address_t *peer, const str *token)
-{
-	coap_resource_t *r;
-
-#ifndef WITH_CONTIKI
-
-#ifdef COAP_RESOURCES_NOHASH
-	LL_FOREACH(context->resources, r) {
-#else
-	coap_resource_t *tmp;
-	HASH_ITER(hh, context->resources, r, tmp) {
 #endif
-		coap_remove_failed_observers(context, r, peer, token);
-	}
-#else							/* WITH_CONTIKI */
-	int i;
+		coap_cancel_all_messages(context, &obs->subscriber, obs->token, obs->token_length);
 
-	r = (coap_resource_t *) resource_storage.mem;
-	for (i = 0; i < resource_storage.num; ++i, ++r) {
-		if (resource_storage.count[i]) {
-			coap_remove_failed_observers(context, r, peer, token);
-		}
+		COAP_FREE_TYPE(subscription, obs);
 	}
-#endif							/* WITH_CONTIKI */
 }
 #endif							/* WITHOUT_NOTIFY */
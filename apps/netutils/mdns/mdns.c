@@ -695,6 +695,157 @@ void rr_group_destroy(struct rr_group *group)
 	}
 }
 
+// hashes a name into an rr_cache bucket (djb2)
+static unsigned int rr_cache_hash(const uint8_t *name)
+{
+	unsigned int h = 5381;
+
+	for (; *name; name++) {
+		h = (h << 5) + h + *name;
+	}
+	return h % MDNS_CACHE_HASH_SIZE;
+}
+
+// wheel slot of the second in which the entry is first considered expired
+static unsigned int rr_cache_slot(const struct rr_entry *rr)
+{
+	return (unsigned int)(rr->update_time + rr->ttl + 1) % MDNS_CACHE_WHEEL_SLOTS;
+}
+
+void rr_cache_init(struct rr_cache *cache)
+{
+	memset(cache, 0, sizeof(struct rr_cache));
+	cache->sweep_time = time(NULL);
+}
+
+// finds the rr_group matching the given name
+struct rr_group *rr_cache_find(struct rr_cache *cache, uint8_t *name)
+{
+	return rr_group_find(cache->bucket[rr_cache_hash(name)], name);
+}
+
+// adds a record to the cache, which takes ownership of it
+void rr_cache_add(struct rr_cache *cache, struct rr_entry *rr)
+{
+	struct rr_list *node;
+	unsigned int slot;
+
+	assert(rr != NULL);
+
+	rr_group_add(&cache->bucket[rr_cache_hash(rr->name)], rr);
+
+	// prepend, the wheel only needs set semantics
+	slot = rr_cache_slot(rr);
+	node = MDNS_MALLOC(sizeof(struct rr_list));
+	node->e = rr;
+	node->next = cache->wheel[slot];
+	cache->wheel[slot] = node;
+
+	if (rr->type == RR_PTR || rr->type == RR_SRV) {
+		cache->num_ptr_srv++;
+	}
+}
+
+// deletes a record from the cache and destroys it
+void rr_cache_del(struct rr_cache *cache, struct rr_entry *rr)
+{
+	assert(rr != NULL);
+
+	rr_list_remove(&cache->wheel[rr_cache_slot(rr)], rr);
+
+	if (rr->type == RR_PTR || rr->type == RR_SRV) {
+		cache->num_ptr_srv--;
+	}
+
+	rr_group_del(&cache->bucket[rr_cache_hash(rr->name)], rr);
+}
+
+// removes entries whose ttl has run out
+// only the slots of the seconds elapsed since the last sweep are visited;
+// entries with a ttl longer than one turn of the wheel are checked again
+// and kept until their own second comes around
+void rr_cache_expire(struct rr_cache *cache, time_t now)
+{
+	time_t t;
+	time_t from = cache->sweep_time + 1;
+
+	if (now < cache->sweep_time) {
+		// clock stepped back, restart from here
+		cache->sweep_time = now;
+		return;
+	}
+
+	if (now - cache->sweep_time >= MDNS_CACHE_WHEEL_SLOTS) {
+		from = now - MDNS_CACHE_WHEEL_SLOTS + 1;
+	}
+
+	for (t = from; t <= now; t++) {
+		struct rr_list **prev = &cache->wheel[(unsigned int)t % MDNS_CACHE_WHEEL_SLOTS];
+		struct rr_list *le;
+
+		while ((le = *prev) != NULL) {
+			struct rr_entry *rr = le->e;
+
+			if ((now - rr->update_time) > rr->ttl) {
+				*prev = le->next;
+				MDNS_FREE(le);
+
+				if (rr->type == RR_PTR || rr->type == RR_SRV) {
+					cache->num_ptr_srv--;
+				}
+				rr_group_del(&cache->bucket[rr_cache_hash(rr->name)], rr);
+			} else {
+				prev = &le->next;
+			}
+		}
+	}
+
+	cache->sweep_time = now;
+}
+
+// deletes every cached RR_PTR and RR_SRV entry
+void rr_cache_del_ptr_srv(struct rr_cache *cache)
+{
+	int i;
+
+	for (i = 0; i < MDNS_CACHE_HASH_SIZE && cache->num_ptr_srv > 0; i++) {
+		struct rr_group *g = cache->bucket[i];
+
+		while (g) {
+			struct rr_group *nextg = g->next;
+			struct rr_list *le = g->rr;
+
+			// rr_cache_del() may free g once its last entry is gone
+			while (le) {
+				struct rr_list *nextle = le->next;
+
+				if (le->e->type == RR_PTR || le->e->type == RR_SRV) {
+					rr_cache_del(cache, le->e);
+				}
+				le = nextle;
+			}
+			g = nextg;
+		}
+	}
+}
+
+void rr_cache_destroy(struct rr_cache *cache)
+{
+	int i;
+
+	for (i = 0; i < MDNS_CACHE_WHEEL_SLOTS; i++) {
+		rr_list_destroy(cache->wheel[i], 0);
+		cache->wheel[i] = NULL;
+	}
+
+	for (i = 0; i < MDNS_CACHE_HASH_SIZE; i++) {
+		rr_group_destroy(cache->bucket[i]);
+		cache->bucket[i] = NULL;
+	}
+
+	cache->num_ptr_srv = 0;
+}
+
 uint8_t *mdns_write_u16(uint8_t *ptr, const uint16_t v)
 {
 	*ptr++ = (uint8_t)(v >> 8) & 0xFF;
@@ -58,6 +58,7 @@
 #ifdef _WIN32
 #include <winsock.h>
 #else
+#include <tinyara/config.h>
 #include <arpa/inet.h>
 #endif
 
@@ -179,6 +180,27 @@ struct rr_group {
 	struct rr_group *next;
 };
 
+#ifdef CONFIG_NETUTILS_MDNS_CACHE_HASH_SIZE
+#define MDNS_CACHE_HASH_SIZE	CONFIG_NETUTILS_MDNS_CACHE_HASH_SIZE
+#else
+#define MDNS_CACHE_HASH_SIZE	16
+#endif
+
+#ifdef CONFIG_NETUTILS_MDNS_CACHE_WHEEL_SLOTS
+#define MDNS_CACHE_WHEEL_SLOTS	CONFIG_NETUTILS_MDNS_CACHE_WHEEL_SLOTS
+#else
+#define MDNS_CACHE_WHEEL_SLOTS	64
+#endif
+
+// record cache: rr_groups hashed by name, entries bucketed by expiry second
+struct rr_cache {
+	struct rr_group *bucket[MDNS_CACHE_HASH_SIZE];
+	struct rr_list *wheel[MDNS_CACHE_WHEEL_SLOTS];
+
+	time_t sweep_time;			// last second the wheel was swept
+	int num_ptr_srv;			// cached RR_PTR and RR_SRV entries
+};
+
 #define MDNS_FLAG_RESP  (1 << 15)	// Query=0 / Response=1
 #define MDNS_FLAG_AA    (1 << 10)	// Authoritative
 #define MDNS_FLAG_TC    (1 <<  9)	// TrunCation
@@ -220,6 +242,14 @@ struct rr_entry *rr_entry_match(struct rr_list *rr_list, struct rr_entry *entry)
 void rr_group_add(struct rr_group **group, struct rr_entry *rr);
 void rr_group_del(struct rr_group **group, struct rr_entry *rr);
 
+void rr_cache_init(struct rr_cache *cache);
+struct rr_group *rr_cache_find(struct rr_cache *cache, uint8_t *name);
+void rr_cache_add(struct rr_cache *cache, struct rr_entry *rr);
+void rr_cache_del(struct rr_cache *cache, struct rr_entry *rr);
+void rr_cache_expire(struct rr_cache *cache, time_t now);
+void rr_cache_del_ptr_srv(struct rr_cache *cache);
+void rr_cache_destroy(struct rr_cache *cache);
+
 int rr_list_count(struct rr_list *rr);
 int rr_list_append(struct rr_list **rr_head, struct rr_entry *rr);
 struct rr_entry *rr_list_remove(struct rr_list **rr_head, struct rr_entry *rr);
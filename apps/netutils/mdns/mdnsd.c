@@ -116,6 +116,12 @@
 
 #define PACKET_SIZE             1536	/* maximum packet size :  */
 
+#ifdef CONFIG_NETUTILS_MDNS_ANSWER_CACHE_SIZE
+#define MDNS_ANSWER_CACHE_SIZE  CONFIG_NETUTILS_MDNS_ANSWER_CACHE_SIZE
+#else
+#define MDNS_ANSWER_CACHE_SIZE  4
+#endif
+
 #define SERVICES_DNS_SD_NLABEL \
 		((uint8_t *)"\x09_services\x07_dns-sd\x04_udp\x05local")
 
@@ -140,6 +146,16 @@ enum mdns_domain {
 #endif
 };
 
+#if defined(CONFIG_NETUTILS_MDNS_RESPONDER_SUPPORT)
+/* encoded reply to a plain single question about our own records */
+struct mdns_answer {
+	uint8_t *name;				/* question name, NULL if the slot is unused */
+	enum rr_type type;
+	uint8_t *pkt;
+	size_t len;
+};
+#endif
+
 struct mdnsd {
 	pthread_mutex_t data_lock;
 	sem_t sendmsg_sem;
@@ -151,10 +167,13 @@ struct mdnsd {
 
 	enum mdns_cache_status c_status;
 	char *c_filter;
-	struct rr_group *cache;
+	struct rr_cache cache;
 	struct rr_list *query;
 #if defined(CONFIG_NETUTILS_MDNS_RESPONDER_SUPPORT)
 	struct rr_group *group;
+	struct mdns_answer answers[MDNS_ANSWER_CACHE_SIZE];	/* flushed whenever group changes */
+	int answer_next;
+	int answer_gen;
 	struct rr_list *announce;
 	struct rr_list *services;
 	struct rr_list *probe;
@@ -222,33 +241,36 @@ static void print_rr_entry(struct rr_entry *rr_e)
 
 static void print_cache(struct mdnsd *svr)
 {
-	struct rr_group *group = svr->cache;
+	struct rr_group *group = NULL;
 	struct rr_list *list = NULL;
 	struct rr_entry *entry = NULL;
 	char *pname = NULL;
+	int i;
 
 	DEBUG_PRINTF("\n");
 	DEBUG_PRINTF(" Multicast DNS Cache\n");
 
-	for (; group; group = group->next) {
-		if (group->name) {
-			pname = nlabel_to_str(group->name);
-		} else {
-			pname = NULL;
-		}
+	for (i = 0; i < MDNS_CACHE_HASH_SIZE; i++) {
+		for (group = svr->cache.bucket[i]; group; group = group->next) {
+			if (group->name) {
+				pname = nlabel_to_str(group->name);
+			} else {
+				pname = NULL;
+			}
 
-		DEBUG_PRINTF("==================================================\n");
-		DEBUG_PRINTF(" Group: %s\n", pname ? pname : "Unknown");
-		DEBUG_PRINTF("==================================================\n");
-		if (pname) {
-			MDNS_FREE(pname);
-		}
+			DEBUG_PRINTF("==================================================\n");
+			DEBUG_PRINTF(" Group: %s\n", pname ? pname : "Unknown");
+			DEBUG_PRINTF("==================================================\n");
+			if (pname) {
+				MDNS_FREE(pname);
+			}
 
-		list = group->rr;
-		for (; list; list = list->next) {
-			entry = list->e;
-			if (entry) {
-				print_rr_entry(entry);
+			list = group->rr;
+			for (; list; list = list->next) {
+				entry = list->e;
+				if (entry) {
+					print_rr_entry(entry);
+				}
 			}
 		}
 	}
@@ -303,43 +325,17 @@ static char *get_service_type_without_subtype(char *name)
 static int lookup_hostname(struct mdnsd *svr, char *hostname)
 {
 	int result = -1;
-	struct rr_group *group = svr->cache;
-	struct rr_list *list = NULL;
-	struct rr_entry *entry = NULL;
-	int b_found = 0;
-	char *e_name;
-	int ret;
+	uint8_t *hname_nlabel = create_nlabel(hostname);
 
 	pthread_mutex_lock(&svr->data_lock);
 
-	for (; group; group = group->next) {
-		list = group->rr;
-		for (; list; list = list->next) {
-			entry = list->e;
-			if (entry && entry->name) {
-				e_name = nlabel_to_str(entry->name);
-				ret = strncmp(e_name, hostname, strlen(hostname));
-				MDNS_FREE(e_name);
-			} else {
-				ret = -1;
-			}
-
-			if (ret == 0) {
-				b_found = 1;
-				break;
-			}
-		}
-
-		if (b_found) {
-			break;
-		}
+	if (rr_cache_find(&svr->cache, hname_nlabel)) {
+		result = 0;
 	}
 
 	pthread_mutex_unlock(&svr->data_lock);
 
-	if (b_found) {
-		result = 0;
-	}
+	MDNS_FREE(hname_nlabel);
 
 	return result;
 }
@@ -348,48 +344,26 @@ static int lookup_hostname(struct mdnsd *svr, char *hostname)
 static int lookup_hostname_to_addr(struct mdnsd *svr, char *hostname, int *ipaddr)
 {
 	int result = -1;
-	struct rr_group *group = svr->cache;
-	struct rr_list *list = NULL;
+	uint8_t *hname_nlabel = create_nlabel(hostname);
+	struct rr_group *group = NULL;
 	struct rr_entry *entry = NULL;
-	int b_found = 0;
-	char *e_name;
-	int ret;
 
 	update_cache(svr);
 
 	pthread_mutex_lock(&svr->data_lock);
 
-	for (; group; group = group->next) {
-		list = group->rr;
-		for (; list; list = list->next) {
-			entry = list->e;
-			if (entry && (entry->type == RR_A)) {	// currently, support only ipv4
-				if (entry->name) {
-					e_name = nlabel_to_str(entry->name);
-					ret = strncmp(e_name, hostname, strlen(hostname));
-					MDNS_FREE(e_name);
-				} else {
-					ret = -1;
-				}
-
-				if (ret == 0) {
-					*ipaddr = entry->data.A.addr;
-					b_found = 1;
-					break;
-				}
-			}
-		}
-
-		if (b_found) {
-			break;
+	group = rr_cache_find(&svr->cache, hname_nlabel);
+	if (group) {
+		entry = rr_entry_find(group->rr, hname_nlabel, RR_A);	// currently, support only ipv4
+		if (entry) {
+			*ipaddr = entry->data.A.addr;
+			result = 0;
 		}
 	}
 
 	pthread_mutex_unlock(&svr->data_lock);
 
-	if (b_found) {
-		result = 0;
-	}
+	MDNS_FREE(hname_nlabel);
 
 	return result;
 }
@@ -407,7 +381,7 @@ static int lookup_service(struct mdnsd *svr, char *type, struct mdns_service_inf
 
 	pthread_mutex_lock(&svr->data_lock);
 
-	struct rr_group *ptr_grp = rr_group_find(svr->cache, (uint8_t *)type_nlabel);
+	struct rr_group *ptr_grp = rr_cache_find(&svr->cache, (uint8_t *)type_nlabel);
 
 	MDNS_FREE(type_nlabel);
 	if (ptr_grp) {
@@ -417,7 +391,7 @@ static int lookup_service(struct mdnsd *svr, char *type, struct mdns_service_inf
 			entry = list->e;
 			if (entry && (entry->type == RR_PTR)) {
 				if (entry->data.PTR.name) {	/* SRV's name */
-					struct rr_group *srv_grp = rr_group_find(svr->cache,
+					struct rr_group *srv_grp = rr_cache_find(&svr->cache,
 											   (uint8_t *)entry->data.PTR.name);
 					if (srv_grp) {
 						/* find service */
@@ -451,7 +425,7 @@ static int lookup_service(struct mdnsd *svr, char *type, struct mdns_service_inf
 								MDNS_FREE(name);
 
 								/* ip address */
-								a_grp = rr_group_find(svr->cache, (uint8_t *)srv_e->data.SRV.target);
+								a_grp = rr_cache_find(&svr->cache, (uint8_t *)srv_e->data.SRV.target);
 								if (a_grp) {
 									struct rr_entry *a_e = rr_entry_find(a_grp->rr, srv_e->data.SRV.target, RR_A);
 									if (a_e) {
@@ -726,6 +700,102 @@ static void process_for_probe(struct mdnsd *svr, struct mdns_pkt *mdns_packet)
 	mdns_packet->num_qn += populate_probe(svr, &mdns_packet->rr_qn);
 }
 
+// a reply can be taken from the answer cache only when it depends on
+// nothing but our own records: one multicast question, no known answers
+static int answer_cacheable(struct mdns_pkt *pkt)
+{
+	return (pkt->flags & MDNS_FLAG_RESP) == 0 && MDNS_FLAG_GET_OPCODE(pkt->flags) == 0 &&
+		   pkt->num_qn == 1 && pkt->rr_qn && !pkt->rr_qn->e->unicast_query &&
+		   pkt->num_ans_rr == 0 && pkt->num_auth_rr == 0 && pkt->num_add_rr == 0;
+}
+
+// copies the cached reply to the question of pkt into pkt_buf
+// returns the reply length, or 0 with *gen set to the current generation
+static size_t answer_cache_lookup(struct mdnsd *svr, struct mdns_pkt *pkt, uint8_t *pkt_buf, int *gen)
+{
+	struct rr_entry *qn = pkt->rr_qn->e;
+	size_t len = 0;
+	int i;
+
+	pthread_mutex_lock(&svr->data_lock);
+	for (i = 0; i < MDNS_ANSWER_CACHE_SIZE; i++) {
+		struct mdns_answer *ans = &svr->answers[i];
+		if (ans->name && ans->type == qn->type && cmp_nlabel(ans->name, qn->name) == 0) {
+			memcpy(pkt_buf, ans->pkt, ans->len);
+			len = ans->len;
+			break;
+		}
+	}
+	*gen = svr->answer_gen;
+	pthread_mutex_unlock(&svr->data_lock);
+
+	if (len > 0) {
+		// echo the transaction ID like mdns_init_reply() does
+		pkt_buf[0] = (pkt->id >> 8) & 0xFF;
+		pkt_buf[1] = pkt->id & 0xFF;
+	}
+
+	return len;
+}
+
+// remembers the encoded reply to the question of pkt
+// dropped if our records changed since answer_cache_lookup() returned gen
+static void answer_cache_store(struct mdnsd *svr, struct mdns_pkt *pkt, uint8_t *pkt_buf, size_t len, int gen)
+{
+	struct rr_entry *qn = pkt->rr_qn->e;
+	struct mdns_answer *ans;
+	uint8_t *copy;
+
+	if (len == 0 || len > PACKET_SIZE) {
+		return;
+	}
+
+	copy = MDNS_MALLOC(len);
+	if (copy == NULL) {
+		return;
+	}
+	memcpy(copy, pkt_buf, len);
+
+	pthread_mutex_lock(&svr->data_lock);
+	if (gen != svr->answer_gen) {
+		pthread_mutex_unlock(&svr->data_lock);
+		MDNS_FREE(copy);
+		return;
+	}
+
+	// replace round robin
+	ans = &svr->answers[svr->answer_next];
+	svr->answer_next = (svr->answer_next + 1) % MDNS_ANSWER_CACHE_SIZE;
+	if (ans->name) {
+		MDNS_FREE(ans->name);
+		MDNS_FREE(ans->pkt);
+	}
+	ans->name = dup_nlabel(qn->name);
+	ans->type = qn->type;
+	ans->pkt = copy;
+	ans->len = len;
+	pthread_mutex_unlock(&svr->data_lock);
+}
+
+// drops every cached reply, called with data_lock held whenever group changes
+static void answer_cache_flush(struct mdnsd *svr)
+{
+	int i;
+
+	for (i = 0; i < MDNS_ANSWER_CACHE_SIZE; i++) {
+		struct mdns_answer *ans = &svr->answers[i];
+		if (ans->name) {
+			MDNS_FREE(ans->name);
+			MDNS_FREE(ans->pkt);
+			ans->name = NULL;
+			ans->pkt = NULL;
+			ans->len = 0;
+		}
+	}
+	svr->answer_next = 0;
+	svr->answer_gen++;
+}
+
 #endif							/* CONFIG_NETUTILS_MDNS_RESPONDER_SUPPORT */
 
 static void process_for_query(struct mdnsd *svr, struct mdns_pkt *mdns_packet)
@@ -743,34 +813,15 @@ static void process_for_query(struct mdnsd *svr, struct mdns_pkt *mdns_packet)
 
 static void update_cache(struct mdnsd *svr)
 {
-	struct rr_group *group = svr->cache;
-	struct rr_list *list = NULL;
-	struct rr_entry *entry = NULL;
-	struct rr_list *remove_list = NULL;
-
 	pthread_mutex_lock(&svr->data_lock);
-	for (; group; group = group->next) {
-		list = group->rr;
-		for (; list; list = list->next) {
-			entry = list->e;
-			if (entry) {
-				/* if ttl is expired or rr is RR_PTR or RR_SRV, remove rr from cache */
-				if (((time(NULL) - entry->update_time) > entry->ttl) || (svr->c_status != CACHE_SERVICE_DISCOVERY && (entry->type == RR_PTR || entry->type == RR_SRV))) {
-					rr_list_append(&remove_list, entry);
-				}
-			}
-		}
-	}
 
-	/* remove ttl expired entry */
-	list = remove_list;
-	for (; list; list = list->next) {
-		entry = list->e;
-		if (entry) {
-			rr_group_del(&svr->cache, entry);
-		}
+	/* remove ttl expired entries */
+	rr_cache_expire(&svr->cache, time(NULL));
+
+	/* RR_PTR and RR_SRV are only kept while discovering services */
+	if (svr->c_status != CACHE_SERVICE_DISCOVERY && svr->cache.num_ptr_srv > 0) {
+		rr_cache_del_ptr_srv(&svr->cache);
 	}
-	rr_list_destroy(remove_list, 0);	/* destroy remove list */
 
 	pthread_mutex_unlock(&svr->data_lock);
 }
@@ -856,22 +907,22 @@ static void add_rr_to_cache(struct mdnsd *svr, struct mdns_pkt *pkt)
 
 		if (rr_e) {
 			cached_rr_e = NULL;
-			group = rr_group_find(svr->cache, rr_e->name);
+			group = rr_cache_find(&svr->cache, rr_e->name);
 			if (group) {
 				rr_e_in_cache = rr_entry_match(group->rr, rr_e);
 				if (rr_e_in_cache) {
-					rr_group_del(&svr->cache, rr_e_in_cache);
+					rr_cache_del(&svr->cache, rr_e_in_cache);
 					if (rr_e->ttl > 0) {
 						cached_rr_e = rr_duplicate(rr_e);
-						rr_group_add(&svr->cache, cached_rr_e);
+						rr_cache_add(&svr->cache, cached_rr_e);
 					}
 				} else {
 					cached_rr_e = rr_duplicate(rr_e);
-					rr_group_add(&svr->cache, cached_rr_e);
+					rr_cache_add(&svr->cache, cached_rr_e);
 				}
 			} else {
 				cached_rr_e = rr_duplicate(rr_e);
-				rr_group_add(&svr->cache, cached_rr_e);
+				rr_cache_add(&svr->cache, cached_rr_e);
 			}
 
 			/* if SRV's target is null, add RR_A 's hostname to SRV's target */
@@ -1243,16 +1294,33 @@ static void main_loop(struct mdnsd *svr)
 				DEBUG_PRINTF("data from=%s size=%ld\n", inet_ntoa(fromaddr.sin_addr), (long)recvsize);
 				struct mdns_pkt *mdns = mdns_parse_pkt(pkt_buffer, recvsize);
 				if (mdns != NULL) {
-					if (process_mdns_pkt(svr, mdns, mdns_packet)) {
 #if defined(CONFIG_NETUTILS_MDNS_RESPONDER_SUPPORT)
-						size_t replylen = mdns_encode_pkt(mdns_packet, pkt_buffer, PACKET_SIZE);
+					size_t replylen = 0;
+					int answer_gen = -1;
+
+					if (answer_cacheable(mdns)) {
+						replylen = answer_cache_lookup(svr, mdns, pkt_buffer, &answer_gen);
+					}
+
+					if (replylen == 0 && process_mdns_pkt(svr, mdns, mdns_packet)) {
+						replylen = mdns_encode_pkt(mdns_packet, pkt_buffer, PACKET_SIZE);
+						if (answer_gen != -1) {
+							answer_cache_store(svr, mdns, pkt_buffer, replylen, answer_gen);
+						}
+					}
+
+					if (replylen > 0) {
 						if (send_packet(svr->sockfd, pkt_buffer, replylen, svr->domain) == -1) {
 							ndbg("ERROR: send_packet() failed. (errno: %d)\n", errno);
 						}
-#endif
 					} else if (mdns->num_qn == 0) {
 						DEBUG_PRINTF("(no questions in packet)\n\n");
 					}
+#else
+					if (process_mdns_pkt(svr, mdns, mdns_packet) == 0 && mdns->num_qn == 0) {
+						DEBUG_PRINTF("(no questions in packet)\n\n");
+					}
+#endif
 
 					mdns_pkt_destroy(mdns);
 				}
@@ -1605,6 +1673,7 @@ static int mdnsd_set_host_info(struct mdnsd *svr, const char *hostname, uint32_t
 	pthread_mutex_lock(&svr->data_lock);
 	rr_group_add(&svr->group, a_e);
 	rr_group_add(&svr->group, nsec_e);
+	answer_cache_flush(svr);
 
 	// append RR_A entry to announce list
 	rr_list_append(&svr->announce, a_e);
@@ -1678,6 +1747,7 @@ static int init_mdns_context(int domain)
 
 	/* initialize struct mdnsd instance */
 	memset(g_svr, 0, sizeof(struct mdnsd));
+	rr_cache_init(&g_svr->cache);
 	g_svr->stop_flag = 0;
 	g_svr->sockfd = -1;
 	g_svr->notify_pipe[0] = -1;
@@ -1812,8 +1882,7 @@ static void release_mdns_context_resource(void)
 	pthread_mutex_destroy(&g_svr->data_lock);
 	sem_destroy(&g_svr->sendmsg_sem);
 
-	rr_group_destroy(g_svr->cache);
-	g_svr->cache = NULL;
+	rr_cache_destroy(&g_svr->cache);
 
 	rr_list_destroy(g_svr->query, 0);
 	g_svr->query = NULL;
@@ -1823,6 +1892,8 @@ static void release_mdns_context_resource(void)
 		g_svr->c_filter = NULL;
 	}
 #if defined(CONFIG_NETUTILS_MDNS_RESPONDER_SUPPORT)
+	answer_cache_flush(g_svr);
+
 	rr_group_destroy(g_svr->group);
 	g_svr->group = NULL;
 
@@ -2094,6 +2165,7 @@ int mdnsd_register_service(const char *instance_name, const char *type,
 	rr_group_add(&g_svr->group, srv_e);
 	rr_group_add(&g_svr->group, ptr_e);
 	rr_group_add(&g_svr->group, bptr_e);
+	answer_cache_flush(g_svr);
 
 	// append PTR entry to announce list
 	rr_list_append(&g_svr->announce, ptr_e);
@@ -37,6 +37,7 @@ Contributors:
 #include <string.h>
 
 #include <memory_mosq.h>
+#include <mosquitto_internal.h>
 
 #ifdef REAL_WITH_MEMORY_TRACKING
 #	if defined(__APPLE__)
@@ -138,3 +139,129 @@ char *_mosquitto_strdup(const char *s)
 
 	return str;
 }
+
+#if MOSQ_PACKET_POOL > 0
+/* Pool of fixed-size blocks. Free blocks are chained through their first
+ * word, blocks from 'unused' on have never been handed out. */
+struct _mosquitto_pool {
+	uint8_t *start;
+	uint8_t *end;
+	uint8_t *unused;
+	void *free_list;
+	size_t block_size;
+};
+
+#define MOSQ_POOL_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+#define MOSQ_PACKET_BLOCK MOSQ_POOL_ALIGN(sizeof(struct _mosquitto_packet))
+#define MOSQ_BUF_BLOCK MOSQ_POOL_ALIGN(MOSQ_PACKET_BUF_SIZE)
+
+static void *g_packet_blocks[MOSQ_PACKET_POOL * MOSQ_PACKET_BLOCK / sizeof(void *)];
+static void *g_buf_blocks[MOSQ_PACKET_POOL * MOSQ_BUF_BLOCK / sizeof(void *)];
+
+static struct _mosquitto_pool g_packet_pool = {
+	(uint8_t *)g_packet_blocks,
+	(uint8_t *)g_packet_blocks + sizeof(g_packet_blocks),
+	(uint8_t *)g_packet_blocks,
+	NULL,
+	MOSQ_PACKET_BLOCK
+};
+
+static struct _mosquitto_pool g_buf_pool = {
+	(uint8_t *)g_buf_blocks,
+	(uint8_t *)g_buf_blocks + sizeof(g_buf_blocks),
+	(uint8_t *)g_buf_blocks,
+	NULL,
+	MOSQ_BUF_BLOCK
+};
+
+#if defined(WITH_THREADING) && !defined(WITH_BROKER)
+static pthread_mutex_t g_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void *_mosquitto_pool_get(struct _mosquitto_pool *pool)
+{
+	void *mem = NULL;
+
+	pthread_mutex_lock(&g_pool_mutex);
+	if (pool->free_list) {
+		mem = pool->free_list;
+		pool->free_list = *(void **)mem;
+	} else if (pool->unused < pool->end) {
+		mem = pool->unused;
+		pool->unused += pool->block_size;
+	}
+	pthread_mutex_unlock(&g_pool_mutex);
+
+	return mem;
+}
+
+static bool _mosquitto_pool_put(struct _mosquitto_pool *pool, void *mem)
+{
+	if ((uint8_t *)mem < pool->start || (uint8_t *)mem >= pool->end) {
+		return false;
+	}
+
+	pthread_mutex_lock(&g_pool_mutex);
+	*(void **)mem = pool->free_list;
+	pool->free_list = mem;
+	pthread_mutex_unlock(&g_pool_mutex);
+
+	return true;
+}
+#endif
+
+/* Packets and their payloads come from the pools while there is room and
+ * the payload fits in a pool buffer, and from the heap otherwise. */
+struct _mosquitto_packet *_mosquitto_packet_new(void)
+{
+#if MOSQ_PACKET_POOL > 0
+	struct _mosquitto_packet *packet = _mosquitto_pool_get(&g_packet_pool);
+
+	if (packet) {
+		memset(packet, 0, sizeof(struct _mosquitto_packet));
+		return packet;
+	}
+#endif
+	return _mosquitto_calloc(1, sizeof(struct _mosquitto_packet));
+}
+
+void _mosquitto_packet_free(struct _mosquitto_packet *packet)
+{
+	if (!packet) {
+		return;
+	}
+#if MOSQ_PACKET_POOL > 0
+	if (_mosquitto_pool_put(&g_packet_pool, packet)) {
+		return;
+	}
+#endif
+	_mosquitto_free(packet);
+}
+
+void *_mosquitto_packet_buf_alloc(size_t size)
+{
+#if MOSQ_PACKET_POOL > 0
+	void *mem;
+
+	if (size <= MOSQ_PACKET_BUF_SIZE) {
+		mem = _mosquitto_pool_get(&g_buf_pool);
+		if (mem) {
+			return mem;
+		}
+	}
+#endif
+	return _mosquitto_malloc(size);
+}
+
+void _mosquitto_packet_buf_free(void *mem)
+{
+	if (!mem) {
+		return;
+	}
+#if MOSQ_PACKET_POOL > 0
+	if (_mosquitto_pool_put(&g_buf_pool, mem)) {
+		return;
+	}
+#endif
+	_mosquitto_free(mem);
+}
@@ -51,4 +51,11 @@ unsigned long _mosquitto_max_memory_used(void);
 void *_mosquitto_realloc(void *ptr, size_t size);
 char *_mosquitto_strdup(const char *s);
 
+struct _mosquitto_packet;
+
+struct _mosquitto_packet *_mosquitto_packet_new(void);
+void _mosquitto_packet_free(struct _mosquitto_packet *packet);
+void *_mosquitto_packet_buf_alloc(size_t size);
+void _mosquitto_packet_buf_free(void *mem);
+
 #endif
@@ -42,6 +42,75 @@ Contributors:
 #include <send_mosq.h>
 #include <time_mosq.h>
 
+#define MOSQ_MSG_BUCKET(mid) ((mid) & (MOSQ_MSG_HASH_SIZE - 1))
+
+static struct mosquitto_message_all **_mosquitto_message_table(struct mosquitto *mosq, enum mosquitto_msg_direction dir)
+{
+	return dir == mosq_md_out ? mosq->out_hash : mosq->in_hash;
+}
+
+static struct mosquitto_message_all *_mosquitto_message_find(struct mosquitto *mosq, uint16_t mid, enum mosquitto_msg_direction dir)
+{
+	struct mosquitto_message_all *message;
+
+	message = _mosquitto_message_table(mosq, dir)[MOSQ_MSG_BUCKET(mid)];
+	while (message && message->msg.mid != mid) {
+		message = message->hash_next;
+	}
+	return message;
+}
+
+/* Index a message, after the older messages with the same mid */
+static void _mosquitto_message_index(struct mosquitto *mosq, struct mosquitto_message_all *message, enum mosquitto_msg_direction dir)
+{
+	struct mosquitto_message_all **link;
+
+	link = &_mosquitto_message_table(mosq, dir)[MOSQ_MSG_BUCKET(message->msg.mid)];
+	while (*link) {
+		link = &(*link)->hash_next;
+	}
+	message->hash_next = NULL;
+	*link = message;
+}
+
+/* Take a message out of its queue and of the index */
+static void _mosquitto_message_unlink(struct mosquitto *mosq, struct mosquitto_message_all *message, enum mosquitto_msg_direction dir)
+{
+	struct mosquitto_message_all **link;
+
+	if (dir == mosq_md_out) {
+		if (message->prev) {
+			message->prev->next = message->next;
+		} else {
+			mosq->out_messages = message->next;
+		}
+		if (message->next) {
+			message->next->prev = message->prev;
+		} else {
+			mosq->out_messages_last = message->prev;
+		}
+		mosq->out_queue_len--;
+	} else {
+		if (message->prev) {
+			message->prev->next = message->next;
+		} else {
+			mosq->in_messages = message->next;
+		}
+		if (message->next) {
+			message->next->prev = message->prev;
+		} else {
+			mosq->in_messages_last = message->prev;
+		}
+		mosq->in_queue_len--;
+	}
+
+	link = &_mosquitto_message_table(mosq, dir)[MOSQ_MSG_BUCKET(message->msg.mid)];
+	while (*link != message) {
+		link = &(*link)->hash_next;
+	}
+	*link = message->hash_next;
+}
+
 void _mosquitto_message_cleanup(struct mosquitto_message_all **message)
 {
 	struct mosquitto_message_all *msg;
@@ -77,6 +146,10 @@ void _mosquitto_message_cleanup_all(struct mosquitto *mosq)
 		_mosquitto_message_cleanup(&mosq->out_messages);
 		mosq->out_messages = tmp;
 	}
+	mosq->in_messages_last = NULL;
+	mosq->out_messages_last = NULL;
+	memset(mosq->in_hash, 0, sizeof(mosq->in_hash));
+	memset(mosq->out_hash, 0, sizeof(mosq->out_hash));
 }
 
 int mosquitto_message_copy(struct mosquitto_message *dst, const struct mosquitto_message *src)
@@ -157,6 +230,7 @@ int _mosquitto_message_queue(struct mosquitto *mosq, struct mosquitto_message_al
 	if (dir == mosq_md_out) {
 		mosq->out_queue_len++;
 		message->next = NULL;
+		message->prev = mosq->out_messages_last;
 		if (mosq->out_messages_last) {
 			mosq->out_messages_last->next = message;
 		} else {
@@ -173,6 +247,7 @@ int _mosquitto_message_queue(struct mosquitto *mosq, struct mosquitto_message_al
 	} else {
 		mosq->in_queue_len++;
 		message->next = NULL;
+		message->prev = mosq->in_messages_last;
 		if (mosq->in_messages_last) {
 			mosq->in_messages_last->next = message;
 		} else {
@@ -180,39 +255,31 @@ int _mosquitto_message_queue(struct mosquitto *mosq, struct mosquitto_message_al
 		}
 		mosq->in_messages_last = message;
 	}
+	_mosquitto_message_index(mosq, message, dir);
 	return rc;
 }
 
 void _mosquitto_messages_reconnect_reset(struct mosquitto *mosq)
 {
 	struct mosquitto_message_all *message;
+	struct mosquitto_message_all *next;
 	struct mosquitto_message_all *prev = NULL;
 	assert(mosq);
 
 	pthread_mutex_lock(&mosq->in_message_mutex);
 	message = mosq->in_messages;
-	mosq->in_queue_len = 0;
 	while (message) {
-		mosq->in_queue_len++;
+		next = message->next;
 		message->timestamp = 0;
 		if (message->msg.qos != 2) {
-			if (prev) {
-				prev->next = message->next;
-				_mosquitto_message_cleanup(&message);
-				message = prev;
-			} else {
-				mosq->in_messages = message->next;
-				_mosquitto_message_cleanup(&message);
-				message = mosq->in_messages;
-			}
+			_mosquitto_message_unlink(mosq, message, mosq_md_in);
+			_mosquitto_message_cleanup(&message);
 		} else {
 			/* Message state can be preserved here because it should match
 			 * whatever the client has got. */
 		}
-		prev = message;
-		message = message->next;
+		message = next;
 	}
-	mosq->in_messages_last = prev;
 	pthread_mutex_unlock(&mosq->in_message_mutex);
 
 	pthread_mutex_lock(&mosq->out_message_mutex);
@@ -244,7 +311,7 @@ void _mosquitto_messages_reconnect_reset(struct mosquitto *mosq)
 
 int _mosquitto_message_remove(struct mosquitto *mosq, uint16_t mid, enum mosquitto_msg_direction dir, struct mosquitto_message_all **message)
 {
-	struct mosquitto_message_all *cur, *prev = NULL;
+	struct mosquitto_message_all *cur;
 	bool found = false;
 	int rc;
 	assert(mosq);
@@ -252,32 +319,21 @@ int _mosquitto_message_remove(struct mosquitto *mosq, uint16_t mid, enum mosquit
 
 	if (dir == mosq_md_out) {
 		pthread_mutex_lock(&mosq->out_message_mutex);
-		cur = mosq->out_messages;
-		while (cur) {
-			if (cur->msg.mid == mid) {
-				if (prev) {
-					prev->next = cur->next;
-				} else {
-					mosq->out_messages = cur->next;
-				}
-				*message = cur;
-				mosq->out_queue_len--;
-				if (cur->next == NULL) {
-					mosq->out_messages_last = prev;
-				} else if (!mosq->out_messages) {
-					mosq->out_messages_last = NULL;
-				}
-				if (cur->msg.qos > 0) {
-					mosq->inflight_messages--;
-				}
-				found = true;
-				break;
+		cur = _mosquitto_message_find(mosq, mid, dir);
+		if (cur) {
+			_mosquitto_message_unlink(mosq, cur, dir);
+			*message = cur;
+			if (cur->msg.qos > 0) {
+				mosq->inflight_messages--;
 			}
-			prev = cur;
-			cur = cur->next;
+			found = true;
 		}
 
-		if (found) {
+		if (found && mosq->out_queue_len <= mosq->inflight_messages) {
+			/* No message waits for room in the window */
+			pthread_mutex_unlock(&mosq->out_message_mutex);
+			return MOSQ_ERR_SUCCESS;
+		} else if (found) {
 			cur = mosq->out_messages;
 			while (cur) {
 				if (mosq->max_inflight_messages == 0 || mosq->inflight_messages < mosq->max_inflight_messages) {
@@ -308,26 +364,11 @@ int _mosquitto_message_remove(struct mosquitto *mosq, uint16_t mid, enum mosquit
 		}
 	} else {
 		pthread_mutex_lock(&mosq->in_message_mutex);
-		cur = mosq->in_messages;
-		while (cur) {
-			if (cur->msg.mid == mid) {
-				if (prev) {
-					prev->next = cur->next;
-				} else {
-					mosq->in_messages = cur->next;
-				}
-				*message = cur;
-				mosq->in_queue_len--;
-				if (cur->next == NULL) {
-					mosq->in_messages_last = prev;
-				} else if (!mosq->in_messages) {
-					mosq->in_messages_last = NULL;
-				}
-				found = true;
-				break;
-			}
-			prev = cur;
-			cur = cur->next;
+		cur = _mosquitto_message_find(mosq, mid, dir);
+		if (cur) {
+			_mosquitto_message_unlink(mosq, cur, dir);
+			*message = cur;
+			found = true;
 		}
 
 		pthread_mutex_unlock(&mosq->in_message_mutex);
@@ -407,15 +448,12 @@ int _mosquitto_message_out_update(struct mosquitto *mosq, uint16_t mid, enum mos
 	assert(mosq);
 
 	pthread_mutex_lock(&mosq->out_message_mutex);
-	message = mosq->out_messages;
-	while (message) {
-		if (message->msg.mid == mid) {
-			message->state = state;
-			message->timestamp = mosquitto_time();
-			pthread_mutex_unlock(&mosq->out_message_mutex);
-			return MOSQ_ERR_SUCCESS;
-		}
-		message = message->next;
+	message = _mosquitto_message_find(mosq, mid, mosq_md_out);
+	if (message) {
+		message->state = state;
+		message->timestamp = mosquitto_time();
+		pthread_mutex_unlock(&mosq->out_message_mutex);
+		return MOSQ_ERR_SUCCESS;
 	}
 	pthread_mutex_unlock(&mosq->out_message_mutex);
 	return MOSQ_ERR_NOT_FOUND;
@@ -216,7 +216,7 @@ int mosquitto_reinitialise(struct mosquitto *mosq, const char *id, bool clean_se
 	mosq->in_messages_last = NULL;
 	mosq->out_messages = NULL;
 	mosq->out_messages_last = NULL;
-	mosq->max_inflight_messages = 20;
+	mosq->max_inflight_messages = MOSQ_MAX_INFLIGHT;
 	mosq->will = NULL;
 	mosq->on_connect = NULL;
 	mosq->on_publish = NULL;
@@ -488,10 +488,23 @@ void _mosquitto_destroy(struct mosquitto *mosq)
 		}
 
 		_mosquitto_packet_cleanup(packet);
-		_mosquitto_free(packet);
+		_mosquitto_packet_free(packet);
 	}
+#if MOSQ_WRITE_BATCH > 0
+	if (mosq->out_batch) {
+		_mosquitto_free(mosq->out_batch);
+		mosq->out_batch = NULL;
+	}
+	mosq->out_batch_len = 0;
+#endif
 
 	_mosquitto_packet_cleanup(&mosq->in_packet);
+#if MOSQ_READ_BUF_SIZE > 0
+	if (mosq->in_buf) {
+		_mosquitto_free(mosq->in_buf);
+		mosq->in_buf = NULL;
+	}
+#endif
 	if (mosq->sockpairR != INVALID_SOCKET) {
 		COMPAT_CLOSE(mosq->sockpairR);
 		mosq->sockpairR = INVALID_SOCKET;
@@ -673,8 +686,11 @@ static int _mosquitto_reconnect(struct mosquitto *mosq, bool blocking)
 		}
 
 		_mosquitto_packet_cleanup(packet);
-		_mosquitto_free(packet);
+		_mosquitto_packet_free(packet);
 	}
+#if MOSQ_WRITE_BATCH > 0
+	mosq->out_batch_len = 0;
+#endif
 	pthread_mutex_unlock(&mosq->out_packet_mutex);
 	pthread_mutex_unlock(&mosq->current_out_packet_mutex);
 
@@ -90,6 +90,41 @@ typedef SOCKET mosq_sock_t;
 typedef int mosq_sock_t;
 #endif
 
+/* Buckets of the tables that find the messages of a direction by mid */
+#define MOSQ_MSG_HASH_SIZE 16
+
+#if defined(__TINYARA__) && defined(CONFIG_NETUTILS_MQTT_MAX_INFLIGHT)
+#	define MOSQ_MAX_INFLIGHT CONFIG_NETUTILS_MQTT_MAX_INFLIGHT
+#else
+#	define MOSQ_MAX_INFLIGHT 20
+#endif
+
+/* Size of the buffer that coalesces queued packets into one write, 0 for none */
+#if defined(__TINYARA__) && defined(CONFIG_NETUTILS_MQTT_WRITE_BATCH)
+#	define MOSQ_WRITE_BATCH CONFIG_NETUTILS_MQTT_WRITE_BATCH
+#else
+#	define MOSQ_WRITE_BATCH 0
+#endif
+
+/* Packets and payload buffers kept in static pools, 0 for the heap only */
+#if defined(__TINYARA__) && defined(CONFIG_NETUTILS_MQTT_PACKET_POOL)
+#	define MOSQ_PACKET_POOL CONFIG_NETUTILS_MQTT_PACKET_POOL
+#	define MOSQ_PACKET_BUF_SIZE CONFIG_NETUTILS_MQTT_PACKET_BUF_SIZE
+#else
+#	define MOSQ_PACKET_POOL 0
+#	define MOSQ_PACKET_BUF_SIZE 0
+#endif
+
+/* Size of the buffer that is reused to read incoming packets, 0 for none */
+#if defined(__TINYARA__) && defined(CONFIG_NETUTILS_MQTT_READ_BUF_SIZE)
+#	define MOSQ_READ_BUF_SIZE CONFIG_NETUTILS_MQTT_READ_BUF_SIZE
+#else
+#	define MOSQ_READ_BUF_SIZE 0
+#endif
+
+/* The payload is not owned by the packet and is not freed with it */
+#define MOSQ_PACKET_BORROWED 0x01
+
 enum mosquitto_msg_direction {
 	mosq_md_in = 0,
 	mosq_md_out = 1
@@ -167,10 +202,13 @@ struct _mosquitto_packet {
 	uint16_t mid;
 	uint8_t command;
 	int8_t remaining_count;
+	uint8_t flags;
 };
 
 struct mosquitto_message_all {
 	struct mosquitto_message_all *next;
+	struct mosquitto_message_all *prev;
+	struct mosquitto_message_all *hash_next;	/* Next message of the same bucket */
 	time_t timestamp;
 	//enum mosquitto_msg_direction direction;
 	enum mosquitto_msg_state state;
@@ -197,6 +235,15 @@ struct mosquitto {
 	struct _mosquitto_packet in_packet;
 	struct _mosquitto_packet *current_out_packet;
 	struct _mosquitto_packet *out_packet;
+#if MOSQ_WRITE_BATCH > 0
+	uint8_t *out_batch;			/* Copy of current_out_packet and the next packets */
+	uint32_t out_batch_pos;
+	uint32_t out_batch_len;		/* Bytes left to write, 0 if there is no batch */
+	int out_batch_count;		/* Packets in the batch */
+#endif
+#if MOSQ_READ_BUF_SIZE > 0
+	uint8_t *in_buf;			/* Payload of in_packet when it fits */
+#endif
 	struct mosquitto_message *will;
 #ifdef WITH_MBEDTLS
 	int mbedtls_state;
@@ -288,6 +335,8 @@ struct mosquitto {
 	struct mosquitto_message_all *in_messages_last;
 	struct mosquitto_message_all *out_messages;
 	struct mosquitto_message_all *out_messages_last;
+	struct mosquitto_message_all *in_hash[MOSQ_MSG_HASH_SIZE];
+	struct mosquitto_message_all *out_hash[MOSQ_MSG_HASH_SIZE];
 	void (*on_connect)(struct mosquitto *, void *userdata, int rc);
 	void (*on_disconnect)(struct mosquitto *, void *userdata, int rc);
 	void (*on_publish)(struct mosquitto *, void *userdata, int mid);
@@ -156,10 +156,11 @@ void _mosquitto_packet_cleanup(struct _mosquitto_packet *packet)
 	packet->remaining_count = 0;
 	packet->remaining_mult = 1;
 	packet->remaining_length = 0;
-	if (packet->payload) {
-		_mosquitto_free(packet->payload);
+	if (packet->payload && !(packet->flags & MOSQ_PACKET_BORROWED)) {
+		_mosquitto_packet_buf_free(packet->payload);
 	}
 	packet->payload = NULL;
+	packet->flags = 0;
 	packet->to_process = 0;
 	packet->pos = 0;
 }
@@ -924,10 +925,162 @@ ssize_t _mosquitto_net_write(struct mosquitto *mosq, void *buf, size_t count)
 #endif
 }
 
-int _mosquitto_packet_write(struct mosquitto *mosq)
+/* Write buf[*pos] to buf[*pos + *to_process]. Sets *blocked and returns
+ * MOSQ_ERR_SUCCESS if the socket cannot take more data for now. */
+static int _mosquitto_net_write_all(struct mosquitto *mosq, uint8_t *buf, uint32_t *pos, uint32_t *to_process, bool *blocked)
 {
 	ssize_t write_length;
+
+	*blocked = false;
+	while (*to_process > 0) {
+		write_length = _mosquitto_net_write(mosq, &(buf[*pos]), *to_process);
+		if (write_length > 0) {
+#if defined(WITH_BROKER) && defined(WITH_SYS_TREE)
+			g_bytes_sent += write_length;
+#endif
+			*to_process -= write_length;
+			*pos += write_length;
+		} else {
+#ifdef WIN32
+			errno = WSAGetLastError();
+#endif
+			if (errno == EAGAIN || errno == COMPAT_EWOULDBLOCK) {
+				*blocked = true;
+				return MOSQ_ERR_SUCCESS;
+			} else {
+				switch (errno) {
+				case COMPAT_ECONNRESET:
+					return MOSQ_ERR_CONN_LOST;
+				default:
+					return MOSQ_ERR_ERRNO;
+				}
+			}
+		}
+	}
+	return MOSQ_ERR_SUCCESS;
+}
+
+/* Make the next queued packet the current one */
+static void _mosquitto_packet_next(struct mosquitto *mosq)
+{
+	pthread_mutex_lock(&mosq->out_packet_mutex);
+	mosq->current_out_packet = mosq->out_packet;
+	if (mosq->out_packet) {
+		mosq->out_packet = mosq->out_packet->next;
+		if (!mosq->out_packet) {
+			mosq->out_packet_last = NULL;
+		}
+	}
+	pthread_mutex_unlock(&mosq->out_packet_mutex);
+}
+
+#if MOSQ_WRITE_BATCH > 0
+/* Copy the current packet and the queued packets that follow it into one
+ * buffer, to send them with one write and, with TLS, in one record. Nothing
+ * is copied if only one packet would fit. The packets stay queued until the
+ * batch is written. */
+static void _mosquitto_packet_batch(struct mosquitto *mosq)
+{
+	struct _mosquitto_packet *packet = mosq->current_out_packet;
+	uint32_t len;
+
+	pthread_mutex_lock(&mosq->out_packet_mutex);
+	if (!mosq->out_packet || packet->to_process + mosq->out_packet->to_process > MOSQ_WRITE_BATCH
+		|| ((packet->command) & 0xF0) == DISCONNECT) {
+		pthread_mutex_unlock(&mosq->out_packet_mutex);
+		return;
+	}
+	if (!mosq->out_batch) {
+		mosq->out_batch = _mosquitto_malloc(MOSQ_WRITE_BATCH);
+		if (!mosq->out_batch) {
+			pthread_mutex_unlock(&mosq->out_packet_mutex);
+			return;
+		}
+	}
+
+	memcpy(mosq->out_batch, packet->payload, packet->to_process);
+	len = packet->to_process;
+	mosq->out_batch_count = 1;
+	packet = mosq->out_packet;
+	while (packet && len + packet->to_process <= MOSQ_WRITE_BATCH) {
+		memcpy(&(mosq->out_batch[len]), packet->payload, packet->to_process);
+		len += packet->to_process;
+		mosq->out_batch_count++;
+		/* Nothing may follow a DISCONNECT */
+		if (((packet->command) & 0xF0) == DISCONNECT) {
+			break;
+		}
+		packet = packet->next;
+	}
+	pthread_mutex_unlock(&mosq->out_packet_mutex);
+
+	mosq->out_batch_pos = 0;
+	mosq->out_batch_len = len;
+}
+#endif
+
+/* Called when the whole of the current packet has been written: frees it
+ * and makes the next one current. Returns true if it was a DISCONNECT and
+ * the connection is closed. */
+static bool _mosquitto_packet_sent(struct mosquitto *mosq)
+{
+	struct _mosquitto_packet *packet = mosq->current_out_packet;
+	bool closed = false;
+
+#ifdef WITH_BROKER
+#	ifdef WITH_SYS_TREE
+	g_msgs_sent++;
+	if (((packet->command) & 0xF6) == PUBLISH) {
+		g_pub_msgs_sent++;
+	}
+#	endif
+#else
+	if (((packet->command) & 0xF6) == PUBLISH) {
+		pthread_mutex_lock(&mosq->callback_mutex);
+		if (mosq->on_publish) {
+			/* This is a QoS=0 message */
+			mosq->in_callback = true;
+			mosq->on_publish(mosq, mosq->userdata, packet->mid);
+			mosq->in_callback = false;
+		}
+		pthread_mutex_unlock(&mosq->callback_mutex);
+	} else if (((packet->command) & 0xF0) == DISCONNECT) {
+		/* FIXME what cleanup needs doing here?
+		 * incoming/outgoing messages? */
+		_mosquitto_socket_close(mosq);
+		closed = true;
+	}
+#endif
+
+	/* Free data and reset values */
+	_mosquitto_packet_next(mosq);
+
+	_mosquitto_packet_cleanup(packet);
+	_mosquitto_packet_free(packet);
+
+	pthread_mutex_lock(&mosq->msgtime_mutex);
+	mosq->next_msg_out = mosquitto_time() + mosq->keepalive;
+	pthread_mutex_unlock(&mosq->msgtime_mutex);
+
+#ifndef WITH_BROKER
+	if (closed) {
+		pthread_mutex_lock(&mosq->callback_mutex);
+		if (mosq->on_disconnect) {
+			mosq->in_callback = true;
+			mosq->on_disconnect(mosq, mosq->userdata, 0);
+			mosq->in_callback = false;
+		}
+		pthread_mutex_unlock(&mosq->callback_mutex);
+	}
+#endif
+	return closed;
+}
+
+int _mosquitto_packet_write(struct mosquitto *mosq)
+{
 	struct _mosquitto_packet *packet;
+	bool blocked;
+	int rc;
 
 	if (!mosq) {
 		return MOSQ_ERR_INVAL;
@@ -955,105 +1108,36 @@ int _mosquitto_packet_write(struct mosquitto *mosq)
 	while (mosq->current_out_packet) {
 		packet = mosq->current_out_packet;
 
-		while (packet->to_process > 0) {
-			write_length = _mosquitto_net_write(mosq, &(packet->payload[packet->pos]), packet->to_process);
-			if (write_length > 0) {
-#if defined(WITH_BROKER) && defined(WITH_SYS_TREE)
-				g_bytes_sent += write_length;
-#endif
-				packet->to_process -= write_length;
-				packet->pos += write_length;
-			} else {
-#ifdef WIN32
-				errno = WSAGetLastError();
-#endif
-				if (errno == EAGAIN || errno == COMPAT_EWOULDBLOCK) {
+#if MOSQ_WRITE_BATCH > 0
+		if (mosq->out_batch_len == 0 && packet->pos == 0) {
+			_mosquitto_packet_batch(mosq);
+		}
+		if (mosq->out_batch_len > 0) {
+			rc = _mosquitto_net_write_all(mosq, mosq->out_batch, &mosq->out_batch_pos, &mosq->out_batch_len, &blocked);
+			if (rc || blocked) {
+				pthread_mutex_unlock(&mosq->current_out_packet_mutex);
+				return rc;
+			}
+			while (mosq->out_batch_count > 0) {
+				mosq->out_batch_count--;
+				if (_mosquitto_packet_sent(mosq)) {
 					pthread_mutex_unlock(&mosq->current_out_packet_mutex);
 					return MOSQ_ERR_SUCCESS;
-				} else {
-					pthread_mutex_unlock(&mosq->current_out_packet_mutex);
-					switch (errno) {
-					case COMPAT_ECONNRESET:
-						return MOSQ_ERR_CONN_LOST;
-					default:
-						return MOSQ_ERR_ERRNO;
-					}
 				}
 			}
+			continue;
 		}
+#endif
 
-#ifdef WITH_BROKER
-#	ifdef WITH_SYS_TREE
-		g_msgs_sent++;
-		if (((packet->command) & 0xF6) == PUBLISH) {
-			g_pub_msgs_sent++;
+		rc = _mosquitto_net_write_all(mosq, packet->payload, &packet->pos, &packet->to_process, &blocked);
+		if (rc || blocked) {
+			pthread_mutex_unlock(&mosq->current_out_packet_mutex);
+			return rc;
 		}
-#	endif
-#else
-		if (((packet->command) & 0xF6) == PUBLISH) {
-			pthread_mutex_lock(&mosq->callback_mutex);
-			if (mosq->on_publish) {
-				/* This is a QoS=0 message */
-				mosq->in_callback = true;
-				mosq->on_publish(mosq, mosq->userdata, packet->mid);
-				mosq->in_callback = false;
-			}
-			pthread_mutex_unlock(&mosq->callback_mutex);
-		} else if (((packet->command) & 0xF0) == DISCONNECT) {
-			/* FIXME what cleanup needs doing here?
-			 * incoming/outgoing messages? */
-			_mosquitto_socket_close(mosq);
-
-			/* Start of duplicate, possibly unnecessary code.
-			 * This does leave things in a consistent state at least. */
-			/* Free data and reset values */
-			pthread_mutex_lock(&mosq->out_packet_mutex);
-			mosq->current_out_packet = mosq->out_packet;
-			if (mosq->out_packet) {
-				mosq->out_packet = mosq->out_packet->next;
-				if (!mosq->out_packet) {
-					mosq->out_packet_last = NULL;
-				}
-			}
-			pthread_mutex_unlock(&mosq->out_packet_mutex);
-
-			_mosquitto_packet_cleanup(packet);
-			_mosquitto_free(packet);
-
-			pthread_mutex_lock(&mosq->msgtime_mutex);
-			mosq->next_msg_out = mosquitto_time() + mosq->keepalive;
-			pthread_mutex_unlock(&mosq->msgtime_mutex);
-			/* End of duplicate, possibly unnecessary code */
-
-			pthread_mutex_lock(&mosq->callback_mutex);
-			if (mosq->on_disconnect) {
-				mosq->in_callback = true;
-				mosq->on_disconnect(mosq, mosq->userdata, 0);
-				mosq->in_callback = false;
-			}
-			pthread_mutex_unlock(&mosq->callback_mutex);
+		if (_mosquitto_packet_sent(mosq)) {
 			pthread_mutex_unlock(&mosq->current_out_packet_mutex);
 			return MOSQ_ERR_SUCCESS;
 		}
-#endif
-
-		/* Free data and reset values */
-		pthread_mutex_lock(&mosq->out_packet_mutex);
-		mosq->current_out_packet = mosq->out_packet;
-		if (mosq->out_packet) {
-			mosq->out_packet = mosq->out_packet->next;
-			if (!mosq->out_packet) {
-				mosq->out_packet_last = NULL;
-			}
-		}
-		pthread_mutex_unlock(&mosq->out_packet_mutex);
-
-		_mosquitto_packet_cleanup(packet);
-		_mosquitto_free(packet);
-
-		pthread_mutex_lock(&mosq->msgtime_mutex);
-		mosq->next_msg_out = mosquitto_time() + mosq->keepalive;
-		pthread_mutex_unlock(&mosq->msgtime_mutex);
 	}
 	pthread_mutex_unlock(&mosq->current_out_packet_mutex);
 	return MOSQ_ERR_SUCCESS;
@@ -1175,9 +1259,24 @@ int _mosquitto_packet_read(struct mosquitto *mosq)
 		mosq->in_packet.remaining_count *= -1;
 
 		if (mosq->in_packet.remaining_length > 0) {
-			mosq->in_packet.payload = _mosquitto_malloc(mosq->in_packet.remaining_length * sizeof(uint8_t));
+#if MOSQ_READ_BUF_SIZE > 0
+			/* Packets that fit are read into the same buffer every time */
+			if (mosq->in_packet.remaining_length <= MOSQ_READ_BUF_SIZE) {
+				if (!mosq->in_buf) {
+					mosq->in_buf = _mosquitto_malloc(MOSQ_READ_BUF_SIZE);
+					if (!mosq->in_buf) {
+						return MOSQ_ERR_NOMEM;
+					}
+				}
+				mosq->in_packet.payload = mosq->in_buf;
+				mosq->in_packet.flags |= MOSQ_PACKET_BORROWED;
+			}
+#endif
 			if (!mosq->in_packet.payload) {
-				return MOSQ_ERR_NOMEM;
+				mosq->in_packet.payload = _mosquitto_malloc(mosq->in_packet.remaining_length * sizeof(uint8_t));
+				if (!mosq->in_packet.payload) {
+					return MOSQ_ERR_NOMEM;
+				}
 			}
 			mosq->in_packet.to_process = mosq->in_packet.remaining_length;
 		}
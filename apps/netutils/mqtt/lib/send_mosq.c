@@ -246,7 +246,7 @@ int _mosquitto_send_command_with_mid(struct mosquitto *mosq, uint8_t command, ui
 	int rc;
 
 	assert(mosq);
-	packet = _mosquitto_calloc(1, sizeof(struct _mosquitto_packet));
+	packet = _mosquitto_packet_new();
 	if (!packet) {
 		return MOSQ_ERR_NOMEM;
 	}
@@ -258,7 +258,7 @@ int _mosquitto_send_command_with_mid(struct mosquitto *mosq, uint8_t command, ui
 	packet->remaining_length = 2;
 	rc = _mosquitto_packet_alloc(packet);
 	if (rc) {
-		_mosquitto_free(packet);
+		_mosquitto_packet_free(packet);
 		return rc;
 	}
 
@@ -275,7 +275,7 @@ int _mosquitto_send_simple_command(struct mosquitto *mosq, uint8_t command)
 	int rc;
 
 	assert(mosq);
-	packet = _mosquitto_calloc(1, sizeof(struct _mosquitto_packet));
+	packet = _mosquitto_packet_new();
 	if (!packet) {
 		return MOSQ_ERR_NOMEM;
 	}
@@ -285,7 +285,7 @@ int _mosquitto_send_simple_command(struct mosquitto *mosq, uint8_t command)
 
 	rc = _mosquitto_packet_alloc(packet);
 	if (rc) {
-		_mosquitto_free(packet);
+		_mosquitto_packet_free(packet);
 		return rc;
 	}
 
@@ -305,7 +305,7 @@ int _mosquitto_send_real_publish(struct mosquitto *mosq, uint16_t mid, const cha
 	if (qos > 0) {
 		packetlen += 2;    /* For message id */
 	}
-	packet = _mosquitto_calloc(1, sizeof(struct _mosquitto_packet));
+	packet = _mosquitto_packet_new();
 	if (!packet) {
 		return MOSQ_ERR_NOMEM;
 	}
@@ -315,7 +315,7 @@ int _mosquitto_send_real_publish(struct mosquitto *mosq, uint16_t mid, const cha
 	packet->remaining_length = packetlen;
 	rc = _mosquitto_packet_alloc(packet);
 	if (rc) {
-		_mosquitto_free(packet);
+		_mosquitto_packet_free(packet);
 		return rc;
 	}
 	/* Variable header (topic string) */
@@ -158,16 +158,20 @@ int tftpget(FAR const char *remote, FAR const char *local, in_addr_t addr, bool
 {
 	struct sockaddr_in server;	/* The address of the TFTP server */
 	struct sockaddr_in from;	/* The address the last UDP message recv'd from */
+	struct tftp_opts_s opts;	/* The options in effect for the transfer */
 	FAR uint8_t *packet;		/* Allocated memory to hold one packet */
-	uint16_t blockno = 0;		/* The current transfer block number */
+	uint16_t blockno = 0;		/* The last block number received in order */
 	uint16_t opcode;			/* Received opcode */
 	uint16_t rblockno;			/* Received block number */
+	uint16_t inwindow = 0;		/* Blocks received since the last ACK */
+	bool nakked = false;		/* The current gap in the window was ACKed */
 	int len;					/* Generic length */
 	int sd;						/* Socket descriptor for socket I/O */
 	int fd;						/* File descriptor for file I/O */
-	int retry;					/* Retry counter */
+	int retry = 0;				/* Retry counter */
 	int nbytesrecvd = 0;		/* The number of bytes received in the packet */
 	int ndatabytes;				/* The number of data bytes received */
+	ssize_t nbyteswritten;		/* The number of bytes written to the file */
 	int result = ERROR;			/* Assume failure */
 	int ret;					/* Generic return status */
 
@@ -198,124 +202,190 @@ int tftpget(FAR const char *remote, FAR const char *local, in_addr_t addr, bool
 		goto errout_with_fd;
 	}
 
+	tftp_initopts(&opts);
+
+	/* Send the read request using the well-known port number.  Subsequent
+	 * sendto will use the port number selected by the TFTP server in its
+	 * first response.  Setting the server port to zero here indicates that
+	 * we have not yet received the server port number.
+	 */
+
+	len = tftp_mkreqpacket(packet, TFTP_RRQ, remote, binary);
+	ret = tftp_sendto(sd, packet, len, &server);
+	if (ret != len) {
+		goto errout_with_sd;
+	}
+	server.sin_port = 0;
+
 	/* Then enter the transfer loop.  Loop until the entire file has
-	 * been received or until an error occurs.
+	 * been received or until an error occurs.  The server sends up to
+	 * opts.windowsize blocks back to back and waits for the ACK of the
+	 * last one (RFC 7440); with the default window of one block this is
+	 * the RFC 1350 lock-step transfer.
 	 */
 
-	do {
-		/* Increment the TFTP block number for the next transfer */
+	for (;;) {
+		/* Get the next packet from the server */
 
-		blockno++;
+		nbytesrecvd = tftp_recvfrom(sd, packet, TFTP_IOBUFSIZE, &from);
 
-		/* Send the next block if the file within a loop.  We will
-		 * retry up to TFTP_RETRIES times before giving up on the
-		 * transfer.
-		 */
+		/* Check if anything valid was received */
 
-		for (retry = 0; retry < TFTP_RETRIES; retry++) {
-			/* Send the read request using the well-known port number before
-			 * receiving the first block.  Each retry of the first block will
-			 * re-send the request.
+		if (nbytesrecvd <= 0) {
+			/* We will retry up to TFTP_RETRIES times before giving up on
+			 * the transfer.
 			 */
 
-			if (blockno == 1) {
+			if (++retry >= TFTP_RETRIES) {
+				nvdbg("Retry limit exceeded\n");
+				goto errout_with_sd;
+			}
+
+			/* Re-send the read request if the server has not answered yet.
+			 * Otherwise ACK the last block received in order so that the
+			 * server restarts the window right after it.
+			 */
+
+			if (!server.sin_port) {
 				len = tftp_mkreqpacket(packet, TFTP_RRQ, remote, binary);
 				server.sin_port = HTONS(CONFIG_NETUTILS_TFTP_PORT);
 				ret = tftp_sendto(sd, packet, len, &server);
-				if (ret != len) {
-					goto errout_with_sd;
-				}
-
-				/* Subsequent sendto will use the port number selected by the TFTP
-				 * server in the DATA packet.  Setting the server port to zero
-				 * here indicates that we have not yet received the server port number.
-				 */
-
 				server.sin_port = 0;
+			} else {
+				len = tftp_mkackpacket(packet, blockno);
+				ret = tftp_sendto(sd, packet, len, &server);
 			}
 
-			/* Get the next packet from the server */
-
-			nbytesrecvd = tftp_recvfrom(sd, packet, TFTP_IOBUFSIZE, &from);
+			if (ret != len) {
+				goto errout_with_sd;
+			}
 
-			/* Check if anything valid was received */
+			inwindow = 0;
+			continue;
+		}
 
-			if (nbytesrecvd > 0) {
-				/* Verify the sender address and port number */
+		/* Verify the sender address and port number */
 
-				if (server.sin_addr.s_addr != from.sin_addr.s_addr) {
-					nvdbg("Invalid address in DATA\n");
-					retry--;
-					continue;
-				}
+		if (server.sin_addr.s_addr != from.sin_addr.s_addr) {
+			nvdbg("Invalid address in DATA\n");
+			continue;
+		}
 
-				if (server.sin_port && server.sin_port != from.sin_port) {
-					nvdbg("Invalid port in DATA\n");
-					len = tftp_mkerrpacket(packet, TFTP_ERR_UNKID, TFTP_ERRST_UNKID);
-					ret = tftp_sendto(sd, packet, len, &from);
-					retry--;
-					continue;
-				}
+		if (server.sin_port && server.sin_port != from.sin_port) {
+			nvdbg("Invalid port in DATA\n");
+			len = tftp_mkerrpacket(packet, TFTP_ERR_UNKID, TFTP_ERRST_UNKID);
+			ret = tftp_sendto(sd, packet, len, &from);
+			continue;
+		}
 
-				/* Parse the incoming DATA packet */
+		/* Parse the incoming DATA packet */
 
-				if (nbytesrecvd < TFTP_DATAHEADERSIZE) {
-					/* Packet is not big enough to be parsed */
+		if (nbytesrecvd < TFTP_DATAHEADERSIZE) {
+			/* Packet is not big enough to be parsed */
 
-					nvdbg("Tiny data packet ignored\n");
-					continue;
-				}
+			nvdbg("Tiny data packet ignored\n");
+			continue;
+		}
 
-				if (tftp_parsedatapacket(packet, &opcode, &rblockno) != OK || blockno != rblockno) {
-					/* Opcode is not TFTP_DATA or the block number is unexpected */
+		if (tftp_parsedatapacket(packet, &opcode, &rblockno) != OK) {
+			/* The server acknowledged the requested options.  The OACK takes
+			 * the place of block 0 and is answered with ACK 0.  It is sent
+			 * again by the server if that ACK gets lost.
+			 */
 
-					nvdbg("Parse failure\n");
-					if (opcode > TFTP_MAXRFC1350) {
-						len = tftp_mkerrpacket(packet, TFTP_ERR_ILLEGALOP, TFTP_ERRST_ILLEGALOP);
-						ret = tftp_sendto(sd, packet, len, &from);
-					}
+			if (opcode == TFTP_OACK) {
+				if (blockno != 0) {
+					nvdbg("Late OACK ignored\n");
 					continue;
 				}
 
-				/* Replace the server port to the one in the good data response */
+				if (tftp_parseoack(packet, nbytesrecvd, &opts) != OK) {
+					len = tftp_mkerrpacket(packet, TFTP_ERR_NEGOTIATE, TFTP_ERRST_NEGOTIATE);
+					(void)tftp_sendto(sd, packet, len, &from);
+					goto errout_with_sd;
+				}
 
-				if (!server.sin_port) {
-					server.sin_port = from.sin_port;
+				server.sin_port = from.sin_port;
+				len = tftp_mkackpacket(packet, 0);
+				ret = tftp_sendto(sd, packet, len, &server);
+				if (ret != len) {
+					goto errout_with_sd;
 				}
 
-				/* Then break out of the loop */
+				retry = 0;
+				continue;
+			}
+
+			/* Opcode is not TFTP_DATA */
 
-				break;
+			nvdbg("Parse failure\n");
+			if (opcode > TFTP_OACK) {
+				len = tftp_mkerrpacket(packet, TFTP_ERR_ILLEGALOP, TFTP_ERRST_ILLEGALOP);
+				ret = tftp_sendto(sd, packet, len, &from);
 			}
+			continue;
 		}
 
-		/* Did we exhaust all of the retries? */
+		/* Replace the server port to the one in the good data response */
 
-		if (retry == TFTP_RETRIES) {
-			nvdbg("Retry limit exceeded\n");
-			goto errout_with_sd;
+		if (!server.sin_port) {
+			server.sin_port = from.sin_port;
+		}
+
+		if (rblockno != (uint16_t)(blockno + 1)) {
+			/* A block of the window was lost or reordered, or this is a
+			 * duplicate of a block already written.  ACK the last block
+			 * received in order, once per gap, and drop the rest of the
+			 * window until the server restarts it.
+			 */
+
+			nvdbg("Unexpected block %d\n", rblockno);
+			if (!nakked) {
+				len = tftp_mkackpacket(packet, blockno);
+				ret = tftp_sendto(sd, packet, len, &server);
+				if (ret != len) {
+					goto errout_with_sd;
+				}
+
+				nakked = true;
+				inwindow = 0;
+			}
+			continue;
 		}
 
-		/* Write the received data chunk to the file */
+		blockno++;
+		nakked = false;
+		retry = 0;
+
+		/* Write the received data chunk straight to the file */
 
 		ndatabytes = nbytesrecvd - TFTP_DATAHEADERSIZE;
 		tftp_dumpbuffer("Recvd DATA", packet + TFTP_DATAHEADERSIZE, ndatabytes);
 
-		ssize_t nSize = tftp_write(fd, packet + TFTP_DATAHEADERSIZE, ndatabytes);
-		if (nSize < 0) {
+		nbyteswritten = tftp_write(fd, packet + TFTP_DATAHEADERSIZE, ndatabytes);
+		if (nbyteswritten < 0) {
 			goto errout_with_sd;
 		}
-		printf("Received %d bytes\n", nSize);
+		nvdbg("Received %d bytes\n", nbyteswritten);
 
-		/* Send the acknowledgment */
+		/* Send the acknowledgment for the last block of the window or for
+		 * the short block that ends the transfer.
+		 */
 
-		len = tftp_mkackpacket(packet, blockno);
-		ret = tftp_sendto(sd, packet, len, &server);
-		if (ret != len) {
-			goto errout_with_sd;
+		if (ndatabytes < opts.blksize || ++inwindow >= opts.windowsize) {
+			len = tftp_mkackpacket(packet, blockno);
+			ret = tftp_sendto(sd, packet, len, &server);
+			if (ret != len) {
+				goto errout_with_sd;
+			}
+			nvdbg("ACK blockno %d\n", blockno);
+			inwindow = 0;
 		}
-		nvdbg("ACK blockno %d\n", blockno);
-	} while (ndatabytes >= TFTP_DATASIZE);
+
+		if (ndatabytes < opts.blksize) {
+			break;
+		}
+	}
 
 	/* Return success */
 
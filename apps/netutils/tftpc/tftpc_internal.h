@@ -89,6 +89,19 @@
 #define CONFIG_NETUTILS_TFTP_TIMEOUT 10	/* One second */
 #endif
 
+/* Requested data block size (RFC 2348) and number of DATA packets sent
+ * per ACK (RFC 7440).  The options are only requested when they differ
+ * from the RFC 1350 lock-step transfer of 512-byte blocks.
+ */
+
+#ifndef CONFIG_NETUTILS_TFTP_BLOCKSIZE
+#define CONFIG_NETUTILS_TFTP_BLOCKSIZE 512
+#endif
+
+#ifndef CONFIG_NETUTILS_TFTP_WINDOWSIZE
+#define CONFIG_NETUTILS_TFTP_WINDOWSIZE 1
+#endif
+
 /* Dump received buffers */
 
 #undef CONFIG_NETUTILS_TFTP_DUMPBUFFERS
@@ -100,7 +113,9 @@
 #define TFTP_DATAHEADERSIZE 4
 
 /* The maximum size for TFTP data is determined by the configured UDP packet
- * payload size (UDP_MSS), but cannot exceed 512 + sizeof(TFTP_DATA header).
+ * payload size (UDP_MSS), but cannot exceed the requested block size +
+ * sizeof(TFTP_DATA header).  The block size actually used by a transfer is
+ * the one acknowledged by the server, 512 if it ignored the option.
  *
  * In the case where there are multiple network devices with different
  * link layer protocols (CONFIG_NET_MULTILINK), each network device
@@ -108,13 +123,20 @@
  * the minimum MSS for that case.
  */
 
+#define TFTP_MAX(a, b)     ((a) > (b) ? (a) : (b))
+
 #define TFTP_DATAHEADERSIZE 4
-#define TFTP_MAXPACKETSIZE  (TFTP_DATAHEADERSIZE+512)
+#define TFTP_MAXPACKETSIZE  (TFTP_DATAHEADERSIZE+TFTP_MAX(CONFIG_NETUTILS_TFTP_BLOCKSIZE, 512))
 #define TFTP_PACKETSIZE   TFTP_MAXPACKETSIZE
 
 #define TFTP_DATASIZE      (TFTP_PACKETSIZE-TFTP_DATAHEADERSIZE)
 #define TFTP_IOBUFSIZE     (TFTP_PACKETSIZE+8)
 
+/* RFC 1350 defaults, used until an OACK says otherwise */
+
+#define TFTP_DEFBLKSIZE    512
+#define TFTP_DEFWINDOWSIZE 1
+
 /* TFTP Opcodes *************************************************************/
 
 #define TFTP_RRQ  1				/* Read Request          RFC 1350, RFC 2090 */
@@ -155,6 +177,13 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Transfer options in effect (RFC 2347) */
+
+struct tftp_opts_s {
+	uint16_t blksize;			/* Data bytes per DATA packet */
+	uint16_t windowsize;		/* DATA packets sent per ACK */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -169,6 +198,8 @@ extern int tftp_sockinit(struct sockaddr_in *server, in_addr_t addr);
 extern int tftp_mkreqpacket(uint8_t *buffer, int opcode, const char *path, bool binary);
 extern int tftp_mkackpacket(uint8_t *buffer, uint16_t blockno);
 extern int tftp_mkerrpacket(uint8_t *buffer, uint16_t errorcode, const char *errormsg);
+extern void tftp_initopts(struct tftp_opts_s *opts);
+extern int tftp_parseoack(const uint8_t *packet, int len, struct tftp_opts_s *opts);
 #if defined(CONFIG_DEBUG) && defined(CONFIG_DEBUG_NET)
 extern int tftp_parseerrpacket(const uint8_t *packet);
 #endif
@@ -61,6 +61,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
@@ -153,6 +154,9 @@ int tftp_sockinit(struct sockaddr_in *server, in_addr_t addr)
  *     N bytes: mode
  *     1 byte:  0
  *
+ *   followed by the blksize and windowsize options, each as a name and a
+ *   decimal value string, if they differ from the RFC 1350 defaults.
+ *
  * Return
  *  Then number of bytes in the request packet (never fails)
  *
@@ -160,9 +164,19 @@ int tftp_sockinit(struct sockaddr_in *server, in_addr_t addr)
 
 int tftp_mkreqpacket(uint8_t *buffer, int opcode, const char *path, bool binary)
 {
+	int len;
+
 	buffer[0] = opcode >> 8;
 	buffer[1] = opcode & 0xff;
-	return sprintf((char *)&buffer[2], "%s%c%s", path, 0, tftp_mode(binary)) + 3;
+	len = sprintf((char *)&buffer[2], "%s%c%s", path, 0, tftp_mode(binary)) + 3;
+
+#if CONFIG_NETUTILS_TFTP_BLOCKSIZE != TFTP_DEFBLKSIZE
+	len += sprintf((char *)&buffer[len], "blksize%c%d", 0, CONFIG_NETUTILS_TFTP_BLOCKSIZE) + 1;
+#endif
+#if CONFIG_NETUTILS_TFTP_WINDOWSIZE != TFTP_DEFWINDOWSIZE
+	len += sprintf((char *)&buffer[len], "windowsize%c%d", 0, CONFIG_NETUTILS_TFTP_WINDOWSIZE) + 1;
+#endif
+	return len;
 }
 
 /****************************************************************************
@@ -208,6 +222,92 @@ int tftp_mkerrpacket(uint8_t *buffer, uint16_t errorcode, const char *errormsg)
 	return strlen(errormsg) + 5;
 }
 
+/****************************************************************************
+ * Name: tftp_initopts
+ *
+ * Description:
+ *   Set the options of a transfer to the RFC 1350 defaults.  They stay in
+ *   effect unless the server acknowledges the requested ones with an OACK.
+ *
+ ****************************************************************************/
+
+void tftp_initopts(struct tftp_opts_s *opts)
+{
+	opts->blksize = TFTP_DEFBLKSIZE;
+	opts->windowsize = TFTP_DEFWINDOWSIZE;
+}
+
+/****************************************************************************
+ * Name: tftp_parseoack
+ *
+ * Description:
+ *   OACK message format:
+ *
+ *     2 bytes: Opcode (network order == big-endian)
+ *     N bytes: Option name
+ *     1 byte:  0
+ *     N bytes: Option value (decimal string)
+ *     1 byte:  0
+ *     ...
+ *
+ *   The server may only lower the values that were requested and may not
+ *   add options of its own (RFC 2347).  Options it left out keep their
+ *   default value.
+ *
+ * Return
+ *   OK if the options were accepted, ERROR if the transfer must be
+ *   terminated with TFTP_ERR_NEGOTIATE.
+ *
+ ****************************************************************************/
+
+int tftp_parseoack(const uint8_t *packet, int len, struct tftp_opts_s *opts)
+{
+	const char *ptr = (const char *)&packet[2];
+	const char *end = (const char *)&packet[len];
+	const char *name;
+	const char *value;
+	long n;
+
+	tftp_initopts(opts);
+
+	while (ptr < end) {
+		name = ptr;
+		ptr += strnlen(ptr, end - ptr) + 1;
+		if (ptr >= end) {
+			ndbg("Truncated OACK\n");
+			return ERROR;
+		}
+
+		value = ptr;
+		ptr += strnlen(ptr, end - ptr) + 1;
+		if (ptr > end) {
+			ndbg("Truncated OACK\n");
+			return ERROR;
+		}
+
+		n = strtol(value, NULL, 10);
+		if (strcasecmp(name, "blksize") == 0) {
+			if (n < 8 || n > CONFIG_NETUTILS_TFTP_BLOCKSIZE) {
+				ndbg("Bad blksize: %ld\n", n);
+				return ERROR;
+			}
+			opts->blksize = (uint16_t)n;
+		} else if (strcasecmp(name, "windowsize") == 0) {
+			if (n < 1 || n > CONFIG_NETUTILS_TFTP_WINDOWSIZE) {
+				ndbg("Bad windowsize: %ld\n", n);
+				return ERROR;
+			}
+			opts->windowsize = (uint16_t)n;
+		} else {
+			ndbg("Unrequested option: %s\n", name);
+			return ERROR;
+		}
+	}
+
+	nvdbg("blksize %d windowsize %d\n", opts->blksize, opts->windowsize);
+	return OK;
+}
+
 /****************************************************************************
  * Name: tftp_parseerrpacket
  *
@@ -136,21 +136,22 @@ static inline ssize_t tftp_read(int fd, uint8_t *buf, size_t buflen)
  *
  *     2 bytes: Opcode (network order == big-endian)
  *     2 bytes: Block number (network order == big-endian)
- *     N bytes: Data (where N <= 512)
+ *     N bytes: Data (where N <= blksize)
  *
  * Input Parameters:
  *   fd      - File descriptor used to read from the file
  *   offset  - File offset to read from
  *   packet  - Buffer to write the data packet into
  *   blockno - The block number of the packet
+ *   blksize - The negotiated block size
  *
  * Return Value:
- *   Number of bytes read into the packet. <TFTP_PACKETSIZE means end of file;
- *   <1 if an error occurs.
+ *   Number of bytes read into the packet. <blksize+TFTP_DATAHEADERSIZE means
+ *   end of file; <1 if an error occurs.
  *
  ****************************************************************************/
 
-int tftp_mkdatapacket(int fd, off_t offset, uint8_t *packet, uint16_t blockno)
+int tftp_mkdatapacket(int fd, off_t offset, uint8_t *packet, uint16_t blockno, uint16_t blksize)
 {
 	off_t tmp;
 	int nbytesread;
@@ -172,7 +173,7 @@ int tftp_mkdatapacket(int fd, off_t offset, uint8_t *packet, uint16_t blockno)
 
 	/* Read the file data into the packet buffer */
 
-	nbytesread = tftp_read(fd, &packet[TFTP_DATAHEADERSIZE], TFTP_DATASIZE);
+	nbytesread = tftp_read(fd, &packet[TFTP_DATAHEADERSIZE], blksize);
 	if (nbytesread < 0) {
 		return ERROR;
 	}
@@ -194,13 +195,16 @@ int tftp_mkdatapacket(int fd, off_t offset, uint8_t *packet, uint16_t blockno)
  *   server  - The address of the server
  *   port    - The port number of the server (0 if not yet known)
  *   blockno - Location to return block number in the received ACK
+ *   opts    - Non-NULL while waiting for the answer to the write request.
+ *             An OACK is then accepted in place of ACK 0 and the options
+ *             it carries are returned here.
  *
  * Returned Value:
  *   OK:success and blockno valid, ERROR:failure.
  *
  ****************************************************************************/
 
-static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint16_t *port, uint16_t *blockno)
+static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint16_t *port, uint16_t *blockno, struct tftp_opts_s *opts)
 {
 	struct sockaddr_in from;	/* The address the last UDP message recv'd from */
 	ssize_t nbytes;				/* The number of bytes received. */
@@ -247,10 +251,10 @@ static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint
 					continue;
 				}
 
-				if (*port != server->sin_port) {
+				if (*port != from.sin_port) {
 					nvdbg("Invalid port in DATA\n");
 					packetlen = tftp_mkerrpacket(packet, TFTP_ERR_UNKID, TFTP_ERRST_UNKID);
-					(void)tftp_sendto(sd, packet, packetlen, server);
+					(void)tftp_sendto(sd, packet, packetlen, &from);
 					continue;
 				}
 
@@ -259,6 +263,20 @@ static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint
 				opcode = (uint16_t)packet[0] << 8 | (uint16_t)packet[1];
 				rblockno = (uint16_t)packet[2] << 8 | (uint16_t)packet[3];
 
+				/* The server acknowledged the requested options */
+
+				if (opcode == TFTP_OACK && opts) {
+					if (tftp_parseoack(packet, nbytes, opts) != OK) {
+						packetlen = tftp_mkerrpacket(packet, TFTP_ERR_NEGOTIATE, TFTP_ERRST_NEGOTIATE);
+						(void)tftp_sendto(sd, packet, packetlen, server);
+						return ERROR;
+					}
+
+					nvdbg("Received OACK\n");
+					*blockno = 0;
+					return OK;
+				}
+
 				/* Verify that the message that we received is an ACK for the
 				 * expected block number.
 				 */
@@ -270,7 +288,7 @@ static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint
 						(void)tftp_parseerrpacket(packet);
 					} else
 #endif
-						if (opcode > TFTP_MAXRFC1350) {
+						if (opcode > TFTP_OACK) {
 							packetlen = tftp_mkerrpacket(packet, TFTP_ERR_ILLEGALOP, TFTP_ERRST_ILLEGALOP);
 							(void)tftp_sendto(sd, packet, packetlen, server);
 						}
@@ -314,11 +332,15 @@ static int tftp_rcvack(int sd, uint8_t *packet, struct sockaddr_in *server, uint
 int tftpput(const char *local, const char *remote, in_addr_t addr, bool binary)
 {
 	struct sockaddr_in server;	/* The address of the TFTP server */
+	struct tftp_opts_s opts;	/* The options in effect for the transfer */
 	uint8_t *packet;			/* Allocated memory to hold one packet */
-	off_t offset;				/* Offset into source file */
-	uint16_t blockno;			/* The current transfer block number */
+	off_t offset;				/* Offset of the window into source file */
+	uint16_t blockno;			/* The first block number of the window */
 	uint16_t rblockno;			/* The ACK'ed block number */
+	uint16_t nacked;			/* The number of blocks of the window ACK'ed */
+	uint16_t nsent;				/* The number of blocks of the window sent */
 	uint16_t port = 0;			/* This is the port number for the transfer */
+	bool lastblock;				/* The window ends with the last block */
 	int packetlen;				/* The length of the data packet */
 	int sd;						/* Socket descriptor for socket I/O */
 	int fd;						/* File descriptor for file I/O */
@@ -356,7 +378,6 @@ int tftpput(const char *local, const char *remote, in_addr_t addr, bool binary)
 	 * of droppying packets if there is nothing hit in the ARP table.
 	 */
 
-	blockno = 1;
 	retry = 0;
 	for (;;) {
 		packetlen = tftp_mkreqpacket(packet, TFTP_WRQ, remote, binary);
@@ -365,9 +386,10 @@ int tftpput(const char *local, const char *remote, in_addr_t addr, bool binary)
 			goto errout_with_sd;
 		}
 
-		/* Receive the ACK for the write request */
+		/* Receive the ACK (or OACK) for the write request */
 
-		if (tftp_rcvack(sd, packet, &server, &port, NULL) == 0) {
+		tftp_initopts(&opts);
+		if (tftp_rcvack(sd, packet, &server, &port, &rblockno, &opts) == OK && rblockno == 0) {
 			break;
 		}
 
@@ -384,47 +406,56 @@ int tftpput(const char *local, const char *remote, in_addr_t addr, bool binary)
 		}
 	}
 
-	/* Then loop sending the entire file to the server in chunks */
+	/* Then loop sending the entire file to the server in windows of up to
+	 * opts.windowsize blocks.  An ACK covers every block up to the one it
+	 * names and the next window starts right after it (RFC 7440).  With
+	 * the default window of one block this is the RFC 1350 lock-step
+	 * transfer.
+	 */
 
+	blockno = 1;
 	offset = 0;
 	retry = 0;
 
 	for (;;) {
-		/* Construct the next data packet */
+		/* Send the window, stopping early at the end of the file */
 
-		packetlen = tftp_mkdatapacket(fd, offset, packet, blockno);
-		if (packetlen < 0) {
-			goto errout_with_sd;
-		}
+		lastblock = false;
+		for (nsent = 0; nsent < opts.windowsize && !lastblock; nsent++) {
+			packetlen = tftp_mkdatapacket(fd, offset + (off_t)nsent * opts.blksize, packet, blockno + nsent, opts.blksize);
+			if (packetlen < 0) {
+				goto errout_with_sd;
+			}
 
-		/* Send the next data chunk */
+			ret = tftp_sendto(sd, packet, packetlen, &server);
+			if (ret != packetlen) {
+				goto errout_with_sd;
+			}
 
-		ret = tftp_sendto(sd, packet, packetlen, &server);
-		if (ret != packetlen) {
-			goto errout_with_sd;
+			lastblock = (packetlen < opts.blksize + TFTP_DATAHEADERSIZE);
 		}
 
-		/* Check for an ACK for the data chunk */
+		/* Check for an ACK for the window */
 
-		if (tftp_rcvack(sd, packet, &server, &port, &rblockno) == OK) {
-			/* Check if the packet that we just sent was ACK'ed.  If not,
-			 * we just loop to resend the same packet (same blockno, same
-			 * file offset).
+		if (tftp_rcvack(sd, packet, &server, &port, &rblockno, NULL) == OK) {
+			/* Check how much of the window was ACK'ed.  If nothing, we just
+			 * loop to resend the same window (same blockno, same file offset).
 			 */
 
-			if (rblockno == blockno) {
-				/* Yes.. If we are at the end of the file and if all of the packets
-				 * have been ACKed, then we are done.
+			nacked = (uint16_t)(rblockno - blockno + 1);
+			if (nacked >= 1 && nacked <= nsent) {
+				/* If the last block of the file has been ACKed, then we are
+				 * done.
 				 */
 
-				if (packetlen < TFTP_PACKETSIZE) {
+				if (lastblock && nacked == nsent) {
 					break;
 				}
 
-				/* Not the last block.. set up for the next block */
+				/* Set up for the window after the ACK'ed block */
 
-				blockno++;
-				offset += TFTP_DATASIZE;
+				blockno += nacked;
+				offset += (off_t)nacked * opts.blksize;
 				retry = 0;
 
 				/* Skip the retry test */
@@ -433,7 +464,7 @@ int tftpput(const char *local, const char *remote, in_addr_t addr, bool binary)
 			}
 		}
 
-		/* We are going to loop and re-send the data packet. Check the retry
+		/* We are going to loop and re-send the window. Check the retry
 		 * count so that we do not loop forever.
 		 */
 
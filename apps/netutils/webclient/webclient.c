@@ -72,11 +72,14 @@
 #include <sys/socket.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
 
 #ifdef CONFIG_LIBC_NETDB
 #include <netdb.h>
@@ -139,6 +142,28 @@
 
 #define MBED_DEBUG_LEVEL 0
 
+/* How the entity of a response is delimited */
+
+#define WGET_BODY_LENGTH           0 /* Content-Length bytes */
+#define WGET_BODY_CHUNKED          1 /* Chunked transfer encoding */
+#define WGET_BODY_CLOSE            2 /* By the end of the connection */
+
+/* Position in a chunked entity */
+
+#define WGET_CHUNK_SIZE            0 /* Chunk size line */
+#define WGET_CHUNK_DATA            1 /* Chunk data */
+#define WGET_CHUNK_DATA_END        2 /* CRLF after the chunk data */
+#define WGET_CHUNK_TRAILER         3 /* Trailer, after the last chunk */
+
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+#ifndef CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE
+#define CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE 2
+#endif
+#ifndef CONFIG_NETUTILS_WEBCLIENT_IDLE_TIMEOUT
+#define CONFIG_NETUTILS_WEBCLIENT_IDLE_TIMEOUT 30
+#endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -169,6 +194,37 @@ struct wget_s {
 #endif
 	char hostname[CONFIG_WEBCLIENT_MAXHOSTNAME];
 	char filename[CONFIG_WEBCLIENT_MAXFILENAME];
+
+	/* Framing of the response, see wget_parse_response() */
+
+	uint8_t body; /* WGET_BODY_* */
+	uint8_t chunkstate; /* WGET_CHUNK_* */
+	bool chunked; /* Transfer-Encoding: chunked */
+	bool keepalive; /* The server keeps the connection open */
+	int remain; /* Bytes left in the entity or the chunk */
+	int entity_len; /* Bytes of entity received */
+};
+
+/* A connection to a server.  Pooled connections keep their TLS
+ * configuration and last session when they are closed.
+ */
+
+struct wget_conn_s {
+	int sockfd;
+	bool connected;
+	bool tls;
+#ifdef CONFIG_NET_SECURITY_TLS
+	struct http_client_tls_t *tls_ctx; /* Configuration, context, session */
+	bool tls_session; /* tls_ctx->tls_session can be resumed */
+	const char *root_ca; /* The certificates of the configuration */
+	const char *dev_cert;
+#endif
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+	bool busy; /* In use by a request */
+	uint16_t port;
+	char hostname[CONFIG_WEBCLIENT_MAXHOSTNAME]; /* Empty if unused */
+	time_t lastused;
+#endif
 };
 
 /****************************************************************************
@@ -206,6 +262,15 @@ static const char g_httpcontsize[] = "Content-Length: ";
 static const char g_httpchunked[] = "Transfer-Encoding: chunked";
 const char *tlsname = "araweb_tls_client";
 
+#ifndef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+static const char g_httpconnclose[] = "Connection: close";
+#endif
+
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+static struct wget_conn_s g_wget_pool[CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE];
+static pthread_mutex_t g_wget_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -591,7 +656,7 @@ void wget_tls_ssl_release(struct http_client_tls_t *client)
 	mbedtls_ssl_free(&(client->tls_ssl));
 }
 
-int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname)
+int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname, mbedtls_ssl_session *session)
 {
 	int result = 0;
 
@@ -632,6 +697,11 @@ int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname)
 	mbedtls_ssl_set_bio(&(client->tls_ssl), &(client->tls_client_fd),
 						mbedtls_net_send, mbedtls_net_recv, NULL);
 
+	/* Offer the session of a previous connection to skip the full handshake */
+	if (session && (result = mbedtls_ssl_set_session(&(client->tls_ssl), session)) != 0) {
+		ndbg("Error: mbedtls_ssl_set_session returned %d\n", result);
+	}
+
 	/* Handshake */
 	while ((result = mbedtls_ssl_handshake(&(client->tls_ssl))) != 0) {
 		if (result != MBEDTLS_ERR_SSL_WANT_READ &&
@@ -697,6 +767,16 @@ static int wget_msg_construct(char *buf, struct http_client_request_t *param, st
 	if (dest == NULL) {
 		return WGET_MSG_CONSTRUCT_ERR;
 	}
+#ifndef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+	dest = wget_strcpy(dest, g_httpconnclose, param);
+	if (dest == NULL) {
+		return WGET_MSG_CONSTRUCT_ERR;
+	}
+	dest = wget_strcpy(dest, g_httpcrnl, param);
+	if (dest == NULL) {
+		return WGET_MSG_CONSTRUCT_ERR;
+	}
+#endif
 
 	/* header of entity */
 
@@ -890,235 +970,506 @@ static int wget_socket_connect(struct wget_s *ws)
 }
 
 /****************************************************************************
- * Name: wget_base
+ * Name: wget_conn_send, wget_conn_recv
  *
  * Description:
- *   Obtain the requested file from an HTTP server using the GET method.
- *
- *   Note: If the function is passed a host name, it must already be in
- *   the resolver cache in order for the function to connect to the web
- *   server. It is therefore up to the calling module to implement the
- *   resolver calls and the signal handler used for reporting a resolv
- *   query answer.
- *
- * Input Parameters
- *   url      - A pointer to a string containing either the full URL to
- *              the file to get (e.g., http://www.nutt.org/index.html, or
- *              http://192.168.23.1:80/index.html).
- *   buffer   - A user provided buffer to receive the file data (also
- *              used for the outgoing GET request
- *   buflen   - The size of the user provided buffer
- *   callback - As data is obtained from the host, this function is
- *              to dispose of each block of file data as it is received.
- *   mode     - Indicates GET or POST modes
- *
- * Returned Value:
- *   0: if the GET operation completed successfully;
- *  -1: On a failure with errno set appropriately
+ *   Send a whole buffer, receive the next bytes of the response, on a
+ *   plain or TLS connection.  wget_conn_recv() returns 0 when the server
+ *   closed the connection.
  *
  ****************************************************************************/
+
+static int wget_conn_send(struct wget_conn_s *conn, const char *buf, int len)
+{
+	int ret;
+
+	while (len > 0) {
 #ifdef CONFIG_NET_SECURITY_TLS
-static pthread_addr_t wget_base(void *arg)
+		if (conn->tls) {
+			ret = mbedtls_ssl_write(&conn->tls_ctx->tls_ssl, (const unsigned char *)buf, len);
+		} else
+#endif
+		{
+			ret = send(conn->sockfd, buf, len, 0);
+		}
+		if (ret < 1) {
+			ndbg("ERROR: send failed: %d\n", ret);
+			return WGET_ERR;
+		}
+		buf += ret;
+		len -= ret;
+	}
+
+	return WGET_OK;
+}
+
+static int wget_conn_recv(struct wget_conn_s *conn, char *buf, int len)
 {
-	int sockfd = -1;
+#ifdef CONFIG_NET_SECURITY_TLS
 	int ret;
-	int buf_len, sndlen, len;
-	int remain = WEBCLIENT_CONF_MAX_MESSAGE_SIZE;
-	int encoding = CONTENT_LENGTH;
-	int state = HTTP_REQUEST_HEADER;
-	struct http_message_len_t mlen = {0,};
-	struct wget_s ws;
-	struct http_client_request_t *param = (struct http_client_request_t *)arg;
-	struct http_client_response_t response = {0, };
-	bool read_finish = false;
 
-	struct http_client_tls_t *client_tls = (struct http_client_tls_t *)malloc(sizeof(
-			struct http_client_tls_t));
-	int handshake_retry = WEBCLIENT_CONF_HANDSHAKE_RETRY;
+	if (conn->tls) {
+		do {
+			ret = mbedtls_ssl_read(&conn->tls_ctx->tls_ssl, (unsigned char *)buf, len);
+		} while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
 
-	if (client_tls == NULL) {
-		free(param->buffer);
-		return (pthread_addr_t)WGET_ERR;
+		if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+			return 0;
+		}
+		return ret;
 	}
+#endif
 
-	/* Initialize the state structure */
-	memset(&ws, 0, sizeof(struct wget_s));
-	ws.buffer = param->buffer;
-	ws.buflen = param->buflen;
+	return recv(conn->sockfd, buf, len, 0);
+}
 
-	/* Parse the hostname (with optional port number) and filename from the URL */
-	ret = netlib_parsehttpurl(param->url, &ws.port, ws.hostname, CONFIG_WEBCLIENT_MAXHOSTNAME, ws.filename, CONFIG_WEBCLIENT_MAXFILENAME);
-	if (ret != 0) {
-		ndbg("ERROR: Malformed HTTP URL: %s\n", param->url);
-		free(param->buffer);
-		free(client_tls);
-		return (pthread_addr_t)WGET_ERR;
+/****************************************************************************
+ * Name: wget_conn_open, wget_conn_close, wget_conn_release
+ *
+ * Description:
+ *   Connect to the server of the request, close the connection, or close
+ *   it and free its TLS configuration.  After a full handshake the TLS
+ *   session is saved in the connection, and the next wget_conn_open()
+ *   resumes it: a pooled connection that the server or the idle timeout
+ *   closed is reopened without paying for a full handshake again.
+ *
+ ****************************************************************************/
+
+static void wget_conn_close(struct wget_conn_s *conn)
+{
+	if (!conn->connected) {
+		return;
 	}
 
-	nvdbg("hostname='%s' filename='%s'\n", ws.hostname, ws.filename);
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (conn->tls) {
+		wget_tls_ssl_release(conn->tls_ctx);
+	} else
+#endif
+	{
+		close(conn->sockfd);
+	}
+	conn->connected = false;
+}
+
+static void wget_conn_release(struct wget_conn_s *conn)
+{
+	wget_conn_close(conn);
 
-	if (param->tls && webclient_tls_init(client_tls, &param->ssl_config)) {
-		ndbg("Fail to client tls init\n");
-		goto errout_before_tlsinit;
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (conn->tls_ctx) {
+		wget_tls_release(conn->tls_ctx);
+		free(conn->tls_ctx);
+		conn->tls_ctx = NULL;
 	}
+	conn->tls_session = false;
+#endif
+}
 
-	/* Re-initialize portions of the state structure that could have
-	 * been left from the previous time through the loop and should not
-	 * persist with the new connection.
-	 */
-	ws.httpstatus = HTTPSTATUS_NONE;
-	ws.offset = 0;
-	ws.datend = 0;
-	ws.ndx = 0;
+static int wget_conn_open(struct wget_conn_s *conn, struct wget_s *ws, struct http_client_request_t *param)
+{
+#ifdef CONFIG_NET_SECURITY_TLS
+	int handshake_retry = WEBCLIENT_CONF_HANDSHAKE_RETRY;
+	int ret;
 
-	if ((sndlen = wget_msg_construct(ws.buffer, param, &ws)) <= 0) {
-		ndbg("ERROR: construction message failed\n");
-		goto errout_before_tlsinit;
+	if (conn->tls && conn->tls_ctx == NULL) {
+		conn->tls_ctx = (struct http_client_tls_t *)malloc(sizeof(struct http_client_tls_t));
+		if (conn->tls_ctx == NULL) {
+			return WGET_ERR;
+		}
+
+		if (webclient_tls_init(conn->tls_ctx, &param->ssl_config)) {
+			ndbg("Fail to client tls init\n");
+			free(conn->tls_ctx);
+			conn->tls_ctx = NULL;
+			return WGET_ERR;
+		}
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+		mbedtls_ssl_conf_session_tickets(&conn->tls_ctx->tls_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+		conn->tls_session = false;
+		conn->root_ca = param->ssl_config.root_ca;
+		conn->dev_cert = param->ssl_config.dev_cert;
 	}
 
 retry:
-	if ((sockfd = wget_socket_connect(&ws)) < 0) {
+#endif
+	if ((conn->sockfd = wget_socket_connect(ws)) < 0) {
 		ndbg("ERROR: socket failed: %d\n", errno);
-		goto errout_before_tlsinit;
-	}
-
-	client_tls->client_fd = sockfd;
-	if (param->tls && (ret = wget_tls_handshake(client_tls, ws.hostname))) {
-		if (handshake_retry-- > 0) {
-			if (ret == MBEDTLS_ERR_NET_SEND_FAILED ||
-				ret == MBEDTLS_ERR_NET_RECV_FAILED ||
-				ret == MBEDTLS_ERR_SSL_CONN_EOF) {
-				ndbg("Handshake again.... \n");
-				mbedtls_net_free(&(client_tls->tls_client_fd));
-				mbedtls_ssl_free(&(client_tls->tls_ssl));
-				goto retry;
-			}
-		}
-		goto errout;
+		return WGET_ERR;
 	}
 
-	buf_len = 0;
-	while (sndlen > 0) {
-		if (param->tls) {
-			ret = mbedtls_ssl_write(&(client_tls->tls_ssl),
-									(const unsigned char *)param->buffer + buf_len,
-									sndlen);
-		} else {
-			ret = send(sockfd, param->buffer + buf_len, sndlen, 0);
-		}
-		if (ret < 1) {
-			ndbg("ERROR: send failed: %d\n", ret);
-			goto errout;
-		} else {
-			sndlen -= ret;
-			buf_len += ret;
-			ndbg("SEND SUCCESS: send %d bytes\n", ret);
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (conn->tls) {
+		conn->tls_ctx->client_fd = conn->sockfd;
+		ret = wget_tls_handshake(conn->tls_ctx, ws->hostname, conn->tls_session ? &conn->tls_ctx->tls_session : NULL);
+		if (ret) {
+			mbedtls_net_free(&conn->tls_ctx->tls_client_fd);
+			mbedtls_ssl_free(&conn->tls_ctx->tls_ssl);
+			if (handshake_retry-- > 0) {
+				if (ret == MBEDTLS_ERR_NET_SEND_FAILED ||
+					ret == MBEDTLS_ERR_NET_RECV_FAILED ||
+					ret == MBEDTLS_ERR_SSL_CONN_EOF) {
+					ndbg("Handshake again.... \n");
+					goto retry;
+				}
+			}
+			conn->tls_session = false;
+			return WGET_ERR;
 		}
+
+		/* Save the session to resume it on the next connection */
+
+		mbedtls_ssl_session_free(&conn->tls_ctx->tls_session);
+		mbedtls_ssl_session_init(&conn->tls_ctx->tls_session);
+		conn->tls_session = mbedtls_ssl_get_session(&conn->tls_ctx->tls_ssl, &conn->tls_ctx->tls_session) == 0;
 	}
+#endif
 
-	if (param->callback && param->response == NULL) {
-		param->response = &response;
-		if (http_client_response_init(param->response) < 0) {
-			ndbg("ERROR: response init failed: %d\n", ret);
-			param->response = NULL;
-			goto errout;
-		}
+	conn->connected = true;
+	return WGET_OK;
+}
+
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+/****************************************************************************
+ * Name: wget_pool_get, wget_pool_put
+ *
+ * Description:
+ *   Take the pool entry of the server of the request, or a free entry, or
+ *   the least recently used one; return it after the request, with its
+ *   connection still open if the server keeps it.  wget_pool_get()
+ *   returns NULL if all the entries are busy.
+ *
+ ****************************************************************************/
+
+static bool wget_pool_match(struct wget_conn_s *conn, struct wget_s *ws, struct http_client_request_t *param)
+{
+	if (conn->port != ws->port || conn->tls != param->tls || strcmp(conn->hostname, ws->hostname) != 0) {
+		return false;
+	}
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (conn->tls && (conn->root_ca != param->ssl_config.root_ca || conn->dev_cert != param->ssl_config.dev_cert)) {
+		return false;
 	}
+#endif
+	return true;
+}
 
-	buf_len = 0;
-	while (!read_finish) {
-		if (remain <= 0) {
-			ndbg("Error: Response Size is too large\n");
-			goto errout;
-		}
+static struct wget_conn_s *wget_pool_get(struct wget_s *ws, struct http_client_request_t *param)
+{
+	struct wget_conn_s *conn = NULL;
+	struct wget_conn_s *entry;
+	time_t now = time(NULL);
+	int i;
 
-		if (param->tls) {
-			len = mbedtls_ssl_read(&(client_tls->tls_ssl),
-								   (unsigned char *)param->response->message + buf_len,
-								   WEBCLIENT_CONF_MAX_MESSAGE_SIZE - buf_len);
-		} else {
-			len = recv(sockfd, param->response->message + buf_len,
-					   WEBCLIENT_CONF_MAX_MESSAGE_SIZE - buf_len, 0);
+	pthread_mutex_lock(&g_wget_pool_lock);
+
+	for (i = 0; i < CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE; i++) {
+		entry = &g_wget_pool[i];
+		if (!entry->busy && entry->hostname[0] != '\0' && wget_pool_match(entry, ws, param)) {
+			conn = entry;
+			break;
 		}
+	}
 
-		if (len < 0) {
-			ndbg("Error: Receive Fail\n");
-			goto errout;
-		} else if (len == 0) {
-			ndbg("Finish read\n");
-			goto errout;
+	if (conn == NULL) {
+		for (i = 0; i < CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE; i++) {
+			entry = &g_wget_pool[i];
+			if (entry->busy) {
+				continue;
+			}
+			if (entry->hostname[0] == '\0') {
+				conn = entry;
+				break;
+			}
+			if (conn == NULL || entry->lastused < conn->lastused) {
+				conn = entry;
+			}
 		}
 
-		buf_len += len;
-		remain -= len;
-		usleep(1);
-		read_finish = http_parse_message(param->response->message,
-						 len, NULL, param->response->url,
-						 &param->response->entity,
-						 &encoding, &state, &mlen,
-						 param->response->headers,
-						 NULL, param->response, NULL);
+		if (conn) {
+			wget_conn_release(conn);
+			conn->tls = param->tls;
+			conn->port = ws->port;
+			strncpy(conn->hostname, ws->hostname, CONFIG_WEBCLIENT_MAXHOSTNAME - 1);
+			conn->hostname[CONFIG_WEBCLIENT_MAXHOSTNAME - 1] = '\0';
+		}
 	}
 
-	param->response->method = param->method;
-	param->response->url = param->url;
-	if (param->response->entity) {
-		param->response->entity_len = strlen(param->response->entity);
+	if (conn) {
+		conn->busy = true;
 	}
 
-	if (param->callback) {
-		param->callback(param->response);
-		http_client_response_release(param->response);
-	}
-	if (param->tls) {
-		wget_tls_release(client_tls);
-		wget_tls_ssl_release(client_tls);
+	pthread_mutex_unlock(&g_wget_pool_lock);
+
+	/* The server has probably given up on a connection idle for so long */
+
+	if (conn && conn->connected && now - conn->lastused >= CONFIG_NETUTILS_WEBCLIENT_IDLE_TIMEOUT) {
+		wget_conn_close(conn);
 	}
-	free(client_tls);
-	if (!param->tls) {
-		close(sockfd);
+
+	return conn;
+}
+
+static void wget_pool_put(struct wget_conn_s *conn, bool keep)
+{
+	if (!keep) {
+		wget_conn_close(conn);
 	}
-	free(param->buffer);
-	param->async_flag = WGET_OK;
-	return (pthread_addr_t)WGET_OK;
 
-errout:
-	if (param->callback && param->response) {
-		http_client_response_release(param->response);
+	pthread_mutex_lock(&g_wget_pool_lock);
+	conn->lastused = time(NULL);
+	conn->busy = false;
+	pthread_mutex_unlock(&g_wget_pool_lock);
+}
+#endif
+
+/* Give back the connection of a request, pooled or not */
+
+static void wget_conn_done(struct wget_conn_s *conn, bool keep)
+{
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+	if (conn >= g_wget_pool && conn < &g_wget_pool[CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE]) {
+		wget_pool_put(conn, keep);
+		return;
 	}
-	if (param->tls) {
-		wget_tls_ssl_release(client_tls);
+#endif
+
+	wget_conn_release(conn);
+}
+
+/****************************************************************************
+ * Name: wget_parse_response
+ *
+ * Description:
+ *   Parse the next 'len' bytes of a response.  The status line, the
+ *   headers and the chunk sizes are read a line at a time in ws->line;
+ *   the entity, without its chunk framing, is passed to the entity
+ *   callback of the request as it arrives, or collected in the message
+ *   buffer of the response.
+ *
+ * Returned Value:
+ *   1 when the response is complete, 0 if more bytes are needed, a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+static int wget_entity(struct wget_s *ws, struct http_client_request_t *param, const char *data, int len)
+{
+	if (len == 0) {
+		return OK;
 	}
-errout_before_tlsinit:
-	if (param->tls) {
-		wget_tls_release(client_tls);
+
+	if (param->entity_callback) {
+		param->entity_callback(param->response, data, len);
+	} else {
+		if (ws->entity_len + len >= WEBCLIENT_CONF_MAX_MESSAGE_SIZE) {
+			ndbg("Error: Response Size is too large\n");
+			return -E2BIG;
+		}
+		memcpy(param->response->message + ws->entity_len, data, len);
 	}
-	if (client_tls) {
-		free(client_tls);
+	ws->entity_len += len;
+
+	return OK;
+}
+
+static int wget_parse_line(struct wget_s *ws, struct http_client_request_t *param)
+{
+	struct http_client_response_t *response = param->response;
+	char *value;
+
+	switch (ws->state) {
+	case WEBCLIENT_STATE_STATUSLINE:
+		if (strncmp(ws->line, g_http11, strlen(g_http11)) == 0) {
+			ws->keepalive = true;
+		} else if (strncmp(ws->line, g_http10, strlen(g_http10)) == 0) {
+			ws->keepalive = false;
+		} else {
+			ndbg("Error: Bad status line\n");
+			return -EPROTO;
+		}
+
+		response->status = atoi(ws->line + strlen(g_http11));
+		value = ws->line + strlen(g_http11);
+		while (*value == ISO_space) {
+			value++;
+		}
+		value = strchr(value, ISO_space);
+		strncpy(response->phrase, value ? value + 1 : "", WEBCLIENT_CONF_MAX_PHRASE_SIZE - 1);
+		response->phrase[WEBCLIENT_CONF_MAX_PHRASE_SIZE - 1] = '\0';
+
+		ws->chunked = false;
+		ws->remain = -1;
+		ws->state = WEBCLIENT_STATE_HEADERS;
+		return 0;
+
+	case WEBCLIENT_STATE_HEADERS:
+		if (ws->line[0] != '\0') {
+			value = strchr(ws->line, ':');
+			if (value == NULL) {
+				return 0;
+			}
+			*value++ = '\0';
+			while (*value == ISO_space) {
+				value++;
+			}
+
+			if (strcasecmp(ws->line, "Content-Length") == 0) {
+				ws->remain = atoi(value);
+			} else if (strcasecmp(ws->line, "Transfer-Encoding") == 0) {
+				ws->chunked = strncasecmp(value, "chunked", 7) == 0;
+			} else if (strcasecmp(ws->line, "Connection") == 0) {
+				if (strncasecmp(value, "close", 5) == 0) {
+					ws->keepalive = false;
+				} else if (strncasecmp(value, "keep-alive", 10) == 0) {
+					ws->keepalive = true;
+				}
+			}
+			http_keyvalue_list_add(response->headers, ws->line, value);
+			return 0;
+		}
+
+		/* End of the headers: skip interim responses, then find out how
+		 * the entity is delimited.
+		 */
+
+		if (response->status >= 100 && response->status < 200) {
+			ws->state = WEBCLIENT_STATE_STATUSLINE;
+			return 0;
+		}
+
+		ws->state = WEBCLIENT_STATE_DATA;
+		if (response->status == 204 || response->status == 304) {
+			return 1;
+		}
+		if (ws->chunked) {
+			ws->body = WGET_BODY_CHUNKED;
+			ws->chunkstate = WGET_CHUNK_SIZE;
+		} else if (ws->remain >= 0) {
+			ws->body = WGET_BODY_LENGTH;
+			if (ws->remain == 0) {
+				return 1;
+			}
+		} else {
+			ws->body = WGET_BODY_CLOSE;
+			ws->keepalive = false;
+		}
+		return 0;
+
+	default:
+		/* Framing of a chunked entity */
+
+		if (ws->chunkstate == WGET_CHUNK_SIZE) {
+			ws->remain = (int)strtol(ws->line, NULL, 16);
+			if (ws->remain < 0) {
+				return -EPROTO;
+			}
+			ws->chunkstate = ws->remain ? WGET_CHUNK_DATA : WGET_CHUNK_TRAILER;
+		} else if (ws->chunkstate == WGET_CHUNK_DATA_END) {
+			ws->chunkstate = WGET_CHUNK_SIZE;
+		} else if (ws->line[0] == '\0') {
+			return 1;
+		}
+		return 0;
 	}
-	if (!param->tls && sockfd > 0) {
-		close(sockfd);
+}
+
+static int wget_parse_response(struct wget_s *ws, struct http_client_request_t *param, const char *buf, int len)
+{
+	int ret;
+	int n;
+	char c;
+
+	while (len > 0) {
+		if (ws->state == WEBCLIENT_STATE_DATA && (ws->body != WGET_BODY_CHUNKED || ws->chunkstate == WGET_CHUNK_DATA)) {
+			n = len;
+			if (ws->body != WGET_BODY_CLOSE && n > ws->remain) {
+				n = ws->remain;
+			}
+			ret = wget_entity(ws, param, buf, n);
+			if (ret < 0) {
+				return ret;
+			}
+			buf += n;
+			len -= n;
+
+			if (ws->body != WGET_BODY_CLOSE) {
+				ws->remain -= n;
+				if (ws->remain == 0) {
+					if (ws->body == WGET_BODY_LENGTH) {
+						return 1;
+					}
+					ws->chunkstate = WGET_CHUNK_DATA_END;
+				}
+			}
+			continue;
+		}
+
+		c = *buf++;
+		len--;
+		if (c == ISO_cr) {
+			continue;
+		}
+		if (c != ISO_nl) {
+			if (ws->ndx < CONFIG_WEBCLIENT_MAXHTTPLINE - 1) {
+				ws->line[ws->ndx++] = c;
+			}
+			continue;
+		}
+
+		ws->line[ws->ndx] = '\0';
+		ws->ndx = 0;
+		ret = wget_parse_line(ws, param);
+		if (ret != 0) {
+			return ret;
+		}
 	}
-	free(param->buffer);
-	param->async_flag = WGET_ERR;
-	return (pthread_addr_t)WGET_ERR;
+
+	return 0;
 }
-#endif
 
-#ifndef CONFIG_NET_SECURITY_TLS
+/****************************************************************************
+ * Name: wget_base
+ *
+ * Description:
+ *   Send a request to an HTTP server and receive its response.
+ *
+ *   With CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE, the connection is taken from
+ *   a pool and left open after the response if the server allows it, so
+ *   that the next request to the same server saves the connection set-up
+ *   and the TLS handshake.  A request sent on a reused connection that
+ *   turns out to be closed by the server is sent again on a new one.
+ *
+ *   Note: If the function is passed a host name, it must already be in
+ *   the resolver cache in order for the function to connect to the web
+ *   server. It is therefore up to the calling module to implement the
+ *   resolver calls and the signal handler used for reporting a resolv
+ *   query answer.
+ *
+ * Input Parameters
+ *   arg      - The request.  The request is built in its buffer, which
+ *              then receives the response.  The entity of the response
+ *              is passed to its entity callback if there is one, or
+ *              returned in the message of the response.
+ *
+ * Returned Value:
+ *   0: if the request completed successfully;
+ *  -1: On a failure
+ *
+ ****************************************************************************/
+
 static pthread_addr_t wget_base(void *arg)
 {
-	int sockfd = -1;
 	int ret;
-	int buf_len, sndlen, len;
-	int remain = WEBCLIENT_CONF_MAX_MESSAGE_SIZE;
-	int encoding = CONTENT_LENGTH;
-	int state = HTTP_REQUEST_HEADER;
-	struct http_message_len_t mlen = {0,};
+	int sndlen, len;
+	bool reused;
+	bool retried = false;
 	struct wget_s ws;
+	struct wget_conn_s *conn;
+	struct wget_conn_s tmpconn;
 	struct http_client_request_t *param = (struct http_client_request_t *)arg;
-	struct http_client_response_t response;
-	bool read_finish = false;
+	struct http_client_response_t response = {0, };
 
 	/* Initialize the state structure */
 	memset(&ws, 0, sizeof(struct wget_s));
@@ -1129,111 +1480,116 @@ static pthread_addr_t wget_base(void *arg)
 	ret = netlib_parsehttpurl(param->url, &ws.port, ws.hostname, CONFIG_WEBCLIENT_MAXHOSTNAME, ws.filename, CONFIG_WEBCLIENT_MAXFILENAME);
 	if (ret != 0) {
 		ndbg("ERROR: Malformed HTTP URL: %s\n", param->url);
-		free(param->buffer);
-		return (pthread_addr_t)WGET_ERR;
+		goto errout_before_conn;
 	}
 
 	nvdbg("hostname='%s' filename='%s'\n", ws.hostname, ws.filename);
 
-	/* Re-initialize portions of the state structure that could have
-	 * been left from the previous time through the loop and should not
-	 * persist with the new connection.
-	 */
-	ws.httpstatus = HTTPSTATUS_NONE;
-	ws.offset = 0;
-	ws.datend = 0;
-	ws.ndx = 0;
-
 	if ((sndlen = wget_msg_construct(ws.buffer, param, &ws)) <= 0) {
 		ndbg("ERROR: construction message failed\n");
-		goto errout_before_init;
-	}
-
-	if ((sockfd = wget_socket_connect(&ws)) < 0) {
-		ndbg("ERROR: socket failed: %d\n", errno);
-		goto errout_before_init;
-	}
-
-	buf_len = 0;
-	while (sndlen > 0) {
-		ret = send(sockfd, param->buffer + buf_len, sndlen, 0);
-		if (ret < 1) {
-			ndbg("ERROR: send failed: %d\n", ret);
-			goto errout;
-		} else {
-			sndlen -= ret;
-			buf_len += ret;
-			ndbg("SEND SUCCESS: send %d bytes\n", ret);
-		}
+		goto errout_before_conn;
 	}
 
 	if (param->callback && param->response == NULL) {
 		param->response = &response;
 		if (http_client_response_init(param->response) < 0) {
-			ndbg("ERROR: response init failed: %d\n", ret);
+			ndbg("ERROR: response init failed\n");
 			param->response = NULL;
-			goto errout;
+			goto errout_before_conn;
 		}
 	}
 
-	buf_len = 0;
-	while (!read_finish) {
-		if (remain <= 0) {
-			ndbg("Error: Response Size is too large\n");
-			goto errout;
+	/* Use a connection of the pool, or one for this request only */
+
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+	conn = wget_pool_get(&ws, param);
+	if (conn == NULL)
+#endif
+	{
+		memset(&tmpconn, 0, sizeof(struct wget_conn_s));
+		tmpconn.tls = param->tls;
+		conn = &tmpconn;
+	}
+
+resend:
+	reused = conn->connected;
+	if (!reused && wget_conn_open(conn, &ws, param) != WGET_OK) {
+		goto errout;
+	}
+
+	if (wget_conn_send(conn, param->buffer, sndlen) != WGET_OK) {
+		if (reused && !retried) {
+			wget_conn_close(conn);
+			retried = true;
+			goto resend;
 		}
-		len = recv(sockfd, param->response->message + buf_len,
-				   WEBCLIENT_CONF_MAX_MESSAGE_SIZE - buf_len, 0);
+		goto errout;
+	}
 
-		if (len < 0) {
-			ndbg("Error: Receive Fail\n");
-			goto errout;
-		} else if (len == 0) {
-			ndbg("Finish read\n");
+	/* The request is sent: its buffer now receives the response */
+
+	ws.state = WEBCLIENT_STATE_STATUSLINE;
+	ws.ndx = 0;
+	ws.entity_len = 0;
+
+	ret = 0;
+	while (ret == 0) {
+		len = wget_conn_recv(conn, param->buffer, param->buflen);
+		if (len <= 0) {
+			if (len == 0 && ws.state == WEBCLIENT_STATE_DATA && ws.body == WGET_BODY_CLOSE) {
+				break;
+			}
+
+			/* The server had closed the reused connection */
+
+			if (reused && !retried && ws.state == WEBCLIENT_STATE_STATUSLINE && ws.ndx == 0) {
+				wget_conn_close(conn);
+				retried = true;
+				goto resend;
+			}
+
+			ndbg("Error: Receive Fail: %d\n", len);
 			goto errout;
 		}
 
-		buf_len += len;
-		remain -= len;
-		usleep(1);
-		read_finish = http_parse_message(param->response->message,
-						 len, NULL, param->response->url,
-						 &param->response->entity,
-						 &encoding, &state, &mlen,
-						 param->response->headers,
-						 NULL, param->response, NULL);
+		ret = wget_parse_response(&ws, param, param->buffer, len);
+	}
+
+	if (ret < 0) {
+		goto errout;
 	}
 
 	param->response->method = param->method;
 	param->response->url = param->url;
-	if (param->response->entity) {
-		param->response->entity_len = strlen(param->response->entity);
+	param->response->entity_len = ws.entity_len;
+	if (param->entity_callback) {
+		param->response->entity = NULL;
+	} else {
+		param->response->message[ws.entity_len] = '\0';
+		param->response->entity = param->response->message;
 	}
 
+	wget_conn_done(conn, ws.keepalive && ws.body != WGET_BODY_CLOSE);
+
 	if (param->callback) {
 		param->callback(param->response);
 		http_client_response_release(param->response);
 	}
 
-	close(sockfd);
-
 	free(param->buffer);
 	param->async_flag = WGET_OK;
 	return (pthread_addr_t)WGET_OK;
 
 errout:
+	wget_conn_done(conn, false);
 	if (param->callback && param->response) {
 		http_client_response_release(param->response);
 	}
-errout_before_init:
-	if (sockfd > 0) {
-		close(sockfd);
-	}
+errout_before_conn:
 	free(param->buffer);
 	param->async_flag = WGET_ERR;
 	return (pthread_addr_t)WGET_ERR;
 }
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -1365,6 +1721,22 @@ int http_client_send_request_async(struct http_client_request_t *request,
 	return http_client_send_requests(request, ssl_config, NULL, cb);
 }
 
+#ifdef CONFIG_NETUTILS_WEBCLIENT_KEEPALIVE
+void http_client_close_connections(void)
+{
+	int i;
+
+	pthread_mutex_lock(&g_wget_pool_lock);
+	for (i = 0; i < CONFIG_NETUTILS_WEBCLIENT_POOL_SIZE; i++) {
+		if (!g_wget_pool[i].busy) {
+			wget_conn_release(&g_wget_pool[i]);
+			g_wget_pool[i].hostname[0] = '\0';
+		}
+	}
+	pthread_mutex_unlock(&g_wget_pool_lock);
+}
+#endif
+
 int http_client_response_init(struct http_client_response_t *response)
 {
 	response->phrase = malloc(WEBCLIENT_CONF_MAX_PHRASE_SIZE);
@@ -233,45 +233,157 @@ stop:
 	return NULL;
 }
 
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+/* Client handler that accepts its clients on its own listening socket */
+
+pthread_addr_t http_accept_handler(pthread_addr_t arg)
+{
+	struct http_server_t *server = (struct http_server_t *)arg;
+	struct sockaddr_in client_addr;
+	struct timeval tv;
+	socklen_t addrlen;
+	int listen_fd;
+	int sock_fd;
+
+	while (sem_wait(&server->sem_thread_sync) != OK) ;
+	listen_fd = server->c_listen_fd[server->c_next++];
+	sem_post(&server->sem_thread_sync);
+
+	HTTP_LOGD("Accepting connections on port %d, socket %d began.\n", server->port, listen_fd);
+
+	while (server->state == HTTP_SERVER_RUN) {
+		addrlen = sizeof(struct sockaddr_in);
+		sock_fd = accept(listen_fd, (struct sockaddr *)&client_addr, &addrlen);
+		if (sock_fd < 0) {
+			if (errno != EWOULDBLOCK) {
+				HTTP_LOGE("Error: Accept client error!!\n");
+			}
+			continue;
+		}
+
+		tv.tv_sec = HTTP_CONF_SOCKET_TIMEOUT_MSEC / 1000;
+		tv.tv_usec = (HTTP_CONF_SOCKET_TIMEOUT_MSEC % 1000) * 1000;
+		if (setsockopt(sock_fd, SOL_SOCKET, SO_RCVTIMEO,
+					   (struct timeval *)&tv, sizeof(struct timeval)) < 0) {
+			HTTP_LOGE("Error: Fail to setsockopt\n");
+		}
+
+		HTTP_LOGD("Client %d is accepted on socket %d\n", sock_fd, listen_fd);
+		http_serve_client(server, sock_fd);
+	}
+
+	/* The last handler to leave reports that the server stopped */
+
+	while (sem_wait(&server->sem_thread_sync) != OK) ;
+	if (--server->c_running == 0) {
+		server->state = HTTP_SERVER_STOP;
+	}
+	sem_post(&server->sem_thread_sync);
+
+	HTTP_LOGD("Closed client handle %d\n", getpid());
+	return NULL;
+}
+#endif
+
+/* Create a socket listening on the server port */
+
+static int http_server_listen(struct http_server_t *server)
+{
+	int reuse = 1;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		HTTP_LOGE("Error: Cannot create socket!!\n");
+		return -1;
+	}
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
+		HTTP_LOGE("Error: Cannot set socket option!!\n");
+	}
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	/* Every client handler listens on the same port */
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+		HTTP_LOGE("Error: Cannot set socket option!!\n");
+		close(fd);
+		return -1;
+	}
+#endif
+
+	if (bind(fd, (struct sockaddr *)&(server->servaddr), sizeof(struct sockaddr_in)) < 0) {
+		HTTP_LOGE("Error: Cannot socket bind!!\n");
+		close(fd);
+		return -1;
+	}
+
+	if (listen(fd, HTTP_CONF_MAX_CLIENT) < 0) {
+		HTTP_LOGE("Error: Cannot listen!!\n");
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
 
 int http_server_start(struct http_server_t *server)
 {
 	pthread_attr_t attr;
 	unsigned int cli_handle_stack = HTTP_CLIENT_HANDLER_STACKSIZE;
-	int reuse = 1;
+	pthread_startroutine_t cli_handler = http_handle_client;
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	struct timeval accept_to;
+#endif
 	int i;
 
 	if (server == NULL) {
 		HTTP_LOGE("Error: Server must be initialized before start");
 		return HTTP_ERROR;
 	}
-	/*
-	 * Initialize socket and bind, start listening
-	 */
-
-	server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-	if (server->listen_fd < 0) {
-		HTTP_LOGE("Error: Cannot create socket!!\n");
-		return HTTP_ERROR;
-	}
-
-	if (setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
-		HTTP_LOGE("Error: Cannot set socket option!!\n");
-	}
 
 	server->servaddr.sin_family = AF_INET;
 	server->servaddr.sin_port = HTTP_HTONS(server->port);
 	server->servaddr.sin_addr.s_addr = INADDR_ANY;
 
-	if (bind(server->listen_fd, (struct sockaddr *)&(server->servaddr), sizeof(struct sockaddr_in)) < 0) {
-		HTTP_LOGE("Error: Cannot socket bind!!\n");
-		close(server->listen_fd);
-		return HTTP_ERROR;
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	/*
+	 * Initialize a listening socket per client handler; the handlers
+	 * accept their clients themselves.
+	 */
+
+	for (i = 0; i < HTTP_CONF_MAX_CLIENT_HANDLE; i++) {
+		server->c_listen_fd[i] = http_server_listen(server);
+		if (server->c_listen_fd[i] < 0) {
+			while (--i >= 0) {
+				close(server->c_listen_fd[i]);
+			}
+			return HTTP_ERROR;
+		}
+
+		/* Wake up the handler periodically to check the server state */
+
+		accept_to.tv_sec = ACCEPT_TIMEOUT_MS / 1000;
+		accept_to.tv_usec = (ACCEPT_TIMEOUT_MS % 1000) * 1000;
+		if (setsockopt(server->c_listen_fd[i], SOL_SOCKET, SO_RCVTIMEO,
+					   (struct timeval *)&accept_to, sizeof(struct timeval)) < 0) {
+			HTTP_LOGE("Error: Fail to setsockopt\n");
+		}
 	}
 
-	if (listen(server->listen_fd, HTTP_CONF_MAX_CLIENT) < 0) {
-		HTTP_LOGE("Error: Cannot listen!!\n");
-		close(server->listen_fd);
+	server->listen_fd = -1;
+	server->c_next = 0;
+	server->c_running = HTTP_CONF_MAX_CLIENT_HANDLE;
+	sem_init(&server->sem_thread_sync, 0, 1);
+	server->state = HTTP_SERVER_RUN;
+	cli_handler = http_accept_handler;
+#else
+	/*
+	 * Initialize socket and bind, start listening
+	 */
+
+	server->listen_fd = http_server_listen(server);
+	if (server->listen_fd < 0) {
 		return HTTP_ERROR;
 	}
 
@@ -285,6 +397,7 @@ int http_server_start(struct http_server_t *server)
 	}
 	pthread_setname_np(server->tid, "listening webserver");
 	pthread_detach(server->tid);
+#endif
 
 #ifdef CONFIG_NET_SECURITY_TLS
 	if (server->tls_init) {
@@ -296,8 +409,18 @@ int http_server_start(struct http_server_t *server)
 		pthread_attr_init(&attr);
 		pthread_attr_setschedpolicy(&attr, SCHED_RR);
 		pthread_attr_setstacksize(&attr, cli_handle_stack);
-		if (pthread_create(&server->c_tid[i], &attr, http_handle_client, (void *)server) != 0) {
+		if (pthread_create(&server->c_tid[i], &attr, cli_handler, (void *)server) != 0) {
 			HTTP_LOGE("Error: Cannot create server thread!!\n");
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+			/* The handlers that were not created do not take part in the stop */
+
+			while (sem_wait(&server->sem_thread_sync) != OK) ;
+			server->c_running -= HTTP_CONF_MAX_CLIENT_HANDLE - i;
+			if (server->c_running == 0) {
+				server->state = HTTP_SERVER_STOP;
+			}
+			sem_post(&server->sem_thread_sync);
+#endif
 			return HTTP_ERROR;
 		}
 		pthread_setname_np(server->c_tid[i], "client handler");
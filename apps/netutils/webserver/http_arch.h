@@ -28,6 +28,7 @@
 #define HTTP_MALLOC malloc
 #define HTTP_MEMSET memset
 #define HTTP_MEMCPY memcpy
+#define HTTP_MEMMOVE memmove
 #define HTTP_FREE   free
 #define HTTP_ATOI   atoi
 
@@ -17,31 +17,106 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <crc32.h>
 #include <apps/netutils/webserver/http_err.h>
 #include <apps/netutils/webserver/http_keyvalue_list.h>
 #include <apps/netutils/webclient.h>
 #include <apps/netutils/websocket.h>
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/dirent.h>
 
 #include "http.h"
 #include "http_client.h"
 #include "http_string_util.h"
 #include "http_query.h"
+#include "http_parser.h"
 #include "http_arch.h"
 #include "http_log.h"
 
 #define MIN_WS_HEADER_FIELD 2
 
-pthread_addr_t http_handle_client(pthread_addr_t arg)
+/* Content types of static files, by extension */
+
+struct http_mime_t {
+	const char *ext;
+	const char *type;
+};
+
+static const struct http_mime_t g_http_mime[] = {
+	{".html", "text/html"},
+	{".htm", "text/html"},
+	{".shtml", "text/html"},
+	{".css", "text/css"},
+	{".js", "application/javascript"},
+	{".json", "application/json"},
+	{".txt", "text/plain"},
+	{".png", "image/png"},
+	{".jpg", "image/jpeg"},
+	{".gif", "image/gif"},
+	{".svg", "image/svg+xml"},
+	{".ico", "image/x-icon"},
+};
+
+/* Serve the requests of one accepted client, then close it */
+
+void http_serve_client(struct http_server_t *server, int sock_fd)
 {
-	struct http_server_t *server = (struct http_server_t *)arg;
-	struct http_msg_t msg;
 	int result;
 	struct http_keyvalue_list_t request_params;
-	int sock_fd;
 	struct mallinfo data;
 	struct http_client_t *p;
+
+	data = mallinfo();
+
+	if (data.fordblks < HTTP_CONF_MIN_TLS_MEMORY * HTTP_CONF_MAX_CLIENT_HANDLE) {
+		HTTP_LOGE("Error: Not enough memory :: %d\n", data.fordblks);
+		close(sock_fd);
+		return;
+	}
+
+	HTTP_LOGD("Free Mem %d\n", data.fordblks);
+
+	p = http_client_init(server, sock_fd);
+
+	if (p == NULL) {
+		HTTP_LOGE("Error: Cannot init client!!\n");
+		close(sock_fd);
+		return;
+	}
+
+	HTTP_LOGD("Client %d.\n", p->client_fd);
+
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (server->tls_init) {
+		if (http_client_tls_init(p) != HTTP_OK) {
+			HTTP_LOGE("Error: Cannot initialize TLS!! Close client.. %d\n", sock_fd);
+			http_client_release(p);
+			return;
+		}
+	}
+#endif
+	http_keyvalue_list_init(&request_params);
+	result = http_recv_and_handle_request(p, &request_params);
+	http_keyvalue_list_release(&request_params);
+
+	if (result != HTTP_OK) {
+		HTTP_LOGD("Client %d  in error case.\n", sock_fd);
+	} else {
+		HTTP_LOGD("Client %d  in normal case.\n", sock_fd);
+	}
+	http_client_release(p);
+	HTTP_LOGD("Release client....\n");
+}
+
+pthread_addr_t http_handle_client(pthread_addr_t arg)
+{
+	struct http_server_t *server = (struct http_server_t *)arg;
+	struct http_msg_t msg;
+	int sock_fd;
 	mqd_t msg_q;
 	struct mq_attr mqattr;
 
@@ -64,47 +139,7 @@ pthread_addr_t http_handle_client(pthread_addr_t arg)
 			break;
 		}
 
-		data = mallinfo();
-
-		if (data.fordblks < HTTP_CONF_MIN_TLS_MEMORY * HTTP_CONF_MAX_CLIENT_HANDLE) {
-			HTTP_LOGE("Error: Not enough memory :: %d\n", data.fordblks);
-			close(sock_fd);
-			continue;
-
-		}
-
-		HTTP_LOGD("Free Mem %d\n", data.fordblks);
-
-		p = http_client_init(server, sock_fd);
-
-		if (p == NULL) {
-			HTTP_LOGE("Error: Cannot init client!!\n");
-			close(sock_fd);
-			continue;
-		}
-
-		HTTP_LOGD("Client %d.\n", p->client_fd);
-
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (server->tls_init) {
-			if (http_client_tls_init(p) != HTTP_OK) {
-				HTTP_LOGE("Error: Cannot initialize TLS!! Close client.. %d\n", sock_fd);
-				http_client_release(p);
-				continue;
-			}
-		}
-#endif
-		http_keyvalue_list_init(&request_params);
-		result = http_recv_and_handle_request(p, &request_params);
-		http_keyvalue_list_release(&request_params);
-
-		if (result != HTTP_OK) {
-			HTTP_LOGD("Client %d  in error case.\n", sock_fd);
-		} else {
-			HTTP_LOGD("Client %d  in normal case.\n", sock_fd);
-		}
-		http_client_release(p);
-		HTTP_LOGD("Release client....\n");
+		http_serve_client(server, sock_fd);
 	}
 
 	mq_close(msg_q);
@@ -141,248 +176,60 @@ int http_client_release(struct http_client_t *client)
 	return HTTP_OK;
 }
 
-int http_parse_message(char *buf, int buf_len, int *method, char *url,
-					   char **body, int *enc, int *state,
-					   struct http_message_len_t *len,
-					   struct http_keyvalue_list_t *params,
-					   struct http_client_t *client,
-					   struct http_client_response_t *response,
-					   struct http_req_message *req)
+/* Fill the request message from the state of the parser */
+static void http_request_ready(struct http_client_t *client, struct http_req_parser_t *parser,
+							   struct http_req_message *req)
 {
-	int protocol = 0;
-	int sentence_end = 0;
-	char key[HTTP_CONF_MAX_KEY_LENGTH] = { 0, };
-	char value[HTTP_CONF_MAX_VALUE_LENGTH] = { 0, };
-	int process_finish = false;
-	int read_finish = false;
-	char *entity = *body;
-
-	while (!process_finish) {
-		/* At this point, we read a line of http request */
-		switch (*state) {
-		case HTTP_REQUEST_HEADER:
-			len->sentence_start = 0;
-			len->message_len = 0;
-			/* Search CR and LF */
-			sentence_end = http_find_first_crlf(buf, buf_len, len->sentence_start);
-			if (sentence_end != -1) {
-				buf[sentence_end] = '\0';
-
-				/* If this is called by webserver */
-				if (client) {
-					/* Header Examples
-					 * ---------------
-					 * 1. GET / HTTP/1.1
-					 * 2. GET /cgi-bin/http_trace.pl HTTP/1.1\r\n
-					 */
-					http_separate_header(buf + len->sentence_start, method, url, &protocol);
-
-					HTTP_LOGD(
-						"Request Method : %s\n",
-						(*method == HTTP_METHOD_GET) ? "GET" :
-						(*method == HTTP_METHOD_PUT) ? "PUT" :
-						(*method == HTTP_METHOD_POST) ? "POST" :
-						(*method == HTTP_METHOD_DELETE) ?
-						"DELETE" : "UNKNOWN");
-					req->method = *method;
-					HTTP_LOGD("Request URI : %s\n", url);
-					HTTP_LOGD("Request Protocol : ");
-					if (protocol == HTTP_HTTP_VERSION_09) {
-						HTTP_LOGD("HTTP/0.9\n");
-					} else if (protocol == HTTP_HTTP_VERSION_10) {
-						HTTP_LOGD("HTTP/1.0\n");
-					} else if (protocol == HTTP_HTTP_VERSION_11) {
-						HTTP_LOGD("HTTP/1.1\n");
-					} else {
-						HTTP_LOGD("unknown version\n");
-					}
-				} else { /* If this is called by webclient */
-					http_separate_status_line(buf + len->sentence_start, &protocol, &response->status, response->phrase);
-					HTTP_LOGD("Response Status : %d\n", response->status);
-					HTTP_LOGD("Response Phrase : %s\n", response->phrase);
-				}
-				len->sentence_start = sentence_end + 2;
-				*state = HTTP_REQUEST_PARAMETERS;
-			} else {
-				read_finish = true;
-				process_finish = true;
-			}
-			break;
-		case HTTP_REQUEST_PARAMETERS:
-			/* Search CR and LF */
-			sentence_end = http_find_first_crlf(buf, buf_len, len->sentence_start);
-			if (sentence_end >= 0) {
-				buf[sentence_end] = '\0';
-				if (strlen(buf + len->sentence_start) > 0) {
-					/* Read parameters */
-					http_separate_keyvalue(buf + len->sentence_start, key, value);
-					HTTP_LOGD("[HTTP Parameter] Key: %s / Value: %s\n", key, value);
-
-					http_keyvalue_list_add(params, key, value);
-					if (client) {
-						if (strcmp(key, "Connection") == 0 && strcmp(value, "Upgrade") == 0) {
-							++client->ws_state;
-						}
-						if (strcmp(key, "Upgrade") == 0 && strcmp(value, "websocket") == 0) {
-							++client->ws_state;
-						}
-						if (strcmp(key, "Sec-WebSocket-Key") == 0) {
-							strncpy((char *)client->ws_key, value, WEBSOCKET_CLIENT_KEY_LEN);
-						}
-					}
-					if (strcmp(key, "Content-Length") == 0) {
-						len->content_len = HTTP_ATOI(value);
-
-						HTTP_LOGD("This request contains contents, length : %d\n", len->content_len);
-					}
-					if (strcmp(key, "Transfer-Encoding") == 0 && strcmp(value, "chunked") == 0) {
-						if (client) {
-							len->chunked_remain = 0;
-							len->entity_len = 0;
-							entity = HTTP_MALLOC(HTTP_CONF_MAX_ENTITY_LENGTH);
-							if (entity == NULL) {
-								HTTP_LOGE("Error: Fail to alloc memory\n");
-								return HTTP_ERROR;
-							}
-							*enc = HTTP_CHUNKED_ENCODING;
-							req->encoding = *enc;
-							*body = entity;
-							HTTP_LOGD("This request contains chunked encoding contents\n");
-						} else {
-							HTTP_LOGD("Weblient cannot support chunked encoding.\n");
-						}
-					}
-				} else {
-					*state = HTTP_REQUEST_BODY;
-				}
-				len->sentence_start = sentence_end + 2;
-			} else {
-				process_finish = true;
-			}
-			break;
-
-		case HTTP_REQUEST_BODY:
-			if (client && *method != HTTP_METHOD_POST && *method != HTTP_METHOD_PUT) {
-				read_finish = true;
-				return read_finish;
-			}
-			/* Content length */
-			if (len->sentence_start < 0 || sentence_end < 0) {
-				HTTP_LOGE("Error: Wrong sentence arrange\n");
-				break;
-			}
-			if (*enc == HTTP_CONTENT_LENGTH) {
-				if (!len->message_len) {
-					*body = buf + len->sentence_start;
-				}
-				if (buf_len - len->sentence_start + len->message_len == len->content_len) {
-					buf[buf_len + len->message_len] = '\0';
+	const char *value;
+#ifdef CONFIG_NETUTILS_WEBSERVER_HEADER_LIST
+	int i;
+#endif
 
-					HTTP_LOGD("All body readed : \n%s\n", *body);
-					read_finish = true;
-				} else {
-					len->message_len += buf_len;
+	req->req_msg = parser->buf;
+	req->method = parser->method;
+	req->url = parser->buf + parser->url;
+	req->encoding = parser->encoding;
 
-					HTTP_LOGD("Not all body readed\n");
-				}
-				process_finish = true;
-			}
-			/* Chunked encoding */
-			else {
-				int i, j, cha;
-				if (!len->chunked_remain) {
-					len->content_len = 0;
-					sentence_end = http_find_first_crlf(buf, buf_len, len->sentence_start);
-
-					if (sentence_end < 0) {
-						HTTP_LOGE("Error: Cannot find body\n");
-						process_finish = true;
-						read_finish = true;
-						break;
-					}
-
-					/* calculate chunked size */
-					for (i = 1; sentence_end - i >= len->sentence_start; ++i) {
-						cha = (int)*(buf + sentence_end - i);
-						if (cha > '9') {
-							cha = cha - 'a' + 10;
-						} else {
-							cha = cha - '0';
-						}
-						for (j = 1; j < i; ++j) {
-							cha *= 16;
-						}
-						len->content_len += cha;
-					}
-					len->chunked_remain = len->content_len;
-					if (!len->chunked_remain) {
-						HTTP_LOGD("Chunked size is zero\n");
-						entity[len->entity_len] = '\0';
-						req->entity = entity + len->entity_len;
-						http_dispatch_url(client, req);
-						read_finish = true;
-						return read_finish;
-					}
-					len->sentence_start = sentence_end + 2;
-				}
-				i = 0;
-				if (len->chunked_remain > 0) {
-					for (i = 0; len->chunked_remain > 0; ++i) {
-						if (len->sentence_start >= buf_len + len->message_len) {
-							len->message_len = len->sentence_start;
-							len->entity_len += i;
-							read_finish = false;
-							return read_finish;
-						}
-						entity[i + len->entity_len] = *(buf + len->sentence_start++);
-						--len->chunked_remain;
-					}
-					len->entity_len += i;
-				}
+	value = http_parser_header(parser, "Connection");
+	if (value && strcmp(value, "Upgrade") == 0) {
+		++client->ws_state;
+	}
+	value = http_parser_header(parser, "Upgrade");
+	if (value && strcmp(value, "websocket") == 0) {
+		++client->ws_state;
+	}
+	value = http_parser_header(parser, "Sec-WebSocket-Key");
+	if (value) {
+		strncpy((char *)client->ws_key, value, WEBSOCKET_CLIENT_KEY_LEN);
+	}
 
-				if (!len->chunked_remain) {
-					entity[len->entity_len] = '\0';
-					req->entity = entity + len->entity_len - len->content_len;
-					http_dispatch_url(client, req);
-					len->sentence_start += 2;
-					sentence_end = http_find_first_crlf(buf, buf_len + len->message_len, len->sentence_start);
-					if (sentence_end < 0) {
-						HTTP_LOGE("Error: Not accord with chunked encoding\n");
-						read_finish = true;
-						return read_finish;
-					}
-					len->sentence_start = sentence_end + 2;
-					if (*(buf + sentence_end - 1) == '0') {
-						req->entity = entity + len->entity_len;
-						http_dispatch_url(client, req);
-						process_finish = true;
-						read_finish = true;
-					}
-				}
-			}
-			break;
-		}
+#ifdef CONFIG_NETUTILS_WEBSERVER_KEEPALIVE
+	client->keepalive = parser->keepalive;
+#endif
+#ifdef CONFIG_NETUTILS_WEBSERVER_HEADER_LIST
+	for (i = 0; i < parser->header_count; i++) {
+		http_keyvalue_list_add(req->headers, parser->buf + parser->headers[i].key,
+							   parser->buf + parser->headers[i].value);
 	}
-	return read_finish;
+#endif
 }
 
 int http_recv_and_handle_request(struct http_client_t *client, struct http_keyvalue_list_t *request_params)
 {
 	char *buf;
+	char *space;
 	int len = 0;
-	char *body = NULL;
-	int read_finish = false;
-
-	int method = HTTP_METHOD_UNKNOWN;
-	char url[HTTP_CONF_MAX_REQUEST_HEADER_URL_LENGTH] = { 0, };
-	int buf_len = 0;
-	int remain = HTTP_CONF_MAX_REQUEST_LENGTH;
-	int enc = HTTP_CONTENT_LENGTH;
+	int avail;
+	int ret;
+	int ready = 0;
+	int served = 0;
 	struct http_req_message req;
-	int state = HTTP_REQUEST_HEADER;
-	struct http_message_len_t mlen = {0,};
+	struct http_req_parser_t parser;
 	struct sockaddr_in addr;
-	socklen_t addr_len;
+	socklen_t addr_len = sizeof(addr);
+#ifdef CONFIG_NETUTILS_WEBSERVER_KEEPALIVE
+	struct timeval tv;
+#endif
 
 	client->ws_state = 0;
 
@@ -397,46 +244,82 @@ int http_recv_and_handle_request(struct http_client_t *client, struct http_keyva
 		HTTP_LOGE("Error: Fail to getpeername\n");
 		goto errout;
 	}
-	req.req_msg = buf;
-	req.url = url;
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_KEEPALIVE
+	/* An idle connection is closed after the timeout */
+	tv.tv_sec = CONFIG_NETUTILS_WEBSERVER_KEEPALIVE_TIMEOUT;
+	tv.tv_usec = 0;
+	setsockopt(client->client_fd, SOL_SOCKET, SO_RCVTIMEO, (struct timeval *)&tv, sizeof(struct timeval));
+#endif
+
+	http_parser_init(&parser, buf);
+	HTTP_MEMSET(&req, 0, sizeof(req));
 	req.headers = request_params;
 	req.client_ip = addr.sin_addr.s_addr;
+	req.parser = &parser;
 
-	while (!read_finish) {
-		if (remain <= 0) {
-			HTTP_LOGE("Error: Request size is too large!!\n");
+	while (1) {
+		ret = http_parser_feed(&parser, len);
+		len = 0;
+		if (ret == HTTP_ERROR) {
 			goto errout;
 		}
+
+		if (ret == HTTP_PARSE_MORE) {
+			space = http_parser_space(&parser, &avail);
+			if (avail <= 0) {
+				HTTP_LOGE("Error: Request size is too large!!\n");
+				goto errout;
+			}
 #ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			len = mbedtls_ssl_read(&(client->tls_ssl), (unsigned char *)buf + buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - buf_len);
-		} else
+			if (client->server->tls_init) {
+				len = mbedtls_ssl_read(&(client->tls_ssl), (unsigned char *)space, avail);
+			} else
 #endif
-		{
-			len = recv(client->client_fd, buf + buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - buf_len, 0);
-		}
-		if (len < 0) {
-			HTTP_LOGE("Error: Receive Fail %d\n", len);
-			goto errout;
-		} else if (len == 0) {
-			HTTP_LOGD("Finish read\n");
-			goto errout;
+			{
+				len = recv(client->client_fd, space, avail, 0);
+			}
+			if (len < 0) {
+				if (served && parser.len == 0) {
+					HTTP_LOGD("Keep-alive timeout\n");
+					break;
+				}
+				HTTP_LOGE("Error: Receive Fail %d\n", len);
+				goto errout;
+			} else if (len == 0) {
+				HTTP_LOGD("Finish read\n");
+				if (served && parser.len == 0) {
+					break;
+				}
+				goto errout;
+			}
+			continue;
 		}
-		buf_len += len;
-		remain -= len;
 
-		read_finish = http_parse_message(buf, len, &method, url, &body, &enc, &state, &mlen, request_params, client, NULL, &req);
-		if (read_finish == HTTP_ERROR) {
-			goto errout;
+		/* A request, or a chunk of its body, is complete */
+		if (!ready) {
+			http_request_ready(client, &parser, &req);
+			ready = 1;
 		}
-	}
-	if (method == HTTP_METHOD_UNKNOWN) {
-		goto errout;
-	}
-
-	if (enc == HTTP_CONTENT_LENGTH) {
-		req.entity = body;
+		req.entity = parser.buf + parser.entity;
 		http_dispatch_url(client, &req);
+		if (ret == HTTP_PARSE_CHUNK) {
+			continue;
+		}
+
+		served++;
+#ifdef CONFIG_NETUTILS_WEBSERVER_KEEPALIVE
+		if (client->keepalive && client->ws_state < MIN_WS_HEADER_FIELD) {
+			http_parser_next(&parser);
+#ifdef CONFIG_NETUTILS_WEBSERVER_HEADER_LIST
+			while (http_keyvalue_list_delete_tail(request_params) == HTTP_OK);
+#endif
+			client->ws_state = 0;
+			ready = 0;
+			continue;
+		}
+#endif
+		break;
 	}
 
 #ifdef CONFIG_NETUTILS_WEBSOCKET
@@ -478,16 +361,10 @@ int http_recv_and_handle_request(struct http_client_t *client, struct http_keyva
 	}
 
 	HTTP_FREE(buf);
-	if (enc == HTTP_CHUNKED_ENCODING) {
-		HTTP_FREE(body);
-	}
 	return HTTP_OK;
 errout:
 	close(client->client_fd);
 	HTTP_FREE(buf);
-	if (enc == HTTP_CHUNKED_ENCODING) {
-		HTTP_FREE(body);
-	}
 	return HTTP_ERROR;
 }
 
@@ -500,16 +377,8 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 
 	switch (method) {
 	case HTTP_METHOD_GET:
-		if ((f = fopen(url, "r")) != NULL) {
-			fgets(entity, HTTP_CONF_MAX_ENTITY_LENGTH, f);
-			if (http_send_response(client, 200, entity, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
-			fclose(f);
-		} else {
-			if (http_send_response(client, 404, HTTP_ERROR_404, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
+		if (http_send_file(client, NULL, url) == HTTP_ERROR) {
+			HTTP_LOGE("Error: Fail to send response\n");
 		}
 		break;
 	case HTTP_METHOD_POST:
@@ -585,10 +454,155 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 	}
 }
 
+static int http_send_all(struct http_client_t *client, const char *buf, int len)
+{
+	int ret;
+
+	while (len > 0) {
+#ifdef CONFIG_NET_SECURITY_TLS
+		if (client->server->tls_init) {
+			ret = mbedtls_ssl_write(&(client->tls_ssl), (const unsigned char *)buf, len);
+		} else
+#endif
+		{
+			ret = send(client->client_fd, buf, len, 0);
+		}
+
+		if (ret < 1) {
+			return HTTP_ERROR;
+		}
+		buf += ret;
+		len -= ret;
+	}
+
+	return HTTP_OK;
+}
+
+/*
+ * Value of the Connection header of a response. The connection is kept only
+ * if the client asked for it and can find the end of the response.
+ */
+static const char *http_connection(struct http_client_t *client, int framed)
+{
+#ifdef CONFIG_NETUTILS_WEBSERVER_KEEPALIVE
+	if (!framed) {
+		client->keepalive = 0;
+	}
+	return client->keepalive ? "keep-alive" : "close";
+#else
+	return "close";
+#endif
+}
+
+static const char *http_file_type(const char *path)
+{
+	int i;
+	int len;
+	int path_len = strlen(path);
+
+	for (i = 0; i < sizeof(g_http_mime) / sizeof(g_http_mime[0]); i++) {
+		len = strlen(g_http_mime[i].ext);
+		if (path_len > len && strcasecmp(path + path_len - len, g_http_mime[i].ext) == 0) {
+			return g_http_mime[i].type;
+		}
+	}
+
+	return "application/octet-stream";
+}
+
+int http_send_file(struct http_client_t *client, struct http_req_message *req, const char *path)
+{
+	int fd;
+	int ret = HTTP_OK;
+	int buflen;
+	ssize_t len;
+	struct stat st;
+	void *base = NULL;
+	char *match;
+	char etag[24];
+	char *buf;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || stat(path, &st) < 0 || S_ISDIR(st.st_mode)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+
+	/*
+	 * The entity tag changes with the size and the modification time. The
+	 * file systems that map files in memory, like ROMFS, have no modification
+	 * time: hash the content instead, reading it where it is.
+	 */
+	if (ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) == OK && base) {
+		snprintf(etag, sizeof(etag), "\"%lx-%08lx\"", (unsigned long)st.st_size,
+				 (unsigned long)crc32((const uint8_t *)base, st.st_size));
+	} else {
+		snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)st.st_size, (unsigned long)st.st_mtime);
+	}
+
+	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LINE_LENGTH);
+	if (buf == NULL) {
+		HTTP_LOGE("Error: Fail to malloc buffer\n");
+		close(fd);
+		return HTTP_ERROR;
+	}
+
+	match = req ? (char *)http_get_header(req, "If-None-Match") : NULL;
+	if (match && strcmp(match, etag) == 0) {
+		buflen = snprintf(buf, HTTP_CONF_MAX_REQUEST_LINE_LENGTH,
+						  "HTTP/1.1 304 Not Modified\r\n"
+						  "ETag: %s\r\n"
+						  "Connection: %s\r\n\r\n", etag, http_connection(client, 1));
+		ret = http_send_all(client, buf, buflen);
+		goto out;
+	}
+
+	buflen = snprintf(buf, HTTP_CONF_MAX_REQUEST_LINE_LENGTH,
+					  "HTTP/1.1 200 OK\r\n"
+					  "Content-Type: %s\r\n"
+					  "Content-Length: %ld\r\n"
+					  "ETag: %s\r\n"
+					  "Cache-Control: no-cache\r\n"
+					  "Connection: %s\r\n\r\n",
+					  http_file_type(path), (long)st.st_size, etag, http_connection(client, 1));
+	if (http_send_all(client, buf, buflen) == HTTP_ERROR) {
+		ret = HTTP_ERROR;
+		goto out;
+	}
+
+	/* sendfile() passes a memory-mapped file to the socket without copying */
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (client->server->tls_init) {
+		while ((len = read(fd, buf, HTTP_CONF_MAX_REQUEST_LINE_LENGTH)) > 0) {
+			if (http_send_all(client, buf, len) == HTTP_ERROR) {
+				ret = HTTP_ERROR;
+				break;
+			}
+		}
+	} else
+#endif
+	{
+		len = sendfile(client->client_fd, fd, NULL, st.st_size);
+		if (len != st.st_size) {
+			ret = HTTP_ERROR;
+		}
+	}
+
+out:
+	if (ret != HTTP_OK) {
+		http_connection(client, 0);
+	}
+	HTTP_FREE(buf);
+	close(fd);
+	return ret;
+}
+
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers)
 {
 	char *buf;
-	int buflen = 0, ret, sndlen;
+	int buflen = 0, ret;
 	struct http_keyvalue_t *cur = NULL;
 
 	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
@@ -624,7 +638,7 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 			if (headers == NULL) {
 				buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
 								   "Content-type: text/html\r\n"
-								   "Connection: close\r\n");
+								   "Connection: %s\r\n", http_connection(client, body != NULL));
 				if (body) {
 					buflen += snprintf(buf + buflen,
 									   HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
@@ -644,26 +658,15 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 		}
 	}
 
-	sndlen = strlen(buf);
-	buflen = 0;
-	while (sndlen > 0) {
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
-		} else
-#endif
-		{
-			ret = send(client->client_fd, buf + buflen, sndlen, 0);
-		}
+	if (status != 200 || headers) {
+		/* The end of the response is not known */
+		http_connection(client, 0);
+	}
 
-		if (ret < 1) {
-			HTTP_FREE(buf);
-			return HTTP_ERROR;
-		} else {
-			sndlen -= ret;
-			buflen += ret;
-		}
+	ret = http_send_all(client, buf, strlen(buf));
+	if (ret != HTTP_OK) {
+		http_connection(client, 0);
 	}
 	HTTP_FREE(buf);
-	return HTTP_OK;
+	return ret;
 }
@@ -36,15 +36,12 @@
 #include "tls/ssl_cache.h"
 #endif
 
-enum {
-	HTTP_REQUEST_HEADER, HTTP_REQUEST_PARAMETERS, HTTP_REQUEST_BODY
-};
-
 struct http_client_t {
 	int client_fd;
 	struct http_server_t *server;
 	int ws_state;
 	unsigned char ws_key[WEBSOCKET_CLIENT_KEY_LEN];
+	int keepalive;			/* Serve the next request of the connection */
 
 #ifdef CONFIG_NET_SECURITY_TLS
 	mbedtls_ssl_context       tls_ssl;
@@ -52,28 +49,17 @@ struct http_client_t {
 #endif
 };
 
-struct http_message_len_t {
-	int chunked_remain;
-	int sentence_start;
-	int message_len;
-	int entity_len;
-	int content_len;
-};
-
 int   http_accept_client(struct http_server_t *server);
 void  http_close_client(struct http_client_t *client);
 void *http_handle_client(void *arg /* struct http_client_t *client */);
+void  http_serve_client(struct http_server_t *server, int sock_fd);
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+void *http_accept_handler(void *arg /* struct http_server_t *server */);
+#endif
 
 struct http_client_t *http_client_init(struct http_server_t *server, int sock_fd);
 int   http_client_release(struct http_client_t *client);
 
-int http_parse_message(char *buf, int buf_len, int *method, char *url,
-					   char **body, int *enc, int *state,
-					   struct http_message_len_t *len,
-					   struct http_keyvalue_list_t *params,
-					   struct http_client_t *client,
-					   struct http_client_response_t *response,
-					   struct http_req_message *req);
 int   http_recv_and_handle_request(struct http_client_t *client, struct http_keyvalue_list_t *request_params);
 
 #ifdef CONFIG_NET_SECURITY_TLS
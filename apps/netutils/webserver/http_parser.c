@@ -0,0 +1,355 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <apps/netutils/webserver/http_err.h>
+
+#include "http.h"
+#include "http_parser.h"
+#include "http_arch.h"
+#include "http_log.h"
+
+enum {
+	HTTP_PARSER_REQUEST_LINE,
+	HTTP_PARSER_HEADERS,
+	HTTP_PARSER_BODY,
+	HTTP_PARSER_CHUNK_SIZE,
+	HTTP_PARSER_CHUNK_DATA,
+	HTTP_PARSER_CHUNK_DONE,	/* A chunk was handed over, drop it */
+	HTTP_PARSER_TRAILER,
+	HTTP_PARSER_COMPLETE
+};
+
+static void http_parser_reset(struct http_req_parser_t *parser)
+{
+	parser->pos = 0;
+	parser->scan = 0;
+	parser->state = HTTP_PARSER_REQUEST_LINE;
+	parser->method = HTTP_METHOD_UNKNOWN;
+	parser->version = HTTP_HTTP_VERSION_UNKNOWN;
+	parser->url = 0;
+	parser->body = 0;
+	parser->header_count = 0;
+	parser->encoding = HTTP_CONTENT_LENGTH;
+	parser->content_len = 0;
+	parser->entity = 0;
+	parser->keepalive = 0;
+	parser->held = -1;
+}
+
+/*
+ * Cut the next line at its CRLF (or LF) and return it, NUL terminated, or
+ * NULL if its end has not arrived yet. The bytes already searched are not
+ * searched again.
+ */
+static char *http_parser_line(struct http_req_parser_t *parser)
+{
+	char *line = parser->buf + parser->pos;
+	int i = parser->scan > parser->pos ? parser->scan : parser->pos;
+
+	for (; i < parser->len; i++) {
+		if (parser->buf[i] == '\n') {
+			parser->buf[i] = '\0';
+			if (i > parser->pos && parser->buf[i - 1] == '\r') {
+				parser->buf[i - 1] = '\0';
+			}
+			parser->pos = i + 1;
+			parser->scan = i + 1;
+			return line;
+		}
+	}
+
+	parser->scan = i;
+	return NULL;
+}
+
+/* End the entity with a NUL, keeping the byte it replaces for later */
+static void http_parser_hold(struct http_req_parser_t *parser, int offset)
+{
+	parser->held = offset;
+	parser->held_char = parser->buf[offset];
+	parser->buf[offset] = '\0';
+}
+
+static int http_parser_request_line(struct http_req_parser_t *parser, char *line)
+{
+	char *url = strchr(line, ' ');
+	char *version = url ? strchr(url + 1, ' ') : NULL;
+
+	if (version == NULL) {
+		HTTP_LOGE("Error: Not HTTP Header!!\n");
+		return HTTP_ERROR;
+	}
+	*url++ = '\0';
+	*version++ = '\0';
+
+	if (strcmp(line, "GET") == 0) {
+		parser->method = HTTP_METHOD_GET;
+	} else if (strcmp(line, "PUT") == 0) {
+		parser->method = HTTP_METHOD_PUT;
+	} else if (strcmp(line, "POST") == 0) {
+		parser->method = HTTP_METHOD_POST;
+	} else if (strcmp(line, "DELETE") == 0) {
+		parser->method = HTTP_METHOD_DELETE;
+	} else {
+		HTTP_LOGE("Error: Unknown method %s\n", line);
+		return HTTP_ERROR;
+	}
+
+	if (strcmp(version, "HTTP/1.1") == 0) {
+		parser->version = HTTP_HTTP_VERSION_11;
+		parser->keepalive = 1;
+	} else if (strcmp(version, "HTTP/1.0") == 0) {
+		parser->version = HTTP_HTTP_VERSION_10;
+	} else if (strcmp(version, "HTTP/0.9") == 0) {
+		parser->version = HTTP_HTTP_VERSION_09;
+	}
+
+	parser->url = url - parser->buf;
+	HTTP_LOGD("Request URI : %s\n", url);
+
+	return HTTP_OK;
+}
+
+static int http_parser_header_line(struct http_req_parser_t *parser, char *line)
+{
+	char *value = strchr(line, ':');
+	char *end;
+
+	if (value == NULL) {
+		return HTTP_OK;
+	}
+
+	if (parser->header_count == HTTP_CONF_MAX_REQUEST_HEADERS) {
+		HTTP_LOGE("Error: Too many headers\n");
+		return HTTP_ERROR;
+	}
+
+	*value++ = '\0';
+	while (*value == ' ' || *value == '\t') {
+		value++;
+	}
+	end = value + strlen(value);
+	while (end > value && (end[-1] == ' ' || end[-1] == '\t')) {
+		*--end = '\0';
+	}
+
+	HTTP_LOGD("[HTTP Parameter] Key: %s / Value: %s\n", line, value);
+	parser->headers[parser->header_count].key = line - parser->buf;
+	parser->headers[parser->header_count].value = value - parser->buf;
+	parser->header_count++;
+
+	if (strcasecmp(line, "Content-Length") == 0) {
+		parser->content_len = HTTP_ATOI(value);
+	} else if (strcasecmp(line, "Transfer-Encoding") == 0 && strcasecmp(value, "chunked") == 0) {
+		parser->encoding = HTTP_CHUNKED_ENCODING;
+	} else if (strcasecmp(line, "Connection") == 0) {
+		if (strcasecmp(value, "close") == 0) {
+			parser->keepalive = 0;
+		} else if (strcasecmp(value, "keep-alive") == 0) {
+			parser->keepalive = 1;
+		}
+	}
+
+	return HTTP_OK;
+}
+
+/* Drop a chunk that was handed over, and its framing */
+static void http_parser_drop_chunk(struct http_req_parser_t *parser)
+{
+	if (parser->state != HTTP_PARSER_CHUNK_DONE) {
+		return;
+	}
+
+	HTTP_MEMMOVE(parser->buf + parser->body, parser->buf + parser->pos, parser->len - parser->pos);
+	parser->len -= parser->pos - parser->body;
+	parser->pos = parser->body;
+	parser->scan = parser->body;
+	parser->state = HTTP_PARSER_CHUNK_SIZE;
+}
+
+void http_parser_init(struct http_req_parser_t *parser, char *buf)
+{
+	parser->buf = buf;
+	parser->len = 0;
+	http_parser_reset(parser);
+}
+
+char *http_parser_space(struct http_req_parser_t *parser, int *avail)
+{
+	http_parser_drop_chunk(parser);
+
+	/* Keep a byte for the NUL that ends the entity */
+	*avail = HTTP_CONF_MAX_REQUEST_LENGTH - 1 - parser->len;
+	return parser->buf + parser->len;
+}
+
+int http_parser_feed(struct http_req_parser_t *parser, int len)
+{
+	char *line;
+	int size;
+
+	parser->len += len;
+	http_parser_drop_chunk(parser);
+
+	while (1) {
+		switch (parser->state) {
+		case HTTP_PARSER_REQUEST_LINE:
+			line = http_parser_line(parser);
+			if (line == NULL) {
+				return HTTP_PARSE_MORE;
+			}
+
+			/* Skip the empty lines before a request */
+			if (*line == '\0') {
+				break;
+			}
+			if (http_parser_request_line(parser, line) != HTTP_OK) {
+				return HTTP_ERROR;
+			}
+			parser->state = HTTP_PARSER_HEADERS;
+			break;
+
+		case HTTP_PARSER_HEADERS:
+			line = http_parser_line(parser);
+			if (line == NULL) {
+				return HTTP_PARSE_MORE;
+			}
+
+			if (*line != '\0') {
+				if (http_parser_header_line(parser, line) != HTTP_OK) {
+					return HTTP_ERROR;
+				}
+				break;
+			}
+
+			/* End of the headers */
+			parser->body = parser->pos;
+			parser->entity = parser->pos;
+			if (parser->encoding == HTTP_CHUNKED_ENCODING) {
+				parser->state = HTTP_PARSER_CHUNK_SIZE;
+			} else if (parser->content_len > 0) {
+				parser->state = HTTP_PARSER_BODY;
+			} else {
+				http_parser_hold(parser, parser->entity);
+				parser->state = HTTP_PARSER_COMPLETE;
+			}
+			break;
+
+		case HTTP_PARSER_BODY:
+			if (parser->entity + parser->content_len >= HTTP_CONF_MAX_REQUEST_LENGTH) {
+				HTTP_LOGE("Error: Request size is too large!!\n");
+				return HTTP_ERROR;
+			}
+			if (parser->len - parser->entity < parser->content_len) {
+				return HTTP_PARSE_MORE;
+			}
+			parser->pos = parser->entity + parser->content_len;
+			http_parser_hold(parser, parser->pos);
+			parser->state = HTTP_PARSER_COMPLETE;
+			break;
+
+		case HTTP_PARSER_CHUNK_SIZE:
+			line = http_parser_line(parser);
+			if (line == NULL) {
+				return HTTP_PARSE_MORE;
+			}
+
+			size = (int)strtol(line, NULL, 16);
+			if (size < 0) {
+				HTTP_LOGE("Error: Not accord with chunked encoding\n");
+				return HTTP_ERROR;
+			}
+			parser->content_len = size;
+			parser->entity = parser->pos;
+			parser->state = size ? HTTP_PARSER_CHUNK_DATA : HTTP_PARSER_TRAILER;
+			break;
+
+		case HTTP_PARSER_CHUNK_DATA:
+			/* The data and its CRLF */
+			if (parser->entity + parser->content_len + 2 >= HTTP_CONF_MAX_REQUEST_LENGTH) {
+				HTTP_LOGE("Error: Chunk is too large!!\n");
+				return HTTP_ERROR;
+			}
+			if (parser->len - parser->entity < parser->content_len + 2) {
+				return HTTP_PARSE_MORE;
+			}
+			parser->buf[parser->entity + parser->content_len] = '\0';
+			parser->pos = parser->entity + parser->content_len + 2;
+			parser->scan = parser->pos;
+			parser->state = HTTP_PARSER_CHUNK_DONE;
+			return HTTP_PARSE_CHUNK;
+
+		case HTTP_PARSER_TRAILER:
+			line = http_parser_line(parser);
+			if (line == NULL) {
+				return HTTP_PARSE_MORE;
+			}
+			if (*line == '\0') {
+				/* The last, empty, chunk */
+				parser->entity = line - parser->buf;
+				parser->state = HTTP_PARSER_COMPLETE;
+			}
+			break;
+
+		case HTTP_PARSER_COMPLETE:
+			return HTTP_PARSE_DONE;
+
+		default:
+			return HTTP_ERROR;
+		}
+	}
+}
+
+void http_parser_next(struct http_req_parser_t *parser)
+{
+	if (parser->held >= 0) {
+		parser->buf[parser->held] = parser->held_char;
+	}
+
+	/* Keep the pipelined requests */
+	HTTP_MEMMOVE(parser->buf, parser->buf + parser->pos, parser->len - parser->pos);
+	parser->len -= parser->pos;
+	http_parser_reset(parser);
+}
+
+const char *http_parser_header(struct http_req_parser_t *parser, const char *key)
+{
+	int i;
+
+	for (i = 0; i < parser->header_count; i++) {
+		if (strcasecmp(parser->buf + parser->headers[i].key, key) == 0) {
+			return parser->buf + parser->headers[i].value;
+		}
+	}
+
+	return NULL;
+}
+
+const char *http_get_header(struct http_req_message *req, const char *key)
+{
+	if (req == NULL || req->parser == NULL) {
+		return NULL;
+	}
+
+	return http_parser_header(req->parser, key);
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Incremental parser of the requests of a connection. The receive buffer of
+ * the connection is the arena of the parser: the request line and the
+ * headers are cut in place with NULs and indexed by offsets, the body of a
+ * request is left where it arrived, and a chunked body is handed over
+ * chunk by chunk, each chunk being dropped from the buffer after it.
+ * Parsing resumes where it stopped when more data arrives, and the bytes
+ * that follow a complete request are kept for the next one.
+ */
+
+#ifndef __http_parser_h__
+#define __http_parser_h__
+
+#include <stdint.h>
+#include <apps/netutils/webserver/http_server.h>
+
+/* Results of http_parser_feed() */
+#define HTTP_PARSE_MORE  0	/* More data is needed */
+#define HTTP_PARSE_DONE  1	/* A request is complete */
+#define HTTP_PARSE_CHUNK 2	/* A chunk of a chunked body is complete */
+
+struct http_parser_header_t {
+	uint16_t key;
+	uint16_t value;
+};
+
+struct http_req_parser_t {
+	char *buf;				/* The arena, HTTP_CONF_MAX_REQUEST_LENGTH bytes */
+	int len;				/* Bytes received in the arena */
+	int pos;				/* Start of the data not parsed yet */
+	int scan;				/* End of the part of the line already searched */
+	int state;
+
+	/* The request being parsed */
+	int method;
+	int version;
+	int url;				/* Offsets in the arena */
+	int body;
+	int header_count;
+	struct http_parser_header_t headers[HTTP_CONF_MAX_REQUEST_HEADERS];
+	int encoding;			/* HTTP_CONTENT_LENGTH or HTTP_CHUNKED_ENCODING */
+	int content_len;		/* Or size of the current chunk */
+	int entity;				/* Offset of the body or of the current chunk */
+	int keepalive;			/* The client keeps the connection open */
+
+	int held;				/* Offset of a byte replaced with the NUL ending the body, or -1 */
+	char held_char;
+};
+
+void  http_parser_init(struct http_req_parser_t *parser, char *buf);
+char *http_parser_space(struct http_req_parser_t *parser, int *avail);
+int   http_parser_feed(struct http_req_parser_t *parser, int len);
+void  http_parser_next(struct http_req_parser_t *parser);
+const char *http_parser_header(struct http_req_parser_t *parser, const char *key);
+
+#endif
@@ -29,101 +29,184 @@
 #include "http_arch.h"
 #include "http_log.h"
 
-static int http_compare_dq(struct http_divided_query_t *src, struct http_divided_query_t *dest, struct http_keyvalue_list_t *params_list)
+static uint32_t http_query_hash(int method, const char *path, int len)
+{
+	uint32_t hash = 5381 + method;
+	int i;
+
+	for (i = 0; i < len; i++) {
+		hash = hash * 33 + (uint8_t)path[i];
+	}
+
+	return hash;
+}
+
+/*
+ * Compile a URL format such as '/device/:id/state' into 'route'. A trailing
+ * '/' is dropped, as it is from the URLs of requests.
+ */
+static int http_compile_query(const char *url_format, int method, struct http_query_handler_t *route)
 {
 	int i = 0;
+	int len = (int)strlen(url_format);
 
-	if (src->slash_count == dest->slash_count) {
-		bool same = true;
-		for (i = 0; i < src->slash_count; i++) {
-			char *src_path = src->paths + (i * HTTP_CONF_MAX_DIVIDED_PATH_LENGTH);
-			char *dest_path = dest->paths + (i * HTTP_CONF_MAX_DIVIDED_PATH_LENGTH);
-
-			if (strcmp(src_path, dest_path) != 0) {
-				/*
-				 * Consider variable string such as ':id', ':num'
-				 */
-				if (src_path[1] != ':' && dest_path[1] != ':') {
-					same = false;
-					break;
-				} else {
-					if (params_list) {
-						if (src_path[1] == ':') {
-							HTTP_LOGD("Add Parameter : [%s: %s]\n", src_path + 2, dest_path + 1);
-							http_keyvalue_list_add(params_list, src_path + 2, dest_path + 1);
-						} else if (dest_path[1] == ':') {
-							HTTP_LOGD("Add Parameter : [%s: %s]\n", dest_path + 2, src_path + 1);
-							http_keyvalue_list_add(params_list, dest_path + 2, src_path + 1);
-						}
-					}
-				}
-			}
+	HTTP_MEMSET(route, 0, sizeof(struct http_query_handler_t));
+
+	if (len > 1 && url_format[len - 1] == '/') {
+		len--;
+	}
+
+	if (url_format[0] != '/' || len >= HTTP_CONF_MAX_URL_QUERY_LENGTH) {
+		HTTP_LOGE("Error: Incorrect url format %s\n", url_format);
+		return HTTP_ERROR;
+	}
+
+	for (i = 0; i < len; i++) {
+		if (url_format[i] != '/') {
+			route->pattern[i] = url_format[i];
+			continue;
+		}
+
+		if (route->segment_count == HTTP_CONF_MAX_SLASH_COUNT) {
+			HTTP_LOGE("Error: Too many segments in %s\n", url_format);
+			return HTTP_ERROR;
 		}
 
-		if (same) {
-			return HTTP_OK;
+		route->segments[route->segment_count++] = i + 1;
+		if (url_format[i + 1] == ':' && route->param_count++ == HTTP_CONF_MAX_PATH_PARAMS) {
+			HTTP_LOGE("Error: Too many parameters in %s\n", url_format);
+			return HTTP_ERROR;
 		}
 	}
 
-	return HTTP_ERROR;
+	route->method = method;
+	route->hash = http_query_hash(method, url_format, len);
+
+	return HTTP_OK;
 }
 
-int http_dispatch_url(struct http_client_t *client, struct http_req_message *req)
+/*
+ * Match the path of a request against a route. The values of the parameters
+ * are copied in 'values', NUL terminated, and returned in 'req'.
+ */
+static bool http_match_query(struct http_query_handler_t *route, const char *query, char *values, struct http_req_message *req)
 {
 	int i = 0;
+	int seg_len = 0;
+	const char *end = NULL;
+	const char *seg = NULL;
+
+	req->path_param_count = 0;
+
+	for (i = 0; i < route->segment_count; i++) {
+		if (*query++ != '/') {
+			return false;
+		}
+
+		end = strchr(query, '/');
+		seg_len = end ? (int)(end - query) : (int)strlen(query);
+		seg = route->pattern + route->segments[i];
+
+		if (seg[0] == ':') {
+			HTTP_MEMCPY(values, query, seg_len);
+			values[seg_len] = '\0';
+			req->path_param_keys[req->path_param_count] = seg + 1;
+			req->path_param_values[req->path_param_count++] = values;
+			values += seg_len + 1;
+		} else if (strncmp(seg, query, seg_len) != 0 || seg[seg_len] != '\0') {
+			return false;
+		}
+
+		query += seg_len;
+	}
+
+	return *query == '\0';
+}
+
+/* Two formats of the same route, whatever the names of their parameters */
+static bool http_same_query(struct http_query_handler_t *a, struct http_query_handler_t *b)
+{
+	int i = 0;
+	const char *seg_a = NULL;
+	const char *seg_b = NULL;
+
+	if (a->method != b->method || a->segment_count != b->segment_count || a->param_count != b->param_count) {
+		return false;
+	}
+
+	for (i = 0; i < a->segment_count; i++) {
+		seg_a = a->pattern + a->segments[i];
+		seg_b = b->pattern + b->segments[i];
+		if (seg_a[0] == ':' ? seg_b[0] != ':' : strcmp(seg_a, seg_b) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int http_dispatch_url(struct http_client_t *client, struct http_req_message *req)
+{
 	char query[HTTP_CONF_MAX_URL_QUERY_LENGTH] = {0, };
 	char params[HTTP_CONF_MAX_URL_PARAMS_LENGTH] = {0, };
-	struct http_divided_query_t dq;
-	struct http_keyvalue_list_t params_list;
+	char values[HTTP_CONF_MAX_URL_QUERY_LENGTH];
+	struct http_server_t *server = client->server;
+	struct http_query_handler_t *cur = NULL;
 	char *origin_url = req->url;
+	uint32_t hash;
 
 	if (http_divide_query_params(req->url, query, params)) {
 		return HTTP_ERROR;
 	}
 	req->url = query;
 	req->query_string = params;
+	req->path_param_count = 0;
 
-	http_parse_query(query, &dq);
-	if (http_keyvalue_list_init(&params_list) == HTTP_ERROR) {
-		http_keyvalue_list_release(&params_list);
-		http_release_query(&dq);
-		return HTTP_ERROR;
-	}
-
-	/* Parse url params */
-	if (strlen(params) > 0) {
-		http_parse_params(params, &params_list);
+	/* Routes without parameters, then routes with parameters */
+	hash = http_query_hash(req->method, query, strlen(query));
+	for (cur = server->query_table[hash % HTTP_CONF_QUERY_HASH_SIZE]; cur; cur = cur->next) {
+		if (cur->hash == hash && cur->method == req->method && http_match_query(cur, query, values, req)) {
+			break;
+		}
 	}
 
-	for (i = 0; i < HTTP_CONF_MAX_QUERY_HANDLER_COUNT; i++) {
-		struct http_query_handler_t *cur = client->server->query_handlers[i];
-
-		if (cur) {
-			if (cur->method == req->method && http_compare_dq(&cur->dq, &dq, &params_list) == HTTP_OK) {
-				cur->func(client, req);
-				req->url = origin_url;
-				http_keyvalue_list_release(&params_list);
-				http_release_query(&dq);
-				return HTTP_OK;
+	if (cur == NULL) {
+		for (cur = server->query_params; cur; cur = cur->next) {
+			if (cur->method == req->method && http_match_query(cur, query, values, req)) {
+				break;
 			}
 		}
 	}
 
-	if (client->server->cb[req->method]) {
-		client->server->cb[req->method](client, req);
+	if (cur) {
+		cur->func(client, req);
+	} else if (server->cb[req->method]) {
+		req->path_param_count = 0;
+		server->cb[req->method](client, req);
 	}
 
 	req->url = origin_url;
-	http_keyvalue_list_release(&params_list);
-	http_release_query(&dq);
+	req->path_param_count = 0;
 	return HTTP_OK;
 }
 
-int http_server_register_cb(struct http_server_t *server, int method, const char *url_format, http_cb_t func)
+const char *http_get_path_param(struct http_req_message *req, const char *key)
 {
 	int i = 0;
-	int empty_slot = 0;
+
+	for (i = 0; i < req->path_param_count; i++) {
+		if (strcmp(req->path_param_keys[i], key) == 0) {
+			return req->path_param_values[i];
+		}
+	}
+
+	return NULL;
+}
+
+int http_server_register_cb(struct http_server_t *server, int method, const char *url_format, http_cb_t func)
+{
 	struct http_query_handler_t *cur = NULL;
+	struct http_query_handler_t **link = NULL;
 
 	if (server == NULL) {
 		HTTP_LOGE("Error: Server is NULL\n");
@@ -140,34 +223,36 @@ int http_server_register_cb(struct http_server_t *server, int method, const char
 		return HTTP_OK;
 	}
 
-	/* Find empty slot */
-	for (i = 0; i < HTTP_CONF_MAX_QUERY_HANDLER_COUNT; i++) {
-		if (server->query_handlers[i] == NULL) {
-			break;
-		}
-	}
-
-	if (i == HTTP_CONF_MAX_QUERY_HANDLER_COUNT) {
+	if (server->query_handler_count == HTTP_CONF_MAX_QUERY_HANDLER_COUNT) {
 		HTTP_LOGE("Error: Not exist empty dq slot!!\n");
 		return HTTP_ERROR;
 	}
 
-	empty_slot = i;
-
-	server->query_handlers[empty_slot] = (struct http_query_handler_t *)HTTP_MALLOC(sizeof(struct http_query_handler_t));
-	if (server->query_handlers[empty_slot] == NULL) {
+	cur = (struct http_query_handler_t *)HTTP_MALLOC(sizeof(struct http_query_handler_t));
+	if (cur == NULL) {
 		HTTP_LOGE("Error : Cannot allocate dq slot!!\n");
 		return HTTP_ERROR;
 	}
 
-	cur = server->query_handlers[empty_slot];
+	if (http_compile_query(url_format, method, cur) != HTTP_OK) {
+		HTTP_FREE(cur);
+		return HTTP_ERROR;
+	}
 
-	HTTP_MEMSET(cur, 0, sizeof(struct http_query_handler_t));
+	cur->func = func;
 
-	http_parse_query(url_format, &cur->dq);
+	/* Append, the first registered route wins when several match */
+	if (cur->param_count == 0) {
+		link = &server->query_table[cur->hash % HTTP_CONF_QUERY_HASH_SIZE];
+	} else {
+		link = &server->query_params;
+	}
 
-	cur->method = method;
-	cur->func = func;
+	while (*link) {
+		link = &(*link)->next;
+	}
+	*link = cur;
+	server->query_handler_count++;
 
 	return HTTP_OK;
 }
@@ -175,7 +260,9 @@ int http_server_register_cb(struct http_server_t *server, int method, const char
 int http_server_deregister_cb(struct http_server_t *server, int method, const char *url_format)
 {
 	int i = 0;
-	struct http_divided_query_t dq;
+	struct http_query_handler_t route;
+	struct http_query_handler_t *cur = NULL;
+	struct http_query_handler_t **link = NULL;
 
 	if (server == NULL) {
 		HTTP_LOGE("Error: Server is NULL\n");
@@ -192,55 +279,41 @@ int http_server_deregister_cb(struct http_server_t *server, int method, const ch
 		return HTTP_OK;
 	}
 
-	http_parse_query(url_format, &dq);
+	if (http_compile_query(url_format, method, &route) != HTTP_OK) {
+		return HTTP_ERROR;
+	}
 
-	for (i = 0; i < HTTP_CONF_MAX_QUERY_HANDLER_COUNT; i++) {
-		if (server->query_handlers[i] != NULL) {
-			if (server->query_handlers[i]->method == method &&
-				http_compare_dq(&server->query_handlers[i]->dq, &dq, NULL) == HTTP_OK) {
-				http_release_query(&server->query_handlers[i]->dq);
-				HTTP_FREE(server->query_handlers[i]);
-				server->query_handlers[i] = NULL;
-				http_release_query(&dq);
+	for (i = -1; i < HTTP_CONF_QUERY_HASH_SIZE; i++) {
+		link = i < 0 ? &server->query_params : &server->query_table[i];
+		for (; *link; link = &(*link)->next) {
+			cur = *link;
+			if (http_same_query(cur, &route)) {
+				*link = cur->next;
+				HTTP_FREE(cur);
+				server->query_handler_count--;
 				return HTTP_OK;
 			}
 		}
 	}
 
-	http_release_query(&dq);
 	return HTTP_ERROR;
 }
 
-int http_parse_query(const char *query, struct http_divided_query_t *dq)
+void http_release_query_handlers(struct http_server_t *server)
 {
 	int i = 0;
-	int query_len = (int)strlen(query);
-	int slash_position[HTTP_CONF_MAX_SLASH_COUNT + 1] = {0, };
-
-	HTTP_MEMSET(dq, 0, sizeof(struct http_divided_query_t));
-
-	for (i = 0; i < query_len; i++) {
-		if (query[i] == '/') {
-			slash_position[dq->slash_count++] = i;
+	struct http_query_handler_t *cur = NULL;
+	struct http_query_handler_t **link = NULL;
+
+	for (i = -1; i < HTTP_CONF_QUERY_HASH_SIZE; i++) {
+		link = i < 0 ? &server->query_params : &server->query_table[i];
+		while (*link) {
+			cur = *link;
+			*link = cur->next;
+			HTTP_FREE(cur);
 		}
 	}
-
-	/* Set the last slash position as query length. To calculate devided path length */
-	slash_position[dq->slash_count] = query_len;
-
-	dq->paths = (char *)HTTP_MALLOC(dq->slash_count * HTTP_CONF_MAX_DIVIDED_PATH_LENGTH);
-	if (!(dq->paths)) {
-		return HTTP_ERROR;
-	}
-
-	HTTP_MEMSET(dq->paths, 0, dq->slash_count * HTTP_CONF_MAX_DIVIDED_PATH_LENGTH);
-
-	for (i = 0; i < dq->slash_count; i++) {
-		HTTP_MEMCPY(dq->paths + (i * HTTP_CONF_MAX_DIVIDED_PATH_LENGTH),
-					query + slash_position[i], slash_position[i + 1] - slash_position[i]);
-	}
-
-	return HTTP_OK;
+	server->query_handler_count = 0;
 }
 
 int http_parse_params(const char *params, struct http_keyvalue_list_t *params_list)
@@ -287,13 +360,6 @@ int http_parse_params(const char *params, struct http_keyvalue_list_t *params_li
 	return HTTP_OK;
 }
 
-void http_release_query(struct http_divided_query_t *dq)
-{
-	if (dq->paths) {
-		HTTP_FREE(dq->paths);
-	}
-}
-
 int http_divide_query_params(const char *url, char *query, char *params)
 {
 	int i = 0;
@@ -20,16 +20,24 @@
 #define __http_query_h__
 
 #include <stdio.h>
+#include <stdint.h>
 
-struct http_divided_query_t {
-	int slash_count;
-	char *paths;
-};
+/* A route registered with http_server_register_cb(), compiled so that a
+ * request is matched in place, without copying or allocating.  The path
+ * is kept with every '/' replaced by a NUL, segment 'i' starting at
+ * 'pattern + segments[i]'; a segment starting with ':' captures the
+ * corresponding segment of the URL.
+ */
 
 struct http_query_handler_t {
+	struct http_query_handler_t *next; /* In the hash bucket or the list of routes with parameters */
 	int method;
-	struct http_divided_query_t dq;
 	http_cb_t func;
+	uint32_t hash; /* Of the method and the path, for routes without parameters */
+	uint8_t segment_count;
+	uint8_t param_count;
+	uint8_t segments[HTTP_CONF_MAX_SLASH_COUNT];
+	char pattern[HTTP_CONF_MAX_URL_QUERY_LENGTH];
 };
 
 /* Pre definition */
@@ -38,10 +46,9 @@ struct http_client_t;
 struct http_keyvalue_list_t;
 
 int  http_divide_query_params(const char *url, char *query, char *params);
-int  http_parse_query(const char *query, struct http_divided_query_t *dq);
 int  http_parse_params(const char *params, struct http_keyvalue_list_t *params_list);
-void http_release_query(struct http_divided_query_t *dq);
 
 int  http_dispatch_url(struct http_client_t *client, struct http_req_message *req);
+void http_release_query_handlers(struct http_server_t *server);
 
 #endif
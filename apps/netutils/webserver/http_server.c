@@ -21,6 +21,7 @@
 #include <apps/netutils/webserver/http_server.h>
 
 #include "http_client.h"
+#include "http_query.h"
 #include "http_arch.h"
 #include "http_log.h"
 
@@ -46,9 +47,6 @@ struct http_server_t *http_server_init(int port)
 	p->tls_init = 0;
 	p->state = HTTP_SERVER_INIT;
 
-	/* Init server query handler */
-	HTTP_MEMSET(p->query_handlers, 0, sizeof(struct http_query_handler_t *) * HTTP_CONF_MAX_QUERY_HANDLER_COUNT);
-
 	return p;
 }
 
@@ -66,6 +64,7 @@ void http_server_release(struct http_server_t **server)
 			http_server_tls_release(*server);
 		}
 #endif
+		http_release_query_handlers(*server);
 		HTTP_FREE(*server);
 		*server = NULL;
 	}
@@ -79,6 +78,10 @@ void http_close_client(struct http_client_t *client)
 
 int http_server_stop(struct http_server_t *server)
 {
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	int i;
+#endif
+
 	if (server == NULL) {
 		HTTP_LOGE("Error: Server must be started before stop\n");
 		return HTTP_ERROR;
@@ -90,7 +93,14 @@ int http_server_stop(struct http_server_t *server)
 		usleep(100000);
 	}
 
+#ifdef CONFIG_NETUTILS_WEBSERVER_MULTI_ACCEPT
+	for (i = 0; i < HTTP_CONF_MAX_CLIENT_HANDLE; i++) {
+		close(server->c_listen_fd[i]);
+	}
+	sem_destroy(&server->sem_thread_sync);
+#else
 	close(server->listen_fd);
+#endif
 
 	return HTTP_OK;
 }
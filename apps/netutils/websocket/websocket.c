@@ -44,6 +44,8 @@
 #include <apps/netutils/websocket.h>
 #include <apps/netutils/wslay/wslay.h>
 
+#include "websocket_deflate.h"
+
 /****************************************************************************
  * Definitions
  ****************************************************************************/
@@ -267,6 +269,7 @@ int websocket_client_handshake(websocket_t *client, char *host, char *port, char
 	unsigned char client_key[WEBSOCKET_CLIENT_KEY_LEN + 1];
 	unsigned char accept_key[WEBSOCKET_ACCEPT_KEY_LEN];
 	unsigned char dst[WEBSOCKET_ACCEPT_KEY_LEN];
+	char ext[WEBSOCKET_EXTENSION_HEADER_SIZE] = "";
 
 	header = (char *)calloc(WEBSOCKET_HANDSHAKE_HEADER_SIZE, sizeof(char));
 	if (header == NULL) {
@@ -282,7 +285,11 @@ int websocket_client_handshake(websocket_t *client, char *host, char *port, char
 	}
 	client_key[WEBSOCKET_CLIENT_KEY_LEN] = '\0';
 
-	snprintf(header, WEBSOCKET_HANDSHAKE_HEADER_SIZE, "GET %s HTTP/1.1\r\n" "Host: %s:%s\r\n" "Upgrade: websocket\r\n" "Connection: Upgrade\r\n" "Sec-WebSocket-Key: %s\r\n" "Sec-WebSocket-Version: 13\r\n" "\r\n", path, host, port, client_key);
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_offer(client, ext, sizeof(ext));
+#endif
+
+	snprintf(header, WEBSOCKET_HANDSHAKE_HEADER_SIZE, "GET %s HTTP/1.1\r\n" "Host: %s:%s\r\n" "Upgrade: websocket\r\n" "Connection: Upgrade\r\n" "Sec-WebSocket-Key: %s\r\n" "Sec-WebSocket-Version: 13\r\n" "%s" "\r\n", path, host, port, client_key, ext);
 	header_length = strlen(header);
 
 	while (header_sent < header_length) {
@@ -344,6 +351,12 @@ int websocket_client_handshake(websocket_t *client, char *host, char *port, char
 		WEBSOCKET_DEBUG("invalid key\n");
 		goto EXIT_WEBSOCKET_HANDSHAKE_ERROR;
 	}
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	if (websocket_deflate_confirm(client, header) != WEBSOCKET_SUCCESS) {
+		goto EXIT_WEBSOCKET_HANDSHAKE_ERROR;
+	}
+#endif
 	free(header);
 	return WEBSOCKET_SUCCESS;
 EXIT_WEBSOCKET_HANDSHAKE_ERROR:
@@ -443,6 +456,7 @@ int websocket_server_handshake(websocket_t *server)
 	char *keyhdstart, *keyhdend;
 	unsigned char client_key[WEBSOCKET_CLIENT_KEY_LEN];
 	unsigned char accept_key[WEBSOCKET_ACCEPT_KEY_LEN];
+	char ext[WEBSOCKET_EXTENSION_HEADER_SIZE] = "";
 
 	header = calloc(WEBSOCKET_HANDSHAKE_HEADER_SIZE, sizeof(char));
 	if (header == NULL) {
@@ -494,8 +508,12 @@ int websocket_server_handshake(websocket_t *server)
 	memset(accept_key, 0, WEBSOCKET_ACCEPT_KEY_LEN);
 	websocket_create_accept_key(accept_key, WEBSOCKET_ACCEPT_KEY_LEN, client_key, WEBSOCKET_CLIENT_KEY_LEN);
 
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_accept(server, header, ext, sizeof(ext));
+#endif
+
 	memset(header, 0, WEBSOCKET_HANDSHAKE_HEADER_SIZE);
-	snprintf(header, WEBSOCKET_HANDSHAKE_HEADER_SIZE, "HTTP/1.1 101 Switching Protocols\r\n" "Upgrade: websocket\r\n" "Connection: Upgrade\r\n" "Sec-WebSocket-Accept: %s\r\n" "\r\n", accept_key);
+	snprintf(header, WEBSOCKET_HANDSHAKE_HEADER_SIZE, "HTTP/1.1 101 Switching Protocols\r\n" "Upgrade: websocket\r\n" "Connection: Upgrade\r\n" "Sec-WebSocket-Accept: %s\r\n" "%s" "\r\n", accept_key, ext);
 	header_length = strlen(header);
 
 	while (header_sent < header_length) {
@@ -515,6 +533,9 @@ int websocket_server_handshake(websocket_t *server)
 	return WEBSOCKET_SUCCESS;
 
 EXIT_WEBSOCKET_HANDSHAKE_ERROR:
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_free(server);
+#endif
 	free(header);
 	return WEBSOCKET_HANDSHAKE_ERROR;
 }
@@ -820,6 +841,12 @@ websocket_return_t websocket_client_open(websocket_t *client, char *host, char *
 		r = WEBSOCKET_INIT_ERROR;
 		goto EXIT_CLIENT_OPEN;
 	}
+	wslay_event_config_set_no_buffering(client->ctx, client->no_buffering);
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	if (client->deflate) {
+		websocket_deflate_start(client);
+	}
+#endif
 
 	WEBSOCKET_DEBUG("start websocket client handling thread\n");
 	websocket_update_state(client, WEBSOCKET_RUNNING);
@@ -878,6 +905,9 @@ EXIT_CLIENT_OPEN:
 		wslay_event_context_free(client->ctx);
 		client->ctx = NULL;
 	}
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_free(client);
+#endif
 	websocket_update_state(client, WEBSOCKET_STOP);
 
 	return r;
@@ -946,6 +976,12 @@ websocket_return_t websocket_server_init(websocket_t *server)
 		r = WEBSOCKET_INIT_ERROR;
 		goto EXIT_SERVER_INIT;
 	}
+	wslay_event_config_set_no_buffering(server->ctx, server->no_buffering);
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	if (server->deflate) {
+		websocket_deflate_start(server);
+	}
+#endif
 
 	if (websocket_config_socket(server->fd) != WEBSOCKET_SUCCESS) {
 		r = WEBSOCKET_SOCKET_ERROR;
@@ -968,6 +1004,9 @@ EXIT_SERVER_INIT:
 		wslay_event_context_free(server->ctx);
 		server->ctx = NULL;
 	}
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_free(server);
+#endif
 
 	websocket_update_state(server, WEBSOCKET_STOP);
 
@@ -981,6 +1020,12 @@ websocket_return_t websocket_register_cb(websocket_t *websocket, websocket_cb_t
 		return WEBSOCKET_ALLOCATION_ERROR;
 	}
 
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	if (websocket->deflate) {
+		websocket_deflate_set_callbacks(websocket, cb);
+		return WEBSOCKET_SUCCESS;
+	}
+#endif
 	wslay_event_config_set_callbacks(websocket->ctx, cb);
 
 	return WEBSOCKET_SUCCESS;
@@ -998,6 +1043,11 @@ websocket_return_t websocket_queue_msg(websocket_t *websocket, websocket_frame_t
 		return WEBSOCKET_INIT_ERROR;
 	}
 
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	if (websocket->deflate) {
+		return websocket_deflate_queue_msg(websocket, tx_frame);
+	}
+#endif
 	return wslay_event_queue_msg(websocket->ctx, tx_frame);
 }
 
@@ -1038,6 +1088,9 @@ websocket_return_t websocket_queue_close(websocket_t *websocket, const char *clo
 			WEBSOCKET_DEBUG("fail to queue close message\n");
 			websocket_socket_free(websocket);
 			wslay_event_context_free(websocket->ctx);
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+			websocket_deflate_free(websocket);
+#endif
 			return WEBSOCKET_SEND_ERROR;
 		}
 		websocket_wait_state(websocket, WEBSOCKET_STOP, 100000);
@@ -1050,6 +1103,9 @@ websocket_return_t websocket_queue_close(websocket_t *websocket, const char *clo
 		wslay_event_context_free(websocket->ctx);
 		websocket->ctx = NULL;
 	}
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+	websocket_deflate_free(websocket);
+#endif
 
 	return WEBSOCKET_SUCCESS;
 }
@@ -0,0 +1,1072 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/// @file app/netutils/websocket/websocket_deflate.c
+/// @brief permessage-deflate (RFC 7692) negotiation and codec.
+///
+/// Whole messages are compressed into a single fixed-Huffman DEFLATE block
+/// with a hash-chained LZ77 matcher limited to 2^window_bits bytes, so the
+/// only long-lived memory is the optional sliding window kept for context
+/// takeover.  The inflater handles all three block types so that messages
+/// from any conforming peer can be decoded.
+
+/****************************************************************************
+ *  Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <apps/netutils/websocket.h>
+#include <apps/netutils/wslay/wslay.h>
+
+#include "websocket_deflate.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define WS_PMD_EXTENSION          "permessage-deflate"
+#define WS_PMD_HEADER             "Sec-WebSocket-Extensions: "
+
+#define WS_PMD_BITS               CONFIG_NETUTILS_WEBSOCKET_DEFLATE_WINDOW_BITS
+#define WS_PMD_MIN_BITS           8
+#define WS_PMD_MAX_BITS           15
+
+/* Every message ends with an empty stored block whose 00 00 ff ff is not
+ * sent on the wire.
+ */
+
+#define WS_PMD_TRAILER_LEN        4
+
+#define WS_PMD_MIN_MATCH          3
+#define WS_PMD_MAX_MATCH          258
+#define WS_PMD_MAX_CHAIN          32
+#define WS_PMD_HASH_BITS          (WS_PMD_BITS - 1)
+#define WS_PMD_HASH_SIZE          (1 << WS_PMD_HASH_BITS)
+
+/* Messages shorter than this are not worth a compressed block */
+
+#define WS_PMD_MIN_LENGTH         32
+
+#define WS_PMD_MAX_CODE_BITS      15
+#define WS_PMD_NLEN               288
+#define WS_PMD_NDIST              30
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct websocket_deflate_s {
+	uint8_t tx_bits;			/* Window of our deflater */
+	uint8_t rx_bits;			/* Window the peer may reference */
+	uint8_t tx_no_takeover;		/* Reset our deflater after each message */
+	uint8_t rx_no_takeover;		/* The peer resets its deflater after each message */
+	size_t tx_hlen;
+	size_t rx_hlen;
+	uint8_t *tx_hist;			/* Last 2^tx_bits bytes sent compressed */
+	uint8_t *rx_hist;			/* Last 2^rx_bits bytes received compressed */
+	wslay_event_on_msg_recv_callback on_msg_recv;	/* Application's callback */
+};
+
+struct websocket_deflate_params_s {
+	int server_no_takeover;
+	int client_no_takeover;
+	int server_bits;			/* 0 if absent */
+	int client_bits;			/* 0 if absent, -1 if given without a value */
+};
+
+struct websocket_bitout_s {
+	uint8_t *out;
+	size_t pos;
+	size_t max;
+	uint32_t bits;
+	int nbits;
+};
+
+struct websocket_huffman_s {
+	int16_t count[WS_PMD_MAX_CODE_BITS + 1];
+	int16_t symbol[WS_PMD_NLEN];
+};
+
+struct websocket_inflate_s {
+	const uint8_t *in;
+	size_t inlen;
+	size_t inpos;
+	uint32_t bits;
+	int nbits;
+	uint8_t *out;
+	size_t outlen;
+	size_t outsize;
+	struct websocket_huffman_s lencode;
+	struct websocket_huffman_s distcode;
+	int16_t lengths[WS_PMD_NLEN + WS_PMD_NDIST + 2];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_lbase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t g_lext[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t g_dbase[WS_PMD_NDIST] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577
+};
+
+static const uint8_t g_dext[WS_PMD_NDIST] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const uint8_t g_clorder[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static const uint8_t g_trailer[WS_PMD_TRAILER_LEN] = { 0x00, 0x00, 0xff, 0xff };
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/***** negotiation *****/
+
+static const char *websocket_deflate_skipws(const char *s, const char *end)
+{
+	while (s < end && (*s == ' ' || *s == '\t')) {
+		s++;
+	}
+	return s;
+}
+
+static int websocket_deflate_bits(const char *s, const char *end)
+{
+	int bits = 0;
+
+	s = websocket_deflate_skipws(s, end);
+	if (s < end && *s == '"') {
+		s++;
+		if (end[-1] != '"' || end - s < 1) {
+			return -1;
+		}
+		end--;
+	}
+	if (s == end) {
+		return -1;
+	}
+	for (; s < end; s++) {
+		if (!isdigit((unsigned char)*s) || bits > WS_PMD_MAX_BITS) {
+			return -1;
+		}
+		bits = bits * 10 + (*s - '0');
+	}
+	if (bits < WS_PMD_MIN_BITS || bits > WS_PMD_MAX_BITS) {
+		return -1;
+	}
+	return bits;
+}
+
+/* Parses one extension offer/response, s..end being the text between two
+ * commas of the header value.
+ */
+
+static int websocket_deflate_parse(const char *s, const char *end, struct websocket_deflate_params_s *p)
+{
+	const char *name;
+	const char *nend;
+	const char *eq;
+	size_t len = strlen(WS_PMD_EXTENSION);
+
+	memset(p, 0, sizeof(*p));
+
+	s = websocket_deflate_skipws(s, end);
+	if ((size_t)(end - s) < len || strncmp(s, WS_PMD_EXTENSION, len) != 0) {
+		return -1;
+	}
+	s = websocket_deflate_skipws(s + len, end);
+
+	while (s < end) {
+		if (*s != ';') {
+			return -1;
+		}
+		name = websocket_deflate_skipws(s + 1, end);
+		s = memchr(name, ';', end - name);
+		if (s == NULL) {
+			s = end;
+		}
+		nend = s;
+		while (nend > name && (nend[-1] == ' ' || nend[-1] == '\t')) {
+			nend--;
+		}
+		eq = memchr(name, '=', nend - name);
+		len = (eq ? eq : nend) - name;
+		while (len > 0 && (name[len - 1] == ' ' || name[len - 1] == '\t')) {
+			len--;
+		}
+
+		if (len == 26 && strncmp(name, "server_no_context_takeover", len) == 0 && !eq && !p->server_no_takeover) {
+			p->server_no_takeover = 1;
+		} else if (len == 26 && strncmp(name, "client_no_context_takeover", len) == 0 && !eq && !p->client_no_takeover) {
+			p->client_no_takeover = 1;
+		} else if (len == 22 && strncmp(name, "server_max_window_bits", len) == 0 && eq && !p->server_bits) {
+			if ((p->server_bits = websocket_deflate_bits(eq + 1, nend)) < 0) {
+				return -1;
+			}
+		} else if (len == 22 && strncmp(name, "client_max_window_bits", len) == 0 && !p->client_bits) {
+			p->client_bits = eq ? websocket_deflate_bits(eq + 1, nend) : -1;
+			if (eq && p->client_bits < 0) {
+				return -1;
+			}
+		} else {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int websocket_deflate_create(websocket_t *websocket, int tx_bits, int tx_no_takeover, int rx_bits, int rx_no_takeover)
+{
+	struct websocket_deflate_s *d;
+
+	d = calloc(1, sizeof(struct websocket_deflate_s));
+	if (d == NULL) {
+		WEBSOCKET_DEBUG("fail to allocate memory for permessage-deflate\n");
+		return WEBSOCKET_ALLOCATION_ERROR;
+	}
+
+	d->tx_bits = tx_bits;
+	d->tx_no_takeover = tx_no_takeover;
+	d->rx_bits = rx_bits;
+	d->rx_no_takeover = rx_no_takeover;
+	websocket->deflate = d;
+
+	WEBSOCKET_DEBUG("permessage-deflate: tx %d bits%s, rx %d bits%s\n", tx_bits, tx_no_takeover ? " no takeover" : "", rx_bits, rx_no_takeover ? " no takeover" : "");
+	return WEBSOCKET_SUCCESS;
+}
+
+/* Keeps the last 2^bits bytes of data as the dictionary of the next message */
+
+static int websocket_deflate_keep(uint8_t **hist, size_t *hlen, int bits, const uint8_t *data, size_t len)
+{
+	size_t wsize = (size_t)1 << bits;
+
+	if (*hist == NULL) {
+		*hist = malloc(wsize);
+		if (*hist == NULL) {
+			*hlen = 0;
+			return WEBSOCKET_ALLOCATION_ERROR;
+		}
+	}
+
+	if (len > wsize) {
+		data += len - wsize;
+		len = wsize;
+	}
+	memcpy(*hist, data, len);
+	*hlen = len;
+
+	return WEBSOCKET_SUCCESS;
+}
+
+/***** deflate *****/
+
+static void websocket_deflate_putbits(struct websocket_bitout_s *b, uint32_t val, int n)
+{
+	b->bits |= val << b->nbits;
+	b->nbits += n;
+	while (b->nbits >= 8) {
+		if (b->pos < b->max) {
+			b->out[b->pos] = (uint8_t)b->bits;
+		}
+		b->pos++;
+		b->bits >>= 8;
+		b->nbits -= 8;
+	}
+}
+
+static uint32_t websocket_deflate_reverse(uint32_t code, int len)
+{
+	uint32_t r = 0;
+
+	while (len-- > 0) {
+		r = (r << 1) | (code & 1);
+		code >>= 1;
+	}
+	return r;
+}
+
+static void websocket_deflate_putsym(struct websocket_bitout_s *b, int sym)
+{
+	if (sym < 144) {
+		websocket_deflate_putbits(b, websocket_deflate_reverse(0x30 + sym, 8), 8);
+	} else if (sym < 256) {
+		websocket_deflate_putbits(b, websocket_deflate_reverse(0x190 + sym - 144, 9), 9);
+	} else if (sym < 280) {
+		websocket_deflate_putbits(b, websocket_deflate_reverse(sym - 256, 7), 7);
+	} else {
+		websocket_deflate_putbits(b, websocket_deflate_reverse(0xc0 + sym - 280, 8), 8);
+	}
+}
+
+static void websocket_deflate_putmatch(struct websocket_bitout_s *b, int len, int dist)
+{
+	int i;
+
+	for (i = 28; g_lbase[i] > len; i--) ;
+	websocket_deflate_putsym(b, 257 + i);
+	websocket_deflate_putbits(b, len - g_lbase[i], g_lext[i]);
+
+	for (i = WS_PMD_NDIST - 1; g_dbase[i] > dist; i--) ;
+	websocket_deflate_putbits(b, websocket_deflate_reverse(i, 5), 5);
+	websocket_deflate_putbits(b, dist - g_dbase[i], g_dext[i]);
+}
+
+static uint32_t websocket_deflate_hash(const uint8_t *p)
+{
+	uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+
+	return (v * 2654435761u) >> (32 - WS_PMD_HASH_BITS);
+}
+
+/* Links position pos into its hash chain.  prev[] holds the distance back to
+ * the previous position with the same hash, 0 ending the chain.
+ */
+
+static void websocket_deflate_insert(int32_t *head, uint16_t *prev, const uint8_t *in, int32_t pos, int32_t wsize)
+{
+	uint32_t h = websocket_deflate_hash(in + pos);
+	int32_t cand = head[h];
+
+	prev[pos & (wsize - 1)] = (cand >= 0 && pos - cand < wsize) ? (uint16_t)(pos - cand) : 0;
+	head[h] = pos;
+}
+
+/* Compresses in[hlen..total) into b, in[0..hlen) being the dictionary left by
+ * the previous message.  Stops early once the output would not be smaller
+ * than the input.
+ */
+
+static void websocket_deflate_block(struct websocket_bitout_s *b, const uint8_t *in, int32_t hlen, int32_t total, int32_t wsize, int32_t *head, uint16_t *prev)
+{
+	int32_t pos;
+	int32_t cand;
+	int32_t maxlen;
+	int32_t bestlen;
+	int32_t bestdist = 0;
+	int32_t n;
+	int chain;
+
+	for (pos = 0; pos < WS_PMD_HASH_SIZE; pos++) {
+		head[pos] = -1;
+	}
+	for (pos = 0; pos < hlen && pos + WS_PMD_MIN_MATCH <= total; pos++) {
+		websocket_deflate_insert(head, prev, in, pos, wsize);
+	}
+
+	/* BFINAL = 0, BTYPE = 01 (fixed Huffman) */
+
+	websocket_deflate_putbits(b, 2, 3);
+
+	pos = hlen;
+	while (pos < total && b->pos < b->max) {
+		bestlen = 0;
+		if (pos + WS_PMD_MIN_MATCH <= total) {
+			maxlen = total - pos;
+			if (maxlen > WS_PMD_MAX_MATCH) {
+				maxlen = WS_PMD_MAX_MATCH;
+			}
+			cand = head[websocket_deflate_hash(in + pos)];
+			for (chain = WS_PMD_MAX_CHAIN; cand >= 0 && pos - cand < wsize && chain > 0; chain--) {
+				if (in[cand + bestlen] == in[pos + bestlen]) {
+					for (n = 0; n < maxlen && in[cand + n] == in[pos + n]; n++) ;
+					if (n > bestlen) {
+						bestlen = n;
+						bestdist = pos - cand;
+						if (n == maxlen) {
+							break;
+						}
+					}
+				}
+				if (prev[cand & (wsize - 1)] == 0) {
+					break;
+				}
+				cand -= prev[cand & (wsize - 1)];
+			}
+			websocket_deflate_insert(head, prev, in, pos, wsize);
+		}
+
+		if (bestlen >= WS_PMD_MIN_MATCH) {
+			websocket_deflate_putmatch(b, bestlen, bestdist);
+			for (n = 1; n < bestlen; n++) {
+				if (pos + n + WS_PMD_MIN_MATCH <= total) {
+					websocket_deflate_insert(head, prev, in, pos + n, wsize);
+				}
+			}
+			pos += bestlen;
+		} else {
+			websocket_deflate_putsym(b, in[pos]);
+			pos++;
+		}
+	}
+
+	/* End of block, then the header of the empty stored block.  Padding to
+	 * the byte boundary completes the part of the sync flush that is sent.
+	 */
+
+	websocket_deflate_putsym(b, 256);
+	websocket_deflate_putbits(b, 0, 3);
+	if (b->nbits > 0) {
+		websocket_deflate_putbits(b, 0, 8 - b->nbits);
+	}
+}
+
+/***** inflate *****/
+
+static int websocket_inflate_bits(struct websocket_inflate_s *s, int n)
+{
+	uint32_t val;
+
+	while (s->nbits < n) {
+		if (s->inpos < s->inlen) {
+			val = s->in[s->inpos];
+		} else if (s->inpos < s->inlen + WS_PMD_TRAILER_LEN) {
+			val = g_trailer[s->inpos - s->inlen];
+		} else {
+			return -1;
+		}
+		s->inpos++;
+		s->bits |= val << s->nbits;
+		s->nbits += 8;
+	}
+
+	val = s->bits & ((1u << n) - 1);
+	s->bits >>= n;
+	s->nbits -= n;
+	return (int)val;
+}
+
+static int websocket_inflate_put(struct websocket_inflate_s *s, uint8_t c)
+{
+	uint8_t *out;
+	size_t size;
+
+	if (s->outlen == s->outsize) {
+		if (s->outsize >= WEBSOCKET_MAX_LENGTH_QUEUE) {
+			return -1;
+		}
+		size = s->outsize * 2;
+		if (size > WEBSOCKET_MAX_LENGTH_QUEUE) {
+			size = WEBSOCKET_MAX_LENGTH_QUEUE;
+		}
+		out = realloc(s->out, size);
+		if (out == NULL) {
+			return -1;
+		}
+		s->out = out;
+		s->outsize = size;
+	}
+	s->out[s->outlen++] = c;
+	return 0;
+}
+
+static int websocket_inflate_construct(struct websocket_huffman_s *h, const int16_t *lengths, int n)
+{
+	int16_t offs[WS_PMD_MAX_CODE_BITS + 1];
+	int left;
+	int len;
+	int sym;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (sym = 0; sym < n; sym++) {
+		h->count[lengths[sym]]++;
+	}
+	if (h->count[0] == n) {
+		return 0;
+	}
+
+	left = 1;
+	for (len = 1; len <= WS_PMD_MAX_CODE_BITS; len++) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0) {
+			return -1;
+		}
+	}
+
+	offs[1] = 0;
+	for (len = 1; len < WS_PMD_MAX_CODE_BITS; len++) {
+		offs[len + 1] = offs[len] + h->count[len];
+	}
+	for (sym = 0; sym < n; sym++) {
+		if (lengths[sym] != 0) {
+			h->symbol[offs[lengths[sym]]++] = sym;
+		}
+	}
+
+	return left;
+}
+
+static int websocket_inflate_decode(struct websocket_inflate_s *s, const struct websocket_huffman_s *h)
+{
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	int count;
+	int len;
+	int b;
+
+	for (len = 1; len <= WS_PMD_MAX_CODE_BITS; len++) {
+		if ((b = websocket_inflate_bits(s, 1)) < 0) {
+			return -1;
+		}
+		code |= b;
+		count = h->count[len];
+		if (code - count < first) {
+			return h->symbol[index + (code - first)];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	return -1;
+}
+
+static int websocket_inflate_stored(struct websocket_inflate_s *s)
+{
+	int len;
+	int nlen;
+	int c;
+
+	s->bits = 0;
+	s->nbits = 0;
+
+	if ((len = websocket_inflate_bits(s, 16)) < 0 || (nlen = websocket_inflate_bits(s, 16)) < 0) {
+		return -1;
+	}
+	if (len != (~nlen & 0xffff)) {
+		return -1;
+	}
+	while (len-- > 0) {
+		if ((c = websocket_inflate_bits(s, 8)) < 0 || websocket_inflate_put(s, (uint8_t)c) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int websocket_inflate_codes(struct websocket_inflate_s *s)
+{
+	int sym;
+	int len;
+	int dist;
+	int extra;
+
+	do {
+		if ((sym = websocket_inflate_decode(s, &s->lencode)) < 0) {
+			return -1;
+		}
+		if (sym < 256) {
+			if (websocket_inflate_put(s, (uint8_t)sym) < 0) {
+				return -1;
+			}
+		} else if (sym > 256) {
+			sym -= 257;
+			if (sym >= 29 || (extra = websocket_inflate_bits(s, g_lext[sym])) < 0) {
+				return -1;
+			}
+			len = g_lbase[sym] + extra;
+
+			if ((sym = websocket_inflate_decode(s, &s->distcode)) < 0 || sym >= WS_PMD_NDIST) {
+				return -1;
+			}
+			if ((extra = websocket_inflate_bits(s, g_dext[sym])) < 0) {
+				return -1;
+			}
+			dist = g_dbase[sym] + extra;
+			if ((size_t)dist > s->outlen) {
+				return -1;
+			}
+
+			while (len-- > 0) {
+				if (websocket_inflate_put(s, s->out[s->outlen - dist]) < 0) {
+					return -1;
+				}
+			}
+		}
+	} while (sym != 256);
+
+	return 0;
+}
+
+static int websocket_inflate_fixed(struct websocket_inflate_s *s)
+{
+	int sym;
+
+	for (sym = 0; sym < WS_PMD_NLEN; sym++) {
+		s->lengths[sym] = sym < 144 ? 8 : sym < 256 ? 9 : sym < 280 ? 7 : 8;
+	}
+	websocket_inflate_construct(&s->lencode, s->lengths, WS_PMD_NLEN);
+
+	for (sym = 0; sym < WS_PMD_NDIST; sym++) {
+		s->lengths[sym] = 5;
+	}
+	websocket_inflate_construct(&s->distcode, s->lengths, WS_PMD_NDIST);
+
+	return websocket_inflate_codes(s);
+}
+
+static int websocket_inflate_dynamic(struct websocket_inflate_s *s)
+{
+	int nlen;
+	int ndist;
+	int ncode;
+	int index;
+	int sym;
+	int len;
+	int rep;
+	int left;
+
+	if ((nlen = websocket_inflate_bits(s, 5)) < 0 || (ndist = websocket_inflate_bits(s, 5)) < 0 || (ncode = websocket_inflate_bits(s, 4)) < 0) {
+		return -1;
+	}
+	nlen += 257;
+	ndist += 1;
+	ncode += 4;
+	if (nlen > 286 || ndist > WS_PMD_NDIST) {
+		return -1;
+	}
+
+	for (index = 0; index < 19; index++) {
+		len = index < ncode ? websocket_inflate_bits(s, 3) : 0;
+		if (len < 0) {
+			return -1;
+		}
+		s->lengths[g_clorder[index]] = len;
+	}
+	if (websocket_inflate_construct(&s->lencode, s->lengths, 19) != 0) {
+		return -1;
+	}
+
+	index = 0;
+	while (index < nlen + ndist) {
+		if ((sym = websocket_inflate_decode(s, &s->lencode)) < 0) {
+			return -1;
+		}
+		if (sym < 16) {
+			s->lengths[index++] = sym;
+			continue;
+		}
+
+		len = 0;
+		if (sym == 16) {
+			if (index == 0) {
+				return -1;
+			}
+			len = s->lengths[index - 1];
+			rep = websocket_inflate_bits(s, 2);
+			rep = rep < 0 ? -1 : rep + 3;
+		} else if (sym == 17) {
+			rep = websocket_inflate_bits(s, 3);
+			rep = rep < 0 ? -1 : rep + 3;
+		} else {
+			rep = websocket_inflate_bits(s, 7);
+			rep = rep < 0 ? -1 : rep + 11;
+		}
+		if (rep < 0 || index + rep > nlen + ndist) {
+			return -1;
+		}
+		while (rep-- > 0) {
+			s->lengths[index++] = len;
+		}
+	}
+
+	if (s->lengths[256] == 0) {
+		return -1;
+	}
+
+	/* Incomplete codes are only allowed for a single length code */
+
+	left = websocket_inflate_construct(&s->lencode, s->lengths, nlen);
+	if (left < 0 || (left > 0 && nlen - s->lencode.count[0] != 1)) {
+		return -1;
+	}
+	left = websocket_inflate_construct(&s->distcode, s->lengths + nlen, ndist);
+	if (left < 0 || (left > 0 && ndist - s->distcode.count[0] != 1)) {
+		return -1;
+	}
+
+	return websocket_inflate_codes(s);
+}
+
+static int websocket_inflate(struct websocket_inflate_s *s)
+{
+	int last;
+	int type;
+	int r;
+
+	do {
+		if ((last = websocket_inflate_bits(s, 1)) < 0 || (type = websocket_inflate_bits(s, 2)) < 0) {
+			return -1;
+		}
+		switch (type) {
+		case 0:
+			r = websocket_inflate_stored(s);
+			break;
+		case 1:
+			r = websocket_inflate_fixed(s);
+			break;
+		case 2:
+			r = websocket_inflate_dynamic(s);
+			break;
+		default:
+			r = -1;
+			break;
+		}
+		if (r < 0) {
+			return r;
+		}
+	} while (!last && s->inpos < s->inlen + WS_PMD_TRAILER_LEN);
+
+	return 0;
+}
+
+static void websocket_deflate_on_msg_recv(wslay_event_context_ptr ctx, const websocket_on_msg_arg *arg, void *user_data)
+{
+	struct websocket_info_t *info = user_data;
+	struct websocket_deflate_s *d = info->data->deflate;
+	struct websocket_inflate_s *s;
+	websocket_on_msg_arg plain;
+	size_t hlen = d->rx_hlen;
+	uint16_t code;
+
+	if (!wslay_get_rsv1(arg->rsv) || !WEBSOCKET_CHECK_NOT_CTRL_FRAME(arg->opcode)) {
+		if (d->on_msg_recv) {
+			d->on_msg_recv(ctx, arg, user_data);
+		}
+		return;
+	}
+
+	s = malloc(sizeof(struct websocket_inflate_s));
+	if (s == NULL) {
+		WEBSOCKET_DEBUG("fail to allocate memory for inflate\n");
+		wslay_event_queue_close(ctx, WSLAY_CODE_INTERNAL_SERVER_ERROR, NULL, 0);
+		return;
+	}
+
+	/* The output starts with the peer's window so back references may reach
+	 * into the previous message.
+	 */
+
+	memset(s, 0, sizeof(struct websocket_inflate_s));
+	s->in = arg->msg;
+	s->inlen = arg->msg_length;
+	s->outsize = hlen + 4 * arg->msg_length + 64;
+	if (s->outsize > WEBSOCKET_MAX_LENGTH_QUEUE) {
+		s->outsize = WEBSOCKET_MAX_LENGTH_QUEUE;
+	}
+	s->out = malloc(s->outsize);
+	if (s->out == NULL || hlen >= s->outsize) {
+		WEBSOCKET_DEBUG("fail to allocate memory for inflate\n");
+		code = WSLAY_CODE_INTERNAL_SERVER_ERROR;
+		goto errout;
+	}
+	if (hlen > 0) {
+		memcpy(s->out, d->rx_hist, hlen);
+		s->outlen = hlen;
+	}
+
+	if (websocket_inflate(s) < 0) {
+		WEBSOCKET_DEBUG("fail to inflate message of %d bytes\n", (int)arg->msg_length);
+		code = s->outlen >= WEBSOCKET_MAX_LENGTH_QUEUE ? WSLAY_CODE_MESSAGE_TOO_BIG : WSLAY_CODE_INVALID_FRAME_PAYLOAD_DATA;
+		goto errout;
+	}
+
+	if (!d->rx_no_takeover && websocket_deflate_keep(&d->rx_hist, &d->rx_hlen, d->rx_bits, s->out, s->outlen) != WEBSOCKET_SUCCESS) {
+		WEBSOCKET_DEBUG("fail to allocate memory for inflate window\n");
+		code = WSLAY_CODE_INTERNAL_SERVER_ERROR;
+		goto errout;
+	}
+
+	if (d->on_msg_recv) {
+		plain = *arg;
+		plain.rsv &= ~WSLAY_RSV1_BIT;
+		plain.msg = s->out + hlen;
+		plain.msg_length = s->outlen - hlen;
+		d->on_msg_recv(ctx, &plain, user_data);
+	}
+
+	free(s->out);
+	free(s);
+	return;
+
+errout:
+	free(s->out);
+	free(s);
+	wslay_event_queue_close(ctx, code, NULL, 0);
+}
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+int websocket_deflate_offer(websocket_t *websocket, char *buf, size_t len)
+{
+	int n;
+
+	if (!websocket->deflate_enabled || websocket->no_buffering) {
+		buf[0] = '\0';
+		return 0;
+	}
+
+	/* Without context takeover the peer's window costs nothing to keep, so
+	 * only bound it when we are going to hold on to it.
+	 */
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE_PEER_NO_TAKEOVER
+	n = snprintf(buf, len, WS_PMD_HEADER WS_PMD_EXTENSION "; client_max_window_bits=%d; server_no_context_takeover", WS_PMD_BITS);
+#else
+	n = snprintf(buf, len, WS_PMD_HEADER WS_PMD_EXTENSION "; client_max_window_bits=%d; server_max_window_bits=%d", WS_PMD_BITS, WS_PMD_BITS);
+#endif
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE_LOCAL_NO_TAKEOVER
+	n += snprintf(buf + n, len - n, "; client_no_context_takeover");
+#endif
+	n += snprintf(buf + n, len - n, "\r\n");
+
+	return n;
+}
+
+int websocket_deflate_confirm(websocket_t *websocket, const char *header)
+{
+	struct websocket_deflate_params_s p;
+	const char *start;
+	const char *end;
+	int tx_bits = WS_PMD_BITS;
+
+	websocket->deflate = NULL;
+	if (!websocket->deflate_enabled || websocket->no_buffering) {
+		return WEBSOCKET_SUCCESS;
+	}
+
+	if ((start = strstr(header, WS_PMD_HEADER)) == NULL) {
+		return WEBSOCKET_SUCCESS;
+	}
+	start += strlen(WS_PMD_HEADER);
+	if ((end = strstr(start, "\r\n")) == NULL) {
+		return WEBSOCKET_HANDSHAKE_ERROR;
+	}
+
+	/* Only one extension was offered, so the answer must be exactly it */
+
+	if (memchr(start, ',', end - start) != NULL || websocket_deflate_parse(start, end, &p) < 0 || p.client_bits < 0) {
+		WEBSOCKET_DEBUG("invalid permessage-deflate response\n");
+		return WEBSOCKET_HANDSHAKE_ERROR;
+	}
+
+	if (p.client_bits > 0 && p.client_bits < tx_bits) {
+		tx_bits = p.client_bits;
+	}
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE_LOCAL_NO_TAKEOVER
+	p.client_no_takeover = 1;
+#endif
+
+	return websocket_deflate_create(websocket, tx_bits, p.client_no_takeover, p.server_bits ? p.server_bits : WS_PMD_MAX_BITS, p.server_no_takeover);
+}
+
+int websocket_deflate_accept(websocket_t *websocket, const char *header, char *buf, size_t len)
+{
+	struct websocket_deflate_params_s p;
+	const char *start;
+	const char *end;
+	const char *next;
+	int tx_bits = WS_PMD_BITS;
+	int tx_no_takeover;
+	int rx_bits;
+	int rx_no_takeover;
+	int n;
+
+	websocket->deflate = NULL;
+	buf[0] = '\0';
+	if (!websocket->deflate_enabled || websocket->no_buffering) {
+		return WEBSOCKET_SUCCESS;
+	}
+
+	/* Take the first acceptable offer of the first extensions header */
+
+	if ((start = strstr(header, WS_PMD_HEADER)) == NULL) {
+		return WEBSOCKET_SUCCESS;
+	}
+	start += strlen(WS_PMD_HEADER);
+	if ((end = strstr(start, "\r\n")) == NULL) {
+		return WEBSOCKET_SUCCESS;
+	}
+	for (;; start = next + 1) {
+		next = memchr(start, ',', end - start);
+		if (next == NULL) {
+			next = end;
+		}
+		if (websocket_deflate_parse(start, next, &p) == 0) {
+			break;
+		}
+		if (next == end) {
+			return WEBSOCKET_SUCCESS;
+		}
+	}
+
+	if (p.server_bits > 0 && p.server_bits < tx_bits) {
+		tx_bits = p.server_bits;
+	}
+	tx_no_takeover = p.server_no_takeover;
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE_LOCAL_NO_TAKEOVER
+	tx_no_takeover = 1;
+#endif
+
+	/* A client that cannot shrink its window must reset it after every
+	 * message instead, so the receive side never needs more than our own
+	 * window size.
+	 */
+
+	rx_bits = WS_PMD_MAX_BITS;
+	if (p.client_bits != 0) {
+		rx_bits = p.client_bits > 0 && p.client_bits < WS_PMD_BITS ? p.client_bits : WS_PMD_BITS;
+	}
+	rx_no_takeover = p.client_no_takeover || rx_bits > WS_PMD_BITS;
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE_PEER_NO_TAKEOVER
+	rx_no_takeover = 1;
+#endif
+
+	n = snprintf(buf, len, WS_PMD_HEADER WS_PMD_EXTENSION "; server_max_window_bits=%d", tx_bits);
+	if (tx_no_takeover) {
+		n += snprintf(buf + n, len - n, "; server_no_context_takeover");
+	}
+	if (p.client_bits != 0) {
+		n += snprintf(buf + n, len - n, "; client_max_window_bits=%d", rx_bits);
+	}
+	if (rx_no_takeover) {
+		n += snprintf(buf + n, len - n, "; client_no_context_takeover");
+	}
+	n += snprintf(buf + n, len - n, "\r\n");
+	if ((size_t)n >= len) {
+		buf[0] = '\0';
+		return WEBSOCKET_SUCCESS;
+	}
+
+	if (websocket_deflate_create(websocket, tx_bits, tx_no_takeover, rx_bits, rx_no_takeover) != WEBSOCKET_SUCCESS) {
+		buf[0] = '\0';
+	}
+
+	return WEBSOCKET_SUCCESS;
+}
+
+void websocket_deflate_set_callbacks(websocket_t *websocket, websocket_cb_t *cb)
+{
+	websocket_cb_t deflate_cb = *cb;
+
+	websocket->deflate->on_msg_recv = cb->on_msg_recv_callback;
+	deflate_cb.on_msg_recv_callback = websocket_deflate_on_msg_recv;
+	wslay_event_config_set_callbacks(websocket->ctx, &deflate_cb);
+}
+
+void websocket_deflate_start(websocket_t *websocket)
+{
+	wslay_event_config_set_allowed_rsv_bits(websocket->ctx, WSLAY_RSV1_BIT);
+	websocket_deflate_set_callbacks(websocket, websocket->cb);
+}
+
+int websocket_deflate_queue_msg(websocket_t *websocket, websocket_frame_t *tx_frame)
+{
+	struct websocket_deflate_s *d = websocket->deflate;
+	struct websocket_bitout_s b;
+	websocket_frame_t frame;
+	int32_t wsize = (int32_t)1 << d->tx_bits;
+	int32_t *head;
+	uint16_t *prev;
+	uint8_t *in;
+	size_t hlen = d->tx_no_takeover ? 0 : d->tx_hlen;
+	size_t len = tx_frame->msg_length;
+	int r;
+
+	if (!WEBSOCKET_CHECK_NOT_CTRL_FRAME(tx_frame->opcode) || len < WS_PMD_MIN_LENGTH || len > WEBSOCKET_MAX_LENGTH_QUEUE) {
+		return wslay_event_queue_msg(websocket->ctx, tx_frame);
+	}
+
+	/* Hash heads, chain links, dictionary plus message, and the output */
+
+	head = malloc(WS_PMD_HASH_SIZE * sizeof(int32_t) + wsize * sizeof(uint16_t) + hlen + 2 * len);
+	if (head == NULL) {
+		return wslay_event_queue_msg(websocket->ctx, tx_frame);
+	}
+	prev = (uint16_t *)(head + WS_PMD_HASH_SIZE);
+	in = (uint8_t *)(prev + wsize);
+	if (hlen > 0) {
+		memcpy(in, d->tx_hist, hlen);
+	}
+	memcpy(in + hlen, tx_frame->msg, len);
+
+	memset(&b, 0, sizeof(b));
+	b.out = in + hlen + len;
+	b.max = len;
+	websocket_deflate_block(&b, in, hlen, hlen + len, wsize, head, prev);
+
+	if (b.pos >= len) {
+		free(head);
+		return wslay_event_queue_msg(websocket->ctx, tx_frame);
+	}
+
+	frame.opcode = tx_frame->opcode;
+	frame.msg = b.out;
+	frame.msg_length = b.pos;
+	r = wslay_event_queue_msg_ex(websocket->ctx, &frame, WSLAY_RSV1_BIT);
+	if (r == WEBSOCKET_SUCCESS && !d->tx_no_takeover) {
+		if (websocket_deflate_keep(&d->tx_hist, &d->tx_hlen, d->tx_bits, in, hlen + len) != WEBSOCKET_SUCCESS) {
+			/* The peer now expects this message in our window */
+			WEBSOCKET_DEBUG("fail to allocate memory for deflate window\n");
+			r = WEBSOCKET_ERR_NOMEM;
+		}
+	}
+
+	free(head);
+	return r;
+}
+
+void websocket_deflate_free(websocket_t *websocket)
+{
+	struct websocket_deflate_s *d = websocket->deflate;
+
+	if (d != NULL) {
+		free(d->tx_hist);
+		free(d->rx_hist);
+		free(d);
+		websocket->deflate = NULL;
+	}
+}
@@ -0,0 +1,59 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/// @file app/netutils/websocket/websocket_deflate.h
+/// @brief permessage-deflate (RFC 7692) extension used by websocket.c
+
+#ifndef __APPS_NETUTILS_WEBSOCKET_WEBSOCKET_DEFLATE_H
+#define __APPS_NETUTILS_WEBSOCKET_WEBSOCKET_DEFLATE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stddef.h>
+#include <apps/netutils/websocket.h>
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET_DEFLATE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Handshake.  The client appends websocket_deflate_offer() to its request
+ * and hands the server's response to websocket_deflate_confirm(); the
+ * server hands the request to websocket_deflate_accept(), which appends
+ * its answer to the response.  Both create websocket->deflate when the
+ * extension is agreed on and leave it NULL otherwise.
+ */
+
+int websocket_deflate_offer(websocket_t *websocket, char *buf, size_t len);
+int websocket_deflate_confirm(websocket_t *websocket, const char *header);
+int websocket_deflate_accept(websocket_t *websocket, const char *header, char *buf, size_t len);
+
+/* Hooks the negotiated state into a freshly initialized wslay context */
+
+void websocket_deflate_start(websocket_t *websocket);
+void websocket_deflate_set_callbacks(websocket_t *websocket, websocket_cb_t *cb);
+
+int websocket_deflate_queue_msg(websocket_t *websocket, websocket_frame_t *tx_frame);
+void websocket_deflate_free(websocket_t *websocket);
+
+#endif /* CONFIG_NETUTILS_WEBSOCKET_DEFLATE */
+#endif /* __APPS_NETUTILS_WEBSOCKET_WEBSOCKET_DEFLATE_H */
@@ -211,9 +211,12 @@ static int wslay_event_imsg_append_chunk(struct wslay_event_imsg *m, size_t len)
 	}
 }
 
+/* The payload is stored right after the message, in the same allocation,
+ * from where wslay_frame_send() frames it.
+ */
 static int wslay_event_omsg_non_fragmented_init(struct wslay_event_omsg **m, uint8_t opcode, uint8_t rsv, const uint8_t *msg, size_t msg_length)
 {
-	*m = (struct wslay_event_omsg *)malloc(sizeof(struct wslay_event_omsg));
+	*m = (struct wslay_event_omsg *)malloc(sizeof(struct wslay_event_omsg) + msg_length);
 	if (!*m) {
 		return WSLAY_ERR_NOMEM;
 	}
@@ -223,11 +226,7 @@ static int wslay_event_omsg_non_fragmented_init(struct wslay_event_omsg **m, uin
 	(*m)->rsv = rsv;
 	(*m)->type = WSLAY_NON_FRAGMENTED;
 	if (msg_length) {
-		(*m)->data = (uint8_t *)malloc(msg_length);
-		if (!(*m)->data) {
-			free(*m);
-			return WSLAY_ERR_NOMEM;
-		}
+		(*m)->data = (uint8_t *)(*m + 1);
 		memcpy((*m)->data, msg, msg_length);
 		(*m)->data_length = msg_length;
 	}
@@ -254,7 +253,6 @@ static void wslay_event_omsg_free(struct wslay_event_omsg *m)
 	if (!m) {
 		return;
 	}
-	free(m->data);
 	free(m);
 }
 
@@ -264,7 +262,16 @@ static uint8_t *wslay_event_flatten_queue(struct wslay_queue *queue, size_t len)
 		return NULL;
 	} else {
 		size_t off = 0;
-		uint8_t *buf = (uint8_t *)malloc(len);
+		uint8_t *buf;
+		struct wslay_event_byte_chunk *first = wslay_queue_top(queue);
+		if (first->data_length == len) {
+			/* Single frame message: hand over its buffer */
+			buf = first->data;
+			free(first);
+			wslay_queue_pop(queue);
+			return buf;
+		}
+		buf = (uint8_t *)malloc(len);
 		if (!buf) {
 			return NULL;
 		}
@@ -49,6 +49,31 @@
 
 #define wslay_min(A, B) (((A) < (B)) ? (A) : (B))
 
+/* XOR len bytes of src with the mask key into dst, which may be src.  off
+ * is the offset of the data in the payload.  Four bytes are masked at a
+ * time, the unaligned accesses are left to memcpy().
+ */
+static void wslay_frame_mask(uint8_t *dst, const uint8_t *src, size_t len, const uint8_t *maskkey, uint64_t off)
+{
+	uint8_t key[4];
+	uint32_t keyword;
+	uint32_t word;
+	size_t i;
+
+	for (i = 0; i < 4; ++i) {
+		key[i] = maskkey[(off + i) % 4];
+	}
+	memcpy(&keyword, key, 4);
+	for (i = 0; i + 4 <= len; i += 4) {
+		memcpy(&word, src + i, 4);
+		word ^= keyword;
+		memcpy(dst + i, &word, 4);
+	}
+	for (; i < len; ++i) {
+		dst[i] = src[i] ^ key[i % 4];
+	}
+}
+
 int wslay_frame_context_init(wslay_frame_context_ptr *ctx, const struct wslay_frame_callbacks *callbacks, void *user_data)
 {
 	*ctx = (wslay_frame_context_ptr)malloc(sizeof(struct wslay_frame_context));
@@ -121,44 +146,57 @@ ssize_t wslay_frame_send(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *i
 		ctx->opayloadoff = 0;
 	}
 	if (ctx->ostate == SEND_HEADER) {
-		ptrdiff_t len = ctx->oheaderlimit - ctx->oheadermark;
+		size_t hdlen = ctx->oheaderlimit - ctx->oheadermark;
+		size_t datalen = 0;
+		size_t len;
 		ssize_t r;
 		int flags = 0;
-		if (iocb->data_length > 0) {
+		/* The header goes out in the same write as the beginning of the
+		 * payload, masked on the way.  Unmasked payload is only copied
+		 * when all of it fits, otherwise it is sent from iocb->data.
+		 */
+		memcpy(ctx->obuf, ctx->oheadermark, hdlen);
+		if (ctx->omask) {
+			datalen = wslay_min(iocb->data_length, sizeof(ctx->obuf) - hdlen);
+			wslay_frame_mask(ctx->obuf + hdlen, iocb->data, datalen, ctx->omaskkey, ctx->opayloadoff);
+		} else if (iocb->data_length <= sizeof(ctx->obuf) - hdlen) {
+			datalen = iocb->data_length;
+			memcpy(ctx->obuf + hdlen, iocb->data, datalen);
+		}
+		if (iocb->data_length > datalen) {
 			flags |= WSLAY_MSG_MORE;
-		};
-		r = ctx->callbacks.send_callback(ctx->oheadermark, len, flags, ctx->user_data);
-		if (r > 0) {
-			if (r > len) {
-				return WSLAY_ERR_INVALID_CALLBACK;
-			} else {
-				ctx->oheadermark += r;
-				if (ctx->oheadermark == ctx->oheaderlimit) {
-					ctx->ostate = SEND_PAYLOAD;
-				} else {
-					return WSLAY_ERR_WANT_WRITE;
-				}
-			}
-		} else {
+		}
+		len = hdlen + datalen;
+		r = ctx->callbacks.send_callback(ctx->obuf, len, flags, ctx->user_data);
+		if (r <= 0) {
 			return WSLAY_ERR_WANT_WRITE;
+		} else if ((size_t)r > len) {
+			return WSLAY_ERR_INVALID_CALLBACK;
+		} else if ((size_t)r < hdlen) {
+			ctx->oheadermark += r;
+			return WSLAY_ERR_WANT_WRITE;
+		}
+		ctx->oheadermark = ctx->oheaderlimit;
+		ctx->ostate = SEND_PAYLOAD;
+		r -= hdlen;
+		if (r > 0 || iocb->data_length == 0) {
+			ctx->opayloadoff += r;
+			if (ctx->opayloadoff == ctx->opayloadlen) {
+				ctx->ostate = PREP_HEADER;
+			}
+			return r;
 		}
 	}
 	if (ctx->ostate == SEND_PAYLOAD) {
 		size_t totallen = 0;
 		if (iocb->data_length > 0) {
 			if (ctx->omask) {
-				uint8_t temp[4096];
 				const uint8_t *datamark = iocb->data, *datalimit = iocb->data + iocb->data_length;
 				while (datamark < datalimit) {
-					size_t datalen = datalimit - datamark;
-					const uint8_t *writelimit = datamark + wslay_min(sizeof(temp), datalen);
-					size_t writelen = writelimit - datamark;
+					size_t writelen = wslay_min(sizeof(ctx->obuf), (size_t)(datalimit - datamark));
 					ssize_t r;
-					size_t i;
-					for (i = 0; i < writelen; ++i) {
-						temp[i] = datamark[i] ^ ctx->omaskkey[(ctx->opayloadoff + i) % 4];
-					}
-					r = ctx->callbacks.send_callback(temp, writelen, 0, ctx->user_data);
+					wslay_frame_mask(ctx->obuf, datamark, writelen, ctx->omaskkey, ctx->opayloadoff);
+					r = ctx->callbacks.send_callback(ctx->obuf, writelen, 0, ctx->user_data);
 					if (r > 0) {
 						if ((size_t)r > writelen) {
 							return WSLAY_ERR_INVALID_CALLBACK;
@@ -318,13 +356,10 @@ ssize_t wslay_frame_recv(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *i
 		readmark = ctx->ibufmark;
 		readlimit = WSLAY_AVAIL_IBUF(ctx) < rempayloadlen ? ctx->ibuflimit : ctx->ibufmark + rempayloadlen;
 		if (ctx->imask) {
-			for (; ctx->ibufmark != readlimit; ++ctx->ibufmark, ++ctx->ipayloadoff) {
-				ctx->ibufmark[0] ^= ctx->imaskkey[ctx->ipayloadoff % 4];
-			}
-		} else {
-			ctx->ibufmark = readlimit;
-			ctx->ipayloadoff += readlimit - readmark;
+			wslay_frame_mask(readmark, readmark, readlimit - readmark, ctx->imaskkey, ctx->ipayloadoff);
 		}
+		ctx->ibufmark = readlimit;
+		ctx->ipayloadoff += readlimit - readmark;
 		iocb->fin = ctx->iom.fin;
 		iocb->rsv = ctx->iom.rsv;
 		iocb->opcode = ctx->iom.opcode;
@@ -82,6 +82,8 @@ struct wslay_frame_context {
 	uint8_t omask;
 	uint8_t omaskkey[4];
 	enum wslay_frame_state ostate;
+	/* The header and the masked payload being sent */
+	uint8_t obuf[4096];
 
 	struct wslay_frame_callbacks callbacks;
 	void *user_data;
@@ -24,6 +24,7 @@
 #include "common/ieee802_11_defs.h"
 #include "common/ieee802_11_common.h"
 #include "common/defs.h"
+#include "crypto/sha1.h"
 
 #include <stdio.h>
 #include <stdint.h>
@@ -106,6 +107,7 @@ void slsi_demo_app_sleep(int seconds, char *str)
 #define WPA_PARAM_KEY_MGMT_WPA_PSK      "key_mgmt WPA-PSK"
 #define WPA_PARAM_SSID                  "ssid "
 #define WPA_PARAM_SCAN_SSID             "scan_ssid "
+#define WPA_PARAM_SCAN_FREQ             "scan_freq "
 #define WPA_PARAM_BSSID                 "bssid "
 #define WPA_PARAM_PSK                   "psk "
 #define WPA_PARAM_WEPKEY                "wep_key0 "
@@ -288,6 +290,25 @@ static char *g_network_id = NULL;
 static uint8_t g_num_sta_connected = 0;
 static slsi_wifi_nv_data_t *g_slsi_wifi_nv_data;
 static char g_country_code[3] = { 0 };
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+/* The last network joined: the PSK derived from its passphrase and the
+ * channel it was found on, so joining it again needs neither the PBKDF2
+ * passphrase hashing nor a scan of every channel */
+#define SLSI_PMK_LEN            32
+#define SLSI_PBKDF2_ITERATIONS  4096
+
+typedef struct slsi_fast_connect {
+	uint8_t ssid[SLSI_SSID_LEN];
+	int ssid_len;
+	char bssid[18];
+	unsigned int freq;
+	char passphrase[SLSI_PASSPHRASE_LEN];
+	char psk[2 * SLSI_PMK_LEN + 1];
+	char scan_freq_network[8];	// network id with a scan_freq set, if any
+} slsi_fast_connect_t;
+
+static slsi_fast_connect_t g_fast_connect;
+#endif
 
 static void *nvram;
 
@@ -346,6 +367,13 @@ static char *sup_argv[6];
  */
 static int8_t slsi_api_start(WiFi_InterFace_ID_t interface_id, const slsi_ap_config_t *ap_config);
 static int8_t slsi_join_network(uint8_t *ssid, int ssid_len, uint8_t *bssid, const slsi_security_config_t *sec_config);
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+static void slsi_fast_connect_select(const uint8_t *ssid, int ssid_len);
+static const char *slsi_fast_connect_psk(const char *passphrase);
+static void slsi_fast_connect_scan_freq(const char *network_id, const uint8_t *bssid);
+static bool slsi_fast_connect_clear_scan_freq(void);
+static void slsi_fast_connect_save(const uint8_t *ssid, int ssid_len, const char *bssid);
+#endif
 static void slsi_wpa_reopen(void);
 static int8_t slsi_terminate_supplicant(void);
 static int8_t slsi_check_status(uint8_t *ssid, int8_t *ssid_len, char *bssid);
@@ -1349,10 +1377,20 @@ void slsi_monitor_thread_handler(void *param)
 						g_state = SLSI_WIFIAPI_STATE_STA_CONNECTED;
 						// connected so lets set scan interval back to limit power consumption
 						slsi_set_scan_interval(SLSI_SCAN_INTERVAL);
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+						slsi_fast_connect_clear_scan_freq();
+						slsi_fast_connect_save(reason.ssid, reason.ssid_len, reason.bssid);
+#endif
 						event_handled = TRUE;
 					} else if (slsi_event_recieved(result, WPA_EVENT_NETWORK_NOT_FOUND)) {
 						/* Assumed to be because network with specification setup is not
 						 * found in scan results - handle as error - disable network */
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+						if (slsi_fast_connect_clear_scan_freq()) {
+							// Not on the cached channel any more - retry on all channels
+							g_fast_connect.freq = 0;
+						} else
+#endif
 						if (join_count == SLSI_STA_JOIN_SCAN_ATTEMPT) {
 							reason.reason_code = SLSI_REASON_NETWORK_CONFIGURATION_NOT_FOUND;
 							event_handled = TRUE;
@@ -1374,6 +1412,9 @@ void slsi_monitor_thread_handler(void *param)
 							VPRINT("reason.reason_code=%d\n", reason.reason_code);
 							// Connection failed change back state
 							g_state = SLSI_WIFIAPI_STATE_SUPPLICANT_RUNNING;
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+							g_fast_connect.scan_freq_network[0] = '\0';
+#endif
 							if (g_network_id) {
 								slsi_remove_network(g_network_id);
 								free(g_network_id);
@@ -1732,7 +1773,9 @@ errout:
 	return result;
 }
 
-static int8_t slsi_set_security(const slsi_security_config_t *sec_config, const char *network_id)
+/* psk, if not NULL, is the hex PSK already derived from the passphrase and
+ * is handed to the supplicant in its place */
+static int8_t slsi_set_security(const slsi_security_config_t *sec_config, const char *network_id, const char *psk)
 {
 	int8_t result = SLSI_STATUS_SECURITY_FAILED;
 	// Set security for both AP mode and STA mode
@@ -1853,7 +1896,9 @@ static int8_t slsi_set_security(const slsi_security_config_t *sec_config, const
 				// wpa_key
 				VPRINT("SLSI_API set_security WPA key: %s\n", sec_config->passphrase);
 				// Validate length ascii (8 or 63)
-				if (len >= SLSI_WIFI_WPA_ASCII_KEY_MIN && len <= SLSI_WIFI_WPA_ASCII_KEY_MAX) {
+				if (len >= SLSI_WIFI_WPA_ASCII_KEY_MIN && len <= SLSI_WIFI_WPA_ASCII_KEY_MAX && psk != NULL) {
+					snprintf(command, WPA_COMMAND_MAX_SIZE, "%s%s %s%s", WPA_COMMAND_SET_NETWORK, network_id, WPA_PARAM_PSK, psk);
+				} else if (len >= SLSI_WIFI_WPA_ASCII_KEY_MIN && len <= SLSI_WIFI_WPA_ASCII_KEY_MAX) {
 					snprintf(command, WPA_COMMAND_MAX_SIZE, "%s%s %s\"%s\"", WPA_COMMAND_SET_NETWORK, network_id, WPA_PARAM_PSK, sec_config->passphrase);
 				} else {
 					DPRINT("SLSI_API set_security WPA - wrong key length\n");
@@ -2004,11 +2049,21 @@ static int8_t slsi_join_network(uint8_t *ssid, int ssid_len, uint8_t *bssid, con
 	int8_t result = SLSI_STATUS_ERROR;
 	char *pbuf = NULL;
 	char *network_id = NULL;
+	const char *psk = NULL;
 
 	VPRINT("SLSI_API join_network setup network with ssid %s\n", ssid);
 	if (sec_config) {
 		VPRINT("SLSI_API join_network setup network with security settings: " "security mode %d\n", sec_config->secmode);
 	}
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+	slsi_fast_connect_select(ssid, ssid_len);
+	if (sec_config && (sec_config->secmode & (SLSI_SEC_MODE_WPA_MIXED | SLSI_SEC_MODE_WPA2_MIXED))) {
+		size_t len = strnlen(sec_config->passphrase, SLSI_PASSPHRASE_LEN);
+		if (len >= SLSI_WIFI_WPA_ASCII_KEY_MIN && len <= SLSI_WIFI_WPA_ASCII_KEY_MAX) {
+			psk = slsi_fast_connect_psk(sec_config->passphrase);
+		}
+	}
+#endif
 	// Find network or add new network
 	result = slsi_get_network(ssid, ssid_len, &network_id);
 	if ((result != SLSI_STATUS_SUCCESS) && (network_id == NULL) /* Attempt to make SVACE happy */) {
@@ -2058,11 +2113,14 @@ static int8_t slsi_join_network(uint8_t *ssid, int ssid_len, uint8_t *bssid, con
 		}
 	}
 	// Set security
-	result = slsi_set_security(sec_config, network_id);
+	result = slsi_set_security(sec_config, network_id, psk);
 	if (result != SLSI_STATUS_SUCCESS) {
 		// remove network
 		slsi_send_command_str_upto_4(WPA_COMMAND_REMOVE_NETWORK, network_id, NULL, NULL, NULL);
 	} else {
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+		slsi_fast_connect_scan_freq(network_id, bssid);
+#endif
 		// Select network (and disable other networks)
 		g_state = SLSI_WIFIAPI_STATE_STA_CONNECTING;
 		slsi_set_scan_interval(SLSI_SCAN_INTERVAL_CONNECT); //set more agressive scan interval for connections
@@ -2087,6 +2145,105 @@ errout:
 	return result;
 }
 
+#ifdef CONFIG_SLSI_WIFI_FAST_CONNECT
+/* Start caching for the network being joined, dropping whatever was cached
+ * for another one */
+static void slsi_fast_connect_select(const uint8_t *ssid, int ssid_len)
+{
+	if (ssid_len <= 0 || ssid_len > SLSI_SSID_LEN) {
+		memset(&g_fast_connect, 0, sizeof(slsi_fast_connect_t));
+		return;
+	}
+	if (g_fast_connect.ssid_len != ssid_len || memcmp(g_fast_connect.ssid, ssid, ssid_len) != 0) {
+		memset(&g_fast_connect, 0, sizeof(slsi_fast_connect_t));
+		memcpy(g_fast_connect.ssid, ssid, ssid_len);
+		g_fast_connect.ssid_len = ssid_len;
+	}
+}
+
+/* The WPA PSK of the selected network as 64 hex digits.  Deriving it takes
+ * 4096 rounds of PBKDF2-SHA1, which is done once per ssid and passphrase
+ * instead of by the supplicant on every join */
+static const char *slsi_fast_connect_psk(const char *passphrase)
+{
+	uint8_t pmk[SLSI_PMK_LEN];
+
+	if (g_fast_connect.ssid_len == 0) {
+		return NULL;
+	}
+	if (g_fast_connect.psk[0] != '\0' && strncmp(g_fast_connect.passphrase, passphrase, SLSI_PASSPHRASE_LEN) == 0) {
+		VPRINT("SLSI_API fast_connect using cached psk\n");
+		return g_fast_connect.psk;
+	}
+	if (pbkdf2_sha1(passphrase, g_fast_connect.ssid, g_fast_connect.ssid_len, SLSI_PBKDF2_ITERATIONS, pmk, SLSI_PMK_LEN) != 0) {
+		g_fast_connect.psk[0] = '\0';
+		return NULL;
+	}
+	wpa_snprintf_hex(g_fast_connect.psk, sizeof(g_fast_connect.psk), pmk, SLSI_PMK_LEN);
+	strncpy(g_fast_connect.passphrase, passphrase, SLSI_PASSPHRASE_LEN - 1);
+	memset(pmk, 0, sizeof(pmk));
+	return g_fast_connect.psk;
+}
+
+/* Limit the connect scan to the channel the network was last found on.  A
+ * bssid given by the caller must match the cached one */
+static void slsi_fast_connect_scan_freq(const char *network_id, const uint8_t *bssid)
+{
+	int8_t result = SLSI_STATUS_ERROR;
+	char freq[12];
+
+	g_fast_connect.scan_freq_network[0] = '\0';
+	if (g_fast_connect.freq == 0) {
+		return;
+	}
+	if (bssid != NULL && bssid[0] != '\0' && strncasecmp((const char *)bssid, g_fast_connect.bssid, 17) != 0) {
+		return;
+	}
+	snprintf(freq, sizeof(freq), "%u", g_fast_connect.freq);
+	slsi_send_command_str_upto_4(WPA_COMMAND_SET_NETWORK, (char *)network_id, WPA_PARAM_SCAN_FREQ, freq, &result);
+	if (result == SLSI_STATUS_SUCCESS) {
+		VPRINT("SLSI_API fast_connect scanning %s MHz only\n", freq);
+		strncpy(g_fast_connect.scan_freq_network, network_id, sizeof(g_fast_connect.scan_freq_network) - 1);
+	}
+}
+
+/* Let the supplicant scan every channel again, for roaming and for a retry
+ * when the network has moved.  Returns TRUE if a scan_freq was set */
+static bool slsi_fast_connect_clear_scan_freq(void)
+{
+	if (g_fast_connect.scan_freq_network[0] == '\0') {
+		return FALSE;
+	}
+	slsi_send_command_str_upto_4(WPA_COMMAND_SET_NETWORK, g_fast_connect.scan_freq_network, WPA_PARAM_SCAN_FREQ, "0", NULL);
+	g_fast_connect.scan_freq_network[0] = '\0';
+	return TRUE;
+}
+
+/* Remember the BSS the selected network was joined on */
+static void slsi_fast_connect_save(const uint8_t *ssid, int ssid_len, const char *bssid)
+{
+	char command[WPA_COMMAND_MAX_SIZE] = { 0 };
+	char *pbuf;
+	char *pos;
+
+	if (g_fast_connect.ssid_len == 0 || g_fast_connect.ssid_len != ssid_len || memcmp(g_fast_connect.ssid, ssid, ssid_len) != 0) {
+		return;
+	}
+	snprintf(command, WPA_COMMAND_MAX_SIZE, "%s", WPA_COMMAND_STATUS);
+	pbuf = slsi_send_request(command, NULL);
+	if (pbuf == NULL) {
+		return;
+	}
+	pos = strstr(pbuf, WPA_VALUE_FREQ);
+	if (pos != NULL) {
+		g_fast_connect.freq = (unsigned int)strtoul(pos + strlen(WPA_VALUE_FREQ), NULL, 10);
+		memcpy(g_fast_connect.bssid, bssid, sizeof(g_fast_connect.bssid) - 1);
+		VPRINT("SLSI_API fast_connect saved %s at %u MHz\n", g_fast_connect.bssid, g_fast_connect.freq);
+	}
+	free(pbuf);
+}
+#endif
+
 static void slsi_set_bss_expiration(void)
 {
 	slsi_send_command_str_digit(WPA_COMMAND_BSS_EXPIRE_AGE, SLSI_BSS_EXPIRE_AGE);
@@ -2222,7 +2379,7 @@ static int8_t slsi_set_ap_network(slsi_ap_config_t *ap_config)
 		}
 
 		// Set security
-		result = slsi_set_security(ap_config->security, network_id);
+		result = slsi_set_security(ap_config->security, network_id, NULL);
 		if (SLSI_WIFI_API_DEBUG_SLEEP) {
 			slsi_demo_app_sleep(1, "security set");
 		}
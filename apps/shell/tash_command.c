@@ -22,7 +22,13 @@
 #include <tinyara/config.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <sched.h>
 #include <sys/types.h>
+#include <sys/prctl.h>
 #include <sys/boardctl.h>
 #include <apps/shell/tash.h>
 #include "tash_internal.h"
@@ -49,6 +55,13 @@
 #define TASH_CMDTASK_PRIORITY		(SCHED_PRIORITY_DEFAULT)
 #endif
 #define TASH_CMDS_PER_LINE			(4)
+#ifdef CONFIG_TASH_CMDTASK_POOLSIZE
+#define TASH_CMDTASK_POOLSIZE		CONFIG_TASH_CMDTASK_POOLSIZE
+#else
+#define TASH_CMDTASK_POOLSIZE		(0)
+#endif
+#define TASH_WORKER_MAXARGS			(32) /* same as TASH_TOKEN_MAX */
+#define TASH_WORKER_ARGBUFLEN		(128) /* same as TASH_LINEBUFLEN */
 
 /****************************************************************************
  * Global Variables
@@ -68,6 +81,7 @@ struct tash_cmd_s {
 	char str[TASH_CMD_MAXSTRLENGTH];	/* Command strings- eg, ifconfig */
 	TASH_CMD_CALLBACK cb;				/* Function pointer for Callback */
 	int exec_type;						/* Execution type of this command */
+	int taskinfo;						/* Index in tash_taskinfo_list, or -1 */
 };
 
 struct tash_cmd_info_s {
@@ -76,6 +90,22 @@ struct tash_cmd_info_s {
 	int count;									/* Number of TASH commands */
 };
 
+#if TASH_CMDTASK_POOLSIZE > 0
+/**
+ * @brief A pre-started task that runs ASYNC commands, so that launching one
+ * does not create a task each time
+ */
+struct tash_worker_s {
+	sem_t wait;							/* Posted when a command is handed over */
+	volatile bool busy;					/* Running a command */
+	pid_t pid;							/* Worker task, or -1 if not started */
+	TASH_CMD_CALLBACK cb;				/* Command to run */
+	int argc;
+	char *argv[TASH_WORKER_MAXARGS];	/* Points into argbuf */
+	char argbuf[TASH_WORKER_ARGBUFLEN];	/* Copy of the argument strings */
+};
+#endif
+
 /********************************************************************************
  * Private Function Prototypes
  ********************************************************************************/
@@ -91,8 +121,10 @@ extern tash_taskinfo_t tash_taskinfo_list[];
  * Private Variables
  ****************************************************************************/
 
-static int is_sorted_list = FALSE;
 static struct tash_cmd_info_s tash_cmds_info = {PTHREAD_MUTEX_INITIALIZER};
+#if TASH_CMDTASK_POOLSIZE > 0
+static struct tash_worker_s tash_workers[TASH_CMDTASK_POOLSIZE];
+#endif
 
 const static tash_cmdlist_t tash_basic_cmds[] = {
 	{"exit",  tash_exit,   TASH_EXECMD_SYNC},
@@ -113,27 +145,52 @@ const static tash_cmdlist_t tash_basic_cmds[] = {
  * Private Functions
  ****************************************************************************/
 
-static void tash_sort_cmds(void)
+/** @brief Binary search of the command table, which is kept sorted
+ *  @ingroup tash
+ *  @return index of the command, or -1 with the index to insert it at in *pos
+ */
+static int tash_search_cmd(const char *str, int *pos)
 {
-	int i;
-	int j;
-	int length = tash_cmds_info.count;
-	int gap = tash_cmds_info.count;
-	struct tash_cmd_s temp;
-	int tash_cmd_size = sizeof(struct tash_cmd_s);
-
-	while (gap > 1) {
-		/* gap = max(floor(gap * 5 / 11), 1) */
-
-		gap = (gap * 5 / 11) > 1 ? (gap * 5 / 11) : 1;
-		for (i = gap; i < length; i++) {
-			memcpy(&temp, &tash_cmds_info.cmd[i], tash_cmd_size);
-			for (j = i; j >= gap && (strcmp(temp.str, tash_cmds_info.cmd[j - gap].str) < 0); j -= gap) {
-				memcpy(&tash_cmds_info.cmd[j], &tash_cmds_info.cmd[j - gap], tash_cmd_size);
-			}
-			memcpy(&tash_cmds_info.cmd[j], &temp, tash_cmd_size);
+	int low = 0;
+	int high = tash_cmds_info.count - 1;
+	int mid;
+	int cmp;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+		cmp = strncmp(str, tash_cmds_info.cmd[mid].str, TASH_CMD_MAXSTRLENGTH - 1);
+		if (cmp == 0) {
+			return mid;
+		} else if (cmp < 0) {
+			high = mid - 1;
+		} else {
+			low = mid + 1;
 		}
 	}
+
+	if (pos) {
+		*pos = low;
+	}
+
+	return -1;
+}
+
+/** @brief Find the builtin task information of a command, looked up once at install
+ *  @ingroup tash
+ */
+static int tash_find_taskinfo(const char *str)
+{
+#if defined(CONFIG_BUILTIN_APPS)
+	int idx;
+
+	for (idx = 0; tash_taskinfo_list[idx].str != NULL; idx++) {
+		if (!(strncmp(str, tash_taskinfo_list[idx].str, TASH_CMD_MAXSTRLENGTH - 1))) {
+			return idx;
+		}
+	}
+#endif
+
+	return -1;
 }
 
 /** @brief Help function in TASH to list all available commands
@@ -146,11 +203,6 @@ static int tash_help(int argc, char **args)
 	printf("\t TASH command list \n");
 	printf("\t --------------------\n");
 
-	if (is_sorted_list == FALSE) {
-		tash_sort_cmds();
-		is_sorted_list = TRUE;
-	}
-
 	for (cmd_idx = 0; cmd_idx < tash_cmds_info.count; cmd_idx++) {
 		printf("%-16s ", tash_cmds_info.cmd[cmd_idx].str);
 		if (cmd_idx % TASH_CMDS_PER_LINE == (TASH_CMDS_PER_LINE - 1)) {
@@ -190,29 +242,107 @@ static int tash_reboot(int argc, char **argv)
 }
 #endif /* CONFIG_BOARDCTL_RESET */
 
+#if TASH_CMDTASK_POOLSIZE > 0
+/** @brief Entry of a pool worker: run the commands handed over by tash_launch_cmdtask
+ *  @ingroup tash
+ */
+static int tash_worker_main(int argc, char **args)
+{
+	struct tash_worker_s *worker = &tash_workers[atoi(args[1])];
+
+	for (;;) {
+		while (sem_wait(&worker->wait) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		prctl(PR_SET_NAME, worker->argv[0], 0);
+		(void)worker->cb(worker->argc, worker->argv);
+		prctl(PR_SET_NAME, "tash_worker", 0);
+
+		worker->busy = false;
+	}
+
+	return 0;
+}
+
+/** @brief Hand an ASYNC command over to an idle pool worker
+ *  @ingroup tash
+ *  @return 0 on success, -1 if no worker is idle or the arguments do not fit
+ */
+static int tash_dispatch_worker(TASH_CMD_CALLBACK cb, int argc, char **args, int pri)
+{
+	struct tash_worker_s *worker = NULL;
+	struct sched_param param;
+	size_t used = 0;
+	size_t len;
+	int idx;
+
+	if (argc >= TASH_WORKER_MAXARGS) {
+		return -1;
+	}
+
+	for (idx = 0; idx < TASH_CMDTASK_POOLSIZE; idx++) {
+		if (tash_workers[idx].pid >= 0 && !tash_workers[idx].busy) {
+			worker = &tash_workers[idx];
+			break;
+		}
+	}
+
+	if (worker == NULL) {
+		return -1;
+	}
+
+	for (idx = 0; idx < argc; idx++) {
+		len = strlen(args[idx]) + 1;
+		if (used + len > TASH_WORKER_ARGBUFLEN) {
+			return -1;
+		}
+
+		worker->argv[idx] = &worker->argbuf[used];
+		memcpy(worker->argv[idx], args[idx], len);
+		used += len;
+	}
+
+	worker->argv[argc] = NULL;
+	worker->argc = argc;
+	worker->cb = cb;
+	worker->busy = true;
+
+	param.sched_priority = pri;
+	sched_setparam(worker->pid, &param);
+
+	sem_post(&worker->wait);
+	return 0;
+}
+#endif
+
 /** @brief Launch a task to run tash cmd asynchronously
  *  @ingroup tash
  */
-static int tash_launch_cmdtask(TASH_CMD_CALLBACK cb, int argc, char **args)
+static int tash_launch_cmdtask(struct tash_cmd_s *cmd, int argc, char **args)
 {
 	int ret = 0;
 	int pri = TASH_CMDTASK_PRIORITY;
 	long stack_size = TASH_CMDTASK_STACKSIZE;
+
 #if defined(CONFIG_BUILTIN_APPS)
-	int cmd_idx;
+	if (cmd->taskinfo >= 0) {
+		pri = tash_taskinfo_list[cmd->taskinfo].task_prio;
+		stack_size = tash_taskinfo_list[cmd->taskinfo].task_stacksize;
+	}
+#endif
 
-	for (cmd_idx = 0; (cmd_idx < tash_cmds_info.count) && (tash_taskinfo_list[cmd_idx].str != NULL); cmd_idx++) {
-		if (!(strncmp(args[0], tash_taskinfo_list[cmd_idx].str, TASH_CMD_MAXSTRLENGTH - 1))) {
-			pri = tash_taskinfo_list[cmd_idx].task_prio;
-			stack_size = tash_taskinfo_list[cmd_idx].task_stacksize;
-			break;
-		}
+#if TASH_CMDTASK_POOLSIZE > 0
+	/* The workers have TASH_CMDTASK_STACKSIZE; bigger stacks need their own task */
+
+	if (stack_size <= TASH_CMDTASK_STACKSIZE && tash_dispatch_worker(cmd->cb, argc, args, pri) == 0) {
+		return 0;
 	}
 #endif
 
-	printf("Command will be launched with pri (%d), stack size(%d)\n", pri, stack_size);
+	printf("Command will be launched with pri (%d), stack size(%ld)\n", pri, stack_size);
 
-	ret = task_create(args[0], pri, stack_size, cb, &args[1]);
+	ret = task_create(args[0], pri, stack_size, cmd->cb, &args[1]);
 
 	return ret;
 }
@@ -226,38 +356,35 @@ static int tash_launch_cmdtask(TASH_CMD_CALLBACK cb, int argc, char **args)
  */
 int tash_execute_cmd(char **args, int argc)
 {
+	struct tash_cmd_s cmd;
 	int cmd_idx;
-	int cmd_found = 0;
 
 	/* lock mutex */
 	pthread_mutex_lock(&tash_cmds_info.tmutex);
 
-	for (cmd_idx = 0; cmd_idx < tash_cmds_info.count; cmd_idx++) {
-		cmd_found = (strncmp(args[0], tash_cmds_info.cmd[cmd_idx].str, TASH_CMD_MAXSTRLENGTH - 1) == 0) ? 1 : 0;
-		if (cmd_found) {
-				/* unlock mutex before executing */
-				pthread_mutex_unlock(&tash_cmds_info.tmutex);
-
-			if (tash_cmds_info.cmd[cmd_idx].exec_type == TASH_EXECMD_SYNC) {
-				/* function call to execute SYNC command */
-				(*tash_cmds_info.cmd[cmd_idx].cb) (argc, args);
-			} else if (tash_cmds_info.cmd[cmd_idx].exec_type == TASH_EXECMD_ASYNC) {
-				/* launch a task to execute ASYNC command */
-				if (tash_launch_cmdtask(tash_cmds_info.cmd[cmd_idx].cb, argc, args)) {
-					shdbg("TASH: error in command task launch \n");
-				}
-			} else {
-				shdbg("TASH: cmd (%s) has wrong value on exec type\n", args[0]);
-			}
-			break;
-		}						/* cmd_found */
-	}							/* for */
-
-	if (!cmd_found) {
+	cmd_idx = tash_search_cmd(args[0], NULL);
+	if (cmd_idx < 0) {
 		/* unlock mutex */
 		pthread_mutex_unlock(&tash_cmds_info.tmutex);
 
 		printf("TASH: cmd (%s) not registered\n", args[0]);
+		return 0;
+	}
+
+	/* copy the entry and unlock mutex before executing */
+	memcpy(&cmd, &tash_cmds_info.cmd[cmd_idx], sizeof(struct tash_cmd_s));
+	pthread_mutex_unlock(&tash_cmds_info.tmutex);
+
+	if (cmd.exec_type == TASH_EXECMD_SYNC) {
+		/* function call to execute SYNC command */
+		(*cmd.cb) (argc, args);
+	} else if (cmd.exec_type == TASH_EXECMD_ASYNC) {
+		/* launch a task to execute ASYNC command */
+		if (tash_launch_cmdtask(&cmd, argc, args) < 0) {
+			shdbg("TASH: error in command task launch \n");
+		}
+	} else {
+		shdbg("TASH: cmd (%s) has wrong value on exec type\n", args[0]);
 	}
 
 	return 0;					/* Need to pass the appropriate error later */
@@ -280,6 +407,7 @@ int tash_execute_cmd(char **args, int argc)
  */
 int tash_cmd_install(const char *str, TASH_CMD_CALLBACK cb, int thread_exec)
 {
+	struct tash_cmd_s *cmd;
 	int cmd_idx;
 
 	if (TASH_MAX_COMMANDS == tash_cmds_info.count) {
@@ -289,26 +417,28 @@ int tash_cmd_install(const char *str, TASH_CMD_CALLBACK cb, int thread_exec)
 	/* Lock mutex */
 	pthread_mutex_lock(&tash_cmds_info.tmutex);
 
-	/* CHeck if cmd is already installed */
-	for (cmd_idx = 0; cmd_idx < tash_cmds_info.count; cmd_idx++) {
-		if (strncmp(str, tash_cmds_info.cmd[cmd_idx].str, TASH_CMD_MAXSTRLENGTH - 1) == 0) {
-			pthread_mutex_unlock(&tash_cmds_info.tmutex);
-			return -2;			/* CMD already installed */
-		}
+	/* CHeck if cmd is already installed, and where it goes to keep the table sorted */
+	if (tash_search_cmd(str, &cmd_idx) >= 0) {
+		pthread_mutex_unlock(&tash_cmds_info.tmutex);
+		return -2;				/* CMD already installed */
 	}
 
-	/* store command string - no need of explicit NULL termination */
-	strncpy(tash_cmds_info.cmd[tash_cmds_info.count].str, str, TASH_CMD_MAXSTRLENGTH - 1);
+	memmove(&tash_cmds_info.cmd[cmd_idx + 1], &tash_cmds_info.cmd[cmd_idx], (tash_cmds_info.count - cmd_idx) * sizeof(struct tash_cmd_s));
+	cmd = &tash_cmds_info.cmd[cmd_idx];
+
+	/* store command string - explicit NULL termination as the slot is reused */
+	strncpy(cmd->str, str, TASH_CMD_MAXSTRLENGTH - 1);
+	cmd->str[TASH_CMD_MAXSTRLENGTH - 1] = '\0';
 	/* store callback */
-	tash_cmds_info.cmd[tash_cmds_info.count].cb = cb;
+	cmd->cb = cb;
 	/* store thread_exec flags */
-	tash_cmds_info.cmd[tash_cmds_info.count].exec_type = thread_exec;
+	cmd->exec_type = thread_exec;
+	/* look up the task priority and stack size of ASYNC builtins once */
+	cmd->taskinfo = (thread_exec == TASH_EXECMD_ASYNC) ? tash_find_taskinfo(str) : -1;
 	/* Increment command count value */
 	tash_cmds_info.count++;
 	pthread_mutex_unlock(&tash_cmds_info.tmutex);
 
-	is_sorted_list = FALSE;
-
 	return 0;
 }
 
@@ -336,6 +466,36 @@ void tash_register_basic_cmds(void)
 	tash_cmdlist_install(tash_basic_cmds);
 }
 
+#if TASH_CMDTASK_POOLSIZE > 0
+/** @brief Start the workers that run ASYNC commands. They inherit the
+ *  standard streams of TASH, so this runs once the console is set up.
+ *  @ingroup tash
+ */
+void tash_start_cmdtask_pool(void)
+{
+	char idxstr[4];
+	char *args[2];
+	int idx;
+
+	args[0] = idxstr;
+	args[1] = NULL;
+
+	for (idx = 0; idx < TASH_CMDTASK_POOLSIZE; idx++) {
+		struct tash_worker_s *worker = &tash_workers[idx];
+
+		sem_init(&worker->wait, 0, 0);
+		worker->busy = false;
+
+		snprintf(idxstr, sizeof(idxstr), "%d", idx);
+		worker->pid = task_create("tash_worker", TASH_CMDTASK_PRIORITY, TASH_CMDTASK_STACKSIZE, tash_worker_main, args);
+		if (worker->pid < 0) {
+			shdbg("TASH: failed to start command worker %d\n", idx);
+			worker->pid = -1;
+		}
+	}
+}
+#endif
+
 #if defined(CONFIG_TASH_COMMAND_INTERFACE)
 /** @name tash_get_cmdscount
  * @brief API to get the number of registered tash commands.
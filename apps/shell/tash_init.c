@@ -134,6 +134,9 @@ int tash_init(void)
 		ret = ERROR;
 	}
 #endif
+#if defined(CONFIG_TASH_CMDTASK_POOLSIZE) && CONFIG_TASH_CMDTASK_POOLSIZE > 0
+	tash_start_cmdtask_pool();
+#endif
 
 	return ret;
 }
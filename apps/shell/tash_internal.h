@@ -54,6 +54,9 @@
 #endif							/* CONFIG_CPP_HAVE_VARARGS */
 
 extern void tash_register_basic_cmds(void);
+#if defined(CONFIG_TASH_CMDTASK_POOLSIZE) && CONFIG_TASH_CMDTASK_POOLSIZE > 0
+extern void tash_start_cmdtask_pool(void);
+#endif
 extern int tash_execute_cmdline(char *buff);
 extern int tash_execute_cmd(char **args, int argc);
 extern int tash_init(void);
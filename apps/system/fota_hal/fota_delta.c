@@ -0,0 +1,424 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+#include <crc32.h>
+#include <apps/system/fota_hal.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Patch layout, all numbers little endian:
+ *
+ *   8 bytes  : magic "FOTADLT1"
+ *   4 bytes  : size of the running image the patch was made against
+ *   4 bytes  : crc32() of that image (no pre/post inversion)
+ *   4 bytes  : size of the new image
+ *   4 bytes  : crc32() of the new image
+ *   N bytes  : LZSS compressed body
+ *
+ * The body decompresses to bsdiff style records, repeated until the whole
+ * new image is produced:
+ *
+ *   4 bytes  : diff length (>= 0)
+ *   4 bytes  : extra length (>= 0)
+ *   4 bytes  : seek in the old image after the diff bytes (signed)
+ *   diff length bytes  : added (mod 256) to the old image bytes
+ *   extra length bytes : copied to the new image as is
+ *
+ * LZSS: a flag byte announces eight items, LSB first.  A set bit is a
+ * literal byte, a clear bit a 2 byte match b0 b1 copying
+ * (b1 & 0x0f) + 3 bytes from ((b1 & 0xf0) << 4 | b0) + 1 bytes back.
+ */
+#define DELTA_MAGIC			"FOTADLT1"
+#define DELTA_MAGIC_LEN		8
+#define DELTA_HEADER_LEN	24
+#define DELTA_CTRL_LEN		12
+
+#define LZSS_WINDOW			4096
+#define LZSS_MIN_MATCH		3
+
+/****************************************************************************
+ * Private Type
+ ****************************************************************************/
+enum delta_lzss_state_e {
+	LZSS_FLAGS,
+	LZSS_ITEM,
+	LZSS_MATCH,
+};
+
+enum delta_rec_state_e {
+	DELTA_CTRL,
+	DELTA_DIFF,
+	DELTA_EXTRA,
+};
+
+struct fotahal_delta_s {
+	fotahal_handle_t handle;
+
+	/* Running image, read in place */
+	const uint8_t *old;
+	uint32_t old_size;
+	uint32_t old_pos;
+
+	/* New image */
+	uint32_t new_size;
+	uint32_t new_crc;
+	uint32_t new_pos;
+	uint32_t crc;
+
+	uint8_t header[DELTA_HEADER_LEN];
+	uint32_t header_len;
+
+	/* LZSS decoder */
+	enum delta_lzss_state_e lzss_state;
+	uint8_t flags;
+	int nflags;
+	uint8_t match0;
+	uint32_t wpos;
+	bool wfull;
+	uint8_t window[LZSS_WINDOW];
+
+	/* bsdiff records */
+	enum delta_rec_state_e rec_state;
+	uint8_t ctrl[DELTA_CTRL_LEN];
+	uint32_t ctrl_len;
+	uint32_t diff_left;
+	uint32_t extra_left;
+	int32_t seek;
+
+	fotahal_return_t result;
+	uint32_t out_len;
+	char out[CONFIG_SYSTEM_FOTA_HAL_DELTA_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static struct fotahal_delta_s *g_delta;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static uint32_t delta_get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static fotahal_return_t delta_flush(struct fotahal_delta_s *delta)
+{
+	fotahal_return_t ret = FOTAHAL_RETURN_SUCCESS;
+
+	if (delta->out_len > 0) {
+		ret = fotahal_write(delta->handle, delta->out, delta->out_len);
+		delta->out_len = 0;
+	}
+
+	return ret;
+}
+
+static fotahal_return_t delta_output(struct fotahal_delta_s *delta, uint8_t ch)
+{
+	if (delta->new_pos >= delta->new_size) {
+		return FOTAHAL_RETURN_WRONGSIZE;
+	}
+
+	delta->out[delta->out_len++] = (char)ch;
+	delta->new_pos++;
+
+	if (delta->out_len == sizeof(delta->out)) {
+		delta->crc = crc32part((const uint8_t *)delta->out, delta->out_len, delta->crc);
+		return delta_flush(delta);
+	}
+
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+/* Consume one byte of the decompressed body */
+static fotahal_return_t delta_record(struct fotahal_delta_s *delta, uint8_t ch)
+{
+	switch (delta->rec_state) {
+	case DELTA_CTRL:
+		delta->ctrl[delta->ctrl_len++] = ch;
+		if (delta->ctrl_len < DELTA_CTRL_LEN) {
+			return FOTAHAL_RETURN_SUCCESS;
+		}
+
+		delta->ctrl_len = 0;
+		delta->diff_left = delta_get_le32(&delta->ctrl[0]);
+		delta->extra_left = delta_get_le32(&delta->ctrl[4]);
+		delta->seek = (int32_t)delta_get_le32(&delta->ctrl[8]);
+
+		if ((int32_t)delta->diff_left < 0 || (int32_t)delta->extra_left < 0 ||
+			delta->diff_left > delta->old_size - delta->old_pos ||
+			delta->diff_left + delta->extra_left > delta->new_size - delta->new_pos) {
+			dbg("%s: corrupted control record\n", __func__);
+			return FOTAHAL_RETURN_WRONGBIN;
+		}
+		break;
+
+	case DELTA_DIFF:
+		delta->diff_left--;
+		return delta_output(delta, ch + delta->old[delta->old_pos++]);
+
+	case DELTA_EXTRA:
+		delta->extra_left--;
+		return delta_output(delta, ch);
+	}
+
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+/* Move to the part of the record the next byte belongs to */
+static fotahal_return_t delta_next(struct fotahal_delta_s *delta)
+{
+	int64_t pos;
+
+	if (delta->rec_state == DELTA_CTRL && delta->ctrl_len == 0) {
+		delta->rec_state = DELTA_DIFF;
+	}
+
+	if (delta->rec_state == DELTA_DIFF && delta->diff_left == 0) {
+		delta->rec_state = DELTA_EXTRA;
+	}
+
+	if (delta->rec_state == DELTA_EXTRA && delta->extra_left == 0) {
+		pos = (int64_t)delta->old_pos + delta->seek;
+		if (pos < 0 || pos > delta->old_size) {
+			dbg("%s: seek out of the old image\n", __func__);
+			return FOTAHAL_RETURN_WRONGBIN;
+		}
+		delta->old_pos = (uint32_t)pos;
+		delta->seek = 0;
+		delta->rec_state = DELTA_CTRL;
+	}
+
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+static fotahal_return_t delta_emit(struct fotahal_delta_s *delta, uint8_t ch)
+{
+	fotahal_return_t ret;
+
+	delta->window[delta->wpos] = ch;
+	delta->wpos = (delta->wpos + 1) % LZSS_WINDOW;
+	if (delta->wpos == 0) {
+		delta->wfull = true;
+	}
+
+	ret = delta_record(delta, ch);
+	if (ret == FOTAHAL_RETURN_SUCCESS) {
+		ret = delta_next(delta);
+	}
+
+	return ret;
+}
+
+/* Consume one byte of the compressed body */
+static fotahal_return_t delta_lzss(struct fotahal_delta_s *delta, uint8_t ch)
+{
+	fotahal_return_t ret = FOTAHAL_RETURN_SUCCESS;
+	uint32_t dist;
+	uint32_t len;
+
+	switch (delta->lzss_state) {
+	case LZSS_FLAGS:
+		delta->flags = ch;
+		delta->nflags = 8;
+		delta->lzss_state = LZSS_ITEM;
+		return ret;
+
+	case LZSS_ITEM:
+		if (delta->flags & 1) {
+			ret = delta_emit(delta, ch);
+			break;
+		}
+		delta->match0 = ch;
+		delta->lzss_state = LZSS_MATCH;
+		return ret;
+
+	case LZSS_MATCH:
+		dist = (((uint32_t)ch & 0xf0) << 4 | delta->match0) + 1;
+		len = (ch & 0x0f) + LZSS_MIN_MATCH;
+		if (!delta->wfull && dist > delta->wpos) {
+			dbg("%s: match before the start of the body\n", __func__);
+			return FOTAHAL_RETURN_WRONGBIN;
+		}
+		while (len-- > 0 && ret == FOTAHAL_RETURN_SUCCESS) {
+			ret = delta_emit(delta, delta->window[(delta->wpos + LZSS_WINDOW - dist) % LZSS_WINDOW]);
+		}
+		break;
+	}
+
+	/* Next item, or a new flag byte once all eight are used */
+	delta->flags >>= 1;
+	if (--delta->nflags == 0) {
+		delta->lzss_state = LZSS_FLAGS;
+	} else {
+		delta->lzss_state = LZSS_ITEM;
+	}
+
+	return ret;
+}
+
+static fotahal_return_t delta_header(struct fotahal_delta_s *delta)
+{
+	uint32_t old_size = delta_get_le32(&delta->header[8]);
+	uint32_t old_crc = delta_get_le32(&delta->header[12]);
+
+	if (memcmp(delta->header, DELTA_MAGIC, DELTA_MAGIC_LEN) != 0) {
+		dbg("%s: not a delta patch\n", __func__);
+		return FOTAHAL_RETURN_WRONGMAGIC;
+	}
+
+	/* The patch only applies to the image it was made against */
+	if (old_size > delta->old_size) {
+		dbg("%s: running image is smaller than the patch base\n", __func__);
+		return FOTAHAL_RETURN_WRONGSIZE;
+	}
+
+	if (crc32(delta->old, old_size) != old_crc) {
+		dbg("%s: running image is not the patch base\n", __func__);
+		return FOTAHAL_RETURN_CHECKSUMFAIL;
+	}
+
+	delta->old_size = old_size;
+	delta->new_size = delta_get_le32(&delta->header[16]);
+	delta->new_crc = delta_get_le32(&delta->header[20]);
+
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: fotahal_delta_open
+ *
+ * Description:
+ *   Start applying a delta patch against the running image, which is read
+ *   in place from old_image (the memory mapped running partition)
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_open(fotahal_handle_t handle, const uint8_t *old_image, uint32_t old_size)
+{
+	struct fotahal_delta_s *delta;
+
+	if (handle == NULL || old_image == NULL) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	if (g_delta) {
+		return FOTAHAL_RETURN_ERROR;
+	}
+
+	delta = (struct fotahal_delta_s *)zalloc(sizeof(struct fotahal_delta_s));
+	if (delta == NULL) {
+		return FOTAHAL_RETURN_ERROR;
+	}
+
+	delta->handle = handle;
+	delta->old = old_image;
+	delta->old_size = old_size;
+	delta->lzss_state = LZSS_FLAGS;
+	delta->rec_state = DELTA_CTRL;
+	delta->result = FOTAHAL_RETURN_SUCCESS;
+
+	g_delta = delta;
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+/****************************************************************************
+ * Name: fotahal_delta_write
+ *
+ * Description:
+ *   Apply the next len bytes of the patch.  The patch can be split
+ *   anywhere; the new image is written out as it is produced.
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_write(fotahal_handle_t handle, const char *patch, uint32_t len)
+{
+	struct fotahal_delta_s *delta = g_delta;
+	const uint8_t *p = (const uint8_t *)patch;
+	fotahal_return_t ret;
+
+	if (delta == NULL || delta->handle != handle) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	ret = delta->result;
+	while (ret == FOTAHAL_RETURN_SUCCESS && len > 0) {
+		if (delta->header_len < DELTA_HEADER_LEN) {
+			delta->header[delta->header_len++] = *p;
+			if (delta->header_len == DELTA_HEADER_LEN) {
+				ret = delta_header(delta);
+			}
+		} else {
+			ret = delta_lzss(delta, *p);
+		}
+		p++;
+		len--;
+	}
+
+	delta->result = ret;
+	return ret;
+}
+
+/****************************************************************************
+ * Name: fotahal_delta_close
+ *
+ * Description:
+ *   Finish the patch, checking that the whole new image was produced and
+ *   matches its CRC-32
+ ****************************************************************************/
+fotahal_return_t fotahal_delta_close(fotahal_handle_t handle)
+{
+	struct fotahal_delta_s *delta = g_delta;
+	fotahal_return_t ret;
+
+	if (delta == NULL || delta->handle != handle) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	ret = delta->result;
+	if (ret == FOTAHAL_RETURN_SUCCESS) {
+		delta->crc = crc32part((const uint8_t *)delta->out, delta->out_len, delta->crc);
+		ret = delta_flush(delta);
+	}
+
+	if (ret == FOTAHAL_RETURN_SUCCESS) {
+		if (delta->header_len < DELTA_HEADER_LEN || delta->new_pos != delta->new_size) {
+			dbg("%s: patch is incomplete\n", __func__);
+			ret = FOTAHAL_RETURN_WRONGSIZE;
+		} else if (delta->crc != delta->new_crc) {
+			dbg("%s: new image checksum mismatch\n", __func__);
+			ret = FOTAHAL_RETURN_CHECKSUMFAIL;
+		}
+	}
+
+	g_delta = NULL;
+	free(delta);
+
+	return ret;
+}
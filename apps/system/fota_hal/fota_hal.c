@@ -19,9 +19,19 @@
  * Included Files
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <tinyara/config.h>
 #include <tinyara/fs/ioctl.h>
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+#include <pthread.h>
+#if defined(CONFIG_TLS_WITH_SSS)
+#include <tls/see_api.h>
+#elif defined(CONFIG_NET_SECURITY_TLS)
+#include <tls/sha256.h>
+#endif
+#endif
 #ifdef CONFIG_TASH
 #include <apps/shell/tash.h>
 #endif
@@ -30,6 +40,14 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+#define FOTAHAL_STREAM_NBUFS		2
+#define FOTAHAL_STREAM_STACKSIZE	2048
+
+#if defined(CONFIG_TLS_WITH_SSS) || defined(CONFIG_NET_SECURITY_TLS)
+#define FOTAHAL_STREAM_HASH
+#endif
+#endif
 
 /****************************************************************************
  * Private Type
@@ -40,6 +58,32 @@ struct priv_fotahal_handle_s {
 
 typedef struct priv_fotahal_handle_s priv_fotahal_handle_t;
 
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+/* Buffers are filled by the caller and programmed by the writer thread in
+ * ring order; pending counts the ones handed to the writer.
+ */
+struct fotahal_stream_s {
+	fotahal_handle_t handle;
+	pthread_t writer;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	char *buf[FOTAHAL_STREAM_NBUFS];
+	uint32_t len[FOTAHAL_STREAM_NBUFS];
+	int head;					/* next buffer to program */
+	int tail;					/* buffer being filled by the caller */
+	int pending;
+	bool stop;
+	fotahal_return_t result;	/* first failure of the writer */
+#if defined(CONFIG_TLS_WITH_SSS)
+	see_hash_ctx hash;
+	bool hash_started;			/* the engine must be released */
+	bool hash_ok;
+#elif defined(CONFIG_NET_SECURITY_TLS)
+	mbedtls_sha256_context hash;
+#endif
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -48,6 +92,9 @@ static bool g_partition_set = false;
 static bool g_binary_set = false;
 static char fota_driver_path[20] = "/dev/fota";
 static priv_fotahal_handle_t g_priv_handle;
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+static struct fotahal_stream_s *g_stream;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -63,6 +110,71 @@ static int verify_fotahal_handle(fotahal_handle_t handle)
 	return ERROR;
 }
 
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+/****************************************************************************
+ * Name: fotahal_stream_writer
+ *
+ * Description:
+ *   Hash and program the queued buffers while the caller fills the next one
+ ****************************************************************************/
+static void *fotahal_stream_writer(void *arg)
+{
+	struct fotahal_stream_s *stream = (struct fotahal_stream_s *)arg;
+	fotahal_return_t ret;
+	int idx;
+
+	pthread_mutex_lock(&stream->lock);
+	for (;;) {
+		while (stream->pending == 0 && !stream->stop) {
+			pthread_cond_wait(&stream->cond, &stream->lock);
+		}
+
+		if (stream->pending == 0) {
+			break;
+		}
+
+		idx = stream->head;
+		ret = stream->result;
+		pthread_mutex_unlock(&stream->lock);
+
+		/* After a failure the rest of the image is only drained */
+		if (ret == FOTAHAL_RETURN_SUCCESS) {
+#if defined(CONFIG_TLS_WITH_SSS)
+			if (stream->hash_ok && see_hash_update(&stream->hash, (unsigned char *)stream->buf[idx], stream->len[idx]) != SEE_OK) {
+				stream->hash_ok = false;
+			}
+#elif defined(CONFIG_NET_SECURITY_TLS)
+			mbedtls_sha256_update(&stream->hash, (unsigned char *)stream->buf[idx], stream->len[idx]);
+#endif
+			ret = fotahal_write(stream->handle, stream->buf[idx], stream->len[idx]);
+		}
+
+		pthread_mutex_lock(&stream->lock);
+		if (stream->result == FOTAHAL_RETURN_SUCCESS) {
+			stream->result = ret;
+		}
+		stream->head = (idx + 1) % FOTAHAL_STREAM_NBUFS;
+		stream->pending--;
+		pthread_cond_broadcast(&stream->cond);
+	}
+	pthread_mutex_unlock(&stream->lock);
+
+	return NULL;
+}
+
+static void fotahal_stream_free(struct fotahal_stream_s *stream)
+{
+	int i;
+
+	pthread_cond_destroy(&stream->cond);
+	pthread_mutex_destroy(&stream->lock);
+	for (i = 0; i < FOTAHAL_STREAM_NBUFS; i++) {
+		free(stream->buf[i]);
+	}
+	free(stream);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -234,3 +346,199 @@ fotahal_return_t fotahal_close(fotahal_handle_t handle)
 	priv_handle->priv = NULL;
 	return FOTAHAL_RETURN_SUCCESS;
 }
+
+#ifdef CONFIG_SYSTEM_FOTA_HAL_STREAM
+/****************************************************************************
+ * Name: fotahal_stream_open
+ *
+ * Description:
+ *   Start a pipelined write of a bin_size bytes image
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_open(fotahal_handle_t handle, uint32_t bin_size)
+{
+	struct fotahal_stream_s *stream;
+	pthread_attr_t attr;
+	int i;
+
+	if (verify_fotahal_handle(handle) != OK) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	if (g_partition_set == false) {
+		return FOTAHAL_RETURN_PART_NOTSET;
+	}
+
+	if (g_binary_set == false) {
+		return FOTAHAL_RETURN_BIN_NOTSET;
+	}
+
+	if (g_stream) {
+		return FOTAHAL_RETURN_ERROR;
+	}
+
+	stream = (struct fotahal_stream_s *)zalloc(sizeof(struct fotahal_stream_s));
+	if (stream == NULL) {
+		return FOTAHAL_RETURN_ERROR;
+	}
+
+	stream->handle = handle;
+	stream->result = FOTAHAL_RETURN_SUCCESS;
+	pthread_mutex_init(&stream->lock, NULL);
+	pthread_cond_init(&stream->cond, NULL);
+
+	for (i = 0; i < FOTAHAL_STREAM_NBUFS; i++) {
+		stream->buf[i] = (char *)malloc(CONFIG_SYSTEM_FOTA_HAL_STREAM_BUFSIZE);
+		if (stream->buf[i] == NULL) {
+			dbg("%s: buffer allocation failed\n", __func__);
+			fotahal_stream_free(stream);
+			return FOTAHAL_RETURN_ERROR;
+		}
+	}
+
+#if defined(CONFIG_TLS_WITH_SSS)
+	stream->hash_started = (see_hash_start(&stream->hash, bin_size, SHA2_256) == SEE_OK);
+	stream->hash_ok = stream->hash_started;
+#elif defined(CONFIG_NET_SECURITY_TLS)
+	mbedtls_sha256_init(&stream->hash);
+	mbedtls_sha256_starts(&stream->hash, 0);
+#endif
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, FOTAHAL_STREAM_STACKSIZE);
+	if (pthread_create(&stream->writer, &attr, fotahal_stream_writer, stream) != 0) {
+		dbg("%s: writer thread creation failed\n", __func__);
+#if defined(CONFIG_TLS_WITH_SSS)
+		if (stream->hash_started) {
+			unsigned char digest[32];
+			see_hash_finish(&stream->hash, digest);
+		}
+#elif defined(CONFIG_NET_SECURITY_TLS)
+		mbedtls_sha256_free(&stream->hash);
+#endif
+		fotahal_stream_free(stream);
+		return FOTAHAL_RETURN_ERROR;
+	}
+
+	g_stream = stream;
+	return FOTAHAL_RETURN_SUCCESS;
+}
+
+/****************************************************************************
+ * Name: fotahal_stream_getbuf
+ *
+ * Description:
+ *   Get the buffer to receive the next chunk of the image into.  Blocks
+ *   while every buffer is still queued for programming.
+ ****************************************************************************/
+char *fotahal_stream_getbuf(fotahal_handle_t handle, uint32_t *size)
+{
+	struct fotahal_stream_s *stream = g_stream;
+	char *buf;
+
+	if (verify_fotahal_handle(handle) != OK || stream == NULL || size == NULL) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&stream->lock);
+	while (stream->pending == FOTAHAL_STREAM_NBUFS) {
+		pthread_cond_wait(&stream->cond, &stream->lock);
+	}
+	buf = stream->buf[stream->tail];
+	pthread_mutex_unlock(&stream->lock);
+
+	*size = CONFIG_SYSTEM_FOTA_HAL_STREAM_BUFSIZE;
+	return buf;
+}
+
+/****************************************************************************
+ * Name: fotahal_stream_put
+ *
+ * Description:
+ *   Queue the first len bytes of the buffer from fotahal_stream_getbuf for
+ *   programming.  A failure of an earlier chunk is reported here.
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_put(fotahal_handle_t handle, uint32_t len)
+{
+	struct fotahal_stream_s *stream = g_stream;
+	fotahal_return_t ret;
+
+	if (verify_fotahal_handle(handle) != OK || stream == NULL) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	if (len > CONFIG_SYSTEM_FOTA_HAL_STREAM_BUFSIZE) {
+		return FOTAHAL_RETURN_WRONGSIZE;
+	}
+
+	pthread_mutex_lock(&stream->lock);
+	ret = stream->result;
+	if (stream->pending == FOTAHAL_STREAM_NBUFS) {
+		/* No buffer was taken with fotahal_stream_getbuf */
+		ret = FOTAHAL_RETURN_ERROR;
+	} else if (len > 0) {
+		stream->len[stream->tail] = len;
+		stream->tail = (stream->tail + 1) % FOTAHAL_STREAM_NBUFS;
+		stream->pending++;
+		pthread_cond_broadcast(&stream->cond);
+	}
+	pthread_mutex_unlock(&stream->lock);
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: fotahal_stream_close
+ *
+ * Description:
+ *   Wait until every queued chunk is programmed.  If sha256 is not NULL the
+ *   SHA-256 digest of the image is checked against it.
+ ****************************************************************************/
+fotahal_return_t fotahal_stream_close(fotahal_handle_t handle, const uint8_t *sha256)
+{
+	struct fotahal_stream_s *stream = g_stream;
+	fotahal_return_t ret;
+#ifdef FOTAHAL_STREAM_HASH
+	unsigned char digest[32];
+	bool digest_ok = true;
+#endif
+
+	if (verify_fotahal_handle(handle) != OK || stream == NULL) {
+		return FOTAHAL_RETURN_WRONGHANDLE;
+	}
+
+	pthread_mutex_lock(&stream->lock);
+	stream->stop = true;
+	pthread_cond_broadcast(&stream->cond);
+	pthread_mutex_unlock(&stream->lock);
+
+	pthread_join(stream->writer, NULL);
+	g_stream = NULL;
+
+	ret = stream->result;
+
+#if defined(CONFIG_TLS_WITH_SSS)
+	if (stream->hash_started && see_hash_finish(&stream->hash, digest) != SEE_OK) {
+		stream->hash_ok = false;
+	}
+	digest_ok = stream->hash_ok;
+#elif defined(CONFIG_NET_SECURITY_TLS)
+	mbedtls_sha256_finish(&stream->hash, digest);
+	mbedtls_sha256_free(&stream->hash);
+#endif
+
+	if (ret == FOTAHAL_RETURN_SUCCESS && sha256) {
+#ifdef FOTAHAL_STREAM_HASH
+		if (!digest_ok || memcmp(digest, sha256, sizeof(digest)) != 0) {
+			dbg("%s: image digest mismatch\n", __func__);
+			ret = FOTAHAL_RETURN_CHECKSUMFAIL;
+		}
+#else
+		dbg("%s: no hash support to verify the image\n", __func__);
+		ret = FOTAHAL_RETURN_CHECKSUMFAIL;
+#endif
+	}
+
+	fotahal_stream_free(stream);
+	return ret;
+}
+#endif
@@ -0,0 +1,569 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/system/fsbench/fsbench_main.c
+ *
+ * File system benchmark.  Each test runs on -j concurrent jobs, every job
+ * on files of its own in the target directory, and prints one CSV line:
+ *
+ *   fsbench,<test>,<ops>,<KB/s>,<ops/s>,<avg>,<p50>,<p90>,<p99>,<max>
+ *
+ * with the latencies of the single operations in microseconds.  Throughput
+ * and rates are over the wall time of the whole test.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mount.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/boottime.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SYSTEM_FSBENCH_DIR
+#define CONFIG_SYSTEM_FSBENCH_DIR "/mnt"
+#endif
+
+#define FSBENCH_MAXJOBS         8
+#define FSBENCH_MOUNTS          5
+#define FSBENCH_STACKSIZE       2048
+#define FSBENCH_PATHLEN         64
+
+/* Latencies are taken with the finest counter available in a flat build */
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+#if defined(CONFIG_ARCH_HAVE_PERF_COUNTER)
+#define FSBENCH_TICKS_PER_USEC  CONFIG_ARCH_PERF_CYCLES_PER_USEC
+#define fsbench_ticks()         up_perf_gettime()
+#elif defined(CONFIG_ARCH_HAVE_BOOTTIME)
+#define FSBENCH_TICKS_PER_USEC  1
+#define fsbench_ticks()         up_boottime()
+#endif
+#endif
+
+#ifndef fsbench_ticks
+#define FSBENCH_TICKS_PER_USEC  1
+#define fsbench_ticks()         ((uint32_t)fsbench_usec())
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fsbench_cfg_s {
+	FAR const char *dir;
+	FAR const char *source;
+	FAR const char *fstype;
+	size_t bsize;
+	size_t fsize;
+	int nfiles;
+	int njobs;
+};
+
+struct fsbench_job_s {
+	FAR const struct fsbench_cfg_s *cfg;
+	FAR const struct fsbench_test_s *test;
+	FAR uint32_t *samples;
+	FAR uint8_t *buffer;
+	int id;
+	int count;
+	int result;
+	uint32_t seed;
+	uint64_t bytes;
+};
+
+/* A test runs one job and records the latency of each of its operations */
+
+struct fsbench_test_s {
+	FAR const char *name;
+	int (*fn)(FAR struct fsbench_job_s *job);
+	bool perjob;				/* Runs on every job, else on one only */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t fsbench_usec(void)
+{
+	struct timespec ts;
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void fsbench_record(FAR struct fsbench_job_s *job, uint32_t start)
+{
+	job->samples[job->count++] = fsbench_ticks() - start;
+}
+
+static void fsbench_datafile(FAR struct fsbench_job_s *job, FAR char *path)
+{
+	snprintf(path, FSBENCH_PATHLEN, "%s/fsbench.%d", job->cfg->dir, job->id);
+}
+
+static void fsbench_metafile(FAR struct fsbench_job_s *job, int i, FAR char *path)
+{
+	snprintf(path, FSBENCH_PATHLEN, "%s/fsb%d_%d", job->cfg->dir, job->id, i);
+}
+
+static int fsbench_nblocks(FAR const struct fsbench_cfg_s *cfg)
+{
+	return cfg->fsize / cfg->bsize;
+}
+
+static off_t fsbench_random_block(FAR struct fsbench_job_s *job)
+{
+	job->seed = job->seed * 1103515245 + 12345;
+	return (off_t)((job->seed >> 8) % fsbench_nblocks(job->cfg)) * job->cfg->bsize;
+}
+
+/* Sequential and random block I/O on the data file of the job */
+
+static int fsbench_io(FAR struct fsbench_job_s *job, bool wr, bool random, bool sync)
+{
+	char path[FSBENCH_PATHLEN];
+	size_t bsize = job->cfg->bsize;
+	uint32_t start;
+	ssize_t nbytes;
+	int nblocks = fsbench_nblocks(job->cfg);
+	int fd;
+	int i;
+
+	fsbench_datafile(job, path);
+	fd = open(path, wr ? (O_WRONLY | O_CREAT) : O_RDONLY, 0666);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	for (i = 0; i < nblocks; i++) {
+		start = fsbench_ticks();
+		if (random && lseek(fd, fsbench_random_block(job), SEEK_SET) < 0) {
+			break;
+		}
+		nbytes = wr ? write(fd, job->buffer, bsize) : read(fd, job->buffer, bsize);
+		if (nbytes != (ssize_t)bsize) {
+			break;
+		}
+		if (sync && fsync(fd) < 0) {
+			break;
+		}
+		fsbench_record(job, start);
+		job->bytes += bsize;
+	}
+
+	close(fd);
+	return i == nblocks ? OK : -EIO;
+}
+
+static int fsbench_seqwr(FAR struct fsbench_job_s *job)
+{
+	return fsbench_io(job, true, false, false);
+}
+
+static int fsbench_seqrd(FAR struct fsbench_job_s *job)
+{
+	return fsbench_io(job, false, false, false);
+}
+
+static int fsbench_rndwr(FAR struct fsbench_job_s *job)
+{
+	return fsbench_io(job, true, true, false);
+}
+
+static int fsbench_rndrd(FAR struct fsbench_job_s *job)
+{
+	return fsbench_io(job, false, true, false);
+}
+
+static int fsbench_fsync(FAR struct fsbench_job_s *job)
+{
+	return fsbench_io(job, true, false, true);
+}
+
+/* Metadata operations on -n small files per job */
+
+static int fsbench_create(FAR struct fsbench_job_s *job)
+{
+	char path[FSBENCH_PATHLEN];
+	uint32_t start;
+	int fd;
+	int i;
+
+	for (i = 0; i < job->cfg->nfiles; i++) {
+		fsbench_metafile(job, i, path);
+		start = fsbench_ticks();
+		fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fd < 0) {
+			return -errno;
+		}
+		close(fd);
+		fsbench_record(job, start);
+	}
+
+	return OK;
+}
+
+static int fsbench_stat(FAR struct fsbench_job_s *job)
+{
+	char path[FSBENCH_PATHLEN];
+	struct stat buf;
+	uint32_t start;
+	int i;
+
+	for (i = 0; i < job->cfg->nfiles; i++) {
+		fsbench_metafile(job, i, path);
+		start = fsbench_ticks();
+		if (stat(path, &buf) < 0) {
+			return -errno;
+		}
+		fsbench_record(job, start);
+	}
+
+	return OK;
+}
+
+static int fsbench_unlink(FAR struct fsbench_job_s *job)
+{
+	char path[FSBENCH_PATHLEN];
+	uint32_t start;
+	int i;
+
+	for (i = 0; i < job->cfg->nfiles; i++) {
+		fsbench_metafile(job, i, path);
+		start = fsbench_ticks();
+		if (unlink(path) < 0) {
+			return -errno;
+		}
+		fsbench_record(job, start);
+	}
+
+	return OK;
+}
+
+/* Mount time: unmount the directory and mount -M on it again with -T */
+
+static int fsbench_mount(FAR struct fsbench_job_s *job)
+{
+	FAR const struct fsbench_cfg_s *cfg = job->cfg;
+	uint32_t start;
+	int i;
+
+	if (cfg->source == NULL || cfg->fstype == NULL) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < FSBENCH_MOUNTS; i++) {
+		if (umount(cfg->dir) < 0) {
+			return -errno;
+		}
+		start = fsbench_ticks();
+		if (mount(cfg->source, cfg->dir, cfg->fstype, 0, NULL) < 0) {
+			return -errno;
+		}
+		fsbench_record(job, start);
+	}
+
+	return OK;
+}
+
+/* In the order they run; the read tests use the files the write tests
+ * leave behind.
+ */
+
+static const struct fsbench_test_s g_tests[] = {
+	{ "seqwr",  fsbench_seqwr,  true  },
+	{ "seqrd",  fsbench_seqrd,  true  },
+	{ "rndwr",  fsbench_rndwr,  true  },
+	{ "rndrd",  fsbench_rndrd,  true  },
+	{ "fsync",  fsbench_fsync,  true  },
+	{ "create", fsbench_create, true  },
+	{ "stat",   fsbench_stat,   true  },
+	{ "unlink", fsbench_unlink, true  },
+	{ "mount",  fsbench_mount,  false },
+};
+
+#define FSBENCH_NTESTS (sizeof(g_tests) / sizeof(g_tests[0]))
+
+static pthread_addr_t fsbench_job(pthread_addr_t arg)
+{
+	FAR struct fsbench_job_s *job = (FAR struct fsbench_job_s *)arg;
+
+	job->result = job->test->fn(job);
+	return NULL;
+}
+
+static int fsbench_compare(FAR const void *a, FAR const void *b)
+{
+	uint32_t x = *(FAR const uint32_t *)a;
+	uint32_t y = *(FAR const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static unsigned long fsbench_ticks2usec(uint64_t ticks)
+{
+	return (unsigned long)(ticks / FSBENCH_TICKS_PER_USEC);
+}
+
+static void fsbench_report(FAR const struct fsbench_test_s *test, FAR uint32_t *samples, int n, uint64_t bytes, uint64_t usec)
+{
+	uint64_t sum = 0;
+	int i;
+
+	if (n == 0) {
+		printf("fsbench,%s,0,,,,,,,\n", test->name);
+		return;
+	}
+
+	usec = usec > 0 ? usec : 1;
+	qsort(samples, n, sizeof(uint32_t), fsbench_compare);
+	for (i = 0; i < n; i++) {
+		sum += samples[i];
+	}
+
+	printf("fsbench,%s,%d,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", test->name, n, (unsigned long)(bytes * 1000000 / 1024 / usec), (unsigned long)((uint64_t)n * 1000000 / usec), fsbench_ticks2usec(sum / n), fsbench_ticks2usec(samples[n / 2]), fsbench_ticks2usec(samples[n * 90 / 100]), fsbench_ticks2usec(samples[n * 99 / 100]), fsbench_ticks2usec(samples[n - 1]));
+}
+
+/* Run one test on all jobs at once and report the merged latencies */
+
+static int fsbench_run(FAR const struct fsbench_cfg_s *cfg, FAR const struct fsbench_test_s *test, FAR struct fsbench_job_s *jobs, FAR uint32_t *samples, int perjob)
+{
+	pthread_t threads[FSBENCH_MAXJOBS];
+	pthread_attr_t attr;
+	uint64_t bytes = 0;
+	uint64_t start;
+	int njobs = test->perjob ? cfg->njobs : 1;
+	int result = OK;
+	int n = 0;
+	int i;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, FSBENCH_STACKSIZE);
+
+	start = fsbench_usec();
+	for (i = 0; i < njobs; i++) {
+		jobs[i].test = test;
+		jobs[i].samples = samples + i * perjob;
+		jobs[i].count = 0;
+		jobs[i].bytes = 0;
+		jobs[i].result = OK;
+		if (pthread_create(&threads[i], &attr, fsbench_job, (pthread_addr_t)&jobs[i]) != 0) {
+			jobs[i].result = -ENOMEM;
+			threads[i] = 0;
+		}
+	}
+
+	for (i = 0; i < njobs; i++) {
+		if (threads[i] != 0) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+	start = fsbench_usec() - start;
+	pthread_attr_destroy(&attr);
+
+	/* Pack the samples of all jobs together */
+
+	for (i = 0; i < njobs; i++) {
+		memmove(samples + n, jobs[i].samples, jobs[i].count * sizeof(uint32_t));
+		n += jobs[i].count;
+		bytes += jobs[i].bytes;
+		if (jobs[i].result != OK) {
+			result = jobs[i].result;
+		}
+	}
+
+	fsbench_report(test, samples, n, bytes, start);
+	if (result != OK) {
+		printf("# %s: failed (%d)\n", test->name, result);
+	}
+
+	return result;
+}
+
+static void fsbench_cleanup(FAR struct fsbench_job_s *jobs, int njobs)
+{
+	char path[FSBENCH_PATHLEN];
+	int i;
+
+	for (i = 0; i < njobs; i++) {
+		fsbench_datafile(&jobs[i], path);
+		unlink(path);
+	}
+}
+
+static void fsbench_usage(FAR const char *progname)
+{
+	int i;
+
+	printf("Usage: %s [options] [test...]\n", progname);
+	printf("  -d <dir>     directory to run in (default %s)\n", CONFIG_SYSTEM_FSBENCH_DIR);
+	printf("  -b <bytes>   block size (default 4096)\n");
+	printf("  -s <bytes>   file size per job (default 65536)\n");
+	printf("  -n <files>   files per job for create/stat/unlink (default 32)\n");
+	printf("  -j <jobs>    concurrent jobs, up to %d (default 1)\n", FSBENCH_MAXJOBS);
+	printf("  -M <source>  block device remounted by the mount test\n");
+	printf("  -T <fstype>  file system type for the mount test\n");
+	printf("Tests:");
+	for (i = 0; i < FSBENCH_NTESTS; i++) {
+		printf(" %s", g_tests[i].name);
+	}
+	printf("\nAll but mount run when none is given.\n");
+}
+
+/****************************************************************************
+ * fsbench_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int fsbench_main(int argc, char *argv[])
+#endif
+{
+	struct fsbench_cfg_s cfg;
+	struct fsbench_job_s jobs[FSBENCH_MAXJOBS];
+	FAR uint32_t *samples;
+	bool selected;
+	int perjob;
+	int option;
+	int ret = EXIT_SUCCESS;
+	int i;
+	int j;
+
+	cfg.dir = CONFIG_SYSTEM_FSBENCH_DIR;
+	cfg.source = NULL;
+	cfg.fstype = NULL;
+	cfg.bsize = 4096;
+	cfg.fsize = 65536;
+	cfg.nfiles = 32;
+	cfg.njobs = 1;
+
+	while ((option = getopt(argc, argv, "d:b:s:n:j:M:T:h")) != ERROR) {
+		switch (option) {
+		case 'd':
+			cfg.dir = optarg;
+			break;
+		case 'b':
+			cfg.bsize = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			cfg.fsize = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			cfg.nfiles = atoi(optarg);
+			break;
+		case 'j':
+			cfg.njobs = atoi(optarg);
+			break;
+		case 'M':
+			cfg.source = optarg;
+			break;
+		case 'T':
+			cfg.fstype = optarg;
+			break;
+		default:
+			fsbench_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (cfg.bsize == 0 || cfg.fsize < cfg.bsize || cfg.nfiles <= 0 || cfg.njobs <= 0 || cfg.njobs > FSBENCH_MAXJOBS) {
+		fsbench_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/* One sample per block or per file for every job, and for the mounts */
+
+	perjob = fsbench_nblocks(&cfg);
+	perjob = perjob > cfg.nfiles ? perjob : cfg.nfiles;
+	perjob = perjob > FSBENCH_MOUNTS ? perjob : FSBENCH_MOUNTS;
+
+	samples = (FAR uint32_t *)malloc(perjob * cfg.njobs * sizeof(uint32_t));
+	memset(jobs, 0, sizeof(jobs));
+	for (i = 0; i < cfg.njobs; i++) {
+		jobs[i].cfg = &cfg;
+		jobs[i].id = i;
+		jobs[i].seed = 0x2545f491 + i;
+		jobs[i].buffer = (FAR uint8_t *)malloc(cfg.bsize);
+		if (jobs[i].buffer == NULL) {
+			break;
+		}
+		memset(jobs[i].buffer, 0xa5 ^ i, cfg.bsize);
+	}
+
+	if (samples == NULL || i < cfg.njobs) {
+		printf("fsbench: out of memory\n");
+		ret = EXIT_FAILURE;
+		goto errout;
+	}
+
+	printf("# dir %s, block %lu, file %lu, files %d, jobs %d\n", cfg.dir, (unsigned long)cfg.bsize, (unsigned long)cfg.fsize, cfg.nfiles, cfg.njobs);
+	printf("# fsbench,test,ops,KB/s,ops/s,avg_us,p50_us,p90_us,p99_us,max_us\n");
+
+	for (i = 0; i < FSBENCH_NTESTS; i++) {
+		if (optind >= argc) {
+			selected = g_tests[i].perjob;
+		} else {
+			selected = false;
+			for (j = optind; j < argc; j++) {
+				if (strcmp(argv[j], g_tests[i].name) == 0) {
+					selected = true;
+				}
+			}
+		}
+
+		if (selected && fsbench_run(&cfg, &g_tests[i], jobs, samples, perjob) != OK) {
+			ret = EXIT_FAILURE;
+		}
+	}
+
+	fsbench_cleanup(jobs, cfg.njobs);
+
+errout:
+	for (i = 0; i < cfg.njobs; i++) {
+		free(jobs[i].buffer);
+	}
+	free(samples);
+	return ret;
+}
@@ -56,9 +56,16 @@
 
 #include <tinyara/config.h>
 
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <apps/inifile.h>
@@ -103,23 +110,63 @@
 #endif
 #endif
 
+/* The index of an INI file.  The index is one contiguous block: this header
+ * followed by the entries, the hash slots and the strings, so that it can be
+ * written to and read from the cache file as it is.
+ */
+
+#define INIFILE_MAGIC       0x49494458	/* "IIDX" */
+#define INIFILE_MINSLOTS    8
+#define INIFILE_MAXENTRIES  (UINT16_MAX / 4)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* A structure that describes one entry from the INI file */
+/* A structure that describes one variable of the INI file.  The names and
+ * the value are offsets into the strings of the index.
+ */
 
-struct inifile_var_s {
-	FAR char *variable;
-	FAR char *value;
+struct inifile_entry_s {
+	uint32_t hash;				/* Hash of the section and variable names */
+	uint32_t section;			/* Section name */
+	uint32_t variable;			/* Variable name */
+	uint32_t value;				/* Variable value */
 };
 
-/* This structure describes the state of one instance of the INI file parser */
+/* The index header.  inisize and inimtime identify the INI file that a
+ * cached index was built from.
+ */
+
+struct inifile_index_s {
+	uint32_t magic;
+	uint32_t inisize;
+	uint32_t inimtime;
+	uint32_t strsize;			/* Size of the strings */
+	uint16_t nentries;			/* Number of entries */
+	uint16_t nslots;			/* Number of hash slots (a power of two) */
+};
+
+/* This structure describes the state of the INI file parser while the
+ * index is built.
+ */
 
 struct inifile_state_s {
 	FILE *instream;
 	int   nextch;
 	char  line[CONFIG_SYSTEM_INIFILE_MAXLINE + 1];
+
+	/* The entries, section names and strings collected so far */
+
+	FAR struct inifile_entry_s *entries;
+	FAR uint32_t *sections;
+	FAR char *strings;
+	uint32_t nentries;
+	uint32_t maxentries;
+	uint32_t nsections;
+	uint32_t maxsections;
+	uint32_t strsize;
+	uint32_t maxstr;
 };
 
 /****************************************************************************
@@ -133,10 +180,6 @@ struct inifile_state_s {
 static bool      inifile_next_line(FAR struct inifile_state_s *priv);
 static int       inifile_read_line(FAR struct inifile_state_s *priv);
 static int       inifile_read_noncomment_line(FAR struct inifile_state_s *priv);
-static bool      inifile_seek_to_section(FAR struct inifile_state_s *priv, FAR const char *section);
-static bool      inifile_read_variable(FAR struct inifile_state_s *priv, FAR struct inifile_var_s *varinfo);
-static FAR char *inifile_find_section_variable(FAR struct inifile_state_s *priv, FAR const char *variable);
-static FAR char *inifile_find_variable(FAR struct inifile_state_s *priv, FAR const char *section, FAR const char *variable);
 
 /****************************************************************************
  * Private Functions
@@ -251,215 +294,508 @@ static int inifile_read_noncomment_line(FAR struct inifile_state_s *priv)
 	return nbytes;
 }
 
+
 /****************************************************************************
- * Name:  inifile_seek_to_section
+ * Name:  inifile_hash
  *
  * Description:
- *   Positions the file pointer to the line containing the first variable
- *   description within the INI file. Returns 1 if the section was found.
- *   In this case, the file pointer will be positioned at the beginning of
- *   the first variable line.
+ *   Case insensitive FNV-1a hash of a section and a variable name.
  *
  ****************************************************************************/
 
-static bool inifile_seek_to_section(FAR struct inifile_state_s *priv, FAR const char *section)
+static uint32_t inifile_hash(FAR const char *section, FAR const char *variable)
 {
-	int nbytes;
+	uint32_t hash = 2166136261u;
 
-	/* Rewind to the beginning of the INI file and re-prime the pump with the
-	 * first character from the INI file.
-	 */
+	while (*section) {
+		hash = (hash ^ (uint8_t)tolower(*section++)) * 16777619u;
+	}
 
-	rewind(priv->instream);
-	priv->nextch = getc(priv->instream);
+	hash *= 16777619u;
 
-	/* Loop until either the section is found, or until we hit the end of the
-	 * INI file.
-	 */
+	while (*variable) {
+		hash = (hash ^ (uint8_t)tolower(*variable++)) * 16777619u;
+	}
 
-	do {
-		/* Read the next line into the input buffer.  A returned value of zero
-		 * bytes means nothing special here -- could be EOF or a blank line.
-		 */
+	return hash;
+}
 
-		nbytes = inifile_read_noncomment_line(priv);
+/****************************************************************************
+ * Name:  inifile_entries
+ * Name:  inifile_slots
+ * Name:  inifile_strings
+ *
+ * Description:
+ *   Locate the parts of an index.
+ *
+ ****************************************************************************/
 
-		/* It takes at least three bytes of data to be a candidate for a
-		 * section header.
-		 */
+static inline FAR struct inifile_entry_s *inifile_entries(FAR struct inifile_index_s *index)
+{
+	return (FAR struct inifile_entry_s *)(index + 1);
+}
 
-		if (nbytes >= 3) {
-			/* A section header must begin with a left bracket */
+static inline FAR uint16_t *inifile_slots(FAR struct inifile_index_s *index)
+{
+	return (FAR uint16_t *)(inifile_entries(index) + index->nentries);
+}
 
-			if (priv->line[0] == '[') {
-				/* The section name should start with the first character
-				 * after the left bracket.
-				 */
+static inline FAR char *inifile_strings(FAR struct inifile_index_s *index)
+{
+	return (FAR char *)(inifile_slots(index) + index->nslots);
+}
+
+static inline size_t inifile_index_size(uint16_t nentries, uint16_t nslots, uint32_t strsize)
+{
+	return sizeof(struct inifile_index_s) + nentries * sizeof(struct inifile_entry_s) + nslots * sizeof(uint16_t) + strsize;
+}
+
+/****************************************************************************
+ * Name:  inifile_lookup
+ *
+ * Description:
+ *   Find the entry of a variable in the index.  Returns NULL if the
+ *   variable is not in the index.
+ *
+ ****************************************************************************/
+
+static FAR struct inifile_entry_s *inifile_lookup(FAR struct inifile_index_s *index, uint32_t hash, FAR const char *section, FAR const char *variable)
+{
+	FAR struct inifile_entry_s *entries = inifile_entries(index);
+	FAR uint16_t *slots = inifile_slots(index);
+	FAR char *strings = inifile_strings(index);
+	FAR struct inifile_entry_s *entry;
+	uint16_t mask = index->nslots - 1;
+	uint16_t slot;
+
+	for (slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+		entry = &entries[slots[slot] - 1];
+		if (entry->hash == hash && strcasecmp(&strings[entry->variable], variable) == 0 && strcasecmp(&strings[entry->section], section) == 0) {
+			return entry;
+		}
+	}
 
-				FAR char *sectend;
+	return NULL;
+}
 
-				/* The section name should extend to the right bracket. */
+/****************************************************************************
+ * Name:  inifile_grow
+ *
+ * Description:
+ *   Make room for at least 'needed' elements in an array that is being
+ *   collected, doubling its size as needed.
+ *
+ ****************************************************************************/
 
-				sectend = strchr(&priv->line[1], ']');
+static int inifile_grow(FAR void **array, FAR uint32_t *max, uint32_t needed, size_t elemsize)
+{
+	FAR void *newarray;
+	uint32_t newmax;
 
-				/* Replace the right bracket (if found) with a NULL
-				 * terminator.
-				 */
+	if (needed <= *max) {
+		return OK;
+	}
 
-				if (sectend) {
-					*sectend = '\0';
-				}
+	for (newmax = *max ? *max : 16; newmax < needed; newmax *= 2) ;
 
-				/* Then compare the section name to the one we are looking for */
+	newarray = realloc(*array, newmax * elemsize);
+	if (!newarray) {
+		return -ENOMEM;
+	}
 
-				if (strcasecmp(&priv->line[1], section) == 0) {
-					/* The section names match!  Return success */
+	*array = newarray;
+	*max = newmax;
+	return OK;
+}
 
-					return true;
-				}
-			}
+/****************************************************************************
+ * Name:  inifile_add_string
+ *
+ * Description:
+ *   Append a string to the strings being collected.  Returns its offset or
+ *   -ENOMEM.
+ *
+ ****************************************************************************/
+
+static int32_t inifile_add_string(FAR struct inifile_state_s *priv, FAR const char *str)
+{
+	size_t len = strlen(str) + 1;
+	uint32_t offset;
+
+	if (inifile_grow((FAR void **)&priv->strings, &priv->maxstr, priv->strsize + len, 1) < 0) {
+		return -ENOMEM;
+	}
+
+	offset = priv->strsize;
+	memcpy(&priv->strings[offset], str, len);
+	priv->strsize += len;
+	return (int32_t)offset;
+}
+
+/****************************************************************************
+ * Name:  inifile_add_section
+ *
+ * Description:
+ *   Start a new section.  Returns the offset of its name, or -EEXIST if the
+ *   section was seen before.
+ *
+ ****************************************************************************/
+
+static int32_t inifile_add_section(FAR struct inifile_state_s *priv, FAR const char *name)
+{
+	int32_t offset;
+	uint32_t i;
+
+	for (i = 0; i < priv->nsections; i++) {
+		if (strcasecmp(&priv->strings[priv->sections[i]], name) == 0) {
+			return -EEXIST;
 		}
-	} while (priv->nextch != EOF);
+	}
 
-	/* If we got here, we search the whole INI file without finding
-	 * the requested section
-	 */
+	if (inifile_grow((FAR void **)&priv->sections, &priv->maxsections, priv->nsections + 1, sizeof(uint32_t)) < 0) {
+		return -ENOMEM;
+	}
+
+	offset = inifile_add_string(priv, name);
+	if (offset >= 0) {
+		priv->sections[priv->nsections++] = (uint32_t)offset;
+	}
+
+	return offset;
+}
+
+/****************************************************************************
+ * Name:  inifile_add_entry
+ *
+ * Description:
+ *   Add a variable of the current section to the entries being collected.
+ *
+ ****************************************************************************/
+
+static int inifile_add_entry(FAR struct inifile_state_s *priv, uint32_t section, FAR const char *variable, FAR const char *value)
+{
+	FAR struct inifile_entry_s *entry;
+	int32_t varoff;
+	int32_t valoff;
+
+	if (priv->nentries >= INIFILE_MAXENTRIES) {
+		return -E2BIG;
+	}
+
+	if (inifile_grow((FAR void **)&priv->entries, &priv->maxentries, priv->nentries + 1, sizeof(struct inifile_entry_s)) < 0) {
+		return -ENOMEM;
+	}
 
-	inidbg("ERROR: Section \"%s\" not found\n", section);
-	return false;
+	varoff = inifile_add_string(priv, variable);
+	if (varoff < 0) {
+		return varoff;
+	}
+
+	valoff = inifile_add_string(priv, value);
+	if (valoff < 0) {
+		return valoff;
+	}
+
+	entry = &priv->entries[priv->nentries++];
+	entry->hash = inifile_hash(&priv->strings[section], variable);
+	entry->section = section;
+	entry->variable = (uint32_t)varoff;
+	entry->value = (uint32_t)valoff;
+	return OK;
 }
 
 /****************************************************************************
- * Name:  inifile_read_variable
+ * Name:  inifile_parse
  *
  * Description:
- *   Obtain variable info from the next line in the section.  This assumes
- *   that the file pointer is pointing to the beginning of the next line.
- *   If there is no further data in the section, false is returned.
+ *   Read the whole INI file and collect its variables.  Variables that
+ *   precede the first section header are ignored, and so are the repeated
+ *   occurrences of a section, as when the file was searched on every
+ *   lookup.
  *
  ****************************************************************************/
 
-static bool inifile_read_variable(FAR struct inifile_state_s *priv, FAR struct inifile_var_s *varinfo)
+static int inifile_parse(FAR struct inifile_state_s *priv)
 {
 	FAR char *ptr;
+	int32_t section = -1;
+	bool skip = true;
+	int nbytes;
+	int ret;
 
-	/* Read until either (1) the end of file is found, (2) the end of
-	 * the section is found, or (3) a valid variable assignment is found.
-	 */
+	/* Prime the pump */
 
-	for (;;) {
-		/* Read the next line in the buffer */
+	priv->nextch = getc(priv->instream);
+
+	while (priv->nextch != EOF) {
+		/* A returned value of zero bytes means nothing special here --
+		 * could be EOF or a blank line.
+		 */
 
-		int nbytes = inifile_read_noncomment_line(priv);
+		nbytes = inifile_read_noncomment_line(priv);
+		if (nbytes == 0) {
+			continue;
+		}
 
-		/* Make sure that the line is non-NULL and that this is not the
-		 * beginning of a new section
+		/* A section header must begin with a left bracket.  It takes at
+		 * least three bytes of data to be a candidate for a section header.
 		 */
 
-		if (!nbytes || priv->line[0] == '[') {
-			return false;
+		if (priv->line[0] == '[') {
+			skip = true;
+			if (nbytes < 3) {
+				continue;
+			}
+
+			/* The section name should extend to the right bracket */
+
+			ptr = strchr(&priv->line[1], ']');
+			if (ptr) {
+				*ptr = '\0';
+			}
+
+			section = inifile_add_section(priv, &priv->line[1]);
+			if (section == -EEXIST) {
+				inivdbg("Ignoring repeated section \"%s\"\n", &priv->line[1]);
+				continue;
+			} else if (section < 0) {
+				return section;
+			}
+
+			skip = false;
+			continue;
 		}
 
-		/* Search for the '=' delimiter.  NOTE  the line is guaranteed to
-		 * be NULL terminated by inifile_read_noncomment_line().
+		if (skip) {
+			continue;
+		}
+
+		/* Search for the '=' delimiter and put NUL termination between the
+		 * variable name and the variable value (replacing the equal sign).
 		 */
 
 		ptr = strchr(&priv->line[1], '=');
+		if (ptr) {
+			*ptr = '\0';
 
-		/* If the delimiter was found, return success */
+			ret = inifile_add_entry(priv, (uint32_t)section, priv->line, ptr + 1);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+	}
 
-		if (ptr) {
-			/* Put NUL termination between the variable name and the
-			 * variable value (replacing the equal sign).
-			 */
+	return OK;
+}
 
-			*ptr = '\0';
+/****************************************************************************
+ * Name:  inifile_build_index
+ *
+ * Description:
+ *   Build the index from the collected entries.  If a variable is assigned
+ *   more than once in a section, the first assignment is used.
+ *
+ ****************************************************************************/
+
+static FAR struct inifile_index_s *inifile_build_index(FAR struct inifile_state_s *priv)
+{
+	FAR struct inifile_index_s *index;
+	FAR struct inifile_entry_s *entry;
+	FAR uint16_t *slots;
+	uint16_t nslots;
+	uint16_t slot;
+	uint16_t i;
 
-			/* Set up the return structure.  NOTE:  value may point at
-			 * a NULL string
-			 */
+	/* Keep the hash slots at most half full */
+
+	for (nslots = INIFILE_MINSLOTS; nslots < 2 * priv->nentries; nslots <<= 1) ;
+
+	index = (FAR struct inifile_index_s *)zalloc(inifile_index_size(priv->nentries, nslots, priv->strsize));
+	if (!index) {
+		return NULL;
+	}
 
-			varinfo->variable = (char *)priv->line;
-			varinfo->value = (ptr + 1);
-			return true;
+	index->magic = INIFILE_MAGIC;
+	index->strsize = priv->strsize;
+	index->nentries = priv->nentries;
+	index->nslots = nslots;
+
+	memcpy(inifile_entries(index), priv->entries, priv->nentries * sizeof(struct inifile_entry_s));
+	memcpy(inifile_strings(index), priv->strings, priv->strsize);
+
+	slots = inifile_slots(index);
+	for (i = 0; i < priv->nentries; i++) {
+		entry = &priv->entries[i];
+		if (inifile_lookup(index, entry->hash, &priv->strings[entry->section], &priv->strings[entry->variable]) != NULL) {
+			continue;
 		}
+
+		for (slot = entry->hash & (nslots - 1); slots[slot] != 0; slot = (slot + 1) & (nslots - 1)) ;
+		slots[slot] = i + 1;
 	}
+
+	return index;
 }
 
+#ifdef CONFIG_SYSTEM_INIFILE_CACHE
 /****************************************************************************
- * Name:  inifile_find_section_variable
+ * Name:  inifile_cache_path
  *
  * Description:
- *   Find the value string associated with the variable name.  This function
- *   will return NULL on failure to find the variable.  It will return a
- *   pointer to an empty string is the variable is found, but not assigned a
- *   value.
+ *   Return the allocated path of the cache file of an INI file.
  *
  ****************************************************************************/
 
-static FAR char *inifile_find_section_variable(FAR struct inifile_state_s *priv, FAR const char *variable)
+static FAR char *inifile_cache_path(FAR const char *inifile_name)
 {
-	/* Loop until either (1) we hit the end of file, (2) we hit the end
-	 * of the section, or (3) we find the variable that we are looking
-	 * for/
-	 */
+	FAR char *path;
 
-	inivdbg("variable=\"%s\"\n", variable);
+	if (asprintf(&path, "%s%s", inifile_name, CONFIG_SYSTEM_INIFILE_CACHE_SUFFIX) < 0) {
+		return NULL;
+	}
 
-	for (;;) {
-		/* Get the next variable from this section. */
+	return path;
+}
+
+/****************************************************************************
+ * Name:  inifile_check_index
+ *
+ * Description:
+ *   Verify that the entries and slots of an index read from the cache file
+ *   stay within the index.
+ *
+ ****************************************************************************/
 
-		struct inifile_var_s varinfo;
-		bool found = inifile_read_variable(priv, &varinfo);
+static bool inifile_check_index(FAR struct inifile_index_s *index)
+{
+	FAR struct inifile_entry_s *entries = inifile_entries(index);
+	FAR uint16_t *slots = inifile_slots(index);
+	uint16_t i;
 
-		/* Is there anything left in the section? */
+	if (index->strsize == 0 || inifile_strings(index)[index->strsize - 1] != '\0') {
+		return false;
+	}
 
-		if (!found) {
-			inivdbg("Returning NULL\n");
-			return NULL;
+	for (i = 0; i < index->nentries; i++) {
+		if (entries[i].section >= index->strsize || entries[i].variable >= index->strsize || entries[i].value >= index->strsize) {
+			return false;
 		}
+	}
 
-		inivdbg("varinfo.variable=\"%s\"\n", varinfo.variable);
+	for (i = 0; i < index->nslots; i++) {
+		if (slots[i] > index->nentries) {
+			return false;
+		}
+	}
 
-		/* Does the the variable name match the one we are looking for? */
+	return true;
+}
 
-		if (strcasecmp(varinfo.variable, variable) == 0) {
-			/* Yes... then we have it! */
+/****************************************************************************
+ * Name:  inifile_read_cache
+ *
+ * Description:
+ *   Read the index from the cache file if it was built from the current
+ *   INI file.
+ *
+ ****************************************************************************/
 
-			inivdbg("Returning \"%s\"\n", varinfo.value);
-			return varinfo.value;
-		}
+static FAR struct inifile_index_s *inifile_read_cache(FAR const char *path, FAR const struct stat *inistat)
+{
+	FAR struct inifile_index_s *index;
+	struct inifile_index_s hdr;
+	size_t size;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	index = NULL;
+	if (read(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+		goto errout;
+	}
+
+	if (hdr.magic != INIFILE_MAGIC || hdr.inisize != (uint32_t)inistat->st_size || hdr.inimtime != (uint32_t)inistat->st_mtime || hdr.nslots < INIFILE_MINSLOTS || (hdr.nslots & (hdr.nslots - 1)) != 0 || hdr.nentries >= hdr.nslots) {
+		inivdbg("Stale cache \"%s\"\n", path);
+		goto errout;
+	}
+
+	size = inifile_index_size(hdr.nentries, hdr.nslots, hdr.strsize);
+	index = (FAR struct inifile_index_s *)malloc(size);
+	if (!index) {
+		goto errout;
+	}
+
+	memcpy(index, &hdr, sizeof(hdr));
+	size -= sizeof(hdr);
+	if (read(fd, index + 1, size) != (ssize_t)size || !inifile_check_index(index)) {
+		free(index);
+		index = NULL;
+	}
+
+errout:
+	close(fd);
+	return index;
+}
+
+/****************************************************************************
+ * Name:  inifile_write_cache
+ *
+ * Description:
+ *   Save the index in the cache file.  Failures are not fatal; the INI file
+ *   is just parsed again the next time.
+ *
+ ****************************************************************************/
+
+static void inifile_write_cache(FAR const char *path, FAR struct inifile_index_s *index, FAR const struct stat *inistat)
+{
+	size_t size;
+	int fd;
+
+	index->inisize = (uint32_t)inistat->st_size;
+	index->inimtime = (uint32_t)inistat->st_mtime;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		inivdbg("Could not create cache \"%s\"\n", path);
+		return;
 	}
+
+	size = inifile_index_size(index->nentries, index->nslots, index->strsize);
+	if (write(fd, index, size) != (ssize_t)size) {
+		close(fd);
+		(void)unlink(path);
+		return;
+	}
+
+	close(fd);
 }
+#endif							/* CONFIG_SYSTEM_INIFILE_CACHE */
 
 /****************************************************************************
  * Name:  inifile_find_variable
  *
  * Description:
  *   Obtains the specified string value for the specified variable name
- *   within the specified section of the INI file.
+ *   within the specified section of the INI file.  Variables that are
+ *   assigned an empty value are treated as not found.
  *
  ****************************************************************************/
 
-static FAR char *inifile_find_variable(FAR struct inifile_state_s *priv, FAR const char *section, FAR const char *variable)
+static FAR char *inifile_find_variable(FAR struct inifile_index_s *index, FAR const char *section, FAR const char *variable)
 {
+	FAR struct inifile_entry_s *entry;
 	FAR char *ret = NULL;
 
 	inivdbg("section=\"%s\" variable=\"%s\"\n", section, variable);
 
-	/* Seek to the first variable in the specified section of the INI file */
-
-	if (priv->instream && inifile_seek_to_section(priv, section)) {
-		/* If the seek was successful, then find the value string within
-		 * the section
-		 */
-
-		FAR char *value = inifile_find_section_variable(priv, variable);
-		inivdbg("variable_value=0x%p\n", value);
-
-		if (value && *value) {
-			inivdbg("variable_value=\"%s\"\n", value);
-			ret = value;
+	if (index) {
+		entry = inifile_lookup(index, inifile_hash(section, variable), section, variable);
+		if (entry && inifile_strings(index)[entry->value] != '\0') {
+			ret = &inifile_strings(index)[entry->value];
+			inivdbg("variable_value=\"%s\"\n", ret);
 		}
 	}
 
@@ -477,34 +813,76 @@ static FAR char *inifile_find_variable(FAR struct inifile_state_s *priv, FAR con
  * Name:  inifile_initialize
  *
  * Description:
- *   Initialize for access to the INI file 'inifile_name'
+ *   Initialize for access to the INI file 'inifile_name'.  The file is
+ *   parsed once into an index that serves all of the lookups.
  *
  ****************************************************************************/
 
 INIHANDLE inifile_initialize(FAR const char *inifile_name)
 {
-	/* Allocate an INI file parser state structure */
+	FAR struct inifile_state_s *priv;
+	FAR struct inifile_index_s *index = NULL;
+#ifdef CONFIG_SYSTEM_INIFILE_CACHE
+	FAR char *cachepath;
+	struct stat inistat;
+	bool cacheable;
+
+	/* Use the cached index if it is up to date */
+
+	cachepath = inifile_cache_path(inifile_name);
+	cacheable = cachepath != NULL && stat(inifile_name, &inistat) == 0;
+	if (cacheable) {
+		index = inifile_read_cache(cachepath, &inistat);
+		if (index) {
+			free(cachepath);
+			return (INIHANDLE)index;
+		}
+	}
+#endif
 
-	FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)malloc(sizeof(struct inifile_state_s));
+	/* Allocate an INI file parser state structure */
 
+	priv = (FAR struct inifile_state_s *)zalloc(sizeof(struct inifile_state_s));
 	if (!priv) {
 		inidbg("ERROR: Failed to allocate state structure\n");
-		return (INIHANDLE)NULL;
+		goto errout;
 	}
 
 	/* Open the specified INI file for reading */
 
 	priv->instream = fopen(inifile_name, "r");
+	if (!priv->instream) {
+		inidbg("ERROR: Could not open \"%s\"\n", inifile_name);
+		goto errout_with_priv;
+	}
 
-	/* Prime the pump */
+	/* Parse it and index the variables */
 
-	if (priv->instream) {
-		priv->nextch = getc(priv->instream);
-		return (INIHANDLE)priv;
+	if (inifile_parse(priv) < 0) {
+		inidbg("ERROR: Failed to parse \"%s\"\n", inifile_name);
 	} else {
-		inidbg("ERROR: Could not open \"%s\"\n", inifile_name);
-		return (INIHANDLE)NULL;
+		index = inifile_build_index(priv);
+	}
+
+#ifdef CONFIG_SYSTEM_INIFILE_CACHE
+	if (index && cacheable) {
+		inifile_write_cache(cachepath, index, &inistat);
 	}
+#endif
+
+	fclose(priv->instream);
+
+errout_with_priv:
+	free(priv->entries);
+	free(priv->sections);
+	free(priv->strings);
+	free(priv);
+
+errout:
+#ifdef CONFIG_SYSTEM_INIFILE_CACHE
+	free(cachepath);
+#endif
+	return (INIHANDLE)index;
 }
 
 /****************************************************************************
@@ -517,19 +895,9 @@ INIHANDLE inifile_initialize(FAR const char *inifile_name)
 
 void inifile_uninitialize(INIHANDLE handle)
 {
-	FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)handle;
-
-	if (priv) {
-		/* Close the INI file stream */
-
-		if (priv->instream) {
-			fclose(priv->instream);
-		}
-
-		/* Release the state structure */
+	/* Release the index */
 
-		free(priv);
-	}
+	free(handle);
 }
 
 /****************************************************************************
@@ -545,13 +913,13 @@ void inifile_uninitialize(INIHANDLE handle)
 
 FAR char *inifile_read_string(INIHANDLE handle, FAR const char *section, FAR const char *variable, FAR const char *defvalue)
 {
-	FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)handle;
+	FAR struct inifile_index_s *index = (FAR struct inifile_index_s *)handle;
 	FAR char *ret = NULL;
 	FAR const char *value;
 
-	/* Get a reference to the volatile version of the string */
+	/* Get a reference to the string in the index */
 
-	value = inifile_find_variable(priv, section, variable);
+	value = inifile_find_variable(index, section, variable);
 
 	/* If the variable was not found, then use the default value */
 
@@ -561,9 +929,9 @@ FAR char *inifile_read_string(INIHANDLE handle, FAR const char *section, FAR con
 		value = defvalue;
 	}
 
-	/* If this was successful, create a non-volatile copy of the string
-	 * We do this even if the default value is used because the caller
-	 * will (eventually) deallocate it.
+	/* If this was successful, create a copy of the string.  We do this even
+	 * if the default value is used because the caller will (eventually)
+	 * deallocate it.
 	 */
 
 	if (value) {
@@ -586,7 +954,7 @@ FAR char *inifile_read_string(INIHANDLE handle, FAR const char *section, FAR con
 
 long inifile_read_integer(INIHANDLE handle, FAR const char *section, FAR const char *variable, FAR long defvalue)
 {
-	FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)handle;
+	FAR struct inifile_index_s *index = (FAR struct inifile_index_s *)handle;
 	FAR char *value;
 	long ret = defvalue;
 
@@ -596,7 +964,7 @@ long inifile_read_integer(INIHANDLE handle, FAR const char *section, FAR const c
 
 	/* Get the value as a string first */
 
-	value = inifile_find_variable(priv, section, variable);
+	value = inifile_find_variable(index, section, variable);
 
 	/* If this was successful, then convert the string to an integer value. */
 
@@ -0,0 +1,414 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/system/metricsd/metricsd_main.c
+ *
+ * Exports the kernel metrics registry.  Every interval a snapshot is taken
+ * with metrics_encode() and appended to a batch; a full batch is published
+ * as one message, an indefinite-length CBOR array of the snapshots:
+ *
+ *   [_ [ uptime ms, { name: value, ... } ], ... ]
+ *
+ * over MQTT to a topic, or over CoAP as a non-confirmable POST to a path
+ * with the application/cbor content format.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <tinyara/metrics.h>
+
+#ifdef CONFIG_NETUTILS_MQTT
+#include <apps/netutils/mqtt_api.h>
+#endif
+#ifdef CONFIG_NETUTILS_LIBCOAP
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "coap.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CBOR indefinite-length array delimiters */
+
+#define CBOR_ARRAY_START        0x9f
+#define CBOR_BREAK              0xff
+
+/* CoAP content format of application/cbor (RFC 7049) */
+
+#define METRICSD_COAP_CBOR      60
+
+/* Space for the host and the topic, which outlive the command line */
+
+#define METRICSD_NAMELEN        64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct metricsd_s {
+	volatile bool running;		/* The daemon task exists */
+	volatile bool stop;			/* Asked to exit at the next interval */
+	bool coap;					/* CoAP instead of MQTT */
+	int port;
+	int interval;				/* Seconds between snapshots */
+	int batch;					/* Snapshots per message */
+	char host[METRICSD_NAMELEN];
+	char topic[METRICSD_NAMELEN];	/* MQTT topic or CoAP path */
+#ifdef CONFIG_NETUTILS_MQTT
+	FAR mqtt_client_t *mqtt;
+	mqtt_client_config_t mqttcfg;
+#endif
+#ifdef CONFIG_NETUTILS_LIBCOAP
+	FAR coap_context_t *ctx;
+	coap_address_t dst;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct metricsd_s g_metricsd;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * metricsd_connect
+ ****************************************************************************/
+
+static int metricsd_connect(FAR struct metricsd_s *md)
+{
+#ifdef CONFIG_NETUTILS_LIBCOAP
+	if (md->coap) {
+		coap_address_t local;
+
+		coap_address_init(&md->dst);
+		md->dst.size = sizeof(struct sockaddr_in);
+		md->dst.addr.sin.sin_family = AF_INET;
+		md->dst.addr.sin.sin_port = htons(md->port ? md->port : COAP_DEFAULT_PORT);
+		if (inet_pton(AF_INET, md->host, &md->dst.addr.sin.sin_addr) != 1) {
+			fprintf(stderr, "metricsd: bad address %s\n", md->host);
+			return -EINVAL;
+		}
+
+		coap_address_init(&local);
+		local.size = sizeof(struct sockaddr_in);
+		local.addr.sin.sin_family = AF_INET;
+		local.addr.sin.sin_addr.s_addr = INADDR_ANY;
+
+		md->ctx = coap_new_context(&local);
+		return md->ctx ? OK : -ENOMEM;
+	}
+#endif
+
+#ifdef CONFIG_NETUTILS_MQTT
+	memset(&md->mqttcfg, 0, sizeof(mqtt_client_config_t));
+	md->mqttcfg.client_id = "metricsd";
+	md->mqttcfg.clean_session = true;
+	md->mqttcfg.protocol_version = MQTT_PROTOCOL_VERSION_311;
+
+	md->mqtt = mqtt_init_client(&md->mqttcfg);
+	if (!md->mqtt) {
+		return -ENOMEM;
+	}
+
+	/* The client reconnects by itself from now on */
+
+	if (mqtt_connect(md->mqtt, md->host, md->port, MQTT_DEFAULT_KEEP_ALIVE_TIME) != 0) {
+		fprintf(stderr, "metricsd: cannot connect to %s\n", md->host);
+		mqtt_deinit_client(md->mqtt);
+		md->mqtt = NULL;
+		return -ECONNREFUSED;
+	}
+
+	return OK;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * metricsd_disconnect
+ ****************************************************************************/
+
+static void metricsd_disconnect(FAR struct metricsd_s *md)
+{
+#ifdef CONFIG_NETUTILS_LIBCOAP
+	if (md->ctx) {
+		coap_free_context(md->ctx);
+		md->ctx = NULL;
+	}
+#endif
+
+#ifdef CONFIG_NETUTILS_MQTT
+	if (md->mqtt) {
+		mqtt_disconnect(md->mqtt);
+		mqtt_deinit_client(md->mqtt);
+		md->mqtt = NULL;
+	}
+#endif
+}
+
+/****************************************************************************
+ * metricsd_publish
+ ****************************************************************************/
+
+static int metricsd_publish(FAR struct metricsd_s *md, FAR uint8_t *data, size_t len)
+{
+#ifdef CONFIG_NETUTILS_LIBCOAP
+	if (md->coap) {
+		FAR coap_pdu_t *pdu;
+		unsigned char format[2];
+		FAR char *segment;
+		FAR char *next;
+		coap_tid_t tid;
+
+		pdu = coap_pdu_init(COAP_MESSAGE_NON, COAP_REQUEST_POST, coap_new_message_id(md->ctx), COAP_MAX_PDU_SIZE);
+		if (!pdu) {
+			return -ENOMEM;
+		}
+
+		/* One Uri-Path option per segment of the path */
+
+		for (segment = md->topic; *segment; segment = next) {
+			next = strchr(segment, '/');
+			if (!next) {
+				next = segment + strlen(segment);
+			}
+
+			if (next > segment) {
+				coap_add_option(pdu, COAP_OPTION_URI_PATH, next - segment, (FAR const unsigned char *)segment);
+			}
+
+			if (*next == '/') {
+				next++;
+			}
+		}
+
+		coap_add_option(pdu, COAP_OPTION_CONTENT_FORMAT, coap_encode_var_bytes(format, METRICSD_COAP_CBOR), format);
+		if (!coap_add_data(pdu, len, data)) {
+			coap_delete_pdu(pdu);
+			return -E2BIG;
+		}
+
+		tid = coap_send(md->ctx, &md->dst, pdu);
+		coap_delete_pdu(pdu);
+		return tid == COAP_INVALID_TID ? -EIO : OK;
+	}
+#endif
+
+#ifdef CONFIG_NETUTILS_MQTT
+	/* Batches taken while the broker is unreachable are dropped */
+
+	if (md->mqtt->state != MQTT_CLIENT_STATE_CONNECTED) {
+		return -ENOTCONN;
+	}
+
+	return mqtt_publish(md->mqtt, md->topic, (FAR char *)data, len, 0, 0) == 0 ? OK : -EIO;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * metricsd_daemon
+ ****************************************************************************/
+
+static int metricsd_daemon(int argc, FAR char *argv[])
+{
+	FAR struct metricsd_s *md = &g_metricsd;
+	FAR uint8_t *buffer;
+	size_t len = 0;
+	ssize_t ret;
+	int nsnapshots = 0;
+
+	buffer = (FAR uint8_t *)malloc(CONFIG_SYSTEM_METRICSD_BUFSIZE);
+	if (!buffer || metricsd_connect(md) != OK) {
+		free(buffer);
+		md->running = false;
+		return EXIT_FAILURE;
+	}
+
+	while (!md->stop) {
+		if (len == 0) {
+			buffer[len++] = CBOR_ARRAY_START;
+		}
+
+		/* Keep room for the break that closes the batch */
+
+		ret = metrics_encode(&buffer[len], CONFIG_SYSTEM_METRICSD_BUFSIZE - len - 1);
+		if (ret == -ENOSPC && nsnapshots == 0) {
+			fprintf(stderr, "metricsd: a snapshot exceeds %d bytes\n", CONFIG_SYSTEM_METRICSD_BUFSIZE);
+			break;
+		}
+
+		if (ret > 0) {
+			len += ret;
+			nsnapshots++;
+		}
+
+		/* Publish a full batch, or a partial one that leaves no room for
+		 * this snapshot, which then starts the next batch.
+		 */
+
+		if (ret < 0 || nsnapshots >= md->batch) {
+			buffer[len++] = CBOR_BREAK;
+			(void)metricsd_publish(md, buffer, len);
+			len = 0;
+			nsnapshots = 0;
+
+			if (ret < 0) {
+				continue;
+			}
+		}
+
+		sleep(md->interval);
+	}
+
+	metricsd_disconnect(md);
+	free(buffer);
+	md->running = false;
+	return EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * metricsd_usage
+ ****************************************************************************/
+
+static void metricsd_usage(FAR const char *progname)
+{
+	printf("Usage: %s [options] <host>\n", progname);
+	printf("       %s stop\n", progname);
+	printf("Options:\n");
+#ifdef CONFIG_NETUTILS_LIBCOAP
+	printf("  -c           publish over CoAP instead of MQTT, <host> is an IPv4 address\n");
+#endif
+	printf("  -p <port>    broker or server port (default 1883 or 5683)\n");
+	printf("  -i <secs>    seconds between snapshots (default %d)\n", CONFIG_SYSTEM_METRICSD_INTERVAL);
+	printf("  -n <count>   snapshots per message (default %d)\n", CONFIG_SYSTEM_METRICSD_BATCH);
+	printf("  -t <topic>   MQTT topic or CoAP path (default %s)\n", CONFIG_SYSTEM_METRICSD_TOPIC);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * metricsd_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int metricsd_main(int argc, char *argv[])
+#endif
+{
+	FAR struct metricsd_s *md = &g_metricsd;
+	FAR const char *topic;
+	int option;
+	int pid;
+
+	if (argc == 2 && strcmp(argv[1], "stop") == 0) {
+		if (!md->running) {
+			printf("metricsd is not running\n");
+			return EXIT_FAILURE;
+		}
+
+		md->stop = true;
+		return EXIT_SUCCESS;
+	}
+
+	if (md->running) {
+		printf("metricsd is already running\n");
+		return EXIT_FAILURE;
+	}
+
+	md->coap = false;
+	md->port = 0;
+	md->interval = CONFIG_SYSTEM_METRICSD_INTERVAL;
+	md->batch = CONFIG_SYSTEM_METRICSD_BATCH;
+	topic = CONFIG_SYSTEM_METRICSD_TOPIC;
+
+	while ((option = getopt(argc, argv, "cp:i:n:t:h")) != ERROR) {
+		switch (option) {
+#ifdef CONFIG_NETUTILS_LIBCOAP
+		case 'c':
+			md->coap = true;
+			break;
+#endif
+		case 'p':
+			md->port = atoi(optarg);
+			break;
+		case 'i':
+			md->interval = atoi(optarg);
+			break;
+		case 'n':
+			md->batch = atoi(optarg);
+			break;
+		case 't':
+			topic = optarg;
+			break;
+		default:
+			metricsd_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+#ifndef CONFIG_NETUTILS_MQTT
+	md->coap = true;
+#endif
+
+	if (optind != argc - 1 || md->interval <= 0 || md->batch <= 0 || strlen(argv[optind]) >= METRICSD_NAMELEN || strlen(topic) >= METRICSD_NAMELEN) {
+		metricsd_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	strcpy(md->host, argv[optind]);
+	strcpy(md->topic, topic);
+
+	md->stop = false;
+	md->running = true;
+
+	pid = task_create("metricsd", CONFIG_SYSTEM_METRICSD_PRIORITY, CONFIG_SYSTEM_METRICSD_STACKSIZE, metricsd_daemon, NULL);
+	if (pid < 0) {
+		fprintf(stderr, "metricsd: task_create failed: %d\n", errno);
+		md->running = false;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
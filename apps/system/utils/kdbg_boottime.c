@@ -0,0 +1,53 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#define BOOTTIME_PROCPATH "/proc/boottime"
+#define BOOTTIME_LINELEN  64
+
+int kdbg_boottime(int argc, char **args)
+{
+	char line[BOOTTIME_LINELEN];
+	unsigned long start;
+	unsigned long total = 0;
+	FILE *fp;
+
+	fp = fopen(BOOTTIME_PROCPATH, "r");
+	if (fp == NULL) {
+		printf("Failed to open : %s\n", BOOTTIME_PROCPATH);
+		return ERROR;
+	}
+
+	/* Print the profile as is and keep the time of the last entry */
+
+	while (fgets(line, sizeof(line), fp)) {
+		printf("%s", line);
+		start = strtoul(line, NULL, 10);
+		if (start > total) {
+			total = start;
+		}
+	}
+
+	printf("Last stage reached at %lu.%03lu ms\n", total / 1000, total % 1000);
+
+	fclose(fp);
+	return OK;
+}
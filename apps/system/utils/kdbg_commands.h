@@ -21,6 +21,10 @@
 
 #include <tinyara/config.h>
 
+#if defined(CONFIG_ENABLE_BOOTTIME)
+int kdbg_boottime(int argc, char **args);
+#endif
+
 #if defined(CONFIG_ENABLE_DATE)
 int kdbg_date(int argc, char **args);
 #endif
@@ -56,6 +56,9 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#ifdef CONFIG_MM_REGION_POLICY
+#include <tinyara/mm/mm.h>
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -72,6 +75,19 @@ int kdbg_free(int argc, char **args)
 
 	printf("              total       used       free    largest\n");
 	printf("Data:   %11d%11d%11d%11d\n", data.arena, data.uordblks, data.fordblks, data.mxordblk);
+#ifdef CONFIG_MM_TASK_CACHE
+	printf("Cache:  %11s%11s\n", "hits", "misses");
+	printf("        %11d%11d\n", data.cachehits, data.cachemisses);
+#endif
+#ifdef CONFIG_MM_REGION_POLICY
+	{
+		int i;
+
+		for (i = 0; i < data.nregions; i++) {
+			printf("%-4s%d:  %11d%11d%11d%11d\n", data.regions[i].tag == MM_REGION_SLOW ? "Slow" : "Fast", i, data.regions[i].arena, data.regions[i].uordblks, data.regions[i].fordblks, data.regions[i].mxordblk);
+		}
+	}
+#endif
 
 	return OK;
 }
@@ -53,6 +53,9 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <tinyara/sched.h>
+#ifdef CONFIG_SCHED_CPUTIME
+#include <tinyara/clock.h>
+#endif
 
 static const char *kdbg_statenames[] = {
 	"INVALID ",
@@ -79,7 +82,15 @@ static const char *kdbg_ttypenames[4] = {
 
 static void kdbg_pseach(FAR struct tcb_s *tcb, FAR void *arg)
 {
+#ifdef CONFIG_SCHED_CPUTIME
+	uint64_t usec = 0;
+#endif
+
 	printf("%5d | %4d | %4s | %7s | %c%c | %8s", tcb->pid, tcb->sched_priority, tcb->flags & TCB_FLAG_ROUND_ROBIN ? "RR  " : "FIFO", kdbg_ttypenames[(tcb->flags & TCB_FLAG_TTYPE_MASK) >> TCB_FLAG_TTYPE_SHIFT], tcb->flags & TCB_FLAG_NONCANCELABLE ? 'N' : ' ', tcb->flags & TCB_FLAG_CANCEL_PENDING ? 'P' : ' ', kdbg_statenames[tcb->task_state]);
+#ifdef CONFIG_SCHED_CPUTIME
+	(void)clock_cputime(tcb->pid, &usec);
+	printf(" | %6lu.%06lu", (unsigned long)(usec / 1000000), (unsigned long)(usec % 1000000));
+#endif
 #if CONFIG_TASK_NAME_SIZE > 0
 	printf(" | %s", tcb->name);
 #endif
@@ -88,6 +99,17 @@ static void kdbg_pseach(FAR struct tcb_s *tcb, FAR void *arg)
 
 int kdbg_ps(int argc, char **args)
 {
+#ifdef CONFIG_SCHED_CPUTIME
+#if CONFIG_TASK_NAME_SIZE > 0
+	printf("\n");
+	printf("  PID | PRIO | FLAG |  TYPE   | NP |  STATUS  |  CPU TIME(s)  | NAME\n");
+	printf("------|------|------|---------|----|----------|---------------|----------\n");
+#else
+	printf("\n");
+	printf("  PID | PRIO | FLAG |  TYPE   | NP |  STATUS  |  CPU TIME(s)\n");
+	printf("------|------|------|---------|----|----------|--------------\n");
+#endif
+#else
 #if CONFIG_TASK_NAME_SIZE > 0
 	printf("\n");
 	printf("  PID | PRIO | FLAG |  TYPE   | NP |  STATUS  | NAME\n");
@@ -96,6 +118,7 @@ int kdbg_ps(int argc, char **args)
 	printf("\n");
 	printf("  PID | PRIO | FLAG |  TYPE   | NP |  STATUS\n");
 	printf("------|------|------|---------|----|--------\n");
+#endif
 #endif
 	sched_foreach(kdbg_pseach, NULL);
 	return 0;
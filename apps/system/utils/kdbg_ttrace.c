@@ -41,6 +41,7 @@ static const struct tag_list ttrace_tags[] = {
 	{"lock",    "Lock",          TTRACE_TAG_LOCK},
 	{"task",    "TASK",          TTRACE_TAG_TASK},
 	{"ipc",     "IPC",           TTRACE_TAG_IPC},
+	{"irq",     "Interrupts",    TTRACE_TAG_IRQ},
 };
 
 int param = 0;
@@ -49,6 +50,7 @@ int is_overwritable = 0;
 
 static void show_help(void);
 void wait_ttrace_dump(void);
+static int run_cmd(FILE *fp, int cmd, int arg);
 
 static int print_uid_packet(struct trace_packet *packet)
 {
@@ -100,6 +102,162 @@ static int print_packet(struct trace_packet *packet)
 	}
 }
 
+#ifdef CONFIG_TTRACE_EVENTS
+/* Binary events are exported in the Chrome trace event format, which
+ * chrome://tracing and Perfetto read.  Tasks are the threads of process 0
+ * and interrupts the threads of process 1.  Only one CPU is assumed, so
+ * the running task and the nesting of interrupts are tracked here.
+ */
+
+#define JSON_NEVENTS     32
+#define JSON_IRQ_NEST    8
+
+struct json_state {
+	uint32_t cpu_mhz;            /* Cycles per microsecond */
+	uint32_t last_cycles;        /* Cycle counter of the previous event */
+	uint64_t now;                /* Cycles since the first event */
+	int16_t run_pid;             /* Running task, -1 if not known yet */
+	uint64_t run_start;          /* When it started to run */
+	int irq_depth;
+	uint32_t irq_num[JSON_IRQ_NEST];
+	uint64_t irq_start[JSON_IRQ_NEST];
+	bool started;                /* An event was seen */
+	bool first;                  /* Nothing printed in the array yet */
+};
+
+static void json_time(struct json_state *st, const char *key, uint64_t cycles)
+{
+	uint64_t usec = cycles / st->cpu_mhz;
+	uint32_t frac = (uint32_t)((cycles % st->cpu_mhz) * 1000 / st->cpu_mhz);
+
+	printf("\"%s\":%lu.%03u", key, (unsigned long)usec, frac);
+}
+
+static void json_begin(struct json_state *st)
+{
+	printf("%s\r\n{", st->first ? "" : ",");
+	st->first = false;
+}
+
+static void json_complete(struct json_state *st, const char *name, int num, int pid, int tid, uint64_t start)
+{
+	json_begin(st);
+	printf("\"name\":\"%s %d\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,", name, num, pid, tid);
+	json_time(st, "ts", start);
+	printf(",");
+	json_time(st, "dur", st->now - start);
+	printf("}");
+}
+
+static void json_instant(struct json_state *st, const char *name, int tid, uint32_t arg)
+{
+	json_begin(st);
+	printf("\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":%d,", name, tid);
+	json_time(st, "ts", st->now);
+	printf(",\"args\":{\"arg\":\"0x%08x\"}}", arg);
+}
+
+static void json_event(struct json_state *st, struct ttrace_event_s *event)
+{
+	if (!st->started) {
+		st->last_cycles = event->cycles;
+		st->started = true;
+	}
+
+	st->now += (uint32_t)(event->cycles - st->last_cycles);
+	st->last_cycles = event->cycles;
+
+	switch (event->id) {
+	case TTRACE_EVENT_SWITCH:
+		if (st->run_pid >= 0) {
+			json_complete(st, "pid", st->run_pid, 0, st->run_pid, st->run_start);
+		}
+		st->run_pid = (int16_t)event->arg;
+		st->run_start = st->now;
+		break;
+	case TTRACE_EVENT_IRQ_ENTER:
+		if (st->irq_depth < JSON_IRQ_NEST) {
+			st->irq_num[st->irq_depth] = event->arg;
+			st->irq_start[st->irq_depth] = st->now;
+		}
+		st->irq_depth++;
+		break;
+	case TTRACE_EVENT_IRQ_EXIT:
+		if (st->irq_depth > 0) {
+			st->irq_depth--;
+			if (st->irq_depth < JSON_IRQ_NEST && st->irq_num[st->irq_depth] == event->arg) {
+				json_complete(st, "irq", event->arg, 1, event->arg, st->irq_start[st->irq_depth]);
+			}
+		}
+		break;
+	case TTRACE_EVENT_SEM_BLOCK:
+		json_instant(st, "sem_wait", event->pid, event->arg);
+		break;
+	case TTRACE_EVENT_TASK_START:
+		json_instant(st, "task_start", event->pid, 0);
+		break;
+	case TTRACE_EVENT_TASK_STOP:
+		json_instant(st, "task_stop", event->pid, 0);
+		break;
+	default:
+		break;
+	}
+}
+
+static int print_events_json(FILE *file)
+{
+	struct ttrace_event_s *events;
+	struct ttrace_eventreq_s req;
+	struct json_state st;
+	uint32_t nlost = 0;
+	uint32_t i;
+	int ret;
+
+	events = (struct ttrace_event_s *)malloc(JSON_NEVENTS * sizeof(struct ttrace_event_s));
+	if (events == NULL) {
+		printf("Failed to allocate event buffer in ttrace\r\n");
+		return TTRACE_INVALID;
+	}
+
+	memset(&st, 0, sizeof(st));
+	st.run_pid = -1;
+	st.first = true;
+
+	printf("{\"traceEvents\":[");
+	json_begin(&st);
+	printf("\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"Tasks\"}}");
+	json_begin(&st);
+	printf("\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Interrupts\"}}");
+
+	do {
+		req.events = events;
+		req.nevents = JSON_NEVENTS;
+		ret = run_cmd(file, TTRACE_GET_EVENTS, (int)&req);
+		if (ret < 0) {
+			break;
+		}
+
+		nlost += req.nlost;
+		st.cpu_mhz = req.cycles_per_usec > 0 ? req.cycles_per_usec : 1;
+
+		for (i = 0; i < req.nevents; i++) {
+			json_event(&st, &events[i]);
+		}
+	} while (req.nevents == JSON_NEVENTS);
+
+	/* Close the slice of the task that was running at the end */
+
+	if (st.run_pid >= 0) {
+		json_complete(&st, "pid", st.run_pid, 0, st.run_pid, st.run_start);
+	}
+
+	printf("\r\n],\"otherData\":{\"lost_events\":\"%u\"}}\r\n", nlost);
+
+	free(events);
+	return ret < 0 ? TTRACE_INVALID : TTRACE_VALID;
+}
+#endif
+
 static void show_help()
 {
 	printf("usage: ttrace [opions] [tags...]\r\n");
@@ -110,6 +268,9 @@ static void show_help()
 	printf("    -i     Show information(state, available/selected/TP used tags, bufsize)\r\n");
 	printf("    -d     Dump trace buffer, It should be run after finish\r\n");
 	printf("    -p     Print trace buffer, It should be run after finish\r\n");
+#ifdef CONFIG_TTRACE_EVENTS
+	printf("    -j     Print binary events as Chrome trace JSON, It should be run after finish\r\n");
+#endif
 }
 
 static int assign_tag(char *name)
@@ -141,10 +302,11 @@ static int parse_args(int argc, char **args)
 	 * -g : TTRACE_FUNC_TAG, TP's tag(hidden to user)
 	 * -d : TTRACE_DUMP, dump mode(hang), It should be run after finish.
 	 * -p : TTRACE_PRINT, print traces, It should be run after finish.
+	 * -j : TTRACE_JSON, print binary events in JSON, after finish.
 	 */
 	while (1) {
 		optarg = NULL;
-		ret = getopt(argc, args, "sofidpb:");
+		ret = getopt(argc, args, "sofidpjb:");
 		if (ret == '?') {
 			show_help();
 			return TTRACE_INVALID;
@@ -285,6 +447,11 @@ static int send_cmds(FILE *file, int cmd)
 		ret = read_tracebuffer(file, bufsize);
 		return ret;
 	}
+#ifdef CONFIG_TTRACE_EVENTS
+	else if (cmd == TTRACE_JSON) {
+		return print_events_json(file);
+	}
+#endif
 
 	if (run_cmd(file, cmd, param) == TTRACE_INVALID) {
 		return TTRACE_INVALID;
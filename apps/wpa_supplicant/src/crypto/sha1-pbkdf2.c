@@ -10,15 +10,92 @@
 
 #include "common.h"
 #include "sha1.h"
+#include "crypto.h"
+#ifdef CONFIG_CRYPTO_INTERNAL
+#include "sha1_i.h"
+#endif
+
+#ifdef CONFIG_WPA_SUPPLICANT_PMK_CACHE
+/* A derived key is stored under a digest of everything it depends on, so a
+ * changed passphrase or SSID simply misses. The file holds the PMKs and must
+ * be protected like the configuration file holding the passphrases. */
+#define PBKDF2_CACHE_KEY_LEN 32
+
+struct pbkdf2_cache_entry {
+	u8 tag[SHA1_MAC_LEN];
+	u8 key[PBKDF2_CACHE_KEY_LEN];
+};
+#endif
+
+#ifdef CONFIG_CRYPTO_INTERNAL
+/*
+ * HMAC-SHA1 of a single SHA1_MAC_LEN message, with the ipad and opad key
+ * blocks already absorbed into istate and ostate. The padded message fits
+ * one block, so each inner and outer hash is a single compression instead of
+ * the four that hmac_sha1() spends re-hashing the key pads every iteration.
+ */
+static void pbkdf2_sha1_hmac_block(const u32 istate[5], const u32 ostate[5], const u8 *msg, u8 *mac)
+{
+	u8 block[64];
+	u32 state[5];
+	int i;
+
+	os_memset(block, 0, sizeof(block));
+	os_memcpy(block, msg, SHA1_MAC_LEN);
+	block[SHA1_MAC_LEN] = 0x80;
+	/* Message length in bits, including the 64-byte pad block: 84 * 8 */
+	block[62] = 0x02;
+	block[63] = 0xa0;
+
+	os_memcpy(state, istate, sizeof(state));
+	SHA1Transform(state, block);
+	for (i = 0; i < 5; i++) {
+		WPA_PUT_BE32(&block[4 * i], state[i]);
+	}
+
+	/* The padding after the inner digest is the same for the outer hash */
+	os_memcpy(state, ostate, sizeof(state));
+	SHA1Transform(state, block);
+	for (i = 0; i < 5; i++) {
+		WPA_PUT_BE32(&mac[4 * i], state[i]);
+	}
+}
+
+static void pbkdf2_sha1_pad_state(const u8 *key, size_t key_len, u8 pad, u32 state[5])
+{
+	struct SHA1Context ctx;
+	u8 block[64];
+	size_t i;
+
+	os_memset(block, 0, sizeof(block));
+	os_memcpy(block, key, key_len);
+	for (i = 0; i < sizeof(block); i++) {
+		block[i] ^= pad;
+	}
+
+	SHA1Init(&ctx);
+	os_memcpy(state, ctx.state, sizeof(ctx.state));
+	SHA1Transform(state, block);
+	os_memset(block, 0, sizeof(block));
+}
+#endif							/* CONFIG_CRYPTO_INTERNAL */
 
 static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid, size_t ssid_len, int iterations, unsigned int count, u8 *digest)
 {
-	unsigned char tmp[SHA1_MAC_LEN], tmp2[SHA1_MAC_LEN];
+	unsigned char tmp[SHA1_MAC_LEN];
 	int i, j;
 	unsigned char count_buf[4];
 	const u8 *addr[2];
 	size_t len[2];
 	size_t passphrase_len = os_strlen(passphrase);
+#ifdef CONFIG_CRYPTO_INTERNAL
+	u32 istate[5], ostate[5];
+	const u8 *key = (const u8 *)passphrase;
+	size_t key_len = passphrase_len;
+	u8 tk[SHA1_MAC_LEN];
+#else
+	unsigned char tmp2[SHA1_MAC_LEN];
+#endif
 
 	addr[0] = ssid;
 	len[0] = ssid_len;
@@ -40,6 +117,28 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid, size_t ssid_len
 	}
 	os_memcpy(digest, tmp, SHA1_MAC_LEN);
 
+#ifdef CONFIG_CRYPTO_INTERNAL
+	if (key_len > 64) {
+		if (sha1_vector(1, &key, &key_len, tk)) {
+			return -1;
+		}
+		key = tk;
+		key_len = SHA1_MAC_LEN;
+	}
+	pbkdf2_sha1_pad_state(key, key_len, 0x36, istate);
+	pbkdf2_sha1_pad_state(key, key_len, 0x5c, ostate);
+
+	for (i = 1; i < iterations; i++) {
+		pbkdf2_sha1_hmac_block(istate, ostate, tmp, tmp);
+		for (j = 0; j < SHA1_MAC_LEN; j++) {
+			digest[j] ^= tmp[j];
+		}
+	}
+
+	os_memset(istate, 0, sizeof(istate));
+	os_memset(ostate, 0, sizeof(ostate));
+	os_memset(tk, 0, sizeof(tk));
+#else
 	for (i = 1; i < iterations; i++) {
 		if (hmac_sha1((u8 *)passphrase, passphrase_len, tmp, SHA1_MAC_LEN, tmp2)) {
 			return -1;
@@ -49,10 +148,85 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid, size_t ssid_len
 			digest[j] ^= tmp2[j];
 		}
 	}
+#endif
 
 	return 0;
 }
 
+static int pbkdf2_sha1_derive(const char *passphrase, const u8 *ssid, size_t ssid_len, int iterations, u8 *buf, size_t buflen)
+{
+	unsigned int count = 0;
+	unsigned char *pos = buf;
+	size_t left = buflen, plen;
+	unsigned char digest[SHA1_MAC_LEN];
+
+	while (left > 0) {
+		count++;
+		if (pbkdf2_sha1_f(passphrase, ssid, ssid_len, iterations, count, digest)) {
+			return -1;
+		}
+		plen = left > SHA1_MAC_LEN ? SHA1_MAC_LEN : left;
+		os_memcpy(pos, digest, plen);
+		pos += plen;
+		left -= plen;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_WPA_SUPPLICANT_PMK_CACHE
+static int pbkdf2_cache_tag(const char *passphrase, const u8 *ssid, size_t ssid_len, int iterations, size_t buflen, u8 *tag)
+{
+	u8 params[12];
+	const u8 *addr[3];
+	size_t len[3];
+
+	WPA_PUT_BE32(params, iterations);
+	WPA_PUT_BE32(&params[4], buflen);
+	WPA_PUT_BE32(&params[8], ssid_len);
+
+	addr[0] = params;
+	len[0] = sizeof(params);
+	addr[1] = ssid;
+	len[1] = ssid_len;
+	addr[2] = (const u8 *)passphrase;
+	len[2] = os_strlen(passphrase);
+
+	return sha1_vector(3, addr, len, tag);
+}
+
+static size_t pbkdf2_cache_load(struct pbkdf2_cache_entry *cache)
+{
+	FILE *f;
+	size_t n;
+
+	f = fopen(CONFIG_WPA_SUPPLICANT_PMK_CACHE_PATH, "rb");
+	if (f == NULL) {
+		return 0;
+	}
+
+	n = fread(cache, sizeof(*cache), CONFIG_WPA_SUPPLICANT_PMK_CACHE_ENTRIES, f);
+	fclose(f);
+	return n;
+}
+
+static void pbkdf2_cache_store(const struct pbkdf2_cache_entry *cache, size_t n)
+{
+	FILE *f;
+
+	f = fopen(CONFIG_WPA_SUPPLICANT_PMK_CACHE_PATH, "wb");
+	if (f == NULL) {
+		wpa_printf(MSG_DEBUG, "PBKDF2: cannot write %s", CONFIG_WPA_SUPPLICANT_PMK_CACHE_PATH);
+		return;
+	}
+
+	if (fwrite(cache, sizeof(*cache), n, f) != n) {
+		wpa_printf(MSG_DEBUG, "PBKDF2: short write to %s", CONFIG_WPA_SUPPLICANT_PMK_CACHE_PATH);
+	}
+	fclose(f);
+}
+#endif							/* CONFIG_WPA_SUPPLICANT_PMK_CACHE */
+
 /**
  * pbkdf2_sha1 - SHA1-based key derivation function (PBKDF2) for IEEE 802.11i
  * @passphrase: ASCII passphrase
@@ -66,24 +240,49 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid, size_t ssid_len
  * This function is used to derive PSK for WPA-PSK. For this protocol,
  * iterations is set to 4096 and buflen to 32. This function is described in
  * IEEE Std 802.11-2004, Clause H.4. The main construction is from PKCS#5 v2.0.
+ *
+ * With CONFIG_WPA_SUPPLICANT_PMK_CACHE, keys of up to 32 bytes are kept in a
+ * small file so that reconnecting with an unchanged passphrase and SSID skips
+ * the derivation.
  */
 int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len, int iterations, u8 *buf, size_t buflen)
 {
-	unsigned int count = 0;
-	unsigned char *pos = buf;
-	size_t left = buflen, plen;
-	unsigned char digest[SHA1_MAC_LEN];
+#ifdef CONFIG_WPA_SUPPLICANT_PMK_CACHE
+	struct pbkdf2_cache_entry cache[CONFIG_WPA_SUPPLICANT_PMK_CACHE_ENTRIES];
+	u8 tag[SHA1_MAC_LEN];
+	size_t n;
+	size_t i;
+	int ret;
 
-	while (left > 0) {
-		count++;
-		if (pbkdf2_sha1_f(passphrase, ssid, ssid_len, iterations, count, digest)) {
-			return -1;
+	if (buflen > PBKDF2_CACHE_KEY_LEN || pbkdf2_cache_tag(passphrase, ssid, ssid_len, iterations, buflen, tag)) {
+		return pbkdf2_sha1_derive(passphrase, ssid, ssid_len, iterations, buf, buflen);
+	}
+
+	n = pbkdf2_cache_load(cache);
+	for (i = 0; i < n; i++) {
+		if (os_memcmp(cache[i].tag, tag, SHA1_MAC_LEN) == 0) {
+			os_memcpy(buf, cache[i].key, buflen);
+			os_memset(cache, 0, sizeof(cache));
+			return 0;
 		}
-		plen = left > SHA1_MAC_LEN ? SHA1_MAC_LEN : left;
-		os_memcpy(pos, digest, plen);
-		pos += plen;
-		left -= plen;
 	}
 
-	return 0;
+	ret = pbkdf2_sha1_derive(passphrase, ssid, ssid_len, iterations, buf, buflen);
+	if (ret == 0) {
+		/* Newest first; the oldest entry drops off the end */
+		if (n == CONFIG_WPA_SUPPLICANT_PMK_CACHE_ENTRIES) {
+			n--;
+		}
+		os_memmove(&cache[1], &cache[0], n * sizeof(cache[0]));
+		os_memset(&cache[0], 0, sizeof(cache[0]));
+		os_memcpy(cache[0].tag, tag, SHA1_MAC_LEN);
+		os_memcpy(cache[0].key, buf, buflen);
+		pbkdf2_cache_store(cache, n + 1);
+	}
+
+	os_memset(cache, 0, sizeof(cache));
+	return ret;
+#else
+	return pbkdf2_sha1_derive(passphrase, ssid, ssid_len, iterations, buf, buflen);
+#endif
 }
@@ -151,6 +151,8 @@ typedef enum {
 			MUTEX_UNLOCK_ERROR = -48,
 	/** Mutex destroy failed */
 			MUTEX_DESTROY_ERROR = -49,
+	/** All in-flight publish slots are waiting for a PUBACK */
+			MQTT_MAX_INFLIGHT_PUBLISHES_REACHED_ERROR = -50,
 } IoT_Error_t;
 
 #ifdef __cplusplus
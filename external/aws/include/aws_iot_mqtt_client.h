@@ -63,6 +63,12 @@ extern "C" {
 
 #define MAX_PACKET_ID 65535
 
+/* Number of QoS1 publishes sent with aws_iot_mqtt_publish_async() that may
+ * wait for their PUBACK at the same time. Override in aws_iot_config.h */
+#ifndef AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES
+#define AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES 4
+#endif
+
 typedef struct _Client AWS_IoT_Client;
 
 /**
@@ -235,6 +241,32 @@ typedef struct _MessageHandlers {
 	void *pApplicationHandlerData;
 } MessageHandlers;   /* Message handlers are indexed by subscription topic */
 
+/**
+ * @brief Publish Acknowledgement Callback
+ *
+ * Defining a TYPE for definition of the callback invoked once a QoS1 publish
+ * sent with aws_iot_mqtt_publish_async() completes. The result is SUCCESS when
+ * the PUBACK arrived and MQTT_REQUEST_TIMEOUT_ERROR when it did not arrive
+ * within the command timeout
+ *
+ */
+typedef void (*pPublishAckHandler_t)(AWS_IoT_Client *pClient, uint16_t packetId, IoT_Error_t result,
+									 void *pAckHandlerData);
+
+/**
+ * @brief MQTT In-flight Publish
+ *
+ * Defining a type for a QoS1 publish waiting for its PUBACK.
+ * A packetId of 0 marks a free entry
+ *
+ */
+typedef struct _InflightPublish {
+	uint16_t packetId;
+	Timer timer;
+	pPublishAckHandler_t pAckHandler;
+	void *pAckHandlerData;
+} InflightPublish;
+
 /**
  * @brief MQTT Client Status
  *
@@ -283,6 +315,9 @@ typedef struct _ClientData {
 	IoT_Client_Connect_Params options;
 
 	MessageHandlers messageHandlers[AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS];
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	InflightPublish inflightPublishes[AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES];
+#endif
 	iot_disconnect_handler disconnectHandler;
 
 	void *disconnectHandlerData;
@@ -100,6 +100,30 @@ IoT_Error_t aws_iot_mqtt_connect(AWS_IoT_Client *pClient, IoT_Client_Connect_Par
 IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
 								 IoT_Publish_Message_Params *pParams);
 
+/**
+ * @brief Publish an MQTT message on a topic without waiting for the PUBACK
+ *
+ * Called to publish an MQTT message on a topic.
+ * @note The function returns once the message was passed to the TLS layer.  A QoS 1
+ * publish stays in flight until yield receives its PUBACK or the command timeout expires,
+ * and pAckHandler is then called with SUCCESS or MQTT_REQUEST_TIMEOUT_ERROR.  At most
+ * AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES publishes can be in flight, further ones fail with
+ * MQTT_MAX_INFLIGHT_PUBLISHES_REACHED_ERROR.  The payload is written directly from
+ * pParams->payload, so it is not limited by AWS_IOT_MQTT_TX_BUF_LEN.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicName Topic Name to publish to
+ * @param topicNameLen Length of the topic name
+ * @param pParams Pointer to Publish Message parameters, receives the packet id
+ * @param pAckHandler Callback for the QoS 1 outcome, may be NULL
+ * @param pAckHandlerData Data passed to pAckHandler
+ *
+ * @return An IoT Error Type defining successful/failed send
+ */
+IoT_Error_t aws_iot_mqtt_publish_async(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+									   IoT_Publish_Message_Params *pParams, pPublishAckHandler_t pAckHandler,
+									   void *pAckHandlerData);
+
 /**
  * @brief Subscribe to an MQTT topic.
  *
@@ -177,6 +201,39 @@ IoT_Error_t aws_iot_mqtt_disconnect(AWS_IoT_Client *pClient);
  */
 IoT_Error_t aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms);
 
+/**
+ * @brief Yield to the MQTT client without blocking
+ *
+ * Event loop variant of aws_iot_mqtt_yield(). Processes only the packets that have
+ * already been received, plus the keepalive, in-flight publish timeouts and a pending
+ * reconnect, then returns. Call it when the socket from aws_iot_mqtt_get_socket()
+ * polls readable or aws_iot_mqtt_get_next_timeout_ms() has elapsed.
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return An IoT Error Type defining successful/failed client processing.
+ */
+IoT_Error_t aws_iot_mqtt_yield_nonblocking(AWS_IoT_Client *pClient);
+
+/**
+ * @brief Get the socket of the MQTT connection
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return Socket descriptor to wait on with poll(), -1 if the client is not connected
+ */
+int aws_iot_mqtt_get_socket(AWS_IoT_Client *pClient);
+
+/**
+ * @brief Time until the client needs to run without incoming data
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return Milliseconds until the next keepalive, reconnect attempt or in-flight
+ *         publish timeout, UINT32_MAX if nothing is scheduled
+ */
+uint32_t aws_iot_mqtt_get_next_timeout_ms(AWS_IoT_Client *pClient);
+
 /**
  * @brief MQTT Manual Re-Connection Function
  *
@@ -70,6 +70,8 @@ struct Network {
 	IoT_Error_t (*disconnect)(Network *);    ///< Function pointer pointing to the network function to disconnect from the network
 	IoT_Error_t (*isConnected)(Network *);    ///< Function pointer pointing to the network function to check if TLS is connected
 	IoT_Error_t (*destroy)(Network *);        ///< Function pointer pointing to the network function to destroy the network object
+	int (*getSocket)(Network *);            ///< Optional. Function pointer returning the descriptor of the underlying socket, for use with poll()
+	bool (*isReadable)(Network *);            ///< Optional. Function pointer checking without blocking whether received data is waiting to be read
 
 	TLSConnectParams tlsConnectParams;        ///< TLSConnect params structure containing the common connection parameters
 	TLSDataParams tlsDataParams;            ///< TLSData params structure containing the connection data parameters that are specific to the library being used
@@ -160,6 +162,28 @@ IoT_Error_t iot_tls_destroy(Network *pNetwork);
  */
 IoT_Error_t iot_tls_is_connected(Network *pNetwork);
 
+/**
+ * @brief Get the socket underlying the TLS connection
+ *
+ * The descriptor may be passed to poll() by an event loop that waits for
+ * incoming data before calling the non-blocking yield.
+ *
+ * @param Network - Pointer to a Network struct defining the network interface
+ * @return int - socket descriptor or -1 if not connected
+ */
+int iot_tls_get_socket(Network *pNetwork);
+
+/**
+ * @brief Check without blocking whether data is waiting to be read
+ *
+ * Both records already decrypted by the TLS layer and bytes still queued on
+ * the socket count as readable.
+ *
+ * @param Network - Pointer to a Network struct defining the network interface
+ * @return bool - true if a read would not have to wait for the peer
+ */
+bool iot_tls_is_readable(Network *pNetwork);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,6 +19,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <string.h>
+#include <poll.h>
 #include <timer_platform.h>
 #include <network_interface.h>
 
@@ -77,6 +78,8 @@ IoT_Error_t iot_tls_init(Network *pNetwork, char *pRootCALocation, char *pDevice
 	pNetwork->disconnect = iot_tls_disconnect;
 	pNetwork->isConnected = iot_tls_is_connected;
 	pNetwork->destroy = iot_tls_destroy;
+	pNetwork->getSocket = iot_tls_get_socket;
+	pNetwork->isReadable = iot_tls_is_readable;
 
 	pNetwork->tlsDataParams.flags = 0;
 
@@ -352,6 +355,29 @@ IoT_Error_t iot_tls_disconnect(Network *pNetwork) {
 	return SUCCESS;
 }
 
+int iot_tls_get_socket(Network *pNetwork) {
+	return pNetwork->tlsDataParams.server_fd.fd;
+}
+
+bool iot_tls_is_readable(Network *pNetwork) {
+	TLSDataParams *tlsDataParams = &(pNetwork->tlsDataParams);
+	struct pollfd pfd;
+
+	if(mbedtls_ssl_get_bytes_avail(&(tlsDataParams->ssl)) > 0) {
+		return true;
+	}
+
+	if(tlsDataParams->server_fd.fd < 0) {
+		return false;
+	}
+
+	/* Hang-ups and errors count as readable so the read reports them */
+	pfd.fd = tlsDataParams->server_fd.fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) > 0;
+}
+
 IoT_Error_t iot_tls_destroy(Network *pNetwork) {
 	TLSDataParams *tlsDataParams = &(pNetwork->tlsDataParams);
 
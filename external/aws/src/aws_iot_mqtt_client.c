@@ -172,6 +172,14 @@ IoT_Error_t aws_iot_mqtt_init(AWS_IoT_Client *pClient, IoT_Client_Init_Params *p
 		pClient->clientData.messageHandlers[i].qos = QOS0;
 	}
 
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	for(i = 0; i < AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES; ++i) {
+		pClient->clientData.inflightPublishes[i].packetId = 0;
+		pClient->clientData.inflightPublishes[i].pAckHandler = NULL;
+		pClient->clientData.inflightPublishes[i].pAckHandlerData = NULL;
+	}
+#endif
+
 	pClient->clientData.packetTimeoutMs = pInitParams->mqttPacketTimeout_ms;
 	pClient->clientData.commandTimeoutMs = pInitParams->mqttCommandTimeout_ms;
 	pClient->clientData.writeBufSize = AWS_IOT_MQTT_TX_BUF_LEN;
@@ -264,14 +264,46 @@ IoT_Error_t aws_iot_mqtt_internal_init_header(MQTTHeader *pHeader, MessageTypes
 	FUNC_EXIT_RC(SUCCESS);
 }
 
+/* Writes the whole buffer unless the timer expires or the network fails.
+ * The caller holds the write mutex. */
+static size_t _aws_iot_mqtt_internal_write_all(AWS_IoT_Client *pClient, const unsigned char *pBuf, size_t length,
+											   Timer *pTimer) {
+	size_t sentLen, sent;
+	IoT_Error_t rc;
+
+	sentLen = 0;
+	sent = 0;
+
+	while(sent < length && !has_timer_expired(pTimer)) {
+		rc = pClient->networkStack.write(&(pClient->networkStack), (unsigned char *) &pBuf[sent], length - sent,
+										 pTimer, &sentLen);
+		if(SUCCESS != rc) {
+			/* there was an error writing the data */
+			break;
+		}
+		sent += sentLen;
+	}
+
+	return sent;
+}
+
 IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t length, Timer *pTimer) {
+	FUNC_ENTRY;
 
-	size_t sentLen, sent;
+	FUNC_EXIT_RC(aws_iot_mqtt_internal_send_packet_with_payload(pClient, length, NULL, 0, pTimer));
+}
+
+IoT_Error_t aws_iot_mqtt_internal_send_packet_with_payload(AWS_IoT_Client *pClient, size_t length,
+														   const unsigned char *pPayload, size_t payloadLen,
+														   Timer *pTimer) {
+	size_t sent;
+#ifdef _ENABLE_THREAD_SUPPORT_
 	IoT_Error_t rc;
+#endif
 
 	FUNC_ENTRY;
 
-	if(NULL == pClient || NULL == pTimer) {
+	if(NULL == pClient || NULL == pTimer || (NULL == pPayload && 0 < payloadLen)) {
 		FUNC_EXIT_RC(NULL_VALUE_ERROR);
 	}
 
@@ -286,17 +318,11 @@ IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t le
 	}
 #endif
 
-	sentLen = 0;
-	sent = 0;
-
-	while(sent < length && !has_timer_expired(pTimer)) {
-		rc = pClient->networkStack.write(&(pClient->networkStack), &pClient->clientData.writeBuf[sent], length, pTimer,
-										 &sentLen);
-		if(SUCCESS != rc) {
-			/* there was an error writing the data */
-			break;
-		}
-		sent += sentLen;
+	/* The payload goes out straight from the caller's buffer, under the same
+	 * lock so no other packet can be interleaved with this one */
+	sent = _aws_iot_mqtt_internal_write_all(pClient, pClient->clientData.writeBuf, length, pTimer);
+	if(sent == length && 0 < payloadLen) {
+		sent += _aws_iot_mqtt_internal_write_all(pClient, pPayload, payloadLen, pTimer);
 	}
 
 #ifdef _ENABLE_THREAD_SUPPORT_
@@ -306,7 +332,7 @@ IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t le
 	}
 #endif
 
-	if(sent == length) {
+	if(sent == length + payloadLen) {
 		/* record the fact that we have successfully sent the packet */
 		//countdown_sec(&c->pingTimer, c->clientData.keepAliveInterval);
 		FUNC_EXIT_RC(SUCCESS);
@@ -581,8 +607,15 @@ IoT_Error_t aws_iot_mqtt_internal_cycle_read(AWS_IoT_Client *pClient, Timer *pTi
 	}
 
 	switch(*pPacketType) {
-		case CONNACK:
 		case PUBACK:
+			/* Acks of asynchronous publishes are completed here. Report them
+			 * as no packet so a blocking publish waiting for its own PUBACK
+			 * does not take them */
+			if(aws_iot_mqtt_internal_handle_inflight_puback(pClient)) {
+				*pPacketType = 0;
+			}
+			break;
+		case CONNACK:
 		case SUBACK:
 		case UNSUBACK:
 			/* SDK is blocking, these responses will be forwarded to calling function to process */
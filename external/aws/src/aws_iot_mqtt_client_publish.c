@@ -69,8 +69,10 @@ static IoT_Error_t _aws_iot_mqtt_read_string_with_len(char **stringVar, uint16_t
 }
 
 /**
-  * Serializes the supplied publish data into the supplied buffer, ready for sending
-  * @param pTxBuf the buffer into which the packet will be serialized
+  * Serializes everything of a publish packet but its payload into the supplied buffer.
+  * The payload is sent from the caller's buffer right after it, so its size is not
+  * limited by the TX buffer
+  * @param pTxBuf the buffer into which the packet header will be serialized
   * @param txBufLen the length in bytes of the supplied buffer
   * @param dup uint8_t - the MQTT dup flag
   * @param qos QoS - the MQTT QoS value
@@ -78,37 +80,38 @@ static IoT_Error_t _aws_iot_mqtt_read_string_with_len(char **stringVar, uint16_t
   * @param packetId uint16_t - the MQTT packet identifier
   * @param pTopicName char * - the MQTT topic in the publish
   * @param topicNameLen uint16_t - the length of the Topic Name
-  * @param pPayload byte buffer - the MQTT publish payload
   * @param payloadLen size_t - the length of the MQTT payload
   * @param pSerializedLen uint32_t - pointer to the variable that stores serialized len
   *
   * @return An IoT Error Type defining successful/failed call
   */
-static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBuf, size_t txBufLen, uint8_t dup,
-															QoS qos, uint8_t retained, uint16_t packetId,
-															const char *pTopicName, uint16_t topicNameLen,
-															const unsigned char *pPayload, size_t payloadLen,
-															uint32_t *pSerializedLen) {
+static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish_header(unsigned char *pTxBuf, size_t txBufLen,
+																   uint8_t dup, QoS qos, uint8_t retained,
+																   uint16_t packetId, const char *pTopicName,
+																   uint16_t topicNameLen, size_t payloadLen,
+																   uint32_t *pSerializedLen) {
 	unsigned char *ptr;
 	uint32_t rem_len;
 	IoT_Error_t rc;
 	MQTTHeader header = {0};
 
 	FUNC_ENTRY;
-	if(NULL == pTxBuf || NULL == pPayload || NULL == pSerializedLen) {
+	if(NULL == pTxBuf || NULL == pSerializedLen) {
 		FUNC_EXIT_RC(NULL_VALUE_ERROR);
 	}
 
 	ptr = pTxBuf;
 	rem_len = 0;
 
-	rem_len += (uint32_t) (topicNameLen + payloadLen + 2);
+	rem_len += (uint32_t) (topicNameLen + 2);
 	if(qos > 0) {
 		rem_len += 2; /* packetId */
 	}
-	if(aws_iot_mqtt_internal_get_final_packet_length_from_remaining_length(rem_len) > txBufLen) {
+	if(aws_iot_mqtt_internal_get_final_packet_length_from_remaining_length(rem_len + (uint32_t) payloadLen)
+	   - payloadLen > txBufLen) {
 		FUNC_EXIT_RC(MQTT_TX_BUFFER_TOO_SHORT_ERROR);
 	}
+	rem_len += (uint32_t) payloadLen;
 
 	rc = aws_iot_mqtt_internal_init_header(&header, PUBLISH, qos, dup, retained);
 	if(SUCCESS != rc) {
@@ -124,9 +127,6 @@ static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBu
 		aws_iot_mqtt_internal_write_uint_16(&ptr, packetId);
 	}
 
-	memcpy(ptr, pPayload, payloadLen);
-	ptr += payloadLen;
-
 	*pSerializedLen = (uint32_t) (ptr - pTxBuf);
 
 	FUNC_EXIT_RC(SUCCESS);
@@ -177,6 +177,45 @@ IoT_Error_t aws_iot_mqtt_internal_serialize_ack(unsigned char *pTxBuf, size_t tx
 	FUNC_EXIT_RC(SUCCESS);
 }
 
+/**
+ * @brief Send a publish packet
+ *
+ * Serializes the packet header into the TX buffer and sends it followed by the
+ * payload, which is written directly from the application's buffer.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicName Topic Name to publish to
+ * @param topicNameLen Length of the topic name
+ * @param pParams Pointer to Publish Message parameters, id already assigned for QoS1
+ * @param pTimer Timer bounding the write
+ *
+ * @return An IoT Error Type defining successful/failed send
+ */
+static IoT_Error_t _aws_iot_mqtt_internal_send_publish(AWS_IoT_Client *pClient, const char *pTopicName,
+													   uint16_t topicNameLen, IoT_Publish_Message_Params *pParams,
+													   Timer *pTimer) {
+	uint32_t len = 0;
+	IoT_Error_t rc;
+
+	FUNC_ENTRY;
+
+	if(NULL == pParams->payload && 0 < pParams->payloadLen) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	rc = _aws_iot_mqtt_internal_serialize_publish_header(pClient->clientData.writeBuf,
+														 pClient->clientData.writeBufSize, 0, pParams->qos,
+														 pParams->isRetained, pParams->id, pTopicName, topicNameLen,
+														 pParams->payloadLen, &len);
+	if(SUCCESS != rc) {
+		FUNC_EXIT_RC(rc);
+	}
+
+	rc = aws_iot_mqtt_internal_send_packet_with_payload(pClient, len, (unsigned char *) pParams->payload,
+														pParams->payloadLen, pTimer);
+	FUNC_EXIT_RC(rc);
+}
+
 /**
  * @brief Publish an MQTT message on a topic
  *
@@ -197,7 +236,6 @@ IoT_Error_t aws_iot_mqtt_internal_serialize_ack(unsigned char *pTxBuf, size_t tx
 static IoT_Error_t _aws_iot_mqtt_internal_publish(AWS_IoT_Client *pClient, const char *pTopicName,
 												  uint16_t topicNameLen, IoT_Publish_Message_Params *pParams) {
 	Timer timer;
-	uint32_t len = 0;
 	uint16_t packet_id;
 	unsigned char dup, type;
 	IoT_Error_t rc;
@@ -211,16 +249,8 @@ static IoT_Error_t _aws_iot_mqtt_internal_publish(AWS_IoT_Client *pClient, const
 		pParams->id = aws_iot_mqtt_get_next_packet_id(pClient);
 	}
 
-	rc = _aws_iot_mqtt_internal_serialize_publish(pClient->clientData.writeBuf, pClient->clientData.writeBufSize, 0,
-												  pParams->qos, pParams->isRetained, pParams->id, pTopicName,
-												  topicNameLen, (unsigned char *) pParams->payload,
-												  pParams->payloadLen, &len);
-	if(SUCCESS != rc) {
-		FUNC_EXIT_RC(rc);
-	}
-
 	/* send the publish packet */
-	rc = aws_iot_mqtt_internal_send_packet(pClient, len, &timer);
+	rc = _aws_iot_mqtt_internal_send_publish(pClient, pTopicName, topicNameLen, pParams, &timer);
 	if(SUCCESS != rc) {
 		FUNC_EXIT_RC(rc);
 	}
@@ -294,6 +324,190 @@ IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName
 	FUNC_EXIT_RC(pubRc);
 }
 
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+/**
+ * @brief Complete an in-flight publish
+ *
+ * Frees the in-flight entry and reports the result to the application.
+ * The client is put in the callback state while the handler runs so that
+ * the handler may publish again but cannot yield.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pInflight In-flight entry to complete
+ * @param result Result passed to the application
+ */
+static void _aws_iot_mqtt_internal_complete_inflight(AWS_IoT_Client *pClient, InflightPublish *pInflight,
+													 IoT_Error_t result) {
+	pPublishAckHandler_t pAckHandler = pInflight->pAckHandler;
+	void *pAckHandlerData = pInflight->pAckHandlerData;
+	uint16_t packetId = pInflight->packetId;
+	ClientState clientState;
+
+	pInflight->packetId = 0;
+	pInflight->pAckHandler = NULL;
+	pInflight->pAckHandlerData = NULL;
+
+	if(NULL == pAckHandler) {
+		return;
+	}
+
+	clientState = aws_iot_mqtt_get_client_state(pClient);
+	aws_iot_mqtt_set_client_state(pClient, clientState, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN);
+	pAckHandler(pClient, packetId, result, pAckHandlerData);
+	aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN, clientState);
+}
+#endif
+
+/**
+ * @brief Match a received PUBACK against the in-flight publishes
+ *
+ * Called by the read cycle for every PUBACK in the RX buffer. If the ack belongs to a
+ * publish sent with aws_iot_mqtt_publish_async() that publish is completed.
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return true if the PUBACK was consumed, false if it belongs to a blocking publish
+ */
+bool aws_iot_mqtt_internal_handle_inflight_puback(AWS_IoT_Client *pClient) {
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	uint32_t itr;
+	uint16_t packetId;
+	unsigned char dup, type;
+	InflightPublish *pInflight;
+
+	if(SUCCESS != aws_iot_mqtt_internal_deserialize_ack(&type, &dup, &packetId, pClient->clientData.readBuf,
+													  pClient->clientData.readBufSize)) {
+		return false;
+	}
+
+	for(itr = 0; itr < AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES; ++itr) {
+		pInflight = &(pClient->clientData.inflightPublishes[itr]);
+		if(0 != packetId && pInflight->packetId == packetId) {
+			_aws_iot_mqtt_internal_complete_inflight(pClient, pInflight, SUCCESS);
+			return true;
+		}
+	}
+#endif
+
+	return false;
+}
+
+/**
+ * @brief Time out in-flight publishes
+ *
+ * Called from yield. Every in-flight publish whose PUBACK did not arrive within the
+ * command timeout is completed with MQTT_REQUEST_TIMEOUT_ERROR.
+ *
+ * @param pClient Reference to the IoT Client
+ */
+void aws_iot_mqtt_internal_expire_inflight_publishes(AWS_IoT_Client *pClient) {
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	uint32_t itr;
+	InflightPublish *pInflight;
+
+	for(itr = 0; itr < AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES; ++itr) {
+		pInflight = &(pClient->clientData.inflightPublishes[itr]);
+		if(0 != pInflight->packetId && has_timer_expired(&(pInflight->timer))) {
+			IOT_WARN("PUBACK for packet %u timed out", pInflight->packetId);
+			_aws_iot_mqtt_internal_complete_inflight(pClient, pInflight, MQTT_REQUEST_TIMEOUT_ERROR);
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Publish an MQTT message on a topic without waiting for the PUBACK
+ *
+ * Called to publish an MQTT message on a topic.
+ * @note The function returns once the message was passed to the TLS layer. For QoS 1 the
+ * publish then stays in flight until yield receives its PUBACK or the command timeout
+ * expires, and the outcome is reported through pAckHandler. Up to
+ * AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES publishes may be in flight at once.
+ * The payload is sent directly from pParams->payload and is not limited by the TX buffer.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicName Topic Name to publish to
+ * @param topicNameLen Length of the topic name
+ * @param pParams Pointer to Publish Message parameters, the packet id is returned in pParams->id
+ * @param pAckHandler Callback invoked with the QoS 1 outcome, may be NULL
+ * @param pAckHandlerData Data passed to pAckHandler
+ *
+ * @return An IoT Error Type defining successful/failed publish
+ */
+IoT_Error_t aws_iot_mqtt_publish_async(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+									   IoT_Publish_Message_Params *pParams, pPublishAckHandler_t pAckHandler,
+									   void *pAckHandlerData) {
+	Timer timer;
+	IoT_Error_t rc, pubRc;
+	ClientState clientState;
+	InflightPublish *pInflight = NULL;
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	uint32_t itr;
+#endif
+
+	FUNC_ENTRY;
+
+	if(NULL == pClient || NULL == pTopicName || 0 == topicNameLen || NULL == pParams) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	if(!aws_iot_mqtt_is_client_connected(pClient)) {
+		FUNC_EXIT_RC(NETWORK_DISCONNECTED_ERROR);
+	}
+
+	clientState = aws_iot_mqtt_get_client_state(pClient);
+	if(CLIENT_STATE_CONNECTED_IDLE != clientState && CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN != clientState) {
+		FUNC_EXIT_RC(MQTT_CLIENT_NOT_IDLE_ERROR);
+	}
+
+	if(QOS1 == pParams->qos) {
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+		for(itr = 0; itr < AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES; ++itr) {
+			if(0 == pClient->clientData.inflightPublishes[itr].packetId) {
+				pInflight = &(pClient->clientData.inflightPublishes[itr]);
+				break;
+			}
+		}
+#endif
+		if(NULL == pInflight) {
+			FUNC_EXIT_RC(MQTT_MAX_INFLIGHT_PUBLISHES_REACHED_ERROR);
+		}
+	}
+
+	rc = aws_iot_mqtt_set_client_state(pClient, clientState, CLIENT_STATE_CONNECTED_PUBLISH_IN_PROGRESS);
+	if(SUCCESS != rc) {
+		FUNC_EXIT_RC(rc);
+	}
+
+	init_timer(&timer);
+	countdown_ms(&timer, pClient->clientData.commandTimeoutMs);
+
+	if(NULL != pInflight) {
+		/* Claim the entry before sending, the PUBACK may be read as soon as
+		 * the packet is out */
+		pParams->id = aws_iot_mqtt_get_next_packet_id(pClient);
+		pInflight->packetId = pParams->id;
+		pInflight->pAckHandler = pAckHandler;
+		pInflight->pAckHandlerData = pAckHandlerData;
+		init_timer(&(pInflight->timer));
+		countdown_ms(&(pInflight->timer), pClient->clientData.commandTimeoutMs);
+	}
+
+	pubRc = _aws_iot_mqtt_internal_send_publish(pClient, pTopicName, topicNameLen, pParams, &timer);
+	if(SUCCESS != pubRc && NULL != pInflight) {
+		pInflight->packetId = 0;
+		pInflight->pAckHandler = NULL;
+		pInflight->pAckHandlerData = NULL;
+	}
+
+	rc = aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_PUBLISH_IN_PROGRESS, clientState);
+	if(SUCCESS == pubRc && SUCCESS != rc) {
+		pubRc = rc;
+	}
+
+	FUNC_EXIT_RC(pubRc);
+}
+
 /**
   * Deserializes the supplied (wire) buffer into publish data
   * @param dup returned uint8_t - the MQTT dup flag
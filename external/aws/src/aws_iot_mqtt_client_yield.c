@@ -170,18 +170,23 @@ static IoT_Error_t _aws_iot_mqtt_keep_alive(AWS_IoT_Client *pClient) {
  * This is the internal function which is called by the yield API to perform the operation.
  * Not meant to be called directly as it doesn't do validations or client state changes
  *
+ * In non-blocking mode only packets that have already arrived are processed and the
+ * call returns as soon as the network has nothing more to read.
+ *
  * @param pClient Reference to the IoT Client
  * @param timeout_ms Maximum number of milliseconds to pass thread execution to the client.
+ * @param blocking Wait for incoming packets until timeout_ms expires
  *
  * @return An IoT Error Type defining successful/failed client processing.
  *         If this call results in an error it is likely the MQTT connection has dropped.
  *         iot_is_mqtt_connected can be called to confirm.
  */
-static IoT_Error_t _aws_iot_mqtt_internal_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms) {
+static IoT_Error_t _aws_iot_mqtt_internal_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms, bool blocking) {
 	IoT_Error_t yieldRc = SUCCESS;
 
 	uint8_t packet_type;
 	ClientState clientState;
+	bool done = false;
 	Timer timer;
 	init_timer(&timer);
 	countdown_ms(&timer, timeout_ms);
@@ -199,11 +204,24 @@ static IoT_Error_t _aws_iot_mqtt_internal_yield(AWS_IoT_Client *pClient, uint32_
 			yieldRc = _aws_iot_mqtt_handle_reconnect(pClient);
 			/* Network reconnect attempted, check if yield timer expired before
 			 * doing anything else */
+			done = !blocking;
 			continue;
 		}
 
-		yieldRc = aws_iot_mqtt_internal_cycle_read(pClient, &timer, &packet_type);
+		yieldRc = SUCCESS;
+		if(blocking) {
+			yieldRc = aws_iot_mqtt_internal_cycle_read(pClient, &timer, &packet_type);
+		} else if(NULL != pClient->networkStack.isReadable
+				  && pClient->networkStack.isReadable(&(pClient->networkStack))) {
+			/* A packet has started to arrive, allow the rest of it the packet timeout */
+			countdown_ms(&timer, pClient->clientData.packetTimeoutMs);
+			yieldRc = aws_iot_mqtt_internal_cycle_read(pClient, &timer, &packet_type);
+		} else {
+			done = true;
+		}
+
 		if(SUCCESS == yieldRc) {
+			aws_iot_mqtt_internal_expire_inflight_publishes(pClient);
 			yieldRc = _aws_iot_mqtt_keep_alive(pClient);
 		} else {
 			// SSL read and write errors are terminal, connection must be closed and retried
@@ -228,44 +246,22 @@ static IoT_Error_t _aws_iot_mqtt_internal_yield(AWS_IoT_Client *pClient, uint32_
 				 * Set to rc to attempting reconnect to inform client that autoreconnect
 				 * attempt has started */
 				yieldRc = NETWORK_ATTEMPTING_RECONNECT;
+				done = !blocking;
 			} else {
 				break;
 			}
 		} else if(SUCCESS != yieldRc) {
 			break;
 		}
-	} while(!has_timer_expired(&timer));
+	} while(blocking ? !has_timer_expired(&timer) : !done);
 
 	FUNC_EXIT_RC(yieldRc);
 }
 
-/**
- * @brief Yield to the MQTT client
- *
- * Called to yield the current thread to the underlying MQTT client.  This time is used by
- * the MQTT client to manage PING requests to monitor the health of the TCP connection as
- * well as periodically check the socket receive buffer for subscribe messages.  Yield()
- * must be called at a rate faster than the keepalive interval.  It must also be called
- * at a rate faster than the incoming message rate as this is the only way the client receives
- * processing time to manage incoming messages.
- * This is the outer function which does the validations and calls the internal yield above
- * to perform the actual operation. It is also responsible for client state changes
- *
- * @param pClient Reference to the IoT Client
- * @param timeout_ms Maximum number of milliseconds to pass thread execution to the client.
- *
- * @return An IoT Error Type defining successful/failed client processing.
- *         If this call results in an error it is likely the MQTT connection has dropped.
- *         iot_is_mqtt_connected can be called to confirm.
- */
-IoT_Error_t aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms) {
+static IoT_Error_t _aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms, bool blocking) {
 	IoT_Error_t rc, yieldRc;
 	ClientState clientState;
 
-	if(NULL == pClient || 0 == timeout_ms) {
-		FUNC_EXIT_RC(NULL_VALUE_ERROR);
-	}
-
 	clientState = aws_iot_mqtt_get_client_state(pClient);
 	/* Check if network was manually disconnected */
 	if(CLIENT_STATE_DISCONNECTED_MANUALLY == clientState) {
@@ -292,7 +288,7 @@ IoT_Error_t aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms) {
 		}
 	}
 
-	yieldRc = _aws_iot_mqtt_internal_yield(pClient, timeout_ms);
+	yieldRc = _aws_iot_mqtt_internal_yield(pClient, timeout_ms, blocking);
 
 	if(NETWORK_DISCONNECTED_ERROR != yieldRc && NETWORK_ATTEMPTING_RECONNECT != yieldRc) {
 		rc = aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_YIELD_IN_PROGRESS,
@@ -305,6 +301,112 @@ IoT_Error_t aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms) {
 	FUNC_EXIT_RC(yieldRc);
 }
 
+/**
+ * @brief Yield to the MQTT client
+ *
+ * Called to yield the current thread to the underlying MQTT client.  This time is used by
+ * the MQTT client to manage PING requests to monitor the health of the TCP connection as
+ * well as periodically check the socket receive buffer for subscribe messages.  Yield()
+ * must be called at a rate faster than the keepalive interval.  It must also be called
+ * at a rate faster than the incoming message rate as this is the only way the client receives
+ * processing time to manage incoming messages.
+ * This is the outer function which does the validations and calls the internal yield above
+ * to perform the actual operation. It is also responsible for client state changes
+ *
+ * @param pClient Reference to the IoT Client
+ * @param timeout_ms Maximum number of milliseconds to pass thread execution to the client.
+ *
+ * @return An IoT Error Type defining successful/failed client processing.
+ *         If this call results in an error it is likely the MQTT connection has dropped.
+ *         iot_is_mqtt_connected can be called to confirm.
+ */
+IoT_Error_t aws_iot_mqtt_yield(AWS_IoT_Client *pClient, uint32_t timeout_ms) {
+	if(NULL == pClient || 0 == timeout_ms) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	FUNC_EXIT_RC(_aws_iot_mqtt_yield(pClient, timeout_ms, true));
+}
+
+/**
+ * @brief Yield to the MQTT client without blocking
+ *
+ * Processes the packets that have already been received, sends a PING request if
+ * one is due, times out in-flight publishes and attempts a pending reconnect.
+ * Returns as soon as there is nothing left to read, so it can be called from an
+ * event loop whenever the socket from aws_iot_mqtt_get_socket() becomes readable
+ * or the time from aws_iot_mqtt_get_next_timeout_ms() has passed.
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return An IoT Error Type defining successful/failed client processing.
+ */
+IoT_Error_t aws_iot_mqtt_yield_nonblocking(AWS_IoT_Client *pClient) {
+	if(NULL == pClient) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	FUNC_EXIT_RC(_aws_iot_mqtt_yield(pClient, pClient->clientData.packetTimeoutMs, false));
+}
+
+/**
+ * @brief Get the socket of the MQTT connection
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return Socket descriptor to wait on with poll(), -1 if the client is not connected
+ */
+int aws_iot_mqtt_get_socket(AWS_IoT_Client *pClient) {
+	if(NULL == pClient || NULL == pClient->networkStack.getSocket || !aws_iot_mqtt_is_client_connected(pClient)) {
+		return -1;
+	}
+
+	return pClient->networkStack.getSocket(&(pClient->networkStack));
+}
+
+/**
+ * @brief Time until the client needs to run without incoming data
+ *
+ * The earliest of the next keepalive PING, the next reconnect attempt and the
+ * timeout of the oldest in-flight publish.
+ *
+ * @param pClient Reference to the IoT Client
+ *
+ * @return Milliseconds, UINT32_MAX if nothing is scheduled
+ */
+uint32_t aws_iot_mqtt_get_next_timeout_ms(AWS_IoT_Client *pClient) {
+	uint32_t timeout_ms = UINT32_MAX;
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	uint32_t itr;
+	uint32_t left;
+#endif
+
+	if(NULL == pClient) {
+		return 0;
+	}
+
+	if(CLIENT_STATE_PENDING_RECONNECT == aws_iot_mqtt_get_client_state(pClient)) {
+		return left_ms(&(pClient->reconnectDelayTimer));
+	}
+
+	if(0 != pClient->clientData.keepAliveInterval) {
+		timeout_ms = left_ms(&(pClient->pingTimer));
+	}
+
+#if AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+	for(itr = 0; itr < AWS_IOT_MQTT_MAX_INFLIGHT_PUBLISHES; ++itr) {
+		if(0 != pClient->clientData.inflightPublishes[itr].packetId) {
+			left = left_ms(&(pClient->clientData.inflightPublishes[itr].timer));
+			if(left < timeout_ms) {
+				timeout_ms = left;
+			}
+		}
+	}
+#endif
+
+	return timeout_ms;
+}
+
 #ifdef __cplusplus
 }
 #endif
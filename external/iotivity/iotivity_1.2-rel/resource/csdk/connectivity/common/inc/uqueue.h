@@ -65,6 +65,8 @@ typedef struct u_queue_t
 {
     /** Head of the queue. */
     u_queue_element *element;
+    /** Tail of the queue. */
+    u_queue_element *tail;
     /** Number of messages in Queue. */
     uint32_t count;
 } u_queue_t;
@@ -90,6 +92,18 @@ CAResult_t u_queue_delete(u_queue_t *queue);
  */
 CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message);
 
+/**
+ * Appends a chain of elements at the end of the queue. The queue takes over the
+ * elements, which must have been allocated with OICMalloc.
+ * @param queue pointer to queue.
+ * @param head first element of the chain.
+ * @param tail last element of the chain, its next pointer must be NULL.
+ * @param count number of elements in the chain.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED otherwise.
+ */
+CAResult_t u_queue_add_elements(u_queue_t *queue, u_queue_element *head,
+                                u_queue_element *tail, uint32_t count);
+
 /**
  * Returns the first message in the queue and removes queue element.
  * Head is moved to next element.
@@ -98,6 +112,14 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message);
  */
 u_queue_message_t *u_queue_get_element(u_queue_t *queue);
 
+/**
+ * Removes all elements from the queue and returns them as a NULL terminated
+ * chain. The caller frees the elements and their messages.
+ * @param queue pointer to queue.
+ * @return first element of the chain, NULL if the queue is empty.
+ */
+u_queue_element *u_queue_get_elements(u_queue_t *queue);
+
 /**
  * Removes head element of the queue.
  * @param queue pointer to queue.
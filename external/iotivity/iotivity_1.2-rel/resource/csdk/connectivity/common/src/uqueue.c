@@ -48,6 +48,7 @@ u_queue_t *u_queue_create()
 
     queuePtr->count = NO_MESSAGES;
     queuePtr->element = NULL;
+    queuePtr->tail = NULL;
 
     return queuePtr;
 }
@@ -79,16 +80,12 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
     element->message = message;
     element->next = NULL;
 
-    ptr = queue->element;
+    ptr = queue->tail;
 
     if (NULL != ptr)
     {
-        while (NULL != ptr->next)
-        {
-            ptr = ptr->next;
-        }
-
         ptr->next = element;
+        queue->tail = element;
         queue->count++;
 
         OIC_LOG_V(DEBUG, TAG, "Queue Count : %d", queue->count);
@@ -105,6 +102,7 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
         }
 
         queue->element = element;
+        queue->tail = element;
         queue->count++;
         OIC_LOG_V(DEBUG, TAG, "Queue Count : %d", queue->count);
     }
@@ -112,6 +110,36 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
     return CA_STATUS_OK;
 }
 
+CAResult_t u_queue_add_elements(u_queue_t *queue, u_queue_element *head,
+                                u_queue_element *tail, uint32_t count)
+{
+    if (NULL == queue)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueAddElements FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    if (NULL == head || NULL == tail)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueAddElements : FAIL, empty chain");
+        return CA_STATUS_FAILED;
+    }
+
+    tail->next = NULL;
+    if (NULL != queue->tail)
+    {
+        queue->tail->next = head;
+    }
+    else
+    {
+        queue->element = head;
+    }
+    queue->tail = tail;
+    queue->count += count;
+
+    return CA_STATUS_OK;
+}
+
 u_queue_message_t *u_queue_get_element(u_queue_t *queue)
 {
     u_queue_element *element = NULL;
@@ -131,6 +159,10 @@ u_queue_message_t *u_queue_get_element(u_queue_t *queue)
     }
 
     queue->element = element->next;
+    if (NULL == queue->element)
+    {
+        queue->tail = NULL;
+    }
     queue->count--;
 
     message = element->message;
@@ -138,6 +170,24 @@ u_queue_message_t *u_queue_get_element(u_queue_t *queue)
     return message;
 }
 
+u_queue_element *u_queue_get_elements(u_queue_t *queue)
+{
+    u_queue_element *head = NULL;
+
+    if (NULL == queue)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueGetElements FAIL, Invalid Queue");
+        return NULL;
+    }
+
+    head = queue->element;
+    queue->element = NULL;
+    queue->tail = NULL;
+    queue->count = NO_MESSAGES;
+
+    return head;
+}
+
 CAResult_t u_queue_remove_element(u_queue_t *queue)
 {
     u_queue_element *next = NULL;
@@ -163,6 +213,10 @@ CAResult_t u_queue_remove_element(u_queue_t *queue)
     OICFree(remove);
 
     queue->element = next;
+    if (NULL == next)
+    {
+        queue->tail = NULL;
+    }
     queue->count--;
 
     return CA_STATUS_OK;
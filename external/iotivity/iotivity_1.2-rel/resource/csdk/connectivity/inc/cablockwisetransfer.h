@@ -53,6 +53,11 @@ typedef void (*CASendThreadFunc)(CAData_t *data);
  */
 typedef void (*CAReceiveThreadFunc)(CAData_t *data);
 
+/**
+ * Number of hash buckets for the block data, a power of two.
+ */
+#define CA_BLOCK_DATA_TABLE_SIZE 16
+
 /**
  * context of blockwise transfer.
  */
@@ -64,8 +69,14 @@ typedef struct
     /** callback function for received message. **/
     CAReceiveThreadFunc receivedThreadFunc;
 
-    /** array list on which the thread is operating. **/
-    u_arraylist_t *dataList;
+    /** block data hashed by ID, chained through CABlockData_t::hashNext. **/
+    struct CABlockData *dataTable[CA_BLOCK_DATA_TABLE_SIZE];
+
+    /** block data ordered by TTL, the first one expires first. **/
+    struct CABlockData *oldestData;
+
+    /** last block data in TTL order. **/
+    struct CABlockData *newestData;
 
     /** data list mutex for synchronization. **/
     oc_mutex blockDataListMutex;
@@ -86,7 +97,7 @@ typedef struct
 /**
  * Block Data Set.
  */
-typedef struct
+typedef struct CABlockData
 {
     coap_block_t block1;                /**< block1 option. */
     coap_block_t block2;                /**< block2 option. */
@@ -97,6 +108,10 @@ typedef struct
     size_t payloadLength;               /**< the total payload length to be received. */
     size_t receivedPayloadLen;          /**< currently received payload length. */
     uint64_t ttl;                       /** The TTL for this blockData. */
+    uint32_t hash;                      /**< hash of the blockData ID. */
+    struct CABlockData *hashNext;       /**< next blockData in the same hash bucket. */
+    struct CABlockData *prev;           /**< previous blockData in TTL order. */
+    struct CABlockData *next;           /**< next blockData in TTL order. */
 } CABlockData_t;
 
 /**
@@ -44,6 +44,25 @@ typedef void (*CAThreadTask)(void *threadData);
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
+/** Queue statistics. **/
+typedef struct
+{
+    /** Number of messages added to the queue. **/
+    uint32_t enqueued;
+    /** Number of messages handed to the thread function. **/
+    uint32_t processed;
+    /** Number of messages queued and not processed yet. **/
+    uint32_t depth;
+    /** Number of times the thread took the pending messages off the queue. **/
+    uint32_t batches;
+    /** Largest number of messages taken off the queue at once. **/
+    uint32_t maxBatch;
+    /** Total time messages waited in the queue, in microseconds. **/
+    uint64_t totalLatency;
+    /** Longest time a message waited in the queue, in microseconds. **/
+    uint64_t maxLatency;
+} CAQueueingThreadStats_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -60,6 +79,10 @@ typedef struct
     bool isStop;
     /** Que on which the thread is operating. **/
     u_queue_t *dataQueue;
+    /** Messages added and not moved to dataQueue yet, newest first. **/
+    u_queue_element *inbox;
+    /** Queue statistics. **/
+    CAQueueingThreadStats_t stats;
 } CAQueueingThread_t;
 
 /**
@@ -93,6 +116,21 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread, const char* thread_
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Move the messages added since the last call into dataQueue. Callers that
+ * access dataQueue directly must call this first, holding threadMutex.
+ * @param[in]   thread       thread data.
+ */
+void CAQueueingThreadCollectData(CAQueueingThread_t *thread);
+
+/**
+ * Get the queue statistics.
+ * @param[in]   thread       thread data.
+ * @param[out]  stats        statistics since the thread was initialized.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGetStats(CAQueueingThread_t *thread, CAQueueingThreadStats_t *stats);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
@@ -3563,6 +3563,8 @@ static void CALERemoveSendQueueData(CAQueueingThread_t *queueHandle, oc_mutex mu
     VERIFY_NON_NULL_VOID(address, CALEADAPTER_TAG, "address");
 
     oc_mutex_lock(mutex);
+    oc_mutex_lock(queueHandle->threadMutex);
+    CAQueueingThreadCollectData(queueHandle);
     while (u_queue_get_size(queueHandle->dataQueue) > 0)
     {
         OIC_LOG(DEBUG, CALEADAPTER_TAG, "get data from queue");
@@ -3589,6 +3591,7 @@ static void CALERemoveSendQueueData(CAQueueingThread_t *queueHandle, oc_mutex mu
             }
         }
     }
+    oc_mutex_unlock(queueHandle->threadMutex);
     oc_mutex_unlock(mutex);
 }
 
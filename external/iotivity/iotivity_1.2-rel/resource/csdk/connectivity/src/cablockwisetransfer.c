@@ -59,10 +59,123 @@
 // context for block-wise transfer
 static CABlockWiseContext_t g_context = { .sendThreadFunc = NULL,
                                           .receivedThreadFunc = NULL,
-                                          .dataList = NULL };
+                                          .dataTable = { NULL },
+                                          .oldestData = NULL,
+                                          .newestData = NULL };
 
 static uint32_t GetTicks(uint32_t milliSeconds);
 
+static uint32_t CAHashBlockDataID(const CABlockDataID_t *blockID)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < blockID->idLength; i++)
+    {
+        hash = (hash ^ blockID->id[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * The block data is kept in a hash table for the lookups by ID and in a list
+ * ordered by TTL for the expiry. Every TTL is set to the same timeout from the
+ * current time, so moving block data to the newest end whenever its TTL is
+ * reset keeps the list sorted and the expired entries are all at its front.
+ * The functions below must be called with blockDataListMutex held.
+ */
+static CABlockData_t *CAFindBlockData(const CABlockDataID_t *blockID)
+{
+    if (NULL == blockID || NULL == blockID->id)
+    {
+        return NULL;
+    }
+
+    uint32_t hash = CAHashBlockDataID(blockID);
+    CABlockData_t *data = g_context.dataTable[hash & (CA_BLOCK_DATA_TABLE_SIZE - 1)];
+    for (; data; data = data->hashNext)
+    {
+        if (data->hash == hash && CABlockidMatches(data, blockID))
+        {
+            return data;
+        }
+    }
+    return NULL;
+}
+
+static void CAAppendBlockDataTTL(CABlockData_t *data)
+{
+    data->next = NULL;
+    data->prev = g_context.newestData;
+    if (g_context.newestData)
+    {
+        g_context.newestData->next = data;
+    }
+    else
+    {
+        g_context.oldestData = data;
+    }
+    g_context.newestData = data;
+}
+
+static void CARemoveBlockDataTTL(CABlockData_t *data)
+{
+    if (data->prev)
+    {
+        data->prev->next = data->next;
+    }
+    else
+    {
+        g_context.oldestData = data->next;
+    }
+    if (data->next)
+    {
+        data->next->prev = data->prev;
+    }
+    else
+    {
+        g_context.newestData = data->prev;
+    }
+    data->prev = NULL;
+    data->next = NULL;
+}
+
+static void CAAddBlockData(CABlockData_t *data)
+{
+    CABlockData_t **bucket;
+
+    data->hash = CAHashBlockDataID(data->blockDataId);
+    bucket = &g_context.dataTable[data->hash & (CA_BLOCK_DATA_TABLE_SIZE - 1)];
+    data->hashNext = *bucket;
+    *bucket = data;
+    CAAppendBlockDataTTL(data);
+}
+
+static void CARemoveBlockData(CABlockData_t *data)
+{
+    CABlockData_t **link = &g_context.dataTable[data->hash & (CA_BLOCK_DATA_TABLE_SIZE - 1)];
+    while (*link && *link != data)
+    {
+        link = &(*link)->hashNext;
+    }
+    if (*link)
+    {
+        *link = data->hashNext;
+    }
+    data->hashNext = NULL;
+    CARemoveBlockDataTTL(data);
+}
+
+static void CADestroyBlockData(CABlockData_t *data)
+{
+    if (data->sentData)
+    {
+        CADestroyDataSet(data->sentData);
+    }
+    CADestroyBlockID(data->blockDataId);
+    OICFree(data->payload);
+    OICFree(data);
+}
+
 static bool CACheckPayloadLength(const CAData_t *sendData)
 {
     size_t payloadLen = 0;
@@ -96,16 +209,9 @@ CAResult_t CAInitializeBlockWiseTransfer(CASendThreadFunc sendThreadFunc,
         g_context.receivedThreadFunc = receivedThreadFunc;
     }
 
-    if (!g_context.dataList)
-    {
-        g_context.dataList = u_arraylist_create();
-    }
-
     CAResult_t res = CAInitBlockWiseMutexVariables();
     if (CA_STATUS_OK != res)
     {
-        u_arraylist_free(&g_context.dataList);
-        g_context.dataList = NULL;
         OIC_LOG(ERROR, TAG, "init has failed");
     }
 
@@ -116,10 +222,9 @@ CAResult_t CATerminateBlockWiseTransfer()
 {
     OIC_LOG(DEBUG, TAG, "CATerminateBlockWiseTransfer");
 
-    if (g_context.dataList)
+    if (g_context.blockDataListMutex)
     {
         CARemoveAllBlockDataFromList();
-        u_arraylist_free(&g_context.dataList);
     }
 
     CATerminateBlockWiseMutexVariables();
@@ -2262,17 +2367,13 @@ CAResult_t CAUpdateBlockOptionType(const CABlockDataID_t *blockID, uint8_t block
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            currData->type = blockType;
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
-            return CA_STATUS_OK;
-        }
+        currData->type = blockType;
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
+        return CA_STATUS_OK;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2287,16 +2388,12 @@ uint8_t CAGetBlockOptionType(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
-            return currData->type;
-        }
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
+        return currData->type;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2310,15 +2407,11 @@ CAData_t *CAGetDataSetFromBlockDataList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData->sentData;
-        }
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        return currData->sentData;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2333,17 +2426,13 @@ CABlockData_t *CAUpdateDataSetFromBlockDataList(const CABlockDataID_t *blockID,
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            CADestroyDataSet(currData->sentData);
-            currData->sentData = CACloneCAData(sendData);
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData;
-        }
+        CADestroyDataSet(currData->sentData);
+        currData->sentData = CACloneCAData(sendData);
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        return currData;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2360,15 +2449,8 @@ CAResult_t CAGetTokenFromBlockDataList(const coap_pdu_t *pdu, const CAEndpoint_t
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    for (CABlockData_t *currData = g_context.oldestData; currData; currData = currData->next)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (NULL == currData)
-        {
-            continue;
-        }
-
         if (NULL != currData->sentData && NULL != currData->sentData->requestInfo)
         {
             if (pdu->transport_hdr->udp.id == currData->sentData->requestInfo->info.messageId &&
@@ -2440,15 +2522,11 @@ CABlockData_t *CAGetBlockDataFromBlockDataList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData;
-        }
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        return currData;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2462,28 +2540,23 @@ coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID, uint16_t blockTyp
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    coap_block_t *block = NULL;
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
+        if (COAP_OPTION_BLOCK2 == blockType)
         {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
-            if (COAP_OPTION_BLOCK2 == blockType)
-            {
-                return &currData->block2;
-            }
-            else if (COAP_OPTION_BLOCK1 == blockType)
-            {
-                return &currData->block1;
-            }
+            block = &currData->block2;
+        }
+        else if (COAP_OPTION_BLOCK1 == blockType)
+        {
+            block = &currData->block1;
         }
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
     OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
-    return NULL;
+    return block;
 }
 
 CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
@@ -2495,17 +2568,13 @@ CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            *fullPayloadLen = currData->receivedPayloadLen;
-            OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
-            return currData->payload;
-        }
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        *fullPayloadLen = currData->receivedPayloadLen;
+        OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
+        return currData->payload;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2573,16 +2642,7 @@ CABlockData_t *CACreateNewBlockData(const CAData_t *sendData)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    bool res = u_arraylist_add(g_context.dataList, (void *) data);
-    if (!res)
-    {
-        OIC_LOG(ERROR, TAG, "add has failed");
-        CADestroyBlockID(data->blockDataId);
-        CADestroyDataSet(data->sentData);
-        OICFree(data);
-        oc_mutex_unlock(g_context.blockDataListMutex);
-        return NULL;
-    }
+    CAAddBlockData(data);
     oc_mutex_unlock(g_context.blockDataListMutex);
 
     OIC_LOG(DEBUG, TAG, "OUT-CreateBlockData");
@@ -2596,28 +2656,13 @@ CAResult_t CARemoveBlockDataFromList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *removedData = CAFindBlockData(blockID);
+    if (removedData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            CABlockData_t *removedData = u_arraylist_remove(g_context.dataList, i);
-            if (!removedData)
-            {
-                OIC_LOG(ERROR, TAG, "data is NULL");
-                oc_mutex_unlock(g_context.blockDataListMutex);
-                return CA_STATUS_FAILED;
-            }
+        CARemoveBlockData(removedData);
 
-            // destroy memory
-            CADestroyDataSet(removedData->sentData);
-            CADestroyBlockID(removedData->blockDataId);
-            OICFree(removedData->payload);
-            OICFree(removedData);
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return CA_STATUS_OK;
-        }
+        // destroy memory
+        CADestroyBlockData(removedData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2630,21 +2675,13 @@ CAResult_t CARemoveAllBlockDataFromList()
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = len; i > 0; i--)
+    while (g_context.oldestData)
     {
-        CABlockData_t *removedData = u_arraylist_remove(g_context.dataList, i - 1);
-        if (removedData)
-        {
-            // destroy memory
-            if (removedData->sentData)
-            {
-                CADestroyDataSet(removedData->sentData);
-            }
-            CADestroyBlockID(removedData->blockDataId);
-            OICFree(removedData->payload);
-            OICFree(removedData);
-        }
+        CABlockData_t *removedData = g_context.oldestData;
+        CARemoveBlockData(removedData);
+
+        // destroy memory
+        CADestroyBlockData(removedData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2786,16 +2823,12 @@ uint32_t GetTicks(uint32_t milliSeconds)
 void CAResetBlockDataTTL(const CABlockDataID_t *blockID)
 {
     oc_mutex_lock(g_context.blockDataListMutex);
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *blockData = CAFindBlockData(blockID);
+    if (blockData)
     {
-        CABlockData_t *blockData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(blockData, blockID))
-        {
-            blockData->ttl = GetTicks(MAX_BLOCK_DATA_TIMEOUT_SECONDS * MILLISECONDS_PER_SECOND);
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return;
-        }
+        blockData->ttl = GetTicks(MAX_BLOCK_DATA_TIMEOUT_SECONDS * MILLISECONDS_PER_SECOND);
+        CARemoveBlockDataTTL(blockData);
+        CAAppendBlockDataTTL(blockData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 }
@@ -2806,26 +2839,19 @@ void CACheckAndDeleteTimedOutBlockData()
     coap_ticks(&now);
 
     oc_mutex_lock(g_context.blockDataListMutex);
-    for (size_t i = 0; i < u_arraylist_length(g_context.dataList); i++)
+    // the list is in TTL order, stop at the first block data still alive
+    while (g_context.oldestData && g_context.oldestData->ttl < now)
     {
-        CABlockData_t *blockData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (blockData && blockData->ttl < now)
-        {
-            OIC_LOG(INFO, TAG, "Deleting timed-out BlockData");
-            OIC_LOG(DEBUG, TAG, "BlockID is ");
-            OIC_LOG_BUFFER(DEBUG, TAG, (const uint8_t *) blockData->blockDataId->id,
-                           blockData->blockDataId->idLength);
+        CABlockData_t *blockData = g_context.oldestData;
+        OIC_LOG(INFO, TAG, "Deleting timed-out BlockData");
+        OIC_LOG(DEBUG, TAG, "BlockID is ");
+        OIC_LOG_BUFFER(DEBUG, TAG, (const uint8_t *) blockData->blockDataId->id,
+                       blockData->blockDataId->idLength);
 
-            blockData = (CABlockData_t *) u_arraylist_remove(g_context.dataList, i);
-            if (blockData)
-            {
-                // destroy memory
-                CADestroyDataSet(blockData->sentData);
-                CADestroyBlockID(blockData->blockDataId);
-                OICFree(blockData->payload);
-                OICFree(blockData);
-            }
-        }
+        CARemoveBlockData(blockData);
+
+        // destroy memory
+        CADestroyBlockData(blockData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 }
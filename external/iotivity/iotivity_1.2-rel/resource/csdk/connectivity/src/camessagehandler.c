@@ -897,6 +897,7 @@ void CAHandleRequestResponseCallbacks()
 
     oc_mutex_lock(g_receiveThread.threadMutex);
 
+    CAQueueingThreadCollectData(&g_receiveThread);
     u_queue_message_t *item = u_queue_get_element(g_receiveThread.dataQueue);
 
     oc_mutex_unlock(g_receiveThread.threadMutex);
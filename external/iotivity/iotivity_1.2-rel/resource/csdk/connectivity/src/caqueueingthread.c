@@ -35,10 +35,80 @@
 
 #include "caqueueingthread.h"
 #include "oic_malloc.h"
+#include "oic_time.h"
 #include "logger.h"
 
 #define TAG PCF("OIC_CA_QING")
 
+// Adapter threads add messages to the inbox with a compare-and-swap and take
+// the mutex only to wake the queueing thread when the inbox was empty.
+#if defined(__GCC_ATOMIC_POINTER_LOCK_FREE) && __GCC_ATOMIC_POINTER_LOCK_FREE == 2 && \
+    defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+#define CA_QUEUE_LOCKFREE
+#endif
+
+/** Queue element together with the time it was queued. **/
+typedef struct
+{
+    u_queue_element element;
+    uint64_t time;
+} CAQueueingNode_t;
+
+static void CAQueueingThreadDestroyMessage(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(message->msg, message->size);
+    }
+    else
+    {
+        OICFree(message->msg);
+    }
+
+    OICFree(message);
+}
+
+static bool CAQueueingThreadIsEmpty(CAQueueingThread_t *thread)
+{
+#ifdef CA_QUEUE_LOCKFREE
+    if (NULL != __atomic_load_n(&thread->inbox, __ATOMIC_ACQUIRE))
+#else
+    if (NULL != thread->inbox)
+#endif
+    {
+        return false;
+    }
+    return u_queue_get_size(thread->dataQueue) <= 0;
+}
+
+/**
+ * Put back the messages a stopped thread did not process, ahead of the ones
+ * queued in the meantime, so that a restarted thread handles them in order.
+ */
+static void CAQueueingThreadRequeue(CAQueueingThread_t *thread, u_queue_element *element)
+{
+    u_queue_element *tail = element;
+    uint32_t count = 1;
+
+    while (NULL != tail->next)
+    {
+        tail = tail->next;
+        count++;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    CAQueueingThreadCollectData(thread);
+    uint32_t laterCount = u_queue_get_size(thread->dataQueue);
+    u_queue_element *laterTail = thread->dataQueue->tail;
+    u_queue_element *later = u_queue_get_elements(thread->dataQueue);
+    u_queue_add_elements(thread->dataQueue, element, tail, count);
+    if (NULL != later)
+    {
+        u_queue_add_elements(thread->dataQueue, later, laterTail, laterCount);
+    }
+    oc_mutex_unlock(thread->threadMutex);
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     OIC_LOG(DEBUG, TAG, "message handler main thread start..");
@@ -57,7 +127,7 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
         oc_mutex_lock(thread->threadMutex);
 
         // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        if (!thread->isStop && CAQueueingThreadIsEmpty(thread))
         {
             OIC_LOG(DEBUG, TAG, "wait..");
 
@@ -75,29 +145,51 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
             continue;
         }
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        // take all pending data at once
+        CAQueueingThreadCollectData(thread);
+        u_queue_element *element = u_queue_get_elements(thread->dataQueue);
         // mutex unlock
         oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
+        if (NULL == element)
         {
             continue;
         }
 
-        // process data
-        thread->threadTask(message->msg);
-
-        // free
-        if (NULL != thread->destroy)
+        uint32_t count = 0;
+        while (NULL != element)
         {
-            thread->destroy(message->msg, message->size);
+            if (thread->isStop)
+            {
+                CAQueueingThreadRequeue(thread, element);
+                break;
+            }
+
+            u_queue_element *next = element->next;
+            u_queue_message_t *message = element->message;
+            uint64_t latency = OICGetCurrentTime(TIME_IN_US) - ((CAQueueingNode_t *) element)->time;
+            OICFree(element);
+
+            thread->stats.totalLatency += latency;
+            if (latency > thread->stats.maxLatency)
+            {
+                thread->stats.maxLatency = latency;
+            }
+
+            // process data
+            thread->threadTask(message->msg);
+
+            // free
+            CAQueueingThreadDestroyMessage(thread, message);
+            thread->stats.processed++;
+            count++;
+            element = next;
         }
-        else
+
+        thread->stats.batches++;
+        if (count > thread->stats.maxBatch)
         {
-            OICFree(message->msg);
+            thread->stats.maxBatch = count;
         }
-
-        OICFree(message);
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -132,6 +224,8 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
+    thread->inbox = NULL;
+    memset(&thread->stats, 0, sizeof(thread->stats));
     if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
     {
         goto ERROR_MEM_FAILURE;
@@ -222,27 +316,103 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
 
     // create thread data
     u_queue_message_t *message = (u_queue_message_t *) OICMalloc(sizeof(u_queue_message_t));
+    CAQueueingNode_t *node = (CAQueueingNode_t *) OICMalloc(sizeof(CAQueueingNode_t));
 
-    if (NULL == message)
+    if (NULL == message || NULL == node)
     {
         OIC_LOG(ERROR, TAG, "memory error!!");
+        OICFree(message);
+        OICFree(node);
         return CA_MEMORY_ALLOC_FAILED;
     }
 
     message->msg = data;
     message->size = size;
+    node->element.message = message;
+    node->time = OICGetCurrentTime(TIME_IN_US);
+
+#ifdef CA_QUEUE_LOCKFREE
+    // add thread data into the inbox
+    u_queue_element *head = __atomic_load_n(&thread->inbox, __ATOMIC_RELAXED);
+    do
+    {
+        node->element.next = head;
+    } while (!__atomic_compare_exchange_n(&thread->inbox, &head, &node->element, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    __atomic_fetch_add(&thread->stats.enqueued, 1, __ATOMIC_RELAXED);
 
+    // the thread can only be waiting for data if the inbox was empty
+    if (NULL == head)
+    {
+        oc_mutex_lock(thread->threadMutex);
+        oc_cond_signal(thread->threadCond);
+        oc_mutex_unlock(thread->threadMutex);
+    }
+#else
     // mutex lock
     oc_mutex_lock(thread->threadMutex);
 
-    // add thread data into list
-    u_queue_add_element(thread->dataQueue, message);
+    // add thread data into the inbox
+    node->element.next = thread->inbox;
+    thread->inbox = &node->element;
+    thread->stats.enqueued++;
 
     // notity the thread
     oc_cond_signal(thread->threadCond);
 
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
+#endif
+
+    return CA_STATUS_OK;
+}
+
+void CAQueueingThreadCollectData(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        return;
+    }
+
+#ifdef CA_QUEUE_LOCKFREE
+    u_queue_element *element = __atomic_exchange_n(&thread->inbox, NULL, __ATOMIC_ACQUIRE);
+#else
+    u_queue_element *element = thread->inbox;
+    thread->inbox = NULL;
+#endif
+    u_queue_element *head = NULL;
+    u_queue_element *tail = element;
+    uint32_t count = 0;
+
+    // the inbox is newest first, reverse it into arrival order
+    while (NULL != element)
+    {
+        u_queue_element *next = element->next;
+        element->next = head;
+        head = element;
+        element = next;
+        count++;
+    }
+
+    if (NULL != head)
+    {
+        u_queue_add_elements(thread->dataQueue, head, tail, count);
+    }
+}
+
+CAResult_t CAQueueingThreadGetStats(CAQueueingThread_t *thread, CAQueueingThreadStats_t *stats)
+{
+    if (NULL == thread || NULL == stats)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    *stats = thread->stats;
+#ifdef CA_QUEUE_LOCKFREE
+    stats->enqueued = __atomic_load_n(&thread->stats.enqueued, __ATOMIC_RELAXED);
+#endif
+    stats->depth = stats->enqueued - stats->processed;
 
     return CA_STATUS_OK;
 }
@@ -259,6 +429,7 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
 
     // mutex lock
     oc_mutex_lock(thread->threadMutex);
+    CAQueueingThreadCollectData(thread);
 
     // remove all remained list data.
     while (u_queue_get_size(thread->dataQueue) > 0)
@@ -269,16 +440,7 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
         // free
         if (NULL != message)
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                OICFree(message->msg);
-            }
-
-            OICFree(message);
+            CAQueueingThreadDestroyMessage(thread, message);
         }
     }
 
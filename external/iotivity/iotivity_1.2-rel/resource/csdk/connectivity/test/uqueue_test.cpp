@@ -192,3 +192,57 @@ TEST_F(UQueueF, Reset)
 
     ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
 }
+
+TEST_F(UQueueF, GetElements)
+{
+    int values[3] = { 0, 1, 2 };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        u_queue_message_t *message = CreateQueueMessage(&values[i], sizeof(values[i]));
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    }
+
+    u_queue_element *head = u_queue_get_elements(queue);
+    ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
+    EXPECT_TRUE(NULL == u_queue_get_head(queue));
+
+    u_queue_element *tail = head;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(tail != NULL);
+        EXPECT_EQ(&values[i], tail->message->msg);
+        if (i < 2)
+        {
+            tail = tail->next;
+        }
+    }
+    EXPECT_TRUE(NULL == tail->next);
+
+    // Append the chain after a new element and check the order is kept
+    int first = -1;
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&first, sizeof(first))));
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_elements(queue, head, tail, 3));
+    ASSERT_EQ(static_cast<uint32_t>(4), u_queue_get_size(queue));
+
+    u_queue_message_t *message = u_queue_get_element(queue);
+    EXPECT_EQ(&first, message->msg);
+    OICFree(message);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        message = u_queue_get_element(queue);
+        ASSERT_TRUE(message != NULL);
+        EXPECT_EQ(&values[i], message->msg);
+        OICFree(message);
+    }
+
+    // The tail is reset with the last element, adding works again
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&first, sizeof(first))));
+    ASSERT_EQ(static_cast<uint32_t>(1), u_queue_get_size(queue));
+}
+
+TEST_F(UQueueF, AddElementsInvalid)
+{
+    EXPECT_EQ(CA_STATUS_FAILED, u_queue_add_elements(queue, NULL, NULL, 0));
+    EXPECT_EQ(CA_STATUS_FAILED, u_queue_add_elements(NULL, NULL, NULL, 0));
+    EXPECT_TRUE(NULL == u_queue_get_elements(NULL));
+}
@@ -53,6 +53,7 @@ static int64_t OCConvertSecurityPayload(OCSecurityPayload *payload, uint8_t *out
         size_t *size);
 static int64_t OCConvertSingleRepPayload(CborEncoder *parent, const OCRepPayload *payload);
 static int64_t OCConvertArray(CborEncoder *parent, const OCRepPayloadValueArray *valArray);
+static size_t OCRepPayloadEncodedSizeBound(const OCRepPayload *payload);
 
 static int64_t AddTextStringToMap(CborEncoder *map, const char *key, size_t keylen,
         const char *value);
@@ -72,6 +73,7 @@ OCStackResult OCConvertPayload(OCPayload* payload, uint8_t** outPayload, size_t*
     int64_t err;
     uint8_t *out = NULL;
     size_t curSize = INIT_SIZE;
+    size_t allocSize = 0;
 
     VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "OutPayload parameter is NULL");
@@ -89,33 +91,32 @@ OCStackResult OCConvertPayload(OCPayload* payload, uint8_t** outPayload, size_t*
     }
     if (out == NULL)
     {
-        out = (uint8_t *)OICCalloc(1, curSize);
+        if (PAYLOAD_TYPE_REPRESENTATION == payload->type)
+        {
+            // Size the buffer from the payload itself so that it is encoded exactly once.
+            curSize = OCRepPayloadEncodedSizeBound((OCRepPayload *)payload);
+        }
+        out = (uint8_t *)OICMalloc(curSize);
         VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
     }
+    allocSize = curSize;
     err = OCConvertPayloadHelper(payload, out, &curSize);
     ret = OC_STACK_NO_MEMORY;
 
-    if (err == CborErrorOutOfMemory)
+    // The encoder counts the bytes it could not write, so whatever is left to the
+    // initial guess still converges after one reallocation.
+    while (err == CborErrorOutOfMemory)
     {
-        // reallocate "out" and try again!
         uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
         VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
-        memset(out2, 0, curSize);
         out = out2;
+        allocSize = curSize;
         err = OCConvertPayloadHelper(payload, out, &curSize);
-        while (err == CborErrorOutOfMemory)
-        {
-            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
-            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
-            memset(out2, 0, curSize);
-            out = out2;
-            err = OCConvertPayloadHelper(payload, out, &curSize);
-        }
     }
 
     if (err == CborNoError)
     {
-        if (curSize < INIT_SIZE && PAYLOAD_TYPE_SECURITY != payload->type)
+        if (curSize < allocSize && PAYLOAD_TYPE_SECURITY != payload->type)
         {
             uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
             VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
@@ -649,6 +650,185 @@ exit:
     return checkError(err, &encoder, outPayload, size);
 }
 
+// Size of a CBOR item head carrying the given argument.
+static size_t CborHeadSize(uint64_t value)
+{
+    return value < 24 ? 1 : value <= UINT8_MAX ? 2 : value <= UINT16_MAX ? 3 :
+           value <= UINT32_MAX ? 5 : 9;
+}
+
+static size_t CborStringSize(size_t len)
+{
+    return CborHeadSize(len) + len;
+}
+
+static size_t OCStringLLSizeBound(const char *type, const OCStringLL *val)
+{
+    size_t count = 0;
+    size_t size = 0;
+
+    for (; val; val = val->next)
+    {
+        size += CborStringSize(strlen(val->value));
+        ++count;
+    }
+    return count ? CborStringSize(strlen(type)) + CborHeadSize(count) + size : 0;
+}
+
+static size_t OCRepMapSizeBound(const OCRepPayload *payload);
+
+static size_t OCArrayItemSizeBound(const OCRepPayloadValueArray *valArray, size_t index)
+{
+    switch (valArray->type)
+    {
+        case OCREP_PROP_INT:
+            if (valArray->iArray)
+            {
+                int64_t i = valArray->iArray[index];
+                return CborHeadSize(i < 0 ? ~(uint64_t)i : (uint64_t)i);
+            }
+            break;
+        case OCREP_PROP_DOUBLE:
+            return valArray->dArray ? 9 : 0;
+        case OCREP_PROP_BOOL:
+            return valArray->bArray ? 1 : 0;
+        case OCREP_PROP_STRING:
+            if (valArray->strArray)
+            {
+                return valArray->strArray[index] ?
+                       CborStringSize(strlen(valArray->strArray[index])) : 1;
+            }
+            break;
+        case OCREP_PROP_BYTE_STRING:
+            if (valArray->ocByteStrArray)
+            {
+                return valArray->ocByteStrArray[index].len ?
+                       CborStringSize(valArray->ocByteStrArray[index].len) : 1;
+            }
+            break;
+        case OCREP_PROP_OBJECT:
+            if (valArray->objArray)
+            {
+                return valArray->objArray[index] ?
+                       OCRepMapSizeBound(valArray->objArray[index]) : 1;
+            }
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// Mirrors the nesting of OCConvertArray.
+static size_t OCArraySizeBound(const OCRepPayloadValueArray *valArray)
+{
+    size_t size = CborHeadSize(valArray->dimensions[0]);
+
+    if (valArray->dimensions[0] == 0)
+    {
+        return size + OCArrayItemSizeBound(valArray, 0);
+    }
+    for (size_t i = 0; i < valArray->dimensions[0]; ++i)
+    {
+        if (0 == valArray->dimensions[1])
+        {
+            size += OCArrayItemSizeBound(valArray, i);
+            continue;
+        }
+        size += CborHeadSize(valArray->dimensions[1]);
+        for (size_t j = 0; j < valArray->dimensions[1]; ++j)
+        {
+            if (0 == valArray->dimensions[2])
+            {
+                size += OCArrayItemSizeBound(valArray, i * valArray->dimensions[1] + j);
+                continue;
+            }
+            size += CborHeadSize(valArray->dimensions[2]);
+            for (size_t k = 0; k < valArray->dimensions[2]; ++k)
+            {
+                size += OCArrayItemSizeBound(valArray,
+                        j * valArray->dimensions[2] +
+                        i * valArray->dimensions[2] * valArray->dimensions[1] +
+                        k);
+            }
+        }
+    }
+    return size;
+}
+
+// Mirrors OCConvertSingleRepPayload.
+static size_t OCSingleRepSizeBound(const OCRepPayload *payload)
+{
+    size_t size = 0;
+
+    for (const OCRepPayloadValue *value = payload->values; value; value = value->next)
+    {
+        size += CborStringSize(strlen(value->name));
+        switch (value->type)
+        {
+            case OCREP_PROP_INT:
+                size += CborHeadSize(value->i < 0 ? ~(uint64_t)value->i : (uint64_t)value->i);
+                break;
+            case OCREP_PROP_DOUBLE:
+                size += 9;
+                break;
+            case OCREP_PROP_STRING:
+                size += CborStringSize(strlen(value->str));
+                break;
+            case OCREP_PROP_BYTE_STRING:
+                size += CborStringSize(value->ocByteStr.len);
+                break;
+            case OCREP_PROP_OBJECT:
+                size += OCRepMapSizeBound(value->obj);
+                break;
+            case OCREP_PROP_ARRAY:
+                size += OCArraySizeBound(&value->arr);
+                break;
+            default:
+                size += 1;
+                break;
+        }
+    }
+    return size;
+}
+
+// An indefinite length map: its head, the members and the break byte.
+static size_t OCRepMapSizeBound(const OCRepPayload *payload)
+{
+    return 2 + OCSingleRepSizeBound(payload);
+}
+
+/*
+ * Size OCConvertRepPayload encodes the payload into.  Every item is counted with
+ * the head size the encoder picks for it, so for a well formed payload the bound
+ * is exact and the reallocation loop in OCConvertPayload is never entered.
+ */
+static size_t OCRepPayloadEncodedSizeBound(const OCRepPayload *payload)
+{
+    size_t arrayCount = 0;
+    size_t size = 0;
+
+    for (const OCRepPayload *temp = payload; temp; temp = temp->next)
+    {
+        arrayCount++;
+    }
+    if (arrayCount > 1)
+    {
+        size += CborHeadSize(arrayCount);
+    }
+    for (; payload; payload = payload->next)
+    {
+        if (arrayCount > 1 && payload->uri && strlen(payload->uri) > 0)
+        {
+            size += CborStringSize(strlen(OC_RSRVD_HREF)) + CborStringSize(strlen(payload->uri));
+        }
+        size += OCStringLLSizeBound(OC_RSRVD_RESOURCE_TYPE, payload->types);
+        size += OCStringLLSizeBound(OC_RSRVD_INTERFACE, payload->interfaces);
+        size += OCRepMapSizeBound(payload);
+    }
+    return size ? size : 1;
+}
+
 static int64_t OCConvertPresencePayload(OCPresencePayload *payload, uint8_t *outPayload,
         size_t *size)
 {
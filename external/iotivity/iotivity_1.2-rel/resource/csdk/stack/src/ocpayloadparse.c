@@ -39,6 +39,10 @@
 
 #define TAG "OIC_RI_PAYLOADPARSE"
 
+// Property names up to this length are decoded into a stack buffer rather than a
+// heap copy; the payload setters keep their own copy of the name anyway.
+#define NAME_BUF_SIZE (32)
+
 static OCStackResult OCParseDiscoveryPayload(OCPayload **outPayload, CborValue *arrayVal);
 static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot);
 static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *arrayVal);
@@ -121,6 +125,36 @@ static char* InPlaceStringTrim(char* str)
     return str;
 }
 
+static CborError OCParseTagName(const CborValue *value, char *buf, char **name)
+{
+    size_t len = NAME_BUF_SIZE - 1;
+    CborError err = cbor_value_copy_text_string(value, buf, &len, NULL);
+    if (CborNoError == err)
+    {
+        buf[len] = '\0';
+        *name = buf;
+        return err;
+    }
+    if (CborErrorOutOfMemory != err)
+    {
+        return err;
+    }
+    err = cbor_value_dup_text_string(value, name, &len, NULL);
+    if (CborNoError != err)
+    {
+        *name = NULL;
+    }
+    return err;
+}
+
+static void OCFreeTagName(char *name, const char *buf)
+{
+    if (name != buf)
+    {
+        OICFree(name);
+    }
+}
+
 static CborError OCParseStringLL(CborValue *map, char *type, OCStringLL **resource)
 {
     CborValue val;
@@ -721,6 +755,7 @@ exit:
 static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot)
 {
     CborError err = CborUnknownError;
+    char nameBuf[NAME_BUF_SIZE];
     char *name = NULL;
     bool res = false;
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "Invalid Parameter outPayload");
@@ -748,7 +783,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
         {
             if (cbor_value_is_text_string(&repMap))
             {
-                err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+                err = OCParseTagName(&repMap, nameBuf, &name);
                 VERIFY_CBOR_SUCCESS(TAG, err, "Failed finding tag name in the map");
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS(TAG, err, "Failed advancing rootMap");
@@ -759,7 +794,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                     (0 == strcmp(OC_RSRVD_INTERFACE, name))))
                 {
                     err = cbor_value_advance(&repMap);
-                    OICFree(name);
+                    OCFreeTagName(name, nameBuf);
                     name = NULL;
                     continue;
                 }
@@ -837,7 +872,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS(TAG, err, "Failed advance repMap");
             }
-            OICFree(name);
+            OCFreeTagName(name, nameBuf);
             name = NULL;
         }
         if (cbor_value_is_container(objMap))
@@ -849,7 +884,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     }
 
 exit:
-    OICFree(name);
+    OCFreeTagName(name, nameBuf);
     OCRepPayloadDestroy(*outPayload);
     *outPayload = NULL;
     return err;
@@ -67,8 +67,13 @@ namespace OC
 
             const std::vector<OCRepresentation>& representations() const;
 
+            // lets a caller that discards the container move the representations out
+            std::vector<OCRepresentation>& representations();
+
             void addRepresentation(const OCRepresentation& rep);
 
+            void addRepresentation(OCRepresentation&& rep);
+
             const OCRepresentation& operator[](int index) const
             {
                 return m_reps[index];
@@ -121,23 +126,29 @@ namespace OC
 
             void setDevAddr(const OCDevAddr&);
 
-            const std::string getHost() const;
+            const std::string& getHost() const;
 
             OCRepPayload* getPayload() const;
 
             void addChild(const OCRepresentation&);
 
+            void addChild(OCRepresentation&&);
+
             void clearChildren();
 
             const std::vector<OCRepresentation>& getChildren() const;
 
             void setChildren(const std::vector<OCRepresentation>& children);
 
+            void setChildren(std::vector<OCRepresentation>&& children);
+
             void setUri(const char* uri);
 
             void setUri(const std::string& uri);
 
-            std::string getUri() const;
+            void setUri(std::string&& uri);
+
+            const std::string& getUri() const;
 
             const std::vector<std::string>& getResourceTypes() const;
 
@@ -31,6 +31,7 @@
 #include "OCApi.h"
 #include <IServerWrapper.h>
 #include <ocstack.h>
+#include <ocpayload.h>
 #include <OCRepresentation.h>
 
 namespace OC
@@ -165,7 +166,8 @@ namespace OC
         *  @param interface specifies the interface
         */
         void setResourceRepresentation(OCRepresentation&& rep, std::string iface) {
-            setResourceRepresentation(rep, iface);
+            m_interface = std::move(iface);
+            m_representation = std::move(rep);
         }
 
         /**
@@ -183,8 +185,8 @@ namespace OC
         *  @param rep rvalue reference to the resource's representation
         */
         void setResourceRepresentation(OCRepresentation&& rep) {
-            // Call the above function
-            setResourceRepresentation(rep);
+            m_interface = DEFAULT_INTERFACE;
+            m_representation = std::move(rep);
         }
     private:
         std::string m_newResourceUri;
@@ -201,46 +203,17 @@ namespace OC
 
         OCRepPayload* getPayload() const
         {
-            MessageContainer inf;
-            OCRepresentation first(m_representation);
-
-            if(m_interface==LINK_INTERFACE)
-            {
-                first.setInterfaceType(InterfaceType::LinkParent);
-            }
-            else if(m_interface==BATCH_INTERFACE)
-            {
-                first.setInterfaceType(InterfaceType::BatchParent);
-            }
-            else
-            {
-                first.setInterfaceType(InterfaceType::DefaultParent);
-            }
-
-            inf.addRepresentation(first);
+            // The interface type of a representation only affects emptyData(),
+            // not its payload, so the root and its children are encoded in place
+            // rather than through interface-tagged copies in a MessageContainer.
+            OCRepPayload* root = m_representation.getPayload();
 
             for(const OCRepresentation& rep : m_representation.getChildren())
             {
-                OCRepresentation cur(rep);
-
-                if(m_interface==LINK_INTERFACE)
-                {
-                    cur.setInterfaceType(InterfaceType::LinkChild);
-                }
-                else if(m_interface==BATCH_INTERFACE)
-                {
-                    cur.setInterfaceType(InterfaceType::BatchChild);
-                }
-                else
-                {
-                    cur.setInterfaceType(InterfaceType::DefaultChild);
-                }
-
-                inf.addRepresentation(cur);
-
+                OCRepPayloadAppend(root, rep.getPayload());
             }
 
-            return inf.getPayload();
+            return root;
         }
     public:
 
@@ -151,21 +151,23 @@ namespace OC
         oc.setPayload(clientResponse->payload);
         //OCPayloadDestroy(clientResponse->payload);
 
-        std::vector<OCRepresentation>::const_iterator it = oc.representations().begin();
-        if (it == oc.representations().end())
+        std::vector<OCRepresentation>& reps = oc.representations();
+        std::vector<OCRepresentation>::iterator it = reps.begin();
+        if (it == reps.end())
         {
             return OCRepresentation();
         }
 
         // first one is considered the root, everything else is considered a child of this one.
-        OCRepresentation root = *it;
+        // The container is discarded, so its representations are moved rather than copied.
+        OCRepresentation root = std::move(*it);
         root.setDevAddr(clientResponse->devAddr);
         root.setUri(clientResponse->resourceUri);
         ++it;
 
-        std::for_each(it, oc.representations().end(),
-                [&root](const OCRepresentation& repItr)
-                {root.addChild(repItr);});
+        std::for_each(it, reps.end(),
+                [&root](OCRepresentation& repItr)
+                {root.addChild(std::move(repItr));});
         return root;
     }
 
@@ -681,7 +683,7 @@ namespace OC
         {
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
             OCRepresentation rep = parseGetSetCallback(clientResponse);
-            std::thread exec(context->callback, rep);
+            std::thread exec(context->callback, std::move(rep));
             exec.detach();
         }
         catch(OC::OCException& e)
@@ -910,7 +912,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, rep, result);
+        std::thread exec(context->callback, std::move(serverHeaderOptions), std::move(rep),
+                result);
         exec.detach();
         return OC_STACK_DELETE_TRANSACTION;
     }
@@ -985,7 +988,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs, result);
+        std::thread exec(context->callback, std::move(serverHeaderOptions), std::move(attrs),
+                result);
         exec.detach();
         return OC_STACK_DELETE_TRANSACTION;
     }
@@ -1260,7 +1264,7 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs,
+        std::thread exec(context->callback, std::move(serverHeaderOptions), std::move(attrs),
                     result, sequenceNumber);
         exec.detach();
         if (sequenceNumber == MAX_SEQUENCE_NUMBER + 1)
@@ -1676,7 +1680,7 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, result, attrs);
+        std::thread exec(context->callback, result, std::move(attrs));
         exec.detach();
         return OC_STACK_DELETE_TRANSACTION;
     }
@@ -42,17 +42,17 @@ void OCResourceRequest::setPayload(OCPayload* payload)
 
     info.setPayload(payload);
 
-    const std::vector<OCRepresentation>& reps = info.representations();
+    std::vector<OCRepresentation>& reps = info.representations();
     if(reps.size() >0)
     {
-        std::vector<OCRepresentation>::const_iterator itr = reps.begin();
-        std::vector<OCRepresentation>::const_iterator back = reps.end();
-        m_representation = *itr;
+        std::vector<OCRepresentation>::iterator itr = reps.begin();
+        std::vector<OCRepresentation>::iterator back = reps.end();
+        m_representation = std::move(*itr);
         ++itr;
 
         for(;itr != back; ++itr)
         {
-            m_representation.addChild(*itr);
+            m_representation.addChild(std::move(*itr));
         }
     }
     else
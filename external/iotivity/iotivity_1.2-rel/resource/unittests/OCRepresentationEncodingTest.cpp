@@ -1608,4 +1608,30 @@ namespace OCRepresentationEncodingTest
         OCRepPayloadDestroy(repPayload);
         OCPayloadDestroy(cparsed);
     }
+
+    TEST(RepresentationEncodingMove, PayloadRoundTrip)
+    {
+        OC::OCRepresentation sub;
+        sub.setValue("int", 1);
+
+        OC::OCRepresentation rep;
+        rep.setUri("/root");
+        rep.setValue("str", std::string("value"));
+        rep.setValue("sub", sub);
+        rep.setValue("bin", std::vector<uint8_t>{1, 2, 3});
+        rep.setValue("strs", std::vector<std::string>{"x", "y"});
+
+        OCRepPayload* payload = rep.getPayload();
+        OC::MessageContainer mc;
+        mc.setPayload(payload);
+        OCRepPayloadDestroy(payload);
+
+        ASSERT_EQ(1u, mc.representations().size());
+        OC::OCRepresentation out = std::move(mc.representations()[0]);
+        EXPECT_EQ("/root", out.getUri());
+        EXPECT_EQ("value", out.getValue<std::string>("str"));
+        EXPECT_EQ(1, out.getValue<OC::OCRepresentation>("sub").getValue<int>("int"));
+        EXPECT_EQ((std::vector<uint8_t>{1, 2, 3}), out.getValue<std::vector<uint8_t>>("bin"));
+        EXPECT_EQ((std::vector<std::string>{"x", "y"}), out.getValue<std::vector<std::string>>("strs"));
+    }
 }
@@ -1468,4 +1468,34 @@ namespace OCRepresentationTest
         EXPECT_ANY_THROW(rep.setDevAddr(addr));
     }
 
+    TEST(OCRepresentationMoveTest, AddChild)
+    {
+        OCRepresentation parent;
+        OCRepresentation child;
+        child.setUri("/child");
+        child.setValue("name", std::string("moved"));
+
+        parent.addChild(std::move(child));
+
+        ASSERT_EQ(1u, parent.getChildren().size());
+        EXPECT_EQ("/child", parent.getChildren()[0].getUri());
+        EXPECT_EQ("moved", parent.getChildren()[0].getValue<std::string>("name"));
+        EXPECT_TRUE(child.getUri().empty());
+    }
+
+    TEST(OCRepresentationMoveTest, SetChildren)
+    {
+        std::vector<OCRepresentation> children(2);
+        children[0].setUri("/a");
+        children[1].setUri("/b");
+
+        OCRepresentation parent;
+        parent.setChildren(std::move(children));
+
+        ASSERT_EQ(2u, parent.getChildren().size());
+        EXPECT_EQ("/a", parent.getChildren()[0].getUri());
+        EXPECT_EQ("/b", parent.getChildren()[1].getUri());
+        EXPECT_TRUE(children.empty());
+    }
+
 }
@@ -48,7 +48,18 @@ extern "C" {
 //-----------------------------------------------------------------------------
 // uv_thread
 
+enum uv_thread_create_flags {
+	UV_THREAD_NO_FLAGS = 0x00,
+	UV_THREAD_HAS_STACK_SIZE = 0x01
+};
+
+typedef struct uv_thread_options_s {
+	unsigned int flags;
+	size_t stack_size;
+} uv_thread_options_t;
+
 int uv_thread_create(uv_thread_t *tid, uv_thread_cb entry, void *arg);
+int uv_thread_create_ex(uv_thread_t *tid, const uv_thread_options_t *params, uv_thread_cb entry, void *arg);
 uv_thread_t uv_thread_self(void);
 int uv_thread_join(uv_thread_t *tid);
 int uv_thread_equal(const uv_thread_t *t1, const uv_thread_t *t2);
@@ -41,7 +41,21 @@
 extern "C" {
 #endif
 
-void uv__work_submit(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status));
+#define UV_THREADPOOL_MAX_SIZE 4
+
+/*
+ * Queued work runs highest priority first. Low priority work, such as
+ * filesystem requests that may block for long, occupies at most half of
+ * the threads, rounded up, so that it cannot starve the other priorities.
+ */
+typedef enum {
+	UV_WORK_PRIORITY_HIGH = 0,
+	UV_WORK_PRIORITY_NORMAL,	/* uv_queue_work(), uv_getaddrinfo() */
+	UV_WORK_PRIORITY_LOW,		/* uv_fs_*() */
+	UV_WORK_PRIORITY_COUNT
+} uv_work_priority_t;
+
+void uv__work_submit(uv_loop_t *loop, struct uv__work *w, uv_work_priority_t priority, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status));
 
 void uv__work_done(uv_async_t *handle);
 
@@ -56,6 +70,14 @@ struct uv_work_s {
 };
 
 int uv_queue_work(uv_loop_t *loop, uv_work_t *req, uv_work_cb work_cb, uv_after_work_cb after_work_cb);
+int uv_queue_work_priority(uv_loop_t *loop, uv_work_t *req, uv_work_priority_t priority, uv_work_cb work_cb, uv_after_work_cb after_work_cb);
+
+/*
+ * Set the number of threads, 1 to UV_THREADPOOL_MAX_SIZE, and their stack
+ * size in bytes, 0 for the default, before the first work is queued.
+ * Returns UV_EBUSY once the pool is running.
+ */
+int uv_threadpool_configure(unsigned int nthreads, size_t stack_size);
 
 int uv_cancel(uv_req_t *req);
 
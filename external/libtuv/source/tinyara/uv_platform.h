@@ -44,6 +44,15 @@
 
 #include "uv__unix_platform.h"
 
+#ifdef CONFIG_EPOLL
+#include <sys/epoll.h>
+
+/* Watch the descriptors with an epoll instance kept in loop->backend_fd
+ * rather than passing all of them to select() on every iteration.
+ */
+#define UV__HAVE_EPOLL 1
+#endif
+
 #include <netdb.h>
 
 /* for testing */
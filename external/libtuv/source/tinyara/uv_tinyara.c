@@ -41,6 +41,38 @@
 
 //-----------------------------------------------------------------------------
 
+#ifdef UV__HAVE_EPOLL
+void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
+{
+	struct epoll_event *events;
+	struct epoll_event dummy;
+	uintptr_t nfds;
+	uintptr_t i;
+
+	if (fd < 0 || loop->watchers == NULL) {
+		return;
+	}
+
+	/* Drop the events of fd that uv__io_poll() has yet to dispatch */
+	events = (struct epoll_event *)loop->watchers[loop->nwatchers];
+	nfds = (uintptr_t)loop->watchers[loop->nwatchers + 1];
+	if (events != NULL) {
+		for (i = 0; i < nfds; i++) {
+			if (events[i].data.fd == fd) {
+				events[i].data.fd = -1;
+			}
+		}
+	}
+
+	/* The kernel only forgets sockets by itself when they are closed, so
+	 * every descriptor leaves the instance here, before it can be closed.
+	 * It fails harmlessly when fd was never added.
+	 */
+	if (loop->backend_fd >= 0) {
+		epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, &dummy);
+	}
+}
+#else
 void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
 {
 	int i;
@@ -52,6 +84,7 @@ void uv__platform_invalidate_fd(uv_loop_t *loop, int fd)
 		}
 	}
 }
+#endif
 
 int uv__nonblock(int fd, int set)
 {
@@ -43,6 +43,153 @@
 
 #include <uv.h>
 
+#ifdef UV__HAVE_EPOLL
+void uv__io_poll(uv_loop_t *loop, int timeout)
+{
+	struct epoll_event events[TUV_POLL_EVENTS_SIZE];
+	struct epoll_event *pe;
+	struct epoll_event e;
+	QUEUE *q;
+	uv__io_t *w;
+	uint64_t base;
+	uint64_t diff;
+	int nevents;
+	int count;
+	int nfds;
+	int fd;
+	int op;
+	int i;
+
+	if (loop->nfds == 0) {
+		assert(QUEUE_EMPTY(&loop->watcher_queue));
+		return;
+	}
+
+	/* Only the watchers whose events changed since the last poll are
+	 * passed to the kernel; the others stay registered.
+	 */
+	while (!QUEUE_EMPTY(&loop->watcher_queue)) {
+		q = QUEUE_HEAD(&loop->watcher_queue);
+		QUEUE_REMOVE(q);
+		QUEUE_INIT(q);
+
+		w = QUEUE_DATA(q, uv__io_t, watcher_queue);
+		assert(w->pevents != 0);
+		assert(w->fd >= 0);
+		assert(w->fd < (int)loop->nwatchers);
+
+		e.events = w->pevents & (UV__POLLIN | UV__POLLOUT);
+		e.data.fd = w->fd;
+
+		op = w->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+		if (epoll_ctl(loop->backend_fd, op, w->fd, &e) != 0) {
+			if (op != EPOLL_CTL_ADD || get_errno() != EEXIST || epoll_ctl(loop->backend_fd, EPOLL_CTL_MOD, w->fd, &e) != 0) {
+				TDLOG("uv__io_poll epoll_ctl abort for errno(%d)", get_errno());
+				ABORT();
+			}
+		}
+
+		w->events = w->pevents;
+	}
+
+	assert(timeout >= -1);
+	base = loop->time;
+	count = 5;
+
+	for (;;) {
+		nfds = epoll_wait(loop->backend_fd, events, ARRAY_SIZE(events), timeout);
+
+		SAVE_ERRNO(uv__update_time(loop));
+
+		if (nfds == 0) {
+			assert(timeout != -1);
+			return;
+		}
+
+		if (nfds == -1) {
+			int err = get_errno();
+			if (err == EAGAIN) {
+				set_errno(0);
+			} else if (err != EINTR) {
+				TDLOG("uv__io_poll abort for errno(%d)", err);
+				ABORT();
+			}
+			if (timeout == -1) {
+				continue;
+			}
+			if (timeout == 0) {
+				return;
+			}
+			goto update_timeout;
+		}
+
+		/* Let uv__platform_invalidate_fd() drop the events of watchers
+		 * that the callbacks below stop or close.
+		 */
+		loop->watchers[loop->nwatchers] = (void *)events;
+		loop->watchers[loop->nwatchers + 1] = (void *)(uintptr_t)nfds;
+
+		nevents = 0;
+
+		for (i = 0; i < nfds; ++i) {
+			pe = &events[i];
+			fd = pe->data.fd;
+
+			if (fd == -1) {
+				continue;
+			}
+
+			assert(fd >= 0);
+			assert((unsigned)fd < loop->nwatchers);
+
+			w = loop->watchers[fd];
+			if (w == NULL) {
+				epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, pe);
+				continue;
+			}
+
+			/* Errors and hangups are reported to the events being watched,
+			 * whose callbacks find them out on the next read or write.
+			 */
+			pe->events &= w->pevents | UV__POLLERR | UV__POLLHUP;
+			if (pe->events == UV__POLLERR || pe->events == UV__POLLHUP) {
+				pe->events |= w->pevents & (UV__POLLIN | UV__POLLOUT);
+			}
+
+			if (pe->events != 0) {
+				w->cb(loop, w, pe->events);
+				++nevents;
+			}
+		}
+
+		loop->watchers[loop->nwatchers] = NULL;
+		loop->watchers[loop->nwatchers + 1] = NULL;
+
+		if (nevents != 0) {
+			if (nfds == (int)ARRAY_SIZE(events) && --count != 0) {
+				/* Poll for more events but don't block this time */
+				timeout = 0;
+				continue;
+			}
+			return;
+		}
+		if (timeout == 0) {
+			return;
+		}
+		if (timeout == -1) {
+			continue;
+		}
+update_timeout:
+		assert(timeout > 0);
+
+		diff = loop->time - base;
+		if (diff >= (uint64_t) timeout) {
+			return;
+		}
+		timeout -= diff;
+	}
+}
+#else
 static void uv__add_pollfd(uv_loop_t *loop, struct pollfd *pe)
 {
 	int i;
@@ -223,3 +370,4 @@ update_timeout:
 		timeout -= diff;
 	}
 }
+#endif
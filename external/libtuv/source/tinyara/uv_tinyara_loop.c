@@ -36,6 +36,22 @@
 
 #include <uv.h>
 
+#ifdef UV__HAVE_EPOLL
+int uv__platform_loop_init(uv_loop_t *loop)
+{
+	/* Closed by uv__loop_close() */
+	loop->backend_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (loop->backend_fd == -1) {
+		return -get_errno();
+	}
+
+	return 0;
+}
+
+void uv__platform_loop_delete(uv_loop_t *loop)
+{
+}
+#else
 int uv__platform_loop_init(uv_loop_t *loop)
 {
 	loop->npollfds = 0;
@@ -46,3 +62,4 @@ void uv__platform_loop_delete(uv_loop_t *loop)
 {
 	loop->npollfds = 0;
 }
+#endif
@@ -99,7 +99,8 @@
 #define POST                                                                  \
   do {                                                                        \
     if ((cb) != NULL) {                                                       \
-      uv__work_submit((loop), &(req)->work_req, uv__fs_work, uv__fs_done);    \
+      uv__work_submit((loop), &(req)->work_req, UV_WORK_PRIORITY_LOW,         \
+                      uv__fs_work, uv__fs_done);                              \
       return 0;                                                               \
     }                                                                         \
     else {                                                                    \
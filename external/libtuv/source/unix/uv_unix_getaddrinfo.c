@@ -219,7 +219,7 @@ int uv_getaddrinfo(uv_loop_t *loop, uv_getaddrinfo_t *req, uv_getaddrinfo_cb cb,
 	}
 
 	if (cb) {
-		uv__work_submit(loop, &req->work_req, uv__getaddrinfo_work, uv__getaddrinfo_done);
+		uv__work_submit(loop, &req->work_req, UV_WORK_PRIORITY_NORMAL, uv__getaddrinfo_work, uv__getaddrinfo_done);
 		return 0;
 	} else {
 		uv__getaddrinfo_work(&req->work_req);
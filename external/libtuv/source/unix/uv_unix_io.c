@@ -173,6 +173,10 @@ void uv__io_stop(uv_loop_t *loop, uv__io_t *w, unsigned int events)
 			loop->watchers[w->fd] = NULL;
 			loop->nfds--;
 			w->events = 0;
+#ifdef UV__HAVE_EPOLL
+			/* Unregister now, the descriptor may be closed before the next poll */
+			uv__platform_invalidate_fd(loop, w->fd);
+#endif
 		}
 	} else if (QUEUE_EMPTY(&w->watcher_queue)) {
 		QUEUE_INSERT_TAIL(&loop->watcher_queue, &w->watcher_queue);
@@ -62,8 +62,15 @@ static void *uv__thread_start(void *arg)
 }
 
 int uv_thread_create(uv_thread_t *tid, void (*entry)(void *arg), void *arg)
+{
+	return uv_thread_create_ex(tid, NULL, entry, arg);
+}
+
+int uv_thread_create_ex(uv_thread_t *tid, const uv_thread_options_t *params, void (*entry)(void *arg), void *arg)
 {
 	struct thread_ctx *ctx;
+	pthread_attr_t attr;
+	pthread_attr_t *attr_p;
 	int err;
 
 	ctx = (struct thread_ctx *)malloc(sizeof(*ctx));
@@ -74,7 +81,20 @@ int uv_thread_create(uv_thread_t *tid, void (*entry)(void *arg), void *arg)
 	ctx->entry = entry;
 	ctx->arg = arg;
 
-	err = pthread_create(tid, NULL, uv__thread_start, ctx);
+	attr_p = NULL;
+	if (params != NULL && (params->flags & UV_THREAD_HAS_STACK_SIZE) && params->stack_size != 0) {
+		attr_p = &attr;
+		if (pthread_attr_init(attr_p) != 0 || pthread_attr_setstacksize(attr_p, params->stack_size) != 0) {
+			free(ctx);
+			return UV_EINVAL;
+		}
+	}
+
+	err = pthread_create(tid, attr_p, uv__thread_start, ctx);
+
+	if (attr_p != NULL) {
+		pthread_attr_destroy(attr_p);
+	}
 
 	if (err) {
 		free(ctx);
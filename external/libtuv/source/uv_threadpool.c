@@ -39,18 +39,40 @@
 
 #include <uv.h>
 
+#if defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+#include <tinyara/wqueue.h>
+#endif
+
 //-----------------------------------------------------------------------------
-#define MAX_THREADPOOL_SIZE 4
+#ifdef CONFIG_LIBTUV_THREADPOOL_SIZE
+#define DEFAULT_THREADPOOL_SIZE CONFIG_LIBTUV_THREADPOOL_SIZE
+#else
+#define DEFAULT_THREADPOOL_SIZE 2
+#endif
+
+#ifdef CONFIG_LIBTUV_THREADPOOL_STACKSIZE
+#define DEFAULT_THREADPOOL_STACKSIZE CONFIG_LIBTUV_THREADPOOL_STACKSIZE
+#else
+#define DEFAULT_THREADPOOL_STACKSIZE 0
+#endif
 
 static uv_once_t _once = UV_ONCE_INIT;
 static uv_cond_t _cond;
 static uv_mutex_t _mutex;
 static unsigned int _nthreads;
-static uv_thread_t *_threads;
-static uv_thread_t _default_threads[2];
-static QUEUE _exit_message;
-static QUEUE _wq;
+static size_t _stack_size = DEFAULT_THREADPOOL_STACKSIZE;
+static unsigned int _nthreads_config;
+static QUEUE _wq[UV_WORK_PRIORITY_COUNT];
+static unsigned int _nlow_running;
+static unsigned int _nlow_max;
 static volatile int _initialized = 0;
+#if defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+static struct work_s _lpwork[UV_THREADPOOL_MAX_SIZE];
+static bool _lpwork_busy[UV_THREADPOOL_MAX_SIZE];
+#else
+static uv_thread_t _threads[UV_THREADPOOL_MAX_SIZE];
+static int _exiting;
+#endif
 
 //-----------------------------------------------------------------------------
 
@@ -60,12 +82,109 @@ static void uv__cancelled(struct uv__work *w)
 	ABORT();
 }
 
+/* Take the next work to run, highest priority first, with _mutex held.
+ * Returns NULL when there is none or when only low priority work is left
+ * and enough threads already run it.
+ */
+static QUEUE *next_work(int *priority)
+{
+	QUEUE *q;
+	int i;
+
+	for (i = 0; i < UV_WORK_PRIORITY_COUNT; i++) {
+		if (QUEUE_EMPTY(&_wq[i])) {
+			continue;
+		}
+		if (i == UV_WORK_PRIORITY_LOW && _nlow_running >= _nlow_max) {
+			continue;
+		}
+
+		q = QUEUE_HEAD(&_wq[i]);
+		QUEUE_REMOVE(q);
+		QUEUE_INIT(q);			/* Signal uv_cancel() that the work req is
+								   executing. */
+		if (i == UV_WORK_PRIORITY_LOW) {
+			_nlow_running++;
+		}
+		*priority = i;
+		return q;
+	}
+
+	return NULL;
+}
+
+static void run_work(QUEUE *q, int priority)
+{
+	struct uv__work *w;
+
+	w = QUEUE_DATA(q, struct uv__work, wq);
+	w->work(w);
+
+	uv_mutex_lock(&w->loop->wq_mutex);
+	w->work = NULL;				/* Signal uv_cancel() that the work req is done
+								   executing. */
+	QUEUE_INSERT_TAIL(&w->loop->wq, &w->wq);
+	uv_async_send(&w->loop->wq_async);
+	uv_mutex_unlock(&w->loop->wq_mutex);
+
+	if (priority == UV_WORK_PRIORITY_LOW) {
+		uv_mutex_lock(&_mutex);
+		_nlow_running--;
+		uv_mutex_unlock(&_mutex);
+	}
+}
+
+#if defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+/* One of up to _nthreads jobs on the low priority work queue, each running
+ * the queued work until there is none left for it.
+ */
+static void lpworker(void *arg)
+{
+	int slot = (int)(intptr_t)arg;
+	int priority;
+	QUEUE *q;
+
+	for (;;) {
+		uv_mutex_lock(&_mutex);
+		q = next_work(&priority);
+		if (q == NULL) {
+			_lpwork_busy[slot] = false;
+		}
+		uv_mutex_unlock(&_mutex);
+
+		if (q == NULL) {
+			break;
+		}
+
+		run_work(q, priority);
+	}
+}
+
+static void post(QUEUE *q, uv_work_priority_t priority)
+{
+	unsigned int i;
+
+	uv_mutex_lock(&_mutex);
+	QUEUE_INSERT_TAIL(&_wq[priority], q);
+
+	for (i = 0; i < _nthreads; i++) {
+		if (!_lpwork_busy[i]) {
+			if (work_queue(LPWORK, &_lpwork[i], lpworker, (void *)(intptr_t)i, 0) == OK) {
+				_lpwork_busy[i] = true;
+			}
+			break;
+		}
+	}
+
+	uv_mutex_unlock(&_mutex);
+}
+#else
 /* To avoid deadlock with uv_cancel() it's crucial that the worker
  * never holds the global _mutex and the loop-local mutex at the same time.
  */
 static void worker(void *arg)
 {
-	struct uv__work *w;
+	int priority;
 	QUEUE *q;
 
 	(void)arg;
@@ -73,46 +192,29 @@ static void worker(void *arg)
 	for (;;) {
 		uv_mutex_lock(&_mutex);
 
-		while (QUEUE_EMPTY(&_wq)) {
+		while ((q = next_work(&priority)) == NULL && !_exiting) {
 			uv_cond_wait(&_cond, &_mutex);
 		}
 
-		q = QUEUE_HEAD(&_wq);
-
-		if (q == &_exit_message) {
-			uv_cond_signal(&_cond);
-		} else {
-			QUEUE_REMOVE(q);
-			QUEUE_INIT(q);		/* Signal uv_cancel() that the work req is
-								   executing. */
-		}
-
 		uv_mutex_unlock(&_mutex);
 
-		if (q == &_exit_message) {
+		if (q == NULL) {
 			break;
 		}
 
-		w = QUEUE_DATA(q, struct uv__work, wq);
-		w->work(w);
-
-		uv_mutex_lock(&w->loop->wq_mutex);
-		w->work = NULL;			/* Signal uv_cancel() that the work req is done
-								   executing. */
-		QUEUE_INSERT_TAIL(&w->loop->wq, &w->wq);
-		uv_async_send(&w->loop->wq_async);
-		uv_mutex_unlock(&w->loop->wq_mutex);
+		run_work(q, priority);
 	}
 }
 
-static void post(QUEUE *q)
+static void post(QUEUE *q, uv_work_priority_t priority)
 {
 	uv_mutex_lock(&_mutex);
-	QUEUE_INSERT_TAIL(&_wq, q);
+	QUEUE_INSERT_TAIL(&_wq[priority], q);
 	uv_mutex_unlock(&_mutex);
 
 	uv_cond_signal(&_cond);
 }
+#endif
 
 #if defined(__TINYARA__)
 static void cleanup(void)
@@ -128,21 +230,37 @@ static void cleanup(void)
 		return;
 	}
 
-	post(&_exit_message);
+#if defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+	/* Wait for the jobs on the work queue to run out of work */
+
+	for (i = 0; i < _nthreads; i++) {
+		uv_mutex_lock(&_mutex);
+		while (_lpwork_busy[i]) {
+			uv_mutex_unlock(&_mutex);
+			usleep(10000);
+			uv_mutex_lock(&_mutex);
+		}
+		uv_mutex_unlock(&_mutex);
+	}
+#else
+	/* The threads exit once the queued work is done */
+
+	uv_mutex_lock(&_mutex);
+	_exiting = 1;
+	uv_cond_broadcast(&_cond);
+	uv_mutex_unlock(&_mutex);
 
 	for (i = 0; i < _nthreads; i++)
 		if (uv_thread_join(_threads + i)) {
 			ABORT();
 		}
 
-	if (_threads != _default_threads) {
-		free(_threads);
-	}
+	_exiting = 0;
+#endif
 
 	uv_mutex_destroy(&_mutex);
 	uv_cond_destroy(&_cond);
 
-	_threads = NULL;
 	_nthreads = 0;
 	_initialized = 0;
 	_once = UV_ONCE_INIT;
@@ -152,29 +270,31 @@ static void init_once(void)
 {
 	unsigned int i;
 	const char *val;
+#if !defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+	uv_thread_options_t options;
+#endif
 
 	assert(_initialized == 0);
 
-	_nthreads = ARRAY_SIZE(_default_threads);
+	_nthreads = DEFAULT_THREADPOOL_SIZE;
 	val = getenv("UV_THREADPOOL_SIZE");
 	if (val != NULL) {
 		_nthreads = atoi(val);
 	}
+	if (_nthreads_config != 0) {
+		_nthreads = _nthreads_config;
+	}
 	if (_nthreads == 0) {
 		_nthreads = 1;
 	}
-	if (_nthreads > MAX_THREADPOOL_SIZE) {
-		_nthreads = MAX_THREADPOOL_SIZE;
+	if (_nthreads > UV_THREADPOOL_MAX_SIZE) {
+		_nthreads = UV_THREADPOOL_MAX_SIZE;
 	}
 
-	_threads = _default_threads;
-	if (_nthreads > ARRAY_SIZE(_default_threads)) {
-		_threads = (uv_thread_t *)malloc(_nthreads * sizeof(_threads[0]));
-		if (_threads == NULL) {
-			_nthreads = ARRAY_SIZE(_default_threads);
-			_threads = _default_threads;
-		}
-	}
+	/* Keep a thread for the other priorities whenever there are two */
+
+	_nlow_max = (_nthreads + 1) / 2;
+	_nlow_running = 0;
 
 	if (uv_cond_init(&_cond)) {
 		TDLOG("init_once cond abort");
@@ -186,21 +306,43 @@ static void init_once(void)
 		ABORT();
 	}
 
-	QUEUE_INIT(&_wq);
+	for (i = 0; i < UV_WORK_PRIORITY_COUNT; i++) {
+		QUEUE_INIT(&_wq[i]);
+	}
+
+#if !defined(CONFIG_LIBTUV_THREADPOOL_LPWORK)
+	options.flags = UV_THREAD_HAS_STACK_SIZE;
+	options.stack_size = _stack_size;
 
 	for (i = 0; i < _nthreads; i++) {
-		if (uv_thread_create(_threads + i, worker, NULL)) {
+		if (uv_thread_create_ex(_threads + i, &options, worker, NULL)) {
 			TDLOG("init_once thread %d abort", i);
 			ABORT();
 		}
 	}
+#endif
 
 	_initialized = 1;
 }
 
 //-----------------------------------------------------------------------------
 
-void uv__work_submit(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status))
+int uv_threadpool_configure(unsigned int nthreads, size_t stack_size)
+{
+	if (nthreads == 0 || nthreads > UV_THREADPOOL_MAX_SIZE) {
+		return UV_EINVAL;
+	}
+
+	if (_initialized) {
+		return UV_EBUSY;
+	}
+
+	_nthreads_config = nthreads;
+	_stack_size = stack_size;
+	return 0;
+}
+
+void uv__work_submit(uv_loop_t *loop, struct uv__work *w, uv_work_priority_t priority, void (*work)(struct uv__work *w), void (*done)(struct uv__work *w, int status))
 {
 
 	uv_once(&_once, init_once);
@@ -208,7 +350,7 @@ void uv__work_submit(uv_loop_t *loop, struct uv__work *w, void (*work)(struct uv
 	w->work = work;
 	w->done = done;
 	QUEUE_INIT(&w->wq);
-	post(&w->wq);
+	post(&w->wq, priority);
 }
 
 static int uv__work_cancel(uv_loop_t *loop, uv_req_t *req, struct uv__work *w)
@@ -292,7 +434,12 @@ static void uv__queue_done(struct uv__work *w, int err)
 
 int uv_queue_work(uv_loop_t *loop, uv_work_t *req, uv_work_cb work_cb, uv_after_work_cb after_work_cb)
 {
-	if (work_cb == NULL) {
+	return uv_queue_work_priority(loop, req, UV_WORK_PRIORITY_NORMAL, work_cb, after_work_cb);
+}
+
+int uv_queue_work_priority(uv_loop_t *loop, uv_work_t *req, uv_work_priority_t priority, uv_work_cb work_cb, uv_after_work_cb after_work_cb)
+{
+	if (work_cb == NULL || (unsigned)priority >= UV_WORK_PRIORITY_COUNT) {
 		return UV_EINVAL;
 	}
 
@@ -300,7 +447,7 @@ int uv_queue_work(uv_loop_t *loop, uv_work_t *req, uv_work_cb work_cb, uv_after_
 	req->loop = loop;
 	req->work_cb = work_cb;
 	req->after_work_cb = after_work_cb;
-	uv__work_submit(loop, &req->work_req, uv__queue_work, uv__queue_done);
+	uv__work_submit(loop, &req->work_req, priority, uv__queue_work, uv__queue_done);
 	return 0;
 }
 
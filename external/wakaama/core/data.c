@@ -82,6 +82,48 @@ static int prv_setBuffer(lwm2m_data_t * dataP,
     return 1;
 }
 
+#if LWM2M_DATA_POOL_SIZE > 0
+// Arrays of up to LWM2M_DATA_POOL_ENTRIES elements are taken from a few static
+// slots: every read, write and notification allocates and frees several of them.
+
+#ifndef LWM2M_DATA_POOL_ENTRIES
+#define LWM2M_DATA_POOL_ENTRIES 16
+#endif
+
+static lwm2m_data_t prv_dataPool[LWM2M_DATA_POOL_SIZE][LWM2M_DATA_POOL_ENTRIES];
+static bool prv_dataPoolUsed[LWM2M_DATA_POOL_SIZE];
+
+static lwm2m_data_t * prv_poolAlloc(int size)
+{
+    int i;
+
+    if (size > LWM2M_DATA_POOL_ENTRIES) return NULL;
+
+    for (i = 0; i < LWM2M_DATA_POOL_SIZE; i++)
+    {
+        if (prv_dataPoolUsed[i] == false)
+        {
+            prv_dataPoolUsed[i] = true;
+            return prv_dataPool[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool prv_poolFree(lwm2m_data_t * dataP)
+{
+    int i;
+
+    if (dataP < prv_dataPool[0] || dataP >= prv_dataPool[LWM2M_DATA_POOL_SIZE]) return false;
+
+    i = (int)(dataP - prv_dataPool[0]) / LWM2M_DATA_POOL_ENTRIES;
+    prv_dataPoolUsed[i] = false;
+
+    return true;
+}
+#endif
+
 lwm2m_data_t * lwm2m_data_new(int size)
 {
     lwm2m_data_t * dataP;
@@ -89,7 +131,15 @@ lwm2m_data_t * lwm2m_data_new(int size)
     LOG_ARG("size: %d", size);
     if (size <= 0) return NULL;
 
+#if LWM2M_DATA_POOL_SIZE > 0
+    dataP = prv_poolAlloc(size);
+    if (dataP == NULL)
+    {
+        dataP = (lwm2m_data_t *)lwm2m_malloc(size * sizeof(lwm2m_data_t));
+    }
+#else
     dataP = (lwm2m_data_t *)lwm2m_malloc(size * sizeof(lwm2m_data_t));
+#endif
 
     if (dataP != NULL)
     {
@@ -129,6 +179,16 @@ void lwm2m_data_free(int size,
             break;
         }
     }
+    data_freeArray(dataP);
+}
+
+void data_freeArray(lwm2m_data_t * dataP)
+{
+    if (dataP == NULL) return;
+
+#if LWM2M_DATA_POOL_SIZE > 0
+    if (prv_poolFree(dataP)) return;
+#endif
     lwm2m_free(dataP);
 }
 
@@ -162,8 +162,10 @@ static void prv_deleteObservedList(lwm2m_context_t * contextP)
         }
         LWM2M_LIST_FREE(targetP->watcherList);
 
+        observe_freeCache(targetP);
         lwm2m_free(targetP);
     }
+    memset(contextP->observedIndex, 0, sizeof(contextP->observedIndex));
 }
 #endif
 
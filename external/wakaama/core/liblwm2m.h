@@ -474,6 +474,8 @@ typedef struct _lwm2m_server_
     char *                  location;
     bool                    dirty;
     lwm2m_block1_data_t *   block1Data;   // buffer to handle block1 data, should be replace by a list to support several block1 transfer by server.
+    uint32_t                defaultMinPeriod; // pmin of observations without one, 0 if none
+    uint32_t                defaultMaxPeriod; // pmax of observations without one, 0 if none
 } lwm2m_server_t;
 
 
@@ -592,6 +594,11 @@ struct _lwm2m_transaction_
 /*
  * LWM2M observed resources
  */
+
+// Number of buckets of the observed resources index. Part of lwm2m_context_t,
+// so it must be the same for the library and the application.
+#define LWM2M_OBSERVED_INDEX_SIZE 8
+
 typedef struct _lwm2m_watcher_
 {
     struct _lwm2m_watcher_ * next;
@@ -605,6 +612,8 @@ typedef struct _lwm2m_watcher_
     time_t lastTime;
     uint32_t counter;
     uint16_t lastMid;
+    uint32_t changed;       // bitmask of the resources (ID < 32) changed since the last notification
+    bool changedAll;        // a change could not be tracked in 'changed'
     union
     {
         int64_t asInteger;
@@ -615,9 +624,13 @@ typedef struct _lwm2m_watcher_
 typedef struct _lwm2m_observed_
 {
     struct _lwm2m_observed_ * next;
+    struct _lwm2m_observed_ * nextInIndex;  // next in the same observedIndex bucket
 
     lwm2m_uri_t uri;
     lwm2m_watcher_t * watcherList;
+    uint8_t * cacheBuffer;  // last encoded payload, dropped by lwm2m_resource_value_changed()
+    size_t cacheLength;
+    lwm2m_media_type_t cacheFormat;
 } lwm2m_observed_t;
 
 #ifdef LWM2M_CLIENT_MODE
@@ -659,6 +672,7 @@ typedef struct
     lwm2m_server_t *     serverList;
     lwm2m_object_t *     objectList;
     lwm2m_observed_t *   observedList;
+    lwm2m_observed_t *   observedIndex[LWM2M_OBSERVED_INDEX_SIZE]; // observedList hashed by object ID
 #endif
 #ifdef LWM2M_SERVER_MODE
     lwm2m_client_t *        clientList;
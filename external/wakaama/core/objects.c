@@ -198,6 +198,42 @@ coap_status_t object_readData(lwm2m_context_t * contextP,
     return result;
 }
 
+coap_status_t object_readResources(lwm2m_context_t * contextP,
+                                   lwm2m_uri_t * uriP,
+                                   uint32_t resourceMask,
+                                   int * sizeP,
+                                   lwm2m_data_t ** dataP)
+{
+    lwm2m_object_t * targetP;
+    uint16_t id;
+    int i;
+
+    LOG_ARG("mask: 0x%08x", resourceMask);
+    LOG_URI(uriP);
+    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    if (NULL == targetP) return COAP_404_NOT_FOUND;
+    if (NULL == targetP->readFunc) return COAP_405_METHOD_NOT_ALLOWED;
+    if (!LWM2M_URI_IS_SET_INSTANCE(uriP) || resourceMask == 0) return COAP_400_BAD_REQUEST;
+    if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
+
+    *sizeP = 0;
+    for (id = 0; id < 32; id++)
+    {
+        if ((resourceMask & ((uint32_t)1 << id)) != 0) (*sizeP)++;
+    }
+
+    *dataP = lwm2m_data_new(*sizeP);
+    if (*dataP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    i = 0;
+    for (id = 0; id < 32; id++)
+    {
+        if ((resourceMask & ((uint32_t)1 << id)) != 0) (*dataP)[i++].id = id;
+    }
+
+    return targetP->readFunc(uriP->instanceId, sizeP, dataP, targetP);
+}
+
 coap_status_t object_read(lwm2m_context_t * contextP,
                           lwm2m_uri_t * uriP,
                           lwm2m_media_type_t * formatP,
@@ -672,6 +708,38 @@ static int prv_getMandatoryInfo(lwm2m_object_t * objectP,
     return 0;
 }
 
+// The Default Minimum and Maximum Periods are optional: left to 0 if absent.
+static void prv_getDefaultPeriods(lwm2m_object_t * objectP,
+                                  uint16_t instanceID,
+                                  lwm2m_server_t * targetP)
+{
+    lwm2m_data_t * dataP;
+    int size;
+    int64_t value;
+
+    size = 2;
+    dataP = lwm2m_data_new(size);
+    if (dataP == NULL) return;
+    dataP[0].id = LWM2M_SERVER_MIN_PERIOD_ID;
+    dataP[1].id = LWM2M_SERVER_MAX_PERIOD_ID;
+
+    if (objectP->readFunc(instanceID, &size, &dataP, objectP) == COAP_205_CONTENT)
+    {
+        if (1 == lwm2m_data_decode_int(dataP + 0, &value)
+         && value > 0 && value <= 0xFFFFFFFF)
+        {
+            targetP->defaultMinPeriod = (uint32_t)value;
+        }
+        if (1 == lwm2m_data_decode_int(dataP + 1, &value)
+         && value > 0 && value <= 0xFFFFFFFF)
+        {
+            targetP->defaultMaxPeriod = (uint32_t)value;
+        }
+    }
+
+    lwm2m_data_free(size, dataP);
+}
+
 int object_getServers(lwm2m_context_t * contextP)
 {
     lwm2m_object_t * objectP;
@@ -777,6 +845,7 @@ int object_getServers(lwm2m_context_t * contextP)
                     lwm2m_data_free(size, dataP);
                     return -1;
                 }
+                prv_getDefaultPeriods(serverObjP, serverInstP->id, targetP);
                 targetP->status = STATE_DEREGISTERED;
                 contextP->serverList = (lwm2m_server_t*)LWM2M_LIST_ADD(contextP->serverList, targetP);
             }
@@ -52,19 +52,21 @@
 
 
 #ifdef LWM2M_CLIENT_MODE
+#define OBSERVED_BUCKET(ID) ((ID) % LWM2M_OBSERVED_INDEX_SIZE)
+
 static lwm2m_observed_t * prv_findObserved(lwm2m_context_t * contextP,
                                            lwm2m_uri_t * uriP)
 {
     lwm2m_observed_t * targetP;
 
-    targetP = contextP->observedList;
+    targetP = contextP->observedIndex[OBSERVED_BUCKET(uriP->objectId)];
     while (targetP != NULL
         && (targetP->uri.objectId != uriP->objectId
          || targetP->uri.flag != uriP->flag
          || (LWM2M_URI_IS_SET_INSTANCE(uriP) && targetP->uri.instanceId != uriP->instanceId)
          || (LWM2M_URI_IS_SET_RESOURCE(uriP) && targetP->uri.resourceId != uriP->resourceId)))
     {
-        targetP = targetP->next;
+        targetP = targetP->nextInIndex;
     }
 
     return targetP;
@@ -73,6 +75,19 @@ static lwm2m_observed_t * prv_findObserved(lwm2m_context_t * contextP,
 static void prv_unlinkObserved(lwm2m_context_t * contextP,
                                lwm2m_observed_t * observedP)
 {
+    lwm2m_observed_t ** bucketP;
+
+    for (bucketP = &contextP->observedIndex[OBSERVED_BUCKET(observedP->uri.objectId)];
+         *bucketP != NULL;
+         bucketP = &(*bucketP)->nextInIndex)
+    {
+        if (*bucketP == observedP)
+        {
+            *bucketP = observedP->nextInIndex;
+            break;
+        }
+    }
+
     if (contextP->observedList == observedP)
     {
         contextP->observedList = contextP->observedList->next;
@@ -129,6 +144,8 @@ static lwm2m_watcher_t * prv_getWatcher(lwm2m_context_t * contextP,
         memcpy(&(observedP->uri), uriP, sizeof(lwm2m_uri_t));
         observedP->next = contextP->observedList;
         contextP->observedList = observedP;
+        observedP->nextInIndex = contextP->observedIndex[OBSERVED_BUCKET(uriP->objectId)];
+        contextP->observedIndex[OBSERVED_BUCKET(uriP->objectId)] = observedP;
     }
 
     watcherP = prv_findWatcher(observedP, serverP);
@@ -139,6 +156,7 @@ static lwm2m_watcher_t * prv_getWatcher(lwm2m_context_t * contextP,
         {
             if (allocatedObserver == true)
             {
+                prv_unlinkObserved(contextP, observedP);
                 lwm2m_free(observedP);
             }
             return NULL;
@@ -182,6 +200,8 @@ coap_status_t observe_handleRequest(lwm2m_context_t * contextP,
         memcpy(watcherP->token, message->token, message->token_len);
         watcherP->active = true;
         watcherP->lastTime = lwm2m_gettime();
+        watcherP->changed = 0;
+        watcherP->changedAll = false;
 
         if (LWM2M_URI_IS_SET_RESOURCE(uriP))
         {
@@ -255,6 +275,7 @@ void observe_cancel(lwm2m_context_t * contextP,
             if (observedP->watcherList == NULL)
             {
                 prv_unlinkObserved(contextP, observedP);
+                observe_freeCache(observedP);
                 lwm2m_free(observedP);
             }
             return;
@@ -369,7 +390,7 @@ lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP,
     lwm2m_observed_t * targetP;
 
     LOG_URI(uriP);
-    targetP = contextP->observedList;
+    targetP = contextP->observedIndex[OBSERVED_BUCKET(uriP->objectId)];
     while (targetP != NULL)
     {
         if (targetP->uri.objectId == uriP->objectId)
@@ -386,7 +407,7 @@ lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP,
                  }
              }
         }
-        targetP = targetP->next;
+        targetP = targetP->nextInIndex;
     }
 
     LOG("Found nothing");
@@ -399,7 +420,7 @@ void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
     lwm2m_observed_t * targetP;
 
     LOG_URI(uriP);
-    targetP = contextP->observedList;
+    targetP = contextP->observedIndex[OBSERVED_BUCKET(uriP->objectId)];
     while (targetP != NULL)
     {
         if (targetP->uri.objectId == uriP->objectId)
@@ -417,21 +438,167 @@ void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
                     LOG("Found an observation");
                     LOG_URI(&(targetP->uri));
 
+                    observe_freeCache(targetP);
+
                     for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
                     {
                         if (watcherP->active == true)
                         {
                             LOG("Tagging a watcher");
                             watcherP->update = true;
+                            if (LWM2M_URI_IS_SET_RESOURCE(uriP) && uriP->resourceId < 32)
+                            {
+                                watcherP->changed |= (uint32_t)1 << uriP->resourceId;
+                            }
+                            else
+                            {
+                                watcherP->changedAll = true;
+                            }
                         }
                     }
                 }
             }
         }
-        targetP = targetP->next;
+        targetP = targetP->nextInIndex;
+    }
+}
+
+void observe_freeCache(lwm2m_observed_t * observedP)
+{
+    if (observedP->cacheBuffer != NULL)
+    {
+        lwm2m_free(observedP->cacheBuffer);
+        observedP->cacheBuffer = NULL;
+        observedP->cacheLength = 0;
     }
 }
 
+// The pmin and pmax attributes of an observation default to the Default
+// Minimum and Maximum Period of its server.
+static bool prv_getMinPeriod(lwm2m_watcher_t * watcherP,
+                             uint32_t * periodP)
+{
+    if (watcherP->parameters != NULL
+     && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) != 0)
+    {
+        *periodP = watcherP->parameters->minPeriod;
+        return true;
+    }
+    if (watcherP->server->defaultMinPeriod > 0)
+    {
+        *periodP = watcherP->server->defaultMinPeriod;
+        return true;
+    }
+
+    return false;
+}
+
+static bool prv_getMaxPeriod(lwm2m_watcher_t * watcherP,
+                             uint32_t * periodP)
+{
+    if (watcherP->parameters != NULL
+     && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+    {
+        *periodP = watcherP->parameters->maxPeriod;
+        return true;
+    }
+    if (watcherP->server->defaultMaxPeriod > 0)
+    {
+        *periodP = watcherP->server->defaultMaxPeriod;
+        return true;
+    }
+
+    return false;
+}
+
+// Returns true if the watcher may send a notification in this step: either
+// its maximum period elapsed or a change is pending and its minimum period
+// elapsed. Only then is it worth reading the observed value.
+static bool prv_isDue(lwm2m_watcher_t * watcherP,
+                      time_t currentTime)
+{
+    uint32_t period;
+
+    if (watcherP->active == false) return false;
+
+    if (prv_getMaxPeriod(watcherP, &period) == true
+     && watcherP->lastTime + period <= currentTime)
+    {
+        return true;
+    }
+
+    if (watcherP->update == false) return false;
+
+    if (prv_getMinPeriod(watcherP, &period) == true
+     && watcherP->lastTime + period > currentTime)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static void prv_sendNotification(lwm2m_context_t * contextP,
+                                 lwm2m_watcher_t * watcherP,
+                                 coap_packet_t * message,
+                                 time_t currentTime)
+{
+    watcherP->lastTime = currentTime;
+    watcherP->lastMid = contextP->nextMID++;
+    message->mid = watcherP->lastMid;
+    coap_set_header_token(message, watcherP->token, watcherP->tokenLen);
+    coap_set_header_observe(message, watcherP->counter++);
+    (void)message_send(contextP, message, watcherP->server->sessionH);
+    watcherP->update = false;
+    watcherP->changed = 0;
+    watcherP->changedAll = false;
+}
+
+#ifdef LWM2M_NOTIFY_DELTA
+// Notifies an object instance observation with only the resources changed
+// since this watcher's last notification. Returns false if the full
+// representation must be sent instead.
+static bool prv_notifyDelta(lwm2m_context_t * contextP,
+                            lwm2m_observed_t * targetP,
+                            lwm2m_watcher_t * watcherP,
+                            time_t currentTime)
+{
+    lwm2m_data_t * dataP = NULL;
+    int size = 0;
+    uint8_t * buffer = NULL;
+    lwm2m_media_type_t format = LWM2M_CONTENT_TLV;
+    coap_packet_t message[1];
+    int res;
+
+    if (watcherP->update == false
+     || watcherP->changedAll == true
+     || watcherP->changed == 0
+     || !LWM2M_URI_IS_SET_INSTANCE(&targetP->uri)
+     || LWM2M_URI_IS_SET_RESOURCE(&targetP->uri))
+    {
+        return false;
+    }
+
+    if (COAP_205_CONTENT != object_readResources(contextP, &targetP->uri, watcherP->changed, &size, &dataP))
+    {
+        lwm2m_data_free(size, dataP);
+        return false;
+    }
+    res = lwm2m_data_serialize(&targetP->uri, size, dataP, &format, &buffer);
+    lwm2m_data_free(size, dataP);
+    if (res < 0) return false;
+
+    LOG_ARG("Notify delta 0x%08x", watcherP->changed);
+    coap_init_message(message, contextP->protocol, COAP_TYPE_NON, COAP_205_CONTENT, 0);
+    coap_set_header_content_type(message, format);
+    coap_set_payload(message, buffer, (size_t)res);
+    prv_sendNotification(contextP, watcherP, message, currentTime);
+    lwm2m_free(buffer);
+
+    return true;
+}
+#endif
+
 void observe_step(lwm2m_context_t * contextP,
                   time_t currentTime,
                   time_t * timeoutP)
@@ -453,9 +620,29 @@ void observe_step(lwm2m_context_t * contextP,
         lwm2m_media_type_t format = LWM2M_CONTENT_TEXT;
         coap_packet_t message[1];
         time_t interval;
+        bool readValue = false;
 
         LOG_URI(&(targetP->uri));
-        if (LWM2M_URI_IS_SET_RESOURCE(&targetP->uri))
+
+        // Nothing is read unless some watcher can notify in this step
+        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+        {
+            if (prv_isDue(watcherP, currentTime) == true) readValue = true;
+        }
+#ifdef LWM2M_NOTIFY_CACHE
+        if (targetP->cacheBuffer != NULL)
+        {
+            // The cached payload is still current: the value only needs to be
+            // read for watchers checking their notification attributes against it.
+            readValue = false;
+            for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+            {
+                if (watcherP->update == true && prv_isDue(watcherP, currentTime) == true) readValue = true;
+            }
+        }
+#endif
+
+        if (readValue == true && LWM2M_URI_IS_SET_RESOURCE(&targetP->uri))
         {
             if (COAP_205_CONTENT != object_readData(contextP, &targetP->uri, &size, &dataP)) continue;
             switch (dataP->type)
@@ -477,6 +664,7 @@ void observe_step(lwm2m_context_t * contextP,
             if (watcherP->active == true)
             {
                 bool notify = false;
+                uint32_t period;
 
                 if (watcherP->update == true)
                 {
@@ -491,6 +679,7 @@ void observe_step(lwm2m_context_t * contextP,
                     }
 
                     if (notify == false
+                     && dataP != NULL
                      && watcherP->parameters != NULL
                      && (watcherP->parameters->toSet & ATTR_FLAG_NUMERIC) != 0)
                     {
@@ -610,26 +799,49 @@ void observe_step(lwm2m_context_t * contextP,
                             notify = true;
                         }
                     }
+                    else if (notify == true
+                          && prv_getMinPeriod(watcherP, &period) == true
+                          && watcherP->lastTime + period > currentTime)
+                    {
+                        // Server Default Minimum Period: hold back and coalesce
+                        // the changes until it elapses
+                        LOG_ARG("Delaying for default minimal period (%d s)", period);
+                        interval = watcherP->lastTime + period - currentTime;
+                        if (*timeoutP > interval) *timeoutP = interval;
+                        notify = false;
+                    }
                 }
 
                 // Is the Maximum Period reached ?
                 if (notify == false
-                 && watcherP->parameters != NULL
-                 && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+                 && prv_getMaxPeriod(watcherP, &period) == true)
                 {
-                    LOG_ARG("Checking maximal period (%d s)", watcherP->parameters->minPeriod);
+                    LOG_ARG("Checking maximal period (%d s)", period);
 
-                    if (watcherP->lastTime + watcherP->parameters->maxPeriod <= currentTime)
+                    if (watcherP->lastTime + period <= currentTime)
                     {
                         LOG("Notify on maximal period");
                         notify = true;
                     }
                 }
 
-                if (notify == true)
+                if (notify == true
+#ifdef LWM2M_NOTIFY_DELTA
+                 && prv_notifyDelta(contextP, targetP, watcherP, currentTime) == false
+#endif
+                   )
                 {
                     if (buffer == NULL)
                     {
+#ifdef LWM2M_NOTIFY_CACHE
+                        if (targetP->cacheBuffer != NULL)
+                        {
+                            buffer = targetP->cacheBuffer;
+                            length = targetP->cacheLength;
+                            format = targetP->cacheFormat;
+                        }
+                        else
+#endif
                         if (dataP != NULL)
                         {
                             int res;
@@ -653,17 +865,16 @@ void observe_step(lwm2m_context_t * contextP,
                                 break;
                             }
                         }
+#ifdef LWM2M_NOTIFY_CACHE
+                        targetP->cacheBuffer = buffer;
+                        targetP->cacheLength = length;
+                        targetP->cacheFormat = format;
+#endif
                         coap_init_message(message, proto, COAP_TYPE_NON, COAP_205_CONTENT, 0);
                         coap_set_header_content_type(message, format);
                         coap_set_payload(message, buffer, length);
                     }
-                    watcherP->lastTime = currentTime;
-                    watcherP->lastMid = contextP->nextMID++;
-                    message->mid = watcherP->lastMid;
-                    coap_set_header_token(message, watcherP->token, watcherP->tokenLen);
-                    coap_set_header_observe(message, watcherP->counter++);
-                    (void)message_send(contextP, message, watcherP->server->sessionH);
-                    watcherP->update = false;
+                    prv_sendNotification(contextP, watcherP, message, currentTime);
                 }
 
                 // Store this value
@@ -682,16 +893,18 @@ void observe_step(lwm2m_context_t * contextP,
                     }
                 }
 
-                if (watcherP->parameters != NULL && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+                if (prv_getMaxPeriod(watcherP, &period) == true)
                 {
                     // update timers
-                    interval = watcherP->lastTime + watcherP->parameters->maxPeriod - currentTime;
+                    interval = watcherP->lastTime + period - currentTime;
                     if (*timeoutP > interval) *timeoutP = interval;
                 }
             }
         }
         if (dataP != NULL) lwm2m_data_free(size, dataP);
+#ifndef LWM2M_NOTIFY_CACHE
         if (buffer != NULL) lwm2m_free(buffer);
+#endif
     }
 }
 
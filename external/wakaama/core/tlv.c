@@ -274,7 +274,7 @@ int tlv_parse(uint8_t * buffer,
             else
             {
                 memcpy(newTlvP, *dataP, size * sizeof(lwm2m_data_t));
-                lwm2m_free(*dataP);
+                data_freeArray(*dataP);
             }
         }
         *dataP = newTlvP;
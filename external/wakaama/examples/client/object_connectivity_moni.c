@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <arpa/inet.h>
 
 // Resource Id's:
 #define RES_M_NETWORK_BEARER            0
@@ -87,7 +88,8 @@ typedef struct
 } conn_m_data_t;
 
 static uint8_t prv_set_value(lwm2m_data_t * dataP,
-                             conn_m_data_t * connDataP)
+                             conn_m_data_t * connDataP,
+                             const dm_conn_stats_t * statsP)
 {
     switch (dataP->id)
     {
@@ -107,7 +109,8 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
     }
 
     case RES_M_RADIO_SIGNAL_STRENGTH: //s-int
-		if (dm_conn_get_rssi(&connDataP->signalStrength) == DM_ERROR_NONE) {
+		if (statsP->valid & DM_CONN_STATS_RSSI) {
+			connDataP->signalStrength = statsP->rssi;
 			lwm2m_data_encode_int(connDataP->signalStrength, dataP);
 		}
 		else {
@@ -126,7 +129,10 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
         for (ri = 0; ri < riCnt; ri++)
         {
             subTlvP[ri].id = ri;
-            dm_conn_get_address(connDataP->ipAddresses[ri]);
+            if (statsP->valid & DM_CONN_STATS_ADDRESS)
+            {
+                inet_ntop(AF_INET, &statsP->ipaddr, connDataP->ipAddresses[ri], sizeof(connDataP->ipAddresses[ri]));
+            }
             lwm2m_data_encode_string(connDataP->ipAddresses[ri], subTlvP + ri);
         }
         lwm2m_data_encode_instances(subTlvP, riCnt, dataP);
@@ -188,6 +194,7 @@ static uint8_t prv_read(uint16_t instanceId,
 {
     uint8_t result;
     int i;
+    dm_conn_stats_t stats;
 
     // this is a single instance object
     if (instanceId != 0)
@@ -223,10 +230,16 @@ static uint8_t prv_read(uint16_t instanceId,
         }
     }
 
+    // one driver pass for all requested resources
+    if (dm_conn_get_stats(&stats) != DM_ERROR_NONE)
+    {
+        stats.valid = 0;
+    }
+
     i = 0;
     do
     {
-        result = prv_set_value((*dataArrayP) + i, (conn_m_data_t*) (objectP->userData));
+        result = prv_set_value((*dataArrayP) + i, (conn_m_data_t*) (objectP->userData), &stats);
         i++;
     } while (i < *numDataP && result == COAP_205_CONTENT );
 
@@ -155,6 +155,39 @@ enum domain_e {
 
 typedef enum domain_e domain_t;
 
+/* A value of one attribute in a tuple passed to db_insert_batch(). */
+struct db_value_s {
+	domain_t domain;
+	union {
+		int int_value;
+		long long_value;
+		const char *string_value;
+	} u;
+};
+
+typedef struct db_value_s db_value_t;
+
+
+/* The object pools of the database, see db_get_pool_stats(). */
+enum db_pool_e {
+	DB_POOL_RELATION = 0,
+	DB_POOL_ATTRIBUTE = 1,
+	DB_POOL_INDEX = 2
+};
+
+typedef enum db_pool_e db_pool_t;
+
+struct db_pool_stats_s {
+	uint16_t used;				/* Objects in use */
+	uint16_t high_water;		/* Highest number of objects in use */
+	uint16_t capacity;			/* Objects allocated, static and from the heap */
+	uint16_t limit;				/* Objects the pool may grow to */
+	uint16_t chunks;			/* Chunks allocated from the heap */
+	uint32_t allocs;
+	uint32_t failures;			/* Allocations that failed at the limit */
+};
+
+typedef struct db_pool_stats_s db_pool_stats_t;
 
 struct _db_handle_s;
 typedef struct _db_handle_s db_handle_t;
@@ -162,6 +195,9 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -219,6 +255,106 @@ db_result_t db_exec(char *format);
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief Run a SELECT query without materializing its result. Each move of the
+*        cursor evaluates the condition on the following tuples until one is
+*        selected, so the first rows are available without scanning the whole
+*        relation. Moving backward, counting rows and moving to the last row
+*        evaluate the tuples again. Aggregates and queries answered through an
+*        index are processed as by db_query().
+*
+* @param[in] query sentence
+* @return On success, pointer of db_cursor_t returned. On failure, a NULL is returned.
+* @since Tizen RT v2.0
+*/
+db_cursor_t *db_query_stream(char *format);
+
+/**
+* @brief Insert many tuples into a relation at once. The tuples are appended with
+*        one write per DB_BULK_WRITE_SIZE bytes and the indexes are updated afterwards.
+*
+* @param[in] name of relation
+* @param[in] array of count tuples, each holding one value per attribute in attribute order
+* @param[in] number of tuples
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_insert_batch(char *relation, db_value_t *tuples, int count);
+
+/**
+* @brief Parse and compile a query once so that it can be run many times.
+*        Values may be replaced by '?' placeholders, numbered from 0 in
+*        the order they appear, e.g. "insert (?, ?) into log;" or
+*        "select id from log where id > ?;".
+*
+* @param[in] query sentence
+* @return On success, pointer of db_stmt_t returned. On failure, a NULL is returned.
+* @since Tizen RT v2.0
+*/
+db_stmt_t *db_prepare(char *format);
+
+/**
+* @brief Bind an integer to a placeholder of a prepared statement.
+*
+* @param[in] prepared statement
+* @param[in] index of placeholder
+* @param[in] value to bind
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value);
+
+/**
+* @brief Bind a long to a placeholder of a prepared statement.
+*
+* @param[in] prepared statement
+* @param[in] index of placeholder
+* @param[in] value to bind
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value);
+
+/**
+* @brief Bind a string to a placeholder in the value list of a prepared insert.
+*        The string is copied.
+*
+* @param[in] prepared statement
+* @param[in] index of placeholder
+* @param[in] value to bind
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_bind_string(db_stmt_t *stmt, int index, const char *value);
+
+/**
+* @brief Run a prepared statement that does not return rows, like db_exec().
+*        Every placeholder must be bound. Bindings are kept between runs.
+*
+* @param[in] prepared statement
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_stmt_exec(db_stmt_t *stmt);
+
+/**
+* @brief Run a prepared query, like db_query(). Every placeholder must be bound.
+*
+* @param[in] prepared statement
+* @return On success, pointer of db_cursor_t returned. On failure, a NULL is returned.
+* @since Tizen RT v2.0
+*/
+db_cursor_t *db_stmt_query(db_stmt_t *stmt);
+
+/**
+* @brief Release a prepared statement.
+*
+* @param[in] prepared statement
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v2.0
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
 
 /**
 * @brief free allocated cursor data. This should be called before application terminated.
@@ -239,6 +375,34 @@ db_result_t db_cursor_free(db_cursor_t *cursor);
 const char *db_get_result_message(db_result_t code);
 
 
+/**
+* @brief get the usage statistics of one of the object pools
+*
+* @param[in] pool relation, attribute or index pool
+* @param[out] stats statistics of the pool
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v1.0
+*/
+db_result_t db_get_pool_stats(db_pool_t pool, db_pool_stats_t *stats);
+
+/**
+* @brief set the number of objects a pool may grow to from the heap
+*
+* @param[in] pool relation, attribute or index pool
+* @param[in] limit number of objects, not less than the static size of the pool
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v1.0
+*/
+db_result_t db_set_pool_limit(db_pool_t pool, uint16_t limit);
+
+/**
+* @brief Print the statistics of all object pools
+*
+* @return On success, positive value is returned. On failure, a negative value is returned.
+* @since Tizen RT v1.0
+*/
+db_result_t db_print_pool_stats(void);
+
 /**
 * @brief Print the related information : relation, attribute name
 *
@@ -31,6 +31,10 @@
 #ifndef DM_CONNECTIVITY_H_
 #define DM_CONNECTIVITY_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -46,6 +50,34 @@ typedef struct dm_scan_info_s dm_scan_info_t;
 
 typedef void (*conn_cb)(void);
 
+/* Bits of struct dm_conn_stats_s, used both as the valid mask of a snapshot
+ * and as the changed mask of a report.
+ */
+#define DM_CONN_STATS_RSSI        (1 << 0)
+#define DM_CONN_STATS_CHANNEL     (1 << 1)
+#define DM_CONN_STATS_TX_POWER    (1 << 2)
+#define DM_CONN_STATS_ADDRESS     (1 << 3)
+#define DM_CONN_STATS_INTERFACE   (1 << 4)
+#define DM_CONN_STATS_MEM_FREE    (1 << 5)
+#define DM_CONN_STATS_ALL         0x3f
+
+/* Largest report dm_conn_encode_stats() can produce: the mask, three single
+ * byte fields, the address, the length prefixed interface name and a five
+ * byte varint.
+ */
+#define DM_CONN_STATS_REPORT_MAX  (1 + 3 + 4 + 1 + IF_NAMESIZE + 5)
+
+struct dm_conn_stats_s {
+	uint8_t valid;                  // DM_CONN_STATS_* bits of the fields read
+	int8_t rssi;                    // dBm
+	uint8_t channel;
+	uint8_t tx_power;               // dBm
+	uint32_t ipaddr;                // IPv4 address, network byte order
+	uint32_t mem_free;              // free heap in bytes
+	char interface[IF_NAMESIZE];    // NUL terminated unless IF_NAMESIZE long
+};
+typedef struct dm_conn_stats_s dm_conn_stats_t;
+
 /**
  * @brief get the rssi of network
  *
@@ -100,6 +132,48 @@ int dm_conn_get_tx_power(int *dbm);
  */
 int dm_conn_set_tx_power(const int *dbm);
 
+/**
+ * @brief get all connectivity and resource metrics in one call
+ *
+ * @details Reads rssi, channel, tx power, address, interface and free heap
+ * with a single pass over the driver and the interface list instead of one
+ * query per value. Fields that could not be read are left out of
+ * stats->valid.
+ * @param[out] stats snapshot to fill in.
+ * @return On success, 0 is returned. On failure, a negative value is returned.
+ *         DM_ERROR_NO_DATA is returned when no field could be read.
+ */
+int dm_conn_get_stats(dm_conn_stats_t *stats);
+
+/**
+ * @brief pack the fields of a snapshot that changed since the previous one
+ *
+ * @details The report is a mask byte of DM_CONN_STATS_* bits followed by the
+ * changed fields in bit order: rssi, channel and tx power as one byte each,
+ * the address as four bytes in network order, the interface as a length
+ * byte and the name, and the free heap as a zigzag varint of its difference
+ * to the previous value. With a NULL prev every valid field is sent. The
+ * caller keeps cur as prev for the next cycle once the report is delivered.
+ * @param[in] prev snapshot the peer already has, or NULL.
+ * @param[in] cur current snapshot.
+ * @param[out] buf report buffer, at least DM_CONN_STATS_REPORT_MAX bytes.
+ * @param[in] buflen size of buf.
+ * @return Length of the report, or 0 when nothing changed.
+ *         On failure, a negative value is returned.
+ */
+int dm_conn_encode_stats(const dm_conn_stats_t *prev, const dm_conn_stats_t *cur, uint8_t *buf, size_t buflen);
+
+/**
+ * @brief apply a report made by dm_conn_encode_stats() to a snapshot
+ *
+ * @param[in,out] stats the receiver's copy of the sender's previous snapshot
+ *                (zeroed before the first report).
+ * @param[in] buf report.
+ * @param[in] len length of the report.
+ * @return On success, 0 is returned. On failure, a negative value is returned.
+ */
+int dm_conn_decode_stats(dm_conn_stats_t *stats, const uint8_t *buf, size_t len);
+
 /**
  * @brief register link up callback function for connectivity event.
  *
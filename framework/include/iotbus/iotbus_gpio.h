@@ -31,6 +31,8 @@
 #ifndef IOTBUS_GPIO_H_
 #define IOTBUS_GPIO_H_
 
+#include <stdint.h>
+
 /**
  * @brief Enumeration of Gpio output mode
  * @details
@@ -86,12 +88,22 @@ struct _iotbus_gpio_s;
  */
 typedef struct _iotbus_gpio_s *iotbus_gpio_context_h;
 
+/**
+ * @brief Struct for a timestamped Gpio edge
+ */
+typedef struct {
+	uint32_t timestamp; /**< time of the edge in microseconds, wraps around */
+	int value;          /**< gpio value after the edge */
+} iotbus_gpio_event_s;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef void (*gpio_isr_cb)(void *user_data);
 
+typedef void (*gpio_events_cb)(iotbus_gpio_event_s *events, unsigned int count, unsigned int dropped, void *user_data);
+
 /**
  * @brief initializes gpio_context based on gpio pin.
  *
@@ -165,6 +177,37 @@ int iotbus_gpio_register_cb(iotbus_gpio_context_h dev, iotbus_gpio_edge_e edge,
  */
 int iotbus_gpio_unregister_cb(iotbus_gpio_context_h dev);
 
+/**
+ * @brief registers a callback for batches of timestamped edges.
+ * @details
+ * The driver buffers every edge with its time, and each wakeup of the
+ * event handler passes all edges buffered since the previous one to
+ * events_cb, oldest first, in one or more calls.  dropped counts the edges
+ * lost to a full buffer before these.  Use iotbus_gpio_unregister_cb() to
+ * unregister it.
+ *
+ * @param[in] dev handle of gpio_context
+ * @param[in] edge gpio edge type
+ * @param[in] events_cb the pointer of events callback function
+ * @param[in] user_data events function parameter
+ * @return On success, 0 is returned. On failure, a negative value is returned.
+ * @since Tizen RT v2.0
+ */
+int iotbus_gpio_register_events_cb(iotbus_gpio_context_h dev, iotbus_gpio_edge_e edge, gpio_events_cb events_cb, void *user_data);
+
+/**
+ * @brief reads the buffered edges without blocking.
+ *
+ * @param[in] dev handle of gpio_context
+ * @param[out] events buffer for the edges, oldest first
+ * @param[in] count size of the buffer
+ * @param[out] dropped number of edges lost to a full buffer, may be NULL
+ * @return On success, the number of edges read is returned.
+ *             On failure, a nagative value is returned.
+ * @since Tizen RT v2.0
+ */
+int iotbus_gpio_read_events(iotbus_gpio_context_h dev, iotbus_gpio_event_s *events, unsigned int count, unsigned int *dropped);
+
 /**
  * @brief reads the gpio value.
  *
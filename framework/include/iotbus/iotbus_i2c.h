@@ -55,6 +55,20 @@ typedef enum {
 	IOTBUS_I2C_HIGH = 2  /**< up to 3.4Mhz */
 } iotbus_i2c_mode_e;
 
+/**
+ * @brief One transfer of a batch: write, then read after a repeated start
+ * @details Either part may be empty.  Reading a register of a sensor is a
+ * write of the register address followed by a read of its value.
+ */
+typedef struct {
+	uint8_t address;     /**< 7-bit slave address */
+	const uint8_t *wbuf; /**< data to write */
+	size_t wlen;         /**< size to write */
+	uint8_t *rbuf;       /**< buffer to read into */
+	size_t rlen;         /**< size to read */
+	int result;          /**< out: 0 on success, a negative value on failure */
+} iotbus_i2c_xfer_s;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -119,6 +133,20 @@ int iotbus_i2c_read(iotbus_i2c_context_h hnd, uint8_t *data, size_t length);
  */
 int iotbus_i2c_write(iotbus_i2c_context_h hnd, const uint8_t *data, size_t length);
 
+/**
+ * @brief runs a batch of transfers, possibly to different devices.
+ * @details The transfers run back to back, each ended by a stop, and the
+ * caller sleeps until the last one is done.  The result of each transfer
+ * is stored in it.
+ *
+ * @param[in] hnd handle of i2c_context
+ * @param[in,out] xfers the transfers
+ * @param[in] count number of transfers
+ * @return On success, 0 is returned. On failure, a negative value is returned.
+ * @since Tizen RT v2.0
+ */
+int iotbus_i2c_batch(iotbus_i2c_context_h hnd, iotbus_i2c_xfer_s *xfers, unsigned int count);
+
 #ifdef __cplusplus
 }
 #endif
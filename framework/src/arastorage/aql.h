@@ -63,6 +63,7 @@
 #include "db_options.h"
 #include "index.h"
 #include "relation.h"
+#include "lvm.h"
 #include "result.h"
 
 /****************************************************************************
@@ -96,6 +97,7 @@
 #define AQL_FLAG_AGGREGATE              1
 #define AQL_FLAG_SELECT_ALL             2
 #define AQL_FLAG_ASSIGN                 4
+#define AQL_FLAG_COLUMNAR               8
 
 #define AQL_CLEAR(adt)                  aql_clear(adt)
 #define AQL_SET_TYPE(adt, type)  (((adt))->optype = (type))
@@ -193,7 +195,10 @@ enum token_e {
 
 	ATTRIBUTE,
 	BPLUSTREE,					/* 48 */
+	COLUMNAR,
+	HASH,
 
+	PARAMETER = 250,
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
 	STRING_VALUE = 253,
@@ -233,6 +238,21 @@ struct aql_attribute_s {
 };
 typedef struct aql_attribute_s aql_attribute_t;
 
+enum aql_param_kind_e {
+	AQL_PARAM_VALUE = 1,
+	AQL_PARAM_OPERAND = 2
+};
+typedef enum aql_param_kind_e aql_param_kind_t;
+
+/* A '?' placeholder: either a slot in the value list of an INSERT or
+   a long operand in the bytecode of the WHERE condition. */
+struct aql_param_s {
+	uint8_t kind;
+	uint8_t value_index;
+	lvm_ip_t ip;
+};
+typedef struct aql_param_s aql_param_t;
+
 struct aql_adt_s {
 	char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
 	aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
@@ -245,9 +265,17 @@ struct aql_adt_s {
 	uint32_t optype;
 	uint8_t flags;
 	void *lvm_instance;
+	aql_param_t params[AQL_PARAMETER_LIMIT];
+	uint8_t param_count;
 };
 typedef struct aql_adt_s aql_adt_t;
 
+/* A statement parsed and compiled once by db_prepare(). */
+struct _db_stmt_s {
+	aql_adt_t adt;
+	uint32_t bound;
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -260,5 +288,6 @@ void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_add_parameter(aql_adt_t *adt, aql_param_kind_t kind);
 
 #endif							/* !AQL_H */
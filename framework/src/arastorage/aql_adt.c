@@ -85,6 +85,7 @@ void aql_clear(aql_adt_t *adt)
 	adt->attribute_count = 0;
 	adt->value_count = 0;
 	adt->flags = 0;
+	adt->param_count = 0;
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -138,6 +139,7 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	value = &adt->values[adt->value_count++];
 	value->domain = domain;
+	VALUE_STRING(value) = NULL;
 
 	switch (domain) {
 	case DOMAIN_INT:
@@ -160,3 +162,30 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+db_result_t aql_add_parameter(aql_adt_t *adt, aql_param_kind_t kind)
+{
+	aql_param_t *param;
+
+	if (adt->param_count == AQL_PARAMETER_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	param = &adt->params[adt->param_count];
+	param->kind = kind;
+	param->value_index = 0;
+	param->ip = -1;
+
+	if (kind == AQL_PARAM_VALUE) {
+		if (adt->value_count == AQL_ATTRIBUTE_LIMIT) {
+			return DB_LIMIT_ERROR;
+		}
+		/* The slot stays unspecified until a value is bound to it. */
+		param->value_index = adt->value_count;
+		adt->values[adt->value_count++].domain = DOMAIN_UNSPECIFIED;
+	}
+
+	adt->param_count++;
+
+	return DB_OK;
+}
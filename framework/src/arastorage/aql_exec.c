@@ -61,14 +61,26 @@
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <unistd.h>
 
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
 #include "result.h"
+#include "column.h"
 #include "aql.h"
 
+/****************************************************************************
+* Private Data
+****************************************************************************/
+/*
+ * Statements run one at a time. A query holds the lock only while it
+ * selects its tuples; the returned cursor reads its snapshot of the tuple
+ * file without it, so inserts are not held back by cursors in use.
+ */
+static pthread_mutex_t g_aql_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
@@ -111,6 +123,10 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 		free((*handle)->lvm_instance);
 		(*handle)->lvm_instance = NULL;
 	}
+	if ((*handle)->lvm_batch != NULL) {
+		free((*handle)->lvm_batch);
+		(*handle)->lvm_batch = NULL;
+	}
 	if ((*handle)->attr_map != NULL) {
 		free((*handle)->attr_map);
 		(*handle)->attr_map = NULL;
@@ -146,30 +162,37 @@ relation_t *aql_get_relation(aql_adt_t *adt)
 	return relation_load(adt->relations[first_rel_arg]);
 }
 
-db_result_t db_exec(char *format)
+static void aql_free_values(aql_adt_t *adt)
+{
+	int i;
+
+	for (i = 0; i < adt->value_count; i++) {
+		if (adt->values[i].domain == DOMAIN_STRING) {
+			free(VALUE_STRING(&adt->values[i]));
+			VALUE_STRING(&adt->values[i]) = NULL;
+		}
+		adt->values[i].domain = DOMAIN_UNSPECIFIED;
+	}
+}
+
+static db_result_t aql_exec_adt(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
+	relation_t *created;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
 
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
-
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype == AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return DB_ARGUMENT_ERROR;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
@@ -180,27 +203,31 @@ db_result_t db_exec(char *format)
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		created = relation_create(adt->relations[0], DB_STORAGE);
+		if (created != NULL) {
 			res = DB_OK;
+			if (AQL_GET_FLAGS(adt) & AQL_FLAG_COLUMNAR) {
+				res = column_create(created);
+			}
 		}
 		break;
 	case AQL_TYPE_INSERT:
 		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
+			res = relation_insert(rel, adt->values);
 			if (DB_SUCCESS(res)) {
 				res = DB_OK;
 			}
@@ -209,10 +236,10 @@ db_result_t db_exec(char *format)
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -236,9 +263,36 @@ db_result_t db_exec(char *format)
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+db_result_t db_exec(char *format)
 {
+	db_result_t res;
 	aql_adt_t adt;
+
+	pthread_mutex_lock(&g_aql_lock);
+	res = aql_get_parse_result(format, &adt);
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
+		res = DB_PARSING_ERROR;
+		goto out;
+	}
+
+	if (adt.param_count > 0) {
+		DB_LOG_E("DB : Placeholders need db_prepare\n");
+		aql_free_values(&adt);
+		res = DB_ARGUMENT_ERROR;
+		goto out;
+	}
+
+	res = aql_exec_adt(&adt);
+	aql_free_values(&adt);
+
+out:
+	pthread_mutex_unlock(&g_aql_lock);
+	return res;
+}
+
+static db_cursor_t *aql_query_adt(aql_adt_t *adt, bool stream)
+{
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -248,11 +302,7 @@ db_cursor_t *db_query(char *format)
 	handler = NULL;
 	cursor = NULL;
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return NULL;
@@ -263,19 +313,20 @@ db_cursor_t *db_query(char *format)
 	}
 #endif
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
+		free(adt->lvm_instance);
 		return NULL;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
@@ -283,11 +334,11 @@ db_cursor_t *db_query(char *format)
 			DB_LOG_E("DB: Init handle failed\n");
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		if (DB_ERROR(relation_select(&handler, rel, adt))) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
-		cursor = relation_process_result(handler);
+		cursor = stream ? relation_stream_result(handler) : relation_process_result(handler);
 		if (cursor == NULL) {
 			DB_LOG_E("DB: Failed to process cursor tuples\n");
 			goto errout;
@@ -321,3 +372,267 @@ errout:
 
 	return NULL;
 }
+
+db_cursor_t *db_query(char *format)
+{
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+
+	cursor = NULL;
+	pthread_mutex_lock(&g_aql_lock);
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
+		goto out;
+	}
+
+	if (adt.param_count > 0) {
+		DB_LOG_E("DB : Placeholders need db_prepare\n");
+		free(adt.lvm_instance);
+		goto out;
+	}
+
+	cursor = aql_query_adt(&adt, false);
+
+out:
+	pthread_mutex_unlock(&g_aql_lock);
+	return cursor;
+}
+
+db_cursor_t *db_query_stream(char *format)
+{
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+
+	cursor = NULL;
+	pthread_mutex_lock(&g_aql_lock);
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_query_stream\n");
+		goto out;
+	}
+
+	if (adt.param_count > 0) {
+		DB_LOG_E("DB : Placeholders need db_prepare\n");
+		free(adt.lvm_instance);
+		goto out;
+	}
+
+	cursor = aql_query_adt(&adt, true);
+
+out:
+	pthread_mutex_unlock(&g_aql_lock);
+	return cursor;
+}
+
+db_result_t db_insert_batch(char *relation, db_value_t *tuples, int count)
+{
+	relation_t *rel;
+	db_result_t res;
+
+	if (relation == NULL || tuples == NULL || count <= 0) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_aql_lock);
+	rel = relation_load(relation);
+	if (rel == NULL) {
+		DB_LOG_E("DB : get relation Failed\n");
+		pthread_mutex_unlock(&g_aql_lock);
+		return DB_RELATIONAL_ERROR;
+	}
+
+	if (relation_cardinality(rel) + count > DB_TUPLE_LIMIT) {
+		res = DB_LIMIT_ERROR;
+	} else {
+		res = relation_insert_batch(rel, tuples, count);
+	}
+
+	relation_release(rel);
+	pthread_mutex_unlock(&g_aql_lock);
+	return res;
+}
+
+db_stmt_t *db_prepare(char *format)
+{
+	db_stmt_t *stmt;
+	aql_param_t *param;
+	db_result_t res;
+	int i;
+
+	stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (stmt == NULL) {
+		DB_LOG_E("DB : Failed to allocate statement\n");
+		return NULL;
+	}
+	memset(stmt, 0, sizeof(db_stmt_t));
+
+	pthread_mutex_lock(&g_aql_lock);
+	res = aql_get_parse_result(format, &stmt->adt);
+	pthread_mutex_unlock(&g_aql_lock);
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB : Parsing Error in db_prepare\n");
+		goto errout;
+	}
+
+	/* Resolve where each WHERE placeholder ended up in the bytecode once,
+	   so binding is a plain store. */
+	for (i = 0; i < stmt->adt.param_count; i++) {
+		param = &stmt->adt.params[i];
+		if (param->kind != AQL_PARAM_OPERAND) {
+			continue;
+		}
+		if (stmt->adt.lvm_instance == NULL) {
+			goto errout;
+		}
+		param->ip = lvm_find_parameter(stmt->adt.lvm_instance, i);
+		if (param->ip < 0) {
+			DB_LOG_E("DB : Lost placeholder %d in condition\n", i);
+			goto errout;
+		}
+	}
+
+	return stmt;
+
+errout:
+	db_finalize(stmt);
+	return NULL;
+}
+
+static db_result_t aql_bind_number(db_stmt_t *stmt, int index, domain_t domain, long value)
+{
+	aql_param_t *param;
+	attribute_value_t *slot;
+
+	if (stmt == NULL || index < 0 || index >= stmt->adt.param_count) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	param = &stmt->adt.params[index];
+	if (param->kind == AQL_PARAM_VALUE) {
+		slot = &stmt->adt.values[param->value_index];
+		if (slot->domain == DOMAIN_STRING) {
+			free(VALUE_STRING(slot));
+		}
+		slot->domain = domain;
+		VALUE_LONG(slot) = value;
+	} else {
+		lvm_bind_long(stmt->adt.lvm_instance, param->ip, value);
+	}
+	stmt->bound |= (uint32_t)1 << index;
+
+	return DB_OK;
+}
+
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value)
+{
+	return aql_bind_number(stmt, index, DOMAIN_INT, (long)value);
+}
+
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value)
+{
+	return aql_bind_number(stmt, index, DOMAIN_LONG, value);
+}
+
+db_result_t db_bind_string(db_stmt_t *stmt, int index, const char *value)
+{
+	aql_param_t *param;
+	attribute_value_t *slot;
+	unsigned char *str;
+	size_t len;
+
+	if (stmt == NULL || value == NULL || index < 0 || index >= stmt->adt.param_count) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	param = &stmt->adt.params[index];
+	if (param->kind != AQL_PARAM_VALUE) {
+		/* Conditions are evaluated on longs only. */
+		return DB_TYPE_ERROR;
+	}
+
+	len = strlen(value);
+	str = (unsigned char *)malloc(len + 1);
+	if (str == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memcpy(str, value, len + 1);
+
+	slot = &stmt->adt.values[param->value_index];
+	if (slot->domain == DOMAIN_STRING) {
+		free(VALUE_STRING(slot));
+	}
+	slot->domain = DOMAIN_STRING;
+	VALUE_STRING(slot) = str;
+	stmt->bound |= (uint32_t)1 << index;
+
+	return DB_OK;
+}
+
+static bool aql_all_bound(db_stmt_t *stmt)
+{
+	uint32_t mask;
+
+	mask = ((uint32_t)1 << stmt->adt.param_count) - 1;
+	return (stmt->bound & mask) == mask;
+}
+
+db_result_t db_stmt_exec(db_stmt_t *stmt)
+{
+	db_result_t res;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (!aql_all_bound(stmt)) {
+		DB_LOG_E("DB : Unbound placeholder in statement\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_aql_lock);
+	res = aql_exec_adt(&stmt->adt);
+	pthread_mutex_unlock(&g_aql_lock);
+	return res;
+}
+
+db_cursor_t *db_stmt_query(db_stmt_t *stmt)
+{
+	aql_adt_t adt;
+	lvm_instance_t *lvm;
+	db_cursor_t *cursor;
+
+	if (stmt == NULL || !aql_all_bound(stmt)) {
+		return NULL;
+	}
+
+	/* The query consumes its condition, so run it on a copy of the
+	   compiled bytecode and keep the template for the next run. */
+	memcpy(&adt, &stmt->adt, sizeof(adt));
+	if (stmt->adt.lvm_instance != NULL) {
+		lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
+		if (lvm == NULL) {
+			DB_LOG_E("DB : Failed to malloc lvm instance\n");
+			return NULL;
+		}
+		memcpy(lvm, stmt->adt.lvm_instance, sizeof(lvm_instance_t));
+		AQL_SET_CONDITION(&adt, lvm);
+	}
+
+	pthread_mutex_lock(&g_aql_lock);
+	cursor = aql_query_adt(&adt, false);
+	pthread_mutex_unlock(&g_aql_lock);
+	return cursor;
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	aql_free_values(&stmt->adt);
+	if (stmt->adt.lvm_instance != NULL) {
+		free(stmt->adt.lvm_instance);
+	}
+	free(stmt);
+
+	return DB_OK;
+}
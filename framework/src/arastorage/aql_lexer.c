@@ -111,12 +111,13 @@ static const struct keyword keywords[] = {
 	{"JOIN", JOIN},
 	{"LONG", LONG},
 	{"TYPE", TYPE},
+	{"HASH", HASH},
 
-	{"WHERE", WHERE},			/* 34 */
+	{"WHERE", WHERE},			/* 35 */
 	{"COUNT", COUNT},
 	{"INDEX", INDEX},
 
-	{"INSERT", INSERT},			/* 37 */
+	{"INSERT", INSERT},			/* 38 */
 	{"SELECT", SELECT},
 	{"REMOVE", REMOVE},
 	{"CREATE", CREATE},
@@ -126,18 +127,19 @@ static const struct keyword keywords[] = {
 	{"INLINE", INLINE},
 	{"REMAIN", REMAIN},
 
-	{"PROJECT", PROJECT},		/* 46 */
+	{"PROJECT", PROJECT},		/* 47 */
 
-	{"RELATION", RELATION},		/* 47 */
+	{"RELATION", RELATION},		/* 48 */
+	{"COLUMNAR", COLUMNAR},
 
-	{"ATTRIBUTE", ATTRIBUTE},	/* 48 */
+	{"ATTRIBUTE", ATTRIBUTE},	/* 50 */
 	{"BPLUSTREE", BPLUSTREE}
 };
 
 /* Provides a pointer to the first keyword of a specific length. */
-static const int8_t skip_hint[] = { 0, 13, 21, 28, 34, 37, 46, 47, 48 };
+static const int8_t skip_hint[] = { 0, 13, 21, 28, 35, 38, 47, 48, 50 };
 
-static char separators[] = "#.;,() \t\n";
+static char separators[] = "#.;,()? \t\n";
 
 /****************************************************************************
 * Private Functions
@@ -267,6 +269,11 @@ int lexer_next(lexer_t *lexer)
 		return next_string(lexer, s + 1);
 	case '\0':
 		return 0;
+	case '?':
+		/* A placeholder for a value bound to a prepared statement. */
+		*lexer->token = PARAMETER;
+		lexer->input = s + 1;
+		return 1;
 	default:
 		if (isdigit((int)*s) || (*s == '-' && isdigit((int)s[1]))) {
 			return next_real(lexer, s);
@@ -261,6 +261,11 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAMETER:
+		if (DB_ERROR(aql_add_parameter(adt, AQL_PARAM_VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -295,6 +300,12 @@ PARSER(operand)
 	case INTEGER_VALUE:
 		lvm_set_long(p, *(long *)lexer->value);
 		break;
+	case PARAMETER:
+		if (DB_ERROR(aql_add_parameter(adt, AQL_PARAM_OPERAND))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		lvm_set_parameter(p, adt->param_count - 1);
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -622,6 +633,7 @@ PARSER(remove_from)
 
 	if (!PARSE(where)) {
 		free(lvm);
+		AQL_SET_CONDITION(adt, NULL);
 		RETURN(SYNTAX_ERROR);
 	}
 
@@ -692,6 +704,7 @@ PARSER_TOKEN(index_type)
 	switch (TOKEN) {
 	case INLINE:
 	case BPLUSTREE:
+	case HASH:
 		return TOKEN;
 	default:
 		return NONE;
@@ -729,6 +742,9 @@ PARSER(create_index)
 	case BPLUSTREE:
 		type = INDEX_BPLUSTREE;
 		break;
+	case HASH:
+		type = INDEX_HASH;
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -746,6 +762,13 @@ PARSER(create_relation)
 	AQL_SET_TYPE(adt, AQL_TYPE_CREATE_RELATION);
 	AQL_ADD_RELATION(adt, VALUE);
 
+	NEXT;
+	if (TOKEN == COLUMNAR) {
+		AQL_SET_FLAG(adt, AQL_FLAG_COLUMNAR);
+	} else {
+		REWIND;
+	}
+
 	RETURN(STATUS_OK);
 }
 
@@ -148,6 +148,61 @@ const char *db_get_result_message(db_result_t code)
 	};
 }
 
+static struct memb *db_pool(db_pool_t pool)
+{
+	if (pool == DB_POOL_INDEX) {
+		return index_pool();
+	}
+	return relation_pool(pool);
+}
+
+db_result_t db_get_pool_stats(db_pool_t pool, db_pool_stats_t *stats)
+{
+	struct memb *m;
+
+	m = db_pool(pool);
+	if (m == NULL || stats == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	stats->used = m->stats.used;
+	stats->high_water = m->stats.high_water;
+	stats->capacity = m->stats.capacity;
+	stats->limit = m->limit;
+	stats->chunks = m->stats.chunks;
+	stats->allocs = m->stats.allocs;
+	stats->failures = m->stats.failures;
+	return DB_OK;
+}
+
+db_result_t db_set_pool_limit(db_pool_t pool, uint16_t limit)
+{
+	struct memb *m;
+
+	m = db_pool(pool);
+	if (m == NULL || limit < m->num) {
+		return DB_ARGUMENT_ERROR;
+	}
+	/* Chunks above a lowered limit stay until they are empty. */
+	m->limit = limit;
+	memb_shrink(m);
+	return DB_OK;
+}
+
+db_result_t db_print_pool_stats(void)
+{
+	static const char *names[] = { "relation", "attribute", "index" };
+	db_pool_stats_t stats;
+	int pool;
+
+	for (pool = DB_POOL_RELATION; pool <= DB_POOL_INDEX; pool++) {
+		if (DB_ERROR(db_get_pool_stats(pool, &stats))) {
+			return DB_ARGUMENT_ERROR;
+		}
+		output("%s pool: used %u, high water %u, capacity %u/%u, chunks %u, allocs %lu, failures %lu\n", names[pool], stats.used, stats.high_water, stats.capacity, stats.limit, stats.chunks, (unsigned long)stats.allocs, (unsigned long)stats.failures);
+	}
+	return DB_OK;
+}
+
 /* Print the related information which will be printed : relation, attribute name */
 db_result_t db_print_header(db_cursor_t *cursor)
 {
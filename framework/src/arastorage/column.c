@@ -0,0 +1,630 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "db_options.h"
+#include "db_debug.h"
+#include "storage.h"
+#include "result.h"
+#include "column.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define VARINT_MAX_LENGTH ((sizeof(long) * 8 + 6) / 7)
+
+#define IS_COLUMN_DOMAIN(attr) ((attr)->domain == DOMAIN_INT || (attr)->domain == DOMAIN_LONG)
+
+#define BLOCK_HEADER_LENGTH(count) \
+	(sizeof(struct column_block_s) + (count) * (sizeof(column_summary_t) + sizeof(uint16_t)))
+
+#define COLUMN_VALUES(base, col) ((base) + (col) * DB_COLUMN_BLOCK_ROWS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* Head of the column file */
+struct column_header_s {
+	uint32_t rows;
+	uint32_t length;
+};
+
+/* Head of a block, followed by the summaries and the data length of
+   each column, and then by the encoded data of each column */
+struct column_block_s {
+	uint32_t row_count;
+	uint32_t length;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static void column_filename(relation_t *rel, char *filename)
+{
+	snprintf(filename, COLUMN_NAME_LENGTH + 1, "%s%s", rel->name, COLUMN_NAME_SUFFIX);
+}
+
+static uint8_t column_count(relation_t *rel)
+{
+	attribute_t *attr;
+	uint8_t count;
+
+	count = 0;
+	for (attr = list_head(rel->attributes); attr != NULL && count < COLUMN_LIMIT; attr = attr->next) {
+		if (IS_COLUMN_DOMAIN(attr)) {
+			count++;
+		}
+	}
+	return count;
+}
+
+/* Allocates the tail once the attributes of the relation are known */
+static db_result_t prepare_tail(relation_t *rel)
+{
+	column_store_t *store;
+
+	store = rel->columns;
+	if (store->tail != NULL) {
+		return DB_OK;
+	}
+	store->column_count = column_count(rel);
+	if (store->column_count == 0) {
+		return DB_OK;
+	}
+	store->tail = (long *)malloc(sizeof(long) * store->column_count * DB_COLUMN_BLOCK_ROWS);
+	if (store->tail == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	return DB_OK;
+}
+
+static db_result_t write_header(db_storage_id_t fd, column_store_t *store)
+{
+	struct column_header_s header;
+
+	header.rows = store->rows;
+	header.length = store->length;
+	return storage_write_to(fd, &header, 0, sizeof(header));
+}
+
+/* Encodes the values as zigzag varint deltas and summarizes them */
+static unsigned encode_values(unsigned char *ptr, long *values, uint16_t count, column_summary_t *summary)
+{
+	unsigned long delta;
+	long previous;
+	unsigned length;
+	uint16_t i;
+
+	summary->min = values[0];
+	summary->max = values[0];
+	previous = 0;
+	length = 0;
+	for (i = 0; i < count; i++) {
+		delta = (unsigned long)values[i] - (unsigned long)previous;
+		delta = (delta << 1) ^ (0UL - (delta >> (sizeof(long) * 8 - 1)));
+		do {
+			ptr[length] = delta & 0x7f;
+			delta >>= 7;
+			if (delta != 0) {
+				ptr[length] |= 0x80;
+			}
+			length++;
+		} while (delta != 0);
+
+		if (values[i] < summary->min) {
+			summary->min = values[i];
+		}
+		if (values[i] > summary->max) {
+			summary->max = values[i];
+		}
+		previous = values[i];
+	}
+	return length;
+}
+
+static db_result_t decode_values(unsigned char *ptr, unsigned length, long *values, uint16_t count)
+{
+	unsigned long delta;
+	unsigned long previous;
+	unsigned shift;
+	unsigned pos;
+	uint16_t i;
+
+	previous = 0;
+	pos = 0;
+	for (i = 0; i < count; i++) {
+		delta = 0;
+		shift = 0;
+		do {
+			if (pos == length || shift >= sizeof(long) * 8) {
+				return DB_STORAGE_ERROR;
+			}
+			delta |= (unsigned long)(ptr[pos] & 0x7f) << shift;
+			shift += 7;
+		} while (ptr[pos++] & 0x80);
+
+		previous += (delta >> 1) ^ (0UL - (delta & 1));
+		values[i] = (long)previous;
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: write_block
+ *
+ * Description: Encodes the tail as a new block at the end of the column
+ *              file and then commits it in the file header
+ *
+ ****************************************************************************/
+static db_result_t write_block(relation_t *rel)
+{
+	column_store_t *store;
+	struct column_block_s block;
+	column_summary_t summary;
+	uint16_t length;
+	unsigned char *buffer;
+	unsigned char *data;
+	unsigned header_length;
+	char filename[COLUMN_NAME_LENGTH + 1];
+	db_storage_id_t fd;
+	db_result_t result;
+	int i;
+
+	store = rel->columns;
+	header_length = BLOCK_HEADER_LENGTH(store->column_count);
+	buffer = (unsigned char *)malloc(header_length + store->column_count * store->tail_rows * VARINT_MAX_LENGTH);
+	if (buffer == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	data = buffer + header_length;
+	block.row_count = store->tail_rows;
+	block.length = 0;
+	for (i = 0; i < store->column_count; i++) {
+		length = encode_values(data + block.length, COLUMN_VALUES(store->tail, i), store->tail_rows, &summary);
+		memcpy(buffer + sizeof(block) + i * sizeof(summary), &summary, sizeof(summary));
+		memcpy(buffer + sizeof(block) + store->column_count * sizeof(summary) + i * sizeof(length), &length, sizeof(length));
+		block.length += length;
+	}
+	memcpy(buffer, &block, sizeof(block));
+
+	column_filename(rel, filename);
+	fd = storage_open(filename, O_RDWR);
+	if (fd < 0) {
+		free(buffer);
+		return DB_STORAGE_ERROR;
+	}
+
+	result = storage_write_to(fd, buffer, sizeof(struct column_header_s) + store->length, header_length + block.length);
+	if (DB_SUCCESS(result)) {
+		store->rows += store->tail_rows;
+		store->length += header_length + block.length;
+		result = write_header(fd, store);
+		if (DB_ERROR(result)) {
+			store->rows -= store->tail_rows;
+			store->length -= header_length + block.length;
+		}
+	}
+	storage_close(fd);
+	free(buffer);
+
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to write a column block of relation %s\n", rel->name);
+		return DB_STORAGE_ERROR;
+	}
+	store->tail_rows = 0;
+	return DB_OK;
+}
+
+/* Rebuilds the column data of the tuples that have no block yet */
+static db_result_t catch_up(relation_t *rel)
+{
+	column_store_t *store;
+	storage_row_t row;
+	tuple_id_t tuple_id;
+	db_result_t result;
+
+	store = rel->columns;
+	if (store->column_count == 0 || !RELATION_HAS_TUPLES(rel)) {
+		return DB_OK;
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	storage_flush_insert_buffer();
+#endif
+
+	row = (storage_row_t)malloc(sizeof(char) * rel->row_length + 1);
+	if (row == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	result = DB_OK;
+	for (tuple_id = store->rows + store->tail_rows; tuple_id < rel->cardinality; tuple_id++) {
+		result = storage_get_row(rel, &tuple_id, row);
+		if (result != DB_OK) {
+			break;
+		}
+		result = column_append(rel, row);
+		if (DB_ERROR(result)) {
+			break;
+		}
+	}
+	free(row);
+
+	return DB_ERROR(result) ? result : DB_OK;
+}
+
+static db_result_t reset_file(relation_t *rel)
+{
+	char filename[COLUMN_NAME_LENGTH + 1];
+	db_storage_id_t fd;
+	db_result_t result;
+
+	column_filename(rel, filename);
+	if (DB_ERROR(storage_generate_file(filename))) {
+		return DB_STORAGE_ERROR;
+	}
+	fd = storage_open(filename, O_RDWR);
+	if (fd < 0) {
+		return DB_STORAGE_ERROR;
+	}
+	rel->columns->rows = 0;
+	rel->columns->length = 0;
+	rel->columns->tail_rows = 0;
+	result = write_header(fd, rel->columns);
+	storage_close(fd);
+	return result;
+}
+
+static db_result_t store_allocate(relation_t *rel)
+{
+	rel->columns = (column_store_t *)malloc(sizeof(column_store_t));
+	if (rel->columns == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(rel->columns, 0, sizeof(column_store_t));
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: column_create
+ *
+ * Description: Makes a relation columnar. Tuples already in the relation
+ *              are encoded right away
+ *
+ ****************************************************************************/
+db_result_t column_create(relation_t *rel)
+{
+	db_result_t result;
+
+	if (!RELATION_HAS_COLUMNS(rel) && DB_ERROR(store_allocate(rel))) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	result = reset_file(rel);
+	if (DB_SUCCESS(result)) {
+		result = prepare_tail(rel);
+	}
+	if (DB_SUCCESS(result)) {
+		result = catch_up(rel);
+	}
+	if (DB_ERROR(result)) {
+		column_remove(rel);
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: column_load
+ *
+ * Description: Attaches the column file of a relation when there is one.
+ *              Relations without a column file stay row based
+ *
+ ****************************************************************************/
+db_result_t column_load(relation_t *rel)
+{
+	struct column_header_s header;
+	char filename[COLUMN_NAME_LENGTH + 1];
+	db_storage_id_t fd;
+	db_result_t result;
+
+	column_filename(rel, filename);
+	fd = storage_open(filename, O_RDONLY);
+	if (fd < 0) {
+		return DB_OK;
+	}
+	result = storage_read_from(fd, &header, 0, sizeof(header));
+	storage_close(fd);
+
+	if (!RELATION_HAS_COLUMNS(rel) && DB_ERROR(store_allocate(rel))) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	if (DB_ERROR(result) || header.rows > rel->cardinality) {
+		/* The column file does not match the tuple file, so build it again */
+		DB_LOG_E("DB: Rebuilding the column file of relation %s\n", rel->name);
+		result = reset_file(rel);
+	} else {
+		rel->columns->rows = header.rows;
+		rel->columns->length = header.length;
+	}
+	if (DB_SUCCESS(result)) {
+		result = prepare_tail(rel);
+	}
+	if (DB_SUCCESS(result)) {
+		result = catch_up(rel);
+	}
+	if (DB_ERROR(result)) {
+		column_release(rel);
+	}
+	return result;
+}
+
+db_result_t column_append(relation_t *rel, storage_row_t row)
+{
+	column_store_t *store;
+	attribute_t *attr;
+	attribute_value_t value;
+	unsigned char *ptr;
+	int col;
+
+	if (DB_ERROR(prepare_tail(rel))) {
+		return DB_ALLOCATION_ERROR;
+	}
+	store = rel->columns;
+	if (store->column_count == 0) {
+		return DB_OK;
+	}
+
+	col = 0;
+	ptr = row;
+	for (attr = list_head(rel->attributes); attr != NULL && col < store->column_count; attr = attr->next) {
+		if (IS_COLUMN_DOMAIN(attr)) {
+			if (DB_ERROR(db_phy_to_value(&value, attr, ptr))) {
+				return DB_TYPE_ERROR;
+			}
+			COLUMN_VALUES(store->tail, col)[store->tail_rows] = db_value_to_long(&value);
+			col++;
+		}
+		ptr += attr->element_size;
+	}
+
+	store->tail_rows++;
+	if (store->tail_rows == DB_COLUMN_BLOCK_ROWS) {
+		return write_block(rel);
+	}
+	return DB_OK;
+}
+
+db_result_t column_remove(relation_t *rel)
+{
+	char filename[COLUMN_NAME_LENGTH + 1];
+	db_result_t result;
+
+	column_filename(rel, filename);
+	result = storage_remove(filename);
+	column_release(rel);
+	return result;
+}
+
+void column_release(relation_t *rel)
+{
+	if (RELATION_HAS_COLUMNS(rel)) {
+		free(rel->columns->tail);
+		free(rel->columns);
+		rel->columns = NULL;
+	}
+}
+
+/* Returns the position of an attribute in the column file, or -1 */
+int column_find(relation_t *rel, attribute_t *attr)
+{
+	attribute_t *ptr;
+	int col;
+
+	if (!IS_COLUMN_DOMAIN(attr)) {
+		return -1;
+	}
+	col = 0;
+	for (ptr = list_head(rel->attributes); ptr != NULL && col < COLUMN_LIMIT; ptr = ptr->next) {
+		if (ptr == attr) {
+			return col;
+		}
+		if (IS_COLUMN_DOMAIN(ptr)) {
+			col++;
+		}
+	}
+	return -1;
+}
+
+/****************************************************************************
+ * Name: column_scan_init
+ *
+ * Description: Prepares a scan over the blocks of a columnar relation.
+ *              Only the columns set in mask are decoded by
+ *              column_scan_read()
+ *
+ ****************************************************************************/
+db_result_t column_scan_init(column_scan_t *scan, relation_t *rel, uint32_t mask)
+{
+	column_store_t *store;
+	char filename[COLUMN_NAME_LENGTH + 1];
+	uint8_t count;
+
+	memset(scan, 0, sizeof(column_scan_t));
+	scan->rel = rel;
+	scan->mask = mask;
+	scan->storage = INVALID_STORAGE_ID;
+	scan->offset = sizeof(struct column_header_s);
+
+	if (DB_ERROR(prepare_tail(rel))) {
+		return DB_ALLOCATION_ERROR;
+	}
+	store = rel->columns;
+	count = store->column_count;
+	if (count == 0) {
+		return DB_OK;
+	}
+
+	scan->summary = (column_summary_t *)malloc(sizeof(column_summary_t) * count);
+	scan->lengths = (uint16_t *)malloc(sizeof(uint16_t) * count);
+	scan->buffer = (unsigned char *)malloc(BLOCK_HEADER_LENGTH(count) + DB_COLUMN_BLOCK_ROWS * VARINT_MAX_LENGTH);
+	scan->values = (long *)malloc(sizeof(long) * count * DB_COLUMN_BLOCK_ROWS);
+	if (scan->summary == NULL || scan->lengths == NULL || scan->buffer == NULL || scan->values == NULL) {
+		column_scan_end(scan);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	if (store->length > 0) {
+		column_filename(rel, filename);
+		scan->storage = storage_open(filename, O_RDONLY);
+		if (scan->storage < 0) {
+			scan->storage = INVALID_STORAGE_ID;
+			column_scan_end(scan);
+			return DB_STORAGE_ERROR;
+		}
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: column_scan_next
+ *
+ * Description: Moves to the next block and reads its summaries. The
+ *              tuples that are not in a block yet come last.
+ *              DB_FINISHED is returned after the last block
+ *
+ ****************************************************************************/
+db_result_t column_scan_next(column_scan_t *scan)
+{
+	column_store_t *store;
+	struct column_block_s block;
+	unsigned header_length;
+	long *values;
+	uint16_t i;
+	int col;
+
+	store = scan->rel->columns;
+	if (store->column_count == 0 || scan->tail) {
+		return DB_FINISHED;
+	}
+
+	if (scan->offset < sizeof(struct column_header_s) + store->length) {
+		header_length = BLOCK_HEADER_LENGTH(store->column_count);
+		if (DB_ERROR(storage_read_from(scan->storage, scan->buffer, scan->offset, header_length))) {
+			return DB_STORAGE_ERROR;
+		}
+		memcpy(&block, scan->buffer, sizeof(block));
+		memcpy(scan->summary, scan->buffer + sizeof(block), sizeof(column_summary_t) * store->column_count);
+		memcpy(scan->lengths, scan->buffer + sizeof(block) + sizeof(column_summary_t) * store->column_count, sizeof(uint16_t) * store->column_count);
+		if (block.row_count == 0 || block.row_count > DB_COLUMN_BLOCK_ROWS) {
+			return DB_STORAGE_ERROR;
+		}
+		scan->row_count = block.row_count;
+		scan->data = scan->offset + header_length;
+		scan->offset = scan->data + block.length;
+		return DB_OK;
+	}
+
+	if (store->tail_rows == 0) {
+		return DB_FINISHED;
+	}
+	scan->tail = 1;
+	scan->row_count = store->tail_rows;
+	for (col = 0; col < store->column_count; col++) {
+		values = COLUMN_VALUES(store->tail, col);
+		scan->summary[col].min = values[0];
+		scan->summary[col].max = values[0];
+		for (i = 1; i < store->tail_rows; i++) {
+			if (values[i] < scan->summary[col].min) {
+				scan->summary[col].min = values[i];
+			}
+			if (values[i] > scan->summary[col].max) {
+				scan->summary[col].max = values[i];
+			}
+		}
+	}
+	return DB_OK;
+}
+
+column_summary_t *column_scan_summary(column_scan_t *scan, int col)
+{
+	return &scan->summary[col];
+}
+
+/* Decodes the columns of the current block that are set in the mask */
+db_result_t column_scan_read(column_scan_t *scan)
+{
+	column_store_t *store;
+	unsigned long offset;
+	int col;
+
+	if (scan->tail) {
+		return DB_OK;
+	}
+
+	store = scan->rel->columns;
+	offset = scan->data;
+	for (col = 0; col < store->column_count; col++) {
+		if (scan->mask & (1u << col)) {
+			if (DB_ERROR(storage_read_from(scan->storage, scan->buffer, offset, scan->lengths[col]))) {
+				return DB_STORAGE_ERROR;
+			}
+			if (DB_ERROR(decode_values(scan->buffer, scan->lengths[col], COLUMN_VALUES(scan->values, col), scan->row_count))) {
+				DB_LOG_E("DB: Corrupted column block in relation %s\n", scan->rel->name);
+				return DB_STORAGE_ERROR;
+			}
+		}
+		offset += scan->lengths[col];
+	}
+	return DB_OK;
+}
+
+long column_scan_value(column_scan_t *scan, int col, uint16_t row)
+{
+	if (scan->tail) {
+		return COLUMN_VALUES(scan->rel->columns->tail, col)[row];
+	}
+	return COLUMN_VALUES(scan->values, col)[row];
+}
+
+void column_scan_end(column_scan_t *scan)
+{
+	if (scan->storage != INVALID_STORAGE_ID) {
+		storage_close(scan->storage);
+		scan->storage = INVALID_STORAGE_ID;
+	}
+	free(scan->summary);
+	free(scan->lengths);
+	free(scan->buffer);
+	free(scan->values);
+	scan->summary = NULL;
+	scan->lengths = NULL;
+	scan->buffer = NULL;
+	scan->values = NULL;
+}
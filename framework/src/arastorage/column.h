@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef COLUMN_H
+#define COLUMN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <arastorage/arastorage.h>
+#include "storage.h"
+
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+/* The maximum number of INT and LONG attributes kept in the column file */
+#define COLUMN_LIMIT 32
+
+#define RELATION_HAS_COLUMNS(rel) ((rel)->columns != NULL)
+
+/****************************************************************************
+* Public Type Definitions
+****************************************************************************/
+struct column_summary_s {
+	long min;
+	long max;
+};
+typedef struct column_summary_s column_summary_t;
+
+/*
+ * The INT and LONG attributes of a columnar relation are kept in a column
+ * file next to the tuple file. Tuples are grouped in blocks of
+ * DB_COLUMN_BLOCK_ROWS, and every attribute of a block is stored as its
+ * own run of zigzag varint deltas after the min/max summaries of the
+ * block. Tuples of the last, incomplete block are held in memory and are
+ * rebuilt from the tuple file when the relation is loaded.
+ */
+struct column_store_s {
+	tuple_id_t rows;			/* Tuples held in written blocks */
+	uint32_t length;			/* Bytes of written blocks */
+	uint16_t tail_rows;
+	uint8_t column_count;
+	long *tail;					/* column_count * DB_COLUMN_BLOCK_ROWS values */
+};
+typedef struct column_store_s column_store_t;
+
+/* Sequential reader of the blocks of a columnar relation */
+struct column_scan_s {
+	relation_t *rel;
+	db_storage_id_t storage;
+	unsigned long offset;		/* Offset of the next block */
+	unsigned long data;			/* Offset of the encoded data of the block */
+	uint32_t mask;				/* Columns to decode */
+	uint16_t row_count;
+	uint8_t tail;
+	column_summary_t *summary;
+	uint16_t *lengths;
+	unsigned char *buffer;
+	long *values;
+};
+typedef struct column_scan_s column_scan_t;
+
+/****************************************************************************
+ * Internal function prototypes
+ ****************************************************************************/
+db_result_t column_create(relation_t *);
+db_result_t column_load(relation_t *);
+db_result_t column_append(relation_t *, storage_row_t);
+db_result_t column_remove(relation_t *);
+void column_release(relation_t *);
+int column_find(relation_t *, attribute_t *);
+
+db_result_t column_scan_init(column_scan_t *, relation_t *, uint32_t);
+db_result_t column_scan_next(column_scan_t *);
+column_summary_t *column_scan_summary(column_scan_t *, int);
+db_result_t column_scan_read(column_scan_t *);
+long column_scan_value(column_scan_t *, int, uint16_t);
+void column_scan_end(column_scan_t *);
+#endif							/* !COLUMN_H */
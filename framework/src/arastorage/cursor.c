@@ -29,6 +29,116 @@
 #include "storage.h"
 #include "memb.h"
 #include "relation.h"
+#include "lvm.h"
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+
+/* Read a tuple of the tuple file of a streaming cursor. */
+static db_result_t stream_read(db_cursor_t *cursor, tuple_id_t row_id)
+{
+	struct cursor_stream_s *stream;
+
+	stream = cursor->stream;
+	if (stream->row_id == row_id) {
+		return DB_OK;
+	}
+	if (DB_ERROR(storage_read_from(stream->storage, stream->row, (unsigned long)row_id * cursor->storage_row_length, cursor->storage_row_length))) {
+		DB_LOG_E("failed to read tuple %d of %s\n", row_id, cursor->name);
+		stream->row_id = INVALID_TUPLE;
+		return DB_CURSOR_ERROR;
+	}
+	stream->row_id = row_id;
+	return DB_OK;
+}
+
+/* Evaluate the next tuples of a streaming cursor until one is selected. */
+static db_result_t stream_scan(db_cursor_t *cursor, tuple_id_t *row_id)
+{
+	struct cursor_stream_s *stream;
+	lvm_instance_t *lvm;
+	int i;
+
+	stream = cursor->stream;
+	lvm = stream->lvm_instance;
+	while (stream->next_row < cursor->total_rows) {
+		if (DB_ERROR(stream_read(cursor, stream->next_row++))) {
+			return DB_CURSOR_ERROR;
+		}
+		if (lvm != NULL) {
+			for (i = 0; i < cursor->attribute_count; i++) {
+				if (stream->attrs[i].domain == DOMAIN_INT || stream->attrs[i].domain == DOMAIN_LONG) {
+					lvm_set_operand_value(lvm, &stream->attrs[i], stream->row + cursor->attr_map[i].offset);
+				}
+			}
+			if (lvm_execute(lvm) != TRUE) {
+				continue;
+			}
+		}
+		stream->matches++;
+		if (stream->matches > cursor->cursor_rows) {
+			cursor->cursor_rows = stream->matches;
+		}
+		*row_id = stream->row_id;
+		return DB_OK;
+	}
+	stream->finished = TRUE;
+	cursor->cursor_rows = stream->matches;
+	return DB_FINISHED;
+}
+
+/* Evaluate the remaining tuples so that cursor_rows is the final count. */
+static db_result_t stream_count(db_cursor_t *cursor)
+{
+	struct cursor_stream_s *stream;
+	tuple_id_t next_row;
+	tuple_id_t matches;
+	tuple_id_t row_id;
+	db_result_t result;
+
+	stream = cursor->stream;
+	if (stream->finished) {
+		return DB_OK;
+	}
+	next_row = stream->next_row;
+	matches = stream->matches;
+	do {
+		result = stream_scan(cursor, &row_id);
+	} while (result == DB_OK);
+	stream->next_row = next_row;
+	stream->matches = matches;
+	return DB_ERROR(result) ? result : DB_OK;
+}
+
+/* Move a streaming cursor to the (row_id)th selected tuple. Tuples are
+   evaluated from the start again to move backward. */
+static db_result_t stream_move_to(db_cursor_t *cursor, tuple_id_t row_id)
+{
+	struct cursor_stream_s *stream;
+	tuple_id_t storage_row;
+	db_result_t result;
+
+	stream = cursor->stream;
+	if (row_id >= cursor->total_rows || (stream->finished && row_id >= cursor->cursor_rows)) {
+		DB_LOG_E("invalid row id\n");
+		return DB_CURSOR_ERROR;
+	}
+	if (row_id < stream->matches) {
+		stream->next_row = 0;
+		stream->matches = 0;
+	}
+	while (stream->matches <= row_id) {
+		result = stream_scan(cursor, &storage_row);
+		if (result != DB_OK) {
+			return DB_CURSOR_ERROR;
+		}
+	}
+	cursor->current_cursor_row = row_id;
+	cursor->current_storage_row = storage_row;
+	DB_LOG_D("set current cursor id = %d, storage id = %d\n", cursor->current_cursor_row, cursor->current_storage_row);
+	return DB_OK;
+}
 
 /****************************************************************************
 * Public Functions
@@ -37,6 +147,10 @@
 /* Update current cursor id and storage id. */
 db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 {
+	if (cursor != NULL && cursor->stream != NULL) {
+		return stream_move_to(cursor, row_id);
+	}
+
 	if (IS_EMPTY_CURSOR(cursor)) {
 		DB_LOG_E("Empty Cursor\n");
 		return DB_CURSOR_ERROR;
@@ -77,6 +191,9 @@ db_result_t cursor_move_first(db_cursor_t *cursor)
 /* Search the last set tuple id and update storage id corresponding it. */
 db_result_t cursor_move_last(db_cursor_t *cursor)
 {
+	if (cursor != NULL && cursor->stream != NULL && DB_ERROR(stream_count(cursor))) {
+		return DB_CURSOR_ERROR;
+	}
 	return cursor_move_to(cursor, cursor->cursor_rows - 1);
 }
 
@@ -113,6 +230,9 @@ bool cursor_is_first_row(db_cursor_t *cursor)
 	if (cursor->current_cursor_row != 0) {
 		return false;
 	}
+	if (cursor->stream != NULL) {
+		return cursor->cursor_rows > 0;
+	}
 	//check whether pointing storage row id is true
 	for (i = 0; i < cursor->total_rows; i++) {
 		index = GET_INDEX(i);
@@ -134,6 +254,9 @@ bool cursor_is_last_row(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return false;
 	}
+	if (cursor->stream != NULL) {
+		return DB_SUCCESS(stream_count(cursor)) && cursor->cursor_rows > 0 && cursor->current_cursor_row == cursor->cursor_rows - 1;
+	}
 	//check whether pointing cursor id is correct
 	if (cursor->current_cursor_row != cursor->cursor_rows - 1) {
 		return false;
@@ -181,6 +304,9 @@ db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
 /* Get the number of tuples in a cursor */
 cursor_row_t cursor_get_count(db_cursor_t *cursor)
 {
+	if (cursor != NULL && cursor->stream != NULL && DB_ERROR(stream_count(cursor))) {
+		return INVALID_CURSOR_VALUE;
+	}
 	if (IS_EMPTY_CURSOR(cursor)) {
 		return INVALID_CURSOR_VALUE;
 	}
@@ -261,6 +387,12 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 		/* If the type of value is aggregate value, we don't need to read storage.
 		 Because aggregate result is already calculated and stored in buffer. */
 		buf += cursor->attr_map[col].offset;
+	} else if (cursor->stream != NULL) {
+		/* The selected tuple is usually still in the row buffer. */
+		if (DB_ERROR(stream_read(cursor, cursor->current_storage_row))) {
+			return DB_CURSOR_ERROR;
+		}
+		memcpy(buf, cursor->stream->row + cursor->attr_map[col].offset, attr.element_size);
 	} else {
 		/* Otherwise, Read tuple value from storage. */
 		offset = cursor->current_storage_row * cursor->storage_row_length + cursor->attr_map[col].offset;
@@ -409,6 +541,9 @@ db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 		return DB_CURSOR_ERROR;
 	}
 
+	if ((*cursor)->name[0] != '\0') {
+		storage_unpin_tuples((*cursor)->name);
+	}
 	cursor_clean_data(*cursor);
 
 	arr_size = GET_CURSOR_DATA_ARR_SIZE(rel->cardinality);
@@ -424,9 +559,68 @@ db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 	(*cursor)->total_rows = rel->cardinality;
 
 	(*cursor)->storage_row_length = rel->row_length;
-	memcpy((*cursor)->name, rel->tuple_filename, sizeof(rel->tuple_filename));
 	memcpy((*cursor)->rel_name, rel->name, sizeof(rel->name));
 
+	/* The cursor sees the first total_rows tuples of this tuple file,
+	   which stays on storage until the cursor is freed. */
+	if (DB_ERROR(storage_pin_tuples(rel->tuple_filename))) {
+		return DB_CURSOR_ERROR;
+	}
+	memcpy((*cursor)->name, rel->tuple_filename, sizeof(rel->tuple_filename));
+
+	return DB_OK;
+}
+
+/*
+ * Turn a cursor into a streaming cursor over the tuples of a relation.
+ * The cursor takes over the condition, and its attribute map must have
+ * been set with cursor_data_set().
+ */
+db_result_t cursor_stream_init(db_cursor_t *cursor, relation_t *rel, void *lvm_instance)
+{
+	struct cursor_stream_s *stream;
+	int i;
+
+	stream = (struct cursor_stream_s *)malloc(sizeof(struct cursor_stream_s));
+	if (stream == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(stream, 0, sizeof(struct cursor_stream_s));
+	stream->storage = -1;
+	stream->row_id = INVALID_TUPLE;
+	cursor->stream = stream;
+
+	cursor->current_cursor_row = -1;
+	cursor->current_storage_row = -1;
+	cursor->cursor_rows = 0;
+	cursor->total_rows = rel->cardinality;
+	cursor->storage_row_length = rel->row_length;
+	memcpy(cursor->rel_name, rel->name, sizeof(rel->name));
+
+	stream->row = (unsigned char *)malloc(rel->row_length + 1);
+	stream->attrs = (attribute_t *)malloc(sizeof(attribute_t) * (cursor->attribute_count + 1));
+	if (stream->row == NULL || stream->attrs == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	for (i = 0; i < cursor->attribute_count; i++) {
+		memcpy(stream->attrs[i].name, cursor->attr_map[i].name, sizeof(stream->attrs[i].name));
+		stream->attrs[i].domain = cursor->attr_map[i].domain;
+		stream->attrs[i].element_size = cursor->attr_map[i].data_size;
+	}
+
+	if (cursor->total_rows > 0) {
+		if (DB_ERROR(storage_pin_tuples(rel->tuple_filename))) {
+			return DB_CURSOR_ERROR;
+		}
+		memcpy(cursor->name, rel->tuple_filename, sizeof(rel->tuple_filename));
+		stream->storage = storage_open(cursor->name, O_RDONLY);
+		if (stream->storage < 0) {
+			DB_LOG_E("failed to open storage %s\n", cursor->name);
+			return DB_CURSOR_ERROR;
+		}
+	}
+
+	stream->lvm_instance = lvm_instance;
 	return DB_OK;
 }
 
@@ -435,6 +629,19 @@ db_result_t cursor_deinit(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return DB_CURSOR_ERROR;
 	}
+	if (cursor->stream != NULL) {
+		if (cursor->stream->storage >= 0) {
+			storage_close(cursor->stream->storage);
+		}
+		free(cursor->stream->lvm_instance);
+		free(cursor->stream->attrs);
+		free(cursor->stream->row);
+		free(cursor->stream);
+		cursor->stream = NULL;
+	}
+	if (cursor->name[0] != '\0') {
+		storage_unpin_tuples(cursor->name);
+	}
 	if (cursor->row_arr) {
 		free(cursor->row_arr);
 		cursor->row_arr = NULL;
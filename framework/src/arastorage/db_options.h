@@ -88,6 +88,32 @@
 #define DB_ATTRIBUTE_POOL_SIZE          16
 #endif							/* DB_ATTRIBUTE_POOL_SIZE */
 
+/*
+ * The number of blocks a relation, attribute or index pool takes from the
+ * heap at a time once its static blocks are in use. 0 keeps the pools
+ * fixed at their static sizes.
+ */
+#ifndef DB_POOL_CHUNK_BLOCKS
+#ifdef CONFIG_ARASTORAGE_POOL_CHUNK_BLOCKS
+#define DB_POOL_CHUNK_BLOCKS            CONFIG_ARASTORAGE_POOL_CHUNK_BLOCKS
+#else
+#define DB_POOL_CHUNK_BLOCKS            4
+#endif
+#endif							/* DB_POOL_CHUNK_BLOCKS */
+
+/* The number of blocks the pools may grow to, see db_set_pool_limit(). */
+#ifndef DB_INDEX_POOL_LIMIT
+#define DB_INDEX_POOL_LIMIT             (DB_INDEX_POOL_SIZE * 4)
+#endif							/* DB_INDEX_POOL_LIMIT */
+
+#ifndef DB_RELATION_POOL_LIMIT
+#define DB_RELATION_POOL_LIMIT          (DB_RELATION_POOL_SIZE * 4)
+#endif							/* DB_RELATION_POOL_LIMIT */
+
+#ifndef DB_ATTRIBUTE_POOL_LIMIT
+#define DB_ATTRIBUTE_POOL_LIMIT         (DB_ATTRIBUTE_POOL_SIZE * 4)
+#endif							/* DB_ATTRIBUTE_POOL_LIMIT */
+
 /* The maximum number of attributes in a relation. */
 #ifndef DB_MAX_ATTRIBUTES_PER_RELATION
 #define DB_MAX_ATTRIBUTES_PER_RELATION  6
@@ -127,6 +153,11 @@
 #define AQL_ATTRIBUTE_LIMIT             6
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of '?' placeholders in a prepared statement. */
+#ifndef AQL_PARAMETER_LIMIT
+#define AQL_PARAMETER_LIMIT             8
+#endif							/* AQL_PARAMETER_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -168,6 +199,24 @@
 #define DB_TUPLE_LIMIT          2000
 #endif							/* DB_TUPLE_LIMIT */
 
+/* The amount of tuple data written at once by a bulk insert. */
+#ifndef DB_BULK_WRITE_SIZE
+#ifdef CONFIG_ARASTORAGE_BULK_WRITE_SIZE
+#define DB_BULK_WRITE_SIZE              CONFIG_ARASTORAGE_BULK_WRITE_SIZE
+#else
+#define DB_BULK_WRITE_SIZE              4096
+#endif
+#endif							/* DB_BULK_WRITE_SIZE */
+
+/* The number of tuples encoded together in a block of a columnar relation. */
+#ifndef DB_COLUMN_BLOCK_ROWS
+#ifdef CONFIG_ARASTORAGE_COLUMN_BLOCK_ROWS
+#define DB_COLUMN_BLOCK_ROWS            CONFIG_ARASTORAGE_COLUMN_BLOCK_ROWS
+#else
+#define DB_COLUMN_BLOCK_ROWS            64
+#endif
+#endif							/* DB_COLUMN_BLOCK_ROWS */
+
 /* The number of int array in a cursor. */
 #ifndef DB_CURSOR_LIMIT
 #define DB_CURSOR_LIMIT          ((DB_TUPLE_LIMIT / (sizeof(uint32_t)*8)) + 1)
@@ -193,6 +242,10 @@
 
 #define INDEX_NAME_LENGTH (RELATION_NAME_LENGTH + sizeof(INDEX_NAME_SUFFIX) - 1)
 
+#define COLUMN_NAME_SUFFIX ".col"
+
+#define COLUMN_NAME_LENGTH (RELATION_NAME_LENGTH + sizeof(COLUMN_NAME_SUFFIX) - 1)
+
 #define TUPLE_FILE_NAME "tup"
 
 #define TUPLE_NAME_LENGTH 14
@@ -205,6 +258,14 @@
 
 #define BUCKET_FILE_LENGTH 15
 
+#define SORT_FILE_NAME "sort"
+
+#define SORT_FILE_LENGTH 15
+
+#define HASH_FILE_NAME "hash"
+
+#define HASH_FILE_LENGTH 15
+
 #define TEMP_FILE_SUFFIX ".tmp"
 
 #define TEMP_FILE_SUFFIX_LENGTH 4
@@ -230,6 +291,43 @@
 #define DB_TREE_CACHE_LIMIT             10
 #endif
 
+/* The number of pages in the buffer pool shared by all bplus-tree indexes. */
+#ifndef DB_INDEX_POOL_PAGES
+#ifdef CONFIG_ARASTORAGE_INDEX_POOL_PAGES
+#define DB_INDEX_POOL_PAGES             CONFIG_ARASTORAGE_INDEX_POOL_PAGES
+#else
+#define DB_INDEX_POOL_PAGES             (DB_TREE_CACHE_LIMIT + DB_HEAP_CACHE_LIMIT)
+#endif
+#endif							/* DB_INDEX_POOL_PAGES */
+
+/* The amount of RAM used to sort index entries when an index is built. */
+#ifndef DB_INDEX_SORT_BUFFER
+#ifdef CONFIG_ARASTORAGE_INDEX_SORT_BUFFER
+#define DB_INDEX_SORT_BUFFER            CONFIG_ARASTORAGE_INDEX_SORT_BUFFER
+#else
+#define DB_INDEX_SORT_BUFFER            4096
+#endif
+#endif							/* DB_INDEX_SORT_BUFFER */
+
+/* The number of key and tuple id pairs in a bucket of a hash index. */
+#ifndef DB_HASH_BUCKET_ENTRIES
+#ifdef CONFIG_ARASTORAGE_HASH_BUCKET_ENTRIES
+#define DB_HASH_BUCKET_ENTRIES          CONFIG_ARASTORAGE_HASH_BUCKET_ENTRIES
+#else
+#define DB_HASH_BUCKET_ENTRIES          16
+#endif
+#endif							/* DB_HASH_BUCKET_ENTRIES */
+
+/* The number of buckets of a new hash index. */
+#ifndef DB_HASH_INITIAL_BUCKETS
+#define DB_HASH_INITIAL_BUCKETS         4
+#endif							/* DB_HASH_INITIAL_BUCKETS */
+
+/* The percentage of filled entries above which a hash bucket is split. */
+#ifndef DB_HASH_LOAD_FACTOR
+#define DB_HASH_LOAD_FACTOR             75
+#endif							/* DB_HASH_LOAD_FACTOR */
+
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
 #endif
@@ -254,4 +352,20 @@
 #define LVM_USE_FLOATS                  DB_FEATURE_FLOATS
 #endif							/* LVM_USE_FLOATS */
 
+/* The number of tuples evaluated together by the LVM in a sequential
+   selection. A value of 1 disables the batch evaluation. */
+#ifndef LVM_BATCH_SIZE
+#ifdef CONFIG_ARASTORAGE_LVM_BATCH_SIZE
+#define LVM_BATCH_SIZE                  CONFIG_ARASTORAGE_LVM_BATCH_SIZE
+#else
+#define LVM_BATCH_SIZE                  16
+#endif
+#endif							/* LVM_BATCH_SIZE */
+
+/* The maximum number of intermediate vectors held at once by a batch
+   evaluation. Conditions nesting deeper are evaluated tuple by tuple. */
+#ifndef LVM_BATCH_DEPTH
+#define LVM_BATCH_DEPTH                 4
+#endif							/* LVM_BATCH_DEPTH */
+
 #endif							/* !DB_OPTIONS_H */
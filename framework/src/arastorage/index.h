@@ -77,7 +77,8 @@ struct index_api_s;
 enum index_e {
 	INDEX_NONE = 0,
 	INDEX_INLINE = 1,
-	INDEX_BPLUSTREE = 2
+	INDEX_BPLUSTREE = 2,
+	INDEX_HASH = 3
 };
 typedef enum index_e index_type_t;
 
@@ -109,6 +110,30 @@ struct index_iterator_s {
 };
 typedef struct index_iterator_s index_iterator_t;
 
+struct index_entry_s {
+	long key;
+	tuple_id_t tuple_id;
+};
+typedef struct index_entry_s index_entry_t;
+
+struct index_run_s;
+
+/* Sorts index entries in DB_INDEX_SORT_BUFFER bytes of RAM. Entries which
+ * do not fit are written to a run file as sorted runs, which are merged
+ * while the entries are read back in order.
+ */
+struct index_sort_s {
+	char run_filename[DB_MAX_FILENAME_LENGTH];
+	db_storage_id_t run_storage;
+	index_entry_t *buffer;
+	tuple_id_t buffered;
+	tuple_id_t count;
+	tuple_id_t next;
+	uint16_t run_count;
+	struct index_run_s *runs;
+};
+typedef struct index_sort_s index_sort_t;
+
 struct index_api_s {
 	index_type_t type;
 	uint8_t flags;
@@ -119,6 +144,7 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	db_result_t(*build)(index_t *, index_sort_t *);
 };
 
 typedef struct index_api_s index_api_t;
@@ -128,6 +154,7 @@ typedef struct index_api_s index_api_t;
 ****************************************************************************/
 extern index_api_t index_inline;
 extern index_api_t index_bplustree;
+extern index_api_t index_hash;
 
 /****************************************************************************
  * Internal function prototypes
@@ -143,4 +170,11 @@ db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t
 tuple_id_t index_get_next(index_iterator_t *, uint8_t);
 int index_exists(attribute_t *);
 db_result_t index_deinit(void);
+struct memb *index_pool(void);
+
+db_result_t index_sort_init(index_sort_t *);
+db_result_t index_sort_add(index_sort_t *, long, tuple_id_t);
+db_result_t index_sort_finish(index_sort_t *);
+db_result_t index_sort_next(index_sort_t *, index_entry_t *);
+void index_sort_free(index_sort_t *);
 #endif							/* !INDEX_H */
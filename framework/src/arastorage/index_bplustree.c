@@ -49,6 +49,7 @@
  * Included Files
  ****************************************************************************/
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -84,6 +85,10 @@
 
 /* The total number of states possible of a node */
 #define NODE_STATES 255
+
+/* The bucket of the buffer pool hash holding a node or bucket of a tree */
+#define POOL_HASH(tree, type, id) ((((uintptr_t)(tree) >> 4) + ((unsigned)(id) << 1) + (type)) % DB_INDEX_POOL_PAGES)
+
 #define CONFIG_VACUUM_THRESHOLD 40
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_VACUUM
@@ -148,11 +153,15 @@ struct bucket_s {
 };
 typedef struct bucket_s bucket_t;
 
+/* A Buffer Pool Entry, describing the page at pos */
 struct qnode_s {
 	struct qnode_s *next;
 	struct qnode_s *prev;
-	uint8_t id;
-	uint8_t pos;
+	struct qnode_s *hash_next;
+	struct tree_s *tree;		/* The index owning the page, NULL when free */
+	uint16_t id;
+	uint16_t pos;
+	uint8_t type;
 	uint8_t node_state;
 };
 
@@ -163,29 +172,25 @@ struct queue_s {
 };
 typedef struct queue_s queue_t;
 
-/* A Bucket Cache Entry */
-struct bucket_cache_s {
-	bucket_t bucket;
-};
-
-/* A Tree Cache Entry */
-struct tree_cache_s {
+/* A Buffer Pool Page, holding either a node or a bucket */
+union page_u {
 	tree_node_t node;
+	bucket_t bucket;
 };
 
-/* Bucket Cache Structure */
-typedef struct {
-	struct bucket_cache_s cache_t[DB_HEAP_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
-} bucket_cache_t;
-
-/* Tree Cache Structure */
+/* Buffer Pool Structure, shared by all open bplus-tree indexes.
+ * Entries are kept in LRU order with the least recently used at the head,
+ * and found through a hash on (tree, type, id).
+ */
 typedef struct {
-	struct tree_cache_s cache_t[DB_TREE_CACHE_LIMIT];
+	union page_u *pages;
+	qnode_t *entries;
+	qnode_t **hash;
 	queue_t in_cache;
-	uint8_t num;
-} tree_cache_t;
+	qnode_t head;
+	qnode_t tail;
+	uint8_t users;
+} buffer_pool_t;
 
 typedef enum {
 	NODE = 0,
@@ -241,10 +246,6 @@ struct tree_s {
 	uint16_t inserted;			/*  Count of total number of tuples inserted  */
 	uint16_t deleted;			/*    Count of total number of tuples deleted  */
 	uint8_t levels;				/*  The depth of the bplus-tree including the buckets  */
-	tree_cache_t *node_cache;	/*  Structure to maintain node cache  */
-	bucket_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
-	pthread_mutex_t node_cache_lock;	/*  Maintains concurrency control over Node Cache  */
-	pthread_mutex_t buck_cache_lock;	/*  Maintains concurrency control over Bucket Cache  */
 	pthread_mutex_t bucket_lock;	/*  Maintains serialisability over in RAM Tree Structure  */
 	struct rw_lock_s tree_lock;	/*  A Reader Writer Lock used to maintain consistency in tree structure */
 };
@@ -254,6 +255,8 @@ typedef struct tree_s tree_t;
  * Private variables
  ****************************************************************************/
 static int base_offset = 0;
+static buffer_pool_t pool;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;	/* Maintains concurrency control over the Buffer Pool */
 
 /****************************************************************************
  * Private Function Prototypes
@@ -271,6 +274,12 @@ static bsplit_status_t bucket_split(tree_t *, int, int, pair_t *);
 static cache_result_t cache_bucket_append(tree_t *, int, pair_t *);
 static cache_result_t cache_write_bucket(tree_t *, int, bucket_t *);
 
+static db_result_t pool_attach(void);
+static void pool_detach(tree_t *);
+static void pool_flush(tree_t *);
+static qnode_t *pool_get(tree_t *, cache_type_t, int);
+static qnode_t *pool_put(tree_t *, cache_type_t, int, void *);
+
 static cache_result_t modify_cache(tree_t *, int, cache_type_t, op_type_t);
 static cache_result_t cache_write_node(tree_t *, int, tree_node_t *);
 static cache_result_t cache_replace_node(tree_t *, int, tree_node_t *);
@@ -282,6 +291,7 @@ static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t build(index_t *, index_sort_t *);
 
 #ifdef DB_WIP
 static db_result_t vacuum(tree_t *, relation_t *);
@@ -302,7 +312,8 @@ index_api_t index_bplustree = {
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	build
 };
 
 /****************************************************************************
@@ -326,8 +337,9 @@ int compare(const void *p1, const void *p2)
  *              bplus-tree both in memory and on flash.
  *              The tree_filename, bucket_filename and tree structure are
  *              saved the flash and also in the index_t structure in RAM,
- *              The cache for both node and buckets is present in RAM and
- *              is de-allocated when the index exits in the release function
+ *              Nodes and buckets are cached in the buffer pool shared by
+ *              all indexes, which is de-allocated when the last index exits
+ *              in the release function
  *
  ****************************************************************************/
 static db_result_t create(index_t *index)
@@ -339,7 +351,6 @@ static db_result_t create(index_t *index)
 	bucket_t buck;
 	int offset = 0;
 	db_result_t result;
-	uint8_t success = 0;
 	int curtime;
 
 	curtime = time(NULL);
@@ -415,76 +426,14 @@ static db_result_t create(index_t *index)
 	/* Initialize the tree metadata. */
 	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
 
-	/* Allocating node cache and initialising it */
-	tree->node_cache = malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
+	/* Attaching to the buffer pool shared by all indexes */
+	if (DB_ERROR(pool_attach())) {
+		DB_LOG_E("FAILED TO ALLOCATE BUFFER POOL\n");
 		result = DB_ALLOCATION_ERROR;
+		storage_close(tree->bucket_storage);
+		storage_close(tree->tree_storage);
 		storage_remove(tree_filename);
 		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it */
-	tree->buck_cache = malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
-		storage_remove(tree_filename);
-		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
 		free(tree);
 		return result;
 	}
@@ -493,9 +442,7 @@ static db_result_t create(index_t *index)
 	tree->deleted = 0;
 
 	/* Initialising Locks for concurrency control */
-	pthread_mutex_init(&(tree->node_cache_lock), NULL);
 	pthread_mutex_init(&(tree->bucket_lock), NULL);
-	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
 	rw_init(&(tree->tree_lock));
 
 	tree->off_nodes = tree->off_buckets = 0;
@@ -539,8 +486,6 @@ static db_result_t load(index_t *index)
 	tree_t *tree;
 	db_storage_id_t fd;
 	char bucket_file[DB_MAX_FILENAME_LENGTH];
-	db_result_t result;
-	uint8_t success = 0;
 
 	index->opaque_data = tree = malloc(sizeof(tree_t));
 	if (tree == NULL) {
@@ -569,73 +514,10 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
-	tree->node_cache = malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
+	if (DB_ERROR(pool_attach())) {
+		DB_LOG_E("FAILED TO ALLOCATE BUFFER POOL\n");
 		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it  */
-	tree->buck_cache = malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
-		free(tree);
-		return result;
+		return DB_ALLOCATION_ERROR;
 	}
 
 	base_offset = sizeof(tree_t) + sizeof(bucket_file);
@@ -651,53 +533,18 @@ static db_result_t load(index_t *index)
 static db_result_t release(index_t *index)
 {
 	tree_t *tree;
-	qnode_t *tmp_node;
 
 	tree = index->opaque_data;
 	if (tree == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->node_cache->in_cache.tail == NULL) || (tree->node_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->buck_cache->in_cache.tail == NULL) || (tree->buck_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
 
-	/* Bucket Cache being flushed */
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->buck_cache->in_cache.tail);
-	tmp_node = tree->node_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->node_cache->in_cache.tail);
+	/* Dirty pages of the index being written back and dropped from the pool */
+	pool_detach(tree);
 	storage_close(tree->bucket_storage);
 	storage_close(tree->tree_storage);
 
-	free(tree->node_cache);
-	free(tree->buck_cache);
 	free(tree);
 	return DB_OK;
 }
@@ -735,27 +582,10 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 	 *	and write back is preferred.
 	 ***************************************************************************************/
 #ifdef DB_WIP
-	qnode_t *tmp_node;
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-
-	/* Bucket Cache being flushed */
-
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
-	tmp_node = tree->node_cache->in_cache.head->next;
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
+	pthread_mutex_lock(&pool_lock);
+	pool_flush(tree);
+	pthread_mutex_unlock(&pool_lock);
 #endif
 	return DB_OK;
 }
@@ -917,6 +747,8 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 		} else {
 			iterator->next_item_no = 1;
 		}
+		pthread_mutex_lock(&(tree->bucket_lock));
+		tree->lock_buckets[cache.bucket_id] = 0;
 		pthread_mutex_unlock(&(tree->bucket_lock));
 		rw_unlock_write(&(tree->tree_lock));
 		return INVALID_TUPLE;
@@ -960,7 +792,9 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Generate new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	do {
+		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	} while (storage_tuples_pinned(tuple_path));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -1007,115 +841,340 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 	tree->inserted -= tree->deleted;
 	tree->deleted = 0;
 
-	storage_remove(old_rel.tuple_filename);
+	storage_remove_tuples(old_rel.tuple_filename);
 	return DB_OK;
 }
 #endif
 
 /****************************************************************************
- * Name: modify_cache
+ * Name: pool_attach
  *
- * Description: Modifying the cache entries to mark the entry dirty,
- *              invalid or unlocking it
+ * Description: Allocates the buffer pool when the first index is created or
+ *              loaded. Indexes opened later share the pages of the same pool.
  *
  ****************************************************************************/
-static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
+static db_result_t pool_attach(void)
 {
-	qnode_t *temp;
-	qnode_t *end;
-	if (cache == NODE) {
-		pthread_mutex_lock(&(tree->node_cache_lock));
-		temp = tree->node_cache->in_cache.tail->prev;
-		end = tree->node_cache->in_cache.head;
+	qnode_t *entry;
+	int i;
+
+	pthread_mutex_lock(&pool_lock);
+	if (pool.users > 0) {
+		pool.users++;
+		pthread_mutex_unlock(&pool_lock);
+		return DB_OK;
+	}
+	pool.pages = malloc(sizeof(union page_u) * DB_INDEX_POOL_PAGES);
+	pool.entries = malloc(sizeof(qnode_t) * DB_INDEX_POOL_PAGES);
+	pool.hash = malloc(sizeof(qnode_t *) * DB_INDEX_POOL_PAGES);
+	if (pool.pages == NULL || pool.entries == NULL || pool.hash == NULL) {
+		free(pool.pages);
+		free(pool.entries);
+		free(pool.hash);
+		pool.pages = NULL;
+		pool.entries = NULL;
+		pool.hash = NULL;
+		pthread_mutex_unlock(&pool_lock);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	pool.in_cache.head = &pool.head;
+	pool.in_cache.tail = &pool.tail;
+	pool.head.prev = NULL;
+	pool.head.next = &pool.tail;
+	pool.tail.prev = &pool.head;
+	pool.tail.next = NULL;
+	for (i = 0; i < DB_INDEX_POOL_PAGES; i++) {
+		entry = &pool.entries[i];
+		entry->tree = NULL;
+		entry->pos = i;
+		entry->node_state = 0;
+		PLACE_AT_TAIL(entry, (&pool));
+		pool.hash[i] = NULL;
+	}
+	pool.users = 1;
+	pthread_mutex_unlock(&pool_lock);
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: pool_lookup
+ *
+ * Description: Finds the valid entry of a node or bucket of the tree.
+ *              The pool lock must be held by the caller
+ *
+ ****************************************************************************/
+static qnode_t *pool_lookup(tree_t *tree, cache_type_t type, int id)
+{
+	qnode_t *entry;
+
+	entry = pool.hash[POOL_HASH(tree, type, id)];
+	while (entry != NULL && (entry->tree != tree || entry->type != type || entry->id != id)) {
+		entry = entry->hash_next;
+	}
+	return entry;
+}
+
+/****************************************************************************
+ * Name: pool_write
+ *
+ * Description: Writes a dirty page back to the storage of its tree
+ *
+ ****************************************************************************/
+static void pool_write(qnode_t *entry)
+{
+	if (!(entry->node_state & NODE_STATE_DIRTY) || !(entry->node_state & NODE_STATE_VALID)) {
+		return;
+	}
+	if (entry->type == NODE) {
+		tree_write(entry->tree, entry->id, &(pool.pages[entry->pos].node));
 	} else {
-		pthread_mutex_lock(&(tree->buck_cache_lock));
-		temp = tree->buck_cache->in_cache.tail->prev;
-		end = tree->buck_cache->in_cache.head;
-	}
-	while (temp != end) {
-		if ((temp->id == id) && (temp->node_state & NODE_STATE_VALID)) {
-			if (op == UNLOCK) {
-				UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
-			} else if (op == DIRTY) {
-				SET_NODE_STATE(temp, NODE_STATE_DIRTY);
-			} else {
-				UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
-				REMOVE_ENTRY(temp);
-				if (cache == NODE) {
-					PLACE_AT_HEAD(temp, tree->node_cache);
-				} else {
-					PLACE_AT_HEAD(temp, tree->buck_cache);
-				}
-			}
-			break;
+		bucket_write(entry->tree, entry->id, &(pool.pages[entry->pos].bucket));
+	}
+	UNSET_NODE_STATE(entry, NODE_STATE_DIRTY);
+}
+
+/****************************************************************************
+ * Name: pool_drop
+ *
+ * Description: Removes an entry from the hash and puts it at the head of
+ *              the LRU queue so that its page is reused first
+ *
+ ****************************************************************************/
+static void pool_drop(qnode_t *entry)
+{
+	qnode_t **link;
+
+	if (entry->tree != NULL) {
+		link = &pool.hash[POOL_HASH(entry->tree, entry->type, entry->id)];
+		while (*link != entry) {
+			link = &((*link)->hash_next);
 		}
-		temp = temp->prev;
+		*link = entry->hash_next;
+		entry->tree = NULL;
 	}
-	if (temp == end) {
-		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
-		return CACHE_NOT_EXIST;
+	entry->node_state = 0;
+	REMOVE_ENTRY(entry);
+	PLACE_AT_HEAD(entry, (&pool));
+}
+
+/****************************************************************************
+ * Name: pool_evict
+ *
+ * Description: Picks the least recently used page which is not pinned,
+ *              writing it back first when it is dirty
+ *
+ ****************************************************************************/
+static qnode_t *pool_evict(void)
+{
+	qnode_t *entry;
+
+	entry = pool.in_cache.head->next;
+	while ((entry->node_state & NODE_STATE_LOCK) && (entry != pool.in_cache.tail)) {
+		entry = entry->next;
 	}
-	if (cache == NODE) {
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-	} else {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
+	if (entry == pool.in_cache.tail) {
+		return NULL;
 	}
-	return CACHE_OK;
+	pool_write(entry);
+	pool_drop(entry);
+	return entry;
 }
 
 /****************************************************************************
- * Name: cache_write_node
+ * Name: pool_insert
  *
- * Description: Routine enabling to put a new cache entry in Node Cache.
- *              Required when new nodes are generated resulting from splits
+ * Description: Assigns a page to a node or bucket of the tree and makes it
+ *              the most recently used entry
  *
  ****************************************************************************/
-static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
+static void pool_insert(qnode_t *entry, tree_t *tree, cache_type_t type, int id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	int hash = POOL_HASH(tree, type, id);
+
+	entry->tree = tree;
+	entry->type = type;
+	entry->id = id;
+	entry->hash_next = pool.hash[hash];
+	pool.hash[hash] = entry;
+	REMOVE_ENTRY(entry);
+	PLACE_AT_TAIL(entry, (&pool));
+}
+
+/****************************************************************************
+ * Name: pool_get
+ *
+ * Description: Returns the pinned entry of a node or bucket, reading it
+ *              from flash when it is not in the pool. Returns NULL when the
+ *              entry is already pinned or every page of the pool is pinned
+ *
+ ****************************************************************************/
+static qnode_t *pool_get(tree_t *tree, cache_type_t type, int id)
+{
+	qnode_t *entry;
+	db_result_t result;
+
+	pthread_mutex_lock(&pool_lock);
+	entry = pool_lookup(tree, type, id);
+	if (entry != NULL) {
+		if (entry->node_state & NODE_STATE_LOCK) {
+			pthread_mutex_unlock(&pool_lock);
+			return NULL;
+		}
+		SET_NODE_STATE(entry, NODE_STATE_LOCK);
+		REMOVE_ENTRY(entry);
+		PLACE_AT_TAIL(entry, (&pool));
+		pthread_mutex_unlock(&pool_lock);
+		return entry;
+	}
 
-	qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		DB_LOG_E("Failed allocation of node\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
+	entry = pool_evict();
+	if (entry == NULL) {
+		DB_LOG_E("NO SLOT AVAILABLE IN BUFFER POOL\n");
+		pthread_mutex_unlock(&pool_lock);
+		return NULL;
 	}
+	pool_insert(entry, tree, type, id);
+	SET_NODE_STATE(entry, NODE_STATE_LOCK | NODE_STATE_VALID);
 
-	if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-		new_node->pos = tree->node_cache->num++;
+	/* Reading from flash */
+	if (type == NODE) {
+		result = storage_read_from(tree->tree_storage, &(pool.pages[entry->pos].node), base_offset + (unsigned long)id * sizeof(tree_node_t), sizeof(tree_node_t));
 	} else {
-		qnode_t *iter_node;
-		iter_node = tree->node_cache->in_cache.head->next;
-		while ((iter_node->node_state | NODE_STATE_LOCK) && iter_node != tree->node_cache->in_cache.tail) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->node_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return CACHE_FULL;
+		result = storage_read_from(tree->bucket_storage, &(pool.pages[entry->pos].bucket), (unsigned long)id * sizeof(bucket_t), sizeof(bucket_t));
+	}
+	if (DB_ERROR(result)) {
+		DB_LOG_E("PANIC %s READ FAILED AT ID %d\n", type == NODE ? "TREE" : "BUCKET", id);
+		pool_drop(entry);
+		pthread_mutex_unlock(&pool_lock);
+		return NULL;
+	}
+	pthread_mutex_unlock(&pool_lock);
+	return entry;
+}
+
+/****************************************************************************
+ * Name: pool_put
+ *
+ * Description: Puts a node or bucket in the pool as an unpinned dirty page,
+ *              replacing the cached copy if there is one
+ *
+ ****************************************************************************/
+static qnode_t *pool_put(tree_t *tree, cache_type_t type, int id, void *data)
+{
+	qnode_t *entry;
+
+	pthread_mutex_lock(&pool_lock);
+	entry = pool_lookup(tree, type, id);
+	if (entry == NULL) {
+		entry = pool_evict();
+		if (entry == NULL) {
+			DB_LOG_E("NO SLOT AVAILABLE IN BUFFER POOL\n");
+			pthread_mutex_unlock(&pool_lock);
+			return NULL;
 		}
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_DIRTY)) {
-			tree_write(tree, iter_node->id, &(tree->node_cache->cache_t[iter_node->pos].node));
+		pool_insert(entry, tree, type, id);
+	} else {
+		REMOVE_ENTRY(entry);
+		PLACE_AT_TAIL(entry, (&pool));
+	}
+	entry->node_state = NODE_STATE_VALID | NODE_STATE_DIRTY;
+
+	/* The data may be the page itself when a bucket is rewritten after invalidation */
+	memmove(&(pool.pages[entry->pos]), data, type == NODE ? sizeof(tree_node_t) : sizeof(bucket_t));
+
+	pthread_mutex_unlock(&pool_lock);
+	return entry;
+}
+
+/****************************************************************************
+ * Name: pool_flush
+ *
+ * Description: Writes back all the dirty pages of the tree, keeping them
+ *              cached. The pool lock must be held by the caller
+ *
+ ****************************************************************************/
+static void pool_flush(tree_t *tree)
+{
+	int i;
+
+	for (i = 0; i < DB_INDEX_POOL_PAGES; i++) {
+		if (pool.entries[i].tree == tree) {
+			pool_write(&pool.entries[i]);
 		}
-		new_node->pos = iter_node->pos;
-		/* iter_node is the node which has to be evicted from cache.
-		 * It is removed the queue maintaining the LRU status.
-		 */
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
 	}
+}
 
-	PLACE_AT_TAIL(new_node, tree->node_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_VALID);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY);
+/****************************************************************************
+ * Name: pool_detach
+ *
+ * Description: Writes back and drops the pages of a released tree.
+ *              The pool is de-allocated when the last index is released
+ *
+ ****************************************************************************/
+static void pool_detach(tree_t *tree)
+{
+	int i;
 
-	memcpy(&(tree->node_cache->cache_t[new_node->pos].node), node, sizeof(tree_node_t));
+	pthread_mutex_lock(&pool_lock);
+	for (i = 0; i < DB_INDEX_POOL_PAGES; i++) {
+		if (pool.entries[i].tree == tree) {
+			pool_write(&pool.entries[i]);
+			pool_drop(&pool.entries[i]);
+		}
+	}
+	if (--pool.users == 0) {
+		free(pool.pages);
+		free(pool.entries);
+		free(pool.hash);
+		pool.pages = NULL;
+		pool.entries = NULL;
+		pool.hash = NULL;
+	}
+	pthread_mutex_unlock(&pool_lock);
+}
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+/****************************************************************************
+ * Name: modify_cache
+ *
+ * Description: Modifying the cache entries to mark the entry dirty,
+ *              invalid or unlocking (unpinning) it
+ *
+ ****************************************************************************/
+static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
+{
+	qnode_t *temp;
 
+	pthread_mutex_lock(&pool_lock);
+	temp = pool_lookup(tree, cache, id);
+	if (temp == NULL) {
+		pthread_mutex_unlock(&pool_lock);
+		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
+		return CACHE_NOT_EXIST;
+	}
+	if (op == UNLOCK) {
+		UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
+	} else if (op == DIRTY) {
+		SET_NODE_STATE(temp, NODE_STATE_DIRTY);
+	} else {
+		pool_drop(temp);
+	}
+	pthread_mutex_unlock(&pool_lock);
+	return CACHE_OK;
+}
+
+/****************************************************************************
+ * Name: cache_write_node
+ *
+ * Description: Routine enabling to put a new cache entry in Node Cache.
+ *              Required when new nodes are generated resulting from splits
+ *
+ ****************************************************************************/
+static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
+{
+	if (pool_put(tree, NODE, id, node) == NULL) {
+		return CACHE_FULL;
+	}
 	return CACHE_OK;
 }
 
@@ -1128,25 +1187,21 @@ static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
  ****************************************************************************/
 static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
 	qnode_t *replace_node;
-	replace_node = tree->node_cache->in_cache.head->next;
 
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
-		replace_node = replace_node->next;
-	}
-	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
+	pthread_mutex_lock(&pool_lock);
+	replace_node = pool_lookup(tree, NODE, id);
+	if (replace_node == NULL || !(replace_node->node_state & NODE_STATE_LOCK)) {
 		DB_LOG_E("PANIC REPLACE FOR NON_EXISTENT OR NON_LOCKED ENTRY\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+		pthread_mutex_unlock(&pool_lock);
 		return CACHE_NOT_EXIST;
 	}
 	UNSET_NODE_STATE(replace_node, NODE_STATE_LOCK);
 	SET_NODE_STATE(replace_node, NODE_STATE_VALID | NODE_STATE_DIRTY);
 
-	memcpy(&(tree->node_cache->cache_t[replace_node->pos].node), node, sizeof(tree_node_t));
+	memcpy(&(pool.pages[replace_node->pos].node), node, sizeof(tree_node_t));
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+	pthread_mutex_unlock(&pool_lock);
 
 	return CACHE_OK;
 }
@@ -1160,45 +1215,9 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
  ****************************************************************************/
 static cache_result_t cache_write_bucket(tree_t *tree, int id, bucket_t *bucket)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
-	}
-
-	if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-		new_node->pos = tree->buck_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->buck_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && (iter_node != tree->buck_cache->in_cache.tail)) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->buck_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return CACHE_FULL;
-		}
-
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, iter_node->id, &(tree->buck_cache->cache_t[iter_node->pos].bucket));
-		}
-		new_node->pos = iter_node->pos;
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
+	if (pool_put(tree, BUCKET, id, bucket) == NULL) {
+		return CACHE_FULL;
 	}
-	PLACE_AT_TAIL(new_node, tree->buck_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY | NODE_STATE_VALID);
-
-	memcpy(&(tree->buck_cache->cache_t[new_node->pos].bucket), bucket, sizeof(bucket_t));
-
-	pthread_mutex_unlock(&(tree->buck_cache_lock));
-
 	return CACHE_OK;
 }
 
@@ -1218,78 +1237,19 @@ static int transform_key(int key)
 /****************************************************************************
  * Name: tree_read
  *
- * Description: Fetches nodes from the flash and suitably evicts the nodes
- *              from cache, in case the cache is full
+ * Description: Fetches nodes from the buffer pool, reading them from flash
+ *              and evicting the least recently used page when required.
+ *              The node is returned pinned
  *
  ****************************************************************************/
 static tree_node_t *tree_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->node_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->node_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* Case when node is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->node_cache);
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return &(tree->node_cache->cache_t[iter->pos].node);
-	} else {
-		qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-			new_node->pos = tree->node_cache->num++;
-		} else {
-			/* Case when the least recently used node needs to be evicted to make place for new node */
-			qnode_t *replace_node = tree->node_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && replace_node != tree->node_cache->in_cache.tail) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->node_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->node_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				tree_write(tree, replace_node->id, &(tree->node_cache->cache_t[replace_node->pos].node));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-		/* Adjusting the pointers */
-		PLACE_AT_TAIL(new_node, tree->node_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
-
-		/* Reading from flash */
-		if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[new_node->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
-			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", new_node->id);
-			UNSET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+	qnode_t *entry = pool_get(tree, NODE, bucket_id);
 
-		return &(tree->node_cache->cache_t[new_node->pos].node);
+	if (entry == NULL) {
+		return NULL;
 	}
+	return &(pool.pages[entry->pos].node);
 }
 
 /****************************************************************************
@@ -1485,80 +1445,19 @@ void tree_print(tree_t *tree, int id)
 /****************************************************************************
  * Name: bucket_read
  *
- * Description: Reads buckets from the cache and fetches them from flash
- *              when the entry does not exist in cache.
- *              Also evicts the suitable entries from cache when cache is full
+ * Description: Reads buckets from the buffer pool and fetches them from
+ *              flash when the entry does not exist in the pool.
+ *              The bucket is returned pinned
  *
  ****************************************************************************/
 static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->buck_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->buck_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* If the bucket is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->buck_cache);
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[iter->pos].bucket);
-	} else {
-		/* Bucket has to be read from flash into the cache */
-		qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-			new_node->pos = tree->buck_cache->num++;
-		} else {
-			/* Cache doesn't have enough space and the least recently used bucket needs to be evicted */
-			qnode_t *replace_node = tree->buck_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && (replace_node != tree->buck_cache->in_cache.tail)) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->buck_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->buck_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				bucket_write(tree, replace_node->id, &(tree->buck_cache->cache_t[replace_node->pos].bucket));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
+	qnode_t *entry = pool_get(tree, BUCKET, bucket_id);
 
-		/* Adjust the pointers */
-		PLACE_AT_TAIL(new_node, tree->buck_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-		UNSET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-		/* Read from flash */
-		if (DB_ERROR(storage_read_from(tree->bucket_storage, (void *)&(tree->buck_cache->cache_t[new_node->pos].bucket), (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
-			DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
-			UNSET_NODE_STATE(new_node, (NODE_STATE_LOCK | NODE_STATE_VALID));
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[new_node->pos].bucket);
+	if (entry == NULL) {
+		return NULL;
 	}
+	return &(pool.pages[entry->pos].bucket);
 }
 
 /****************************************************************************
@@ -1891,6 +1790,160 @@ retry:
 	return TREE_OK;
 }
 
+/****************************************************************************
+ * Name: build_nodes
+ *
+ * Description: Writes one level of nodes over the given children, grouping
+ *              them evenly so that every node gets at least two children.
+ *              The separator keys are the largest keys of the children.
+ *              The ids and largest keys of the new nodes replace those of
+ *              the children and their number is returned.
+ *
+ ****************************************************************************/
+static int build_nodes(tree_t *tree, uint16_t *ids, int *max_keys, int count, uint16_t is_leaf)
+{
+	tree_node_t node;
+	int parents;
+	int size;
+	int child;
+	int p;
+	int j;
+
+	parents = (count + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+	if (tree->off_nodes + parents > CONFIG_NODE_LIMIT) {
+		DB_LOG_E("DB: Too many nodes for the bulk built tree\n");
+		return -1;
+	}
+
+	child = 0;
+	for (p = 0; p < parents; p++) {
+		size = count / parents + (p < count % parents);
+		memset(&node, 0, sizeof(tree_node_t));
+		for (j = 0; j < size; j++) {
+			node.id[j] = ids[child + j];
+			if (j < size - 1) {
+				node.val[j] = max_keys[child + j];
+			}
+		}
+		node.val[BRANCH_FACTOR - 1] = size - 1;
+		node.is_leaf = is_leaf;
+		if (!tree_write(tree, tree->off_nodes, &node)) {
+			return -1;
+		}
+		ids[p] = tree->off_nodes++;
+		max_keys[p] = max_keys[child + size - 1];
+		child += size;
+	}
+	return parents;
+}
+
+/****************************************************************************
+ * Name: build
+ *
+ * Description: Builds the tree bottom-up from the entries of an existing
+ *              relation in key order. Buckets are filled to three quarters
+ *              and written in sequence with their chaining, then the nodes
+ *              are written level by level up to the root
+ *
+ ****************************************************************************/
+static db_result_t build(index_t *index, index_sort_t *sort)
+{
+	tree_t *tree;
+	bucket_t bucket;
+	index_entry_t entry;
+	uint16_t *ids;
+	int *max_keys;
+	int buckets;
+	int fill;
+	int count;
+	int i;
+	db_result_t result;
+
+	tree = (tree_t *)index->opaque_data;
+	if (sort->count == 0) {
+		return DB_OK;
+	}
+
+	/* Leave room for inserts in every bucket unless all the entries would not fit */
+	fill = BUCKET_SIZE * 3 / 4;
+	if (sort->count > (tuple_id_t)fill * (CONFIG_BUCKETS_LIMIT - 1)) {
+		fill = (sort->count + CONFIG_BUCKETS_LIMIT - 2) / (CONFIG_BUCKETS_LIMIT - 1);
+		if (fill > BUCKET_SIZE) {
+			DB_LOG_E("DB: %lu entries do not fit in the bplus-tree\n", (unsigned long)sort->count);
+			return DB_LIMIT_ERROR;
+		}
+	}
+	buckets = (sort->count + fill - 1) / fill;
+
+	ids = malloc(sizeof(uint16_t) * buckets);
+	max_keys = malloc(sizeof(int) * buckets);
+	if (ids == NULL || max_keys == NULL) {
+		free(ids);
+		free(max_keys);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	/* The tree made by create is replaced, so its cached pages are dropped unwritten */
+	pthread_mutex_lock(&pool_lock);
+	for (i = 0; i < DB_INDEX_POOL_PAGES; i++) {
+		if (pool.entries[i].tree == tree) {
+			pool_drop(&pool.entries[i]);
+		}
+	}
+	pthread_mutex_unlock(&pool_lock);
+
+	result = DB_OK;
+	for (i = 0; i < buckets; i++) {
+		memset(&bucket, 0, sizeof(bucket_t));
+		while (bucket.next_free_slot < fill && (result = index_sort_next(sort, &entry)) == DB_OK) {
+			bucket.pairs[bucket.next_free_slot].key = transform_key((int)entry.key);
+			bucket.pairs[bucket.next_free_slot].value = entry.tuple_id;
+			bucket.next_free_slot++;
+		}
+		if (DB_ERROR(result) || bucket.next_free_slot == 0) {
+			goto errout;
+		}
+		/* Start Bucket chaining */
+		bucket.info[0] = (i == buckets - 1) ? CONFIG_BUCKETS_LIMIT - 1 : i + 1;
+		bucket.info[1] = bucket.pairs[0].key;
+		bucket.info[2] = bucket.pairs[bucket.next_free_slot - 1].key;
+		/* End of Bucket chaining */
+		if (!bucket_write(tree, i, &bucket)) {
+			result = DB_STORAGE_ERROR;
+			goto errout;
+		}
+		ids[i] = i;
+		max_keys[i] = bucket.info[2];
+	}
+	tree->off_buckets = buckets;
+
+	tree->off_nodes = 0;
+	tree->levels = 1;
+	count = buckets;
+	do {
+		count = build_nodes(tree, ids, max_keys, count, tree->levels == 1);
+		if (count < 0) {
+			result = DB_LIMIT_ERROR;
+			goto errout;
+		}
+		tree->levels++;
+	} while (count > 1);
+	tree->root = ids[0];
+	tree->inserted = sort->count;
+	tree->deleted = 0;
+
+	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+	free(ids);
+	free(max_keys);
+	DB_LOG_D("DB: Built a bplus-tree of %d levels over %d buckets\n", tree->levels, buckets);
+	return DB_OK;
+
+errout:
+	free(ids);
+	free(max_keys);
+	return DB_ERROR(result) ? result : DB_INDEX_ERROR;
+}
+
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 /****************************************************************************
  * Name: db_flush
@@ -1921,7 +1974,9 @@ static int db_flush(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Create a new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	do {
+		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	} while (storage_tuples_pinned(tuple_path));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -1994,7 +2049,13 @@ static int db_flush(tree_t *tree, relation_t *rel)
 	free(temp);
 	tree->inserted -= tree->deleted;
 	tree->deleted = 0;
-	storage_remove(old_rel.tuple_filename);
+	storage_remove_tuples(old_rel.tuple_filename);
+
+	/* Write back the rewritten buckets so that they match the new tuple file */
+	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+	pthread_mutex_lock(&pool_lock);
+	pool_flush(tree);
+	pthread_mutex_unlock(&pool_lock);
 	DB_LOG_D("Flushed the database.\n");
 	return DB_OK;
 }
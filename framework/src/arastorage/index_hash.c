@@ -0,0 +1,662 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * A linear hashing index for equality searches. The primary buckets are
+ * kept in the bucket file, where bucket i is found at i times the bucket
+ * size. Buckets which overflow are chained to overflow buckets kept in
+ * the descriptor file after the header of the index. When the entries
+ * exceed DB_HASH_LOAD_FACTOR percent of the primary buckets, the bucket
+ * at the split pointer is split in two, so the table grows one bucket at
+ * a time and a point lookup reads one bucket in the expected case.
+ *
+ * Range searches are emulated by the index manager through one lookup
+ * per key when the range is small enough.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include "db_options.h"
+#include "db_debug.h"
+#include "storage.h"
+#include "random.h"
+#include "index.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define HASH_NO_BUCKET ((uint16_t)-1)
+
+/* The largest number of primary buckets, which keeps bucket ids in 16 bits */
+#define HASH_BUCKET_LIMIT 0x7fff
+
+#define BUCKET_COUNT(header) \
+	(((tuple_id_t)DB_HASH_INITIAL_BUCKETS << (header)->level) + (header)->split)
+
+#define OVERFLOW_OFFSET(id) \
+	(sizeof(struct hash_header_s) + (unsigned long)(id) * sizeof(hash_bucket_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* Head of the descriptor file, written whenever the table changes shape.
+   The number of entries only drives the splits and may lag behind. */
+struct hash_header_s {
+	tuple_id_t entries;
+	uint16_t level;
+	uint16_t split;				/* Next primary bucket to split */
+	uint16_t overflow_count;	/* Overflow buckets in the descriptor file */
+	uint16_t free_overflow;		/* First unused overflow bucket */
+	char bucket_file[DB_MAX_FILENAME_LENGTH];
+};
+
+struct hash_bucket_s {
+	uint16_t next;				/* Overflow bucket chained to this bucket */
+	uint16_t count;
+	index_entry_t entries[DB_HASH_BUCKET_ENTRIES];
+};
+typedef struct hash_bucket_s hash_bucket_t;
+
+/* Position of an iteration in the bucket chain of its current key */
+struct hash_scan_s {
+	long key;
+	uint16_t bucket_id;
+	uint16_t slot;
+	uint8_t overflow;
+	hash_bucket_t bucket;
+};
+
+struct hash_s {
+	struct hash_header_s header;
+	db_storage_id_t descriptor_storage;
+	db_storage_id_t bucket_storage;
+	struct hash_scan_s scan;
+	hash_bucket_t buffer;		/* Bucket updated by insert and delete */
+};
+typedef struct hash_s hash_t;
+
+/****************************************************************************
+* Private Function Prototypes
+****************************************************************************/
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *, uint8_t);
+
+index_api_t index_hash = {
+	INDEX_HASH,
+	INDEX_API_EXTERNAL,
+	create,
+	destroy,
+	load,
+	release,
+	insert,
+	delete,
+	get_next,
+	NULL
+};
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static uint32_t hash_key(long key)
+{
+	uint32_t h;
+
+	h = (uint32_t)key ^ (uint32_t)((unsigned long)key >> 16 >> 16);
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return h;
+}
+
+/****************************************************************************
+ * Name: hash_address
+ *
+ * Description: Returns the primary bucket of a key. Buckets before the
+ *              split pointer have already been split in this round and
+ *              are addressed with the hash function of the next level
+ *
+ ****************************************************************************/
+static uint16_t hash_address(hash_t *hash, long key)
+{
+	uint32_t h;
+	uint32_t buckets;
+	uint32_t address;
+
+	h = hash_key(key);
+	buckets = (uint32_t)DB_HASH_INITIAL_BUCKETS << hash->header.level;
+	address = h % buckets;
+	if (address < hash->header.split) {
+		address = h % (buckets << 1);
+	}
+	return (uint16_t)address;
+}
+
+static db_result_t bucket_read(hash_t *hash, uint16_t id, uint8_t overflow, hash_bucket_t *bucket)
+{
+	if (overflow) {
+		return storage_read_from(hash->descriptor_storage, bucket, OVERFLOW_OFFSET(id), sizeof(hash_bucket_t));
+	}
+	return storage_read_from(hash->bucket_storage, bucket, (unsigned long)id * sizeof(hash_bucket_t), sizeof(hash_bucket_t));
+}
+
+static db_result_t bucket_write(hash_t *hash, uint16_t id, uint8_t overflow, hash_bucket_t *bucket)
+{
+	if (overflow) {
+		return storage_write_to(hash->descriptor_storage, bucket, OVERFLOW_OFFSET(id), sizeof(hash_bucket_t));
+	}
+	return storage_write_to(hash->bucket_storage, bucket, (unsigned long)id * sizeof(hash_bucket_t), sizeof(hash_bucket_t));
+}
+
+static db_result_t header_write(hash_t *hash)
+{
+	return storage_write_to(hash->descriptor_storage, &hash->header, 0, sizeof(hash->header));
+}
+
+static uint16_t overflow_alloc(hash_t *hash)
+{
+	hash_bucket_t bucket;
+	uint16_t id;
+
+	id = hash->header.free_overflow;
+	if (id != HASH_NO_BUCKET) {
+		if (DB_ERROR(bucket_read(hash, id, TRUE, &bucket))) {
+			return HASH_NO_BUCKET;
+		}
+		hash->header.free_overflow = bucket.next;
+		return id;
+	}
+	if (hash->header.overflow_count == HASH_NO_BUCKET - 1) {
+		DB_LOG_E("DB: No more overflow buckets in the hash index\n");
+		return HASH_NO_BUCKET;
+	}
+	return hash->header.overflow_count++;
+}
+
+static db_result_t overflow_free(hash_t *hash, uint16_t id)
+{
+	hash_bucket_t bucket;
+
+	bucket.next = hash->header.free_overflow;
+	bucket.count = 0;
+	if (DB_ERROR(bucket_write(hash, id, TRUE, &bucket))) {
+		return DB_STORAGE_ERROR;
+	}
+	hash->header.free_overflow = id;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bucket_add
+ *
+ * Description: Adds an entry to the bucket being filled by a split. A full
+ *              bucket is chained to a new overflow bucket and written
+ *
+ ****************************************************************************/
+static db_result_t bucket_add(hash_t *hash, hash_bucket_t *bucket, uint16_t *id, uint8_t *overflow, index_entry_t *entry)
+{
+	uint16_t next;
+
+	if (bucket->count == DB_HASH_BUCKET_ENTRIES) {
+		next = overflow_alloc(hash);
+		if (next == HASH_NO_BUCKET) {
+			return DB_STORAGE_ERROR;
+		}
+		bucket->next = next;
+		if (DB_ERROR(bucket_write(hash, *id, *overflow, bucket))) {
+			return DB_STORAGE_ERROR;
+		}
+		*id = next;
+		*overflow = TRUE;
+		bucket->next = HASH_NO_BUCKET;
+		bucket->count = 0;
+	}
+	bucket->entries[bucket->count++] = *entry;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: split
+ *
+ * Description: Splits the primary bucket at the split pointer. Its entries
+ *              and those of its overflow buckets are divided between the
+ *              bucket and a new primary bucket at the end of the table, and
+ *              the overflow buckets read are freed for reuse
+ *
+ ****************************************************************************/
+static db_result_t split(hash_t *hash)
+{
+	hash_bucket_t *buckets;
+	hash_bucket_t *in;
+	hash_bucket_t *out;
+	uint16_t in_id;
+	uint8_t in_overflow;
+	uint16_t out_id[2];
+	uint8_t out_overflow[2];
+	uint16_t old;
+	uint16_t next;
+	int side;
+	int i;
+
+	if (BUCKET_COUNT(&hash->header) >= HASH_BUCKET_LIMIT) {
+		return DB_OK;
+	}
+
+	buckets = malloc(sizeof(hash_bucket_t) * 3);
+	if (buckets == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	in = &buckets[0];
+	out = &buckets[1];
+
+	old = hash->header.split;
+	out_id[0] = old;
+	out_id[1] = (uint16_t)BUCKET_COUNT(&hash->header);
+	out_overflow[0] = out_overflow[1] = FALSE;
+	for (side = 0; side < 2; side++) {
+		out[side].next = HASH_NO_BUCKET;
+		out[side].count = 0;
+	}
+
+	if (++hash->header.split == (DB_HASH_INITIAL_BUCKETS << hash->header.level)) {
+		hash->header.level++;
+		hash->header.split = 0;
+	}
+
+	in_id = old;
+	in_overflow = FALSE;
+	do {
+		if (DB_ERROR(bucket_read(hash, in_id, in_overflow, in))) {
+			goto errout;
+		}
+		next = in->next;
+		if (in_overflow && DB_ERROR(overflow_free(hash, in_id))) {
+			goto errout;
+		}
+		for (i = 0; i < in->count; i++) {
+			side = hash_address(hash, in->entries[i].key) != old;
+			if (DB_ERROR(bucket_add(hash, &out[side], &out_id[side], &out_overflow[side], &in->entries[i]))) {
+				goto errout;
+			}
+		}
+		in_id = next;
+		in_overflow = TRUE;
+	} while (in_id != HASH_NO_BUCKET);
+
+	for (side = 0; side < 2; side++) {
+		if (DB_ERROR(bucket_write(hash, out_id[side], out_overflow[side], &out[side]))) {
+			goto errout;
+		}
+	}
+	free(buckets);
+	return header_write(hash);
+
+errout:
+	DB_LOG_E("DB: Failed to split hash bucket %u\n", old);
+	free(buckets);
+	return DB_STORAGE_ERROR;
+}
+
+/****************************************************************************
+ * Name: scan_start
+ *
+ * Description: Reads the primary bucket of the key to be searched next
+ *
+ ****************************************************************************/
+static db_result_t scan_start(hash_t *hash, long key)
+{
+	hash->scan.key = key;
+	hash->scan.bucket_id = hash_address(hash, key);
+	hash->scan.overflow = FALSE;
+	hash->scan.slot = 0;
+	return bucket_read(hash, hash->scan.bucket_id, FALSE, &hash->scan.bucket);
+}
+
+/****************************************************************************
+ * Name: create
+ *
+ * Description: Generates the descriptor file holding the header and the
+ *              overflow buckets, and the bucket file holding the
+ *              DB_HASH_INITIAL_BUCKETS empty primary buckets
+ *
+ ****************************************************************************/
+static db_result_t create(index_t *index)
+{
+	char hash_filename[DB_MAX_FILENAME_LENGTH];
+	hash_bucket_t bucket;
+	hash_t *hash;
+	int i;
+
+	hash = malloc(sizeof(hash_t));
+	if (hash == NULL) {
+		DB_LOG_E("DB: Failed to allocate a hash index\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(&hash->header, 0, sizeof(hash->header));
+	hash->header.free_overflow = HASH_NO_BUCKET;
+
+	random_init(time(NULL));
+	snprintf(hash_filename, HASH_FILE_LENGTH, "%s.%x", HASH_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	if (DB_ERROR(storage_generate_file(hash_filename))) {
+		DB_LOG_E("DB: Failed to generate a hash descriptor file\n");
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	snprintf(hash->header.bucket_file, BUCKET_FILE_LENGTH, "%s.%x", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	if (DB_ERROR(storage_generate_file(hash->header.bucket_file))) {
+		DB_LOG_E("DB: Failed to generate a hash bucket file\n");
+		storage_remove(hash_filename);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+
+	hash->descriptor_storage = storage_open(hash_filename, O_RDWR);
+	hash->bucket_storage = storage_open(hash->header.bucket_file, O_RDWR);
+	if (hash->descriptor_storage < 0 || hash->bucket_storage < 0) {
+		goto errout;
+	}
+
+	if (DB_ERROR(header_write(hash))) {
+		goto errout;
+	}
+	memset(&bucket, 0, sizeof(bucket));
+	bucket.next = HASH_NO_BUCKET;
+	for (i = 0; i < DB_HASH_INITIAL_BUCKETS; i++) {
+		if (DB_ERROR(bucket_write(hash, i, FALSE, &bucket))) {
+			goto errout;
+		}
+	}
+
+	memcpy(index->descriptor_file, hash_filename, sizeof(index->descriptor_file));
+	index->opaque_data = hash;
+	DB_LOG_D("DB: Created a hash index in files \"%s\" and \"%s\"\n", hash_filename, hash->header.bucket_file);
+	return DB_OK;
+
+errout:
+	DB_LOG_E("DB: Failed to initialise the hash index files\n");
+	if (hash->descriptor_storage >= 0) {
+		storage_close(hash->descriptor_storage);
+	}
+	if (hash->bucket_storage >= 0) {
+		storage_close(hash->bucket_storage);
+	}
+	storage_remove(hash_filename);
+	storage_remove(hash->header.bucket_file);
+	free(hash);
+	return DB_STORAGE_ERROR;
+}
+
+static db_result_t destroy(index_t *index)
+{
+	struct hash_header_s header;
+	db_storage_id_t fd;
+
+	if (index->opaque_data != NULL && DB_ERROR(release(index))) {
+		return DB_INDEX_ERROR;
+	}
+	fd = storage_open(index->descriptor_file, O_RDWR);
+	if (fd < 0) {
+		return DB_STORAGE_ERROR;
+	}
+	if (DB_ERROR(storage_read_from(fd, &header, 0, sizeof(header)))) {
+		storage_close(fd);
+		return DB_STORAGE_ERROR;
+	}
+	storage_close(fd);
+	return storage_remove(header.bucket_file);
+}
+
+static db_result_t load(index_t *index)
+{
+	hash_t *hash;
+	db_storage_id_t fd;
+
+	hash = malloc(sizeof(hash_t));
+	if (hash == NULL) {
+		DB_LOG_E("DB: Failed to allocate a hash index while loading\n");
+		return DB_ALLOCATION_ERROR;
+	}
+
+	fd = storage_open(index->descriptor_file, O_RDWR);
+	if (fd < 0) {
+		DB_LOG_E("DB: Failed to open the hash descriptor file %s\n", index->descriptor_file);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	if (DB_ERROR(storage_read_from(fd, &hash->header, 0, sizeof(hash->header)))) {
+		DB_LOG_E("DB: Failed to read the hash header from %s\n", index->descriptor_file);
+		storage_close(fd);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	hash->descriptor_storage = fd;
+	hash->bucket_storage = storage_open(hash->header.bucket_file, O_RDWR);
+	if (hash->bucket_storage < 0) {
+		DB_LOG_E("DB: Failed to open the hash bucket file %s\n", hash->header.bucket_file);
+		storage_close(fd);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+
+	index->opaque_data = hash;
+	DB_LOG_D("DB: Loaded hash index from file %s and bucket file %s\n", index->descriptor_file, hash->header.bucket_file);
+	return DB_OK;
+}
+
+static db_result_t release(index_t *index)
+{
+	hash_t *hash;
+
+	hash = index->opaque_data;
+	if (hash == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	header_write(hash);
+	storage_close(hash->bucket_storage);
+	storage_close(hash->descriptor_storage);
+
+	free(hash);
+	index->opaque_data = NULL;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: insert
+ *
+ * Description: Appends the entry to the last bucket in the chain of its
+ *              primary bucket, and splits a bucket when the load factor
+ *              of the index is exceeded
+ *
+ ****************************************************************************/
+static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t value)
+{
+	hash_t *hash;
+	hash_bucket_t *bucket;
+	uint16_t id;
+	uint16_t next;
+	uint8_t overflow;
+
+	hash = index->opaque_data;
+	bucket = &hash->buffer;
+
+	id = hash_address(hash, db_value_to_long(key));
+	overflow = FALSE;
+	if (DB_ERROR(bucket_read(hash, id, overflow, bucket))) {
+		return DB_STORAGE_ERROR;
+	}
+	while (bucket->count == DB_HASH_BUCKET_ENTRIES) {
+		if (bucket->next == HASH_NO_BUCKET) {
+			next = overflow_alloc(hash);
+			if (next == HASH_NO_BUCKET) {
+				return DB_INDEX_ERROR;
+			}
+			bucket->next = next;
+			if (DB_ERROR(bucket_write(hash, id, overflow, bucket))) {
+				return DB_STORAGE_ERROR;
+			}
+			if (DB_ERROR(header_write(hash))) {
+				return DB_STORAGE_ERROR;
+			}
+			bucket->next = HASH_NO_BUCKET;
+			bucket->count = 0;
+			id = next;
+			overflow = TRUE;
+			break;
+		}
+		id = bucket->next;
+		overflow = TRUE;
+		if (DB_ERROR(bucket_read(hash, id, overflow, bucket))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	bucket->entries[bucket->count].key = db_value_to_long(key);
+	bucket->entries[bucket->count].tuple_id = value;
+	bucket->count++;
+	if (DB_ERROR(bucket_write(hash, id, overflow, bucket))) {
+		DB_LOG_E("DB: Failed to insert key %ld into a hash index\n", db_value_to_long(key));
+		return DB_STORAGE_ERROR;
+	}
+
+	hash->header.entries++;
+	if ((unsigned long)hash->header.entries * 100 > (unsigned long)BUCKET_COUNT(&hash->header) * DB_HASH_BUCKET_ENTRIES * DB_HASH_LOAD_FACTOR) {
+		return split(hash);
+	}
+	return DB_OK;
+}
+
+static db_result_t delete(index_t *index, attribute_value_t *value)
+{
+	hash_t *hash;
+	hash_bucket_t *bucket;
+	long key;
+	uint16_t id;
+	uint8_t overflow;
+	int modified;
+	int i;
+
+	hash = index->opaque_data;
+	bucket = &hash->buffer;
+	key = db_value_to_long(value);
+
+	id = hash_address(hash, key);
+	overflow = FALSE;
+	do {
+		if (DB_ERROR(bucket_read(hash, id, overflow, bucket))) {
+			return DB_STORAGE_ERROR;
+		}
+		modified = FALSE;
+		for (i = 0; i < bucket->count;) {
+			if (bucket->entries[i].key == key) {
+				bucket->entries[i] = bucket->entries[--bucket->count];
+				hash->header.entries--;
+				modified = TRUE;
+			} else {
+				i++;
+			}
+		}
+		if (modified && DB_ERROR(bucket_write(hash, id, overflow, bucket))) {
+			return DB_STORAGE_ERROR;
+		}
+		id = bucket->next;
+		overflow = TRUE;
+	} while (id != HASH_NO_BUCKET);
+
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: get_next
+ *
+ * Description: Returns the tuple id of the next entry whose key is in the
+ *              range of the iterator. The keys of the range are looked up
+ *              one after another, and each lookup follows the bucket chain
+ *              of the key. The entry is removed from the index when the
+ *              condition is not matched
+ *
+ ****************************************************************************/
+static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
+{
+	hash_t *hash;
+	struct hash_scan_s *scan;
+	tuple_id_t tuple_id;
+	long max;
+
+	hash = iterator->index->opaque_data;
+	scan = &hash->scan;
+	max = db_value_to_long(&iterator->max_value);
+
+	if (iterator->next_item_no == 0 && iterator->found_items == 0) {
+		if (DB_ERROR(scan_start(hash, db_value_to_long(&iterator->min_value)))) {
+			return INVALID_TUPLE;
+		}
+	}
+
+	for (;;) {
+		while (scan->slot < scan->bucket.count) {
+			if (scan->bucket.entries[scan->slot].key != scan->key) {
+				scan->slot++;
+				continue;
+			}
+			tuple_id = scan->bucket.entries[scan->slot].tuple_id;
+			iterator->found_items++;
+			iterator->next_item_no = iterator->found_items;
+
+			/* matched condition is FALSE when the query is for remove tuples */
+			if (matched_condition == FALSE) {
+				scan->bucket.entries[scan->slot] = scan->bucket.entries[--scan->bucket.count];
+				hash->header.entries--;
+				if (DB_ERROR(bucket_write(hash, scan->bucket_id, scan->overflow, &scan->bucket))) {
+					return INVALID_TUPLE;
+				}
+			} else {
+				scan->slot++;
+			}
+			return tuple_id;
+		}
+
+		if (scan->bucket.next != HASH_NO_BUCKET) {
+			scan->bucket_id = scan->bucket.next;
+			scan->overflow = TRUE;
+			scan->slot = 0;
+			if (DB_ERROR(bucket_read(hash, scan->bucket_id, TRUE, &scan->bucket))) {
+				return INVALID_TUPLE;
+			}
+		} else if (scan->key < max) {
+			if (DB_ERROR(scan_start(hash, scan->key + 1))) {
+				return INVALID_TUPLE;
+			}
+		} else {
+			break;
+		}
+	}
+
+	iterator->next_item_no = iterator->found_items == 0 ? 0 : 1;
+	return INVALID_TUPLE;
+}
@@ -103,7 +103,8 @@ index_api_t index_inline = {
 	null_op,
 	insert,
 	delete,
-	get_next
+	get_next,
+	NULL
 };
 
 /****************************************************************************
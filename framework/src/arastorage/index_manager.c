@@ -72,7 +72,8 @@
 * Private Types
 ****************************************************************************/
 static index_api_t *index_components[] = { &index_inline,
-										   &index_bplustree
+										   &index_bplustree,
+										   &index_hash
 										 };
 
 pthread_attr_t g_attr;
@@ -83,7 +84,7 @@ pthread_attr_t g_attr;
 static index_api_t *find_index_api(index_type_t index_type);
 db_result_t db_indexing(relation_t*);
 LIST(indices);
-MEMB(index_memb, index_t, DB_INDEX_POOL_SIZE);
+MEMB_GROWABLE(index_memb, index_t, DB_INDEX_POOL_SIZE, DB_POOL_CHUNK_BLOCKS, DB_INDEX_POOL_LIMIT);
 
 /****************************************************************************
 * Public Functions
@@ -122,6 +123,11 @@ db_result_t index_deinit(void)
 	return DB_OK;
 }
 
+struct memb *index_pool(void)
+{
+	return &index_memb;
+}
+
 db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *attr)
 {
 	tuple_id_t cardinality;
@@ -200,15 +206,15 @@ db_result_t index_destroy(index_t *index)
 {
 	db_result_t res;
 	int i;
+	char *count;
 	index_t *index_iter;
 	if (DB_ERROR(index_release(index)) || DB_ERROR(index->api->destroy(index))) {
 		return DB_INDEX_ERROR;
 	}
-	for (i = 0; i < index_memb.num; ++i) {
-		if (index_memb.count[i] > 0) {
-			index_iter = (index_t *)((char *)index_memb.mem + (i * index_memb.size));
+	for (i = 0; (index_iter = memb_block(&index_memb, i, &count)) != NULL; ++i) {
+		if (*count > 0) {
 			if ((strcmp(index->rel->name, index_iter->rel->name) == 0) && strcmp(index->attr->name, index_iter->attr->name) == 0) {
-				index_memb.count[i] = 0;
+				while (memb_free(&index_memb, index_iter) > 0) ;
 				break;
 			}
 		}
@@ -235,16 +241,15 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 	DB_LOG_D("DB: Attempting to load an index over %s.%s\n", rel->name, attr->name);
 
 	int i;
+	char *count;
 	bool found = false;
-	for (i = 0; i < index_memb.num; ++i) {
-		if (index_memb.count[i] > 0) {
-			/* If this block was unused, we increase the reference count to
-			   indicate that it now is used and return a pointer to the
-			   memory block. */
-			index = (index_t *)((char *)index_memb.mem + (i * index_memb.size));
+	for (i = 0; (index = memb_block(&index_memb, i, &count)) != NULL; ++i) {
+		if (*count > 0) {
+			/* If this block is in use by the same index, we increase the
+			   reference count and share it. */
 			if ((strcmp(index->rel->name, rel->name) == 0) && strcmp(index->attr->name, attr->name) == 0) {
 				found = true;
-				index_memb.count[i]++;
+				(*count)++;
 				attr->index = index;
 				index->rel = rel;
 				index->attr = attr;
@@ -435,8 +440,10 @@ db_result_t db_indexing(relation_t *rel)
 	attribute_value_t value;
 	attribute_t *attr;
 	db_result_t result;
+	index_sort_t sort;
 	int offset;
 	bool isfound;
+	bool sorted;
 
 	index = get_next_index_to_load();
 	if (index == NULL) {
@@ -457,6 +464,7 @@ db_result_t db_indexing(relation_t *rel)
 
 	offset  = 0;
 	isfound = false;
+	sorted  = false;
 
 	attr = list_head(rel->attributes);
 	while (attr != NULL) {
@@ -474,10 +482,19 @@ db_result_t db_indexing(relation_t *rel)
 		goto errout;
 	}
 
+	/* Indexes which can be built bottom-up get their entries in key order */
+	if (index->api->build != NULL) {
+		if (DB_ERROR(index_sort_init(&sort))) {
+			DB_LOG_E("DB: Failed to allocate the index sort buffer\n");
+			goto errout;
+		}
+		sorted = true;
+	}
+
 	cardinality = relation_cardinality(rel);
 
 	for (tuple_id = 0; tuple_id < cardinality; tuple_id++) {
-		memset(row, 0, sizeof(row));
+		memset(row, 0, rel->row_length);
 		DB_LOG_V("DB: Indexing Tuple id %d\n", tuple_id);
 		result = storage_get_row(rel, &tuple_id, row);
 		if (DB_ERROR(result)) {
@@ -491,18 +508,34 @@ db_result_t db_indexing(relation_t *rel)
 			goto errout;
 		}
 
-		if (DB_ERROR(index_insert(index, &value, tuple_id))) {
+		if (sorted) {
+			result = index_sort_add(&sort, db_value_to_long(&value), tuple_id);
+		} else {
+			result = index_insert(index, &value, tuple_id);
+		}
+		if (DB_ERROR(result)) {
 			DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
 			goto errout;
 		}
 	}
 
+	if (sorted) {
+		if (DB_ERROR(index_sort_finish(&sort)) || DB_ERROR(index->api->build(index, &sort))) {
+			DB_LOG_E("DB: Failed to build the index for %s.%s\n", rel->name, index->attr->name);
+			goto errout;
+		}
+		index_sort_free(&sort);
+	}
+
 	free(row);
 	DB_LOG_D("DB: Loaded %lu rows into the index\n", cardinality);
 
 	return DB_OK;
 
 errout:
+	if (sorted) {
+		index_sort_free(&sort);
+	}
 	if (row != NULL) {
 		free(row);
 	}
@@ -0,0 +1,259 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "db_options.h"
+#include "db_debug.h"
+#include "storage.h"
+#include "random.h"
+#include "index.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define SORT_CAPACITY (DB_INDEX_SORT_BUFFER / sizeof(index_entry_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* Merge state of a sorted run, read through its slice of the sort buffer */
+struct index_run_s {
+	tuple_id_t next;			/* Index of the next entry to read from storage */
+	tuple_id_t end;				/* Index of the end of the run */
+	index_entry_t *slice;
+	uint16_t head;
+	uint16_t filled;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static int compare_entry(const void *p1, const void *p2)
+{
+	const index_entry_t *e1 = p1;
+	const index_entry_t *e2 = p2;
+
+	if (e1->key != e2->key) {
+		return e1->key < e2->key ? -1 : 1;
+	}
+	if (e1->tuple_id != e2->tuple_id) {
+		return e1->tuple_id < e2->tuple_id ? -1 : 1;
+	}
+	return 0;
+}
+
+/****************************************************************************
+ * Name: write_run
+ *
+ * Description: Sorts the buffered entries and appends them to the run file
+ *              as a new run
+ *
+ ****************************************************************************/
+static db_result_t write_run(index_sort_t *sort)
+{
+	unsigned long offset;
+
+	if (sort->run_storage == INVALID_STORAGE_ID) {
+		snprintf(sort->run_filename, SORT_FILE_LENGTH, "%s.%x", SORT_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+		if (DB_ERROR(storage_generate_file(sort->run_filename))) {
+			return DB_STORAGE_ERROR;
+		}
+		sort->run_storage = storage_open(sort->run_filename, O_RDWR);
+		if (sort->run_storage < 0) {
+			sort->run_storage = INVALID_STORAGE_ID;
+			storage_remove(sort->run_filename);
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	qsort(sort->buffer, sort->buffered, sizeof(index_entry_t), compare_entry);
+	offset = (unsigned long)sort->run_count * SORT_CAPACITY * sizeof(index_entry_t);
+	if (DB_ERROR(storage_write_to(sort->run_storage, sort->buffer, offset, sort->buffered * sizeof(index_entry_t)))) {
+		DB_LOG_E("DB: Failed to write sort run %d\n", sort->run_count);
+		return DB_STORAGE_ERROR;
+	}
+	sort->run_count++;
+	sort->buffered = 0;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: fill_run
+ *
+ * Description: Reads the next entries of a run into its slice
+ *
+ ****************************************************************************/
+static db_result_t fill_run(index_sort_t *sort, struct index_run_s *run, uint16_t slice_length)
+{
+	tuple_id_t length;
+
+	length = run->end - run->next;
+	if (length > slice_length) {
+		length = slice_length;
+	}
+	if (DB_ERROR(storage_read_from(sort->run_storage, run->slice, (unsigned long)run->next * sizeof(index_entry_t), length * sizeof(index_entry_t)))) {
+		return DB_STORAGE_ERROR;
+	}
+	run->next += length;
+	run->head = 0;
+	run->filled = length;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+db_result_t index_sort_init(index_sort_t *sort)
+{
+	sort->buffer = malloc(SORT_CAPACITY * sizeof(index_entry_t));
+	if (sort->buffer == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	sort->run_storage = INVALID_STORAGE_ID;
+	sort->run_filename[0] = '\0';
+	sort->buffered = 0;
+	sort->count = 0;
+	sort->next = 0;
+	sort->run_count = 0;
+	sort->runs = NULL;
+	return DB_OK;
+}
+
+db_result_t index_sort_add(index_sort_t *sort, long key, tuple_id_t tuple_id)
+{
+	if (sort->buffered == SORT_CAPACITY && DB_ERROR(write_run(sort))) {
+		return DB_STORAGE_ERROR;
+	}
+	sort->buffer[sort->buffered].key = key;
+	sort->buffer[sort->buffered].tuple_id = tuple_id;
+	sort->buffered++;
+	sort->count++;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: index_sort_finish
+ *
+ * Description: Ends the input of entries. When all the entries fit in the
+ *              buffer they are sorted in place, otherwise the last run is
+ *              written and the buffer is divided into one slice per run
+ *              for the merge
+ *
+ ****************************************************************************/
+db_result_t index_sort_finish(index_sort_t *sort)
+{
+	struct index_run_s *run;
+	uint16_t slice_length;
+	int i;
+
+	if (sort->run_count == 0) {
+		qsort(sort->buffer, sort->buffered, sizeof(index_entry_t), compare_entry);
+		return DB_OK;
+	}
+	if (sort->buffered > 0 && DB_ERROR(write_run(sort))) {
+		return DB_STORAGE_ERROR;
+	}
+	if (sort->run_count > SORT_CAPACITY) {
+		DB_LOG_E("DB: Too many sort runs (%d) for the sort buffer\n", sort->run_count);
+		return DB_LIMIT_ERROR;
+	}
+
+	sort->runs = malloc(sizeof(struct index_run_s) * sort->run_count);
+	if (sort->runs == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	slice_length = SORT_CAPACITY / sort->run_count;
+	for (i = 0; i < sort->run_count; i++) {
+		run = &sort->runs[i];
+		run->next = (tuple_id_t)i * SORT_CAPACITY;
+		run->end = run->next + SORT_CAPACITY;
+		if (run->end > sort->count) {
+			run->end = sort->count;
+		}
+		run->slice = sort->buffer + i * slice_length;
+		if (DB_ERROR(fill_run(sort, run, slice_length))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: index_sort_next
+ *
+ * Description: Returns the entries in increasing order of key and tuple id.
+ *              DB_FINISHED is returned after the last entry
+ *
+ ****************************************************************************/
+db_result_t index_sort_next(index_sort_t *sort, index_entry_t *entry)
+{
+	struct index_run_s *run;
+	struct index_run_s *min_run;
+	int i;
+
+	if (sort->next == sort->count) {
+		return DB_FINISHED;
+	}
+	if (sort->run_count == 0) {
+		*entry = sort->buffer[sort->next++];
+		return DB_OK;
+	}
+
+	min_run = NULL;
+	for (i = 0; i < sort->run_count; i++) {
+		run = &sort->runs[i];
+		if (run->head == run->filled) {
+			continue;
+		}
+		if (min_run == NULL || compare_entry(&run->slice[run->head], &min_run->slice[min_run->head]) < 0) {
+			min_run = run;
+		}
+	}
+	if (min_run == NULL) {
+		return DB_STORAGE_ERROR;
+	}
+
+	*entry = min_run->slice[min_run->head++];
+	sort->next++;
+	if (min_run->head == min_run->filled && min_run->next < min_run->end) {
+		if (DB_ERROR(fill_run(sort, min_run, SORT_CAPACITY / sort->run_count))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+	return DB_OK;
+}
+
+void index_sort_free(index_sort_t *sort)
+{
+	free(sort->buffer);
+	free(sort->runs);
+	sort->buffer = NULL;
+	sort->runs = NULL;
+	if (sort->run_storage != INVALID_STORAGE_ID) {
+		storage_close(sort->run_storage);
+		storage_remove(sort->run_filename);
+		sort->run_storage = INVALID_STORAGE_ID;
+	}
+}
@@ -274,6 +274,209 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 	return EXECUTION_ERROR;
 }
 
+static long *batch_vector(lvm_batch_t *batch)
+{
+	if (batch->depth == LVM_BATCH_DEPTH) {
+		return NULL;
+	}
+	return batch->scratch[batch->depth++];
+}
+
+/* Evaluate an arithmetic expression or an operand for every tuple of the
+   batch. Variables are used in place, other values go to scratch vectors. */
+static lvm_status_t batch_expr(lvm_instance_t *p, lvm_batch_t *batch, long **vector)
+{
+	node_type_t type;
+	operator_t *operator;
+	operand_t operand;
+	long *left;
+	long *right;
+	long *out;
+	long l;
+	uint16_t i;
+	uint16_t count;
+	uint8_t depth;
+	lvm_status_t r;
+
+	count = batch->count;
+	type = get_type(p);
+	if (type == LVM_OPERAND) {
+		get_operand(p, &operand);
+		if (operand.type == LVM_VARIABLE) {
+			*vector = batch->values[operand.value.id];
+			return LVM_TRUE;
+		}
+		out = batch_vector(batch);
+		if (out == NULL) {
+			return STACK_OVERFLOW;
+		}
+		l = operand_to_long(p, &operand);
+		for (i = 0; i < count; i++) {
+			out[i] = l;
+		}
+		*vector = out;
+		return LVM_TRUE;
+	} else if (type != LVM_ARITH_OP) {
+		return SEMANTIC_ERROR;
+	}
+
+	operator = get_operator(p);
+	depth = batch->depth;
+	r = batch_expr(p, batch, &left);
+	if (LVM_ERROR(r)) {
+		return r;
+	}
+	r = batch_expr(p, batch, &right);
+	if (LVM_ERROR(r)) {
+		return r;
+	}
+	/* Each result element only depends on the elements of the same
+	   tuple, so the result may overwrite the vector of an operand. */
+	batch->depth = depth;
+	out = batch_vector(batch);
+	if (out == NULL) {
+		return STACK_OVERFLOW;
+	}
+
+	switch (*operator) {
+	case LVM_ADD:
+		for (i = 0; i < count; i++) {
+			out[i] = left[i] + right[i];
+		}
+		break;
+	case LVM_SUB:
+		for (i = 0; i < count; i++) {
+			out[i] = left[i] - right[i];
+		}
+		break;
+	case LVM_MUL:
+		for (i = 0; i < count; i++) {
+			out[i] = left[i] * right[i];
+		}
+		break;
+	case LVM_DIV:
+		/* A division by zero fails the whole condition of its tuple,
+		   as it does in eval_expr(). */
+		for (i = 0; i < count; i++) {
+			if (right[i] == 0) {
+				batch->error[i] = 1;
+				out[i] = 0;
+			} else {
+				out[i] = left[i] / right[i];
+			}
+		}
+		break;
+	default:
+		return EXECUTION_ERROR;
+	}
+
+	*vector = out;
+	return LVM_TRUE;
+}
+
+static lvm_status_t batch_logic(lvm_instance_t *p, lvm_batch_t *batch, operator_t op, unsigned char *out)
+{
+	unsigned char other[LVM_BATCH_SIZE];
+	long *l1;
+	long *l2;
+	uint16_t i;
+	uint16_t count;
+	uint8_t depth;
+	lvm_status_t r;
+
+	count = batch->count;
+	if (IS_CONNECTIVE(op)) {
+		if (get_type(p) != LVM_CMP_OP) {
+			return SEMANTIC_ERROR;
+		}
+		r = batch_logic(p, batch, *get_operator(p), out);
+		if (LVM_ERROR(r)) {
+			return r;
+		}
+		if (op == LVM_NOT) {
+			for (i = 0; i < count; i++) {
+				out[i] = !out[i];
+			}
+			return LVM_TRUE;
+		}
+
+		if (get_type(p) != LVM_CMP_OP) {
+			return SEMANTIC_ERROR;
+		}
+		r = batch_logic(p, batch, *get_operator(p), other);
+		if (LVM_ERROR(r)) {
+			return r;
+		}
+		if (op == LVM_AND) {
+			for (i = 0; i < count; i++) {
+				out[i] &= other[i];
+			}
+		} else if (op == LVM_OR) {
+			for (i = 0; i < count; i++) {
+				out[i] |= other[i];
+			}
+		} else {
+			return EXECUTION_ERROR;
+		}
+		return LVM_TRUE;
+	}
+
+	/* The vectors of a comparison are not needed once it is evaluated. */
+	depth = batch->depth;
+	r = batch_expr(p, batch, &l1);
+	if (!LVM_ERROR(r)) {
+		r = batch_expr(p, batch, &l2);
+	}
+	batch->depth = depth;
+	if (LVM_ERROR(r)) {
+		return r;
+	}
+
+	switch (op) {
+	case LVM_EQ:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] == l2[i];
+		}
+		break;
+	case LVM_NEQ:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] != l2[i];
+		}
+		break;
+	case LVM_GE:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] > l2[i];
+		}
+		break;
+	case LVM_GEQ:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] >= l2[i];
+		}
+		break;
+	case LVM_LE:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] < l2[i];
+		}
+		break;
+	case LVM_LEQ:
+		for (i = 0; i < count; i++) {
+			out[i] = l1[i] <= l2[i];
+		}
+		break;
+	default:
+		return EXECUTION_ERROR;
+	}
+	return LVM_TRUE;
+}
+
+static long phy_to_long(attribute_t *attr, unsigned char *value)
+{
+	if (attr->domain == DOMAIN_INT) {
+		return value[0] << 8 | value[1];
+	}
+	return (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+}
+
 void lvm_reset(lvm_instance_t *p)
 {
 	p->end = 0;
@@ -370,6 +573,40 @@ lvm_status_t lvm_execute(lvm_instance_t *p)
 	return status;
 }
 
+/****************************************************************************
+ * Name: lvm_execute_batch
+ *
+ * Description: Evaluates the condition for the batch->count tuples whose
+ *              variable values are in the batch. On LVM_TRUE, batch->result
+ *              tells for each tuple whether the condition holds. Conditions
+ *              nesting more than LVM_BATCH_DEPTH intermediate vectors
+ *              return STACK_OVERFLOW and have to be evaluated with
+ *              lvm_execute()
+ *
+ ****************************************************************************/
+lvm_status_t lvm_execute_batch(lvm_instance_t *p, lvm_batch_t *batch)
+{
+	lvm_status_t status;
+	uint16_t i;
+
+	p->ip = 0;
+	if (get_type(p) != LVM_CMP_OP) {
+		DB_LOG_E("Error: The code must start with a relational operator\n");
+		return EXECUTION_ERROR;
+	}
+
+	batch->depth = 0;
+	memset(batch->error, 0, batch->count);
+	status = batch_logic(p, batch, *get_operator(p), batch->result);
+	if (LVM_ERROR(status)) {
+		return status;
+	}
+	for (i = 0; i < batch->count; i++) {
+		batch->result[i] &= !batch->error[i];
+	}
+	return LVM_TRUE;
+}
+
 void lvm_set_op(lvm_instance_t *p, operator_t op)
 {
 	lvm_set_type(p, LVM_ARITH_OP);
@@ -396,15 +633,30 @@ void lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *
 	operand_value_t operand_value;
 
 	/* Update the internal state of the PLE. */
-	if (attr->domain == DOMAIN_INT) {
-		operand_value.l = value[0] << 8 | value[1];
-	} else if (attr->domain == DOMAIN_LONG) {
-		operand_value.l = (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+	if (attr->domain == DOMAIN_INT || attr->domain == DOMAIN_LONG) {
+		operand_value.l = phy_to_long(attr, value);
 	}
 
 	lvm_set_variable_value(p, attr->name, operand_value);
 }
 
+/* Returns LVM_MAX_VARIABLE_ID if the condition does not use the name. */
+variable_id_t lvm_get_variable_id(lvm_instance_t *p, char *name)
+{
+	variable_id_t id;
+
+	id = lookup(p, name);
+	if (id < LVM_MAX_VARIABLE_ID && p->variables[id].name[0] == '\0') {
+		return LVM_MAX_VARIABLE_ID;
+	}
+	return id;
+}
+
+void lvm_set_batch_value(lvm_batch_t *batch, variable_id_t id, uint16_t row, attribute_t *attr, unsigned char *value)
+{
+	batch->values[id][row] = phy_to_long(attr, value);
+}
+
 void lvm_set_long(lvm_instance_t *p, long l)
 {
 	operand_t op;
@@ -415,6 +667,86 @@ void lvm_set_long(lvm_instance_t *p, long l)
 	lvm_set_operand(p, &op);
 }
 
+void lvm_set_parameter(lvm_instance_t *p, long id)
+{
+	operand_t op;
+
+	op.type = LVM_PARAMETER;
+	op.value.l = id;
+
+	lvm_set_operand(p, &op);
+}
+
+/* Walk the prefix-ordered node at *ip and its operands, the same way
+   lvm_execute() does, looking for the placeholder operand with the given
+   id. The code is walked as a tree because p->end does not always point
+   past the last node once the parser has shifted operators in. */
+static lvm_ip_t find_parameter(lvm_instance_t *p, lvm_ip_t *ip, long id)
+{
+	node_type_t type;
+	operator_t op;
+	operand_t operand;
+	lvm_ip_t found;
+	int i;
+	int arguments;
+
+	if (*ip + sizeof(node_type_t) > DB_VM_BYTECODE_SIZE) {
+		return -1;
+	}
+	memcpy(&type, &p->code[*ip], sizeof(type));
+	*ip += sizeof(type);
+
+	switch (type) {
+	case LVM_OPERAND:
+		if (*ip + sizeof(operand_t) > DB_VM_BYTECODE_SIZE) {
+			return -1;
+		}
+		memcpy(&operand, &p->code[*ip], sizeof(operand));
+		if (operand.type == LVM_PARAMETER && operand.value.l == id) {
+			return *ip;
+		}
+		*ip += sizeof(operand);
+		return -1;
+	case LVM_CMP_OP:
+	case LVM_ARITH_OP:
+		if (*ip + sizeof(operator_t) > DB_VM_BYTECODE_SIZE) {
+			return -1;
+		}
+		memcpy(&op, &p->code[*ip], sizeof(op));
+		*ip += sizeof(op);
+		arguments = op == LVM_NOT ? 1 : 2;
+		for (i = 0; i < arguments; i++) {
+			found = find_parameter(p, ip, id);
+			if (found >= 0) {
+				return found;
+			}
+		}
+		return -1;
+	default:
+		/* Stop walking: this is not valid code. */
+		*ip = DB_VM_BYTECODE_SIZE;
+		return -1;
+	}
+}
+
+lvm_ip_t lvm_find_parameter(lvm_instance_t *p, long id)
+{
+	lvm_ip_t ip;
+
+	ip = 0;
+	return find_parameter(p, &ip, id);
+}
+
+void lvm_bind_long(lvm_instance_t *p, lvm_ip_t ip, long l)
+{
+	operand_t op;
+
+	op.type = LVM_LONG;
+	op.value.l = l;
+
+	memcpy(&p->code[ip], &op, sizeof(op));
+}
+
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type)
 {
 	variable_id_t id;
@@ -499,28 +831,24 @@ static void create_union(derivation_t *result, derivation_t *d1, derivation_t *d
 	int i;
 
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
-		if (!d1[i].derived && !d2[i].derived) {
+		if (!d1[i].derived || !d2[i].derived) {
+			/* A variable that only one side restricts can take
+			   any value in the union. */
 			continue;
-		} else if (d1[i].derived && !d2[i].derived) {
-			result[i].min.l = d1[i].min.l;
-			result[i].max.l = d1[i].max.l;
-		} else if (!d1[i].derived && d2[i].derived) {
+		}
+
+		/* Both derivations have been made; create a
+		   union of the ranges. */
+		if (d1[i].min.l > d2[i].min.l) {
 			result[i].min.l = d2[i].min.l;
-			result[i].max.l = d2[i].max.l;
 		} else {
-			/* Both derivations have been made; create a
-			   union of the ranges. */
-			if (d1[i].min.l > d2[i].min.l) {
-				result[i].min.l = d2[i].min.l;
-			} else {
-				result[i].min.l = d1[i].min.l;
-			}
+			result[i].min.l = d1[i].min.l;
+		}
 
-			if (d1[i].max.l < d2[i].max.l) {
-				result[i].max.l = d2[i].max.l;
-			} else {
-				result[i].max.l = d1[i].max.l;
-			}
+		if (d1[i].max.l < d2[i].max.l) {
+			result[i].max.l = d2[i].max.l;
+		} else {
+			result[i].max.l = d1[i].max.l;
 		}
 		result[i].derived = 1;
 	}
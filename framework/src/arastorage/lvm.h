@@ -118,7 +118,8 @@ typedef enum lvm_operator_e operator_t;
 enum operand_type_e {
 	LVM_VARIABLE,
 	LVM_FLOAT,
-	LVM_LONG
+	LVM_LONG,
+	LVM_PARAMETER
 };
 typedef enum operand_type_e operand_type_t;
 
@@ -162,6 +163,22 @@ struct lvm_instance_s {
 };
 typedef struct lvm_instance_s lvm_instance_t;
 
+/*
+ * Variable values of up to LVM_BATCH_SIZE tuples. lvm_execute_batch()
+ * walks the bytecode once for the whole batch and applies every operator
+ * to all the tuples in a single loop, leaving the outcome of each tuple
+ * in result.
+ */
+struct lvm_batch_s {
+	long values[LVM_MAX_VARIABLE_ID][LVM_BATCH_SIZE];
+	long scratch[LVM_BATCH_DEPTH][LVM_BATCH_SIZE];
+	unsigned char error[LVM_BATCH_SIZE];
+	unsigned char result[LVM_BATCH_SIZE];
+	uint16_t count;
+	uint8_t depth;
+};
+typedef struct lvm_batch_s lvm_batch_t;
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -171,6 +188,7 @@ lvm_status_t lvm_derive(lvm_instance_t *p);
 lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max);
 void lvm_print_derivations(lvm_instance_t *p);
 lvm_status_t lvm_execute(lvm_instance_t *p);
+lvm_status_t lvm_execute_batch(lvm_instance_t *p, lvm_batch_t *batch);
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type);
 lvm_status_t lvm_set_variable_value(lvm_instance_t *p, char *name, operand_value_t value);
 void lvm_print_code(lvm_instance_t *p);
@@ -182,7 +200,12 @@ void lvm_set_op(lvm_instance_t *p, operator_t op);
 void lvm_set_relation(lvm_instance_t *p, operator_t op);
 void lvm_set_operand(lvm_instance_t *p, operand_t *op);
 void lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value);
+variable_id_t lvm_get_variable_id(lvm_instance_t *p, char *name);
+void lvm_set_batch_value(lvm_batch_t *batch, variable_id_t id, uint16_t row, attribute_t *attr, unsigned char *value);
 void lvm_set_long(lvm_instance_t *p, long l);
 void lvm_set_variable(lvm_instance_t *p, char *name);
+void lvm_set_parameter(lvm_instance_t *p, long id);
+lvm_ip_t lvm_find_parameter(lvm_instance_t *p, long id);
+void lvm_bind_long(lvm_instance_t *p, lvm_ip_t ip, long l);
 
 #endif							/* LVM_H */
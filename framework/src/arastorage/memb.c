@@ -63,65 +63,210 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <stdlib.h>
 #include <string.h>
 
 #include "memb.h"
 
 /****************************************************************************
-* Public Functions
+* Private Functions
 ****************************************************************************/
-void memb_init(struct memb *m)
+static struct memb_chunk *memb_grow(struct memb *m)
 {
-	memset(m->count, 0, m->num);
-	memset(m->mem, 0, m->size * m->num);
+	struct memb_chunk *chunk;
+	unsigned short num;
+
+	num = m->grow;
+	if (num == 0 || m->stats.capacity >= m->limit) {
+		return NULL;
+	}
+	if (num > m->limit - m->stats.capacity) {
+		num = m->limit - m->stats.capacity;
+	}
+
+	chunk = (struct memb_chunk *)malloc(sizeof(struct memb_chunk) + num);
+	if (chunk == NULL) {
+		return NULL;
+	}
+	chunk->mem = malloc(num * m->size);
+	if (chunk->mem == NULL) {
+		free(chunk);
+		return NULL;
+	}
+	chunk->num = num;
+	chunk->count = (char *)(chunk + 1);
+	memset(chunk->count, 0, num);
+	memset(chunk->mem, 0, num * m->size);
+
+	chunk->next = m->chunks;
+	m->chunks = chunk;
+	m->stats.capacity += num;
+	m->stats.chunks++;
+	return chunk;
 }
 
-void *memb_alloc(struct memb *m)
+static void *memb_take(struct memb *m, char *count, void *mem, unsigned short num)
 {
 	int i;
 
-	for (i = 0; i < m->num; ++i) {
-		if (m->count[i] == 0) {
+	for (i = 0; i < num; ++i) {
+		if (count[i] == 0) {
 			/* If this block was unused, we increase the reference count to
 			   indicate that it now is used and return a pointer to the
 			   memory block. */
-			++(m->count[i]);
-			return (void *)((char *)m->mem + (i * m->size));
+			++(count[i]);
+			if (++m->stats.used > m->stats.high_water) {
+				m->stats.high_water = m->stats.used;
+			}
+			m->stats.allocs++;
+			return (void *)((char *)mem + (i * m->size));
 		}
 	}
-
-	/* No free block was found, so we return NULL to indicate failure to
-	   allocate block. */
 	return NULL;
 }
 
-char memb_free(struct memb *m, void *ptr)
+static int memb_release(struct memb *m, char *count, void *mem, unsigned short num, void *ptr)
 {
 	int i;
 	char *ptr2;
 
 	/* Walk through the list of blocks and try to find the block to
 	   which the pointer "ptr" points to. */
-	ptr2 = (char *)m->mem;
-	for (i = 0; i < m->num; ++i) {
+	ptr2 = (char *)mem;
+	for (i = 0; i < num; ++i) {
 
 		if (ptr2 == (char *)ptr) {
 			/* We've found to block to which "ptr" points so we decrease the
 			   reference count and return the new value of it. */
-			if (m->count[i] > 0) {
+			if (count[i] > 0) {
 				/* Make sure that we don't deallocate free memory. */
-				--(m->count[i]);
+				if (--(count[i]) == 0) {
+					m->stats.used--;
+				}
 			}
-			return m->count[i];
+			return count[i];
 		}
 		ptr2 += m->size;
 	}
 	return -1;
 }
 
+static void memb_free_chunks(struct memb *m, int all)
+{
+	struct memb_chunk **link;
+	struct memb_chunk *chunk;
+	int i;
+
+	link = &m->chunks;
+	while ((chunk = *link) != NULL) {
+		for (i = 0; !all && i < chunk->num; ++i) {
+			if (chunk->count[i] != 0) {
+				break;
+			}
+		}
+		if (!all && i < chunk->num) {
+			link = &chunk->next;
+			continue;
+		}
+		*link = chunk->next;
+		m->stats.capacity -= chunk->num;
+		m->stats.chunks--;
+		free(chunk->mem);
+		free(chunk);
+	}
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+void memb_init(struct memb *m)
+{
+	memset(m->count, 0, m->num);
+	memset(m->mem, 0, m->size * m->num);
+	memb_free_chunks(m, 1);
+	/* The high-water mark and the counters cover the whole lifetime of
+	   the pool so that they survive a reinitialization. */
+	m->stats.used = 0;
+	m->stats.capacity = m->num;
+	m->stats.chunks = 0;
+}
+
+void *memb_alloc(struct memb *m)
+{
+	struct memb_chunk *chunk;
+	void *ptr;
+
+	ptr = memb_take(m, m->count, m->mem, m->num);
+	for (chunk = m->chunks; ptr == NULL && chunk != NULL; chunk = chunk->next) {
+		ptr = memb_take(m, chunk->count, chunk->mem, chunk->num);
+	}
+	if (ptr == NULL) {
+		chunk = memb_grow(m);
+		if (chunk != NULL) {
+			ptr = memb_take(m, chunk->count, chunk->mem, chunk->num);
+		}
+	}
+
+	/* No free block was found, so we return NULL to indicate failure to
+	   allocate block. */
+	if (ptr == NULL) {
+		m->stats.failures++;
+	}
+	return ptr;
+}
+
+char memb_free(struct memb *m, void *ptr)
+{
+	struct memb_chunk *chunk;
+
+	if ((char *)ptr >= (char *)m->mem && (char *)ptr < (char *)m->mem + (m->num * m->size)) {
+		return memb_release(m, m->count, m->mem, m->num, ptr);
+	}
+	for (chunk = m->chunks; chunk != NULL; chunk = chunk->next) {
+		if ((char *)ptr >= (char *)chunk->mem && (char *)ptr < (char *)chunk->mem + (chunk->num * m->size)) {
+			return memb_release(m, chunk->count, chunk->mem, chunk->num, ptr);
+		}
+	}
+	return -1;
+}
+
 int memb_inmemb(struct memb *m, void *ptr)
 {
-	return (char *)ptr >= (char *)m->mem && (char *)ptr < (char *)m->mem + (m->num * m->size);
+	struct memb_chunk *chunk;
+
+	if ((char *)ptr >= (char *)m->mem && (char *)ptr < (char *)m->mem + (m->num * m->size)) {
+		return 1;
+	}
+	for (chunk = m->chunks; chunk != NULL; chunk = chunk->next) {
+		if ((char *)ptr >= (char *)chunk->mem && (char *)ptr < (char *)chunk->mem + (chunk->num * m->size)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void *memb_block(struct memb *m, int i, char **count)
+{
+	struct memb_chunk *chunk;
+
+	if (i < m->num) {
+		*count = &m->count[i];
+		return (void *)((char *)m->mem + (i * m->size));
+	}
+	i -= m->num;
+	for (chunk = m->chunks; chunk != NULL; chunk = chunk->next) {
+		if (i < chunk->num) {
+			*count = &chunk->count[i];
+			return (void *)((char *)chunk->mem + (i * m->size));
+		}
+		i -= chunk->num;
+	}
+	return NULL;
+}
+
+void memb_shrink(struct memb *m)
+{
+	memb_free_chunks(m, 0);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -114,20 +114,55 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
+		MEMB_GROWABLE(name, structure, num, 0, num)
+
+/**
+ * Declare a memory block that grows from the heap.
+ *
+ * The first \a num blocks are declared statically as with MEMB(). When
+ * they are all in use, memb_alloc() allocates further chunks of \a grow
+ * blocks from the heap until the pool holds \a limit blocks.
+ *
+ * \param grow The number of blocks in each heap chunk, 0 to never grow.
+ *
+ * \param limit The maximum number of blocks of the pool.
+ */
+#define MEMB_GROWABLE(name, structure, num, grow, limit) \
 		static char CC_CONCAT(name, _memb_count)[num]; \
 		static structure CC_CONCAT(name, _memb_mem)[num]; \
 		static struct memb name = { sizeof(structure), num, \
 									CC_CONCAT(name, _memb_count), \
-									(void *)CC_CONCAT(name, _memb_mem) }
+									(void *)CC_CONCAT(name, _memb_mem), \
+									grow, limit }
 
 /****************************************************************************
 * Public Type Definitions
 ****************************************************************************/
+struct memb_chunk {
+	struct memb_chunk *next;
+	unsigned short num;
+	char *count;
+	void *mem;
+};
+
+struct memb_stats {
+	unsigned short used;		/* Blocks in use */
+	unsigned short high_water;	/* Highest number of blocks in use */
+	unsigned short capacity;	/* Static and heap blocks */
+	unsigned short chunks;		/* Heap chunks */
+	unsigned long allocs;
+	unsigned long failures;		/* Allocations that found no free block */
+};
+
 struct memb {
 	unsigned short size;
 	unsigned short num;
 	char *count;
 	void *mem;
+	unsigned short grow;
+	unsigned short limit;
+	struct memb_chunk *chunks;
+	struct memb_stats stats;
 };
 
 /****************************************************************************
@@ -164,6 +199,23 @@ char memb_free(struct memb *m, void *ptr);
 
 int memb_inmemb(struct memb *m, void *ptr);
 
+/**
+ * Get a block of a memory block by its position.
+ *
+ * Blocks are numbered from the static blocks on through the heap
+ * chunks, so that all blocks can be visited with increasing \a i.
+ *
+ * \param count Set to the reference count of the block.
+ *
+ * \return The block, or NULL if \a i is past the last block.
+ */
+void *memb_block(struct memb *m, int i, char **count);
+
+/**
+ * Give the heap chunks whose blocks are all free back to the heap.
+ */
+void memb_shrink(struct memb *m);
+
 /** @} */
 /** @} */
 
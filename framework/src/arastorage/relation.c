@@ -61,6 +61,7 @@
 #include <sys/types.h>
 
 #include "index.h"
+#include "column.h"
 #include "lvm.h"
 #include "storage.h"
 #include "db_options.h"
@@ -75,8 +76,8 @@
 ****************************************************************************/
 
 LIST(relations);
-MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
-MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
+MEMB_GROWABLE(relations_memb, relation_t, DB_RELATION_POOL_SIZE, DB_POOL_CHUNK_BLOCKS, DB_RELATION_POOL_LIMIT);
+MEMB_GROWABLE(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE, DB_POOL_CHUNK_BLOCKS, DB_ATTRIBUTE_POOL_LIMIT);
 
 static relation_t *relation_find(char *);
 static attribute_t *attribute_find(relation_t *, char *);
@@ -195,6 +196,7 @@ static void relation_free(relation_t *rel)
 		}
 	} while (attr != NULL);
 
+	column_release(rel);
 	list_remove(relations, rel);
 	memb_free(&relations_memb, rel);
 }
@@ -221,13 +223,29 @@ db_result_t relation_deinit(void)
 		relation_free(rel);
 		rel = next;
 	}
+	memb_shrink(&relations_memb);
+	memb_shrink(&attributes_memb);
 	return DB_OK;
 }
 
+struct memb *relation_pool(db_pool_t pool)
+{
+	switch (pool) {
+	case DB_POOL_RELATION:
+		return &relations_memb;
+	case DB_POOL_ATTRIBUTE:
+		return &attributes_memb;
+	default:
+		return NULL;
+	}
+}
+
 relation_t *relation_load(char *name)
 {
 	relation_t *rel;
+	int allocated;
 
+	allocated = FALSE;
 	rel = relation_find(name);
 	if (rel != NULL) {
 		rel->references++;
@@ -248,6 +266,7 @@ relation_t *relation_load(char *name)
 	rel->name[sizeof(rel->name) - 1] = '\0';
 	rel->references = 1;
 	list_add(relations, rel);
+	allocated = TRUE;
 
 end:
 	if (rel->dir == DB_STORAGE && DB_ERROR(storage_load(rel))) {
@@ -258,6 +277,11 @@ end:
 	rel->cardinality = relation_cardinality(rel);
 	DB_LOG_D("DB: Rel %s, Cardinality %d\n", rel->name, rel->cardinality);
 
+	/* The column data of a cached relation stays in memory between loads. */
+	if (allocated && rel->dir == DB_STORAGE && DB_ERROR(column_load(rel))) {
+		DB_LOG_E("DB: Failed to load the column file of relation %s\n", rel->name);
+	}
+
 	return rel;
 }
 
@@ -466,12 +490,36 @@ db_result_t relation_remove(relation_t *rel, int remove_tuples)
 	if (DB_ERROR(result)) {
 		DB_LOG_E("DB: Index file unlinking failed\n");
 	}
+	free(filename);
+
+	column_remove(rel);
 
 	result = storage_drop_relation(rel, remove_tuples);
 	relation_free(rel);
 	return result;
 }
 
+/*
+ * Add stored rows to the column data of a columnar relation. When this
+ * fails, the column data is dropped from memory and queries fall back to
+ * the tuple file until the next load rebuilds it.
+ */
+static void append_columns(relation_t *rel, storage_row_t rows, unsigned count)
+{
+	unsigned i;
+
+	if (!RELATION_HAS_COLUMNS(rel)) {
+		return;
+	}
+	for (i = 0; i < count; i++) {
+		if (DB_ERROR(column_append(rel, rows + i * rel->row_length))) {
+			DB_LOG_E("DB: Failed to update the columns of relation %s\n", rel->name);
+			column_release(rel);
+			return;
+		}
+	}
+}
+
 db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 {
 	attribute_t *attr;
@@ -542,7 +590,157 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 
 	DB_LOG_V(")\n");
 
-	return storage_put_row(rel, record, FALSE);
+	result = storage_put_row(rel, record, FALSE);
+	if (DB_SUCCESS(result)) {
+		append_columns(rel, record, 1);
+	}
+	return result;
+}
+
+static void batch_value(attribute_value_t *value, db_value_t *src)
+{
+	value->domain = src->domain;
+	switch (src->domain) {
+	case DOMAIN_INT:
+		VALUE_INT(value) = src->u.int_value;
+		break;
+	case DOMAIN_LONG:
+		VALUE_LONG(value) = src->u.long_value;
+		break;
+	case DOMAIN_STRING:
+		VALUE_STRING(value) = (unsigned char *)src->u.string_value;
+		break;
+	default:
+		break;
+	}
+}
+
+static db_result_t batch_encode(relation_t *rel, db_value_t *values, unsigned char *ptr)
+{
+	attribute_t *attr;
+	attribute_value_t value;
+	db_result_t result;
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next, values++) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			memset(ptr, 0, attr->element_size);
+			ptr += attr->element_size;
+			continue;
+		}
+
+		if (attr->domain != values->domain && !(attr->domain == DOMAIN_LONG && values->domain == DOMAIN_INT)) {
+			DB_LOG_E("DB: The value domain %d does not match the domain %d of attribute %s\n", values->domain, attr->domain, attr->name);
+			return DB_RELATIONAL_ERROR;
+		}
+
+		if (attr->domain == DOMAIN_STRING) {
+			if (values->u.string_value == NULL) {
+				return DB_ARGUMENT_ERROR;
+			}
+			/* Copy no further than the string itself; strncpy pads the rest. */
+			strncpy((char *)ptr, values->u.string_value, attr->element_size);
+			ptr[attr->element_size - 1] = '\0';
+		} else {
+			batch_value(&value, values);
+			if (attr->domain == DOMAIN_LONG && values->domain == DOMAIN_INT) {
+				VALUE_LONG(&value) = values->u.int_value;
+			}
+			result = db_value_to_phy(ptr, attr, &value);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+		ptr += attr->element_size;
+	}
+
+	return DB_OK;
+}
+
+/*
+ * Append a batch of tuples. Rows are packed into a DB_BULK_WRITE_SIZE
+ * buffer and stored with one write per buffer, then every index is
+ * updated for the whole batch before moving on to the next index.
+ */
+db_result_t relation_insert_batch(relation_t *rel, db_value_t *tuples, int count)
+{
+	attribute_t *attr;
+	attribute_value_t value;
+	unsigned char *buffer;
+	unsigned rows_per_write;
+	unsigned rows;
+	tuple_id_t first_row;
+	int written;
+	int i;
+	int pos;
+	db_result_t result;
+
+	if (count <= 0 || rel->row_length == 0) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	/* Rows queued by relation_insert() have to land first. */
+	result = storage_flush_insert_buffer();
+	if (DB_ERROR(result)) {
+		return result;
+	}
+#endif
+
+	rows_per_write = DB_BULK_WRITE_SIZE / rel->row_length;
+	if (rows_per_write == 0) {
+		rows_per_write = 1;
+	}
+	if (rows_per_write > (unsigned)count) {
+		rows_per_write = count;
+	}
+
+	buffer = (unsigned char *)malloc(rows_per_write * rel->row_length);
+	if (buffer == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	first_row = rel->next_row;
+	written = 0;
+	rows = 0;
+	result = DB_OK;
+	for (i = 0; i < count; i++) {
+		result = batch_encode(rel, &tuples[i * rel->attribute_count], buffer + rows * rel->row_length);
+		if (DB_ERROR(result)) {
+			break;
+		}
+		if (++rows == rows_per_write || i == count - 1) {
+			result = storage_put_rows(rel, buffer, rows);
+			if (DB_ERROR(result)) {
+				break;
+			}
+			append_columns(rel, buffer, rows);
+			written += rows;
+			rows = 0;
+		}
+	}
+	free(buffer);
+
+	/* Index whatever reached storage, even if the batch stopped early. */
+	pos = 0;
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next, pos++) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL) {
+			continue;
+		}
+		for (i = 0; i < written; i++) {
+			batch_value(&value, &tuples[i * rel->attribute_count + pos]);
+			if (DB_ERROR(index_insert(attr->index, &value, first_row + i))) {
+				return DB_INDEX_ERROR;
+			}
+		}
+	}
+
+	return result;
 }
 
 /*
@@ -600,6 +798,184 @@ static db_result_t aggregate(attribute_t *attr, attribute_value_t *value, tuple_
 	return DB_OK;
 }
 
+static void column_value(attribute_value_t *value, attribute_t *attr, long long_value)
+{
+	value->domain = attr->domain;
+	if (attr->domain == DOMAIN_INT) {
+		VALUE_INT(value) = (int)long_value;
+	} else {
+		VALUE_LONG(value) = long_value;
+	}
+}
+
+/*
+ * Evaluate the condition for the rows of a column block from first on, up
+ * to LVM_BATCH_SIZE of them. The rows are evaluated together when the
+ * handle has a batch, and one by one when it has none or the condition is
+ * too deep for it.
+ */
+static void select_column_rows(db_handle_t *handle, column_scan_t *scan, int *cols, uint16_t first, unsigned char *selected)
+{
+	source_dest_map_t *attr_map;
+	attribute_t *from_attr;
+	attribute_value_t value;
+	lvm_instance_t *lvm;
+	lvm_batch_t *batch;
+	variable_id_t id;
+	unsigned char phy[sizeof(long)];
+	uint16_t count;
+	uint16_t row;
+	int i;
+
+	attr_map = handle->attr_map;
+	lvm = handle->lvm_instance;
+	batch = handle->lvm_batch;
+	count = scan->row_count - first;
+	if (count > LVM_BATCH_SIZE) {
+		count = LVM_BATCH_SIZE;
+	}
+
+	if (batch != NULL) {
+		batch->count = count;
+		for (i = 0; i < handle->result_rel->attribute_count; i++) {
+			from_attr = attr_map[i].from_attr;
+			id = lvm_get_variable_id(lvm, from_attr->name);
+			if (id == LVM_MAX_VARIABLE_ID) {
+				continue;
+			}
+			for (row = 0; row < count; row++) {
+				column_value(&value, from_attr, column_scan_value(scan, cols[i], first + row));
+				db_value_to_phy(phy, from_attr, &value);
+				lvm_set_batch_value(batch, id, row, from_attr, phy);
+			}
+		}
+		if (lvm_execute_batch(lvm, batch) == LVM_TRUE) {
+			memcpy(selected, batch->result, count);
+			return;
+		}
+		free(batch);
+		handle->lvm_batch = NULL;
+	}
+
+	for (row = 0; row < count; row++) {
+		for (i = 0; i < handle->result_rel->attribute_count; i++) {
+			from_attr = attr_map[i].from_attr;
+			column_value(&value, from_attr, column_scan_value(scan, cols[i], first + row));
+			db_value_to_phy(phy, from_attr, &value);
+			lvm_set_operand_value(lvm, from_attr, phy);
+		}
+		selected[row] = lvm_execute(lvm) == TRUE;
+	}
+}
+
+/*
+ * Aggregate a columnar relation block by block. Only the columns used by
+ * the query are decoded, and blocks whose summaries fall outside the
+ * ranges derived from the WHERE clause are skipped without being read.
+ */
+static db_result_t aggregate_columns(db_handle_t **handle)
+{
+	column_scan_t scan;
+	source_dest_map_t *attr_map;
+	attribute_t *from_attr;
+	attribute_value_t value;
+	column_summary_t *summary;
+	lvm_instance_t *lvm;
+	unsigned char selected[LVM_BATCH_SIZE];
+	operand_value_t min[AQL_ATTRIBUTE_LIMIT];
+	operand_value_t max[AQL_ATTRIBUTE_LIMIT];
+	uint8_t ranged[AQL_ATTRIBUTE_LIMIT];
+	int cols[AQL_ATTRIBUTE_LIMIT];
+	db_result_t result;
+	uint32_t mask;
+	uint16_t row;
+	int count;
+	int skip;
+	int i;
+
+	attr_map = (*handle)->attr_map;
+	count = (*handle)->result_rel->attribute_count;
+	lvm = (*handle)->lvm_instance;
+
+	mask = 0;
+	for (i = 0; i < count; i++) {
+		from_attr = attr_map[i].from_attr;
+		cols[i] = column_find((*handle)->rel, from_attr);
+		mask |= 1u << cols[i];
+		ranged[i] = lvm != NULL && lvm_get_derived_range(lvm, from_attr->name, &min[i], &max[i]) == LVM_TRUE;
+	}
+
+	result = column_scan_init(&scan, (*handle)->rel, mask);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	while ((result = column_scan_next(&scan)) == DB_OK) {
+		skip = FALSE;
+		for (i = 0; i < count && !skip; i++) {
+			summary = column_scan_summary(&scan, cols[i]);
+			skip = ranged[i] && (summary->max < min[i].l || summary->min > max[i].l);
+		}
+		if (skip) {
+			continue;
+		}
+
+		result = column_scan_read(&scan);
+		if (DB_ERROR(result)) {
+			break;
+		}
+
+		for (row = 0; row < scan.row_count; row++) {
+			if (lvm != NULL) {
+				if (row % LVM_BATCH_SIZE == 0) {
+					select_column_rows(*handle, &scan, cols, row, selected);
+				}
+				if (!selected[row % LVM_BATCH_SIZE]) {
+					continue;
+				}
+			}
+
+			(*handle)->current_row++;
+			for (i = 0; i < count; i++) {
+				if (attr_map[i].to_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+					continue;
+				}
+				column_value(&value, attr_map[i].from_attr, column_scan_value(&scan, cols[i], row));
+				result = aggregate(attr_map[i].to_attr, &value, (*handle)->current_row);
+				if (DB_ERROR(result)) {
+					goto end;
+				}
+			}
+		}
+	}
+
+end:
+	column_scan_end(&scan);
+	return result == DB_FINISHED ? DB_OK : result;
+}
+
+/* Check whether an aggregate query can be answered from the column file. */
+static int select_columns(db_handle_t *handle)
+{
+	source_dest_map_t *attr_map_ptr;
+	source_dest_map_t *attr_map_end;
+
+	if (!(handle->adt_flags & AQL_FLAG_AGGREGATE) || !RELATION_HAS_COLUMNS(handle->rel)) {
+		return FALSE;
+	}
+	if (handle->result_rel->attribute_count > AQL_ATTRIBUTE_LIMIT) {
+		return FALSE;
+	}
+
+	attr_map_end = handle->attr_map + handle->result_rel->attribute_count;
+	for (attr_map_ptr = handle->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		if (column_find(handle->rel, attr_map_ptr->from_attr) < 0) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
 static db_result_t generate_attribute_map(source_dest_map_t *attr_map, unsigned attribute_count, relation_t *from_rel, relation_t *to_rel)
 {
 	attribute_t *from_attr;
@@ -738,9 +1114,15 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		return DB_IMPLEMENTATION_ERROR;
 	}
 
+	/* Aggregates over a columnar relation use the block summaries
+	   of the column file instead of an index. */
+	if (select_columns(*handle)) {
+		(*handle)->flags |= DB_HANDLE_FLAG_SEARCH_COLUMNS;
+	}
+
 	if ((*handle)->lvm_instance != NULL) {
 		/* Try to establish acceptable ranges for the attribute values. */
-		if (!LVM_ERROR(lvm_derive((*handle)->lvm_instance))) {
+		if (!LVM_ERROR(lvm_derive((*handle)->lvm_instance)) && !((*handle)->flags & DB_HANDLE_FLAG_SEARCH_COLUMNS)) {
 			select_index(handle);
 		}
 	}
@@ -752,6 +1134,15 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		return DB_ALLOCATION_ERROR;
 	}
 
+	/* Conditions of selections that do not use an index are evaluated
+	   in batches. Without a batch, the tuples are evaluated one by one. */
+	if (LVM_BATCH_SIZE > 1 && AQL_GET_EXEC_TYPE((*handle)->optype) == AQL_TYPE_SELECT && (*handle)->lvm_instance != NULL && !((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX)) {
+		(*handle)->lvm_batch = malloc(sizeof(lvm_batch_t));
+		if ((*handle)->lvm_batch != NULL) {
+			memset((*handle)->lvm_batch, 0, sizeof(lvm_batch_t));
+		}
+	}
+
 	/* Set flag to process tuples which need to be read */
 	(*handle)->flags |= DB_HANDLE_FLAG_PROCESSING;
 
@@ -785,6 +1176,114 @@ int db_processing_status(db_handle_t *handle)
 	return handle->flags & DB_HANDLE_FLAG_PROCESSING;
 }
 
+/*
+ * Select from the next LVM_BATCH_SIZE tuples of a sequential scan. The
+ * tuples are read with a single storage access and the condition is
+ * evaluated for all of them in one pass over the LVM bytecode.
+ */
+static db_result_t select_batch(db_handle_t **handle, db_cursor_t *cursor)
+{
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+	attribute_t *from_attr;
+	attribute_value_t value;
+	lvm_instance_t *lvm;
+	lvm_batch_t *batch;
+	relation_t *rel;
+	storage_row_t rows;
+	unsigned char *from_ptr;
+	db_result_t result;
+	tuple_id_t first;
+	tuple_id_t nrows;
+	variable_id_t id;
+	uint16_t count;
+	uint16_t i;
+
+	rel = (*handle)->rel;
+	lvm = (*handle)->lvm_instance;
+	batch = (*handle)->lvm_batch;
+	attr_map_end = (*handle)->attr_map + (*handle)->result_rel->attribute_count;
+
+	if (DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+		return DB_STORAGE_ERROR;
+	}
+	first = (*handle)->tuple_id + 1;
+	if (first >= nrows) {
+		return DB_FINISHED;
+	}
+	count = nrows - first < LVM_BATCH_SIZE ? nrows - first : LVM_BATCH_SIZE;
+
+	rows = (storage_row_t)malloc(sizeof(char) * rel->row_length * count);
+	if (rows == NULL) {
+		DB_LOG_E("DB: Failed to allocate rows\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	result = storage_read_from(rel->tuple_storage, rows, (unsigned long)first * rel->row_length, rel->row_length * count);
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to get rows in relation %s!\n", rel->name);
+		goto errout;
+	}
+
+	batch->count = count;
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		from_attr = attr_map_ptr->from_attr;
+		if (from_attr->domain != DOMAIN_INT && from_attr->domain != DOMAIN_LONG) {
+			continue;
+		}
+		id = lvm_get_variable_id(lvm, from_attr->name);
+		if (id == LVM_MAX_VARIABLE_ID) {
+			continue;
+		}
+		from_ptr = rows + attr_map_ptr->from_offset;
+		for (i = 0; i < count; i++, from_ptr += rel->row_length) {
+			lvm_set_batch_value(batch, id, i, from_attr, from_ptr);
+		}
+	}
+
+	if (lvm_execute_batch(lvm, batch) != LVM_TRUE) {
+		/* Continue tuple by tuple from the same position. */
+		free(batch);
+		(*handle)->lvm_batch = NULL;
+		free(rows);
+		return DB_OK;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (!batch->result[i]) {
+			continue;
+		}
+		(*handle)->current_row++;
+
+		if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
+			result = cursor_data_add(cursor, first + i);
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+			continue;
+		}
+		for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+			if (attr_map_ptr->to_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+				continue;
+			}
+			from_ptr = rows + i * rel->row_length + attr_map_ptr->from_offset;
+			result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+			result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+		}
+	}
+
+	(*handle)->tuple_id = first + count - 1;
+	result = DB_OK;
+
+errout:
+	free(rows);
+	return result;
+}
+
 db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 {
 	db_result_t result;
@@ -793,6 +1292,7 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 	attribute_t *result_attr, *from_attr;
 	unsigned char *from_ptr, *to_ptr;
 	char aggr_buf[8];
+	size_t length;
 	attribute_value_t value;
 	storage_row_t row = NULL;
 	tuple_t result_row;
@@ -808,6 +1308,25 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 	attribute_count = (*handle)->result_rel->attribute_count;
 	attr_map_end = (*handle)->attr_map + attribute_count;
 
+	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_COLUMNS) {
+		result = aggregate_columns(handle);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		goto processing_aggregation;
+	}
+
+	if ((*handle)->lvm_batch != NULL) {
+		result = select_batch(handle, cursor);
+		if (result != DB_FINISHED) {
+			return result;
+		}
+		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
+			goto processing_aggregation;
+		}
+		return DB_FINISHED;
+	}
+
 	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
 		(*handle)->tuple_id = index_get_next(&((*handle)->index_iterator), TRUE);
 		if ((*handle)->tuple_id == INVALID_TUPLE) {
@@ -852,7 +1371,7 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -874,6 +1393,10 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 
 		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
 			for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+				if (attr_map_ptr->to_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+					/* Only used by the predicate. */
+					continue;
+				}
 				from_ptr = row + attr_map_ptr->from_offset;
 				result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
 				if (DB_ERROR(result)) {
@@ -902,6 +1425,9 @@ processing_aggregation:
 	/* Generate aggregated result if requested. */
 	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
 		result_attr = attr_map_ptr->to_attr;
+		if (result_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+			continue;
+		}
 		to_ptr = result_row + attr_map_ptr->to_offset;
 
 		snprintf(aggr_buf, sizeof(aggr_buf), "%f", result_attr->aggregation_value);
@@ -910,7 +1436,11 @@ processing_aggregation:
 	}
 
 	/* Copy aggregated result to tuple in cursor */
-	memcpy(cursor->tuple, result_row, sizeof(cursor->tuple));
+	length = (*handle)->result_rel->row_length;
+	if (length > sizeof(cursor->tuple)) {
+		length = sizeof(cursor->tuple);
+	}
+	memcpy(cursor->tuple, result_row, length);
 
 	(*handle)->current_row = 0;
 	(*handle)->adt_flags &= ~AQL_FLAG_AGGREGATE; /* Stop the aggregation. */
@@ -944,6 +1474,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 	tuple_t result_row;
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
 	char name[RELATION_NAME_LENGTH + 1];
+	int columnar;
 	int i;
 
 	if ((*handle)->tuple == NULL) {
@@ -978,7 +1509,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -1014,6 +1545,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 end_removal:
 	DB_LOG_E("DB: Finished removing tuples. Result relation has %d tuples\n", (*handle)->result_rel->cardinality);
 	memcpy(name, (*handle)->rel->name, sizeof(name));
+	columnar = RELATION_HAS_COLUMNS((*handle)->rel);
 	relation_remove((*handle)->rel, 1);
 
 	/* Rename the name of new relation to old relation */
@@ -1024,6 +1556,11 @@ end_removal:
 	}
 	memcpy((*handle)->result_rel->name, (*handle)->rel->name, sizeof((*handle)->result_rel->name));
 
+	/* Keep the relation columnar with the remaining tuples. */
+	if (columnar && DB_ERROR(column_create((*handle)->result_rel))) {
+		DB_LOG_E("DB: Failed to rebuild the columns of relation %s\n", name);
+	}
+
 	/* Process finished, we allocate cursor for result of remove */
 	if (DB_ERROR(cursor_init(&cursor, (*handle)->result_rel)) || DB_ERROR(cursor_data_set(cursor, (*handle)->attr_map, (*handle)->result_rel->attribute_count))) {
 		DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
@@ -1102,6 +1639,40 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 	return NULL;
 }
 
+/*
+ * Return a streaming cursor for a selection which scans the relation
+ * without aggregates, so that tuples are evaluated only as the cursor
+ * moves. Other selections are processed as by relation_process_result().
+ */
+db_cursor_t *relation_stream_result(db_handle_t *handler)
+{
+	db_cursor_t *cursor;
+
+	if (handler->optype != AQL_TYPE_SELECT || (handler->adt_flags & (AQL_FLAG_AGGREGATE | AQL_FLAG_ASSIGN)) || (handler->flags & (DB_HANDLE_FLAG_SEARCH_INDEX | DB_HANDLE_FLAG_SEARCH_COLUMNS)) || handler->rel->dir != DB_STORAGE) {
+		return relation_process_result(handler);
+	}
+
+	cursor = (db_cursor_t *)malloc(sizeof(db_cursor_t));
+	if (cursor == NULL) {
+		DB_LOG_E("DB: Failed to malloc cursor\n");
+		return NULL;
+	}
+	memset(cursor, 0, sizeof(db_cursor_t));
+
+	if (DB_ERROR(cursor_data_set(cursor, handler->attr_map, handler->result_rel->attribute_count)) || DB_ERROR(cursor_stream_init(cursor, handler->rel, handler->lvm_instance))) {
+		DB_LOG_E("DB: Failed to init streaming cursor\n");
+		if (cursor->stream != NULL) {
+			cursor->stream->lvm_instance = NULL;
+		}
+		cursor_deinit(cursor);
+		return NULL;
+	}
+	/* The cursor evaluates the condition from now on. */
+	handler->lvm_instance = NULL;
+
+	return cursor;
+}
+
 db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
 {
 	aql_adt_t *adt;
@@ -97,7 +97,7 @@
 #define IS_INVALID_CURSOR_ROW(a) ((a) == NULL || ((a)->current_cursor_row >= (a)->cursor_rows))
 
 /* check current storage row is valid or invalid*/
-#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY)
+#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || ((a)->stream == NULL && (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY))
 
 #define RELATION_HAS_TUPLES(rel) ((rel)->tuple_storage >= 0)
 
@@ -119,6 +119,9 @@ enum db_value_type_e {
 };
 typedef enum db_value_type_e db_value_type_t;
 
+struct column_store_s;
+struct memb;
+
 /*
  * A relation consists of a name, a set of domains, a set of indexes,
  * and a set of keys. Each relation must have a primary key.
@@ -133,6 +136,7 @@ struct relation_s {
 	tuple_id_t next_row;
 	db_storage_id_t tuple_storage;
 	db_direction_t dir;
+	struct column_store_s *columns;
 	uint8_t references;
 	char name[RELATION_NAME_LENGTH + 1];
 	char tuple_filename[TUPLE_NAME_LENGTH + 1];
@@ -150,6 +154,23 @@ struct cursor_data_map_s {
 };
 typedef struct cursor_data_map_s cursor_data_map_t;
 
+/*
+ * A streaming cursor keeps the condition of its query instead of a bitmap
+ * of the selected tuples, and finds the next selected tuple when it moves
+ * forward. Tuples before next_row have been evaluated, and matches of
+ * them were selected.
+ */
+struct cursor_stream_s {
+	void *lvm_instance;			/* NULL when every tuple is selected */
+	attribute_t *attrs;			/* Attributes of the condition variables */
+	unsigned char *row;			/* Tuple row_id of the tuple file */
+	db_storage_id_t storage;
+	tuple_id_t next_row;
+	tuple_id_t matches;
+	tuple_id_t row_id;
+	uint8_t finished;			/* cursor_rows counts all selected tuples */
+};
+
 /* A structure for cursor in SELECT operation */
 struct _db_cursor_s {
 	tuple_id_t current_cursor_row;
@@ -163,6 +184,7 @@ struct _db_cursor_s {
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
 	cursor_data_map_t attr_map[AQL_ATTRIBUTE_LIMIT];
+	struct cursor_stream_s *stream;
 };
 
 /****************************************************************************
@@ -170,6 +192,7 @@ struct _db_cursor_s {
  ****************************************************************************/
 /* Operations for cursor processing */
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel);
+db_result_t cursor_stream_init(db_cursor_t *cursor, relation_t *rel, void *lvm_instance);
 db_result_t cursor_load(db_cursor_t **target, db_cursor_t *src);
 db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id);
 db_result_t cursor_deinit(db_cursor_t *cursor);
@@ -181,6 +204,7 @@ db_result_t relation_deinit(void);
 db_result_t relation_process_remove(db_handle_t **, db_cursor_t *);
 db_result_t relation_process_select(db_handle_t **, db_cursor_t *);
 db_cursor_t *relation_process_result(db_handle_t *);
+db_cursor_t *relation_stream_result(db_handle_t *);
 relation_t *relation_load(char *);
 db_result_t relation_release(relation_t *);
 relation_t *relation_create(char *, db_direction_t);
@@ -192,7 +216,9 @@ db_result_t relation_attribute_remove(relation_t *, char *);
 db_result_t relation_set_primary_key(relation_t *, char *);
 db_result_t relation_remove(relation_t *, int);
 db_result_t relation_insert(relation_t *, attribute_value_t *);
+db_result_t relation_insert_batch(relation_t *, db_value_t *, int);
 db_result_t relation_select(db_handle_t **, relation_t *, void *);
 tuple_id_t relation_cardinality(relation_t *);
+struct memb *relation_pool(db_pool_t);
 
 #endif              /* RELATION_H */
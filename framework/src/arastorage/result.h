@@ -71,6 +71,7 @@
 #define DB_HANDLE_FLAG_INDEX_STEP       0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX     0x02
 #define DB_HANDLE_FLAG_PROCESSING       0x04
+#define DB_HANDLE_FLAG_SEARCH_COLUMNS   0x08
 #define DB_HANDLE_FLAG_INVALID          0x00
 
 /****************************************************************************
@@ -106,6 +107,7 @@ struct _db_handle_s {
 	uint8_t adt_flags;
 	uint8_t ncolumns;
 	void *lvm_instance;
+	void *lvm_batch;
 	source_dest_map_t *attr_map;
 };
 
@@ -91,12 +91,18 @@ db_result_t storage_put_relation(relation_t *);
 db_result_t storage_drop_relation(relation_t *, int);
 db_result_t storage_rename_relation(char *, char *);
 
+db_result_t storage_pin_tuples(const char *);
+void storage_unpin_tuples(const char *);
+db_result_t storage_remove_tuples(const char *);
+int storage_tuples_pinned(const char *);
+
 db_result_t storage_put_attribute(relation_t *, attribute_t *);
 db_result_t storage_get_index(index_t *, relation_t *, attribute_t *);
 db_result_t storage_put_index(index_t *);
 db_result_t storage_remove_index(relation_t *rel, attribute_t *attr);
 db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t, uint8_t);
+db_result_t storage_put_rows(relation_t *, storage_row_t, unsigned);
 db_result_t storage_write_row(db_storage_id_t, storage_row_t, unsigned, char *);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
 db_result_t storage_read_from(db_storage_id_t, void *, unsigned long, unsigned);
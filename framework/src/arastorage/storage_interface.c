@@ -83,6 +83,35 @@ struct index_record_s {
 	uint8_t type;
 };
 
+/* A tuple file read by open cursors */
+struct tuple_pin_s {
+	struct tuple_pin_s *next;
+	char filename[TUPLE_NAME_LENGTH + 1];
+	uint16_t cursors;
+	uint8_t removed;			/* Remove the file when the last cursor is gone */
+};
+
+/****************************************************************************
+* Private Data
+****************************************************************************/
+static struct tuple_pin_s *g_tuple_pins;
+static pthread_mutex_t g_tuple_pin_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static struct tuple_pin_s **find_pin(const char *filename)
+{
+	struct tuple_pin_s **pin;
+
+	for (pin = &g_tuple_pins; *pin != NULL; pin = &(*pin)->next) {
+		if (strncmp((*pin)->filename, filename, TUPLE_NAME_LENGTH) == 0) {
+			break;
+		}
+	}
+	return pin;
+}
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -231,7 +260,10 @@ db_result_t storage_put_relation(relation_t *rel)
 	}
 
 	if (rel->tuple_filename[0] == '\0') {
-		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+		/* Do not truncate a removed tuple file that cursors still read. */
+		do {
+			snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+		} while (storage_tuples_pinned(tuple_path));
 		result = storage_generate_file(tuple_path);
 		if (DB_ERROR(result)) {
 			storage_close(fd);
@@ -285,7 +317,7 @@ db_result_t storage_drop_relation(relation_t *rel, int remove_tuples)
 	DB_LOG_D("Unlink rel = %s, tuple = %s\n", rel->name, rel->tuple_filename);
 	if (remove_tuples && RELATION_HAS_TUPLES(rel)) {
 		storage_close(rel->tuple_storage);
-		if (DB_ERROR(storage_remove(rel->tuple_filename))) {
+		if (DB_ERROR(storage_remove_tuples(rel->tuple_filename))) {
 			DB_LOG_D("Failed to remove tuple file : %s\n", rel->tuple_filename);
 			return DB_STORAGE_ERROR;
 		}
@@ -299,6 +331,86 @@ db_result_t storage_drop_relation(relation_t *rel, int remove_tuples)
 	return DB_OK;
 }
 
+/****************************************************************************
+ * Name: storage_pin_tuples
+ *
+ * Description: Keeps a tuple file on storage while a cursor reads it. Rows
+ *              are only ever appended to a tuple file, so the rows below
+ *              the cardinality seen by the cursor do not change. Operations
+ *              which rewrite a relation write a new tuple file, and the old
+ *              one stays readable by its cursors until they are freed
+ *
+ ****************************************************************************/
+db_result_t storage_pin_tuples(const char *filename)
+{
+	struct tuple_pin_s **pin;
+	db_result_t result;
+
+	result = DB_OK;
+	pthread_mutex_lock(&g_tuple_pin_lock);
+	pin = find_pin(filename);
+	if (*pin == NULL) {
+		*pin = (struct tuple_pin_s *)malloc(sizeof(struct tuple_pin_s));
+		if (*pin == NULL) {
+			result = DB_ALLOCATION_ERROR;
+			goto out;
+		}
+		memset(*pin, 0, sizeof(struct tuple_pin_s));
+		strncpy((*pin)->filename, filename, TUPLE_NAME_LENGTH);
+	}
+	(*pin)->cursors++;
+out:
+	pthread_mutex_unlock(&g_tuple_pin_lock);
+	return result;
+}
+
+void storage_unpin_tuples(const char *filename)
+{
+	struct tuple_pin_s **pin;
+	struct tuple_pin_s *unpinned;
+
+	pthread_mutex_lock(&g_tuple_pin_lock);
+	pin = find_pin(filename);
+	if (*pin != NULL && --(*pin)->cursors == 0) {
+		unpinned = *pin;
+		*pin = unpinned->next;
+		if (unpinned->removed) {
+			DB_LOG_D("DB: Remove tuple file %s of the last cursor\n", unpinned->filename);
+			storage_remove(unpinned->filename);
+		}
+		free(unpinned);
+	}
+	pthread_mutex_unlock(&g_tuple_pin_lock);
+}
+
+/* Remove a tuple file, or defer it until its cursors unpin it. */
+db_result_t storage_remove_tuples(const char *filename)
+{
+	struct tuple_pin_s *pin;
+	db_result_t result;
+
+	pthread_mutex_lock(&g_tuple_pin_lock);
+	pin = *find_pin(filename);
+	if (pin != NULL) {
+		pin->removed = 1;
+		result = DB_OK;
+	} else {
+		result = storage_remove(filename);
+	}
+	pthread_mutex_unlock(&g_tuple_pin_lock);
+	return result;
+}
+
+int storage_tuples_pinned(const char *filename)
+{
+	int pinned;
+
+	pthread_mutex_lock(&g_tuple_pin_lock);
+	pinned = *find_pin(filename) != NULL;
+	pthread_mutex_unlock(&g_tuple_pin_lock);
+	return pinned;
+}
+
 db_result_t storage_rename_relation(char *old_name, char *new_name)
 {
 	ssize_t r;
@@ -543,6 +655,28 @@ db_result_t storage_put_row(relation_t *rel, storage_row_t row, uint8_t flag)
 	return result;
 }
 
+/* Append count contiguous rows with a single positioned write. Rows held
+   in the insert buffer must have been flushed by the caller. */
+db_result_t storage_put_rows(relation_t *rel, storage_row_t rows, unsigned count)
+{
+	db_result_t result;
+	tuple_id_t nrows;
+
+	if (DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+		return DB_STORAGE_ERROR;
+	}
+
+	result = storage_write_to(rel->tuple_storage, rows, (unsigned long)nrows * rel->row_length, count * rel->row_length);
+	if (DB_ERROR(result)) {
+		DB_LOG_D("DB: Failed to store %u rows\n", count);
+		return DB_STORAGE_ERROR;
+	}
+
+	rel->cardinality += count;
+	rel->next_row += count;
+	return DB_OK;
+}
+
 db_result_t storage_write_row(db_storage_id_t fd, storage_row_t row, unsigned length, char *filename)
 {
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <debug.h>
 #include <errno.h>
@@ -268,6 +269,73 @@ int dm_conn_get_interface(char *interface)
 	return DM_ERROR_NO_DATA;
 }
 
+int dm_conn_get_stats(dm_conn_stats_t *stats)
+{
+	struct ifreq ifreqs[3];
+	struct ifreq *ifr;
+	struct sockaddr_in *sin;
+	struct ifconf ifcfg;
+	struct mallinfo mem;
+	int8_t val;
+	uint8_t uval;
+	int fd;
+	int i;
+
+	if (stats == NULL) {
+		dmdbg("Null Parameter\n");
+		return DM_ERROR_INVALID_PARAMETER;
+	}
+
+	memset(stats, 0, sizeof(dm_conn_stats_t));
+
+	if (WiFiGetRssi(&val) == SLSI_STATUS_SUCCESS) {
+		stats->rssi = val;
+		stats->valid |= DM_CONN_STATS_RSSI;
+	}
+	if (WiFiGetChannel(&val) == SLSI_STATUS_SUCCESS) {
+		stats->channel = (uint8_t)val;
+		stats->valid |= DM_CONN_STATS_CHANNEL;
+	}
+	if (WiFiGetTxPower(&uval) == SLSI_STATUS_SUCCESS) {
+		stats->tx_power = uval;
+		stats->valid |= DM_CONN_STATS_TX_POWER;
+	}
+
+	/* One interface list serves both the address and the interface name */
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd >= 0) {
+		ifcfg.ifc_len = sizeof(ifreqs);
+		ifcfg.ifc_req = ifreqs;
+		if (ioctl(fd, SIOCGIFCONF, (void *)&ifcfg) == 0) {
+			for (i = 0, ifr = ifreqs; i < ifcfg.ifc_len / (int)sizeof(struct ifreq); ifr++, i++) {
+				sin = (struct sockaddr_in *)&ifr->ifr_addr;
+				if (sin->sin_addr.s_addr == INADDR_LOOPBACK) {
+					continue;
+				}
+				stats->ipaddr = sin->sin_addr.s_addr;
+				strncpy(stats->interface, ifr->ifr_name, IF_NAMESIZE);
+				stats->valid |= DM_CONN_STATS_ADDRESS | DM_CONN_STATS_INTERFACE;
+				break;
+			}
+		}
+		close(fd);
+	}
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	mem = mallinfo();
+	stats->mem_free = (uint32_t)mem.fordblks;
+	stats->valid |= DM_CONN_STATS_MEM_FREE;
+#else
+	if (mallinfo(&mem) == OK) {
+		stats->mem_free = (uint32_t)mem.fordblks;
+		stats->valid |= DM_CONN_STATS_MEM_FREE;
+	}
+#endif
+
+	return stats->valid != 0 ? DM_ERROR_NONE : DM_ERROR_NO_DATA;
+}
+
 int dm_conn_register_linkup_cb(conn_cb cb)
 {
 	int i;
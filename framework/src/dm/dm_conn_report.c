@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file dm_conn_report.c
+ * @brief Delta encoding of DM connectivity snapshots
+ */
+#include <tinyara/config.h>
+
+#include <string.h>
+
+#include <dm/dm_error.h>
+#include <dm/dm_connectivity.h>
+
+static uint32_t dm_zigzag(int32_t v)
+{
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t dm_unzigzag(uint32_t v)
+{
+	return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint8_t dm_conn_changed(const dm_conn_stats_t *prev, const dm_conn_stats_t *cur)
+{
+	uint8_t mask;
+
+	if (prev == NULL) {
+		return cur->valid & DM_CONN_STATS_ALL;
+	}
+
+	/* Only fields the peer already holds can be skipped */
+
+	mask = cur->valid & ~prev->valid;
+	if ((cur->valid & prev->valid & DM_CONN_STATS_RSSI) && cur->rssi != prev->rssi) {
+		mask |= DM_CONN_STATS_RSSI;
+	}
+	if ((cur->valid & prev->valid & DM_CONN_STATS_CHANNEL) && cur->channel != prev->channel) {
+		mask |= DM_CONN_STATS_CHANNEL;
+	}
+	if ((cur->valid & prev->valid & DM_CONN_STATS_TX_POWER) && cur->tx_power != prev->tx_power) {
+		mask |= DM_CONN_STATS_TX_POWER;
+	}
+	if ((cur->valid & prev->valid & DM_CONN_STATS_ADDRESS) && cur->ipaddr != prev->ipaddr) {
+		mask |= DM_CONN_STATS_ADDRESS;
+	}
+	if ((cur->valid & prev->valid & DM_CONN_STATS_INTERFACE) && strncmp(cur->interface, prev->interface, IF_NAMESIZE) != 0) {
+		mask |= DM_CONN_STATS_INTERFACE;
+	}
+	if ((cur->valid & prev->valid & DM_CONN_STATS_MEM_FREE) && cur->mem_free != prev->mem_free) {
+		mask |= DM_CONN_STATS_MEM_FREE;
+	}
+
+	return mask & DM_CONN_STATS_ALL;
+}
+
+int dm_conn_encode_stats(const dm_conn_stats_t *prev, const dm_conn_stats_t *cur, uint8_t *buf, size_t buflen)
+{
+	uint8_t mask;
+	uint8_t *p;
+	size_t len;
+	uint32_t base;
+	uint32_t v;
+
+	if (cur == NULL || buf == NULL || buflen < DM_CONN_STATS_REPORT_MAX) {
+		return DM_ERROR_INVALID_PARAMETER;
+	}
+
+	mask = dm_conn_changed(prev, cur);
+	if (mask == 0) {
+		return 0;
+	}
+
+	p = buf;
+	*p++ = mask;
+	if (mask & DM_CONN_STATS_RSSI) {
+		*p++ = (uint8_t)cur->rssi;
+	}
+	if (mask & DM_CONN_STATS_CHANNEL) {
+		*p++ = cur->channel;
+	}
+	if (mask & DM_CONN_STATS_TX_POWER) {
+		*p++ = cur->tx_power;
+	}
+	if (mask & DM_CONN_STATS_ADDRESS) {
+		memcpy(p, &cur->ipaddr, 4);
+		p += 4;
+	}
+	if (mask & DM_CONN_STATS_INTERFACE) {
+		len = strnlen(cur->interface, IF_NAMESIZE);
+		*p++ = (uint8_t)len;
+		memcpy(p, cur->interface, len);
+		p += len;
+	}
+	if (mask & DM_CONN_STATS_MEM_FREE) {
+		base = (prev != NULL && (prev->valid & DM_CONN_STATS_MEM_FREE)) ? prev->mem_free : 0;
+		v = dm_zigzag((int32_t)(cur->mem_free - base));
+		while (v >= 0x80) {
+			*p++ = (uint8_t)(v | 0x80);
+			v >>= 7;
+		}
+		*p++ = (uint8_t)v;
+	}
+
+	return (int)(p - buf);
+}
+
+int dm_conn_decode_stats(dm_conn_stats_t *stats, const uint8_t *buf, size_t len)
+{
+	const uint8_t *p;
+	const uint8_t *end;
+	uint8_t mask;
+	size_t namelen;
+	uint32_t base;
+	uint32_t v;
+	int shift;
+
+	if (stats == NULL || buf == NULL || len == 0) {
+		return DM_ERROR_INVALID_PARAMETER;
+	}
+
+	p = buf;
+	end = buf + len;
+	mask = *p++;
+	if (mask & ~DM_CONN_STATS_ALL) {
+		return DM_ERROR_INVALID_PARAMETER;
+	}
+
+	if (mask & DM_CONN_STATS_RSSI) {
+		if (p >= end) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		stats->rssi = (int8_t)*p++;
+	}
+	if (mask & DM_CONN_STATS_CHANNEL) {
+		if (p >= end) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		stats->channel = *p++;
+	}
+	if (mask & DM_CONN_STATS_TX_POWER) {
+		if (p >= end) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		stats->tx_power = *p++;
+	}
+	if (mask & DM_CONN_STATS_ADDRESS) {
+		if (end - p < 4) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		memcpy(&stats->ipaddr, p, 4);
+		p += 4;
+	}
+	if (mask & DM_CONN_STATS_INTERFACE) {
+		if (p >= end) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		namelen = *p++;
+		if (namelen > IF_NAMESIZE || (size_t)(end - p) < namelen) {
+			return DM_ERROR_INVALID_PARAMETER;
+		}
+		memset(stats->interface, 0, IF_NAMESIZE);
+		memcpy(stats->interface, p, namelen);
+		p += namelen;
+	}
+	if (mask & DM_CONN_STATS_MEM_FREE) {
+		v = 0;
+		shift = 0;
+		do {
+			if (p >= end || shift > 28) {
+				return DM_ERROR_INVALID_PARAMETER;
+			}
+			v |= (uint32_t)(*p & 0x7f) << shift;
+			shift += 7;
+		} while (*p++ & 0x80);
+		base = (stats->valid & DM_CONN_STATS_MEM_FREE) ? stats->mem_free : 0;
+		stats->mem_free = base + (uint32_t)dm_unzigzag(v);
+	}
+
+	if (p != end) {
+		return DM_ERROR_INVALID_PARAMETER;
+	}
+
+	stats->valid |= mask;
+	return DM_ERROR_NONE;
+}
@@ -64,6 +64,11 @@ int dm_conn_get_interface(char *interface)
 	return DM_ERROR_NOT_SUPPORTED;
 }
 
+int dm_conn_get_stats(dm_conn_stats_t *stats)
+{
+	return DM_ERROR_NOT_SUPPORTED;
+}
+
 int dm_conn_register_linkup_cb(conn_cb cb)
 {
 	return DM_ERROR_NOT_SUPPORTED;
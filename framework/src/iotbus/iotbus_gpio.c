@@ -38,6 +38,9 @@
 
 #define zdbg printf
 
+/* Edges handed to an events callback per call */
+#define IOTBUS_GPIO_EVENT_BATCH 16
+
 /**
  * @brief Struct for iotbus_gpio_s
  */
@@ -48,6 +51,7 @@ struct _iotbus_gpio_s {
 	iotbus_gpio_edge_e edge;
 	int fd;
 	gpio_isr_cb isr_cb;
+	gpio_events_cb events_cb;
 	void *ud;
 };
 
@@ -59,6 +63,23 @@ extern "C" {
 void gpio_async_handler(void *data)
 {
 	struct _iotbus_gpio_s *item = (struct _iotbus_gpio_s *)data;
+
+	if (item->events_cb) {
+		iotbus_gpio_event_s events[IOTBUS_GPIO_EVENT_BATCH];
+		unsigned int dropped;
+		int n;
+
+		/* Drain everything buffered since the last wakeup */
+		do {
+			n = iotbus_gpio_read_events(item, events, IOTBUS_GPIO_EVENT_BATCH, &dropped);
+			if (n < 0)
+				break;
+			if (n > 0 || dropped)
+				item->events_cb(events, n, dropped, item->ud);
+		} while (n == IOTBUS_GPIO_EVENT_BATCH);
+		return;
+	}
+
 	item->isr_cb(item->ud);
 
 	return;
@@ -85,6 +106,7 @@ iotbus_gpio_context_h iotbus_gpio_open(int gpiopin)
 	dev->dir = IOTBUS_GPIO_DIRECTION_OUT;
 	dev->edge = IOTBUS_GPIO_EDGE_NONE;
 	dev->isr_cb = NULL;
+	dev->events_cb = NULL;
 
 	return dev;
 }
@@ -97,7 +119,7 @@ int iotbus_gpio_close(iotbus_gpio_context_h dev)
 	if (!dev)
 		return IOTBUS_ERROR_INVALID_PARAMETER;
 
-	if (dev->isr_cb != NULL) {
+	if (dev->isr_cb != NULL || dev->events_cb != NULL) {
 		int ret = iotbus_gpio_unregister_cb(dev);
 		if (ret != IOTBUS_ERROR_NONE)
 			return ret;
@@ -291,11 +313,92 @@ int iotbus_gpio_unregister_cb(iotbus_gpio_context_h dev)
 	iotapi_remove(&elm);
 
 	item->isr_cb = NULL;
+	item->events_cb = NULL;
 	item->ud = NULL;
 
 	return IOTBUS_ERROR_NONE;
 }
 
+/**
+ * @brief Registers a callback for batches of timestamped edges.
+ */
+int iotbus_gpio_register_events_cb(iotbus_gpio_context_h dev, iotbus_gpio_edge_e edge, gpio_events_cb events_cb, void *user_data)
+{
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	unsigned int dropped;
+	int ret;
+
+	if (events_cb == NULL)
+		return IOTBUS_ERROR_INVALID_PARAMETER;
+
+	ret = iotbus_gpio_set_edge_mode(dev, edge);
+	if (ret != IOTBUS_ERROR_NONE)
+		return ret;
+
+	/* Start from an empty buffer */
+	ret = iotbus_gpio_read_events(dev, NULL, 0, &dropped);
+	if (ret < 0)
+		return ret;
+
+	struct _iotbus_gpio_s *item = (struct _iotbus_gpio_s *)dev;
+	iotapi_elem elm;
+
+	item->ud = user_data;
+	item->events_cb = events_cb;
+	elm.fd = dev->fd;
+	elm.data = item;
+	elm.func = gpio_async_handler;
+
+	iotapi_insert(&elm);
+
+	return IOTBUS_ERROR_NONE;
+#else
+	return IOTBUS_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Reads the buffered edges without blocking.
+ */
+int iotbus_gpio_read_events(iotbus_gpio_context_h dev, iotbus_gpio_event_s *events, unsigned int count, unsigned int *dropped)
+{
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	struct gpio_event_s buf[IOTBUS_GPIO_EVENT_BATCH];
+	struct gpio_events_s arg;
+	unsigned int total = 0;
+	unsigned int lost = 0;
+	int i;
+	int ret;
+
+	if (!dev || (!events && count))
+		return IOTBUS_ERROR_INVALID_PARAMETER;
+
+	do {
+		arg.ge_events = buf;
+		arg.ge_nevents = count - total < IOTBUS_GPIO_EVENT_BATCH ? count - total : IOTBUS_GPIO_EVENT_BATCH;
+		arg.ge_dropped = 0;
+
+		ret = ioctl(dev->fd, GPIOIOC_READ_EVENTS, (unsigned long)&arg);
+		if (ret < 0)
+			return errno == ENOSYS ? IOTBUS_ERROR_NOT_SUPPORTED : IOTBUS_ERROR_UNKNOWN;
+
+		lost += arg.ge_dropped;
+		for (i = 0; i < ret; i++) {
+			events[total + i].timestamp = buf[i].ge_usec;
+			events[total + i].value = buf[i].ge_value;
+		}
+		total += ret;
+	} while (ret == IOTBUS_GPIO_EVENT_BATCH && total < count);
+
+	if (dropped)
+		*dropped = lost;
+
+	return total;
+#else
+	return IOTBUS_ERROR_NOT_SUPPORTED;
+#endif
+}
+
 /**
  * @brief Reads the gpio value.
  */
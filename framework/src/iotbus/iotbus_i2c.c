@@ -24,6 +24,7 @@
 #include <tinyara/config.h>
 
 #include <stdlib.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
@@ -135,6 +136,77 @@ int iotbus_i2c_write(iotbus_i2c_context_h hnd, const uint8_t *data, size_t lengt
 	return ret;
 }
 
+int iotbus_i2c_batch(iotbus_i2c_context_h hnd, iotbus_i2c_xfer_s *xfers, unsigned int count)
+{
+#ifdef CONFIG_I2C_BATCH
+	struct i2c_batch_ioctl_data_s batch;
+	struct i2c_xfer_s *kxfers;
+	struct i2c_msg_s *msgs;
+	unsigned int i;
+	int ret;
+
+	if (!hnd)
+		return IOTBUS_ERROR_INVALID_PARAMETER;
+
+	if (count == 0)
+		return IOTBUS_ERROR_NONE;
+
+	if (!xfers)
+		return IOTBUS_ERROR_INVALID_PARAMETER;
+
+	/* At most a write and a read message per transfer */
+	kxfers = (struct i2c_xfer_s *)malloc(count * (sizeof(struct i2c_xfer_s) + 2 * sizeof(struct i2c_msg_s)));
+	if (!kxfers)
+		return IOTBUS_ERROR_UNKNOWN;
+	msgs = (struct i2c_msg_s *)&kxfers[count];
+
+	for (i = 0; i < count; i++) {
+		iotbus_i2c_xfer_s *x = &xfers[i];
+
+		if ((x->wlen && !x->wbuf) || (x->rlen && !x->rbuf) || x->wlen > UINT16_MAX || x->rlen > UINT16_MAX) {
+			free(kxfers);
+			return IOTBUS_ERROR_INVALID_PARAMETER;
+		}
+
+		kxfers[i].msgs = msgs;
+		kxfers[i].nmsgs = 0;
+		if (x->wlen) {
+			msgs->addr = x->address;
+			msgs->flags = 0;
+			msgs->buffer = (uint8_t *)x->wbuf;
+			msgs->length = x->wlen;
+			msgs++;
+			kxfers[i].nmsgs++;
+		}
+		if (x->rlen) {
+			msgs->addr = x->address;
+			msgs->flags = I2C_M_READ;
+			msgs->buffer = x->rbuf;
+			msgs->length = x->rlen;
+			msgs++;
+			kxfers[i].nmsgs++;
+		}
+	}
+
+	batch.xfers = kxfers;
+	batch.nxfers = count;
+	ret = ioctl(hnd->fd, I2C_RDWR_BATCH, (unsigned long)((uintptr_t)&batch));
+	if (ret < 0) {
+		ret = (errno == ETIMEDOUT) ? IOTBUS_ERROR_TIMED_OUT : IOTBUS_ERROR_UNKNOWN;
+	} else {
+		ret = IOTBUS_ERROR_NONE;
+	}
+
+	for (i = 0; i < count; i++)
+		xfers[i].result = kxfers[i].result < 0 ? kxfers[i].result : 0;
+
+	free(kxfers);
+	return ret;
+#else
+	return IOTBUS_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
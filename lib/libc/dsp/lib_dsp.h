@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/dsp/lib_dsp.h
+ *
+ * Saturating and dual 16-bit multiply-accumulate primitives.  On cores with
+ * the ARMv7 DSP extension (Cortex-M4, Cortex-R4) they map to single
+ * QADD/QSUB/QADD16/QSUB16/SSAT/SMLALD instructions, elsewhere to C.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_DSP_LIB_DSP_H
+#define __LIBC_DSP_LIB_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(__ARM_FEATURE_DSP) && defined(__GNUC__)
+#define DSP_HAVE_ARM_DSP 1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Two adjacent q15_t read or written as one word.  The ARMv7 cores handle
+ * the halfword aligned word accesses in hardware.
+ */
+
+typedef uint32_t dsp_pair_t __attribute__((aligned(2), may_alias));
+
+#define DSP_PAIR(p)             (*(FAR const dsp_pair_t *)(p))
+#define DSP_SETPAIR(p, v)       (*(FAR dsp_pair_t *)(p) = (v))
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Saturate to the q15_t range */
+
+static inline q15_t dsp_sat15(int32_t x)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	int32_t r;
+
+	__asm__("ssat %0, #16, %1" : "=r"(r) : "r"(x));
+	return (q15_t)r;
+#else
+	if (x > Q15_MAX) {
+		return Q15_MAX;
+	} else if (x < Q15_MIN) {
+		return Q15_MIN;
+	}
+
+	return (q15_t)x;
+#endif
+}
+
+/* Saturate a 64-bit value to the q31_t range */
+
+static inline q31_t dsp_sat31(int64_t x)
+{
+	if (x > Q31_MAX) {
+		return Q31_MAX;
+	} else if (x < Q31_MIN) {
+		return Q31_MIN;
+	}
+
+	return (q31_t)x;
+}
+
+static inline q31_t dsp_qadd(q31_t a, q31_t b)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	q31_t r;
+
+	__asm__("qadd %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+	return r;
+#else
+	return dsp_sat31((int64_t)a + b);
+#endif
+}
+
+static inline q31_t dsp_qsub(q31_t a, q31_t b)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	q31_t r;
+
+	__asm__("qsub %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+	return r;
+#else
+	return dsp_sat31((int64_t)a - b);
+#endif
+}
+
+/* Saturating add and subtract of both halfwords of a pair */
+
+static inline uint32_t dsp_qadd16(uint32_t a, uint32_t b)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	uint32_t r;
+
+	__asm__("qadd16 %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+	return r;
+#else
+	uint16_t lo = (uint16_t)dsp_sat15((int32_t)(int16_t)a + (int16_t)b);
+	uint16_t hi = (uint16_t)dsp_sat15((int32_t)(int16_t)(a >> 16) + (int16_t)(b >> 16));
+
+	return ((uint32_t)hi << 16) | lo;
+#endif
+}
+
+static inline uint32_t dsp_qsub16(uint32_t a, uint32_t b)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	uint32_t r;
+
+	__asm__("qsub16 %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+	return r;
+#else
+	uint16_t lo = (uint16_t)dsp_sat15((int32_t)(int16_t)a - (int16_t)b);
+	uint16_t hi = (uint16_t)dsp_sat15((int32_t)(int16_t)(a >> 16) - (int16_t)(b >> 16));
+
+	return ((uint32_t)hi << 16) | lo;
+#endif
+}
+
+/* acc + a.lo * b.lo + a.hi * b.hi */
+
+static inline int64_t dsp_smlald(uint32_t a, uint32_t b, int64_t acc)
+{
+#ifdef DSP_HAVE_ARM_DSP
+	__asm__("smlald %Q0, %R0, %1, %2" : "+r"(acc) : "r"(a), "r"(b));
+	return acc;
+#else
+	return acc + (int32_t)(int16_t)a * (int16_t)b + (int32_t)(int16_t)(a >> 16) * (int16_t)(b >> 16);
+#endif
+}
+
+#endif							/* __LIBC_DSP_LIB_DSP_H */
@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/dsp/lib_dspbiquad.c
+ *
+ * Cascaded direct form I biquad filters.  Each stage runs over the whole
+ * block before the next one, keeping its coefficients and state in
+ * registers; the state of a stage is { x[n-1], x[n-2], y[n-1], y[n-2] }.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <dsp.h>
+
+#include "lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void dsp_biquad_q15_init(FAR struct dsp_biquad_q15_s *iir, uint8_t nstages, FAR const q15_t *coeffs, FAR q15_t *state, uint8_t postshift)
+{
+	iir->coeffs = coeffs;
+	iir->state = state;
+	iir->nstages = nstages;
+	iir->postshift = postshift;
+	memset(state, 0, nstages * DSP_BIQUAD_NSTATE * sizeof(q15_t));
+}
+
+void dsp_biquad_q15(FAR struct dsp_biquad_q15_s *iir, FAR const q15_t *src, FAR q15_t *dst, size_t n)
+{
+	FAR const q15_t *c = iir->coeffs;
+	FAR q15_t *s = iir->state;
+	int shift = 15 - iir->postshift;
+	int stage;
+	size_t i;
+
+	for (stage = 0; stage < iir->nstages; stage++) {
+		int32_t b0 = c[0];
+		int32_t b1 = c[1];
+		int32_t b2 = c[2];
+		int32_t a1 = c[3];
+		int32_t a2 = c[4];
+		int32_t x1 = s[0];
+		int32_t x2 = s[1];
+		int32_t y1 = s[2];
+		int32_t y2 = s[3];
+
+		for (i = 0; i < n; i++) {
+			int32_t x0 = src[i];
+			int64_t acc;
+			int32_t y0;
+
+			acc = (int64_t)(b0 * x0) + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+			y0 = dsp_sat15((int32_t)(acc >> shift));
+
+			x2 = x1;
+			x1 = x0;
+			y2 = y1;
+			y1 = y0;
+			dst[i] = (q15_t)y0;
+		}
+
+		s[0] = (q15_t)x1;
+		s[1] = (q15_t)x2;
+		s[2] = (q15_t)y1;
+		s[3] = (q15_t)y2;
+
+		/* The following stages filter the output in place */
+
+		src = dst;
+		c += DSP_BIQUAD_NCOEFFS;
+		s += DSP_BIQUAD_NSTATE;
+	}
+}
+
+void dsp_biquad_q31_init(FAR struct dsp_biquad_q31_s *iir, uint8_t nstages, FAR const q31_t *coeffs, FAR q31_t *state, uint8_t postshift)
+{
+	iir->coeffs = coeffs;
+	iir->state = state;
+	iir->nstages = nstages;
+	iir->postshift = postshift;
+	memset(state, 0, nstages * DSP_BIQUAD_NSTATE * sizeof(q31_t));
+}
+
+void dsp_biquad_q31(FAR struct dsp_biquad_q31_s *iir, FAR const q31_t *src, FAR q31_t *dst, size_t n)
+{
+	FAR const q31_t *c = iir->coeffs;
+	FAR q31_t *s = iir->state;
+	int shift = 31 - iir->postshift;
+	int stage;
+	size_t i;
+
+	for (stage = 0; stage < iir->nstages; stage++) {
+		int64_t b0 = c[0];
+		int64_t b1 = c[1];
+		int64_t b2 = c[2];
+		int64_t a1 = c[3];
+		int64_t a2 = c[4];
+		q31_t x1 = s[0];
+		q31_t x2 = s[1];
+		q31_t y1 = s[2];
+		q31_t y2 = s[3];
+
+		for (i = 0; i < n; i++) {
+			q31_t x0 = src[i];
+			int64_t acc;
+			q31_t y0;
+
+			acc = b0 * x0 + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+			y0 = dsp_sat31(acc >> shift);
+
+			x2 = x1;
+			x1 = x0;
+			y2 = y1;
+			y1 = y0;
+			dst[i] = y0;
+		}
+
+		s[0] = x1;
+		s[1] = x2;
+		s[2] = y1;
+		s[3] = y2;
+
+		src = dst;
+		c += DSP_BIQUAD_NCOEFFS;
+		s += DSP_BIQUAD_NSTATE;
+	}
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/dsp/lib_dspfft.c
+ *
+ * In-place radix-4 decimation in frequency FFT on Q15 data.  Every stage
+ * divides by 4, which keeps the butterflies in range without per-block
+ * exponent tracking.  The twiddles come from a quarter wave sine table
+ * for DSP_FFT_MAXSIZE points, shorter transforms use it with a stride.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <dsp.h>
+
+#include "lib_dsp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define QUARTER                 (DSP_FFT_MAXSIZE / 4)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* g_sintab[i] = sin(i * pi / (2 * QUARTER)) in Q15 */
+
+static const q15_t g_sintab[QUARTER + 1] = {
+	0, 201, 402, 603, 804, 1005, 1206, 1407,
+	1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012,
+	3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+	4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+	6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767,
+	7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+	9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849,
+	11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+	12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+	14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+	15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673,
+	16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+	18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357,
+	19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+	20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+	22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+	23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143,
+	24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+	25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+	26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+	27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+	28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+	28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534,
+	29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+	30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+	30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+	31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+	31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+	32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+	32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+	32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717,
+	32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+	32767
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* cos and sin of 2 * pi * m / DSP_FFT_MAXSIZE */
+
+static void dsp_twiddle(unsigned int m, FAR int32_t *c, FAR int32_t *s)
+{
+	unsigned int i = m & (QUARTER - 1);
+
+	switch (m / QUARTER) {
+	case 0:
+		*c = g_sintab[QUARTER - i];
+		*s = g_sintab[i];
+		break;
+	case 1:
+		*c = -g_sintab[i];
+		*s = g_sintab[QUARTER - i];
+		break;
+	case 2:
+		*c = -g_sintab[QUARTER - i];
+		*s = -g_sintab[i];
+		break;
+	default:
+		*c = g_sintab[i];
+		*s = -g_sintab[QUARTER - i];
+		break;
+	}
+}
+
+/* Store (re + j im) * (c - j s), rounded and saturated */
+
+static inline void dsp_rotate(FAR q15_t *dst, int32_t re, int32_t im, int32_t c, int32_t s)
+{
+	dst[0] = dsp_sat15((re * c + im * s + 0x4000) >> 15);
+	dst[1] = dsp_sat15((im * c - re * s + 0x4000) >> 15);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int dsp_cfft_q15(FAR q15_t *buf, size_t n, bool inverse)
+{
+	size_t len;
+	size_t quarter;
+	size_t stride;
+	size_t base;
+	size_t i;
+	size_t j;
+	size_t r;
+	int digits;
+	int k;
+
+	len = 4;
+	digits = 1;
+	while (len < n) {
+		len <<= 2;
+		digits++;
+	}
+
+	if (len != n || n > DSP_FFT_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	for (len = n, stride = DSP_FFT_MAXSIZE / n; len >= 4; len >>= 2, stride <<= 2) {
+		quarter = len >> 2;
+
+		for (j = 0; j < quarter; j++) {
+			int32_t c1;
+			int32_t s1;
+			int32_t c2;
+			int32_t s2;
+			int32_t c3;
+			int32_t s3;
+
+			dsp_twiddle(j * stride, &c1, &s1);
+			dsp_twiddle(2 * j * stride, &c2, &s2);
+			dsp_twiddle(3 * j * stride, &c3, &s3);
+
+			/* The inverse transform rotates the other way */
+
+			if (inverse) {
+				s1 = -s1;
+				s2 = -s2;
+				s3 = -s3;
+			}
+
+			for (base = j; base < n; base += len) {
+				FAR q15_t *p0 = &buf[2 * base];
+				FAR q15_t *p1 = p0 + 2 * quarter;
+				FAR q15_t *p2 = p1 + 2 * quarter;
+				FAR q15_t *p3 = p2 + 2 * quarter;
+				int32_t are = (int32_t)p0[0] + p2[0];
+				int32_t aim = (int32_t)p0[1] + p2[1];
+				int32_t bre = (int32_t)p0[0] - p2[0];
+				int32_t bim = (int32_t)p0[1] - p2[1];
+				int32_t cre = (int32_t)p1[0] + p3[0];
+				int32_t cim = (int32_t)p1[1] + p3[1];
+				int32_t dre = (int32_t)p1[0] - p3[0];
+				int32_t dim = (int32_t)p1[1] - p3[1];
+
+				/* -j * d for the forward transform, +j * d for the inverse */
+
+				if (inverse) {
+					int32_t t = dre;
+
+					dre = -dim;
+					dim = t;
+				} else {
+					int32_t t = dre;
+
+					dre = dim;
+					dim = -t;
+				}
+
+				p0[0] = (q15_t)((are + cre) >> 2);
+				p0[1] = (q15_t)((aim + cim) >> 2);
+				dsp_rotate(p1, (bre + dre) >> 2, (bim + dim) >> 2, c1, s1);
+				dsp_rotate(p2, (are - cre) >> 2, (aim - cim) >> 2, c2, s2);
+				dsp_rotate(p3, (bre - dre) >> 2, (bim - dim) >> 2, c3, s3);
+			}
+		}
+	}
+
+	/* The outputs are in base 4 digit reversed order */
+
+	for (i = 1; i < n - 1; i++) {
+		for (r = 0, j = i, k = 0; k < digits; k++, j >>= 2) {
+			r = (r << 2) | (j & 3);
+		}
+
+		if (i < r) {
+			uint32_t t = DSP_PAIR(&buf[2 * i]);
+
+			DSP_SETPAIR(&buf[2 * i], DSP_PAIR(&buf[2 * r]));
+			DSP_SETPAIR(&buf[2 * r], t);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/dsp/lib_dspfir.c
+ *
+ * FIR filters.  The state holds the last ntaps - 1 input samples followed
+ * by room for blocksize new ones, so every output is a plain dot product of
+ * the coefficients with a contiguous window of the state and no circular
+ * indexing is needed in the inner loop.  After each block the history is
+ * moved back to the front.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <dsp.h>
+
+#include "lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void dsp_fir_q15_init(FAR struct dsp_fir_q15_s *fir, uint16_t ntaps, FAR const q15_t *coeffs, FAR q15_t *state, uint16_t blocksize)
+{
+	fir->coeffs = coeffs;
+	fir->state = state;
+	fir->ntaps = ntaps;
+	fir->blocksize = blocksize;
+	memset(state, 0, DSP_FIR_STATE_SIZE(ntaps, blocksize) * sizeof(q15_t));
+}
+
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *src, FAR q15_t *dst, size_t n)
+{
+	FAR const q15_t *coeffs = fir->coeffs;
+	FAR q15_t *state = fir->state;
+	size_t ntaps = fir->ntaps;
+	size_t hist = ntaps - 1;
+	size_t block;
+	size_t i;
+	size_t k;
+
+	while (n > 0) {
+		block = n < fir->blocksize ? n : fir->blocksize;
+		memcpy(&state[hist], src, block * sizeof(q15_t));
+
+		for (i = 0; i < block; i++) {
+			FAR const q15_t *x = &state[i];
+			int64_t acc = 0;
+
+			/* Two taps per multiply-accumulate */
+
+			for (k = 0; k + 1 < ntaps; k += 2) {
+				acc = dsp_smlald(DSP_PAIR(&coeffs[k]), DSP_PAIR(&x[k]), acc);
+			}
+
+			if (k < ntaps) {
+				acc += (int32_t)coeffs[k] * x[k];
+			}
+
+			dst[i] = dsp_sat15((int32_t)(acc >> 15));
+		}
+
+		memmove(state, &state[block], hist * sizeof(q15_t));
+		src += block;
+		dst += block;
+		n -= block;
+	}
+}
+
+void dsp_fir_q31_init(FAR struct dsp_fir_q31_s *fir, uint16_t ntaps, FAR const q31_t *coeffs, FAR q31_t *state, uint16_t blocksize)
+{
+	fir->coeffs = coeffs;
+	fir->state = state;
+	fir->ntaps = ntaps;
+	fir->blocksize = blocksize;
+	memset(state, 0, DSP_FIR_STATE_SIZE(ntaps, blocksize) * sizeof(q31_t));
+}
+
+void dsp_fir_q31(FAR struct dsp_fir_q31_s *fir, FAR const q31_t *src, FAR q31_t *dst, size_t n)
+{
+	FAR const q31_t *coeffs = fir->coeffs;
+	FAR q31_t *state = fir->state;
+	size_t ntaps = fir->ntaps;
+	size_t hist = ntaps - 1;
+	size_t block;
+	size_t i;
+	size_t k;
+
+	while (n > 0) {
+		block = n < fir->blocksize ? n : fir->blocksize;
+		memcpy(&state[hist], src, block * sizeof(q31_t));
+
+		for (i = 0; i < block; i++) {
+			FAR const q31_t *x = &state[i];
+			int64_t acc = 0;
+
+			for (k = 0; k < ntaps; k++) {
+				acc += (int64_t)coeffs[k] * x[k];
+			}
+
+			dst[i] = dsp_sat31(acc >> 31);
+		}
+
+		memmove(state, &state[block], hist * sizeof(q31_t));
+		src += block;
+		dst += block;
+		n -= block;
+	}
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/dsp/lib_dspvector.c
+ *
+ * Saturating element-wise vector operations and dot products.  The Q15
+ * loops handle two samples per word.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <dsp.h>
+
+#include "lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void dsp_add_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst, size_t n)
+{
+	for (; n >= 2; n -= 2, a += 2, b += 2, dst += 2) {
+		DSP_SETPAIR(dst, dsp_qadd16(DSP_PAIR(a), DSP_PAIR(b)));
+	}
+
+	if (n > 0) {
+		*dst = dsp_sat15((int32_t)*a + *b);
+	}
+}
+
+void dsp_add_q31(FAR const q31_t *a, FAR const q31_t *b, FAR q31_t *dst, size_t n)
+{
+	while (n-- > 0) {
+		*dst++ = dsp_qadd(*a++, *b++);
+	}
+}
+
+void dsp_sub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst, size_t n)
+{
+	for (; n >= 2; n -= 2, a += 2, b += 2, dst += 2) {
+		DSP_SETPAIR(dst, dsp_qsub16(DSP_PAIR(a), DSP_PAIR(b)));
+	}
+
+	if (n > 0) {
+		*dst = dsp_sat15((int32_t)*a - *b);
+	}
+}
+
+void dsp_sub_q31(FAR const q31_t *a, FAR const q31_t *b, FAR q31_t *dst, size_t n)
+{
+	while (n-- > 0) {
+		*dst++ = dsp_qsub(*a++, *b++);
+	}
+}
+
+void dsp_scale_q15(FAR const q15_t *src, q15_t scale, int shift, FAR q15_t *dst, size_t n)
+{
+	int rshift = 15 - shift;
+
+	while (n-- > 0) {
+		*dst++ = dsp_sat15(((int32_t)*src++ * scale) >> rshift);
+	}
+}
+
+void dsp_scale_q31(FAR const q31_t *src, q31_t scale, int shift, FAR q31_t *dst, size_t n)
+{
+	int rshift = 31 - shift;
+
+	while (n-- > 0) {
+		*dst++ = dsp_sat31(((int64_t)*src++ * scale) >> rshift);
+	}
+}
+
+int64_t dsp_dot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n)
+{
+	int64_t acc = 0;
+
+	for (; n >= 4; n -= 4, a += 4, b += 4) {
+		acc = dsp_smlald(DSP_PAIR(a), DSP_PAIR(b), acc);
+		acc = dsp_smlald(DSP_PAIR(a + 2), DSP_PAIR(b + 2), acc);
+	}
+
+	while (n-- > 0) {
+		acc += (int32_t)*a++ * *b++;
+	}
+
+	return acc;
+}
+
+int64_t dsp_dot_q31(FAR const q31_t *a, FAR const q31_t *b, size_t n)
+{
+	int64_t acc = 0;
+
+	while (n-- > 0) {
+		acc += ((int64_t)*a++ * *b++) >> 14;
+	}
+
+	return acc;
+}
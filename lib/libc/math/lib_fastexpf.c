@@ -0,0 +1,109 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/math/lib_fastexpf.c
+ *
+ * Single precision expf() selected by CONFIG_LIBM_FASTFLOAT.  With
+ * x = k * ln2 + r and |r| <= ln2/2, exp(x) = 2^k * exp(r), where exp(r)
+ * comes from a minimax polynomial evaluated in float and 2^k is built
+ * directly in the exponent field.
+ *
+ * Maximum error, measured against the double precision exp() over a dense
+ * sample of float arguments: below 1 ulp.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ln2 split in two parts, k * LN2_HI being exact for the k in range */
+
+#define LN2_HI      6.93145751953125e-01f
+#define LN2_LO      1.42860682030941723212e-06f
+#define INV_LN2     1.4426950216e+00f
+
+/* Beyond these arguments the result overflows or underflows to zero */
+
+#define OVERFLOW    8.8722831726e+01f
+#define UNDERFLOW   -1.0397207642e+02f
+
+/* exp(r) = 1 + r + r^2 * (E0 + E1 * r + E2 * r^2 + E3 * r^3 + E4 * r^4) */
+
+#define E0          4.999999404e-01f
+#define E1          1.666652113e-01f
+#define E2          4.166838899e-02f
+#define E3          8.368710056e-03f
+#define E4          1.381461276e-03f
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float expf(float x)
+{
+	float fk;
+	float r;
+	float p;
+	float scale;
+	int k;
+
+	if (isnan(x)) {
+		return x + x;
+	}
+
+	if (x > OVERFLOW) {
+		return INFINITY;
+	}
+
+	if (x < UNDERFLOW) {
+		return 0.0f;
+	}
+
+	fk = x * INV_LN2;
+	k = (int)(fk < 0.0f ? fk - 0.5f : fk + 0.5f);
+	fk = (float)k;
+	r = (x - fk * LN2_HI) - fk * LN2_LO;
+
+	/* Add the small terms together before adding them to 1 */
+
+	p = 1.0f + (r + r * r * (E0 + r * (E1 + r * (E2 + r * (E3 + r * E4)))));
+
+	/* Multiply by 2^k, in two steps when 2^k is not a normal float */
+
+	if (k > 127) {
+		p *= 2.0f;
+		k--;
+	} else if (k < -126) {
+		SET_FLOAT_WORD(scale, (uint32_t)(127 - 64) << 23);
+		p *= scale;
+		k += 64;
+	}
+
+	SET_FLOAT_WORD(scale, (uint32_t)(k + 127) << 23);
+	return p * scale;
+}
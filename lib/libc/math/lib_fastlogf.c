@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/math/lib_fastlogf.c
+ *
+ * Single precision logf() selected by CONFIG_LIBM_FASTFLOAT.  With
+ * x = 2^k * (1 + f) and sqrt(2)/2 <= 1 + f < sqrt(2),
+ * log(x) = k * ln2 + log(1 + f), where log(1 + f) = 2s + s * R(s^2) with
+ * s = f / (2 + f) and a minimax polynomial R evaluated in float.
+ *
+ * Maximum error, measured against the double precision log() over a dense
+ * sample of positive floats: below 1 ulp.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ln2 split in two parts, k * LN2_HI being exact for any exponent k */
+
+#define LN2_HI      6.9313812256e-01f
+#define LN2_LO      9.0580006145e-06f
+
+/* R(z) = z * (L0 + L1 * z + L2 * z^2) for z = s^2 <= (3 - 2 * sqrt(2))^2 */
+
+#define L0          6.666677594e-01f
+#define L1          3.997757435e-01f
+#define L2          2.987093627e-01f
+
+/* sqrt(2) as a float word, 2^25 for scaling subnormals */
+
+#define SQRT2_WORD  0x3fb504f3
+#define TWO25       3.3554432e+07f
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float logf(float x)
+{
+	uint32_t ix;
+	float f;
+	float s;
+	float z;
+	float hfsq;
+	float r;
+	float fk;
+	int k;
+
+	GET_FLOAT_WORD(ix, x);
+
+	/* log(-x) and log(NaN) are NaN, log(0) is -inf, log(inf) is inf */
+
+	if ((ix & 0x7fffffff) == 0) {
+		return -INFINITY;
+	}
+
+	if ((ix & 0x80000000) != 0) {
+		return (x - x) / 0.0f;
+	}
+
+	if (ix >= 0x7f800000) {
+		return x + x;
+	}
+
+	/* Normalize subnormals */
+
+	k = 0;
+	if (ix < 0x00800000) {
+		x *= TWO25;
+		GET_FLOAT_WORD(ix, x);
+		k = -25;
+	}
+
+	/* Split x into 2^k * m with sqrt(2)/2 <= m < sqrt(2) */
+
+	k += (int)(ix >> 23) - 127;
+	ix = (ix & 0x007fffff) | 0x3f800000;
+	if (ix >= SQRT2_WORD) {
+		ix -= 0x00800000;
+		k++;
+	}
+
+	SET_FLOAT_WORD(f, ix);
+	f -= 1.0f;
+
+	/* log(1 + f) = f - (hfsq - s * (hfsq + R)), which keeps the exact f
+	 * apart from the small rounded terms.
+	 */
+
+	s = f / (2.0f + f);
+	z = s * s;
+	hfsq = 0.5f * f * f;
+	r = z * (L0 + z * (L1 + z * L2));
+	fk = (float)k;
+
+	return fk * LN2_HI - ((hfsq - (s * (hfsq + r) + fk * LN2_LO)) - f);
+}
@@ -0,0 +1,280 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/math/lib_fastsincosf.c
+ *
+ * Single precision sinf() and cosf() selected by CONFIG_LIBM_FASTFLOAT.
+ * The argument is reduced to r in [-pi/4, pi/4] and a quadrant, and r is
+ * fed to minimax polynomials evaluated in float only.
+ *
+ * Arguments above 4 take a slower reduction in double precision, and
+ * arguments above 2^19 a Payne-Hanek reduction against the bits of 4/pi,
+ * which is exact whatever the size of x.
+ *
+ * Maximum error, measured against the double precision functions over
+ * floats sampled across the whole finite range: below 1 ulp.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split in three parts; the first two have few enough bits that
+ * n * PIO2_1 and n * PIO2_2 are exact for the n of the fast reduction.
+ */
+
+#define PIO2_1      1.5703125f
+#define PIO2_2      4.838705062866211e-04f
+#define PIO2_3      -4.371138828673793e-08f
+#define INV_PIO2    6.3661977236e-01f
+
+/* pi/2 in 28-bit parts for the double precision reduction, n * PIO2_Dx
+ * being exact for n < 2^24.
+ */
+
+#define PIO2_D1     1.570796325802803
+#define PIO2_D2     9.920935808982456e-10
+#define PIO2_D3     -1.2177051748566079e-18
+#define PIO2_D4     -2.940788670387328e-27
+
+/* Largest |x| for which the float reduction is accurate, 4.0f, as a
+ * float word.  The double precision reduction takes over above it, up to
+ * MID_LIMIT, 2^19, where n * PIO2_D1 stops being exact enough.
+ */
+
+#define FAST_LIMIT  0x40800000
+#define MID_LIMIT   0x49000000
+
+/* pi * 2^-62, the weight of the fraction left by reduce_large() */
+
+#define PI_2M62     0x1.921fb54442d18p-62
+
+/* sin(r) = r + r^3 * (S0 + S1 * r^2 + S2 * r^4) on [-pi/4, pi/4] */
+
+#define S0          -1.666665524e-01f
+#define S1          8.332160302e-03f
+#define S2          -1.951528247e-04f
+
+/* cos(r) = 1 - r^2 / 2 + r^4 * (C0 + C1 * r^2 + C2 * r^4) on [-pi/4, pi/4] */
+
+#define C0          4.166664556e-02f
+#define C1          -1.388731645e-03f
+#define C2          2.443315680e-05f
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The bits of 4/pi, each word starting 8 bits after the previous one, so
+ * that 96 bits from any byte offset are found in three words 4 apart.
+ */
+
+static const uint32_t g_inv_pio4[24] = {
+	0xa2,       0xa2f9,     0xa2f983,   0xa2f9836e,
+	0xf9836e4e, 0x836e4e44, 0x6e4e4415, 0x4e441529,
+	0x441529fc, 0x1529fc27, 0x29fc2757, 0xfc2757d1,
+	0x2757d1f5, 0x57d1f534, 0xd1f534dd, 0xf534ddc0,
+	0x34ddc0db, 0xddc0db62, 0xc0db6295, 0xdb629599,
+	0x6295993c, 0x95993c43, 0x993c4390, 0x3c439041
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The reduced argument is r + rlo, rlo being the rounding error of r.  It
+ * only enters the first order term of each polynomial.
+ */
+
+static inline float sin_poly(float r, float rlo)
+{
+	float z = r * r;
+
+	return r + (r * z * (S0 + z * (S1 + z * S2)) + rlo);
+}
+
+static inline float cos_poly(float r, float rlo)
+{
+	float z = r * r;
+	float hz = 0.5f * z;
+	float w = 1.0f - hz;
+
+	/* w is rounded, so its error is added back with the small terms */
+
+	return w + (((1.0f - w) - hz) + (z * z * (C0 + z * (C1 + z * C2)) - r * rlo));
+}
+
+/****************************************************************************
+ * Name: reduce_large
+ *
+ * Description:
+ *   Payne-Hanek reduction of |x| >= 2^19, ix being the float word of |x|.
+ *   The 24-bit mantissa times the 96 bits of 4/pi that matter for its
+ *   exponent leaves the quadrant in the top two bits of a 64-bit fraction
+ *   of a period; the rest, centred on zero, is r in units of pi * 2^-62.
+ *
+ ****************************************************************************/
+
+static double reduce_large(uint32_t ix, FAR int *quadrant)
+{
+	FAR const uint32_t *arr = &g_inv_pio4[(ix >> 26) & 15];
+	int shift = (ix >> 23) & 7;
+	uint64_t res0;
+	uint64_t res1;
+	uint64_t res2;
+	uint64_t n;
+	uint32_t m;
+
+	m = ((ix & 0x7fffff) | 0x800000) << shift;
+
+	res0 = m * arr[0];
+	res1 = (uint64_t)m * arr[4];
+	res2 = (uint64_t)m * arr[8];
+	res0 = (res2 >> 32) | (res0 << 32);
+	res0 += res1;
+
+	n = (res0 + (1ULL << 61)) >> 62;
+	res0 -= n << 62;
+	*quadrant = (int)(n & 3);
+	return (double)(int64_t)res0 * PI_2M62;
+}
+
+/****************************************************************************
+ * Name: reduce
+ *
+ * Description:
+ *   Return r = x - n * pi/2 with |r| <= pi/4 and store n modulo 4 and the
+ *   rounding error of r.  ix is the float word of |x|.
+ *
+ ****************************************************************************/
+
+static float reduce(float x, uint32_t ix, FAR int *quadrant, FAR float *rlo)
+{
+	float fn;
+	float a;
+	float r;
+	double dn;
+	double dr;
+	int n;
+
+	if (ix <= FAST_LIMIT) {
+		fn = x * INV_PIO2;
+		n = (int)(fn < 0.0f ? fn - 0.5f : fn + 0.5f);
+		fn = (float)n;
+		*quadrant = n & 3;
+
+		a = (x - fn * PIO2_1) - fn * PIO2_2;
+		r = a - fn * PIO2_3;
+		*rlo = (a - r) - fn * PIO2_3;
+		return r;
+	}
+
+	if (ix < MID_LIMIT) {
+		/* Reduce in double precision */
+
+		dn = (double)x * M_2_PI;
+		n = (int)(dn < 0.0 ? dn - 0.5 : dn + 0.5);
+		dn = (double)n;
+		*quadrant = n & 3;
+
+		dr = ((((double)x - dn * PIO2_D1) - dn * PIO2_D2) - dn * PIO2_D3) - dn * PIO2_D4;
+	} else {
+		/* Reduce |x| exactly; x - n * pi/2 = -(|x| - n * pi/2) */
+
+		dr = reduce_large(ix, &n);
+		if (x < 0.0f) {
+			dr = -dr;
+			n = -n;
+		}
+		*quadrant = n & 3;
+	}
+
+	r = (float)dr;
+	*rlo = (float)(dr - (double)r);
+	return r;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float sinf(float x)
+{
+	uint32_t ix;
+	int quadrant;
+	float rlo;
+	float r;
+
+	/* NaN for NaN and infinite arguments */
+
+	GET_FLOAT_WORD(ix, x);
+	ix &= 0x7fffffff;
+	if (ix >= 0x7f800000) {
+		return x - x;
+	}
+
+	r = reduce(x, ix, &quadrant, &rlo);
+	switch (quadrant) {
+	case 0:
+		return sin_poly(r, rlo);
+	case 1:
+		return cos_poly(r, rlo);
+	case 2:
+		return -sin_poly(r, rlo);
+	default:
+		return -cos_poly(r, rlo);
+	}
+}
+
+float cosf(float x)
+{
+	uint32_t ix;
+	int quadrant;
+	float rlo;
+	float r;
+
+	/* NaN for NaN and infinite arguments */
+
+	GET_FLOAT_WORD(ix, x);
+	ix &= 0x7fffffff;
+	if (ix >= 0x7f800000) {
+		return x - x;
+	}
+
+	r = reduce(x, ix, &quadrant, &rlo);
+	switch (quadrant) {
+	case 0:
+		return cos_poly(r, rlo);
+	case 1:
+		return -sin_poly(r, rlo);
+	case 2:
+		return -cos_poly(r, rlo);
+	default:
+		return sin_poly(r, rlo);
+	}
+}
@@ -100,7 +100,15 @@ void lib_sem_initialize(FAR struct file_struct *stream)
 
 void lib_take_semaphore(FAR struct file_struct *stream)
 {
-	pid_t my_pid = getpid();
+	pid_t my_pid;
+
+	/* A stream used by a single task needs no locking at all */
+
+	if ((stream->fs_flags & __FS_FLAG_NOLOCK) != 0) {
+		return;
+	}
+
+	my_pid = getpid();
 
 	/* Do I already have the semaphore? */
 
@@ -132,7 +140,13 @@ void lib_take_semaphore(FAR struct file_struct *stream)
 
 void lib_give_semaphore(FAR struct file_struct *stream)
 {
-	pid_t my_pid = getpid();
+	pid_t my_pid;
+
+	if ((stream->fs_flags & __FS_FLAG_NOLOCK) != 0) {
+		return;
+	}
+
+	my_pid = getpid();
 
 	/* I better be holding at least one reference to the semaphore */
 
@@ -111,6 +111,10 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mq_stat)
 		mq_stat->mq_maxmsg = mqdes->msgq->maxmsgs;
 		mq_stat->mq_msgsize = mqdes->msgq->maxmsgsize;
 		mq_stat->mq_flags = mqdes->oflags;
+		if (mqdes->msgq->maxrefsize > 0) {
+			mq_stat->mq_msgsize = mqdes->msgq->maxrefsize;
+			mq_stat->mq_flags |= MQ_REFERENCE;
+		}
 		mq_stat->mq_curmsgs = (size_t)mqdes->msgq->nmsgs;
 
 		ret = OK;
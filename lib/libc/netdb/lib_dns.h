@@ -62,6 +62,7 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <sys/socket.h>
@@ -92,10 +93,22 @@
 #define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 30
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT
+#define CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT 10
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
 
+/* The maximum number of name servers queried at the same time */
+
+#define DNS_MAX_NAMESERVERS 4
+
 #define DNS_MAX_ADDRSTR   48
 #define DNS_MAX_LINE      64
 #define NETDB_DNS_KEYWORD "nameserver"
@@ -117,6 +130,21 @@ struct sockaddr_in6 ipv6;	/* IPv6 address */
 #endif
 };
 
+/* The state of one lookup, see dns_query_start() */
+
+struct dns_query_s {
+	int sd;						/* DNS resolver socket */
+	uint16_t id;				/* ID of the queries */
+	uint8_t attempt;			/* Number of times the queries were sent, less one */
+	uint8_t npending;			/* Queries of this attempt not answered yet */
+	uint8_t nnegative;			/* Answers that the name has no address */
+	int result;					/* Explanation of the last failure */
+	uint32_t deadline;			/* Time (ms) to send the queries again */
+	int nservers;				/* Number of name servers */
+	union dns_server_u servers[DNS_MAX_NAMESERVERS];
+	char hostname[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -211,16 +239,36 @@ int dns_bind(void);
 
 int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr, FAR socklen_t *addrlen);
 
+/****************************************************************************
+ * Name: dns_query_start, dns_query_process and dns_query_timeout
+ *
+ * Description:
+ *   dns_query() in steps, so that a lookup can progress from an event loop
+ *   without blocking: dns_query_start() sends the queries, then
+ *   dns_query_process() with 'wait' false is called when query->sd is
+ *   readable or dns_query_timeout() milliseconds have passed, until it
+ *   returns something else than -EINPROGRESS.
+ *
+ ****************************************************************************/
+
+int dns_query_start(FAR struct dns_query_s *query, int sd, FAR const char *hostname);
+int dns_query_process(FAR struct dns_query_s *query, FAR struct sockaddr *addr, FAR socklen_t *addrlen, bool wait);
+int dns_query_timeout(FAR struct dns_query_s *query);
+
 /****************************************************************************
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save a resolved hostname, or the failure to resolve it, in the DNS
+ *   cache.
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
- *   addr     - The IP address associated with the hostname
+ *   addr     - The IP address associated with the hostname, or NULL if
+ *              the name servers reported that it does not resolve.
  *   addrlen  - The size of the of the IP address.
+ *   ttl      - Time to live of the answer in seconds.  It is limited to
+ *              CONFIG_NETDB_DNSCLIENT_LIFESEC if that is not zero.
  *
  * Returned Value:
  *   None
@@ -228,7 +276,7 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr, FAR s
  ****************************************************************************/
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr, socklen_t addrlen);
+void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr, socklen_t addrlen, uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -248,8 +296,9 @@ void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr,
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -EADDRNOTAVAIL if the cache records that the
+ *   hostname does not resolve.
  *
  ****************************************************************************/
 
@@ -57,8 +57,10 @@
 #include <tinyara/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -78,17 +80,26 @@
 #define DNS_CLOCK CLOCK_REALTIME
 #endif
 
+/* One hash bucket per entry.  Buckets and chain links hold an entry index
+ * plus one so that zero marks the end of a chain.
+ */
+
+#define DNS_CACHE_NBUCKETS CONFIG_NETDB_DNSCLIENT_ENTRIES
+#define DNS_CACHE_NONE     0
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames */
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * with an AF_UNSPEC address records that the name did not resolve.
+ */
 
 struct dns_cache_s {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-	time_t ctime;				/* Creation time */
-#endif
-	char name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+	uint32_t expiry;			/* Time at which the entry becomes stale */
+	uint8_t next;				/* Next entry in the hash chain */
+	uint8_t bucket;				/* Hash bucket the entry is linked in */
+	char name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];	/* Empty if the entry is free */
 	union dns_server_u addr;	/* Resolved address */
 };
 
@@ -96,8 +107,9 @@ struct dns_cache_s {
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;		/* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;		/* Tail of the circular, DNS resolver cache */
+/* Heads of the hash chains */
+
+static uint8_t g_dns_buckets[DNS_CACHE_NBUCKETS];
 
 /* This is the DNS resolver cache */
 
@@ -107,6 +119,96 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_now
+ *
+ * Description:
+ *   Return the current time in seconds, using CLOCK_MONOTONIC if possible
+ *
+ ****************************************************************************/
+
+static uint32_t dns_now(void)
+{
+	struct timespec now;
+
+	if (clock_gettime(DNS_CLOCK, &now) < 0) {
+		return 0;
+	}
+
+	return (uint32_t)now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_hash
+ *
+ * Description:
+ *   FNV-1a hash of a host name, reduced to a bucket index
+ *
+ ****************************************************************************/
+
+static uint8_t dns_hash(FAR const char *hostname)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*hostname != '\0') {
+		hash ^= (uint8_t)*hostname++;
+		hash *= 16777619u;
+	}
+
+	return (uint8_t)(hash % DNS_CACHE_NBUCKETS);
+}
+
+/****************************************************************************
+ * Name: dns_unlink
+ *
+ * Description:
+ *   Remove an entry from its hash chain and mark it free
+ *
+ ****************************************************************************/
+
+static void dns_unlink(int ndx)
+{
+	FAR struct dns_cache_s *entry = &g_dns_cache[ndx];
+	FAR uint8_t *link = &g_dns_buckets[entry->bucket];
+
+	while (*link != ndx + 1) {
+		DEBUGASSERT(*link != DNS_CACHE_NONE);
+		link = &g_dns_cache[*link - 1].next;
+	}
+
+	*link = entry->next;
+	entry->name[0] = '\0';
+}
+
+/****************************************************************************
+ * Name: dns_lookup
+ *
+ * Description:
+ *   Find the entry of a host name, dropping the stale entries met on the
+ *   way.  Returns the entry index or -1.
+ *
+ ****************************************************************************/
+
+static int dns_lookup(FAR const char *hostname, uint8_t bucket, uint32_t now)
+{
+	FAR struct dns_cache_s *entry;
+	uint8_t link;
+	int ndx;
+
+	for (link = g_dns_buckets[bucket]; link != DNS_CACHE_NONE; link = entry->next) {
+		ndx = link - 1;
+		entry = &g_dns_cache[ndx];
+
+		if ((int32_t)(entry->expiry - now) <= 0) {
+			dns_unlink(ndx);
+		} else if (strcmp(hostname, entry->name) == 0) {
+			return ndx;
+		}
+	}
+
+	return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -115,69 +217,91 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save a resolved hostname, or the failure to resolve it, in the DNS
+ *   cache.
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
- *   addr     - The IP address associated with the hostname
+ *   addr     - The IP address associated with the hostname, or NULL if
+ *              the name servers reported that it does not resolve.
  *   addrlen  - The size of the of the IP address.
+ *   ttl      - Time to live of the answer in seconds.  It is limited to
+ *              CONFIG_NETDB_DNSCLIENT_LIFESEC if that is not zero.
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr, socklen_t addrlen)
+void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr, socklen_t addrlen, uint32_t ttl)
 {
 	FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-	struct timespec now;
-#endif
-	int next;
+	uint32_t now;
+	uint8_t bucket;
 	int ndx;
+	int i;
 
-	/* Get exclusive access to the DNS cache */
+	/* Names that do not fit are not cached rather than aliased */
 
-	dns_semtake();
+	DEBUGASSERT(hostname != NULL);
+	if (strlen(hostname) >= CONFIG_NETDB_DNSCLIENT_NAMESIZE || addrlen > sizeof(union dns_server_u)) {
+		return;
+	}
 
-	/* Get the index to the new head of the list */
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+	if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC) {
+		ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+	}
+#endif
 
-	ndx = g_dns_head;
-	next = ndx + 1;
-	if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES) {
-		next = 0;
+	if (ttl == 0) {
+		return;
 	}
 
-	/* If the next head pointer would match the tail index, then increment
-	 * the tail index, discarding the oldest mapping in the cache.
-	 */
+	bucket = dns_hash(hostname);
+	now = dns_now();
 
-	if (next == g_dns_tail) {
-		int tmp = g_dns_tail + 1;
-		if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES) {
-			tmp = 0;
-		}
+	/* Get exclusive access to the DNS cache */
 
-		g_dns_tail = tmp;
-	}
+	dns_semtake();
 
-	/* Save the answer in the cache */
+	/* Replace the entry of the same name, else use a free entry, else the
+	 * one that expires first.
+	 */
 
-	entry = &g_dns_cache[ndx];
+	ndx = dns_lookup(hostname, bucket, now);
+	if (ndx < 0) {
+		for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++) {
+			if (g_dns_cache[i].name[0] == '\0') {
+				ndx = i;
+				break;
+			}
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-	/* Get the current time, using CLOCK_MONOTONIC if possible */
+			if (ndx < 0 || (int32_t)(g_dns_cache[i].expiry - g_dns_cache[ndx].expiry) < 0) {
+				ndx = i;
+			}
+		}
 
-	(void)clock_gettime(DNS_CLOCK, &now);
-	entry->ctime = (time_t)now.tv_sec;
-#endif
-	assert((hostname != NULL) && (strlen(hostname) < CONFIG_NETDB_DNSCLIENT_NAMESIZE))
-	strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
-	memcpy(&entry->addr.addr, addr, addrlen);
+		if (g_dns_cache[ndx].name[0] != '\0') {
+			dns_unlink(ndx);
+		}
 
-	/* Save the updated head index */
+		entry = &g_dns_cache[ndx];
+		entry->bucket = bucket;
+		entry->next = g_dns_buckets[bucket];
+		g_dns_buckets[bucket] = ndx + 1;
+		strcpy(entry->name, hostname);
+	} else {
+		entry = &g_dns_cache[ndx];
+	}
+
+	entry->expiry = now + ttl;
+	if (addr != NULL) {
+		memcpy(&entry->addr.addr, addr, addrlen);
+	} else {
+		entry->addr.addr.sa_family = AF_UNSPEC;
+	}
 
-	g_dns_head = next;
 	dns_semgive();
 }
 
@@ -198,21 +322,18 @@ void dns_save_answer(FAR const char *hostname, FAR const struct sockaddr *addr,
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -EADDRNOTAVAIL if the cache records that the
+ *   hostname does not resolve.
  *
  ****************************************************************************/
 
 int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr, FAR socklen_t *addrlen)
 {
 	FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-	struct timespec now;
-	uint32_t elapsed;
-	int ret;
-#endif
-	int next;
+	socklen_t inlen;
 	int ndx;
+	int ret;
 
 	/* If DNS not initialized, no need to proceed */
 
@@ -221,94 +342,51 @@ int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr, FAR soc
 		return -EAGAIN;
 	}
 
+	if (strlen(hostname) >= CONFIG_NETDB_DNSCLIENT_NAMESIZE) {
+		return -ENOENT;
+	}
+
 	/* Get exclusive access to the DNS cache */
 
 	dns_semtake();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-	/* Get the current time, using CLOCK_MONOTONIC if possible */
-
-	ret = clock_gettime(DNS_CLOCK, &now);
-#endif
-
-	/* REVISIT: This is not thread safe */
-
-	for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next) {
-		entry = &g_dns_cache[ndx];
-
-		/* Advance the index for the next time through the loop, handling
-		 * wrapping to the beginning of the circular buffer.
-		 */
-
-		next = ndx + 1;
-		if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES) {
-			next = 0;
-		}
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-		/* Check if this entry has expired
-		 * REVISIT: Does not this calculation assume that the sizeof(time_t)
-		 * is equal to the sizeof(uint32_t)?
-		 */
-
-		elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-		if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC) {
-			/* This entry has expired.  Increment the tail index to exclude
-			 * this entry on future traversals.
-			 */
-
-			g_dns_tail = next;
-		} else
-#endif
-		{
-			/* The entry has not expired, check for a name match.  Notice that
-			 * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-			 * this has the possibility of aliasing two names and returning
-			 * the wrong entry from the cache.
-			 */
-
-			if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0) {
-				socklen_t inlen;
+	ndx = dns_lookup(hostname, dns_hash(hostname), dns_now());
+	if (ndx < 0) {
+		ret = -ENOENT;
+		goto errout_with_sem;
+	}
 
-				/* We have a match.  Return the resolved host address */
+	entry = &g_dns_cache[ndx];
 
 #ifdef CONFIG_NET_IPv4
-				if (entry->addr.addr.sa_family == AF_INET)
-#ifdef CONFIG_NET_IPv6
-#endif
-				{
-					inlen = sizeof(struct sockaddr_in);
-				}
+	if (entry->addr.addr.sa_family == AF_INET) {
+		inlen = sizeof(struct sockaddr_in);
+	} else
 #endif
-
 #ifdef CONFIG_NET_IPv6
-				else
-#ifdef CONFIG_NET_IPv4
-#endif
-				{
-					inlen = sizeof(struct sockaddr_in6);
-				}
+	if (entry->addr.addr.sa_family == AF_INET6) {
+		inlen = sizeof(struct sockaddr_in6);
+	} else
 #endif
-				/* Make sure that the address will fit in the caller-provided
-				 * buffer.
-				 */
+	{
+		/* A cached negative answer */
 
-				if (*addrlen < inlen) {
-					ret = -ERANGE;
-					goto errout_with_sem;
-				}
-
-				/* Return the address information */
+		ret = -EADDRNOTAVAIL;
+		goto errout_with_sem;
+	}
 
-				memcpy(addr, &entry->addr.addr, inlen);
-				*addrlen = inlen;
+	/* Make sure that the address will fit in the caller-provided buffer. */
 
-				dns_semgive();
-				return OK;
-			}
-		}
+	if (*addrlen < inlen) {
+		ret = -ERANGE;
+		goto errout_with_sem;
 	}
 
-	ret = -ENOENT;
+	/* Return the address information */
+
+	memcpy(addr, &entry->addr.addr, inlen);
+	*addrlen = inlen;
+	ret = OK;
 
 errout_with_sem:
 	dns_semgive();
@@ -63,7 +63,9 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -77,9 +79,9 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* The maximum number of retries when asking for a name */
+/* The number of times the queries are sent again when no server answers */
 
-#define MAX_RETRIES      8
+#define MAX_ATTEMPTS     3
 
 /* Buffer sizes */
 /*
@@ -89,28 +91,55 @@
 #define SEND_BUFFER_SIZE (32 + CONFIG_NETDB_DNSCLIENT_NAMESIZE)
 #define RECV_BUFFER_SIZE CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 
-/****************************************************************************
- * Private Types
- ****************************************************************************/
+/* Use clock monotonic, if possible */
 
-struct dns_query_s {
-	int sd;						/* DNS server socket */
-	int result;					/* Explanation of the failure */
-	FAR const char *hostname;	/* Hostname to lookup */
-	FAR struct sockaddr *addr;	/* Location to return host address */
-	FAR socklen_t *addrlen;		/* Length of the address */
-};
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define DNS_CLOCK CLOCK_MONOTONIC
+#else
+#define DNS_CLOCK CLOCK_REALTIME
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_seqno;			/* Sequence number of the next request */
+static uint16_t g_seqno;		/* Sequence number of the next request */
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+/* The record types asked for each name, queried at the same time */
+
+static const uint16_t g_dns_rectypes[] = {
+#ifdef CONFIG_NET_IPv4
+	DNS_RECTYPE_A,
+#endif
+#ifdef CONFIG_NET_IPv6
+	DNS_RECTYPE_AAAA,
+#endif
+};
+
+#define DNS_NRECTYPES (sizeof(g_dns_rectypes) / sizeof(g_dns_rectypes[0]))
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_now_ms
+ *
+ * Description:
+ *   Return the current time in milliseconds, wrapping around
+ *
+ ****************************************************************************/
+
+static uint32_t dns_now_ms(void)
+{
+	struct timespec now;
+
+	(void)clock_gettime(DNS_CLOCK, &now);
+	return (uint32_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 /****************************************************************************
  * Name: dns_parse_name
  *
@@ -139,35 +168,27 @@ static FAR uint8_t *dns_parse_name(FAR uint8_t *query)
  * Name: dns_send_query
  *
  * Description:
- *   Runs through the list of names to see if there are any that have
- *   not yet been queried and, if so, sends out a query.
+ *   Send a query for one record type of a name to one name server.
  *
  ****************************************************************************/
 
-static int dns_send_query(int sd, FAR const char *name, FAR union dns_server_u *uaddr, uint16_t rectype)
+static int dns_send_query(int sd, FAR const char *name, FAR union dns_server_u *uaddr, uint16_t rectype, uint16_t id)
 {
 	register FAR struct dns_header_s *hdr;
 	FAR uint8_t *dest;
 	FAR uint8_t *nptr;
 	FAR const char *src;
 	uint8_t buffer[SEND_BUFFER_SIZE];
-	uint8_t seqno;
 	socklen_t addrlen;
 	int errcode;
 	int ret;
 	int n;
 
-	/* Increment the sequence number */
-
-	dns_semtake();
-	seqno = g_seqno++;
-	dns_semgive();
-
 	/* Initialize the request header */
 
 	hdr = (FAR struct dns_header_s *)buffer;
 	memset(hdr, 0, sizeof(struct dns_header_s));
-	hdr->id = htons(seqno);
+	hdr->id = htons(id);
 	hdr->flags1 = DNS_FLAG1_RD;
 	hdr->numquestions = HTONS(1);
 	dest = buffer + 12;
@@ -201,22 +222,18 @@ static int dns_send_query(int sd, FAR const char *name, FAR union dns_server_u *
 	/* Send the request */
 
 #ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-	if (uaddr->addr.sa_family == AF_INET)
-#endif
-	{
+	if (uaddr->addr.sa_family == AF_INET) {
 		addrlen = sizeof(struct sockaddr_in);
-	}
+	} else
 #endif
-
 #ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-	else
+	if (uaddr->addr.sa_family == AF_INET6) {
+		addrlen = sizeof(struct sockaddr_in6);
+	} else
 #endif
 	{
-		addrlen = sizeof(struct sockaddr_in6);
+		return -EAFNOSUPPORT;
 	}
-#endif
 
 	ret = sendto(sd, buffer, dest - buffer, 0, &uaddr->addr, addrlen);
 
@@ -235,42 +252,56 @@ static int dns_send_query(int sd, FAR const char *name, FAR union dns_server_u *
  * Name: dns_recv_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Receive one response.  Returns OK with the first address found and
+ *   its time to live, -ESRCH if the packet does not answer query 'id',
+ *   -EADDRNOTAVAIL if the server reports that the name has no address of
+ *   the type asked, or another negated errno value on failure.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *addrlen)
+static int dns_recv_response(int sd, uint16_t id, FAR struct sockaddr *addr, FAR socklen_t *addrlen, FAR uint32_t *ttl, int flags)
 {
 	FAR uint8_t *nameptr;
 	char buffer[RECV_BUFFER_SIZE];
 	FAR struct dns_answer_s *ans;
 	FAR struct dns_header_s *hdr;
-#if 0							/* Not used */
-	uint8_t nquestions;
-#endif
 	uint8_t nanswers;
 	int errcode;
 	int ret;
 
 	/* Receive the response */
 
-	ret = recv(sd, buffer, RECV_BUFFER_SIZE, 0);
+	ret = recv(sd, buffer, RECV_BUFFER_SIZE, flags);
 	if (ret < 0) {
 		errcode = get_errno();
+		if (errcode == EWOULDBLOCK) {
+			return -EAGAIN;
+		}
+
 		ndbg("ERROR: recv failed: %d\n", errcode);
 		return -errcode;
 	}
 
 	hdr = (FAR struct dns_header_s *)buffer;
 
+	/* Discard anything that is not a response to this query, for example a
+	 * late answer to an earlier one.
+	 */
+
+	if (ret < sizeof(struct dns_header_s) || (hdr->flags1 & DNS_FLAG1_RESPONSE) == 0 || htons(hdr->id) != id) {
+		nvdbg("Ignoring packet of %d bytes\n", ret);
+		return -ESRCH;
+	}
+
 	nvdbg("ID %d\n", htons(hdr->id));
-	nvdbg("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
 	nvdbg("Error %d\n", hdr->flags2 & DNS_FLAG2_ERR_MASK);
 	nvdbg("Num questions %d, answers %d, authrr %d, extrarr %d\n", htons(hdr->numquestions), htons(hdr->numanswers), htons(hdr->numauthrr), htons(hdr->numextrarr));
 
-	/* Check for error */
+	/* Check for error.  A name error means that the name does not exist. */
 
-	if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0) {
+	if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME) {
+		return -EADDRNOTAVAIL;
+	} else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0) {
 		ndbg("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
 		return -EPROTO;
 	}
@@ -279,9 +310,6 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
 	 * and the extrarr are simply discarded.
 	 */
 
-#if 0							/* Not used */
-	nquestions = htons(hdr->numquestions);
-#endif
 	nanswers = htons(hdr->numanswers);
 
 	/* Skip the name in the question. TODO: This should really be
@@ -289,23 +317,6 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
 	 * match.
 	 */
 
-#ifdef CONFIG_DEBUG_NET
-	{
-		int d = 64;
-		nameptr = dns_parse_name((uint8_t *)buffer + 12) + 4;
-
-		for (;;) {
-			ndbg("%02X %02X %02X %02X %02X %02X %02X %02X \n", nameptr[0], nameptr[1], nameptr[2], nameptr[3], nameptr[4], nameptr[5], nameptr[6], nameptr[7]);
-
-			nameptr += 8;
-			d -= 8;
-			if (d < 0) {
-				break;
-			}
-		}
-	}
-#endif
-
 	nameptr = dns_parse_name((uint8_t *)buffer + 12) + 4;
 
 	for (; nanswers > 0; nanswers--) {
@@ -325,8 +336,9 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
 		}
 
 		ans = (FAR struct dns_answer_s *)nameptr;
+		*ttl = ((uint32_t)htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]);
 
-		nvdbg("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x \n", htons(ans->type), htons(ans->class), (htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]), htons(ans->len));
+		nvdbg("Answer: type=%04x, class=%04x, ttl=%06lx, length=%04x \n", htons(ans->type), htons(ans->class), (unsigned long)*ttl, htons(ans->len));
 
 		/* Check for IPv4/6 address type and Internet class. Others are discarded. */
 
@@ -361,7 +373,7 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
 					FAR struct sockaddr_in6 *inaddr;
 
 					inaddr = (FAR struct sockaddr_in6 *)addr;
-					inaddr->sin6_family = AF_INET;
+					inaddr->sin6_family = AF_INET6;
 					inaddr->sin6_port = 0;
 					memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
@@ -384,8 +396,7 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
  * Name: dns_query_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the the
- *   hostname.
+ *   Collect the address of one name server.
  *
  * Input Parameters:
  *   arg      - Query arguements
@@ -393,194 +404,223 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr, FAR socklen_t *a
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal once DNS_MAX_NAMESERVERS have
+ *   been collected, zero otherwise.
  *
  ****************************************************************************/
 
 static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr, FAR socklen_t addrlen)
 {
-#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
 	FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-	int retries;
-	int ret;
-
-	/* Loop while receive timeout errors occur and there are remaining retries */
-
-	for (retries = 0; retries < 3; retries++) {
-#ifdef CONFIG_NET_IPv4
-		/* Is this an IPv4 address? */
 
-		if (addr->sa_family == AF_INET) {
-			/* Yes.. verify the address size */
+	if (addrlen > sizeof(union dns_server_u)) {
+		ndbg("ERROR: Invalid address size: %d\n", addrlen);
+		return 0;
+	}
 
-			if (addrlen < sizeof(struct sockaddr_in)) {
-				/* Return zero to skip this address and try the next
-				 * namserver address in resolv.conf.
-				 */
+	memcpy(&query->servers[query->nservers], addr, addrlen);
+	query->nservers++;
 
-				ndbg("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-				query->result = -EINVAL;
-				return 0;
-			}
+	return query->nservers >= DNS_MAX_NAMESERVERS ? 1 : 0;
+}
 
-			/* Send the IPv4 query */
+/****************************************************************************
+ * Name: dns_query_send
+ *
+ * Description:
+ *   Send the queries of one attempt to every name server and restart the
+ *   response timeout.  Answers to earlier attempts carry the same ID and
+ *   are still accepted.
+ *
+ ****************************************************************************/
 
-			ret = dns_send_query(query->sd, query->hostname, (FAR union dns_server_u *)addr, DNS_RECTYPE_A);
+static int dns_query_send(FAR struct dns_query_s *query)
+{
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+	int ret;
+	int i;
+	int j;
+
+	query->npending = 0;
+	query->nnegative = 0;
+	for (i = 0; i < query->nservers; i++) {
+		for (j = 0; j < DNS_NRECTYPES; j++) {
+			ret = dns_send_query(query->sd, query->hostname, &query->servers[i], g_dns_rectypes[j], query->id);
 			if (ret < 0) {
-				/* Return zero to skip this address and try the next
-				 * namserver address in resolv.conf.
-				 */
-
-				ndbg("ERROR: IPv4 dns_send_query failed: %d\n", ret);
+				ndbg("ERROR: dns_send_query failed: %d\n", ret);
 				query->result = ret;
-				return 0;
+				continue;
 			}
 
-			/* Obtain the IPv4 response */
-
-			ret = dns_recv_response(query->sd, query->addr, query->addrlen);
-			if (ret >= 0) {
-				/* IPv4 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-				/* Save the answer in the DNS cache */
+			query->npending++;
+		}
+	}
 
-				dns_save_answer(query->hostname, query->addr, *query->addrlen);
+	query->deadline = dns_now_ms() + CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT * 1000;
+	return query->npending > 0 ? -EINPROGRESS : query->result;
+#else
+	return -EAFNOSUPPORT;
 #endif
-				/* Return 1 to indicate to (1) stop the traversal, and (2)
-				 * indicate that the address was found.
-				 */
+}
 
-				return 1;
-			}
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-			/* Handle errors */
+/****************************************************************************
+ * Name: dns_query_start
+ *
+ * Description:
+ *   Start looking up 'hostname': collect the name servers and send the
+ *   A and AAAA queries to all of them at once.
+ *
+ * Input Parameters:
+ *   query    - The state of the lookup, initialized here.
+ *   sd       - The socket descriptor previously initialized by dsn_bind().
+ *   hostname - The hostname string to be resolved.
+ *
+ * Returned Value:
+ *   -EINPROGRESS if queries were sent; dns_query_process() then takes the
+ *   answers.  Otherwise a negated errno value.
+ *
+ ****************************************************************************/
 
-			ndbg("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
+int dns_query_start(FAR struct dns_query_s *query, int sd, FAR const char *hostname)
+{
+	int ret;
 
-			if (ret == -EADDRNOTAVAIL) {
-				/* The IPv4 address is not available.  Return zero to
-				 * continue the tranversal with the next nameserver
-				 * address in resolv.conf.
-				 */
+	if (strlen(hostname) >= CONFIG_NETDB_DNSCLIENT_NAMESIZE) {
+		return -ENAMETOOLONG;
+	}
 
-				query->result = -EADDRNOTAVAIL;
-				return 0;
-			} else if (ret != -EAGAIN) {
-				/* Some failure other than receive timeout occurred.  Return
-				 * zero to skip this address and try the next namserver
-				 * address in resolv.conf.
-				 */
+	strcpy(query->hostname, hostname);
+	query->sd = sd;
+	query->attempt = 0;
+	query->result = -EADDRNOTAVAIL;
 
-				query->result = ret;
-				return 0;
-			}
-		} else {
-			/* Unsupported address family. Return zero to continue the
-			 * tranversal with the next nameserver address in resolv.conf.
-			 */
-			return 0;
-		}
-#endif							/* CONFIG_NET_IPv4 */
+	/* Collect the name servers.  dns_foreach_nameserver() will return:
+	 *
+	 *  1 - DNS_MAX_NAMESERVERS were collected
+	 *  0 - All name servers were collected
+	 * <0 - Some other failure
+	 */
 
-#ifdef CONFIG_NET_IPv6
-		/* Is this an IPv6 address? */
+	query->nservers = 0;
+	ret = dns_foreach_nameserver(dns_query_callback, query);
+	if (ret < 0) {
+		return ret;
+	}
 
-		if (query->addr->sa_family == AF_INET6) {
-			/* Yes.. verify the address size */
+	dns_semtake();
+	query->id = g_seqno++;
+	dns_semgive();
 
-			if (addrlen < sizeof(struct sockaddr_in6)) {
-				/* Return zero to skip this address and try the next
-				 * namserver address in resolv.conf.
-				 */
+	return dns_query_send(query);
+}
 
-				ndbg("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-				query->result = -EINVAL;
-				return 0;
-			}
+/****************************************************************************
+ * Name: dns_query_process
+ *
+ * Description:
+ *   Take the responses to a lookup started by dns_query_start().  The first
+ *   answer with an address completes the lookup and is cached.  If every
+ *   query is answered and the name has no address, that is cached as a
+ *   negative answer.  The queries are sent again when the response timeout
+ *   expires, MAX_ATTEMPTS times at most.
+ *
+ * Input Parameters:
+ *   query   - The state of the lookup.
+ *   addr    - The location to return the IP address associated with the
+ *     hostname
+ *   addrlen - On entry, the size of the buffer backing up the 'addr'
+ *     pointer.  On return, this location will hold the actual size of
+ *     the returned address.
+ *   wait    - Block until the lookup completes.  Otherwise return
+ *     -EINPROGRESS as soon as no more responses are queued on the socket.
+ *
+ * Returned Value:
+ *   Zero (OK) if the address was found, -EINPROGRESS if the lookup is still
+ *   going on, or a negated errno value.
+ *
+ ****************************************************************************/
 
-			/* Send the IPv6 query */
+int dns_query_process(FAR struct dns_query_s *query, FAR struct sockaddr *addr, FAR socklen_t *addrlen, bool wait)
+{
+	uint32_t ttl;
+	int ret;
 
-			ret = dns_send_query(query->sd, query->hostname, (FAR union dns_server_u *)addr, DNS_RECTYPE_AAAA);
-			if (ret < 0) {
-				/* Return zero to skip this address and try the next
-				 * namserver address in resolv.conf.
-				 */
+	for (;;) {
+		if (query->npending == 0 || (int32_t)(dns_now_ms() - query->deadline) >= 0) {
+			if (query->npending == 0 && query->nnegative > 0) {
+				/* Every query was answered and the name has no address */
 
-				ndbg("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-				query->result = ret;
-				return 0;
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+				dns_save_answer(query->hostname, NULL, 0, CONFIG_NETDB_DNSCLIENT_NEGLIFESEC);
+#endif
+				return -EADDRNOTAVAIL;
 			}
 
-			/* Obtain the IPv6 response */
+			if (++query->attempt >= MAX_ATTEMPTS) {
+				return query->result;
+			}
 
-			ret = dns_recv_response(query->sd, query->addr, query->addrlen);
-			if (ret >= 0) {
-				/* IPv6 response received successfully */
+			ret = dns_query_send(query);
+			if (ret != -EINPROGRESS) {
+				return ret;
+			}
+		}
 
+		ret = dns_recv_response(query->sd, query->id, addr, addrlen, &ttl, wait ? 0 : MSG_DONTWAIT);
+		if (ret >= 0) {
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-				/* Save the answer in the DNS cache */
+			/* Save the answer in the DNS cache */
 
-				dns_save_answer(query->hostname, query->addr, *query->addrlen);
+			dns_save_answer(query->hostname, addr, *addrlen, ttl);
 #endif
-				/* Return 1 to indicate to (1) stop the traversal, and (2)
-				 * indicate that the address was found.
-				 */
-
-				return 1;
+			return OK;
+		} else if (ret == -ESRCH) {
+			continue;
+		} else if (ret == -EAGAIN) {
+			if (!wait) {
+				return -EINPROGRESS;
 			}
 
-			/* Handle errors */
+			/* Receive timeout, send the queries again */
 
-			ndbg("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
-
-			if (ret == -EADDRNOTAVAIL) {
-				/* The IPv6 address is not available.  Return zero to
-				 * continue the tranversal with the next nameserver
-				 * address in resolv.conf.
-				 */
+			query->result = -ETIMEDOUT;
+			query->deadline = dns_now_ms();
+			continue;
+		} else if (ret == -ERANGE) {
+			return ret;
+		}
 
-				query->result = -EADDRNOTAVAIL;
-				return 0;
-			} else if (ret != -EAGAIN) {
-				/* Some failure other than receive timeout occurred.  Return
-				 * zero to skip this address and try the next namserver
-				 * address in resolv.conf.
-				 */
+		ndbg("ERROR: dns_recv_response failed: %d\n", ret);
 
-				query->result = ret;
-				return 0;
-			}
-		} else {
-			/* Unsupported address family. Return zero to continue the
-			 * tranversal with the next nameserver address in resolv.conf.
-			 */
-			return 0;
+		if (ret == -EADDRNOTAVAIL) {
+			query->nnegative++;
 		}
-#endif
-	}
-
-	/* We tried three times and could not communicate with this nameserver.
-	 * Perhaps it is down?  Return zero to continue with the next address
-	 * in the resolv.conf file.
-	 */
 
-	query->result = -ETIMEDOUT;
-	return 0;
-#else							/* defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6) */
-	/* No IP Network, ideally this should not happen. Return zero to continue the
-	 * tranversal with the next nameserver address in resolv.conf.
-	 */
-	return 0;
-#endif							/* defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6) */
+		query->result = ret;
+		query->npending--;
+	}
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: dns_query_timeout
+ *
+ * Description:
+ *   Return the time in milliseconds until dns_query_process() must be
+ *   called again to send the queries again, if no response comes first.
+ *
  ****************************************************************************/
 
+int dns_query_timeout(FAR struct dns_query_s *query)
+{
+	int32_t remaining = (int32_t)(query->deadline - dns_now_ms());
+
+	return remaining > 0 ? remaining : 0;
+}
+
 /****************************************************************************
  * Name: dns_query
  *
@@ -604,31 +644,12 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr, FAR sock
 
 int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr, FAR socklen_t *addrlen)
 {
-	FAR struct dns_query_s query;
+	struct dns_query_s query;
 	int ret;
 
-	/* Set up the query info structure */
-
-	query.sd = sd;
-	query.result = -EADDRNOTAVAIL;
-	query.hostname = hostname;
-	query.addr = addr;
-	query.addrlen = addrlen;
-
-	/* Perform the query. dns_foreach_nameserver() will return:
-	 *
-	 *  1 - The query was successful.
-	 *  0 - Look up failed
-	 * <0 - Some other failure (?, shouldn't happen)
-	 */
-
-	ret = dns_foreach_nameserver(dns_query_callback, &query);
-	if (ret > 0) {
-		/* The lookup was successful */
-
-		ret = OK;
-	} else if (ret == 0) {
-		ret = query.result;
+	ret = dns_query_start(&query, sd, hostname);
+	while (ret == -EINPROGRESS) {
+		ret = dns_query_process(&query, addr, addrlen, true);
 	}
 
 	return ret;
@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/netdb/lib_getaddrinfo_async.c
+ *
+ * getaddrinfo() without blocking the caller.  Each lookup owns a UDP
+ * socket; the caller polls it with its other descriptors and calls
+ * gai_async_process() when it is readable or gai_async_timeout() has
+ * expired, so any number of lookups can be in flight from one task.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/socket.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include "netdb/lib_dns.h"
+
+#ifdef CONFIG_NETDB_DNSCLIENT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct gai_async_s {
+	struct dns_query_s query;	/* The DNS lookup in progress */
+	struct addrinfo hints;		/* Copy of the caller's hints */
+	in_port_t port;				/* Port of the service, network order */
+	gai_callback_t callback;	/* Called when the lookup completes */
+	FAR void *arg;				/* Argument of the callback */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gai_async_errcode
+ *
+ * Description:
+ *   Convert a negated errno value from the DNS client to an EAI_* value
+ *
+ ****************************************************************************/
+
+static int gai_async_errcode(int ret)
+{
+	switch (ret) {
+	case -EADDRNOTAVAIL:
+	case -ENAMETOOLONG:
+		return EAI_NONAME;
+	case -ETIMEDOUT:
+	case -EAGAIN:
+		return EAI_AGAIN;
+	case -ENOMEM:
+		return EAI_MEMORY;
+	default:
+		return EAI_FAIL;
+	}
+}
+
+/****************************************************************************
+ * Name: gai_async_result
+ *
+ * Description:
+ *   Build the addrinfo result for a resolved address, allocated as
+ *   getaddrinfo() does so that freeaddrinfo() releases it.
+ *
+ ****************************************************************************/
+
+static int gai_async_result(FAR const struct addrinfo *hints, in_port_t port, FAR const char *hostname, FAR const struct sockaddr *addr, socklen_t addrlen, FAR struct addrinfo **res)
+{
+	FAR struct addrinfo *ai;
+
+	ai = (FAR struct addrinfo *)malloc(sizeof(struct addrinfo));
+	if (ai == NULL) {
+		return EAI_MEMORY;
+	}
+
+	memset(ai, 0, sizeof(struct addrinfo));
+	ai->ai_family = addr->sa_family;
+	ai->ai_socktype = hints->ai_socktype;
+	ai->ai_protocol = hints->ai_protocol;
+	ai->ai_addrlen = addrlen;
+
+	ai->ai_addr = (FAR struct sockaddr *)malloc(addrlen);
+	if (ai->ai_addr == NULL) {
+		free(ai);
+		return EAI_MEMORY;
+	}
+
+	memcpy(ai->ai_addr, addr, addrlen);
+#ifdef CONFIG_NET_IPv6
+	if (addr->sa_family == AF_INET6) {
+		((FAR struct sockaddr_in6 *)ai->ai_addr)->sin6_port = port;
+	} else
+#endif
+	{
+		((FAR struct sockaddr_in *)ai->ai_addr)->sin_port = port;
+	}
+
+	if ((hints->ai_flags & AI_CANONNAME) != 0) {
+		ai->ai_canonname = strdup(hostname);
+	}
+
+	*res = ai;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getaddrinfo_async
+ ****************************************************************************/
+
+int getaddrinfo_async(FAR const char *host, FAR const char *service, FAR const struct addrinfo *hints, gai_callback_t callback, FAR void *arg, FAR struct gai_async_s **req)
+{
+	FAR struct gai_async_s *gai;
+	FAR struct addrinfo *res = NULL;
+	struct addrinfo numeric;
+	union dns_server_u addr;
+	socklen_t addrlen;
+	in_port_t port = 0;
+	int sd;
+	int ret;
+
+	if (callback == NULL || req == NULL) {
+		return EAI_FAIL;
+	}
+
+	*req = NULL;
+
+	if (hints != NULL) {
+		memcpy(&numeric, hints, sizeof(struct addrinfo));
+	} else {
+		memset(&numeric, 0, sizeof(struct addrinfo));
+		numeric.ai_family = PF_UNSPEC;
+	}
+
+	/* Numeric addresses, no host and bad arguments complete at once */
+
+	numeric.ai_flags |= AI_NUMERICHOST;
+	ret = getaddrinfo(host, service, &numeric, &res);
+	if (host == NULL || ret != EAI_NONAME) {
+		callback(ret, res, arg);
+		return OK;
+	}
+
+	numeric.ai_flags &= ~AI_NUMERICHOST;
+
+	/* Resolve the service now; getaddrinfo() without host returns it with
+	 * a loopback or wildcard address.
+	 */
+
+	if (service != NULL) {
+		ret = getaddrinfo(NULL, service, &numeric, &res);
+		if (ret != OK) {
+			callback(ret, NULL, arg);
+			return OK;
+		}
+
+		port = ((FAR struct sockaddr_in *)res->ai_addr)->sin_port;
+		freeaddrinfo(res);
+		res = NULL;
+	}
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+	/* Answer from the DNS cache if possible */
+
+	addrlen = sizeof(union dns_server_u);
+	ret = dns_find_answer(host, &addr.addr, &addrlen);
+	if (ret == OK) {
+		ret = gai_async_result(&numeric, port, host, &addr.addr, addrlen, &res);
+		callback(ret, res, arg);
+		return OK;
+	} else if (ret == -EADDRNOTAVAIL) {
+		callback(EAI_NONAME, NULL, arg);
+		return OK;
+	}
+#endif
+
+	/* Start the DNS lookup */
+
+	gai = (FAR struct gai_async_s *)malloc(sizeof(struct gai_async_s));
+	if (gai == NULL) {
+		callback(EAI_MEMORY, NULL, arg);
+		return OK;
+	}
+
+	sd = dns_bind();
+	if (sd < 0) {
+		free(gai);
+		callback(gai_async_errcode(sd), NULL, arg);
+		return OK;
+	}
+
+	ret = dns_query_start(&gai->query, sd, host);
+	if (ret != -EINPROGRESS) {
+		close(sd);
+		free(gai);
+		callback(gai_async_errcode(ret), NULL, arg);
+		return OK;
+	}
+
+	memcpy(&gai->hints, &numeric, sizeof(struct addrinfo));
+	gai->port = port;
+	gai->callback = callback;
+	gai->arg = arg;
+
+	*req = gai;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: gai_async_fd
+ ****************************************************************************/
+
+int gai_async_fd(FAR struct gai_async_s *req)
+{
+	return req->query.sd;
+}
+
+/****************************************************************************
+ * Name: gai_async_timeout
+ ****************************************************************************/
+
+int gai_async_timeout(FAR struct gai_async_s *req)
+{
+	return dns_query_timeout(&req->query);
+}
+
+/****************************************************************************
+ * Name: gai_async_process
+ ****************************************************************************/
+
+int gai_async_process(FAR struct gai_async_s *req)
+{
+	FAR struct addrinfo *res = NULL;
+	union dns_server_u addr;
+	socklen_t addrlen;
+	int ret;
+
+	addrlen = sizeof(union dns_server_u);
+	ret = dns_query_process(&req->query, &addr.addr, &addrlen, false);
+	if (ret == -EINPROGRESS) {
+		return 1;
+	}
+
+	if (ret == OK) {
+		ret = gai_async_result(&req->hints, req->port, req->query.hostname, &addr.addr, addrlen, &res);
+	} else {
+		ret = gai_async_errcode(ret);
+	}
+
+	close(req->query.sd);
+	req->callback(ret, res, req->arg);
+	free(req);
+	return 0;
+}
+
+/****************************************************************************
+ * Name: gai_async_cancel
+ ****************************************************************************/
+
+void gai_async_cancel(FAR struct gai_async_s *req)
+{
+	close(req->query.sd);
+	free(req);
+}
+
+#endif							/* CONFIG_NETDB_DNSCLIENT */
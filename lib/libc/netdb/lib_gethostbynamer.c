@@ -740,15 +740,20 @@ int gethostbyname_r(FAR const char *name, FAR struct hostent *host, FAR char *bu
 
 		return OK;
 	}
-#endif
 
-	/* Try to get the host address using the DNS name server */
+	/* Don't ask the name servers again about a name cached as unknown */
 
-	ret = lib_dns_lookup(name, host, buf, buflen);
-	if (ret >= 0) {
-		/* Successful DNS lookup! */
+	if (ret != -EADDRNOTAVAIL)
+#endif
+	{
+		/* Try to get the host address using the DNS name server */
 
-		return OK;
+		ret = lib_dns_lookup(name, host, buf, buflen);
+		if (ret >= 0) {
+			/* Successful DNS lookup! */
+
+			return OK;
+		}
 	}
 #endif							/* CONFIG_NETDB_DNSCLIENT */
 
@@ -105,11 +105,10 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 		sem->flags = 0;
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-		sem->hhead = NULL;
-#else
 		sem->holder.htcb = NULL;
 		sem->holder.counts = 0;
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+		sem->hhead = NULL;
 #endif
 #endif
 		return OK;
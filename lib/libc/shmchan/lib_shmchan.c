@@ -0,0 +1,281 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/shmchan/lib_shmchan.c
+ *
+ * Each end only writes its own index, so no lock is needed.  A side that
+ * finds the ring full or empty sets its wait flag, checks the indices again
+ * and sleeps on its semaphore; the other side posts it only when it sees
+ * the flag, so the common case of a busy channel costs no system call.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/shm.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <shmchan.h>
+
+#include <tinyara/semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offset of the ring in the segment */
+
+#define SHMCHAN_RINGOFF         ((sizeof(struct shmchan_hdr_s) + 7) & ~7)
+
+#define SHMCHAN_MINSIZE         64
+
+/* Order the data and index accesses of both ends */
+
+#define shmchan_barrier()       __sync_synchronize()
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int shmchan_attach(int shmid, FAR struct shmchan_s *chan)
+{
+	FAR void *addr;
+
+	addr = shmat(shmid, NULL, 0);
+	if (addr == (FAR void *)-1) {
+		return -1;
+	}
+
+	chan->hdr = (FAR struct shmchan_hdr_s *)addr;
+	chan->ring = (FAR uint8_t *)addr + SHMCHAN_RINGOFF;
+	chan->shmid = shmid;
+	return 0;
+}
+
+/* Called with *waitflag set: sleep until the other end posts sem, unless
+ * the indices checked again show that it is not needed anymore.  Returns
+ * -1 with errno set if interrupted.
+ */
+
+static int shmchan_sleep(FAR volatile uint8_t *waitflag, FAR sem_t *sem, bool ready)
+{
+	if (ready) {
+		*waitflag = 0;
+		return 0;
+	}
+
+	return sem_wait(sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int shmchan_create(key_t key, size_t size, FAR struct shmchan_s *chan)
+{
+	FAR struct shmchan_hdr_s *hdr;
+	uint32_t ringsize;
+	int shmid;
+
+	if (size == 0 || size > 0x40000000) {
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	for (ringsize = SHMCHAN_MINSIZE; ringsize < size; ringsize <<= 1) ;
+
+	shmid = shmget(key, SHMCHAN_RINGOFF + ringsize, IPC_CREAT | IPC_EXCL | 0666);
+	if (shmid < 0) {
+		return -1;
+	}
+
+	if (shmchan_attach(shmid, chan) < 0) {
+		int errcode = get_errno();
+
+		shmctl(shmid, IPC_RMID, NULL);
+		set_errno(errcode);
+		return -1;
+	}
+
+	hdr = chan->hdr;
+	memset(hdr, 0, sizeof(struct shmchan_hdr_s));
+	hdr->size = ringsize;
+
+	/* The semaphores are used for signaling and must not boost priorities */
+
+	sem_init(&hdr->rxsem, 1, 0);
+	sem_setprotocol(&hdr->rxsem, SEM_PRIO_NONE);
+	sem_init(&hdr->txsem, 1, 0);
+	sem_setprotocol(&hdr->txsem, SEM_PRIO_NONE);
+
+	/* Publish the header last, shmchan_open() checks the magic */
+
+	shmchan_barrier();
+	hdr->magic = SHMCHAN_MAGIC;
+	return 0;
+}
+
+int shmchan_open(key_t key, FAR struct shmchan_s *chan)
+{
+	int shmid;
+
+	shmid = shmget(key, 0, 0);
+	if (shmid < 0) {
+		return -1;
+	}
+
+	if (shmchan_attach(shmid, chan) < 0) {
+		return -1;
+	}
+
+	if (chan->hdr->magic != SHMCHAN_MAGIC) {
+		shmdt(chan->hdr);
+		chan->hdr = NULL;
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	return 0;
+}
+
+int shmchan_close(FAR struct shmchan_s *chan)
+{
+	int ret;
+
+	ret = shmdt(chan->hdr);
+	chan->hdr = NULL;
+	chan->ring = NULL;
+	return ret;
+}
+
+int shmchan_destroy(FAR struct shmchan_s *chan)
+{
+	int shmid = chan->shmid;
+
+	chan->hdr->magic = 0;
+	sem_destroy(&chan->hdr->rxsem);
+	sem_destroy(&chan->hdr->txsem);
+
+	if (shmchan_close(chan) < 0) {
+		return -1;
+	}
+
+	return shmctl(shmid, IPC_RMID, NULL);
+}
+
+ssize_t shmchan_reserve(FAR struct shmchan_s *chan, FAR void **buf, bool wait)
+{
+	FAR struct shmchan_hdr_s *hdr = chan->hdr;
+	uint32_t head = hdr->head;
+	uint32_t space;
+	uint32_t off;
+
+	while ((space = hdr->size - (head - hdr->tail)) == 0) {
+		if (!wait) {
+			set_errno(EAGAIN);
+			return -1;
+		}
+
+		hdr->txwait = 1;
+		shmchan_barrier();
+		if (shmchan_sleep(&hdr->txwait, &hdr->txsem, head - hdr->tail < hdr->size) < 0) {
+			return -1;
+		}
+	}
+
+	/* Only the part up to the end of the ring is contiguous */
+
+	off = head & (hdr->size - 1);
+	if (space > hdr->size - off) {
+		space = hdr->size - off;
+	}
+
+	*buf = chan->ring + off;
+	return (ssize_t)space;
+}
+
+void shmchan_commit(FAR struct shmchan_s *chan, size_t len)
+{
+	FAR struct shmchan_hdr_s *hdr = chan->hdr;
+
+	/* The data must be visible before the new head */
+
+	shmchan_barrier();
+	hdr->head += len;
+	shmchan_barrier();
+
+	if (hdr->rxwait) {
+		hdr->rxwait = 0;
+		sem_post(&hdr->rxsem);
+	}
+}
+
+ssize_t shmchan_peek(FAR struct shmchan_s *chan, FAR const void **buf, bool wait)
+{
+	FAR struct shmchan_hdr_s *hdr = chan->hdr;
+	uint32_t tail = hdr->tail;
+	uint32_t avail;
+	uint32_t off;
+
+	while ((avail = hdr->head - tail) == 0) {
+		if (!wait) {
+			set_errno(EAGAIN);
+			return -1;
+		}
+
+		hdr->rxwait = 1;
+		shmchan_barrier();
+		if (shmchan_sleep(&hdr->rxwait, &hdr->rxsem, hdr->head != tail) < 0) {
+			return -1;
+		}
+	}
+
+	/* Read the data only after the head that covers it */
+
+	shmchan_barrier();
+
+	off = tail & (hdr->size - 1);
+	if (avail > hdr->size - off) {
+		avail = hdr->size - off;
+	}
+
+	*buf = chan->ring + off;
+	return (ssize_t)avail;
+}
+
+void shmchan_release(FAR struct shmchan_s *chan, size_t len)
+{
+	FAR struct shmchan_hdr_s *hdr = chan->hdr;
+
+	/* Done reading before the space is handed back */
+
+	shmchan_barrier();
+	hdr->tail += len;
+	shmchan_barrier();
+
+	if (hdr->txwait) {
+		hdr->txwait = 0;
+		sem_post(&hdr->txsem);
+	}
+}
@@ -80,6 +80,6 @@
 
 void clearerr(FILE *stream)
 {
-	stream->fs_flags = 0;
+	stream->fs_flags &= ~(__FS_FLAG_EOF | __FS_FLAG_ERROR);
 }
 #endif							/* CONFIG_NFILE_STREAMS */
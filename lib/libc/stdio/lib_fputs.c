@@ -168,19 +168,29 @@ int fputs(FAR const char *s, FAR FILE *stream)
 	}
 #endif
 
-	/* Write the string.  Loop until the null terminator is encountered */
+	/* Write the string one line at a time.  Loop until the null terminator
+	 * is encountered.
+	 */
 
-	for (nput = 0; *s; nput++, s++) {
-		/* Write the next character to the stream buffer */
+	for (nput = 0; *s; ) {
+		FAR const char *newline = strchr(s, '\n');
+		int ntowrite = newline ? newline - s + 1 : strlen(s);
 
-		ret = lib_fwrite(s, 1, stream);
+		/* Write the line, or what is left of the string, to the stream
+		 * buffer
+		 */
+
+		ret = lib_fwrite(s, ntowrite, stream);
 		if (ret <= 0) {
 			return EOF;
 		}
 
+		nput += ret;
+		s += ret;
+
 		/* Flush the buffer if a newline was written to the buffer */
 
-		if (*s == '\n') {
+		if (s[-1] == '\n') {
 			ret = lib_fflush(stream, true);
 			if (ret < 0) {
 				return EOF;
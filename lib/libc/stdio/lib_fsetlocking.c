@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/stdio/lib_fsetlocking.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdio_ext.h>
+
+#include <tinyara/fs/fs.h>
+
+#if CONFIG_NFILE_STREAMS > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __fsetlocking
+ *
+ * Description:
+ *   Query or set how the stream is locked.  FSETLOCKING_BYCALLER makes
+ *   lib_take_semaphore()/lib_give_semaphore() return at once.
+ *
+ ****************************************************************************/
+
+int __fsetlocking(FAR FILE *stream, int type)
+{
+	int old = (stream->fs_flags & __FS_FLAG_NOLOCK) != 0 ? FSETLOCKING_BYCALLER : FSETLOCKING_INTERNAL;
+
+	if (type == FSETLOCKING_BYCALLER) {
+		stream->fs_flags |= __FS_FLAG_NOLOCK;
+	} else if (type == FSETLOCKING_INTERNAL) {
+		stream->fs_flags &= ~__FS_FLAG_NOLOCK;
+	}
+
+	return old;
+}
+#endif							/* CONFIG_NFILE_STREAMS */
@@ -62,6 +62,8 @@
  ****************************************************************************/
 
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "lib_internal.h"
 
@@ -71,6 +73,13 @@
 
 #define MAX_PREC 16
 
+/* lib_fixdtoa() handles precisions up to FIXDTOA_MAXPREC and needs room for
+ * the 20 digits of a 64-bit value plus the terminating NUL.
+ */
+
+#define FIXDTOA_MAXPREC 9
+#define FIXDTOA_BUFSIZE 21
+
 #ifndef MIN
 #define MIN(a, b) (a < b ? a : b)
 #endif
@@ -99,6 +108,10 @@
  * Private Constant Data
  ****************************************************************************/
 
+static const uint32_t g_dtoapow10[FIXDTOA_MAXPREC + 1] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -134,9 +147,128 @@ static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
 
 static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 {
-	while (*str) {
-		obj->put(obj, *str++);
+	putrun(obj, str, strlen(str));
+}
+
+/****************************************************************************
+ * Name: lib_fixdtoa
+ *
+ * Description:
+ *   Fast path for __dtoa(value, 3, prec, ...), which works on multiple
+ *   precision integers.  The positive value is m * 2^e with a 53-bit m, so
+ *   when m * 10^prec fits in 64 bits, the correctly rounded value of
+ *   value * 10^prec is found with one multiplication and one shift.  The
+ *   digits and the decimal point position are the same as those returned
+ *   by __dtoa(): trailing zeroes removed, and ties rounded to even.
+ *
+ * Returned Value:
+ *   A pointer to the NUL terminated digits in buf, or NULL if the value is
+ *   out of range and __dtoa() has to be used.
+ *
+ ****************************************************************************/
+
+static FAR char *lib_fixdtoa(double value, int prec, FAR char *buf, FAR int *expt, FAR char **rve)
+{
+	FAR char *end = &buf[FIXDTOA_BUFSIZE - 1];
+	FAR char *digits = end;
+	uint64_t bits;
+	uint64_t m;
+	uint64_t q;
+	uint32_t lo;
+	int e;
+	int nzeroes;
+
+	if (prec < 0 || prec > FIXDTOA_MAXPREC) {
+		return NULL;
 	}
+
+	memcpy(&bits, &value, sizeof(bits));
+	e = (int)((bits >> 52) & 0x7ff);
+	m = bits & (((uint64_t)1 << 52) - 1);
+
+	if (e == 0) {
+		/* Zero is the only subnormal worth handling here */
+
+		if (m != 0) {
+			return NULL;
+		}
+
+		q = 0;
+	} else {
+		m |= (uint64_t)1 << 52;
+		e -= 1075;
+
+		/* Drop the low zero bits of m to make room for 10^prec */
+
+		while (e < 0 && (m & 1) == 0) {
+			m >>= 1;
+			e++;
+		}
+
+		if (e >= 0) {
+			/* An integer: no rounding, and all digits after the point are
+			 * zeroes which __dtoa() drops anyway.
+			 */
+
+			if (e > 11) {
+				return NULL;
+			}
+
+			q = m << e;
+			prec = 0;
+		} else {
+			uint64_t prod;
+			uint64_t rem;
+			uint64_t half;
+
+			if (e <= -64 || m > UINT64_MAX / g_dtoapow10[prec]) {
+				return NULL;
+			}
+
+			prod = m * g_dtoapow10[prec];
+			q = prod >> -e;
+			rem = prod & ((((uint64_t)1) << -e) - 1);
+			half = ((uint64_t)1) << (-e - 1);
+
+			if (rem > half || (rem == half && (q & 1) != 0)) {
+				q++;
+			}
+		}
+	}
+
+	*end = '\0';
+	*rve = end;
+
+	if (q == 0) {
+		*--digits = '0';
+		*expt = 1;
+		return digits;
+	}
+
+	for (nzeroes = 0; q % 10 == 0; nzeroes++) {
+		q /= 10;
+	}
+
+	/* Split off nine digits at a time so that the digit loop runs on
+	 * 32-bit values.
+	 */
+
+	while (q > UINT32_MAX) {
+		lo = (uint32_t)(q % 1000000000);
+		q /= 1000000000;
+
+		for (e = 0; e < 9; e++) {
+			*--digits = lo % 10 + '0';
+			lo /= 10;
+		}
+	}
+
+	for (lo = (uint32_t)q; lo != 0; lo /= 10) {
+		*--digits = lo % 10 + '0';
+	}
+
+	*expt = (end - digits) + nzeroes - prec;
+	return digits;
 }
 
 /****************************************************************************
@@ -163,6 +295,7 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 
 static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec, uint8_t flags, double value)
 {
+	char buf[FIXDTOA_BUFSIZE];	/* Digits of the fast conversion */
 	FAR char *digits;			/* String returned by __dtoa */
 	FAR char *rve;				/* Points to the end of the return value */
 	int expt;					/* Integer value of exponent */
@@ -196,7 +329,10 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec, uint8_t
 
 	/* Perform the conversion */
 
-	digits = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
+	digits = lib_fixdtoa(value, prec, buf, &expt, &rve);
+	if (digits == NULL) {
+		digits = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
+	}
 	numlen = rve - digits;
 
 	/* Avoid precision error from missing trailing zeroes */
@@ -57,6 +57,7 @@
 #include <tinyara/compiler.h>
 
 #include <stdint.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -78,6 +79,10 @@
 #define CONFIG_LIBC_FIXEDPRECISION 3
 #endif
 
+/* Room for the decimal digits of a 64-bit unsigned value */
+
+#define DEC_BUFSIZE              20
+
 #define FLAG_SHOWPLUS            0x01
 #define FLAG_ALTFORM             0x02
 #define FLAG_HASDOT              0x04
@@ -167,6 +172,7 @@ static int getsizesize(uint8_t fmt, uint8_t flags, FAR void *p)
 #endif							/* CONFIG_NOPRINTF_FIELDWIDTH */
 #endif							/* CONFIG_PTR_IS_NOT_INT */
 /* Unsigned int to ASCII conversion */
+static FAR char *utodecbuf(FAR char *end, unsigned int n);
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n);
 static void utohex(FAR struct lib_outstream_s *obj, unsigned int n, uint8_t a);
 static void utooct(FAR struct lib_outstream_s *obj, unsigned int n);
@@ -181,6 +187,7 @@ static int getusize(uint8_t fmt, uint8_t flags, unsigned int lln);
 /* Unsigned long int to ASCII conversion */
 
 #ifdef CONFIG_LONG_IS_NOT_INT
+static FAR char *lutodecbuf(FAR char *end, unsigned long ln);
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long ln);
 static void lutohex(FAR struct lib_outstream_s *obj, unsigned long ln, uint8_t a);
 static void lutooct(FAR struct lib_outstream_s *obj, unsigned long ln);
@@ -195,6 +202,7 @@ static int getlusize(uint8_t fmt, FAR uint8_t flags, unsigned long ln);
 /* Unsigned long long int to ASCII conversions */
 
 #ifdef CONFIG_HAVE_LONG_LONG
+static FAR char *llutodecbuf(FAR char *end, unsigned long long lln);
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long lln);
 static void llutohex(FAR struct lib_outstream_s *obj, unsigned long long lln, uint8_t a);
 static void llutooct(FAR struct lib_outstream_s *obj, unsigned long long lln);
@@ -225,6 +233,21 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt, uint8_t fl
 
 static const char g_nullstring[] = "(null)";
 
+/* Decimal conversions emit two digits per division using this table */
+
+static const char g_decpairs[200] = {
+	'0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+	'1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+	'2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+	'3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+	'4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+	'5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+	'6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+	'7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+	'8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+	'9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'
+};
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -233,6 +256,25 @@ static const char g_nullstring[] = "(null)";
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: putrun
+ *
+ * Description:
+ *   Output len characters, in one call when the stream has a puts method.
+ *
+ ****************************************************************************/
+
+static void putrun(FAR struct lib_outstream_s *obj, FAR const char *buf, int len)
+{
+	if (obj->puts) {
+		obj->puts(obj, buf, len);
+	} else {
+		while (len-- > 0) {
+			obj->put(obj, *buf++);
+		}
+	}
+}
+
 /* Include floating point functions */
 
 #ifdef CONFIG_LIBC_FLOATINGPOINT
@@ -292,19 +334,46 @@ static int getpsize(uint8_t flags, FAR void *p)
 #endif							/* CONFIG_PTR_IS_NOT_INT */
 
 /****************************************************************************
- * Name: utodec
+ * Name: utodecbuf
+ *
+ * Description:
+ *   Convert n to decimal digits ending right before 'end', two digits at a
+ *   time, and return a pointer to the first digit.
+ *
  ****************************************************************************/
 
-static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+static FAR char *utodecbuf(FAR char *end, unsigned int n)
 {
-	unsigned int remainder = n % 10;
-	unsigned int dividend = n / 10;
+	unsigned int pair;
 
-	if (dividend) {
-		utodec(obj, dividend);
+	while (n >= 100) {
+		pair = (n % 100) << 1;
+		n /= 100;
+		*--end = g_decpairs[pair + 1];
+		*--end = g_decpairs[pair];
 	}
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	if (n >= 10) {
+		pair = n << 1;
+		*--end = g_decpairs[pair + 1];
+		*--end = g_decpairs[pair];
+	} else {
+		*--end = (char)n + '0';
+	}
+
+	return end;
+}
+
+/****************************************************************************
+ * Name: utodec
+ ****************************************************************************/
+
+static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+{
+	char buf[DEC_BUFSIZE];
+	FAR char *digits = utodecbuf(&buf[DEC_BUFSIZE], n);
+
+	putrun(obj, digits, &buf[DEC_BUFSIZE] - digits);
 }
 
 /****************************************************************************
@@ -515,6 +584,13 @@ static void fixup(uint8_t fmt, FAR uint8_t *flags, FAR int *n)
 static int getusize(uint8_t fmt, uint8_t flags, unsigned int n)
 {
 	struct lib_outstream_s nulloutstream;
+
+	if (fmt == 'd' || fmt == 'i' || fmt == 'u') {
+		char buf[DEC_BUFSIZE];
+
+		return &buf[DEC_BUFSIZE] - utodecbuf(&buf[DEC_BUFSIZE], n);
+	}
+
 	lib_nulloutstream(&nulloutstream);
 
 	utoascii(&nulloutstream, fmt, flags, n);
@@ -539,19 +615,29 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 #ifdef CONFIG_LONG_IS_NOT_INT
 /****************************************************************************
- * Name: lutodec
+ * Name: lutodecbuf and lutodec
  ****************************************************************************/
 
-static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
+static FAR char *lutodecbuf(FAR char *end, unsigned long n)
 {
-	unsigned int remainder = n % 10;
-	unsigned long dividend = n / 10;
+	unsigned int pair;
 
-	if (dividend) {
-		lutodec(obj, dividend);
+	while (n >= 100) {
+		pair = (unsigned int)(n % 100) << 1;
+		n /= 100;
+		*--end = g_decpairs[pair + 1];
+		*--end = g_decpairs[pair];
 	}
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	return utodecbuf(end, (unsigned int)n);
+}
+
+static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
+{
+	char buf[DEC_BUFSIZE];
+	FAR char *digits = lutodecbuf(&buf[DEC_BUFSIZE], n);
+
+	putrun(obj, digits, &buf[DEC_BUFSIZE] - digits);
 }
 
 /****************************************************************************
@@ -757,6 +843,13 @@ static void lfixup(uint8_t fmt, FAR uint8_t *flags, FAR long *ln)
 static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 {
 	struct lib_outstream_s nulloutstream;
+
+	if (fmt == 'd' || fmt == 'i' || fmt == 'u') {
+		char buf[DEC_BUFSIZE];
+
+		return &buf[DEC_BUFSIZE] - lutodecbuf(&buf[DEC_BUFSIZE], ln);
+	}
+
 	lib_nulloutstream(&nulloutstream);
 
 	lutoascii(&nulloutstream, fmt, flags, ln);
@@ -768,19 +861,37 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 #ifdef CONFIG_HAVE_LONG_LONG
 /****************************************************************************
- * Name: llutodec
+ * Name: llutodecbuf and llutodec
  ****************************************************************************/
 
-static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
+static FAR char *llutodecbuf(FAR char *end, unsigned long long n)
 {
-	unsigned int remainder = n % 10;
-	unsigned long long dividend = n / 10;
+	unsigned int chunk;
+	int i;
 
-	if (dividend) {
-		llutodec(obj, dividend);
+	/* Peel off eight digits per 64-bit division, the rest fits in an int */
+
+	while (n > UINT_MAX) {
+		chunk = (unsigned int)(n % 100000000);
+		n /= 100000000;
+
+		for (i = 0; i < 4; i++) {
+			unsigned int pair = (chunk % 100) << 1;
+			chunk /= 100;
+			*--end = g_decpairs[pair + 1];
+			*--end = g_decpairs[pair];
+		}
 	}
 
-	obj->put(obj, (remainder + (unsigned int)'0'));
+	return utodecbuf(end, (unsigned int)n);
+}
+
+static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
+{
+	char buf[DEC_BUFSIZE];
+	FAR char *digits = llutodecbuf(&buf[DEC_BUFSIZE], n);
+
+	putrun(obj, digits, &buf[DEC_BUFSIZE] - digits);
 }
 
 /****************************************************************************
@@ -986,6 +1097,13 @@ static void llfixup(uint8_t fmt, FAR uint8_t *flags, FAR long long *lln)
 static int getllusize(uint8_t fmt, uint8_t flags, unsigned long long lln)
 {
 	struct lib_outstream_s nulloutstream;
+
+	if (fmt == 'd' || fmt == 'i' || fmt == 'u') {
+		char buf[DEC_BUFSIZE];
+
+		return &buf[DEC_BUFSIZE] - llutodecbuf(&buf[DEC_BUFSIZE], lln);
+	}
+
 	lib_nulloutstream(&nulloutstream);
 
 	llutoascii(&nulloutstream, fmt, flags, lln);
@@ -1104,6 +1222,7 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 		/* Just copy regular characters */
 
 		if (FMT_CHAR != '%') {
+#ifdef CONFIG_ARCH_ROMGETC
 			/* Output the character */
 
 			obj->put(obj, FMT_CHAR);
@@ -1116,6 +1235,38 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 
 				(void)obj->flush(obj);
 			}
+#endif
+#else
+			/* Output the whole run up to the next format specifier at once
+			 * and flush once after it if it holds a newline.
+			 */
+
+			FAR const char *run = src;
+#ifdef CONFIG_STDIO_LINEBUFFER
+			bool newline = false;
+#endif
+
+			do {
+#ifdef CONFIG_STDIO_LINEBUFFER
+				if (*src == '\n') {
+					newline = true;
+				}
+#endif
+				src++;
+			} while (*src != '\0' && *src != '%');
+
+			putrun(obj, run, src - run);
+#ifdef CONFIG_STDIO_LINEBUFFER
+			if (newline) {
+				/* Should return an error on a failure to flush */
+
+				(void)obj->flush(obj);
+			}
+#endif
+
+			/* Leave src on the last character of the run for FMT_BOTTOM */
+
+			src--;
 #endif
 			/* Process the next character in the format */
 
@@ -1126,6 +1277,31 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 
 		FMT_NEXT;
 
+		/* Fast path for a bare %d, %i, %u or %s without any flag, width,
+		 * precision or length qualifier, which is most of what logging
+		 * uses.
+		 */
+
+		if (FMT_CHAR == 'd' || FMT_CHAR == 'i' || FMT_CHAR == 'u') {
+			int n = va_arg(ap, int);
+
+			if (FMT_CHAR != 'u' && n < 0) {
+				obj->put(obj, '-');
+				utodec(obj, -(unsigned int)n);
+			} else {
+				utodec(obj, (unsigned int)n);
+			}
+			continue;
+		} else if (FMT_CHAR == 's') {
+			ptmp = va_arg(ap, char *);
+			if (!ptmp) {
+				ptmp = (char *)g_nullstring;
+			}
+
+			putrun(obj, ptmp, strlen(ptmp));
+			continue;
+		}
+
 		/* Assume defaults */
 
 		flags = 0;
@@ -1272,10 +1448,11 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 #endif
 			/* Concatenate the string into the output */
 
-			while (*ptmp) {
-				obj->put(obj, *ptmp);
-				ptmp++;
-			}
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
+			putrun(obj, ptmp, swidth);
+#else
+			putrun(obj, ptmp, strlen(ptmp));
+#endif
 
 			/* Perform left-justification operations. */
 
@@ -1466,11 +1643,15 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 		else if (strchr("eEfgG", FMT_CHAR)) {
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 			double dblval = va_arg(ap, double);
-			int dblsize;
+			int dblsize = 0;
 
-			/* Get the width of the output */
+			/* Get the width of the output, which is only needed (and costs a
+			 * second conversion) when there is a field to pad.
+			 */
 
-			dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+			if (width > 0) {
+				dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+			}
 
 			/* Perform left field justification actions */
 
@@ -57,6 +57,7 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -70,6 +71,10 @@
  * Preprocessor Definitions
  ****************************************************************************/
 
+/* Partitions smaller than this are finished with an insertion sort */
+
+#define QSORT_INSERTION_THRESHOLD 7
+
 #define min(a, b)  (a) < (b) ? a : b
 
 #define swapcode(TYPE, parmi, parmj, n) \
@@ -99,12 +104,32 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/* qsort() and qsort_r() share the sort; the two-argument comparison is
+ * called directly rather than through a wrapper.
+ */
+
+#define CMP(c, a, b) \
+	((c)->compar != NULL ? (c)->compar(a, b) : (c)->compar_r(a, b, (c)->arg))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct qsort_cmp_s {
+	CODE int (*compar)(FAR const void *, FAR const void *);
+	CODE int (*compar_r)(FAR const void *, FAR const void *, FAR void *);
+	FAR void *arg;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static inline void swapfunc(char *a, char *b, int n, int swaptype);
-static inline char *med3(char *a, char *b, char *c, int (*compar)(const void *, const void *));
+static inline char *med3(char *a, char *b, char *c, FAR const struct qsort_cmp_s *cmp);
+static void insertion_sort(char *base, size_t nmemb, size_t size, int swaptype, FAR const struct qsort_cmp_s *cmp);
+static void heap_sort(char *base, size_t nmemb, size_t size, int swaptype, FAR const struct qsort_cmp_s *cmp);
+static void introsort(char *base, size_t nmemb, size_t size, int depth, FAR const struct qsort_cmp_s *cmp);
 
 /****************************************************************************
  * Private Functions
@@ -118,72 +143,131 @@ static inline void swapfunc(char *a, char *b, int n, int swaptype)
 		swapcode(char, a, b, n);
 	}
 }
-static inline char *med3(char *a, char *b, char *c, int (*compar)(const void *, const void *))
+
+static inline char *med3(char *a, char *b, char *c, FAR const struct qsort_cmp_s *cmp)
+{
+	return CMP(cmp, a, b) < 0 ? (CMP(cmp, b, c) < 0 ? b : (CMP(cmp, a, c) < 0 ? c : a))
+		   : (CMP(cmp, b, c) > 0 ? b : (CMP(cmp, a, c) < 0 ? a : c));
+}
+
+static void insertion_sort(char *base, size_t nmemb, size_t size, int swaptype, FAR const struct qsort_cmp_s *cmp)
 {
-	return compar(a, b) < 0 ? (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a))
-		   : (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+	char *pm;
+	char *pl;
+
+	for (pm = base + size; pm < base + nmemb * size; pm += size) {
+		for (pl = pm; pl > base && CMP(cmp, pl - size, pl) > 0; pl -= size) {
+			swap(pl, pl - size);
+		}
+	}
 }
 
 /****************************************************************************
- * Public Function
+ * Name: heap_sort
+ *
+ * Description:
+ *   Sort a partition in O(n log n) once introsort() has recursed too deep,
+ *   which happens only for inputs that defeat the median selection.
+ *
  ****************************************************************************/
 
+static void heap_sort(char *base, size_t nmemb, size_t size, int swaptype, FAR const struct qsort_cmp_s *cmp)
+{
+	size_t start;
+	size_t end;
+	size_t root;
+	size_t child;
+
+	/* Build a max-heap, then move the root to the end one at a time */
+
+	start = nmemb / 2;
+	end = nmemb;
+	while (end > 1) {
+		if (start > 0) {
+			start--;
+		} else {
+			end--;
+			swap(base, base + end * size);
+		}
+
+		for (root = start; (child = 2 * root + 1) < end; root = child) {
+			if (child + 1 < end && CMP(cmp, base + child * size, base + (child + 1) * size) < 0) {
+				child++;
+			}
+
+			if (CMP(cmp, base + root * size, base + child * size) >= 0) {
+				break;
+			}
+
+			swap(base + root * size, base + child * size);
+		}
+	}
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: introsort
  *
  * Description:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Bentley & McIlroy's "Engineering a Sort Function" quicksort, bounded to
+ *   'depth' levels of partitioning before falling back to heap_sort().
+ *   Small partitions are finished with an insertion sort, and only the
+ *   smaller side of each partition is recursed into so that the stack
+ *   stays within O(log n).
  *
  ****************************************************************************/
 
-void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *))
+static void introsort(char *base, size_t nmemb, size_t size, int depth, FAR const struct qsort_cmp_s *cmp)
 {
 	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-	int d, r, swaptype, swap_cnt;
+	size_t d, r, s;
+	int res, swaptype;
 
 loop:
 	SWAPINIT(base, size);
-	swap_cnt = 0;
-	if (nmemb < 7) {
-		for (pm = (char *)base + size; pm < (char *)base + nmemb * size; pm += size) {
-			for (pl = pm; pl > (char *)base && compar(pl - size, pl) > 0; pl -= size) {
-				swap(pl, pl - size);
-			}
-		}
+	if (nmemb < QSORT_INSERTION_THRESHOLD) {
+		insertion_sort(base, nmemb, size, swaptype, cmp);
+		return;
+	}
+
+	if (depth-- <= 0) {
+		heap_sort(base, nmemb, size, swaptype, cmp);
 		return;
 	}
 
-	pm = (char *)base + (nmemb / 2) * size;
-	if (nmemb > 7) {
+	pm = base + (nmemb / 2) * size;
+	if (nmemb > QSORT_INSERTION_THRESHOLD) {
 		pl = base;
-		pn = (char *)base + (nmemb - 1) * size;
+		pn = base + (nmemb - 1) * size;
 		if (nmemb > 40) {
 			d = (nmemb / 8) * size;
-			pl = med3(pl, pl + d, pl + 2 * d, compar);
-			pm = med3(pm - d, pm, pm + d, compar);
-			pn = med3(pn - 2 * d, pn - d, pn, compar);
+			pl = med3(pl, pl + d, pl + 2 * d, cmp);
+			pm = med3(pm - d, pm, pm + d, cmp);
+			pn = med3(pn - 2 * d, pn - d, pn, cmp);
 		}
-		pm = med3(pl, pm, pn, compar);
+
+		pm = med3(pl, pm, pn, cmp);
 	}
+
 	swap(base, pm);
-	pa = pb = (char *)base + size;
+	pa = pb = base + size;
 
-	pc = pd = (char *)base + (nmemb - 1) * size;
+	pc = pd = base + (nmemb - 1) * size;
 	for (;;) {
-		while (pb <= pc && (r = compar(pb, base)) <= 0) {
-			if (r == 0) {
-				swap_cnt = 1;
+		while (pb <= pc && (res = CMP(cmp, pb, base)) <= 0) {
+			if (res == 0) {
 				swap(pa, pb);
 				pa += size;
 			}
+
 			pb += size;
 		}
-		while (pb <= pc && (r = compar(pc, base)) >= 0) {
-			if (r == 0) {
-				swap_cnt = 1;
+
+		while (pb <= pc && (res = CMP(cmp, pc, base)) >= 0) {
+			if (res == 0) {
 				swap(pc, pd);
 				pd -= size;
 			}
+
 			pc -= size;
 		}
 
@@ -192,38 +276,105 @@ loop:
 		}
 
 		swap(pb, pc);
-		swap_cnt = 1;
 		pb += size;
 		pc -= size;
 	}
 
-	if (swap_cnt == 0) {
-		/* Switch to insertion sort */
-
-		for (pm = (char *)base + size; pm < (char *)base + nmemb * size; pm += size) {
-			for (pl = pm; pl > (char *)base && compar(pl - size, pl) > 0; pl -= size) {
-				swap(pl, pl - size);
-			}
-		}
-
-		return;
-	}
+	/* Move the elements equal to the pivot to the middle */
 
-	pn = (char *)base + nmemb * size;
-	r = min(pa - (char *)base, pb - pa);
+	pn = base + nmemb * size;
+	r = min(pa - base, pb - pa);
 	vecswap(base, pb - r, r);
 	r = min(pd - pc, pn - pd - size);
 	vecswap(pb, pn - r, r);
 
-	if ((r = pb - pa) > size) {
-		qsort(base, r / size, size, compar);
+	/* Recurse into the smaller side and iterate on the larger one */
+
+	r = pb - pa;
+	s = pd - pc;
+	if (r > s) {
+		if (s > size) {
+			introsort(pn - s, s / size, size, depth, cmp);
+		}
+
+		if (r > size) {
+			nmemb = r / size;
+			goto loop;
+		}
+	} else {
+		if (r > size) {
+			introsort(base, r / size, size, depth, cmp);
+		}
+
+		if (s > size) {
+			base = pn - s;
+			nmemb = s / size;
+			goto loop;
+		}
 	}
+}
+
+/****************************************************************************
+ * Name: qsort_depth
+ *
+ * Description:
+ *   Return the partitioning depth allowed before introsort() falls back to
+ *   heap_sort(): twice the base-2 logarithm of nmemb.
+ *
+ ****************************************************************************/
 
-	if ((r = pd - pc) > size) {
-		/* Iterate rather than recurse to save stack space */
+static int qsort_depth(size_t nmemb)
+{
+	int depth = 0;
 
-		base = pn - r;
-		nmemb = r / size;
-		goto loop;
+	while (nmemb > 1) {
+		nmemb >>= 1;
+		depth += 2;
 	}
+
+	return depth;
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   Sort nmemb elements of the given size with an introsort: a quicksort
+ *   from Bentley & McIlroy's "Engineering a Sort Function" which falls
+ *   back to a heap sort on degenerate partitions, so that the worst case
+ *   is O(n log n).
+ *
+ ****************************************************************************/
+
+void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *))
+{
+	struct qsort_cmp_s cmp;
+
+	cmp.compar = compar;
+	cmp.compar_r = NULL;
+	cmp.arg = NULL;
+	introsort((char *)base, nmemb, size, qsort_depth(nmemb), &cmp);
+}
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   Same as qsort(), with arg passed as the third argument of each call to
+ *   compar.
+ *
+ ****************************************************************************/
+
+void qsort_r(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *, void *), void *arg)
+{
+	struct qsort_cmp_s cmp;
+
+	cmp.compar = NULL;
+	cmp.compar_r = compar;
+	cmp.arg = arg;
+	introsort((char *)base, nmemb, size, qsort_depth(nmemb), &cmp);
 }
@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/stdlib/lib_radixsort.c
+ *
+ * LSD radix sort of elements by an unsigned 32-bit key, for bulk data
+ * where a comparison sort spends most of its time in the compare calls.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "lib_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The key is sorted one byte per pass, least significant byte first */
+
+#define RADIX_BITS   8
+#define RADIX_SIZE   (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t radix_key(FAR const char *elem, size_t keyoffset)
+{
+	uint32_t key;
+
+	/* The key of a packed element may not be aligned */
+
+	memcpy(&key, elem + keyoffset, sizeof(key));
+	return key;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: radixsort_u32
+ *
+ * Description:
+ *   Sort nmemb elements of the given size in ascending order of the
+ *   uint32_t key found keyoffset bytes into each element.  The sort is
+ *   stable, takes O(n) time and uses a temporary copy of the array.  An
+ *   array of uint32_t values is sorted with size 4 and keyoffset 0.
+ *   Signed keys sort correctly once their sign bit has been flipped.
+ *
+ *   Counts for all the passes are gathered in a single scan, and a pass
+ *   is skipped when all the keys have the same byte in it, so small
+ *   keys cost fewer passes.
+ *
+ * Returned Value:
+ *   0 on success, or -1 with errno set to ENOMEM if the temporary copy
+ *   cannot be allocated, in which case the array is left unchanged.
+ *
+ ****************************************************************************/
+
+int radixsort_u32(FAR void *base, size_t nmemb, size_t size, size_t keyoffset)
+{
+	FAR size_t *counts;
+	FAR char *tmp;
+	FAR char *src;
+	FAR char *dst;
+	FAR char *swp;
+	FAR char *elem;
+	size_t offset;
+	size_t count;
+	size_t i;
+	uint32_t key;
+	int pass;
+	int shift;
+
+	if (nmemb < 2) {
+		return 0;
+	}
+
+	counts = (FAR size_t *)lib_malloc(RADIX_PASSES * RADIX_SIZE * sizeof(size_t) + nmemb * size);
+	if (counts == NULL) {
+		set_errno(ENOMEM);
+		return -1;
+	}
+
+	tmp = (FAR char *)&counts[RADIX_PASSES * RADIX_SIZE];
+	memset(counts, 0, RADIX_PASSES * RADIX_SIZE * sizeof(size_t));
+
+	/* Histogram every byte of the keys at once */
+
+	for (i = 0, elem = (FAR char *)base; i < nmemb; i++, elem += size) {
+		key = radix_key(elem, keyoffset);
+		for (pass = 0; pass < RADIX_PASSES; pass++) {
+			counts[pass * RADIX_SIZE + ((key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1))]++;
+		}
+	}
+
+	src = (FAR char *)base;
+	dst = tmp;
+	for (pass = 0; pass < RADIX_PASSES; pass++) {
+		FAR size_t *bucket = &counts[pass * RADIX_SIZE];
+
+		shift = pass * RADIX_BITS;
+
+		/* Nothing to reorder if every key has the same byte here */
+
+		if (bucket[(radix_key(src, keyoffset) >> shift) & (RADIX_SIZE - 1)] == nmemb) {
+			continue;
+		}
+
+		/* Turn the counts into the starting offsets of each bucket */
+
+		for (i = 0, offset = 0; i < RADIX_SIZE; i++) {
+			count = bucket[i];
+			bucket[i] = offset;
+			offset += count;
+		}
+
+		if (size == sizeof(uint32_t)) {
+			FAR uint32_t *s = (FAR uint32_t *)src;
+			FAR uint32_t *d = (FAR uint32_t *)dst;
+
+			/* The element is the key itself */
+
+			for (i = 0; i < nmemb; i++) {
+				key = radix_key((FAR char *)&s[i], 0);
+				memcpy(&d[bucket[(key >> shift) & (RADIX_SIZE - 1)]++], &key, sizeof(key));
+			}
+		} else {
+			for (i = 0, elem = src; i < nmemb; i++, elem += size) {
+				key = radix_key(elem, keyoffset);
+				memcpy(dst + bucket[(key >> shift) & (RADIX_SIZE - 1)]++ * size, elem, size);
+			}
+		}
+
+		swp = src;
+		src = dst;
+		dst = swp;
+	}
+
+	/* An odd number of passes leaves the result in the temporary copy */
+
+	if (src != (FAR char *)base) {
+		memcpy(base, src, nmemb * size);
+	}
+
+	lib_free(counts);
+	return 0;
+}
@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/time/lib_clocktimepage.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/timepage.h>
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct timepage_s *g_timepage_ptr;
+static bool g_timepage_probed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline void clock_timepage_barrier(void)
+{
+	__asm__ __volatile__("" : : : "memory");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_gettime
+ *
+ * Description:
+ *   Same as clock_gettime() for CLOCK_REALTIME and CLOCK_MONOTONIC, but
+ *   computed from the time page without entering the kernel.  Falls back to
+ *   clock_gettime() if the page is not available.
+ *
+ ****************************************************************************/
+
+int clock_timepage_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+	FAR const volatile struct timepage_s *page;
+	uint32_t seq;
+	uint32_t wraps;
+	uint32_t count;
+	uint64_t base;
+	uint64_t mono;
+	int64_t realoffset;
+	uint32_t mult;
+	uint64_t nsec;
+
+	/* Look the page up once.  Racing callers get the same answer. */
+
+	if (!g_timepage_probed) {
+		g_timepage_ptr = clock_timepage();
+		g_timepage_probed = true;
+	}
+
+	page = g_timepage_ptr;
+	if (page == NULL || (clock_id != CLOCK_REALTIME
+#ifdef CONFIG_CLOCK_MONOTONIC
+						 && clock_id != CLOCK_MONOTONIC
+#endif
+						)) {
+		return clock_gettime(clock_id, tp);
+	}
+
+	/* Read a consistent sample and the counter, retrying if the kernel
+	 * updated the page meanwhile.
+	 */
+
+	do {
+		seq = page->tp_seq;
+		clock_timepage_barrier();
+
+		wraps = page->tp_wraps;
+		count = *page->tp_counter;
+		if (page->tp_wrapstat != NULL && (*page->tp_wrapstat & page->tp_wrapmask) != 0) {
+			/* The counter wrapped but the kernel did not handle it yet.  Read
+			 * it again so that the count is known to be past the wrap.
+			 */
+
+			count = *page->tp_counter;
+			wraps++;
+		}
+
+		if (page->tp_countdown) {
+			count = UINT32_MAX - count;
+		}
+
+		base = page->tp_count;
+		mono = page->tp_mono;
+		realoffset = page->tp_realoffset;
+		mult = page->tp_mult;
+
+		clock_timepage_barrier();
+	} while ((seq & 1) != 0 || page->tp_seq != seq);
+
+	nsec = mono + (((((uint64_t)wraps << 32) | count) - base) * mult >> TIMEPAGE_SHIFT);
+	if (clock_id == CLOCK_REALTIME) {
+		nsec += realoffset;
+	}
+
+	tp->tv_sec = (time_t)(nsec / NSEC_PER_SEC);
+	tp->tv_nsec = (long)(nsec % NSEC_PER_SEC);
+	return OK;
+}
+
+#endif							/* CONFIG_CLOCK_TIMEPAGE */
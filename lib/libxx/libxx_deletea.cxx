@@ -55,6 +55,10 @@
 //***************************************************************************
 
 #include <tinyara/config.h>
+#include <cstddef>
+#ifdef __cpp_aligned_new
+#  include <new>
+#endif
 
 #include "libxx_internal.hxx"
 
@@ -76,5 +80,41 @@
 
 void operator delete[](void *ptr)
 {
-  lib_free(ptr);
+  libxx_free(ptr);
 }
+
+//***************************************************************************
+// Name: delete
+//
+// Description:
+//   C++14 sized and C++17 aligned forms.  The pools find the size class of
+//   an object from its address, so the size adds nothing here.
+//
+//***************************************************************************
+
+#ifdef __cpp_sized_deallocation
+#ifdef CONFIG_CXX_NEWLONG
+void operator delete[](void *ptr, unsigned long nbytes)
+#else
+void operator delete[](void *ptr, unsigned int nbytes)
+#endif
+{
+  libxx_free(ptr);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+void operator delete[](void *ptr, std::align_val_t align)
+{
+  libxx_free(ptr);
+}
+
+#ifdef CONFIG_CXX_NEWLONG
+void operator delete[](void *ptr, unsigned long nbytes, std::align_val_t align)
+#else
+void operator delete[](void *ptr, unsigned int nbytes, std::align_val_t align)
+#endif
+{
+  libxx_free(ptr);
+}
+#endif
@@ -58,6 +58,7 @@
 //***************************************************************************
 
 #include <tinyara/config.h>
+#include <cstddef>
 
 //***************************************************************************
 // Definitions
@@ -76,12 +77,14 @@
 #  define lib_zalloc(s)    kmm_zalloc(s)
 #  define lib_realloc(p,s) kmm_realloc(p,s)
 #  define lib_free(p)      kmm_free(p)
+#  define lib_memalign(a,s) kmm_memalign(a,s)
 #else
 #  include <cstdlib>
 #  define lib_malloc(s)    malloc(s)
 #  define lib_zalloc(s)    zalloc(s)
 #  define lib_realloc(p,s) realloc(p,s)
 #  define lib_free(p)      free(p)
+#  define lib_memalign(a,s) memalign(a,s)
 #endif
 
 //***************************************************************************
@@ -102,4 +105,43 @@ extern "C" FAR void *__dso_handle;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_CXX_NEWPOOL
+FAR void *libxx_poolalloc(size_t nbytes);
+bool libxx_poolfree(FAR void *ptr);
+#endif
+
+//***************************************************************************
+// Inline Functions
+//***************************************************************************
+
+// Allocation and release behind operator new and delete.  Small objects
+// come from the size class pools when they are enabled, everything else
+// and any overflow from the heap.
+
+static inline FAR void *libxx_alloc(size_t nbytes)
+{
+#ifdef CONFIG_CXX_NEWPOOL
+  FAR void *alloc = libxx_poolalloc(nbytes);
+
+  if (alloc != NULL)
+    {
+      return alloc;
+    }
+#endif
+
+  return lib_malloc(nbytes);
+}
+
+static inline void libxx_free(FAR void *ptr)
+{
+#ifdef CONFIG_CXX_NEWPOOL
+  if (libxx_poolfree(ptr))
+    {
+      return;
+    }
+#endif
+
+  lib_free(ptr);
+}
+
 #endif // __LIBXX_LIBXX_INTERNAL_HXX
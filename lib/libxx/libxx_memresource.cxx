@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+//***************************************************************************
+// libxx/libxx_memresource.cxx
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <tinyara/config.h>
+#include <cstddef>
+#include <stdint.h>
+
+#include <tinyara/mm/mm.h>
+#include <tinyara/memory_resource.hxx>
+
+#include "libxx_internal.hxx"
+
+//***************************************************************************
+// Definitions
+//***************************************************************************
+
+// Alignment of every heap and pool allocation
+
+#define LIBXX_MINALIGN     8
+
+// First upstream chunk of a monotonic_buffer_resource
+
+#define LIBXX_CHUNKSIZE    256
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+namespace
+{
+  class new_delete_resource_imp : public tinyara::pmr::memory_resource
+  {
+  protected:
+    FAR void *do_allocate(size_t nbytes, size_t align)
+    {
+      if (align <= LIBXX_MINALIGN)
+        {
+          return ::operator new(nbytes);
+        }
+
+      return lib_memalign(align, nbytes);
+    }
+
+    void do_deallocate(FAR void *ptr, size_t nbytes, size_t align)
+    {
+      if (align <= LIBXX_MINALIGN)
+        {
+          ::operator delete(ptr);
+        }
+      else
+        {
+          lib_free(ptr);
+        }
+    }
+  };
+
+  // Header of an upstream chunk of a monotonic_buffer_resource
+
+  struct libxx_chunk_s
+  {
+    FAR struct libxx_chunk_s *next;
+    size_t size;
+  };
+}
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static new_delete_resource_imp g_newdelete;
+static FAR tinyara::pmr::memory_resource *g_defresource = &g_newdelete;
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace tinyara
+{
+namespace pmr
+{
+  FAR memory_resource *new_delete_resource()
+  {
+    return &g_newdelete;
+  }
+
+  FAR memory_resource *get_default_resource()
+  {
+    return g_defresource;
+  }
+
+  FAR memory_resource *set_default_resource(FAR memory_resource *r)
+  {
+    FAR memory_resource *prev = g_defresource;
+
+    g_defresource = r ? r : &g_newdelete;
+    return prev;
+  }
+
+  //*************************************************************************
+  // heap_resource
+  //*************************************************************************
+
+  FAR void *heap_resource::do_allocate(size_t nbytes, size_t align)
+  {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+    mmaddress_t retaddr = (mmaddress_t)__builtin_return_address(0);
+
+    if (align <= LIBXX_MINALIGN)
+      {
+        return mm_malloc(m_heap, nbytes, retaddr);
+      }
+
+    return mm_memalign(m_heap, align, nbytes, retaddr);
+#else
+    if (align <= LIBXX_MINALIGN)
+      {
+        return mm_malloc(m_heap, nbytes);
+      }
+
+    return mm_memalign(m_heap, align, nbytes);
+#endif
+  }
+
+  void heap_resource::do_deallocate(FAR void *ptr, size_t nbytes, size_t align)
+  {
+    mm_free(m_heap, ptr);
+  }
+
+  //*************************************************************************
+  // monotonic_buffer_resource
+  //*************************************************************************
+
+  monotonic_buffer_resource::monotonic_buffer_resource(FAR memory_resource *upstream)
+    : m_upstream(upstream ? upstream : get_default_resource()),
+      m_chunks(NULL), m_buffer(NULL), m_bufsize(0), m_cur(NULL), m_avail(0),
+      m_nextsize(LIBXX_CHUNKSIZE)
+  {
+  }
+
+  monotonic_buffer_resource::monotonic_buffer_resource(FAR void *buffer, size_t size,
+                                                       FAR memory_resource *upstream)
+    : m_upstream(upstream ? upstream : get_default_resource()),
+      m_chunks(NULL), m_buffer(buffer), m_bufsize(size),
+      m_cur(static_cast<FAR char *>(buffer)), m_avail(size),
+      m_nextsize(size > LIBXX_CHUNKSIZE ? 2 * size : LIBXX_CHUNKSIZE)
+  {
+  }
+
+  monotonic_buffer_resource::~monotonic_buffer_resource()
+  {
+    release();
+  }
+
+  void monotonic_buffer_resource::release()
+  {
+    FAR struct libxx_chunk_s *chunk = static_cast<FAR struct libxx_chunk_s *>(m_chunks);
+
+    while (chunk != NULL)
+      {
+        FAR struct libxx_chunk_s *next = chunk->next;
+
+        m_upstream->deallocate(chunk, chunk->size, LIBXX_MINALIGN);
+        chunk = next;
+      }
+
+    m_chunks = NULL;
+    m_cur    = static_cast<FAR char *>(m_buffer);
+    m_avail  = m_bufsize;
+  }
+
+  FAR void *monotonic_buffer_resource::do_allocate(size_t nbytes, size_t align)
+  {
+    size_t pad = (size_t)(-(uintptr_t)m_cur) & (align - 1);
+
+    if (pad + nbytes > m_avail)
+      {
+        // Start a new upstream chunk big enough for the request
+
+        FAR struct libxx_chunk_s *chunk;
+        size_t hdrsize = (sizeof(struct libxx_chunk_s) + LIBXX_MINALIGN - 1) & ~(LIBXX_MINALIGN - 1);
+        size_t size = m_nextsize;
+
+        while (size < hdrsize + nbytes + align)
+          {
+            size *= 2;
+          }
+
+        chunk = static_cast<FAR struct libxx_chunk_s *>(m_upstream->allocate(size, LIBXX_MINALIGN));
+        if (chunk == NULL)
+          {
+            return NULL;
+          }
+
+        chunk->next = static_cast<FAR struct libxx_chunk_s *>(m_chunks);
+        chunk->size = size;
+        m_chunks    = chunk;
+        m_cur       = reinterpret_cast<FAR char *>(chunk) + hdrsize;
+        m_avail     = size - hdrsize;
+        m_nextsize  = 2 * size;
+        pad         = (size_t)(-(uintptr_t)m_cur) & (align - 1);
+      }
+
+    FAR void *ptr = m_cur + pad;
+
+    m_cur   += pad + nbytes;
+    m_avail -= pad + nbytes;
+    return ptr;
+  }
+}
+}
@@ -57,6 +57,9 @@
 #include <tinyara/config.h>
 #include <cstddef>
 #include <debug.h>
+#ifdef __cpp_aligned_new
+#  include <new>
+#endif
 
 #include "libxx_internal.hxx"
 
@@ -102,7 +105,7 @@ void *operator new(unsigned int nbytes)
 
   // Perform the allocation
 
-  void *alloc = lib_malloc(nbytes);
+  void *alloc = libxx_alloc(nbytes);
 
 #ifdef CONFIG_DEBUG
   if (alloc == 0)
@@ -118,3 +121,46 @@ void *operator new(unsigned int nbytes)
 
   return alloc;
 }
+
+//***************************************************************************
+// Name: new
+//
+// Description:
+//   C++17 allocation of over-aligned types.  Alignments up to 8 bytes are
+//   already honoured by the pools and the heap.
+//
+//***************************************************************************
+
+#ifdef __cpp_aligned_new
+#ifdef CONFIG_CXX_NEWLONG
+void *operator new(unsigned long nbytes, std::align_val_t align)
+#else
+void *operator new(unsigned int nbytes, std::align_val_t align)
+#endif
+{
+  void *alloc;
+
+  if (nbytes < 1)
+  {
+    nbytes = 1;
+  }
+
+  if ((size_t)align <= 8)
+  {
+    alloc = libxx_alloc(nbytes);
+  }
+  else
+  {
+    alloc = lib_memalign((size_t)align, nbytes);
+  }
+
+#ifdef CONFIG_DEBUG
+  if (alloc == 0)
+  {
+    dbg("Failed to allocate\n");
+  }
+#endif
+
+  return alloc;
+}
+#endif
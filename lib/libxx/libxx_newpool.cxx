@@ -0,0 +1,231 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+//***************************************************************************
+// libxx/libxx_newpool.cxx
+//
+// Pools for small operator new allocations.  A static arena is split into
+// one equal region per 8-byte size class.  Objects of a class are carved
+// from its region and recycled through a LIFO free list, so they carry no
+// heap header and need no heap semaphore.  The owner of a pointer and its
+// size class follow from its address alone, which is what lets the
+// unsized operator delete find the right free list.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <tinyara/config.h>
+#include <cstddef>
+#include <stdint.h>
+
+#include <arch/irq.h>
+
+#include "libxx_internal.hxx"
+
+#ifdef CONFIG_CXX_NEWPOOL
+
+//***************************************************************************
+// Definitions
+//***************************************************************************
+
+#define POOL_ALIGN      8
+#define POOL_NCLASSES   ((CONFIG_CXX_NEWPOOL_MAXSIZE + POOL_ALIGN - 1) / POOL_ALIGN)
+#define POOL_REGION     ((CONFIG_CXX_NEWPOOL_SIZE / POOL_NCLASSES) & ~(POOL_ALIGN - 1))
+#define POOL_SIZE       (POOL_REGION * POOL_NCLASSES)
+
+// ARMv7 cores update the free lists with LDREX/STREX.  The exclusive
+// monitor is cleared on every exception, so a pop that was preempted
+// retries instead of suffering from ABA.  Other cores disable interrupts.
+
+#if defined(CONFIG_ARCH_CORTEXR4) || defined(CONFIG_ARCH_CORTEXM3) || \
+    defined(CONFIG_ARCH_CORTEXM4)
+#  define POOL_HAVE_LDREX 1
+#endif
+
+#define POOL_NEXT(obj)  (*(FAR void **)(obj))
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+struct libxx_poolclass_s
+{
+  FAR void *freelist;         // LIFO list of recycled objects
+  uintptr_t carved;           // Bytes of the region handed out so far
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static uint64_t g_poolarena[POOL_SIZE / sizeof(uint64_t)];
+static struct libxx_poolclass_s g_poolclass[POOL_NCLASSES];
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static inline void libxx_poolpush(FAR struct libxx_poolclass_s *pc, FAR void *obj)
+{
+#ifdef POOL_HAVE_LDREX
+  FAR void *head;
+  int failed;
+
+  do
+    {
+      __asm__ __volatile__("ldrex %0, [%1]" : "=&r"(head) : "r"(&pc->freelist) : "memory");
+      POOL_NEXT(obj) = head;
+      __asm__ __volatile__("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&pc->freelist), "r"(obj) : "memory");
+    }
+  while (failed);
+#else
+  irqstate_t flags = irqsave();
+  POOL_NEXT(obj) = pc->freelist;
+  pc->freelist = obj;
+  irqrestore(flags);
+#endif
+}
+
+static inline FAR void *libxx_poolpop(FAR struct libxx_poolclass_s *pc)
+{
+  FAR void *head;
+#ifdef POOL_HAVE_LDREX
+  int failed;
+
+  do
+    {
+      __asm__ __volatile__("ldrex %0, [%1]" : "=&r"(head) : "r"(&pc->freelist) : "memory");
+      if (head == NULL)
+        {
+          __asm__ __volatile__("clrex" : : : "memory");
+          break;
+        }
+
+      __asm__ __volatile__("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&pc->freelist), "r"(POOL_NEXT(head)) : "memory");
+    }
+  while (failed);
+#else
+  irqstate_t flags = irqsave();
+  head = pc->freelist;
+  if (head)
+    {
+      pc->freelist = POOL_NEXT(head);
+    }
+
+  irqrestore(flags);
+#endif
+
+  return head;
+}
+
+// Take a never used object of objsize bytes from the region of a class
+
+static inline FAR void *libxx_poolcarve(FAR struct libxx_poolclass_s *pc, int ndx, uintptr_t objsize)
+{
+  uintptr_t offset;
+#ifdef POOL_HAVE_LDREX
+  int failed;
+
+  do
+    {
+      __asm__ __volatile__("ldrex %0, [%1]" : "=&r"(offset) : "r"(&pc->carved) : "memory");
+      if (offset + objsize > POOL_REGION)
+        {
+          __asm__ __volatile__("clrex" : : : "memory");
+          return NULL;
+        }
+
+      __asm__ __volatile__("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&pc->carved), "r"(offset + objsize) : "memory");
+    }
+  while (failed);
+#else
+  irqstate_t flags = irqsave();
+  offset = pc->carved;
+  if (offset + objsize > POOL_REGION)
+    {
+      irqrestore(flags);
+      return NULL;
+    }
+
+  pc->carved = offset + objsize;
+  irqrestore(flags);
+#endif
+
+  return (FAR uint8_t *)g_poolarena + ndx * POOL_REGION + offset;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_poolalloc
+//
+// Description:
+//   Return an object of at least nbytes (> 0) from the pools, or NULL if
+//   the size is not pooled or its class is exhausted.
+//
+//***************************************************************************
+
+FAR void *libxx_poolalloc(size_t nbytes)
+{
+  FAR struct libxx_poolclass_s *pc;
+  FAR void *obj;
+  int ndx;
+
+  ndx = (int)((nbytes - 1) / POOL_ALIGN);
+  if (ndx >= POOL_NCLASSES)
+    {
+      return NULL;
+    }
+
+  pc = &g_poolclass[ndx];
+  obj = libxx_poolpop(pc);
+  if (obj == NULL)
+    {
+      obj = libxx_poolcarve(pc, ndx, (ndx + 1) * POOL_ALIGN);
+    }
+
+  return obj;
+}
+
+//***************************************************************************
+// Name: libxx_poolfree
+//
+// Description:
+//   Recycle ptr if it came from the pools and return true, otherwise
+//   return false and leave it to the heap.
+//
+//***************************************************************************
+
+bool libxx_poolfree(FAR void *ptr)
+{
+  uintptr_t offset = (uintptr_t)ptr - (uintptr_t)g_poolarena;
+
+  if (offset >= POOL_SIZE)
+    {
+      return false;
+    }
+
+  libxx_poolpush(&g_poolclass[offset / POOL_REGION], ptr);
+  return true;
+}
+
+#endif // CONFIG_CXX_NEWPOOL
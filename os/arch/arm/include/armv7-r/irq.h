@@ -326,6 +326,14 @@ struct xcptcontext {
 	uintptr_t far;
 #endif
 
+#ifdef CONFIG_ARMV7R_STACKCHECK
+	/* The lowest stack pointer seen on function entry, the high-water mark
+	 * of the thread's stack (see arm_stackcheck.c).
+	 */
+
+	uintptr_t stackmin;
+#endif
+
 #ifdef CONFIG_LIB_SYSCALL
 	/* The following array holds the return address and the exc_return value
 	 * needed to return from each nested system call.
@@ -373,6 +381,21 @@ struct xcptcontext {
 
 #ifndef __ASSEMBLY__
 
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+/* Critical section timing, see kernel/irq/irq_latency.c */
+
+#define IRQ_CPSR_I (1 << 7)		/* CPSR IRQ mask bit */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void irq_csbegin(void);
+void irq_csend(void);
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 /* Return the current IRQ state */
 
 static inline irqstate_t irqstate(void)
@@ -408,6 +431,12 @@ static inline irqstate_t irqsave(void)
 		: "memory"
 	);
 
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	if ((cpsr & IRQ_CPSR_I) == 0) {
+		irq_csbegin();
+	}
+#endif
+
 	return cpsr;
 }
 
@@ -417,6 +446,10 @@ static inline irqstate_t irqenable(void)
 {
 	unsigned int cpsr;
 
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	irq_csend();
+#endif
+
 	__asm__ __volatile__
 	(
 		"\tmrs    %0, cpsr\n"
@@ -436,6 +469,12 @@ static inline irqstate_t irqenable(void)
 
 static inline void irqrestore(irqstate_t flags)
 {
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	if ((flags & IRQ_CPSR_I) == 0) {
+		irq_csend();
+	}
+#endif
+
 	__asm__ __volatile__
 	(
 		"msr    cpsr_c, %0"
@@ -91,7 +91,7 @@
  *
  ****************************************************************************/
 
-void up_block_task(struct tcb_s *tcb, tstate_t task_state)
+void ramfunc_function up_block_task(struct tcb_s *tcb, tstate_t task_state)
 {
 	struct tcb_s *rtcb = this_task();
 	bool switch_needed;
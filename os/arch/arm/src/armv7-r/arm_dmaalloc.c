@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_dmaalloc.c
+ *
+ * DMA buffers.  Coherent buffers come from a heap of their own in memory
+ * that the MPU maps non-cacheable, so they never need cache maintenance.
+ * Streaming buffers come from the kernel heap, aligned to and padded to
+ * whole cache lines so that cleaning or invalidating them cannot touch
+ * neighbouring data.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+
+#include "cache.h"
+#include "cp15_cacheops.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARCH_DMA_ALLOC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DMA_POOL_START          ((uintptr_t)CONFIG_ARCH_DMA_COHERENT_BASE)
+#define DMA_POOL_END            (DMA_POOL_START + CONFIG_ARCH_DMA_COHERENT_SIZE)
+
+#define DMA_LINE_ALIGN(n)       (((n) + CP15_L1_LINESIZE - 1) & ~(CP15_L1_LINESIZE - 1))
+
+#define dma_is_coherent(a)      ((uintptr_t)(a) >= DMA_POOL_START && (uintptr_t)(a) < DMA_POOL_END)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_heap_s g_dmaheap;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_dma_initialize
+ *
+ * Description:
+ *   Create the coherent buffer heap.  Called once from up_initialize().
+ *
+ ****************************************************************************/
+
+void up_dma_initialize(void)
+{
+	mm_initialize(&g_dmaheap, (FAR void *)DMA_POOL_START, CONFIG_ARCH_DMA_COHERENT_SIZE);
+}
+
+/****************************************************************************
+ * Name: up_dma_alloc
+ *
+ * Description:
+ *   Allocate a DMA buffer of the given type, DMA_COHERENT or DMA_STREAMING.
+ *   The buffer starts on a cache line boundary.
+ *
+ ****************************************************************************/
+
+FAR void *up_dma_alloc(size_t size, int type)
+{
+	FAR void *mem;
+
+	size = DMA_LINE_ALIGN(size);
+
+	if (type == DMA_COHERENT) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		mem = mm_memalign(&g_dmaheap, CP15_L1_LINESIZE, size, __builtin_return_address(0));
+#else
+		mem = mm_memalign(&g_dmaheap, CP15_L1_LINESIZE, size);
+#endif
+	} else {
+		mem = kmm_memalign(CP15_L1_LINESIZE, size);
+	}
+
+	if (mem == NULL) {
+		mdbg("%s DMA allocation of %u bytes failed\n", type == DMA_COHERENT ? "Coherent" : "Streaming", size);
+	}
+
+	return mem;
+}
+
+/****************************************************************************
+ * Name: up_dma_free
+ *
+ * Description:
+ *   Free a buffer allocated with up_dma_alloc().
+ *
+ ****************************************************************************/
+
+void up_dma_free(FAR void *mem)
+{
+	if (dma_is_coherent(mem)) {
+		mm_free(&g_dmaheap, mem);
+	} else {
+		kmm_free(mem);
+	}
+}
+
+/****************************************************************************
+ * Name: up_dma_sync
+ *
+ * Description:
+ *   Make a DMA buffer consistent between the CPU and a device.  Call it
+ *   before starting a transfer and, for DMA_FROM_DEVICE, once more after
+ *   the transfer before the CPU reads the data.  Coherent buffers only
+ *   need the memory accesses to be ordered.
+ *
+ ****************************************************************************/
+
+void up_dma_sync(FAR void *mem, size_t size, int dir)
+{
+	uintptr_t start = (uintptr_t)mem;
+	uintptr_t end = start + size;
+
+	if (dma_is_coherent(mem)) {
+		ARM_DSB();
+		return;
+	}
+
+	switch (dir) {
+	case DMA_TO_DEVICE:
+		arch_clean_dcache(start, end);
+		break;
+
+	case DMA_FROM_DEVICE:
+		arch_invalidate_dcache(start, end);
+		break;
+
+	default:
+		arch_flush_dcache(start, end);
+		break;
+	}
+}
+
+#endif							/* CONFIG_ARCH_DMA_ALLOC */
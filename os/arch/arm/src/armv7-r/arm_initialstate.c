@@ -108,6 +108,12 @@ void up_initial_state(struct tcb_s *tcb)
 
 	xcp->regs[REG_SP] = (uint32_t)tcb->adj_stack_ptr;
 
+#ifdef CONFIG_ARMV7R_STACKCHECK
+	/* No stack used yet */
+
+	xcp->stackmin = STACKMIN_NONE;
+#endif
+
 	/* Save the task entry point */
 
 	xcp->regs[REG_PC] = (uint32_t)tcb->start;
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_stackcheck.c
+ *
+ * Stack high-water marks without painting the stacks.  Everything is built
+ * with -finstrument-functions and each function entry lowers the recorded
+ * minimum stack pointer of the running thread.  up_check_tcbstack() then
+ * only has to subtract it from the top of the stack.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7R_STACKCHECK
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Set once an overflow has been reported, the PANIC() path is instrumented
+ * too.
+ */
+
+static bool g_stackoverflow;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+void __cyg_profile_func_enter(void *func, void *caller) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *func, void *caller) __attribute__((no_instrument_function));
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __cyg_profile_func_enter
+ *
+ * Description:
+ *   Called on entry to every instrumented function.  Records the stack
+ *   pointer if it is the lowest seen so far on the stack of the running
+ *   thread and stops the system if it gets within
+ *   CONFIG_ARMV7R_STACKCHECK_MARGIN bytes of the bottom of the stack.
+ *
+ *   Stack pointers outside the thread's stack, i.e. on the interrupt stack
+ *   or before the thread's stack is set up, are ignored.
+ *
+ ****************************************************************************/
+
+void __cyg_profile_func_enter(void *func, void *caller)
+{
+	FAR struct tcb_s *rtcb = this_task();
+	uintptr_t base;
+	uintptr_t sp;
+
+	__asm__ __volatile__("mov %0, sp" : "=r"(sp));
+
+	/* The common case: not deeper than before */
+
+	if (rtcb == NULL || sp >= rtcb->xcp.stackmin) {
+		return;
+	}
+
+	base = (uintptr_t)rtcb->stack_alloc_ptr;
+	if (sp < base || sp >= base + rtcb->adj_stack_size) {
+		return;
+	}
+
+	rtcb->xcp.stackmin = sp;
+
+	if (sp - base < CONFIG_ARMV7R_STACKCHECK_MARGIN && !g_stackoverflow) {
+		g_stackoverflow = true;
+		lldbg("Stack overflow: pid %d sp %08x base %08x in %p from %p\n", rtcb->pid, sp, base, func, caller);
+		PANIC();
+	}
+}
+
+/****************************************************************************
+ * Name: __cyg_profile_func_exit
+ ****************************************************************************/
+
+void __cyg_profile_func_exit(void *func, void *caller)
+{
+}
+
+#endif							/* CONFIG_ARMV7R_STACKCHECK */
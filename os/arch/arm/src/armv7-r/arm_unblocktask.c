@@ -99,7 +99,7 @@
  *
  ****************************************************************************/
 
-void up_unblock_task(struct tcb_s *tcb)
+void ramfunc_function up_unblock_task(struct tcb_s *tcb)
 {
 	struct tcb_s *rtcb = this_task();
 
@@ -826,6 +826,44 @@ static inline void mpu_peripheral(uintptr_t base, size_t size)
 	mpu_set_drsr(regval);
 }
 
+/****************************************************************************
+ * Name: mpu_user_peripheral_ro
+ *
+ * Description:
+ *   Configure a region as periperal address space that user code may read
+ *
+ ****************************************************************************/
+
+static inline void mpu_user_peripheral_ro(uintptr_t base, size_t size)
+{
+	unsigned int region = mpu_allocregion();
+	uint32_t regval;
+	uint8_t l2size;
+	uint8_t subregions;
+
+	/* Select the region */
+	mpu_set_rgnr(region);
+
+	/* Select the region base address */
+	mpu_set_drbar(base & MPU_RBAR_ADDR_MASK);
+
+	/* Select the region size and the sub-region map */
+	l2size = mpu_log2regionceil(size);
+	subregions = mpu_subregion(base, size, l2size);
+
+	/* Then configure the region */
+	regval = MPU_RACR_S				| /* Shareable     */
+		 MPU_RACR_B				| /* Bufferable    */
+		 MPU_RACR_AP_RWRO			| /* P:RW   U:RO   */
+		 MPU_RACR_XN;				  /* Instruction access disable */
+	mpu_set_dracr(regval);
+
+	regval = MPU_RASR_ENABLE			| /* Enable region */
+		 MPU_RASR_RSIZE_LOG2((uint32_t)l2size)	| /* Region size   */
+		 ((uint32_t)subregions << MPU_RASR_SRD_SHIFT); /* Sub-regions */
+	mpu_set_drsr(regval);
+}
+
 /****************************************************************************
  * Name: mpu_priv_intsram_wb
  *
@@ -866,6 +904,15 @@ static inline void mpu_priv_intsram_wb(uintptr_t base, size_t size)
 	mpu_set_drsr(regval);
 }
 
+/****************************************************************************
+ * Name: mpu_user_intsram_ro
+ *
+ * Description:
+ *   Configure a region as internal SRAM that is read-only for user code,
+ *   with WB/WA cache policy
+ *
+ ****************************************************************************/
+
 static inline void mpu_user_intsram_ro(uintptr_t base, size_t size)
 {
 	unsigned int region = mpu_allocregion();
@@ -888,7 +935,7 @@ static inline void mpu_user_intsram_ro(uintptr_t base, size_t size)
 	regval =					  /* Not Cacheable  */
 		 MPU_RACR_B				| /* Not Bufferable */
 		 MPU_RACR_TEX(5)			| /* TEX */
-		 MPU_RACR_AP_RWNO;			  /* P:RW   U:NO */
+		 MPU_RACR_AP_RWRO;			  /* P:RW   U:RO */
 	mpu_set_dracr(regval);
 
 	regval = MPU_RASR_ENABLE			| /* Enable region */
@@ -268,9 +268,9 @@
 #define PCMR_IMP_SHIFT     (24)	/* Bits 24-31: Implementer code */
 #define PCMR_IMP_MASK      (0xff << PCMR_IMP_SHIFT)
 
-/* 32-bit Performance Monitors Count Enable Set register (PMCNTENSET): CRn=c9, opc1=0, CRm=c12, opc2=1
- * TODO: To be provided
- */
+/* 32-bit Performance Monitors Count Enable Set register (PMCNTENSET): CRn=c9, opc1=0, CRm=c12, opc2=1 */
+
+#define PMCNTENSET_C       (1 << 31)	/* Enable the cycle counter (PMCCNTR) */
 
 /* 32-bit Performance Monitors Count Enable Clear register (PMCNTENCLR): CRn=c9, opc1=0, CRm=c12, opc2=2
  * TODO: To be provided
@@ -530,6 +530,35 @@ static inline void cp15_wrpmcr(unsigned int pmcr)
 	);
 }
 
+/* Write the Performance Monitors Count Enable Set register (PMCNTENSET) */
+
+static inline void cp15_wrpmcntenset(unsigned int pmcntenset)
+{
+	__asm__ __volatile__
+	(
+		"\tmcr p15, 0, %0, c9, c12, 1\n"
+		:
+		: "r"(pmcntenset)
+		: "memory"
+	);
+}
+
+/* Read the Performance Monitors Cycle Count Register (PMCCNTR) */
+
+static inline unsigned int cp15_rdpmccntr(void)
+{
+	unsigned int pmccntr;
+	__asm__ __volatile__
+	(
+		"\tmrc p15, 0, %0, c9, c13, 0\n"
+		: "=r"(pmccntr)
+		:
+		: "memory"
+	);
+
+	return pmccntr;
+}
+
 #endif							/* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -72,4 +72,19 @@ enum configdata_id {
 };
 #endif
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Board initialization steps, see artik053_tash.c */
+
+int artik053_configure_partitions(void);
+int artik053_userfs_initialize(void);
+int artik053_procfs_initialize(void);
+int artik053_rammtd_initialize(void);
+int artik053_rtc_initialize(void);
+int artik053_timer_initialize(void);
+int artik053_adc_setup(void);
+int artik053_wpa_ctrl_initialize(void);
+
 #endif /* __ARCH_ARM_SRC_ARTIK053_SRC_ARTIK053_H__ */
@@ -60,10 +60,14 @@
 #include <assert.h>
 
 #include <tinyara/gpio.h>
+#include <tinyara/board.h>
+#include <tinyara/bootinit.h>
 
 #include "up_arch.h"
 #include "s5j_gpio.h"
 
+#include "artik053.h"
+
 /*****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -196,10 +200,80 @@ void s5j_board_initialize(void)
  *   may be used, for example, to initialize board-specific device drivers.
  *
  ****************************************************************************/
+#ifdef CONFIG_BOOTINIT
+static int artik053_wlan_initialize(void)
+{
+#ifdef CONFIG_SCSC_WLAN
+	slsi_driver_initialize();
+#endif
+	return OK;
+}
+
+static int artik053_pwm_initialize(void)
+{
+#ifdef CONFIG_S5J_PWM
+	return board_pwm_setup();
+#else
+	return OK;
+#endif
+}
+
+static int artik053_gpio_initialize(void)
+{
+	board_gpio_initialize();
+	return OK;
+}
+
+static int artik053_i2c_initialize(void)
+{
+	board_i2c_initialize();
+	return OK;
+}
+
+/* The partitions must exist before the user file system is mounted and
+ * the WPA control FIFOs before the Wi-Fi driver starts; everything else is
+ * independent, so the SMART scan and the Wi-Fi firmware download overlap.
+ */
+
+enum {
+	ARTIK053_STEP_PARTITIONS,
+	ARTIK053_STEP_USERFS,
+	ARTIK053_STEP_PROCFS,
+	ARTIK053_STEP_RAMMTD,
+	ARTIK053_STEP_WPA_CTRL,
+	ARTIK053_STEP_WLAN,
+	ARTIK053_STEP_RTC,
+	ARTIK053_STEP_TIMER,
+	ARTIK053_STEP_ADC,
+	ARTIK053_STEP_PWM,
+	ARTIK053_STEP_GPIO,
+	ARTIK053_STEP_I2C,
+	ARTIK053_NSTEPS
+};
+
+static const struct bootinit_step_s g_artik053_steps[ARTIK053_NSTEPS] = {
+	[ARTIK053_STEP_PARTITIONS] = { "partitions", artik053_configure_partitions, 0 },
+	[ARTIK053_STEP_USERFS]     = { "userfs", artik053_userfs_initialize, BOOTINIT_DEP(ARTIK053_STEP_PARTITIONS) },
+	[ARTIK053_STEP_PROCFS]     = { "procfs", artik053_procfs_initialize, 0 },
+	[ARTIK053_STEP_RAMMTD]     = { "rammtd", artik053_rammtd_initialize, 0 },
+	[ARTIK053_STEP_WPA_CTRL]   = { "wpa_ctrl", artik053_wpa_ctrl_initialize, 0 },
+	[ARTIK053_STEP_WLAN]       = { "wlan", artik053_wlan_initialize, BOOTINIT_DEP(ARTIK053_STEP_WPA_CTRL) },
+	[ARTIK053_STEP_RTC]        = { "rtc", artik053_rtc_initialize, 0 },
+	[ARTIK053_STEP_TIMER]      = { "timer", artik053_timer_initialize, 0 },
+	[ARTIK053_STEP_ADC]        = { "adc", artik053_adc_setup, 0 },
+	[ARTIK053_STEP_PWM]        = { "pwm", artik053_pwm_initialize, 0 },
+	[ARTIK053_STEP_GPIO]       = { "gpio", artik053_gpio_initialize, 0 },
+	[ARTIK053_STEP_I2C]        = { "i2c", artik053_i2c_initialize, 0 },
+};
+#endif /* CONFIG_BOOTINIT */
+
 void board_initialize(void)
 {
 	artik053_clear_bootcount();
 
+#ifdef CONFIG_BOOTINIT
+	bootinit_run(g_artik053_steps, ARTIK053_NSTEPS);
+#else
 	/* Perform app-specific initialization here instaed of from the TASH. */
 	board_app_initialize();
 
@@ -213,5 +287,6 @@ void board_initialize(void)
 
 	board_gpio_initialize();
 	board_i2c_initialize();
+#endif /* CONFIG_BOOTINIT */
 }
 #endif /* CONFIG_BOARD_INITIALIZE */
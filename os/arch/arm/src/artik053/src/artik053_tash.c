@@ -116,7 +116,15 @@ int artik053_adc_setup(void)
 	return OK;
 }
 
-static void artik053_configure_partitions(void)
+/****************************************************************************
+ * Name: artik053_configure_partitions
+ *
+ * Description:
+ *   Split the flash into the configured partitions and attach FTL, MTD
+ *   config or SMART to them.
+ *
+ ****************************************************************************/
+int artik053_configure_partitions(void)
 {
 #if defined(CONFIG_ARTIK053_FLASH_PART)
 	int partno;
@@ -132,12 +140,12 @@ static void artik053_configure_partitions(void)
 	mtd = progmem_initialize();
 	if (!mtd) {
 		lldbg("ERROR: progmem_initialize failed\n");
-		return;
+		return -ENODEV;
 	}
 
 	if (mtd->ioctl(mtd, MTDIOC_GEOMETRY, (unsigned long)&geo) < 0) {
 		lldbg("ERROR: mtd->ioctl failed\n");
-		return;
+		return -ENODEV;
 	}
 
 	partno = 0;
@@ -151,12 +159,12 @@ static void artik053_configure_partitions(void)
 
 		if (partsize < geo.erasesize) {
 			lldbg("ERROR: Partition size is lesser than erasesize\n");
-			return;
+			return -EINVAL;
 		}
 
 		if (partsize % geo.erasesize != 0) {
 			lldbg("ERROR: Partition size is not multiple of erasesize\n");
-			return;
+			return -EINVAL;
 		}
 
 		mtd_part = mtd_partition(mtd, partoffset, partsize / geo.erasesize, partno);
@@ -164,7 +172,7 @@ static void artik053_configure_partitions(void)
 
 		if (!mtd_part) {
 			lldbg("ERROR: failed to create partition.\n");
-			return;
+			return -ENOMEM;
 		}
 #if defined(CONFIG_MTD_FTL)
 		if (!strncmp(types, "ftl,", 4)) {
@@ -225,9 +233,18 @@ static void artik053_configure_partitions(void)
 		partno++;
 	}
 #endif /* CONFIG_ARTIK053_FLASH_PART */
+
+	return OK;
 }
 
-static void scsc_wpa_ctrl_iface_init(void)
+/****************************************************************************
+ * Name: artik053_wpa_ctrl_initialize
+ *
+ * Description:
+ *   Create the FIFOs through which the WPA supplicant is controlled.
+ *
+ ****************************************************************************/
+int artik053_wpa_ctrl_initialize(void)
 {
 #ifdef CONFIG_SCSC_WLAN
 	int ret;
@@ -235,121 +252,177 @@ static void scsc_wpa_ctrl_iface_init(void)
 	ret = mkfifo("/dev/wpa_ctrl_req", 666);
 	if (ret != 0 && ret != -EEXIST) {
 		lldbg("mkfifo error ret:%d\n", ret);
-		return;
+		return ret;
 	}
 
 	ret = mkfifo("/dev/wpa_ctrl_cfm", 666);
 	if (ret != 0 && ret != -EEXIST) {
 		lldbg("mkfifo error ret:%d\n", ret);
-		return;
+		return ret;
 	}
 
 	ret = mkfifo("/dev/wpa_monitor", 666);
 	if (ret != 0 && ret != -EEXIST) {
 		lldbg("mkfifo error ret:%d\n", ret);
-		return;
+		return ret;
 	}
 #endif
-}
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+	return OK;
+}
 
 /****************************************************************************
- * Name: board_app_initialize
+ * Name: artik053_userfs_initialize
  *
  * Description:
- *   Perform architecture specific initialization
+ *   Mount the user partition, formatting it first if needed.  The SMART
+ *   scan makes this one of the slowest steps of the bring-up.
  *
  ****************************************************************************/
-int board_app_initialize(void)
+int artik053_userfs_initialize(void)
 {
+#ifdef CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME
 	int ret;
-#if defined(CONFIG_RAMMTD) && defined(CONFIG_FS_SMARTFS)
-	int bufsize = CONFIG_RAMMTD_ERASESIZE * CONFIG_ARTIK053_RAMMTD_NEBLOCKS;
-	static uint8_t *rambuf;
-	struct mtd_dev_s *mtd;
-#endif /* CONFIG_RAMMTD */
-
-	artik053_configure_partitions();
 
-#ifdef CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME
-	/* Initialize and mount user partition (if we have) */
 	ret = mksmartfs(CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME, false);
 	if (ret != OK) {
 		lldbg("ERROR: mksmartfs on %s failed", CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME);
-	} else {
-		ret = mount(CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME, CONFIG_ARTIK053_AUTOMOUNT_USERFS_MOUNTPOINT, "smartfs", 0, NULL);
-		if (ret != OK) {
-			lldbg("ERROR: mounting '%s' failed\n", CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME);
-		}
+		return ret;
+	}
+
+	ret = mount(CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME, CONFIG_ARTIK053_AUTOMOUNT_USERFS_MOUNTPOINT, "smartfs", 0, NULL);
+	if (ret != OK) {
+		lldbg("ERROR: mounting '%s' failed\n", CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME);
+		return ret;
 	}
 #endif /* CONFIG_ARTIK053_AUTOMOUNT_USERFS_DEVNAME */
 
+	return OK;
+}
+
+/****************************************************************************
+ * Name: artik053_procfs_initialize
+ ****************************************************************************/
+int artik053_procfs_initialize(void)
+{
 #ifdef CONFIG_FS_PROCFS
-	/* Mount the procfs file system */
+	int ret;
+
 	ret = mount(NULL, ARTIK053_PROCFS_MOUNTPOINT, "procfs", 0, NULL);
 	if (ret < 0) {
 		lldbg("Failed to mount procfs at %s: %d\n", ARTIK053_PROCFS_MOUNTPOINT, ret);
+		return ret;
 	}
 #endif
 
+	return OK;
+}
+
+/****************************************************************************
+ * Name: artik053_rammtd_initialize
+ *
+ * Description:
+ *   Create and mount a SMART file system in RAM.
+ *
+ ****************************************************************************/
+int artik053_rammtd_initialize(void)
+{
 #if defined(CONFIG_RAMMTD) && defined(CONFIG_FS_SMARTFS)
+	int bufsize = CONFIG_RAMMTD_ERASESIZE * CONFIG_ARTIK053_RAMMTD_NEBLOCKS;
+	static uint8_t *rambuf;
+	struct mtd_dev_s *mtd;
+	int ret;
+
 	rambuf = (uint8_t *)malloc(bufsize);
 
 	mtd = rammtd_initialize(rambuf, bufsize);
 	if (!mtd) {
 		lldbg("ERROR: FAILED TO CREATE RAM MTD INSTANCE\n");
 		free(rambuf);
-	} else {
-		if (smart_initialize(CONFIG_ARTIK053_RAMMTD_DEV_NUMBER, mtd, NULL) < 0) {
-			lldbg("ERROR: FAILED TO smart_initialize\n");
-			free(rambuf);
-		} else {
-			(void)mksmartfs(CONFIG_ARTIK053_RAMMTD_DEV_POINT, false);
-
-			ret = mount(CONFIG_ARTIK053_RAMMTD_DEV_POINT, CONFIG_ARTIK053_RAMMTD_MOUNT_POINT,
-					"smartfs", 0, NULL);
-			if (ret < 0) {
-				lldbg("ERROR: Failed to mount the SMART volume: %d\n", errno);
-				free(rambuf);
-			}
-		}
+		return -ENOMEM;
+	}
+
+	if (smart_initialize(CONFIG_ARTIK053_RAMMTD_DEV_NUMBER, mtd, NULL) < 0) {
+		lldbg("ERROR: FAILED TO smart_initialize\n");
+		free(rambuf);
+		return -ENODEV;
+	}
+
+	(void)mksmartfs(CONFIG_ARTIK053_RAMMTD_DEV_POINT, false);
+
+	ret = mount(CONFIG_ARTIK053_RAMMTD_DEV_POINT, CONFIG_ARTIK053_RAMMTD_MOUNT_POINT,
+			"smartfs", 0, NULL);
+	if (ret < 0) {
+		lldbg("ERROR: Failed to mount the SMART volume: %d\n", errno);
+		free(rambuf);
+		return -errno;
 	}
 #endif /* CONFIG_RAMMTD */
 
+	return OK;
+}
+
+/****************************************************************************
+ * Name: artik053_rtc_initialize
+ ****************************************************************************/
+int artik053_rtc_initialize(void)
+{
 #if defined(CONFIG_RTC_DRIVER)
-	{
-		struct rtc_lowerhalf_s *rtclower;
-
-		rtclower = s5j_rtc_lowerhalf();
-		if (rtclower) {
-			ret = rtc_initialize(0, rtclower);
-			if (ret < 0) {
-				lldbg("Failed to register the RTC driver: %d\n", ret);
-			}
+	struct rtc_lowerhalf_s *rtclower;
+	int ret;
+
+	rtclower = s5j_rtc_lowerhalf();
+	if (rtclower) {
+		ret = rtc_initialize(0, rtclower);
+		if (ret < 0) {
+			lldbg("Failed to register the RTC driver: %d\n", ret);
+			return ret;
 		}
 	}
 #endif /* CONFIG_RTC_DRIVER */
 
+	return OK;
+}
+
+/****************************************************************************
+ * Name: artik053_timer_initialize
+ ****************************************************************************/
+int artik053_timer_initialize(void)
+{
 #ifdef CONFIG_TIMER
-	{
-		int  i;
-		char path[CONFIG_PATH_MAX];
+	int  i;
+	char path[CONFIG_PATH_MAX];
 
-		for (i = 0; i < CONFIG_S5J_MCT_NUM; i++) {
-			snprintf(path, sizeof(path), "/dev/timer%d", i);
-			s5j_timer_initialize(path, i);
-		}
+	for (i = 0; i < CONFIG_S5J_MCT_NUM; i++) {
+		snprintf(path, sizeof(path), "/dev/timer%d", i);
+		s5j_timer_initialize(path, i);
 	}
 #endif
 
-	artik053_adc_setup();
+	return OK;
+}
 
-	scsc_wpa_ctrl_iface_init();
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-	UNUSED(ret);
+/****************************************************************************
+ * Name: board_app_initialize
+ *
+ * Description:
+ *   Perform architecture specific initialization
+ *
+ ****************************************************************************/
+int board_app_initialize(void)
+{
+	artik053_configure_partitions();
+	artik053_userfs_initialize();
+	artik053_procfs_initialize();
+	artik053_rammtd_initialize();
+	artik053_rtc_initialize();
+	artik053_timer_initialize();
+	artik053_adc_setup();
+	artik053_wpa_ctrl_initialize();
 
 	return OK;
 }
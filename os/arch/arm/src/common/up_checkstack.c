@@ -72,6 +72,12 @@
 
 #ifdef CONFIG_STACK_COLORATION
 
+/* With CONFIG_ARMV7R_STACKCHECK only the interrupt stack is scanned */
+
+#if !defined(CONFIG_ARMV7R_STACKCHECK) || CONFIG_ARCH_INTERRUPTSTACK > 3
+#define HAVE_STACK_SCAN 1
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -79,7 +85,9 @@
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
+#ifdef HAVE_STACK_SCAN
 static size_t do_stackcheck(uintptr_t alloc, size_t size);
+#endif
 
 /****************************************************************************
  * Name: do_stackcheck
@@ -98,6 +106,7 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size);
  *
  ****************************************************************************/
 
+#ifdef HAVE_STACK_SCAN
 static size_t do_stackcheck(uintptr_t alloc, size_t size)
 {
 	FAR uintptr_t start;
@@ -155,6 +164,7 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
 
 	return mark << 2;
 }
+#endif
 
 /****************************************************************************
  * Global Functions
@@ -178,7 +188,22 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
 
 size_t up_check_tcbstack(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_ARMV7R_STACKCHECK
+	/* The lowest stack pointer is recorded on every function entry, see
+	 * arm_stackcheck.c.  Nothing to scan.
+	 */
+
+	uintptr_t top = (uintptr_t)tcb->stack_alloc_ptr + tcb->adj_stack_size;
+	uintptr_t stackmin = tcb->xcp.stackmin;
+
+	if (stackmin == STACKMIN_NONE || stackmin > top) {
+		return 0;
+	}
+
+	return top - stackmin;
+#else
 	return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size);
+#endif
 }
 
 ssize_t up_check_tcbstack_remain(FAR struct tcb_s *tcb)
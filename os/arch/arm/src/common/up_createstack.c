@@ -230,10 +230,11 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
 		/* If stack debug is enabled, then fill the stack with a
 		 * recognizable value that we can use later to test for high
-		 * water marks.
+		 * water marks.  CONFIG_ARMV7R_STACKCHECK records them on function
+		 * entry instead.
 		 */
 
-#ifdef CONFIG_STACK_COLORATION
+#if defined(CONFIG_STACK_COLORATION) && !defined(CONFIG_ARMV7R_STACKCHECK)
 		up_stack_color(tcb->stack_alloc_ptr, tcb->adj_stack_size);
 #endif
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
@@ -100,8 +100,12 @@ void up_idle(void)
 
 	/* Sleep until an interrupt occurs to save power */
 
-#if 0
-	asm("WFI");					/* For example */
+#ifdef CONFIG_SCHED_TICKLESS
+	/* Without a periodic tick, the next interrupt is the next OS timer
+	 * event or a device interrupt.
+	 */
+
+	asm("WFI");
 #endif
 #endif
 }
@@ -162,6 +162,12 @@ void up_initialize(void)
 
 	up_calibratedelay();
 
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	/* Start the cycle counter used for profiling */
+
+	up_perf_init();
+#endif
+
 	/* Colorize the interrupt stack */
 
 	up_color_intstack();
@@ -184,6 +190,12 @@ void up_initialize(void)
 	up_pminitialize();
 #endif
 
+#ifdef CONFIG_ARCH_DMA_ALLOC
+	/* Create the coherent DMA buffer heap */
+
+	up_dma_initialize();
+#endif
+
 	/* Initialize the DMA subsystem if the weak function up_dmainitialize has been
 	 * brought into the build
 	 */
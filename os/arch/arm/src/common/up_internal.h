@@ -197,6 +197,12 @@
 #define INTSTACK_COLOR 0xdeadbeef
 #define HEAP_COLOR     'h'
 
+/* Stack high-water mark of a thread that has not been seen on its stack
+ * yet (CONFIG_ARMV7R_STACKCHECK).
+ */
+
+#define STACKMIN_NONE  UINTPTR_MAX
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -496,6 +502,10 @@ void lowconsole_init(void);
 void weak_function up_dmainitialize(void);
 #endif
 
+#ifdef CONFIG_ARCH_DMA_ALLOC
+void up_dma_initialize(void);
+#endif
+
 /* Cache control ************************************************************/
 
 #ifdef CONFIG_ARCH_L2CACHE
@@ -58,6 +58,8 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <string.h>
+#include <time.h>
 
 #include <tinyara/irq.h>
 #include <tinyara/wqueue.h>
@@ -66,9 +68,23 @@
 
 #include "up_arch.h"
 #include "s5j_adc.h"
+#ifdef CONFIG_S5J_ADC_BLOCK
+#include <tinyara/kmalloc.h>
+#include "s5j_mct.h"
+#endif
 
 #ifdef CONFIG_S5J_ADC
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define ADC_BLOCK_CLOCK		CLOCK_MONOTONIC
+#else
+#define ADC_BLOCK_CLOCK		CLOCK_REALTIME
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -84,8 +100,29 @@ struct s5j_dev_s {
 
 	struct work_s work;	/* Supports the IRQ handling */
 	uint8_t chanlist[S5J_ADC_MAX_CHANNELS];
+
+#ifdef CONFIG_S5J_ADC_BLOCK
+	/* Block mode: an MCT channel starts a scan of the channels */
+	FAR struct s5j_mct_priv_s *mct;
+	FAR int32_t *block;	/* Sample sets of the block being filled */
+	struct timespec blocktime; /* Time of its first set */
+	uint16_t nsets;		/* Sets per block */
+	uint16_t set;		/* Set being converted */
+	uint8_t bchannels;	/* Channels per set */
+	uint8_t bcurrent;	/* Index of the channel being converted */
+	bool blockmode;
+	bool busy;		/* A scan is in progress */
+	uint32_t overruns;	/* Triggers lost because a scan was in progress */
+#endif
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+#ifdef CONFIG_S5J_ADC_BLOCK
+static void adc_blockstop(FAR struct adc_dev_s *dev);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -134,6 +171,72 @@ static void adc_conversion(void *arg)
 	modifyreg32(S5J_ADC_CON1, 0, ADC_CON1_STCEN_ENABLE);
 }
 
+#ifdef CONFIG_S5J_ADC_BLOCK
+/****************************************************************************
+ * Name: adc_blocksample
+ *
+ * Description:
+ *   Block mode end-of-conversion handling, called from adc_interrupt.
+ *   Stores the sample in the block and starts the conversion of the next
+ *   channel of the scan.  The upper half is only called once per block.
+ *
+ ****************************************************************************/
+static void adc_blocksample(FAR struct s5j_dev_s *priv)
+{
+	uint32_t index = (uint32_t)priv->set * priv->bchannels + priv->bcurrent;
+
+	priv->block[index] = getreg32(S5J_ADC_DAT) & ADC_DAT_ADCDAT_MASK;
+
+	if (++priv->bcurrent < priv->bchannels) {
+		modifyreg32(S5J_ADC_CON2, ADC_CON2_ACHSEL_MASK,
+					priv->chanlist[priv->bcurrent]);
+		modifyreg32(S5J_ADC_CON1, 0, ADC_CON1_STCEN_ENABLE);
+		return;
+	}
+
+	/* The scan is complete */
+	priv->busy = false;
+	if (++priv->set >= priv->nsets) {
+		priv->set = 0;
+		if (priv->cb != NULL && priv->cb->au_receive_block != NULL) {
+			priv->cb->au_receive_block(priv->dev, &priv->blocktime,
+						   priv->block, priv->nsets);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: adc_trigger
+ *
+ * Description:
+ *   MCT interrupt in block mode: start a scan of the channels.
+ *
+ ****************************************************************************/
+static int adc_trigger(int irq, FAR void *context, FAR void *arg)
+{
+	FAR struct s5j_dev_s *priv = (FAR struct s5j_dev_s *)arg;
+
+	s5j_mct_ack_irq(priv->mct);
+
+	if (priv->busy) {
+		/* The sampling rate is too high for the conversion time */
+		priv->overruns++;
+		return OK;
+	}
+
+	if (priv->set == 0) {
+		clock_gettime(ADC_BLOCK_CLOCK, &priv->blocktime);
+	}
+
+	priv->busy     = true;
+	priv->bcurrent = 0;
+	modifyreg32(S5J_ADC_CON2, ADC_CON2_ACHSEL_MASK, priv->chanlist[0]);
+	modifyreg32(S5J_ADC_CON1, 0, ADC_CON1_STCEN_ENABLE);
+
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_interrupt
  *
@@ -154,6 +257,13 @@ static int adc_interrupt(int irq, FAR void *context, void *arg)
 		/* Clear interrupt pending */
 		putreg32(ADC_INT_STATUS_PENDING, S5J_ADC_INT_STATUS);
 
+#ifdef CONFIG_S5J_ADC_BLOCK
+		if (priv->blockmode) {
+			adc_blocksample(priv);
+			return OK;
+		}
+#endif
+
 		/*
 		 * Check if interrupt work is already queued. If it is already
 		 * busy, then we already have interrupt processing in the
@@ -356,6 +466,10 @@ static int adc_setup(FAR struct adc_dev_s *dev)
  ****************************************************************************/
 static void adc_shutdown(FAR struct adc_dev_s *dev)
 {
+#ifdef CONFIG_S5J_ADC_BLOCK
+	adc_blockstop(dev);
+
+#endif
 	/* Disable interrupt */
 	putreg32(ADC_INT_DISABLE, S5J_ADC_INT);
 
@@ -384,6 +498,95 @@ static void adc_rxint(FAR struct adc_dev_s *dev, bool enable)
 	putreg32(enable ? ADC_INT_ENABLE : ADC_INT_DISABLE, S5J_ADC_INT);
 }
 
+#ifdef CONFIG_S5J_ADC_BLOCK
+/****************************************************************************
+ * Name: adc_blockstart
+ *
+ * Description:
+ *   Start sampling the first cfg->ab_nchannels configured channels at
+ *   cfg->ab_rate scans per second, triggered by the MCT.
+ *
+ ****************************************************************************/
+static int adc_blockstart(FAR struct adc_dev_s *dev,
+			  FAR const struct adc_blockcfg_s *cfg)
+{
+	FAR struct s5j_dev_s *priv = (FAR struct s5j_dev_s *)dev->ad_priv;
+	FAR int32_t *block;
+	irqstate_t flags;
+
+	if (cfg->ab_nchannels > priv->cchannels ||
+	    cfg->ab_rate > USEC_PER_SEC) {
+		return -EINVAL;
+	}
+
+	if (priv->mct == NULL) {
+		priv->mct = s5j_mct_init(S5J_MCT_CHANNEL2);
+		if (priv->mct == NULL) {
+			return -ENODEV;
+		}
+	}
+
+	block = (FAR int32_t *)kmm_malloc(cfg->ab_nsets * cfg->ab_nchannels *
+					  sizeof(int32_t));
+	if (block == NULL) {
+		return -ENOMEM;
+	}
+
+	flags = irqsave();
+	priv->block     = block;
+	priv->nsets     = cfg->ab_nsets;
+	priv->bchannels = cfg->ab_nchannels;
+	priv->set       = 0;
+	priv->busy      = false;
+	priv->overruns  = 0;
+	priv->blockmode = true;
+	irqrestore(flags);
+
+	s5j_mct_setmode(priv->mct, false);
+	s5j_mct_setperiod(priv->mct, USEC_PER_SEC / cfg->ab_rate);
+	s5j_mct_setisr(priv->mct, adc_trigger, priv);
+	s5j_mct_enableint(priv->mct);
+	s5j_mct_enable(priv->mct);
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: adc_blockstop
+ ****************************************************************************/
+static void adc_blockstop(FAR struct adc_dev_s *dev)
+{
+	FAR struct s5j_dev_s *priv = (FAR struct s5j_dev_s *)dev->ad_priv;
+	FAR int32_t *block;
+	irqstate_t flags;
+
+	if (!priv->blockmode) {
+		return;
+	}
+
+	s5j_mct_disableint(priv->mct);
+	s5j_mct_disable(priv->mct);
+	s5j_mct_setisr(priv->mct, NULL, NULL);
+
+	flags = irqsave();
+	priv->blockmode = false;
+	priv->busy      = false;
+	block           = priv->block;
+	priv->block     = NULL;
+
+	/* Back to the configured channel of the single conversion mode */
+	modifyreg32(S5J_ADC_CON2, ADC_CON2_ACHSEL_MASK,
+				priv->chanlist[priv->current]);
+	irqrestore(flags);
+
+	if (priv->overruns > 0) {
+		adbg("%u scans lost in block mode\n", priv->overruns);
+	}
+
+	kmm_free(block);
+}
+#endif
+
 /****************************************************************************
  * Name: adc_ioctl
  *
@@ -426,6 +629,10 @@ static const struct adc_ops_s g_adcops = {
 	.ao_shutdown	= adc_shutdown,
 	.ao_rxint	= adc_rxint,
 	.ao_ioctl	= adc_ioctl,
+#ifdef CONFIG_S5J_ADC_BLOCK
+	.ao_blockstart	= adc_blockstart,
+	.ao_blockstop	= adc_blockstop,
+#endif
 };
 
 static struct s5j_dev_s g_adcpriv = {
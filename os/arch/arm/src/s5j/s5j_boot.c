@@ -82,7 +82,7 @@ extern uint32_t _vector_end;
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
-#ifdef CONFIG_STACK_COLORATION
+#if defined(CONFIG_STACK_COLORATION) && !defined(CONFIG_ARMV7R_STACKCHECK)
 static inline void up_idlestack_color(void *pv, unsigned int nbytes)
 {
 	register void *r0 __asm__("r0");
@@ -142,6 +142,7 @@ int s5j_mpu_initialize(void)
 	 * Reserved		0x020E8000	0x020FFFFF	96 (WBWA)
 	 * Reserved		0x02100000	0x021FFFFF	64 (NCNB)
 	 * WIFI			0x02110000	0x0215FFFF	320(NCNB)
+	 * DMA			0x02160000	0x0217FFFF	128(NCNB, CONFIG_ARCH_DMA_ALLOC)
 	 */
 
 	/* Region 0, Set read only for memory area */
@@ -218,8 +219,10 @@ void arm_boot(void)
 	/*
 	 * This function makes idle stack colored.
 	 * Do not call any function between this and os_start.
+	 * With CONFIG_ARMV7R_STACKCHECK the high-water mark is tracked on
+	 * function entry instead and the stack is not painted.
 	 */
-#ifdef CONFIG_STACK_COLORATION
+#if defined(CONFIG_STACK_COLORATION) && !defined(CONFIG_ARMV7R_STACKCHECK)
 	up_idlestack_color((void *)&_ebss, CONFIG_IDLETHREAD_STACKSIZE);
 #endif
 
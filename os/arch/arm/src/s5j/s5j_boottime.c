@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/s5j/s5j_boottime.c
+ *
+ * Boot time stamps from the free running counter of MCT channel 0.  The
+ * timer drivers only use the tick and interrupt counters of the channel
+ * and the tickless system timer uses channel 3, so the counter can be
+ * started from the very beginning of os_start() and left running.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/boottime.h>
+
+#include "up_arch.h"
+#include "chip.h"
+#include "chip/s5jt200_mct.h"
+
+#ifdef CONFIG_BOOTTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define S5J_BOOTTIME_BASE	(S5J_MCT_BASE + 0x300)
+
+/* The MCT runs from the 26MHz oscillator, prescaled to 1MHz as done by
+ * s5j_mct_init() so that both agree on the prescaler.
+ */
+
+#define S5J_BOOTTIME_OSC	26000000
+#define S5J_BOOTTIME_PRESCALER	(S5J_BOOTTIME_OSC / USEC_PER_SEC - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static bool g_boottime_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void s5j_boottime_wait(uint32_t bitmask)
+{
+	uint32_t reg = S5J_BOOTTIME_BASE + S5J_MCT_WSTAT_OFFSET;
+
+	while ((getreg32(reg) & bitmask) == 0) {
+		/* poll */
+	}
+
+	putreg32(bitmask, reg);
+}
+
+static void s5j_boottime_start(void)
+{
+	modifyreg32(S5J_MCT_CFG, 0x7ff, S5J_BOOTTIME_PRESCALER);
+
+	putreg32(UINT32_MAX, S5J_BOOTTIME_BASE + S5J_MCT_FRCNTB_OFFSET);
+	s5j_boottime_wait(S5J_MCT_WSTAT_FRCCNTB);
+
+	modifyreg32(S5J_BOOTTIME_BASE + S5J_MCT_TCON_OFFSET, 0, S5J_MCT_TCON_FRC_START);
+	s5j_boottime_wait(S5J_MCT_WSTAT_TCON);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_boottime
+ *
+ * Description:
+ *   Return the microseconds since the first call.  The counter counts down
+ *   from UINT32_MAX and wraps after about 71 minutes.
+ *
+ ****************************************************************************/
+
+uint32_t up_boottime(void)
+{
+	if (!g_boottime_started) {
+		g_boottime_started = true;
+		s5j_boottime_start();
+	}
+
+	return UINT32_MAX - getreg32(S5J_BOOTTIME_BASE + S5J_MCT_FRCNTO_OFFSET);
+}
+
+#endif							/* CONFIG_BOOTTIME */
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/s5j/s5j_dvfs.c
+ *
+ * CPU operating points for the PM frequency governor.  Frequency changes
+ * go through the power CAL so that they follow the same path as the other
+ * clocks of the chip.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <tinyara/pm/pm.h>
+
+#include "s5j_vclk.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_dvfs_opp_s g_s5j_opps[] = {
+	{ S5J_DEFAULT_CPU_CLOCK / 4, 50 },
+	{ S5J_DEFAULT_CPU_CLOCK / 2, 50 },
+	{ S5J_DEFAULT_CPU_CLOCK,     50 },
+};
+
+#define S5J_NOPPS (sizeof(g_s5j_opps) / sizeof(g_s5j_opps[0]))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int up_dvfs_getopps(FAR const struct pm_dvfs_opp_s **opps)
+{
+	*opps = g_s5j_opps;
+	return S5J_NOPPS;
+}
+
+int up_dvfs_setopp(int index)
+{
+	if (index < 0 || index >= S5J_NOPPS) {
+		return -EINVAL;
+	}
+
+	if (cal_clk_setrate(dvfs_cpu, g_s5j_opps[index].freq) < 0) {
+		return -ENOSYS;
+	}
+
+	return OK;
+}
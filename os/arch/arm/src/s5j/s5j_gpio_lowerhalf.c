@@ -59,13 +59,26 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <time.h>
 
 #include <arch/irq.h>
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
 #include <tinyara/gpio.h>
 #include <tinyara/kmalloc.h>
 
 #include "up_arch.h"
 #include "s5j_gpio.h"
+#include "s5j_rtc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define GPIO_EVENT_MASK		(CONFIG_GPIO_EVENT_NBUFFER - 1)
+
+#if (CONFIG_GPIO_EVENT_NBUFFER & GPIO_EVENT_MASK) != 0
+#error "CONFIG_GPIO_EVENT_NBUFFER must be a power of two"
+#endif
 
 /****************************************************************************
  * Private Types
@@ -76,18 +89,93 @@ struct s5j_lowerhalf_s {
 
 	uint32_t pincfg;
 	gpio_handler_t handler;
+
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	/* Edges recorded by the interrupt handler, in a ring */
+	struct gpio_event_s events[CONFIG_GPIO_EVENT_NBUFFER];
+	uint16_t head;		/* Free-running write index */
+	uint16_t tail;		/* Free-running read index */
+	uint16_t dropped;	/* Edges lost to a full ring */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
-#ifndef CONFIG_DISABLE_POLL
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+/****************************************************************************
+ * Name: s5j_gpio_usec
+ *
+ * Description:
+ *   Microseconds since boot, to the resolution of the system timer's
+ *   counter.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+static uint32_t s5j_gpio_usec(void)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+	struct timespec ts;
+
+	up_timer_gettime(&ts);
+	return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+	uint32_t reload = getreg32(S5J_RTC_TICCNT0) + 1;
+	uint32_t ticks = (uint32_t)clock_systimer();
+	uint32_t count = getreg32(S5J_RTC_CURTICCNT0);
+
+	/*
+	 * The tick counter counts down.  If it has expired but the tick is
+	 * still pending, the count already belongs to the next tick.
+	 */
+	if (getreg32(S5J_RTC_INTP) & RTC_INTP_TIMETIC0) {
+		ticks++;
+		count = getreg32(S5J_RTC_CURTICCNT0);
+	}
+
+	return ticks * USEC_PER_TICK +
+		(uint32_t)((uint64_t)(reload - 1 - count) * USEC_PER_TICK / reload);
+#endif
+}
+
+static void s5j_gpio_record(struct s5j_lowerhalf_s *priv)
+{
+	struct gpio_event_s *ev;
+	uint32_t edge = priv->pincfg & GPIO_EINT_MASK;
+
+	if ((uint16_t)(priv->head - priv->tail) == CONFIG_GPIO_EVENT_NBUFFER) {
+		if (priv->dropped != UINT16_MAX) {
+			priv->dropped++;
+		}
+		return;
+	}
+
+	ev = &priv->events[priv->head & GPIO_EVENT_MASK];
+	ev->ge_usec = s5j_gpio_usec();
+
+	/* On a single edge the value is known, the pin may have moved on */
+	if (edge == GPIO_EINT_RISING_EDGE) {
+		ev->ge_value = 1;
+	} else if (edge == GPIO_EINT_FALLING_EDGE) {
+		ev->ge_value = 0;
+	} else {
+		ev->ge_value = s5j_gpioread(priv->pincfg);
+	}
+
+	priv->head++;
+}
+#endif
+
+#if !defined(CONFIG_DISABLE_POLL) || defined(CONFIG_GPIO_EVENT_BUFFER)
 static int s5j_gpio_interrupt(int irq, FAR void *context, FAR void *arg)
 {
 	struct s5j_lowerhalf_s *lower = (struct s5j_lowerhalf_s *)arg;
 
 	s5j_gpio_clear_pending(lower->pincfg);
 
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	s5j_gpio_record(lower);
+#endif
+
 	if (lower->handler != NULL) {
 		DEBUGASSERT(lower->handler != NULL);
 		lower->handler(lower->parent);
@@ -185,8 +273,8 @@ static int s5j_gpio_enable(FAR struct gpio_lowerhalf_s *lower, int falling,
 		return -EINVAL;
 	}
 
-	/* clear function mask */
-	priv->pincfg &= ~GPIO_FUNC_MASK;
+	/* clear function and edge masks */
+	priv->pincfg &= ~(GPIO_FUNC_MASK | GPIO_EINT_MASK);
 
 	if (falling && rising) {
 		priv->pincfg |= GPIO_EINT | GPIO_EINT_BOTH_EDGE;
@@ -200,6 +288,12 @@ static int s5j_gpio_enable(FAR struct gpio_lowerhalf_s *lower, int falling,
 	}
 
 	priv->handler = handler;
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	/* Edges of the previous configuration are stale */
+	priv->head = 0;
+	priv->tail = 0;
+	priv->dropped = 0;
+#endif
 	if (handler) {
 		irq_attach(irqvector, s5j_gpio_interrupt, priv);
 		up_enable_irq(irqvector);
@@ -211,6 +305,28 @@ static int s5j_gpio_enable(FAR struct gpio_lowerhalf_s *lower, int falling,
 	return s5j_configgpio(priv->pincfg);
 }
 
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+static int s5j_gpio_read_events(FAR struct gpio_lowerhalf_s *lower,
+								FAR struct gpio_event_s *events,
+								size_t nevents, FAR uint16_t *dropped)
+{
+	struct s5j_lowerhalf_s *priv = (struct s5j_lowerhalf_s *)lower;
+	irqstate_t flags;
+	size_t n = 0;
+
+	flags = irqsave();
+	while (n < nevents && priv->tail != priv->head) {
+		events[n++] = priv->events[priv->tail & GPIO_EVENT_MASK];
+		priv->tail++;
+	}
+	*dropped = priv->dropped;
+	priv->dropped = 0;
+	irqrestore(flags);
+
+	return n;
+}
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -220,6 +336,9 @@ static const struct gpio_ops_s s5j_gpio_ops = {
 	.pull   = s5j_gpio_pull,
 	.setdir = s5j_gpio_setdir,
 	.enable = s5j_gpio_enable,
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	.read_events = s5j_gpio_read_events,
+#endif
 };
 
 /****************************************************************************
@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/s5j/s5j_hrtimer.c
+ *
+ * One-shot timer for the high-resolution timers on MCT channel 1, clocked
+ * at 1MHz.  The tick counter of the channel runs in one-shot mode.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/hrtimer.h>
+
+#include "up_arch.h"
+
+#include "chip.h"
+#include "chip/s5jt200_mct.h"
+#include "s5j_mct.h"
+
+#ifdef CONFIG_S5J_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define HRTIMER_CHANNEL		S5J_MCT_CHANNEL1
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static FAR struct s5j_mct_priv_s *g_hrtimer_mct;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static int s5j_hrtimer_isr(int irq, FAR void *context, FAR void *arg)
+{
+	FAR struct s5j_mct_priv_s *mct = g_hrtimer_mct;
+
+	if (s5j_mct_getstatus(mct) & S5J_MCT_INT_CSTAT_ICNT) {
+		s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+		s5j_mct_disable(mct);
+		hrtimer_expiration();
+	}
+
+	return OK;
+}
+
+/*
+ * Set up the channel on first use, so that it does not depend on where
+ * the initialization sequence brings up the MCT.
+ */
+static FAR struct s5j_mct_priv_s *s5j_hrtimer_mct(void)
+{
+	FAR struct s5j_mct_priv_s *mct = g_hrtimer_mct;
+
+	if (mct == NULL) {
+		mct = s5j_mct_init(HRTIMER_CHANNEL);
+		DEBUGASSERT(mct != NULL);
+
+		s5j_mct_disable(mct);
+		s5j_mct_setmode(mct, true);
+		s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+
+		s5j_mct_setisr(mct, s5j_hrtimer_isr, NULL);
+		s5j_mct_setintmask(mct, S5J_MCT_INTR_ICNT);
+
+		g_hrtimer_mct = mct;
+	}
+
+	return mct;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function:  up_hrtimer_start
+ *
+ * Description:
+ *   Arm the one-shot timer to call hrtimer_expiration() after 'nsec'
+ *   nanoseconds, rounded up to whole microseconds.  Called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+void up_hrtimer_start(uint64_t nsec)
+{
+	FAR struct s5j_mct_priv_s *mct = s5j_hrtimer_mct();
+	uint64_t usec;
+
+	usec = (nsec + NSEC_PER_USEC - 1) / NSEC_PER_USEC;
+	if (usec == 0) {
+		usec = 1;
+	} else if (usec > UINT32_MAX) {
+		usec = UINT32_MAX;
+	}
+
+	s5j_mct_disable(mct);
+	s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+	s5j_mct_setperiod(mct, (uint32_t)usec);
+	s5j_mct_enable(mct);
+}
+
+/****************************************************************************
+ * Function:  up_hrtimer_cancel
+ *
+ * Description:
+ *   Stop the one-shot timer.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+void up_hrtimer_cancel(void)
+{
+	FAR struct s5j_mct_priv_s *mct = g_hrtimer_mct;
+
+	if (mct != NULL) {
+		s5j_mct_disable(mct);
+		s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+	}
+}
+
+#endif /* CONFIG_S5J_HRTIMER */
@@ -70,6 +70,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <time.h>
 
 #include <tinyara/arch.h>
 #include <tinyara/irq.h>
@@ -111,6 +112,9 @@ static const struct i2c_ops_s s5j_i2c_ops = {
 #ifdef CONFIG_I2C_TRANSFER
 	.transfer = s5j_i2c_transfer,
 #endif
+#ifdef CONFIG_I2C_BATCH
+	.batch = s5j_i2c_batch,
+#endif
 #ifdef CONFIG_I2C_SLAVE
 	.setownaddress = NULL,
 	.registercallback = NULL,
@@ -795,6 +799,172 @@ static int hsi2c_slave_handler(void *args)
 	return 0;
 }
 
+#ifdef CONFIG_I2C_BATCH
+/*
+ * A batch is run in manual mode like s5j_i2c_transfer(), but each command
+ * is issued from the interrupt that signals the end of the previous one,
+ * so the caller sleeps for the whole batch.
+ */
+static void hsi2c_batch_cmd(struct s5j_i2c_priv_s *priv, unsigned int cmd, uint8_t state)
+{
+	priv->bstate = state;
+	putreg32(cmd, priv->config->base + I2C_MANUAL_CMD);
+}
+
+/* Move the next byte of the current message, or go on to the next message */
+static void hsi2c_batch_data(struct s5j_i2c_priv_s *priv)
+{
+	struct i2c_xfer_s *xfer = &priv->xferv[priv->xfern];
+	struct i2c_msg_s *msg = &xfer->msgs[priv->msgn];
+	unsigned int cmd;
+
+	while (priv->byten >= msg->length) {
+		priv->byten = 0;
+		if (++priv->msgn == xfer->nmsgs) {
+			xfer->result = xfer->nmsgs;
+			hsi2c_batch_cmd(priv, I2C_STOP, BATCH_STOP);
+			return;
+		}
+
+		msg++;
+		if (!(msg->flags & I2C_M_NOSTART)) {
+			hsi2c_batch_cmd(priv, I2C_RESTART, BATCH_START);
+			return;
+		}
+	}
+
+	if (msg->flags & I2C_M_READ) {
+		/* Looks awkward, but if I2C_RX_ACK is set, ACK is NOT generated */
+		cmd = I2C_READ_DATA;
+		if (priv->byten == msg->length - 1) {
+			cmd |= I2C_RX_ACK;
+		}
+		hsi2c_batch_cmd(priv, cmd, BATCH_READ);
+	} else {
+		cmd = ((unsigned int)msg->buffer[priv->byten]) << 24 | I2C_SEND_DATA;
+		hsi2c_batch_cmd(priv, cmd, BATCH_WRITE);
+	}
+}
+
+static void hsi2c_batch_fail(struct s5j_i2c_priv_s *priv, int err)
+{
+	priv->xferv[priv->xfern].result = err;
+	hsi2c_batch_cmd(priv, I2C_STOP, BATCH_STOP);
+}
+
+/* Start the current transfer, skipping empty ones.  False at the end. */
+static bool hsi2c_batch_next(struct s5j_i2c_priv_s *priv)
+{
+	for (; priv->xfern < priv->xferc; priv->xfern++) {
+		if (priv->xferv[priv->xfern].nmsgs > 0) {
+			priv->msgn = 0;
+			priv->byten = 0;
+			putreg32(0x88, priv->config->base + CTL);
+			hsi2c_batch_cmd(priv, I2C_START, BATCH_START);
+			return true;
+		}
+
+		priv->xferv[priv->xfern].result = 0;
+	}
+
+	return false;
+}
+
+static int hsi2c_batch_handler(struct s5j_i2c_priv_s *priv)
+{
+	unsigned int base = priv->config->base;
+	struct i2c_msg_s *msg;
+	unsigned int status;
+	bool nak;
+
+	status = getreg32(base + INT_STAT) & HSI2C_INT_XFER_DONE;
+	if (status == 0) {
+		return OK;
+	}
+
+	putreg32(status, base + INT_STAT);
+
+	if (priv->bstate == BATCH_STOP) {
+		priv->xfern++;
+		if (!hsi2c_batch_next(priv)) {
+			up_disable_irq(priv->config->irq);
+			priv->xferv = NULL;
+			sem_post(&priv->batchsem);
+		}
+		return OK;
+	}
+
+	nak = (status & HSI2C_INT_XFER_DONE_NOACK_MANUAL) != 0;
+	msg = &priv->xferv[priv->xfern].msgs[priv->msgn];
+	if (msg->flags & I2C_M_IGNORE_NAK) {
+		nak = false;
+	}
+
+	switch (priv->bstate) {
+	case BATCH_START:
+		if (msg->flags & I2C_M_TEN) {
+			hsi2c_batch_cmd(priv, I2C_ADDR10H(msg->addr) << 24 | I2C_SEND_DATA, BATCH_ADDR);
+		} else if (msg->flags & I2C_M_READ) {
+			hsi2c_batch_cmd(priv, I2C_READADDR8(msg->addr) << 24 | I2C_SEND_DATA, BATCH_ADDR);
+		} else {
+			hsi2c_batch_cmd(priv, I2C_WRITEADDR8(msg->addr) << 24 | I2C_SEND_DATA, BATCH_ADDR);
+		}
+		break;
+
+	case BATCH_ADDR:
+		if (nak) {
+			hsi2c_batch_fail(priv, -ENXIO);
+		} else if (msg->flags & I2C_M_TEN) {
+			hsi2c_batch_cmd(priv, I2C_ADDR10L(msg->addr) << 24 | I2C_SEND_DATA, BATCH_ADDR10);
+		} else {
+			hsi2c_batch_data(priv);
+		}
+		break;
+
+	case BATCH_ADDR10:
+		if (nak) {
+			hsi2c_batch_fail(priv, -ENXIO);
+		} else if (msg->flags & I2C_M_READ) {
+			hsi2c_batch_cmd(priv, I2C_RESTART, BATCH_RESTART10);
+		} else {
+			hsi2c_batch_data(priv);
+		}
+		break;
+
+	case BATCH_RESTART10:
+		hsi2c_batch_cmd(priv, I2C_READADDR10H(msg->addr) << 24 | I2C_SEND_DATA, BATCH_ADDR10RD);
+		break;
+
+	case BATCH_ADDR10RD:
+		if (nak) {
+			hsi2c_batch_fail(priv, -ENXIO);
+		} else {
+			hsi2c_batch_data(priv);
+		}
+		break;
+
+	case BATCH_WRITE:
+		if (nak) {
+			hsi2c_batch_fail(priv, -EIO);
+		} else {
+			priv->byten++;
+			hsi2c_batch_data(priv);
+		}
+		break;
+
+	case BATCH_READ:
+		msg->buffer[priv->byten++] = (getreg32(base + I2C_MANUAL_CMD) >> 16) & 0xff;
+		hsi2c_batch_data(priv);
+		break;
+
+	default:
+		break;
+	}
+
+	return OK;
+}
+#endif
+
 static void hsi2c_set_auto_mode(unsigned int base)
 {
 	unsigned int val;
@@ -941,6 +1111,10 @@ static inline void s5j_i2c_sem_init(struct s5j_i2c_priv_s *priv)
 #ifndef CONFIG_I2C_POLLED
 	sem_init(&priv->waitsem, 0, 0);
 #endif
+#ifdef CONFIG_I2C_BATCH
+	sem_init(&priv->batchsem, 0, 0);
+	sem_setprotocol(&priv->batchsem, SEM_PRIO_NONE);
+#endif
 }
 
 static inline void s5j_i2c_sem_destroy(struct s5j_i2c_priv_s *priv)
@@ -949,6 +1123,9 @@ static inline void s5j_i2c_sem_destroy(struct s5j_i2c_priv_s *priv)
 #ifndef CONFIG_I2C_POLLED
 	sem_destroy(&priv->waitsem);
 #endif
+#ifdef CONFIG_I2C_BATCH
+	sem_destroy(&priv->batchsem);
+#endif
 }
 
 static int s5j_i2c0_interrupt(int irq, void *context, void *arg)
@@ -958,6 +1135,12 @@ static int s5j_i2c0_interrupt(int irq, void *context, void *arg)
 	/* Read the masked interrupt status */
 	priv = &s5j_i2c0_priv;
 
+#ifdef CONFIG_I2C_BATCH
+	if (priv->xferv != NULL) {
+		return hsi2c_batch_handler(priv);
+	}
+#endif
+
 	/* Let the common interrupt handler do the rest of the work */
 	return hsi2c_master_handler(priv);
 }
@@ -969,6 +1152,12 @@ static int s5j_i2c1_interrupt(int irq, void *context, void *arg)
 	/* Read the masked interrupt status */
 	priv = &s5j_i2c1_priv;
 
+#ifdef CONFIG_I2C_BATCH
+	if (priv->xferv != NULL) {
+		return hsi2c_batch_handler(priv);
+	}
+#endif
+
 	/* Let the common interrupt handler do the rest of the work */
 	return hsi2c_master_handler(priv);
 }
@@ -980,6 +1169,12 @@ static int s5j_i2c2_interrupt(int irq, void *context, void *arg)
 	/* Read the masked interrupt status */
 	priv = &s5j_i2c2_priv;
 
+#ifdef CONFIG_I2C_BATCH
+	if (priv->xferv != NULL) {
+		return hsi2c_batch_handler(priv);
+	}
+#endif
+
 	/* Let the common interrupt handler do the rest of the work */
 	return hsi2c_master_handler(priv);
 }
@@ -991,6 +1186,12 @@ static int s5j_i2c3_interrupt(int irq, void *context, void *arg)
 	/* Read the masked interrupt status */
 	priv = &s5j_i2c3_priv;
 
+#ifdef CONFIG_I2C_BATCH
+	if (priv->xferv != NULL) {
+		return hsi2c_batch_handler(priv);
+	}
+#endif
+
 	/* Let the common interrupt handler do the rest of the work */
 	return hsi2c_master_handler(priv);
 }
@@ -1025,6 +1226,12 @@ static int s5j_i2c_initialize(struct s5j_i2c_priv_s *priv, unsigned int frequenc
 		up_enable_irq(config->irq);
 	}
 #endif
+#ifdef CONFIG_I2C_BATCH
+	/* Enabled by s5j_i2c_batch() for the duration of a batch */
+	if (priv->master == I2C_MASTER && priv->mode == I2C_POLLING) {
+		irq_attach(config->irq, config->isr, NULL);
+	}
+#endif
 
 	return OK;
 }
@@ -1045,6 +1252,10 @@ static int s5j_i2c_uninitialize(struct s5j_i2c_priv_s *priv)
 		irq_detach(priv->config->irq);
 	}
 #endif
+#ifdef CONFIG_I2C_BATCH
+	up_disable_irq(priv->config->irq);
+	irq_detach(priv->config->irq);
+#endif
 
 	return OK;
 }
@@ -1205,6 +1416,108 @@ fail:
 	return ret;
 }
 
+#ifdef CONFIG_I2C_BATCH
+/**
+ * @brief    Run a batch of I2C transfers from the interrupt handler
+ * @param    struct i2c_dev_s *dev : structure visible to the I2C client
+ * @param    struct i2c_xfer_s *xferv : the transfers, each ended by a STOP
+ * @param    int xferc : number of transfers
+ * @return   int : ==0 :OK, -ETIMEDOUT if the bus hangs
+ * @note     The address of a message is not retried when it is not
+ *           acknowledged, the transfer fails with -ENXIO instead.
+ */
+int s5j_i2c_batch(struct i2c_dev_s *dev, struct i2c_xfer_s *xferv, int xferc)
+{
+	struct s5j_i2c_priv_s *priv = (struct s5j_i2c_priv_s *)dev;
+	unsigned int base = priv->config->base;
+	struct timespec abstime;
+	irqstate_t flags;
+	uint64_t usec;
+	uint32_t nbytes;
+	bool running;
+	int ret = OK;
+	int i;
+	int j;
+
+	/* Only s5j_i2c_transfer() sends the high speed master code */
+	if (priv->xfer_speed > I2C_SPEED_400KHZ) {
+		return -ENOSYS;
+	}
+
+	nbytes = 0;
+	for (i = 0; i < xferc; i++) {
+		if (xferv[i].nmsgs < 0 || (xferv[i].nmsgs > 0 && xferv[i].msgs == NULL)) {
+			return -EINVAL;
+		}
+		for (j = 0; j < xferv[i].nmsgs; j++) {
+			nbytes += xferv[i].msgs[j].length + 3;
+		}
+	}
+
+	/* Allow four times the bus time of 9 bits per byte, at least 10 ms */
+	usec = (uint64_t)nbytes * 9 * 4 * USEC_PER_SEC / priv->xfer_speed + 10000;
+
+	s5j_i2c_sem_wait(priv);
+
+	priv->xferv = xferv;
+	priv->xferc = xferc;
+	priv->xfern = 0;
+	putreg32(HSI2C_INT_XFER_DONE, base + INT_STAT);
+
+	flags = irqsave();
+	running = hsi2c_batch_next(priv);
+	if (running) {
+		up_enable_irq(priv->config->irq);
+	} else {
+		priv->xferv = NULL;
+	}
+	irqrestore(flags);
+
+	if (running) {
+		clock_gettime(CLOCK_REALTIME, &abstime);
+		abstime.tv_sec += usec / USEC_PER_SEC;
+		abstime.tv_nsec += (usec % USEC_PER_SEC) * NSEC_PER_USEC;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+
+		while (sem_timedwait(&priv->batchsem, &abstime) != 0) {
+			if (errno != ETIMEDOUT) {
+				continue;
+			}
+
+			flags = irqsave();
+			running = priv->xferv != NULL;
+			if (running) {
+				up_disable_irq(priv->config->irq);
+				for (i = priv->xfern; i < xferc; i++) {
+					xferv[i].result = -ETIMEDOUT;
+				}
+				priv->xferv = NULL;
+			}
+			irqrestore(flags);
+
+			if (running) {
+				putreg32(HSI2C_INT_XFER_DONE, base + INT_STAT);
+				hsi2c_stop(priv);
+				ret = -ETIMEDOUT;
+			} else {
+				/* Done just in time, take the count posted */
+				while (sem_wait(&priv->batchsem) != 0) {
+					ASSERT(errno == EINTR);
+				}
+			}
+			break;
+		}
+	}
+
+	s5j_i2c_sem_post(priv);
+
+	return ret;
+}
+#endif
+
 int s5j_i2c_read(FAR struct i2c_dev_s *dev, FAR uint8_t *buffer, int buflen)
 {
 	struct s5j_i2c_priv_s *priv = (struct s5j_i2c_priv_s *)dev;
@@ -152,6 +152,18 @@ struct slave_data {
 	u8 data[20];
 };
 
+/* Last manual command issued for a batch */
+enum s5j_batch_state_e {
+	BATCH_START,				/* START or repeated START */
+	BATCH_ADDR,					/* 7-bit address or 10-bit address high byte */
+	BATCH_ADDR10,				/* 10-bit address low byte */
+	BATCH_RESTART10,			/* Repeated START to read from a 10-bit address */
+	BATCH_ADDR10RD,				/* 10-bit address high byte with the read bit */
+	BATCH_WRITE,				/* Data byte sent */
+	BATCH_READ,					/* Data byte received */
+	BATCH_STOP,					/* STOP */
+};
+
 struct master_data {
 	struct i2c_msg_s *msg;
 	int num;
@@ -206,6 +218,17 @@ struct s5j_i2c_priv_s {
 	struct slave_data *slave_test_data;
 	struct master_data *master_test_data;
 
+#ifdef CONFIG_I2C_BATCH
+	/* batch run by the interrupt handler */
+	sem_t batchsem;					/* Posted when the batch is done */
+	struct i2c_xfer_s *xferv;		/* The batch, NULL when none runs */
+	int xferc;						/* Number of transfers */
+	int xfern;						/* Current transfer */
+	int msgn;						/* Current message of the transfer */
+	int byten;						/* Next byte of the message */
+	uint8_t bstate;					/* See enum s5j_batch_state_e */
+#endif
+
 };
 
 /****************************************************************************
@@ -248,6 +271,13 @@ static void hsi2c_set_trans_mode(unsigned int base, unsigned int master, unsigne
 static void hsi2c_set_hwacg_mode(unsigned int base, unsigned int slave);
 static int hsi2c_master_handler(void *args);
 static int hsi2c_slave_handler(void *args);
+#ifdef CONFIG_I2C_BATCH
+static void hsi2c_batch_cmd(struct s5j_i2c_priv_s *priv, unsigned int cmd, uint8_t state);
+static void hsi2c_batch_data(struct s5j_i2c_priv_s *priv);
+static void hsi2c_batch_fail(struct s5j_i2c_priv_s *priv, int err);
+static bool hsi2c_batch_next(struct s5j_i2c_priv_s *priv);
+static int hsi2c_batch_handler(struct s5j_i2c_priv_s *priv);
+#endif
 static void hsi2c_set_auto_mode(unsigned int base);
 static void hsi2c_set_fifo_level(unsigned int base);
 static void hsi2c_master_setup(struct s5j_i2c_priv_s *priv, unsigned int mode, unsigned int speed, unsigned int slave_addr);
@@ -274,6 +304,9 @@ static int s5j_i2c_uninitialize(struct s5j_i2c_priv_s *priv);
 unsigned int s5j_i2c_setclock(struct i2c_dev_s *dev, unsigned int frequency);
 int s5j_i2c_setownaddress(FAR struct i2c_dev_s *dev, int addr, int nbits);
 int s5j_i2c_transfer(struct i2c_dev_s *dev, struct i2c_msg_s *msgv, int msgc);
+#ifdef CONFIG_I2C_BATCH
+int s5j_i2c_batch(struct i2c_dev_s *dev, struct i2c_xfer_s *xferv, int xferc);
+#endif
 int s5j_i2c_read(FAR struct i2c_dev_s *dev, FAR uint8_t *buffer, int buflen);
 int s5j_i2c_write(FAR struct i2c_dev_s *dev, FAR const uint8_t *buffer, int buflen);
 struct i2c_dev_s *up_i2cinitialize(int port);
@@ -146,21 +146,21 @@ static FAR struct s5j_mct_priv_s s5j_mct0_priv = {
 };
 #endif
 
-#ifdef CONFIG_S5J_TIMER1
+#if defined(CONFIG_S5J_TIMER1) || defined(CONFIG_S5J_HRTIMER)
 static FAR struct s5j_mct_priv_s s5j_mct1_priv = {
 	.base_addr = (S5J_MCT_BASE + 0x400),
 	.irq_id    = IRQ_MCT_L1,
 };
 #endif
 
-#ifdef CONFIG_S5J_TIMER2
+#if defined(CONFIG_S5J_TIMER2) || defined(CONFIG_S5J_ADC_BLOCK)
 static FAR struct s5j_mct_priv_s s5j_mct2_priv = {
 	.base_addr = (S5J_MCT_BASE + 0x500),
 	.irq_id    = IRQ_MCT_L2,
 };
 #endif
 
-#ifdef CONFIG_S5J_TIMER3
+#if defined(CONFIG_S5J_TIMER3) || defined(CONFIG_S5J_TICKLESS)
 static FAR struct s5j_mct_priv_s s5j_mct3_priv = {
 	.base_addr = (S5J_MCT_BASE + 0x600),
 	.irq_id    = IRQ_MCT_L3,
@@ -248,6 +248,50 @@ void s5j_mct_disableint(FAR struct s5j_mct_priv_s *priv)
 	mct_putreg32(priv, S5J_MCT_INT_ENB_OFFSET, 0);
 }
 
+void s5j_mct_setintmask(FAR struct s5j_mct_priv_s *priv, uint32_t mask)
+{
+	mct_putreg32(priv, S5J_MCT_INT_ENB_OFFSET, mask);
+}
+
+uint32_t s5j_mct_getstatus(FAR struct s5j_mct_priv_s *priv)
+{
+	return mct_getreg32(priv, S5J_MCT_INT_CSTAT_OFFSET);
+}
+
+void s5j_mct_clearstatus(FAR struct s5j_mct_priv_s *priv, uint32_t mask)
+{
+	mct_putreg32(priv, S5J_MCT_INT_CSTAT_OFFSET, mask);
+}
+
+uint32_t s5j_mct_getcount(FAR struct s5j_mct_priv_s *priv)
+{
+	/* Remaining ticks of the current tick counter period */
+	return mct_getreg32(priv, S5J_MCT_TCNTO_OFFSET);
+}
+
+void s5j_mct_frcstart(FAR struct s5j_mct_priv_s *priv, uint32_t reload)
+{
+	unsigned int value;
+
+	/* The free running counter counts down from 'reload' and reloads */
+	mct_putreg32(priv, S5J_MCT_FRCNTB_OFFSET, reload);
+	s5j_mct_wait_wstat(priv->base_addr, S5J_MCT_WSTAT_FRCCNTB);
+
+	value = mct_getreg32(priv, S5J_MCT_TCON_OFFSET);
+	mct_putreg32(priv, S5J_MCT_TCON_OFFSET, value | S5J_MCT_TCON_FRC_START);
+	s5j_mct_wait_wstat(priv->base_addr, S5J_MCT_WSTAT_TCON);
+}
+
+uint32_t s5j_mct_frcgetcount(FAR struct s5j_mct_priv_s *priv)
+{
+	return mct_getreg32(priv, S5J_MCT_FRCNTO_OFFSET);
+}
+
+uintptr_t s5j_mct_getregaddr(FAR struct s5j_mct_priv_s *priv, uint32_t offset)
+{
+	return priv->base_addr + offset;
+}
+
 FAR struct s5j_mct_priv_s *s5j_mct_init(int timer)
 {
 	FAR struct s5j_mct_priv_s *priv = NULL;
@@ -261,19 +305,19 @@ FAR struct s5j_mct_priv_s *s5j_mct_init(int timer)
 		break;
 #endif
 
-#ifdef CONFIG_S5J_TIMER1
+#if defined(CONFIG_S5J_TIMER1) || defined(CONFIG_S5J_HRTIMER)
 	case S5J_MCT_CHANNEL1:
 		priv = &s5j_mct1_priv;
 		break;
 #endif
 
-#ifdef CONFIG_S5J_TIMER2
+#if defined(CONFIG_S5J_TIMER2) || defined(CONFIG_S5J_ADC_BLOCK)
 	case S5J_MCT_CHANNEL2:
 		priv = &s5j_mct2_priv;
 		break;
 #endif
 
-#ifdef CONFIG_S5J_TIMER3
+#if defined(CONFIG_S5J_TIMER3) || defined(CONFIG_S5J_TICKLESS)
 	case S5J_MCT_CHANNEL3:
 		priv = &s5j_mct3_priv;
 		break;
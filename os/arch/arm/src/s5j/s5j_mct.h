@@ -108,6 +108,13 @@ int s5j_mct_setisr(FAR struct s5j_mct_priv_s *priv, xcpt_t handler, void *arg);
 void s5j_mct_setperiod(FAR struct s5j_mct_priv_s *priv, uint32_t period);
 void s5j_mct_enableint(FAR struct s5j_mct_priv_s *priv);
 void s5j_mct_disableint(FAR struct s5j_mct_priv_s *priv);
+void s5j_mct_setintmask(FAR struct s5j_mct_priv_s *priv, uint32_t mask);
+uint32_t s5j_mct_getstatus(FAR struct s5j_mct_priv_s *priv);
+void s5j_mct_clearstatus(FAR struct s5j_mct_priv_s *priv, uint32_t mask);
+uint32_t s5j_mct_getcount(FAR struct s5j_mct_priv_s *priv);
+void s5j_mct_frcstart(FAR struct s5j_mct_priv_s *priv, uint32_t reload);
+uint32_t s5j_mct_frcgetcount(FAR struct s5j_mct_priv_s *priv);
+uintptr_t s5j_mct_getregaddr(FAR struct s5j_mct_priv_s *priv, uint32_t offset);
 
 /* Power-up timer and get its structure */
 FAR struct s5j_mct_priv_s *s5j_mct_init(int timer);
@@ -138,6 +138,11 @@ int cal_clk_setrate(unsigned int id, unsigned long rate)
 		div = parents / rate;
 		modifyreg32(0x80081800, 0xf, (div - 1));
 		break;
+	case dvfs_cpu:
+		/* The Cortex-R4 clock is set up by the boot loader and its divider
+		 * is not described in s5j_cmu.h yet, so it cannot be changed here.
+		 */
+		return -1;
 	default:
 		break;
 	}
@@ -159,6 +164,9 @@ unsigned long cal_clk_getrate(unsigned int id)
 	case m1_clkcmu_uart:
 		rate = S5J_DEFAULT_UART_CLOCK;
 		break;
+	case dvfs_cpu:
+		rate = S5J_DEFAULT_CPU_CLOCK;
+		break;
 	case gate_hsi2c0:
 	case gate_hsi2c1:
 	case gate_hsi2c2:
@@ -207,6 +207,24 @@
 #define UART4_ASSIGNED	1
 #endif
 
+/* FIFO trigger levels and RX timeout */
+#ifndef CONFIG_S5J_UART_RX_FIFO_TRIG
+#define CONFIG_S5J_UART_RX_FIFO_TRIG	2
+#endif
+#ifndef CONFIG_S5J_UART_TX_FIFO_TRIG
+#define CONFIG_S5J_UART_TX_FIFO_TRIG	2
+#endif
+#ifndef CONFIG_S5J_UART_RX_TIMEOUT_FRAMES
+#define CONFIG_S5J_UART_RX_TIMEOUT_FRAMES	32
+#endif
+
+#define S5J_UART_RX_FIFO_TRIG	\
+	((CONFIG_S5J_UART_RX_FIFO_TRIG << UART_UFCON_RX_FIFO_TRIG_SHIFT) & UART_UFCON_RX_FIFO_TRIG_MASK)
+#define S5J_UART_TX_FIFO_TRIG	\
+	((CONFIG_S5J_UART_TX_FIFO_TRIG << UART_UFCON_TX_FIFO_TRIG_SHIFT) & UART_UFCON_TX_FIFO_TRIG_MASK)
+#define S5J_UART_RX_TOUT		\
+	(((CONFIG_S5J_UART_RX_TIMEOUT_FRAMES / 8 - 1) << UART_UCON_RX_TOUT_SHIFT) & UART_UCON_RX_TOUT_MASK)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -365,7 +383,7 @@ static int up_setup(struct uart_dev_s *dev)
 	uart_putreg32(priv, S5J_UART_ULCON_OFFSET, regval);
 
 	/* UCON */
-	regval = UART_UCON_RX_TOUT_32FRAMES |
+	regval = S5J_UART_RX_TOUT |
 			UART_UCON_TX_INTTYPE_LEVEL | UART_UCON_RX_INTTYPE_LEVEL |
 			UART_UCON_RX_TOUTINT_ENABLE | UART_UCON_RX_ERRINT_DISABLE |
 			UART_UCON_TX_MODE_IRQPOLL | UART_UCON_RX_MODE_IRQPOLL;
@@ -387,7 +405,7 @@ static int up_setup(struct uart_dev_s *dev)
 	/* Reset TX and RX FIFO and enable FIFO mode */
 	regval = UART_UFCON_FIFO_ENABLE |
 			UART_UFCON_TX_FIFO_RESET | UART_UFCON_RX_FIFO_RESET |
-			UART_UFCON_TX_FIFO_TRIG_4BYTES | UART_UFCON_RX_FIFO_TRIG_4BYTES;
+			S5J_UART_TX_FIFO_TRIG | S5J_UART_RX_FIFO_TRIG;
 
 	uart_putreg32(priv, S5J_UART_UFCON_OFFSET, regval);
 
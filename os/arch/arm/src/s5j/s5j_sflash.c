@@ -57,6 +57,7 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <string.h>
 #include <tinyara/irq.h>
 #include <tinyara/progmem.h>
 
@@ -68,6 +69,13 @@
 #include "s5j_gpio.h"
 #include "chip/s5jt200_sflash.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#ifndef CONFIG_S5J_SFLASH_WRITE_CHUNK
+#define CONFIG_S5J_SFLASH_WRITE_CHUNK	256
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -164,7 +172,6 @@ ssize_t up_progmem_ispageerased(size_t page)
 ssize_t up_progmem_write(size_t addr, const void *buf, size_t count)
 {
 	int page;
-	int pagesize;
 	size_t remain = count;
 
 	page = up_progmem_getpage(addr + count);
@@ -172,14 +179,18 @@ ssize_t up_progmem_write(size_t addr, const void *buf, size_t count)
 		return -EINVAL;
 	}
 
-	pagesize = up_progmem_pagesize(page);
-
 	while (remain) {
-		int tmp = remain;
+		size_t tmp;
 		irqstate_t irqs;
 
-		if (tmp > pagesize) {
-			tmp = pagesize;
+		/*
+		 * Program up to the next chunk boundary, so that interrupts are
+		 * never disabled for more than one chunk
+		 */
+		tmp = CONFIG_S5J_SFLASH_WRITE_CHUNK -
+				(addr % CONFIG_S5J_SFLASH_WRITE_CHUNK);
+		if (tmp > remain) {
+			tmp = remain;
 		}
 
 		/* Disable IRQs */
@@ -140,6 +140,9 @@
 #define SPI_STAT_TRAILING_BYTE(x)	((x >> 24) & 1)
 #define SPI_STAT_TX_DONE(x)			((x >> 25) & 1)
 
+/* Depth of the TX and RX FIFOs, in words */
+#define S5J_SPI_FIFO_DEPTH			64
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -405,13 +408,22 @@ static uint16_t spi_send(struct spi_dev_s *dev, uint16_t wd)
  * Description:
  *   Exchange a block data with the SPI device. Support only byte transfers.
  *
+ *   Each pass reads the status once, then fills the TX FIFO and drains the
+ *   RX FIFO as far as the levels allow.  No more than S5J_SPI_FIFO_DEPTH
+ *   words are in flight, so that the RX FIFO cannot overrun.
+ *
  ****************************************************************************/
 static void spi_exchange(struct spi_dev_s *dev, const void *txbuffer, void *rxbuffer, size_t nwords)
 {
 	FAR struct s5j_spidev_s *priv = (FAR struct s5j_spidev_s *)dev;
+	FAR const uint8_t *tx = (FAR const uint8_t *)txbuffer;
+	FAR uint8_t *rx = (FAR uint8_t *)rxbuffer;
 
 	size_t sent = 0;
 	size_t received = 0;
+	unsigned int status;
+	unsigned int txroom;
+	unsigned int rxlevel;
 	unsigned int dummy_rx;
 
 	SPI_SFR *pSPIRegs;
@@ -423,63 +435,28 @@ static void spi_exchange(struct spi_dev_s *dev, const void *txbuffer, void *rxbu
 	putreg32(ch_cfg, &pSPIRegs->CH_CFG);
 
 	/* TX/RX */
-	if ((rxbuffer == NULL) && (txbuffer == NULL)) {
-		while (received < nwords) {
-			if (sent < nwords)
-				if (SPI_STAT_TX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) < 64) {
-					putreg32(0, &pSPIRegs->SPI_TX_DATA);
-					sent++;
-				}
-
-			if (SPI_STAT_RX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) > 0) {
-				dummy_rx = getreg32(&pSPIRegs->SPI_RX_DATA);
-				received++;
-			}
-		}
-		return;
-	}
-
-	if (rxbuffer == NULL) {
-		while (received < nwords) {
-			if (sent < nwords)
-				if (SPI_STAT_TX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) < 64) {
-					putreg32(((unsigned char *)txbuffer)[sent++], &pSPIRegs->SPI_TX_DATA);
-				}
+	while (received < nwords) {
+		status = getreg32(&pSPIRegs->SPI_STATUS);
 
-			if (SPI_STAT_RX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) > 0) {
-				dummy_rx = getreg32(&pSPIRegs->SPI_RX_DATA);
-				received++;
-			}
+		txroom = S5J_SPI_FIFO_DEPTH - SPI_STAT_TX_FIFO_LVL(status);
+		if (txroom > S5J_SPI_FIFO_DEPTH - (sent - received)) {
+			txroom = S5J_SPI_FIFO_DEPTH - (sent - received);
 		}
-		return;
-	}
-
-	if (txbuffer == NULL) {
-		while (received < nwords) {
-			if (sent < nwords)
-				if (SPI_STAT_TX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) < 64) {
-					putreg32(((unsigned char *)rxbuffer)[sent++], &pSPIRegs->SPI_TX_DATA);
-				}
-
-			if (SPI_STAT_RX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) > 0) {
-				((unsigned char *)rxbuffer)[received++] = getreg32(&pSPIRegs->SPI_RX_DATA);
-			}
 
+		for (; txroom > 0 && sent < nwords; txroom--, sent++) {
+			putreg32(tx ? tx[sent] : 0, &pSPIRegs->SPI_TX_DATA);
 		}
-		return;
-	}
 
-	while (received < nwords) {
-		if (sent < nwords)
-			if (SPI_STAT_TX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) < 64) {
-				putreg32(((unsigned char *)txbuffer)[sent++], &pSPIRegs->SPI_TX_DATA);
+		for (rxlevel = SPI_STAT_RX_FIFO_LVL(status); rxlevel > 0; rxlevel--, received++) {
+			if (rx) {
+				rx[received] = getreg32(&pSPIRegs->SPI_RX_DATA);
+			} else {
+				dummy_rx = getreg32(&pSPIRegs->SPI_RX_DATA);
 			}
-
-		if (SPI_STAT_RX_FIFO_LVL(getreg32(&pSPIRegs->SPI_STATUS)) > 0) {
-			((unsigned char *)rxbuffer)[received++] = getreg32(&pSPIRegs->SPI_RX_DATA);
 		}
-
 	}
+
+	(void)dummy_rx;
 }
 
 /****************************************************************************
@@ -0,0 +1,309 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/s5j/s5j_tickless.c
+ *
+ * Tick-less OS support on MCT channel 3, clocked at 1MHz.  The free running
+ * counter of the channel provides the system time; each time it reloads,
+ * 2^32 microseconds are added to the time base.  The tick counter of the
+ * channel, in one-shot mode, provides the interval timer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/timepage.h>
+
+#include "up_arch.h"
+#ifdef CONFIG_ARMV7M_MPU
+#include "mpu.h"
+#endif
+
+#include "chip.h"
+#include "chip/s5jt200_mct.h"
+#include "s5j_mct.h"
+
+#ifdef CONFIG_S5J_TICKLESS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define TICKLESS_CHANNEL	S5J_MCT_CHANNEL3
+
+/* Size of the registers of one MCT channel */
+#define TICKLESS_REGSIZE	0x100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct s5j_tickless_s {
+	FAR struct s5j_mct_priv_s *mct;
+	uint32_t frcwraps;			/* Number of free running counter reloads */
+	bool running;				/* True: the interval timer is running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static struct s5j_tickless_s g_tickless;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static void s5j_usec2timespec(uint64_t usec, FAR struct timespec *ts)
+{
+	ts->tv_sec  = (time_t)(usec / USEC_PER_SEC);
+	ts->tv_nsec = (long)(usec % USEC_PER_SEC) * NSEC_PER_USEC;
+}
+
+/*
+ * Return the number of microseconds since up_timer_initialize().  A reload
+ * of the free running counter that is not yet accounted for by the
+ * interrupt handler is detected from the pending status.
+ */
+static uint64_t s5j_tickless_uptime(void)
+{
+	FAR struct s5j_mct_priv_s *mct = g_tickless.mct;
+	uint32_t wraps;
+	uint32_t count;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	wraps = g_tickless.frcwraps;
+	count = s5j_mct_frcgetcount(mct);
+	if (s5j_mct_getstatus(mct) & S5J_MCT_INT_CSTAT_FRC) {
+		/* Re-read so that the count is known to be past the reload */
+		count = s5j_mct_frcgetcount(mct);
+		wraps++;
+	}
+
+	irqrestore(flags);
+
+	return ((uint64_t)wraps << 32) + (UINT32_MAX - count);
+}
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+/*
+ * Publish the free running counter in the user-space time page.  User code
+ * reads the count and the pending reload status of the channel directly,
+ * so both its registers and the page are made readable from user mode.
+ */
+static void s5j_tickless_timepage_init(FAR struct s5j_mct_priv_s *mct)
+{
+#ifdef CONFIG_ARMV7M_MPU
+	mpu_user_peripheral_ro(s5j_mct_getregaddr(mct, 0), TICKLESS_REGSIZE);
+	mpu_user_intsram_ro((uintptr_t)&g_timepage, TIMEPAGE_SIZE);
+#endif
+
+	clock_timepage_initialize((FAR const volatile uint32_t *)s5j_mct_getregaddr(mct, S5J_MCT_FRCNTO_OFFSET), USEC_PER_SEC, true,
+		(FAR const volatile uint32_t *)s5j_mct_getregaddr(mct, S5J_MCT_INT_CSTAT_OFFSET), S5J_MCT_INT_CSTAT_FRC);
+}
+
+/*
+ * Take a new time page sample.  Called with interrupts disabled whenever
+ * a reload of the free running counter has been accounted for.
+ */
+static void s5j_tickless_timepage_update(void)
+{
+	uint32_t count = s5j_mct_frcgetcount(g_tickless.mct);
+	struct timespec ts;
+
+	s5j_usec2timespec(((uint64_t)g_tickless.frcwraps << 32) + (UINT32_MAX - count), &ts);
+	clock_timepage_update(g_tickless.frcwraps, count, &ts);
+}
+#endif
+
+static int s5j_tickless_isr(int irq, FAR void *context, FAR void *arg)
+{
+	FAR struct s5j_mct_priv_s *mct = g_tickless.mct;
+	uint32_t status = s5j_mct_getstatus(mct);
+
+	if (status & S5J_MCT_INT_CSTAT_FRC) {
+		/* The free running counter reloaded */
+		s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_FRC);
+		g_tickless.frcwraps++;
+#ifdef CONFIG_CLOCK_TIMEPAGE
+		s5j_tickless_timepage_update();
+#endif
+	}
+
+	if (status & S5J_MCT_INT_CSTAT_ICNT) {
+		/* The interval timer expired */
+		s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+
+		if (g_tickless.running) {
+			s5j_mct_disable(mct);
+			g_tickless.running = false;
+			sched_timer_expiration();
+		}
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function:  up_timer_initialize
+ *
+ * Description:
+ *   Start the free running counter that provides the system time and set
+ *   up the interval timer (stopped).
+ *
+ ****************************************************************************/
+void up_timer_initialize(void)
+{
+	FAR struct s5j_mct_priv_s *mct;
+
+	mct = s5j_mct_init(TICKLESS_CHANNEL);
+	DEBUGASSERT(mct != NULL);
+
+	g_tickless.mct = mct;
+	g_tickless.frcwraps = 0;
+	g_tickless.running = false;
+
+#ifdef CONFIG_SCHED_TICKLESS_LIMIT_MAX_SLEEP
+	/* The tick counter of the interval timer is 32 bits wide */
+	g_oneshot_maxticks = UINT32_MAX / USEC_PER_TICK;
+#endif
+
+	s5j_mct_disable(mct);
+	s5j_mct_setmode(mct, true);
+	s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_FRC | S5J_MCT_INT_CSTAT_ICNT);
+
+	s5j_mct_setisr(mct, s5j_tickless_isr, NULL);
+	s5j_mct_setintmask(mct, S5J_MCT_INTR_FRC | S5J_MCT_INTR_ICNT);
+
+	s5j_mct_frcstart(mct, UINT32_MAX);
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+	s5j_tickless_timepage_init(mct);
+	s5j_tickless_timepage_update();
+#endif
+}
+
+/****************************************************************************
+ * Function:  up_timer_gettime
+ *
+ * Description:
+ *   Return the elapsed time since up_timer_initialize() was called.
+ *
+ ****************************************************************************/
+int up_timer_gettime(FAR struct timespec *ts)
+{
+	DEBUGASSERT(ts != NULL);
+
+	s5j_usec2timespec(s5j_tickless_uptime(), ts);
+
+	return OK;
+}
+
+/****************************************************************************
+ * Function:  up_timer_cancel
+ *
+ * Description:
+ *   Stop the interval timer and return the time that was remaining.  If the
+ *   timer has already expired, the remaining time is zero and
+ *   sched_timer_expiration() will not be called.
+ *
+ ****************************************************************************/
+int up_timer_cancel(FAR struct timespec *ts)
+{
+	FAR struct s5j_mct_priv_s *mct = g_tickless.mct;
+	uint32_t remaining = 0;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	if (g_tickless.running) {
+		remaining = s5j_mct_getcount(mct);
+		s5j_mct_disable(mct);
+
+		if (s5j_mct_getstatus(mct) & S5J_MCT_INT_CSTAT_ICNT) {
+			/* Expired while interrupts were disabled */
+			s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+			remaining = 0;
+		}
+
+		g_tickless.running = false;
+	}
+
+	irqrestore(flags);
+
+	if (ts != NULL) {
+		s5j_usec2timespec(remaining, ts);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Function:  up_timer_start
+ *
+ * Description:
+ *   (Re-)start the interval timer.  sched_timer_expiration() is called
+ *   when it expires.
+ *
+ ****************************************************************************/
+int up_timer_start(FAR const struct timespec *ts)
+{
+	FAR struct s5j_mct_priv_s *mct = g_tickless.mct;
+	uint64_t usec;
+	irqstate_t flags;
+
+	DEBUGASSERT(ts != NULL);
+
+	usec = (uint64_t)ts->tv_sec * USEC_PER_SEC + ts->tv_nsec / NSEC_PER_USEC;
+	if (usec == 0) {
+		usec = 1;
+	} else if (usec > UINT32_MAX) {
+		usec = UINT32_MAX;
+	}
+
+	flags = irqsave();
+
+	if (g_tickless.running) {
+		s5j_mct_disable(mct);
+	}
+
+	s5j_mct_clearstatus(mct, S5J_MCT_INT_CSTAT_ICNT);
+	s5j_mct_setperiod(mct, (uint32_t)usec);
+	s5j_mct_enable(mct);
+	g_tickless.running = true;
+
+	irqrestore(flags);
+
+	return OK;
+}
+
+#endif /* CONFIG_S5J_TICKLESS */
@@ -93,11 +93,16 @@ enum {
 	num_of_umux = vclk_group_umux_end - 0x0A060000,
 
 	dvfs_dummy = 0x0A070000,
+	dvfs_cpu,
 	vclk_group_dfs_end,
 	num_of_dfs = vclk_group_dfs_end - 0x0A070000,
 };
 
+#define S5J_DEFAULT_CPU_CLOCK	(320 * 1000 * 1000)
 #define S5J_DEFAULT_I2C_CLOCK	(160 * 1000 * 1000)
 #define S5J_DEFAULT_UART_CLOCK	(26 * 1000 * 1000)
 
+int cal_clk_setrate(unsigned int id, unsigned long rate);
+unsigned long cal_clk_getrate(unsigned int id);
+
 #endif /* __ARCH_ARM_SRC_S5J_S5J_VCLK_H__ */
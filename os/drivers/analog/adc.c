@@ -76,7 +76,9 @@
 #include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
 #include <tinyara/semaphore.h>
+#include <tinyara/kmalloc.h>
 #include <tinyara/analog/adc.h>
+#include <tinyara/analog/ioctl.h>
 
 #include <tinyara/irq.h>
 
@@ -90,6 +92,12 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
 			   int32_t data);
+#ifdef CONFIG_ADC_BLOCK
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+				 FAR const struct timespec *ts,
+				 FAR const int32_t *data, uint16_t nsets);
+static void    adc_blockstop(FAR struct adc_dev_s *dev);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -107,7 +115,10 @@ static const struct file_operations g_adc_fops = {
 };
 
 static const struct adc_callback_s g_adc_callback = {
-	adc_receive	/* au_receive */
+	adc_receive,		/* au_receive */
+#ifdef CONFIG_ADC_BLOCK
+	adc_receive_block,	/* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -209,6 +220,10 @@ static int adc_close(FAR struct file *filep)
 			/* There are no more references to the port */
 			dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_BLOCK
+			adc_blockstop(dev);
+#endif
+
 			/* Free the IRQ and disable the ADC device */
 			flags = irqsave(); /* Disable interrupts */
 			dev->ad_ops->ao_shutdown(dev); /* Disable the ADC */
@@ -221,6 +236,144 @@ static int adc_close(FAR struct file *filep)
 	return ret;
 }
 
+#ifdef CONFIG_ADC_BLOCK
+/****************************************************************************
+ * Name: adc_blockstart
+ *
+ * Description:
+ *   Allocate the block queue and start block mode in the lower half.
+ *
+ ****************************************************************************/
+static int adc_blockstart(FAR struct adc_dev_s *dev,
+			  FAR const struct adc_blockcfg_s *cfg)
+{
+	FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+	FAR uint8_t *buffer;
+	irqstate_t flags;
+	size_t size;
+	int ret;
+
+	if (dev->ad_ops->ao_blockstart == NULL) {
+		return -ENOSYS;
+	}
+
+	if (cfg == NULL || cfg->ab_rate == 0 || cfg->ab_nsets == 0 ||
+	    cfg->ab_nchannels == 0) {
+		return -EINVAL;
+	}
+
+	if (fifo->ab_buffer != NULL) {
+		return -EBUSY;
+	}
+
+	size = ADC_BLOCK_SIZE(cfg->ab_nsets, cfg->ab_nchannels);
+	buffer = (FAR uint8_t *)kmm_malloc(size * CONFIG_ADC_NBLOCKS);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	flags = irqsave();
+	fifo->ab_size   = size;
+	fifo->ab_seqno  = 0;
+	fifo->ab_head   = 0;
+	fifo->ab_tail   = 0;
+	fifo->ab_cfg    = *cfg;
+	fifo->ab_buffer = buffer;
+	irqrestore(flags);
+
+	ret = dev->ad_ops->ao_blockstart(dev, cfg);
+	if (ret < 0) {
+		flags = irqsave();
+		fifo->ab_buffer = NULL;
+		irqrestore(flags);
+		kmm_free(buffer);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: adc_blockstop
+ ****************************************************************************/
+static void adc_blockstop(FAR struct adc_dev_s *dev)
+{
+	FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+	FAR uint8_t *buffer;
+	irqstate_t flags;
+	int i;
+
+	if (fifo->ab_buffer == NULL) {
+		return;
+	}
+
+	dev->ad_ops->ao_blockstop(dev);
+
+	flags = irqsave();
+	buffer = fifo->ab_buffer;
+	fifo->ab_buffer = NULL;
+
+	/* Wake up the readers waiting for a block */
+	for (i = 0; i < dev->ad_nrxwaiters; i++) {
+		sem_post(&dev->ad_recv.af_sem);
+	}
+	irqrestore(flags);
+
+	kmm_free(buffer);
+}
+
+/****************************************************************************
+ * Name: adc_readblocks
+ *
+ * Description:
+ *   read() in block mode: copy as many whole blocks as fit in the buffer.
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+static ssize_t adc_readblocks(FAR struct file *filep,
+			      FAR struct adc_dev_s *dev, FAR char *buffer,
+			      size_t buflen)
+{
+	FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+	size_t nread = 0;
+	int ret;
+
+	if (buflen < fifo->ab_size) {
+		return -EINVAL;
+	}
+
+	while (fifo->ab_head == fifo->ab_tail) {
+		if (filep->f_oflags & O_NONBLOCK) {
+			return -EAGAIN;
+		}
+
+		dev->ad_nrxwaiters++;
+		ret = sem_wait(&dev->ad_recv.af_sem);
+		dev->ad_nrxwaiters--;
+		if (ret < 0) {
+			return -errno;
+		}
+
+		/* Block mode may have been stopped meanwhile */
+		if (fifo->ab_buffer == NULL) {
+			return 0;
+		}
+	}
+
+	do {
+		memcpy(&buffer[nread], &fifo->ab_buffer[fifo->ab_head * fifo->ab_size],
+		       fifo->ab_size);
+		nread += fifo->ab_size;
+
+		if (++fifo->ab_head >= CONFIG_ADC_NBLOCKS) {
+			fifo->ab_head = 0;
+		}
+	} while (fifo->ab_head != fifo->ab_tail &&
+		 nread + fifo->ab_size <= buflen);
+
+	return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_read
  ****************************************************************************/
@@ -236,6 +389,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
 
 	avdbg("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCK
+	if (dev->ad_blocks.ab_buffer != NULL) {
+		flags = irqsave();
+		ret = adc_readblocks(filep, dev, buffer, buflen);
+		irqrestore(flags);
+		return ret;
+	}
+#endif
+
 	if (buflen % 5 == 0)
 		msglen = 5;
 	else if (buflen % 4 == 0)
@@ -350,7 +512,23 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	FAR struct adc_dev_s *dev = inode->i_private;
 	int ret;
 
-	ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+	switch (cmd) {
+#ifdef CONFIG_ADC_BLOCK
+	case ANIOC_BLOCK_START:
+		ret = adc_blockstart(dev, (FAR const struct adc_blockcfg_s *)((uintptr_t)arg));
+		break;
+
+	case ANIOC_BLOCK_STOP:
+		adc_blockstop(dev);
+		ret = OK;
+		break;
+#endif
+
+	default:
+		ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+		break;
+	}
+
 	return ret;
 }
 
@@ -391,6 +569,57 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
 	return errcode;
 }
 
+#ifdef CONFIG_ADC_BLOCK
+/****************************************************************************
+ * Name: adc_receive_block
+ ****************************************************************************/
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+			     FAR const struct timespec *ts,
+			     FAR const int32_t *data, uint16_t nsets)
+{
+	FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+	FAR struct adc_block_s *block;
+	int nexttail;
+	int errcode = -ENOMEM;
+
+	if (fifo->ab_buffer == NULL || nsets != fifo->ab_cfg.ab_nsets) {
+		return -EINVAL;
+	}
+
+	nexttail = fifo->ab_tail + 1;
+	if (nexttail >= CONFIG_ADC_NBLOCKS) {
+		nexttail = 0;
+	}
+
+	/*
+	 * Drop the new block if the queue is full.  Its sequence number is
+	 * consumed anyway so that the reader can tell.
+	 */
+	if (nexttail != fifo->ab_head) {
+		block = (FAR struct adc_block_s *)
+			&fifo->ab_buffer[fifo->ab_tail * fifo->ab_size];
+		block->ab_time      = *ts;
+		block->ab_seqno     = fifo->ab_seqno;
+		block->ab_nsets     = nsets;
+		block->ab_nchannels = fifo->ab_cfg.ab_nchannels;
+		block->ab_reserved  = 0;
+		memcpy(block + 1, data,
+		       nsets * fifo->ab_cfg.ab_nchannels * sizeof(int32_t));
+
+		fifo->ab_tail = nexttail;
+
+		if (dev->ad_nrxwaiters > 0) {
+			sem_post(&dev->ad_recv.af_sem);
+		}
+
+		errcode = OK;
+	}
+
+	fifo->ab_seqno++;
+	return errcode;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
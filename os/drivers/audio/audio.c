@@ -62,9 +62,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <unistd.h>
 #include <string.h>
 #include <semaphore.h>
+#include <time.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
@@ -73,6 +75,9 @@
 #include <tinyara/kmalloc.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/audio/audio.h>
 #include <mqueue.h>
 
@@ -94,6 +99,24 @@
 #define CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO  1
 #endif
 
+#ifdef CONFIG_AUDIO_GRAPH
+#ifndef CONFIG_AUDIO_GRAPH_NNODES
+#define CONFIG_AUDIO_GRAPH_NNODES 4
+#endif
+
+#ifndef CONFIG_AUDIO_GRAPH_PRIORITY
+#define CONFIG_AUDIO_GRAPH_PRIORITY 224
+#endif
+
+#ifndef CONFIG_AUDIO_GRAPH_STACKSIZE
+#define CONFIG_AUDIO_GRAPH_STACKSIZE 2048
+#endif
+
+/* Completed buffers waiting for the graph thread, a power of two */
+
+#define AUDIO_GRAPH_QDEPTH 8
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -106,6 +129,18 @@ struct audio_upperhalf_s {
 	sem_t exclsem;				/* Supports mutual exclusion */
 	FAR struct audio_lowerhalf_s *dev;	/* lower-half state */
 	mqd_t usermq;				/* User mode app's message queue */
+#ifdef CONFIG_AUDIO_GRAPH
+	struct audio_graph_node_s nodes[CONFIG_AUDIO_GRAPH_NNODES];
+	volatile uint8_t nnodes;		/* Number of graph nodes, 0: graph off */
+	uint8_t qhead;				/* Completed buffers, written by the callback */
+	uint8_t qtail;				/* and read by the graph thread */
+	volatile int16_t inflight;		/* Buffers held by the lower half */
+	pid_t graphpid;				/* Graph thread, 0 until the first node */
+	sem_t graphsem;				/* Counts buffers in the queue */
+	FAR struct ap_buffer_s *queue[AUDIO_GRAPH_QDEPTH];
+	uint32_t stamp[AUDIO_GRAPH_QDEPTH];	/* Completion time of each buffer */
+	struct audio_graph_stats_s stats;
+#endif
 };
 
 /****************************************************************************
@@ -117,6 +152,11 @@ static int audio_close(FAR struct file *filep);
 static ssize_t audio_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t audio_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
 static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef CONFIG_AUDIO_GRAPH
+static int audio_graph_start(FAR struct audio_upperhalf_s *upper);
+static int audio_graph_enqueue(FAR struct audio_upperhalf_s *upper, FAR struct ap_buffer_s *apb);
+static bool audio_graph_complete(FAR struct audio_upperhalf_s *upper, FAR struct ap_buffer_s *apb);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int audio_start(FAR struct audio_upperhalf_s *upper, FAR void *session);
 static void audio_callback(FAR void *priv, uint16_t reason, FAR struct ap_buffer_s *apb, uint16_t status, FAR void *session);
@@ -556,7 +596,11 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
 
 		bufdesc = (FAR struct audio_buf_desc_s *)arg;
+#ifdef CONFIG_AUDIO_GRAPH
+		ret = audio_graph_enqueue(upper, bufdesc->u.pBuffer);
+#else
 		ret = lower->ops->enqueuebuffer(lower, bufdesc->u.pBuffer);
+#endif
 	}
 	break;
 
@@ -586,6 +630,70 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	}
 	break;
 
+#ifdef CONFIG_AUDIO_GRAPH
+	/* AUDIOIOC_GRAPH_ADDNODE - Append a processing node to the graph
+	 *
+	 *   ioctl argument:  pointer to an audio_graph_node_s structure
+	 */
+
+	case AUDIOIOC_GRAPH_ADDNODE: {
+		FAR struct audio_graph_node_s *node = (FAR struct audio_graph_node_s *)arg;
+
+		audinfo("AUDIOIOC_GRAPH_ADDNODE\n");
+
+		if (node == NULL || node->process == NULL) {
+			ret = -EINVAL;
+		} else if (upper->nnodes >= CONFIG_AUDIO_GRAPH_NNODES) {
+			ret = -ENOSPC;
+		} else {
+			ret = audio_graph_start(upper);
+			if (ret == OK) {
+				upper->nodes[upper->nnodes] = *node;
+				upper->nnodes++;
+			}
+		}
+	}
+	break;
+
+	/* AUDIOIOC_GRAPH_CLEAR - Remove all graph nodes
+	 *
+	 *   ioctl argument:  None
+	 */
+
+	case AUDIOIOC_GRAPH_CLEAR: {
+		audinfo("AUDIOIOC_GRAPH_CLEAR\n");
+
+		upper->nnodes = 0;
+		ret = OK;
+	}
+	break;
+
+	/* AUDIOIOC_GRAPH_GETSTATS - Get and reset the graph statistics
+	 *
+	 *   ioctl argument:  pointer to an audio_graph_stats_s structure
+	 */
+
+	case AUDIOIOC_GRAPH_GETSTATS: {
+		FAR struct audio_graph_stats_s *stats = (FAR struct audio_graph_stats_s *)arg;
+		irqstate_t flags;
+
+		audinfo("AUDIOIOC_GRAPH_GETSTATS\n");
+
+		if (stats == NULL) {
+			ret = -EINVAL;
+		} else {
+			flags = irqsave();
+			*stats = upper->stats;
+			upper->stats.periods = 0;
+			upper->stats.xruns = 0;
+			upper->stats.lat_max = 0;
+			irqrestore(flags);
+			ret = OK;
+		}
+	}
+	break;
+#endif							/* CONFIG_AUDIO_GRAPH */
+
 	/* AUDIOIOC_RESERVE - Reserve a session with the driver
 	 *
 	 *   ioctl argument - pointer to receive the session context
@@ -761,6 +869,14 @@ static void audio_callback(FAR void *handle, uint16_t reason, FAR struct ap_buff
 
 	switch (reason) {
 	case AUDIO_CALLBACK_DEQUEUE: {
+#ifdef CONFIG_AUDIO_GRAPH
+		/* Let the graph thread process and requeue the buffer */
+
+		if (audio_graph_complete(upper, apb)) {
+			break;
+		}
+#endif
+
 		/* Call the dequeue routine */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -797,6 +913,206 @@ static void audio_callback(FAR void *handle, uint16_t reason, FAR struct ap_buff
 	}
 }
 
+#ifdef CONFIG_AUDIO_GRAPH
+/****************************************************************************
+ * Name: audio_graph_usec
+ *
+ * Description:
+ *   Time stamp for the latency statistics.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_graph_usec(void)
+{
+#ifdef CONFIG_CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+	return (uint32_t)TICK2USEC(clock_systimer());
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_graph_enqueue
+ *
+ * Description:
+ *   Give a buffer to the lower half, counting the buffers it holds.  Called
+ *   with exclsem held.
+ *
+ ****************************************************************************/
+
+static int audio_graph_enqueue(FAR struct audio_upperhalf_s *upper, FAR struct ap_buffer_s *apb)
+{
+	FAR struct audio_lowerhalf_s *lower = upper->dev;
+	irqstate_t flags;
+	int ret;
+
+	flags = irqsave();
+	upper->inflight++;
+	irqrestore(flags);
+
+	ret = lower->ops->enqueuebuffer(lower, apb);
+	if (ret < 0) {
+		flags = irqsave();
+		upper->inflight--;
+		irqrestore(flags);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: audio_graph_complete
+ *
+ * Description:
+ *   Called from the lower half's dequeue callback, possibly in an interrupt
+ *   handler.  Queues the buffer for the graph thread and returns true, or
+ *   returns false if the buffer should go to the message queue.
+ *
+ ****************************************************************************/
+
+static bool audio_graph_complete(FAR struct audio_upperhalf_s *upper, FAR struct ap_buffer_s *apb)
+{
+	irqstate_t flags;
+	bool queued = false;
+
+	flags = irqsave();
+
+	/* The lower half has nothing left to play or fill */
+
+	if (--upper->inflight <= 0 && upper->started && upper->nnodes > 0) {
+		upper->stats.xruns++;
+	}
+
+	if (upper->nnodes > 0 && (uint8_t)(upper->qhead - upper->qtail) < AUDIO_GRAPH_QDEPTH) {
+		upper->queue[upper->qhead & (AUDIO_GRAPH_QDEPTH - 1)] = apb;
+		upper->stamp[upper->qhead & (AUDIO_GRAPH_QDEPTH - 1)] = audio_graph_usec();
+		upper->qhead++;
+		queued = true;
+	}
+
+	irqrestore(flags);
+
+	if (queued) {
+		sem_post(&upper->graphsem);
+	}
+
+	return queued;
+}
+
+/****************************************************************************
+ * Name: audio_graph_thread
+ *
+ * Description:
+ *   Runs the graph nodes on each completed buffer and enqueues it again.
+ *
+ ****************************************************************************/
+
+static int audio_graph_thread(int argc, FAR char *argv[])
+{
+	FAR struct audio_upperhalf_s *upper;
+	FAR struct ap_buffer_s *apb;
+	irqstate_t flags;
+	uint32_t stamp;
+	uint32_t latency;
+	int ret;
+	int i;
+
+	DEBUGASSERT(argc == 2);
+	upper = (FAR struct audio_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+	for (;;) {
+		if (sem_wait(&upper->graphsem) < 0) {
+			continue;
+		}
+
+		flags = irqsave();
+		apb = upper->queue[upper->qtail & (AUDIO_GRAPH_QDEPTH - 1)];
+		stamp = upper->stamp[upper->qtail & (AUDIO_GRAPH_QDEPTH - 1)];
+		upper->qtail++;
+		irqrestore(flags);
+
+		/* Run the nodes in order */
+
+		ret = upper->nnodes > 0 ? OK : -ENOENT;
+		for (i = 0; ret == OK && i < upper->nnodes; i++) {
+			ret = upper->nodes[i].process(apb, upper->nodes[i].arg);
+		}
+
+		while (sem_wait(&upper->exclsem) < 0) {
+		}
+
+		if (ret == OK && upper->started) {
+			ret = audio_graph_enqueue(upper, apb);
+		} else if (ret == OK) {
+			ret = -ESHUTDOWN;
+		}
+
+		if (ret < 0) {
+			/* Return the buffer to the application */
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+			audio_dequeuebuffer(upper, apb, OK, apb->session);
+#else
+			audio_dequeuebuffer(upper, apb, OK);
+#endif
+		}
+
+		sem_post(&upper->exclsem);
+
+		latency = audio_graph_usec() - stamp;
+
+		flags = irqsave();
+		upper->stats.periods++;
+		upper->stats.lat_last = latency;
+		if (latency > upper->stats.lat_max) {
+			upper->stats.lat_max = latency;
+		}
+		irqrestore(flags);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: audio_graph_start
+ *
+ * Description:
+ *   Create the graph thread of the device if it does not exist yet.
+ *
+ ****************************************************************************/
+
+static int audio_graph_start(FAR struct audio_upperhalf_s *upper)
+{
+	FAR char *argv[2];
+	char arg[16];
+	pid_t pid;
+
+	if (upper->graphpid > 0) {
+		return OK;
+	}
+
+	sem_init(&upper->graphsem, 0, 0);
+	sem_setprotocol(&upper->graphsem, SEM_PRIO_NONE);
+
+	snprintf(arg, sizeof(arg), "%lx", (unsigned long)((uintptr_t)upper));
+	argv[0] = arg;
+	argv[1] = NULL;
+
+	pid = kernel_thread("audio_graph", CONFIG_AUDIO_GRAPH_PRIORITY, CONFIG_AUDIO_GRAPH_STACKSIZE, audio_graph_thread, argv);
+	if (pid < 0) {
+		auderr("ERROR: Failed to start the graph thread: %d\n", errno);
+		sem_destroy(&upper->graphsem);
+		return -errno;
+	}
+
+	upper->graphpid = pid;
+	return OK;
+}
+#endif							/* CONFIG_AUDIO_GRAPH */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,6 +64,7 @@
 #include <sys/types.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <fcntl.h>
 #include <string.h>
@@ -71,6 +72,7 @@
 #include <errno.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/audio/audio.h>
 #include <tinyara/audio/i2s.h>
@@ -88,6 +90,21 @@
 #define CONFIG_AUDIO_I2SCHAR_TXTIMEOUT 0
 #endif
 
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+#ifndef CONFIG_AUDIO_I2SCHAR_NPERIODS
+#define CONFIG_AUDIO_I2SCHAR_NPERIODS 4
+#endif
+
+#ifndef CONFIG_AUDIO_I2SCHAR_PERIOD_BYTES
+#define CONFIG_AUDIO_I2SCHAR_PERIOD_BYTES 1024
+#endif
+
+/* Footprint of one period, keeping the next one word aligned */
+
+#define I2SCHAR_PERIOD_SIZE \
+	((sizeof(struct ap_buffer_s) + CONFIG_AUDIO_I2SCHAR_PERIOD_BYTES + 3) & ~3)
+#endif
+
 #define i2serr printf
 #define i2sinfo printf
 
@@ -99,9 +116,28 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+/* The periods of one direction.  The lower half completes transfers in
+ * order, so the periods come back in the order they were queued.
+ */
+
+struct i2schar_ring_s {
+	FAR struct ap_buffer_s *apb[CONFIG_AUDIO_I2SCHAR_NPERIODS];
+	sem_t navail;			/* Periods ready for the application */
+	uint8_t head;			/* Next period for the application */
+	bool reserved;			/* The application holds apb[head] */
+	bool started;			/* RX: all periods have been queued */
+	volatile int result;		/* Last error from the lower half */
+};
+#endif
+
 struct i2schar_dev_s {
 	FAR struct i2s_dev_s *i2s;	/* The lower half i2s driver */
 	sem_t exclsem;			/* Assures mutually exclusive access */
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+	struct i2schar_ring_s tx;	/* Periods to send */
+	struct i2schar_ring_s rx;	/* Periods to receive into */
+#endif
 };
 
 /****************************************************************************
@@ -116,6 +152,9 @@ static void i2schar_txcallback(FAR struct i2s_dev_s *dev, FAR struct ap_buffer_s
 
 static ssize_t i2schar_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t i2schar_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+static int i2schar_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -127,7 +166,11 @@ static const struct file_operations i2schar_fops = {
 	i2schar_read,				/* read  */
 	i2schar_write,				/* write */
 	NULL,					/* seek  */
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+	i2schar_ioctl,				/* ioctl */
+#else
 	NULL,					/* ioctl */
+#endif
 #ifndef CONFIG_DISABLE_POLL
 	NULL,					/* poll  */
 #endif
@@ -349,6 +392,220 @@ errout_with_reference:
 	return ret;
 }
 
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+/****************************************************************************
+ * Name: i2schar_ringcallback
+ *
+ * Description:
+ *   I2S transfer complete callback for a period of the ring.  The period
+ *   becomes available to the application again.
+ *
+ ****************************************************************************/
+
+static void i2schar_ringcallback(FAR struct i2s_dev_s *dev, FAR struct ap_buffer_s *apb, FAR void *arg, int result)
+{
+	FAR struct i2schar_ring_s *ring = (FAR struct i2schar_ring_s *)arg;
+
+	DEBUGASSERT(ring && apb);
+
+	if (result < 0) {
+		ring->result = result;
+	}
+
+	sem_post(&ring->navail);
+}
+
+/****************************************************************************
+ * Name: i2schar_queue
+ *
+ * Description:
+ *   Give a period of the ring to the lower half.
+ *
+ ****************************************************************************/
+
+static int i2schar_queue(FAR struct i2schar_dev_s *priv, FAR struct i2schar_ring_s *ring, FAR struct ap_buffer_s *apb)
+{
+	int ret;
+
+	ret = sem_wait(&priv->exclsem);
+	if (ret < 0) {
+		return -get_errno();
+	}
+
+	apb->curbyte = 0;
+	if (ring == &priv->tx) {
+		ret = I2S_SEND(priv->i2s, apb, i2schar_ringcallback, ring, CONFIG_AUDIO_I2SCHAR_TXTIMEOUT);
+	} else {
+		apb->nbytes = 0;
+		ret = I2S_RECEIVE(priv->i2s, apb, i2schar_ringcallback, ring, CONFIG_AUDIO_I2SCHAR_RXTIMEOUT);
+	}
+
+	sem_post(&priv->exclsem);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: i2schar_reserve
+ *
+ * Description:
+ *   Hand the next available period of the ring to the application.
+ *
+ ****************************************************************************/
+
+static int i2schar_reserve(FAR struct i2schar_ring_s *ring, FAR struct i2schar_period_s *period, bool nonblock)
+{
+	FAR struct ap_buffer_s *apb;
+	int ret;
+
+	if (!period) {
+		return -EINVAL;
+	}
+
+	if (ring->reserved) {
+		return -EBUSY;
+	}
+
+	ret = nonblock ? sem_trywait(&ring->navail) : sem_wait(&ring->navail);
+	if (ret < 0) {
+		return -get_errno();
+	}
+
+	apb = ring->apb[ring->head];
+	ring->reserved = true;
+
+	period->buffer = apb->samp;
+	period->result = ring->result;
+	ring->result = 0;
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: i2schar_commit
+ *
+ * Description:
+ *   Queue the period the application holds and move on to the next one.
+ *
+ ****************************************************************************/
+
+static int i2schar_commit(FAR struct i2schar_dev_s *priv, FAR struct i2schar_ring_s *ring)
+{
+	int ret;
+
+	if (!ring->reserved) {
+		return -EINVAL;
+	}
+
+	ret = i2schar_queue(priv, ring, ring->apb[ring->head]);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ring->reserved = false;
+	if (++ring->head >= CONFIG_AUDIO_I2SCHAR_NPERIODS) {
+		ring->head = 0;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: i2schar_ioctl
+ *
+ * Description:
+ *   Standard character driver ioctl method
+ *
+ ****************************************************************************/
+
+static int i2schar_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct i2schar_dev_s *priv;
+	FAR struct i2schar_period_s *period = (FAR struct i2schar_period_s *)((uintptr_t)arg);
+	bool nonblock = (filep->f_oflags & O_NONBLOCK) != 0;
+	int ret;
+	int i;
+
+	DEBUGASSERT(inode);
+	priv = (FAR struct i2schar_dev_s *)inode->i_private;
+	DEBUGASSERT(priv);
+
+	switch (cmd) {
+	case I2SCHARIOC_TX_RESERVE:
+		ret = i2schar_reserve(&priv->tx, period, nonblock);
+		if (ret == OK) {
+			period->nbytes = priv->tx.apb[priv->tx.head]->nmaxbytes;
+		}
+		break;
+
+	case I2SCHARIOC_TX_COMMIT:
+		if (!priv->tx.reserved || arg > CONFIG_AUDIO_I2SCHAR_PERIOD_BYTES) {
+			ret = -EINVAL;
+			break;
+		}
+
+		priv->tx.apb[priv->tx.head]->nbytes = (apb_samp_t)arg;
+		ret = i2schar_commit(priv, &priv->tx);
+		break;
+
+	case I2SCHARIOC_RX_RESERVE:
+		if (!priv->rx.started) {
+			/* Start reception into every period */
+
+			for (i = 0; i < CONFIG_AUDIO_I2SCHAR_NPERIODS; i++) {
+				ret = i2schar_queue(priv, &priv->rx, priv->rx.apb[i]);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
+			priv->rx.started = true;
+		}
+
+		ret = i2schar_reserve(&priv->rx, period, nonblock);
+		if (ret == OK) {
+			period->nbytes = priv->rx.apb[priv->rx.head]->nbytes;
+		}
+		break;
+
+	case I2SCHARIOC_RX_COMMIT:
+		ret = i2schar_commit(priv, &priv->rx);
+		break;
+
+	default:
+		ret = -ENOTTY;
+		break;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: i2schar_ringinit
+ *
+ * Description:
+ *   Carve the periods of a ring out of one allocation.
+ *
+ ****************************************************************************/
+
+static void i2schar_ringinit(FAR struct i2schar_ring_s *ring, FAR uint8_t *mem, int navail)
+{
+	FAR struct ap_buffer_s *apb;
+	int i;
+
+	for (i = 0; i < CONFIG_AUDIO_I2SCHAR_NPERIODS; i++) {
+		apb = (FAR struct ap_buffer_s *)(mem + i * I2SCHAR_PERIOD_SIZE);
+		apb->nmaxbytes = CONFIG_AUDIO_I2SCHAR_PERIOD_BYTES;
+		apb->crefs = 1;
+		sem_init(&apb->sem, 0, 1);
+		ring->apb[i] = apb;
+	}
+
+	sem_init(&ring->navail, 0, navail);
+	sem_setprotocol(&ring->navail, SEM_PRIO_NONE);
+}
+#endif /* CONFIG_AUDIO_I2SCHAR_RING */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -388,13 +645,30 @@ int i2schar_register(FAR struct i2s_dev_s *i2s, int minor)
 
 	/* Allocate a I2S character device structure */
 
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+	/* The periods of both rings follow the device structure */
+
+	priv = (FAR struct i2schar_dev_s *)kmm_zalloc(((sizeof(struct i2schar_dev_s) + 3) & ~3) + 2 * CONFIG_AUDIO_I2SCHAR_NPERIODS * I2SCHAR_PERIOD_SIZE);
+#else
 	priv = (FAR struct i2schar_dev_s *)kmm_zalloc(sizeof(struct i2schar_dev_s));
+#endif
 	if (priv) {
 		/* Initialize the I2S character device structure */
 
 		priv->i2s = i2s;
 		sem_init(&priv->exclsem, 0, 1);
 
+#ifdef CONFIG_AUDIO_I2SCHAR_RING
+		{
+			FAR uint8_t *mem = (FAR uint8_t *)priv + ((sizeof(struct i2schar_dev_s) + 3) & ~3);
+
+			/* Every TX period starts free, RX periods only once received */
+
+			i2schar_ringinit(&priv->tx, mem, CONFIG_AUDIO_I2SCHAR_NPERIODS);
+			i2schar_ringinit(&priv->rx, mem + CONFIG_AUDIO_I2SCHAR_NPERIODS * I2SCHAR_PERIOD_SIZE, 0);
+		}
+#endif
+
 		/* Create the character device name */
 
 		snprintf(devname, DEVNAME_FMTLEN, DEVNAME_FMT, minor);
@@ -62,6 +62,7 @@
 #include <stdbool.h>
 #include <semaphore.h>
 #include <tinyara/fs/fs.h>
+#include <tinyara/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -69,9 +70,35 @@
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
 
+/* Geometry of the sector cache: sector 's' can only be held by one of the
+ * BCH_CACHE_NWAYS lines of set 's % BCH_CACHE_NSETS'.  Without
+ * CONFIG_BCH_CACHE, this is a single sector buffer written through.
+ */
+#ifdef CONFIG_BCH_CACHE
+#define BCH_CACHE_NSETS		CONFIG_BCH_CACHE_NSETS
+#define BCH_CACHE_NWAYS		CONFIG_BCH_CACHE_NWAYS
+#else
+#define BCH_CACHE_NSETS		1
+#define BCH_CACHE_NWAYS		1
+#endif
+#define BCH_CACHE_NLINES	(BCH_CACHE_NSETS * BCH_CACHE_NWAYS)
+
+/* Dirty sectors are written back after no write for this delay */
+#if defined(CONFIG_BCH_CACHE) && defined(CONFIG_SCHED_LPWORK) && \
+	defined(CONFIG_BCH_CACHE_FLUSH_DELAY) && CONFIG_BCH_CACHE_FLUSH_DELAY > 0
+#define BCH_CACHE_DELAYED_FLUSH 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+struct bch_line_s {
+	size_t sector;				/* The sector in the line, (size_t)-1 if none */
+	uint32_t stamp;				/* Time of the last access, for LRU replacement */
+	bool dirty;					/* true: Data has been written to the line */
+	FAR uint8_t *buffer;		/* One sector buffer */
+};
+
 struct bchlib_s {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
@@ -79,10 +106,16 @@ struct bchlib_s {
 	size_t sector;				/* The current sector in the buffer */
 	sem_t sem;					/* For atomic accesses to this structure */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	FAR uint8_t *buffer;		/* Buffer of the current sector */
+	FAR struct bch_line_s *current;	/* Line of the current sector */
+	FAR uint8_t *cache;			/* Storage of all the lines */
+	uint32_t stamp;				/* Access counter */
+	struct bch_line_s lines[BCH_CACHE_NLINES];
+#ifdef BCH_CACHE_DELAYED_FLUSH
+	struct work_s work;			/* Delayed write back of the dirty lines */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -108,6 +141,11 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors);
+EXTERN void bchlib_initcache(FAR struct bchlib_s *bch);
+EXTERN void bchlib_cancelflush(FAR struct bchlib_s *bch);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -61,6 +61,9 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -88,16 +91,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR struct bch_line_s *line, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)line->buffer;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			line->sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -115,39 +118,29 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_writeline
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write the content of a cache line to the media if it is dirty
  *
  ****************************************************************************/
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bch_writeline(FAR struct bchlib_s *bch, FAR struct bch_line_s *line)
 {
 	FAR struct inode *inode;
 	ssize_t ret = OK;
 
-	/*
-	 * Check if the sector has been modified and is out of synch with the
-	 * media.
-	 */
-	if (bch->dirty) {
+	if (line->dirty) {
 		inode = bch->inode;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
+		bch_cypher(bch, line, CYPHER_ENCRYPT);
 #endif
 
 		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+		ret = inode->u.i_bops->write(inode, line->buffer, line->sector, 1);
 		if (ret < 0) {
-			fdbg("Write failed: %d\n");
+			fdbg("Write failed: %d\n", ret);
 		}
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -155,21 +148,129 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 		 * Computation overhead to save memory for extra sector buffer
 		 * TODO: Add configuration switch for extra sector buffer
 		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, line, CYPHER_DECRYPT);
 #endif
 
 		/* The sector is now in sync with the media */
-		bch->dirty = false;
+		line->dirty = false;
+	}
+
+	return ret < 0 ? (int)ret : OK;
+}
+
+/****************************************************************************
+ * Name: bch_flushtimeout
+ *
+ * Description:
+ *   Write back the dirty sectors once no write occurred for
+ *   CONFIG_BCH_CACHE_FLUSH_DELAY milliseconds.  Runs on the LP work queue.
+ *
+ ****************************************************************************/
+#ifdef BCH_CACHE_DELAYED_FLUSH
+static void bch_flushtimeout(FAR void *arg)
+{
+	FAR struct bchlib_s *bch = (FAR struct bchlib_s *)arg;
+
+	bchlib_semtake(bch);
+	(void)bchlib_flushsector(bch);
+	bchlib_semgive(bch);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_initcache
+ *
+ * Description:
+ *   Set up the cache lines over bch->cache, which holds BCH_CACHE_NLINES
+ *   sectors
+ *
+ ****************************************************************************/
+void bchlib_initcache(FAR struct bchlib_s *bch)
+{
+	int i;
+
+	for (i = 0; i < BCH_CACHE_NLINES; i++) {
+		bch->lines[i].sector = (size_t)-1;
+		bch->lines[i].stamp  = 0;
+		bch->lines[i].dirty  = false;
+		bch->lines[i].buffer = &bch->cache[i * bch->sectsize];
+	}
+
+	bch->sector  = (size_t)-1;
+	bch->buffer  = NULL;
+	bch->current = NULL;
+	bch->stamp   = 0;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Write back the dirty cached sectors in [sector, sector + nsectors), in
+ *   ascending order so that the block driver may merge them
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bch_line_s *next;
+	FAR struct bch_line_s *line;
+	int result = OK;
+	int ret;
+	int i;
+
+	for (;;) {
+		next = NULL;
+		for (i = 0; i < BCH_CACHE_NLINES; i++) {
+			line = &bch->lines[i];
+			if (line->dirty && line->sector >= sector && line->sector - sector < nsectors &&
+				(next == NULL || line->sector < next->sector)) {
+				next = line;
+			}
+		}
+
+		if (next == NULL) {
+			break;
+		}
+
+		/* The line is clean afterwards, even if the write failed */
+		ret = bch_writeline(bch, next);
+		if (ret < 0 && result == OK) {
+			result = ret;
+		}
 	}
 
-	return (int)ret;
+	return result;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush the current contents of the sector cache (if dirty)
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+	return bchlib_flushrange(bch, 0, bch->nsectors);
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make 'sector' the current sector in bch->buffer, reading it into the
+ *   cache if it is not there.  The least recently used line of its set is
+ *   replaced, after being written back if dirty.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -178,23 +279,124 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
 	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct bch_line_s *set;
+	FAR struct bch_line_s *line;
+	ssize_t ret;
+	int i;
 
-	if (bch->sector != sector) {
-		inode = bch->inode;
+	if (bch->current != NULL && bch->sector == sector) {
+		return OK;
+	}
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+	set  = &bch->lines[(sector % BCH_CACHE_NSETS) * BCH_CACHE_NWAYS];
+	line = &set[0];
+	for (i = 0; i < BCH_CACHE_NWAYS; i++) {
+		if (set[i].sector == sector) {
+			line = &set[i];
+			goto found;
+		}
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-		if (ret < 0) {
-			fdbg("Read failed: %d\n");
+		/* Prefer an unused line, otherwise the least recently used one */
+		if (line->sector != (size_t)-1 &&
+			(set[i].sector == (size_t)-1 || set[i].stamp < line->stamp)) {
+			line = &set[i];
 		}
-		bch->sector = sector;
+	}
+
+	if (line == bch->current) {
+		bch->current = NULL;
+		bch->sector  = (size_t)-1;
+	}
+
+	ret = bch_writeline(bch, line);
+	if (ret < 0) {
+		fdbg("Flush failed: %d\n", ret);
+	}
+	line->sector = (size_t)-1;
+
+	inode = bch->inode;
+	ret = inode->u.i_bops->read(inode, line->buffer, sector, 1);
+	if (ret < 0) {
+		fdbg("Read failed: %d\n", ret);
+		return (int)ret;
+	}
+
+	line->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+	bch_cypher(bch, line, CYPHER_DECRYPT);
+#endif
+
+found:
+	line->stamp  = ++bch->stamp;
+	bch->current = line;
+	bch->buffer  = line->buffer;
+	bch->sector  = sector;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the current sector as modified.  With a delayed flush, the write
+ *   back is (re-)scheduled so that bursts of writes reach the media once.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+	DEBUGASSERT(bch->current != NULL);
+	bch->current->dirty = true;
+
+#ifdef BCH_CACHE_DELAYED_FLUSH
+	(void)work_cancel(LPWORK, &bch->work);
+	(void)work_queue(LPWORK, &bch->work, bch_flushtimeout, (FAR void *)bch,
+					 MSEC2TICK(CONFIG_BCH_CACHE_FLUSH_DELAY));
 #endif
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Drop the cached sectors in [sector, sector + nsectors), which are about
+ *   to be written directly to the media
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bch_line_s *line;
+	int i;
+
+	for (i = 0; i < BCH_CACHE_NLINES; i++) {
+		line = &bch->lines[i];
+		if (line->sector != (size_t)-1 && line->sector >= sector && line->sector - sector < nsectors) {
+			line->sector = (size_t)-1;
+			line->dirty  = false;
+
+			if (line == bch->current) {
+				bch->current = NULL;
+				bch->sector  = (size_t)-1;
+			}
+		}
 	}
-	return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_cancelflush
+ *
+ * Description:
+ *   Cancel the delayed write back, if any
+ *
+ ****************************************************************************/
+void bchlib_cancelflush(FAR struct bchlib_s *bch)
+{
+#ifdef BCH_CACHE_DELAYED_FLUSH
+	(void)work_cancel(LPWORK, &bch->work);
+#endif
+}
@@ -128,17 +128,18 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	sem_init(&bch->sem, 0, 1);
 	bch->nsectors = geo.geo_nsectors;
 	bch->sectsize = geo.geo_sectorsize;
-	bch->sector   = (size_t)-1;
 	bch->readonly = readonly;
 
-	/* Allocate the sector I/O buffer */
-	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
-	if (!bch->buffer) {
+	/* Allocate the sector cache */
+	bch->cache = (FAR uint8_t *)kmm_malloc(bch->sectsize * BCH_CACHE_NLINES);
+	if (!bch->cache) {
 		fdbg("ERROR: Failed to allocate sector buffer\n");
 		ret = -ENOMEM;
 		goto errout_with_bch;
 	}
 
+	bchlib_initcache(bch);
+
 	*handle = bch;
 	return OK;
 
@@ -88,14 +88,15 @@ int bchlib_teardown(FAR void *handle)
 	}
 
 	/* Flush any pending data to the block driver */
+	bchlib_cancelflush(bch);
 	bchlib_flushsector(bch);
 
 	/* Close the block driver */
 	(void)close_blockdriver(bch->inode);
 
 	/* Free the BCH state structure */
-	if (bch->buffer) {
-		kmm_free(bch->buffer);
+	if (bch->cache) {
+		kmm_free(bch->cache);
 	}
 
 	sem_destroy(&bch->sem);
@@ -107,7 +107,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	byteswritten = 0;
 	if (sectoffset > 0) {
 		/* Read the full sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the tail end of the sector from the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -117,7 +120,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 		}
 
 		memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-		bch->dirty = true;
+		bchlib_dirtysector(bch);
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -141,7 +144,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nsectors = bch->nsectors - sector;
 		}
 
-		/* Write the contiguous sectors */
+		/* Write the contiguous sectors, replacing any cached copy */
+		bchlib_invalidate(bch, sector, nsectors);
 		ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
 				sector, nsectors);
 		if (ret < 0) {
@@ -165,22 +169,27 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	/* Then write any partial final sector */
 	if (len > 0) {
 		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the head end of the sector from the user buffer */
 		memcpy(bch->buffer, buffer, len);
-		bch->dirty = true;
+		bchlib_dirtysector(bch);
 
 		/* Adjust counts */
 		byteswritten += len;
 	}
 
+#ifndef CONFIG_BCH_CACHE
 	/* Finally, flush any cached writes to the device as well */
 	ret = bchlib_flushsector(bch);
 	if (ret < 0) {
 		fdbg("ERROR: Flush failed: %d\n", ret);
 		return ret;
 	}
+#endif
 
 	return byteswritten;
 }
@@ -66,6 +66,9 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#ifdef CONFIG_CAN_TIMESTAMP
+#include <time.h>
+#endif
 
 #include <tinyara/arch.h>
 #include <tinyara/semaphore.h>
@@ -99,6 +102,16 @@
 #define HALF_SECOND_MSEC 500
 #define HALF_SECOND_USEC 500000L
 
+/* Receive Ring *************************************************************/
+
+#define CAN_RXMASK       (CONFIG_CAN_RXFIFOSIZE - 1)
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define CAN_RXCLOCK      CLOCK_MONOTONIC
+#else
+#define CAN_RXCLOCK      CLOCK_REALTIME
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -113,6 +126,10 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 static int can_xmit(FAR struct can_dev_s *dev);
 static ssize_t can_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
 static inline ssize_t can_rtrread(FAR struct can_dev_s *dev, FAR struct canioctl_rtr_s *rtr);
+static int can_addfilter(FAR struct can_dev_s *dev, FAR const struct canioctl_filter_s *filter);
+static void can_rtrmatch(FAR struct can_dev_s *dev, FAR const struct can_hdr_s *hdr, FAR const uint8_t *data);
+static FAR struct can_msg_s *can_rxslot(FAR struct can_rxfifo_s *fifo, int offset);
+static void can_rxpublish(FAR struct can_dev_s *dev, int count);
 static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -183,6 +200,7 @@ static int can_open(FAR struct file *filep)
 					dev->cd_xmit.tx_tail = 0;
 					dev->cd_recv.rx_head = 0;
 					dev->cd_recv.rx_tail = 0;
+					dev->cd_recv.rx_dropped = 0;
 
 					/* Finally, Enable the CAN RX interrupt */
 
@@ -283,7 +301,9 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct can_dev_s *dev = inode->i_private;
+	FAR struct can_rxfifo_s *fifo = &dev->cd_recv;
 	size_t nread;
+	uint16_t head;
 	irqstate_t flags;
 	int ret = 0;
 
@@ -295,61 +315,75 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 	 */
 
 	if (buflen >= CAN_MSGLEN(0)) {
-		/* Interrupts must be disabled while accessing the cd_recv FIFO */
+		/* Only one thread may consume from the receive ring at a time */
+
+		if (sem_wait(&dev->cd_recvsem) != OK) {
+			return -get_errno();
+		}
+
+		/* Interrupts need only be disabled while deciding to sleep, so that a
+		 * message arriving in between cannot be missed.
+		 */
 
 		flags = irqsave();
-		while (dev->cd_recv.rx_head == dev->cd_recv.rx_tail) {
-			/* The receive FIFO is empty -- was non-blocking mode selected? */
+		while (fifo->rx_head == fifo->rx_tail) {
+			/* The receive ring is empty -- was non-blocking mode selected? */
 
 			if (filep->f_oflags & O_NONBLOCK) {
 				ret = -EAGAIN;
-				goto return_with_irqdisabled;
+				break;
 			}
 
-			/* Wait for a message to be received */
+			/* Wait for a message to be received.  can_receive() clears
+			 * cd_nrxwaiters when it posts.
+			 */
 
-			ret = sem_wait(&dev->cd_recv.rx_sem);
+			dev->cd_nrxwaiters++;
+			ret = sem_wait(&fifo->rx_sem);
 			if (ret < 0) {
 				ret = -get_errno();
-				goto return_with_irqdisabled;
+				if (dev->cd_nrxwaiters > 0) {
+					dev->cd_nrxwaiters--;
+				}
+				break;
 			}
 		}
+		irqrestore(flags);
 
-		/* The cd_recv FIFO is not empty.  Copy all buffered data that will fit
-		 * in the user buffer.
-		 */
-
-		nread = 0;
-		do {
-			/* Will the next message in the FIFO fit into the user buffer? */
-
-			FAR struct can_msg_s *msg = &dev->cd_recv.rx_buffer[dev->cd_recv.rx_head];
-			int msglen = CAN_MSGLEN(msg->cm_hdr.ch_dlc);
+		if (ret == OK) {
+			/* The ring is not empty.  Copy all buffered messages that will fit
+			 * in the user buffer.  can_receive() only ever appends behind
+			 * rx_tail, so this needs no protection from the interrupt handler.
+			 */
 
-			if (nread + msglen > buflen) {
-				break;
-			}
+			nread = 0;
+			head = fifo->rx_head;
+			do {
+				/* Will the next message in the ring fit into the user buffer? */
 
-			/* Copy the message to the user buffer */
+				FAR struct can_msg_s *msg = &fifo->rx_buffer[head & CAN_RXMASK];
+				int msglen = CAN_MSGLEN(msg->cm_hdr.ch_dlc);
 
-			memcpy(&buffer[nread], msg, msglen);
-			nread += msglen;
+				if (nread + msglen > buflen) {
+					break;
+				}
 
-			/* Increment the head of the circular message buffer */
+				/* Copy the message to the user buffer */
 
-			if (++dev->cd_recv.rx_head >= CONFIG_CAN_FIFOSIZE) {
-				dev->cd_recv.rx_head = 0;
-			}
-		} while (dev->cd_recv.rx_head != dev->cd_recv.rx_tail);
+				memcpy(&buffer[nread], msg, msglen);
+				nread += msglen;
+				head++;
+			} while (head != fifo->rx_tail);
 
-		/* All on the messages have bee transferred.  Return the number of bytes
-		 * that were read.
-		 */
+			/* Hand the slots back to can_receive() only after they have been
+			 * copied out, then return the number of bytes that were read.
+			 */
 
-		ret = nread;
+			fifo->rx_head = head;
+			ret = nread;
+		}
 
-return_with_irqdisabled:
-		irqrestore(flags);
+		sem_post(&dev->cd_recvsem);
 	}
 
 	return ret;
@@ -594,6 +628,43 @@ static inline ssize_t can_rtrread(FAR struct can_dev_s *dev, FAR struct canioctl
 	return ret;
 }
 
+/****************************************************************************
+ * Name: can_addfilter
+ *
+ * Description:
+ *   Validate an acceptance filter and install it in the hardware.
+ *
+ ****************************************************************************/
+
+static int can_addfilter(FAR struct can_dev_s *dev, FAR const struct canioctl_filter_s *filter)
+{
+	uint32_t maxid;
+
+	if (filter == NULL) {
+		return -EINVAL;
+	}
+
+	if (dev->cd_ops->co_addfilter == NULL) {
+		return -ENOTTY;
+	}
+
+#ifdef CONFIG_CAN_EXTID
+	maxid = filter->cf_extid ? CAN_MAX_EXTMSGID : CAN_MAX_MSGID;
+#else
+	if (filter->cf_extid) {
+		return -EINVAL;
+	}
+
+	maxid = CAN_MAX_MSGID;
+#endif
+
+	if ((filter->cf_id | filter->cf_mask) > maxid) {
+		return -EINVAL;
+	}
+
+	return dev_addfilter(dev, filter);
+}
+
 /****************************************************************************
  * Name: can_ioctl
  ****************************************************************************/
@@ -620,6 +691,24 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		ret = can_rtrread(dev, (struct canioctl_rtr_s *)((uintptr_t)arg));
 		break;
 
+	/* CANIOCTL_ADDFILTER: Install a hardware acceptance filter.  Argument is
+	 * a reference to struct canioctl_filter_s.
+	 */
+
+	case CANIOCTL_ADDFILTER:
+		ret = can_addfilter(dev, (FAR const struct canioctl_filter_s *)((uintptr_t)arg));
+		break;
+
+	/* CANIOCTL_DELFILTER: Remove the filter at the index given as argument */
+
+	case CANIOCTL_DELFILTER:
+		if (dev->cd_ops->co_delfilter == NULL) {
+			ret = -ENOTTY;
+		} else {
+			ret = dev_delfilter(dev, (int)arg);
+		}
+		break;
+
 	/* Not a "built-in" ioctl command.. perhaps it is unique to this
 	 * device driver.
 	 */
@@ -632,6 +721,94 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: can_rtrmatch
+ *
+ * Description:
+ *   Complete any pending RTR request waiting for a message with this ID.
+ *
+ * Assumptions:
+ *   CAN interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void can_rtrmatch(FAR struct can_dev_s *dev, FAR const struct can_hdr_s *hdr, FAR const uint8_t *data)
+{
+	int i;
+
+	if (dev->cd_npendrtr > 0) {
+		/* There are pending RTR requests -- search the lists of requests
+		 * and see any any matches this new message.
+		 */
+
+		for (i = 0; i < CONFIG_CAN_NPENDINGRTR; i++) {
+			FAR struct can_rtrwait_s *rtr = &dev->cd_rtr[i];
+			FAR struct can_msg_s *msg = rtr->cr_msg;
+
+			/* Check if the entry is valid and if the ID matches.  A valid
+			 * entry has a non-NULL receiving address
+			 */
+
+			if (msg && hdr->ch_id == rtr->cr_id) {
+				/* We have the response... copy the data to the user's buffer */
+
+				memcpy(&msg->cm_hdr, hdr, sizeof(struct can_hdr_s));
+				memcpy(msg->cm_data, data, hdr->ch_dlc);
+
+				/* Mark the entry unused */
+
+				rtr->cr_msg = NULL;
+
+				/* And restart the waiting thread */
+
+				sem_post(&rtr->cr_sem);
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: can_rxslot
+ *
+ * Description:
+ *   Return the free slot 'offset' messages behind the tail of the receive
+ *   ring, or NULL if the ring would overflow.
+ *
+ ****************************************************************************/
+
+static FAR struct can_msg_s *can_rxslot(FAR struct can_rxfifo_s *fifo, int offset)
+{
+	uint16_t tail = fifo->rx_tail + offset;
+
+	if ((uint16_t)(tail - fifo->rx_head) >= CONFIG_CAN_RXFIFOSIZE) {
+		return NULL;
+	}
+
+	return &fifo->rx_buffer[tail & CAN_RXMASK];
+}
+
+/****************************************************************************
+ * Name: can_rxpublish
+ *
+ * Description:
+ *   Make the next 'count' filled slots visible to the reader and wake it up
+ *   if it is waiting.  A waiting reader is posted once per batch rather than
+ *   once per message.
+ *
+ ****************************************************************************/
+
+static void can_rxpublish(FAR struct can_dev_s *dev, int count)
+{
+	if (count > 0) {
+		dev->cd_recv.rx_tail += count;
+
+		if (dev->cd_nrxwaiters > 0) {
+			dev->cd_nrxwaiters = 0;
+			sem_post(&dev->cd_recv.rx_sem);
+		}
+	}
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -651,11 +828,13 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
 	/* Initialize the CAN device structure */
 
 	dev->cd_ocount = 0;
+	dev->cd_nrxwaiters = 0;
 
 	/* Initialize semaphores */
 	sem_init(&dev->cd_xmit.tx_sem, 0, 0);
 	sem_init(&dev->cd_recv.rx_sem, 0, 0);
 	sem_init(&dev->cd_closesem, 0, 1);
+	sem_init(&dev->cd_recvsem, 0, 1);
 
 	for (i = 0; i < CONFIG_CAN_NPENDINGRTR; i++) {
 		/*
@@ -663,7 +842,7 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
 		 * signaling and should not have priority inheritance enabled.
 		 */
 		sem_init(&dev->cd_rtr[i].cr_sem, 0, 0);
-		sem_setprotocol(&dev->cd_rtr[i].cr_sem. SEM_PRIO_NONE);
+		sem_setprotocol(&dev->cd_rtr[i].cr_sem, SEM_PRIO_NONE);
 		dev->cd_rtr[i].cr_msg = NULL;
 		dev->cd_npendrtr--;
 	}
@@ -696,83 +875,95 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
 
 int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr, FAR uint8_t *data)
 {
-	FAR struct can_rxfifo_s *fifo = &dev->cd_recv;
-	FAR uint8_t *dest;
-	int nexttail;
-	int err = -ENOMEM;
-	int i;
+	FAR struct can_msg_s *msg;
+#ifdef CONFIG_CAN_TIMESTAMP
+	struct timespec ts;
+#endif
 
 	canllvdbg("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
-	/* Check if adding this new message would over-run the drivers ability to
-	 * enqueue read data.
-	 */
-
-	nexttail = fifo->rx_tail + 1;
-	if (nexttail >= CONFIG_CAN_FIFOSIZE) {
-		nexttail = 0;
-	}
-
 	/* First, check if this response matches any RTR response that we may be
 	 * waiting for.
 	 */
 
-	if (dev->cd_npendrtr > 0) {
-		/* There are pending RTR requests -- search the lists of requests
-		 * and see any any matches this new message.
-		 */
+	can_rtrmatch(dev, hdr, data);
 
-		for (i = 0; i < CONFIG_CAN_NPENDINGRTR; i++) {
-			FAR struct can_rtrwait_s *rtr = &dev->cd_rtr[i];
-			FAR struct can_msg_s *msg = rtr->cr_msg;
+	/* Refuse the new data if the ring is full */
 
-			/* Check if the entry is valid and if the ID matches.  A valid
-			 * entry has a non-NULL receiving address
-			 */
+	msg = can_rxslot(&dev->cd_recv, 0);
+	if (msg == NULL) {
+		dev->cd_recv.rx_dropped++;
+		return -ENOMEM;
+	}
 
-			if (msg && hdr->ch_id == rtr->cr_id) {
-				/* We have the response... copy the data to the user's buffer */
+	/* Add the new, decoded CAN message at the tail of the ring */
 
-				memcpy(&msg->cm_hdr, hdr, sizeof(struct can_hdr_s));
-				for (i = 0, dest = msg->cm_data; i < hdr->ch_dlc; i++) {
-					*dest++ = *data++;
-				}
+	memcpy(&msg->cm_hdr, hdr, sizeof(struct can_hdr_s));
+	memcpy(msg->cm_data, data, hdr->ch_dlc);
+#ifdef CONFIG_CAN_TIMESTAMP
+	clock_gettime(CAN_RXCLOCK, &ts);
+	msg->cm_hdr.ch_ts = ts;
+#endif
 
-				/* Mark the entry unused */
+	can_rxpublish(dev, 1);
+	return OK;
+}
 
-				rtr->cr_msg = NULL;
+/****************************************************************************
+ * Name: can_receivev
+ *
+ * Description:
+ *   Called from the CAN interrupt handler with all messages drained from a
+ *   hardware receive FIFO.
+ *
+ * Parameters:
+ *   dev   - CAN driver state structure
+ *   msgs  - The received messages
+ *   nmsgs - The number of messages in msgs
+ *
+ * Returned Value:
+ *   The number of messages accepted into the receive ring.
+ *
+ * Assumptions:
+ *   CAN interrupts are disabled.
+ *
+ ****************************************************************************/
 
-				/* And restart the waiting thread */
+int can_receivev(FAR struct can_dev_s *dev, FAR const struct can_msg_s *msgs, int nmsgs)
+{
+	FAR struct can_msg_s *msg;
+#ifdef CONFIG_CAN_TIMESTAMP
+	struct timespec ts;
+#endif
+	int naccepted = 0;
+	int i;
 
-				sem_post(&rtr->cr_sem);
-			}
-		}
-	}
+	canllvdbg("nmsgs: %d\n", nmsgs);
 
-	/* Refuse the new data if the FIFO is full */
+#ifdef CONFIG_CAN_TIMESTAMP
+	clock_gettime(CAN_RXCLOCK, &ts);
+#endif
 
-	if (nexttail != fifo->rx_head) {
-		/* Add the new, decoded CAN message at the tail of the FIFO */
+	for (i = 0; i < nmsgs; i++) {
+		can_rtrmatch(dev, &msgs[i].cm_hdr, msgs[i].cm_data);
 
-		memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr, sizeof(struct can_hdr_s));
-		for (i = 0, dest = fifo->rx_buffer[fifo->rx_tail].cm_data; i < hdr->ch_dlc; i++) {
-			*dest++ = *data++;
+		msg = can_rxslot(&dev->cd_recv, naccepted);
+		if (msg == NULL) {
+			dev->cd_recv.rx_dropped++;
+			continue;
 		}
 
-		/* Increment the tail of the circular buffer */
-
-		fifo->rx_tail = nexttail;
-
-		/* The increment the counting semaphore. The maximum value should be
-		 * CONFIG_CAN_FIFOSIZE -- one possible count for each allocated
-		 * message buffer.
-		 */
-
-		sem_post(&fifo->rx_sem);
-		err = OK;
+		memcpy(msg, &msgs[i], CAN_MSGLEN(msgs[i].cm_hdr.ch_dlc));
+#ifdef CONFIG_CAN_TIMESTAMP
+		msg->cm_hdr.ch_ts = ts;
+#endif
+		naccepted++;
 	}
 
-	return err;
+	/* Make the whole batch visible to the reader at once */
+
+	can_rxpublish(dev, naccepted);
+	return naccepted;
 }
 
 /****************************************************************************
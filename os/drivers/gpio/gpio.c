@@ -413,6 +413,23 @@ static int gpio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	}
 #endif /* CONFIG_DISABLE_SIGNALS */
 
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	case GPIOIOC_READ_EVENTS: {
+		FAR struct gpio_events_s *events =
+			(FAR struct gpio_events_s *)((uintptr_t)arg);
+
+		if (!events || (!events->ge_events && events->ge_nevents)) {
+			ret = -EINVAL;
+		} else if (!lower->ops->read_events) {
+			ret = -ENOSYS;
+		} else {
+			ret = lower->ops->read_events(lower, events->ge_events,
+							events->ge_nevents, &events->ge_dropped);
+		}
+		break;
+	}
+#endif /* CONFIG_GPIO_EVENT_BUFFER */
+
 	default:
 		ret = -ENOTTY;
 		if (lower->ops->ioctl) {
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/i2c/i2c_batch.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stddef.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <tinyara/i2c.h>
+
+#if defined(CONFIG_I2C_BATCH)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_batch
+ *
+ * Description:
+ *   Perform a list of transfers with I2C_BATCH(), or with one I2C_TRANSFER()
+ *   each if the driver does not provide batch().
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   xfers - The transfers; the result of each one is stored in it
+ *   count - The number of transfers
+ *
+ * Returned Value:
+ *   OK once every transfer has been attempted; a negated errno otherwise
+ *
+ ****************************************************************************/
+
+int i2c_batch(FAR struct i2c_dev_s *dev, FAR struct i2c_xfer_s *xfers, int count)
+{
+	int ret;
+	int i;
+
+	DEBUGASSERT(dev != NULL);
+
+	if (count < 0 || (count > 0 && xfers == NULL)) {
+		return -EINVAL;
+	}
+
+	if (dev->ops->batch != NULL) {
+		ret = I2C_BATCH(dev, xfers, count);
+		if (ret != -ENOSYS) {
+			return ret;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		xfers[i].result = I2C_TRANSFER(dev, xfers[i].msgs, xfers[i].nmsgs);
+	}
+
+	return OK;
+}
+
+#endif							/* CONFIG_I2C_BATCH */
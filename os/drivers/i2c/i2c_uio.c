@@ -228,6 +228,9 @@ static int i2c_uioctrl(FAR struct file *filep, int cmd, unsigned long arg)
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct i2c_dev_s *dev = inode->i_private;
 	FAR struct i2c_rdwr_ioctl_data_s *rdwr;
+#ifdef CONFIG_I2C_BATCH
+	FAR struct i2c_batch_ioctl_data_s *batch;
+#endif
 
 	switch (cmd) {
 	case I2C_SLAVE:
@@ -247,6 +250,12 @@ static int i2c_uioctrl(FAR struct file *filep, int cmd, unsigned long arg)
 		rdwr = (struct i2c_rdwr_ioctl_data_s *)(arg);
 		ret = I2C_TRANSFER(dev, rdwr->msgs, rdwr->nmsgs);
 		break;
+#ifdef CONFIG_I2C_BATCH
+	case I2C_RDWR_BATCH:
+		batch = (struct i2c_batch_ioctl_data_s *)(arg);
+		ret = i2c_batch(dev, batch->xfers, batch->nxfers);
+		break;
+#endif
 
 	case I2C_FREQUENCY:
 		freq = *((uint32_t *)arg);
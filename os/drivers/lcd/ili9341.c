@@ -353,6 +353,7 @@
 #define ILI9341_IFACE0_PXFMT      FB_FMT_RGB16_565
 #define ILI9341_IFACE0_BPP        16
 #define ILI9341_IFACE0_BUFFER     ILI9341_IFACE0_STRIDE
+#define ILI9341_IFACE0_ROWS       ((ILI9341_XRES * ILI9341_YRES) / ILI9341_IFACE0_STRIDE)
 #else
 #error "undefined pixel format for lcd interface 0"
 #endif
@@ -378,6 +379,7 @@
 #define ILI9341_IFACE1_PXFMT      FB_FMT_RGB16_565
 #define ILI9341_IFACE1_BPP        16
 #define ILI9341_IFACE1_BUFFER     ILI9341_IFACE1_STRIDE
+#define ILI9341_IFACE1_ROWS       ((ILI9341_XRES * ILI9341_YRES) / ILI9341_IFACE1_STRIDE)
 #else
 #error "undefined pixel format for lcd interface 1"
 #endif
@@ -385,6 +387,25 @@
 
 /* Add next LCD display */
 
+/* Framebuffer lines of each display, at most its number of rows */
+
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+#if CONFIG_LCD_ILI9341_FB_LINES < ILI9341_IFACE0_ROWS
+#define ILI9341_IFACE0_FBLINES    CONFIG_LCD_ILI9341_FB_LINES
+#else
+#define ILI9341_IFACE0_FBLINES    ILI9341_IFACE0_ROWS
+#endif
+#endif
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+#if CONFIG_LCD_ILI9341_FB_LINES < ILI9341_IFACE1_ROWS
+#define ILI9341_IFACE1_FBLINES    CONFIG_LCD_ILI9341_FB_LINES
+#else
+#define ILI9341_IFACE1_FBLINES    ILI9341_IFACE1_ROWS
+#endif
+#endif
+#endif
+
 /* Debug option */
 
 #ifdef CONFIG_DEBUG_LCD
@@ -442,6 +463,21 @@ struct ili9341_dev_s {
 	/* Current power state of the device */
 
 	uint8_t power;
+
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+	/* Rows fbrow .. fbrow + fblines - 1 of the display */
+
+	uint16_t *fb;
+	uint16_t fblines;
+	uint16_t fbrow;
+
+	/* Dirty rectangle, inclusive.  Clean when dx0 > dx1 */
+
+	uint16_t dx0;
+	uint16_t dy0;
+	uint16_t dx1;
+	uint16_t dy1;
+#endif
 };
 
 /******************************************************************************
@@ -505,6 +541,15 @@ static uint16_t g_runbuffer0[ILI9341_IFACE0_BUFFER];
 static uint16_t g_runbuffer1[ILI9341_IFACE1_BUFFER];
 #endif
 
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+static uint16_t g_fb0[ILI9341_IFACE0_STRIDE * ILI9341_IFACE0_FBLINES];
+#endif
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+static uint16_t g_fb1[ILI9341_IFACE1_STRIDE * ILI9341_IFACE1_FBLINES];
+#endif
+#endif
+
 static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] = {
 #ifdef CONFIG_LCD_ILI9341_IFACE0
 	{
@@ -518,6 +563,11 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] = {
 		.pxfmt = ILI9341_IFACE0_PXFMT,
 		.bpp = ILI9341_IFACE0_BPP,
 		.power = 0,
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+		.fb = g_fb0,
+		.fblines = ILI9341_IFACE0_FBLINES,
+		.dx0 = UINT16_MAX,
+#endif
 	},
 #endif
 #ifdef CONFIG_LCD_ILI9341_IFACE1
@@ -532,6 +582,11 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] = {
 		.pxfmt = ILI9341_IFACE1_PXFMT,
 		.bpp = ILI9341_IFACE1_BPP,
 		.power = 0,
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+		.fb = g_fb1,
+		.fblines = ILI9341_IFACE1_FBLINES,
+		.dx0 = UINT16_MAX,
+#endif
 	},
 #endif
 };
@@ -624,6 +679,52 @@ static void ili9341_selectarea(FAR struct ili9341_lcd_s *lcd, uint16_t x0, uint1
 	lcd->sendparam(lcd, (y1 & 0xff));
 }
 
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+/*******************************************************************************
+ * Name:  ili9341_fbflush
+ *
+ * Description:
+ *   Send the dirty rectangle of the framebuffer to the display.  The whole
+ *   rectangle is one drawing area and one memory write; when it spans the
+ *   full width its rows are contiguous and go out in a single burst.
+ *
+ * Parameter:
+ *   dev   - Reference to private driver structure
+ *
+ ******************************************************************************/
+
+static void ili9341_fbflush(FAR struct ili9341_dev_s *dev)
+{
+	FAR struct ili9341_lcd_s *lcd = dev->lcd;
+	uint16_t xres = ili9341_getxres(dev);
+	uint16_t width;
+	uint16_t row;
+
+	if (dev->dx0 > dev->dx1) {
+		return;
+	}
+
+	width = dev->dx1 - dev->dx0 + 1;
+
+	lcd->select(lcd);
+	ili9341_selectarea(lcd, dev->dx0, dev->dy0, dev->dx1, dev->dy1);
+	lcd->sendcmd(lcd, ILI9341_MEMORY_WRITE);
+
+	if (width == xres) {
+		lcd->sendgram(lcd, &dev->fb[(dev->dy0 - dev->fbrow) * xres], (uint32_t)width * (dev->dy1 - dev->dy0 + 1));
+	} else {
+		for (row = dev->dy0; row <= dev->dy1; row++) {
+			lcd->sendgram(lcd, &dev->fb[(row - dev->fbrow) * xres + dev->dx0], width);
+		}
+	}
+
+	lcd->deselect(lcd);
+
+	dev->dx0 = UINT16_MAX;
+	dev->dx1 = 0;
+}
+#endif
+
 /*******************************************************************************
  * Name:  ili9341_putrun
  *
@@ -648,16 +749,59 @@ static void ili9341_selectarea(FAR struct ili9341_lcd_s *lcd, uint16_t x0, uint1
 static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col, FAR const uint8_t *buffer, size_t npixels)
 {
 	FAR struct ili9341_dev_s *dev = &g_lcddev[devno];
+#ifndef CONFIG_LCD_ILI9341_FRAMEBUFFER
 	FAR struct ili9341_lcd_s *lcd = dev->lcd;
+#endif
 	FAR const uint16_t *src = (const uint16_t *)buffer;
 
 	DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
 	/* Check if position outside of area */
-	if (col + npixels > ili9341_getxres(dev) || row > ili9341_getyres(dev)) {
+	if (col + npixels > ili9341_getxres(dev) || row >= ili9341_getyres(dev)) {
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+	if (npixels == 0) {
+		return OK;
+	}
+
+	/* Move the band of buffered rows to reach this row */
+
+	if (row < dev->fbrow || row >= dev->fbrow + dev->fblines) {
+		ili9341_fbflush(dev);
+		dev->fbrow = row;
+		if (dev->fbrow + dev->fblines > ili9341_getyres(dev)) {
+			dev->fbrow = ili9341_getyres(dev) - dev->fblines;
+		}
+	}
+
+	memcpy(&dev->fb[(row - dev->fbrow) * ili9341_getxres(dev) + col], src, npixels * sizeof(uint16_t));
+
+	/* Grow the dirty rectangle */
+
+	if (dev->dx0 > dev->dx1) {
+		dev->dx0 = col;
+		dev->dx1 = col + npixels - 1;
+		dev->dy0 = row;
+		dev->dy1 = row;
+	} else {
+		if (col < dev->dx0) {
+			dev->dx0 = col;
+		}
+		if (col + npixels - 1 > dev->dx1) {
+			dev->dx1 = col + npixels - 1;
+		}
+		if (row < dev->dy0) {
+			dev->dy0 = row;
+		}
+		if (row > dev->dy1) {
+			dev->dy1 = row;
+		}
+	}
+
+	return OK;
+#else
 	/* Select lcd driver */
 
 	lcd->select(lcd);
@@ -679,6 +823,7 @@ static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col, FAR const u
 	lcd->deselect(lcd);
 
 	return OK;
+#endif
 }
 
 /*******************************************************************************
@@ -712,10 +857,16 @@ static int ili9341_getrun(int devno, fb_coord_t row, fb_coord_t col, FAR uint8_t
 	DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
 	/* Check if position outside of area */
-	if (col + npixels > ili9341_getxres(dev) || row > ili9341_getyres(dev)) {
+	if (col + npixels > ili9341_getxres(dev) || row >= ili9341_getyres(dev)) {
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+	/* The display must be up to date before reading it back */
+
+	ili9341_fbflush(dev);
+#endif
+
 	/* Select lcd driver */
 
 	lcd->select(lcd);
@@ -1195,6 +1346,13 @@ int ili9341_clear(FAR struct lcd_dev_s *dev, uint16_t color)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+	/* Pending runs would be drawn over the cleared display later */
+
+	priv->dx0 = UINT16_MAX;
+	priv->dx1 = 0;
+#endif
+
 	/* Select lcd driver */
 
 	lcd->select(lcd);
@@ -1221,3 +1379,36 @@ int ili9341_clear(FAR struct lcd_dev_s *dev, uint16_t color)
 
 	return OK;
 }
+
+/******************************************************************************
+ * Name:  ili9341_flush
+ *
+ * Description:
+ *   This is a non-standard LCD interface.  With
+ *   CONFIG_LCD_ILI9341_FRAMEBUFFER, runs are collected in RAM; send the
+ *   region changed since the last flush to the display.
+ *
+ * Parameter:
+ *   dev   - A reference to the lcd driver structure
+ *
+ * Returned Value:
+ *
+ *  On success - OK
+ *  On error   - -EINVAL
+ *
+ ******************************************************************************/
+
+int ili9341_flush(FAR struct lcd_dev_s *dev)
+{
+	FAR struct ili9341_dev_s *priv = (FAR struct ili9341_dev_s *)dev;
+
+	if (!priv->lcd) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_LCD_ILI9341_FRAMEBUFFER
+	ili9341_fbflush(priv);
+#endif
+
+	return OK;
+}
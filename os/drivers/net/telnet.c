@@ -77,9 +77,11 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <tinyara/clock.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 #include <tinyara/net/telnet.h>
+#include <tinyara/wqueue.h>
 
 #ifdef CONFIG_NETDEV_TELNET
 
@@ -96,6 +98,11 @@
 #define CONFIG_TELNET_TXBUFFER_SIZE 256
 #endif
 
+#if !defined(CONFIG_SCHED_WORKQUEUE) || !defined(CONFIG_TELNET_FLUSH_DELAY)
+#undef CONFIG_TELNET_FLUSH_DELAY
+#define CONFIG_TELNET_FLUSH_DELAY 0
+#endif
+
 /* Telnet protocol stuff ****************************************************/
 
 #define ISO_nl       0x0a
@@ -130,11 +137,16 @@ enum telnet_state_e {
 struct telnet_dev_s {
 	sem_t td_exclsem;			/* Enforces mutually exclusive access */
 	uint8_t td_state;			/* (See telnet_state_e) */
-	uint8_t td_pending;			/* Number of valid, pending bytes in the rxbuffer */
-	uint8_t td_offset;			/* Offset to the valid, pending bytes in the rxbuffer */
+	uint16_t td_pending;		/* Number of valid, pending bytes in the rxbuffer */
+	uint16_t td_offset;			/* Offset to the valid, pending bytes in the rxbuffer */
 	uint8_t td_crefs;			/* The number of open references to the session */
 	int td_minor;				/* Minor device number */
 	int td_psock;				/* A clone of the internal socket structure */
+	int td_txlen;				/* Number of bytes waiting in the txbuffer */
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+	bool td_flushq;				/* td_flushwork is queued and holds a reference */
+	struct work_s td_flushwork;	/* Sends the txbuffer after a delay */
+#endif
 	char td_rxbuffer[CONFIG_TELNET_RXBUFFER_SIZE];
 	char td_txbuffer[CONFIG_TELNET_TXBUFFER_SIZE];
 };
@@ -162,6 +174,11 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch, FAR char *
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src, size_t srclen, FAR char *dest, size_t destlen);
 static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch, int *nwritten);
 static void telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option, uint8_t value);
+static int telnet_flush(FAR struct telnet_dev_s *priv);
+static void telnet_release(FAR struct telnet_dev_s *priv);
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+static void telnet_flushwork(FAR void *arg);
+#endif
 
 /* Telnet character driver methods */
 
@@ -271,12 +288,36 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch, FAR char *
 
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src, size_t srclen, FAR char *dest, size_t destlen)
 {
+	size_t n;
 	int nread;
 	uint8_t ch;
 
 	nllvdbg("srclen: %d destlen: %d\n", srclen, destlen);
 
 	for (nread = 0; srclen > 0 && nread < destlen; srclen--) {
+		if (priv->td_state == STATE_NORMAL) {
+			/* Copy a run of plain characters at once.  Pasted input is
+			 * mostly made of those.
+			 */
+
+			for (n = 0; n < srclen && n < destlen - nread; n++) {
+				ch = src[n];
+				if (ch == TELNET_IAC || ch == ISO_cr) {
+					break;
+				}
+			}
+
+			if (n > 0) {
+				memcpy(&dest[nread], src, n);
+				nread += n;
+				src += n;
+				srclen -= n;
+				if (srclen == 0 || nread >= destlen) {
+					break;
+				}
+			}
+		}
+
 		ch = *src++;
 		nllvdbg("ch=%02x state=%d\n", ch, priv->td_state);
 
@@ -431,6 +472,127 @@ static void telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option, uint8_
 	}
 }
 
+/****************************************************************************
+ * Name: telnet_flush
+ *
+ * Description:
+ *   Send the output waiting in the TX buffer.  Called with td_exclsem held.
+ *
+ ****************************************************************************/
+
+static int telnet_flush(FAR struct telnet_dev_s *priv)
+{
+	ssize_t ret = OK;
+
+	if (priv->td_txlen > 0) {
+		ret = send(priv->td_psock, priv->td_txbuffer, priv->td_txlen, 0);
+		if (ret < 0) {
+			nlldbg("psock_send failed: %d\n", ret);
+		}
+
+		priv->td_txlen = 0;
+	}
+
+	return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: telnet_flushwork
+ *
+ * Description:
+ *   Send the output that telnet_write() held back.  The queued work holds a
+ *   reference to the session, so it also frees the session if the last
+ *   open reference went away meanwhile.
+ *
+ ****************************************************************************/
+
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+static void telnet_flushwork(FAR void *arg)
+{
+	FAR struct telnet_dev_s *priv = (FAR struct telnet_dev_s *)arg;
+
+	while (sem_wait(&priv->td_exclsem) < 0) {
+	}
+
+	priv->td_flushq = false;
+	(void)telnet_flush(priv);
+	telnet_release(priv);
+}
+#endif
+
+/****************************************************************************
+ * Name: telnet_release
+ *
+ * Description:
+ *   Drop a reference to the session and release td_exclsem, which the
+ *   caller holds.  The last reference sends the remaining output, closes
+ *   the connection and frees the session.
+ *
+ ****************************************************************************/
+
+static void telnet_release(FAR struct telnet_dev_s *priv)
+{
+	FAR char *devpath;
+	int ret;
+
+	/* Decrement the references to the driver.  If the reference count will
+	 * decrement to 0, then uninitialize the driver.
+	 */
+
+	if (priv->td_crefs > 1) {
+		/* Just decrement the reference count and release the semaphore */
+
+		priv->td_crefs--;
+		sem_post(&priv->td_exclsem);
+		return;
+	}
+
+	(void)telnet_flush(priv);
+
+	/* Re-create the path to the driver. */
+
+	sched_lock();
+	ret = asprintf(&devpath, TELNETD_DEVFMT, priv->td_minor);
+	if (ret < 0) {
+		nlldbg("ERROR: Failed to allocate the driver path\n");
+	} else {
+		/* Un-register the character driver */
+
+		ret = unregister_driver(devpath);
+		if (ret < 0) {
+			/* NOTE: a return value of -EBUSY is not an error, it simply
+			 * means that the Telnet driver is busy now and cannot be
+			 * registered now because there are other sessions using the
+			 * connection.  The driver will be properly unregistered when
+			 * the final session terminates.
+			 */
+
+			if (ret != -EBUSY) {
+				nlldbg("Failed to unregister the driver %s: %d\n", devpath, ret);
+			}
+		}
+
+		free(devpath);
+	}
+
+	/* Close the socket */
+
+	close(priv->td_psock);
+
+	/* Release the driver memory.  What if there are threads waiting on
+	 * td_exclsem?  They will never be awakened!  How could this happen?
+	 * crefs == 1 so there are no other open references to the driver.
+	 * But this could have if someone were trying to re-open the driver
+	 * after every other thread has closed it.  That really should not
+	 * happen in the intended usage model.
+	 */
+
+	DEBUGASSERT(priv->td_exclsem.semcount == 0);
+	sem_destroy(&priv->td_exclsem);
+	free(priv);
+	sched_unlock();
+}
+
 /****************************************************************************
  * Name: telnet_open
  ****************************************************************************/
@@ -492,7 +654,6 @@ static int telnet_close(FAR struct file *filep)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct telnet_dev_s *priv = inode->i_private;
-	FAR char *devpath;
 	int ret;
 
 	nllvdbg("td_crefs: %d\n", priv->td_crefs);
@@ -505,60 +666,18 @@ static int telnet_close(FAR struct file *filep)
 		goto errout;
 	}
 
-	/* Decrement the references to the driver.  If the reference count will
-	 * decrement to 0, then uninitialize the driver.
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+	/* A delayed flush that has not started yet is not needed any more.  One
+	 * that has started keeps its reference and finishes the job.
 	 */
 
-	if (priv->td_crefs > 1) {
-		/* Just decrement the reference count and release the semaphore */
-
+	if (priv->td_flushq && work_cancel(LPWORK, &priv->td_flushwork) == OK) {
+		priv->td_flushq = false;
 		priv->td_crefs--;
-		sem_post(&priv->td_exclsem);
-	} else {
-		/* Re-create the path to the driver. */
-
-		sched_lock();
-		ret = asprintf(&devpath, TELNETD_DEVFMT, priv->td_minor);
-		if (ret < 0) {
-			nlldbg("ERROR: Failed to allocate the driver path\n");
-		} else {
-			/* Un-register the character driver */
-
-			ret = unregister_driver(devpath);
-			if (ret < 0) {
-				/* NOTE: a return value of -EBUSY is not an error, it simply
-				 * means that the Telnet driver is busy now and cannot be
-				 * registered now because there are other sessions using the
-				 * connection.  The driver will be properly unregistered when
-				 * the final session terminates.
-				 */
-
-				if (ret != -EBUSY) {
-					nlldbg("Failed to unregister the driver %s: %d\n", devpath, ret);
-				}
-			}
-
-			free(devpath);
-		}
-
-		/* Close the socket */
-
-		close(priv->td_psock);
-
-		/* Release the driver memory.  What if there are threads waiting on
-		 * td_exclsem?  They will never be awakened!  How could this happen?
-		 * crefs == 1 so there are no other open references to the driver.
-		 * But this could have if someone were trying to re-open the driver
-		 * after every other thread has closed it.  That really should not
-		 * happen in the intended usage model.
-		 */
-
-		DEBUGASSERT(priv->td_exclsem.semcount == 0);
-		sem_destroy(&priv->td_exclsem);
-		free(priv);
-		sched_unlock();
 	}
+#endif
 
+	telnet_release(priv);
 	ret = OK;
 
 errout:
@@ -595,6 +714,13 @@ static ssize_t telnet_read(FAR struct file *filep, FAR char *buffer, size_t len)
 		/* Read a buffer of data from the telnet client */
 
 		else {
+			/* The client may be waiting for output that is held back */
+
+			if (priv->td_txlen > 0 && sem_wait(&priv->td_exclsem) == OK) {
+				(void)telnet_flush(priv);
+				sem_post(&priv->td_exclsem);
+			}
+
 			ret = recv(priv->td_psock, priv->td_rxbuffer, CONFIG_TELNET_RXBUFFER_SIZE, 0);
 
 			/* Did we receive anything? */
@@ -636,51 +762,69 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
 	FAR struct telnet_dev_s *priv = inode->i_private;
 	FAR const char *src = buffer;
 	ssize_t nsent;
-	ssize_t ret;
-	int ncopied;
+	int ret = OK;
 	char ch;
-	bool eol;
 
 	nllvdbg("len: %d\n", len);
 
-	/* Process each character from the user buffer */
+	if (len == 0) {
+		return 0;
+	}
+
+	ret = sem_wait(&priv->td_exclsem);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	/* Process each character from the user buffer.  Lines are collected in
+	 * the TX buffer rather than sent one by one, so that a burst of output
+	 * goes out in as few TCP segments as possible.
+	 */
 
-	for (nsent = 0, ncopied = 0; nsent < len; nsent++) {
+	for (nsent = 0; nsent < len && ret == OK; nsent++) {
 		/* Get the next character from the user buffer */
 
 		ch = *src++;
 
 		/* Add the character to the TX buffer */
 
-		eol = telnet_putchar(priv, ch, &ncopied);
+		(void)telnet_putchar(priv, ch, &priv->td_txlen);
 
-		/* Was that the end of a line? Or is the buffer too full to hold the
-		 * next largest character sequence ("\r\n\0")?
+		/* Is the buffer too full to hold the next largest character
+		 * sequence ("\r\n\0")?  Then send the data now.
 		 */
 
-		if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 3) {
-			/* Yes... send the data now */
+		if (priv->td_txlen > CONFIG_TELNET_TXBUFFER_SIZE - 3) {
+			ret = telnet_flush(priv);
+		}
+	}
 
-			ret = send(priv->td_psock, priv->td_txbuffer, ncopied, 0);
-			if (ret < 0) {
-				nlldbg("psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
-				return ret;
-			}
+	/* A partial line is probably a prompt or an echo that the user waits
+	 * for, so it is sent at once.  Complete lines may wait a little for
+	 * more output to join them.
+	 */
 
-			/* Reset the index to the beginning of the TX buffer. */
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+	if (ret == OK && priv->td_txlen > 0 && buffer[len - 1] == '\n') {
+		if (!priv->td_flushq && priv->td_crefs < 255 && work_queue(LPWORK, &priv->td_flushwork, telnet_flushwork, priv, MSEC2TICK(CONFIG_TELNET_FLUSH_DELAY)) == OK) {
+			priv->td_flushq = true;
+			priv->td_crefs++;
+		}
 
-			ncopied = 0;
+		if (priv->td_flushq) {
+			sem_post(&priv->td_exclsem);
+			return len;
 		}
 	}
+#endif
 
-	/* Send anything remaining in the TX buffer */
+	if (ret == OK) {
+		ret = telnet_flush(priv);
+	}
 
-	if (ncopied > 0) {
-		ret = send(priv->td_psock, priv->td_txbuffer, ncopied, 0);
-		if (ret < 0) {
-			nlldbg("psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
-			return ret;
-		}
+	sem_post(&priv->td_exclsem);
+	if (ret < 0) {
+		return ret;
 	}
 
 	/* Notice that we don't actually return the number of bytes sent, but
@@ -733,6 +877,11 @@ static int telnet_session(FAR struct telnet_session_s *session)
 	priv->td_crefs = 0;
 	priv->td_pending = 0;
 	priv->td_offset = 0;
+	priv->td_txlen = 0;
+#if CONFIG_TELNET_FLUSH_DELAY > 0
+	priv->td_flushq = false;
+	memset(&priv->td_flushwork, 0, sizeof(priv->td_flushwork));
+#endif
 
 	/* Clone the internal socket structure.  We do this so that it will be
 	 * independent of threads and of socket descriptors (the original socket
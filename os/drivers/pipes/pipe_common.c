@@ -96,6 +96,10 @@
 #define pipe_dumpbuffer(m, a, n)
 #endif
 
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -133,26 +137,115 @@ static void pipecommon_semtake(sem_t *sem)
  * Name: pipecommon_pollnotify
  ****************************************************************************/
 
+/* Callers only report POLLIN when the pipe stops being empty and POLLOUT
+ * when it stops being full.  That is enough: a poll set up at any other
+ * time is notified right away by pipecommon_poll().
+ */
+
 #ifndef CONFIG_DISABLE_POLL
 static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t eventset)
 {
+	FAR struct pollfd **slots;
+	FAR struct pollfd *fds;
+	int nfds;
 	int i;
 
-	for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++) {
-		struct pollfd *fds = dev->d_fds[i];
+	if (eventset == POLLIN) {
+		slots = dev->d_rdfds;
+		nfds = dev->d_nrdfds;
+	} else {
+		slots = dev->d_wrfds;
+		nfds = dev->d_nwrfds;
+	}
+
+	for (i = 0; nfds > 0 && i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++) {
+		fds = slots[i];
 		if (fds) {
+			nfds--;
 			fds->revents |= (fds->events & eventset);
-			if (fds->revents != 0) {
-				fvdbg("Report events: %02x\n", fds->revents);
-				sem_post(fds->sem);
-			}
+			fvdbg("Report events: %02x\n", fds->revents);
+			sem_post(fds->sem);
 		}
 	}
 }
+
+static FAR struct pollfd **pipecommon_pollslot(FAR struct pollfd **slots)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++) {
+		if (!slots[i]) {
+			return &slots[i];
+		}
+	}
+
+	return NULL;
+}
 #else
 #define pipecommon_pollnotify(dev, event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the buffer size to 'size' bytes.  If the pipe is open, the
+ *   buffered data moves to a new buffer, which must be able to hold it.
+ *   Returns the new size or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t size)
+{
+	FAR struct lfring_s *ring = &dev->d_ring;
+	FAR uint8_t *buffer;
+	size_t nbytes;
+	bool wasfull;
+	int sval;
+
+	if (size == 0 || size > CONFIG_DEV_PIPE_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -get_errno();
+	}
+
+	if (ring->buffer != NULL && size != ring->size) {
+		nbytes = lfring_used(ring);
+		if (nbytes > size) {
+			sem_post(&dev->d_bfsem);
+			return -EBUSY;
+		}
+
+		buffer = (FAR uint8_t *)kmm_malloc(size);
+		if (!buffer) {
+			sem_post(&dev->d_bfsem);
+			return -ENOMEM;
+		}
+
+		wasfull = nbytes == ring->size;
+		lfring_read(ring, buffer, nbytes);
+		kmm_free(ring->buffer);
+		lfring_init(ring, buffer, size);
+		lfring_commit(ring, nbytes);
+
+		/* A full pipe that grew can be written again */
+
+		if (wasfull && nbytes < size) {
+			while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
+				sem_post(&dev->d_wrsem);
+			}
+
+			pipecommon_pollnotify(dev, POLLOUT);
+		}
+	}
+
+	dev->d_bufsize = size;
+	sem_post(&dev->d_bfsem);
+	return (int)size;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -175,6 +268,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
 		sem_init(&dev->d_bfsem, 0, 1);
 		sem_init(&dev->d_rdsem, 0, 0);
 		sem_init(&dev->d_wrsem, 0, 0);
+		dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
 
 		/*
 		 * The read/write wait semaphores are used for signaling and,
@@ -228,12 +322,14 @@ int pipecommon_open(FAR struct file *filep)
 	 * is first opened.
 	 */
 
-	if (dev->d_refs == 0 && dev->d_buffer == NULL) {
-		dev->d_buffer = (uint8_t *)kmm_malloc(CONFIG_DEV_PIPE_SIZE);
-		if (!dev->d_buffer) {
+	if (dev->d_refs == 0 && dev->d_ring.buffer == NULL) {
+		FAR uint8_t *buffer = (FAR uint8_t *)kmm_malloc(dev->d_bufsize);
+		if (!buffer) {
 			(void)sem_post(&dev->d_bfsem);
 			return -ENOMEM;
 		}
+
+		lfring_init(&dev->d_ring, buffer, dev->d_bufsize);
 	}
 
 	/* Increment the reference count on the pipe instance */
@@ -266,7 +362,7 @@ int pipecommon_open(FAR struct file *filep)
 
 	if ((filep->f_oflags & O_RDWR) == O_RDONLY &&	/* Read-only */
 		dev->d_nwriters < 1 &&	/* No writers on the pipe */
-		dev->d_wrndx == dev->d_rdndx) {	/* Buffer is empty */
+		lfring_empty(&dev->d_ring)) {	/* Buffer is empty */
 		/* NOTE: d_rdsem is normally used when the read logic waits for more
 		 * data to be written.  But until the first writer has opened the
 		 * pipe, the meaning is different: it is used prevent O_RDONLY open
@@ -345,16 +441,14 @@ int pipecommon_close(FAR struct file *filep)
 	 * obtained when the pipe is re-opened.
 	 */
 
-	else if (PIPE_IS_POLICY_0(dev->d_flags) || dev->d_wrndx == dev->d_rdndx) {
+	else if (PIPE_IS_POLICY_0(dev->d_flags) || lfring_empty(&dev->d_ring)) {
 		/* Policy 0 or the buffer is empty ... deallocate the buffer now. */
 
-		kmm_free(dev->d_buffer);
-		dev->d_buffer = NULL;
+		kmm_free(dev->d_ring.buffer);
 
 		/* And reset all counts and indices */
 
-		dev->d_wrndx = 0;
-		dev->d_rdndx = 0;
+		lfring_init(&dev->d_ring, NULL, 0);
 		dev->d_refs = 0;
 		dev->d_nwriters = 0;
 
@@ -385,6 +479,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	FAR uint8_t *start = (uint8_t *)buffer;
 #endif
 	ssize_t nread = 0;
+	bool wasfull;
 	int sval;
 	int ret;
 
@@ -402,7 +497,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* If the pipe is empty, then wait for something to be written to it */
 
-	while (dev->d_wrndx == dev->d_rdndx) {
+	while (lfring_empty(&dev->d_ring)) {
 		/* If O_NONBLOCK was set, then return EGAIN */
 
 		if (filep->f_oflags & O_NONBLOCK) {
@@ -431,14 +526,8 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* Then return whatever is available in the pipe (which is at least one byte) */
 
-	nread = 0;
-	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
-			dev->d_rdndx = 0;
-		}
-		nread++;
-	}
+	wasfull = lfring_space(&dev->d_ring) == 0;
+	nread = lfring_read(&dev->d_ring, buffer, len);
 
 	/* Notify all waiting writers that bytes have been removed from the buffer */
 
@@ -448,7 +537,9 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* Notify all poll/select waiters that they can write to the FIFO */
 
-	pipecommon_pollnotify(dev, POLLOUT);
+	if (wasfull) {
+		pipecommon_pollnotify(dev, POLLOUT);
+	}
 
 	sem_post(&dev->d_bfsem);
 	pipe_dumpbuffer("From PIPE:", start, nread);
@@ -465,7 +556,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
 	ssize_t last;
-	int nxtwrndx;
+	bool wasempty;
 	int sval;
 
 	DEBUGASSERT(dev);
@@ -498,69 +589,57 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
+		/* Copy as many bytes as the circular buffer can hold */
 
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
-		}
+		wasempty = lfring_empty(&dev->d_ring);
+		nwritten += lfring_write(&dev->d_ring, buffer + nwritten, len - nwritten);
 
-		/* Would the next write overflow the circular buffer? */
+		/* Was anything written in this pass? */
 
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
+		if (last < nwritten) {
+			/* Yes.. Notify all of the waiting readers that more data is available */
 
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
-
-			/* Is the write complete? */
-
-			if (++nwritten >= len) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
-
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+			while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
+				sem_post(&dev->d_rdsem);
+			}
 
-				/* Notify all poll/select waiters that they can write to the FIFO */
+			/* Notify all poll/select waiters that they can read from the FIFO */
 
+			if (wasempty) {
 				pipecommon_pollnotify(dev, POLLIN);
-
-				/* Return the number of bytes written */
-
-				sem_post(&dev->d_bfsem);
-				return len;
 			}
-		} else {
-			/* There is not enough room for the next byte. Was anything written in this pass? */
+		}
 
-			if (last < nwritten) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+		/* Is the write complete? */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-			}
-			last = nwritten;
+		if (nwritten >= len) {
+			/* Yes.. Return the number of bytes written */
 
-			/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+			sem_post(&dev->d_bfsem);
+			return len;
+		}
 
-			if (filep->f_oflags & O_NONBLOCK) {
-				if (nwritten == 0) {
-					nwritten = -EAGAIN;
-				}
-				sem_post(&dev->d_bfsem);
-				return nwritten;
-			}
+		/* There is not enough room for the next byte */
 
-			/* There is more to be written.. wait for data to be removed from the pipe */
+		last = nwritten;
 
-			sched_lock();
+		/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+
+		if (filep->f_oflags & O_NONBLOCK) {
+			if (nwritten == 0) {
+				nwritten = -EAGAIN;
+			}
 			sem_post(&dev->d_bfsem);
-			pipecommon_semtake(&dev->d_wrsem);
-			sched_unlock();
-			pipecommon_semtake(&dev->d_bfsem);
+			return nwritten;
 		}
+
+		/* There is more to be written.. wait for data to be removed from the pipe */
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
 	}
 }
 
@@ -573,8 +652,10 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
+	FAR struct pollfd **rdslot = NULL;
+	FAR struct pollfd **wrslot = NULL;
 	pollevent_t eventset;
-	pipe_ndx_t nbytes;
+	size_t nbytes;
 	int ret = OK;
 	int i;
 
@@ -585,41 +666,47 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 	pipecommon_semtake(&dev->d_bfsem);
 	if (setup) {
 		/* This is a request to set up the poll. Find an available
-		 * slot for the poll structure reference
+		 * slot for the poll structure reference in the list of each
+		 * direction that it waits for.
 		 */
 
-		for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++) {
-			/* Find an available slot */
-
-			if (!dev->d_fds[i]) {
-				/* Bind the poll structure and this slot */
+		if ((fds->events & POLLIN) && (rdslot = pipecommon_pollslot(dev->d_rdfds)) == NULL) {
+			ret = -EBUSY;
+		}
 
-				dev->d_fds[i] = fds;
-				fds->priv = &dev->d_fds[i];
-				break;
-			}
+		if ((fds->events & POLLOUT) && (wrslot = pipecommon_pollslot(dev->d_wrfds)) == NULL) {
+			ret = -EBUSY;
 		}
 
-		if (i >= CONFIG_DEV_PIPE_NPOLLWAITERS) {
+		if (ret < 0) {
 			fds->priv = NULL;
-			ret = -EBUSY;
 			goto errout;
 		}
 
+		/* Bind the poll structure and the slots */
+
+		if (rdslot) {
+			*rdslot = fds;
+			dev->d_nrdfds++;
+		}
+
+		if (wrslot) {
+			*wrslot = fds;
+			dev->d_nwrfds++;
+		}
+
+		fds->priv = dev;
+
 		/* Should immediately notify on any of the requested events?
 		 * First, determine how many bytes are in the buffer
 		 */
 
-		if (dev->d_wrndx >= dev->d_rdndx) {
-			nbytes = dev->d_wrndx - dev->d_rdndx;
-		} else {
-			nbytes = (CONFIG_DEV_PIPE_SIZE - 1) + dev->d_wrndx - dev->d_rdndx;
-		}
+		nbytes = lfring_used(&dev->d_ring);
 
 		/* Notify the POLLOUT event if the pipe is not full */
 
 		eventset = 0;
-		if (nbytes < (CONFIG_DEV_PIPE_SIZE - 1)) {
+		if (nbytes < dev->d_ring.size) {
 			eventset |= POLLOUT;
 		}
 
@@ -629,16 +716,15 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 			eventset |= POLLIN;
 		}
 
-		if (eventset) {
-			pipecommon_pollnotify(dev, eventset);
+		fds->revents |= (fds->events & eventset);
+		if (fds->revents != 0) {
+			sem_post(fds->sem);
 		}
 	} else {
 		/* This is a request to tear down the poll. */
 
-		struct pollfd **slot = (struct pollfd **)fds->priv;
-
 #ifdef CONFIG_DEBUG
-		if (!slot) {
+		if (!fds->priv) {
 			ret = -EIO;
 			goto errout;
 		}
@@ -646,7 +732,18 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
 		/* Remove all memory of the poll setup */
 
-		*slot = NULL;
+		for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++) {
+			if (dev->d_rdfds[i] == fds) {
+				dev->d_rdfds[i] = NULL;
+				dev->d_nrdfds--;
+			}
+
+			if (dev->d_wrfds[i] == fds) {
+				dev->d_wrfds[i] = NULL;
+				dev->d_nwrfds--;
+			}
+		}
+
 		fds->priv = NULL;
 	}
 
@@ -656,6 +753,184 @@ errout:
 }
 #endif
 
+#ifdef CONFIG_PIPE_SPLICE
+/****************************************************************************
+ * Name: pipecommon_splice_out
+ *
+ * Description:
+ *   Pass up to 'len' bytes of the pipe to 'sink' in place, one contiguous
+ *   region at a time, waiting for data like pipecommon_read().  The bytes
+ *   accepted by 'sink' are removed from the pipe only if 'consume' is true.
+ *   Returns the number of bytes accepted, 0 at end of file, or a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_out(FAR struct file *filep, pipe_xfer_t sink, FAR void *arg, size_t len, bool nonblock, bool consume)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev = inode->i_private;
+	FAR struct lfring_s *ring = &dev->d_ring;
+	ssize_t ntransferred = 0;
+	uint32_t index;
+	size_t avail;
+	size_t offset;
+	size_t n;
+	ssize_t ret;
+	bool wasfull;
+	int sval;
+
+	DEBUGASSERT(dev);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -get_errno();
+	}
+
+	/* If the pipe is empty, then wait for something to be written to it */
+
+	while (lfring_empty(ring)) {
+		if (nonblock || (filep->f_oflags & O_NONBLOCK)) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		if (dev->d_nwriters <= 0) {
+			sem_post(&dev->d_bfsem);
+			return 0;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		ret = sem_wait(&dev->d_rdsem);
+		sched_unlock();
+
+		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
+			return -get_errno();
+		}
+	}
+
+	/* Hand the buffered data to the sink where it lies in the ring */
+
+	index = ring->tail;
+	avail = lfring_used(ring);
+	wasfull = avail == ring->size;
+
+	while (ntransferred < len && avail > 0) {
+		offset = lfring_offset(ring, index);
+		n = MIN(avail, ring->size - offset);
+		n = MIN(n, len - ntransferred);
+
+		ret = sink(arg, &ring->buffer[offset], n);
+		if (ret <= 0) {
+			if (ntransferred == 0) {
+				ntransferred = ret;
+			}
+			break;
+		}
+
+		index = lfring_advance(ring, index, ret);
+		avail -= ret;
+		ntransferred += ret;
+
+		if (consume) {
+			lfring_consume(ring, ret);
+		}
+
+		if (ret < n) {
+			break;
+		}
+	}
+
+	if (consume && ntransferred > 0) {
+		/* Notify all waiting writers that bytes have been removed from the buffer */
+
+		while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
+			sem_post(&dev->d_wrsem);
+		}
+
+		if (wasfull) {
+			pipecommon_pollnotify(dev, POLLOUT);
+		}
+	}
+
+	sem_post(&dev->d_bfsem);
+	return ntransferred;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_in
+ *
+ * Description:
+ *   Let 'source' fill the next contiguous free region of the pipe, of at
+ *   most 'len' bytes, in place, waiting for space like pipecommon_write().
+ *   Returns the number of bytes added or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_in(FAR struct file *filep, pipe_xfer_t source, FAR void *arg, size_t len, bool nonblock)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev = inode->i_private;
+	FAR struct lfring_s *ring = &dev->d_ring;
+	FAR uint8_t *ptr;
+	size_t n;
+	ssize_t ret;
+	bool wasempty;
+	int sval;
+
+	DEBUGASSERT(dev);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -get_errno();
+	}
+
+	/* If the pipe is full, wait for data to be removed from it */
+
+	while (lfring_space(ring) == 0) {
+		if (nonblock || (filep->f_oflags & O_NONBLOCK)) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
+	}
+
+	wasempty = lfring_empty(ring);
+	n = lfring_reserve(ring, &ptr);
+	n = MIN(n, len);
+
+	ret = source(arg, ptr, n);
+	if (ret > 0) {
+		lfring_commit(ring, ret);
+
+		/* Notify all of the waiting readers that more data is available */
+
+		while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
+			sem_post(&dev->d_rdsem);
+		}
+
+		if (wasempty) {
+			pipecommon_pollnotify(dev, POLLIN);
+		}
+	}
+
+	sem_post(&dev->d_bfsem);
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pipecommon_ioctl
  ****************************************************************************/
@@ -665,9 +940,8 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
 
-	/* Only one command supported */
-
-	if (cmd == PIPEIOC_POLICY) {
+	switch (cmd) {
+	case PIPEIOC_POLICY:
 		if (arg != 0) {
 			PIPE_POLICY_1(dev->d_flags);
 		} else {
@@ -675,9 +949,16 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		}
 
 		return OK;
-	}
 
-	return -ENOTTY;
+	case PIPEIOC_SETSIZE:
+		return pipecommon_resize(dev, (size_t)arg);
+
+	case PIPEIOC_GETSIZE:
+		return (int)dev->d_bufsize;
+
+	default:
+		return -ENOTTY;
+	}
 }
 
 /****************************************************************************
@@ -700,8 +981,8 @@ int pipecommon_unlink(FAR struct inode *inode)
 	if (dev->d_refs == 0) {
 		/* No.. free the buffer (if there is one) */
 
-		if (dev->d_buffer) {
-			kmm_free(dev->d_buffer);
+		if (dev->d_ring.buffer) {
+			kmm_free(dev->d_ring.buffer);
 		}
 
 		/* And free the device structure. */
@@ -64,6 +64,8 @@
 #include <stdbool.h>
 #include <poll.h>
 
+#include <tinyara/lfring.h>
+
 #ifndef CONFIG_DEV_PIPE_SIZE
 #define CONFIG_DEV_PIPE_SIZE 1024
 #endif
@@ -80,6 +82,12 @@
 #define CONFIG_DEV_PIPE_NPOLLWAITERS 2
 #endif
 
+/* Largest buffer that F_SETPIPE_SZ may ask for */
+
+#ifndef CONFIG_DEV_PIPE_MAXSIZE
+#define CONFIG_DEV_PIPE_MAXSIZE 65536
+#endif
+
 /* Maximum number of open's supported on pipe */
 
 #define CONFIG_DEV_PIPE_MAXUSER 255
@@ -101,40 +109,33 @@
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
-
-#if CONFIG_DEV_PIPE_SIZE > 65535
-typedef uint32_t pipe_ndx_t;	/* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
-typedef uint16_t pipe_ndx_t;	/* 16-bit index */
-#else
-typedef uint8_t pipe_ndx_t;		/*  8-bit index */
-#endif
-
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe pipe/fifo
  * device is registered.
  */
 
 struct pipe_dev_s {
-	sem_t d_bfsem;				/* Used to serialize access to d_buffer and indices */
+	sem_t d_bfsem;				/* Used to serialize access to d_ring */
 	sem_t d_rdsem;				/* Empty buffer - Reader waits for data write */
 	sem_t d_wrsem;				/* Full buffer - Writer waits for data read */
-	pipe_ndx_t d_wrndx;			/* Index in d_buffer to save next byte written */
-	pipe_ndx_t d_rdndx;			/* Index in d_buffer to return the next byte read */
+	struct lfring_s d_ring;		/* Buffer allocated when device opened */
+	size_t d_bufsize;			/* Size of the buffer to allocate */
 	uint8_t d_refs;				/* References counts on pipe (limited to 255) */
 	uint8_t d_nwriters;			/* Number of reference counts for write access */
 	uint8_t d_pipeno;			/* Pipe minor number */
 	uint8_t d_flags;			/* See PIPE_FLAG_* definitions */
-	uint8_t *d_buffer;			/* Buffer allocated when device opened */
 
-	/* The following is a list if poll structures of threads waiting for
-	 * driver events. The 'struct pollfd' reference for each open is also
-	 * retained in the f_priv field of the 'struct file'.
+	/* The poll structures of threads waiting for driver events, kept apart
+	 * by direction so that a change of state only visits the waiters that
+	 * it concerns: d_rdfds wait for POLLIN and d_wrfds for POLLOUT.  A poll
+	 * for both is in both lists.
 	 */
 
 #ifndef CONFIG_DISABLE_POLL
-	struct pollfd *d_fds[CONFIG_DEV_PIPE_NPOLLWAITERS];
+	uint8_t d_nrdfds;			/* Number of entries in d_rdfds */
+	uint8_t d_nwrfds;			/* Number of entries in d_wrfds */
+	struct pollfd *d_rdfds[CONFIG_DEV_PIPE_NPOLLWAITERS];
+	struct pollfd *d_wrfds[CONFIG_DEV_PIPE_NPOLLWAITERS];
 #endif
 };
 
@@ -152,6 +153,14 @@ extern "C" {
 struct file;					/* Forward reference */
 struct inode;					/* Forward reference */
 
+#ifdef CONFIG_PIPE_SPLICE
+/* Moves data out of or into the pipe ring in place for splice() and tee().
+ * Returns the number of bytes moved or a negated errno value.
+ */
+
+typedef ssize_t (*pipe_xfer_t)(FAR void *arg, FAR uint8_t *buffer, size_t len);
+#endif
+
 FAR struct pipe_dev_s *pipecommon_allocdev(void);
 void pipecommon_freedev(FAR struct pipe_dev_s *dev);
 int pipecommon_open(FAR struct file *filep);
@@ -163,6 +172,10 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 #endif
 int pipecommon_unlink(FAR struct inode *priv);
+#ifdef CONFIG_PIPE_SPLICE
+ssize_t pipecommon_splice_out(FAR struct file *filep, pipe_xfer_t sink, FAR void *arg, size_t len, bool nonblock, bool consume);
+ssize_t pipecommon_splice_in(FAR struct file *filep, pipe_xfer_t source, FAR void *arg, size_t len, bool nonblock);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -0,0 +1,239 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * splice() and tee().  The data of the pipe is passed to write() where it
+ * lies in the pipe ring, and read() fills the free part of the ring
+ * directly, so moving data between a pipe and a socket or file does not go
+ * through a user buffer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <tinyara/fs/fs.h>
+
+#include "pipe_common.h"
+
+#if CONFIG_DEV_PIPE_SIZE > 0 && defined(CONFIG_PIPE_SPLICE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The descriptor at the other end of a splice() */
+
+struct splice_fd_s {
+	int fd;
+	FAR off_t *offset;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_getpipe
+ *
+ * Description:
+ *   Return the open file of 'fd' if it is a pipe or FIFO opened with the
+ *   access in 'oflags', NULL otherwise.
+ *
+ ****************************************************************************/
+
+static FAR struct file *splice_getpipe(int fd, int oflags)
+{
+	FAR struct file *filep;
+	FAR struct inode *inode;
+
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+		return NULL;
+	}
+
+	filep = fs_getfilep(fd);
+	if (filep == NULL) {
+		return NULL;
+	}
+
+	inode = filep->f_inode;
+	if (inode == NULL || inode->u.i_ops == NULL || inode->u.i_ops->read != pipecommon_read) {
+		return NULL;
+	}
+
+	if ((filep->f_oflags & oflags) == 0) {
+		return NULL;
+	}
+
+	return filep;
+}
+
+/****************************************************************************
+ * Name: splice_write / splice_read
+ *
+ * Description:
+ *   Move data between the pipe ring and the other descriptor.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_write(FAR void *arg, FAR uint8_t *buffer, size_t len)
+{
+	FAR struct splice_fd_s *other = (FAR struct splice_fd_s *)arg;
+	ssize_t ret;
+
+	if (other->offset) {
+		ret = pwrite(other->fd, buffer, len, *other->offset);
+		if (ret > 0) {
+			*other->offset += ret;
+		}
+	} else {
+		ret = write(other->fd, buffer, len);
+	}
+
+	return ret < 0 ? -get_errno() : ret;
+}
+
+static ssize_t splice_read(FAR void *arg, FAR uint8_t *buffer, size_t len)
+{
+	FAR struct splice_fd_s *other = (FAR struct splice_fd_s *)arg;
+	ssize_t ret;
+
+	if (other->offset) {
+		ret = pread(other->fd, buffer, len, *other->offset);
+		if (ret > 0) {
+			*other->offset += ret;
+		}
+	} else {
+		ret = read(other->fd, buffer, len);
+	}
+
+	return ret < 0 ? -get_errno() : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between a pipe and another descriptor.  One of
+ *   'fd_in' and 'fd_out' must be a pipe; its offset must be NULL.  The
+ *   offset of the other descriptor is used and updated like with
+ *   pread()/pwrite() if given.  SPLICE_F_NONBLOCK makes the pipe side
+ *   non-blocking; the other flags are accepted and ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved, 0 at end of file of the input pipe, or -1
+ *   with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags)
+{
+	FAR struct file *inpipe;
+	FAR struct file *outpipe;
+	struct splice_fd_s other;
+	bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+	ssize_t ret;
+
+	inpipe = splice_getpipe(fd_in, O_RDOK);
+	outpipe = splice_getpipe(fd_out, O_WROK);
+
+	if (inpipe != NULL) {
+		if (off_in != NULL) {
+			ret = -ESPIPE;
+		} else if (inpipe == outpipe || (outpipe && inpipe->f_inode == outpipe->f_inode)) {
+			ret = -EINVAL;
+		} else {
+			other.fd = fd_out;
+			other.offset = off_out;
+			ret = pipecommon_splice_out(inpipe, splice_write, &other, len, nonblock, true);
+		}
+	} else if (outpipe != NULL) {
+		if (off_out != NULL) {
+			ret = -ESPIPE;
+		} else {
+			other.fd = fd_in;
+			other.offset = off_in;
+			ret = pipecommon_splice_in(outpipe, splice_read, &other, len, nonblock);
+		}
+	} else {
+		ret = -EINVAL;
+	}
+
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   Copy up to 'len' bytes from the pipe 'fd_in' to the pipe 'fd_out'
+ *   without removing them from 'fd_in'.
+ *
+ * Returned Value:
+ *   The number of bytes copied, 0 at end of file of the input pipe, or -1
+ *   with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+	FAR struct file *inpipe;
+	FAR struct file *outpipe;
+	struct splice_fd_s other;
+	ssize_t ret;
+
+	inpipe = splice_getpipe(fd_in, O_RDOK);
+	outpipe = splice_getpipe(fd_out, O_WROK);
+
+	if (inpipe == NULL || outpipe == NULL || inpipe->f_inode == outpipe->f_inode) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	other.fd = fd_out;
+	other.offset = NULL;
+	ret = pipecommon_splice_out(inpipe, splice_write, &other, len, (flags & SPLICE_F_NONBLOCK) != 0, false);
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return ret;
+}
+
+#endif							/* CONFIG_DEV_PIPE_SIZE > 0 && CONFIG_PIPE_SPLICE */
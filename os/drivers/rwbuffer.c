@@ -87,6 +87,15 @@
 #define CONFIG_DRVR_WRDELAY 350
 #endif
 
+/* Number of blocks loaded by a read-ahead buffer reload */
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+#define RWB_RHWINDOW(rwb)		((rwb)->rhwindow)
+#define RWB_RHMINWINDOW(rwb)	((rwb)->rhmaxblocks > 4 ? (rwb)->rhmaxblocks >> 2 : 1)
+#else
+#define RWB_RHWINDOW(rwb)		((rwb)->rhmaxblocks)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -356,7 +365,7 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 	 * read-ahead buffer
 	 */
 
-	endblock = startblock + rwb->rhmaxblocks;
+	endblock = startblock + RWB_RHWINDOW(rwb);
 
 	/* Make sure that we don't read past the end of the device */
 
@@ -388,6 +397,155 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_pfworker
+ *
+ * Description:
+ *   Read the next window into the prefetch buffer.  Runs on the LP work
+ *   queue without the rhsem, which the reader may hold while waiting for
+ *   the prefetch to complete.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+static void rwb_pfworker(FAR void *arg)
+{
+	FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+	ssize_t ret;
+
+	ret = rwb->rhreload(rwb->dev, rwb->pfbuffer, rwb->pfblockstart, rwb->pfnblocks);
+	if (ret != rwb->pfnblocks) {
+		fdbg("ERROR: Prefetch of %d blocks at %ld failed: %d\n", rwb->pfnblocks, (long)rwb->pfblockstart, ret);
+		rwb->pfnblocks = 0;
+	}
+
+	rwb->pfbusy = false;
+	rwb_semgive(&rwb->pfsem);
+}
+
+/****************************************************************************
+ * Name: rwb_pfwait
+ *
+ * Assumptions:
+ *   The caller holds the rhsem semaphore.
+ *
+ ****************************************************************************/
+
+static void rwb_pfwait(FAR struct rwbuffer_s *rwb)
+{
+	while (rwb->pfbusy) {
+		rwb_semtake(&rwb->pfsem);
+	}
+}
+
+/****************************************************************************
+ * Name: rwb_pfstart
+ *
+ * Description:
+ *   Start reading the window that follows the read-ahead buffer, unless it
+ *   is already there or being read.
+ *
+ * Assumptions:
+ *   The caller holds the rhsem semaphore.
+ *
+ ****************************************************************************/
+
+static void rwb_pfstart(FAR struct rwbuffer_s *rwb)
+{
+	off_t startblock = rwb->rhblockstart + rwb->rhnblocks;
+	off_t endblock;
+	int ret;
+
+	if (rwb->pfbusy || rwb->rhnblocks == 0 || startblock >= rwb->nblocks) {
+		return;
+	}
+
+	if (rwb->pfnblocks > 0 && rwb->pfblockstart == startblock) {
+		return;
+	}
+
+	endblock = startblock + rwb->rhwindow;
+	if (endblock > rwb->nblocks) {
+		endblock = rwb->nblocks;
+	}
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	/* The media must be up to date before the worker reads it */
+
+	if (rwb->wrmaxblocks > 0) {
+		rwb_semtake(&rwb->wrsem);
+		if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, endblock - startblock)) {
+			rwb_wrflush(rwb);
+		}
+
+		rwb_semgive(&rwb->wrsem);
+	}
+#endif
+
+	/* Drop the completions that nobody waited for */
+
+	while (sem_trywait(&rwb->pfsem) == 0) ;
+
+	rwb->pfblockstart = startblock;
+	rwb->pfnblocks = endblock - startblock;
+	rwb->pfbusy = true;
+
+	ret = work_queue(LPWORK, &rwb->rhwork, rwb_pfworker, (FAR void *)rwb, 0);
+	if (ret < 0) {
+		fdbg("ERROR: Failed to queue the prefetch: %d\n", ret);
+		rwb->pfnblocks = 0;
+		rwb->pfbusy = false;
+	}
+}
+
+/****************************************************************************
+ * Name: rwb_pfswap
+ *
+ * Description:
+ *   Make the prefetch buffer the read-ahead buffer if it holds startblock.
+ *
+ * Assumptions:
+ *   The caller holds the rhsem semaphore and no prefetch is in progress.
+ *
+ ****************************************************************************/
+
+static bool rwb_pfswap(FAR struct rwbuffer_s *rwb, off_t startblock)
+{
+	uint8_t *buffer;
+
+	if (rwb->pfnblocks == 0 || startblock < rwb->pfblockstart || startblock >= rwb->pfblockstart + rwb->pfnblocks) {
+		return false;
+	}
+
+	buffer = rwb->rhbuffer;
+	rwb->rhbuffer = rwb->pfbuffer;
+	rwb->rhblockstart = rwb->pfblockstart;
+	rwb->rhnblocks = rwb->pfnblocks;
+	rwb->pfbuffer = buffer;
+	rwb->pfnblocks = 0;
+	return true;
+}
+
+/****************************************************************************
+ * Name: rwb_pfinvalidate
+ *
+ * Description:
+ *   Drop the prefetch buffer if it overlaps the given blocks.
+ *
+ * Assumptions:
+ *   The caller holds the rhsem semaphore.
+ *
+ ****************************************************************************/
+
+static void rwb_pfinvalidate(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
+{
+	rwb_pfwait(rwb);
+	if (rwb->pfnblocks > 0 && rwb_overlap(rwb->pfblockstart, rwb->pfnblocks, startblock, nblocks)) {
+		rwb->pfnblocks = 0;
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_invalidate_writebuffer
  *
@@ -527,7 +685,15 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, siz
 #if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
 {
-	int ret;
+	int ret = OK;
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+	if (rwb->rhmaxblocks > 0) {
+		rwb_semtake(&rwb->rhsem);
+		rwb_pfinvalidate(rwb, startblock, blockcount);
+		rwb_semgive(&rwb->rhsem);
+	}
+#endif
 
 	if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0) {
 		off_t rhbend;
@@ -627,6 +793,9 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 	DEBUGASSERT(rwb->rhreload != NULL);
 	rwb->rhbuffer = NULL;
 #endif
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+	rwb->pfbuffer = NULL;
+#endif
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
 	if (rwb->wrmaxblocks > 0) {
@@ -681,6 +850,26 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 		}
 
 		fvdbg("Read-ahead buffer size: %d bytes\n", allocsize);
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		/* The prefetch semaphore is used for signaling and, hence, should
+		 * not have priority inheritance enabled.
+		 */
+
+		sem_init(&rwb->pfsem, 0, 0);
+		sem_setprotocol(&rwb->pfsem, SEM_PRIO_NONE);
+
+		rwb->rhwindow = RWB_RHMINWINDOW(rwb);
+		rwb->rhexpected = (off_t)-1;
+		rwb->pfnblocks = 0;
+		rwb->pfbusy = false;
+
+		rwb->pfbuffer = kmm_malloc(allocsize);
+		if (!rwb->pfbuffer) {
+			fdbg("Prefetch buffer kmm_malloc(%d) failed\n", allocsize);
+			return -ENOMEM;
+		}
+#endif
 	}
 #endif							/* CONFIG_DRVR_READAHEAD */
 
@@ -705,6 +894,13 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 
 #ifdef CONFIG_DRVR_READAHEAD
 	if (rwb->rhmaxblocks > 0) {
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		rwb_pfwait(rwb);
+		sem_destroy(&rwb->pfsem);
+		if (rwb->pfbuffer) {
+			kmm_free(rwb->pfbuffer);
+		}
+#endif
 		sem_destroy(&rwb->rhsem);
 		if (rwb->rhbuffer) {
 			kmm_free(rwb->rhbuffer);
@@ -721,6 +917,9 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 {
 #ifdef CONFIG_DRVR_READAHEAD
 	uint32_t remaining;
+#endif
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+	bool sequential;
 #endif
 	int ret = OK;
 
@@ -752,6 +951,16 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 		/* Loop until we have read all of the requested blocks */
 
 		rwb_semtake(&rwb->rhsem);
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		/* A read that starts where the previous one ended continues a
+		 * stream.
+		 */
+
+		sequential = (startblock == rwb->rhexpected);
+		rwb->rhexpected = startblock + nblocks;
+#endif
+
 		for (remaining = nblocks; remaining > 0;) {
 			/* Is there anything in the read-ahead buffer? */
 
@@ -780,14 +989,39 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 			 */
 
 			if (remaining > 0) {
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+				/* The next window may already have been prefetched */
+
+				rwb_pfwait(rwb);
+				if (rwb_pfswap(rwb, startblock)) {
+					continue;
+				}
+
+				/* Grow the window while the stream goes on */
+
+				if (!sequential) {
+					rwb->rhwindow = RWB_RHMINWINDOW(rwb);
+				} else if (rwb->rhwindow < rwb->rhmaxblocks) {
+					rwb->rhwindow = rwb->rhwindow > rwb->rhmaxblocks / 2 ? rwb->rhmaxblocks : rwb->rhwindow * 2;
+				}
+#endif
 				ret = rwb_rhreload(rwb, startblock);
 				if (ret < 0) {
 					fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+					rwb_semgive(&rwb->rhsem);
 					return ret;
 				}
 			}
 		}
 
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		/* Read the next window while this one is consumed */
+
+		if (sequential) {
+			rwb_pfstart(rwb);
+		}
+#endif
+
 		/* On success, return the number of blocks that we were requested to
 		 * read. This is for compatibility with the normal return of a block
 		 * driver read method
@@ -796,7 +1030,7 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 		rwb_semgive(&rwb->rhsem);
 		ret = nblocks;
 	} else
-#else
+#endif
 	{
 		/* No read-ahead buffering, (re)load the data directly into
 		 * the user buffer.
@@ -804,9 +1038,8 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 
 		ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
 	}
-#endif
 
-		return ret;
+	return ret;
 }
 
 /****************************************************************************
@@ -829,6 +1062,9 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 		if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks)) {
 			rwb_resetrhbuffer(rwb);
 		}
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		rwb_pfinvalidate(rwb, startblock, nblocks);
+#endif
 
 		rwb_semgive(&rwb->rhsem);
 	}
@@ -861,7 +1097,7 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 		 * driver write method
 		 */
 	} else
-#else
+#endif
 	{
 		/* No write buffer.. just pass the write operation through via the
 		 * flush callback.
@@ -870,9 +1106,7 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 		ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
 	}
 
-#endif
-
-		return ret;
+	return ret;
 }
 
 /****************************************************************************
@@ -922,6 +1156,10 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 	if (rwb->rhmaxblocks > 0) {
 		rwb_semtake(&rwb->rhsem);
 		rwb_resetrhbuffer(rwb);
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+		rwb_pfinvalidate(rwb, 0, rwb->nblocks);
+		rwb->rhexpected = (off_t)-1;
+#endif
 		rwb_semgive(&rwb->rhsem);
 	}
 #endif
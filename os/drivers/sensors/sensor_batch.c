@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/sensors/sensor_batch.c
+ *
+ * Batching of sensors with hardware FIFOs.  The driver reports the FIFO
+ * watermark interrupt, the FIFO is then drained on the low priority work
+ * queue with as few bus transfers as the driver can manage and the samples
+ * are time stamped and kept in a ring until the application reads them.
+ *
+ * The sensor does not time stamp its samples, so they are spread evenly
+ * back from the time of the drain.  The period is measured from one drain
+ * to the next, which follows the actual sensor clock; only the first batch
+ * uses the nominal period.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/sensors/sensor.h>
+#include <tinyara/sensors/sensor_batch.h>
+
+#ifdef CONFIG_SENSOR_BATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SENSOR_BATCH_MASK    (CONFIG_SENSOR_BATCH_NSAMPLES - 1)
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#define SENSOR_BATCH_CLOCK   CLOCK_MONOTONIC
+#else
+#define SENSOR_BATCH_CLOCK   CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void sensor_batch_takesem(sem_t *sem)
+{
+	while (sem_wait(sem) != OK) {
+		ASSERT(errno == EINTR);
+	}
+}
+
+static int64_t sensor_batch_ns(const struct timespec *ts)
+{
+	return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/* Wake up all readers waiting for samples.  Called with exclsem held. */
+
+static void sensor_batch_wakeup(struct sensor_batch_s *sb)
+{
+	while (sb->nwaiters > 0) {
+		sb->nwaiters--;
+		sem_post(&sb->waitsem);
+	}
+}
+
+/* Time stamp the samples in [start, sb->tail), the newest one with 'now' */
+
+static void sensor_batch_stamp(struct sensor_batch_s *sb, uint16_t start, int nread)
+{
+	struct timespec now;
+	int64_t period;
+	int64_t t;
+	uint16_t i;
+
+	clock_gettime(SENSOR_BATCH_CLOCK, &now);
+
+	if (sb->havelast) {
+		period = (sensor_batch_ns(&now) - sensor_batch_ns(&sb->last)) / nread;
+	} else {
+		period = sb->period_ns;
+	}
+
+	t = sensor_batch_ns(&now);
+	for (i = sb->tail; i != start; t -= period) {
+		i--;
+		sb->ts[i & SENSOR_BATCH_MASK].tv_sec = t / NSEC_PER_SEC;
+		sb->ts[i & SENSOR_BATCH_MASK].tv_nsec = t % NSEC_PER_SEC;
+	}
+
+	sb->last = now;
+	sb->havelast = true;
+}
+
+static void sensor_batch_worker(FAR void *arg)
+{
+	struct sensor_batch_s *sb = (struct sensor_batch_s *)arg;
+	sensor_operations_t *ops = sb->sensor->ops;
+	uint16_t start;
+	int nread = 0;
+	int space;
+	int nfree;
+	int ret;
+
+	sensor_batch_takesem(&sb->exclsem);
+
+	if (!sb->active) {
+		sem_post(&sb->exclsem);
+		return;
+	}
+
+	/* Drain the hardware FIFO straight into the ring.  Each call reads as
+	 * many samples as fit before the ring wraps; a short read means that the
+	 * FIFO is empty.
+	 */
+
+	start = sb->tail;
+	do {
+		nfree = CONFIG_SENSOR_BATCH_NSAMPLES - (uint16_t)(sb->tail - sb->head);
+		if (nfree == 0) {
+			/* Drop the oldest samples rather than leave the FIFO undrained */
+
+			sb->head += sb->watermark;
+			sb->dropped += sb->watermark;
+			if ((int16_t)(start - sb->head) < 0) {
+				start = sb->head;
+			}
+
+			nfree = sb->watermark;
+		}
+
+		space = CONFIG_SENSOR_BATCH_NSAMPLES - (sb->tail & SENSOR_BATCH_MASK);
+		if (space > nfree) {
+			space = nfree;
+		}
+
+		ret = ops->fifo_read(sb->sensor, &sb->data[sb->tail & SENSOR_BATCH_MASK], space);
+		if (ret < 0) {
+			SENSOR_DEBUG("fifo_read failed: %d\n", ret);
+			break;
+		}
+
+		sb->tail += ret;
+		nread += ret;
+	} while (ret == space);
+
+	if (nread > 0) {
+		sensor_batch_stamp(sb, start, nread);
+		sensor_batch_wakeup(sb);
+	}
+
+	sem_post(&sb->exclsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int sensor_batch_start(struct sensor_batch_s *sb, sensor_device_t *sensor, int watermark, uint32_t period_us)
+{
+	int ret;
+
+	if (sb == NULL || sensor == NULL || sensor->ops == NULL) {
+		return -EINVAL;
+	}
+
+	if (sensor->ops->fifo_config == NULL || sensor->ops->fifo_read == NULL) {
+		return -ENOSYS;
+	}
+
+	if (watermark <= 0 || watermark > CONFIG_SENSOR_BATCH_NSAMPLES) {
+		return -EINVAL;
+	}
+
+	if (sensor->batch != NULL) {
+		return -EBUSY;
+	}
+
+	memset(sb, 0, sizeof(struct sensor_batch_s));
+	sb->sensor = sensor;
+	sb->watermark = watermark;
+	sb->period_ns = period_us * 1000;
+	sb->active = true;
+
+	sem_init(&sb->exclsem, 0, 1);
+	sem_init(&sb->waitsem, 0, 0);
+	sem_setprotocol(&sb->waitsem, SEM_PRIO_NONE);
+
+	sensor->batch = sb;
+
+	ret = sensor->ops->fifo_config(sensor, watermark);
+	if (ret < 0) {
+		sensor->batch = NULL;
+		sem_destroy(&sb->exclsem);
+		sem_destroy(&sb->waitsem);
+		return ret;
+	}
+
+	return OK;
+}
+
+int sensor_batch_stop(struct sensor_batch_s *sb)
+{
+	sensor_device_t *sensor = sb->sensor;
+	int ret;
+
+	sensor_batch_takesem(&sb->exclsem);
+	sb->active = false;
+	sem_post(&sb->exclsem);
+
+	ret = sensor->ops->fifo_config(sensor, 0);
+	sensor->batch = NULL;
+	work_cancel(LPWORK, &sb->work);
+
+	/* Readers waiting on an empty ring return with no samples */
+
+	sensor_batch_takesem(&sb->exclsem);
+	sensor_batch_wakeup(sb);
+	sem_post(&sb->exclsem);
+
+	return ret;
+}
+
+int sensor_batch_read(struct sensor_batch_s *sb, sensor_data_t *data, struct timespec *ts, int nsamples)
+{
+	uint16_t head;
+	int nread;
+	int n;
+
+	if (nsamples <= 0) {
+		return 0;
+	}
+
+	sensor_batch_takesem(&sb->exclsem);
+
+	while (sb->head == sb->tail) {
+		if (!sb->active) {
+			sem_post(&sb->exclsem);
+			return 0;
+		}
+
+		sb->nwaiters++;
+		sem_post(&sb->exclsem);
+
+		if (sem_wait(&sb->waitsem) != OK) {
+			return -get_errno();
+		}
+
+		sensor_batch_takesem(&sb->exclsem);
+	}
+
+	/* Copy out in at most two runs, split where the ring wraps */
+
+	nread = (uint16_t)(sb->tail - sb->head);
+	if (nread > nsamples) {
+		nread = nsamples;
+	}
+
+	head = sb->head;
+	for (n = 0; n < nread; ) {
+		int run = CONFIG_SENSOR_BATCH_NSAMPLES - (head & SENSOR_BATCH_MASK);
+
+		if (run > nread - n) {
+			run = nread - n;
+		}
+
+		memcpy(&data[n], &sb->data[head & SENSOR_BATCH_MASK], run * sizeof(sensor_data_t));
+		if (ts != NULL) {
+			memcpy(&ts[n], &sb->ts[head & SENSOR_BATCH_MASK], run * sizeof(struct timespec));
+		}
+
+		head += run;
+		n += run;
+	}
+
+	sb->head = head;
+	sem_post(&sb->exclsem);
+
+	return nread;
+}
+
+void sensor_batch_notify(sensor_device_t *sensor)
+{
+	struct sensor_batch_s *sb = sensor->batch;
+
+	if (sb != NULL && sb->active && work_available(&sb->work)) {
+		(void)work_queue(LPWORK, &sb->work, sensor_batch_worker, sb, 0);
+	}
+}
+
+#endif							/* CONFIG_SENSOR_BATCH */
@@ -71,6 +71,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/compiler.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/semaphore.h>
 #include <tinyara/fs/fs.h>
@@ -81,25 +82,111 @@
 #ifdef CONFIG_RAMLOG
 
 /****************************************************************************
- * Private Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#define RAMLOG_MAGIC 0x524c4f47	/* "RLOG" */
+
+#ifdef CONFIG_RAMLOG_COMPRESS
+#define RAMLOG_ZCHUNK     CONFIG_RAMLOG_COMPRESS_CHUNK
+#define RAMLOG_ZHASHBITS  8
+
+/* Worst-case size of a compressed chunk and the ring space of a record */
+
+#define RAMLOG_ZBOUND     (RAMLOG_ZCHUNK + RAMLOG_ZCHUNK / 255 + 16)
+#define RAMLOG_ZSIZE(n)   (sizeof(struct ramlog_zhdr_s) + (((n) + 3) & ~3))
+
+#if (RAMLOG_ZCHUNK & (RAMLOG_ZCHUNK - 1)) != 0
+#error CONFIG_RAMLOG_COMPRESS_CHUNK must be a power of two
+#endif
+
+#if CONFIG_RAMLOG_COMPRESS_BUFSIZE < 2 * (RAMLOG_ZBOUND + 8)
+#error CONFIG_RAMLOG_COMPRESS_BUFSIZE must hold at least two compressed chunks
+#endif
+
+#define LZ4_MINMATCH      4
+#define LZ4_RUNMASK       15
+#define LZ4_LASTLITERALS  5
+#define LZ4_MFLIMIT       12
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The log is addressed by free-running 32-bit byte positions.  rl_head is
+ * the position after the newest byte and rl_tail that of the oldest byte
+ * still in the buffer, so rl_head - rl_tail is the amount of data.  Each
+ * open file has its own read position; reading does not remove anything.
+ */
+
+struct ramlog_reader_s {
+	FAR struct ramlog_reader_s *rr_flink;	/* Next open reader */
+	volatile uint32_t rr_pos;	/* Position of the next byte to read */
+};
+
+/* With CONFIG_RAMLOG_COMPRESS, the output that is about to be overwritten
+ * is LZ4-compressed chunk by chunk into a second ring, which holds the
+ * contiguous range [zl_tail, zl_head).  zl_head is never behind rl_tail,
+ * so together with the plain buffer the log reaches back to zl_tail.
+ * Chunks are aligned to RAMLOG_ZCHUNK positions and each is stored as a
+ * header followed by the LZ4 block.  A record never wraps around the end
+ * of the ring; zl_wrapndx marks where the older part of the ring ends.
+ */
+
+#ifdef CONFIG_RAMLOG_COMPRESS
+struct ramlog_zhdr_s {
+	uint32_t zh_pos;			/* Position of the first byte of the chunk */
+	uint16_t zh_rawlen;			/* Size of the chunk */
+	uint16_t zh_zlen;			/* Size of the LZ4 block that follows */
+};
+
+struct ramlog_zlog_s {
+	uint32_t zl_head;			/* Position after the newest compressed byte */
+	uint32_t zl_tail;			/* Position of the oldest compressed byte */
+	size_t zl_nrec;				/* Number of records in the ring */
+	size_t zl_headndx;			/* Ring index of the next record */
+	size_t zl_tailndx;			/* Ring index of the oldest record */
+	size_t zl_wrapndx;			/* Ring index where the records wrap to 0 */
+
+	/* Last chunk decompressed for a reader, protected by rl_exclsem */
+
+	uint32_t zl_cachepos;
+	size_t zl_cachelen;
+	uint8_t zl_cache[RAMLOG_ZCHUNK];
+
+	/* Compressor work areas, only used with interrupts disabled */
+
+	uint8_t zl_in[RAMLOG_ZCHUNK];
+	uint8_t zl_out[RAMLOG_ZBOUND];
+	uint16_t zl_hash[1 << RAMLOG_ZHASHBITS];
+
+	uint32_t zl_buffer[CONFIG_RAMLOG_COMPRESS_BUFSIZE / 4];
+};
+#endif
+
 struct ramlog_dev_s {
 #ifndef CONFIG_RAMLOG_NONBLOCKING
 	volatile uint8_t rl_nwaiters;	/* Number of threads waiting for data */
 #endif
-	volatile uint16_t rl_head;	/* The head index (where data is added) */
-	volatile uint16_t rl_tail;	/* The tail index (where data is removed) */
+	volatile uint32_t rl_head;	/* Position after the newest byte */
+	volatile uint32_t rl_tail;	/* Position of the oldest byte kept */
 	sem_t rl_exclsem;			/* Enforces mutually exclusive access */
 #ifndef CONFIG_RAMLOG_NONBLOCKING
 	sem_t rl_waitsem;			/* Used to wait for data */
 #endif
 	size_t rl_bufsize;			/* Size of the RAM buffer */
 	FAR char *rl_buffer;		/* Circular RAM buffer */
+#ifdef CONFIG_RAMLOG_COMPRESS
+	FAR struct ramlog_zlog_s *rl_zlog;	/* Compressed history or NULL */
+#endif
+	size_t rl_headndx;			/* Buffer index of rl_head */
+
+	/* The open readers.  The list is only changed with interrupts disabled
+	 * because ramlog_addbuf() walks it from interrupt handlers.
+	 */
+
+	FAR struct ramlog_reader_s *rl_readers;
 
 	/* The following is a list if poll structures of threads waiting for
 	 * driver events. The 'struct pollfd' reference for each open is also
@@ -109,6 +196,11 @@ struct ramlog_dev_s {
 #ifndef CONFIG_DISABLE_POLL
 	struct pollfd *rl_fds[CONFIG_RAMLOG_NPOLLWAITERS];
 #endif
+
+#ifdef CONFIG_RAMLOG_PERSIST
+	uint32_t rl_magic;			/* RAMLOG_MAGIC once initialized */
+	uint32_t rl_check;			/* Check value of the indices */
+#endif
 };
 
 /****************************************************************************
@@ -119,10 +211,17 @@ struct ramlog_dev_s {
 #ifndef CONFIG_DISABLE_POLL
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv, pollevent_t eventset);
 #endif
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+static size_t ramlog_index(FAR struct ramlog_dev_s *priv, uint32_t pos);
+static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv, FAR const char *buffer, size_t len);
+#ifdef CONFIG_RAMLOG_COMPRESS
+static void ramlog_zsave(FAR struct ramlog_dev_s *priv, uint32_t tail);
+static size_t ramlog_zread(FAR struct ramlog_dev_s *priv, FAR struct ramlog_reader_s *reader, FAR char *buffer, size_t len);
+#endif
 
 /* Character driver methods */
 
+static int ramlog_open(FAR struct file *filep);
+static int ramlog_close(FAR struct file *filep);
 static ssize_t ramlog_read(FAR struct file *, FAR char *, size_t);
 static ssize_t ramlog_write(FAR struct file *, FAR const char *, size_t);
 #ifndef CONFIG_DISABLE_POLL
@@ -134,8 +233,8 @@ static int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setu
  ****************************************************************************/
 
 static const struct file_operations g_ramlogfops = {
-	0,							/* open */
-	0,							/* close */
+	ramlog_open,				/* open */
+	ramlog_close,				/* close */
 	ramlog_read,				/* read */
 	ramlog_write,				/* write */
 	0,							/* seek */
@@ -150,7 +249,22 @@ static const struct file_operations g_ramlogfops = {
  */
 
 #if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+#ifdef CONFIG_RAMLOG_PERSIST
+/* The buffer and the device are kept across warm resets.  They are set up
+ * on first use after each boot, see ramlog_sysdev().
+ */
+
+static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE] noinit_data;
+static struct ramlog_dev_s g_sysdev noinit_data;
+static bool g_sysinit;
+#ifdef CONFIG_RAMLOG_COMPRESS
+static struct ramlog_zlog_s g_syszlog;
+#endif
+#else
 static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE];
+#ifdef CONFIG_RAMLOG_COMPRESS
+static struct ramlog_zlog_s g_syszlog;
+#endif
 
 /* This is the device structure for the console or syslogging function.  It
  * must be statically initialized because the RAMLOG syslog_putc function
@@ -169,8 +283,12 @@ static struct ramlog_dev_s g_sysdev = {
 #endif
 	CONFIG_RAMLOG_BUFSIZE,		/* rl_bufsize */
 	g_sysbuffer					/* rl_buffer */
+#ifdef CONFIG_RAMLOG_COMPRESS
+	, &g_syszlog				/* rl_zlog */
+#endif
 };
 #endif
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -206,46 +324,668 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv, pollevent_t eventse
 #endif
 
 /****************************************************************************
- * Name: ramlog_addchar
+ * Name: ramlog_sysdev
+ *
+ * Description:
+ *   Return the console/syslog device.  With CONFIG_RAMLOG_PERSIST it lives
+ *   in memory that is not cleared at start-up, so on first use after each
+ *   boot the semaphores and readers are reset and the log of the previous
+ *   boot is kept if its indices are intact.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+#ifdef CONFIG_RAMLOG_PERSIST
+static uint32_t ramlog_check(FAR struct ramlog_dev_s *priv)
+{
+	return RAMLOG_MAGIC ^ priv->rl_head ^ ~priv->rl_tail ^ (uint32_t)priv->rl_headndx;
+}
+
+static FAR struct ramlog_dev_s *ramlog_sysdev(void)
+{
+	FAR struct ramlog_dev_s *priv = &g_sysdev;
+	irqstate_t flags;
+
+	if (!g_sysinit) {
+		flags = irqsave();
+		if (!g_sysinit) {
+			if (priv->rl_magic != RAMLOG_MAGIC || priv->rl_check != ramlog_check(priv) || priv->rl_bufsize != CONFIG_RAMLOG_BUFSIZE || priv->rl_buffer != g_sysbuffer || priv->rl_headndx >= CONFIG_RAMLOG_BUFSIZE || priv->rl_head - priv->rl_tail > CONFIG_RAMLOG_BUFSIZE) {
+				/* Cold boot or a damaged log: start empty */
+
+				priv->rl_head = 0;
+				priv->rl_tail = 0;
+				priv->rl_headndx = 0;
+			}
+
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+			priv->rl_nwaiters = 0;
+			sem_init(&priv->rl_waitsem, 0, 0);
+			sem_setprotocol(&priv->rl_waitsem, SEM_PRIO_NONE);
+#endif
+			sem_init(&priv->rl_exclsem, 0, 1);
+			priv->rl_bufsize = CONFIG_RAMLOG_BUFSIZE;
+			priv->rl_buffer = g_sysbuffer;
+#ifdef CONFIG_RAMLOG_COMPRESS
+			/* The compressed history is not kept across resets */
+
+			priv->rl_zlog = &g_syszlog;
+#endif
+			priv->rl_readers = NULL;
+#ifndef CONFIG_DISABLE_POLL
+			memset(priv->rl_fds, 0, sizeof(priv->rl_fds));
+#endif
+			priv->rl_magic = RAMLOG_MAGIC;
+			priv->rl_check = ramlog_check(priv);
+			g_sysinit = true;
+		}
+		irqrestore(flags);
+	}
+
+	return priv;
+}
+#else
+#define ramlog_sysdev() (&g_sysdev)
+#endif
+#endif
+
+/****************************************************************************
+ * Name: ramlog_index
+ *
+ * Description:
+ *   Return the buffer index of a position that is still in the log.  The
+ *   index is derived from that of rl_head rather than taken modulo the
+ *   buffer size, so the positions may wrap around.
+ *
+ ****************************************************************************/
+
+static size_t ramlog_index(FAR struct ramlog_dev_s *priv, uint32_t pos)
+{
+	size_t dist = priv->rl_head - pos;
+
+	if (dist <= priv->rl_headndx) {
+		return priv->rl_headndx - dist;
+	}
+
+	return priv->rl_headndx + priv->rl_bufsize - dist;
+}
+
+/****************************************************************************
+ * Name: ramlog_lz4_compress
+ *
+ * Description:
+ *   Encode len bytes at src as one LZ4 block (the format that
+ *   fs/cromfs decodes) at dst, which must hold RAMLOG_ZBOUND bytes.  A
+ *   greedy parse with a single hash table entry per 4-byte prefix is
+ *   plenty for log text.  Returns the size of the block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_COMPRESS
+static inline uint32_t ramlog_lz4_read32(FAR const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static FAR uint8_t *ramlog_lz4_length(FAR uint8_t *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+
+	*op++ = (uint8_t)len;
+	return op;
+}
+
+static size_t ramlog_lz4_compress(FAR const uint8_t *src, size_t len, FAR uint8_t *dst, FAR uint16_t *hash)
+{
+	FAR const uint8_t *iend = src + len;
+	FAR const uint8_t *ip = src;
+	FAR const uint8_t *anchor = src;
+	FAR const uint8_t *ref;
+	FAR uint8_t *op = dst;
+	FAR uint8_t *token;
+	uint32_t seq;
+	size_t nlit;
+	size_t mlen;
+	unsigned int h;
+
+	memset(hash, 0, sizeof(uint16_t) << RAMLOG_ZHASHBITS);
+
+	/* A match must start at least LZ4_MFLIMIT bytes before the end and the
+	 * last LZ4_LASTLITERALS bytes must be literals.
+	 */
+
+	while (len > LZ4_MFLIMIT && ip <= iend - LZ4_MFLIMIT) {
+		seq = ramlog_lz4_read32(ip);
+		h = (seq * 2654435761u) >> (32 - RAMLOG_ZHASHBITS);
+		ref = src + hash[h];
+		hash[h] = (uint16_t)(ip - src);
+
+		if (ref >= ip || ramlog_lz4_read32(ref) != seq) {
+			ip++;
+			continue;
+		}
+
+		mlen = LZ4_MINMATCH;
+		while (ip + mlen < iend - LZ4_LASTLITERALS && ref[mlen] == ip[mlen]) {
+			mlen++;
+		}
+
+		/* Emit the literals since the last match, then the match */
+
+		nlit = ip - anchor;
+		token = op++;
+		if (nlit >= LZ4_RUNMASK) {
+			*token = LZ4_RUNMASK << 4;
+			op = ramlog_lz4_length(op, nlit - LZ4_RUNMASK);
+		} else {
+			*token = (uint8_t)(nlit << 4);
+		}
+
+		memcpy(op, anchor, nlit);
+		op += nlit;
+
+		*op++ = (uint8_t)(ip - ref);
+		*op++ = (uint8_t)((ip - ref) >> 8);
+
+		if (mlen - LZ4_MINMATCH >= LZ4_RUNMASK) {
+			*token |= LZ4_RUNMASK;
+			op = ramlog_lz4_length(op, mlen - LZ4_MINMATCH - LZ4_RUNMASK);
+		} else {
+			*token |= (uint8_t)(mlen - LZ4_MINMATCH);
+		}
+
+		ip += mlen;
+		anchor = ip;
+	}
+
+	/* The last sequence has literals only */
+
+	nlit = iend - anchor;
+	token = op++;
+	if (nlit >= LZ4_RUNMASK) {
+		*token = LZ4_RUNMASK << 4;
+		op = ramlog_lz4_length(op, nlit - LZ4_RUNMASK);
+	} else {
+		*token = (uint8_t)(nlit << 4);
+	}
+
+	memcpy(op, anchor, nlit);
+	op += nlit;
+
+	return op - dst;
+}
+
+/****************************************************************************
+ * Name: ramlog_lz4_decompress
+ *
+ * Description:
+ *   Decode the LZ4 block of srclen bytes at src into at most dstlen bytes
+ *   at dst.  Returns the number of bytes decoded, or -EIO if the block
+ *   does not fit.
+ *
+ ****************************************************************************/
+
+static int ramlog_lz4_decompress(FAR const uint8_t *src, size_t srclen, FAR uint8_t *dst, size_t dstlen)
+{
+	FAR const uint8_t *iend = src + srclen;
+	FAR const uint8_t *ip = src;
+	FAR uint8_t *oend = dst + dstlen;
+	FAR uint8_t *op = dst;
+	FAR const uint8_t *match;
+	size_t offset;
+	size_t len;
+	uint8_t token;
+	uint8_t b;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		len = token >> 4;
+		if (len == LZ4_RUNMASK) {
+			do {
+				if (ip >= iend) {
+					return -EIO;
+				}
+
+				b = *ip++;
+				len += b;
+			} while (b == 255);
+		}
+
+		if (len > (size_t)(iend - ip) || len > (size_t)(oend - op)) {
+			return -EIO;
+		}
+
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		if (ip >= iend) {
+			break;
+		}
+
+		if (iend - ip < 2) {
+			return -EIO;
+		}
+
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -EIO;
+		}
+
+		len = token & LZ4_RUNMASK;
+		if (len == LZ4_RUNMASK) {
+			do {
+				if (ip >= iend) {
+					return -EIO;
+				}
+
+				b = *ip++;
+				len += b;
+			} while (b == 255);
+		}
+
+		len += LZ4_MINMATCH;
+		if (len > (size_t)(oend - op)) {
+			return -EIO;
+		}
+
+		/* The match may overlap the bytes being written */
+
+		match = op - offset;
+		while (len-- > 0) {
+			*op++ = *match++;
+		}
+	}
+
+	return (int)(op - dst);
+}
+
+/****************************************************************************
+ * Name: ramlog_zreset
+ *
+ * Description:
+ *   Empty the compressed history so that it continues at pos.
+ *
+ ****************************************************************************/
+
+static void ramlog_zreset(FAR struct ramlog_zlog_s *zlog, uint32_t pos)
+{
+	zlog->zl_head = pos;
+	zlog->zl_tail = pos;
+	zlog->zl_nrec = 0;
+	zlog->zl_headndx = 0;
+	zlog->zl_tailndx = 0;
+	zlog->zl_wrapndx = sizeof(zlog->zl_buffer);
+}
+
+/****************************************************************************
+ * Name: ramlog_zappend
+ *
+ * Description:
+ *   Store the zlen bytes in zl_out as the record of the rawlen bytes at
+ *   pos, dropping the oldest records until there is room.
+ *
+ ****************************************************************************/
+
+static void ramlog_zappend(FAR struct ramlog_zlog_s *zlog, uint32_t pos, size_t rawlen, size_t zlen)
+{
+	FAR uint8_t *ring = (FAR uint8_t *)zlog->zl_buffer;
+	FAR struct ramlog_zhdr_s *hdr;
+	size_t need = RAMLOG_ZSIZE(zlen);
+
+	for (;;) {
+		if (zlog->zl_nrec == 0) {
+			ramlog_zreset(zlog, pos);
+			break;
+		}
+
+		if (zlog->zl_headndx > zlog->zl_tailndx) {
+			/* Free space from zl_headndx to the end and before zl_tailndx */
+
+			if (sizeof(zlog->zl_buffer) - zlog->zl_headndx >= need) {
+				break;
+			}
+
+			zlog->zl_wrapndx = zlog->zl_headndx;
+			zlog->zl_headndx = 0;
+		} else if (zlog->zl_tailndx - zlog->zl_headndx >= need) {
+			/* Free space from zl_headndx to zl_tailndx */
+
+			break;
+		} else {
+			/* Drop the oldest record */
+
+			hdr = (FAR struct ramlog_zhdr_s *)&ring[zlog->zl_tailndx];
+			zlog->zl_tailndx += RAMLOG_ZSIZE(hdr->zh_zlen);
+			if (zlog->zl_tailndx == zlog->zl_wrapndx) {
+				zlog->zl_tailndx = 0;
+				zlog->zl_wrapndx = sizeof(zlog->zl_buffer);
+			}
+
+			if (--zlog->zl_nrec > 0) {
+				hdr = (FAR struct ramlog_zhdr_s *)&ring[zlog->zl_tailndx];
+				zlog->zl_tail = hdr->zh_pos;
+			}
+		}
+	}
+
+	hdr = (FAR struct ramlog_zhdr_s *)&ring[zlog->zl_headndx];
+	hdr->zh_pos = pos;
+	hdr->zh_rawlen = (uint16_t)rawlen;
+	hdr->zh_zlen = (uint16_t)zlen;
+	memcpy(hdr + 1, zlog->zl_out, zlen);
+
+	zlog->zl_headndx += need;
+	zlog->zl_nrec++;
+}
+
+/****************************************************************************
+ * Name: ramlog_zsave
+ *
+ * Description:
+ *   Compress the log up to the position tail before the caller drops it
+ *   from the plain buffer.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void ramlog_zsave(FAR struct ramlog_dev_s *priv, uint32_t tail)
+{
+	FAR struct ramlog_zlog_s *zlog = priv->rl_zlog;
+	uint32_t start;
+	uint32_t end;
+	size_t ndx;
+	size_t len;
+	size_t nfirst;
+	size_t zlen;
+
+	if (zlog->zl_nrec == 0 || (int32_t)(zlog->zl_head - priv->rl_tail) < 0) {
+		ramlog_zreset(zlog, priv->rl_tail);
+	}
+
+	while ((int32_t)(zlog->zl_head - tail) < 0) {
+		/* Compress up to the next chunk boundary, or all there is */
+
+		start = zlog->zl_head;
+		end = (start | (RAMLOG_ZCHUNK - 1)) + 1;
+		if ((int32_t)(end - priv->rl_head) > 0) {
+			end = priv->rl_head;
+		}
+
+		len = end - start;
+		ndx = ramlog_index(priv, start);
+		nfirst = priv->rl_bufsize - ndx;
+		if (nfirst > len) {
+			nfirst = len;
+		}
+
+		memcpy(zlog->zl_in, &priv->rl_buffer[ndx], nfirst);
+		memcpy(&zlog->zl_in[nfirst], priv->rl_buffer, len - nfirst);
+
+		zlen = ramlog_lz4_compress(zlog->zl_in, len, zlog->zl_out, zlog->zl_hash);
+		ramlog_zappend(zlog, start, len, zlen);
+		zlog->zl_head = end;
+	}
+}
+
+/****************************************************************************
+ * Name: ramlog_zread
+ *
+ * Description:
+ *   Read from the compressed history if the reader is positioned before
+ *   the plain buffer.  Returns the number of bytes read, which is zero
+ *   when the data must come from the plain buffer.  Called with
+ *   rl_exclsem held.
+ *
+ ****************************************************************************/
+
+static size_t ramlog_zread(FAR struct ramlog_dev_s *priv, FAR struct ramlog_reader_s *reader, FAR char *buffer, size_t len)
+{
+	FAR struct ramlog_zlog_s *zlog = priv->rl_zlog;
+	FAR uint8_t *ring;
+	FAR struct ramlog_zhdr_s *hdr;
+	irqstate_t flags;
+	uint32_t pos;
+	size_t ndx;
+	size_t ncopy;
+	size_t i;
+
+	if (zlog == NULL) {
+		return 0;
+	}
+
+	pos = reader->rr_pos;
+	if (pos - zlog->zl_cachepos >= zlog->zl_cachelen) {
+		/* Decompress the chunk with interrupts disabled, as the writer may
+		 * otherwise drop it from the ring meanwhile.
+		 */
+
+		ring = (FAR uint8_t *)zlog->zl_buffer;
+		zlog->zl_cachelen = 0;
+
+		flags = irqsave();
+		if (zlog->zl_nrec == 0 || (int32_t)(pos - priv->rl_tail) >= 0) {
+			irqrestore(flags);
+			return 0;
+		}
+
+		if ((int32_t)(pos - zlog->zl_tail) < 0) {
+			pos = zlog->zl_tail;
+		}
+
+		ndx = zlog->zl_tailndx;
+		for (i = 0; i < zlog->zl_nrec; i++) {
+			hdr = (FAR struct ramlog_zhdr_s *)&ring[ndx];
+			if (pos - hdr->zh_pos < hdr->zh_rawlen) {
+				if (ramlog_lz4_decompress((FAR uint8_t *)(hdr + 1), hdr->zh_zlen, zlog->zl_cache, RAMLOG_ZCHUNK) == hdr->zh_rawlen) {
+					zlog->zl_cachepos = hdr->zh_pos;
+					zlog->zl_cachelen = hdr->zh_rawlen;
+				}
+
+				break;
+			}
+
+			ndx += RAMLOG_ZSIZE(hdr->zh_zlen);
+			if (ndx == zlog->zl_wrapndx) {
+				ndx = 0;
+			}
+		}
+
+		irqrestore(flags);
+
+		if (zlog->zl_cachelen == 0) {
+			return 0;
+		}
+	}
+
+	ndx = pos - zlog->zl_cachepos;
+	ncopy = zlog->zl_cachelen - ndx;
+	if (ncopy > len) {
+		ncopy = len;
+	}
+
+	memcpy(buffer, &zlog->zl_cache[ndx], ncopy);
+	reader->rr_pos = pos + ncopy;
+	return ncopy;
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_addbuf
+ *
+ * Description:
+ *   Append a block of data to the log.  May be called from an interrupt
+ *   handler.  Returns the number of bytes added, or -EBUSY if nothing could
+ *   be added.
+ *
  ****************************************************************************/
 
-static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
+static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv, FAR const char *buffer, size_t len)
 {
+#ifndef CONFIG_RAMLOG_UPDATE_LATEST
+	FAR struct ramlog_reader_s *reader;
+	uint32_t oldest;
+	uint32_t pos;
+#endif
 	irqstate_t flags;
-	int nexthead;
+	size_t nfirst;
+
+	if (len == 0) {
+		return 0;
+	}
 
 	/* Disable interrupts (in case we are NOT called from interrupt handler) */
 
 	flags = irqsave();
 
-	/* Calculate the write index AFTER the next byte is written */
+#ifdef CONFIG_RAMLOG_UPDATE_LATEST
+	/* Only the newest part of an oversized block can be kept */
 
-	nexthead = priv->rl_head + 1;
-	if (nexthead >= priv->rl_bufsize) {
-		nexthead = 0;
+	if (len > priv->rl_bufsize) {
+		buffer += len - priv->rl_bufsize;
+		len = priv->rl_bufsize;
 	}
+#else
+	/* Do not overwrite anything that an open reader has not read yet.  With
+	 * no readers the oldest data gives way as usual.
+	 */
 
-	/* Would the next write overflow the circular buffer? */
+	oldest = priv->rl_head;
+	for (reader = priv->rl_readers; reader; reader = reader->rr_flink) {
+		pos = reader->rr_pos;
+		if ((int32_t)(pos - priv->rl_tail) < 0) {
+			pos = priv->rl_tail;
+		}
 
-	if (nexthead == priv->rl_tail) {
-		/* Yes... */
-#ifdef CONFIG_RAMLOG_UPDATE_LATEST
-		/* Increment the tail index. It means that a byte in buffer is removed. */
-		if (++priv->rl_tail >= priv->rl_bufsize) {
-			priv->rl_tail = 0;
+		if ((int32_t)(pos - oldest) < 0) {
+			oldest = pos;
+		}
+	}
+
+	if (len > priv->rl_bufsize - (priv->rl_head - oldest)) {
+		len = priv->rl_bufsize - (priv->rl_head - oldest);
+		if (len == 0) {
+			/* Return an indication that nothing was saved in the buffer. */
+
+			irqrestore(flags);
+			return -EBUSY;
+		}
+	}
+#endif
+
+	/* Drop the oldest bytes to make room.  Readers that were behind them
+	 * skip ahead to rl_tail on their next read, or read them from the
+	 * compressed history.
+	 */
+
+	if (priv->rl_head + len - priv->rl_tail > priv->rl_bufsize) {
+#ifdef CONFIG_RAMLOG_COMPRESS
+		if (priv->rl_zlog) {
+			ramlog_zsave(priv, priv->rl_head + len - priv->rl_bufsize);
 		}
-#else
-		/* Return an indication that nothing was saved in the buffer. */
-		irqrestore(flags);
-		return -EBUSY;
 #endif
+		priv->rl_tail = priv->rl_head + len - priv->rl_bufsize;
 	}
 
-	/* No... copy the byte and re-enable interrupts */
+	/* Copy the block in at most two pieces, split where the buffer wraps */
 
-	priv->rl_buffer[priv->rl_head] = ch;
-	priv->rl_head = nexthead;
+	nfirst = priv->rl_bufsize - priv->rl_headndx;
+	if (nfirst > len) {
+		nfirst = len;
+	}
+
+	memcpy(&priv->rl_buffer[priv->rl_headndx], buffer, nfirst);
+	memcpy(priv->rl_buffer, &buffer[nfirst], len - nfirst);
+
+	priv->rl_headndx += len;
+	if (priv->rl_headndx >= priv->rl_bufsize) {
+		priv->rl_headndx -= priv->rl_bufsize;
+	}
+
+	priv->rl_head += len;
+#ifdef CONFIG_RAMLOG_PERSIST
+	priv->rl_check = ramlog_check(priv);
+#endif
 	irqrestore(flags);
+	return len;
+}
+
+/****************************************************************************
+ * Name: ramlog_open
+ ****************************************************************************/
+
+static int ramlog_open(FAR struct file *filep)
+{
+	struct inode *inode = filep->f_inode;
+	struct ramlog_dev_s *priv;
+	struct ramlog_reader_s *reader;
+	irqstate_t flags;
+
+	DEBUGASSERT(inode && inode->i_private);
+	priv = inode->i_private;
+
+	/* Only readers need a read position */
+
+	if ((filep->f_oflags & O_RDOK) == 0) {
+		filep->f_priv = NULL;
+		return OK;
+	}
+
+	reader = (FAR struct ramlog_reader_s *)kmm_malloc(sizeof(struct ramlog_reader_s));
+	if (reader == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Start at the oldest byte still in the log */
+
+	flags = irqsave();
+	reader->rr_pos = priv->rl_tail;
+#ifdef CONFIG_RAMLOG_COMPRESS
+	if (priv->rl_zlog && priv->rl_zlog->zl_nrec > 0) {
+		reader->rr_pos = priv->rl_zlog->zl_tail;
+	}
+#endif
+	reader->rr_flink = priv->rl_readers;
+	priv->rl_readers = reader;
+	irqrestore(flags);
+
+	filep->f_priv = reader;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ramlog_close
+ ****************************************************************************/
+
+static int ramlog_close(FAR struct file *filep)
+{
+	struct inode *inode = filep->f_inode;
+	struct ramlog_dev_s *priv;
+	struct ramlog_reader_s *reader = filep->f_priv;
+	struct ramlog_reader_s **link;
+	irqstate_t flags;
+
+	DEBUGASSERT(inode && inode->i_private);
+	priv = inode->i_private;
+
+	if (reader == NULL) {
+		return OK;
+	}
+
+	flags = irqsave();
+	for (link = &priv->rl_readers; *link; link = &(*link)->rr_flink) {
+		if (*link == reader) {
+			*link = reader->rr_flink;
+			break;
+		}
+	}
+	irqrestore(flags);
+
+	filep->f_priv = NULL;
+	kmm_free(reader);
 	return OK;
 }
 
@@ -257,8 +997,14 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
 	struct inode *inode = filep->f_inode;
 	struct ramlog_dev_s *priv;
+	struct ramlog_reader_s *reader = filep->f_priv;
+	irqstate_t flags;
 	ssize_t nread;
-	char ch;
+	uint32_t pos;
+	uint32_t lost;
+	size_t ndx;
+	size_t ncopy;
+	size_t nfirst;
 	int ret;
 
 	/* Some sanity checking */
@@ -266,13 +1012,17 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	DEBUGASSERT(inode && inode->i_private);
 	priv = inode->i_private;
 
+	if (reader == NULL) {
+		return -EBADF;
+	}
+
 	/* If the circular buffer is empty, then wait for something to be written
 	 * to it.  This function may NOT be called from an interrupt handler.
 	 */
 
 	DEBUGASSERT(!up_interrupt_context());
 
-	/* Get exclusive access to the rl_tail index */
+	/* Get exclusive access to the read position */
 
 	ret = sem_wait(&priv->rl_exclsem);
 	if (ret < 0) {
@@ -282,11 +1032,35 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	/* Loop until something is read */
 
 	for (nread = 0; nread < len;) {
-		/* Get the next byte from the buffer */
+#ifdef CONFIG_RAMLOG_COMPRESS
+		/* Older output may only be left in the compressed history */
+
+		ncopy = ramlog_zread(priv, reader, &buffer[nread], len - nread);
+		if (ncopy > 0) {
+			nread += ncopy;
+			continue;
+		}
+#endif
+
+		/* Find the unread data.  If the writer has overwritten the data at
+		 * our position, skip ahead to the oldest data still kept.
+		 */
+
+		flags = irqsave();
+		pos = reader->rr_pos;
+		if ((int32_t)(pos - priv->rl_tail) < 0) {
+			pos = priv->rl_tail;
+		}
+
+		ncopy = priv->rl_head - pos;
+		ndx = ramlog_index(priv, pos);
+		irqrestore(flags);
 
-		if (priv->rl_head == priv->rl_tail) {
+		if (ncopy == 0) {
 			/* The circular buffer is empty. */
 
+			reader->rr_pos = pos;
+
 #ifdef CONFIG_RAMLOG_NONBLOCKING
 			/* Return what we have (with zero mean the end-of-file) */
 
@@ -370,22 +1144,51 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 			}
 #endif							/* CONFIG_RAMLOG_NONBLOCKING */
 		} else {
-			/* The circular buffer is not empty, get the next byte from the
-			 * tail index.
+			/* Copy as much as fits with interrupts enabled, in at most two
+			 * pieces split where the buffer wraps.
 			 */
 
-			ch = priv->rl_buffer[priv->rl_tail];
-
-			/* Increment the tail index and re-enable interrupts */
+			if (ncopy > len - nread) {
+				ncopy = len - nread;
+			}
 
-			if (++priv->rl_tail >= priv->rl_bufsize) {
-				priv->rl_tail = 0;
+			nfirst = priv->rl_bufsize - ndx;
+			if (nfirst > ncopy) {
+				nfirst = ncopy;
 			}
 
-			/* Add the character to the user buffer */
+			memcpy(&buffer[nread], &priv->rl_buffer[ndx], nfirst);
+			memcpy(&buffer[nread + nfirst], priv->rl_buffer, ncopy - nfirst);
+
+			/* A writer may have overwritten the start of what we copied.
+			 * Anything from the new rl_tail on was not touched, so just drop
+			 * the bytes before it.
+			 */
+
+			flags = irqsave();
+			lost = priv->rl_tail - pos;
+			irqrestore(flags);
+
+			if ((int32_t)lost > 0) {
+#ifdef CONFIG_RAMLOG_COMPRESS
+				/* The bytes were compressed before they were overwritten */
+
+				if (priv->rl_zlog) {
+					continue;
+				}
+#endif
+				if (lost >= ncopy) {
+					reader->rr_pos = pos + lost;
+					continue;
+				}
+
+				memmove(&buffer[nread], &buffer[nread + lost], ncopy - lost);
+				pos += lost;
+				ncopy -= lost;
+			}
 
-			buffer[nread] = ch;
-			nread++;
+			reader->rr_pos = pos + ncopy;
+			nread += ncopy;
 		}
 	}
 
@@ -418,68 +1221,79 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
 {
 	struct inode *inode = filep->f_inode;
 	struct ramlog_dev_s *priv;
-	ssize_t nwritten;
-	char ch;
-	int ret;
+	ssize_t nadded = 0;
+	size_t start;
+	size_t end;
+	ssize_t ret;
 
 	/* Some sanity checking */
 
 	DEBUGASSERT(inode && inode->i_private);
 	priv = inode->i_private;
 
-	/* Loop until all of the bytes have been written.  This function may be
-	 * called from an interrupt handler!  Semaphores cannot be used!
+	/* Add the data in blocks.  This function may be called from an interrupt
+	 * handler!  Semaphores cannot be used!
 	 *
-	 * The write logic only needs to modify the rl_head index.  Therefore,
-	 * there is a difference in the way that rl_head and rl_tail are protected:
-	 * rl_tail is protected with a semaphore; rl_tail is protected by disabling
-	 * interrupts.
+	 * The write logic only modifies rl_head, rl_tail and the buffer, all with
+	 * interrupts disabled.  The read positions are protected with a
+	 * semaphore.
 	 */
 
-	for (nwritten = 0; nwritten < len; nwritten++) {
-		/* Get the next character to output */
-
-		ch = buffer[nwritten];
-
-		/* Ignore carriage returns */
+	for (start = 0; start < len; start = end) {
+		end = len;
 
 #ifdef CONFIG_RAMLOG_CRLF
-		if (ch == '\r') {
-			continue;
+		/* Find the next carriage return or linefeed */
+
+		for (end = start; end < len; end++) {
+			if (buffer[end] == '\r' || buffer[end] == '\n') {
+				break;
+			}
 		}
+#endif
 
-		/* Pre-pend a carriage before a linefeed */
+		/* Add everything up to it as one block */
 
-		if (ch == '\n') {
-			ret = ramlog_addchar(priv, '\r');
-			if (ret < 0) {
-				/* The buffer is full and nothing was saved. Break out of the
-				 * loop to return the number of bytes written up to this point.
-				 * The data to be written is dropped on the floor.
+		if (end > start) {
+			ret = ramlog_addbuf(priv, &buffer[start], end - start);
+			if (ret > 0) {
+				nadded += ret;
+			}
+
+			if (ret < (ssize_t)(end - start)) {
+				/* The buffer is full. Break out of the loop to return the
+				 * number of bytes written up to this point. The rest of the
+				 * data is dropped on the floor.
 				 */
 
 				break;
 			}
 		}
-#endif
 
-		/* Then output the character */
+#ifdef CONFIG_RAMLOG_CRLF
+		if (end < len) {
+			/* Ignore carriage returns and pre-pend one before a linefeed */
 
-		ret = ramlog_addchar(priv, ch);
-		if (ret < 0) {
-			/* The buffer is full and nothing was saved. Break out of the
-			 * loop to return the number of bytes written up to this point.
-			 * The data to be written is dropped on the floor.
-			 */
+			if (buffer[end] == '\n') {
+				ret = ramlog_addbuf(priv, "\r\n", 2);
+				if (ret > 0) {
+					nadded += ret;
+				}
 
-			break;
+				if (ret < 2) {
+					break;
+				}
+			}
+
+			end++;
 		}
+#endif
 	}
 
 	/* Was anything written? */
 
 #if !defined(CONFIG_RAMLOG_NONBLOCKING) || !defined(CONFIG_DISABLE_POLL)
-	if (nwritten > 0) {
+	if (nadded > 0) {
 		irqstate_t flags;
 #ifndef CONFIG_RAMLOG_NONBLOCKING
 		int i;
@@ -520,8 +1334,8 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct ramlog_dev_s *priv;
+	FAR struct ramlog_reader_s *reader = filep->f_priv;
 	pollevent_t eventset;
-	int ndx;
 	int ret;
 	int i;
 
@@ -564,23 +1378,14 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 		}
 
 		/* Should immediately notify on any of the requested events?
-		 * First, check if the xmit buffer is full.
+		 * The log can always be written, old data gives way.
 		 */
 
-		eventset = 0;
-
-		ndx = priv->rl_head + 1;
-		if (ndx >= priv->rl_bufsize) {
-			ndx = 0;
-		}
-
-		if (ndx != priv->rl_tail) {
-			eventset |= POLLOUT;
-		}
+		eventset = POLLOUT;
 
-		/* Check if the receive buffer is empty */
+		/* Check if there is anything this reader has not read yet */
 
-		if (priv->rl_head != priv->rl_tail) {
+		if (reader && reader->rr_pos != priv->rl_head) {
 			eventset |= POLLIN;
 		}
 
@@ -676,7 +1481,7 @@ int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen)
 #ifdef CONFIG_RAMLOG_CONSOLE
 int ramlog_consoleinit(void)
 {
-	FAR struct ramlog_dev_s *priv = &g_sysdev;
+	FAR struct ramlog_dev_s *priv = ramlog_sysdev();
 
 	/* Register the console character driver */
 
@@ -701,7 +1506,7 @@ int ramlog_sysloginit(void)
 {
 	/* Register the syslog character driver */
 
-	return register_driver(CONFIG_SYSLOG_DEVPATH, &g_ramlogfops, 0666, &g_sysdev);
+	return register_driver(CONFIG_SYSLOG_DEVPATH, &g_ramlogfops, 0666, ramlog_sysdev());
 }
 #endif
 
@@ -725,7 +1530,8 @@ int ramlog_sysloginit(void)
 
 int syslog_putc(int ch)
 {
-	FAR struct ramlog_dev_s *priv = &g_sysdev;
+	FAR struct ramlog_dev_s *priv = ramlog_sysdev();
+	char c = ch;
 	int ret;
 
 #ifdef CONFIG_RAMLOG_CRLF
@@ -738,18 +1544,15 @@ int syslog_putc(int ch)
 	/* Pre-pend a newline with a carriage return */
 
 	if (ch == '\n') {
-		ret = ramlog_addchar(priv, '\r');
-		if (ret < 0) {
-			/* The buffer is full and nothing was saved. */
-
-			goto errout;
-		}
-	}
+		ret = ramlog_addbuf(priv, "\r\n", 2);
+	} else
 #endif
+	{
+		/* Add the character to the RAMLOG */
 
-	/* Add the character to the RAMLOG */
+		ret = ramlog_addbuf(priv, &c, 1);
+	}
 
-	ret = ramlog_addchar(priv, ch);
 	if (ret >= 0) {
 		/* Return the character added on success */
 
@@ -760,7 +1563,6 @@ int syslog_putc(int ch)
 	 * work like all other putc-like functions.
 	 */
 
-errout:
 	set_errno(-ret);
 	return EOF;
 }
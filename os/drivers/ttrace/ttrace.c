@@ -44,6 +44,8 @@
 
 #include <arch/irq.h>
 
+#include "ttrace_event.h"
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -192,6 +194,9 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	case TTRACE_START:
 		g_state = TTRACE_STATE_RUNNING;
 		priv->ttrace_head = 0;
+#ifdef CONFIG_TTRACE_EVENTS
+		ttrace_event_start(g_selected_tag);
+#endif
 		break;
 	case TTRACE_OVERWRITE:
 		g_ringbuf.is_overwritable = arg;
@@ -199,6 +204,9 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	case TTRACE_FINISH:
 		g_selected_tag = 0;
 		g_state = TTRACE_STATE_IDLE;
+#ifdef CONFIG_TTRACE_EVENTS
+		ttrace_event_stop();
+#endif
 		break;
 	case TTRACE_INFO:
 		ttdbg("Available tags: apps libs lock ipc task\r\n");
@@ -231,6 +239,11 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		}
 		ttdbg("used bufsize: %d\r\n", ret);
 		break;
+#ifdef CONFIG_TTRACE_EVENTS
+	case TTRACE_GET_EVENTS:
+		ret = ttrace_event_read((FAR struct ttrace_eventreq_s *)arg);
+		break;
+#endif
 	case TTRACE_BUFFER:
 		ttdbg("Resize of trace buffer is not supported yet.\r\n");
 		ttdbg("Trace buffer size should be defined by menuconfig.\r\n");
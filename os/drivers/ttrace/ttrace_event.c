@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/ttrace/ttrace_event.c
+ *
+ * Binary T-trace events.  Unlike the text packets written through
+ * /dev/ttrace, these are recorded directly by the kernel hooks (including
+ * from interrupt handlers) without any system call, into a circular array
+ * that always keeps the most recent events.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/ttrace.h>
+
+#include <arch/irq.h>
+
+#include "ttrace_event.h"
+
+#ifdef CONFIG_TTRACE_EVENTS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ttrace_event_s g_ttevents[CONFIG_TTRACE_EVENT_COUNT];
+
+/* Index of the oldest event and number of events in g_ttevents */
+
+static uint32_t g_ttevtail;
+static uint32_t g_ttevcount;
+
+/* Number of events overwritten before being read */
+
+static uint32_t g_ttevlost;
+
+/* The tags being recorded, zero when the trace is stopped */
+
+static volatile uint32_t g_ttevtags;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ttrace_event
+ *
+ * Description:
+ *   Record an event if its tag is selected.  'pid' is the task that the
+ *   event belongs to, or -1 for the running task.  May be called from
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+void ttrace_event(int tag, int id, int pid, uint32_t arg, int arg2)
+{
+	FAR struct ttrace_event_s *event;
+	irqstate_t flags;
+
+	if ((g_ttevtags & tag) == 0) {
+		return;
+	}
+
+	flags = irqsave();
+
+	if (g_ttevcount < CONFIG_TTRACE_EVENT_COUNT) {
+		event = &g_ttevents[(g_ttevtail + g_ttevcount++) % CONFIG_TTRACE_EVENT_COUNT];
+	} else {
+		/* Overwrite the oldest event */
+
+		event = &g_ttevents[g_ttevtail];
+		g_ttevtail = (g_ttevtail + 1) % CONFIG_TTRACE_EVENT_COUNT;
+		g_ttevlost++;
+	}
+
+	event->cycles = up_perf_gettime();
+	event->arg = arg;
+	event->pid = pid < 0 ? getpid() : pid;
+	event->id = id;
+	event->arg2 = arg2;
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: sched_note_start, sched_note_stop and sched_note_switch
+ *
+ * Description:
+ *   Scheduler instrumentation hooks (see include/sched.h).
+ *
+ ****************************************************************************/
+
+void sched_note_start(FAR struct tcb_s *tcb)
+{
+	ttrace_event(TTRACE_TAG_TASK, TTRACE_EVENT_TASK_START, tcb->pid, 0, 0);
+}
+
+void sched_note_stop(FAR struct tcb_s *tcb)
+{
+	ttrace_event(TTRACE_TAG_TASK, TTRACE_EVENT_TASK_STOP, tcb->pid, 0, 0);
+}
+
+void sched_note_switch(FAR struct tcb_s *pFromTcb, FAR struct tcb_s *pToTcb)
+{
+	ttrace_event(TTRACE_TAG_TASK, TTRACE_EVENT_SWITCH, pFromTcb->pid, pToTcb->pid, pFromTcb->task_state);
+}
+
+/****************************************************************************
+ * Name: ttrace_event_start
+ ****************************************************************************/
+
+void ttrace_event_start(uint32_t tags)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	g_ttevtail = 0;
+	g_ttevcount = 0;
+	g_ttevlost = 0;
+	g_ttevtags = tags;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: ttrace_event_stop
+ ****************************************************************************/
+
+void ttrace_event_stop(void)
+{
+	g_ttevtags = 0;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_read
+ *
+ * Description:
+ *   Copy the oldest events to the caller and remove them from the buffer.
+ *   Interrupts are disabled for one event at a time only, so this may also
+ *   be used while the trace is running.
+ *
+ ****************************************************************************/
+
+int ttrace_event_read(FAR struct ttrace_eventreq_s *req)
+{
+	irqstate_t flags;
+	uint32_t ncopied = 0;
+
+	if (req == NULL || (req->events == NULL && req->nevents > 0)) {
+		return -EINVAL;
+	}
+
+	while (ncopied < req->nevents) {
+		flags = irqsave();
+
+		if (g_ttevcount == 0) {
+			irqrestore(flags);
+			break;
+		}
+
+		req->events[ncopied++] = g_ttevents[g_ttevtail];
+		g_ttevtail = (g_ttevtail + 1) % CONFIG_TTRACE_EVENT_COUNT;
+		g_ttevcount--;
+
+		irqrestore(flags);
+	}
+
+	req->nevents = ncopied;
+	req->nlost = g_ttevlost;
+	req->cycles_per_usec = CONFIG_TTRACE_CYCLES_PER_USEC;
+	g_ttevlost = 0;
+
+	return OK;
+}
+
+#endif							/* CONFIG_TTRACE_EVENTS */
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_TTRACE_TTRACE_EVENT_H
+#define __DRIVERS_TTRACE_TTRACE_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/ttrace.h>
+
+#ifdef CONFIG_TTRACE_EVENTS
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Start recording the events of the tags in 'tags', discarding the events
+ * recorded so far, and stop recording.
+ */
+
+void ttrace_event_start(uint32_t tags);
+void ttrace_event_stop(void);
+
+/* Handle the TTRACE_GET_EVENTS ioctl */
+
+int ttrace_event_read(FAR struct ttrace_eventreq_s *req);
+
+#endif							/* CONFIG_TTRACE_EVENTS */
+#endif							/* __DRIVERS_TTRACE_TTRACE_EVENT_H */
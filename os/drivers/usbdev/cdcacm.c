@@ -110,6 +110,9 @@ struct cdcacm_dev_s {
 	uint8_t nwrq;				/* Number of queue write requests (in reqlist) */
 	uint8_t nrdq;				/* Number of queue read requests (in epbulkout) */
 	uint8_t minor;				/* The device minor number */
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+	int16_t txpos;				/* Next TX byte not yet handed to a write request */
+#endif
 	bool rxenabled;				/* true: UART RX "interrupts" enabled */
 	int16_t rxhead;				/* Working head; used when rx int disabled */
 
@@ -129,7 +132,7 @@ struct cdcacm_dev_s {
 	 */
 
 	struct cdcacm_req_s wrreqs[CONFIG_CDCACM_NWRREQS];
-	struct cdcacm_req_s rdreqs[CONFIG_CDCACM_NWRREQS];
+	struct cdcacm_req_s rdreqs[CONFIG_CDCACM_NRDREQS];
 
 	/* Serial I/O buffers */
 
@@ -157,7 +160,12 @@ struct cdcacm_alloc_s {
 
 /* Transfer helpers *********************************************************/
 
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+static uint16_t cdcacm_txregion(FAR struct cdcacm_dev_s *priv, FAR struct usbdev_req_s *req, uint16_t reqlen);
+static void cdcacm_txdone(FAR struct cdcacm_dev_s *priv, uint16_t nbytes);
+#else
 static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv, uint8_t *reqbuf, uint16_t reqlen);
+#endif
 static int cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv);
 static inline int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv, uint8_t *reqbuf, uint16_t reqlen);
 
@@ -248,6 +256,111 @@ static const struct uart_ops_s g_uartops = {
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+/****************************************************************************
+ * Name: cdcacm_txregion
+ *
+ * Description:
+ *   Point the write request at the next contiguous region of the TX buffer
+ *   that has not been handed to a request yet.  The region stays owned by
+ *   the request, and is not released to writers, until cdcacm_txdone().
+ *
+ ****************************************************************************/
+
+static uint16_t cdcacm_txregion(FAR struct cdcacm_dev_s *priv, FAR struct usbdev_req_s *req, uint16_t reqlen)
+{
+	FAR uart_dev_t *serdev = &priv->serdev;
+	FAR struct uart_buffer_s *xmit = &serdev->xmit;
+	irqstate_t flags;
+	int16_t queued;
+	int16_t sent;
+	uint16_t nbytes;
+
+	flags = irqsave();
+
+	/* With nothing in flight, or after the buffer was flushed or reset under
+	 * us, start again from the tail.
+	 */
+
+	queued = xmit->head - xmit->tail;
+	if (queued < 0) {
+		queued += xmit->size;
+	}
+
+	sent = priv->txpos - xmit->tail;
+	if (sent < 0) {
+		sent += xmit->size;
+	}
+
+	if (priv->nwrq >= CONFIG_CDCACM_NWRREQS || sent > queued) {
+		priv->txpos = xmit->tail;
+	}
+
+	if (priv->txpos == xmit->head) {
+		uart_disabletxint(serdev);
+		irqrestore(flags);
+		return 0;
+	}
+
+	/* Take the bytes up to the head or to the end of the buffer */
+
+	if (xmit->head > priv->txpos) {
+		nbytes = xmit->head - priv->txpos;
+	} else {
+		nbytes = xmit->size - priv->txpos;
+	}
+
+	nbytes = MIN(nbytes, reqlen);
+	req->buf = (FAR uint8_t *)&xmit->buffer[priv->txpos];
+
+	priv->txpos += nbytes;
+	if (priv->txpos >= xmit->size) {
+		priv->txpos = 0;
+	}
+
+	irqrestore(flags);
+	return nbytes;
+}
+
+/****************************************************************************
+ * Name: cdcacm_txdone
+ *
+ * Description:
+ *   Release the TX buffer region of a completed write request.  Requests on
+ *   the bulk IN endpoint complete in order, so this is always the region at
+ *   the tail.
+ *
+ ****************************************************************************/
+
+static void cdcacm_txdone(FAR struct cdcacm_dev_s *priv, uint16_t nbytes)
+{
+	FAR uart_dev_t *serdev = &priv->serdev;
+	FAR struct uart_buffer_s *xmit = &serdev->xmit;
+	irqstate_t flags;
+	int16_t queued;
+
+	flags = irqsave();
+
+	/* Never release more than is queued in case the buffer was flushed */
+
+	queued = xmit->head - xmit->tail;
+	if (queued < 0) {
+		queued += xmit->size;
+	}
+
+	nbytes = MIN(nbytes, (uint16_t)queued);
+	if (nbytes > 0) {
+		xmit->tail += nbytes;
+		if (xmit->tail >= xmit->size) {
+			xmit->tail -= xmit->size;
+		}
+
+		uart_datasent(serdev);
+	}
+
+	irqrestore(flags);
+}
+#else
 /****************************************************************************
  * Name: cdcacm_fillrequest
  *
@@ -307,6 +420,7 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv, uint8_t *reqbu
 	irqrestore(flags);
 	return nbytes;
 }
+#endif
 
 /****************************************************************************
  * Name: cdcacm_sndpacket
@@ -361,7 +475,11 @@ static int cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv)
 
 		/* Fill the request with serial TX data */
 
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+		len = cdcacm_txregion(priv, req, reqlen);
+#else
 		len = cdcacm_fillrequest(priv, req->buf, reqlen);
+#endif
 		if (len > 0) {
 			/* Remove the empty container from the request list */
 
@@ -824,6 +942,13 @@ static void cdcacm_wrcomplete(FAR struct usbdev_ep_s *ep, FAR struct usbdev_req_
 	priv = (FAR struct cdcacm_dev_s *)ep->priv;
 	reqcontainer = (FAR struct cdcacm_req_s *)req->priv;
 
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+	/* Give the sent region of the TX buffer back to writers */
+
+	cdcacm_txdone(priv, req->len);
+	req->buf = NULL;
+#endif
+
 	/* Return the write request to the free list */
 
 	flags = irqsave();
@@ -983,7 +1108,13 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver, FAR struct usbde
 
 	for (i = 0; i < CONFIG_CDCACM_NWRREQS; i++) {
 		reqcontainer = &priv->wrreqs[i];
+#ifdef CONFIG_CDCACM_TXZEROCOPY
+		/* The request buffer is set to a TX buffer region when it is sent */
+
+		reqcontainer->req = EP_ALLOCREQ(priv->epbulkin);
+#else
 		reqcontainer->req = cdcacm_allocreq(priv->epbulkin, reqlen);
+#endif
 		if (reqcontainer->req == NULL) {
 			usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_WRALLOCREQ), -ENOMEM);
 			ret = -ENOMEM;
@@ -182,6 +182,7 @@ static inline int usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv, uint8_t cdblen,
 static int usbmsc_idlestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
+static int usbmsc_writesectors(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
@@ -1939,7 +1940,9 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes still to be sent from iobuffer
+ *   niobytes   - holds the number of bytes loaded into iobuffer by the last
+ *                block driver read
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
@@ -1952,6 +1955,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 	FAR struct usbdev_req_s *req;
 	irqstate_t flags;
 	ssize_t nread;
+	uint32_t nsectors;
 	uint8_t *src;
 	uint8_t *dest;
 	int nbytes;
@@ -1968,19 +1972,28 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 		/* Is the I/O buffer empty? */
 
 		if (priv->nsectbytes <= 0) {
-			/* Yes.. read the next sector */
+			/* Yes.. read as many of the next sectors as the buffer will hold.  The
+			 * bulk IN requests filled from the previous read are still being sent
+			 * while the block driver works on this one.
+			 */
 
-			nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-			if (nread < 0) {
+			nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+			nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, nsectors);
+			if (nread <= 0) {
 				usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
 				lun->sd = SCSI_KCQME_UNRRE1;
 				lun->sdinfo = priv->sector;
 				break;
 			}
 
-			priv->nsectbytes = lun->sectorsize;
-			priv->u.xfrlen--;
-			priv->sector++;
+			if ((uint32_t)nread < nsectors) {
+				nsectors = nread;
+			}
+
+			priv->niobytes = nsectors * lun->sectorsize;
+			priv->nsectbytes = priv->niobytes;
+			priv->u.xfrlen -= nsectors;
+			priv->sector += nsectors;
 		}
 
 		/* Check if there is a request in the wrreqlist that we will be able to
@@ -2007,7 +2020,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 		 * all of the data available in the sector buffer.
 		 */
 
-		src = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+		src = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
 		dest = &req->buf[priv->nreqbytes];
 
 		nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
@@ -2060,6 +2073,37 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: usbmsc_writesectors
+ *
+ * Description:
+ *   Write the whole sectors collected in the I/O buffer to the block driver
+ *   with a single call and update the transfer state.
+ *
+ ****************************************************************************/
+
+static int usbmsc_writesectors(FAR struct usbmsc_dev_s *priv)
+{
+	FAR struct usbmsc_lun_s *lun = priv->lun;
+	uint32_t nsectors;
+	ssize_t nwritten;
+
+	nsectors = priv->nsectbytes / lun->sectorsize;
+	nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, nsectors);
+	if (nwritten < 0) {
+		usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+		lun->sd = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+		lun->sdinfo = priv->sector;
+		return (int)nwritten;
+	}
+
+	priv->nsectbytes = 0;
+	priv->residue -= nsectors * lun->sectorsize;
+	priv->u.xfrlen -= nsectors;
+	priv->sector += nsectors;
+	return OK;
+}
+
 /****************************************************************************
  * Name: usbmsc_cmdwritestate
  *
@@ -2079,7 +2123,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered in iobuffer
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
@@ -2090,13 +2134,22 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 	FAR struct usbmsc_lun_s *lun = priv->lun;
 	FAR struct usbmsc_req_s *privreq;
 	FAR struct usbdev_req_s *req;
-	ssize_t nwritten;
+	uint32_t iosectors;
+	uint32_t iobytes;
 	uint16_t xfrd;
+	bool flush;
 	uint8_t *src;
 	uint8_t *dest;
 	int nbytes;
 	int ret;
 
+	/* Sectors are collected in the I/O buffer and written to the block driver
+	 * up to iosectors at a time.
+	 */
+
+	iosectors = priv->iosize / lun->sectorsize;
+	iobytes = MIN(priv->u.xfrlen, iosectors) * lun->sectorsize;
+
 	/* Loop transferring data until either (1) all of the data has been
 	 * transferred, or (2) we have written all of the data in the available
 	 * read requests.
@@ -2131,13 +2184,14 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 		 * to the block driver OR all of the request data has been transferred.
 		 */
 
+		flush = false;
 		while (priv->nreqbytes > 0 && priv->u.xfrlen > 0) {
 			/* Copy the data received in the read request into the sector I/O buffer */
 
 			src = &req->buf[xfrd - priv->nreqbytes];
 			dest = &priv->iobuffer[priv->nsectbytes];
 
-			nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+			nbytes = MIN(iobytes - priv->nsectbytes, priv->nreqbytes);
 
 			/* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2147,21 +2201,22 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
 			/* Is the I/O buffer full? */
 
-			if (priv->nsectbytes >= lun->sectorsize) {
-				/* Yes.. Write the next sector */
+			if (priv->nsectbytes >= iobytes) {
+				/* Yes.. If the request has been emptied, write the buffer only
+				 * after the request is back with the endpoint.
+				 */
 
-				nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, 1);
-				if (nwritten < 0) {
-					usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
-					lun->sd = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
-					lun->sdinfo = priv->sector;
+				if (priv->nreqbytes <= 0) {
+					flush = true;
+					break;
+				}
+
+				ret = usbmsc_writesectors(priv);
+				if (ret < 0) {
 					goto errout;
 				}
 
-				priv->nsectbytes = 0;
-				priv->residue -= lun->sectorsize;
-				priv->u.xfrlen--;
-				priv->sector++;
+				iobytes = MIN(priv->u.xfrlen, iosectors) * lun->sectorsize;
 			}
 		}
 
@@ -2179,9 +2234,28 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 			usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT), (uint16_t)-ret);
 		}
 
+		/* Write the full buffer while the requests just returned to the endpoint
+		 * receive the data that follows it.
+		 */
+
+		if (flush) {
+			ret = usbmsc_writesectors(priv);
+			if (ret < 0) {
+				goto errout;
+			}
+
+			iobytes = MIN(priv->u.xfrlen, iosectors) * lun->sectorsize;
+		}
+
 		/* Did the host decide to stop early? */
 
 		if (xfrd != CONFIG_USBMSC_BULKOUTREQLEN) {
+			/* Write any whole sectors that were received before it stopped */
+
+			if (priv->nsectbytes >= lun->sectorsize) {
+				(void)usbmsc_writesectors(priv);
+			}
+
 			priv->shortpacket = 1;
 			goto errout;
 		}
@@ -595,6 +595,14 @@ struct slsi_dev {
 #endif
 	pthread_mutex_t rx_data_mutex;
 
+	/* Data frames received in one run of the HIP work, passed to lwIP with
+	 * a single tcpip_input_list() call, see slsi_ethernetif_input_batch()
+	 */
+	bool rx_batch;
+	struct netif *rx_batch_dev;
+	struct pbuf *rx_batch_first;
+	struct pbuf *rx_batch_last;	/* Last pbuf of the last frame */
+
 	struct slsi_sig_send sig_wait;
 	struct slsi_mbuf_work rx_dbg_sap;
 	int tx_host_tag;
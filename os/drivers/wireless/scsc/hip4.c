@@ -21,8 +21,10 @@
 #include "hip4.h"
 #include "mbulk.h"
 #include "dev.h"
+#include "netif.h"
 #include "utils_scsc.h"
 #include "debug_scsc.h"
+#include <tinyara/net/netperf.h>
 
 #ifdef CONFIG_SCSC_PLATFORM
 #define SCSC_SCOREBOARD_VER  (1)
@@ -279,9 +281,11 @@ cont:
 	return mbuf;
 }
 
-/* Add signal reference (offset in shared memory) in the selected queue */
+/* Add signal reference (offset in shared memory) in the selected queue
+ * without notifying the FW. Returns the number of signals in the queue.
+ */
 /* This function should be called in atomic context. Callers should supply proper locking mechanism */
-static int hip4_q_add_signal(struct slsi_hip4 *hip, enum hip4_hip_q_conf conf, scsc_mifram_ref phy_m, struct scsc_service *service)
+static int hip4_q_put(struct slsi_hip4 *hip, enum hip4_hip_q_conf conf, scsc_mifram_ref phy_m)
 {
 	struct hip4_hip_control *ctrl = hip->hip_control;
 	struct hip4_priv *hip_priv = hip->hip_priv;
@@ -321,6 +325,30 @@ static int hip4_q_add_signal(struct slsi_hip4 *hip, enum hip4_hip_q_conf conf, s
 		hip4_update_index(hip, conf, widx, idx_w);
 	}
 
+	return (idx_w - idx_r) & (MAX_NUM - 1);
+}
+
+/* Add signal reference (offset in shared memory) in the selected queue */
+/* This function should be called in atomic context. Callers should supply proper locking mechanism */
+static int hip4_q_add_signal(struct slsi_hip4 *hip, enum hip4_hip_q_conf conf, scsc_mifram_ref phy_m, struct scsc_service *service)
+{
+	struct hip4_priv *hip_priv = hip->hip_priv;
+	int used;
+
+	used = hip4_q_put(hip, conf, phy_m);
+	if (used < 0) {
+		return used;
+	}
+
+	/* While data signals are batched, the FW is notified once at the end of
+	 * the batch, or when the queue gets half full so that it does not stall.
+	 */
+	if (conf == HIP4_MIF_Q_FH_DAT && hip_priv->tx_batch && used < MAX_NUM / 2) {
+		hip_priv->tx_doorbell = true;
+		return 0;
+	}
+
+	hip_priv->tx_doorbell = false;
 	scsc_service_mifintrbit_bit_set(service, hip_priv->rx_intr_fromhost, SCSC_MIFINTR_TARGET_R4);
 
 	return 0;
@@ -392,6 +420,8 @@ static void hip4_wq(FAR void *arg)
 	struct slsi_dev *sdev = container_of(hip, struct slsi_dev, hip4_inst);
 	struct scsc_service *service;
 	bool update = false;
+	bool rfb_returned = false;
+	int budget = CONFIG_SCSC_WLAN_RX_BUDGET;
 
 	if (!sdev || !sdev->service) {
 		return;
@@ -487,13 +517,15 @@ consume_ctl_mbulk:
 
 		/* Go through the list of references to free */
 		while ((ref = to_free[i++]))
-			/* return to the firmware */
-			if (hip4_q_add_signal(hip, HIP4_MIF_Q_TH_RFB, ref, service)) {
+			/* return to the firmware, which is notified once at the end */
+			if (hip4_q_put(hip, HIP4_MIF_Q_TH_RFB, ref) < 0) {
 				/* We need to know when this happens. We need to wait until space becomes free.
 				 * We need to engineer the size of the ring buffers to ensure this is a rare event.
 				 * After retrying once, we could panic or something.
 				 */
 				/* need to retry later */
+			} else {
+				rfb_returned = true;
 			}
 		update = true;
 	}
@@ -514,7 +546,10 @@ consume_ctl_mbulk:
 		update = false;
 	}
 
-	while (idx_r != idx_w) {
+	/* The data frames of this run are passed to lwIP at once */
+	slsi_ethernetif_input_batch(sdev, true);
+
+	while (idx_r != idx_w && budget > 0) {
 		struct max_buff *mbuf;
 		/* Currently the max number to be freed is 2. In future
 		 * implementations (i.e. AMPDU) this number may be bigger
@@ -522,6 +557,7 @@ consume_ctl_mbulk:
 		/* list of mbulks to be freed */
 		scsc_mifram_ref to_free[MBULK_MAX_CHAIN + 1] = { 0 };
 		u8 i = 0;
+		uint32_t start = netperf_begin();
 
 		/* Catch-up with idx_w */
 		ref = ctrl->q[HIP4_MIF_Q_TH_DAT].array[idx_r];
@@ -544,14 +580,18 @@ consume_dat_mbulk:
 
 		/* Go through the list of references to free */
 		while ((ref = to_free[i++]))
-			/* return to the firmware */
-			if (hip4_q_add_signal(hip, HIP4_MIF_Q_TH_RFB, ref, service)) {
+			/* return to the firmware, which is notified once at the end */
+			if (hip4_q_put(hip, HIP4_MIF_Q_TH_RFB, ref) < 0) {
 				/* We need to know when this happens. We need to wait until space becomes free.
 				 * We need to engineer the size of the ring buffers to ensure this is a rare event.
 				 * After retrying once, we could panic or something.
 				 */
+			} else {
+				rfb_returned = true;
 			}
 		update = true;
+		budget--;
+		netperf_end(NETPERF_DRIVER_RX, start);
 	}
 	/* Update the scoreboard */
 	if (SCSC_SCOREBOARD_VER == 0) {
@@ -560,9 +600,25 @@ consume_dat_mbulk:
 		hip4_update_index(hip, HIP4_MIF_Q_TH_DAT, ridx, idx_r);
 	}
 
-	if (!(hip->hip_priv->closing)) {
-		scsc_service_mifintrbit_bit_unmask(service, hip->hip_priv->rx_intr_tohost);
+	slsi_ethernetif_input_batch(sdev, false);
+
+	if (rfb_returned) {
+		scsc_service_mifintrbit_bit_set(service, hip_priv->rx_intr_fromhost, SCSC_MIFINTR_TARGET_R4);
+	}
+
+	if (hip->hip_priv->closing) {
+		return;
+	}
+
+	/* Out of budget: run again with the interrupt still masked, so that
+	 * other work gets a chance to run in between.
+	 */
+	if (idx_r != idx_w) {
+		work_queue(SLSI_HIP_WORK_QID, &hip_priv->intr_wq, hip4_wq, (FAR void *)hip_priv, 0);
+		return;
 	}
+
+	scsc_service_mifintrbit_bit_unmask(service, hip->hip_priv->rx_intr_tohost);
 }
 
 /* IRQ handler for hip4. The function runs in Interrupt context, so all the
@@ -793,6 +849,37 @@ int hip4_init(struct slsi_hip4 *hip)
 	return 0;
 }
 
+/**
+ * Start (start == true) or end a batch of data frames. In between, the data
+ * frames are added to the from-host queue without notifying the FW, which
+ * is notified once when the batch ends. Batches may be nested and must be
+ * used from the context that transmits the data frames.
+ */
+void hip4_tx_batch(struct slsi_hip4 *hip, bool start)
+{
+	struct hip4_priv *hip_priv = hip->hip_priv;
+	struct slsi_dev *sdev;
+
+	if (hip_priv == NULL) {
+		return;
+	}
+
+	if (start) {
+		hip_priv->tx_batch++;
+		return;
+	}
+
+	if (hip_priv->tx_batch == 0 || --hip_priv->tx_batch != 0 || !hip_priv->tx_doorbell) {
+		return;
+	}
+
+	hip_priv->tx_doorbell = false;
+	sdev = container_of(hip, struct slsi_dev, hip4_inst);
+	if (sdev->service != NULL) {
+		scsc_service_mifintrbit_bit_set(sdev->service, hip_priv->rx_intr_fromhost, SCSC_MIFINTR_TARGET_R4);
+	}
+}
+
 /**
  * This function is in charge to transmit a frame through the HIP.
  * It does NOT take ownership of the MBUF unless it successfully transmit it;
@@ -221,6 +221,9 @@ struct hip4_priv {
 	u32 version;				/* Version of the running FW */
 	void *scbrd_base;			/* Scbrd_base pointer */
 
+	u8 tx_batch;				/* Non-zero while data signals are batched, see hip4_tx_batch() */
+	bool tx_doorbell;			/* A data signal was added without notifying the FW */
+
 #ifdef CONFIG_ARCH_CHIP_S5JT200
 	/* Allocated memory */
 	scsc_mifram_ref hip_control;
@@ -243,6 +246,7 @@ void hip4_freeze(struct slsi_hip4 *hip);
 void hip4_deinit(struct slsi_hip4 *hip);
 
 int scsc_wifi_transmit_frame(struct slsi_hip4 *hip, bool ctrl_packet, struct max_buff *mbuf);
+void hip4_tx_batch(struct slsi_hip4 *hip, bool start);
 
 /* Macros for accessing information stored in the hip_config struct */
 #define scsc_wifi_get_hip_config_version_4_u8(buff_ptr, member) le16_to_cpu((((struct hip4_hip_config_version_4 *)(buff_ptr))->member))
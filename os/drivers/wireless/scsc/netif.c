@@ -30,6 +30,8 @@
 #include <arpa/inet.h>
 #include <net/lwip/netif/etharp.h>
 #include <net/lwip/ipv4/igmp.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/stats.h>
 
 #include "debug_scsc.h"
 #include "netif.h"
@@ -370,6 +372,56 @@ int eth_send_eapol(const u8 *src, const u8 *dst, const u8 *buf, u16 len, u16 pro
 	return ERR_OK;
 }
 
+/* Pass the frames of the batch to lwIP. Called with rx_data_mutex held. */
+static void slsi_rx_batch_flush(struct slsi_dev *sdev)
+{
+	if (sdev->rx_batch_first == NULL) {
+		return;
+	}
+
+	if (tcpip_input_list(sdev->rx_batch_first, sdev->rx_batch_dev) != ERR_OK) {
+		/* The frames are linked, this frees all of them */
+		pbuf_free(sdev->rx_batch_first);
+		LINK_STATS_INC(link.drop);
+	}
+
+	sdev->rx_batch_dev = NULL;
+	sdev->rx_batch_first = NULL;
+	sdev->rx_batch_last = NULL;
+}
+
+/* Copy a frame into a pbuf and add it to the batch. Called with rx_data_mutex held. */
+static void slsi_rx_batch_add(struct slsi_dev *sdev, struct netif *dev, u8_t *frame_ptr, u16_t len)
+{
+	struct pbuf *p;
+
+	if (sdev->rx_batch_dev != dev) {
+		slsi_rx_batch_flush(sdev);
+	}
+
+	p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+	if (p == NULL) {
+		LINK_STATS_INC(link.memerr);
+		LINK_STATS_INC(link.drop);
+		return;
+	}
+	pbuf_take(p, frame_ptr, len);
+	LINK_STATS_INC(link.recv);
+
+	/* Like the loopback list of lwIP, the last pbuf of a frame is linked to
+	 * the first pbuf of the next one */
+	if (sdev->rx_batch_first == NULL) {
+		sdev->rx_batch_dev = dev;
+		sdev->rx_batch_first = p;
+	} else {
+		sdev->rx_batch_last->next = p;
+	}
+	while (p->next != NULL) {
+		p = p->next;
+	}
+	sdev->rx_batch_last = p;
+}
+
 void slsi_ethernetif_input(struct netif *dev, u8_t *frame_ptr, u16_t len)
 {
 	struct netdev_vif *ndev_vif = netdev_priv(dev);
@@ -377,11 +429,30 @@ void slsi_ethernetif_input(struct netif *dev, u8_t *frame_ptr, u16_t len)
 
 	SLSI_MUTEX_LOCK(sdev->rx_data_mutex);
 
-	dev->d_buf = frame_ptr;
-	dev->d_len = len;
-
 	SLSI_INCR_DATA_PATH_STATS(sdev->dp_stats.rx_num_packets_given_to_lwip);
-	ethernetif_input(dev);
+	if (sdev->rx_batch && dev->input == tcpip_input) {
+		slsi_rx_batch_add(sdev, dev, frame_ptr, len);
+	} else {
+		dev->d_buf = frame_ptr;
+		dev->d_len = len;
+		ethernetif_input(dev);
+	}
+
+	SLSI_MUTEX_UNLOCK(sdev->rx_data_mutex);
+}
+
+/* Start (start == true) or end a batch of received frames: in between, the
+ * frames given to slsi_ethernetif_input() are queued and they are passed to
+ * lwIP at once when the batch ends.
+ */
+void slsi_ethernetif_input_batch(struct slsi_dev *sdev, bool start)
+{
+	SLSI_MUTEX_LOCK(sdev->rx_data_mutex);
+
+	if (!start) {
+		slsi_rx_batch_flush(sdev);
+	}
+	sdev->rx_batch = start;
 
 	SLSI_MUTEX_UNLOCK(sdev->rx_data_mutex);
 }
@@ -506,6 +577,15 @@ static err_t slsi_set_multicast_list(struct netif *dev, ip_addr_t *group, u8_t a
 	}
 }
 
+#if LWIP_NETIF_TX_BATCH
+static void slsi_tx_batch(struct netif *dev, u8_t start)
+{
+	struct netdev_vif *ndev_vif = netdev_priv(dev);
+
+	hip4_tx_batch(&ndev_vif->sdev->hip4_inst, start != 0);
+}
+#endif
+
 static struct netif *slsi_alloc_netdev(int sizeof_priv)
 {
 	struct netif *dev;
@@ -529,6 +609,9 @@ static struct netif *slsi_alloc_netdev(int sizeof_priv)
 	dev->d_ifup = slsi_net_open;
 	dev->d_ifdown = slsi_net_stop;
 	dev->linkoutput = slsi_linkoutput;
+#if LWIP_NETIF_TX_BATCH
+	dev->tx_batch = slsi_tx_batch;
+#endif
 	dev->output = etharp_output;
 	dev->igmp_mac_filter = slsi_set_multicast_list;
 #ifdef CONFIG_NETDEV_PHY_IOCTL
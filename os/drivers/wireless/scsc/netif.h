@@ -115,4 +115,5 @@ void slsi_netif_remove(struct slsi_dev *sdev, struct netif *dev);
 void slsi_netif_remove_all(struct slsi_dev *sdev);
 void slsi_netif_deinit(struct slsi_dev *sdev);
 void slsi_ethernetif_input(struct netif *netif, u8_t *frame_ptr, u16_t len);
+void slsi_ethernetif_input_batch(struct slsi_dev *sdev, bool start);
 #endif /*__SLSI_NETIF_H__*/
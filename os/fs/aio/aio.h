@@ -60,6 +60,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <aio.h>
 #include <queue.h>
@@ -90,6 +91,31 @@
 #error AIO needs file and/or socket descriptors
 #endif
 
+/* The priority of the low priority work queue is boosted to that of the
+ * submitter.  The AIO engine threads run at a fixed priority instead.
+ */
+
+#undef AIO_BOOST_LPWORK
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_FS_AIO_ENGINE)
+#define AIO_BOOST_LPWORK
+#endif
+
+/* The eventfd to notify on completion (SIGEV_EVENTFD) */
+
+#ifdef CONFIG_EVENTFD
+#define AIOC_EFD(aioc) ((aioc)->aioc_efd)
+#else
+#define AIOC_EFD(aioc) ((FAR struct file *)NULL)
+#endif
+
+/* Cancel a request that has not been started yet */
+
+#ifdef CONFIG_FS_AIO_ENGINE
+#define aio_workcancel(aioc) aio_engine_cancel(aioc)
+#else
+#define aio_workcancel(aioc) work_cancel(LPWORK, &(aioc)->aioc_work)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -108,7 +134,17 @@ struct aio_container_s {
 #endif
 		FAR void *ptr;			/* Generic pointer to FAR data */
 	} u;
+#ifdef CONFIG_FS_AIO_ENGINE
+	dq_entry_t aioc_qlink;		/* Link in the submission queue */
+	worker_t aioc_worker;		/* Performs the I/O */
+	uint8_t aioc_op;			/* LIO_READ, LIO_WRITE or LIO_NOP */
+	bool aioc_queued;			/* In a submission queue, not started */
+#else
 	struct work_s aioc_work;	/* Used to defer I/O to the work thread */
+#endif
+#ifdef CONFIG_EVENTFD
+	FAR struct file *aioc_efd;	/* The eventfd to notify, or NULL */
+#endif
 	pid_t aioc_pid;				/* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t aioc_prio;			/* Priority of the waiting task */
@@ -264,6 +300,40 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+#ifdef CONFIG_FS_AIO_ENGINE
+/****************************************************************************
+ * Name: aio_engine_queue
+ *
+ * Description:
+ *   Add the request to the submission queue of its device or mount point.
+ *   Requests of a queue are performed in order by one AIO thread at a
+ *   time; requests of different queues proceed in parallel.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container
+ *   worker - Performs the I/O unless it is merged with its neighbours
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_engine_queue(FAR struct aio_container_s *aioc, worker_t worker);
+
+/****************************************************************************
+ * Name: aio_engine_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started from its submission queue.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -ENOENT if it has been started.
+ *
+ ****************************************************************************/
+
+int aio_engine_cancel(FAR struct aio_container_s *aioc);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -272,6 +342,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
  *
  * Input Parameters:
  *   pid    - ID of the task to signal
+ *   efd    - The eventfd to notify with SIGEV_EVENTFD
  *   aiocbp - Pointer to the asynchronous I/O state structure that includes
  *            information about how to signal the client
  *
@@ -281,7 +352,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
  *
  ****************************************************************************/
 
-int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
+int aio_signal(pid_t pid, FAR struct file *efd, FAR struct aiocb *aiocbp);
 
 #endif							/* CONFIG_FS_AIO */
 #endif							/* __FS_AIO_AIO_H */
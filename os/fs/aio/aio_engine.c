@@ -0,0 +1,344 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/aio/aio_engine.c
+ *
+ * The AIO engine performs asynchronous I/O on a pool of dedicated threads
+ * instead of the low priority work queue.  Requests are queued per device
+ * or mount point: a file's inode selects one of CONFIG_FS_AIO_NQUEUES
+ * submission queues.  A queue is run by one thread at a time so that the
+ * requests of a device are performed in order, while other threads run the
+ * other queues.  Reads or writes that continue each other, in the file and
+ * in memory, are merged into one transfer.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <aio.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/kthread.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_ENGINE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct aio_squeue_s {
+	dq_queue_t sq_pending;		/* Requests not started, in order */
+	bool sq_busy;				/* A thread is running this queue */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct aio_squeue_s g_aio_squeue[CONFIG_FS_AIO_NQUEUES];
+
+/* Posted once per queued request to wake an AIO thread */
+
+static sem_t g_aio_worksem = SEM_INITIALIZER(0);
+
+static bool g_aio_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#define aioc_from_qlink(entry) \
+	((FAR struct aio_container_s *)((FAR char *)(entry) - offsetof(struct aio_container_s, aioc_qlink)))
+
+/****************************************************************************
+ * Name: aio_engine_select
+ *
+ * Description:
+ *   Return the submission queue of the device or mount point of a file.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_squeue_s *aio_engine_select(FAR struct aio_container_s *aioc)
+{
+	uintptr_t key = (uintptr_t)aioc->u.aioc_filep->f_inode;
+
+	return &g_aio_squeue[(key >> 4) % CONFIG_FS_AIO_NQUEUES];
+}
+
+/****************************************************************************
+ * Name: aio_engine_mergeable
+ *
+ * Description:
+ *   Return true if 'next' continues 'prev' in the file and in memory.
+ *
+ ****************************************************************************/
+
+static bool aio_engine_mergeable(FAR struct aio_container_s *prev, FAR struct aio_container_s *next)
+{
+	FAR struct aiocb *pcb = prev->aioc_aiocbp;
+	FAR struct aiocb *ncb = next->aioc_aiocbp;
+
+	return next->aioc_op == prev->aioc_op && next->u.aioc_filep == prev->u.aioc_filep && ncb->aio_offset == pcb->aio_offset + (off_t)pcb->aio_nbytes && (FAR uint8_t *)ncb->aio_buf == (FAR uint8_t *)pcb->aio_buf + pcb->aio_nbytes;
+}
+
+/****************************************************************************
+ * Name: aio_engine_take
+ *
+ * Description:
+ *   Remove the next request of a queue from it, together with the requests
+ *   that can be merged with it.  Returns the number of requests taken.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock
+ *
+ ****************************************************************************/
+
+static int aio_engine_take(FAR struct aio_squeue_s *sq, FAR struct aio_container_s **batch)
+{
+	FAR struct aio_container_s *aioc;
+	FAR dq_entry_t *entry;
+	int n = 0;
+
+	while ((entry = dq_peek(&sq->sq_pending)) != NULL && n < CONFIG_FS_AIO_MERGE) {
+		aioc = aioc_from_qlink(entry);
+		if (n > 0) {
+			/* Only plain reads and writes at explicit offsets merge */
+
+			if (batch[0]->aioc_op == LIO_NOP || (batch[0]->u.aioc_filep->f_oflags & O_APPEND) != 0 || !aio_engine_mergeable(batch[n - 1], aioc)) {
+				break;
+			}
+		}
+
+		dq_rem(entry, &sq->sq_pending);
+		aioc->aioc_queued = false;
+		batch[n++] = aioc;
+	}
+
+	return n;
+}
+
+/****************************************************************************
+ * Name: aio_engine_run
+ *
+ * Description:
+ *   Perform a batch of requests.  A single request is performed by its own
+ *   worker.  Merged requests are performed as one transfer whose result is
+ *   divided among them in order.
+ *
+ ****************************************************************************/
+
+static void aio_engine_run(FAR struct aio_container_s **batch, int n)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aiocb *first = batch[0]->aioc_aiocbp;
+	FAR struct file *filep = batch[0]->u.aioc_filep;
+	FAR struct aiocb *aiocbp;
+	FAR struct file *efd;
+	size_t nbytes = 0;
+	ssize_t remaining;
+	ssize_t ret;
+	pid_t pid;
+	int i;
+
+	if (n == 1) {
+		batch[0]->aioc_worker(batch[0]);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		nbytes += batch[i]->aioc_aiocbp->aio_nbytes;
+	}
+
+	if (batch[0]->aioc_op == LIO_READ) {
+		ret = file_pread(filep, (FAR void *)first->aio_buf, nbytes, first->aio_offset);
+	} else {
+		ret = file_pwrite(filep, (FAR const void *)first->aio_buf, nbytes, first->aio_offset);
+	}
+
+	if (ret < 0) {
+		ret = -get_errno();
+		fdbg("ERROR: merged transfer failed: %d\n", (int)ret);
+	}
+
+	remaining = ret;
+	for (i = 0; i < n; i++) {
+		aioc = batch[i];
+		pid = aioc->aioc_pid;
+		efd = AIOC_EFD(aioc);
+		aiocbp = aioc_decant(aioc);
+
+		if (ret < 0) {
+			aiocbp->aio_result = ret;
+		} else if (remaining > (ssize_t)aiocbp->aio_nbytes) {
+			aiocbp->aio_result = aiocbp->aio_nbytes;
+			remaining -= aiocbp->aio_nbytes;
+		} else {
+			aiocbp->aio_result = remaining;
+			remaining = 0;
+		}
+
+		(void)aio_signal(pid, efd, aiocbp);
+	}
+}
+
+/****************************************************************************
+ * Name: aio_engine_thread
+ *
+ * Description:
+ *   The body of an AIO thread.  It runs a queue that no other thread is
+ *   running until the queue is empty.
+ *
+ ****************************************************************************/
+
+static int aio_engine_thread(int argc, FAR char *argv[])
+{
+	FAR struct aio_container_s *batch[CONFIG_FS_AIO_MERGE];
+	FAR struct aio_squeue_s *sq;
+	int n;
+	int i;
+
+	for (;;) {
+		while (sem_wait(&g_aio_worksem) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		aio_lock();
+		for (i = 0; i < CONFIG_FS_AIO_NQUEUES; i++) {
+			sq = &g_aio_squeue[i];
+			if (sq->sq_busy || dq_empty(&sq->sq_pending)) {
+				continue;
+			}
+
+			sq->sq_busy = true;
+			while ((n = aio_engine_take(sq, batch)) > 0) {
+				aio_unlock();
+				aio_engine_run(batch, n);
+				aio_lock();
+			}
+
+			sq->sq_busy = false;
+		}
+
+		aio_unlock();
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_engine_start
+ *
+ * Description:
+ *   Start the AIO threads when the first request is queued.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock
+ *
+ ****************************************************************************/
+
+static int aio_engine_start(void)
+{
+	int started = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_FS_AIO_NTHREADS; i++) {
+		if (kernel_thread("aio", CONFIG_FS_AIO_PRIORITY, CONFIG_FS_AIO_STACKSIZE, (main_t)aio_engine_thread, (FAR char *const *)NULL) >= 0) {
+			started++;
+		}
+	}
+
+	if (started == 0) {
+		return -EAGAIN;
+	}
+
+	g_aio_started = true;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_engine_queue
+ *
+ * Description:
+ *   Add the request to the submission queue of its device or mount point.
+ *
+ ****************************************************************************/
+
+int aio_engine_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+	FAR struct aio_squeue_s *sq;
+	int ret = OK;
+
+	aio_lock();
+	if (!g_aio_started) {
+		ret = aio_engine_start();
+		if (ret < 0) {
+			aio_unlock();
+			return ret;
+		}
+	}
+
+	sq = aio_engine_select(aioc);
+	aioc->aioc_worker = worker;
+	aioc->aioc_queued = true;
+	dq_addlast(&aioc->aioc_qlink, &sq->sq_pending);
+	aio_unlock();
+
+	sem_post(&g_aio_worksem);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: aio_engine_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started from its submission queue.
+ *
+ ****************************************************************************/
+
+int aio_engine_cancel(FAR struct aio_container_s *aioc)
+{
+	int ret = -ENOENT;
+
+	aio_lock();
+	if (aioc->aioc_queued) {
+		dq_rem(&aioc->aioc_qlink, &aio_engine_select(aioc)->sq_pending);
+		aioc->aioc_queued = false;
+		ret = OK;
+	}
+
+	aio_unlock();
+	return ret;
+}
+
+#endif							/* CONFIG_FS_AIO && CONFIG_FS_AIO_ENGINE */
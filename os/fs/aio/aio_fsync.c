@@ -109,8 +109,9 @@ static void aio_fsync_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+	FAR struct file *efd;
 	pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	uint8_t prio;
 #endif
 	int ret;
@@ -122,7 +123,8 @@ static void aio_fsync_worker(FAR void *arg)
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
 	pid = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+	efd = AIOC_EFD(aioc);
+#ifdef AIO_BOOST_LPWORK
 	prio = aioc->aioc_prio;
 #endif
 	aiocbp = aioc_decant(aioc);
@@ -141,9 +143,9 @@ static void aio_fsync_worker(FAR void *arg)
 
 	/* Signal the client */
 
-	(void)aio_signal(pid, aiocbp);
+	(void)aio_signal(pid, efd, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Restore the low priority worker thread default priority */
 
 	lpwork_restorepriority(prio);
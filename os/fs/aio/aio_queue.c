@@ -91,7 +91,8 @@
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue, or on
+ *   the AIO engine if CONFIG_FS_AIO_ENGINE is selected
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -107,7 +108,17 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
 	int ret;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef CONFIG_FS_AIO_ENGINE
+	ret = aio_engine_queue(aioc, worker);
+	if (ret < 0) {
+		aioc->aioc_aiocbp->aio_result = ret;
+		set_errno(-ret);
+		ret = ERROR;
+	}
+
+	return ret;
+#else
+#ifdef AIO_BOOST_LPWORK
 	/* Prohibit context switches until we complete the queuing */
 
 	sched_lock();
@@ -130,12 +141,13 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 		set_errno(-ret);
 		ret = ERROR;
 	}
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Now the low-priority work queue might run at its new priority */
 
 	sched_unlock();
 #endif
 	return ret;
+#endif
 }
 
 #endif							/* CONFIG_FS_AIO */
@@ -109,8 +109,9 @@ static void aio_read_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+	FAR struct file *efd;
 	pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	uint8_t prio;
 #endif
 	ssize_t nread = 0;
@@ -122,7 +123,8 @@ static void aio_read_worker(FAR void *arg)
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
 	pid = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+	efd = AIOC_EFD(aioc);
+#ifdef AIO_BOOST_LPWORK
 	prio = aioc->aioc_prio;
 #endif
 	aiocbp = aioc_decant(aioc);
@@ -154,9 +156,9 @@ static void aio_read_worker(FAR void *arg)
 
 	/* Signal the client */
 
-	(void)aio_signal(pid, aiocbp);
+	(void)aio_signal(pid, efd, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Restore the low priority worker thread default priority */
 
 	lpwork_restorepriority(prio);
@@ -289,6 +291,9 @@ int aio_read(FAR struct aiocb *aiocbp)
 
 	/* Defer the work to the worker thread */
 
+#ifdef CONFIG_FS_AIO_ENGINE
+	aioc->aioc_op = LIO_READ;
+#endif
 	ret = aio_queue(aioc, aio_read_worker);
 	if (ret < 0) {
 		/* The result and the errno have already been set */
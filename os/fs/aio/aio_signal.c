@@ -60,10 +60,13 @@
 #include <sched.h>
 #include <signal.h>
 #include <aio.h>
+#include <sys/eventfd.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <tinyara/fs/fs.h>
+
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
@@ -99,6 +102,7 @@
  *
  * Input Parameters:
  *   pid    - ID of the task to signal
+ *   efd    - The eventfd to notify with SIGEV_EVENTFD
  *   aiocbp - Pointer to the asynchronous I/O state structure that includes
  *            information about how to signal the client
  *
@@ -111,7 +115,7 @@
  *
  ****************************************************************************/
 
-int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
+int aio_signal(pid_t pid, FAR struct file *efd, FAR struct aiocb *aiocbp)
 {
 #ifdef CONFIG_CAN_PASS_STRUCTS
 	union sigval value;
@@ -139,6 +143,22 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
 		}
 	}
 
+#ifdef CONFIG_EVENTFD
+	/* Or notify the eventfd of the client.  The worker thread cannot use the
+	 * descriptor, the file was looked up when the I/O was queued.
+	 */
+
+	if (aiocbp->aio_sigevent.sigev_notify == SIGEV_EVENTFD && efd != NULL) {
+		eventfd_t one = 1;
+
+		if (file_write(efd, &one, sizeof(eventfd_t)) < 0) {
+			errcode = get_errno();
+			fdbg("ERROR: eventfd write failed: %d\n", errcode);
+			ret = ERROR;
+		}
+	}
+#endif
+
 	/* Send the poll signal in any event in case the caller is waiting
 	 * on sig_suspend();
 	 */
@@ -121,6 +121,9 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	struct sched_param param;
 #endif
+#ifdef CONFIG_EVENTFD
+	FAR struct file *efd;
+#endif
 
 #ifdef AIO_HAVE_FILEP
 	{
@@ -135,6 +138,20 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 	}
 #endif
 
+#ifdef CONFIG_EVENTFD
+	/* The completion is posted by a thread that cannot use the descriptor */
+
+	efd = NULL;
+	if (aiocbp->aio_sigevent.sigev_notify == SIGEV_EVENTFD) {
+		efd = fs_getfilep(aiocbp->aio_sigevent.sigev_signo);
+		if (!efd) {
+			/* The errno value has already been set */
+
+			return NULL;
+		}
+	}
+#endif
+
 	/* Allocate the AIO control block container, waiting for one to become
 	 * available if necessary.  This should never fail.
 	 */
@@ -148,6 +165,9 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 	aioc->aioc_aiocbp = aiocbp;
 	aioc->u.ptr = u.ptr;
 	aioc->aioc_pid = getpid();
+#ifdef CONFIG_EVENTFD
+	aioc->aioc_efd = efd;
+#endif
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	DEBUGVERIFY(sched_getparam(aioc->aioc_pid, &param));
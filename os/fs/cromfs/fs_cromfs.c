@@ -0,0 +1,720 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/cromfs/fs_cromfs.c
+ *
+ * CROMFS is a read-only file system like ROMFS whose files are split into
+ * blocks that are compressed independently with LZ4.  Reads decode only the
+ * blocks they touch; a few recently decoded blocks are kept in a small
+ * cache so that small sequential reads do not decode a block more than
+ * once.  Images are made with tools/mkcromfs.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/dirent.h>
+
+#include "fs_cromfs.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int cromfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int cromfs_close(FAR struct file *filep);
+static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static off_t cromfs_seek(FAR struct file *filep, off_t offset, int whence);
+
+static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int cromfs_opendir(FAR struct inode *mountpt, FAR const char *relpath, FAR struct fs_dirent_s *dir);
+static int cromfs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir);
+static int cromfs_rewinddir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir);
+
+static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data, FAR void **handle);
+static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver);
+static int cromfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf);
+
+static int cromfs_stat(FAR struct inode *mountpt, FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct mountpt_operations cromfs_operations = {
+	cromfs_open,				/* open */
+	cromfs_close,				/* close */
+	cromfs_read,				/* read */
+	NULL,						/* write */
+	cromfs_seek,				/* seek */
+	NULL,						/* ioctl */
+
+	NULL,						/* sync */
+	cromfs_dup,					/* dup */
+
+	cromfs_opendir,				/* opendir */
+	NULL,						/* closedir */
+	cromfs_readdir,				/* readdir */
+	cromfs_rewinddir,			/* rewinddir */
+
+	cromfs_bind,				/* bind */
+	cromfs_unbind,				/* unbind */
+	cromfs_statfs,				/* statfs */
+
+	NULL,						/* unlink */
+	NULL,						/* mkdir */
+	NULL,						/* rmdir */
+	NULL,						/* rename */
+	cromfs_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cromfs_addfile
+ *
+ * Description:
+ *   Create the private data of an open file and add it to the open files of
+ *   the mountpoint.  Called with the mountpoint semaphore held.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_file_s *cromfs_addfile(FAR struct cromfs_mountpt_s *cm, uint32_t table, uint32_t size)
+{
+	FAR struct cromfs_file_s *cf;
+
+	cf = (FAR struct cromfs_file_s *)kmm_malloc(sizeof(struct cromfs_file_s));
+	if (cf) {
+		cf->cf_table = table;
+		cf->cf_size = size;
+		cf->cf_next = cm->cm_head;
+		cm->cm_head = cf;
+	}
+
+	return cf;
+}
+
+/****************************************************************************
+ * Name: cromfs_open
+ ****************************************************************************/
+
+static int cromfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	struct cromfs_nodeinfo_s node;
+	FAR struct cromfs_mountpt_s *cm;
+	FAR struct cromfs_file_s *cf;
+	int ret;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	DEBUGASSERT(filep->f_priv == NULL && filep->f_inode != NULL);
+
+	cm = (FAR struct cromfs_mountpt_s *)filep->f_inode->i_private;
+	DEBUGASSERT(cm != NULL);
+
+	/* CROMFS is read-only */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	ret = cromfs_findnode(cm, relpath, &node);
+	if (ret < 0) {
+		fdbg("Failed to find '%s': %d\n", relpath, ret);
+		goto errout_with_semaphore;
+	}
+
+	if ((node.ci_mode & CROMFS_MODE_TYPEMASK) != CROMFS_MODE_FILE) {
+		fdbg("'%s' is a directory\n", relpath);
+		ret = -EISDIR;
+		goto errout_with_semaphore;
+	}
+
+	cf = cromfs_addfile(cm, node.ci_info, node.ci_size);
+	if (!cf) {
+		ret = -ENOMEM;
+		goto errout_with_semaphore;
+	}
+
+	filep->f_priv = cf;
+	ret = OK;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_close
+ ****************************************************************************/
+
+static int cromfs_close(FAR struct file *filep)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	FAR struct cromfs_file_s *cf;
+	FAR struct cromfs_file_s **pprev;
+
+	fvdbg("Closing\n");
+
+	DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+	cf = filep->f_priv;
+	cm = filep->f_inode->i_private;
+	DEBUGASSERT(cm != NULL);
+
+	/* Do not check if the mount is healthy.  We must support closing of
+	 * the file even when there is healthy mount.
+	 */
+
+	cromfs_semtake(cm);
+	for (pprev = &cm->cm_head; *pprev; pprev = &(*pprev)->cf_next) {
+		if (*pprev == cf) {
+			*pprev = cf->cf_next;
+			break;
+		}
+	}
+
+	cromfs_semgive(cm);
+
+	kmm_free(cf);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_read
+ ****************************************************************************/
+
+static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	FAR struct cromfs_file_s *cf;
+	ssize_t ret;
+
+	fvdbg("Read %d bytes from offset %d\n", buflen, filep->f_pos);
+
+	DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+	cf = filep->f_priv;
+	cm = filep->f_inode->i_private;
+	DEBUGASSERT(cm != NULL);
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	/* Truncate read count so that it does not exceed the number of bytes
+	 * left in the file.
+	 */
+
+	if (buflen > cf->cf_size - filep->f_pos) {
+		buflen = cf->cf_size - filep->f_pos;
+	}
+
+	ret = cromfs_readblocks(cm, cf, filep->f_pos, (FAR uint8_t *)buffer, buflen);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_seek
+ ****************************************************************************/
+
+static off_t cromfs_seek(FAR struct file *filep, off_t offset, int whence)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	FAR struct cromfs_file_s *cf;
+	off_t position;
+	int ret;
+
+	fvdbg("Seek to offset: %d whence: %d\n", offset, whence);
+
+	DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+	cf = filep->f_priv;
+	cm = filep->f_inode->i_private;
+	DEBUGASSERT(cm != NULL);
+
+	switch (whence) {
+	case SEEK_SET:
+		position = offset;
+		break;
+
+	case SEEK_CUR:
+		position = offset + filep->f_pos;
+		break;
+
+	case SEEK_END:
+		position = offset + cf->cf_size;
+		break;
+
+	default:
+		fdbg("Whence is invalid: %d\n", whence);
+		return -EINVAL;
+	}
+
+	if (position < 0) {
+		return -EINVAL;
+	}
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		cromfs_semgive(cm);
+		return ret;
+	}
+
+	/* Limit positions to the end of the file. */
+
+	if (position > cf->cf_size) {
+		position = cf->cf_size;
+	}
+
+	filep->f_pos = position;
+	cromfs_semgive(cm);
+	return position;
+}
+
+/****************************************************************************
+ * Name: cromfs_dup
+ ****************************************************************************/
+
+static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	FAR struct cromfs_file_s *oldcf;
+	FAR struct cromfs_file_s *newcf;
+	int ret;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	DEBUGASSERT(oldp->f_priv != NULL && newp->f_priv == NULL && newp->f_inode != NULL);
+
+	cm = (FAR struct cromfs_mountpt_s *)newp->f_inode->i_private;
+	DEBUGASSERT(cm != NULL);
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	oldcf = oldp->f_priv;
+	newcf = cromfs_addfile(cm, oldcf->cf_table, oldcf->cf_size);
+	if (!newcf) {
+		ret = -ENOMEM;
+		goto errout_with_semaphore;
+	}
+
+	newp->f_priv = newcf;
+	ret = OK;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_opendir
+ *
+ * Description:
+ *   Open a directory for read access
+ *
+ ****************************************************************************/
+
+static int cromfs_opendir(FAR struct inode *mountpt, FAR const char *relpath, FAR struct fs_dirent_s *dir)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	struct cromfs_nodeinfo_s node;
+	int ret;
+
+	fvdbg("relpath: '%s'\n", relpath);
+
+	DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+	cm = mountpt->i_private;
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	ret = cromfs_findnode(cm, relpath, &node);
+	if (ret < 0) {
+		fdbg("Failed to find directory '%s': %d\n", relpath, ret);
+		goto errout_with_semaphore;
+	}
+
+	if ((node.ci_mode & CROMFS_MODE_TYPEMASK) != CROMFS_MODE_DIRECTORY) {
+		fdbg("'%s' is not a directory\n", relpath);
+		ret = -ENOTDIR;
+		goto errout_with_semaphore;
+	}
+
+	dir->u.cromfs.cr_firstoffset = node.ci_info;
+	dir->u.cromfs.cr_curroffset = node.ci_info;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_readdir
+ *
+ * Description: Read the next directory entry
+ *
+ ****************************************************************************/
+
+static int cromfs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	struct cromfs_nodeinfo_s node;
+	int ret;
+
+	fvdbg("Entry\n");
+
+	DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+	cm = mountpt->i_private;
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	/* We signal the end of the directory by returning the special error
+	 * -ENOENT
+	 */
+
+	if (dir->u.cromfs.cr_curroffset == 0) {
+		fvdbg("End of directory\n");
+		ret = -ENOENT;
+		goto errout_with_semaphore;
+	}
+
+	ret = cromfs_parsenode(cm, dir->u.cromfs.cr_curroffset, &node);
+	if (ret < 0) {
+		goto errout_with_semaphore;
+	}
+
+	ret = cromfs_parsename(cm, dir->u.cromfs.cr_curroffset, dir->fd_dir.d_name);
+	if (ret < 0) {
+		goto errout_with_semaphore;
+	}
+
+	if ((node.ci_mode & CROMFS_MODE_TYPEMASK) == CROMFS_MODE_DIRECTORY) {
+		dir->fd_dir.d_type = DTYPE_DIRECTORY;
+	} else {
+		dir->fd_dir.d_type = DTYPE_FILE;
+	}
+
+	dir->u.cromfs.cr_curroffset = node.ci_peer;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_rewinddir
+ *
+ * Description: Reset directory read to the first entry
+ *
+ ****************************************************************************/
+
+static int cromfs_rewinddir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	int ret;
+
+	fvdbg("Entry\n");
+
+	DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+	cm = mountpt->i_private;
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret == OK) {
+		dir->u.cromfs.cr_curroffset = dir->u.cromfs.cr_firstoffset;
+	}
+
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_bind
+ *
+ * Description: This implements a portion of the mount operation. This
+ *  function allocates and initializes the mountpoint private data and
+ *  binds the blockdriver inode to the filesystem private data.  The final
+ *  binding of the private data (containing the blockdriver) to the
+ *  mountpoint is performed by mount().
+ *
+ ****************************************************************************/
+
+static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data, FAR void **handle)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	int ret;
+
+	fvdbg("Entry\n");
+
+	if (!blkdriver || !blkdriver->u.i_bops) {
+		fdbg("No block driver/ops\n");
+		return -ENODEV;
+	}
+
+	if (blkdriver->u.i_bops->open && blkdriver->u.i_bops->open(blkdriver) != OK) {
+		fdbg("No open method\n");
+		return -ENODEV;
+	}
+
+	cm = (FAR struct cromfs_mountpt_s *)kmm_zalloc(sizeof(struct cromfs_mountpt_s));
+	if (!cm) {
+		fdbg("Failed to allocate mountpoint structure\n");
+		return -ENOMEM;
+	}
+
+	/* The filesystem is responsible for one reference on the blkdriver
+	 * inode and does not have to addref() here (but does have to release
+	 * in unbind().
+	 */
+
+	sem_init(&cm->cm_sem, 0, 0);
+	cm->cm_blkdriver = blkdriver;
+
+	ret = cromfs_hwconfigure(cm);
+	if (ret < 0) {
+		fdbg("cromfs_hwconfigure failed: %d\n", ret);
+		goto errout_with_buffers;
+	}
+
+	ret = cromfs_fsconfigure(cm);
+	if (ret < 0) {
+		fdbg("cromfs_fsconfigure failed: %d\n", ret);
+		goto errout_with_buffers;
+	}
+
+	/* Mounted! */
+
+	*handle = (void *)cm;
+	cromfs_semgive(cm);
+	return OK;
+
+errout_with_buffers:
+	cromfs_release(cm);
+	sem_destroy(&cm->cm_sem);
+	kmm_free(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_unbind
+ *
+ * Description: This implements the filesystem portion of the umount
+ *   operation.
+ *
+ ****************************************************************************/
+
+static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver)
+{
+	FAR struct cromfs_mountpt_s *cm = (FAR struct cromfs_mountpt_s *)handle;
+	FAR struct inode *inode;
+
+	fvdbg("Entry\n");
+
+#ifdef CONFIG_DEBUG
+	if (!cm) {
+		return -EINVAL;
+	}
+#endif
+
+	cromfs_semtake(cm);
+	if (cm->cm_head) {
+		/* We cannot unmount now.. there are open files */
+
+		fdbg("There are open files\n");
+		cromfs_semgive(cm);
+		return -EBUSY;
+	}
+
+	/* Close the block driver and return our reference to it so that the
+	 * umount logic disposes of it.
+	 */
+
+	inode = cm->cm_blkdriver;
+	if (inode) {
+		if (inode->u.i_bops && inode->u.i_bops->close) {
+			(void)inode->u.i_bops->close(inode);
+		}
+
+		if (blkdriver) {
+			*blkdriver = inode;
+		}
+	}
+
+	cromfs_release(cm);
+	sem_destroy(&cm->cm_sem);
+	kmm_free(cm);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_statfs
+ *
+ * Description: Return filesystem statistics
+ *
+ ****************************************************************************/
+
+static int cromfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	int ret;
+
+	fvdbg("Entry\n");
+
+	DEBUGASSERT(mountpt && mountpt->i_private);
+
+	cm = mountpt->i_private;
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret < 0) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	/* Report the space taken on the media, in units of sectors */
+
+	memset(buf, 0, sizeof(struct statfs));
+	buf->f_type = CROMFS_MAGIC;
+	buf->f_bsize = cm->cm_hwsectorsize;
+	buf->f_blocks = (cm->cm_volsize + cm->cm_hwsectorsize - 1) / cm->cm_hwsectorsize;
+	buf->f_bfree = 0;
+	buf->f_bavail = 0;
+	buf->f_namelen = NAME_MAX;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int cromfs_stat(FAR struct inode *mountpt, FAR const char *relpath, FAR struct stat *buf)
+{
+	FAR struct cromfs_mountpt_s *cm;
+	struct cromfs_nodeinfo_s node;
+	int ret;
+
+	fvdbg("Entry\n");
+
+	DEBUGASSERT(mountpt && mountpt->i_private);
+
+	cm = mountpt->i_private;
+
+	cromfs_semtake(cm);
+	ret = cromfs_checkmount(cm);
+	if (ret != OK) {
+		fdbg("cromfs_checkmount failed: %d\n", ret);
+		goto errout_with_semaphore;
+	}
+
+	ret = cromfs_findnode(cm, relpath, &node);
+	if (ret < 0) {
+		fvdbg("Failed to find '%s': %d\n", relpath, ret);
+		goto errout_with_semaphore;
+	}
+
+	memset(buf, 0, sizeof(struct stat));
+	if ((node.ci_mode & CROMFS_MODE_TYPEMASK) == CROMFS_MODE_DIRECTORY) {
+		buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
+	} else {
+		buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+		buf->st_size = node.ci_size;
+	}
+
+	if ((node.ci_mode & CROMFS_MODE_EXEC) != 0) {
+		buf->st_mode |= S_IXOTH | S_IXGRP | S_IXUSR;
+	}
+
+	/* The block size is the uncompressed size of a data block */
+
+	buf->st_blksize = cm->cm_bsize;
+	buf->st_blocks = (buf->st_size + buf->st_blksize - 1) / buf->st_blksize;
+
+errout_with_semaphore:
+	cromfs_semgive(cm);
+	return ret;
+}
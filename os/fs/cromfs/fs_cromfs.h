@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/cromfs/fs_cromfs.h
+ ****************************************************************************/
+
+#ifndef __FS_CROMFS_FS_CROMFS_H
+#define __FS_CROMFS_FS_CROMFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <tinyara/fs/dirent.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Volume header (multi-byte values are little-endian) */
+
+#define CROMFS_VHDR_MAGIC    0	/*  0-7:   "-cromfs-" */
+#define CROMFS_VHDR_SIZE     8	/*  8-11:  Number of bytes in the image */
+#define CROMFS_VHDR_ROOT    12	/* 12-15:  Offset of the root directory node */
+#define CROMFS_VHDR_BSIZE   16	/* 16-19:  Uncompressed size of a data block */
+#define CROMFS_VHDR_NNODES  20	/* 20-23:  Number of nodes */
+#define CROMFS_VHDR_NBLOCKS 24	/* 24-27:  Number of data blocks */
+#define CROMFS_VHDR_USIZE   28	/* 28-31:  Uncompressed size of all files */
+#define CROMFS_VHDR_LEN     32
+
+#define CROMFS_MAGIC_STRING  "-cromfs-"
+
+/* Node header (multi-byte values are little-endian).  A node is followed by
+ * its NUL-terminated name, padded to a 4 byte boundary.  The root directory
+ * has an empty name.
+ */
+
+#define CROMFS_NODE_PEER     0	/*  0-3:   Offset of the next node in the same
+								 *         directory (zero if no more) */
+#define CROMFS_NODE_INFO     4	/*  4-7:   Directory: offset of the first node
+								 *         (zero if empty). File: offset of the
+								 *         block table */
+#define CROMFS_NODE_SIZE     8	/*  8-11:  File: uncompressed size in bytes */
+#define CROMFS_NODE_MODE    12	/* 12-13:  Node type and flags */
+#define CROMFS_NODE_NAMELEN 14	/* 14-15:  Length of the name */
+#define CROMFS_NODE_NAME    16	/* 16-..:  Name */
+
+#define CROMFS_MODE_DIRECTORY 1
+#define CROMFS_MODE_FILE      2
+#define CROMFS_MODE_TYPEMASK  7
+#define CROMFS_MODE_EXEC      8
+
+/* The block table of a file of N blocks holds N+1 32-bit offsets: block n
+ * occupies the bytes from entry n up to entry n+1.  Each block holds
+ * cv_bsize bytes of the file (less for the last block) as an LZ4 block, or
+ * is stored as is if LZ4 does not make it any smaller.
+ */
+
+/* Largest supported data block */
+
+#define CROMFS_MAX_BSIZE   65536
+
+/* Maximum number of nested directories followed by a path */
+
+#define CROMFS_MAX_DEPTH   32
+
+#ifndef CONFIG_FS_CROMFS_NCACHED
+#define CONFIG_FS_CROMFS_NCACHED 2
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A decompressed data block */
+
+struct cromfs_cache_s {
+	uint32_t cc_offset;			/* Image offset of the compressed block, 0: unused */
+	uint32_t cc_age;			/* Last use, to replace the least recently used */
+	uint32_t cc_len;			/* Number of valid bytes in cc_data */
+	uint8_t *cc_data;			/* cm_bsize bytes */
+};
+
+/* This structure represents the overall mountpoint state.  An instance of
+ * this structure is retained as inode private data on each mountpoint that
+ * is mounted with a cromfs filesystem.
+ */
+
+struct cromfs_file_s;
+struct cromfs_mountpt_s {
+	struct inode *cm_blkdriver;	/* The block driver inode that hosts the image */
+	struct cromfs_file_s *cm_head;	/* A list to all files opened on this mountpoint */
+
+	bool cm_mounted;			/* true: The file system is ready */
+	uint16_t cm_hwsectorsize;	/* HW: Sector size reported by block driver */
+	sem_t cm_sem;				/* Used to assume thread-safe access */
+	uint32_t cm_hwnsectors;		/* HW: The number of sectors reported by the hardware */
+	uint32_t cm_volsize;		/* Size of the image */
+	uint32_t cm_rootoffset;		/* Offset of the root directory node */
+	uint32_t cm_bsize;			/* Uncompressed size of a data block */
+	uint32_t cm_nblocks;		/* Number of data blocks in the image */
+	uint32_t cm_cachesector;	/* Current sector in the cm_buffer */
+	uint32_t cm_age;			/* Source of cc_age */
+	uint8_t *cm_xipbase;		/* Base address of directly accessible media */
+	uint8_t *cm_buffer;			/* Device sector buffer, allocated if cm_xipbase==0 */
+	uint8_t *cm_cbuffer;		/* Compressed block buffer, allocated if cm_xipbase==0 */
+	struct cromfs_cache_s cm_cache[CONFIG_FS_CROMFS_NCACHED];
+};
+
+/* This structure represents on open file under the mountpoint.  An instance
+ * of this structure is retained as struct file specific information on each
+ * opened file.
+ */
+
+struct cromfs_file_s {
+	struct cromfs_file_s *cf_next;	/* Retained in a singly linked list */
+	uint32_t cf_table;			/* Offset of the block table */
+	uint32_t cf_size;			/* Size of the file in bytes */
+};
+
+/* A node as found by walking a path */
+
+struct cromfs_nodeinfo_s {
+	uint32_t ci_offset;			/* Offset of the node */
+	uint32_t ci_peer;			/* Offset of the next node in the directory */
+	uint32_t ci_info;			/* First child or block table */
+	uint32_t ci_size;			/* Size (if file) */
+	uint16_t ci_mode;			/* CROMFS_MODE_* */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+EXTERN void cromfs_semtake(struct cromfs_mountpt_s *cm);
+EXTERN void cromfs_semgive(struct cromfs_mountpt_s *cm);
+EXTERN int cromfs_devread(struct cromfs_mountpt_s *cm, uint32_t offset, void *buffer, uint32_t nbytes);
+EXTERN int cromfs_hwconfigure(struct cromfs_mountpt_s *cm);
+EXTERN int cromfs_fsconfigure(struct cromfs_mountpt_s *cm);
+EXTERN void cromfs_release(struct cromfs_mountpt_s *cm);
+EXTERN int cromfs_checkmount(struct cromfs_mountpt_s *cm);
+EXTERN int cromfs_parsenode(struct cromfs_mountpt_s *cm, uint32_t offset, struct cromfs_nodeinfo_s *node);
+EXTERN int cromfs_parsename(struct cromfs_mountpt_s *cm, uint32_t offset, char *name);
+EXTERN int cromfs_findnode(struct cromfs_mountpt_s *cm, const char *path, struct cromfs_nodeinfo_s *node);
+EXTERN ssize_t cromfs_readblocks(struct cromfs_mountpt_s *cm, struct cromfs_file_s *cf, uint32_t pos, uint8_t *buffer, size_t buflen);
+EXTERN int cromfs_lz4_decompress(const uint8_t *src, uint32_t srclen, uint8_t *dst, uint32_t dstlen);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __FS_CROMFS_FS_CROMFS_H */
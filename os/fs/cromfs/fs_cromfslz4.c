@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/cromfs/fs_cromfslz4.c
+ *
+ * Decoder of the LZ4 block format.  A block is a series of sequences; each
+ * starts with a token whose upper nibble is the number of literals and the
+ * lower nibble the match length minus 4, both extended by further bytes
+ * while they read 255.  The literals follow, then the 16-bit little-endian
+ * distance back to the match.  The last sequence has literals only.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "fs_cromfs.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZ4_MINMATCH   4
+#define LZ4_RUNMASK    15
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_length
+ *
+ * Description:
+ *   Add the extension bytes of a length whose nibble was saturated.
+ *
+ ****************************************************************************/
+
+static inline int lz4_length(const uint8_t **pip, const uint8_t *iend, uint32_t *plen)
+{
+	const uint8_t *ip = *pip;
+	uint32_t len = *plen;
+	uint8_t b;
+
+	do {
+		if (ip >= iend) {
+			return -EIO;
+		}
+
+		b = *ip++;
+		len += b;
+	} while (b == 255);
+
+	*pip = ip;
+	*plen = len;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cromfs_lz4_decompress
+ *
+ * Description:
+ *   Decode the LZ4 block of srclen bytes at src into the dstlen bytes at
+ *   dst.  All lengths and distances are checked so that a corrupted image
+ *   cannot write outside of dst.
+ *
+ * Returned Value:
+ *   The number of bytes decoded, or -EIO if the block is corrupted.
+ *
+ ****************************************************************************/
+
+int cromfs_lz4_decompress(const uint8_t *src, uint32_t srclen, uint8_t *dst, uint32_t dstlen)
+{
+	const uint8_t *ip = src;
+	const uint8_t *iend = src + srclen;
+	const uint8_t *match;
+	uint8_t *op = dst;
+	uint8_t *oend = dst + dstlen;
+	uint32_t offset;
+	uint32_t len;
+	uint32_t run;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Copy the literals */
+
+		len = token >> 4;
+		if (len == LZ4_RUNMASK && lz4_length(&ip, iend, &len) < 0) {
+			return -EIO;
+		}
+
+		if (len > (uint32_t)(iend - ip) || len > (uint32_t)(oend - op)) {
+			return -EIO;
+		}
+
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* The last sequence ends with its literals */
+
+		if (ip >= iend) {
+			break;
+		}
+
+		/* Copy the match */
+
+		if (iend - ip < 2) {
+			return -EIO;
+		}
+
+		offset = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (uint32_t)(op - dst)) {
+			return -EIO;
+		}
+
+		len = token & LZ4_RUNMASK;
+		if (len == LZ4_RUNMASK && lz4_length(&ip, iend, &len) < 0) {
+			return -EIO;
+		}
+
+		len += LZ4_MINMATCH;
+		if (len > (uint32_t)(oend - op)) {
+			return -EIO;
+		}
+
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+		} else if (offset == 1) {
+			memset(op, *match, len);
+		} else {
+			/* The match overlaps the bytes being written, so it repeats
+			 * with a period of offset.  Each copy doubles the repeated run
+			 * behind match, which lets every copy be a plain memcpy().
+			 */
+
+			run = offset;
+			while (len > run) {
+				memcpy(op, match, run);
+				op += run;
+				len -= run;
+				run <<= 1;
+			}
+
+			memcpy(op, match, len);
+		}
+
+		op += len;
+	}
+
+	return (int)(op - dst);
+}
@@ -0,0 +1,652 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/cromfs/fs_cromfsutil.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/dirent.h>
+
+#include "fs_cromfs.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cromfs_get16/cromfs_get32
+ *
+ * Description:
+ *   Read a little-endian value of the image
+ *
+ ****************************************************************************/
+
+static inline uint16_t cromfs_get16(const uint8_t *p)
+{
+	return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint32_t cromfs_get32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/****************************************************************************
+ * Name: cromfs_hwread
+ *
+ * Description:
+ *   Read sectors from the block driver
+ *
+ ****************************************************************************/
+
+static int cromfs_hwread(struct cromfs_mountpt_s *cm, uint8_t *buffer, uint32_t sector, unsigned int nsectors)
+{
+	struct inode *inode = cm->cm_blkdriver;
+	ssize_t nsectorsread;
+
+	DEBUGASSERT(inode);
+	if (inode->u.i_bops && inode->u.i_bops->read) {
+		nsectorsread = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+		if (nsectorsread == (ssize_t)nsectors) {
+			return OK;
+		} else if (nsectorsread < 0) {
+			return nsectorsread;
+		}
+	}
+
+	return -ENODEV;
+}
+
+/****************************************************************************
+ * Name: cromfs_decode
+ *
+ * Description:
+ *   Decompress the clen bytes of the block at offset into the ulen bytes at
+ *   dst.  On XIP media the block is decoded in place, otherwise it is read
+ *   into the compressed block buffer first.
+ *
+ ****************************************************************************/
+
+static int cromfs_decode(struct cromfs_mountpt_s *cm, uint32_t offset, uint32_t clen, uint8_t *dst, uint32_t ulen)
+{
+	const uint8_t *src;
+	int ret;
+
+	if (cm->cm_xipbase) {
+		src = cm->cm_xipbase + offset;
+	} else {
+		ret = cromfs_devread(cm, offset, cm->cm_cbuffer, clen);
+		if (ret < 0) {
+			return ret;
+		}
+
+		src = cm->cm_cbuffer;
+	}
+
+	ret = cromfs_lz4_decompress(src, clen, dst, ulen);
+	if (ret != (int)ulen) {
+		fdbg("Corrupted block at %08x: %d\n", offset, ret);
+		return -EIO;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_cacheblock
+ *
+ * Description:
+ *   Return the decompressed block at offset, replacing the least recently
+ *   used cached block if it is not cached yet.
+ *
+ ****************************************************************************/
+
+static struct cromfs_cache_s *cromfs_cacheblock(struct cromfs_mountpt_s *cm, uint32_t offset, uint32_t clen, uint32_t ulen)
+{
+	struct cromfs_cache_s *cache;
+	struct cromfs_cache_s *victim = &cm->cm_cache[0];
+	int i;
+
+	for (i = 0; i < CONFIG_FS_CROMFS_NCACHED; i++) {
+		cache = &cm->cm_cache[i];
+		if (cache->cc_offset == offset) {
+			cache->cc_age = ++cm->cm_age;
+			return cache;
+		}
+
+		if (cache->cc_age < victim->cc_age) {
+			victim = cache;
+		}
+	}
+
+	victim->cc_offset = 0;
+	if (cromfs_decode(cm, offset, clen, victim->cc_data, ulen) < 0) {
+		return NULL;
+	}
+
+	victim->cc_offset = offset;
+	victim->cc_len = ulen;
+	victim->cc_age = ++cm->cm_age;
+	return victim;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cromfs_semtake
+ ****************************************************************************/
+
+void cromfs_semtake(struct cromfs_mountpt_s *cm)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(&cm->cm_sem) != 0) {
+		/* The only case that an error should occur here is if
+		 * the wait was awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: cromfs_semgive
+ ****************************************************************************/
+
+void cromfs_semgive(struct cromfs_mountpt_s *cm)
+{
+	sem_post(&cm->cm_sem);
+}
+
+/****************************************************************************
+ * Name: cromfs_devread
+ *
+ * Description:
+ *   Read nbytes of the image at offset.  Whole sectors are read directly
+ *   into the buffer, partial sectors through the device sector buffer.
+ *
+ ****************************************************************************/
+
+int cromfs_devread(struct cromfs_mountpt_s *cm, uint32_t offset, void *buffer, uint32_t nbytes)
+{
+	uint8_t *dest = (uint8_t *)buffer;
+	uint32_t sectorsize = cm->cm_hwsectorsize;
+	uint32_t sector;
+	uint32_t ndx;
+	uint32_t n;
+	int ret;
+
+	if (offset > cm->cm_volsize || nbytes > cm->cm_volsize - offset) {
+		fdbg("Read beyond the image: %08x+%u\n", offset, nbytes);
+		return -EIO;
+	}
+
+	if (cm->cm_xipbase) {
+		memcpy(dest, cm->cm_xipbase + offset, nbytes);
+		return OK;
+	}
+
+	while (nbytes > 0) {
+		sector = offset / sectorsize;
+		ndx = offset - sector * sectorsize;
+
+		if (ndx == 0 && nbytes >= sectorsize) {
+			n = nbytes / sectorsize;
+			ret = cromfs_hwread(cm, dest, sector, n);
+			if (ret < 0) {
+				return ret;
+			}
+
+			n *= sectorsize;
+		} else {
+			if (cm->cm_cachesector != sector) {
+				ret = cromfs_hwread(cm, cm->cm_buffer, sector, 1);
+				if (ret < 0) {
+					cm->cm_cachesector = (uint32_t)-1;
+					return ret;
+				}
+
+				cm->cm_cachesector = sector;
+			}
+
+			n = sectorsize - ndx;
+			if (n > nbytes) {
+				n = nbytes;
+			}
+
+			memcpy(dest, &cm->cm_buffer[ndx], n);
+		}
+
+		dest += n;
+		offset += n;
+		nbytes -= n;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_hwconfigure
+ *
+ * Description:
+ *   Get the geometry of the block driver and set up access to the media
+ *
+ ****************************************************************************/
+
+int cromfs_hwconfigure(struct cromfs_mountpt_s *cm)
+{
+	struct inode *inode = cm->cm_blkdriver;
+	struct geometry geo;
+	int ret;
+
+	/* Get the underlying device geometry */
+
+#ifdef CONFIG_DEBUG
+	if (!inode || !inode->u.i_bops || !inode->u.i_bops->geometry) {
+		return -ENODEV;
+	}
+#endif
+
+	ret = inode->u.i_bops->geometry(inode, &geo);
+	if (ret != OK) {
+		return ret;
+	}
+
+	if (!geo.geo_available) {
+		return -EBUSY;
+	}
+
+	cm->cm_hwsectorsize = geo.geo_sectorsize;
+	cm->cm_hwnsectors = geo.geo_nsectors;
+	cm->cm_volsize = cm->cm_hwsectorsize * cm->cm_hwnsectors;
+	cm->cm_cachesector = (uint32_t)-1;
+
+	/* Determine if block driver supports the XIP mode of operation.  Then
+	 * all data is read and decompressed directly from the media.
+	 */
+
+	if (inode->u.i_bops->ioctl) {
+		ret = inode->u.i_bops->ioctl(inode, BIOC_XIPBASE, (unsigned long)&cm->cm_xipbase);
+		if (ret == OK && cm->cm_xipbase) {
+			return OK;
+		}
+	}
+
+	cm->cm_xipbase = NULL;
+	cm->cm_buffer = (uint8_t *)kmm_malloc(cm->cm_hwsectorsize);
+	if (!cm->cm_buffer) {
+		return -ENOMEM;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_fsconfigure
+ *
+ * Description:
+ *   Read and verify the volume header and allocate the block buffers
+ *
+ ****************************************************************************/
+
+int cromfs_fsconfigure(struct cromfs_mountpt_s *cm)
+{
+	uint8_t vhdr[CROMFS_VHDR_LEN];
+	uint32_t volsize;
+	uint8_t *data;
+	int ret;
+	int i;
+
+	ret = cromfs_devread(cm, 0, vhdr, CROMFS_VHDR_LEN);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (memcmp(&vhdr[CROMFS_VHDR_MAGIC], CROMFS_MAGIC_STRING, 8) != 0) {
+		fdbg("Not a cromfs image\n");
+		return -EINVAL;
+	}
+
+	volsize = cromfs_get32(&vhdr[CROMFS_VHDR_SIZE]);
+	cm->cm_rootoffset = cromfs_get32(&vhdr[CROMFS_VHDR_ROOT]);
+	cm->cm_bsize = cromfs_get32(&vhdr[CROMFS_VHDR_BSIZE]);
+	cm->cm_nblocks = cromfs_get32(&vhdr[CROMFS_VHDR_NBLOCKS]);
+
+	if (volsize > cm->cm_volsize || cm->cm_rootoffset >= volsize || cm->cm_bsize == 0 || cm->cm_bsize > CROMFS_MAX_BSIZE) {
+		fdbg("Bad volume header: size %u root %u block size %u\n", volsize, cm->cm_rootoffset, cm->cm_bsize);
+		return -EINVAL;
+	}
+
+	cm->cm_volsize = volsize;
+
+	/* Allocate the decompressed block cache and, unless the compressed
+	 * blocks can be decoded in place, a buffer for one compressed block.
+	 */
+
+	data = (uint8_t *)kmm_malloc((CONFIG_FS_CROMFS_NCACHED + (cm->cm_xipbase ? 0 : 1)) * cm->cm_bsize);
+	if (!data) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < CONFIG_FS_CROMFS_NCACHED; i++) {
+		cm->cm_cache[i].cc_offset = 0;
+		cm->cm_cache[i].cc_age = 0;
+		cm->cm_cache[i].cc_data = data;
+		data += cm->cm_bsize;
+	}
+
+	cm->cm_cbuffer = cm->cm_xipbase ? NULL : data;
+	cm->cm_mounted = true;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_release
+ *
+ * Description:
+ *   Free the buffers of the mountpoint
+ *
+ ****************************************************************************/
+
+void cromfs_release(struct cromfs_mountpt_s *cm)
+{
+	if (cm->cm_cache[0].cc_data) {
+		kmm_free(cm->cm_cache[0].cc_data);
+		cm->cm_cache[0].cc_data = NULL;
+	}
+
+	if (cm->cm_buffer) {
+		kmm_free(cm->cm_buffer);
+		cm->cm_buffer = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: cromfs_checkmount
+ *
+ * Description:
+ *   Check if the mountpoint is still valid.
+ *
+ ****************************************************************************/
+
+int cromfs_checkmount(struct cromfs_mountpt_s *cm)
+{
+	struct inode *inode;
+	struct geometry geo;
+	int ret;
+
+	DEBUGASSERT(cm && cm->cm_blkdriver);
+	if (cm->cm_mounted) {
+		inode = cm->cm_blkdriver;
+		if (inode->u.i_bops && inode->u.i_bops->geometry) {
+			ret = inode->u.i_bops->geometry(inode, &geo);
+			if (ret == OK && geo.geo_available && !geo.geo_mediachanged) {
+				return OK;
+			}
+		}
+
+		/* If we get here, the mount is NOT healthy */
+
+		cm->cm_mounted = false;
+	}
+
+	return -ENODEV;
+}
+
+/****************************************************************************
+ * Name: cromfs_parsenode
+ *
+ * Description:
+ *   Read the node header at offset
+ *
+ ****************************************************************************/
+
+int cromfs_parsenode(struct cromfs_mountpt_s *cm, uint32_t offset, struct cromfs_nodeinfo_s *node)
+{
+	uint8_t nhdr[CROMFS_NODE_NAME];
+	int ret;
+
+	ret = cromfs_devread(cm, offset, nhdr, CROMFS_NODE_NAME);
+	if (ret < 0) {
+		return ret;
+	}
+
+	node->ci_offset = offset;
+	node->ci_peer = cromfs_get32(&nhdr[CROMFS_NODE_PEER]);
+	node->ci_info = cromfs_get32(&nhdr[CROMFS_NODE_INFO]);
+	node->ci_size = cromfs_get32(&nhdr[CROMFS_NODE_SIZE]);
+	node->ci_mode = cromfs_get16(&nhdr[CROMFS_NODE_MODE]);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_parsename
+ *
+ * Description:
+ *   Copy the name of the node at offset, truncated to NAME_MAX characters
+ *
+ ****************************************************************************/
+
+int cromfs_parsename(struct cromfs_mountpt_s *cm, uint32_t offset, char *name)
+{
+	uint8_t len[2];
+	uint16_t namelen;
+	int ret;
+
+	ret = cromfs_devread(cm, offset + CROMFS_NODE_NAMELEN, len, 2);
+	if (ret < 0) {
+		return ret;
+	}
+
+	namelen = cromfs_get16(len);
+	if (namelen > NAME_MAX) {
+		namelen = NAME_MAX;
+	}
+
+	ret = cromfs_devread(cm, offset + CROMFS_NODE_NAME, name, namelen);
+	if (ret < 0) {
+		return ret;
+	}
+
+	name[namelen] = '\0';
+	return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_findnode
+ *
+ * Description:
+ *   Walk the path from the root directory and return the node it names
+ *
+ ****************************************************************************/
+
+int cromfs_findnode(struct cromfs_mountpt_s *cm, const char *path, struct cromfs_nodeinfo_s *node)
+{
+	uint8_t name[NAME_MAX + 3];
+	const char *end;
+	uint32_t offset;
+	uint16_t namelen;
+	int depth;
+	int len;
+	int ret;
+
+	ret = cromfs_parsenode(cm, cm->cm_rootoffset, node);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (depth = 0; depth < CROMFS_MAX_DEPTH; depth++) {
+		while (*path == '/') {
+			path++;
+		}
+
+		if (*path == '\0') {
+			return OK;
+		}
+
+		if ((node->ci_mode & CROMFS_MODE_TYPEMASK) != CROMFS_MODE_DIRECTORY) {
+			return -ENOTDIR;
+		}
+
+		end = strchr(path, '/');
+		len = end ? end - path : strlen(path);
+		if (len > NAME_MAX) {
+			return -ENAMETOOLONG;
+		}
+
+		/* Compare the component with the names of the directory, reading
+		 * the name only when the lengths match.
+		 */
+
+		for (offset = node->ci_info; offset != 0; offset = node->ci_peer) {
+			ret = cromfs_devread(cm, offset + CROMFS_NODE_NAMELEN, name, 2 + len);
+			if (ret < 0) {
+				return ret;
+			}
+
+			namelen = cromfs_get16(name);
+			if (namelen == len && memcmp(&name[2], path, len) == 0) {
+				break;
+			}
+
+			ret = cromfs_parsenode(cm, offset, node);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		if (offset == 0) {
+			return -ENOENT;
+		}
+
+		ret = cromfs_parsenode(cm, offset, node);
+		if (ret < 0) {
+			return ret;
+		}
+
+		path += len;
+	}
+
+	return -ELOOP;
+}
+
+/****************************************************************************
+ * Name: cromfs_readblocks
+ *
+ * Description:
+ *   Read buflen bytes of the file at position pos.  Blocks that are stored
+ *   uncompressed are read directly, whole compressed blocks are decoded
+ *   straight into the buffer, and partially read compressed blocks go
+ *   through the block cache.  The caller limits buflen to the file size.
+ *
+ * Returned Value:
+ *   The number of bytes read, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t cromfs_readblocks(struct cromfs_mountpt_s *cm, struct cromfs_file_s *cf, uint32_t pos, uint8_t *buffer, size_t buflen)
+{
+	struct cromfs_cache_s *cache;
+	uint8_t table[8];
+	uint32_t block;
+	uint32_t blkoff;
+	uint32_t start;
+	uint32_t clen;
+	uint32_t ulen;
+	uint32_t n;
+	ssize_t nread = 0;
+	int ret;
+
+	while (buflen > 0) {
+		block = pos / cm->cm_bsize;
+		blkoff = pos - block * cm->cm_bsize;
+
+		/* Find the compressed block in the block table */
+
+		ret = cromfs_devread(cm, cf->cf_table + 4 * block, table, 8);
+		if (ret < 0) {
+			return ret;
+		}
+
+		start = cromfs_get32(&table[0]);
+		clen = cromfs_get32(&table[4]) - start;
+
+		ulen = cf->cf_size - block * cm->cm_bsize;
+		if (ulen > cm->cm_bsize) {
+			ulen = cm->cm_bsize;
+		}
+
+		if (clen > ulen || start > cm->cm_volsize || clen > cm->cm_volsize - start) {
+			fdbg("Bad block table entry %u at %08x\n", block, cf->cf_table);
+			return -EIO;
+		}
+
+		n = ulen - blkoff;
+		if (n > buflen) {
+			n = buflen;
+		}
+
+		if (clen == ulen) {
+			/* The block is stored uncompressed */
+
+			ret = cromfs_devread(cm, start + blkoff, buffer, n);
+		} else if (n == ulen) {
+			/* The whole block is read */
+
+			ret = cromfs_decode(cm, start, clen, buffer, ulen);
+		} else {
+			cache = cromfs_cacheblock(cm, start, clen, ulen);
+			if (cache) {
+				memcpy(buffer, cache->cc_data + blkoff, n);
+				ret = OK;
+			} else {
+				ret = -EIO;
+			}
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		buffer += n;
+		pos += n;
+		nread += n;
+		buflen -= n;
+	}
+
+	return nread;
+}
@@ -56,6 +56,12 @@
 #if defined(CONFIG_FTL_READAHEAD) || defined(CONFIG_FTL_WRITEBUFFER)
 #include <tinyara/rwbuffer.h>
 #endif
+#ifdef CONFIG_FTL_LOG_BGGC
+#include <semaphore.h>
+#include <assert.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -65,10 +71,50 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+/* Erase block header: magic, sequence number, then the logical sector of
+ * each data R/W block of the erase block (FTL_LOG_UNMAPPED if unwritten).
+ */
+
+#  define FTL_LOG_MAGIC            "FTLL"
+#  define FTL_LOG_HDRSIZE          8
+#  define FTL_LOG_UNMAPPED         0xffffffff
+#  define FTL_LOG_IOVS             8	/* Ranges per vectored read */
+
+/* Erase block states */
+
+#  define FTL_LOG_ERASED           0	/* Free and erased */
+#  define FTL_LOG_DIRTY            1	/* Free, must be erased before use */
+#  define FTL_LOG_USED             2	/* Holds a header and data */
+
+/* Fewest stale sectors for a block to be reclaimed in the background */
+
+#  define FTL_LOG_BGGC_MINSTALE(dev) ((dev)->datapages > 4 ? (dev)->datapages >> 2 : 1)
+
+#  ifndef CONFIG_FTL_LOG_BGGC
+#    define ftl_log_lock(dev)
+#    define ftl_log_unlock(dev)
+#  endif
+
+#  define FTL_RELOAD               ftl_log_read
+#  define FTL_FLUSH                ftl_log_write
+#else
+#  define FTL_RELOAD               ftl_reload
+#  define FTL_FLUSH                ftl_flush
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+struct ftl_logblk_s {
+	uint32_t              seq;     /* Sequence number, if used */
+	uint16_t              nvalid;  /* R/W blocks holding current sectors */
+	uint8_t               state;   /* FTL_LOG_ERASED, _DIRTY or _USED */
+};
+#endif
+
 struct ftl_struct_s {
 	FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
 	struct mtd_geometry_s geo;     /* Device geometry */
@@ -76,7 +122,25 @@ struct ftl_struct_s {
 	struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
 #endif
 	uint16_t              blkper;  /* R/W blocks per erase block */
-#ifdef CONFIG_FS_WRITABLE
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+	FAR uint32_t         *map;     /* R/W block of each logical sector */
+	FAR struct ftl_logblk_s *blocks; /* State of each erase block */
+	FAR uint8_t          *hdrbuf;  /* Header of one erase block */
+	FAR uint8_t          *pagebuf; /* One R/W block being reclaimed */
+	uint32_t              nsectors; /* Logical sectors exposed */
+	uint32_t              seq;     /* Sequence of the next opened block */
+	off_t                 active;  /* Erase block appended to, or -1 */
+	off_t                 cursor;  /* Last erase block opened */
+	size_t                nfree;   /* Erased and dirty erase blocks */
+	uint16_t              hdrpages; /* Header R/W blocks per erase block */
+	uint16_t              datapages; /* Data R/W blocks per erase block */
+	uint16_t              nextpage; /* Next data R/W block of the active one */
+	bool                  reclaiming; /* Copying the live sectors of a block */
+#ifdef CONFIG_FTL_LOG_BGGC
+	sem_t                 exclsem; /* Serializes the requests and reclamation */
+	struct work_s         gcwork;  /* Background reclamation work */
+#endif
+#elif defined(CONFIG_FS_WRITABLE)
 	FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
 };
@@ -87,10 +151,18 @@ struct ftl_struct_s {
 
 static int     ftl_open(FAR struct inode *inode);
 static int     ftl_close(FAR struct inode *inode);
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static ssize_t ftl_log_read(FAR void *priv, FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static ssize_t ftl_log_write(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+#else
 static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+#endif
 static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer, size_t start_sector, unsigned int nsectors);
 #ifdef CONFIG_FS_WRITABLE
+#ifndef CONFIG_FTL_LOGSTRUCTURED
+static ssize_t ftl_writearound(FAR struct ftl_struct_s *dev, off_t rwblock, off_t first, size_t count, FAR const uint8_t *buffer);
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+#endif
 static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer, size_t start_sector, unsigned int nsectors);
 #endif
 static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
@@ -146,6 +218,545 @@ static int ftl_close(FAR struct inode *inode)
 	return OK;
 }
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+/****************************************************************************
+ * Name: ftl_log_lock / ftl_log_unlock
+ *
+ * Description:  Get / release exclusive access to the translation table.
+ *               Needed with background reclamation, which runs from the
+ *               work queue while the file system may issue requests.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_BGGC
+static void ftl_log_lock(FAR struct ftl_struct_s *dev)
+{
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait
+		 * was awakened by a signal.
+		 */
+
+		ASSERT(errno == EINTR);
+	}
+}
+
+static void ftl_log_unlock(FAR struct ftl_struct_s *dev)
+{
+	sem_post(&dev->exclsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_allocblock
+ *
+ * Description:  Open a free erase block for appending: erase it if needed
+ *               and write its header.  Free blocks are taken round robin so
+ *               that the erases are spread over the device.
+ *
+ ****************************************************************************/
+
+static int ftl_log_allocblock(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_logblk_s *blk;
+	uint8_t hdr[FTL_LOG_HDRSIZE];
+	off_t eblock;
+	size_t i;
+	ssize_t nxfrd;
+	int ret;
+
+	eblock = dev->cursor;
+	for (i = 0; i < dev->geo.neraseblocks; i++) {
+		if (++eblock >= dev->geo.neraseblocks) {
+			eblock = 0;
+		}
+
+		if (dev->blocks[eblock].state != FTL_LOG_USED) {
+			break;
+		}
+	}
+
+	if (i == dev->geo.neraseblocks) {
+		return -ENOSPC;
+	}
+
+	blk = &dev->blocks[eblock];
+	if (blk->state == FTL_LOG_DIRTY) {
+		ret = MTD_ERASE(dev->mtd, eblock, 1);
+		if (ret < 0) {
+			dbg("ERROR: Erase block=%d failed: %d\n", eblock, ret);
+			return ret;
+		}
+	}
+
+	memcpy(hdr, FTL_LOG_MAGIC, 4);
+	memcpy(&hdr[4], &dev->seq, sizeof(uint32_t));
+	nxfrd = MTD_WRITE(dev->mtd, eblock * dev->geo.erasesize, FTL_LOG_HDRSIZE, hdr);
+	if (nxfrd != FTL_LOG_HDRSIZE) {
+		dbg("ERROR: Write header of erase block %d failed: %d\n", eblock, nxfrd);
+
+		/* Whatever got programmed, the block must be erased before use */
+
+		blk->state = FTL_LOG_DIRTY;
+		return -EIO;
+	}
+
+	blk->state  = FTL_LOG_USED;
+	blk->seq    = dev->seq++;
+	blk->nvalid = 0;
+	dev->nfree--;
+	dev->cursor   = eblock;
+	dev->active   = eblock;
+	dev->nextpage = 0;
+
+	fvdbg("Opened erase block %d seq %u, %d free\n", eblock, blk->seq, dev->nfree);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_findvictim
+ *
+ * Description:  Return the erase block holding the fewest live sectors,
+ *               other than the open one, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static off_t ftl_log_findvictim(FAR struct ftl_struct_s *dev, FAR uint16_t *nvalid)
+{
+	off_t victim = -1;
+	off_t eblock;
+
+	*nvalid = dev->datapages;
+	for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++) {
+		if (dev->blocks[eblock].state == FTL_LOG_USED && eblock != dev->active && (victim < 0 || dev->blocks[eblock].nvalid < *nvalid)) {
+			victim  = eblock;
+			*nvalid = dev->blocks[eblock].nvalid;
+		}
+	}
+
+	return victim;
+}
+
+static int ftl_log_reclaim(FAR struct ftl_struct_s *dev, off_t victim);
+
+/****************************************************************************
+ * Name: ftl_log_append
+ *
+ * Description:  Write one logical sector to the next free R/W block of the
+ *               open erase block, record it in the erase block header and
+ *               make the translation table point to it.  The previous copy
+ *               becomes stale.
+ *
+ *               The last free erase block is kept for the reclamation: it
+ *               is only handed out to the copies of the live sectors.
+ *
+ ****************************************************************************/
+
+static int ftl_log_append(FAR struct ftl_struct_s *dev, uint32_t lsector, FAR const uint8_t *buffer)
+{
+	uint32_t physical;
+	uint32_t old;
+	uint16_t nvalid;
+	off_t victim;
+	off_t offset;
+	ssize_t nxfrd;
+	int ret;
+
+	while (dev->active < 0 || dev->nextpage >= dev->datapages) {
+		if (dev->nfree > 1 || (dev->reclaiming && dev->nfree > 0)) {
+			ret = ftl_log_allocblock(dev);
+		} else if (!dev->reclaiming) {
+			victim = ftl_log_findvictim(dev, &nvalid);
+			if (victim < 0 || nvalid >= dev->datapages) {
+				return -ENOSPC;
+			}
+
+			ret = ftl_log_reclaim(dev, victim);
+		} else {
+			return -ENOSPC;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* The data first: if the entry is not written, the copy is ignored */
+
+	physical = dev->active * dev->blkper + dev->hdrpages + dev->nextpage;
+	nxfrd = MTD_BWRITE(dev->mtd, physical, 1, buffer);
+	if (nxfrd != 1) {
+		dbg("ERROR: Write block %u failed: %d\n", physical, nxfrd);
+		dev->nextpage++;
+		return -EIO;
+	}
+
+	offset = dev->active * dev->geo.erasesize + FTL_LOG_HDRSIZE + dev->nextpage * sizeof(uint32_t);
+	nxfrd = MTD_WRITE(dev->mtd, offset, sizeof(uint32_t), (FAR const uint8_t *)&lsector);
+	dev->nextpage++;
+	if (nxfrd != sizeof(uint32_t)) {
+		dbg("ERROR: Write entry of block %u failed: %d\n", physical, nxfrd);
+		return -EIO;
+	}
+
+	old = dev->map[lsector];
+	if (old != FTL_LOG_UNMAPPED) {
+		dev->blocks[old / dev->blkper].nvalid--;
+	}
+
+	dev->map[lsector] = physical;
+	dev->blocks[dev->active].nvalid++;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reclaim
+ *
+ * Description:  Copy the live sectors of an erase block to the open erase
+ *               block, then erase it.  The header of the victim gives the
+ *               logical sector of each R/W block; it is live if the
+ *               translation table still points to it.
+ *
+ ****************************************************************************/
+
+static int ftl_log_reclaim(FAR struct ftl_struct_s *dev, off_t victim)
+{
+	off_t first = victim * dev->blkper + dev->hdrpages;
+	uint32_t lsector;
+	uint16_t i;
+	ssize_t nxfrd;
+	int ret = OK;
+
+	fvdbg("Reclaiming erase block %d, %d live\n", victim, dev->blocks[victim].nvalid);
+
+	nxfrd = MTD_BREAD(dev->mtd, victim * dev->blkper, dev->hdrpages, dev->hdrbuf);
+	if (nxfrd != dev->hdrpages) {
+		dbg("ERROR: Read header of erase block %d failed: %d\n", victim, nxfrd);
+		return -EIO;
+	}
+
+	dev->reclaiming = true;
+	for (i = 0; i < dev->datapages && dev->blocks[victim].nvalid > 0; i++) {
+		memcpy(&lsector, &dev->hdrbuf[FTL_LOG_HDRSIZE + i * sizeof(uint32_t)], sizeof(uint32_t));
+		if (lsector >= dev->nsectors || dev->map[lsector] != first + i) {
+			continue;
+		}
+
+		nxfrd = MTD_BREAD(dev->mtd, first + i, 1, dev->pagebuf);
+		if (nxfrd != 1) {
+			dbg("ERROR: Read block %d failed: %d\n", first + i, nxfrd);
+			ret = -EIO;
+			break;
+		}
+
+		ret = ftl_log_append(dev, lsector, dev->pagebuf);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	dev->reclaiming = false;
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Nothing refers to the block any more: a power loss before or during
+	 * the erase leaves stale copies with an older sequence number.
+	 */
+
+	ret = MTD_ERASE(dev->mtd, victim, 1);
+	if (ret < 0) {
+		dbg("ERROR: Erase block=%d failed: %d\n", victim, ret);
+		dev->blocks[victim].state = FTL_LOG_DIRTY;
+	} else {
+		dev->blocks[victim].state = FTL_LOG_ERASED;
+	}
+
+	dev->blocks[victim].seq = 0;
+	dev->nfree++;
+	return OK;
+}
+
+#ifdef CONFIG_FTL_LOG_BGGC
+/****************************************************************************
+ * Name: ftl_log_bggc_worker
+ *
+ * Description:  Background reclamation.  Reclaims the erase blocks with the
+ *               fewest live sectors until enough of them are free.  The
+ *               lock is dropped after each block so that requests are only
+ *               held off for one reclamation.
+ *
+ ****************************************************************************/
+
+static void ftl_log_bggc_worker(FAR void *arg)
+{
+	FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+	uint16_t nvalid;
+	off_t victim;
+	int ret;
+
+	for (;;) {
+		ftl_log_lock(dev);
+
+		/* Leave the blocks that would mostly be copied to the writes */
+
+		victim = -1;
+		if (dev->nfree < CONFIG_FTL_LOG_BGGC_FREEBLOCKS) {
+			victim = ftl_log_findvictim(dev, &nvalid);
+			if (nvalid > dev->datapages - FTL_LOG_BGGC_MINSTALE(dev)) {
+				victim = -1;
+			}
+		}
+
+		if (victim < 0) {
+			ftl_log_unlock(dev);
+			break;
+		}
+
+		ret = ftl_log_reclaim(dev, victim);
+		ftl_log_unlock(dev);
+
+		if (ret < 0) {
+			dbg("ERROR: Reclaiming erase block %d failed: %d\n", victim, ret);
+			break;
+		}
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:  Read logical sectors through the translation table.  Each
+ *               run of physically consecutive R/W blocks becomes one range
+ *               of a vectored MTD read.  Sectors never written read as
+ *               erased.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_read(FAR void *priv, FAR uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+	struct mtd_iovec_s iov[FTL_LOG_IOVS];
+	size_t queued = 0;
+	size_t i;
+	size_t run;
+	ssize_t nxfrd;
+	int iovcnt = 0;
+
+	if (startblock < 0 || startblock + nblocks > dev->nsectors) {
+		return -EINVAL;
+	}
+
+	ftl_log_lock(dev);
+	for (i = 0; i < nblocks; i += run) {
+		uint32_t physical = dev->map[startblock + i];
+
+		if (physical == FTL_LOG_UNMAPPED) {
+			memset(buffer + i * dev->geo.blocksize, 0xff, dev->geo.blocksize);
+			run = 1;
+			continue;
+		}
+
+		run = 1;
+		while (i + run < nblocks && dev->map[startblock + i + run] == physical + run) {
+			run++;
+		}
+
+		iov[iovcnt].startblock = physical;
+		iov[iovcnt].nblocks = run;
+		iov[iovcnt].buffer = buffer + i * dev->geo.blocksize;
+		queued += run;
+
+		if (++iovcnt == FTL_LOG_IOVS) {
+			nxfrd = MTD_BREADV(dev->mtd, iov, iovcnt);
+			if (nxfrd != queued) {
+				dbg("ERROR: Read of %d ranges failed: %d\n", iovcnt, nxfrd);
+				ftl_log_unlock(dev);
+				return -EIO;
+			}
+
+			iovcnt = 0;
+			queued = 0;
+		}
+	}
+
+	/* Read the ranges that are left */
+
+	if (iovcnt > 0) {
+		nxfrd = MTD_BREADV(dev->mtd, iov, iovcnt);
+		if (nxfrd != queued) {
+			dbg("ERROR: Read of %d ranges failed: %d\n", iovcnt, nxfrd);
+			ftl_log_unlock(dev);
+			return -EIO;
+		}
+	}
+
+	ftl_log_unlock(dev);
+	return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description:  Append logical sectors to the log
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_write(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+	size_t i;
+	int ret = OK;
+
+	if (startblock < 0 || startblock + nblocks > dev->nsectors) {
+		return -EINVAL;
+	}
+
+	ftl_log_lock(dev);
+	for (i = 0; i < nblocks; i++) {
+		ret = ftl_log_append(dev, startblock + i, buffer + i * dev->geo.blocksize);
+		if (ret < 0) {
+			dbg("ERROR: Write of sector %d failed: %d\n", startblock + i, ret);
+			break;
+		}
+	}
+
+#ifdef CONFIG_FTL_LOG_BGGC
+	if (dev->nfree < CONFIG_FTL_LOG_BGGC_FREEBLOCKS && work_available(&dev->gcwork)) {
+		work_queue(LPWORK, &dev->gcwork, ftl_log_bggc_worker, dev, MSEC2TICK(CONFIG_FTL_LOG_BGGC_DELAY));
+	}
+#endif
+	ftl_log_unlock(dev);
+
+	return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ *
+ * Description:  Size the log and rebuild the translation table from the
+ *               erase block headers.  When several copies of a sector
+ *               exist, the one in the erase block with the highest sequence
+ *               number, and in it the last one, is current.  Erase blocks
+ *               without a valid header are erased before being used.
+ *
+ ****************************************************************************/
+
+static int ftl_log_mount(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_logblk_s *blk;
+	uint32_t lsector;
+	uint32_t physical;
+	uint32_t seq = 0;
+	off_t eblock;
+	uint16_t i;
+	ssize_t nxfrd;
+
+	/* The header holds the magic, the sequence and one entry per R/W block
+	 * left after itself.
+	 */
+
+	dev->hdrpages = 1;
+	while (FTL_LOG_HDRSIZE + (dev->blkper - dev->hdrpages) * sizeof(uint32_t) > dev->hdrpages * dev->geo.blocksize) {
+		dev->hdrpages++;
+	}
+
+	dev->datapages = dev->blkper - dev->hdrpages;
+	if (dev->datapages == 0 || dev->geo.neraseblocks <= CONFIG_FTL_LOG_SPAREBLOCKS) {
+		dbg("ERROR: Device too small for the log\n");
+		return -EINVAL;
+	}
+
+	dev->nsectors = (dev->geo.neraseblocks - CONFIG_FTL_LOG_SPAREBLOCKS) * dev->datapages;
+	dev->map      = (FAR uint32_t *)kmm_malloc(dev->nsectors * sizeof(uint32_t));
+	dev->blocks   = (FAR struct ftl_logblk_s *)kmm_zalloc(dev->geo.neraseblocks * sizeof(struct ftl_logblk_s));
+	dev->hdrbuf   = (FAR uint8_t *)kmm_malloc(dev->hdrpages * dev->geo.blocksize);
+	dev->pagebuf  = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+	if (!dev->map || !dev->blocks || !dev->hdrbuf || !dev->pagebuf) {
+		dbg("ERROR: Failed to allocate the translation table\n");
+		return -ENOMEM;
+	}
+
+	memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+	dev->nfree = 0;
+
+	for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++) {
+		blk = &dev->blocks[eblock];
+
+		nxfrd = MTD_BREAD(dev->mtd, eblock * dev->blkper, dev->hdrpages, dev->hdrbuf);
+		if (nxfrd != dev->hdrpages) {
+			dbg("ERROR: Read header of erase block %d failed: %d\n", eblock, nxfrd);
+			return -EIO;
+		}
+
+		if (memcmp(dev->hdrbuf, FTL_LOG_MAGIC, 4) != 0) {
+			blk->state = FTL_LOG_DIRTY;
+			dev->nfree++;
+			continue;
+		}
+
+		blk->state = FTL_LOG_USED;
+		memcpy(&blk->seq, &dev->hdrbuf[4], sizeof(uint32_t));
+		if (blk->seq >= seq) {
+			seq = blk->seq + 1;
+		}
+
+		for (i = 0; i < dev->datapages; i++) {
+			memcpy(&lsector, &dev->hdrbuf[FTL_LOG_HDRSIZE + i * sizeof(uint32_t)], sizeof(uint32_t));
+			if (lsector >= dev->nsectors) {
+				continue;
+			}
+
+			physical = dev->map[lsector];
+			if (physical == FTL_LOG_UNMAPPED || dev->blocks[physical / dev->blkper].seq <= blk->seq) {
+				dev->map[lsector] = eblock * dev->blkper + dev->hdrpages + i;
+			}
+		}
+	}
+
+	for (lsector = 0; lsector < dev->nsectors; lsector++) {
+		if (dev->map[lsector] != FTL_LOG_UNMAPPED) {
+			dev->blocks[dev->map[lsector] / dev->blkper].nvalid++;
+		}
+	}
+
+	/* Partly written blocks are not appended to after a restart: whether
+	 * their R/W blocks without an entry were programmed is unknown.
+	 */
+
+	dev->seq      = seq;
+	dev->active   = -1;
+	dev->cursor   = dev->geo.neraseblocks - 1;
+	dev->nextpage = 0;
+
+	fvdbg("%u sectors, %d header blocks, %d free erase blocks\n", dev->nsectors, dev->hdrpages, dev->nfree);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_free
+ ****************************************************************************/
+
+static void ftl_log_free(FAR struct ftl_struct_s *dev)
+{
+	if (dev->map) {
+		kmm_free(dev->map);
+	}
+
+	if (dev->blocks) {
+		kmm_free(dev->blocks);
+	}
+
+	if (dev->hdrbuf) {
+		kmm_free(dev->hdrbuf);
+	}
+
+	if (dev->pagebuf) {
+		kmm_free(dev->pagebuf);
+	}
+}
+#endif							/* CONFIG_FTL_LOGSTRUCTURED */
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -153,6 +764,7 @@ static int ftl_close(FAR struct inode *inode)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_FTL_LOGSTRUCTURED
 static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock, size_t nblocks)
 {
 	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
@@ -167,6 +779,7 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock,
 
 	return nread;
 }
+#endif
 
 /****************************************************************************
  * Name: ftl_read
@@ -188,10 +801,50 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #ifdef CONFIG_FTL_READAHEAD
 	return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
 #else
-	return ftl_reload(dev, buffer, start_sector, nsectors);
+	return FTL_RELOAD(dev, buffer, start_sector, nsectors);
 #endif
 }
 
+/****************************************************************************
+ * Name: ftl_writearound
+ *
+ * Description: Write back the erase block at rwblock, held in dev->eblock,
+ *              with 'count' R/W blocks starting at block 'first' of it
+ *              replaced by the user data.  The user data is written in
+ *              place as the middle range of one vectored write instead of
+ *              being copied into dev->eblock first.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_WRITABLE) && !defined(CONFIG_FTL_LOGSTRUCTURED)
+static ssize_t ftl_writearound(FAR struct ftl_struct_s *dev, off_t rwblock, off_t first, size_t count, FAR const uint8_t *buffer)
+{
+	struct mtd_iovec_s iov[3];
+	off_t end = first + count;
+	int iovcnt = 0;
+
+	if (first > 0) {
+		iov[iovcnt].startblock = rwblock;
+		iov[iovcnt].nblocks = first;
+		iov[iovcnt].buffer = dev->eblock;
+		iovcnt++;
+	}
+
+	iov[iovcnt].startblock = rwblock + first;
+	iov[iovcnt].nblocks = count;
+	iov[iovcnt].buffer = (FAR uint8_t *)buffer;
+	iovcnt++;
+
+	if (end < dev->blkper) {
+		iov[iovcnt].startblock = rwblock + end;
+		iov[iovcnt].nblocks = dev->blkper - end;
+		iov[iovcnt].buffer = dev->eblock + end * dev->geo.blocksize;
+		iovcnt++;
+	}
+
+	return MTD_BWRITEV(dev->mtd, iov, iovcnt);
+}
+
 /****************************************************************************
  * Name: ftl_flush
  *
@@ -199,7 +852,6 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
 {
 	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
@@ -247,7 +899,7 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			return ret;
 		}
 
-		/* Copy the user data at the end of the buffered erase block */
+		/* Put the user data at the end of the buffered erase block */
 
 		offset = (startblock & mask) * dev->geo.blocksize;
 
@@ -257,13 +909,11 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			nbytes = dev->geo.erasesize - offset;
 		}
 
-		fvdbg("Copy %d bytes into erase block=%d at offset=%d\n", nbytes, eraseblock, offset);
-
-		memcpy(dev->eblock + offset, buffer, nbytes);
+		fvdbg("Write %d bytes into erase block=%d at offset=%d\n", nbytes, eraseblock, offset);
 
 		/* And write the erase block back to flash */
 
-		nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
+		nxfrd = ftl_writearound(dev, rwblock, startblock & mask, nbytes / dev->geo.blocksize, buffer);
 		if (nxfrd != dev->blkper) {
 			dbg("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
 			return -EIO;
@@ -330,15 +980,14 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 			return ret;
 		}
 
-		/* Copy the user data at the beginning the buffered erase block */
+		/* Put the user data at the beginning the buffered erase block */
 
 		nbytes = remaining * dev->geo.blocksize;
-		fvdbg("Copy %d bytes into erase block=%d at offset=0\n", nbytes, alignedblock);
-		memcpy(dev->eblock, buffer, nbytes);
+		fvdbg("Write %d bytes into erase block=%d at offset=0\n", nbytes, alignedblock);
 
 		/* And write the erase back to flash */
 
-		nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, dev->eblock);
+		nxfrd = ftl_writearound(dev, alignedblock, 0, remaining, buffer);
 		if (nxfrd != dev->blkper) {
 			dbg("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
 			return -EIO;
@@ -368,7 +1017,7 @@ static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer, s
 #ifdef CONFIG_FTL_WRITEBUFFER
 	return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
 #else
-	return ftl_flush(dev, buffer, start_sector, nsectors);
+	return FTL_FLUSH(dev, buffer, start_sector, nsectors);
 #endif
 }
 #endif
@@ -396,7 +1045,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 #else
 		geometry->geo_writeenabled  = false;
 #endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+		geometry->geo_nsectors      = dev->nsectors;
+#else
 		geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
 		geometry->geo_sectorsize    = dev->geo.blocksize;
 
 		fvdbg("available: true mediachanged: false writeenabled: %s\n",
@@ -511,7 +1164,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 
 		/* Allocate one, in-memory erase block buffer */
 
-#ifdef CONFIG_FS_WRITABLE
+#if defined(CONFIG_FS_WRITABLE) && !defined(CONFIG_FTL_LOGSTRUCTURED)
 		dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
 		if (!dev->eblock) {
 			dbg("ERROR: Failed to allocate an erase block buffer\n");
@@ -525,26 +1178,54 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
 		DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+		/* Rebuild the translation table of the log */
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+		dev->map     = NULL;
+		dev->blocks  = NULL;
+		dev->hdrbuf  = NULL;
+		dev->pagebuf = NULL;
+		dev->reclaiming = false;
+#ifdef CONFIG_FTL_LOG_BGGC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+#endif
+
+		ret = ftl_log_mount(dev);
+		if (ret < 0) {
+			ftl_log_free(dev);
+			kmm_free(dev);
+			return ret;
+		}
+#endif
+
 		/* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
 		dev->rwb.blocksize   = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+		dev->rwb.nblocks     = dev->nsectors;
+#else
 		dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#endif
 		dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
 		dev->rwb.wrmaxblocks = dev->blkper;
-		dev->rwb.wrflush     = ftl_flush;
+		dev->rwb.wrflush     = FTL_FLUSH;
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
 		dev->rwb.rhmaxblocks = dev->blkper;
-		dev->rwb.rhreload    = ftl_reload;
+		dev->rwb.rhreload    = FTL_RELOAD;
 #endif
 
 		ret = rwb_initialize(&dev->rwb);
 		if (ret < 0) {
 			dbg("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+			ftl_log_free(dev);
+#endif
 			kmm_free(dev);
 			return ret;
 		}
@@ -559,6 +1240,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		ret = register_blockdriver(devname, &g_bops, 0, dev);
 		if (ret < 0) {
 			dbg("ERROR: register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+			ftl_log_free(dev);
+#endif
 			kmm_free(dev);
 		}
 	}
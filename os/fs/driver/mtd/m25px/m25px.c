@@ -66,6 +66,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <tinyara/arch.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/spi/spi.h>
@@ -99,6 +100,28 @@
 #error  "Memory Type not defined no selected for the flash device"
 #endif
 
+/* Program/erase suspend.  The opcodes differ between vendors: 0x75/0x7a is used
+ * by the Micron, Winbond and GigaDevice parts, 0xb0/0x30 by the Macronix ones.
+ */
+
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+#ifndef CONFIG_M25P_SUSPEND_CMD
+#define CONFIG_M25P_SUSPEND_CMD 0x75
+#endif
+
+#ifndef CONFIG_M25P_RESUME_CMD
+#define CONFIG_M25P_RESUME_CMD 0x7a
+#endif
+
+#ifndef CONFIG_M25P_SUSPEND_LATENCY
+#define CONFIG_M25P_SUSPEND_LATENCY 30
+#endif
+
+#ifndef CONFIG_M25P_RESUME_INTERVAL
+#define CONFIG_M25P_RESUME_INTERVAL 100
+#endif
+#endif
+
 /* M25P Registers *******************************************************************/
 /* Indentification register values */
 
@@ -246,6 +269,11 @@ struct m25p_dev_s {
 #ifdef CONFIG_M25P_SUBSECTOR_ERASE
 	uint8_t subsectorshift;		/* 0, 12 or 13 (4K or 8K) */
 #endif
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	bool busy;					/* A program or erase may be in progress */
+	off_t busystart;			/* Byte range changed by that operation */
+	off_t busyend;
+#endif
 };
 
 /************************************************************************************
@@ -257,11 +285,20 @@ struct m25p_dev_s {
 static void m25p_lock(FAR struct spi_dev_s *dev);
 static inline void m25p_unlock(FAR struct spi_dev_s *dev);
 static inline int m25p_readid(struct m25p_dev_s *priv);
+static uint8_t m25p_readstatus(struct m25p_dev_s *priv);
 static void m25p_waitwritecomplete(struct m25p_dev_s *priv);
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+static void m25p_setbusy(struct m25p_dev_s *priv, off_t offset, off_t nbytes);
+static bool m25p_suspend(struct m25p_dev_s *priv, off_t offset, size_t nbytes);
+static void m25p_resume(struct m25p_dev_s *priv);
+#else
+#define m25p_setbusy(priv, offset, nbytes)
+#endif
 static void m25p_writeenable(struct m25p_dev_s *priv);
 static inline void m25p_sectorerase(struct m25p_dev_s *priv, off_t offset, uint8_t type);
 static inline int m25p_bulkerase(struct m25p_dev_s *priv);
 static inline void m25p_pagewrite(struct m25p_dev_s *priv, FAR const uint8_t *buffer, off_t offset);
+static void m25p_readbytes(struct m25p_dev_s *priv, off_t offset, size_t nbytes, FAR uint8_t *buffer);
 
 /* MTD driver methods */
 
@@ -273,6 +310,8 @@ static ssize_t m25p_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 static ssize_t m25p_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buffer);
 #endif
 static int m25p_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
+static ssize_t m25p_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
+static ssize_t m25p_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
 
 /************************************************************************************
  * Private Data
@@ -433,31 +472,43 @@ static inline int m25p_readid(struct m25p_dev_s *priv)
 }
 
 /************************************************************************************
- * Name: m25p_waitwritecomplete
+ * Name: m25p_readstatus
  ************************************************************************************/
 
-static void m25p_waitwritecomplete(struct m25p_dev_s *priv)
+static uint8_t m25p_readstatus(struct m25p_dev_s *priv)
 {
 	uint8_t status;
 
-	/* Loop as long as the memory is busy with a write cycle */
+	/* Select this FLASH part */
 
-	do {
-		/* Select this FLASH part */
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-		SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
+	/* Send "Read Status Register (RDSR)" command */
 
-		/* Send "Read Status Register (RDSR)" command */
+	(void)SPI_SEND(priv->dev, M25P_RDSR);
 
-		(void)SPI_SEND(priv->dev, M25P_RDSR);
+	/* Send a dummy byte to generate the clock needed to shift out the status */
 
-		/* Send a dummy byte to generate the clock needed to shift out the status */
+	status = SPI_SEND(priv->dev, M25P_DUMMY);
 
-		status = SPI_SEND(priv->dev, M25P_DUMMY);
+	/* Deselect the FLASH */
 
-		/* Deselect the FLASH */
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+	return status;
+}
+
+/************************************************************************************
+ * Name: m25p_waitwritecomplete
+ ************************************************************************************/
 
-		SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+static void m25p_waitwritecomplete(struct m25p_dev_s *priv)
+{
+	uint8_t status;
+
+	/* Loop as long as the memory is busy with a write cycle */
+
+	do {
+		status = m25p_readstatus(priv);
 
 		/* Given that writing could take up to few tens of milliseconds, and erasing
 		 * could take more.  The following short delay in the "busy" case will allow
@@ -471,9 +522,92 @@ static void m25p_waitwritecomplete(struct m25p_dev_s *priv)
 		}
 	} while ((status & M25P_SR_WIP) != 0);
 
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	priv->busy = false;
+#endif
 	fvdbg("Complete\n");
 }
 
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+/************************************************************************************
+ * Name: m25p_setbusy
+ *
+ * Description:
+ *   Remember the byte range of the program or erase that was just started so
+ *   that m25p_suspend() knows which reads may preempt it.
+ *
+ ************************************************************************************/
+
+static void m25p_setbusy(struct m25p_dev_s *priv, off_t offset, off_t nbytes)
+{
+	priv->busy = true;
+	priv->busystart = offset;
+	priv->busyend = offset + nbytes;
+}
+
+/************************************************************************************
+ * Name: m25p_suspend
+ *
+ * Description:
+ *   Suspend the program or erase in progress so that the read of [offset,
+ *   offset + nbytes) can be served right away.  Returns false if nothing was
+ *   suspended, in which case the caller must wait for the operation to finish.
+ *   The SPI bus must be locked; the operation is resumed by m25p_resume()
+ *   before the bus is released.
+ *
+ ************************************************************************************/
+
+static bool m25p_suspend(struct m25p_dev_s *priv, off_t offset, size_t nbytes)
+{
+	/* The contents of the page or sector being changed are undefined while the
+	 * operation is suspended.  Reads of that region have to wait.
+	 */
+
+	if (!priv->busy || (offset < priv->busyend && offset + (off_t)nbytes > priv->busystart)) {
+		return false;
+	}
+
+	if ((m25p_readstatus(priv) & M25P_SR_WIP) == 0) {
+		priv->busy = false;
+		return false;
+	}
+
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
+	(void)SPI_SEND(priv->dev, CONFIG_M25P_SUSPEND_CMD);
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+
+	/* WIP drops once the part has reached the suspended state, which takes at
+	 * most tSUS.  If the operation completed just before the command, the
+	 * command and the later resume are ignored by the part.
+	 */
+
+	up_udelay(CONFIG_M25P_SUSPEND_LATENCY);
+	while ((m25p_readstatus(priv) & M25P_SR_WIP) != 0) {
+	}
+
+	fvdbg("Suspended\n");
+	return true;
+}
+
+/************************************************************************************
+ * Name: m25p_resume
+ ************************************************************************************/
+
+static void m25p_resume(struct m25p_dev_s *priv)
+{
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
+	(void)SPI_SEND(priv->dev, CONFIG_M25P_RESUME_CMD);
+	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+
+	/* Let the operation make some progress before the bus is released.  Without
+	 * this a steady stream of reads could keep the erase suspended forever.
+	 */
+
+	up_udelay(CONFIG_M25P_RESUME_INTERVAL);
+	fvdbg("Resumed\n");
+}
+#endif
+
 /************************************************************************************
  * Name:  m25p_writeenable
  ************************************************************************************/
@@ -547,6 +681,16 @@ static void m25p_sectorerase(struct m25p_dev_s *priv, off_t sector, uint8_t type
 	/* Deselect the FLASH */
 
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+
+#ifdef CONFIG_M25P_SUBSECTOR_ERASE
+	if (type == M25P_SSE) {
+		m25p_setbusy(priv, offset, (off_t)1 << priv->subsectorshift);
+	} else
+#endif
+	{
+		m25p_setbusy(priv, offset, (off_t)1 << priv->sectorshift);
+	}
+
 	fvdbg("Erased\n");
 }
 
@@ -581,6 +725,7 @@ static inline int m25p_bulkerase(struct m25p_dev_s *priv)
 	/* Deselect the FLASH */
 
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+	m25p_setbusy(priv, 0, (off_t)priv->nsectors << priv->sectorshift);
 	fvdbg("Return: OK\n");
 	return OK;
 }
@@ -628,6 +773,7 @@ static inline void m25p_pagewrite(struct m25p_dev_s *priv, FAR const uint8_t *bu
 	/* Deselect the FLASH: Chip Select high */
 
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+	m25p_setbusy(priv, offset, (off_t)1 << priv->pageshift);
 	fvdbg("Written\n");
 }
 
@@ -673,6 +819,7 @@ static inline void m25p_bytewrite(struct m25p_dev_s *priv, FAR const uint8_t *bu
 	/* Deselect the FLASH: Chip Select high */
 
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+	m25p_setbusy(priv, offset, count);
 	fvdbg("Written\n");
 }
 #endif
@@ -795,17 +942,46 @@ static ssize_t m25p_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 
 	fvdbg("offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
+	/* Lock the SPI bus and read */
+
+	m25p_lock(priv->dev);
+	m25p_readbytes(priv, offset, nbytes, buffer);
+	m25p_unlock(priv->dev);
+	fvdbg("return nbytes: %d\n", (int)nbytes);
+	return nbytes;
+}
+
+/************************************************************************************
+ * Name: m25p_readbytes
+ *
+ * Description:
+ *   Read from FLASH with the SPI bus already locked.
+ *
+ ************************************************************************************/
+
+static void m25p_readbytes(struct m25p_dev_s *priv, off_t offset, size_t nbytes, FAR uint8_t *buffer)
+{
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	bool suspended;
+#endif
+
 	/* Wait for any preceding write to complete.  We could simplify things by
 	 * perform this wait at the end of each write operation (rather than at
 	 * the beginning of ALL operations), but have the wait first will slightly
-	 * improve performance.
+	 * improve performance.  If the part supports it, a long erase or program
+	 * is suspended instead and resumed after the read.
 	 */
 
-	m25p_waitwritecomplete(priv);
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	suspended = m25p_suspend(priv, offset, nbytes);
+	if (!suspended)
+#endif
+	{
+		m25p_waitwritecomplete(priv);
+	}
 
-	/* Lock the SPI bus and select this FLASH part */
+	/* Select this FLASH part */
 
-	m25p_lock(priv->dev);
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
 	/* Send "Read from Memory " instruction */
@@ -822,12 +998,78 @@ static ssize_t m25p_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 
 	SPI_RECVBLOCK(priv->dev, buffer, nbytes);
 
-	/* Deselect the FLASH and unlock the SPI bus */
+	/* Deselect the FLASH and resume any suspended operation */
 
 	SPI_SELECT(priv->dev, SPIDEV_FLASH, false);
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	if (suspended) {
+		m25p_resume(priv);
+	}
+#endif
+}
+
+/************************************************************************************
+ * Name: m25p_breadv
+ *
+ * Description:
+ *   Read all ranges back to back without releasing the SPI bus in between.
+ *
+ ************************************************************************************/
+
+static ssize_t m25p_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	FAR struct m25p_dev_s *priv = (FAR struct m25p_dev_s *)dev;
+	ssize_t total = 0;
+	int i;
+
+	fvdbg("iovcnt: %d\n", iovcnt);
+
+	m25p_lock(priv->dev);
+	for (i = 0; i < iovcnt; i++) {
+		if (iov[i].nblocks > 0) {
+			m25p_readbytes(priv, iov[i].startblock << priv->pageshift, iov[i].nblocks << priv->pageshift, iov[i].buffer);
+			total += iov[i].nblocks;
+		}
+	}
+
 	m25p_unlock(priv->dev);
-	fvdbg("return nbytes: %d\n", (int)nbytes);
-	return nbytes;
+	return total;
+}
+
+/************************************************************************************
+ * Name: m25p_bwritev
+ ************************************************************************************/
+
+static ssize_t m25p_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	FAR struct m25p_dev_s *priv = (FAR struct m25p_dev_s *)dev;
+	size_t pagesize = 1 << priv->pageshift;
+	FAR const uint8_t *buffer;
+	ssize_t total = 0;
+	off_t page;
+	size_t n;
+	int i;
+
+	fvdbg("iovcnt: %d\n", iovcnt);
+
+	/* Lock the SPI bus once and write each page of each range */
+
+	m25p_lock(priv->dev);
+	for (i = 0; i < iovcnt; i++) {
+		buffer = iov[i].buffer;
+		page = iov[i].startblock;
+
+		for (n = 0; n < iov[i].nblocks; n++) {
+			m25p_pagewrite(priv, buffer, page);
+			buffer += pagesize;
+			page++;
+		}
+
+		total += iov[i].nblocks;
+	}
+
+	m25p_unlock(priv->dev);
+	return total;
 }
 
 /************************************************************************************
@@ -949,6 +1191,21 @@ static int m25p_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 	}
 	break;
 
+#ifdef CONFIG_M25P_ERASE_SUSPEND
+	case MTDIOC_RDLATENCY: {
+		FAR uint32_t *latency = (FAR uint32_t *)((uintptr_t)arg);
+		if (latency) {
+			/* A read outside the region being changed waits at most for the
+			 * suspend, plus the resume interval of a read that came before it.
+			 */
+
+			*latency = CONFIG_M25P_SUSPEND_LATENCY + CONFIG_M25P_RESUME_INTERVAL;
+			ret = OK;
+		}
+	}
+	break;
+#endif
+
 	case MTDIOC_XIPBASE:
 	default:
 		ret = -ENOTTY;			/* Bad command */
@@ -1001,6 +1258,8 @@ FAR struct mtd_dev_s *m25p_initialize(FAR struct spi_dev_s *dev)
 		priv->mtd.write = m25p_write;
 #endif
 		priv->mtd.ioctl = m25p_ioctl;
+		priv->mtd.breadv = m25p_breadv;
+		priv->mtd.bwritev = m25p_bwritev;
 		priv->dev = dev;
 
 		/* Deselect the FLASH */
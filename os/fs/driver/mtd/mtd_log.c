@@ -0,0 +1,903 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/driver/mtd/mtd_log.c
+ *
+ * Append-only circular record log on an MTD device or partition.
+ *
+ * Every erase block is a segment.  The first write block (page) of a
+ * segment starts with a segment header that holds a sequence number, which
+ * increases by one every time the log moves on to the next segment, and the
+ * erase count of the segment.  Records follow, each with its own header
+ * and CRC; a record never crosses a page.  Records are collected in a page
+ * buffer and every page is written exactly once, so no flash location is
+ * ever programmed twice.
+ *
+ * When the last segment is full the log wraps around and erases the oldest
+ * one.  Segments are therefore erased strictly in turn, which spreads the
+ * wear evenly over the device.
+ *
+ * On registration, the segment with the highest sequence number is the
+ * one being written; the first page of it without a record header is
+ * where appending continues.  A torn page or a record with a bad CRC ends
+ * the scan of its page.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+#include <crc32.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+#include <tinyara/fs/mtdlog.h>
+
+#ifdef CONFIG_MTD_LOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MTDLOG_MAGIC      0x474c544d	/* "MTLG" */
+#define MTDLOG_NOPAGE     UINT32_MAX
+
+#define MTDLOG_SEGHDR     sizeof(struct mtdlog_seghdr_s)
+#define MTDLOG_RECHDR     sizeof(struct mtdlog_rec_s)
+#define MTDLOG_ALIGN(n)   (((n) + 3) & ~3)
+
+/* Bytes of a record header covered by its CRC, ahead of the payload */
+
+#define MTDLOG_CRCHDR     offsetof(struct mtdlog_rec_s, crc)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mtdlog_seghdr_s {
+	uint32_t magic;				/* MTDLOG_MAGIC */
+	uint32_t segseq;			/* Segment sequence number, never 0 */
+	uint32_t erasecnt;			/* Number of times the segment was erased */
+	uint32_t crc;				/* CRC-32 of the fields above */
+};
+
+struct mtdlog_dev_s {
+	FAR struct mtd_dev_s *mtd;	/* Contained MTD interface */
+	sem_t exclsem;				/* Supports mutual exclusion */
+	uint16_t pagesize;			/* Size of a write block */
+	uint16_t woff;				/* Bytes used in wbuf */
+	uint32_t pagesperseg;		/* Write blocks per erase block */
+	uint32_t nsegs;				/* Number of erase blocks */
+	uint32_t head;				/* Segment being written */
+	uint32_t wpage;				/* Page being filled */
+	uint32_t nextseq;			/* Sequence number of the next record */
+	uint32_t rpage;				/* Page held in rbuf */
+	FAR uint32_t *segseq;		/* Sequence number of each segment, 0: unused */
+	FAR uint32_t *erasecnt;		/* Erase count of each segment */
+	FAR uint8_t *wbuf;			/* Page being filled */
+	FAR uint8_t *rbuf;			/* Page cache for reads */
+};
+
+/* Read position of an open file */
+
+struct mtdlog_file_s {
+	uint32_t page;				/* Page of the next record */
+	uint16_t off;				/* Offset of the next record in the page */
+	uint32_t segseq;			/* Sequence number of the page's segment */
+	uint64_t start;				/* Time range of read() */
+	uint64_t end;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int mtdlog_open(FAR struct file *filep);
+static int mtdlog_close(FAR struct file *filep);
+static ssize_t mtdlog_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t mtdlog_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+static int mtdlog_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations mtdlog_fops = {
+	mtdlog_open,				/* open */
+	mtdlog_close,				/* close */
+	mtdlog_read,				/* read */
+	mtdlog_write,				/* write */
+	0,							/* seek */
+	mtdlog_ioctl				/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	, 0							/* poll */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t mtdlog_seg(FAR struct mtdlog_dev_s *dev, uint32_t page)
+{
+	return page / dev->pagesperseg;
+}
+
+/* Offset of the first record in a page */
+
+static inline uint16_t mtdlog_firstoff(FAR struct mtdlog_dev_s *dev, uint32_t page)
+{
+	return (page % dev->pagesperseg) == 0 ? MTDLOG_SEGHDR : 0;
+}
+
+static inline uint32_t mtdlog_maxrecord(FAR struct mtdlog_dev_s *dev)
+{
+	uint32_t max = dev->pagesize - MTDLOG_SEGHDR - MTDLOG_RECHDR;
+
+	return max < UINT16_MAX ? max : UINT16_MAX - 1;
+}
+
+/****************************************************************************
+ * Name: mtdlog_getpage
+ *
+ * Description:
+ *   Return the contents of a page.  The page being filled is served from
+ *   the write buffer.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *mtdlog_getpage(FAR struct mtdlog_dev_s *dev, uint32_t page)
+{
+	ssize_t nread;
+
+	if (page == dev->wpage && mtdlog_seg(dev, page) == dev->head) {
+		return dev->wbuf;
+	}
+
+	if (page != dev->rpage) {
+		nread = MTD_BREAD(dev->mtd, page, 1, dev->rbuf);
+		if (nread != 1) {
+			fdbg("Read of page %u failed: %d\n", page, (int)nread);
+			dev->rpage = MTDLOG_NOPAGE;
+			return NULL;
+		}
+
+		dev->rpage = page;
+	}
+
+	return dev->rbuf;
+}
+
+/****************************************************************************
+ * Name: mtdlog_parse
+ *
+ * Description:
+ *   Check the record at 'off' in a page and copy its header.  Returns false
+ *   if there is no valid record there.
+ *
+ ****************************************************************************/
+
+static bool mtdlog_parse(FAR struct mtdlog_dev_s *dev, FAR const uint8_t *buf, uint16_t off, FAR struct mtdlog_rec_s *rec)
+{
+	if (off + MTDLOG_RECHDR > dev->pagesize) {
+		return false;
+	}
+
+	memcpy(rec, &buf[off], MTDLOG_RECHDR);
+	if (rec->len == 0 || rec->len == UINT16_MAX || off + MTDLOG_RECHDR + rec->len > dev->pagesize) {
+		return false;
+	}
+
+	return crc32part(&buf[off + MTDLOG_RECHDR], rec->len, crc32(&buf[off], MTDLOG_CRCHDR)) == rec->crc;
+}
+
+/* True if a record header location was never written */
+
+static bool mtdlog_erased(FAR const uint8_t *buf)
+{
+	int i;
+
+	for (i = 1; i < MTDLOG_RECHDR; i++) {
+		if (buf[i] != buf[0]) {
+			return false;
+		}
+	}
+
+	return buf[0] == 0xff || buf[0] == 0x00;
+}
+
+/****************************************************************************
+ * Name: mtdlog_flush
+ *
+ * Description:
+ *   Write the page being filled, if it holds any record, and move on to the
+ *   next page.
+ *
+ ****************************************************************************/
+
+static int mtdlog_flush(FAR struct mtdlog_dev_s *dev)
+{
+	ssize_t nwritten;
+
+	if (dev->woff <= mtdlog_firstoff(dev, dev->wpage)) {
+		return OK;
+	}
+
+	nwritten = MTD_BWRITE(dev->mtd, dev->wpage, 1, dev->wbuf);
+	if (nwritten != 1) {
+		fdbg("Write of page %u failed: %d\n", dev->wpage, (int)nwritten);
+		return nwritten < 0 ? (int)nwritten : -EIO;
+	}
+
+	if (dev->rpage == dev->wpage) {
+		dev->rpage = MTDLOG_NOPAGE;
+	}
+
+	dev->wpage++;
+	dev->woff = 0;
+	memset(dev->wbuf, 0xff, dev->pagesize);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtdlog_rotate
+ *
+ * Description:
+ *   Erase the segment after the head, dropping the oldest records, and
+ *   start writing into it.  The segment header goes out with the first page.
+ *
+ ****************************************************************************/
+
+static int mtdlog_rotate(FAR struct mtdlog_dev_s *dev)
+{
+	struct mtdlog_seghdr_s hdr;
+	uint32_t next;
+	int ret;
+
+	next = (dev->head + 1) % dev->nsegs;
+
+	ret = MTD_ERASE(dev->mtd, next, 1);
+	if (ret < 0) {
+		fdbg("Erase of segment %u failed: %d\n", next, ret);
+		return ret;
+	}
+
+	if (mtdlog_seg(dev, dev->rpage) == next) {
+		dev->rpage = MTDLOG_NOPAGE;
+	}
+
+	dev->erasecnt[next]++;
+	dev->segseq[next] = dev->segseq[dev->head] + 1;
+	if (dev->segseq[next] == 0) {
+		dev->segseq[next] = 1;
+	}
+
+	dev->head  = next;
+	dev->wpage = next * dev->pagesperseg;
+
+	hdr.magic    = MTDLOG_MAGIC;
+	hdr.segseq   = dev->segseq[next];
+	hdr.erasecnt = dev->erasecnt[next];
+	hdr.crc      = crc32((FAR const uint8_t *)&hdr, offsetof(struct mtdlog_seghdr_s, crc));
+
+	memset(dev->wbuf, 0xff, dev->pagesize);
+	memcpy(dev->wbuf, &hdr, MTDLOG_SEGHDR);
+	dev->woff = MTDLOG_SEGHDR;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtdlog_append
+ ****************************************************************************/
+
+static int mtdlog_append(FAR struct mtdlog_dev_s *dev, uint32_t sec, uint16_t msec, FAR const void *data, size_t len)
+{
+	struct mtdlog_rec_s rec;
+	size_t need;
+	int ret;
+
+	if (len == 0 || len > mtdlog_maxrecord(dev)) {
+		return -EINVAL;
+	}
+
+	need = MTDLOG_ALIGN(MTDLOG_RECHDR + len);
+	if (dev->woff + need > dev->pagesize) {
+		ret = mtdlog_flush(dev);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* Move on to the next segment when the head segment is full */
+
+	if (mtdlog_seg(dev, dev->wpage) != dev->head) {
+		ret = mtdlog_rotate(dev);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	rec.len  = len;
+	rec.msec = msec;
+	rec.seq  = dev->nextseq++;
+	rec.sec  = sec;
+	rec.crc  = crc32part(data, len, crc32((FAR const uint8_t *)&rec, MTDLOG_CRCHDR));
+
+	memcpy(&dev->wbuf[dev->woff], &rec, MTDLOG_RECHDR);
+	memcpy(&dev->wbuf[dev->woff + MTDLOG_RECHDR], data, len);
+	dev->woff += need;
+
+	/* Write the page as soon as no further record can fit */
+
+	if (dev->woff + MTDLOG_ALIGN(MTDLOG_RECHDR + 1) > dev->pagesize) {
+		return mtdlog_flush(dev);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtdlog_oldest
+ *
+ * Description:
+ *   Return the segment holding the oldest records, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int mtdlog_oldest(FAR struct mtdlog_dev_s *dev)
+{
+	uint32_t seg;
+	int oldest = -1;
+
+	for (seg = 0; seg < dev->nsegs; seg++) {
+		if (dev->segseq[seg] != 0 && (oldest < 0 || (int32_t)(dev->segseq[seg] - dev->segseq[oldest]) < 0)) {
+			oldest = seg;
+		}
+	}
+
+	return oldest;
+}
+
+/* Move the read position to the first record of a segment */
+
+static void mtdlog_setpos(FAR struct mtdlog_dev_s *dev, FAR struct mtdlog_file_s *priv, uint32_t seg)
+{
+	priv->page   = seg * dev->pagesperseg;
+	priv->off    = MTDLOG_SEGHDR;
+	priv->segseq = dev->segseq[seg];
+}
+
+/****************************************************************************
+ * Name: mtdlog_seek
+ *
+ * Description:
+ *   Move the read position to the start of the last segment whose first
+ *   record is not younger than 'start'.  read() skips the remaining older
+ *   records.  Records are assumed to be appended in time order.
+ *
+ ****************************************************************************/
+
+static void mtdlog_seek(FAR struct mtdlog_dev_s *dev, FAR struct mtdlog_file_s *priv, uint64_t start)
+{
+	FAR const uint8_t *buf;
+	struct mtdlog_rec_s rec;
+	uint32_t seg;
+	uint32_t i;
+	int oldest;
+
+	priv->segseq = 0;
+	oldest = mtdlog_oldest(dev);
+	if (oldest < 0) {
+		return;
+	}
+
+	mtdlog_setpos(dev, priv, oldest);
+
+	for (i = 1; i < dev->nsegs; i++) {
+		seg = (oldest + i) % dev->nsegs;
+		if (dev->segseq[seg] != dev->segseq[oldest] + i) {
+			break;
+		}
+
+		buf = mtdlog_getpage(dev, seg * dev->pagesperseg);
+		if (!buf || !mtdlog_parse(dev, buf, MTDLOG_SEGHDR, &rec)) {
+			continue;
+		}
+
+		if (MTDLOG_TIME(rec.sec, rec.msec) > start) {
+			break;
+		}
+
+		mtdlog_setpos(dev, priv, seg);
+	}
+}
+
+/****************************************************************************
+ * Name: mtdlog_scanseg
+ *
+ * Description:
+ *   Find the first unused page of a segment and the sequence number of the
+ *   last valid record in it.  Returns the page after the segment if it is
+ *   full.
+ *
+ ****************************************************************************/
+
+static uint32_t mtdlog_scanseg(FAR struct mtdlog_dev_s *dev, uint32_t seg, FAR uint32_t *lastseq, FAR bool *found)
+{
+	FAR const uint8_t *buf;
+	struct mtdlog_rec_s rec;
+	uint32_t page;
+	uint16_t off;
+
+	for (page = seg * dev->pagesperseg; page < (seg + 1) * dev->pagesperseg; page++) {
+		buf = mtdlog_getpage(dev, page);
+		off = mtdlog_firstoff(dev, page);
+		if (buf && mtdlog_erased(&buf[off])) {
+			break;
+		}
+
+		/* A page that cannot be read or is torn is treated as used */
+
+		while (buf && mtdlog_parse(dev, buf, off, &rec)) {
+			*lastseq = rec.seq;
+			*found = true;
+			off += MTDLOG_ALIGN(MTDLOG_RECHDR + rec.len);
+		}
+	}
+
+	return page;
+}
+
+/****************************************************************************
+ * Name: mtdlog_mount
+ *
+ * Description:
+ *   Recover the state of the log from the device.
+ *
+ ****************************************************************************/
+
+static void mtdlog_mount(FAR struct mtdlog_dev_s *dev)
+{
+	FAR const uint8_t *buf;
+	struct mtdlog_seghdr_s hdr;
+	uint32_t lastseq = 0;
+	uint32_t seg;
+	uint32_t i;
+	bool found = false;
+	bool valid = false;
+
+	/* Nothing is buffered yet:  read every page from flash */
+
+	dev->head  = dev->nsegs - 1;
+	dev->wpage = MTDLOG_NOPAGE;
+
+	for (seg = 0; seg < dev->nsegs; seg++) {
+		dev->segseq[seg] = 0;
+		dev->erasecnt[seg] = 0;
+
+		buf = mtdlog_getpage(dev, seg * dev->pagesperseg);
+		if (!buf) {
+			continue;
+		}
+
+		memcpy(&hdr, buf, MTDLOG_SEGHDR);
+		if (hdr.magic != MTDLOG_MAGIC || hdr.segseq == 0 || hdr.crc != crc32(buf, offsetof(struct mtdlog_seghdr_s, crc))) {
+			continue;
+		}
+
+		dev->segseq[seg] = hdr.segseq;
+		dev->erasecnt[seg] = hdr.erasecnt;
+		if (!valid || (int32_t)(hdr.segseq - dev->segseq[dev->head]) > 0) {
+			dev->head = seg;
+			valid = true;
+		}
+	}
+
+	memset(dev->wbuf, 0xff, dev->pagesize);
+	dev->woff = 0;
+
+	if (!valid) {
+		/* No log yet:  the first append rotates into segment 0 */
+
+		dev->wpage = dev->nsegs * dev->pagesperseg;
+		dev->nextseq = 1;
+		return;
+	}
+
+	/* Appending continues after the last used page of the head segment.
+	 * If the head segment has no valid record, look for the last one in
+	 * the segments before it.
+	 */
+
+	dev->wpage = mtdlog_scanseg(dev, dev->head, &lastseq, &found);
+
+	for (i = 1, seg = dev->head; !found && i < dev->nsegs; i++) {
+		uint32_t prev = (seg + dev->nsegs - 1) % dev->nsegs;
+
+		if (dev->segseq[prev] == 0 || dev->segseq[prev] + 1 != dev->segseq[seg]) {
+			break;
+		}
+
+		seg = prev;
+		(void)mtdlog_scanseg(dev, seg, &lastseq, &found);
+	}
+
+	dev->nextseq = lastseq + 1;
+	fvdbg("head segment %u, page %u, next record %u\n", dev->head, dev->wpage, dev->nextseq);
+}
+
+/****************************************************************************
+ * Name: mtdlog_open
+ ****************************************************************************/
+
+static int mtdlog_open(FAR struct file *filep)
+{
+	FAR struct mtdlog_file_s *priv;
+
+	priv = (FAR struct mtdlog_file_s *)kmm_zalloc(sizeof(struct mtdlog_file_s));
+	if (!priv) {
+		return -ENOMEM;
+	}
+
+	priv->end = UINT64_MAX;
+	filep->f_priv = priv;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtdlog_close
+ ****************************************************************************/
+
+static int mtdlog_close(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct mtdlog_dev_s *dev = inode->i_private;
+	int ret = OK;
+
+	/* Closing a writer makes its records persistent */
+
+	if ((filep->f_oflags & O_WROK) != 0) {
+		while (sem_wait(&dev->exclsem) < 0) ;
+		ret = mtdlog_flush(dev);
+		sem_post(&dev->exclsem);
+	}
+
+	kmm_free(filep->f_priv);
+	filep->f_priv = NULL;
+	return ret;
+}
+
+/****************************************************************************
+ * Name: mtdlog_read
+ *
+ * Description:
+ *   Return the next record in the time range, header first.
+ *
+ ****************************************************************************/
+
+static ssize_t mtdlog_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct mtdlog_dev_s *dev = inode->i_private;
+	FAR struct mtdlog_file_s *priv = filep->f_priv;
+	FAR const uint8_t *buf;
+	struct mtdlog_rec_s rec;
+	uint64_t time;
+	uint32_t seg;
+	uint32_t next;
+	ssize_t ret;
+	int oldest;
+
+	if (sem_wait(&dev->exclsem) < 0) {
+		return -errno;
+	}
+
+	for (;;) {
+		/* Restart from the oldest record if the segment under the read
+		 * position was recycled.
+		 */
+
+		seg = mtdlog_seg(dev, priv->page);
+		if (priv->segseq == 0 || dev->segseq[seg] != priv->segseq) {
+			oldest = mtdlog_oldest(dev);
+			if (oldest < 0) {
+				ret = 0;
+				break;
+			}
+
+			mtdlog_setpos(dev, priv, oldest);
+			seg = oldest;
+		}
+
+		/* Stop at the end of the log */
+
+		if (seg == dev->head && (priv->page > dev->wpage || (priv->page == dev->wpage && priv->off >= dev->woff))) {
+			ret = 0;
+			break;
+		}
+
+		buf = mtdlog_getpage(dev, priv->page);
+		if (!buf) {
+			ret = -EIO;
+			break;
+		}
+
+		if (!mtdlog_parse(dev, buf, priv->off, &rec)) {
+			/* No more records in this page */
+
+			if ((priv->page + 1) % dev->pagesperseg != 0) {
+				priv->page++;
+				priv->off = 0;
+				continue;
+			}
+
+			/* Continue with the next segment, if it follows this one */
+
+			next = (seg + 1) % dev->nsegs;
+			if (dev->segseq[next] != priv->segseq + 1) {
+				ret = 0;
+				break;
+			}
+
+			mtdlog_setpos(dev, priv, next);
+			continue;
+		}
+
+		time = MTDLOG_TIME(rec.sec, rec.msec);
+		if (time > priv->end) {
+			ret = 0;
+			break;
+		}
+
+		if (time < priv->start) {
+			priv->off += MTDLOG_ALIGN(MTDLOG_RECHDR + rec.len);
+			continue;
+		}
+
+		if (buflen < MTDLOG_RECHDR + rec.len) {
+			ret = -EMSGSIZE;
+			break;
+		}
+
+		memcpy(buffer, &buf[priv->off], MTDLOG_RECHDR + rec.len);
+		priv->off += MTDLOG_ALIGN(MTDLOG_RECHDR + rec.len);
+		ret = MTDLOG_RECHDR + rec.len;
+		break;
+	}
+
+	sem_post(&dev->exclsem);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: mtdlog_write
+ *
+ * Description:
+ *   Append one record time stamped with the current time.
+ *
+ ****************************************************************************/
+
+static ssize_t mtdlog_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct mtdlog_dev_s *dev = inode->i_private;
+	struct timespec ts;
+	int ret;
+
+	(void)clock_gettime(CLOCK_REALTIME, &ts);
+
+	if (sem_wait(&dev->exclsem) < 0) {
+		return -errno;
+	}
+
+	ret = mtdlog_append(dev, ts.tv_sec, ts.tv_nsec / 1000000, buffer, buflen);
+	sem_post(&dev->exclsem);
+
+	return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: mtdlog_ioctl
+ ****************************************************************************/
+
+static int mtdlog_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct mtdlog_dev_s *dev = inode->i_private;
+	FAR struct mtdlog_file_s *priv = filep->f_priv;
+	int ret = -ENOTTY;
+
+	if (sem_wait(&dev->exclsem) < 0) {
+		return -errno;
+	}
+
+	switch (cmd) {
+	case MTDLOGIOC_APPEND: {
+		FAR struct mtdlog_append_s *app = (FAR struct mtdlog_append_s *)((uintptr_t)arg);
+
+		ret = app ? mtdlog_append(dev, app->sec, app->msec, app->data, app->len) : -EINVAL;
+	}
+	break;
+
+	case MTDLOGIOC_FLUSH:
+		ret = mtdlog_flush(dev);
+		break;
+
+	case MTDLOGIOC_SETRANGE: {
+		FAR struct mtdlog_range_s *range = (FAR struct mtdlog_range_s *)((uintptr_t)arg);
+
+		if (!range || range->start > range->end) {
+			ret = -EINVAL;
+			break;
+		}
+
+		priv->start = range->start;
+		priv->end   = range->end;
+		mtdlog_seek(dev, priv, range->start);
+		ret = OK;
+	}
+	break;
+
+	case MTDLOGIOC_REWIND:
+		priv->start  = 0;
+		priv->end    = UINT64_MAX;
+		priv->segseq = 0;
+		ret = OK;
+		break;
+
+	case MTDLOGIOC_INFO: {
+		FAR struct mtdlog_info_s *info = (FAR struct mtdlog_info_s *)((uintptr_t)arg);
+		FAR const uint8_t *buf;
+		struct mtdlog_rec_s rec;
+		uint32_t seg;
+		int oldest;
+
+		if (!info) {
+			ret = -EINVAL;
+			break;
+		}
+
+		info->nsegments = dev->nsegs;
+		info->segsize   = dev->pagesperseg * dev->pagesize;
+		info->pagesize  = dev->pagesize;
+		info->maxrecord = mtdlog_maxrecord(dev);
+		info->next      = dev->nextseq;
+		info->oldest    = dev->nextseq;
+		info->minerase  = UINT32_MAX;
+		info->maxerase  = 0;
+
+		for (seg = 0; seg < dev->nsegs; seg++) {
+			if (dev->erasecnt[seg] < info->minerase) {
+				info->minerase = dev->erasecnt[seg];
+			}
+
+			if (dev->erasecnt[seg] > info->maxerase) {
+				info->maxerase = dev->erasecnt[seg];
+			}
+		}
+
+		oldest = mtdlog_oldest(dev);
+		if (oldest >= 0) {
+			buf = mtdlog_getpage(dev, oldest * dev->pagesperseg);
+			if (buf && mtdlog_parse(dev, buf, MTDLOG_SEGHDR, &rec)) {
+				info->oldest = rec.seq;
+			}
+		}
+
+		ret = OK;
+	}
+	break;
+
+	default:
+		break;
+	}
+
+	sem_post(&dev->exclsem);
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtdlog_register
+ *
+ * Description:
+ *   Register a /dev/mtdlogN device backed by an MTD
+ *
+ ****************************************************************************/
+
+int mtdlog_register(int minor, FAR struct mtd_dev_s *mtd)
+{
+	FAR struct mtdlog_dev_s *dev;
+	struct mtd_geometry_s geo;
+	char devname[16];
+	int ret;
+
+	ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo));
+	if (ret < 0) {
+		fdbg("MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+		return ret;
+	}
+
+	/* A page must hold the segment header and at least one small record,
+	 * and the ring needs two segments.
+	 */
+
+	if (geo.blocksize < 2 * (MTDLOG_SEGHDR + MTDLOG_RECHDR) || geo.erasesize % geo.blocksize != 0 || geo.neraseblocks < 2) {
+		fdbg("Unsupported geometry\n");
+		return -EINVAL;
+	}
+
+	dev = (FAR struct mtdlog_dev_s *)kmm_zalloc(sizeof(struct mtdlog_dev_s));
+	if (!dev) {
+		return -ENOMEM;
+	}
+
+	dev->mtd         = mtd;
+	dev->pagesize    = geo.blocksize;
+	dev->pagesperseg = geo.erasesize / geo.blocksize;
+	dev->nsegs       = geo.neraseblocks;
+	dev->rpage       = MTDLOG_NOPAGE;
+
+	dev->segseq   = (FAR uint32_t *)kmm_malloc(2 * dev->nsegs * sizeof(uint32_t));
+	dev->wbuf     = (FAR uint8_t *)kmm_malloc(2 * dev->pagesize);
+	if (!dev->segseq || !dev->wbuf) {
+		ret = -ENOMEM;
+		goto errout;
+	}
+
+	dev->erasecnt = &dev->segseq[dev->nsegs];
+	dev->rbuf     = &dev->wbuf[dev->pagesize];
+
+	sem_init(&dev->exclsem, 0, 1);
+	mtdlog_mount(dev);
+
+	snprintf(devname, sizeof(devname), "/dev/mtdlog%d", minor);
+	ret = register_driver(devname, &mtdlog_fops, 0666, dev);
+	if (ret < 0) {
+		sem_destroy(&dev->exclsem);
+		goto errout;
+	}
+
+	return OK;
+
+errout:
+	kmm_free(dev->segseq);
+	kmm_free(dev->wbuf);
+	kmm_free(dev);
+	return ret;
+}
+
+#endif							/* CONFIG_MTD_LOG */
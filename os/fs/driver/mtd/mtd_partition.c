@@ -78,6 +78,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Number of ranges of a vectored transfer translated per parent call */
+
+#define PART_IOV_CHUNK 8
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -134,6 +138,8 @@ static ssize_t part_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buffer);
 #endif
 static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
+static ssize_t part_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
+static ssize_t part_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
 
 /* File system methods */
 
@@ -305,6 +311,88 @@ static ssize_t part_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t n
 	return priv->parent->bwrite(priv->parent, startblock + priv->firstblock, nblocks, buf);
 }
 
+/****************************************************************************
+ * Name: part_transferv
+ *
+ * Description:
+ *   Check every range of a vectored transfer against the partition, then
+ *   pass the ranges, offset to the parent, on in chunks of PART_IOV_CHUNK.
+ *
+ ****************************************************************************/
+
+static ssize_t part_transferv(FAR struct mtd_partition_s *priv, FAR const struct mtd_iovec_s *iov, int iovcnt, bool write)
+{
+	struct mtd_iovec_s piov[PART_IOV_CHUNK];
+	ssize_t total = 0;
+	ssize_t ret;
+	size_t nblocks;
+	int n;
+	int i;
+
+	DEBUGASSERT(priv && (iov || iovcnt == 0));
+
+	/* Make sure that no range would extend past the end of the partition
+	 * before anything is transferred.
+	 */
+
+	for (i = 0; i < iovcnt; i++) {
+		if (iov[i].nblocks > 0 && !part_blockcheck(priv, iov[i].startblock + iov[i].nblocks - 1)) {
+			fdbg("ERROR: Transfer beyond the end of the partition\n");
+			return -ENXIO;
+		}
+	}
+
+	while (iovcnt > 0) {
+		n = iovcnt < PART_IOV_CHUNK ? iovcnt : PART_IOV_CHUNK;
+		nblocks = 0;
+
+		for (i = 0; i < n; i++) {
+			piov[i].startblock = iov[i].startblock + priv->firstblock;
+			piov[i].nblocks = iov[i].nblocks;
+			piov[i].buffer = iov[i].buffer;
+			nblocks += iov[i].nblocks;
+		}
+
+		if (write) {
+			ret = MTD_BWRITEV(priv->parent, piov, n);
+		} else {
+			ret = MTD_BREADV(priv->parent, piov, n);
+		}
+
+		if (ret < 0) {
+			return total > 0 ? total : ret;
+		}
+
+		total += ret;
+		if ((size_t)ret != nblocks) {
+			break;
+		}
+
+		iov += n;
+		iovcnt -= n;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: part_breadv
+ ****************************************************************************/
+
+static ssize_t part_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	return part_transferv((FAR struct mtd_partition_s *)dev, iov, iovcnt, false);
+}
+
+/****************************************************************************
+ * Name: part_bwritev
+ ****************************************************************************/
+
+static ssize_t part_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	return part_transferv((FAR struct mtd_partition_s *)dev, iov, iovcnt, true);
+}
+
 /****************************************************************************
  * Name: part_read
  *
@@ -779,6 +867,8 @@ FAR struct mtd_dev_s *mtd_partition(FAR struct mtd_dev_s *mtd, off_t firstblock,
 	part->child.bwrite = part_bwrite;
 	part->child.read = mtd->read ? part_read : NULL;
 	part->child.ioctl = part_ioctl;
+	part->child.breadv = part_breadv;
+	part->child.bwritev = part_bwritev;
 #ifdef CONFIG_MTD_BYTE_WRITE
 	part->child.write = mtd->write ? part_write : NULL;
 #endif
@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/driver/mtd/mtd_vectored.c
+ *
+ * Range by range fallback of the vectored MTD block transfers
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/mtd.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_breadv
+ ****************************************************************************/
+
+ssize_t mtd_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	ssize_t total = 0;
+	ssize_t ret;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		ret = MTD_BREAD(dev, iov[i].startblock, iov[i].nblocks, iov[i].buffer);
+		if (ret < 0) {
+			fdbg("ERROR: Read %d blocks at %d failed: %d\n", (int)iov[i].nblocks, (int)iov[i].startblock, (int)ret);
+			return total > 0 ? total : ret;
+		}
+
+		total += ret;
+		if ((size_t)ret != iov[i].nblocks) {
+			break;
+		}
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: mtd_bwritev
+ ****************************************************************************/
+
+ssize_t mtd_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt)
+{
+	ssize_t total = 0;
+	ssize_t ret;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		ret = MTD_BWRITE(dev, iov[i].startblock, iov[i].nblocks, iov[i].buffer);
+		if (ret < 0) {
+			fdbg("ERROR: Write %d blocks at %d failed: %d\n", (int)iov[i].nblocks, (int)iov[i].startblock, (int)ret);
+			return total > 0 ? total : ret;
+		}
+
+		total += ret;
+		if ((size_t)ret != iov[i].nblocks) {
+			break;
+		}
+	}
+
+	return total;
+}
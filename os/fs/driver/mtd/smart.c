@@ -66,6 +66,8 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -74,11 +76,14 @@
 #include <crc32.h>
 #include <tinyara/math.h>
 #include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart_procfs.h>
 #include <tinyara/fs/smart.h>
+#include <tinyara/metrics.h>
 
 /****************************************************************************
  * Private Definitions
@@ -130,6 +135,15 @@
 #define SMART_WEAR_LEVEL_FORMAT_SIG 32
 #define SMART_PARTNAME_SIZE         4
 
+/* Wear level metrics of a device: lowest and highest wear level of the
+ * erase blocks and number of times their spread went over the limit.
+ */
+
+#define SMART_METRIC_WEARMIN        0
+#define SMART_METRIC_WEARMAX        1
+#define SMART_METRIC_UNEVEN         2
+#define SMART_NMETRICS              3
+
 #define SMART_FIRST_DIR_SECTOR      3	/* First root directory sector */
 
 /* First logical sector number we will use for assignment of requested Alloc
@@ -223,6 +237,21 @@ struct smart_cache_s {
 };
 #endif
 
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+/* One entry of the write-back cache.  It holds the data area (i.e. without
+ * the header) of one logical sector; the bytes in [dirtylo, dirtyhi) have
+ * not been written to the flash yet.
+ */
+
+struct smart_wbentry_s {
+	uint16_t logical;			/* Logical sector number, 0xFFFF if unused */
+	uint16_t dirtylo;			/* First dirty byte of the data */
+	uint16_t dirtyhi;			/* One past the last dirty byte (== dirtylo if clean) */
+	uint32_t birth;				/* The "birthday" of the last access */
+	FAR uint8_t *data;			/* The sector data */
+};
+#endif
+
 /* When CRC is enabled, we allocate sectors in memory only and only write
  * to the device when an actual writesector is performed.  If during the
  * alloc process we do a physical write, we would either have to hold off on
@@ -296,6 +325,24 @@ struct smart_struct_s {
 	uint16_t cache_lastphys;	/* Keep the physical sector number also */
 	uint16_t cache_nextbirth;	/* Sector cache aging value */
 #endif
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	FAR uint8_t *wbbuffer;		/* Storage of the write-back cache data */
+	uint32_t wbnextbirth;		/* Write-back cache aging value */
+	struct smart_wbentry_s
+			wbcache[CONFIG_MTD_SMART_WRITEBACK_NSECTORS];	/* Write-back cache */
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	off_t cpstart;				/* First MTD block of the checkpoint area */
+	uint32_t cpsize;			/* Size of the checkpoint area in bytes */
+	uint16_t cpblocks;			/* Erase blocks of the checkpoint area */
+	bool cpvalid;				/* The checkpoint on the device is current */
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+	sem_t exclsem;				/* Serializes the callers and the collection */
+	struct work_s gcwork;		/* Background garbage collection work */
+	uint16_t gclow;				/* Free sectors that trigger a collection */
+	uint16_t gchigh;			/* Free sectors that end a collection */
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	FAR uint8_t *erasecounts;	/* Number of erases for each erase block */
 #endif
@@ -304,11 +351,24 @@ struct smart_struct_s {
 	struct smart_alloc_s
 			alloc[SMART_MAX_ALLOCS];	/* Array of memory allocations */
 #endif
+#if defined(CONFIG_METRICS) && defined(CONFIG_MTD_SMART_WEAR_LEVEL)
+	char metricname[SMART_NMETRICS][24];	/* "smart<minor><partname>.wear.*" */
+	struct metric_s metrics[SMART_NMETRICS];	/* Wear level metrics */
+#endif
 };
 
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED   0x02
 
+/* Map checkpoint signature and layout version */
+
+#define SMART_CP_MAGIC                 "SMCP"
+#define SMART_CP_VERSION               1
+
+/* Fewest released sectors for a block to be collected in the background */
+
+#define SMART_BGGC_MINRELEASED(dev)    ((dev)->availSectPerBlk > 4 ? (dev)->availSectPerBlk >> 2 : 1)
+
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 struct smart_multiroot_device_s {
 	FAR struct smart_struct_s *dev;
@@ -381,6 +441,36 @@ typedef uint32_t crc_t;
 
 #endif
 
+/* Header of the map checkpoint.  It is stored in the first MTD block of the
+ * checkpoint area and followed, from the next block, by the sector map and
+ * the release and free counts of the erase blocks, as held in RAM.
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+struct smart_cp_header_s {
+	uint8_t magic[4];			/* SMART_CP_MAGIC */
+	uint32_t crc;				/* CRC-32 of the header and of the data */
+	uint32_t datasize;			/* Size of the data following the header */
+	uint32_t unusedsectors;		/* Device statistics at checkpoint time */
+	uint32_t blockerases;
+	uint16_t sectorsize;		/* Geometry the checkpoint was taken with */
+	uint16_t totalsectors;
+	uint16_t neraseblocks;
+	uint16_t freesectors;		/* Sector counts */
+	uint16_t releasesectors;
+	uint16_t lastallocblock;
+	uint16_t reservedsector;
+	uint8_t version;			/* SMART_CP_VERSION */
+	uint8_t released;			/* Erased state while the checkpoint is
+								 * current, programmed when it goes stale */
+	uint8_t formatversion;		/* Format information */
+	uint8_t namesize;
+	uint8_t fmtheader[sizeof(struct smart_sect_header_s)];	/* Header of the
+								 * format sector, to detect a device
+								 * rewritten behind our back */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -401,6 +491,7 @@ static uint16_t smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t
 static int smart_writesector(FAR struct smart_struct_s *dev, unsigned long arg);
 #endif
 static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
+static int smart_readsectors(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
@@ -409,6 +500,25 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+static FAR struct smart_wbentry_s *smart_wb_find(FAR struct smart_struct_s *dev, uint16_t logical);
+static void smart_wb_reset(FAR struct smart_struct_s *dev);
+static int smart_wb_flush(FAR struct smart_struct_s *dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cp_write(FAR struct smart_struct_s *dev);
+static int smart_cp_invalidate(FAR struct smart_struct_s *dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_lock(FAR struct smart_struct_s *dev);
+static void smart_unlock(FAR struct smart_struct_s *dev);
+#else
+#define smart_lock(dev)
+#define smart_unlock(dev)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -519,8 +629,43 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_MTD_SMART_WRITEBACK) || defined(CONFIG_MTD_SMART_CHECKPOINT)
+	FAR struct smart_struct_s *dev;
+	int ret = OK;
+#endif
+
 	fvdbg("Entry\n");
+
+#if defined(CONFIG_MTD_SMART_WRITEBACK) || defined(CONFIG_MTD_SMART_CHECKPOINT)
+	DEBUGASSERT(inode && inode->i_private);
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+	dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+	smart_lock(dev);
+
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	/* Write any cached sector data back to the flash */
+
+	ret = smart_wb_flush(dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Save the map so that the next mount does not need a scan */
+
+	if (ret == OK) {
+		ret = smart_cp_write(dev);
+	}
+#endif
+
+	smart_unlock(dev);
+	return ret;
+#else
 	return OK;
+#endif
 }
 
 /****************************************************************************
@@ -800,6 +945,13 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 
 	/* I think maybe we need to lock on a mutex here */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	ret = smart_cp_invalidate(dev);
+	if (ret < 0) {
+		return ret;
+	}
+#endif
+
 	/* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
 	 * per erase block is a power of 2, and (2) the erase begins with that same
 	 * alignment.
@@ -1007,6 +1159,12 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	dev->cache_nextbirth = 0;
 #endif
 
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	/* The write-back cache is sized for the old sector size */
+
+	smart_wb_reset(dev);
+#endif
+
 	if (dev->rwbuffer != NULL) {
 		smart_free(dev, dev->rwbuffer);
 		dev->rwbuffer = NULL;
@@ -1055,6 +1213,13 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 	dev->totalsectors = (uint16_t)totalsectors;
 
+#ifdef CONFIG_MTD_SMART_BGGC
+	/* Default background collection watermarks for this geometry */
+
+	dev->gclow = (uint16_t)(totalsectors * CONFIG_MTD_SMART_BGGC_LOW / 100);
+	dev->gchigh = (uint16_t)(totalsectors * CONFIG_MTD_SMART_BGGC_HIGH / 100);
+#endif
+
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
 
 	dev->bad_sector_rwbuffer = (uint8_t *)smart_malloc(dev, dev->sectorsize * sizeof(uint8_t), "Bad sector rwbuffer");
@@ -1680,6 +1845,292 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 }
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/****************************************************************************
+ * Name: smart_cp_transfer
+ *
+ * Description: Reads or writes 'size' bytes of checkpoint data starting at
+ *              MTD block 'block'.  Whole blocks are transferred in place,
+ *              the last partial block goes through the rwbuffer; both as
+ *              ranges of one vectored request.
+ *
+ ****************************************************************************/
+
+static int smart_cp_transfer(FAR struct smart_struct_s *dev, off_t block, FAR uint8_t *data, size_t size, bool write)
+{
+	size_t nblocks = size / dev->geo.blocksize;
+	size_t remaining = size - nblocks * dev->geo.blocksize;
+	struct mtd_iovec_s iov[2];
+	int iovcnt = 0;
+	ssize_t ret;
+
+	if (nblocks > 0) {
+		iov[iovcnt].startblock = block;
+		iov[iovcnt].nblocks = nblocks;
+		iov[iovcnt].buffer = data;
+		iovcnt++;
+	}
+
+	if (remaining > 0) {
+		if (write) {
+			memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+			memcpy(dev->rwbuffer, data + nblocks * dev->geo.blocksize, remaining);
+		}
+
+		iov[iovcnt].startblock = block + nblocks;
+		iov[iovcnt].nblocks = 1;
+		iov[iovcnt].buffer = (FAR uint8_t *)dev->rwbuffer;
+		iovcnt++;
+	}
+
+	if (iovcnt == 0) {
+		return OK;
+	}
+
+	if (write) {
+		ret = MTD_BWRITEV(dev->mtd, iov, iovcnt);
+	} else {
+		ret = MTD_BREADV(dev->mtd, iov, iovcnt);
+	}
+
+	if (ret != (ssize_t)(nblocks + (remaining > 0))) {
+		return ret < 0 ? (int)ret : -EIO;
+	}
+
+	if (remaining > 0 && !write) {
+		memcpy(data + nblocks * dev->geo.blocksize, dev->rwbuffer, remaining);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_cp_crc
+ *
+ * Description: Computes the CRC of a checkpoint header and of its data.
+ *              The 'released' byte (programmed after the CRC was written)
+ *              and the CRC itself are excluded.
+ *
+ ****************************************************************************/
+
+static uint32_t smart_cp_crc(FAR const struct smart_cp_header_s *hdr, FAR const uint8_t *data)
+{
+	struct smart_cp_header_s tmp;
+
+	memcpy(&tmp, hdr, sizeof(struct smart_cp_header_s));
+	tmp.crc = 0;
+	tmp.released = CONFIG_SMARTFS_ERASEDSTATE;
+
+	return crc32part(data, hdr->datasize, crc32((FAR const uint8_t *)&tmp, sizeof(struct smart_cp_header_s)));
+}
+
+/****************************************************************************
+ * Name: smart_cp_write
+ *
+ * Description: Saves the sector map and the free and release counts to the
+ *              checkpoint area, unless the checkpoint there is current.
+ *              The data is written first and the header last, so that an
+ *              interrupted checkpoint is never taken for a valid one.
+ *
+ ****************************************************************************/
+
+static int smart_cp_write(FAR struct smart_struct_s *dev)
+{
+	struct smart_cp_header_s hdr;
+	uint16_t fmtsector;
+	int ret;
+
+	if (dev->cpblocks == 0 || dev->cpvalid || dev->formatstatus != SMART_FMT_STAT_FORMATTED) {
+		return OK;
+	}
+
+	memset(&hdr, 0, sizeof(struct smart_cp_header_s));
+	hdr.datasize = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+	if (dev->geo.blocksize + hdr.datasize > dev->cpsize) {
+		/* Formatted with a smaller sector size than the area was sized for */
+
+		fvdbg("Map too large for the checkpoint area\n");
+		return OK;
+	}
+
+	fmtsector = dev->sMap[0];
+	if (fmtsector == 0xFFFF) {
+		return OK;
+	}
+
+	ret = MTD_READ(dev->mtd, fmtsector * dev->mtdBlksPerSector * dev->geo.blocksize, sizeof(struct smart_sect_header_s), hdr.fmtheader);
+	if (ret != sizeof(struct smart_sect_header_s)) {
+		return ret < 0 ? ret : -EIO;
+	}
+
+	ret = MTD_ERASE(dev->mtd, dev->geo.neraseblocks, dev->cpblocks);
+	if (ret < 0) {
+		fdbg("Error %d erasing the checkpoint area\n", -ret);
+		return ret;
+	}
+
+	/* The map and the count arrays are allocated as one buffer */
+
+	ret = smart_cp_transfer(dev, dev->cpstart + 1, (FAR uint8_t *)dev->sMap, hdr.datasize, true);
+	if (ret < 0) {
+		fdbg("Error %d writing the checkpoint\n", -ret);
+		return ret;
+	}
+
+	memcpy(hdr.magic, SMART_CP_MAGIC, sizeof(hdr.magic));
+	hdr.version = SMART_CP_VERSION;
+	hdr.released = CONFIG_SMARTFS_ERASEDSTATE;
+	hdr.sectorsize = dev->sectorsize;
+	hdr.totalsectors = dev->totalsectors;
+	hdr.neraseblocks = dev->neraseblocks;
+	hdr.freesectors = dev->freesectors;
+	hdr.releasesectors = dev->releasesectors;
+	hdr.lastallocblock = dev->lastallocblock;
+	hdr.reservedsector = dev->reservedsector;
+	hdr.formatversion = dev->formatversion;
+	hdr.namesize = dev->namesize;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+	hdr.unusedsectors = dev->unusedsectors;
+	hdr.blockerases = dev->blockerases;
+#endif
+	hdr.crc = smart_cp_crc(&hdr, (FAR const uint8_t *)dev->sMap);
+
+	ret = smart_cp_transfer(dev, dev->cpstart, (FAR uint8_t *)&hdr, sizeof(struct smart_cp_header_s), true);
+	if (ret < 0) {
+		fdbg("Error %d writing the checkpoint header\n", -ret);
+		return ret;
+	}
+
+	fvdbg("Checkpoint written, %d bytes\n", hdr.datasize);
+	dev->cpvalid = true;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_cp_invalidate
+ *
+ * Description: Marks the checkpoint on the device as stale.  Must be called
+ *              before anything is changed on the device.
+ *
+ ****************************************************************************/
+
+static int smart_cp_invalidate(FAR struct smart_struct_s *dev)
+{
+	uint8_t released = (uint8_t)~CONFIG_SMARTFS_ERASEDSTATE;
+	ssize_t ret;
+
+	if (!dev->cpvalid) {
+		return OK;
+	}
+
+	ret = smart_bytewrite(dev, dev->cpstart * dev->geo.blocksize + offsetof(struct smart_cp_header_s, released), 1, &released);
+	if (ret < 0) {
+		/* The stale checkpoint would be loaded by the next mount */
+
+		fdbg("Error %d invalidating the checkpoint\n", -ret);
+		return (int)ret;
+	}
+
+	dev->cpvalid = false;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_cp_load
+ *
+ * Description: Restores the sector map and the free and release counts from
+ *              a current checkpoint instead of scanning the device.  A
+ *              checkpoint that does not match the device is invalidated.
+ *
+ ****************************************************************************/
+
+static int smart_cp_load(FAR struct smart_struct_s *dev)
+{
+	struct smart_cp_header_s hdr;
+	uint8_t fmtheader[sizeof(struct smart_sect_header_s)];
+	uint16_t fmtsector;
+	int ret;
+
+	if (dev->cpblocks == 0) {
+		return -ENOENT;
+	}
+
+	ret = smart_cp_transfer(dev, dev->cpstart, (FAR uint8_t *)&hdr, sizeof(struct smart_cp_header_s), false);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (memcmp(hdr.magic, SMART_CP_MAGIC, sizeof(hdr.magic)) != 0 || hdr.version != SMART_CP_VERSION || hdr.released != CONFIG_SMARTFS_ERASEDSTATE) {
+		return -ENOENT;
+	}
+
+	/* From here on, a failure leaves a checkpoint that must not be used */
+
+	dev->cpvalid = true;
+
+	ret = smart_setsectorsize(dev, hdr.sectorsize);
+	if (ret != OK) {
+		goto errout;
+	}
+
+	if (hdr.totalsectors != dev->totalsectors || hdr.neraseblocks != dev->neraseblocks || hdr.datasize != dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1) || dev->geo.blocksize + hdr.datasize > dev->cpsize) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	ret = smart_cp_transfer(dev, dev->cpstart + 1, (FAR uint8_t *)dev->sMap, hdr.datasize, false);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (smart_cp_crc(&hdr, (FAR const uint8_t *)dev->sMap) != hdr.crc) {
+		fdbg("Checkpoint CRC error\n");
+		ret = -EIO;
+		goto errout;
+	}
+
+	/* Check that the format sector is still where it was */
+
+	fmtsector = dev->sMap[0];
+	if (fmtsector >= dev->totalsectors) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	ret = MTD_READ(dev->mtd, fmtsector * dev->mtdBlksPerSector * dev->geo.blocksize, sizeof(struct smart_sect_header_s), fmtheader);
+	if (ret != sizeof(struct smart_sect_header_s) || memcmp(fmtheader, hdr.fmtheader, sizeof(fmtheader)) != 0) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	dev->freesectors = hdr.freesectors;
+	dev->releasesectors = hdr.releasesectors;
+	dev->lastallocblock = hdr.lastallocblock;
+	dev->reservedsector = hdr.reservedsector;
+	dev->formatversion = hdr.formatversion;
+	dev->namesize = hdr.namesize;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+	dev->unusedsectors = hdr.unusedsectors;
+	dev->blockerases = hdr.blockerases;
+#endif
+	dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	/* Read the wear leveling status bits */
+
+	smart_read_wearstatus(dev);
+#endif
+
+	fvdbg("Map restored from the checkpoint\n");
+	return OK;
+
+errout:
+	fdbg("Invalid checkpoint: %d\n", ret);
+	smart_cp_invalidate(dev);
+	return ret;
+}
+#endif							/* CONFIG_MTD_SMART_CHECKPOINT */
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -1716,6 +2167,14 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
 	fvdbg("Entry\n");
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* A clean unmount left the map on the device, no scan is needed */
+
+	if (smart_cp_load(dev) == OK) {
+		return OK;
+	}
+#endif
+
 	/* Find the sector size on the volume by reading headers from
 	 * sectors of decreasing size.  On a formatted volume, the sector
 	 * size is saved in the header status byte of seach sector, so
@@ -3505,6 +3964,55 @@ retry:
 	return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_gc_findblock
+ *
+ * Description:  Find the erase block with the most released sectors, which
+ *               is the cheapest one to collect.  Returns 0xFFFF if no block
+ *               has released sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint16_t smart_gc_findblock(FAR struct smart_struct_s *dev, FAR uint16_t *released)
+{
+	uint16_t collectblock;
+	uint16_t releasemax;
+	int x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	uint8_t count;
+#endif
+
+	collectblock = 0xFFFF;
+	releasemax = 0;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		/* Don't collect blocks that have been worn completely */
+
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
+			continue;
+		}
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		count = smart_get_count(dev, dev->releasecount, x);
+		if (count > releasemax) {
+			releasemax = count;
+			collectblock = x;
+		}
+#else
+		if (dev->releasecount[x] > releasemax) {
+			releasemax = dev->releasecount[x];
+			collectblock = x;
+		}
+#endif
+	}
+
+	*released = releasemax;
+	return collectblock;
+}
+#endif							/* CONFIG_FS_WRITABLE */
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -3520,11 +4028,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 	uint16_t collectblock;
 	uint16_t releasemax;
 	bool collect = TRUE;
-	int x;
 	int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-	uint8_t count;
-#endif
 
 	while (collect) {
 		collect = FALSE;
@@ -3548,31 +4052,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (collect) {
 			/* Find the block with the most released sectors */
 
-			collectblock = 0xFFFF;
-			releasemax = 0;
-			for (x = 0; x < dev->neraseblocks; x++) {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-				/* Don't collect blocks that have been worn completely */
-
-				if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
-					continue;
-				}
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-				count = smart_get_count(dev, dev->releasecount, x);
-				if (count > releasemax) {
-					releasemax = count;
-					collectblock = x;
-				}
-#else
-				if (dev->releasecount[x] > releasemax) {
-					releasemax = dev->releasecount[x];
-					collectblock = x;
-				}
-#endif
-			}
-			//releasemax = smart_get_count(dev, dev->releasecount, collectblock);
+			collectblock = smart_gc_findblock(dev, &releasemax);
 
 			if (collectblock == 0xFFFF) {
 				/* Need to collect, but no sectors with released blocks! */
@@ -4578,6 +5058,127 @@ errout:
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_readsectors
+ *
+ * Description:  Reads the data of a run of consecutive logical sectors.
+ *               Sectors that are also physically consecutive are read from
+ *               the MTD device with a single block read.  The caller's
+ *               buffer must hold nsectors full sectors since it is used as
+ *               the read buffer; the data of the sectors is then packed at
+ *               its start, 'count' bytes per sector.  Returns the number of
+ *               sectors read, which stops at the first sector that cannot
+ *               be read.
+ *
+ ****************************************************************************/
+
+static int smart_readsectors(FAR struct smart_struct_s *dev, unsigned long arg)
+{
+	FAR struct smart_read_sectors_s *req;
+	FAR struct smart_sect_header_s *header;
+	FAR uint8_t *raw;
+	uint16_t logical;
+	uint16_t physsector;
+	uint16_t nread;
+	uint16_t run;
+	uint16_t x;
+	int ret = -EINVAL;
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	FAR struct smart_wbentry_s *entry;
+#endif
+
+	fvdbg("Entry\n");
+	req = (FAR struct smart_read_sectors_s *)arg;
+	DEBUGASSERT(req->count <= dev->sectorsize - sizeof(struct smart_sect_header_s));
+
+	nread = 0;
+	while (nread < req->nsectors) {
+		logical = req->logsector + nread;
+		if (logical >= dev->totalsectors) {
+			fdbg("Logical sector %d too large\n", logical);
+			break;
+		}
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+		physsector = dev->sMap[logical];
+#else
+		physsector = smart_cache_lookup(dev, logical);
+#endif
+		if (physsector == 0xFFFF) {
+			fdbg("Logical sector %d not allocated\n", logical);
+			break;
+		}
+
+		/* Extend the run while the next logical sector follows on the device */
+
+		for (run = 1; nread + run < req->nsectors && logical + run < dev->totalsectors; run++) {
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+			if (dev->sMap[logical + run] != physsector + run) {
+#else
+			if (smart_cache_lookup(dev, logical + run) != physsector + run) {
+#endif
+				break;
+			}
+		}
+
+		/* Read the run behind the data packed so far */
+
+		raw = &req->buffer[nread * dev->sectorsize];
+		ret = MTD_BREAD(dev->mtd, physsector * dev->mtdBlksPerSector, run * dev->mtdBlksPerSector, raw);
+		if (ret != run * dev->mtdBlksPerSector) {
+			fdbg("Error reading phys sectors %d-%d\n", physsector, physsector + run - 1);
+			ret = -EIO;
+			break;
+		}
+
+		for (x = 0; x < run; x++, raw += dev->sectorsize) {
+			header = (FAR struct smart_sect_header_s *)raw;
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+			/* Validate the CRC using our sector buffer */
+
+			memcpy(dev->rwbuffer, raw, dev->sectorsize);
+#if SMART_STATUS_VERSION == 1
+			if ((header->status & SMART_STATUS_CRC) != (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_CRC))
+#endif
+			{
+				if (smart_validate_crc(dev) != OK) {
+					fdbg("Error validating sector %d CRC during read\n", physsector + x);
+					ret = -EIO;
+					break;
+				}
+			}
+#else
+			if ((UINT8TOUINT16(header->logicalsector) != logical + x) || (!(SECTOR_IS_COMMITTED((*header))))) {
+				fdbg("Error in logical sector %d header, phys=%d\n", logical + x, physsector + x);
+				ret = -EIO;
+				break;
+			}
+#endif
+
+			memmove(&req->buffer[(nread + x) * req->count], &raw[sizeof(struct smart_sect_header_s)], req->count);
+		}
+
+		nread += x;
+		if (x < run) {
+			break;
+		}
+	}
+
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	/* Sectors held in the write-back cache may be newer than the flash */
+
+	for (x = 0; x < nread; x++) {
+		entry = smart_wb_find(dev, req->logsector + x);
+		if (entry != NULL) {
+			memcpy(&req->buffer[x * req->count], entry->data, req->count);
+		}
+	}
+#endif
+
+	return nread > 0 ? nread : ret;
+}
+
 /****************************************************************************
  * Name: smart_allocsector
  *
@@ -4891,6 +5492,421 @@ errout:
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_wb_find
+ *
+ * Description:  Return the write-back cache entry holding the specified
+ *               logical sector, or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+static FAR struct smart_wbentry_s *smart_wb_find(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	int x;
+
+	for (x = 0; x < CONFIG_MTD_SMART_WRITEBACK_NSECTORS; x++) {
+		if (dev->wbcache[x].logical == logical) {
+			return &dev->wbcache[x];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: smart_wb_invalidate
+ *
+ * Description:  Drop the specified logical sector from the write-back cache
+ *               without writing it back.  Used when the sector is freed or
+ *               newly allocated.
+ *
+ ****************************************************************************/
+
+static void smart_wb_invalidate(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	FAR struct smart_wbentry_s *entry;
+
+	entry = smart_wb_find(dev, logical);
+	if (entry != NULL) {
+		entry->logical = 0xFFFF;
+	}
+}
+
+/****************************************************************************
+ * Name: smart_wb_reset
+ *
+ * Description:  Drop all entries of the write-back cache and release its
+ *               storage.  It is allocated again by the next access.
+ *
+ ****************************************************************************/
+
+static void smart_wb_reset(FAR struct smart_struct_s *dev)
+{
+	int x;
+
+	for (x = 0; x < CONFIG_MTD_SMART_WRITEBACK_NSECTORS; x++) {
+		dev->wbcache[x].logical = 0xFFFF;
+		dev->wbcache[x].data = NULL;
+	}
+
+	if (dev->wbbuffer != NULL) {
+		smart_free(dev, dev->wbbuffer);
+		dev->wbbuffer = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: smart_wb_writeback
+ *
+ * Description:  Write the dirty bytes of a write-back cache entry to the
+ *               flash.  Bytes between two dirty ranges hold the data that
+ *               was read from the flash, so writing the whole span does
+ *               not add conflicts for in-place updates.
+ *
+ ****************************************************************************/
+
+static int smart_wb_writeback(FAR struct smart_struct_s *dev, FAR struct smart_wbentry_s *entry)
+{
+	struct smart_read_write_s req;
+	int ret;
+
+	if (entry->dirtyhi == entry->dirtylo) {
+		return OK;
+	}
+
+	req.logsector = entry->logical;
+	req.offset = entry->dirtylo;
+	req.count = entry->dirtyhi - entry->dirtylo;
+	req.buffer = &entry->data[entry->dirtylo];
+
+	ret = smart_writesector(dev, (unsigned long)&req);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+		/* Write new wear status bits to the device */
+
+		smart_write_wearstatus(dev);
+	}
+#endif
+
+	if (ret != OK) {
+		fdbg("Error writing back logical sector %d: %d\n", entry->logical, ret);
+		return ret;
+	}
+
+	entry->dirtylo = entry->dirtyhi = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_wb_flush
+ *
+ * Description:  Write all dirty entries of the write-back cache to the
+ *               flash.  The entries stay cached.
+ *
+ ****************************************************************************/
+
+static int smart_wb_flush(FAR struct smart_struct_s *dev)
+{
+	int ret = OK;
+	int err;
+	int x;
+
+	for (x = 0; x < CONFIG_MTD_SMART_WRITEBACK_NSECTORS; x++) {
+		if (dev->wbcache[x].logical != 0xFFFF) {
+			err = smart_wb_writeback(dev, &dev->wbcache[x]);
+			if (err != OK && ret == OK) {
+				ret = err;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: smart_wb_getentry
+ *
+ * Description:  Return the write-back cache entry of the specified logical
+ *               sector, loading the sector data into the least recently used
+ *               entry if it is not cached.  Returns NULL if the sector
+ *               cannot be cached, in which case the caller should access
+ *               the flash directly:  the sector is not allocated or not yet
+ *               committed, the LRU entry could not be written back, or
+ *               there is not enough memory for the cache.
+ *
+ ****************************************************************************/
+
+static FAR struct smart_wbentry_s *smart_wb_getentry(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	FAR struct smart_wbentry_s *entry;
+	struct smart_read_write_s req;
+	size_t datasize;
+	int ret;
+	int x;
+
+	entry = smart_wb_find(dev, logical);
+	if (entry != NULL) {
+		entry->birth = dev->wbnextbirth++;
+		return entry;
+	}
+
+	datasize = dev->sectorsize - sizeof(struct smart_sect_header_s);
+
+	/* Allocate the cache storage on first use.  If the heap is short of
+	 * memory we just run uncached and try again later.
+	 */
+
+	if (dev->wbbuffer == NULL) {
+		dev->wbbuffer = (FAR uint8_t *)smart_malloc(dev, datasize * CONFIG_MTD_SMART_WRITEBACK_NSECTORS, "Write-back cache");
+		if (dev->wbbuffer == NULL) {
+			fvdbg("No memory for the write-back cache\n");
+			return NULL;
+		}
+
+		for (x = 0; x < CONFIG_MTD_SMART_WRITEBACK_NSECTORS; x++) {
+			dev->wbcache[x].logical = 0xFFFF;
+			dev->wbcache[x].data = &dev->wbbuffer[x * datasize];
+		}
+	}
+
+	/* Use a free entry if there is one, else the least recently used */
+
+	entry = &dev->wbcache[0];
+	for (x = 0; x < CONFIG_MTD_SMART_WRITEBACK_NSECTORS; x++) {
+		if (dev->wbcache[x].logical == 0xFFFF) {
+			entry = &dev->wbcache[x];
+			break;
+		}
+
+		if (dev->wbnextbirth - dev->wbcache[x].birth > dev->wbnextbirth - entry->birth) {
+			entry = &dev->wbcache[x];
+		}
+	}
+
+	if (entry->logical != 0xFFFF) {
+		if (smart_wb_writeback(dev, entry) != OK) {
+			return NULL;
+		}
+
+		entry->logical = 0xFFFF;
+	}
+
+	/* Load the current sector data */
+
+	req.logsector = logical;
+	req.offset = 0;
+	req.count = datasize;
+	req.buffer = entry->data;
+
+	ret = smart_readsector(dev, (unsigned long)&req);
+	if (ret != (int)datasize) {
+		return NULL;
+	}
+
+	entry->logical = logical;
+	entry->dirtylo = entry->dirtyhi = 0;
+	entry->birth = dev->wbnextbirth++;
+
+	return entry;
+}
+
+/****************************************************************************
+ * Name: smart_wb_readsector
+ *
+ * Description:  BIOC_READSECT through the write-back cache.
+ *
+ ****************************************************************************/
+
+static int smart_wb_readsector(FAR struct smart_struct_s *dev, unsigned long arg)
+{
+	FAR struct smart_read_write_s *req = (FAR struct smart_read_write_s *)arg;
+	FAR struct smart_wbentry_s *entry;
+
+	if (req->offset + req->count > dev->sectorsize - sizeof(struct smart_sect_header_s)) {
+		return smart_readsector(dev, arg);
+	}
+
+	entry = smart_wb_getentry(dev, req->logsector);
+	if (entry == NULL) {
+		return smart_readsector(dev, arg);
+	}
+
+	memcpy((FAR uint8_t *)req->buffer, &entry->data[req->offset], req->count);
+	return req->count;
+}
+
+/****************************************************************************
+ * Name: smart_wb_writesector
+ *
+ * Description:  BIOC_WRITESECT through the write-back cache.  The data is
+ *               only merged into the cached sector; it reaches the flash
+ *               when the entry is evicted or the cache is flushed, so that
+ *               repeated small writes to the same sector cost one sector
+ *               write.
+ *
+ ****************************************************************************/
+
+static int smart_wb_writesector(FAR struct smart_struct_s *dev, unsigned long arg)
+{
+	FAR struct smart_read_write_s *req = (FAR struct smart_read_write_s *)arg;
+	FAR struct smart_wbentry_s *entry;
+	int ret;
+
+	if (req->offset + req->count > dev->sectorsize - sizeof(struct smart_sect_header_s)) {
+		entry = NULL;
+	} else {
+		entry = smart_wb_getentry(dev, req->logsector);
+	}
+
+	if (entry == NULL) {
+		/* Write through */
+
+		ret = smart_writesector(dev, arg);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+			/* Write new wear status bits to the device */
+
+			smart_write_wearstatus(dev);
+		}
+#endif
+
+		return ret;
+	}
+
+	if (req->count == 0) {
+		return OK;
+	}
+
+	memcpy(&entry->data[req->offset], req->buffer, req->count);
+
+	if (entry->dirtyhi == entry->dirtylo) {
+		entry->dirtylo = req->offset;
+		entry->dirtyhi = req->offset + req->count;
+	} else {
+		if (req->offset < entry->dirtylo) {
+			entry->dirtylo = req->offset;
+		}
+
+		if (req->offset + req->count > entry->dirtyhi) {
+			entry->dirtyhi = req->offset + req->count;
+		}
+	}
+
+	return OK;
+}
+#endif							/* CONFIG_MTD_SMART_WRITEBACK */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+/****************************************************************************
+ * Name: smart_lock / smart_unlock
+ *
+ * Description:  Get / release exclusive access to the device.  Needed with
+ *               background collection, which relocates blocks from the
+ *               work queue while the file system may issue requests.
+ *
+ ****************************************************************************/
+
+static void smart_lock(FAR struct smart_struct_s *dev)
+{
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait
+		 * was awakened by a signal.
+		 */
+
+		ASSERT(errno == EINTR);
+	}
+}
+
+static void smart_unlock(FAR struct smart_struct_s *dev)
+{
+	sem_post(&dev->exclsem);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Background garbage collection.  Relocates the blocks with
+ *               the most released sectors until the free sectors reach the
+ *               high watermark.  The lock is dropped after each block so
+ *               that requests are only held off for one relocation.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	uint16_t collectblock;
+	uint16_t released;
+	int ret;
+
+	for (;;) {
+		smart_lock(dev);
+
+		/* Only collect blocks that give back a fair share of their sectors,
+		 * an erase is not worth a couple of sectors.
+		 */
+
+		collectblock = 0xFFFF;
+		if (dev->formatstatus == SMART_FMT_STAT_FORMATTED && dev->freesectors < dev->gchigh) {
+			collectblock = smart_gc_findblock(dev, &released);
+			if (released < SMART_BGGC_MINRELEASED(dev)) {
+				collectblock = 0xFFFF;
+			}
+		}
+
+		if (collectblock == 0xFFFF) {
+			smart_unlock(dev);
+			break;
+		}
+
+		fvdbg("Collecting block %d, released=%d, totalfree=%d\n", collectblock, released, dev->freesectors);
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		ret = smart_cp_invalidate(dev);
+		if (ret < 0) {
+			smart_unlock(dev);
+			break;
+		}
+#endif
+
+		ret = smart_relocate_block(dev, collectblock);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+			/* Write new wear status bits to the device */
+
+			smart_write_wearstatus(dev);
+		}
+#endif
+
+		smart_unlock(dev);
+
+		if (ret != OK) {
+			fdbg("Error collecting block %d: %d\n", collectblock, ret);
+			break;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  Schedule the background collection if the free sectors
+ *               dropped below the low watermark.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+	if (dev->freesectors < dev->gclow && work_available(&dev->gcwork)) {
+		work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY));
+	}
+}
+#endif							/* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -4915,6 +5931,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+	smart_lock(dev);
+
 	/* Process the ioctl's we care about first, pass any we don't respond
 	 * to directly to the underlying MTD device.
 	 */
@@ -4929,7 +5947,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_DEBUG
 		if (arg == 0) {
 			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #endif
 
@@ -4952,7 +5971,18 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	case BIOC_READSECT:
 
 		/* Do a logical sector read and return the data */
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		ret = smart_wb_readsector(dev, arg);
+#else
 		ret = smart_readsector(dev, arg);
+#endif
+		goto ok_out;
+
+	case BIOC_READSECTS:
+
+		/* Read a run of logical sectors */
+
+		ret = smart_readsectors(dev, arg);
 		goto ok_out;
 
 #ifdef CONFIG_FS_WRITABLE
@@ -4960,6 +5990,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
 		/* Perform a low-level format on the flash */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		ret = smart_cp_invalidate(dev);
+		if (ret < 0) {
+			goto ok_out;
+		}
+#endif
 		ret = smart_llformat(dev, arg);
 		goto ok_out;
 
@@ -4967,13 +6003,36 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
 		/* Allocate a logical sector for the upper layer file system */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		ret = smart_cp_invalidate(dev);
+		if (ret < 0) {
+			goto ok_out;
+		}
+#endif
 		ret = smart_allocsector(dev, arg);
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		if (ret >= 0) {
+			smart_wb_invalidate(dev, ret);
+		}
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+		smart_bggc_schedule(dev);
+#endif
 		goto ok_out;
 
 	case BIOC_FREESECT:
 
 		/* Free the specified logical sector */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		ret = smart_cp_invalidate(dev);
+		if (ret < 0) {
+			goto ok_out;
+		}
+#endif
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		smart_wb_invalidate(dev, arg);
+#endif
 		ret = smart_freesector(dev, arg);
 		goto ok_out;
 
@@ -4981,6 +6040,15 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
 		/* Write to the sector */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		ret = smart_cp_invalidate(dev);
+		if (ret < 0) {
+			goto ok_out;
+		}
+#endif
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		ret = smart_wb_writesector(dev, arg);
+#else
 		ret = smart_writesector(dev, arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -4990,10 +6058,43 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 			smart_write_wearstatus(dev);
 		}
 #endif
+#endif							/* CONFIG_MTD_SMART_WRITEBACK */
+#ifdef CONFIG_MTD_SMART_BGGC
+		smart_bggc_schedule(dev);
+#endif
+		goto ok_out;
+
+	case BIOC_FLUSH:
+
+		/* Write any cached sector data to the flash */
 
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		ret = smart_wb_flush(dev);
+#else
+		ret = OK;
+#endif
 		goto ok_out;
 #endif							/* CONFIG_FS_WRITABLE */
 
+#ifdef CONFIG_MTD_SMART_BGGC
+	case BIOC_GCWATERMARK: {
+		FAR struct smart_gcwatermark_s *wm = (FAR struct smart_gcwatermark_s *)arg;
+
+		/* Set the background collection watermarks */
+
+		if (wm == NULL || (wm->low > 0 && wm->high < wm->low) || wm->high > dev->totalsectors) {
+			ret = -EINVAL;
+			goto ok_out;
+		}
+
+		dev->gclow = wm->low;
+		dev->gchigh = wm->high;
+		smart_bggc_schedule(dev);
+		ret = OK;
+		goto ok_out;
+	}
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	case BIOC_GETPROCFSD:
 
@@ -5061,9 +6162,52 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+	smart_unlock(dev);
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_sample_metrics
+ *
+ * Description:
+ *   Metrics sample callback.  Sets all the wear level metrics of the
+ *   device, the callback being installed on the first one only.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_METRICS) && defined(CONFIG_MTD_SMART_WEAR_LEVEL)
+static void smart_sample_metrics(FAR struct metric_s *metric)
+{
+	FAR struct smart_struct_s *dev;
+
+	dev = (FAR struct smart_struct_s *)((uintptr_t)metric - offsetof(struct smart_struct_s, metrics));
+
+	metric_set(&dev->metrics[SMART_METRIC_WEARMIN], dev->minwearlevel);
+	metric_set(&dev->metrics[SMART_METRIC_WEARMAX], dev->maxwearlevel);
+	metric_set(&dev->metrics[SMART_METRIC_UNEVEN], dev->uneven_wearcount);
+}
+
+/****************************************************************************
+ * Name: smart_register_metrics
+ ****************************************************************************/
+
+static void smart_register_metrics(FAR struct smart_struct_s *dev, int minor)
+{
+	static const char *const suffix[SMART_NMETRICS] = { "wear.min", "wear.max", "wear.uneven" };
+	int i;
+
+	for (i = 0; i < SMART_NMETRICS; i++) {
+		snprintf(dev->metricname[i], sizeof(dev->metricname[i]), "smart%d%s.%s", minor, dev->partname, suffix[i]);
+
+		memset(&dev->metrics[i], 0, sizeof(struct metric_s));
+		dev->metrics[i].name = dev->metricname[i];
+		dev->metrics[i].type = i == SMART_METRIC_UNEVEN ? METRIC_COUNTER : METRIC_GAUGE;
+		dev->metrics[i].sample = i == 0 ? smart_sample_metrics : NULL;
+		metrics_register(&dev->metrics[i]);
+	}
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -5131,6 +6275,34 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			goto errout;
 		}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		/* Keep the last erase blocks for the map checkpoint.  The area is
+		 * sized for the default sector size; volumes formatted with smaller
+		 * sectors are always scanned.
+		 */
+
+		{
+			uint32_t erasesize = dev->geo.erasesize ? dev->geo.erasesize : 262144;
+			uint32_t cpsize;
+
+			totalsectors = dev->geo.neraseblocks * (erasesize / CONFIG_MTD_SMART_SECTOR_SIZE);
+			if (totalsectors > 65536) {
+				totalsectors = 65536;
+			}
+
+			cpsize = dev->geo.blocksize + totalsectors * sizeof(uint16_t) + (dev->geo.neraseblocks << 1);
+			dev->cpblocks = (cpsize + erasesize - 1) / erasesize;
+			if (dev->cpblocks >= dev->geo.neraseblocks) {
+				dev->cpblocks = 0;
+			}
+
+			dev->geo.neraseblocks -= dev->cpblocks;
+			dev->cpstart = (off_t)dev->geo.neraseblocks * (erasesize / dev->geo.blocksize);
+			dev->cpsize = dev->cpblocks * erasesize;
+			dev->cpvalid = false;
+		}
+#endif
+
 		/* Set the sector size to the default for now */
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
@@ -5146,6 +6318,14 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 		dev->rwbuffer = NULL;
 		dev->bytebuffer = NULL;
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+		dev->wbbuffer = NULL;
+		dev->wbnextbirth = 0;
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 		dev->erasecounts = NULL;
 #endif
@@ -5240,6 +6420,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 		/* Do a scan of the device */
 
 		smart_scan(dev);
+
+#if defined(CONFIG_METRICS) && defined(CONFIG_MTD_SMART_WEAR_LEVEL)
+		/* The device stays registered from now on */
+
+		smart_register_metrics(dev, minor);
+#endif
 	}
 
 	return OK;
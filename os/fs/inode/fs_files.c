@@ -111,6 +111,80 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) sem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_setfree
+ *
+ * Description:
+ *   Mark the descriptor of a released file structure as free in the
+ *   allocation bitmap.  The structure may belong to another list (dup2 into
+ *   a new task); that list rescans when its bitmap runs out.
+ *
+ ****************************************************************************/
+
+static inline void _files_setfree(FAR struct filelist *list, FAR struct file *filep)
+{
+	if (filep >= list->fl_files && filep < &list->fl_files[CONFIG_NFILE_DESCRIPTORS]) {
+		int fd = filep - list->fl_files;
+		list->fl_free[fd >> 5] |= (uint32_t)1 << (fd & 31);
+	}
+}
+
+/****************************************************************************
+ * Name: _files_findfree
+ *
+ * Description:
+ *   Find a free descriptor at or above minfd.  The bitmap is only a hint:
+ *   a set bit whose slot turns out to be in use is cleared and skipped, and
+ *   when no set bit remains the table is rescanned so that slots released
+ *   behind the bitmap's back are found again.
+ *
+ ****************************************************************************/
+
+static int _files_findfree(FAR struct filelist *list, int minfd)
+{
+	uint32_t word;
+	int found;
+	int ndx;
+	int fd;
+
+	for (ndx = minfd >> 5; ndx < FILELIST_NWORDS; ndx++) {
+		word = list->fl_free[ndx];
+		if (ndx == (minfd >> 5)) {
+			word &= ~(((uint32_t)1 << (minfd & 31)) - 1);
+		}
+
+		while (word != 0) {
+			fd = (ndx << 5) + __builtin_ctz(word);
+			word &= word - 1;
+			if (fd >= CONFIG_NFILE_DESCRIPTORS) {
+				break;
+			}
+
+			list->fl_free[ndx] &= ~((uint32_t)1 << (fd & 31));
+			if (!list->fl_files[fd].f_inode) {
+				return fd;
+			}
+		}
+	}
+
+	/* Nothing in the bitmap, rebuild it from the table.  The lowest free
+	 * descriptor is returned and all the others are marked free.
+	 */
+
+	found = ERROR;
+	for (fd = CONFIG_NFILE_DESCRIPTORS - 1; fd >= minfd; fd--) {
+		if (!list->fl_files[fd].f_inode) {
+			if (found >= 0) {
+				_files_setfree(list, &list->fl_files[found]);
+			}
+
+			found = fd;
+		}
+	}
+
+	return found;
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -182,6 +256,10 @@ void files_initlist(FAR struct filelist *list)
 	/* Initialize the list access mutex */
 
 	(void)sem_init(&list->fl_sem, 0, 1);
+
+	/* Every descriptor starts out free */
+
+	memset(list->fl_free, 0xff, sizeof(list->fl_free));
 }
 
 /****************************************************************************
@@ -260,6 +338,11 @@ int file_dup(FAR struct file *filep, int minfd)
 		} else
 #endif
 		{
+			/* Files without an inode of their own (epoll, eventfd) keep
+			 * their state in f_priv and count the files sharing it
+			 */
+
+			filep2->f_priv = filep->f_priv;
 			ret = filep->f_inode->u.i_ops->open(filep2);
 		}
 
@@ -340,8 +423,12 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 		} else
 #endif
 		{
-			/* (Re-)open the pseudo file or device driver */
+			/* (Re-)open the pseudo file or device driver, with the
+			 * private data of the original for the pseudo files that
+			 * keep their state there
+			 */
 
+			filep2->f_priv = filep1->f_priv;
 			ret = inode->u.i_ops->open(filep2);
 		}
 
@@ -362,6 +449,8 @@ errout_with_inode:
 	filep2->f_oflags = 0;
 	filep2->f_pos = 0;
 	filep2->f_inode = NULL;
+	filep2->f_priv = NULL;
+	_files_setfree(list, filep2);
 
 errout_with_ret:
 	err = -ret;
@@ -389,20 +478,21 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 	list = sched_getfiles();
 	DEBUGASSERT(list);
 
+	if (minfd < 0 || minfd >= CONFIG_NFILE_DESCRIPTORS) {
+		return ERROR;
+	}
+
 	_files_semtake(list);
-	for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++) {
-		if (!list->fl_files[i].f_inode) {
-			list->fl_files[i].f_oflags = oflags;
-			list->fl_files[i].f_pos = pos;
-			list->fl_files[i].f_inode = inode;
-			list->fl_files[i].f_priv = NULL;
-			_files_semgive(list);
-			return i;
-		}
+	i = _files_findfree(list, minfd);
+	if (i >= 0) {
+		list->fl_files[i].f_oflags = oflags;
+		list->fl_files[i].f_pos = pos;
+		list->fl_files[i].f_inode = inode;
+		list->fl_files[i].f_priv = NULL;
 	}
 
 	_files_semgive(list);
-	return ERROR;
+	return i;
 }
 
 /****************************************************************************
@@ -436,6 +526,7 @@ int files_close(int fd)
 
 	_files_semtake(list);
 	ret = _files_close(&list->fl_files[fd]);
+	_files_setfree(list, &list->fl_files[fd]);
 	_files_semgive(list);
 	return ret;
 }
@@ -461,6 +552,7 @@ void files_release(int fd)
 		list->fl_files[fd].f_oflags = 0;
 		list->fl_files[fd].f_pos = 0;
 		list->fl_files[fd].f_inode = NULL;
+		_files_setfree(list, &list->fl_files[fd]);
 		_files_semgive(list);
 	}
 }
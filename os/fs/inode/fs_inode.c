@@ -61,6 +61,7 @@
 #include <errno.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/fs/fs.h>
 
 #include "inode/inode.h"
@@ -188,6 +189,7 @@ void inode_initialize(void)
 	 */
 
 	(void)sem_init(&g_inode_sem.sem, 0, 1);
+	(void)sem_setname(&g_inode_sem.sem, "inode");
 	g_inode_sem.holder = NO_HOLDER;
 	g_inode_sem.count = 0;
 
@@ -270,6 +272,22 @@ void inode_semgive(void)
 	}
 }
 
+/****************************************************************************
+ * Name: inode_semfree
+ *
+ * Description:
+ *   Return true if no task holds the inode semaphore.  Only meaningful with
+ *   the scheduler locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_semfree(void)
+{
+	return g_inode_sem.holder == NO_HOLDER;
+}
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
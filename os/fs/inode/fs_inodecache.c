@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * A direct-mapped cache of the full paths found by inode_find().  An entry
+ * is valid only while the generation it was cached in is current; the
+ * generation is advanced whenever an inode is added to or removed from the
+ * tree, which drops all entries at once.  Cached lookups take neither the
+ * inode semaphore nor walk the tree: they run with the scheduler locked and
+ * only while no task holds the semaphore, so that nobody can be in the
+ * middle of changing the tree or a reference count.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+
+#include <tinyara/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct inode_cache_s {
+	uint32_t gen;				/* Generation when cached, 0 if unused */
+	uint32_t hash;				/* Hash of the path */
+	FAR struct inode *node;		/* The inode found */
+	uint16_t reloff;			/* Offset of the relative path in 'path' */
+	char path[CONFIG_FS_INODE_CACHE_PATHLEN + 1];
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct inode_cache_s g_inodecache[CONFIG_FS_INODE_CACHE_ENTRIES];
+static uint32_t g_inodegen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of 'path' and its length in 'len'.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+	FAR const char *ptr = path;
+	uint32_t hash = 2166136261u;
+
+	while (*ptr != '\0') {
+		hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+	}
+
+	*len = ptr - path;
+	return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Return the cached inode of 'path' with a new reference, or NULL if the
+ *   path is not cached or the inode tree is in use.
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_cache_lookup(FAR const char *path, FAR const char **relpath)
+{
+	FAR struct inode_cache_s *entry;
+	FAR struct inode *node = NULL;
+	uint32_t hash;
+	size_t len;
+
+	hash = inode_cache_hash(path, &len);
+	if (len > CONFIG_FS_INODE_CACHE_PATHLEN) {
+		return NULL;
+	}
+
+	entry = &g_inodecache[hash % CONFIG_FS_INODE_CACHE_ENTRIES];
+
+	sched_lock();
+	if (inode_semfree() && entry->gen == g_inodegen && entry->hash == hash && strcmp(entry->path, path) == 0) {
+		node = entry->node;
+		node->i_crefs++;
+		if (relpath) {
+			*relpath = path + entry->reloff;
+		}
+	}
+
+	sched_unlock();
+	return node;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Cache the inode found for 'path' by inode_search().  'relpath' points
+ *   into 'path'.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const char *path, FAR struct inode *node, FAR const char *relpath)
+{
+	FAR struct inode_cache_s *entry;
+	uint32_t hash;
+	size_t len;
+
+	hash = inode_cache_hash(path, &len);
+	if (len > CONFIG_FS_INODE_CACHE_PATHLEN) {
+		return;
+	}
+
+	entry = &g_inodecache[hash % CONFIG_FS_INODE_CACHE_ENTRIES];
+	entry->hash = hash;
+	entry->node = node;
+	entry->reloff = relpath - path;
+	memcpy(entry->path, path, len + 1);
+	entry->gen = g_inodegen;
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all the cached paths.  Called when the inode tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+	int i;
+
+	if (++g_inodegen == 0) {
+		/* The generation wrapped, old entries could become valid again */
+
+		for (i = 0; i < CONFIG_FS_INODE_CACHE_ENTRIES; i++) {
+			g_inodecache[i].gen = 0;
+		}
+
+		g_inodegen = 1;
+	}
+}
+
+#endif							/* CONFIG_FS_INODE_CACHE */
@@ -98,12 +98,32 @@ FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
 		return NULL;
 	}
 
+#ifdef CONFIG_FS_INODE_CACHE
+	FAR const char *fullpath = path;
+	FAR const char *name;
+
+	node = inode_cache_lookup(path, relpath);
+	if (node) {
+		return node;
+	}
+#endif
+
 	/* Find the node matching the path.  If found, increment the count of
 	 * references on the node.
 	 */
 
 	inode_semtake();
+#ifdef CONFIG_FS_INODE_CACHE
+	node = inode_search(&path, (FAR struct inode **)NULL, (FAR struct inode **)NULL, &name);
+	if (node) {
+		inode_cache_insert(fullpath, node, name);
+		if (relpath) {
+			*relpath = name;
+		}
+	}
+#else
 	node = inode_search(&path, (FAR struct inode **)NULL, (FAR struct inode **)NULL, relpath);
+#endif
 	if (node) {
 		node->i_crefs++;
 	}
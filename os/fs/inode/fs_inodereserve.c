@@ -205,6 +205,8 @@ int inode_reserve(FAR const char *path, FAR struct inode **inode)
 
 	/* Now we now where to insert the subtree */
 
+	inode_cache_invalidate();
+
 	for (;;) {
 		FAR struct inode *node;
 
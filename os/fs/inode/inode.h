@@ -172,6 +172,19 @@ void inode_semtake(void);
 
 void inode_semgive(void);
 
+#ifdef CONFIG_FS_INODE_CACHE
+/****************************************************************************
+ * Name: inode_semfree
+ *
+ * Description:
+ *   Return true if no task holds the inode semaphore.  Only meaningful with
+ *   the scheduler locked.
+ *
+ ****************************************************************************/
+
+bool inode_semfree(void);
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -276,6 +289,25 @@ int inode_remove(FAR const char *path);
 
 FAR struct inode *inode_find(FAR const char *path, const char **relpath);
 
+/* fs_inodecache.c **********************************************************/
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_insert and inode_cache_invalidate
+ *
+ * Description:
+ *   The cache of the paths found by inode_find().  inode_cache_invalidate()
+ *   must be called, with the inode semaphore held, whenever an inode is
+ *   added to or removed from the tree.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+FAR struct inode *inode_cache_lookup(FAR const char *path, FAR const char **relpath);
+void inode_cache_insert(FAR const char *path, FAR struct inode *node, FAR const char *relpath);
+void inode_cache_invalidate(void);
+#else
+#define inode_cache_invalidate()
+#endif
+
 /* fs_inodeaddref.c *********************************************************/
 
 void inode_addref(FAR struct inode *inode);
@@ -86,7 +86,7 @@
  * These file systems all require block drivers:
  */
 
-#if defined(CONFIG_FS_SMARTFS) || defined(CONFIG_FS_ROMFS)
+#if defined(CONFIG_FS_SMARTFS) || defined(CONFIG_FS_ROMFS) || defined(CONFIG_FS_CROMFS)
 #define BDFS_SUPPORT 1
 #endif
 
@@ -127,6 +127,9 @@ extern const struct mountpt_operations smartfs_operations;
 #ifdef CONFIG_FS_ROMFS
 extern const struct mountpt_operations romfs_operations;
 #endif
+#ifdef CONFIG_FS_CROMFS
+extern const struct mountpt_operations cromfs_operations;
+#endif
 
 static const struct fsmap_t g_bdfsmap[] = {
 	/*
@@ -138,6 +141,9 @@ static const struct fsmap_t g_bdfsmap[] = {
 #endif
 #ifdef CONFIG_FS_ROMFS
 	{"romfs", &romfs_operations},
+#endif
+#ifdef CONFIG_FS_CROMFS
+	{"cromfs", &cromfs_operations},
 #endif
 	{NULL, NULL},
 };
@@ -95,7 +95,14 @@
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations uptime_operations;
+extern const struct procfs_operations boottime_operations;
 extern const struct procfs_operations version_operations;
+extern const struct procfs_operations locks_operations;
+extern const struct procfs_operations mm_operations;
+extern const struct procfs_operations netmem_operations;
+extern const struct procfs_operations netstats_operations;
+extern const struct procfs_operations paging_operations;
+extern const struct procfs_operations tasks_operations;
 
 /* This is not good.  These are implemented in drivers/mtd.  Having to
  * deal with them here is not a good coupling.
@@ -123,6 +130,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"[0-9]*", &proc_operations},
 #endif
 
+#if defined(CONFIG_BOOTTIME) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME)
+	{"boottime", &boottime_operations},
+#endif
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
 	{"cpuload", &cpuload_operations},
 #endif
@@ -131,10 +142,30 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"fs/smartfs**", &smartfs_procfsoperations},
 #endif
 
+#if defined(CONFIG_SEM_LOCKSTAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+	{"locks", &locks_operations},
+#endif
+
+#if defined(CONFIG_MM_HEAP_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MM)
+	{"mm", &mm_operations},
+#endif
+
 #if defined(CONFIG_MTD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD)
 	{"mtd", &mtd_procfsoperations},
 #endif
 
+#if defined(CONFIG_NET_MEMINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NETMEM)
+	{"net/mem", &netmem_operations},
+#endif
+
+#if defined(CONFIG_NET_PERF_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NETSTATS)
+	{"net/stats", &netstats_operations},
+#endif
+
+#if defined(CONFIG_PAGING_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGING)
+	{"paging", &paging_operations},
+#endif
+
 #if defined(CONFIG_MTD_PARTITION) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PARTITIONS)
 	{"partitions", &part_procfsoperations},
 #endif
@@ -143,6 +174,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"power/domains**", &power_procfsoperations},
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKS)
+	{"tasks", &tasks_operations},
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
 	{"uptime", &uptime_operations},
 #endif
@@ -0,0 +1,260 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsboottime.c
+ *
+ * /proc/boottime: the boot time profile, one milestone or initialization
+ * step per line with its time since boot and its duration in microseconds.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/boottime.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_BOOTTIME) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest line: two times, worker, result, a name and the newline */
+
+#define BOOTTIME_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The whole report is formatted
+ * on open so that it stays consistent across short reads.
+ */
+
+struct boottime_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[1];				/* The report, allocated with the structure */
+};
+
+#define SIZEOF_BOOTTIME_FILE_S(n) (sizeof(struct boottime_file_s) + (n) - 1)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int boottime_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int boottime_close(FAR struct file *filep);
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int boottime_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int boottime_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations boottime_operations = {
+	boottime_open,					/* open */
+	boottime_close,					/* close */
+	boottime_read,					/* read */
+	NULL,						/* write */
+
+	boottime_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	boottime_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_open
+ ****************************************************************************/
+
+static int boottime_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR const struct boottime_event_s *events;
+	FAR struct boottime_file_s *attr;
+	size_t maxsize;
+	int nevents;
+	int i;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	if (strcmp(relpath, "boottime") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	events = boottime_timeline(&nevents);
+	maxsize = (nevents + 1) * BOOTTIME_LINELEN;
+
+	attr = (FAR struct boottime_file_s *)kmm_zalloc(SIZEOF_BOOTTIME_FILE_S(maxsize));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	attr->size = snprintf(attr->text, BOOTTIME_LINELEN, "%10s %10s %6s %6s %s\n", "START_US", "TIME_US", "WORKER", "RESULT", "NAME");
+
+	for (i = 0; i < nevents; i++) {
+		FAR const struct boottime_event_s *event = &events[i];
+		char worker[8];
+		int len;
+
+		/* The entry may have been reserved but not filled in yet */
+
+		if (event->name == NULL) {
+			continue;
+		}
+
+		if (event->worker < 0) {
+			strcpy(worker, "-");
+		} else {
+			snprintf(worker, sizeof(worker), "%d", event->worker);
+		}
+
+		len = snprintf(&attr->text[attr->size], BOOTTIME_LINELEN, "%10lu %10lu %6s %6d %s\n", (unsigned long)event->start, (unsigned long)(event->end - event->start), worker, event->result, event->name);
+		attr->size += len < BOOTTIME_LINELEN ? len : BOOTTIME_LINELEN - 1;
+	}
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_close
+ ****************************************************************************/
+
+static int boottime_close(FAR struct file *filep)
+{
+	FAR struct boottime_file_s *attr;
+
+	attr = (FAR struct boottime_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_read
+ ****************************************************************************/
+
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct boottime_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct boottime_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: boottime_dup
+ ****************************************************************************/
+
+static int boottime_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct boottime_file_s *oldattr;
+	FAR struct boottime_file_s *newattr;
+	size_t allocsize;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct boottime_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	allocsize = SIZEOF_BOOTTIME_FILE_S(oldattr->size + 1);
+	newattr = (FAR struct boottime_file_s *)kmm_malloc(allocsize);
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, allocsize);
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_stat
+ ****************************************************************************/
+
+static int boottime_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "boottime") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_BOOTTIME && !CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -92,10 +92,13 @@
  * Private Types
  ****************************************************************************/
 
-/* This structure describes one open "file" */
+/* This structure describes one open "file".  The load is sampled on open
+ * and again only when the file is read from the start after a previous read.
+ */
 
 struct cpuload_file_s {
 	struct procfs_file_s base;	/* Base open file structure */
+	bool consumed;				/* line[] has been returned by a read */
 	unsigned int linesize;		/* Number of valid characters in line[] */
 	char line[CPULOAD_LINELEN];	/* Pre-allocated buffer for formatted lines */
 };
@@ -104,6 +107,10 @@ struct cpuload_file_s {
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Helpers */
+
+static void cpuload_sample(FAR struct cpuload_file_s *attr);
+
 /* File system methods */
 
 static int cpuload_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
@@ -145,6 +152,42 @@ const struct procfs_operations cpuload_operations = {
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cpuload_sample
+ ****************************************************************************/
+
+static void cpuload_sample(FAR struct cpuload_file_s *attr)
+{
+	struct cpuload_s cpuload;
+	uint32_t intpart;
+	uint32_t fracpart;
+
+	/* Sample the counts for the IDLE thread.  clock_cpuload should only
+	 * fail if the PID is not valid.  This, however, should never happen
+	 * for the IDLE thread.
+	 */
+
+	DEBUGVERIFY(clock_cpuload(0, &cpuload));
+
+	/* On the simulator, you may hit cpuload.total == 0, but probably never on
+	 * real hardware.
+	 */
+
+	if (cpuload.total > 0) {
+		uint32_t tmp;
+
+		tmp = 1000 - (1000 * cpuload.active) / cpuload.total;
+		intpart = tmp / 10;
+		fracpart = tmp - 10 * intpart;
+	} else {
+		intpart = 0;
+		fracpart = 0;
+	}
+
+	attr->linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%", intpart, fracpart);
+	attr->consumed = false;
+}
+
 /****************************************************************************
  * Name: cpuload_open
  ****************************************************************************/
@@ -181,6 +224,8 @@ static int cpuload_open(FAR struct file *filep, FAR const char *relpath, int ofl
 		return -ENOMEM;
 	}
 
+	cpuload_sample(attr);
+
 	/* Save the attributes as the open-specific state in filep->f_priv */
 
 	filep->f_priv = (FAR void *)attr;
@@ -214,7 +259,6 @@ static int cpuload_close(FAR struct file *filep)
 static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 {
 	FAR struct cpuload_file_s *attr;
-	size_t linesize;
 	off_t offset;
 	ssize_t ret;
 
@@ -225,47 +269,18 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer, size_t buf
 	attr = (FAR struct cpuload_file_s *)filep->f_priv;
 	DEBUGASSERT(attr);
 
-	/* If f_pos is zero, then sample the system time.  Otherwise, use
-	 * the cached system time from the previous read().  It is necessary
-	 * save the cached value in case, for example, the user is reading
-	 * the time one byte at a time.  In that case, the time must remain
-	 * stable throughout the reads.
+	/* The load sampled on open is returned by the first read.  Rewinding
+	 * to zero after that takes a new sample, so a poller can keep the file
+	 * open.  Otherwise the sample must remain stable throughout the reads,
+	 * e.g. if the user is reading it one byte at a time.
 	 */
 
-	if (filep->f_pos == 0) {
-		struct cpuload_s cpuload;
-		uint32_t intpart;
-		uint32_t fracpart;
-
-		/* Sample the counts for the IDLE thread.  clock_cpuload should only
-		 * fail if the PID is not valid.  This, however, should never happen
-		 * for the IDLE thread.
-		 */
-
-		DEBUGVERIFY(clock_cpuload(0, &cpuload));
-
-		/* On the simulator, you may hit cpuload.total == 0, but probably never on
-		 * real hardware.
-		 */
-
-		if (cpuload.total > 0) {
-			uint32_t tmp;
-
-			tmp = 1000 - (1000 * cpuload.active) / cpuload.total;
-			intpart = tmp / 10;
-			fracpart = tmp - 10 * intpart;
-		} else {
-			intpart = 0;
-			fracpart = 0;
-		}
-
-		linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%", intpart, fracpart);
-
-		/* Save the linesize in case we are re-entered with f_pos > 0 */
-
-		attr->linesize = linesize;
+	if (filep->f_pos == 0 && attr->consumed) {
+		cpuload_sample(attr);
 	}
 
+	attr->consumed = true;
+
 	/* Transfer the system up time to user receive buffer */
 
 	offset = filep->f_pos;
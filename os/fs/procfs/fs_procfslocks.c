@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfslocks.c
+ *
+ * /proc/locks: the contention statistics of the tracked semaphores, one per
+ * line with its acquisitions, blocking waits, total and longest wait in
+ * microseconds, current holder and the address it acquired the semaphore
+ * from.  Writing anything to the file clears the counters.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SEM_LOCKSTAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCKS_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The whole report is formatted
+ * on open so that it stays consistent across short reads.
+ */
+
+struct locks_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[1];				/* The report, allocated with the structure */
+};
+
+#define SIZEOF_LOCKS_FILE_S(n) (sizeof(struct locks_file_s) + (n) - 1)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int locks_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int locks_close(FAR struct file *filep);
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t locks_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+
+static int locks_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int locks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations locks_operations = {
+	locks_open,					/* open */
+	locks_close,					/* close */
+	locks_read,					/* read */
+	locks_write,					/* write */
+
+	locks_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	locks_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: locks_open
+ ****************************************************************************/
+
+static int locks_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct sem_lockstat_s *stats;
+	FAR struct locks_file_s *attr;
+	size_t maxsize;
+	int nentries;
+	int i;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	if (strcmp(relpath, "locks") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	stats = (FAR struct sem_lockstat_s *)kmm_malloc(CONFIG_SEM_LOCKSTAT_NENTRIES * sizeof(struct sem_lockstat_s));
+	if (!stats) {
+		fdbg("ERROR: Failed to allocate statistics\n");
+		return -ENOMEM;
+	}
+
+	nentries = sem_lockstat(stats, CONFIG_SEM_LOCKSTAT_NENTRIES);
+	maxsize = (nentries + 1) * LOCKS_LINELEN;
+
+	attr = (FAR struct locks_file_s *)kmm_zalloc(SIZEOF_LOCKS_FILE_S(maxsize));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		kmm_free(stats);
+		return -ENOMEM;
+	}
+
+	attr->size = snprintf(attr->text, LOCKS_LINELEN, "%10s %8s %8s %10s %8s %5s %10s %s\n", "ADDRESS", "ACQUIRE", "WAITS", "TOTAL_US", "MAX_US", "PID", "CALLER", "NAME");
+
+	for (i = 0; i < nentries; i++) {
+		FAR struct sem_lockstat_s *entry = &stats[i];
+		char holder[8];
+		int len;
+
+		if (entry->holder < 0) {
+			strcpy(holder, "-");
+		} else {
+			snprintf(holder, sizeof(holder), "%d", entry->holder);
+		}
+
+		len = snprintf(&attr->text[attr->size], LOCKS_LINELEN, "0x%08lx %8lu %8lu %10llu %8lu %5s 0x%08lx %s\n", (unsigned long)(uintptr_t)entry->sem, (unsigned long)entry->nacquire, (unsigned long)entry->nwait, (unsigned long long)entry->totalwait, (unsigned long)entry->maxwait, holder, (unsigned long)(uintptr_t)entry->caller, entry->name ? entry->name : "-");
+		attr->size += len < LOCKS_LINELEN ? len : LOCKS_LINELEN - 1;
+	}
+
+	kmm_free(stats);
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: locks_close
+ ****************************************************************************/
+
+static int locks_close(FAR struct file *filep)
+{
+	FAR struct locks_file_s *attr;
+
+	attr = (FAR struct locks_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: locks_read
+ ****************************************************************************/
+
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct locks_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct locks_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: locks_write
+ ****************************************************************************/
+
+static ssize_t locks_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	sem_lockstat_reset();
+	return buflen;
+}
+
+/****************************************************************************
+ * Name: locks_dup
+ ****************************************************************************/
+
+static int locks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct locks_file_s *oldattr;
+	FAR struct locks_file_s *newattr;
+	size_t allocsize;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct locks_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	allocsize = SIZEOF_LOCKS_FILE_S(oldattr->size + 1);
+	newattr = (FAR struct locks_file_s *)kmm_malloc(allocsize);
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, allocsize);
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: locks_stat
+ ****************************************************************************/
+
+static int locks_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "locks") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SEM_LOCKSTAT && !CONFIG_FS_PROCFS_EXCLUDE_LOCKS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,384 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsmm.c
+ *
+ * /proc/mm reports the allocation profile of the user heap collected with
+ * CONFIG_MM_HEAP_PROFILE.  Writing anything to /proc/mm clears the profile.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_MM_HEAP_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MM_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct mm_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	struct mm_profinfo_s info;	/* Profile snapshot taken at f_pos == 0 */
+	char line[MM_LINELEN];		/* Pre-allocated buffer for formatted lines */
+};
+
+/* State of one read() while formatting lines */
+
+struct mm_read_s {
+	FAR struct mm_file_s *attr;	/* The open file */
+	FAR char *buffer;			/* Next free byte of the user buffer */
+	size_t remaining;			/* Free bytes left in the user buffer */
+	size_t totalsize;			/* Bytes returned so far */
+	off_t offset;				/* Bytes still to be skipped */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int mm_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int mm_close(FAR struct file *filep);
+static ssize_t mm_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t mm_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+
+static int mm_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int mm_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations mm_operations = {
+	mm_open,					/* open */
+	mm_close,					/* close */
+	mm_read,					/* read */
+	mm_write,					/* write */
+
+	mm_dup,						/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	mm_stat						/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_putline
+ *
+ * Description:
+ *   Transfer the 'linesize' bytes formatted in attr->line to the user
+ *   buffer.  Returns false when the user buffer is full.
+ *
+ ****************************************************************************/
+
+static bool mm_putline(FAR struct mm_read_s *rd, size_t linesize)
+{
+	size_t copysize;
+
+	if (linesize >= MM_LINELEN) {
+		linesize = MM_LINELEN - 1;
+	}
+
+	copysize = procfs_memcpy(rd->attr->line, linesize, rd->buffer, rd->remaining, &rd->offset);
+
+	rd->totalsize += copysize;
+	rd->buffer += copysize;
+	rd->remaining -= copysize;
+
+	return rd->remaining > 0;
+}
+
+/****************************************************************************
+ * Name: mm_open
+ ****************************************************************************/
+
+static int mm_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct mm_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* "mm" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "mm") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct mm_file_s *)kmm_zalloc(sizeof(struct mm_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mm_close
+ ****************************************************************************/
+
+static int mm_close(FAR struct file *filep)
+{
+	FAR struct mm_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct mm_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mm_read
+ ****************************************************************************/
+
+static ssize_t mm_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct mm_file_s *attr;
+	FAR struct mm_profinfo_s *info;
+	struct mm_read_s rd;
+	size_t linesize;
+	int ndx;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct mm_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+	info = &attr->info;
+
+	/* Take a snapshot of the profile when reading from the beginning so
+	 * that the output remains consistent across several short reads.
+	 */
+
+	if (filep->f_pos == 0) {
+		mm_heapprofile(&g_mmheap, info);
+	}
+
+	rd.attr = attr;
+	rd.buffer = buffer;
+	rd.remaining = buflen;
+	rd.totalsize = 0;
+	rd.offset = filep->f_pos;
+
+	linesize = snprintf(attr->line, MM_LINELEN, "%-12s%u\n", "Allocs:", info->prof.mp_nalloc);
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+
+	linesize = snprintf(attr->line, MM_LINELEN, "%-12s%u\n", "Failures:", info->prof.mp_nfail);
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+
+	linesize = snprintf(attr->line, MM_LINELEN, "%-12s%lu (min %lu)\n", "Largest:", (unsigned long)info->largest, (unsigned long)info->prof.mp_minlargest);
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	linesize = snprintf(attr->line, MM_LINELEN, "%-12smax %u avg %u cycles (%u samples)\n", "Latency:", info->prof.mp_maxcycles, info->prof.mp_nsampled ? (uint32_t)(info->prof.mp_totcycles / info->prof.mp_nsampled) : 0, info->prof.mp_nsampled);
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+#endif
+
+	/* Show the histogram of allocated chunk sizes */
+
+	linesize = snprintf(attr->line, MM_LINELEN, "Chunk size histogram:\n");
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+
+	for (ndx = 0; ndx < MM_PROFILE_NHIST; ndx++) {
+		if (info->prof.mp_sizehist[ndx] == 0) {
+			continue;
+		}
+
+		linesize = snprintf(attr->line, MM_LINELEN, "  %8lu%s %u\n", 1ul << (ndx + MM_MIN_SHIFT), ndx == MM_PROFILE_NHIST - 1 ? "+:" : ":", info->prof.mp_sizehist[ndx]);
+		if (!mm_putline(&rd, linesize)) {
+			goto out;
+		}
+	}
+
+	/* Show the number of chunks in each non-empty free list */
+
+	linesize = snprintf(attr->line, MM_LINELEN, "Free lists:\n");
+	if (!mm_putline(&rd, linesize)) {
+		goto out;
+	}
+
+	for (ndx = 0; ndx < MM_NNODES; ndx++) {
+		if (info->nfree[ndx] == 0) {
+			continue;
+		}
+
+		linesize = snprintf(attr->line, MM_LINELEN, "  %8lu: %u\n", (unsigned long)mm_ndx2size(ndx), info->nfree[ndx]);
+		if (!mm_putline(&rd, linesize)) {
+			goto out;
+		}
+	}
+
+out:
+	/* Update the file offset */
+
+	filep->f_pos += rd.totalsize;
+	return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: mm_write
+ *
+ * Description:
+ *   Any write clears the profile counters.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	mm_profile_reset(&g_mmheap);
+	return buflen;
+}
+
+/****************************************************************************
+ * Name: mm_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mm_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct mm_file_s *oldattr;
+	FAR struct mm_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct mm_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct mm_file_s *)kmm_malloc(sizeof(struct mm_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct mm_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mm_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mm_stat(const char *relpath, struct stat *buf)
+{
+	/* "mm" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "mm") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "mm" is the name for a read/write file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif							/* CONFIG_MM_HEAP_PROFILE && !CONFIG_FS_PROCFS_EXCLUDE_MM */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsnetmem.c
+ *
+ * /proc/net/mem: the memory held by the network stack.  Three tables: the
+ * use of every lwIP memory pool and of the lwIP heap, the packets dropped
+ * for lack of buffers by reason, and the bytes queued on each TCP
+ * connection.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/net/netmem.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_NET_MEMINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NETMEM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETMEM_MAXPOOLS 32
+
+#ifdef CONFIG_NET_MEMP_NUM_TCP_PCB
+#define NETMEM_MAXCONNS CONFIG_NET_MEMP_NUM_TCP_PCB
+#else
+#define NETMEM_MAXCONNS 5
+#endif
+
+/* Three table headers with a blank line before the last two */
+
+#define NETMEM_LINELEN 96
+#define NETMEM_TEXTLEN ((NETMEM_MAXPOOLS + NETMEM_NDROPS + NETMEM_MAXCONNS + 5) * NETMEM_LINELEN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The report is formatted on
+ * open so that it stays consistent across short reads.
+ */
+
+struct netmem_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[NETMEM_TEXTLEN];	/* The report */
+};
+
+/* Scratch space for the snapshots taken on open */
+
+struct netmem_snapshot_s {
+	struct netmem_pool_s pools[NETMEM_MAXPOOLS];
+	struct netmem_conn_s conns[NETMEM_MAXCONNS];
+	uint32_t drops[NETMEM_NDROPS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int netmem_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int netmem_close(FAR struct file *filep);
+static ssize_t netmem_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int netmem_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int netmem_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations netmem_operations = {
+	netmem_open,				/* open */
+	netmem_close,				/* close */
+	netmem_read,				/* read */
+	NULL,						/* write */
+
+	netmem_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	netmem_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netmem_addline
+ ****************************************************************************/
+
+static void netmem_addline(FAR struct netmem_file_s *attr, int len)
+{
+	if (len > 0) {
+		attr->size += len < NETMEM_LINELEN ? len : NETMEM_LINELEN - 1;
+	}
+}
+
+/****************************************************************************
+ * Name: netmem_open
+ ****************************************************************************/
+
+static int netmem_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct netmem_file_s *attr;
+	FAR struct netmem_snapshot_s *snap;
+	FAR char *line;
+	int npools;
+	int nconns;
+	int i;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* This file is read-only */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	if (strcmp(relpath, "net/mem") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	attr = (FAR struct netmem_file_s *)kmm_zalloc(sizeof(struct netmem_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	snap = (FAR struct netmem_snapshot_s *)kmm_malloc(sizeof(struct netmem_snapshot_s));
+	if (!snap) {
+		fdbg("ERROR: Failed to allocate the snapshot\n");
+		kmm_free(attr);
+		return -ENOMEM;
+	}
+
+	npools = netmem_pools(snap->pools, NETMEM_MAXPOOLS);
+	netmem_drops(snap->drops);
+	nconns = netmem_conns(snap->conns, NETMEM_MAXCONNS);
+	if (nconns < 0) {
+		fdbg("ERROR: Failed to walk the connections: %d\n", nconns);
+		nconns = 0;
+	}
+
+	netmem_addline(attr, snprintf(attr->text, NETMEM_LINELEN, "%-16s %8s %8s %8s %8s\n", "POOL", "AVAIL", "USED", "MAX", "ERR"));
+	for (i = 0; i < npools; i++) {
+		FAR struct netmem_pool_s *p = &snap->pools[i];
+
+		line = &attr->text[attr->size];
+		netmem_addline(attr, snprintf(line, NETMEM_LINELEN, "%-16s %8lu %8lu %8lu %8lu\n", p->name, (unsigned long)p->avail, (unsigned long)p->used, (unsigned long)p->max, (unsigned long)p->err));
+	}
+
+	line = &attr->text[attr->size];
+	netmem_addline(attr, snprintf(line, NETMEM_LINELEN, "\n%-16s %8s\n", "DROP", "COUNT"));
+	for (i = 0; i < NETMEM_NDROPS; i++) {
+		line = &attr->text[attr->size];
+		netmem_addline(attr, snprintf(line, NETMEM_LINELEN, "%-16s %8lu\n", netmem_drop_name(i), (unsigned long)snap->drops[i]));
+	}
+
+	line = &attr->text[attr->size];
+	netmem_addline(attr, snprintf(line, NETMEM_LINELEN, "\n%4s %-11s %5s %21s %6s %6s %6s %5s %6s %6s\n", "SD", "STATE", "LPORT", "REMOTE", "SNDBUF", "SNDQ", "UNSENT", "PBUFS", "RCVQ", "OOSEQ"));
+	for (i = 0; i < nconns; i++) {
+		FAR struct netmem_conn_s *c = &snap->conns[i];
+		FAR const uint8_t *ip = (FAR const uint8_t *)&c->raddr;
+		char remote[22];
+
+		snprintf(remote, sizeof(remote), "%u.%u.%u.%u:%u", ip[0], ip[1], ip[2], ip[3], c->rport);
+		line = &attr->text[attr->size];
+		netmem_addline(attr, snprintf(line, NETMEM_LINELEN, "%4d %-11s %5u %21s %6lu %6lu %6lu %5u %6lu %6lu\n", c->sd, c->state, c->lport, remote, (unsigned long)c->sndbuf, (unsigned long)c->sndq, (unsigned long)c->unsent, c->sndpbufs, (unsigned long)c->rcvq, (unsigned long)c->ooseq));
+	}
+
+	kmm_free(snap);
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netmem_close
+ ****************************************************************************/
+
+static int netmem_close(FAR struct file *filep)
+{
+	FAR struct netmem_file_s *attr;
+
+	attr = (FAR struct netmem_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netmem_read
+ ****************************************************************************/
+
+static ssize_t netmem_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct netmem_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct netmem_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: netmem_dup
+ ****************************************************************************/
+
+static int netmem_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct netmem_file_s *oldattr;
+	FAR struct netmem_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct netmem_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct netmem_file_s *)kmm_malloc(sizeof(struct netmem_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct netmem_file_s));
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netmem_stat
+ ****************************************************************************/
+
+static int netmem_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "net/mem") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_NET_MEMINFO && !CONFIG_FS_PROCFS_EXCLUDE_NETMEM */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsnetstats.c
+ *
+ * /proc/net/stats: the per-layer timing of the network receive path, one
+ * stage per line with its number of packets and their average, worst and
+ * total time.  Writing anything to the file clears the counters.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/net/netperf.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_NET_PERF_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NETSTATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETSTATS_LINELEN 64
+#define NETSTATS_TEXTLEN ((NETPERF_NSTAGES + 1) * NETSTATS_LINELEN)
+
+/* Convert cycles of up_perf_gettime() to nanoseconds */
+
+#define NETSTATS_NSEC(c) ((uint64_t)(c) * 1000 / CONFIG_ARCH_PERF_CYCLES_PER_USEC)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The report is formatted on
+ * open so that it stays consistent across short reads.
+ */
+
+struct netstats_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[NETSTATS_TEXTLEN];	/* The report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int netstats_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int netstats_close(FAR struct file *filep);
+static ssize_t netstats_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t netstats_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+
+static int netstats_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int netstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations netstats_operations = {
+	netstats_open,					/* open */
+	netstats_close,					/* close */
+	netstats_read,					/* read */
+	netstats_write,					/* write */
+
+	netstats_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	netstats_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netstats_open
+ ****************************************************************************/
+
+static int netstats_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	struct netperf_stage_s stats[NETPERF_NSTAGES];
+	FAR struct netstats_file_s *attr;
+	int i;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	if (strcmp(relpath, "net/stats") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	attr = (FAR struct netstats_file_s *)kmm_zalloc(sizeof(struct netstats_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	netperf_snapshot(stats);
+
+	attr->size = snprintf(attr->text, NETSTATS_LINELEN, "%-12s %10s %10s %10s %12s\n", "STAGE", "COUNT", "AVG_NS", "MAX_NS", "TOTAL_US");
+
+	for (i = 0; i < NETPERF_NSTAGES; i++) {
+		FAR struct netperf_stage_s *s = &stats[i];
+		uint32_t avg = s->count > 0 ? (uint32_t)NETSTATS_NSEC(s->total / s->count) : 0;
+		int len;
+
+		len = snprintf(&attr->text[attr->size], NETSTATS_LINELEN, "%-12s %10lu %10lu %10lu %12llu\n", netperf_name(i), (unsigned long)s->count, (unsigned long)avg, (unsigned long)NETSTATS_NSEC(s->max), (unsigned long long)(NETSTATS_NSEC(s->total) / 1000));
+		attr->size += len < NETSTATS_LINELEN ? len : NETSTATS_LINELEN - 1;
+	}
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netstats_close
+ ****************************************************************************/
+
+static int netstats_close(FAR struct file *filep)
+{
+	FAR struct netstats_file_s *attr;
+
+	attr = (FAR struct netstats_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netstats_read
+ ****************************************************************************/
+
+static ssize_t netstats_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct netstats_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct netstats_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: netstats_write
+ ****************************************************************************/
+
+static ssize_t netstats_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	netperf_reset();
+	return buflen;
+}
+
+/****************************************************************************
+ * Name: netstats_dup
+ ****************************************************************************/
+
+static int netstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct netstats_file_s *oldattr;
+	FAR struct netstats_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct netstats_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct netstats_file_s *)kmm_malloc(sizeof(struct netstats_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct netstats_file_s));
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: netstats_stat
+ ****************************************************************************/
+
+static int netstats_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "net/stats") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_NET_PERF_STATS && !CONFIG_FS_PROCFS_EXCLUDE_NETSTATS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfspaging.c
+ *
+ * /proc/paging: the page fault, page fill and page replacement counters of
+ * the on-demand paging logic.  Writing anything to the file clears them.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/page.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SEM_LOCKSTAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGING_LINELEN 32
+#define PAGING_NLINES  5
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The counters are formatted on
+ * open so that they stay consistent across short reads.
+ */
+
+struct paging_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[PAGING_NLINES * PAGING_LINELEN];	/* The report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int paging_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct paging_file_s *attr;
+	struct pgstats_s stats;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	if (strcmp(relpath, "paging") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	attr = (FAR struct paging_file_s *)kmm_zalloc(sizeof(struct paging_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	pg_getstats(&stats);
+	attr->size = snprintf(attr->text, sizeof(attr->text), "faults:       %10lu\n" "fills:        %10lu\n" "prefetch:     %10lu\n" "prefetchused: %10lu\n" "replaced:     %10lu\n", (unsigned long)stats.nfaults, (unsigned long)stats.nfills, (unsigned long)stats.nprefetch, (unsigned long)stats.nprefetchused, (unsigned long)stats.nreplaced);
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: paging_close
+ ****************************************************************************/
+
+static int paging_close(FAR struct file *filep)
+{
+	FAR struct paging_file_s *attr;
+
+	attr = (FAR struct paging_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: paging_read
+ ****************************************************************************/
+
+static ssize_t paging_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct paging_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct paging_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: paging_write
+ ****************************************************************************/
+
+static ssize_t paging_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	pg_resetstats();
+	return buflen;
+}
+
+/****************************************************************************
+ * Name: paging_dup
+ ****************************************************************************/
+
+static int paging_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct paging_file_s *oldattr;
+	FAR struct paging_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct paging_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct paging_file_s *)kmm_malloc(sizeof(struct paging_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct paging_file_s));
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: paging_stat
+ ****************************************************************************/
+
+static int paging_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "paging") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SEM_LOCKSTAT && !CONFIG_FS_PROCFS_EXCLUDE_LOCKS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -63,6 +63,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -78,7 +79,7 @@
 #include <tinyara/fs/procfs.h>
 #include <tinyara/fs/dirent.h>
 
-#ifdef CONFIG_SCHED_CPULOAD
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CPUTIME)
 #include <tinyara/clock.h>
 #endif
 
@@ -90,9 +91,7 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
-/* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
- */
+/* The longest line generated by this logic.  Longer lines are truncated. */
 
 #define STATUS_LINELEN 32
 
@@ -109,6 +108,9 @@ enum proc_node_e {
 	PROC_CMDLINE,				/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	PROC_LOADAVG,				/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	PROC_STAT,					/* CPU time used */
 #endif
 	PROC_STACK,					/* Task stack info */
 	PROC_GROUP,					/* Group directory */
@@ -127,15 +129,22 @@ struct proc_node_s {
 	uint8_t dtype;				/* dirent type (see include/dirent.h) */
 };
 
-/* This structure describes one open "file" */
+/* This structure describes one open "file".  The whole content of the node
+ * is formatted once on open, so that reads only copy out of the snapshot
+ * and the content stays consistent across short reads.
+ */
 
 struct proc_file_s {
 	struct procfs_file_s base;	/* Base open file structure */
 	FAR const struct proc_node_s *node;	/* Describes the file node */
 	pid_t pid;					/* Task/thread ID */
-	char line[STATUS_LINELEN];	/* Pre-allocated buffer for formatted lines */
+	size_t maxsize;				/* Space reserved in text[], less the terminator */
+	size_t size;				/* Number of valid characters in text[] */
+	char text[1];				/* The snapshot, allocated with the structure */
 };
 
+#define SIZEOF_PROC_FILE_S(n) (sizeof(struct proc_file_s) + (n) - 1)
+
 /* This structure describes one open "directory" */
 
 struct proc_dir_s {
@@ -150,14 +159,20 @@ struct proc_dir_s {
 /* Helpers */
 
 static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath);
-static ssize_t proc_status(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
-static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+static void proc_printf(FAR struct proc_file_s *procfile, FAR const char *fmt, ...);
+static size_t proc_maxlines(FAR const struct proc_node_s *node, FAR struct tcb_s *tcb);
+static void proc_status(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
+static void proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
 #ifdef CONFIG_SCHED_CPULOAD
-static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+static void proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+static void proc_stat_cputime(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
 #endif
-static ssize_t proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
-static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
-static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+static void proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
+static void proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
+static void proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
+static int proc_snapshot(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb);
 
 /* File system methods */
 
@@ -223,6 +238,12 @@ static const struct proc_node_s g_loadavg = {
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_stat = {
+	"stat", "stat", (uint8_t)PROC_STAT, DTYPE_FILE	/* CPU time used */
+};
+#endif
+
 static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
@@ -246,6 +267,9 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	&g_stat,					/* CPU time used */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -262,6 +286,9 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	&g_stat,					/* CPU time used */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -328,20 +355,82 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
 	return NULL;
 }
 
+/****************************************************************************
+ * Name: proc_printf
+ *
+ * Description:
+ *   Append one formatted line to the snapshot.  Like the per-read line
+ *   buffer this replaces, a line is truncated to STATUS_LINELEN - 1
+ *   characters, and output beyond the space reserved at open is dropped.
+ *
+ ****************************************************************************/
+
+static void proc_printf(FAR struct proc_file_s *procfile, FAR const char *fmt, ...)
+{
+	va_list ap;
+	size_t avail;
+	int len;
+
+	avail = procfile->maxsize - procfile->size + 1;
+	if (avail > STATUS_LINELEN) {
+		avail = STATUS_LINELEN;
+	}
+
+	va_start(ap, fmt);
+	len = vsnprintf(&procfile->text[procfile->size], avail, fmt, ap);
+	va_end(ap);
+
+	if (len > 0) {
+		procfile->size += (size_t)len < avail ? (size_t)len : avail - 1;
+	}
+}
+
+/****************************************************************************
+ * Name: proc_maxlines
+ *
+ * Description:
+ *   Return an upper bound on the number of lines the node will generate for
+ *   the thread, so that the snapshot can be allocated before formatting.
+ *
+ ****************************************************************************/
+
+static size_t proc_maxlines(FAR const struct proc_node_s *node, FAR struct tcb_s *tcb)
+{
+	FAR char **argv;
+	size_t nlines;
+
+	switch (node->node) {
+	case PROC_CMDLINE:
+		nlines = 2;
+		if ((tcb->flags & TCB_FLAG_TTYPE_MASK) != TCB_FLAG_TTYPE_PTHREAD) {
+			for (argv = ((FAR struct task_tcb_s *)tcb)->argv + 1; *argv; argv++) {
+				nlines++;
+			}
+		}
+		return nlines;
+
+	case PROC_GROUP_STATUS:
+		return 6 + tcb->group->tg_nmembers;
+
+	case PROC_GROUP_FD:
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+		return 2 + CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS;
+#else
+		return 1 + CONFIG_NFILE_DESCRIPTORS;
+#endif
+
+	default:
+		return 6;
+	}
+}
+
 /****************************************************************************
  * Name: proc_status
  ****************************************************************************/
 
-static ssize_t proc_status(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+static void proc_status(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
 	FAR const char *name;
-	size_t remaining;
-	size_t linesize;
-	size_t copysize;
-	size_t totalsize;
-
-	remaining = buflen;
-	totalsize = 0;
 
 	/* Show the task name */
 
@@ -350,101 +439,44 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile, FAR struct tcb_s *t
 #else
 	name = "<noname>";
 #endif
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%s\n", "Name:", name);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%s\n", "Name:", name);
 
 	/* Show the thread type */
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%s\n", "Type:", g_ttypenames[(tcb->flags & TCB_FLAG_TTYPE_MASK) >> TCB_FLAG_TTYPE_SHIFT]);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%s\n", "Type:", g_ttypenames[(tcb->flags & TCB_FLAG_TTYPE_MASK) >> TCB_FLAG_TTYPE_SHIFT]);
 
 	/* Show the thread state */
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%s\n", "State:", g_statenames[tcb->task_state]);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%s\n", "State:", g_statenames[tcb->task_state]);
 
 	/* Show the thread priority */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d (%d)\n", "Priority:", tcb->sched_priority, tcb->base_priority);
+	proc_printf(procfile, "%-12s%d (%d)\n", "Priority:", tcb->sched_priority, tcb->base_priority);
 #else
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n", "Priority:", tcb->sched_priority);
+	proc_printf(procfile, "%-12s%d\n", "Priority:", tcb->sched_priority);
 #endif
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
 
 	/* Show the scheduler */
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%s", "Scheduler:", tcb->flags & TCB_FLAG_ROUND_ROBIN ? "SCHED_RR" : "SCHED_FIFO");
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%s", "Scheduler:", tcb->flags & TCB_FLAG_ROUND_ROBIN ? "SCHED_RR" : "SCHED_FIFO");
 
 	/* Show the signal mask */
 
 #ifndef CONFIG_DISABLE_SIGNALS
-
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "\n%-12s%08x", "SigMask:", tcb->sigprocmask);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
+	proc_printf(procfile, "\n%-12s%08x", "SigMask:", tcb->sigprocmask);
 #endif
-	return totalsize;
 }
 
 /****************************************************************************
  * Name: proc_cmdline
  ****************************************************************************/
 
-static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+static void proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
 	FAR struct task_tcb_s *ttcb;
 	FAR const char *name;
 	FAR char **argv;
-	size_t remaining;
-	size_t linesize;
-	size_t copysize;
-	size_t totalsize;
-
-	remaining = buflen;
-	totalsize = 0;
 
 	/* Show the task name */
 
@@ -453,31 +485,16 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 #else
 	name = "<noname>";
 #endif
-	linesize = strlen(name);
-	memcpy(procfile->line, name, linesize);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+	proc_printf(procfile, "%s", name);
 
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
 #ifndef CONFIG_DISABLE_PTHREAD
 	/* Show the pthread argument */
 
 	if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_PTHREAD) {
 		FAR struct pthread_tcb_s *ptcb = (FAR struct pthread_tcb_s *)tcb;
 
-		linesize = snprintf(procfile->line, STATUS_LINELEN, " 0x%p", ptcb->arg);
-		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-		totalsize += copysize;
-		buffer += copysize;
-		remaining -= copysize;
-
-		return totalsize;
+		proc_printf(procfile, " 0x%p", ptcb->arg);
+		return;
 	}
 #endif
 
@@ -486,19 +503,8 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 	ttcb = (FAR struct task_tcb_s *)tcb;
 
 	for (argv = ttcb->argv + 1; *argv; argv++) {
-		linesize = snprintf(procfile->line, STATUS_LINELEN, " %s", *argv);
-		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-		totalsize += copysize;
-		buffer += copysize;
-		remaining -= copysize;
-
-		if (totalsize >= buflen) {
-			return totalsize;
-		}
+		proc_printf(procfile, " %s", *argv);
 	}
-
-	return totalsize;
 }
 
 /****************************************************************************
@@ -506,17 +512,14 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_CPULOAD
-static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+static void proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
 	struct cpuload_s cpuload;
 	uint32_t intpart;
 	uint32_t fracpart;
-	size_t linesize;
-	size_t copysize;
 
-	/* Sample the counts for the thread.  clock_cpuload should only fail if
-	 * the PID is not valid.  This could happen if the thread exited sometime
-	 * after the procfs entry was opened.
+	/* Sample the counts for the thread.  The TCB was looked up with
+	 * interrupts disabled, so the PID is still valid.
 	 */
 
 	(void)clock_cpuload(procfile->pid, &cpuload);
@@ -536,182 +539,87 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 		fracpart = 0;
 	}
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%3d.%01d%%", intpart, fracpart);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
-
-	return copysize;
+	proc_printf(procfile, "%3d.%01d%%", intpart, fracpart);
 }
 #endif
 
 /****************************************************************************
- * Name: proc_stack
+ * Name: proc_stat_cputime
  ****************************************************************************/
 
-static ssize_t proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+#ifdef CONFIG_SCHED_CPUTIME
+static void proc_stat_cputime(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
-	size_t remaining;
-	size_t linesize;
-	size_t copysize;
-	size_t totalsize;
+	uint64_t usec = 0;
 
-	remaining = buflen;
-	totalsize = 0;
+	(void)clock_cputime(procfile->pid, &usec);
 
-	/* Show the stack base address */
+	proc_printf(procfile, "%-12s%lu.%06lu\n", "CPU time:", (unsigned long)(usec / 1000000), (unsigned long)(usec % 1000000));
+}
+#endif
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s0x%p\n", "StackBase:", tcb->adj_stack_ptr);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+/****************************************************************************
+ * Name: proc_stack
+ ****************************************************************************/
 
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
+static void proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
+{
+	/* Show the stack base address */
 
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s0x%p\n", "StackBase:", tcb->adj_stack_ptr);
 
 	/* Show the stack size */
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld", "StackSize:", (long)tcb->adj_stack_size);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
+	proc_printf(procfile, "%-12s%ld", "StackSize:", (long)tcb->adj_stack_size);
 
 #ifdef CONFIG_DEBUG_COLORATION
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
-
 	/* Show the stack size */
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "\n%-12s%ld", "StackUsed:", (long)up_check_tcbstack(tcb));
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
+	proc_printf(procfile, "\n%-12s%ld", "StackUsed:", (long)up_check_tcbstack(tcb));
 #endif
-
-	return totalsize;
 }
 
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
 
-static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+static void proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
 	FAR struct task_group_s *group = tcb->group;
-	size_t remaining;
-	size_t linesize;
-	size_t copysize;
-	size_t totalsize;
 #ifdef HAVE_GROUP_MEMBERS
 	int i;
 #endif
 
 	DEBUGASSERT(group);
 
-	remaining = buflen;
-	totalsize = 0;
-
 	/* Show the group IDs */
 
 #ifdef HAVE_GROUP_MEMBERS
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n", "Group ID:", group->tg_gid);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
-
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n", "Parent ID:", group->tg_pgid);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%d\n", "Group ID:", group->tg_gid);
+	proc_printf(procfile, "%-12s%d\n", "Parent ID:", group->tg_pgid);
 #endif
 
 #if !defined(CONFIG_DISABLE_PTHREAD) && defined(CONFIG_SCHED_HAVE_PARENT)
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n", "Main task:", group->tg_task);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-12s%d\n", "Main task:", group->tg_task);
 #endif
 
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s0x%02x\n", "Flags:", group->tg_flags);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
-
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d", "Members:", group->tg_nmembers);
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
+	proc_printf(procfile, "%-12s0x%02x\n", "Flags:", group->tg_flags);
+	proc_printf(procfile, "%-12s%d", "Members:", group->tg_nmembers);
 
 #ifdef HAVE_GROUP_MEMBERS
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
-
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "\nMember IDs:");
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "\nMember IDs:");
 
 	for (i = 0; i < group->tg_nmembers; i++) {
-		linesize = snprintf(procfile->line, STATUS_LINELEN, " %d");
-		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-		totalsize += copysize;
-		buffer += copysize;
-		remaining -= copysize;
-
-		if (totalsize >= buflen) {
-			return totalsize;
-		}
+		proc_printf(procfile, " %d", group->tg_members[i]);
 	}
 #endif
-
-	return totalsize;
 }
 
 /****************************************************************************
  * Name: proc_groupfd
  ****************************************************************************/
 
-static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+static void proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
 {
 	FAR struct task_group_s *group = tcb->group;
 #if CONFIG_NFILE_DESCRIPTORS > 0	/* Guaranteed to be true */
@@ -720,28 +628,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 #if CONFIG_NSOCKET_DESCRIPTORS > 0
 	FAR struct socket *socket;
 #endif
-	size_t remaining;
-	size_t linesize;
-	size_t copysize;
-	size_t totalsize;
 	int i;
 
 	DEBUGASSERT(group);
 
-	remaining = buflen;
-	totalsize = 0;
-
 #if CONFIG_NFILE_DESCRIPTORS > 0	/* Guaranteed to be true */
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "%3-s %-8s %s", "FD", "POS", "OFLAGS");
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "%-3s %-8s %s", "FD", "POS", "OFLAGS");
 
 	/* Examine each open file descriptor */
 
@@ -749,31 +641,13 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 		/* Is there an inode associated with the file descriptor? */
 
 		if (file->f_inode) {
-			linesize = snprintf(procfile->line, STATUS_LINELEN, "\n%3d %8ld %04x", i, (long)file->f_pos, file->f_oflags);
-			copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-			totalsize += copysize;
-			buffer += copysize;
-			remaining -= copysize;
-
-			if (totalsize >= buflen) {
-				return totalsize;
-			}
+			proc_printf(procfile, "\n%3d %8ld %04x", i, (long)file->f_pos, file->f_oflags);
 		}
 	}
 #endif
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0
-	linesize = snprintf(procfile->line, STATUS_LINELEN, "\n%3-s %-2s %-3s %s", "SD", "RF", "TYP", "FLAGS");
-	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-	totalsize += copysize;
-	buffer += copysize;
-	remaining -= copysize;
-
-	if (totalsize >= buflen) {
-		return totalsize;
-	}
+	proc_printf(procfile, "\n%-3s %-2s %-3s %s", "SD", "RF", "TYP", "FLAGS");
 
 	/* Examine each open socket descriptor */
 
@@ -781,21 +655,61 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 		/* Is there an connection associated with the socket descriptor? */
 
 		if (socket->conn) {
-			linesize = snprintf(procfile->line, STATUS_LINELEN, "\n%3d %2d %3d %02x", i + CONFIG_NFILE_DESCRIPTORS, (long)socket->conn->state, socket->conn->type, socket->conn->flags);
-			copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
-
-			totalsize += copysize;
-			buffer += copysize;
-			remaining -= copysize;
-
-			if (totalsize >= buflen) {
-				return totalsize;
-			}
+			proc_printf(procfile, "\n%3d %2d %3d %02x", i + CONFIG_NFILE_DESCRIPTORS, (int)socket->conn->state, socket->conn->type, socket->conn->flags);
 		}
 	}
 #endif
+}
+
+/****************************************************************************
+ * Name: proc_snapshot
+ *
+ * Description:
+ *   Format the whole content of the node into the snapshot.  Called with
+ *   interrupts disabled so that the TCB cannot go away underneath.
+ *
+ ****************************************************************************/
+
+static int proc_snapshot(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb)
+{
+	procfile->size = 0;
+
+	switch (procfile->node->node) {
+	case PROC_STATUS:			/* Task/thread status */
+		proc_status(procfile, tcb);
+		break;
+
+	case PROC_CMDLINE:			/* Task command line */
+		proc_cmdline(procfile, tcb);
+		break;
+
+#ifdef CONFIG_SCHED_CPULOAD
+	case PROC_LOADAVG:			/* Average CPU utilization */
+		proc_loadavg(procfile, tcb);
+		break;
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	case PROC_STAT:				/* CPU time used */
+		proc_stat_cputime(procfile, tcb);
+		break;
+#endif
+	case PROC_STACK:			/* Task stack info */
+		proc_stack(procfile, tcb);
+		break;
+
+	case PROC_GROUP_STATUS:	/* Task group status */
+		proc_groupstatus(procfile, tcb);
+		break;
+
+	case PROC_GROUP_FD:		/* Group file descriptors */
+		proc_groupfd(procfile, tcb);
+		break;
+
+	default:
+		return -EINVAL;
+	}
 
-	return totalsize;
+	return OK;
 }
 
 /****************************************************************************
@@ -810,7 +724,9 @@ static int proc_open(FAR struct file *filep, FAR const char *relpath, int oflags
 	FAR char *ptr;
 	irqstate_t flags;
 	unsigned long tmp;
+	size_t maxsize;
 	pid_t pid;
+	int ret;
 
 	fvdbg("Open '%s'\n", relpath);
 
@@ -848,19 +764,6 @@ static int proc_open(FAR struct file *filep, FAR const char *relpath, int oflags
 		return -ENOENT;
 	}
 
-	/* Now verify that a task with this task/thread ID exists */
-
-	pid = (pid_t)tmp;
-
-	flags = irqsave();
-	tcb = sched_gettcb(pid);
-	irqrestore(flags);
-
-	if (!tcb) {
-		fdbg("ERROR: PID %d is no longer valid\n", (int)pid);
-		return -ENOENT;
-	}
-
 	/* The remaining segments of the relpath should be a well known node in
 	 * the task/thread tree.
 	 */
@@ -878,9 +781,25 @@ static int proc_open(FAR struct file *filep, FAR const char *relpath, int oflags
 		return -EISDIR;
 	}
 
+	/* Now verify that a task with this task/thread ID exists and size the
+	 * snapshot for it.
+	 */
+
+	pid = (pid_t)tmp;
+
+	flags = irqsave();
+	tcb = sched_gettcb(pid);
+	maxsize = tcb ? proc_maxlines(node, tcb) * (STATUS_LINELEN - 1) : 0;
+	irqrestore(flags);
+
+	if (!tcb) {
+		fdbg("ERROR: PID %d is no longer valid\n", (int)pid);
+		return -ENOENT;
+	}
+
 	/* Allocate a container to hold the task and node selection */
 
-	procfile = (FAR struct proc_file_s *)kmm_zalloc(sizeof(struct proc_file_s));
+	procfile = (FAR struct proc_file_s *)kmm_malloc(SIZEOF_PROC_FILE_S(maxsize + 1));
 	if (!procfile) {
 		fdbg("ERROR: Failed to allocate file container\n");
 		return -ENOMEM;
@@ -888,8 +807,25 @@ static int proc_open(FAR struct file *filep, FAR const char *relpath, int oflags
 
 	/* Initialize the file container */
 
+	memset(procfile, 0, sizeof(struct proc_file_s));
 	procfile->pid = pid;
 	procfile->node = node;
+	procfile->maxsize = maxsize;
+
+	/* Format the snapshot.  The thread may have exited while the container
+	 * was allocated.
+	 */
+
+	flags = irqsave();
+	tcb = sched_gettcb(pid);
+	ret = tcb ? proc_snapshot(procfile, tcb) : -ENOENT;
+	irqrestore(flags);
+
+	if (ret < 0) {
+		fdbg("ERROR: PID %d is no longer valid\n", (int)pid);
+		kmm_free(procfile);
+		return ret;
+	}
 
 	/* Save the index as the open-specific state in filep->f_priv */
 
@@ -924,8 +860,7 @@ static int proc_close(FAR struct file *filep)
 static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 {
 	FAR struct proc_file_s *procfile;
-	FAR struct tcb_s *tcb;
-	irqstate_t flags;
+	off_t offset;
 	ssize_t ret;
 
 	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
@@ -935,51 +870,10 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 	procfile = (FAR struct proc_file_s *)filep->f_priv;
 	DEBUGASSERT(procfile);
 
-	/* Verify that the thread is still valid */
-
-	flags = irqsave();
-	tcb = sched_gettcb(procfile->pid);
-
-	if (!tcb) {
-		fdbg("ERROR: PID %d is not valid\n", (int)procfile->pid);
-		irqrestore(flags);
-		return -ENODEV;
-	}
-
-	/* Provide the requested data */
+	/* Provide the requested data from the snapshot taken on open */
 
-	switch (procfile->node->node) {
-	case PROC_STATUS:			/* Task/thread status */
-		ret = proc_status(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-
-	case PROC_CMDLINE:			/* Task command line */
-		ret = proc_cmdline(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-
-#ifdef CONFIG_SCHED_CPULOAD
-	case PROC_LOADAVG:			/* Average CPU utilization */
-		ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-#endif
-	case PROC_STACK:			/* Task stack info */
-		ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-
-	case PROC_GROUP_STATUS:	/* Task group status */
-		ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-
-	case PROC_GROUP_FD:		/* Group file descriptors */
-		ret = proc_groupfd(procfile, tcb, buffer, buflen, filep->f_pos);
-		break;
-
-	default:
-		ret = -EINVAL;
-		break;
-	}
-
-	irqrestore(flags);
+	offset = filep->f_pos;
+	ret = procfs_memcpy(procfile->text, procfile->size, buffer, buflen, &offset);
 
 	/* Update the file offset */
 
@@ -1002,6 +896,7 @@ static int proc_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
 	FAR struct proc_file_s *oldfile;
 	FAR struct proc_file_s *newfile;
+	size_t allocsize;
 
 	fvdbg("Dup %p->%p\n", oldp, newp);
 
@@ -1012,15 +907,19 @@ static int proc_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 	/* Allocate a new container to hold the task and node selection */
 
-	newfile = (FAR struct proc_file_s *)kmm_malloc(sizeof(struct proc_file_s));
+	allocsize = SIZEOF_PROC_FILE_S(oldfile->size + 1);
+	newfile = (FAR struct proc_file_s *)kmm_malloc(allocsize);
 	if (!newfile) {
 		fdbg("ERROR: Failed to allocate file container\n");
 		return -ENOMEM;
 	}
 
-	/* The copy the file information from the old container to the new */
+	/* The copy the file information and snapshot from the old container to
+	 * the new
+	 */
 
-	memcpy(newfile, oldfile, sizeof(struct proc_file_s));
+	memcpy(newfile, oldfile, allocsize);
+	newfile->maxsize = oldfile->size;
 
 	/* Save the new container in the new file structure */
 
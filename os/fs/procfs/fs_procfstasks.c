@@ -0,0 +1,340 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfstasks.c
+ *
+ * /proc/tasks: the state, priority, stack and CPU usage of every task and
+ * thread as fixed-size binary records (see struct procfs_task_s), taken in
+ * one pass over the task list.  A poller gets the whole table with a single
+ * read instead of opening and parsing several text files per task.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  There cannot be more threads
+ * than CONFIG_MAX_TASKS, so the snapshot is allocated once on open and is
+ * refreshed in place when the file is read again from the start.  hdr and
+ * task[] are contiguous and are returned as they are.
+ */
+
+struct tasks_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	bool consumed;				/* The snapshot has been returned by a read */
+	size_t size;				/* Number of valid bytes from hdr */
+	struct procfs_tasks_hdr_s hdr;
+	struct procfs_task_s task[CONFIG_MAX_TASKS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static void tasks_entry(FAR struct tcb_s *tcb, FAR void *arg);
+static void tasks_snapshot(FAR struct tasks_file_s *attr);
+
+/* File system methods */
+
+static int tasks_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int tasks_close(FAR struct file *filep);
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int tasks_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int tasks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations tasks_operations = {
+	tasks_open,					/* open */
+	tasks_close,				/* close */
+	tasks_read,					/* read */
+	NULL,						/* write */
+
+	tasks_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	tasks_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tasks_entry
+ *
+ * Description:
+ *   sched_foreach() callback filling in the record of one thread.  Called
+ *   with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void tasks_entry(FAR struct tcb_s *tcb, FAR void *arg)
+{
+	FAR struct tasks_file_s *attr = (FAR struct tasks_file_s *)arg;
+	FAR struct procfs_task_s *task;
+#ifdef CONFIG_SCHED_CPULOAD
+	struct cpuload_s cpuload;
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	uint64_t usec;
+#endif
+
+	if (attr->hdr.ntasks >= CONFIG_MAX_TASKS) {
+		return;
+	}
+
+	task = &attr->task[attr->hdr.ntasks++];
+	memset(task, 0, sizeof(struct procfs_task_s));
+
+	task->pid = tcb->pid;
+	task->flags = tcb->flags;
+	task->state = tcb->task_state;
+	task->priority = tcb->sched_priority;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	task->base_priority = tcb->base_priority;
+#else
+	task->base_priority = tcb->sched_priority;
+#endif
+	task->stack_size = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+	task->stack_used = up_check_tcbstack(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+	if (clock_cpuload(tcb->pid, &cpuload) == OK) {
+		task->cpuload_active = cpuload.active;
+		attr->hdr.cpuload_total = cpuload.total;
+	}
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+	if (clock_cputime(tcb->pid, &usec) == OK) {
+		task->cputime = usec;
+	}
+#endif
+
+#if CONFIG_TASK_NAME_SIZE > 0
+	strncpy(task->name, tcb->name, CONFIG_TASK_NAME_SIZE);
+#endif
+}
+
+/****************************************************************************
+ * Name: tasks_snapshot
+ ****************************************************************************/
+
+static void tasks_snapshot(FAR struct tasks_file_s *attr)
+{
+	memset(&attr->hdr, 0, sizeof(struct procfs_tasks_hdr_s));
+
+	attr->hdr.magic = PROCFS_TASKS_MAGIC;
+	attr->hdr.version = PROCFS_TASKS_VERSION;
+	attr->hdr.hdrsize = sizeof(struct procfs_tasks_hdr_s);
+	attr->hdr.recsize = sizeof(struct procfs_task_s);
+	attr->hdr.flags = PROCFS_TASKS_BASEPRIO;
+#ifdef CONFIG_SCHED_CPULOAD
+	attr->hdr.flags |= PROCFS_TASKS_CPULOAD;
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+	attr->hdr.flags |= PROCFS_TASKS_CPUTIME;
+#endif
+#ifdef CONFIG_STACK_COLORATION
+	attr->hdr.flags |= PROCFS_TASKS_STACKUSED;
+#endif
+	attr->hdr.systime = clock_systimer();
+
+	/* sched_foreach() keeps interrupts disabled throughout, so the records
+	 * are consistent with each other.
+	 */
+
+	sched_foreach(tasks_entry, attr);
+
+	attr->size = sizeof(struct procfs_tasks_hdr_s) + attr->hdr.ntasks * sizeof(struct procfs_task_s);
+	attr->consumed = false;
+}
+
+/****************************************************************************
+ * Name: tasks_open
+ ****************************************************************************/
+
+static int tasks_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct tasks_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	if (strcmp(relpath, "tasks") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	attr = (FAR struct tasks_file_s *)kmm_zalloc(sizeof(struct tasks_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	tasks_snapshot(attr);
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_close
+ ****************************************************************************/
+
+static int tasks_close(FAR struct file *filep)
+{
+	FAR struct tasks_file_s *attr;
+
+	attr = (FAR struct tasks_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_read
+ ****************************************************************************/
+
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct tasks_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	attr = (FAR struct tasks_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* The snapshot taken on open is returned by the first pass.  Rewinding
+	 * to zero after that takes a new one.
+	 */
+
+	if (filep->f_pos == 0 && attr->consumed) {
+		tasks_snapshot(attr);
+	}
+
+	attr->consumed = true;
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy((FAR const char *)&attr->hdr, attr->size, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: tasks_dup
+ ****************************************************************************/
+
+static int tasks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct tasks_file_s *oldattr;
+	FAR struct tasks_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	oldattr = (FAR struct tasks_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct tasks_file_s *)kmm_malloc(sizeof(struct tasks_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct tasks_file_s));
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_stat
+ ****************************************************************************/
+
+static int tasks_stat(const char *relpath, struct stat *buf)
+{
+	if (strcmp(relpath, "tasks") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* !CONFIG_FS_PROCFS_EXCLUDE_TASKS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
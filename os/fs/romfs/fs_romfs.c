@@ -374,6 +374,17 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer, size_t bufle
 		buflen = bytesleft;
 	}
 
+	/* If the image is directly addressable, copy the data straight from it
+	 * rather than sector by sector through the file buffer.
+	 */
+
+	if (rm->rm_xipbase) {
+		memcpy(userbuffer, rm->rm_xipbase + rf->rf_startoffset + filep->f_pos, buflen);
+		filep->f_pos += buflen;
+		romfs_semgive(rm);
+		return buflen;
+	}
+
 	/* Loop until either (1) all data has been transferred, or (2) an
 	 * error occurs.
 	 */
@@ -232,6 +232,10 @@
 #define UINT8_TO_UINT16(UINT8_ARRAY)                    ((uint16_t)(((uint16_t)UINT8_ARRAY[1] << 8) & 0xFF00) | UINT8_ARRAY[0])
 #define SMARTFS_NEXTSECTOR(h)   (UINT8_TO_UINT16(h->nextsector))
 #define SMARTFS_USED(h)                 (UINT8_TO_UINT16(h->used))
+
+/* Maximum number of sectors that smartfs_read reads with one request */
+
+#define SMARTFS_MAX_READAHEAD   32
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 #define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
@@ -365,6 +369,9 @@ struct smartfs_ofile_s {
 	size_t filepos;				/* Current file position */
 	uint16_t currsector;		/* Current sector of filepos */
 	uint16_t curroffset;		/* Current offset in sector */
+	uint16_t readahead;			/* Number of sectors to read at once.  Grows
+								 * while the chain is found to run over
+								 * consecutive logical sectors. */
 	uint16_t byteswritten;		/* Count of bytes written to currsector
 								 * that have not been recorded in the
 								 * sector yet.  We delay updating the
@@ -395,6 +402,9 @@ struct smartfs_mountpt_s {
 #endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 	struct journal_transaction_manager_s *journal;
+#endif
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	FAR uint8_t *fs_dcache;		/* Directory entry cache */
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
 };
@@ -490,6 +500,12 @@ struct journal_transaction_manager_s {
 	uint8_t *buffer;			/* buffer to hold logging entry header and data */
 	uint8_t *active_sectors;	/* map to mark sectors which are written but not yet synced */
 	struct active_write_node_s *list;	/* linked list to hold information about writes which need sync */
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	uint8_t *gbuffer;			/* Staging buffer for merged journal writes */
+	uint16_t pendsector;		/* Journal sector of the deferred finished marks */
+	uint8_t npending;			/* Number of deferred finished marks */
+	uint16_t pending[CONFIG_SMARTFS_JOURNAL_GROUP_MAX];	/* Offsets of the transactions */
+#endif
 };
 #endif
 /****************************************************************************
@@ -543,6 +559,15 @@ uint16_t get_used_byte_count_from_end(uint8_t *buffer);
 int set_used_byte_count(uint8_t *used, uint16_t count);
 uint16_t get_used_byte_count(uint8_t *used);
 #endif
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+int smartfs_dcache_init(FAR struct smartfs_mountpt_s *fs);
+void smartfs_dcache_release(FAR struct smartfs_mountpt_s *fs);
+void smartfs_dcache_flush(FAR struct smartfs_mountpt_s *fs);
+FAR struct smartfs_entry_header_s *smartfs_dcache_lookup(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name, FAR uint16_t *dsector, FAR uint16_t *doffset);
+void smartfs_dcache_insert(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, uint16_t dsector, uint16_t doffset, FAR const struct smartfs_entry_header_s *entry);
+void smartfs_dcache_remove(FAR struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset);
+#endif
+
 #ifdef CONFIG_SMARTFS_SECTOR_RECOVERY
 int smartfs_recover(struct inode *mountpt);
 int smart_validatesector(FAR struct inode *inode, uint16_t logsector, char *validsectors);
@@ -559,6 +584,9 @@ struct stat;
 int smartfs_journal_init(struct smartfs_mountpt_s *fs);
 int smartfs_create_journalentry(struct smartfs_mountpt_s *fs, enum logging_transaction_type_e type, uint16_t curr_sector, uint16_t offset, uint16_t datalen, uint16_t genericdata, uint8_t needsync, const uint8_t *data, uint16_t *t_sector, uint16_t *t_offset);
 int smartfs_finish_journalentry(struct smartfs_mountpt_s *fs, uint16_t curr_sector, uint16_t sector, uint16_t offset, enum logging_transaction_type_e type);
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+int smartfs_journal_flush(struct smartfs_mountpt_s *fs);
+#endif
 #endif
 
 #endif							/* __FS_SMARTFS_SMARTFS_H */
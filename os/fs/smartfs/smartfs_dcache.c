@@ -0,0 +1,265 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/smartfs/smartfs_dcache.c
+ *
+ * Directory entry cache.  Each mount keeps a direct mapped hash table of
+ * directory entries, indexed by the first sector of the parent directory
+ * and the entry name.  A slot holds a copy of the entry as it is stored on
+ * the device together with its location, so that smartfs_finddirentry()
+ * can resolve a path segment without scanning the directory sectors.
+ * Entries are added as directories are scanned and when they are created,
+ * and removed when they are deleted or renamed.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "smartfs.h"
+
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One slot of the cache.  It is followed by the entry header and the name
+ * as stored on the device (namesize bytes, not always NUL terminated).
+ */
+
+struct smartfs_dcache_slot_s {
+	uint16_t dfirst;			/* First sector of the parent directory,
+								 * 0xFFFF if the slot is unused */
+	uint16_t dsector;			/* Sector holding the entry */
+	uint16_t doffset;			/* Offset of the entry in that sector */
+	uint16_t pad;				/* Keeps the entry copy 32-bit aligned */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Size of one slot including the copy of the entry, rounded up so that
+ * the slots stay aligned.
+ */
+
+static inline size_t smartfs_dcache_slotsize(FAR struct smartfs_mountpt_s *fs)
+{
+	size_t size;
+
+	size = sizeof(struct smartfs_dcache_slot_s) + sizeof(struct smartfs_entry_header_s) + fs->fs_llformat.namesize;
+	return (size + 3) & ~3;
+}
+
+static inline FAR struct smartfs_dcache_slot_s *smartfs_dcache_slot(FAR struct smartfs_mountpt_s *fs, unsigned int index)
+{
+	return (FAR struct smartfs_dcache_slot_s *)&fs->fs_dcache[index * smartfs_dcache_slotsize(fs)];
+}
+
+static inline FAR struct smartfs_entry_header_s *smartfs_dcache_entry(FAR struct smartfs_dcache_slot_s *slot)
+{
+	return (FAR struct smartfs_entry_header_s *)(slot + 1);
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_hash
+ *
+ * Description:
+ *   FNV-1a hash of the parent directory and of the name, which is compared
+ *   up to namesize characters like in the directory scan.
+ *
+ ****************************************************************************/
+
+static unsigned int smartfs_dcache_hash(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name)
+{
+	uint32_t hash = 2166136261u;
+	uint16_t x;
+
+	hash = (hash ^ (dfirst & 0xFF)) * 16777619u;
+	hash = (hash ^ (dfirst >> 8)) * 16777619u;
+
+	for (x = 0; x < fs->fs_llformat.namesize && name[x] != '\0'; x++) {
+		hash = (hash ^ (uint8_t)name[x]) * 16777619u;
+	}
+
+	return hash % CONFIG_SMARTFS_DIRENT_CACHE_SIZE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_dcache_init
+ *
+ * Description:
+ *   Allocate the directory entry cache of a mount.  Must be called once the
+ *   low-level format (and thus the name size) is known.
+ *
+ ****************************************************************************/
+
+int smartfs_dcache_init(FAR struct smartfs_mountpt_s *fs)
+{
+	fs->fs_dcache = (FAR uint8_t *)kmm_malloc(CONFIG_SMARTFS_DIRENT_CACHE_SIZE * smartfs_dcache_slotsize(fs));
+	if (fs->fs_dcache == NULL) {
+		fdbg("Error allocating the directory entry cache\n");
+		return -ENOMEM;
+	}
+
+	smartfs_dcache_flush(fs);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_release
+ *
+ * Description:
+ *   Free the directory entry cache of a mount.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_release(FAR struct smartfs_mountpt_s *fs)
+{
+	if (fs->fs_dcache != NULL) {
+		kmm_free(fs->fs_dcache);
+		fs->fs_dcache = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_flush
+ *
+ * Description:
+ *   Drop all the entries of the cache.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_flush(FAR struct smartfs_mountpt_s *fs)
+{
+	unsigned int x;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	for (x = 0; x < CONFIG_SMARTFS_DIRENT_CACHE_SIZE; x++) {
+		smartfs_dcache_slot(fs, x)->dfirst = 0xFFFF;
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_lookup
+ *
+ * Description:
+ *   Look up the entry 'name' of the directory starting at sector 'dfirst'.
+ *   On success, its location is returned in 'dsector' and 'doffset'.
+ *
+ * Returned Value:
+ *   The cached copy of the entry, valid until the cache is next modified,
+ *   or NULL if the entry is not cached.  This does not mean that the entry
+ *   does not exist.
+ *
+ ****************************************************************************/
+
+FAR struct smartfs_entry_header_s *smartfs_dcache_lookup(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name, FAR uint16_t *dsector, FAR uint16_t *doffset)
+{
+	FAR struct smartfs_dcache_slot_s *slot;
+	FAR struct smartfs_entry_header_s *cached;
+
+	if (fs->fs_dcache == NULL) {
+		return NULL;
+	}
+
+	slot = smartfs_dcache_slot(fs, smartfs_dcache_hash(fs, dfirst, name));
+	if (slot->dfirst != dfirst) {
+		return NULL;
+	}
+
+	cached = smartfs_dcache_entry(slot);
+	if (strncmp(cached->name, name, fs->fs_llformat.namesize) != 0) {
+		return NULL;
+	}
+
+	*dsector = slot->dsector;
+	*doffset = slot->doffset;
+	return cached;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_insert
+ *
+ * Description:
+ *   Add a valid entry of the directory starting at 'dfirst', found at
+ *   sector 'dsector', offset 'doffset'.  An entry with the same hash is
+ *   replaced.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_insert(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, uint16_t dsector, uint16_t doffset, FAR const struct smartfs_entry_header_s *entry)
+{
+	FAR struct smartfs_dcache_slot_s *slot;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	slot = smartfs_dcache_slot(fs, smartfs_dcache_hash(fs, dfirst, entry->name));
+	slot->dfirst = dfirst;
+	slot->dsector = dsector;
+	slot->doffset = doffset;
+	memcpy(smartfs_dcache_entry(slot), entry, sizeof(struct smartfs_entry_header_s) + fs->fs_llformat.namesize);
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_remove
+ *
+ * Description:
+ *   Drop the entry stored at sector 'dsector', offset 'doffset', if it is
+ *   cached.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_remove(FAR struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset)
+{
+	FAR struct smartfs_dcache_slot_s *slot;
+	unsigned int x;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	for (x = 0; x < CONFIG_SMARTFS_DIRENT_CACHE_SIZE; x++) {
+		slot = smartfs_dcache_slot(fs, x);
+		if (slot->dfirst != 0xFFFF && slot->dsector == dsector && slot->doffset == doffset) {
+			slot->dfirst = 0xFFFF;
+		}
+	}
+}
+
+#endif							/* CONFIG_SMARTFS_DIRENT_CACHE */
@@ -70,6 +70,7 @@
 #include <debug.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/dirent.h>
 #include <tinyara/fs/ioctl.h>
@@ -317,6 +318,7 @@ static int smartfs_open(FAR struct file *filep, const char *relpath, int oflags,
 	sf->curroffset = sizeof(struct smartfs_chain_header_s);
 	sf->currsector = sf->entry.firstsector;
 	sf->byteswritten = 0;
+	sf->readahead = 1;
 
 	/* Test if we opened for APPEND mode.  If we did, then seek to the
 	 * end of the file.
@@ -461,11 +463,16 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 	struct smartfs_mountpt_s *fs;
 	struct smartfs_ofile_s *sf;
 	struct smart_read_write_s readwrite;
+	struct smart_read_sectors_s readsects;
 	struct smartfs_chain_header_s *header;
+	uint8_t *sectorbuf;
 	int ret = OK;
 	uint32_t bytesread;
 	uint16_t bytestoread;
 	uint16_t bytesinsector;
+	uint16_t nextsector;
+	uint16_t nsectors;
+	uint16_t x;
 
 	/* Sanity checks */
 
@@ -495,70 +502,133 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 			break;
 		}
 
-		/* Read the curent sector into our buffer */
+		/* If the file has been running over consecutive logical sectors and
+		 * the caller's buffer can hold several of them, read them with one
+		 * request, using the caller's buffer as the sector buffer.
+		 */
 
-		readwrite.logsector = sf->currsector;
-		readwrite.offset = 0;
-		readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-		readwrite.count = fs->fs_llformat.availbytes;
-		ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-		if (ret < 0) {
-			fdbg("Error %d reading sector %d data\n", ret, sf->currsector);
-			goto errout_with_semaphore;
+		nsectors = 0;
+		if (sf->readahead > 1 && sf->curroffset == sizeof(struct smartfs_chain_header_s)) {
+			nsectors = sf->readahead;
+			if ((buflen - bytesread) / fs->fs_llformat.sectorsize < nsectors) {
+				nsectors = (buflen - bytesread) / fs->fs_llformat.sectorsize;
+			}
 		}
 
-		/* Point header to the read data to get used byte count */
+		if (nsectors > 1) {
+			readsects.logsector = sf->currsector;
+			readsects.nsectors = nsectors;
+			readsects.count = fs->fs_llformat.availbytes;
+			readsects.buffer = (uint8_t *)&buffer[bytesread];
+			ret = FS_IOCTL(fs, BIOC_READSECTS, (unsigned long)&readsects);
+			if (ret < 0) {
+				fdbg("Error %d reading sectors %d-%d data\n", ret, sf->currsector, sf->currsector + nsectors - 1);
+				goto errout_with_semaphore;
+			}
 
-		header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+			nsectors = ret;
+			sectorbuf = readsects.buffer;
+		} else {
+			/* Read the curent sector into our buffer */
 
-		/* Get number of used bytes in this sector */
+			readwrite.logsector = sf->currsector;
+			readwrite.offset = 0;
+			readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+			readwrite.count = fs->fs_llformat.availbytes;
+			ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+			if (ret < 0) {
+				fdbg("Error %d reading sector %d data\n", ret, sf->currsector);
+				goto errout_with_semaphore;
+			}
+
+			nsectors = 1;
+			sectorbuf = (uint8_t *)fs->fs_rwbuffer;
+		}
+
+		/* Copy out the data of each sector read while they follow the chain */
+
+		for (x = 0; x < nsectors; x++, sectorbuf += fs->fs_llformat.availbytes) {
+			/* Point header to the read data to get used byte count */
+
+			header = (struct smartfs_chain_header_s *)sectorbuf;
+
+			/* Get number of used bytes in this sector */
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-		bytesinsector = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
+			bytesinsector = get_leftover_used_byte_count(sectorbuf, get_used_byte_count((uint8_t *)header->used));
 #else
-		bytesinsector = SMARTFS_USED(header);
+			bytesinsector = SMARTFS_USED(header);
 
-		if (bytesinsector == SMARTFS_ERASEDSTATE_16BIT) {
-			/* No bytes to read from this sector */
+			if (bytesinsector == SMARTFS_ERASEDSTATE_16BIT) {
+				/* No bytes to read from this sector */
 
-			bytesinsector = 0;
-		}
+				bytesinsector = 0;
+			}
 #endif
-		/* Calculate the number of bytes to read into the buffer */
+			/* The copy below may overwrite the header of a sector read into
+			 * the caller's buffer, so get the next sector first.
+			 */
 
-		bytestoread = bytesinsector - (sf->curroffset - sizeof(struct smartfs_chain_header_s));
-		if (bytestoread + bytesread > buflen) {
-			/* Truncate bytesto read based on buffer len */
+			nextsector = SMARTFS_NEXTSECTOR(header);
 
-			bytestoread = buflen - bytesread;
-		}
+			/* Calculate the number of bytes to read into the buffer */
 
-		/* Copy data to the read buffer */
+			bytestoread = bytesinsector - (sf->curroffset - sizeof(struct smartfs_chain_header_s));
+			if (bytestoread + bytesread > buflen) {
+				/* Truncate bytesto read based on buffer len */
 
-		if (bytestoread > 0) {
-			/* Do incremental copy from this sector */
+				bytestoread = buflen - bytesread;
+			}
 
-			memcpy(&buffer[bytesread], &fs->fs_rwbuffer[sf->curroffset], bytestoread);
-			bytesread += bytestoread;
-			sf->filepos += bytestoread;
-			sf->curroffset += bytestoread;
-		}
+			/* Copy data to the read buffer */
 
-		/* Test if we are at the end of the data in this sector */
+			if (bytestoread > 0) {
+				/* Do incremental copy from this sector */
 
-		if ((bytestoread == 0) || (sf->curroffset == fs->fs_llformat.availbytes)) {
-			/* Set the next sector as the current sector */
+				memmove(&buffer[bytesread], &sectorbuf[sf->curroffset], bytestoread);
+				bytesread += bytestoread;
+				sf->filepos += bytestoread;
+				sf->curroffset += bytestoread;
+			}
 
-			sf->currsector = SMARTFS_NEXTSECTOR(header);
-			sf->curroffset = sizeof(struct smartfs_chain_header_s);
+			/* Test if we are at the end of the data in this sector */
+
+			if ((bytestoread == 0) || (sf->curroffset == fs->fs_llformat.availbytes)) {
+				/* Track whether the chain runs over consecutive sectors */
+
+				if (nextsector == sf->currsector + 1) {
+					if (sf->readahead < SMARTFS_MAX_READAHEAD) {
+						sf->readahead <<= 1;
+					}
+				} else {
+					sf->readahead = 1;
+				}
+
+				/* Set the next sector as the current sector */
 
-			/* Test if at end of data */
+				sf->currsector = nextsector;
+				sf->curroffset = sizeof(struct smartfs_chain_header_s);
+
+				/* Test if at end of data or if the sectors read ahead are not
+				 * the next ones of the chain.
+				 */
 
-			if (sf->currsector == SMARTFS_ERASEDSTATE_16BIT) {
-				/* No more data!  Return what we have */
+				if (sf->currsector == SMARTFS_ERASEDSTATE_16BIT || sf->readahead == 1) {
+					break;
+				}
+			} else {
+				/* The buffer is full or this sector holds no more data for
+				 * now; the sectors read ahead are not used.
+				 */
 
 				break;
 			}
 		}
+
+		if (sf->currsector == SMARTFS_ERASEDSTATE_16BIT) {
+			/* No more data!  Return what we have */
+
+			break;
+		}
 	}
 
 	/* Return the number of bytes we read */
@@ -1241,6 +1311,14 @@ static int smartfs_sync(FAR struct file *filep)
 
 	ret = smartfs_sync_internal(fs, sf);
 
+#ifdef CONFIG_MTD_SMART_WRITEBACK
+	/* Also push out the sectors held in the MTD write-back cache */
+
+	if (ret == OK) {
+		ret = FS_IOCTL(fs, BIOC_FLUSH, 0);
+	}
+#endif
+
 	smartfs_semgive(fs);
 	return ret;
 }
@@ -1507,6 +1585,7 @@ static int smartfs_bind(FAR struct inode *blkdriver, const void *data, void **ha
 	fs->fs_sem = &g_sem;
 	if (!g_seminitialized) {
 		sem_init(&g_sem, 0, 0);	/* Initialize the semaphore that controls access */
+		(void)sem_setname(&g_sem, "smartfs");
 		g_seminitialized = TRUE;
 	} else {
 		/* Take the semaphore for the mount */
@@ -1539,6 +1618,13 @@ static int smartfs_bind(FAR struct inode *blkdriver, const void *data, void **ha
 		kmm_free(fs);
 		return ret;
 	}
+#endif
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	/* Set up the cache once any journaled change has been replayed.  We
+	 * run without it if there is not enough memory.
+	 */
+
+	(void)smartfs_dcache_init(fs);
 #endif
 	smartfs_semgive(fs);
 
@@ -1572,12 +1658,22 @@ static int smartfs_unbind(void *handle, FAR struct inode **blkdriver)
 		smartfs_semgive(fs);
 		return -EBUSY;
 	}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	/* Leave no finished transaction to be replayed */
+	(void)smartfs_journal_flush(fs);
+	if (fs->journal) {
+		kmm_free(fs->journal->gbuffer);
+	}
+#endif
 	/* Unmount ... close the block driver */
 	ret = smartfs_unmount(fs);
 #ifdef CONFIG_SMARTFS_JOURNALING
 	if (fs->journal) {
 		kmm_free(fs->journal);
 	}
+#endif
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	smartfs_dcache_release(fs);
 #endif
 	smartfs_semgive(fs);
 	kmm_free(fs);
@@ -2074,6 +2170,9 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath, const char *ne
 		readwrite.count = sizeof(uint16_t);
 		readwrite.buffer = (uint8_t *)tmp_pntr;
 		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+		smartfs_dcache_remove(fs, oldentry.dsector, oldentry.doffset);
+#endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 		retj = smartfs_finish_journalentry(fs, 0, t_sector, t_offset, T_RENAME);
 		if (retj != OK) {
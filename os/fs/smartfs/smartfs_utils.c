@@ -177,6 +177,9 @@ int clear_journal_sectors(struct smartfs_mountpt_s *fs, struct journal_transacti
 static int set_area_id_bits(struct smartfs_mountpt_s *fs, uint8_t id_bits);
 static int smartfs_write_transaction(struct smartfs_mountpt_s *fs, struct journal_transaction_manager_s
 									 *j_mgr, uint16_t *sector, uint16_t *offset);
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+static int smartfs_journal_merge(struct smartfs_mountpt_s *fs, uint16_t sector, uint16_t offset, const uint8_t *tail, uint16_t count);
+#endif
 #endif
 /****************************************************************************
  * Public Variables
@@ -775,6 +778,10 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 	struct smartfs_entry_header_s *entry;
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	struct smartfs_entry_header_s *cached;
+	bool fromcache;
+#endif
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 	int used_value;
 #endif
@@ -854,32 +861,56 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 			offset = 0xFFFF;
 
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+			cached = smartfs_dcache_lookup(fs, dirsector, fs->fs_workbuffer, &readwrite.logsector, &offset);
+#endif
+
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
 			while (dirsector != 0xFFFF)
 #else
 			while (dirsector != 0)
 #endif
 			{
-				/* Read the next directory in the chain */
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+				if (cached != NULL) {
+					/* Only check the cached entry.  The directory is scanned
+					 * from its first sector if it does not match.
+					 */
 
-				readwrite.logsector = dirsector;
-				readwrite.count = fs->fs_llformat.availbytes;
-				readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-				readwrite.offset = 0;
-				ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-				if (ret < 0) {
-					goto errout;
-				}
+					header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+					entry = cached;
+					readwrite.count = offset + entrysize;
+					cached = NULL;
+					fromcache = true;
+				} else
+#endif
+				{
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+					fromcache = false;
+#endif
 
-				/* Point to next sector in chain */
+					/* Read the next directory in the chain */
 
-				header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
-				dirsector = SMARTFS_NEXTSECTOR(header);
+					readwrite.logsector = dirsector;
+					readwrite.count = fs->fs_llformat.availbytes;
+					readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+					readwrite.offset = 0;
+					ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+					if (ret < 0) {
+						goto errout;
+					}
 
-				/* Search for the entry */
+					/* Point to next sector in chain */
+
+					header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+					dirsector = SMARTFS_NEXTSECTOR(header);
+
+					/* Search for the entry */
+
+					offset = sizeof(struct smartfs_chain_header_s);
+					entry = (struct smartfs_entry_header_s *)&fs->fs_rwbuffer[offset];
+				}
 
-				offset = sizeof(struct smartfs_chain_header_s);
-				entry = (struct smartfs_entry_header_s *)&fs->fs_rwbuffer[offset];
 				while (offset < readwrite.count) {
 					/* Test if this entry is valid and active */
 
@@ -893,6 +924,14 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 						continue;
 					}
 
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+					/* Remember the entries seen on the way */
+
+					if (!fromcache) {
+						smartfs_dcache_insert(fs, dirstack[depth], readwrite.logsector, offset, entry);
+					}
+#endif
+
 					/* Test if the name matches */
 
 					if (strncmp(entry->name, fs->fs_workbuffer, fs->fs_llformat.namesize) == 0) {
@@ -1277,6 +1316,13 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 		goto errout;
 	}
 
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	/* The new entry is likely to be looked up soon */
+
+	smartfs_dcache_remove(fs, psector, offset);
+	smartfs_dcache_insert(fs, parentdirsector, psector, offset, entry);
+#endif
+
 	/* Now fill in the entry */
 
 	direntry->firstsector = nextsector;
@@ -1409,6 +1455,18 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 		goto errout;
 	}
 
+#ifdef CONFIG_SMARTFS_DIRENT_CACHE
+	/* Forget the entry.  Forget everything for a directory since its
+	 * sectors may now be reused by another one.
+	 */
+
+	if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_DIR) {
+		smartfs_dcache_flush(fs);
+	} else {
+		smartfs_dcache_remove(fs, entry->dsector, entry->doffset);
+	}
+#endif
+
 	/* Test if any entries in this sector are being used */
 
 	if ((entry->dsector != fs->fs_rootsector) && (entry->dsector != entry->dfirst)) {
@@ -1588,6 +1646,17 @@ int smartfs_truncatefile(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *e
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	/* Truncation is not journaled: a write to the freed sectors must not be
+	 * replayed.
+	 */
+
+	ret = smartfs_journal_flush(fs);
+	if (ret != OK) {
+		return ret;
+	}
+#endif
+
 	/* Walk through the directory's sectors and count entries */
 
 	nextsector = entry->firstsector;
@@ -1938,6 +2007,13 @@ int smartfs_journal_init(struct smartfs_mountpt_s *fs)
 	if (!(journal->buffer)) {
 		goto err_out;
 	}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	journal->npending = 0;
+	journal->gbuffer = (uint8_t *)kmm_malloc(journal->availbytes);
+	if (!(journal->gbuffer)) {
+		goto err_out;
+	}
+#endif
 
 	/* Allocate a bitmap to mark currently active sectors (sectors which are
 	 * written and need sync) */
@@ -2043,6 +2119,11 @@ err_out:
 		if (journal->buffer) {
 			kmm_free(journal->buffer);
 		}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+		if (journal->gbuffer) {
+			kmm_free(journal->gbuffer);
+		}
+#endif
 		kmm_free(journal);
 		journal = NULL;
 	}
@@ -2773,6 +2854,14 @@ static int move_journal_area(struct smartfs_mountpt_s *fs)
 	read_area = j_mgr->jarea;
 	write_area = (read_area == 0) ? 1 : 0;
 
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	/* The finished marks must land before the unfinished entries are copied */
+	ret = smartfs_journal_flush(fs);
+	if (ret != OK) {
+		return ret;
+	}
+#endif
+
 	temp_mgr.enabled = j_mgr->enabled;
 	temp_mgr.jarea = read_area;
 	temp_mgr.sector = SMARTFS_LOGGING_SECTOR + write_area * CONFIG_SMARTFS_NLOGGING_SECTORS;
@@ -2946,6 +3035,170 @@ static int get_next_sector_info(struct journal_transaction_manager_s *j_mgr)
 	}
 	return ret;
 }
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+/****************************************************************************
+ * Name: smartfs_journal_merge
+ *
+ * Description: Write 'count' bytes of 'tail' at 'offset' in journal sector
+ *              'sector' together with the deferred finished marks, with a
+ *              single sector write when they are in the same sector.  The
+ *              bytes between the marks and the tail are read back so that
+ *              they are written unchanged.  With no tail, only the marks
+ *              are written.
+ *
+ ****************************************************************************/
+static int smartfs_journal_merge(struct smartfs_mountpt_s *fs, uint16_t sector, uint16_t offset, const uint8_t *tail, uint16_t count)
+{
+	int ret;
+	uint8_t x;
+	uint16_t start;
+	uint16_t end;
+	struct smart_read_write_s req;
+	struct journal_transaction_manager_s *journal;
+
+	journal = fs->journal;
+	if (journal->npending > 0 && journal->pendsector != sector) {
+		/* The marks cannot go with this write */
+
+		ret = smartfs_journal_merge(fs, journal->pendsector, 0, NULL, 0);
+		if (ret != OK) {
+			return ret;
+		}
+	}
+
+	req.logsector = sector;
+	if (journal->npending == 0) {
+		if (count == 0) {
+			return OK;
+		}
+
+		req.offset = offset;
+		req.count = count;
+		req.buffer = (uint8_t *)tail;
+		return FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
+	}
+
+	/* Find the span of the marks, they all precede the tail */
+
+	start = journal->pending[0];
+	end = journal->pending[0];
+	for (x = 1; x < journal->npending; x++) {
+		if (journal->pending[x] < start) {
+			start = journal->pending[x];
+		}
+		if (journal->pending[x] > end) {
+			end = journal->pending[x];
+		}
+	}
+
+	end = (count > 0) ? offset : end + offsetof(struct smartfs_logging_entry_s, trans_info) + 1;
+
+	req.offset = start;
+	req.count = end - start;
+	req.buffer = journal->gbuffer;
+	ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&req);
+	if (ret < 0) {
+		fdbg("Reading failed %u %u\n", req.logsector, req.offset);
+		return ret;
+	}
+
+	for (x = 0; x < journal->npending; x++) {
+		T_SET_TRANSACTION(journal->gbuffer[journal->pending[x] - start + offsetof(struct smartfs_logging_entry_s, trans_info)], TRANS_FINISHED);
+	}
+
+	if (count > 0) {
+		memcpy(journal->gbuffer + req.count, tail, count);
+		req.count += count;
+	}
+
+	ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
+	if (ret != OK) {
+		fdbg("Writing failed %u %u\n", req.logsector, req.offset);
+		return ret;
+	}
+
+	journal->npending = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smartfs_journal_flush
+ *
+ * Description: Write out the deferred finished marks.
+ *
+ ****************************************************************************/
+int smartfs_journal_flush(struct smartfs_mountpt_s *fs)
+{
+	if (!fs->journal || !fs->journal->enabled || fs->journal->npending == 0) {
+		return OK;
+	}
+
+	return smartfs_journal_merge(fs, fs->journal->pendsector, 0, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: smartfs_write_grouped
+ *
+ * Description: Write the transaction entry and its data at the position
+ *              of the journal manager, already marked as started, along
+ *              with the deferred finished marks.  Data that goes on to the
+ *              next sector is written first, so that the entry is never
+ *              seen as started before it is complete.
+ *
+ ****************************************************************************/
+static int smartfs_write_grouped(struct smartfs_mountpt_s *fs, struct journal_transaction_manager_s *j_mgr, uint16_t startsector)
+{
+	int ret;
+	uint16_t size;
+	uint16_t count;
+	struct smart_read_write_s req;
+	struct smartfs_logging_entry_s *entry;
+
+	entry = (struct smartfs_logging_entry_s *)(j_mgr->buffer);
+	T_SET_TRANSACTION(entry->trans_info, TRANS_STARTED);
+
+	size = sizeof(struct smartfs_logging_entry_s);
+	if (entry->datalen > 0 && GET_TRANS_TYPE(entry->trans_info) != T_DELETE) {
+		size += entry->datalen;
+	}
+
+	count = size;
+	if (j_mgr->offset + size > j_mgr->availbytes) {
+		count = j_mgr->availbytes - j_mgr->offset;
+
+		req.logsector = j_mgr->sector + 1;
+		if (req.logsector >= startsector + CONFIG_SMARTFS_NLOGGING_SECTORS) {
+			/* This case should have been handled by the caller */
+			fdbg("logical sector is too big!! %d\n", req.logsector);
+			return -ENOSPC;
+		}
+		req.offset = 0;
+		req.count = size - count;
+		req.buffer = j_mgr->buffer + count;
+		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
+		if (ret != OK) {
+			fdbg("write remained data failed ret : %d\n", ret);
+			return ret;
+		}
+	}
+
+	ret = smartfs_journal_merge(fs, j_mgr->sector, j_mgr->offset, j_mgr->buffer, count);
+	if (ret != OK) {
+		fdbg("write entry failed ret : %d\n", ret);
+		return ret;
+	}
+
+	if (count < size) {
+		j_mgr->sector++;
+		j_mgr->offset = size - count;
+	} else {
+		j_mgr->offset += size;
+	}
+
+	return OK;
+}
+#endif							/* CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT */
+
 /****************************************************************************
  * Name: smartfs_write_transaction
  *
@@ -2985,6 +3238,10 @@ static int smartfs_write_transaction(struct smartfs_mountpt_s *fs, struct journa
 
 	*sector = j_mgr->sector;
 	*offset = j_mgr->offset;
+
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	return smartfs_write_grouped(fs, j_mgr, startsector);
+#else
 	req.logsector = *sector;
 	req.offset = *offset;
 	req.count = sizeof(struct smartfs_logging_entry_s);
@@ -3052,6 +3309,7 @@ static int smartfs_write_transaction(struct smartfs_mountpt_s *fs, struct journa
 	}
 
 	return ret;
+#endif							/* CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT */
 }
 
 /****************************************************************************
@@ -3318,6 +3576,25 @@ int smartfs_finish_journalentry(struct smartfs_mountpt_s *fs, uint16_t curr_sect
 	if (IS_ACTIVE(j_mgr->active_sectors, curr_sector) && type == T_SYNC) {
 		remove_from_list(j_mgr, curr_sector);
 	}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	/* Defer the mark.  Replaying a finished write or sync rewrites the same
+	 * data, but the other operations must not be replayed once finished.
+	 */
+	if (j_mgr->npending > 0 && (j_mgr->pendsector != sector || j_mgr->npending == CONFIG_SMARTFS_JOURNAL_GROUP_MAX)) {
+		int ret = smartfs_journal_flush(fs);
+		if (ret != OK) {
+			return ret;
+		}
+	}
+
+	j_mgr->pendsector = sector;
+	j_mgr->pending[j_mgr->npending++] = offset;
+	if (type != T_WRITE && type != T_SYNC) {
+		return smartfs_journal_flush(fs);
+	}
+	return OK;
+#else
 	return smartfs_set_transaction(fs, sector, offset, TRANS_FINISHED);
+#endif
 }
 #endif /* END OF CONFIG_SMARTFS_JOURNALING */
\ No newline at end of file
@@ -0,0 +1,807 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_epoll.c
+ *
+ * An epoll instance is an open file whose private data holds the
+ * descriptors registered with epoll_ctl().  Each registration owns a struct
+ * pollfd that stays set up with fdesc_poll() until the descriptor is
+ * removed, so that epoll_wait() does not set up and tear down every
+ * descriptor on each call like poll() does.
+ *
+ * Sockets report new events through the notify() callback of the pollfd,
+ * which puts the registration on the ready list of the instance:
+ * epoll_wait() then only visits the sockets that had an event.  Other
+ * descriptors only post the semaphore of the instance, and their revents
+ * are checked when epoll_wait() wakes up.
+ *
+ * A level-triggered descriptor that was reported is set up again before
+ * the next wait, which reports it again if it is still ready.
+ *
+ * Descriptors duplicated by dup() or inherited by a child task share the
+ * instance, which is released on the last close.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#include <arch/irq.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_EPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Events that are reported whether they are requested or not */
+
+#define EPOLL_ALWAYS     (EPOLLERR | EPOLLHUP)
+
+/* Events passed to the poll setup of a descriptor */
+
+#define EPOLL_POLLEVENTS (EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct epoll_head_s;
+
+/* One descriptor registered with an instance */
+
+struct epoll_item_s {
+	FAR struct epoll_item_s *flink;	/* Next descriptor of the same kind */
+	FAR struct epoll_item_s *rlink;	/* Next descriptor on the ready list */
+	FAR struct epoll_item_s *alink;	/* Next descriptor to set up again */
+	FAR struct epoll_head_s *eph;	/* The instance */
+	struct epoll_event event;		/* Requested events and user data */
+	struct pollfd pfd;				/* Poll setup of the descriptor */
+	bool armed;						/* True: pfd is set up */
+	bool queued;					/* True: on the ready list */
+	bool rearm;						/* True: on the list to set up again */
+};
+
+/* The private data of an epoll file */
+
+struct epoll_head_s {
+	sem_t exclsem;					/* Serializes epoll_ctl() and epoll_wait() */
+	sem_t waitsem;					/* Posted when a descriptor has events */
+	FAR struct epoll_item_s *sockets;	/* Registered sockets */
+	FAR struct epoll_item_s *files;	/* Other registered descriptors */
+	FAR struct epoll_item_s *rearm;	/* Level-triggered descriptors reported */
+	int crefs;						/* Files open on the instance */
+
+	/* The ready list is updated by notify(), with interrupts disabled */
+
+	FAR struct epoll_item_s *rhead;
+	FAR struct epoll_item_s *rtail;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep);
+static int epoll_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_fops = {
+	epoll_open,					/* open */
+	epoll_close,				/* close */
+	0,							/* read */
+	0,							/* write */
+	0,							/* seek */
+	0,							/* ioctl */
+	0,							/* poll */
+	0							/* unlink */
+};
+
+/* All the epoll files share this inode, which is not in the tree */
+
+static struct inode g_epoll_inode = {
+	.i_crefs = 1,
+	.u = {
+		.i_ops = &g_epoll_fops,
+	},
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(sem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define epoll_semgive(sem) sem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_head
+ *
+ * Description:
+ *   Return the instance of an epoll file descriptor, or NULL with errno set.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_head(int epfd)
+{
+	FAR struct file *filep;
+
+	if ((unsigned int)epfd >= CONFIG_NFILE_DESCRIPTORS) {
+		set_errno(EBADF);
+		return NULL;
+	}
+
+	filep = fs_getfilep(epfd);
+	if (filep == NULL) {
+		/* The errno value has already been set */
+
+		return NULL;
+	}
+
+	if (filep->f_inode == NULL) {
+		set_errno(EBADF);
+		return NULL;
+	}
+
+	if (filep->f_inode != &g_epoll_inode || filep->f_priv == NULL) {
+		set_errno(EINVAL);
+		return NULL;
+	}
+
+	return (FAR struct epoll_head_s *)filep->f_priv;
+}
+
+/****************************************************************************
+ * Name: epoll_notify
+ *
+ * Description:
+ *   Called by the socket layer when a socket has new events.
+ *
+ ****************************************************************************/
+
+static void epoll_notify(FAR struct pollfd *fds)
+{
+	FAR struct epoll_item_s *item;
+	FAR struct epoll_head_s *eph;
+	irqstate_t flags;
+
+	item = (FAR struct epoll_item_s *)((FAR uint8_t *)fds - offsetof(struct epoll_item_s, pfd));
+	eph = item->eph;
+
+	flags = irqsave();
+	if (!item->queued) {
+		item->rlink = NULL;
+		if (eph->rtail != NULL) {
+			eph->rtail->rlink = item;
+		} else {
+			eph->rhead = item;
+		}
+
+		eph->rtail = item;
+		item->queued = true;
+	}
+
+	irqrestore(flags);
+
+	sem_post(&eph->waitsem);
+}
+
+/****************************************************************************
+ * Name: epoll_unqueue
+ *
+ * Description:
+ *   Remove a descriptor from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_unqueue(FAR struct epoll_item_s *item)
+{
+	FAR struct epoll_head_s *eph = item->eph;
+	FAR struct epoll_item_s *prev = NULL;
+	FAR struct epoll_item_s *curr;
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (item->queued) {
+		for (curr = eph->rhead; curr != item; prev = curr, curr = curr->rlink) {
+			DEBUGASSERT(curr != NULL);
+		}
+
+		if (prev != NULL) {
+			prev->rlink = item->rlink;
+		} else {
+			eph->rhead = item->rlink;
+		}
+
+		if (eph->rtail == item) {
+			eph->rtail = prev;
+		}
+
+		item->rlink = NULL;
+		item->queued = false;
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_arm / epoll_disarm
+ *
+ * Description:
+ *   Set up / tear down the poll of a registered descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_item_s *item)
+{
+	int ret;
+
+	item->pfd.sem = &item->eph->waitsem;
+	item->pfd.events = (pollevent_t)((item->event.events | EPOLL_ALWAYS) & EPOLL_POLLEVENTS);
+	item->pfd.revents = 0;
+	item->pfd.priv = NULL;
+	item->pfd.flink = NULL;
+	item->pfd.notify = ((unsigned int)item->pfd.fd >= CONFIG_NFILE_DESCRIPTORS) ? epoll_notify : NULL;
+
+	ret = fdesc_poll(item->pfd.fd, &item->pfd, true);
+	if (ret < 0) {
+		/* fdesc_poll() returns ERROR with errno set for a bad descriptor */
+
+		return ret == ERROR ? -get_errno() : ret;
+	}
+
+	item->armed = true;
+	return OK;
+}
+
+static void epoll_disarm(FAR struct epoll_item_s *item)
+{
+	if (item->armed) {
+		(void)fdesc_poll(item->pfd.fd, &item->pfd, false);
+		item->armed = false;
+	}
+
+	epoll_unqueue(item);
+	item->pfd.revents = 0;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Return the registration of 'fd' and, in 'prev', the link pointing to
+ *   it.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_item_s *epoll_find(FAR struct epoll_head_s *eph, int fd, FAR struct epoll_item_s ***prev)
+{
+	FAR struct epoll_item_s **link;
+
+	link = ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) ? &eph->sockets : &eph->files;
+	while (*link != NULL && (*link)->pfd.fd != fd) {
+		link = &(*link)->flink;
+	}
+
+	*prev = link;
+	return *link;
+}
+
+/****************************************************************************
+ * Name: epoll_norearm
+ *
+ * Description:
+ *   Take a descriptor off the list of descriptors to set up again.
+ *
+ ****************************************************************************/
+
+static void epoll_norearm(FAR struct epoll_head_s *eph, FAR struct epoll_item_s *item)
+{
+	FAR struct epoll_item_s **link;
+
+	if (item->rearm) {
+		for (link = &eph->rearm; *link != item; link = &(*link)->alink) {
+			DEBUGASSERT(*link != NULL);
+		}
+
+		*link = item->alink;
+		item->alink = NULL;
+		item->rearm = false;
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_report
+ *
+ * Description:
+ *   Return the events of a descriptor in 'ev' if there are any.  Returns
+ *   true if an event was returned.
+ *
+ ****************************************************************************/
+
+static bool epoll_report(FAR struct epoll_head_s *eph, FAR struct epoll_item_s *item, pollevent_t revents, FAR struct epoll_event *ev)
+{
+	revents &= item->pfd.events;
+	if (revents == 0) {
+		return false;
+	}
+
+	ev->events = revents;
+	ev->data = item->event.data;
+
+	if ((item->event.events & EPOLLONESHOT) != 0) {
+		/* Disabled until EPOLL_CTL_MOD */
+
+		epoll_disarm(item);
+	} else if ((item->event.events & EPOLLET) == 0 && !item->rearm) {
+		item->alink = eph->rearm;
+		eph->rearm = item;
+		item->rearm = true;
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Return up to 'maxevents' events.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph, FAR struct epoll_event *events, int maxevents)
+{
+	FAR struct epoll_item_s *item;
+	pollevent_t revents;
+	irqstate_t flags;
+	int nevents = 0;
+
+	/* Set the level-triggered descriptors reported last time up again, so
+	 * that they report the events still in effect.
+	 */
+
+	while ((item = eph->rearm) != NULL) {
+		eph->rearm = item->alink;
+		item->alink = NULL;
+		item->rearm = false;
+
+		epoll_disarm(item);
+		if (epoll_arm(item) < 0) {
+			/* Most likely closed while registered */
+
+			fdbg("Failed to set up fd %d again\n", item->pfd.fd);
+		}
+	}
+
+	/* Sockets with new events */
+
+	while (nevents < maxevents) {
+		flags = irqsave();
+		item = eph->rhead;
+		if (item != NULL) {
+			eph->rhead = item->rlink;
+			if (eph->rhead == NULL) {
+				eph->rtail = NULL;
+			}
+
+			item->rlink = NULL;
+			item->queued = false;
+			revents = item->pfd.revents;
+			item->pfd.revents = 0;
+		}
+
+		irqrestore(flags);
+
+		if (item == NULL) {
+			break;
+		}
+
+		if (epoll_report(eph, item, revents, &events[nevents])) {
+			nevents++;
+		}
+	}
+
+	/* Other descriptors */
+
+	for (item = eph->files; item != NULL && nevents < maxevents; item = item->flink) {
+		if (!item->armed) {
+			continue;
+		}
+
+		flags = irqsave();
+		revents = item->pfd.revents;
+		item->pfd.revents = 0;
+		irqrestore(flags);
+
+		if (revents != 0 && epoll_report(eph, item, revents, &events[nevents])) {
+			nevents++;
+		}
+	}
+
+	return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_open
+ *
+ * Description:
+ *   Only called when a file is duplicated, with f_priv copied from the
+ *   original file: add a reference to the instance.
+ *
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep)
+{
+	FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)filep->f_priv;
+
+	if (eph == NULL) {
+		return -EBADF;
+	}
+
+	epoll_semtake(&eph->exclsem);
+	eph->crefs++;
+	epoll_semgive(&eph->exclsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Drop the reference of a file and release the epoll instance with the
+ *   last one.
+ *
+ ****************************************************************************/
+
+static int epoll_close(FAR struct file *filep)
+{
+	FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)filep->f_priv;
+	FAR struct epoll_item_s *item;
+	FAR struct epoll_item_s **list;
+	int crefs;
+	int i;
+
+	if (eph == NULL) {
+		return OK;
+	}
+
+	filep->f_priv = NULL;
+
+	epoll_semtake(&eph->exclsem);
+	crefs = --eph->crefs;
+	epoll_semgive(&eph->exclsem);
+	if (crefs > 0) {
+		return OK;
+	}
+
+	for (i = 0; i < 2; i++) {
+		list = (i == 0) ? &eph->sockets : &eph->files;
+		while ((item = *list) != NULL) {
+			*list = item->flink;
+			epoll_disarm(item);
+			kmm_free(item);
+		}
+	}
+
+	sem_destroy(&eph->waitsem);
+	sem_destroy(&eph->exclsem);
+	kmm_free(eph);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create1
+ *
+ * Description:
+ *   Create an epoll instance and return its file descriptor.
+ *
+ ****************************************************************************/
+
+int epoll_create1(int flags)
+{
+	FAR struct epoll_head_s *eph;
+	FAR struct file *filep;
+	int err;
+	int fd;
+
+	if ((flags & ~EPOLL_CLOEXEC) != 0) {
+		err = EINVAL;
+		goto errout;
+	}
+
+	eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+	if (eph == NULL) {
+		err = ENOMEM;
+		goto errout;
+	}
+
+	eph->crefs = 1;
+	sem_init(&eph->exclsem, 0, 1);
+
+	/*
+	 * This semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+	sem_init(&eph->waitsem, 0, 0);
+	sem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+
+	inode_addref(&g_epoll_inode);
+
+	fd = files_allocate(&g_epoll_inode, O_RDOK, 0, 0);
+	if (fd < 0) {
+		err = EMFILE;
+		goto errout_with_inode;
+	}
+
+	filep = fs_getfilep(fd);
+	DEBUGASSERT(filep != NULL);
+	filep->f_priv = eph;
+	return fd;
+
+errout_with_inode:
+	inode_release(&g_epoll_inode);
+	sem_destroy(&eph->waitsem);
+	sem_destroy(&eph->exclsem);
+	kmm_free(eph);
+
+errout:
+	set_errno(err);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Same as epoll_create1(0).  'size' is only checked for compatibility.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size)
+{
+	if (size <= 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	return epoll_create1(0);
+}
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add, modify or remove a descriptor of an epoll instance.
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
+{
+	FAR struct epoll_head_s *eph;
+	FAR struct epoll_item_s *item;
+	FAR struct epoll_item_s **prev;
+	int ret = OK;
+
+	eph = epoll_head(epfd);
+	if (eph == NULL) {
+		/* The errno value has already been set */
+
+		return ERROR;
+	}
+
+	if (fd < 0 || fd == epfd || (op != EPOLL_CTL_DEL && ev == NULL)) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	epoll_semtake(&eph->exclsem);
+
+	item = epoll_find(eph, fd, &prev);
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		item = (FAR struct epoll_item_s *)kmm_zalloc(sizeof(struct epoll_item_s));
+		if (item == NULL) {
+			ret = -ENOMEM;
+			break;
+		}
+
+		item->eph = eph;
+		item->event = *ev;
+		item->pfd.fd = fd;
+
+		ret = epoll_arm(item);
+		if (ret < 0) {
+			kmm_free(item);
+			break;
+		}
+
+		item->flink = *prev;
+		*prev = item;
+		break;
+
+	case EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_norearm(eph, item);
+		epoll_disarm(item);
+		item->event = *ev;
+		ret = epoll_arm(item);
+		break;
+
+	case EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		*prev = item->flink;
+		epoll_norearm(eph, item);
+		epoll_disarm(item);
+		kmm_free(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	epoll_semgive(&eph->exclsem);
+
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait for events on the descriptors of an epoll instance.
+ *
+ * Return:
+ *   The number of events returned in 'events', zero on timeout, or -1 with
+ *   errno set (EBADF, EINVAL or EINTR).
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout)
+{
+	FAR struct epoll_head_s *eph;
+	struct timespec abstime;
+	int nevents;
+	int ret;
+
+	/* epoll_wait() is a cancellation point */
+	(void)enter_cancellation_point();
+
+	eph = epoll_head(epfd);
+	if (eph == NULL) {
+		/* The errno value has already been set */
+
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if (events == NULL || maxevents <= 0) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if (timeout > 0) {
+		(void)clock_gettime(CLOCK_REALTIME, &abstime);
+
+		abstime.tv_sec += timeout / MSEC_PER_SEC;
+		abstime.tv_nsec += (timeout % MSEC_PER_SEC) * NSEC_PER_MSEC;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+	}
+
+	for (;;) {
+		/* The events posted so far are all collected below */
+
+		while (sem_trywait(&eph->waitsem) == 0) ;
+
+		epoll_semtake(&eph->exclsem);
+		nevents = epoll_collect(eph, events, maxevents);
+		epoll_semgive(&eph->exclsem);
+
+		if (nevents > 0 || timeout == 0) {
+			break;
+		}
+
+		if (timeout > 0) {
+			ret = sem_timedwait(&eph->waitsem, &abstime);
+		} else {
+			ret = sem_wait(&eph->waitsem);
+		}
+
+		if (ret < 0) {
+			if (get_errno() == ETIMEDOUT) {
+				nevents = 0;
+			} else {
+				/* EINTR is the only other error expected, errno is set */
+
+				nevents = ERROR;
+			}
+
+			break;
+		}
+	}
+
+	leave_cancellation_point();
+	return nevents;
+}
+
+#endif							/* CONFIG_EPOLL */
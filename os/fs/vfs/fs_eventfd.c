@@ -0,0 +1,499 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_eventfd.c
+ *
+ * An eventfd is an open file whose private data holds a 64-bit counter.
+ * write() adds to the counter and read() returns and resets it, so that
+ * tasks wake each other through read(), write() and poll() without the
+ * buffer and the copies of a pipe.  Like epoll, the files share one inode
+ * that is not in the tree.  Descriptors duplicated by dup() or inherited
+ * by a child task share the counter, which is freed on the last close.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/eventfd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_EVENTFD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest value of the counter */
+
+#define EVENTFD_MAX     ((eventfd_t)0xfffffffffffffffeull)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The private data of an eventfd file */
+
+struct eventfd_s {
+	sem_t exclsem;				/* Serializes access to the counter */
+	sem_t rdsem;				/* Posted when the counter becomes non-zero */
+	sem_t wrsem;				/* Posted when the counter is decreased */
+	eventfd_t counter;
+	int flags;					/* EFD_SEMAPHORE */
+	int crefs;					/* Files open on the counter */
+	FAR struct pollfd *fds[CONFIG_EVENTFD_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep);
+static int eventfd_close(FAR struct file *filep);
+static ssize_t eventfd_fileread(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t eventfd_filewrite(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_eventfd_fops = {
+	eventfd_open,				/* open */
+	eventfd_close,				/* close */
+	eventfd_fileread,			/* read */
+	eventfd_filewrite,			/* write */
+	0,							/* seek */
+	0,							/* ioctl */
+	eventfd_poll,				/* poll */
+	0							/* unlink */
+};
+
+/* All the eventfd files share this inode, which is not in the tree */
+
+static struct inode g_eventfd_inode = {
+	.i_crefs = 1,
+	.u = {
+		.i_ops = &g_eventfd_fops,
+	},
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int eventfd_semtake(FAR sem_t *sem)
+{
+	if (sem_wait(sem) < 0) {
+		return -get_errno();
+	}
+
+	return OK;
+}
+
+#define eventfd_semgive(sem) sem_post(sem)
+
+/****************************************************************************
+ * Name: eventfd_wake
+ *
+ * Description:
+ *   Wake all the tasks waiting on 'sem'.
+ *
+ ****************************************************************************/
+
+static void eventfd_wake(FAR sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: eventfd_pollnotify
+ ****************************************************************************/
+
+static void eventfd_pollnotify(FAR struct eventfd_s *dev, pollevent_t eventset)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_EVENTFD_NPOLLWAITERS; i++) {
+		FAR struct pollfd *fds = dev->fds[i];
+		if (fds) {
+			fds->revents |= (fds->events & eventset);
+			if (fds->revents != 0) {
+				sem_post(fds->sem);
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: eventfd_open
+ *
+ * Description:
+ *   Only called when a file is duplicated, with f_priv copied from the
+ *   original file: add a reference to the counter.
+ *
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep)
+{
+	FAR struct eventfd_s *dev = (FAR struct eventfd_s *)filep->f_priv;
+	int ret;
+
+	if (dev == NULL) {
+		return -EBADF;
+	}
+
+	ret = eventfd_semtake(&dev->exclsem);
+	if (ret < 0) {
+		return ret;
+	}
+
+	dev->crefs++;
+	eventfd_semgive(&dev->exclsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_close
+ *
+ * Description:
+ *   Drop the reference of a file and release the eventfd with the last
+ *   one.
+ *
+ ****************************************************************************/
+
+static int eventfd_close(FAR struct file *filep)
+{
+	FAR struct eventfd_s *dev = (FAR struct eventfd_s *)filep->f_priv;
+	int crefs;
+
+	if (dev == NULL) {
+		return OK;
+	}
+
+	filep->f_priv = NULL;
+
+	while (sem_wait(&dev->exclsem) < 0) {
+		/* Interrupted by a signal; the reference must still be dropped */
+	}
+
+	crefs = --dev->crefs;
+	eventfd_semgive(&dev->exclsem);
+	if (crefs > 0) {
+		return OK;
+	}
+
+	sem_destroy(&dev->wrsem);
+	sem_destroy(&dev->rdsem);
+	sem_destroy(&dev->exclsem);
+	kmm_free(dev);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_fileread
+ *
+ * Description:
+ *   Return the counter and reset it, or return 1 and decrement it with
+ *   EFD_SEMAPHORE.  Waits while the counter is zero unless the file is
+ *   non-blocking.
+ *
+ ****************************************************************************/
+
+static ssize_t eventfd_fileread(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct eventfd_s *dev = (FAR struct eventfd_s *)filep->f_priv;
+	eventfd_t value;
+	int ret;
+
+	if (dev == NULL) {
+		return -EBADF;
+	}
+
+	if (buflen < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	ret = eventfd_semtake(&dev->exclsem);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (dev->counter == 0) {
+		if ((filep->f_oflags & O_NONBLOCK) != 0) {
+			eventfd_semgive(&dev->exclsem);
+			return -EAGAIN;
+		}
+
+		/* Wait for a write without letting it run before we wait */
+
+		sched_lock();
+		eventfd_semgive(&dev->exclsem);
+		ret = eventfd_semtake(&dev->rdsem);
+		sched_unlock();
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = eventfd_semtake(&dev->exclsem);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if ((dev->flags & EFD_SEMAPHORE) != 0) {
+		value = 1;
+	} else {
+		value = dev->counter;
+	}
+
+	dev->counter -= value;
+	memcpy(buffer, &value, sizeof(eventfd_t));
+
+	eventfd_wake(&dev->wrsem);
+	eventfd_pollnotify(dev, POLLOUT);
+	eventfd_semgive(&dev->exclsem);
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_filewrite
+ *
+ * Description:
+ *   Add a value to the counter.  Waits while the counter would overflow
+ *   unless the file is non-blocking.
+ *
+ ****************************************************************************/
+
+static ssize_t eventfd_filewrite(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	FAR struct eventfd_s *dev = (FAR struct eventfd_s *)filep->f_priv;
+	eventfd_t value;
+	int ret;
+
+	if (dev == NULL) {
+		return -EBADF;
+	}
+
+	if (buflen < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	memcpy(&value, buffer, sizeof(eventfd_t));
+	if (value > EVENTFD_MAX) {
+		return -EINVAL;
+	}
+
+	ret = eventfd_semtake(&dev->exclsem);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (value > EVENTFD_MAX - dev->counter) {
+		if ((filep->f_oflags & O_NONBLOCK) != 0) {
+			eventfd_semgive(&dev->exclsem);
+			return -EAGAIN;
+		}
+
+		sched_lock();
+		eventfd_semgive(&dev->exclsem);
+		ret = eventfd_semtake(&dev->wrsem);
+		sched_unlock();
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = eventfd_semtake(&dev->exclsem);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	dev->counter += value;
+	if (dev->counter > 0) {
+		eventfd_wake(&dev->rdsem);
+		eventfd_pollnotify(dev, POLLIN);
+	}
+
+	eventfd_semgive(&dev->exclsem);
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_poll
+ ****************************************************************************/
+
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct eventfd_s *dev = (FAR struct eventfd_s *)filep->f_priv;
+	FAR struct pollfd **slot;
+	pollevent_t eventset;
+	int ret;
+	int i;
+
+	if (dev == NULL) {
+		return -EBADF;
+	}
+
+	ret = eventfd_semtake(&dev->exclsem);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (setup) {
+		for (i = 0; i < CONFIG_EVENTFD_NPOLLWAITERS; i++) {
+			if (dev->fds[i] == NULL) {
+				dev->fds[i] = fds;
+				fds->priv = &dev->fds[i];
+				break;
+			}
+		}
+
+		if (i >= CONFIG_EVENTFD_NPOLLWAITERS) {
+			fds->priv = NULL;
+			ret = -EBUSY;
+			goto errout;
+		}
+
+		/* Report the events that are already true */
+
+		eventset = 0;
+		if (dev->counter < EVENTFD_MAX) {
+			eventset |= POLLOUT;
+		}
+
+		if (dev->counter > 0) {
+			eventset |= POLLIN;
+		}
+
+		if (eventset != 0) {
+			eventfd_pollnotify(dev, eventset);
+		}
+	} else {
+		slot = (FAR struct pollfd **)fds->priv;
+		if (slot != NULL) {
+			*slot = NULL;
+			fds->priv = NULL;
+		}
+	}
+
+errout:
+	eventfd_semgive(&dev->exclsem);
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create an eventfd with the counter set to 'initval' and return its file
+ *   descriptor.
+ *
+ ****************************************************************************/
+
+int eventfd(unsigned int initval, int flags)
+{
+	FAR struct eventfd_s *dev;
+	FAR struct file *filep;
+	int oflags;
+	int err;
+	int fd;
+
+	if ((flags & ~(EFD_NONBLOCK | EFD_CLOEXEC | EFD_SEMAPHORE)) != 0) {
+		err = EINVAL;
+		goto errout;
+	}
+
+	dev = (FAR struct eventfd_s *)kmm_zalloc(sizeof(struct eventfd_s));
+	if (dev == NULL) {
+		err = ENOMEM;
+		goto errout;
+	}
+
+	dev->counter = initval;
+	dev->flags = flags & EFD_SEMAPHORE;
+	dev->crefs = 1;
+	sem_init(&dev->exclsem, 0, 1);
+
+	/*
+	 * These semaphores are used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+	sem_init(&dev->rdsem, 0, 0);
+	sem_setprotocol(&dev->rdsem, SEM_PRIO_NONE);
+	sem_init(&dev->wrsem, 0, 0);
+	sem_setprotocol(&dev->wrsem, SEM_PRIO_NONE);
+
+	inode_addref(&g_eventfd_inode);
+
+	oflags = O_RDWR;
+	if ((flags & EFD_NONBLOCK) != 0) {
+		oflags |= O_NONBLOCK;
+	}
+
+	fd = files_allocate(&g_eventfd_inode, oflags, 0, 0);
+	if (fd < 0) {
+		err = EMFILE;
+		goto errout_with_inode;
+	}
+
+	filep = fs_getfilep(fd);
+	DEBUGASSERT(filep != NULL);
+	filep->f_priv = dev;
+	return fd;
+
+errout_with_inode:
+	inode_release(&g_eventfd_inode);
+	sem_destroy(&dev->wrsem);
+	sem_destroy(&dev->rdsem);
+	sem_destroy(&dev->exclsem);
+	kmm_free(dev);
+
+errout:
+	set_errno(err);
+	return ERROR;
+}
+
+#endif							/* CONFIG_EVENTFD */
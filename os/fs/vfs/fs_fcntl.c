@@ -62,6 +62,7 @@
 #include <assert.h>
 
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 #include <tinyara/net/net.h>
 #include <tinyara/sched.h>
 #include <tinyara/cancelpt.h>
@@ -218,6 +219,28 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
 		err = ENOSYS;			/* Not implemented */
 		break;
 
+	case F_SETPIPE_SZ:
+	case F_GETPIPE_SZ:
+		/* Set the size of the buffer of a pipe or FIFO to the third argument,
+		 * taken as an integer, or get it.  The new or current size is
+		 * returned.  Passed to the driver, which knows whether it is a pipe.
+		 */
+
+		if (INODE_IS_DRIVER(filep->f_inode) && filep->f_inode->u.i_ops->ioctl) {
+			if (cmd == F_SETPIPE_SZ) {
+				ret = filep->f_inode->u.i_ops->ioctl(filep, PIPEIOC_SETSIZE, (unsigned long)va_arg(ap, int));
+			} else {
+				ret = filep->f_inode->u.i_ops->ioctl(filep, PIPEIOC_GETSIZE, 0);
+			}
+		} else {
+			ret = -ENOTTY;
+		}
+
+		if (ret < 0) {
+			err = ret == -ENOTTY ? EBADF : -ret;
+		}
+		break;
+
 	default:
 		err = EINVAL;
 		break;
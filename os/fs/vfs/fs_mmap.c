@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_mmap.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap
+ *
+ * Description:
+ *   Return the address of the data of a file whose file system keeps it in
+ *   directly addressable memory, such as ROMFS on an XIP-capable MTD
+ *   device or a RAM disk.  Nothing is copied and no memory is allocated.
+ *   Only read-only shared or private mappings chosen by the system are
+ *   supported; munmap() has nothing to release.
+ *
+ * Parameters:
+ *   start  - Ignored unless MAP_FIXED is given, which is not supported
+ *   length - The length of the mapping
+ *   prot   - PROT_READ and/or PROT_EXEC
+ *   flags  - MAP_SHARED or MAP_PRIVATE
+ *   fd     - The open file to map
+ *   offset - The offset of the mapping in the file
+ *
+ * Returned Value:
+ *   The address of the mapping, or MAP_FAILED with errno set to:
+ *
+ *     EBADF:  'fd' is not a valid descriptor
+ *     EINVAL: 'length' is zero or 'offset' is negative
+ *     ENOSYS: Writable, fixed or anonymous mappings were requested
+ *     ENODEV: The file system does not keep the file in memory
+ *
+ ****************************************************************************/
+
+FAR void *mmap(FAR void *start, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	FAR struct file *filep;
+	FAR struct inode *inode;
+	FAR uint8_t *base = NULL;
+	int errcode;
+
+	if (length == 0 || offset < 0) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	if ((prot & PROT_WRITE) != 0 || (flags & (MAP_FIXED | MAP_ANONYMOUS)) != 0) {
+		fdbg("ERROR: unsupported mapping prot=%x flags=%x\n", prot, flags);
+		errcode = ENOSYS;
+		goto errout;
+	}
+
+	filep = fs_getfilep(fd);
+	if (filep == NULL) {
+		/* The errno value has already been set */
+
+		return MAP_FAILED;
+	}
+
+	inode = filep->f_inode;
+	if (inode == NULL || inode->u.i_ops == NULL || inode->u.i_ops->ioctl == NULL) {
+		errcode = ENODEV;
+		goto errout;
+	}
+
+	if (inode->u.i_ops->ioctl(filep, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) < 0 || base == NULL) {
+		errcode = ENODEV;
+		goto errout;
+	}
+
+	return base + offset;
+
+errout:
+	set_errno(errcode);
+	return MAP_FAILED;
+}
+
+#endif							/* CONFIG_NFILE_DESCRIPTORS > 0 */
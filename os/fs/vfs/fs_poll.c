@@ -112,7 +112,7 @@ static int poll_semtake(FAR sem_t *sem)
 }
 
 /****************************************************************************
- * Name: poll_fdsetup
+ * Name: fdesc_poll
  *
  * Description:
  *   Configure (or unconfigure) one file/socket descriptor for the poll
@@ -122,7 +122,7 @@ static int poll_semtake(FAR sem_t *sem)
  ****************************************************************************/
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
-static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 {
 	FAR struct file *filep;
 	FAR struct inode *inode;
@@ -194,6 +194,9 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
 		fds[i].sem = sem;
 		fds[i].revents = 0;
 		fds[i].priv = NULL;
+#ifdef CONFIG_EPOLL
+		fds[i].notify = NULL;
+#endif
 
 		/* Check for invalid descriptors. "If the value of fd is less than 0,
 		 * events shall be ignored, and revents shall be set to 0 in that entry
@@ -207,7 +210,7 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
 		if (fds[i].fd >= 0) {
 			/* Set up the poll on this valid file descriptor */
 
-			ret = poll_fdsetup(fds[i].fd, &fds[i], true);
+			ret = fdesc_poll(fds[i].fd, &fds[i], true);
 			if (ret < 0) {
 				/* Setup failed for fds[i]. We now need to teardown previously
 				 * setup fds[0 .. (i - 1)] to release allocated resources and
@@ -216,7 +219,7 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
 				 */
 
 				for (j = 0; j < i; j++) {
-					(void)poll_fdsetup(fds[j].fd, &fds[j], false);
+					(void)fdesc_poll(fds[j].fd, &fds[j], false);
 				}
 
 				/* Indicate an error on the file descriptor */
@@ -255,7 +258,7 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds, int *count,
 		if (fds[i].fd >= 0) {
 			/* Teardown the poll */
 
-			status = poll_fdsetup(fds[i].fd, &fds[i], false);
+			status = fdesc_poll(fds[i].fd, &fds[i], false);
 			if (status < 0) {
 				ret = status;
 			}
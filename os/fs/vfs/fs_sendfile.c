@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_sendfile.c
+ *
+ * sendfile() from a file that the file system maps in memory, such as a
+ * file of a ROMFS image in execute-in-place flash, to a TCP socket: the
+ * segments queued on the socket refer to the file in place, so the data
+ * is neither read into a buffer nor copied into the pbufs.  Other
+ * transfers use the read()/write() loop of lib_sendfile().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#include <net/lwip/sockets.h>
+
+#ifdef CONFIG_NET_SENDFILE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_mmap
+ *
+ * Description:
+ *   Return the address of the data of the open file 'filep' in memory, or
+ *   NULL if the file system does not map it.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *sendfile_mmap(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR void *base = NULL;
+
+	if (inode == NULL || inode->u.i_ops == NULL || inode->u.i_ops->ioctl == NULL) {
+		return NULL;
+	}
+
+	if (inode->u.i_ops->ioctl(filep, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) < 0) {
+		return NULL;
+	}
+
+	return (FAR const uint8_t *)base;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile
+ *
+ * Description:
+ *   See include/sys/sendfile.h.  The data of a memory-mapped file is passed
+ *   to lwip_send_ref(): it must not change until the peer acknowledged it,
+ *   which holds for read-only media such as ROMFS.
+ *
+ ****************************************************************************/
+
+ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	FAR struct file *filep;
+	FAR const uint8_t *base;
+	off_t savepos;
+	off_t pos;
+	off_t size;
+	ssize_t ntransferred;
+	int ret;
+
+	/* Only a file to a socket can avoid the copy */
+
+	if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS || (unsigned int)infd >= CONFIG_NFILE_DESCRIPTORS) {
+		return lib_sendfile(outfd, infd, offset, count);
+	}
+
+	filep = fs_getfilep(infd);
+	if (filep == NULL) {
+		return ERROR;
+	}
+
+	base = sendfile_mmap(filep);
+	if (base == NULL) {
+		return lib_sendfile(outfd, infd, offset, count);
+	}
+
+	/* Find the part of the file to send.  The file position is left
+	 * unchanged if 'offset' is given, moved past the data sent otherwise.
+	 */
+
+	savepos = filep->f_pos;
+	pos = offset ? *offset : savepos;
+	size = file_seek(filep, 0, SEEK_END);
+	if (size == (off_t)-1) {
+		return ERROR;
+	}
+
+	if (pos > size) {
+		pos = size;
+	}
+	if (count > (size_t)(size - pos)) {
+		count = size - pos;
+	}
+
+	/* Queue the data in place */
+
+	for (ntransferred = 0; ntransferred < count; ntransferred += ret) {
+		ret = lwip_send_ref(outfd, base + pos + ntransferred, count - ntransferred, 0);
+		if (ret < 0) {
+#ifndef CONFIG_DISABLE_SIGNALS
+			if (get_errno() != EINTR || ntransferred == 0)
+#endif
+			{
+				ntransferred = ERROR;
+			}
+			break;
+		}
+	}
+
+	if (offset == NULL && ntransferred > 0) {
+		savepos = pos + ntransferred;
+	} else if (offset && ntransferred > 0) {
+		*offset = pos + ntransferred;
+	}
+
+	if (file_seek(filep, savepos, SEEK_SET) == (off_t)-1) {
+		return ERROR;
+	}
+
+	return ntransferred;
+}
+
+#endif							/* CONFIG_NET_SENDFILE */
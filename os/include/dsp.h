@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/dsp.h
+ *
+ * Fixed-point signal processing kernels on Q15 and Q31 data: saturating
+ * vector operations, dot products, FIR and biquad IIR filters and a
+ * radix-4 complex FFT.  A Q15 value v stands for v / 2^15 and a Q31 value
+ * for v / 2^31, so both cover [-1, 1).
+ *
+ ****************************************************************************/
+/**
+ * @defgroup DSP_LIBC DSP
+ * @brief Provides fixed-point signal processing kernels
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+#ifndef __INCLUDE_DSP_H
+#define __INCLUDE_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define Q15_MAX                 0x7fff
+#define Q15_MIN                 (-0x7fff - 1)
+#define Q31_MAX                 0x7fffffff
+#define Q31_MIN                 (-0x7fffffff - 1)
+
+/* Conversions from and to float, the float one is saturated */
+
+#define ftoq15(f)               ((q15_t)((f) >= 1.0f ? Q15_MAX : (f) < -1.0f ? Q15_MIN : (f) * 32768.0f))
+#define q15tof(q)               ((float)(q) / 32768.0f)
+#define ftoq31(f)               ((q31_t)((f) >= 1.0f ? Q31_MAX : (f) < -1.0f ? Q31_MIN : (f) * 2147483648.0f))
+#define q31tof(q)               ((float)(q) / 2147483648.0f)
+
+/* Number of q15_t/q31_t a FIR filter needs for its state when it is run
+ * on at most blocksize samples per internal pass
+ */
+
+#define DSP_FIR_STATE_SIZE(ntaps, blocksize) ((ntaps) + (blocksize) - 1)
+
+/* A biquad stage has five coefficients and four state values */
+
+#define DSP_BIQUAD_NCOEFFS      5
+#define DSP_BIQUAD_NSTATE       4
+
+/* Largest supported FFT length */
+
+#define DSP_FFT_MAXSIZE         1024
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+/* FIR filter y[n] = sum(h[k] * x[n - k], k = 0..ntaps - 1).  The
+ * coefficients are stored time reversed: coeffs[i] = h[ntaps - 1 - i].
+ */
+
+struct dsp_fir_q15_s {
+	FAR const q15_t *coeffs;	/* ntaps coefficients, time reversed */
+	FAR q15_t *state;			/* DSP_FIR_STATE_SIZE(ntaps, blocksize) values */
+	uint16_t ntaps;
+	uint16_t blocksize;
+};
+
+struct dsp_fir_q31_s {
+	FAR const q31_t *coeffs;
+	FAR q31_t *state;
+	uint16_t ntaps;
+	uint16_t blocksize;
+};
+
+/* Cascade of direct form I biquads.  Each stage computes
+ *
+ *   y[n] = 2^postshift * (b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2])
+ *
+ * with the coefficients stored as { b0, b1, b2, a1, a2 } per stage.  The
+ * feedback coefficients carry the opposite sign of the usual transfer
+ * function denominator.  Coefficients of magnitude 1 or more are stored
+ * divided by 2^postshift.
+ */
+
+struct dsp_biquad_q15_s {
+	FAR const q15_t *coeffs;	/* DSP_BIQUAD_NCOEFFS per stage */
+	FAR q15_t *state;			/* DSP_BIQUAD_NSTATE per stage */
+	uint8_t nstages;
+	uint8_t postshift;
+};
+
+struct dsp_biquad_q31_s {
+	FAR const q31_t *coeffs;
+	FAR q31_t *state;
+	uint8_t nstages;
+	uint8_t postshift;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/* Vector operations.  Results are saturated and dst may alias a source. */
+
+/**
+ * @brief dst[i] = a[i] + b[i], saturated
+ * @since Tizen RT v2.0
+ */
+void dsp_add_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst, size_t n);
+/**
+ * @brief dst[i] = a[i] + b[i], saturated
+ * @since Tizen RT v2.0
+ */
+void dsp_add_q31(FAR const q31_t *a, FAR const q31_t *b, FAR q31_t *dst, size_t n);
+/**
+ * @brief dst[i] = a[i] - b[i], saturated
+ * @since Tizen RT v2.0
+ */
+void dsp_sub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst, size_t n);
+/**
+ * @brief dst[i] = a[i] - b[i], saturated
+ * @since Tizen RT v2.0
+ */
+void dsp_sub_q31(FAR const q31_t *a, FAR const q31_t *b, FAR q31_t *dst, size_t n);
+/**
+ * @brief dst[i] = src[i] * scale * 2^shift, saturated
+ * @param[in] shift left shift from 0 to 15 applied after the multiply
+ * @since Tizen RT v2.0
+ */
+void dsp_scale_q15(FAR const q15_t *src, q15_t scale, int shift, FAR q15_t *dst, size_t n);
+/**
+ * @brief dst[i] = src[i] * scale * 2^shift, saturated
+ * @param[in] shift left shift from 0 to 31 applied after the multiply
+ * @since Tizen RT v2.0
+ */
+void dsp_scale_q31(FAR const q31_t *src, q31_t scale, int shift, FAR q31_t *dst, size_t n);
+/**
+ * @brief Dot product of two Q15 vectors
+ * @return the exact sum of the products in Q30
+ * @since Tizen RT v2.0
+ */
+int64_t dsp_dot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n);
+/**
+ * @brief Dot product of two Q31 vectors
+ * @return the sum of the products in Q48, each truncated by 14 bits
+ * @since Tizen RT v2.0
+ */
+int64_t dsp_dot_q31(FAR const q31_t *a, FAR const q31_t *b, size_t n);
+
+/* FIR filters */
+
+/**
+ * @brief Initialize a FIR filter and clear its state
+ * @param[in] blocksize samples processed per internal pass, sizing the state
+ * @since Tizen RT v2.0
+ */
+void dsp_fir_q15_init(FAR struct dsp_fir_q15_s *fir, uint16_t ntaps, FAR const q15_t *coeffs, FAR q15_t *state, uint16_t blocksize);
+/**
+ * @brief Filter n samples; the products are accumulated exactly in 64 bits
+ * @since Tizen RT v2.0
+ */
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *src, FAR q15_t *dst, size_t n);
+/**
+ * @brief Initialize a FIR filter and clear its state
+ * @since Tizen RT v2.0
+ */
+void dsp_fir_q31_init(FAR struct dsp_fir_q31_s *fir, uint16_t ntaps, FAR const q31_t *coeffs, FAR q31_t *state, uint16_t blocksize);
+/**
+ * @brief Filter n samples with a Q62 accumulator
+ * @details The accumulator has one guard bit: the absolute coefficients
+ * must sum to less than 2.
+ * @since Tizen RT v2.0
+ */
+void dsp_fir_q31(FAR struct dsp_fir_q31_s *fir, FAR const q31_t *src, FAR q31_t *dst, size_t n);
+
+/* Biquad IIR filters */
+
+/**
+ * @brief Initialize a biquad cascade and clear its state
+ * @since Tizen RT v2.0
+ */
+void dsp_biquad_q15_init(FAR struct dsp_biquad_q15_s *iir, uint8_t nstages, FAR const q15_t *coeffs, FAR q15_t *state, uint8_t postshift);
+/**
+ * @brief Filter n samples through every stage; src and dst may be equal
+ * @since Tizen RT v2.0
+ */
+void dsp_biquad_q15(FAR struct dsp_biquad_q15_s *iir, FAR const q15_t *src, FAR q15_t *dst, size_t n);
+/**
+ * @brief Initialize a biquad cascade and clear its state
+ * @since Tizen RT v2.0
+ */
+void dsp_biquad_q31_init(FAR struct dsp_biquad_q31_s *iir, uint8_t nstages, FAR const q31_t *coeffs, FAR q31_t *state, uint8_t postshift);
+/**
+ * @brief Filter n samples through every stage; src and dst may be equal
+ * @details The accumulator has one guard bit: the absolute coefficients of
+ * a stage, as stored, must sum to less than 2.
+ * @since Tizen RT v2.0
+ */
+void dsp_biquad_q31(FAR struct dsp_biquad_q31_s *iir, FAR const q31_t *src, FAR q31_t *dst, size_t n);
+
+/* FFT */
+
+/**
+ * @brief In-place radix-4 complex FFT
+ * @details buf holds n interleaved { re, im } pairs.  Each of the log4(n)
+ * stages scales by 1/4, so the forward and the inverse transform both
+ * return the result divided by n.  Inputs of magnitude below 1 cannot
+ * overflow; components of larger ones saturate.
+ * @param[in] n 4, 16, 64, 256 or 1024
+ * @param[in] inverse compute the inverse transform
+ * @return 0 on success, -EINVAL if n is not supported
+ * @since Tizen RT v2.0
+ */
+int dsp_cfft_q15(FAR q15_t *buf, size_t n, bool inverse);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __INCLUDE_DSP_H */
+/**
+ * @}
+ */
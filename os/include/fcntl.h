@@ -135,6 +135,8 @@
 #define F_SETLKW    12			/* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13			/* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14			/* Set the signal to be sent */
+#define F_SETPIPE_SZ 15			/* Set the buffer size of a pipe or FIFO (linux) */
+#define F_GETPIPE_SZ 16			/* Get the buffer size of a pipe or FIFO (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -155,6 +157,13 @@
 #define DN_RENAME   4			/* A file was renamed */
 #define DN_ATTRIB   5			/* Attributes of a file were changed */
 
+/* Flags for splice() and tee() */
+
+#define SPLICE_F_MOVE     (1 << 0)	/* Ignored */
+#define SPLICE_F_NONBLOCK (1 << 1)	/* Do not block on the pipe */
+#define SPLICE_F_MORE     (1 << 2)	/* Ignored */
+#define SPLICE_F_GIFT     (1 << 3)	/* Ignored */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -208,6 +217,23 @@ int open(const char *path, int oflag, ...);
  */
 int fcntl(int fd, int cmd, ...);
 
+#ifdef CONFIG_PIPE_SPLICE
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief  Move data between a pipe and another descriptor inside the kernel (Linux)
+ * @details [SYSTEM CALL API]
+ * @since Tizen RT v2.0
+ */
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags);
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief  Copy data from one pipe to another without consuming it (Linux)
+ * @details [SYSTEM CALL API]
+ * @since Tizen RT v2.0
+ */
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
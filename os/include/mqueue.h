@@ -77,6 +77,13 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_flags bit given to mq_open() when a message queue is
+ * created.  A reference queue passes buffers allocated with mq_refalloc()
+ * instead of copying messages; mq_msgsize is the largest such buffer.
+ */
+
+#define MQ_REFERENCE (1 << 15)
+
 /********************************************************************************
  * Global Type Declarations
  ********************************************************************************/
@@ -158,6 +165,30 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio
  */
 int mq_notify(mqd_t mqdes, const struct sigevent *notification);
 
+/**
+ * @brief Allocate a message buffer for a reference message queue
+ * @details [SYSTEM CALL API]
+ *   The buffer is given to mq_send() or mq_timedsend() on a queue created
+ *   with MQ_REFERENCE, which passes it to the receiver without copying.
+ *   mq_receive() then stores a pointer to the buffer in its msg argument and
+ *   returns the length that was sent.  The buffer belongs to the sender until
+ *   it is sent, to the queue while it is queued and to the receiver
+ *   afterwards, which releases it with mq_reffree() or sends it on.
+ * @param[in] size size of the message buffer in bytes
+ * @return On success, the buffer is returned. On failure, NULL is returned.
+ * @since Tizen RT v1.1
+ */
+FAR void *mq_refalloc(size_t size);
+
+/**
+ * @brief Free a message buffer allocated with mq_refalloc()
+ * @details [SYSTEM CALL API]
+ * @param[in] buffer the buffer, which must not be queued
+ * @return None
+ * @since Tizen RT v1.1
+ */
+void mq_reffree(FAR void *buffer);
+
 /**
  * @brief  POSIX APIs (refer to : http://pubs.opengroup.org/onlinepubs/9699919799/)
  * @since Tizen RT v1.0
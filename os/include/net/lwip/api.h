@@ -147,6 +147,14 @@ struct api_msg_msg;
 typedef void (*netconn_callback)(struct netconn *, enum netconn_evt, u16_t len);
 
 /** A netconn descriptor */
+/** A buffer to be sent as part of a gathered netconn write */
+struct netvector {
+	/** pointer to the application buffer that contains the data to send */
+	const void *ptr;
+	/** size of the application data to send */
+	size_t len;
+};
+
 struct netconn {
 	/** type of the netconn (TCP, UDP or RAW) */
 	enum netconn_type type;
@@ -197,6 +205,11 @@ struct netconn {
 	    for UDP and RAW, used for FIONREAD */
 	s16_t recv_avail;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_SO_SNDBUF
+	/** maximum amount of bytes queued for sending on a TCP netconn,
+	    at most TCP_SND_BUF */
+	int send_bufsize;
+#endif							/* LWIP_SO_SNDBUF */
 	/** flags holding more netconn-internal state, see NETCONN_FLAG_* defines */
 	u8_t flags;
 #if LWIP_TCP
@@ -254,6 +267,7 @@ void netconn_recved(struct netconn *conn, u32_t length);
 err_t netconn_sendto(struct netconn *conn, struct netbuf *buf, ip_addr_t *addr, u16_t port);
 err_t netconn_send(struct netconn *conn, struct netbuf *buf);
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
+err_t netconn_write_vectors_partly(struct netconn *conn, const struct netvector *vectors, u16_t vectorcnt, u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
 	netconn_write_partly(conn, dataptr, size, apiflags, NULL)
 err_t netconn_close(struct netconn *conn);
@@ -308,6 +322,12 @@ err_t netconn_join_leave_group(struct netconn *conn, ip_addr_t *multiaddr, ip_ad
 /** Get the receive buffer in bytes */
 #define netconn_get_recvbufsize(conn)               ((conn)->recv_bufsize)
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_SO_SNDBUF
+/** Set the send buffer in bytes */
+#define netconn_set_sendbufsize(conn, sendbufsize)  ((conn)->send_bufsize = (sendbufsize))
+/** Get the send buffer in bytes */
+#define netconn_get_sendbufsize(conn)               ((conn)->send_bufsize)
+#endif							/* LWIP_SO_SNDBUF */
 
 #ifdef __cplusplus
 }
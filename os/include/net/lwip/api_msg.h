@@ -103,7 +103,13 @@ struct api_msg_msg {
 		} ad;
 		/** used for do_write */
 		struct {
-			const void *dataptr;
+			/** current buffer to write */
+			const struct netvector *vector;
+			/** number of buffers left to write, including the current one */
+			u16_t vector_cnt;
+			/** offset in the current buffer */
+			size_t vector_off;
+			/** total length of all the buffers */
 			size_t len;
 			u8_t apiflags;
 #if LWIP_SO_SNDTIMEO
@@ -162,6 +168,9 @@ void do_join_leave_group(struct api_msg_msg *msg);
 
 struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback);
 void netconn_free(struct netconn *conn);
+#if LWIP_TCP
+struct netconn *netconn_tcp_owner(struct tcp_pcb *pcb);
+#endif							/* LWIP_TCP */
 
 #ifdef __cplusplus
 }
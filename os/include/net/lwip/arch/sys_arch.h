@@ -39,17 +39,20 @@ typedef pid_t sys_thread_t;
 
 // === MAIL BOX ===
 
+/* Lock-free ring of messages, see sys_arch.c */
+
 struct sys_mbox {
 	u8_t is_valid;
 	u8_t id;
-	u32_t queue_size;
-	u32_t wait_send;
-	u32_t wait_fetch;
-	u32_t front;
-	u32_t rear;
+	u32_t mask;					/* Number of slots - 1, a power of 2 - 1 */
+	u32_t head;					/* Next position to post */
+	u32_t tail;					/* Next position to fetch */
+	u32_t wait_send;			/* Posters sleeping on 'space' */
+	u32_t wait_fetch;			/* Fetchers sleeping on 'mail' */
+	u16_t seq[SYS_MBOX_MAXSIZE];
 	void *msgs[SYS_MBOX_MAXSIZE];
 	sys_sem_t mail;
-	sys_sem_t mutex;
+	sys_sem_t space;
 };
 
 typedef struct sys_mbox sys_mbox_t;
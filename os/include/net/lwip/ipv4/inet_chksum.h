@@ -94,6 +94,11 @@ u16_t inet_chksum_pseudo_partial(struct pbuf *p, ip_addr_t *src, ip_addr_t *dest
 #if LWIP_CHKSUM_COPY_ALGORITHM
 u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len);
 #endif							/* LWIP_CHKSUM_COPY_ALGORITHM */
+#ifdef CONFIG_ARMV7R_INET_CHKSUM
+/* arch/arm/src/armv7-r/arm_chksum.S */
+u16_t arm_chksum(const void *dataptr, int len);
+u16_t arm_chksum_copy(void *dst, const void *src, u16_t len);
+#endif							/* CONFIG_ARMV7R_INET_CHKSUM */
 
 #ifdef __cplusplus
 }
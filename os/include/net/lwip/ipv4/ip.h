@@ -122,10 +122,10 @@ struct ip_pcb {
 /* #define SOF_USELOOPBACK 0x0040       Unimplemented: bypass hardware when possible */
 #define SOF_LINGER        _SO_BIT(5)	/* linger on close if data present */
 /* #define SOF_OOBINLINE   _SO_BIT(6)   Unimplemented: leave received OOB data in line */
-/* #define SOF_REUSEPORT   0x0200       Unimplemented: allow local address & port reuse */
+#define SOF_REUSEPORT     0x0200		/* allow local address & port reuse by TCP listeners (SO_REUSEPORT) */
 
 /* These flags are inherited (e.g. from a listen-pcb to a connection-pcb): */
-#define SOF_INHERITED   (SOF_REUSEADDR|SOF_KEEPALIVE|SOF_LINGER/* |SOF_DEBUG|SOF_DONTROUTE|SOF_OOBINLINE */)
+#define SOF_INHERITED   (SOF_REUSEADDR|SOF_REUSEPORT|SOF_KEEPALIVE|SOF_LINGER/* |SOF_DEBUG|SOF_DONTROUTE|SOF_OOBINLINE */)
 
 #ifdef PACK_STRUCT_USE_INCLUDES
 #include <net/lwip/arch/bpstruct.h>
@@ -70,9 +70,12 @@ extern "C" {
  */
 struct ip_reassdata {
 	struct ip_reassdata *next;
-	struct pbuf *p;
+	struct pbuf *p;				/* fragments, sorted by offset */
+	struct pbuf *p_last;		/* fragment with the highest offset */
 	struct ip_hdr iphdr;
 	u16_t datagram_len;
+	u16_t recv_len;				/* payload bytes received so far */
+	u16_t pbufs;				/* pbufs enqueued for this datagram */
 	u8_t flags;
 	u8_t timer;
 };
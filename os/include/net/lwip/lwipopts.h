@@ -82,6 +82,14 @@
 #endif
 #endif
 
+#ifdef CONFIG_NET_ARP_HASHSIZE
+#define ETHARP_HASH_SIZE                CONFIG_NET_ARP_HASHSIZE
+#endif
+
+#ifdef CONFIG_NET_ARP_PROACTIVE_REFRESH
+#define ETHARP_PROACTIVE_REFRESH        CONFIG_NET_ARP_PROACTIVE_REFRESH
+#endif
+
 #ifdef CONFIG_NET_ARP_QUEUEING
 #define ARP_QUEUEING                    CONFIG_NET_ARP_QUEUEING
 #endif
@@ -136,6 +144,10 @@
 #define IP_REASS_MAX_PBUFS	           CONFIG_NET_IPV4_REASS_MAX_PBUFS
 #endif
 
+#ifdef CONFIG_NET_IPV4_REASS_MAX_PBUFS_PER_SRC
+#define IP_REASS_MAX_PBUFS_PER_SRC     CONFIG_NET_IPV4_REASS_MAX_PBUFS_PER_SRC
+#endif
+
 #ifdef CONFIG_NET_IPV4_REASS_MAXAGE
 #define IP_REASS_MAXAGE	               CONFIG_NET_IPV4_REASS_MAXAGE
 #endif
@@ -239,6 +251,22 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_WND_SCALE
+#define LWIP_WND_SCALE	CONFIG_NET_TCP_WND_SCALE
+#endif
+
+#ifdef CONFIG_NET_TCP_RCV_SCALE
+#define TCP_RCV_SCALE	CONFIG_NET_TCP_RCV_SCALE
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	CONFIG_NET_TCP_SACK
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+#define LWIP_TCP_RACK	CONFIG_NET_TCP_RACK
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -428,6 +456,15 @@
 #define PBUF_POOL_SIZE	CONFIG_NET_PBUF_POOL_SIZE
 #endif
 
+#ifdef CONFIG_NET_PBUF_POOL_CLASSES
+#define LWIP_PBUF_POOL_CLASSES	1
+#define PBUF_POOL_SMALL_SIZE	CONFIG_NET_PBUF_POOL_SMALL_SIZE
+#define PBUF_POOL_SMALL_BUFSIZE	CONFIG_NET_PBUF_POOL_SMALL_BUFSIZE
+#define PBUF_POOL_MEDIUM_SIZE	CONFIG_NET_PBUF_POOL_MEDIUM_SIZE
+#define PBUF_POOL_MEDIUM_BUFSIZE	CONFIG_NET_PBUF_POOL_MEDIUM_BUFSIZE
+#define PBUF_POOL_ALIGNMENT	CONFIG_NET_PBUF_POOL_ALIGNMENT
+#endif
+
 /*---------- Interanl Memory Pool Sizes ----*/
 
 
@@ -490,6 +527,22 @@
 #define LWIP_SO_RCVBUF	CONFIG_NET_SO_RCVBUF
 #endif
 
+#ifdef CONFIG_NET_SO_SNDBUF
+#define LWIP_SO_SNDBUF	CONFIG_NET_SO_SNDBUF
+#endif
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY	CONFIG_NET_SOCKET_ZEROCOPY
+#endif
+
+#ifdef CONFIG_NET_SOCKET_SENDMSG
+#define LWIP_SOCKET_SENDMSG	CONFIG_NET_SOCKET_SENDMSG
+#endif
+
+#ifdef CONFIG_NET_SOCKET_MMSG
+#define LWIP_SOCKET_MMSG	CONFIG_NET_SOCKET_MMSG
+#endif
+
 #ifdef CONFIG_NET_SO_REUSE
 #define SO_REUSE	CONFIG_NET_SO_REUSE
 #endif
@@ -585,12 +638,18 @@
 #define NO_SYS 0
 #define LWIP_RAND() rand()
 
+#ifdef CONFIG_ARMV7R_INET_CHKSUM
+#define LWIP_CHKSUM	arm_chksum
+#define LWIP_CHKSUM_COPY(dst, src, len)	arm_chksum_copy(dst, src, len)
+#define LWIP_CHECKSUM_ON_COPY	1
+#endif
+
 #ifdef CONFIG_NET_TCPIP_CORE_LOCKING
-#define TCPIP_CORE_LOCKING	CONFIG_NET_TCPIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING	CONFIG_NET_TCPIP_CORE_LOCKING
 #endif
 
 #ifdef CONFIG_NET_TCPIP_CORE_LOCKING_INPUT
-#define TCPIP_CORE_LOCKING_INPUT	CONFIG_NET_TCPIP_CORE_LOCKING_INPUT
+#define LWIP_TCPIP_CORE_LOCKING_INPUT	CONFIG_NET_TCPIP_CORE_LOCKING_INPUT
 #endif
 
 #ifdef CONFIG_NET_TCPIP_THREAD_NAME
@@ -895,5 +954,9 @@
 #define LWIP_HAVE_LOOPIF                CONFIG_NET_LWIP_LOOPBACK_INTERFACE
 #endif
 
+#ifdef CONFIG_NET_LWIP_NETIF_TX_BATCH
+#define LWIP_NETIF_TX_BATCH             CONFIG_NET_LWIP_NETIF_TX_BATCH
+#endif
+
 
 #endif							/* __LWIP_LWIPOPTS_H__ */
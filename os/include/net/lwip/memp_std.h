@@ -102,6 +102,11 @@ LWIP_MEMPOOL(PPPOE_IF, MEMP_NUM_PPPOE_INTERFACES, sizeof(struct pppoe_softc), "P
  */
 LWIP_PBUF_MEMPOOL(PBUF, MEMP_NUM_PBUF, 0, "PBUF_REF/ROM")
 LWIP_PBUF_MEMPOOL(PBUF_POOL, PBUF_POOL_SIZE, PBUF_POOL_BUFSIZE, "PBUF_POOL")
+#if LWIP_PBUF_POOL_CLASSES
+/* The buffer is aligned to PBUF_POOL_ALIGNMENT within the element */
+LWIP_PBUF_MEMPOOL(PBUF_POOL_SMALL, PBUF_POOL_SMALL_SIZE, PBUF_POOL_ALIGNMENT + PBUF_POOL_SMALL_BUFSIZE, "PBUF_POOL_SMALL")
+LWIP_PBUF_MEMPOOL(PBUF_POOL_MEDIUM, PBUF_POOL_MEDIUM_SIZE, PBUF_POOL_ALIGNMENT + PBUF_POOL_MEDIUM_BUFSIZE, "PBUF_POOL_MEDIUM")
+#endif
 
 /*
  * Allow for user-defined pools; this must be explicitly set in lwipopts.h
@@ -181,6 +181,16 @@ typedef err_t (*netif_output_fn)(struct netif *netif, struct pbuf *p, ip_addr_t
  * @param p The packet to send (raw ethernet packet)
  */
 typedef err_t (*netif_linkoutput_fn)(struct netif *netif, struct pbuf *p);
+#if LWIP_NETIF_TX_BATCH
+/** Function prototype for netif->tx_batch functions. Called with start != 0
+ * before several packets are passed to linkoutput in a row, and with
+ * start == 0 after the last one.
+ *
+ * @param netif The netif which sends the packets
+ * @param start Whether the batch starts or ends
+ */
+typedef void (*netif_tx_batch_fn)(struct netif *netif, u8_t start);
+#endif							/* LWIP_NETIF_TX_BATCH */
 /** Function prototype for netif status- or link-callback functions. */
 typedef void (*netif_status_callback_fn)(struct netif *netif);
 /** Function prototype for netif igmp_mac_filter functions */
@@ -220,6 +230,11 @@ struct netif {
 	 *  to send a packet on the interface. This function outputs
 	 *  the pbuf as-is on the link medium. */
 	netif_linkoutput_fn linkoutput;
+#if LWIP_NETIF_TX_BATCH
+	/** This function is called by TCP around the segments that it sends
+	 *  in one pass, may be NULL. */
+	netif_tx_batch_fn tx_batch;
+#endif							/* LWIP_NETIF_TX_BATCH */
 #if LWIP_NETIF_STATUS_CALLBACK
 	/** This function is called when the netif state is set to up or down
 	 */
@@ -430,6 +430,27 @@
 #define PBUF_POOL_SIZE                  16
 #endif
 
+/**
+ * LWIP_PBUF_POOL_CLASSES==1: allocate PBUF_POOL pbufs from a small and a
+ * medium pool when the requested length fits, the pbuf pool holding the
+ * larger ones.
+ */
+#ifndef LWIP_PBUF_POOL_CLASSES
+#define LWIP_PBUF_POOL_CLASSES          0
+#endif
+
+/**
+ * PBUF_POOL_SMALL_SIZE, PBUF_POOL_MEDIUM_SIZE: the number of buffers in the
+ * small and the medium pbuf pools.
+ */
+#ifndef PBUF_POOL_SMALL_SIZE
+#define PBUF_POOL_SMALL_SIZE            16
+#endif
+
+#ifndef PBUF_POOL_MEDIUM_SIZE
+#define PBUF_POOL_MEDIUM_SIZE           8
+#endif
+
 /*
    ---------------------------------
    ---------- ARP options ----------
@@ -449,6 +470,23 @@
 #define ARP_TABLE_SIZE                  10
 #endif
 
+/**
+ * ETHARP_HASH_SIZE: Number of hash chains used to look up ARP table entries
+ * by IP address. Must be a power of two.
+ */
+#ifndef ETHARP_HASH_SIZE
+#define ETHARP_HASH_SIZE                8
+#endif
+
+/**
+ * ETHARP_PROACTIVE_REFRESH==1: The ARP timer re-requests entries that were
+ * used since their last update shortly before they expire, instead of waiting
+ * for a packet to be sent to them during the re-request window.
+ */
+#ifndef ETHARP_PROACTIVE_REFRESH
+#define ETHARP_PROACTIVE_REFRESH        0
+#endif
+
 /**
  * ARP_QUEUEING==1: Multiple outgoing packets are queued during hardware address
  * resolution. By default, only the most recent packet is queued per IP address.
@@ -569,6 +607,15 @@
 #define IP_REASS_MAX_PBUFS              10
 #endif
 
+/**
+ * IP_REASS_MAX_PBUFS_PER_SRC: Maximum amount of pbufs waiting to be reassembled
+ * for datagrams from one source address, so that a single peer sending large
+ * or incomplete fragmented datagrams cannot use up the whole reassembly buffer.
+ */
+#ifndef IP_REASS_MAX_PBUFS_PER_SRC
+#define IP_REASS_MAX_PBUFS_PER_SRC      IP_REASS_MAX_PBUFS
+#endif
+
 /**
  * IP_FRAG_USES_STATIC_BUF==1: Use a static MTU-sized buffer for IP
  * fragmentation. Otherwise pbufs are allocated and reference the original
@@ -1023,6 +1070,43 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_WND_SCALE==1: support the TCP window scale option (RFC 7323).
+ * The window variables become 32 bits wide and TCP_WND may exceed 64 KB,
+ * up to 0xffff << TCP_RCV_SCALE.
+ */
+#ifndef LWIP_WND_SCALE
+#define LWIP_WND_SCALE                  0
+#endif
+
+/**
+ * TCP_RCV_SCALE: the shift count advertised in the window scale option
+ * (0..14). 0 still lets the peer use a large send window.
+ */
+#ifndef TCP_RCV_SCALE
+#define TCP_RCV_SCALE                   0
+#endif
+
+/**
+ * LWIP_TCP_SACK==1: support selective acknowledgements (RFC 2018).
+ * Data held on the ooseq queue is reported in SACK blocks on pure ACKs,
+ * and SACK blocks from the peer mark sent segments as delivered.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_RACK==1: time based loss detection (RACK, RFC 8985) on top of
+ * SACK. A segment is retransmitted once a segment sent after it has been
+ * delivered and it has been outstanding for longer than that segment's
+ * RTT plus a quarter of the minimum RTT, without waiting for three
+ * duplicate ACKs or the retransmission timeout.
+ */
+#ifndef LWIP_TCP_RACK
+#define LWIP_TCP_RACK                   0
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -1066,6 +1150,27 @@
 #define PBUF_POOL_BUFSIZE               LWIP_MEM_ALIGN_SIZE(TCP_MSS+40+PBUF_LINK_HLEN)
 #endif
 
+/**
+ * PBUF_POOL_SMALL_BUFSIZE, PBUF_POOL_MEDIUM_BUFSIZE: the size of each pbuf
+ * in the small and the medium pbuf pools (LWIP_PBUF_POOL_CLASSES).
+ */
+#ifndef PBUF_POOL_SMALL_BUFSIZE
+#define PBUF_POOL_SMALL_BUFSIZE         128
+#endif
+
+#ifndef PBUF_POOL_MEDIUM_BUFSIZE
+#define PBUF_POOL_MEDIUM_BUFSIZE        512
+#endif
+
+/**
+ * PBUF_POOL_ALIGNMENT: alignment of the buffer of the small and medium
+ * pbufs, normally the data cache line size. Must be a power of 2 and a
+ * multiple of MEM_ALIGNMENT.
+ */
+#ifndef PBUF_POOL_ALIGNMENT
+#define PBUF_POOL_ALIGNMENT             MEM_ALIGNMENT
+#endif
+
 /*
    ------------------------------------------------
    ---------- Network Interfaces options ----------
@@ -1110,6 +1215,15 @@
 #define LWIP_NETIF_REMOVE_CALLBACK      0
 #endif
 
+/**
+ * LWIP_NETIF_TX_BATCH==1: Support a netif->tx_batch function that tcp_output()
+ * calls around the segments it sends in one pass, so that the driver can
+ * notify the hardware once for all of them.
+ */
+#ifndef LWIP_NETIF_TX_BATCH
+#define LWIP_NETIF_TX_BATCH             0
+#endif
+
 /**
  * LWIP_NETIF_HWADDRHINT==1: Cache link-layer-address hints (e.g. table
  * indices) in struct netif. TCP and UDP can make use of this to prevent
@@ -1455,6 +1569,37 @@
 #define LWIP_SO_RCVBUF                  0
 #endif
 
+/**
+ * LWIP_SO_SNDBUF==1: Enable SO_SNDBUF processing.  It limits the bytes a
+ * TCP netconn queues for sending to less than TCP_SND_BUF.
+ */
+#ifndef LWIP_SO_SNDBUF
+#define LWIP_SO_SNDBUF                  0
+#endif
+
+/**
+ * LWIP_SOCKET_ZEROCOPY==1: Enable lwip_recvfrom_pbuf(), lwip_pbuf_release()
+ * and lwip_send_ref().
+ */
+#ifndef LWIP_SOCKET_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY            0
+#endif
+
+/**
+ * LWIP_SOCKET_SENDMSG==1: Enable lwip_sendmsg().
+ */
+#ifndef LWIP_SOCKET_SENDMSG
+#define LWIP_SOCKET_SENDMSG             0
+#endif
+
+/**
+ * LWIP_SOCKET_MMSG==1: Enable lwip_recvmmsg() and lwip_sendmmsg().
+ * Requires LWIP_SOCKET_SENDMSG.
+ */
+#ifndef LWIP_SOCKET_MMSG
+#define LWIP_SOCKET_MMSG                0
+#endif
+
 /**
  * If LWIP_SO_RCVBUF is used, this is the default value for recv_bufsize.
  */
@@ -1462,6 +1607,13 @@
 #define RECV_BUFSIZE_DEFAULT            INT_MAX
 #endif
 
+/**
+ * If LWIP_SO_SNDBUF is used, this is the default value for send_bufsize.
+ */
+#ifndef SEND_BUFSIZE_DEFAULT
+#define SEND_BUFSIZE_DEFAULT            TCP_SND_BUF
+#endif
+
 /**
  * SO_REUSE==1: Enable SO_REUSEADDR option.
  */
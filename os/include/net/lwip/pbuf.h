@@ -91,6 +91,10 @@ typedef enum {
 #define PBUF_FLAG_LLMCAST   0x10U
 /** indicates this pbuf includes a TCP FIN flag */
 #define PBUF_FLAG_TCP_FIN   0x20U
+/** indicates this PBUF_POOL pbuf comes from the small pbuf pool */
+#define PBUF_FLAG_POOL_SMALL  0x40U
+/** indicates this PBUF_POOL pbuf comes from the medium pbuf pool */
+#define PBUF_FLAG_POOL_MEDIUM 0x80U
 
 struct pbuf {
 	/** next pbuf in singly linked pbuf chain */
@@ -75,7 +75,6 @@ extern "C" {
  * Option flags per-socket. These must match the SOF_ flags in ip.h (checked in init.c)
  */
 #define  SO_USELOOPBACK 0x0040	/* Unimplemented: bypass hardware when possible */
-#define  SO_REUSEPORT   0x0200	/* Unimplemented: allow local address & port reuse */
 
 #define SO_DONTLINGER   ((int)(~SO_LINGER))
 
@@ -232,8 +231,22 @@ int lwip_listen(int s, int backlog);
 int lwip_recv(int s, void *mem, size_t len, int flags);
 int lwip_read(int s, void *mem, size_t len);
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen);
+#if LWIP_SOCKET_ZEROCOPY
+struct pbuf;
+int lwip_recvfrom_pbuf(int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen);
+void lwip_pbuf_release(struct pbuf *p);
+int lwip_send_ref(int s, const void *dataptr, size_t size, int flags);
+#endif
 int lwip_send(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
+#if LWIP_SOCKET_SENDMSG
+int lwip_sendmsg(int s, const struct msghdr *msg, int flags);
+#endif
+#if LWIP_SOCKET_MMSG
+struct timespec;
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+#endif
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
 #if LWIP_SELECT
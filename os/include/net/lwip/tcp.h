@@ -165,6 +165,24 @@ enum tcp_state {
 #define DEF_ACCEPT_CALLBACK
 #endif							/* LWIP_CALLBACK_API */
 
+#if LWIP_WND_SCALE
+#define RCV_WND_SCALE(pcb, wnd) (((wnd) >> (pcb)->rcv_scale))
+#define SND_WND_SCALE(pcb, wnd) (((tcpwnd_size_t)(wnd) << (pcb)->snd_scale))
+#define TCPWND16(x)             ((u16_t)LWIP_MIN((x), 0xFFFF))
+#define TCP_WND_MAX(pcb)        ((tcpwnd_size_t)(((pcb)->flags & TF_WND_SCALE) ? TCP_WND : TCPWND16(TCP_WND)))
+typedef u32_t tcpwnd_size_t;
+#define TCPWNDSIZE_F            U32_F
+#else							/* LWIP_WND_SCALE */
+#define RCV_WND_SCALE(pcb, wnd) (wnd)
+#define SND_WND_SCALE(pcb, wnd) (wnd)
+#define TCPWND16(x)             (x)
+#define TCP_WND_MAX(pcb)        TCP_WND
+typedef u16_t tcpwnd_size_t;
+#define TCPWNDSIZE_F            U16_F
+#endif							/* LWIP_WND_SCALE */
+
+typedef u16_t tcpflags_t;
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
@@ -188,15 +206,17 @@ struct tcp_pcb {
 	/* ports are in host byte order */
 	u16_t remote_port;
 
-	u8_t flags;
-#define TF_ACK_DELAY   ((u8_t)0x01U)	/* Delayed ACK. */
-#define TF_ACK_NOW     ((u8_t)0x02U)	/* Immediate ACK. */
-#define TF_INFR        ((u8_t)0x04U)	/* In fast recovery. */
-#define TF_TIMESTAMP   ((u8_t)0x08U)	/* Timestamp option enabled */
-#define TF_RXCLOSED    ((u8_t)0x10U)	/* rx closed by tcp_shutdown */
-#define TF_FIN         ((u8_t)0x20U)	/* Connection was closed locally (FIN segment enqueued). */
-#define TF_NODELAY     ((u8_t)0x40U)	/* Disable Nagle algorithm */
-#define TF_NAGLEMEMERR ((u8_t)0x80U)	/* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+	tcpflags_t flags;
+#define TF_ACK_DELAY   ((tcpflags_t)0x0001U)	/* Delayed ACK. */
+#define TF_ACK_NOW     ((tcpflags_t)0x0002U)	/* Immediate ACK. */
+#define TF_INFR        ((tcpflags_t)0x0004U)	/* In fast recovery. */
+#define TF_TIMESTAMP   ((tcpflags_t)0x0008U)	/* Timestamp option enabled */
+#define TF_RXCLOSED    ((tcpflags_t)0x0010U)	/* rx closed by tcp_shutdown */
+#define TF_FIN         ((tcpflags_t)0x0020U)	/* Connection was closed locally (FIN segment enqueued). */
+#define TF_NODELAY     ((tcpflags_t)0x0040U)	/* Disable Nagle algorithm */
+#define TF_NAGLEMEMERR ((tcpflags_t)0x0080U)	/* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+#define TF_WND_SCALE   ((tcpflags_t)0x0100U)	/* Window scale option enabled */
+#define TF_SACK        ((tcpflags_t)0x0200U)	/* Selective acknowledgements enabled */
 
 	/* the rest of the fields are in host byte order
 	   as we have to do some math with them */
@@ -208,9 +228,12 @@ struct tcp_pcb {
 
 	/* receiver variables */
 	u32_t rcv_nxt;			/* next seqno expected */
-	u16_t rcv_wnd;			/* receiver window available */
-	u16_t rcv_ann_wnd;		/* receiver window to announce */
+	tcpwnd_size_t rcv_wnd;	/* receiver window available */
+	tcpwnd_size_t rcv_ann_wnd;	/* receiver window to announce */
 	u32_t rcv_ann_right_edge;	/* announced right edge of window */
+#if LWIP_TCP_SACK
+	u32_t sack_last;		/* seqno of the latest out of sequence segment */
+#endif							/* LWIP_TCP_SACK */
 
 	/* Retransmission timer. */
 	s16_t rtime;
@@ -230,16 +253,24 @@ struct tcp_pcb {
 	u32_t lastack;			/* Highest acknowledged seqno. */
 
 	/* congestion avoidance/control variables */
-	u16_t cwnd;
-	u16_t ssthresh;
+	tcpwnd_size_t cwnd;
+	tcpwnd_size_t ssthresh;
+
+#if LWIP_TCP_RACK
+	/* RACK loss detection, times in milliseconds */
+	u32_t rack_xmit_ts;		/* send time of the latest delivered segment */
+	u32_t rack_rtt;			/* RTT measured on that segment */
+	u32_t rack_min_rtt;		/* lowest RTT seen, TCP_RACK_NO_RTT until sampled */
+	u32_t rack_recover;		/* snd_nxt when the window was last reduced */
+#endif							/* LWIP_TCP_RACK */
 
 	/* sender variables */
 	u32_t snd_nxt;			/* next new seqno to be sent */
 	u32_t snd_wl1, snd_wl2;	/* Sequence and acknowledgement numbers of last
 								   window update. */
 	u32_t snd_lbb;			/* Sequence number of next byte to be buffered. */
-	u16_t snd_wnd;			/* sender window */
-	u16_t snd_wnd_max;		/* the maximum sender window announced by the remote host */
+	tcpwnd_size_t snd_wnd;	/* sender window */
+	tcpwnd_size_t snd_wnd_max;	/* the maximum sender window announced by the remote host */
 
 	u16_t acked;
 
@@ -294,6 +325,11 @@ struct tcp_pcb {
 
 	/* KEEPALIVE counter */
 	u8_t keep_cnt_sent;
+
+#if LWIP_WND_SCALE
+	u8_t snd_scale;
+	u8_t rcv_scale;
+#endif							/* LWIP_WND_SCALE */
 };
 
 struct tcp_pcb_listen {
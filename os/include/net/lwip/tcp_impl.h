@@ -85,6 +85,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+#if LWIP_TCP_RACK
+u8_t tcp_rack_detect_loss(struct tcp_pcb *pcb);
+#endif							/* LWIP_TCP_RACK */
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -291,17 +294,33 @@ struct tcp_seg {
 	u16_t chksum;
 	u8_t chksum_swapped;
 #endif							/* TCP_CHECKSUM_ON_COPY */
+#if LWIP_TCP_RACK
+	u32_t xmit_ts;			/* sys_now() of the last transmission */
+#endif							/* LWIP_TCP_RACK */
 	u8_t flags;
 #define TF_SEG_OPTS_MSS         (u8_t)0x01U	/* Include MSS option. */
 #define TF_SEG_OPTS_TS          (u8_t)0x02U	/* Include timestamp option. */
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U	/* ALL data (not the header) is
 											   checksummed into 'chksum' */
+#define TF_SEG_OPTS_WND_SCALE   (u8_t)0x08U	/* Include window scale option. */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x10U	/* Include SACK permitted option. */
+#define TF_SEG_SACKED           (u8_t)0x20U	/* Reported as received by a SACK block. */
+#define TF_SEG_SENT             (u8_t)0x40U	/* Transmitted at least once. */
+#define TF_SEG_RETRANSMITTED    (u8_t)0x80U	/* Transmitted more than once. */
 	struct tcp_hdr *tcphdr;	/* the TCP header */
 };
 
 #define LWIP_TCP_OPT_LENGTH(flags)              \
 	(flags & TF_SEG_OPTS_MSS ? 4  : 0) +        \
-	(flags & TF_SEG_OPTS_TS  ? 12 : 0)
+	(flags & TF_SEG_OPTS_TS  ? 12 : 0) +        \
+	(flags & TF_SEG_OPTS_WND_SCALE ? 4 : 0) +   \
+	(flags & TF_SEG_OPTS_SACK_PERM ? 4 : 0)
+
+/* SACK option with n blocks, padded with two NOPs */
+#define LWIP_TCP_SACK_OPT_LENGTH(n)     (4 + 8 * (n))
+#define TCP_SACK_MAX_BLOCKS             4
+
+#define TCP_RACK_NO_RTT                 0xFFFFFFFFUL
 
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) htonl(0x02040000 | ((mss) & 0xFFFF))
@@ -323,6 +342,7 @@ extern struct tcp_pcb *tcp_active_pcbs;	/* List of all TCP PCBs that are in a
 											   data. */
 extern struct tcp_pcb
 	*tcp_tw_pcbs;				/* List of all TCP PCBs in TIME-WAIT. */
+extern const char *const tcp_state_str[];
 
 extern struct tcp_pcb *tcp_tmp_pcb;	/* Only used for temporary storage. */
 
@@ -61,6 +61,10 @@
 #include <net/lwip/timers.h>
 #include <net/lwip/netif.h>
 
+#if LWIP_TCPIP_CORE_LOCKING
+#include <tinyara/net/net.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -72,10 +76,11 @@ extern "C" {
 #endif
 
 #if LWIP_TCPIP_CORE_LOCKING
-/** The global semaphore to lock the stack. */
-extern sys_mutex_t lock_tcpip_core;
-#define LOCK_TCPIP_CORE()     sys_mutex_lock(&lock_tcpip_core)
-#define UNLOCK_TCPIP_CORE()   sys_mutex_unlock(&lock_tcpip_core)
+/** The stack is locked with the network lock of the OS.  It is re-entrant,
+ * but a thread that waits for the tcpip thread (e.g. a delayed write) must
+ * not hold it more than once. */
+#define LOCK_TCPIP_CORE()     net_lock()
+#define UNLOCK_TCPIP_CORE()   net_unlock(0)
 #define TCPIP_APIMSG(m)       tcpip_apimsg_lock(m)
 #define TCPIP_APIMSG_ACK(m)
 #define TCPIP_NETIFAPI(m)     tcpip_netifapi_lock(m)
@@ -107,6 +112,7 @@ err_t tcpip_apimsg_lock(struct api_msg *apimsg);
 #endif							/* LWIP_NETCONN */
 
 err_t tcpip_input(struct pbuf *p, struct netif *inp);
+err_t tcpip_input_list(struct pbuf *p, struct netif *inp);
 
 #if LWIP_NETIF_API
 err_t tcpip_netifapi(struct netifapi_msg *netifapimsg);
@@ -136,6 +142,7 @@ enum tcpip_msg_type {
 	TCPIP_MSG_API,
 #endif							/* LWIP_NETCONN */
 	TCPIP_MSG_INPKT,
+	TCPIP_MSG_INPKT_LIST,
 #if LWIP_NETIF_API
 	TCPIP_MSG_NETIFAPI,
 #endif							/* LWIP_NETIF_API */
@@ -160,6 +167,9 @@ struct tcpip_msg {
 		struct {
 			struct pbuf *p;
 			struct netif *netif;
+#ifdef CONFIG_NET_PERF_STATS
+			u32_t stamp;		/* netperf_begin() when posted */
+#endif
 		} inp;
 		struct {
 			tcpip_callback_fn function;
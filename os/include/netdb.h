@@ -329,6 +329,73 @@ int getaddrinfo(const char *host, const char *service, const struct addrinfo *hi
  */
 void freeaddrinfo(FAR struct addrinfo *ai);
 
+#ifdef CONFIG_NETDB_DNSCLIENT
+/**
+ * @brief An asynchronous getaddrinfo() request, see getaddrinfo_async()
+ */
+struct gai_async_s;
+
+/**
+ * @brief Completion callback of getaddrinfo_async()
+ * @param[in] result 0 on success, otherwise an EAI_* value
+ * @param[in] res the addresses found, to be released with freeaddrinfo(), or NULL
+ * @param[in] arg the argument given to getaddrinfo_async()
+ */
+typedef void (*gai_callback_t)(int result, FAR struct addrinfo *res, FAR void *arg);
+
+/**
+ * @brief getaddrinfo_async() starts a getaddrinfo() lookup that does not block the caller.
+ *        The lookup progresses when the caller polls gai_async_fd() for POLLIN, with a
+ *        timeout of gai_async_timeout() milliseconds, and calls gai_async_process() after
+ *        either, so that many lookups can be in flight from one event loop.
+ *        Numeric hosts, cached answers and invalid arguments complete before this
+ *        function returns, in which case *req is set to NULL.
+ * @param[in] host the domain name to resolve
+ * @param[in] service can be a port number passed as string or a service name
+ * @param[in] hints can be either NULL or an addrinfo structure with the type of service requested
+ * @param[in] callback the function called with the result, exactly once unless cancelled
+ * @param[in] arg the argument of the callback
+ * @param[out] req the request in progress, or NULL if it already completed
+ * @return 0 on success, EAI_FAIL if callback or req is NULL
+ * @since Tizen RT v2.0
+ */
+int getaddrinfo_async(FAR const char *host, FAR const char *service, FAR const struct addrinfo *hints, gai_callback_t callback, FAR void *arg, FAR struct gai_async_s **req);
+
+/**
+ * @brief gai_async_fd() returns the descriptor to poll for POLLIN for a request
+ * @param[in] req the request returned by getaddrinfo_async()
+ * @return the socket descriptor of the request
+ * @since Tizen RT v2.0
+ */
+int gai_async_fd(FAR struct gai_async_s *req);
+
+/**
+ * @brief gai_async_timeout() returns the time after which gai_async_process() must be called
+ *        even if the descriptor does not become readable, to send the queries again
+ * @param[in] req the request returned by getaddrinfo_async()
+ * @return the timeout in milliseconds
+ * @since Tizen RT v2.0
+ */
+int gai_async_timeout(FAR struct gai_async_s *req);
+
+/**
+ * @brief gai_async_process() takes the responses queued for a request without blocking.
+ *        When the lookup completes, the callback is called and the request is freed.
+ * @param[in] req the request returned by getaddrinfo_async()
+ * @return 1 if the lookup is still in progress, 0 once it completed
+ * @since Tizen RT v2.0
+ */
+int gai_async_process(FAR struct gai_async_s *req);
+
+/**
+ * @brief gai_async_cancel() abandons a request in progress without calling its callback
+ * @param[in] req the request returned by getaddrinfo_async()
+ * @return void
+ * @since Tizen RT v2.0
+ */
+void gai_async_cancel(FAR struct gai_async_s *req);
+#endif
+
 /**
  * @brief gethostbyaddr() is the function returns a corresponding hostname with given IP addresses
  * @param[in] *addr host address sending DNS server (e.g., 192.168.0.0)
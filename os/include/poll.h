@@ -141,6 +141,15 @@ struct pollfd {
 #ifdef CONFIG_NET_LWIP
 	FAR void *scb;
 #endif
+#ifdef CONFIG_EPOLL
+	/* Set by epoll for a descriptor that stays set up across waits.  The
+	 * socket layer calls notify() when a new event is posted, other
+	 * descriptors only post 'sem'.
+	 */
+
+	CODE void (*notify)(FAR struct pollfd *fds);
+	FAR struct pollfd *flink;	/* Link in the list of the socket */
+#endif
 };
 
 /****************************************************************************
@@ -119,10 +119,9 @@ struct sem_s {
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t flags;			/* See PRIOINHERIT_FLAGS_* definitions */
+	struct semholder_s holder;	/* First holder, the only one of a mutex */
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	FAR struct semholder_s *hhead;	/* List of holders of semaphore counts */
-#else
-	struct semholder_s holder;	/* Single holder */
+	FAR struct semholder_s *hhead;	/* List of further holders of semaphore counts */
 #endif
 #endif
 };
@@ -136,7 +135,7 @@ typedef struct sem_s sem_t;
  */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#define SEM_INITIALIZER(c) {(c), 0, NULL} /* semcount, flags, hhead */
+#define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER, NULL} /* semcount, flags, holder, hhead */
 #else
 #define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER} /* semcount, flags, holder */
 #endif
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/shmchan.h
+ *
+ * Single-producer single-consumer byte channels in a shared memory segment.
+ * The segment holds the ring indices, two doorbell semaphores and the ring
+ * itself, so the producer writes and the consumer reads the data in place
+ * without any copy through the kernel.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup SHMCHAN_LIBC SHMCHAN
+ * @brief Provides shared memory channels between tasks
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+#ifndef __INCLUDE_SHMCHAN_H
+#define __INCLUDE_SHMCHAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMCHAN_MAGIC           0x6368616e	/* "chan" */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Start of the shared memory segment, followed by the ring.  head and tail
+ * run freely and are only reduced modulo size when the ring is accessed;
+ * head is only written by the producer and tail only by the consumer.
+ */
+
+struct shmchan_hdr_s {
+	uint32_t magic;
+	uint32_t size;				/* Ring size in bytes, a power of two */
+	volatile uint32_t head;		/* Bytes committed by the producer */
+	volatile uint32_t tail;		/* Bytes released by the consumer */
+	volatile uint8_t rxwait;	/* The consumer waits on rxsem */
+	volatile uint8_t txwait;	/* The producer waits on txsem */
+	sem_t rxsem;				/* Posted when data is committed */
+	sem_t txsem;				/* Posted when space is released */
+};
+
+/* One end of a channel, private to the task using it */
+
+struct shmchan_s {
+	FAR struct shmchan_hdr_s *hdr;
+	FAR uint8_t *ring;
+	int shmid;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @brief Create a channel in a new shared memory segment and attach to it
+ * @param[in] key shmget() key of the segment, it must not exist yet
+ * @param[in] size ring size in bytes, rounded up to a power of two
+ * @return 0 on success, -1 with errno set on failure
+ * @since Tizen RT v2.0
+ */
+int shmchan_create(key_t key, size_t size, FAR struct shmchan_s *chan);
+/**
+ * @brief Attach to the channel created with key by another task
+ * @return 0 on success, -1 with errno set on failure
+ * @since Tizen RT v2.0
+ */
+int shmchan_open(key_t key, FAR struct shmchan_s *chan);
+/**
+ * @brief Detach from a channel
+ * @return 0 on success, -1 with errno set on failure
+ * @since Tizen RT v2.0
+ */
+int shmchan_close(FAR struct shmchan_s *chan);
+/**
+ * @brief Detach from a channel and remove its segment
+ * @details The other end must have closed the channel.
+ * @return 0 on success, -1 with errno set on failure
+ * @since Tizen RT v2.0
+ */
+int shmchan_destroy(FAR struct shmchan_s *chan);
+/**
+ * @brief Producer: get the contiguous free space at the head of the ring
+ * @param[out] buf start of the free space
+ * @param[in] wait block until there is free space, else fail with EAGAIN
+ * @return the number of bytes that may be written at buf, -1 with errno
+ *   set on failure
+ * @since Tizen RT v2.0
+ */
+ssize_t shmchan_reserve(FAR struct shmchan_s *chan, FAR void **buf, bool wait);
+/**
+ * @brief Producer: pass len bytes written after shmchan_reserve() to the consumer
+ * @since Tizen RT v2.0
+ */
+void shmchan_commit(FAR struct shmchan_s *chan, size_t len);
+/**
+ * @brief Consumer: get the contiguous data at the tail of the ring
+ * @param[out] buf start of the data
+ * @param[in] wait block until there is data, else fail with EAGAIN
+ * @return the number of bytes that may be read at buf, -1 with errno set
+ *   on failure
+ * @since Tizen RT v2.0
+ */
+ssize_t shmchan_peek(FAR struct shmchan_s *chan, FAR const void **buf, bool wait);
+/**
+ * @brief Consumer: return len bytes read after shmchan_peek() to the producer
+ * @since Tizen RT v2.0
+ */
+void shmchan_release(FAR struct shmchan_s *chan, size_t len);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __INCLUDE_SHMCHAN_H */
+/**
+ * @}
+ */
@@ -197,6 +197,7 @@
 
 #define SIGEV_NONE      0		/* No notification desired */
 #define SIGEV_SIGNAL    1		/* Notify via signal */
+#define SIGEV_EVENTFD   2		/* Write 1 to the eventfd sigev_signo (non-standard, AIO only) */
 
 /* Special values of sigaction (all treated like NULL) */
 
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/stdio_ext.h
+ *
+ * Extensions to stdio following the interfaces of the same name in other C
+ * libraries.
+ *
+ ****************************************************************************/
+/**
+ * @ingroup STDIO_LIBC
+ *
+ * @{
+ */
+
+#ifndef __INCLUDE_STDIO_EXT_H
+#define __INCLUDE_STDIO_EXT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Locking types of __fsetlocking() */
+
+#define FSETLOCKING_QUERY    0	/* Only return the current type */
+#define FSETLOCKING_INTERNAL 1	/* Each stdio call locks the stream */
+#define FSETLOCKING_BYCALLER 2	/* The caller serializes all accesses */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @brief Select whether stdio calls on the stream take its lock
+ * @details With FSETLOCKING_BYCALLER, a stream that only one task uses
+ * skips the semaphore on every fputc(), fwrite() or printf() call.  Change
+ * the type only while no other stdio call is running on the stream.
+ * @return the type in effect before the call
+ * @since Tizen RT v2.0
+ */
+int __fsetlocking(FAR FILE *stream, int type);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __INCLUDE_STDIO_EXT_H */
+/**
+ * @}
+ */
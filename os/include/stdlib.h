@@ -109,6 +109,17 @@
 /****************************************************************************
  * Global Type Definitions
  ****************************************************************************/
+#ifdef CONFIG_MM_REGION_POLICY
+/** @brief usage of one heap region, part of struct mallinfo */
+struct mallinfo_region {
+	int tag;					/* Region tags (MM_REGION_FAST/SLOW) */
+	int arena;					/* Size of the region */
+	int mxordblk;				/* Size of the largest free chunk */
+	int uordblks;				/* Space occupied by allocated chunks */
+	int fordblks;				/* Space occupied by free chunks */
+};
+#endif
+
 /** @brief structure of memory information */
 struct mallinfo {
 	int arena;					/* This is the total size of memory allocated
@@ -119,6 +130,14 @@ struct mallinfo {
 								 * chunks handed out by malloc. */
 	int fordblks;				/* This is the total size of memory occupied
 								 * by free (not in use) chunks.*/
+#ifdef CONFIG_MM_TASK_CACHE
+	int cachehits;				/* Allocations served by per-task caches */
+	int cachemisses;			/* Per-task cache refills from the heap */
+#endif
+#ifdef CONFIG_MM_REGION_POLICY
+	int nregions;				/* Number of valid entries in regions[] */
+	struct mallinfo_region regions[CONFIG_MM_REGIONS];
+#endif
 };
 
 /* Structure type returned by the div() function. */
@@ -375,6 +394,15 @@ void free(FAR void *);
  * @since Tizen RT v1.0
  */
 FAR void *realloc(FAR void *, size_t);
+/**
+ * @ingroup STDLIB_LIBC
+ * @brief returns the number of usable bytes in a block allocated by malloc
+ *
+ * @param[in] mem A pointer returned by malloc, calloc or realloc, or NULL
+ * @return The usable size of the block, which may be larger than requested. 0 if mem is NULL.
+ * @since Tizen RT v1.1
+ */
+size_t malloc_usable_size(FAR void *mem);
 /**
  * @ingroup STDLIB_LIBC
  * @brief allocates size bytes and returns a pointer to the allocated memory
@@ -466,6 +494,19 @@ int mkstemp(FAR char *path_template);
  * @since Tizen RT v1.0
  */
 void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *));
+/**
+ * @ingroup STDLIB_LIBC
+ * @brief  qsort() passing arg as the third argument of each call to compar
+ * @since Tizen RT v2.0
+ */
+void qsort_r(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *, void *), void *arg);
+/**
+ * @ingroup STDLIB_LIBC
+ * @brief  Stable radix sort of elements by the uint32_t key at keyoffset
+ * @return 0 on success, -1 with errno ENOMEM if no temporary copy could be allocated
+ * @since Tizen RT v2.0
+ */
+int radixsort_u32(FAR void *base, size_t nmemb, size_t size, size_t keyoffset);
 
 /* Binary search */
 /**
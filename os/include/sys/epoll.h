@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EPOLL_KERNEL EPOLL
+ * @brief Provides APIs for epoll
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/epoll.h
+/// @brief epoll APIs
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+
+#ifdef CONFIG_EPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Operations of epoll_ctl() */
+
+#define EPOLL_CTL_ADD   1		/* Register a descriptor */
+#define EPOLL_CTL_DEL   2		/* Remove a descriptor */
+#define EPOLL_CTL_MOD   3		/* Change the events of a descriptor */
+
+/* Flags of epoll_create1().  There is no exec(), the flag is accepted and
+ * ignored.
+ */
+
+#define EPOLL_CLOEXEC   (1 << 0)
+
+/* Events.  EPOLLERR and EPOLLHUP are always reported. */
+
+#define EPOLLIN         POLLIN
+#define EPOLLOUT        POLLOUT
+#define EPOLLERR        POLLERR
+#define EPOLLHUP        POLLHUP
+
+/* Report the descriptor once, then disable it until EPOLL_CTL_MOD */
+
+#define EPOLLONESHOT    (1u << 30)
+
+/* Edge-triggered: report the descriptor when a new event occurs rather
+ * than for as long as it is ready.
+ */
+
+#define EPOLLET         (1u << 31)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef union epoll_data {
+	FAR void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;			/* Events (input), events that occurred (output) */
+	epoll_data_t data;			/* Returned with the events */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief create an epoll instance
+ * @details @b #include <sys/epoll.h> \n
+ * The instance is a file descriptor, closed with close().  It cannot be
+ * duplicated.
+ * @param[in] size ignored, but must be greater than zero
+ * @return On success, the file descriptor of the instance. On failure, -1 is returned.
+ * @since Tizen RT v1.0
+ */
+int epoll_create(int size);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief create an epoll instance
+ * @details @b #include <sys/epoll.h>
+ * @param[in] flags 0 or EPOLL_CLOEXEC
+ * @return On success, the file descriptor of the instance. On failure, -1 is returned.
+ * @since Tizen RT v1.0
+ */
+int epoll_create1(int flags);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief add, modify or remove a descriptor of an epoll instance
+ * @details @b #include <sys/epoll.h> \n
+ * Descriptors other than sockets must be removed before they are closed.
+ * @param[in] epfd the epoll instance
+ * @param[in] op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param[in] fd the file or socket descriptor
+ * @param[in] ev the events to wait for and the data to return, unused by EPOLL_CTL_DEL
+ * @return On success, 0 is returned. On failure, -1 is returned.
+ * @since Tizen RT v1.0
+ */
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief wait for events on an epoll instance
+ * @details @b #include <sys/epoll.h>
+ * @param[in] epfd the epoll instance
+ * @param[out] events returns the events that occurred
+ * @param[in] maxevents the size of 'events'
+ * @param[in] timeout in milliseconds, -1 to wait forever
+ * @return On success, the number of events returned, 0 on timeout. On failure, -1 is returned.
+ * @since Tizen RT v1.0
+ */
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_EPOLL */
+#endif							/* __INCLUDE_SYS_EPOLL_H */
+/**
+ * @}
+ */
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EVENTFD_KERNEL EVENTFD
+ * @brief Provides APIs for eventfd
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/eventfd.h
+/// @brief eventfd APIs
+
+#ifndef __INCLUDE_SYS_EVENTFD_H
+#define __INCLUDE_SYS_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef CONFIG_EVENTFD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of eventfd().  There is no exec(), EFD_CLOEXEC is accepted and
+ * ignored.
+ */
+
+#define EFD_NONBLOCK    O_NONBLOCK
+#define EFD_CLOEXEC     (1 << 14)
+#define EFD_SEMAPHORE   (1 << 15)	/* read() returns 1 and decrements */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef uint64_t eventfd_t;
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Read and write the counter of an eventfd.  Return 0 on success, -1 on
+ * failure.
+ */
+
+static inline int eventfd_read(int fd, FAR eventfd_t *value)
+{
+	return read(fd, value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? 0 : -1;
+}
+
+static inline int eventfd_write(int fd, eventfd_t value)
+{
+	return write(fd, &value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? 0 : -1;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup EVENTFD_KERNEL
+ * @brief create a file descriptor for event notification
+ * @details @b #include <sys/eventfd.h> \n
+ * write() adds an 8-byte value to the counter of the eventfd.  read()
+ * returns the counter and resets it, or returns 1 and decrements it with
+ * EFD_SEMAPHORE, and waits while it is zero.  poll() reports POLLIN while
+ * the counter is not zero.  The descriptor is closed with close() and
+ * cannot be duplicated.
+ * @param[in] initval the initial value of the counter
+ * @param[in] flags EFD_NONBLOCK, EFD_CLOEXEC, EFD_SEMAPHORE
+ * @return On success, the file descriptor. On failure, -1 is returned.
+ * @since Tizen RT v1.0
+ */
+int eventfd(unsigned int initval, int flags);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_EVENTFD */
+#endif							/* __INCLUDE_SYS_EVENTFD_H */
+/**
+ * @}
+ */
@@ -132,6 +132,14 @@ extern "C" {
 
 ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
 
+#ifdef CONFIG_NET_SENDFILE
+/* The read()/write() copy loop, used by sendfile() for the files it cannot
+ * send without copying.
+ */
+
+ssize_t lib_sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
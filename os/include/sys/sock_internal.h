@@ -60,7 +60,7 @@
 #include <tinyara/config.h>
 #include <sys/types.h>
 
-#ifdef CONFIG_ENABLE_IOTIVITY
+#if defined(CONFIG_ENABLE_IOTIVITY) || defined(CONFIG_NET_SOCKET_SENDMSG)
 
 #include <uio.h>
 
@@ -74,6 +74,15 @@ struct msghdr {
 	unsigned int msg_flags;
 };
 
+#ifdef CONFIG_NET_SOCKET_MMSG
+/* One message of recvmmsg() and sendmmsg() */
+
+struct mmsghdr {
+	struct msghdr msg_hdr;		/* The message */
+	unsigned int msg_len;		/* Bytes received or sent */
+};
+#endif							/* CONFIG_NET_SOCKET_MMSG */
+
 /*
  *  POSIX 1003.1g - ancillary data object information
  *  Ancillary data consits of a sequence of pairs of
@@ -115,7 +124,7 @@ static inline struct cmsghdr *cmsg_nxthdr(struct msghdr *__msg, struct cmsghdr *
 {
 	return __cmsg_nxthdr(__msg->msg_control, __msg->msg_controllen, __cmsg);
 }
-#endif							/* CONFIG_ENABLE_IOTIVITY */
+#endif							/* CONFIG_ENABLE_IOTIVITY || CONFIG_NET_SOCKET_SENDMSG */
 
 /****************************************************************************
  * Definitions
@@ -190,6 +199,7 @@ static inline struct cmsghdr *cmsg_nxthdr(struct msghdr *__msg, struct cmsghdr *
 #define MSG_ERRQUEUE   0x2000	/* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000	/* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000	/* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000	/* recvmmsg(): block for the first message only.  */
 
 /* Socket options */
 
@@ -225,6 +235,9 @@ static inline struct cmsghdr *cmsg_nxthdr(struct msghdr *__msg, struct cmsghdr *
 #define SO_SNDTIMEO    15		/* Sets the timeout value specifying the amount of time that an
 								 * output function blocks because flow control prevents data from
 								 * being sent(get/set). arg: struct timeval */
+#define SO_REUSEPORT   16		/* Allow several TCP sockets to bind and listen on the same
+								 * address and port (get/set).
+								 * arg: pointer to integer containing a boolean value */
 
 /* Protocol levels supported by get/setsockopt(): */
 
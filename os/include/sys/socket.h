@@ -167,6 +167,20 @@ ssize_t send(int sockfd, FAR const void *buf, size_t len, int flags);
 */
 ssize_t sendto(int sockfd, FAR const void *buf, size_t len, int flags, FAR const struct sockaddr *to, socklen_t tolen);
 
+#ifdef CONFIG_NET_SOCKET_SENDMSG
+/**
+* @brief   send a message gathered from several buffers on a socket
+*
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[in] msg the buffers to send (msg_iov, msg_iovlen) and, for a datagram
+*            socket, the destination address (msg_name, msg_namelen)
+* @param[in] flags the type of message transmission
+* @return On success, returns the number of bytes sent, On failure, -1 is returned.
+* @since Tizen RT v1.0
+*/
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
+#endif
+
 /**
 * @brief   send a message on a socket
 *
@@ -193,6 +207,36 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 */
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags, FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+#ifdef CONFIG_NET_SOCKET_MMSG
+struct timespec;
+
+/**
+* @brief   receive several datagrams from a socket with a single call
+*
+* @param[in] sockfd the file descriptor of a UDP or raw socket
+* @param[inout] msgvec the messages; for each, msg_hdr describes the buffers and
+*            returns the sender address and flags, msg_len returns the size received
+* @param[in] vlen the number of messages in msgvec
+* @param[in] flags MSG_WAITFORONE to wait for the first datagram only, MSG_DONTWAIT, MSG_PEEK
+* @param[in] timeout null, or the time after which no further datagram is received
+* @return On success, returns the number of datagrams received, On failure, -1 is returned.
+* @since Tizen RT v2.0
+*/
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags, FAR struct timespec *timeout);
+
+/**
+* @brief   send several messages on a socket with a single call
+*
+* @param[in] sockfd the file descriptor of the socket
+* @param[inout] msgvec the messages, as for sendmsg(); msg_len returns the bytes sent
+* @param[in] vlen the number of messages in msgvec
+* @param[in] flags the type of message transmission, applied to every message
+* @return On success, returns the number of messages sent, On failure, -1 is returned.
+* @since Tizen RT v2.0
+*/
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags);
+#endif
+
 /**
 * @brief   shut down socket send and receive operations
 *
@@ -116,6 +116,7 @@
 /* TinyAra specific file-systems */
 
 #define BINFS_MAGIC           0x4242
+#define CROMFS_MAGIC          0x4d4f5243
 #define PROCFS_MAGIC          0x434f5250
 #define NXFFS_MAGIC           0x4747
 #define SMARTFS_MAGIC         0x54524D53
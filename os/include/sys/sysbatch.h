@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup SYSBATCH_KERNEL SYSBATCH
+ * @brief Provides APIs for batched system calls
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/sysbatch.h
+/// @brief Batched system call APIs
+
+#ifndef __INCLUDE_SYS_SYSBATCH_H
+#define __INCLUDE_SYS_SYSBATCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/syscall.h>
+
+#ifdef CONFIG_SYSCALL_BATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of a submission entry */
+
+#define SYSBATCH_F_STOP   (1 << 0)	/* Stop the batch if this call fails */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A queued system call: the SYS_* number and up to six parameters, passed
+ * exactly as the proxy would pass them.
+ */
+
+struct sysbatch_sqe_s {
+	uint16_t nbr;				/* SYS_* system call number */
+	uint16_t flags;				/* SYSBATCH_F_* */
+	uint32_t user_data;			/* Copied to the completion */
+	uintptr_t parm[6];			/* Parameters of the call */
+};
+
+/* The outcome of one call, in submission order */
+
+struct sysbatch_cqe_s {
+	uint32_t user_data;			/* user_data of the submission */
+	int errcode;				/* errno if the call returned -1, else 0 */
+	uintptr_t result;			/* Return value of the call */
+};
+
+/* A submission ring and a completion ring of the same size in caller
+ * memory.  The caller advances sq_tail and cq_head, the kernel advances
+ * sq_head and cq_tail.  The indexes run freely and are masked on use.
+ */
+
+struct sysbatch_s {
+	uint32_t sq_head;			/* Next submission the kernel runs */
+	uint32_t sq_tail;			/* Next submission the caller fills */
+	uint32_t cq_head;			/* Next completion the caller reaps */
+	uint32_t cq_tail;			/* Next completion the kernel fills */
+	uint32_t mask;				/* Number of entries - 1 */
+	FAR struct sysbatch_sqe_s *sqes;
+	FAR struct sysbatch_cqe_s *cqes;
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Set up a batch over nentries (a power of two) entries in each ring */
+
+static inline void sysbatch_init(FAR struct sysbatch_s *batch, FAR struct sysbatch_sqe_s *sqes, FAR struct sysbatch_cqe_s *cqes, uint32_t nentries)
+{
+	batch->sq_head = 0;
+	batch->sq_tail = 0;
+	batch->cq_head = 0;
+	batch->cq_tail = 0;
+	batch->mask = nentries - 1;
+	batch->sqes = sqes;
+	batch->cqes = cqes;
+}
+
+/* Return the next free submission entry and queue it, or NULL if the
+ * submission ring is full.
+ */
+
+static inline FAR struct sysbatch_sqe_s *sysbatch_get_sqe(FAR struct sysbatch_s *batch)
+{
+	FAR struct sysbatch_sqe_s *sqe;
+
+	if (batch->sq_tail - batch->sq_head > batch->mask) {
+		return NULL;
+	}
+
+	sqe = &batch->sqes[batch->sq_tail & batch->mask];
+	sqe->flags = 0;
+	sqe->user_data = 0;
+	batch->sq_tail++;
+	return sqe;
+}
+
+/* Return the oldest completion not yet reaped, or NULL if there is none.
+ * sysbatch_cqe_seen() releases it.
+ */
+
+static inline FAR struct sysbatch_cqe_s *sysbatch_get_cqe(FAR struct sysbatch_s *batch)
+{
+	if (batch->cq_head == batch->cq_tail) {
+		return NULL;
+	}
+
+	return &batch->cqes[batch->cq_head & batch->mask];
+}
+
+static inline void sysbatch_cqe_seen(FAR struct sysbatch_s *batch)
+{
+	batch->cq_head++;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup SYSBATCH_KERNEL
+ * @brief run the queued system calls of a batch in one kernel entry
+ * @details @b #include <sys/sysbatch.h> \n
+ * Runs submissions in order from sq_head to sq_tail and posts one
+ * completion for each.  It stops early when the completion ring is full or
+ * after a failed call flagged SYSBATCH_F_STOP; the remaining submissions
+ * stay queued.  A call that blocks blocks the whole batch.  Unknown system
+ * call numbers and nested batches complete with ENOSYS.
+ * @param[in,out] batch the rings to process
+ * @return On success, the number of calls run. On failure, -1 is returned
+ *         and errno is set (EINVAL for a malformed batch).
+ * @since Tizen RT v1.0
+ */
+int sysbatch_submit(FAR struct sysbatch_s *batch);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_SYSCALL_BATCH */
+#endif							/* __INCLUDE_SYS_SYSBATCH_H */
+/**
+ * @}
+ */
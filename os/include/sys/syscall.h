@@ -213,7 +213,12 @@
 #define SYS_clock_gettime              (__SYS_clock+2)
 #define SYS_clock_settime              (__SYS_clock+3)
 #define SYS_gettimeofday               (__SYS_clock+4)
+#ifdef CONFIG_CLOCK_TIMEPAGE
+#define SYS_clock_timepage             (__SYS_clock+5)
+#define __SYS_timers                   (__SYS_clock+6)
+#else
 #define __SYS_timers                   (__SYS_clock+5)
+#endif
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -260,7 +265,21 @@
 #ifndef CONFIG_DISABLE_POLL
 #define SYS_poll                       __SYS_poll
 #define SYS_select                     (__SYS_poll+1)
-#define __SYS_filedesc                 (__SYS_poll+2)
+#ifdef CONFIG_EPOLL
+#define SYS_epoll_create               (__SYS_poll+2)
+#define SYS_epoll_create1              (__SYS_poll+3)
+#define SYS_epoll_ctl                  (__SYS_poll+4)
+#define SYS_epoll_wait                 (__SYS_poll+5)
+#define __SYS_eventfd                  (__SYS_poll+6)
+#else
+#define __SYS_eventfd                  (__SYS_poll+2)
+#endif
+#ifdef CONFIG_EVENTFD
+#define SYS_eventfd                    __SYS_eventfd
+#define __SYS_filedesc                 (__SYS_eventfd+1)
+#else
+#define __SYS_filedesc                 __SYS_eventfd
+#endif
 #else
 #define __SYS_filedesc                 __SYS_poll
 #endif
@@ -291,9 +310,17 @@
 #if CONFIG_NFILE_STREAMS > 0
 #define SYS_fs_fdopen                  (__SYS_filedesc+16)
 #define SYS_sched_getstreams           (__SYS_filedesc+17)
-#define __SYS_mountpoint               (__SYS_filedesc+18)
+#define __SYS_splice                   (__SYS_filedesc+18)
 #else
-#define __SYS_mountpoint               (__SYS_filedesc+16)
+#define __SYS_splice                   (__SYS_filedesc+16)
+#endif
+
+#ifdef CONFIG_PIPE_SPLICE
+#define SYS_splice                     (__SYS_splice+0)
+#define SYS_tee                        (__SYS_splice+1)
+#define __SYS_mountpoint               (__SYS_splice+2)
+#else
+#define __SYS_mountpoint               __SYS_splice
 #endif
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT)
@@ -376,7 +403,9 @@
 #define SYS_mq_timedreceive            (__SYS_mqueue+7)
 #define SYS_mq_timedsend               (__SYS_mqueue+8)
 #define SYS_mq_unlink                  (__SYS_mqueue+9)
-#define __SYS_environ                  (__SYS_mqueue+10)
+#define SYS_mq_refalloc                (__SYS_mqueue+10)
+#define SYS_mq_reffree                 (__SYS_mqueue+11)
+#define __SYS_environ                  (__SYS_mqueue+12)
 #else
 #define __SYS_environ                  __SYS_mqueue
 #endif
@@ -418,9 +447,18 @@
 
 #if CONFIG_TASK_NAME_SIZE > 0
 #define SYS_prctl                      (SYS_nnetsocket+0)
-#define SYS_maxsyscall                 (SYS_nnetsocket+1)
+#define __SYS_sysbatch                 (SYS_nnetsocket+1)
+#else
+#define __SYS_sysbatch                 SYS_nnetsocket
+#endif
+
+/* The following is defined only if batched system calls are supported */
+
+#ifdef CONFIG_SYSCALL_BATCH
+#define SYS_sysbatch_submit            (__SYS_sysbatch+0)
+#define SYS_maxsyscall                 (__SYS_sysbatch+1)
 #else
-#define SYS_maxsyscall                 SYS_nnetsocket
+#define SYS_maxsyscall                 __SYS_sysbatch
 #endif
 
 /* Note that the reported number of system calls does *NOT* include the
@@ -125,10 +125,13 @@
 
 #ifndef __ASSEMBLY__
 
+#if defined(CONFIG_ENABLE_IOTIVITY) || defined(CONFIG_NET_SOCKET_SENDMSG)
+typedef unsigned long __kernel_size_t;
+#endif
+
 #ifdef CONFIG_ENABLE_IOTIVITY
 
 typedef int wint_t;
-typedef unsigned long __kernel_size_t;
 typedef unsigned short __kernel_sa_family_t;
 typedef unsigned short __u16;
 
@@ -70,6 +70,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 #include <semaphore.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/spi/spi.h>
@@ -91,6 +92,19 @@
 #define CONFIG_ADC_FIFOSIZE 255
 #endif
 
+#if defined(CONFIG_ADC_BLOCK) && !defined(CONFIG_ADC_NBLOCKS)
+#define CONFIG_ADC_NBLOCKS 4
+#endif
+
+/*
+ * Size in bytes of one block of nsets sample sets of nchannels samples as
+ * returned by read(), padded so that the next block header stays aligned.
+ */
+
+#define ADC_BLOCK_SIZE(nsets, nchannels) \
+	((sizeof(struct adc_block_s) + \
+	  (nsets) * (nchannels) * sizeof(int32_t) + 7) & ~7)
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -120,6 +134,28 @@ struct adc_callback_s {
 
 	CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch,
 			       int32_t data);
+
+#ifdef CONFIG_ADC_BLOCK
+	/*
+	 * This method is called from the lower half, possibly from interrupt
+	 * context, when a block of sample sets started by ao_blockstart()
+	 * is complete.
+	 *
+	 * Input Parameters:
+	 *   dev   - The ADC device structure
+	 *   ts    - The time at which the first sample set was taken
+	 *   data  - nsets sample sets, the samples of each set interleaved
+	 *           in channel order
+	 *   nsets - Number of sample sets, as configured
+	 *
+	 * Returned Value:
+	 *   Zero on success; -ENOMEM if the block was dropped.
+	 */
+
+	CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+				     FAR const struct timespec *ts,
+				     FAR const int32_t *data, uint16_t nsets);
+#endif
 };
 
 /* This describes on ADC message */
@@ -139,6 +175,40 @@ struct adc_fifo_s {
 	struct  adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+/*
+ * Block mode.  After ANIOC_BLOCK_START a read() returns whole blocks, each
+ * an adc_block_s header followed by ab_nsets * ab_nchannels int32_t samples
+ * interleaved in channel order.
+ */
+
+struct adc_blockcfg_s {
+	uint32_t ab_rate;	/* Sample sets per second */
+	uint16_t ab_nsets;	/* Sample sets per block */
+	uint8_t  ab_nchannels;	/* Channels sampled in each set */
+};
+
+struct adc_block_s {
+	struct timespec ab_time; /* Time at which the first set was taken,
+				  * CLOCK_MONOTONIC if configured */
+	uint32_t ab_seqno;	/* Block number; a gap means blocks were dropped */
+	uint16_t ab_nsets;	/* Number of sample sets that follow */
+	uint8_t  ab_nchannels;	/* Samples per set */
+	uint8_t  ab_reserved;
+};
+
+#ifdef CONFIG_ADC_BLOCK
+/* The queue of completed blocks of the upper half */
+
+struct adc_blockfifo_s {
+	FAR uint8_t *ab_buffer;	/* CONFIG_ADC_NBLOCKS blocks of ab_size bytes */
+	size_t   ab_size;	/* Size of one block */
+	uint32_t ab_seqno;	/* Number of the next block produced */
+	uint8_t  ab_head;	/* Index of the oldest block */
+	uint8_t  ab_tail;	/* Index of the next free block */
+	struct adc_blockcfg_s ab_cfg;
+};
+#endif
+
 /*
  * This structure defines all of the operations providd by the architecture
  * specific logic. All fields must be provided with non-NULL function pointers
@@ -186,6 +256,19 @@ struct adc_ops_s {
 	/* All ioctl calls will be routed through this method */
 
 	CODE int (*ao_ioctl)(FAR struct adc_dev_s *dev, int cmd, unsigned long arg);
+
+#ifdef CONFIG_ADC_BLOCK
+	/*
+	 * Start timer triggered sampling of the first cfg->ab_nchannels
+	 * configured channels at cfg->ab_rate sets per second, passing up
+	 * every cfg->ab_nsets sets with au_receive_block() (optional).
+	 * ao_blockstop() ends it.
+	 */
+
+	CODE int (*ao_blockstart)(FAR struct adc_dev_s *dev,
+				  FAR const struct adc_blockcfg_s *cfg);
+	CODE void (*ao_blockstop)(FAR struct adc_dev_s *dev);
+#endif
 };
 
 /*
@@ -207,6 +290,9 @@ struct adc_dev_s {
 	sem_t             ad_closesem;   /* Locks out new opens while close is in progress */
 	sem_t             ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
 	struct adc_fifo_s ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_BLOCK
+	struct adc_blockfifo_s ad_blocks; /* Completed blocks in block mode */
+#endif
 #endif
 
 	/* Fields provided by lower half ADC logic */
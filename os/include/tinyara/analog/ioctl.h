@@ -76,9 +76,16 @@
 #define ANIOC_TRIGGER		_ANIOC(0x0001)	/* Trigger one conversion
 						 * IN: None
 						 * OUT: None */
+#define ANIOC_BLOCK_START	_ANIOC(0x0002)	/* Start block mode
+						 * IN: Pointer to struct
+						 *     adc_blockcfg_s
+						 * OUT: None */
+#define ANIOC_BLOCK_STOP	_ANIOC(0x0003)	/* Stop block mode
+						 * IN: None
+						 * OUT: None */
 
 #define AN_FIRST		0x0001		/* First commands */
-#define AN_NCMDS		1		/* Two common commands */
+#define AN_NCMDS		3		/* Three common commands */
 
 /*
  * User defined ioctl commands are also supported. These will be forwarded
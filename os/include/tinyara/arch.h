@@ -1777,6 +1777,48 @@ void weak_function sched_process_cpuload(void);
 
 void irq_dispatch(int irq, FAR void *context);
 
+/****************************************************************************
+ * Name: up_perf_init and up_perf_gettime
+ *
+ * Description:
+ *   up_perf_init() starts the free running cycle counter of the CPU.  It is
+ *   called once from up_initialize().  up_perf_gettime() returns the
+ *   current value of the counter; it wraps around silently, so intervals
+ *   must be computed with unsigned 32-bit arithmetic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+void up_perf_init(void);
+uint32_t up_perf_gettime(void);
+#endif
+
+/****************************************************************************
+ * Name: up_dma_alloc, up_dma_free and up_dma_sync
+ *
+ * Description:
+ *   Allocate and free buffers that a device accesses by DMA.  A
+ *   DMA_COHERENT buffer lies in non-cacheable memory and is always
+ *   consistent.  A DMA_STREAMING buffer is cached, so up_dma_sync() must
+ *   be called before each transfer and, for DMA_FROM_DEVICE, once more
+ *   after it, before the CPU reads the data.  Both start on a cache line
+ *   boundary and never share a cache line with other data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DMA_ALLOC
+#define DMA_COHERENT      0
+#define DMA_STREAMING     1
+
+#define DMA_TO_DEVICE     0
+#define DMA_FROM_DEVICE   1
+#define DMA_BIDIRECTIONAL 2
+
+FAR void *up_dma_alloc(size_t size, int type);
+void up_dma_free(FAR void *mem);
+void up_dma_sync(FAR void *mem, size_t size, int dir);
+#endif
+
 /****************************************************************************
  * Name: up_check_stack and friends
  *
@@ -121,6 +121,20 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_GRAPH_ADDNODE - Append a processing node to the audio graph.
+ *                    Nodes should be added before streaming starts.
+ *
+ *   ioctl argument:  Pointer to the audio_graph_node_s structure
+ *
+ * AUDIOIOC_GRAPH_CLEAR - Remove all graph nodes.  Completed buffers go
+ *                    to the registered message queue again.
+ *
+ *   ioctl argument:  None
+ *
+ * AUDIOIOC_GRAPH_GETSTATS - Get and reset the audio graph statistics
+ *
+ *   ioctl argument:  Pointer to the audio_graph_stats_s structure
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -139,6 +153,9 @@
 #define AUDIOIOC_REGISTERMQ         _AUDIOIOC(14)
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
+#define AUDIOIOC_GRAPH_ADDNODE      _AUDIOIOC(17)
+#define AUDIOIOC_GRAPH_CLEAR        _AUDIOIOC(18)
+#define AUDIOIOC_GRAPH_GETSTATS     _AUDIOIOC(19)
 
 /* Audio Device Types *******************************************************/
 /* The Tinyara audio interface support different types of audio devices for
@@ -438,6 +455,28 @@ struct audio_buf_desc_s {
 	} u;
 };
 
+/* A processing node of the audio graph.  For each buffer completed by the
+ * lower half, the graph thread calls the nodes in the order they were added
+ * to prepare the buffer, then enqueues it again.  A node returning a
+ * negative value hands the buffer to the message queue instead.
+ */
+
+typedef CODE int (*audio_graph_process_t)(FAR struct ap_buffer_s *apb, FAR void *arg);
+
+struct audio_graph_node_s {
+	audio_graph_process_t process;	/* Processing callback */
+	FAR void *arg;			/* Its argument */
+};
+
+/* Audio graph statistics, returned by AUDIOIOC_GRAPH_GETSTATS */
+
+struct audio_graph_stats_s {
+	uint32_t periods;		/* Buffers processed by the graph */
+	uint32_t xruns;			/* Times the lower half ran out of buffers */
+	uint32_t lat_last;		/* Completion to re-enqueue of the last buffer, usec */
+	uint32_t lat_max;		/* Worst latency since the last read, usec */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -211,6 +211,30 @@
 
 #define I2S_SEND(d, b, c, a, t) ((d)->ops->i2s_send(d, b, c, a, t))
 
+/* I2S character driver ioctl commands **************************************/
+/* With CONFIG_AUDIO_I2SCHAR_RING the driver owns a ring of periods per
+ * direction, which the application fills or consumes in place:
+ *
+ * I2SCHARIOC_TX_RESERVE - Wait for a free TX period.  Argument: struct
+ *   i2schar_period_s *, which receives the period and its capacity.
+ * I2SCHARIOC_TX_COMMIT - Send the reserved TX period.  Argument: the
+ *   number of bytes written to it.
+ * I2SCHARIOC_RX_RESERVE - Wait for a received period.  Argument: struct
+ *   i2schar_period_s *, which receives the period and the bytes received.
+ *   The first call starts reception into all periods.
+ * I2SCHARIOC_RX_COMMIT - Give the reserved RX period back for reception.
+ *   Argument: none.
+ *
+ * RESERVE fails with EAGAIN on a non-blocking descriptor when no period is
+ * ready, and with EBUSY when a period of that direction is already
+ * reserved.  A failed COMMIT leaves the period reserved.
+ */
+
+#define I2SCHARIOC_TX_RESERVE  _I2SCHARIOC(0x0001)
+#define I2SCHARIOC_TX_COMMIT   _I2SCHARIOC(0x0002)
+#define I2SCHARIOC_RX_RESERVE  _I2SCHARIOC(0x0003)
+#define I2SCHARIOC_RX_COMMIT   _I2SCHARIOC(0x0004)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -219,6 +243,14 @@
 struct i2s_dev_s;
 typedef CODE void (*i2s_callback_t)(FAR struct i2s_dev_s *dev, FAR struct ap_buffer_s *apb, FAR void *arg, int result);
 
+/* A period of the I2S character driver's ring */
+
+struct i2schar_period_s {
+	FAR uint8_t *buffer;		/* The samples */
+	size_t nbytes;			/* TX: capacity, RX: bytes received */
+	int result;			/* Last error of this direction's transfers, 0 if none */
+};
+
 /* The I2S vtable */
 
 struct i2s_ops_s {
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/bootinit.h
+ *
+ * Dependency ordered, parallel board bring-up.  The board describes its
+ * initialization as a table of steps, each naming the steps it depends on,
+ * and bootinit_run() executes every step as soon as its dependencies have
+ * completed, using a small pool of kernel threads so that slow independent
+ * steps (a SMART scan, a firmware download) overlap.  Every step is
+ * recorded in the boot time profile, see <tinyara/boottime.h>.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_BOOTINIT_H
+#define __INCLUDE_TINYARA_BOOTINIT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_BOOTINIT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of steps in one table */
+
+#define BOOTINIT_MAXSTEPS       32
+
+/* Dependency on step number 'n' of the same table */
+
+#define BOOTINIT_DEP(n)         ((uint32_t)1 << (n))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One initialization step */
+
+struct bootinit_step_s {
+	FAR const char *name;		/* Name shown in the timeline */
+	CODE int (*init)(void);		/* Returns OK or a negated errno value */
+	uint32_t deps;				/* BOOTINIT_DEP() set of prerequisite steps */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bootinit_run
+ *
+ * Description:
+ *   Run the 'nsteps' steps of 'steps', each one after all of its
+ *   dependencies, on the calling thread and CONFIG_BOOTINIT_NWORKERS - 1
+ *   helper kernel threads.  A step whose dependency failed still runs; it
+ *   is up to the step to check for what it needs.  Must be called from a
+ *   thread that can wait, i.e. with CONFIG_BOARD_INITTHREAD.
+ *
+ * Returned Value:
+ *   The number of steps that failed, or -EINVAL if the table is too large
+ *   or its dependencies are cyclic, in which case nothing has been run.
+ *
+ ****************************************************************************/
+
+int bootinit_run(FAR const struct bootinit_step_s *steps, int nsteps);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_BOOTINIT */
+#endif							/* __INCLUDE_TINYARA_BOOTINIT_H */
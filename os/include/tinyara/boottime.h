@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/boottime.h
+ *
+ * Boot time profiling.  Milestones along the start-up path and the steps
+ * of the parallel board initialization are time stamped in microseconds
+ * into a static table, so that they can be recorded before the heap or
+ * the system timer exist.  The table is reported in /proc/boottime.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_BOOTTIME_H
+#define __INCLUDE_TINYARA_BOOTTIME_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_BOOTTIME
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One timeline entry.  Milestones have start == end and worker == -1. */
+
+struct boottime_event_s {
+	FAR const char *name;
+	uint32_t start;				/* Microseconds when the step started */
+	uint32_t end;				/* Microseconds when the step completed */
+	int16_t result;				/* Value returned by the step */
+	int8_t worker;				/* Worker that ran the step */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: boottime_now
+ *
+ * Description:
+ *   Return the time since boot in microseconds, from up_boottime() if the
+ *   architecture has a counter running from reset, from the system timer
+ *   otherwise (zero until clock_initialize()).
+ *
+ ****************************************************************************/
+
+uint32_t boottime_now(void);
+
+/****************************************************************************
+ * Name: boottime_mark
+ *
+ * Description:
+ *   Record a milestone at the current time.  'name' must stay valid for the
+ *   lifetime of the system.  May be called from the very start of
+ *   os_start() and from any context.
+ *
+ ****************************************************************************/
+
+void boottime_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: boottime_record
+ *
+ * Description:
+ *   Record a step that started at 'start' (from boottime_now()) and ends
+ *   now, with its result and the worker that ran it.
+ *
+ ****************************************************************************/
+
+void boottime_record(FAR const char *name, uint32_t start, int result, int worker);
+
+/****************************************************************************
+ * Name: boottime_timeline
+ *
+ * Description:
+ *   Return the timeline and its number of entries in 'nevents'.
+ *
+ ****************************************************************************/
+
+FAR const struct boottime_event_s *boottime_timeline(FAR int *nevents);
+
+/****************************************************************************
+ * Name: up_boottime
+ *
+ * Description:
+ *   Provided by architectures that select ARCH_HAVE_BOOTTIME.  Return the
+ *   microseconds elapsed since the counter was first read; the first call
+ *   starts the counter.  Must work before the OS is initialized.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_BOOTTIME
+uint32_t up_boottime(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#else							/* CONFIG_BOOTTIME */
+
+#define boottime_now()                  0
+#define boottime_mark(n)
+#define boottime_record(n, s, r, w)     ((void)(s))
+
+#endif							/* CONFIG_BOOTTIME */
+#endif							/* __INCLUDE_TINYARA_BOOTTIME_H */
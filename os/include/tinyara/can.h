@@ -64,6 +64,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#ifdef CONFIG_CAN_TIMESTAMP
+#include <time.h>
+#endif
 
 #include <tinyara/fs/fs.h>
 
@@ -77,8 +80,12 @@
  *   CONFIG_STM32_CAN2 must also be defined)
  * CONFIG_CAN_EXTID - Enables support for the 29-bit extended ID.  Default
  *   Standard 11-bit IDs.
- * CONFIG_CAN_FIFOSIZE - The size of the circular buffer of CAN messages.
- *   Default: 8
+ * CONFIG_CAN_FIFOSIZE - The size of the circular buffer of outgoing CAN
+ *   messages.  Default: 8
+ * CONFIG_CAN_RXFIFOSIZE - The size of the ring of received CAN messages.  Must
+ *   be a power of two.  Default: 32
+ * CONFIG_CAN_TIMESTAMP - Record the time of reception in the header of each
+ *   received message.
  * CONFIG_CAN_NPENDINGRTR - The size of the list of pending RTR requests.
  *   Default: 4
  * CONFIG_CAN_LOOPBACK - A CAN driver may or may not support a loopback
@@ -98,6 +105,17 @@
 #define CONFIG_CAN_FIFOSIZE 255
 #endif
 
+#if !defined(CONFIG_CAN_RXFIFOSIZE)
+#define CONFIG_CAN_RXFIFOSIZE 32
+#elif CONFIG_CAN_RXFIFOSIZE > 4096
+#undef  CONFIG_CAN_RXFIFOSIZE
+#define CONFIG_CAN_RXFIFOSIZE 4096
+#endif
+
+#if (CONFIG_CAN_RXFIFOSIZE & (CONFIG_CAN_RXFIFOSIZE - 1)) != 0
+#error "CONFIG_CAN_RXFIFOSIZE must be a power of two"
+#endif
+
 #if !defined(CONFIG_CAN_NPENDINGRTR)
 #define CONFIG_CAN_NPENDINGRTR 4
 #elif CONFIG_CAN_NPENDINGRTR > 255
@@ -117,6 +135,8 @@
 #define dev_send(dev, m)            dev->cd_ops->co_send(dev, m)
 #define dev_txready(dev)            dev->cd_ops->co_txready(dev)
 #define dev_txempty(dev)            dev->cd_ops->co_txempty(dev)
+#define dev_addfilter(dev, f)       dev->cd_ops->co_addfilter(dev, f)
+#define dev_delfilter(dev, ndx)     dev->cd_ops->co_delfilter(dev, ndx)
 
 /* CAN message support */
 
@@ -133,11 +153,22 @@
 
 #define CANIOCTL_RTR              1	/* Argument is a reference to struct canioctl_rtr_s */
 
+/* CANIOCTL_ADDFILTER: Install a hardware acceptance filter.  Argument is a
+ *   reference to struct canioctl_filter_s.  Returns the index of the filter
+ *   slot used, or -ENOTTY if the hardware has no acceptance filters.  Once any
+ *   filter is installed only messages matching one of the filters are
+ *   received.
+ * CANIOCTL_DELFILTER: Remove the filter at the index given as the argument.
+ */
+
+#define CANIOCTL_ADDFILTER        2	/* Argument is a reference to struct canioctl_filter_s */
+#define CANIOCTL_DELFILTER        3	/* Argument is the index returned by CANIOCTL_ADDFILTER */
+
 /* CANIOCTL_USER: Device specific ioctl calls can be supported with cmds greater
  * than this value
  */
 
-#define CANIOCTL_USER             2
+#define CANIOCTL_USER             4
 
 /************************************************************************************
  * Public Types
@@ -166,6 +197,9 @@
  *               Bits 6-7: Unused
  *   Bytes 5-12: CAN data
  *
+ * With CONFIG_CAN_TIMESTAMP the header is followed by a struct timespec holding
+ * the time at which the message was received.  It is ignored on write().
+ *
  * The struct can_msg_s holds this information in a user-friendly, unpacked form.
  * This is the form that is used at the read() and write() driver interfaces.  The
  * message structure is actually variable length -- the true length is given by
@@ -179,12 +213,18 @@ struct can_hdr_s {
 	uint8_t ch_rtr:1;			/* RTR indication */
 	uint8_t ch_extid:1;			/* Extended ID indication */
 	uint8_t ch_unused:2;		/* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+	struct timespec ch_ts;		/* Time of reception */
+#endif
 } packed_struct;
 #else
 struct can_hdr_s {
 	uint16_t ch_dlc:4;			/* 4-bit DLC */
 	uint16_t ch_rtr:1;			/* RTR indication */
 	uint16_t ch_id:11;			/* 11-bit standard ID */
+#ifdef CONFIG_CAN_TIMESTAMP
+	struct timespec ch_ts;		/* Time of reception */
+#endif
 } packed_struct;
 #endif
 
@@ -193,14 +233,18 @@ struct can_msg_s {
 	uint8_t cm_data[CAN_MAXDATALEN];	/* CAN message data (0-8 byte) */
 } packed_struct;
 
-/* This structure defines a CAN message FIFO. */
+/* This structure defines the ring of received CAN messages.  The indices run
+ * freely and are masked on access; rx_tail is only advanced by can_receive()
+ * and can_receivev() and rx_head only by the reader, so neither side needs to lock the other out.
+ */
 
 struct can_rxfifo_s {
-	sem_t rx_sem;				/* Counting semaphore */
-	uint8_t rx_head;			/* Index to the head [IN] in the circular buffer */
-	uint8_t rx_tail;			/* Index to the tail [OUT] in the circular buffer */
-	/* Circular buffer of CAN messages */
-	struct can_msg_s rx_buffer[CONFIG_CAN_FIFOSIZE];
+	sem_t rx_sem;				/* Wakes up readers waiting for a message */
+	volatile uint16_t rx_head;	/* Index to the head [OUT] in the ring */
+	volatile uint16_t rx_tail;	/* Index to the tail [IN] in the ring */
+	uint32_t rx_dropped;		/* Messages dropped because the ring was full */
+	/* Ring of CAN messages */
+	struct can_msg_s rx_buffer[CONFIG_CAN_RXFIFOSIZE];
 };
 
 struct can_txfifo_s {
@@ -222,10 +266,12 @@ struct can_rtrwait_s {
 
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
- * caller of can_register().
+ * caller of can_register(), except the acceptance filter methods which may be
+ * NULL if the hardware has no filters.
  */
 
 struct can_dev_s;
+struct canioctl_filter_s;
 struct can_ops_s {
 	/* Reset the CAN device.  Called early to initialize the hardware. This
 	 * is called, before co_setup() and on error conditions.
@@ -278,6 +324,16 @@ struct can_ops_s {
 	 */
 
 	CODE bool(*co_txempty)(FAR struct can_dev_s *dev);
+
+	/* Install a hardware acceptance filter.  Returns the index of the filter
+	 * slot used or a negated errno (-ENOSPC when all slots are in use).
+	 */
+
+	CODE int (*co_addfilter)(FAR struct can_dev_s *dev, FAR const struct canioctl_filter_s *filter);
+
+	/* Remove the hardware acceptance filter in the given slot */
+
+	CODE int (*co_delfilter)(FAR struct can_dev_s *dev, int ndx);
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -293,8 +349,9 @@ struct can_dev_s {
 	uint8_t cd_ocount;			/* The number of times the device has been opened */
 	uint8_t cd_npendrtr;		/* Number of pending RTR messages */
 	uint8_t cd_ntxwaiters;		/* Number of threads waiting to enqueue a message */
+	uint8_t cd_nrxwaiters;		/* Number of threads waiting for a message */
 	sem_t cd_closesem;			/* Locks out new opens while close is in progress */
-	sem_t cd_recvsem;			/* Used to wakeup user waiting for space in cd_recv.buffer */
+	sem_t cd_recvsem;			/* Serializes readers of cd_recv */
 	struct can_txfifo_s cd_xmit;	/* Describes transmit FIFO */
 	struct can_rxfifo_s cd_recv;	/* Describes receive FIFO */
 	/* List of pending RTR requests */
@@ -310,6 +367,14 @@ struct canioctl_rtr_s {
 	FAR struct can_msg_s *ci_msg;	/* The location to return the RTR response */
 };
 
+/* A message is accepted by a filter when (ID & cf_mask) == (cf_id & cf_mask) */
+
+struct canioctl_filter_s {
+	uint32_t cf_id;				/* The 11- or 29-bit ID to match */
+	uint32_t cf_mask;			/* The ID bits that must match */
+	uint8_t cf_extid;			/* Match extended (1) or standard (0) IDs */
+};
+
 /************************************************************************************
  * Public Data
  ************************************************************************************/
@@ -354,6 +419,27 @@ EXTERN int can_register(FAR const char *path, FAR struct can_dev_s *dev);
 
 EXTERN int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr, FAR uint8_t *data);
 
+/************************************************************************************
+ * Name: can_receivev
+ *
+ * Description:
+ *   Called from the CAN interrupt handler to hand over all messages drained from
+ *   a hardware receive FIFO at once.  The messages share one timestamp and the
+ *   reader is woken up at most once.
+ *
+ * Parameters:
+ *   dev   - The specific CAN device
+ *   msgs  - The received messages
+ *   nmsgs - The number of messages in msgs
+ *
+ * Return:
+ *   The number of messages accepted; the rest were dropped because the receive
+ *   ring was full.
+ *
+ ************************************************************************************/
+
+EXTERN int can_receivev(FAR struct can_dev_s *dev, FAR const struct can_msg_s *msgs, int nmsgs);
+
 /************************************************************************************
  * Name: can_txdone
  *
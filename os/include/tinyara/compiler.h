@@ -131,6 +131,30 @@
 #define inline_function __attribute__ ((always_inline, no_instrument_function))
 #define noinline_function __attribute__ ((noinline))
 
+/* The ramfunc_function attribute places a hot function in the .ramfunc
+ * section, which the start-up logic copies to internal SRAM when
+ * CONFIG_ARCH_RAMFUNCS is selected.  Unlike the architecture's __ramfunc__
+ * it can go on functions whose callers do not see it; the linker adds
+ * veneers for the calls between FLASH and RAM that are out of branch range.
+ */
+
+#ifdef CONFIG_ARCH_RAMFUNCS
+#define ramfunc_function __attribute__ ((section(".ramfunc"), noinline))
+#else
+#define ramfunc_function
+#endif
+
+/* The noinit_data attribute places a variable in the .noinit section, which
+ * is neither loaded nor cleared at start-up, so its contents survive a warm
+ * reset.  Only boards that select CONFIG_ARCH_HAVE_NOINIT provide it.
+ */
+
+#ifdef CONFIG_ARCH_HAVE_NOINIT
+#define noinit_data __attribute__ ((section(".noinit")))
+#else
+#define noinit_data
+#endif
+
 /* GCC has does not use storage classes to qualify addressing */
 
 #define FAR
@@ -277,6 +301,8 @@
 
 #define inline_function
 #define noinline_function
+#define ramfunc_function
+#define noinit_data
 
 /* The reentrant attribute informs SDCC that the function
  * must be reentrant.  In this case, SDCC will store input
@@ -379,6 +405,8 @@
 #define naked_function
 #define inline_function
 #define noinline_function
+#define ramfunc_function
+#define noinit_data
 
 /* REVISIT: */
 
@@ -469,6 +497,8 @@
 #define naked_function
 #define inline_function
 #define noinline_function
+#define ramfunc_function
+#define noinit_data
 
 #define FAR
 #define NEAR
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_EVENT_H
+#define __INCLUDE_TINYARA_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <time.h>
+
+#ifdef CONFIG_EVENT_GROUPS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of event_wait() and event_timedwait() */
+
+#define EVENT_WAITALL   (1 << 0)	/* Wait for all the events, not any of them */
+#define EVENT_CLEAR     (1 << 1)	/* Clear the awaited events on return */
+
+/* Initializer of a statically allocated event group */
+
+#define EVENT_INITIALIZER { 0, { NULL, NULL } }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef uint32_t event_set_t;
+
+/* An event group.  A task waits until any or all of the events it asks for
+ * are posted.  The waiters are queued on the group itself, so that posting
+ * does not allocate and only wakes the tasks whose condition is met.
+ */
+
+struct event_s {
+	volatile event_set_t set;	/* The posted events */
+	dq_queue_t waitlist;		/* Tasks waiting for events */
+};
+
+typedef struct event_s event_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: event_init
+ *
+ * Description:
+ *   Initialize an event group with no event posted.
+ *
+ ****************************************************************************/
+
+int event_init(FAR event_t *event);
+
+/****************************************************************************
+ * Name: event_destroy
+ *
+ * Description:
+ *   Destroy an event group.  Fails with EBUSY while tasks wait on it.
+ *
+ ****************************************************************************/
+
+int event_destroy(FAR event_t *event);
+
+/****************************************************************************
+ * Name: event_post
+ *
+ * Description:
+ *   Post the events 'set' and wake the tasks whose wait is satisfied.  May
+ *   be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int event_post(FAR event_t *event, event_set_t set);
+
+/****************************************************************************
+ * Name: event_clear
+ *
+ * Description:
+ *   Clear the events 'set' without waking anybody.
+ *
+ ****************************************************************************/
+
+int event_clear(FAR event_t *event, event_set_t set);
+
+/****************************************************************************
+ * Name: event_wait and event_timedwait
+ *
+ * Description:
+ *   Wait until any of the events 'set' is posted, or all of them with
+ *   EVENT_WAITALL.  With EVENT_CLEAR the awaited events are cleared before
+ *   returning.  The events posted at wake up are returned in 'result' if it
+ *   is not NULL.  event_timedwait() fails with ETIMEDOUT once the absolute
+ *   CLOCK_REALTIME time 'abstime' has passed.
+ *
+ * Returned Value:
+ *   OK, or ERROR with errno set to EINVAL, EINTR or ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+int event_wait(FAR event_t *event, event_set_t set, int flags, FAR event_set_t *result);
+int event_timedwait(FAR event_t *event, event_set_t set, int flags, FAR const struct timespec *abstime, FAR event_set_t *result);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_EVENT_GROUPS */
+#endif							/* __INCLUDE_TINYARA_EVENT_H */
@@ -98,6 +98,17 @@ struct fs_romfsdir_s {
 };
 #endif							/* CONFIG_FS_ROMFS */
 
+#ifdef CONFIG_FS_CROMFS
+/* For CROMFS, we need the offsets of the first and the next node of the
+ * directory
+ */
+
+struct fs_cromfsdir_s {
+	uint32_t cr_firstoffset;	/* Offset of the first node in the directory */
+	uint32_t cr_curroffset;		/* Offset of the next node to read, 0 at the end */
+};
+#endif							/* CONFIG_FS_CROMFS */
+
 #ifdef CONFIG_FS_SMARTFS
 /* SMARTFS is the Sector Mapped Allocation for Really Tiny FLASH filesystem.
  * it is designed to use small sectors on small serial FLASH devices, using
@@ -151,6 +162,9 @@ struct fs_dirent_s {
 #ifdef CONFIG_FS_ROMFS
 		struct fs_romfsdir_s romfs;
 #endif
+#ifdef CONFIG_FS_CROMFS
+		struct fs_cromfsdir_s cromfs;
+#endif
 #ifdef CONFIG_FS_PROCFS
 		FAR void *procfs;
 #endif
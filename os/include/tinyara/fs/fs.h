@@ -82,6 +82,7 @@
 #define __FS_FLAG_ERROR (1 << 1)	/* Error detected by any operation */
 #define __FS_FLAG_LBF   (1 << 2)       /* Line buffered */
 #define __FS_FLAG_UBF   (1 << 3)       /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_NOLOCK (1 << 4)      /* Caller locks, see __fsetlocking() */
 #ifndef CONFIG_MOUNT_POINT
 #define CONFIG_MOUNT_POINT "/mnt/"
 #endif
@@ -278,8 +279,11 @@ struct file {
 /* This defines a list of files indexed by the file descriptor */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#define FILELIST_NWORDS ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
 struct filelist {
 	sem_t fl_sem;				/* Manage access to the file list */
+	uint32_t fl_free[FILELIST_NWORDS];	/* Set bits are descriptors believed free */
 	struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
 };
 #endif
@@ -771,6 +775,22 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
 ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf, size_t nbytes, off_t offset);
 #endif
 
+/* fs/fs_poll.c *************************************************************/
+/****************************************************************************
+ * Name: fdesc_poll
+ *
+ * Description:
+ *   Set up (or tear down) the poll of one file or socket descriptor, as
+ *   poll() does for each of its descriptors.  Currently used only by
+ *   epoll.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 && !defined(CONFIG_DISABLE_POLL)
+struct pollfd;
+int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
+#endif
+
 /* fs/fs_lseek.c ************************************************************/
 /****************************************************************************
  * Name: file_seek
@@ -94,6 +94,8 @@
 #define _RTCBASE        (0x1800)	/* RTC ioctl commands */
 #define _FOTABASE       (0x1900)	/* FOTA ioctl commands */
 #define _GPIOBASE       (0x2000)	/* GPIO ioctl commands */
+#define _I2SCHARBASE    (0x2100)	/* I2S character driver ioctl commands */
+#define _MTDLOGIOCBASE  (0x2200)	/* MTD log store ioctl commands */
 
 /* boardctl() commands share the same number space */
 #define _BOARDBASE      (0xff00)	/* boardctl commands */
@@ -230,6 +232,24 @@
 										 *      the block with specific debug
 										 *      command and data.
 										 * OUT: None.  */
+#define BIOC_FLUSH      _BIOC(0x000C)	/* Write any data cached by the block
+										 * device to the media.
+										 * IN:  None
+										 * OUT: None (ioctl return value provides
+										 *      success/failure indication). */
+#define BIOC_READSECTS  _BIOC(0x000D)	/* Read a run of consecutive logical
+										 * sectors from the block device.
+										 * IN:  Pointer to the read request (the
+										 *      first logical sector, number of
+										 *      sectors, count and read buffer
+										 *      address)
+										 * OUT: Number of sectors read or error */
+#define BIOC_GCWATERMARK _BIOC(0x000E)	/* Set the free sector watermarks of
+										 * the background garbage collection.
+										 * IN:  Pointer to the watermarks (low
+										 *      and high, in sectors)
+										 * OUT: None (ioctl return value provides
+										 *      success/failure indication). */
 
 /* TinyAra MTD driver ioctl definitions ***************************************/
 
@@ -250,6 +270,13 @@
 											 * OUT: None */
 #define MTDIOC_SETSPEED   _MTDIOC(0x0004)	/* IN:  New bus speed in Hz
 											 * OUT: None */
+#define MTDIOC_RDLATENCY  _MTDIOC(0x0005)	/* IN:  Pointer to uint32_t in which
+											 *      to receive the latency
+											 * OUT: Worst case time in microseconds
+											 *      that a read can be held off by a
+											 *      program or erase in progress.
+											 *      -ENOTTY if reads always wait for
+											 *      the operation to complete */
 
 /* TinyAra ARP driver ioctl definitions (see include/netinet/arp.h) *******************/
 
@@ -304,6 +331,12 @@
 #define _CFGDIOCVALID(c)   (_IOC_TYPE(c) == _CFGDIOCBASE)
 #define _CFGDIOC(nr)       _IOC(_CFGDIOCBASE, nr)
 
+/* MTD log store driver ioctl definitions ***********************************/
+/* (see include/tinyara/fs/mtdlog.h */
+
+#define _MTDLOGIOCVALID(c) (_IOC_TYPE(c) == _MTDLOGIOCBASE)
+#define _MTDLOGIOC(nr)     _IOC(_MTDLOGIOCBASE, nr)
+
 /* Timer driver ioctl commands **********************************************/
 /* (see include/tinyara/timer.h */
 
@@ -321,6 +354,12 @@
 											 *       (default)
 											 *     1=fre when empty
 											 * OUT: None */
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0002)	/* Resize the buffer
+											 * IN: New size in bytes
+											 * OUT: None (returns the new size) */
+#define PIPEIOC_GETSIZE    _PIPEIOC(0x0003)	/* Get the buffer size
+											 * IN: None
+											 * OUT: None (returns the size) */
 /* RTC driver ioctl definitions *********************************************/
 /* (see include/tinyara/rtc.h */
 
@@ -340,6 +379,11 @@
 #define _GPIOIOCVALID(c)   (_IOC_TYPE(c) == _GPIOBASE)
 #define _GPIOIOC(nr)       _IOC(_GPIOBASE, nr)
 
+/* I2S character driver ioctl definitions ***********************************/
+/* (see include/tinyara/audio/i2s.h */
+#define _I2SCHARIOCVALID(c) (_IOC_TYPE(c) == _I2SCHARBASE)
+#define _I2SCHARIOC(nr)     _IOC(_I2SCHARBASE, nr)
+
 /* boardctl() command definitions *******************************************/
 #define _BOARDIOCVALID(c)  (_IOC_TYPE(c) == _BOARDBASE)
 #define _BOARDIOC(nr)      _IOC(_BOARDBASE, nr)
@@ -74,6 +74,8 @@
 #define MTD_READ(d, s, n, b)   ((d)->read   ? (d)->read(d, s, n, b)   : (-ENOSYS))
 #define MTD_WRITE(d, s, n, b)  ((d)->write  ? (d)->write(d, s, n, b)  : (-ENOSYS))
 #define MTD_IOCTL(d, c, a)     ((d)->ioctl  ? (d)->ioctl(d, c, a)     : (-ENOSYS))
+#define MTD_BREADV(d, v, n)    ((d)->breadv  ? (d)->breadv(d, v, n)  : mtd_breadv(d, v, n))
+#define MTD_BWRITEV(d, v, n)   ((d)->bwritev ? (d)->bwritev(d, v, n) : mtd_bwritev(d, v, n))
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD)
 #define CONFIG_MTD_REGISTRATION   1
@@ -106,6 +108,14 @@ struct mtd_byte_write_s {
 	const uint8_t *buffer;		/* Pointer to the data to write */
 };
 
+/* One range of R/W blocks of a vectored block transfer */
+
+struct mtd_iovec_s {
+	off_t startblock;			/* First R/W block of the range */
+	size_t nblocks;				/* Number of R/W blocks in the range */
+	FAR uint8_t *buffer;		/* Data of the range */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -147,6 +157,15 @@ struct mtd_dev_s {
 	 */
 
 	int (*ioctl)(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
+
+	/* Read/write a list of block ranges as one request (optional).  Drivers
+	 * can issue the whole list back to back without releasing the bus.  The
+	 * return value is the total number of blocks transferred.  Without them
+	 * MTD_BREADV()/MTD_BWRITEV() fall back to one bread/bwrite per range.
+	 */
+
+	ssize_t (*breadv)(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
+	ssize_t (*bwritev)(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
 #ifdef CONFIG_MTD_REGISTRATION
 	/* An assigned MTD number for procfs reporting */
 
@@ -189,6 +208,24 @@ extern "C" {
 
 /* MTD Support **************************************************************/
 
+/****************************************************************************
+ * Name: mtd_breadv, mtd_bwritev
+ *
+ * Description:
+ *   Transfer a list of block ranges with one bread/bwrite call per range.
+ *   This is the fallback of MTD_BREADV()/MTD_BWRITEV() for drivers without
+ *   vectored methods.
+ *
+ * Returned Value:
+ *   The total number of blocks transferred.  It is short if a range failed
+ *   after others had been transferred; a negated errno value if the first
+ *   range failed.
+ *
+ ****************************************************************************/
+
+ssize_t mtd_breadv(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
+ssize_t mtd_bwritev(FAR struct mtd_dev_s *dev, FAR const struct mtd_iovec_s *iov, int iovcnt);
+
 /****************************************************************************
  * Name: mtd_partition
  *
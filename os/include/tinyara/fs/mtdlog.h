@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/fs/mtdlog.h
+ *
+ * Append-only circular record log stored directly on an MTD device or
+ * partition.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_FS_MTDLOG_H
+#define __INCLUDE_TINYARA_FS_MTDLOG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <tinyara/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+/* write() appends one record, time stamped with CLOCK_REALTIME.  read()
+ * returns one record per call:  a struct mtdlog_rec_s followed by the
+ * payload.  Records are read from the oldest one still stored unless a
+ * time range was set.  Appended records are buffered in RAM until a flash
+ * page is full, the MTDLOGIOC_FLUSH command is issued or a writer closes
+ * the device.
+ *
+ * MTDLOGIOC_APPEND - Append a record with a caller supplied time stamp.
+ *
+ *   ioctl argument:  Pointer to a struct mtdlog_append_s.
+ *
+ * MTDLOGIOC_FLUSH - Write the buffered records to flash.
+ *
+ *   ioctl argument:  None.
+ *
+ * MTDLOGIOC_SETRANGE - Restrict read() to records time stamped within a
+ *   range and move the read position to the start of the range.  read()
+ *   returns 0 after the last record of the range.
+ *
+ *   ioctl argument:  Pointer to a struct mtdlog_range_s.
+ *
+ * MTDLOGIOC_REWIND - Clear the time range and read from the oldest record.
+ *
+ *   ioctl argument:  None.
+ *
+ * MTDLOGIOC_INFO - Get the state of the log.
+ *
+ *   ioctl argument:  Pointer to a struct mtdlog_info_s.
+ */
+
+#define MTDLOGIOC_APPEND    _MTDLOGIOC(1)
+#define MTDLOGIOC_FLUSH     _MTDLOGIOC(2)
+#define MTDLOGIOC_SETRANGE  _MTDLOGIOC(3)
+#define MTDLOGIOC_REWIND    _MTDLOGIOC(4)
+#define MTDLOGIOC_INFO      _MTDLOGIOC(5)
+
+/* Time stamp of a record in milliseconds */
+
+#define MTDLOG_TIME(sec, msec) ((uint64_t)(sec) * 1000 + (msec))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Header of a record, as stored on flash and as returned by read() */
+
+struct mtdlog_rec_s {
+	uint16_t len;				/* Payload length in bytes */
+	uint16_t msec;				/* Time stamp: milliseconds */
+	uint32_t seq;				/* Sequence number of the record */
+	uint32_t sec;				/* Time stamp: seconds */
+	uint32_t crc;				/* CRC-32 of the fields above and the payload */
+};
+
+/* Argument of MTDLOGIOC_APPEND */
+
+struct mtdlog_append_s {
+	uint32_t sec;				/* Time stamp: seconds */
+	uint16_t msec;				/* Time stamp: milliseconds */
+	uint16_t len;				/* Payload length in bytes */
+	FAR const void *data;		/* Payload */
+};
+
+/* Argument of MTDLOGIOC_SETRANGE.  Both ends are inclusive and given in
+ * milliseconds (see MTDLOG_TIME()).
+ */
+
+struct mtdlog_range_s {
+	uint64_t start;
+	uint64_t end;
+};
+
+/* Argument of MTDLOGIOC_INFO */
+
+struct mtdlog_info_s {
+	uint32_t nsegments;			/* Number of erase blocks in the ring */
+	uint32_t segsize;			/* Size of an erase block */
+	uint32_t pagesize;			/* Size of a write block */
+	uint32_t maxrecord;			/* Largest payload of a record */
+	uint32_t oldest;			/* Sequence number of the oldest record */
+	uint32_t next;				/* Sequence number of the next record */
+	uint32_t minerase;			/* Least erase count of the erase blocks */
+	uint32_t maxerase;			/* Largest erase count of the erase blocks */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mtdlog_register
+ *
+ * Description:
+ *   Bind an MTD device or partition to /dev/mtdlogN.  The log found on the
+ *   device is recovered:  segments and records with a bad CRC are skipped
+ *   and appending continues after the last valid record.  A device without
+ *   a log is used from scratch.
+ *
+ * Input parameters:
+ *   minor - The minor device number N
+ *   mtd   - The MTD device holding the log
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mtdlog_register(int minor, FAR struct mtd_dev_s *mtd);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __INCLUDE_TINYARA_FS_MTDLOG_H */
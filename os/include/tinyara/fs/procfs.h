@@ -58,6 +58,9 @@
  ****************************************************************************/
 
 #include <tinyara/config.h>
+
+#include <stdint.h>
+
 #include <tinyara/fs/fs.h>
 
 /****************************************************************************
@@ -136,6 +139,51 @@ struct procfs_dir_priv_s {
 		*procfsentry;				/* Pointer to procfs handler entry */
 };
 
+/* /proc/tasks is a binary file: a struct procfs_tasks_hdr_s followed by
+ * ntasks records of recsize bytes each, one per task/thread, all taken in a
+ * single pass over the task list.  Readers should check the magic and use
+ * hdrsize and recsize to step through the file, as the records grow at the
+ * end when fields are added.  Reading the file again from offset zero
+ * after a read takes a new snapshot, so a poller can keep it open.
+ */
+
+#define PROCFS_TASKS_MAGIC      0x6b736174	/* "task" */
+#define PROCFS_TASKS_VERSION    1
+
+/* Which of the optional record fields are valid (procfs_tasks_hdr_s flags) */
+
+#define PROCFS_TASKS_CPULOAD    (1 << 0)	/* cpuload_active and cpuload_total */
+#define PROCFS_TASKS_CPUTIME    (1 << 1)	/* cputime */
+#define PROCFS_TASKS_STACKUSED  (1 << 2)	/* stack_used */
+#define PROCFS_TASKS_BASEPRIO   (1 << 3)	/* base_priority */
+
+struct procfs_tasks_hdr_s {
+	uint32_t magic;				/* PROCFS_TASKS_MAGIC */
+	uint16_t version;			/* PROCFS_TASKS_VERSION */
+	uint16_t hdrsize;			/* Size of this header */
+	uint16_t recsize;			/* Size of one struct procfs_task_s */
+	uint16_t ntasks;			/* Number of records following the header */
+	uint32_t flags;				/* See PROCFS_TASKS_* */
+	uint64_t systime;			/* System timer, in ticks, at the snapshot */
+	uint32_t cpuload_total;		/* Ticks in the CPU load measurement window */
+	uint32_t reserved;
+};
+
+struct procfs_task_s {
+	int16_t pid;				/* Task/thread ID */
+	uint16_t flags;				/* TCB_FLAG_* of the thread */
+	uint8_t state;				/* Thread state (tstate_t) */
+	uint8_t priority;			/* Current priority */
+	uint8_t base_priority;		/* Priority before any inheritance */
+	uint8_t reserved;
+	uint32_t stack_size;		/* Size of the stack, in bytes */
+	uint32_t stack_used;		/* Stack high water mark, in bytes */
+	uint32_t cpuload_active;	/* Ticks active in the CPU load window */
+	uint32_t reserved2;
+	uint64_t cputime;			/* CPU time used, in microseconds */
+	char name[CONFIG_TASK_NAME_SIZE + 1];	/* Task/thread name */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
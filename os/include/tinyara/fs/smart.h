@@ -102,6 +102,30 @@ struct smart_read_write_s {
 	const uint8_t *buffer;		/* Pointer to the data to write */
 };
 
+/* The following defines the information for reading a run of consecutive
+ * logical sectors from the device (BIOC_READSECTS).  The buffer must be
+ * able to hold nsectors full device sectors; on return, the first 'count'
+ * data bytes of each sector read are packed at its start.
+ */
+
+struct smart_read_sectors_s {
+	uint16_t logsector;			/* The first logical sector number */
+	uint16_t nsectors;			/* Number of logical sectors to read */
+	uint16_t count;				/* Number of bytes to read per sector */
+	uint8_t *buffer;			/* Pointer to the read buffer */
+};
+
+/* The following defines the free sector watermarks of the background
+ * garbage collection (BIOC_GCWATERMARK).  Collection is scheduled when the
+ * number of free sectors drops below 'low' and goes on until it reaches
+ * 'high'.  A 'low' of zero disables background collection.
+ */
+
+struct smart_gcwatermark_s {
+	uint16_t low;				/* Free sectors that trigger a collection */
+	uint16_t high;				/* Free sectors that end a collection */
+};
+
 /* The following defines the procfs data exchange interface between the
  * SMART MTD and FS layers.
  */
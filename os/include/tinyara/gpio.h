@@ -59,6 +59,7 @@
 
 #include <tinyara/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
@@ -79,6 +80,12 @@
 #define GPIOIOC_SET_DRIVE		_GPIOIOC(0x0002)
 #define GPIOIOC_POLLEVENTS		_GPIOIOC(0x0003)
 #define GPIOIOC_REGISTER		_GPIOIOC(0x0004)
+#define GPIOIOC_READ_EVENTS		_GPIOIOC(0x0005)
+
+/* Number of edges buffered per pin, a power of two */
+#ifndef CONFIG_GPIO_EVENT_NBUFFER
+#define CONFIG_GPIO_EVENT_NBUFFER 32
+#endif
 
 /****************************************************************************
  * Public Types
@@ -121,6 +128,19 @@ struct gpio_notify_s {
 	uint8_t gn_signo;
 };
 
+/* A timestamped edge, as buffered by the lower half */
+struct gpio_event_s {
+	uint32_t ge_usec;	/* Time of the edge in microseconds, wraps around */
+	uint8_t ge_value;	/* GPIO value after the edge */
+};
+
+/* The argument of GPIOIOC_READ_EVENTS, which returns the number of events */
+struct gpio_events_s {
+	FAR struct gpio_event_s *ge_events;	/* Buffer for the events */
+	uint16_t ge_nevents;	/* Size of the buffer */
+	uint16_t ge_dropped;	/* Out: edges lost to a full buffer since the last read */
+};
+
 struct gpio_upperhalf_s;
 typedef CODE void (*gpio_handler_t)(FAR struct gpio_upperhalf_s *upper);
 
@@ -135,6 +155,12 @@ struct gpio_ops_s {
 						int falling, int rising, gpio_handler_t handler);
 	CODE int  (*ioctl)(FAR struct gpio_lowerhalf_s *lower, FAR int cmd,
 					   unsigned long args);
+#ifdef CONFIG_GPIO_EVENT_BUFFER
+	/* Take the buffered edges, oldest first */
+	CODE int  (*read_events)(FAR struct gpio_lowerhalf_s *lower,
+							 FAR struct gpio_event_s *events,
+							 size_t nevents, FAR uint16_t *dropped);
+#endif
 };
 
 struct gpio_lowerhalf_s {
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/hrtimer.h
+ *
+ * High-resolution timers.  Unlike watchdogs, which expire on system ticks,
+ * hrtimers expire at an absolute CLOCK_MONOTONIC time in nanoseconds.  The
+ * pending timers are kept in a binary min-heap and a dedicated hardware
+ * one-shot timer is armed for the earliest one.  Callbacks run in
+ * interrupt context.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_HRTIMER_H
+#define __INCLUDE_TINYARA_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct hrtimer_s;
+typedef CODE void (*hrtimer_callback_t)(FAR struct hrtimer_s *timer);
+
+struct hrtimer_s {
+	uint64_t expiry;			/* CLOCK_MONOTONIC expiry time (ns) */
+	hrtimer_callback_t callback;	/* Called in interrupt context on expiry */
+	FAR void *arg;				/* For use by the callback */
+	int16_t index;				/* Position in the queue, -1 if not pending */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a timer before its first use.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current CLOCK_MONOTONIC time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   (Re-)start a timer to expire at the absolute time 'expiry', as returned
+ *   by hrtimer_now().  A time in the past expires immediately.  May be
+ *   called from the callback of any timer, including this one.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSPC if CONFIG_HRTIMER_NTIMERS timers are already
+ *   pending.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t expiry);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a pending timer.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if the timer was not pending.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_expiration
+ *
+ * Description:
+ *   Called by the architecture from the one-shot timer interrupt.  Runs the
+ *   callbacks of the expired timers and re-arms the one-shot timer.
+ *
+ ****************************************************************************/
+
+void hrtimer_expiration(void);
+
+/****************************************************************************
+ * Architecture interface
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_hrtimer_start
+ *
+ * Description:
+ *   Arm the one-shot timer to call hrtimer_expiration() after 'nsec'
+ *   nanoseconds, rounded up to the timer resolution.  A delay beyond the
+ *   range of the timer may be shortened; hrtimer_expiration() re-arms it.
+ *
+ ****************************************************************************/
+
+void up_hrtimer_start(uint64_t nsec);
+
+/****************************************************************************
+ * Name: up_hrtimer_cancel
+ *
+ * Description:
+ *   Stop the one-shot timer.
+ *
+ ****************************************************************************/
+
+void up_hrtimer_cancel(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_HRTIMER */
+#endif							/* __INCLUDE_TINYARA_HRTIMER_H */
@@ -109,6 +109,7 @@
 									 * is already in use by a driver! */
 #define I2C_TENBIT           0x0704	/* 0 for 7 bit addrs, != 0 for 10 bit */
 #define I2C_RDWR             0x0707	/* Combined R/W transfer (one STOP only) */
+#define I2C_RDWR_BATCH       0x0708	/* Batch of transfers, one STOP each */
 
 #define I2C_FREQUENCY    0X801
 
@@ -265,6 +266,29 @@
 
 #define I2C_TRANSFER(d, m, c) ((d)->ops->transfer(d, m, c))
 
+/****************************************************************************
+ * Name: I2C_BATCH
+ *
+ * Description:
+ *   Perform a list of transfers back to back.  Each one is a sequence of
+ *   messages as for I2C_TRANSFER(), started with a START and completed with
+ *   a STOP, and its slave addresses may differ from those of the others.
+ *   The whole list is an 'atomic' operation.  Optional: use i2c_batch(),
+ *   which falls back to I2C_TRANSFER() when it is not provided.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   xfers - The transfers; the result of each one is stored in it
+ *   count - The number of transfers
+ *
+ * Returned Value:
+ *   OK once every transfer has been attempted; a negated errno if the list
+ *   could not be run.  -ENOSYS requests the fallback.
+ *
+ ****************************************************************************/
+
+#define I2C_BATCH(d, x, c) ((d)->ops->batch(d, x, c))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -273,6 +297,7 @@
 
 struct i2c_dev_s;
 struct i2c_msg_s;
+struct i2c_xfer_s;
 struct i2c_ops_s {
 	uint32_t (*setfrequency)(FAR struct i2c_dev_s *dev, uint32_t frequency);
 	int (*setaddress)(FAR struct i2c_dev_s *dev, int addr, int nbits);
@@ -285,6 +310,9 @@ struct i2c_ops_s {
 #ifdef CONFIG_I2C_TRANSFER
 	int (*transfer)(FAR struct i2c_dev_s *dev, FAR struct i2c_msg_s *msgs, int count);
 #endif
+#ifdef CONFIG_I2C_BATCH
+	int (*batch)(FAR struct i2c_dev_s *dev, FAR struct i2c_xfer_s *xfers, int count);
+#endif
 #ifdef CONFIG_I2C_SLAVE
 	int (*setownaddress)(FAR struct i2c_dev_s *dev, int addr, int nbits);
 
@@ -328,6 +356,24 @@ struct i2c_rdwr_ioctl_data_s {
 };
 #endif
 
+#ifdef CONFIG_I2C_BATCH
+/* One transfer of a batch: its messages, then a STOP */
+
+struct i2c_xfer_s {
+	FAR struct i2c_msg_s *msgs;
+	int nmsgs;
+	int result;					/* Out: messages transferred or a negated errno */
+};
+
+#ifdef CONFIG_I2C_USERIO
+/* I2C batch data. Used in RDWR_BATCH ioctl */
+struct i2c_batch_ioctl_data_s {
+	struct i2c_xfer_s *xfers;
+	uint32_t nxfers;
+};
+#endif
+#endif
+
 /* I2C private data.  This structure only defines the initial fields of the
  * structure visible to the I2C client.  The specific implementation may
  * add additional, device specific fields after the vtable.
@@ -467,6 +513,27 @@ int i2c_write(FAR struct i2c_dev_s *dev, FAR const struct i2c_config_s *config,
 int i2c_read(FAR struct i2c_dev_s *dev, FAR const struct i2c_config_s *config, FAR uint8_t *buffer, int buflen);
 #endif
 
+/****************************************************************************
+ * Name: i2c_batch
+ *
+ * Description:
+ *   Perform a list of transfers with I2C_BATCH(), or with one I2C_TRANSFER()
+ *   each if the driver does not provide batch().
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   xfers - The transfers; the result of each one is stored in it
+ *   count - The number of transfers
+ *
+ * Returned Value:
+ *   OK once every transfer has been attempted; a negated errno otherwise
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_BATCH
+int i2c_batch(FAR struct i2c_dev_s *dev, FAR struct i2c_xfer_s *xfers, int count);
+#endif
+
 #ifdef CONFIG_I2C_USERIO
 int i2c_uioregister(FAR const char *path, FAR struct i2c_dev_s *dev);
 #endif
@@ -74,6 +74,12 @@
 #else
 #define irq_detach(irq) irq_attach(irq, NULL, NULL)
 #endif
+
+/* Returned by the top half of a threaded interrupt to run its bottom half */
+
+#ifdef CONFIG_IRQ_THREAD
+#define IRQ_WAKE_THREAD 1
+#endif
 #endif
 /****************************************************************************
  * Public Types
@@ -120,6 +126,38 @@ int irq_attach_withname(int irq, xcpt_t isr, FAR void *arg, const char *name);
 int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 #endif
 
+#ifdef CONFIG_IRQ_THREAD
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded handler to IRQ number 'irq'.  'isr' runs in interrupt
+ *   context and must quiet the interrupt source; it returns IRQ_WAKE_THREAD
+ *   to have 'thread' run in a kernel thread of the given priority, or OK
+ *   when there is nothing more to do.  If 'isr' is NULL, the interrupt is
+ *   disabled in the interrupt controller until 'thread' has run.  A
+ *   'stacksize' of zero selects CONFIG_IRQ_THREAD_STACKSIZE.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int priority, int stacksize);
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a handler attached by irq_attach_thread() and stop its thread.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq);
+
+#endif
+
 #ifdef CONFIG_DEBUG_IRQ_INFO
 
 /****************************************************************************
@@ -150,6 +150,11 @@ extern "C" {
 #define kmm_free(p)            free(p)
 #define kmm_mallinfo()         mallinfo()
 
+#ifdef CONFIG_MM_REGION_POLICY
+#define kmm_setregiontag(r, t) umm_setregiontag(r, t)
+#define kmm_malloc_fast(s)     umm_malloc_fast(s)
+#endif
+
 #elif !defined(CONFIG_MM_KERNEL_HEAP)
 /* If this the kernel phase of a kernel build, and there are only user-space
  * allocators, then the following are defined in userspace.h as macros that
@@ -314,6 +314,26 @@ FAR struct lcd_dev_s *ili9341_initialize(FAR struct ili9341_lcd_s *lcd, int devn
  **************************************************************************************/
 
 int ili9341_clear(FAR struct lcd_dev_s *dev, uint16_t color);
+
+/**************************************************************************************
+ * Name:  ili9341_flush
+ *
+ * Description:
+ *   This is a non-standard LCD interface.  With CONFIG_LCD_ILI9341_FRAMEBUFFER the
+ *   runs written to the display are collected in RAM, and this sends the region
+ *   changed since the last flush.  Otherwise it does nothing.
+ *
+ * Parameter:
+ *   dev   - A reference to the lcd driver structure
+ *
+ * Returned Value:
+ *
+ *  On success - OK
+ *  On error   - -EINVAL
+ *
+ **************************************************************************************/
+
+int ili9341_flush(FAR struct lcd_dev_s *dev);
 #undef EXTERN
 #ifdef __cplusplus
 }
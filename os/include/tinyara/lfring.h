@@ -0,0 +1,332 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Lock-free single-producer/single-consumer byte ring.
+ *
+ * The producer only writes 'head' and the consumer only writes 'tail', so
+ * one side may run in an interrupt handler while the other runs in a task
+ * without disabling interrupts.  Several producers (or consumers) must be
+ * serialized by the caller, e.g. with a semaphore or sched_lock() for
+ * tasks; the ring itself never blocks.
+ *
+ * Both indices run over [0, 2 * size): the ring is empty when they are
+ * equal and full when they are 'size' apart.  All 'size' bytes are thus
+ * usable and 'size' need not be a power of two.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_LFRING_H
+#define __INCLUDE_TINYARA_LFRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Order the accesses to the buffer with respect to the index updates.  A
+ * compiler barrier is sufficient between an interrupt handler and a task
+ * on the same core; ARMv7 cores also get a DMB so that the ring may be
+ * shared with other bus masters.
+ */
+
+#if defined(CONFIG_ARCH_CORTEXR4) || defined(CONFIG_ARCH_CORTEXM3) || \
+	defined(CONFIG_ARCH_CORTEXM4)
+#define LFRING_BARRIER() __asm__ __volatile__("dmb" : : : "memory")
+#else
+#define LFRING_BARRIER() __asm__ __volatile__("" : : : "memory")
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct lfring_s {
+	volatile uint32_t head;	/* Next index to write (owned by the producer) */
+	volatile uint32_t tail;	/* Next index to read (owned by the consumer) */
+	uint32_t size;			/* Size of the buffer in bytes */
+	FAR uint8_t *buffer;	/* The ring storage */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lfring_init
+ *
+ * Description:
+ *   Initialize an empty ring over 'size' bytes of storage at 'buffer'.
+ *   Neither side may be using the ring.
+ *
+ ****************************************************************************/
+
+static inline void lfring_init(FAR struct lfring_s *ring, FAR void *buffer, size_t size)
+{
+	ring->head = 0;
+	ring->tail = 0;
+	ring->size = size;
+	ring->buffer = (FAR uint8_t *)buffer;
+}
+
+/****************************************************************************
+ * Name: lfring_reset
+ *
+ * Description:
+ *   Discard the content of the ring.  Neither side may be using the ring.
+ *
+ ****************************************************************************/
+
+static inline void lfring_reset(FAR struct lfring_s *ring)
+{
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+/* Index arithmetic: indices are in [0, 2 * size), offsets in [0, size) */
+
+static inline uint32_t lfring_advance(FAR const struct lfring_s *ring, uint32_t index, size_t n)
+{
+	index += n;
+	return index >= 2 * ring->size ? index - 2 * ring->size : index;
+}
+
+static inline uint32_t lfring_offset(FAR const struct lfring_s *ring, uint32_t index)
+{
+	return index >= ring->size ? index - ring->size : index;
+}
+
+static inline size_t lfring_distance(FAR const struct lfring_s *ring, uint32_t head, uint32_t tail)
+{
+	return head >= tail ? head - tail : head + 2 * ring->size - tail;
+}
+
+/****************************************************************************
+ * Name: lfring_used / lfring_space
+ *
+ * Description:
+ *   Return the number of bytes in the ring / free in the ring.  The value
+ *   is exact for the side that calls it: the other side can only make it
+ *   grow.
+ *
+ ****************************************************************************/
+
+static inline size_t lfring_used(FAR const struct lfring_s *ring)
+{
+	return lfring_distance(ring, ring->head, ring->tail);
+}
+
+static inline size_t lfring_space(FAR const struct lfring_s *ring)
+{
+	return ring->size - lfring_used(ring);
+}
+
+static inline bool lfring_empty(FAR const struct lfring_s *ring)
+{
+	return ring->head == ring->tail;
+}
+
+/****************************************************************************
+ * Name: lfring_reserve
+ *
+ * Description:
+ *   Producer side.  Return the number of contiguous free bytes starting at
+ *   the write position and return that position in 'ptr'.  Data placed
+ *   there becomes visible to the consumer with lfring_commit().
+ *
+ ****************************************************************************/
+
+static inline size_t lfring_reserve(FAR struct lfring_s *ring, FAR uint8_t **ptr)
+{
+	uint32_t head = ring->head;
+	uint32_t offset = lfring_offset(ring, head);
+	size_t space;
+
+	space = ring->size - lfring_distance(ring, head, ring->tail);
+
+	/* Do not overwrite bytes that the consumer may still be reading */
+
+	LFRING_BARRIER();
+
+	*ptr = &ring->buffer[offset];
+	return space < ring->size - offset ? space : ring->size - offset;
+}
+
+/****************************************************************************
+ * Name: lfring_commit
+ *
+ * Description:
+ *   Producer side.  Publish 'n' bytes written at the write position.  'n'
+ *   must not exceed the free space.
+ *
+ ****************************************************************************/
+
+static inline void lfring_commit(FAR struct lfring_s *ring, size_t n)
+{
+	LFRING_BARRIER();
+	ring->head = lfring_advance(ring, ring->head, n);
+}
+
+/****************************************************************************
+ * Name: lfring_peek
+ *
+ * Description:
+ *   Consumer side.  Return the number of contiguous bytes available at the
+ *   read position and return that position in 'ptr'.  The bytes are
+ *   released to the producer with lfring_consume().
+ *
+ ****************************************************************************/
+
+static inline size_t lfring_peek(FAR struct lfring_s *ring, FAR uint8_t **ptr)
+{
+	uint32_t tail = ring->tail;
+	uint32_t offset = lfring_offset(ring, tail);
+	size_t used;
+
+	used = lfring_distance(ring, ring->head, tail);
+
+	/* Do not read bytes before they were published */
+
+	LFRING_BARRIER();
+
+	*ptr = &ring->buffer[offset];
+	return used < ring->size - offset ? used : ring->size - offset;
+}
+
+/****************************************************************************
+ * Name: lfring_consume
+ *
+ * Description:
+ *   Consumer side.  Release 'n' bytes at the read position.  'n' must not
+ *   exceed the number of bytes in the ring.
+ *
+ ****************************************************************************/
+
+static inline void lfring_consume(FAR struct lfring_s *ring, size_t n)
+{
+	LFRING_BARRIER();
+	ring->tail = lfring_advance(ring, ring->tail, n);
+}
+
+/****************************************************************************
+ * Name: lfring_write
+ *
+ * Description:
+ *   Producer side.  Copy up to 'len' bytes into the ring and return the
+ *   number of bytes copied.
+ *
+ ****************************************************************************/
+
+static inline size_t lfring_write(FAR struct lfring_s *ring, FAR const void *data, size_t len)
+{
+	FAR const uint8_t *src = (FAR const uint8_t *)data;
+	FAR uint8_t *ptr;
+	size_t total = 0;
+	size_t n;
+
+	/* At most two passes: up to the end of the buffer, then from its start */
+
+	while (total < len && (n = lfring_reserve(ring, &ptr)) > 0) {
+		if (n > len - total) {
+			n = len - total;
+		}
+
+		memcpy(ptr, src + total, n);
+		lfring_commit(ring, n);
+		total += n;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: lfring_read
+ *
+ * Description:
+ *   Consumer side.  Copy up to 'len' bytes out of the ring and return the
+ *   number of bytes copied.
+ *
+ ****************************************************************************/
+
+static inline size_t lfring_read(FAR struct lfring_s *ring, FAR void *data, size_t len)
+{
+	FAR uint8_t *dest = (FAR uint8_t *)data;
+	FAR uint8_t *ptr;
+	size_t total = 0;
+	size_t n;
+
+	while (total < len && (n = lfring_peek(ring, &ptr)) > 0) {
+		if (n > len - total) {
+			n = len - total;
+		}
+
+		memcpy(dest + total, ptr, n);
+		lfring_consume(ring, n);
+		total += n;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: lfring_putc / lfring_getc
+ *
+ * Description:
+ *   Single byte variants of lfring_write() and lfring_read().  lfring_putc()
+ *   returns false if the ring is full; lfring_getc() returns -1 if the ring
+ *   is empty.
+ *
+ ****************************************************************************/
+
+static inline bool lfring_putc(FAR struct lfring_s *ring, uint8_t ch)
+{
+	FAR uint8_t *ptr;
+
+	if (lfring_reserve(ring, &ptr) == 0) {
+		return false;
+	}
+
+	*ptr = ch;
+	lfring_commit(ring, 1);
+	return true;
+}
+
+static inline int lfring_getc(FAR struct lfring_s *ring)
+{
+	FAR uint8_t *ptr;
+	int ch;
+
+	if (lfring_peek(ring, &ptr) == 0) {
+		return -1;
+	}
+
+	ch = *ptr;
+	lfring_consume(ring, 1);
+	return ch;
+}
+
+#endif							/* __INCLUDE_TINYARA_LFRING_H */
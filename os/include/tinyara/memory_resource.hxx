@@ -0,0 +1,210 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+//***************************************************************************
+// include/tinyara/memory_resource.hxx
+//
+// Polymorphic memory resources in the shape of C++17 std::pmr, for
+// containers that should draw from a given heap or from a buffer instead
+// of the global operator new.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_TINYARA_MEMORY_RESOURCE_HXX
+#define __INCLUDE_TINYARA_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <tinyara/config.h>
+#include <cstddef>
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+struct mm_heap_s;
+
+namespace tinyara
+{
+namespace pmr
+{
+  // Abstract source of memory.  Unlike std::pmr, allocate() returns NULL
+  // on failure since the library is built without exceptions.
+
+  class memory_resource
+  {
+  public:
+    virtual ~memory_resource() { }
+
+    FAR void *allocate(size_t nbytes, size_t align = sizeof(FAR void *))
+    {
+      return do_allocate(nbytes, align);
+    }
+
+    void deallocate(FAR void *ptr, size_t nbytes, size_t align = sizeof(FAR void *))
+    {
+      do_deallocate(ptr, nbytes, align);
+    }
+
+    bool is_equal(const memory_resource &other) const
+    {
+      return do_is_equal(other);
+    }
+
+  protected:
+    virtual FAR void *do_allocate(size_t nbytes, size_t align) = 0;
+    virtual void do_deallocate(FAR void *ptr, size_t nbytes, size_t align) = 0;
+    virtual bool do_is_equal(const memory_resource &other) const
+    {
+      return this == &other;
+    }
+  };
+
+  inline bool operator==(const memory_resource &a, const memory_resource &b)
+  {
+    return &a == &b || a.is_equal(b);
+  }
+
+  inline bool operator!=(const memory_resource &a, const memory_resource &b)
+  {
+    return !(a == b);
+  }
+
+  // Allocations from one mm_heap_s instance, for example a heap set up
+  // with mm_initialize() over a dedicated memory region
+
+  class heap_resource : public memory_resource
+  {
+  public:
+    explicit heap_resource(FAR struct mm_heap_s *heap) : m_heap(heap) { }
+
+    FAR struct mm_heap_s *heap() const
+    {
+      return m_heap;
+    }
+
+  protected:
+    FAR void *do_allocate(size_t nbytes, size_t align);
+    void do_deallocate(FAR void *ptr, size_t nbytes, size_t align);
+
+  private:
+    FAR struct mm_heap_s *m_heap;
+  };
+
+  // Bump allocation from a caller buffer, then from chunks of geometrically
+  // growing size taken from an upstream resource.  deallocate() is a no-op;
+  // everything is returned at once by release() or the destructor.
+
+  class monotonic_buffer_resource : public memory_resource
+  {
+  public:
+    explicit monotonic_buffer_resource(FAR memory_resource *upstream = 0);
+    monotonic_buffer_resource(FAR void *buffer, size_t size, FAR memory_resource *upstream = 0);
+    ~monotonic_buffer_resource();
+
+    void release();
+
+    FAR memory_resource *upstream_resource() const
+    {
+      return m_upstream;
+    }
+
+  protected:
+    FAR void *do_allocate(size_t nbytes, size_t align);
+    void do_deallocate(FAR void *ptr, size_t nbytes, size_t align) { }
+
+  private:
+    monotonic_buffer_resource(const monotonic_buffer_resource &);
+    monotonic_buffer_resource &operator=(const monotonic_buffer_resource &);
+
+    FAR memory_resource *m_upstream;
+    FAR void *m_chunks;             // Upstream chunks, newest first
+    FAR void *m_buffer;             // Initial caller buffer
+    size_t m_bufsize;
+    FAR char *m_cur;                // Free space in the current chunk
+    size_t m_avail;
+    size_t m_nextsize;              // Size of the next upstream chunk
+  };
+
+  // Resource on top of the global operator new and delete
+
+  FAR memory_resource *new_delete_resource();
+
+  // Resource used by allocators built without one, initially
+  // new_delete_resource().  set_default_resource() returns the previous
+  // one; NULL restores new_delete_resource().
+
+  FAR memory_resource *get_default_resource();
+  FAR memory_resource *set_default_resource(FAR memory_resource *r);
+
+  // Standard allocator over a memory resource, usable with the allocator
+  // parameter of the containers
+
+  template<class T>
+  class polymorphic_allocator
+  {
+  public:
+    typedef T value_type;
+
+    polymorphic_allocator() : m_resource(get_default_resource()) { }
+    polymorphic_allocator(FAR memory_resource *r) : m_resource(r) { }
+
+    template<class U>
+    polymorphic_allocator(const polymorphic_allocator<U> &other)
+      : m_resource(other.resource()) { }
+
+    FAR T *allocate(size_t n)
+    {
+      return static_cast<FAR T *>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(FAR T *p, size_t n)
+    {
+      m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    FAR memory_resource *resource() const
+    {
+      return m_resource;
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const
+    {
+      return polymorphic_allocator();
+    }
+
+  private:
+    FAR memory_resource *m_resource;
+  };
+
+  template<class T, class U>
+  inline bool operator==(const polymorphic_allocator<T> &a, const polymorphic_allocator<U> &b)
+  {
+    return *a.resource() == *b.resource();
+  }
+
+  template<class T, class U>
+  inline bool operator!=(const polymorphic_allocator<T> &a, const polymorphic_allocator<U> &b)
+  {
+    return !(a == b);
+  }
+}
+}
+
+#endif // __INCLUDE_TINYARA_MEMORY_RESOURCE_HXX
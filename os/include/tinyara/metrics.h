@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/metrics.h
+ *
+ * A registry of kernel health metrics.  Subsystems define their metrics
+ * statically, register them once at initialization and update them with
+ * metric_add(), metric_set() and metric_observe(), which only touch the
+ * metric itself.  Gauges that are cheaper to read on demand than to keep
+ * up to date (heap usage, CPU load, ...) instead provide a sample callback
+ * that is called when a snapshot is taken.  metrics_encode() serializes a
+ * snapshot of all the registered metrics as CBOR (RFC 7049).
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_METRICS_H
+#define __INCLUDE_TINYARA_METRICS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_METRICS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initializers of statically allocated metrics.  'bounds' and 'buckets' of
+ * a histogram must be arrays: bounds[] holds the ascending upper bounds of
+ * the buckets and buckets[] one more entry than bounds[] for the values
+ * above the last bound.
+ */
+
+#define METRIC_COUNTER_INITIALIZER(name) \
+	{ NULL, (name), METRIC_COUNTER, 0, 0, NULL, NULL, NULL }
+#define METRIC_GAUGE_INITIALIZER(name, sample) \
+	{ NULL, (name), METRIC_GAUGE, 0, 0, NULL, NULL, (sample) }
+#define METRIC_HISTOGRAM_INITIALIZER(name, bounds, buckets) \
+	{ NULL, (name), METRIC_HISTOGRAM, sizeof(bounds) / sizeof((bounds)[0]), 0, (bounds), (buckets), NULL }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+enum metric_type_e {
+	METRIC_COUNTER = 0,			/* Monotonic count, encoded unsigned */
+	METRIC_GAUGE,				/* Instantaneous value, encoded signed */
+	METRIC_HISTOGRAM			/* Counts of values per bucket */
+};
+
+struct metric_s;
+
+/* Called when a snapshot is taken, to refresh the value with metric_set() */
+
+typedef CODE void (*metric_sample_t)(FAR struct metric_s *metric);
+
+struct metric_s {
+	FAR struct metric_s *flink;	/* Next registered metric */
+	FAR const char *name;		/* Name, e.g. "mm.heap.used" */
+	uint8_t type;				/* See enum metric_type_e */
+	uint8_t nbounds;			/* Histogram: number of entries in bounds[] */
+	volatile uint32_t value;	/* Counter or gauge value */
+	FAR const uint32_t *bounds;	/* Histogram: upper bounds of the buckets */
+	FAR volatile uint32_t *buckets;	/* Histogram: nbounds + 1 counts */
+	metric_sample_t sample;		/* Optional, see metric_sample_t */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: metrics_initialize
+ *
+ * Description:
+ *   Register the metrics of the kernel itself.  Called once by os_start().
+ *
+ ****************************************************************************/
+
+void metrics_initialize(void);
+
+/****************************************************************************
+ * Name: metrics_register
+ *
+ * Description:
+ *   Add a metric to the registry.  Metrics cannot be removed again, so
+ *   'metric' and its name must stay valid for the life of the system.
+ *
+ ****************************************************************************/
+
+void metrics_register(FAR struct metric_s *metric);
+
+/****************************************************************************
+ * Name: metric_add, metric_set and metric_observe
+ *
+ * Description:
+ *   Add 'n' to a counter, set a gauge or count 'value' in the bucket of a
+ *   histogram.  May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void metric_add(FAR struct metric_s *metric, uint32_t n);
+void metric_set(FAR struct metric_s *metric, int32_t value);
+void metric_observe(FAR struct metric_s *metric, uint32_t value);
+
+/****************************************************************************
+ * Name: metrics_encode
+ *
+ * Description:
+ *   Sample the gauges that have a sample callback and encode a snapshot of
+ *   all the registered metrics into 'buffer' as the CBOR array
+ *
+ *     [ uptime in milliseconds, { name: value, ... } ]
+ *
+ *   where the value of a histogram is the array of its bucket counts.
+ *   Must be called from a task, as the sample callbacks may block.
+ *
+ * Returned Value:
+ *   The number of bytes encoded, or -ENOSPC if the snapshot does not fit
+ *   in 'buflen' bytes.
+ *
+ ****************************************************************************/
+
+ssize_t metrics_encode(FAR uint8_t *buffer, size_t buflen);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_METRICS */
+#endif							/* __INCLUDE_TINYARA_METRICS_H */
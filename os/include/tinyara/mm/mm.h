@@ -174,7 +174,33 @@
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+/* With the segregated-fit allocator, each power-of-two range (first level)
+ * is further split into MM_SLI_COUNT linear sub-ranges (second level).
+ * Every (first, second) pair owns one unsorted free list in mm_nodelist[],
+ * and two levels of bitmaps record which lists are non-empty so that a
+ * suitable list can be found with two find-first-set operations.
+ *
+ * MM_SLI_SHIFT is log2 of the number of second level lists.
+ * MM_FLI_COUNT is the number of first level ranges.
+ */
+
+#define MM_SLI_SHIFT     CONFIG_MM_SLI_SHIFT
+#define MM_SLI_COUNT     (1 << MM_SLI_SHIFT)
+#define MM_SLI_MASK      (MM_SLI_COUNT - 1)
+#define MM_FLI_COUNT     (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#define MM_NNODES        (MM_FLI_COUNT * MM_SLI_COUNT)
+
+/* Bit scan helpers:  index of the least/most significant set bit of a
+ * non-zero 32-bit value.
+ */
+
+#define MM_FFS(v)        __builtin_ctz(v)
+#define MM_FLS(v)        (31 - __builtin_clz(v))
+#else
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#endif
 
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
@@ -191,6 +217,19 @@
 #endif
 #define MM_IS_ALLOCATED(n) ((int)((struct mm_allocnode_s*)(n)->preceding) < 0)
 
+#ifdef CONFIG_MM_REGION_POLICY
+/* Region tags.  Every region carries one tag (MM_REGION_FAST by default);
+ * an allocation request names the set of tags it prefers.  With
+ * MM_REGION_STRICT, the request fails rather than fall back to a region
+ * with another tag.
+ */
+
+#define MM_REGION_FAST   0x01	/* Fast memory, e.g. internal SRAM */
+#define MM_REGION_SLOW   0x02	/* Slow memory, e.g. external RAM */
+#define MM_REGION_ANY    (MM_REGION_FAST | MM_REGION_SLOW)
+#define MM_REGION_STRICT 0x80	/* Do not fall back to other regions */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -301,6 +340,58 @@ struct mm_freenode_s {
 #define CHECK_FREENODE_SIZE \
 	DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_TASK_CACHE
+/* Per-task cache of small chunks.  Chunk class 'n' holds allocated chunks
+ * of exactly (n + 1) * MM_MIN_CHUNK bytes (including the chunk header).
+ * The cached chunks remain allocated from the point of view of the heap;
+ * they are kept in a singly linked list threaded through their payload.
+ */
+
+#define MM_TASKCACHE_NCLASSES  CONFIG_MM_TASK_CACHE_NCLASSES
+#define MM_TASKCACHE_DEPTH     CONFIG_MM_TASK_CACHE_DEPTH
+#define MM_TASKCACHE_BATCH     ((MM_TASKCACHE_DEPTH + 1) / 2)
+
+struct mm_taskcache_s {
+	FAR void *head[MM_TASKCACHE_NCLASSES];	/* Cached chunks of each class */
+	uint8_t count[MM_TASKCACHE_NCLASSES];	/* Number of chunks in each list */
+	uint32_t hits;				/* Allocations served by this cache */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* Heap profiler.  Every allocation request is counted in a histogram of
+ * chunk sizes (bucket 'n' holds chunks of 2^(n + MM_MIN_SHIFT) up to
+ * 2^(n + MM_MIN_SHIFT + 1) - 1 bytes).  One out of every MM_PROFILE_RATE
+ * requests is sampled:  its latency is measured with the architecture
+ * cycle counter and the size of the largest free chunk is recorded.
+ * Failed requests are always sampled.
+ */
+
+#define MM_PROFILE_NHIST       16
+#define MM_PROFILE_RATE        (1 << CONFIG_MM_HEAP_PROFILE_RATE)
+
+struct mm_profile_s {
+	uint32_t mp_nalloc;			/* Number of allocation requests */
+	uint32_t mp_nfail;			/* Number of failed requests */
+	uint32_t mp_sizehist[MM_PROFILE_NHIST];	/* Chunk size histogram */
+	size_t mp_minlargest;		/* Smallest largest-free-chunk sampled */
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	uint32_t mp_start;			/* Cycle count when the sample started */
+	uint32_t mp_nsampled;		/* Number of latency samples */
+	uint32_t mp_maxcycles;		/* Worst sampled latency (cycles) */
+	uint64_t mp_totcycles;		/* Sum of sampled latencies (cycles) */
+#endif
+};
+
+/* Snapshot of the profile, returned by mm_heapprofile() */
+
+struct mm_profinfo_s {
+	struct mm_profile_s prof;	/* Copy of the profile counters */
+	size_t largest;				/* Largest free chunk now */
+	uint16_t nfree[MM_NNODES];	/* Number of chunks in each free list */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s {
@@ -319,6 +410,21 @@ struct mm_heap_s {
 	int peak_alloc_size;
 	int total_alloc_size;
 #endif
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Per-task cache statistics.  Misses are counted while holding the
+	 * semaphore.  Hits are counted in the cache of each thread and only
+	 * those of exited threads are added here; umm_cache_hits() returns
+	 * the total.
+	 */
+
+	uint32_t mm_cache_hits;
+	uint32_t mm_cache_misses;
+#endif
+#ifdef CONFIG_MM_HEAP_PROFILE
+	/* Allocation profile, updated while holding mm_semaphore */
+
+	struct mm_profile_s mm_profile;
+#endif
 
 	/* This is the first and last nodes of the heap */
 
@@ -329,12 +435,31 @@ struct mm_heap_s {
 	int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_REGION_POLICY
+	/* Tag of each region and the union of the tags of all regions */
+
+	uint8_t mm_regtag[CONFIG_MM_REGIONS];
+	uint8_t mm_tags;
+#endif
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* Free nodes are kept in one unsorted, doubly linked list per size
+	 * class.  Bit 'fl' of mm_flbitmap is set if any second level list of
+	 * first level 'fl' is non-empty; bit 'sl' of mm_slbitmap[fl] is set if
+	 * the list mm_nodelist[fl * MM_SLI_COUNT + sl] is non-empty.
+	 */
+
+	uint32_t mm_flbitmap;
+	uint32_t mm_slbitmap[MM_FLI_COUNT];
+	struct mm_freenode_s mm_nodelist[MM_NNODES];
+#else
 	/* All free nodes are maintained in a doubly linked list.  This
 	 * array provides some hooks into the list at various points to
 	 * speed searches for free nodes.
 	 */
 
 	struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 };
 
 /****************************************************************************
@@ -434,6 +559,32 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
 #endif
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+#ifdef CONFIG_MM_REGION_POLICY
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size, uint8_t tags, mmaddress_t caller_retaddr);
+#else
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size, uint8_t tags);
+#endif
+#endif
+
+/* Functions contained in mm_region.c ***************************************/
+
+#ifdef CONFIG_MM_REGION_POLICY
+void mm_setregiontag(FAR struct mm_heap_s *heap, int region, uint8_t tag);
+uint8_t mm_regionpolicy(FAR struct mm_heap_s *heap, size_t size);
+FAR struct mm_freenode_s *mm_findregionchunk(FAR struct mm_heap_s *heap, size_t size, uint8_t tags);
+#endif
+
+/* Functions contained in umm_region.c **************************************/
+
+#if defined(CONFIG_MM_REGION_POLICY) && (!defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__))
+void umm_setregiontag(int region, uint8_t tag);
+uint8_t umm_settaskregion(uint8_t tags);
+FAR void *umm_malloc_fast(size_t size);
+#endif
+
 /* Functions contained in kmm_malloc.c **************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -468,6 +619,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size);
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize);
 #endif
+
+/* Functions contained in mm_malloc_size.c **********************************/
+
+size_t mm_malloc_size(FAR void *mem);
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 
 /* Functions contained in mm_calloc.c ***************************************/
@@ -526,6 +681,16 @@ FAR void *kmm_memalign(size_t alignment, size_t size);
 bool kmm_heapmember(FAR void *mem);
 #endif
 
+/* Functions contained in umm_cache.c **************************************/
+
+#ifdef CONFIG_MM_TASK_CACHE
+struct tcb_s;					/* Forward reference */
+FAR void *umm_cache_alloc(size_t size);
+bool umm_cache_free(FAR void *mem);
+void umm_cache_drain(FAR struct tcb_s *tcb);
+uint32_t umm_cache_hits(void);
+#endif
+
 /* Functions contained in mm_brkaddr.c **************************************/
 
 FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region);
@@ -595,10 +760,31 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node,
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_remfreechunk.c *********************************/
+
+void mm_remfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_findfreechunk.c ********************************/
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size);
+#endif
+
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+void mm_profile_reset(FAR struct mm_heap_s *heap);
+bool mm_profile_begin(FAR struct mm_heap_s *heap, size_t size);
+void mm_profile_end(FAR struct mm_heap_s *heap, bool sampled, FAR void *mem);
+size_t mm_largestfree(FAR struct mm_heap_s *heap);
+size_t mm_ndx2size(int ndx);
+void mm_heapprofile(FAR struct mm_heap_s *heap, FAR struct mm_profinfo_s *info);
+#endif
+
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions contained in kmm_mallinfo.c . Used to display memory allocation details */
 void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid);
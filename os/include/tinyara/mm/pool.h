@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Fixed-size object pool allocator.
+ ****************************************************************************/
+
+#ifndef __INCLUDE_MM_POOL_H
+#define __INCLUDE_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/mm/gran.h>
+
+#ifdef CONFIG_MM_POOL
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+/* CONFIG_MM_POOL - Enable fixed-size object pools.  Each pool carves its
+ *   objects out of a private granule allocator region, so objects carry no
+ *   per-allocation header.  Freed objects are kept in a LIFO free list
+ *   that is pushed and popped without disabling interrupts.
+ * CONFIG_MM_POOL_STATS - Maintain per-pool allocation statistics.
+ */
+
+/* Typed allocation helpers */
+
+#define KMM_POOL_ALLOC(pool, type)  ((FAR type *)kmm_pool_alloc(pool))
+#define KMM_POOL_FREE(pool, obj)    kmm_pool_free(pool, (FAR void *)(obj))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_POOL_STATS
+struct kmm_poolstats_s {
+	uint32_t nalloc;			/* Number of successful allocations */
+	uint32_t nfail;				/* Number of failed allocations */
+	uint16_t ninuse;			/* Number of objects currently allocated */
+	uint16_t peak;				/* Largest value of ninuse seen */
+};
+#endif
+
+/* This structure represents one pool of fixed-size objects */
+
+struct kmm_pool_s {
+	FAR void *freelist;			/* LIFO list of free objects */
+	GRAN_HANDLE gran;			/* Granule allocator backing the pool */
+	uintptr_t start;			/* First byte of the backing region */
+	uintptr_t end;				/* One past the last byte of the region */
+	uint16_t objsize;			/* Size of one object (bytes, rounded) */
+#ifdef CONFIG_MM_POOL_STATS
+	struct kmm_poolstats_s stats;
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmm_pool_initialize
+ *
+ * Description:
+ *   Set up a pool that can hold up to 'nobjs' objects of 'objsize' bytes.
+ *   The backing region is allocated from the kernel heap and managed by a
+ *   granule allocator instance; objects are carved from it on demand.
+ *
+ * Input Parameters:
+ *   pool    - The pool structure to initialize
+ *   objsize - Size of one object in bytes
+ *   nobjs   - Maximum number of objects in the pool
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int kmm_pool_initialize(FAR struct kmm_pool_s *pool, size_t objsize, unsigned int nobjs);
+
+/****************************************************************************
+ * Name: kmm_pool_alloc
+ *
+ * Description:
+ *   Allocate one object from the pool.  This may be called from interrupt
+ *   handlers, but then only objects already on the free list are
+ *   available unless CONFIG_GRAN_INTR is also selected.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated object or NULL if the pool is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_pool_alloc(FAR struct kmm_pool_s *pool);
+
+/****************************************************************************
+ * Name: kmm_pool_free
+ *
+ * Description:
+ *   Return an object to the pool.  This may be called from interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   pool - The pool that the object was allocated from
+ *   obj  - The object to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void kmm_pool_free(FAR struct kmm_pool_s *pool, FAR void *obj);
+
+/****************************************************************************
+ * Name: kmm_pool_member
+ *
+ * Description:
+ *   Check if an object lies within the backing region of the pool.  This
+ *   lets callers that fall back to the heap when a pool is exhausted decide
+ *   where to return an object.
+ *
+ ****************************************************************************/
+
+static inline bool kmm_pool_member(FAR struct kmm_pool_s *pool, FAR void *obj)
+{
+	return (uintptr_t)obj >= pool->start && (uintptr_t)obj < pool->end;
+}
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_MM_POOL */
+#endif							/* __INCLUDE_MM_POOL_H */
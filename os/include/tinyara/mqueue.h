@@ -72,6 +72,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Number of message priority buckets, see CONFIG_MQ_PRIO_BUCKETS */
+
+#define MQ_PRIO_NBUCKETS 32
+
 /****************************************************************************
  * Global Type Declarations
  ****************************************************************************/
@@ -83,6 +87,10 @@ struct mq_des;					/* forward reference */
 struct mqueue_inode_s {
 	FAR struct inode *inode;	/* Containing inode */
 	sq_queue_t msglist;			/* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+	uint32_t prmap;				/* Bit n set if bucket n holds messages */
+	FAR sq_entry_t *prtail[MQ_PRIO_NBUCKETS];	/* Last message of each bucket */
+#endif
 	int16_t maxmsgs;			/* Maximum number of messages in the queue */
 	int16_t nmsgs;				/* Number of message in the queue */
 	int16_t nwaitnotfull;		/* Number tasks waiting for not full */
@@ -92,6 +100,7 @@ struct mqueue_inode_s {
 #else
 	uint16_t maxmsgsize;		/* Max size of message in message queue */
 #endif
+	size_t maxrefsize;			/* Max size of a reference message, 0 if copied */
 #ifndef CONFIG_DISABLE_SIGNALS
 	FAR struct mq_des *ntmqdes;	/* Notification: Owning mqdes (NULL if none) */
 	pid_t ntpid;				/* Notification: Receiving Task's PID */
@@ -107,6 +107,8 @@ typedef uint16_t socktimeo_t;
  * descriptor.
  */
 
+struct pollfd;					/* Forward reference. Defined in poll.h */
+
 struct socket {
 	/** sockets currently are built on netconns, each socket has one netconn */
 	struct netconn *conn;
@@ -126,6 +128,10 @@ struct socket {
 	int err;
 	/** counter of how many threads are waiting for this socket using select */
 	int select_waiting;
+#ifdef CONFIG_EPOLL
+	/** epoll registrations of this socket, notified by event_callback() */
+	struct pollfd *epoll_fds;
+#endif
 };
 
 /* This defines a list of sockets indexed by the socket descriptor */
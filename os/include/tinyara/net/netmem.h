@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/net/netmem.h
+ *
+ * Accounting of the memory held by the network stack: the use of every
+ * lwIP memory pool, the bytes queued on each TCP connection and the
+ * packets dropped for lack of buffers, by reason.  Reported in
+ * /proc/net/mem.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_NET_NETMEM_H
+#define __INCLUDE_TINYARA_NET_NETMEM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+enum netmem_drop_e {
+	NETMEM_DROP_PBUF_POOL = 0,	/* PBUF_POOL allocation failed */
+	NETMEM_DROP_PBUF_RAM,		/* PBUF_RAM allocation failed */
+	NETMEM_DROP_TCPIP_MBOX,		/* Input queue of the tcpip thread full */
+	NETMEM_DROP_SOCK_RCVBUF,	/* UDP or raw datagram over the socket receive buffer */
+	NETMEM_DROP_TCP_OOSEQ,		/* Out-of-sequence TCP data discarded */
+	NETMEM_NDROPS
+};
+
+/* Use of one memory pool, or of the lwIP heap */
+
+struct netmem_pool_s {
+	FAR const char *name;
+	uint32_t avail;				/* Number of elements (bytes for the heap) */
+	uint32_t used;				/* Currently allocated */
+	uint32_t max;				/* Highest allocation seen */
+	uint32_t err;				/* Failed allocations */
+};
+
+/* Bytes held by one TCP connection */
+
+struct netmem_conn_s {
+	FAR const char *state;		/* TCP state name */
+	int16_t sd;					/* Socket descriptor, -1 if none */
+	uint16_t lport;				/* Local port */
+	uint16_t rport;				/* Remote port */
+	uint32_t raddr;				/* Remote IPv4 address, network order */
+	uint32_t sndbuf;			/* Send buffer limit (SO_SNDBUF) */
+	uint32_t sndq;				/* Written and not acknowledged yet */
+	uint32_t unsent;			/* Part of sndq never sent */
+	uint16_t sndpbufs;			/* Number of pbufs on the send queues */
+	uint32_t rcvq;				/* Received and not read by the application */
+	uint32_t ooseq;				/* Held on the out-of-sequence queue */
+};
+
+#ifdef CONFIG_NET_MEMINFO
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: netmem_drop
+ *
+ * Description:
+ *   Count a packet dropped for 'reason'.  May be called from any context.
+ *
+ ****************************************************************************/
+
+void netmem_drop(enum netmem_drop_e reason);
+
+/****************************************************************************
+ * Name: netmem_drops
+ *
+ * Description:
+ *   Copy the NETMEM_NDROPS drop counters to 'drops'.
+ *
+ ****************************************************************************/
+
+void netmem_drops(FAR uint32_t *drops);
+
+/****************************************************************************
+ * Name: netmem_drop_name
+ *
+ * Description:
+ *   Return the name of a drop reason as shown in /proc/net/mem.
+ *
+ ****************************************************************************/
+
+FAR const char *netmem_drop_name(enum netmem_drop_e reason);
+
+/****************************************************************************
+ * Name: netmem_pools
+ *
+ * Description:
+ *   Fill at most 'npools' entries of 'pools' with the use of the lwIP
+ *   memory pools followed by the lwIP heap.  This needs CONFIG_NET_MEMP_STATS
+ *   and CONFIG_NET_MEM_STATS respectively.
+ *
+ * Returned Value:
+ *   The number of entries filled.
+ *
+ ****************************************************************************/
+
+int netmem_pools(FAR struct netmem_pool_s *pools, int npools);
+
+/****************************************************************************
+ * Name: netmem_conns
+ *
+ * Description:
+ *   Fill at most 'nconns' entries of 'conns' with the queues of the active
+ *   TCP connections.  The connections are walked in the tcpip thread.
+ *
+ * Returned Value:
+ *   The number of entries filled, or a negated errno value.
+ *
+ ****************************************************************************/
+
+int netmem_conns(FAR struct netmem_conn_s *conns, int nconns);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#else							/* CONFIG_NET_MEMINFO */
+
+#define netmem_drop(r)
+
+#endif							/* CONFIG_NET_MEMINFO */
+#endif							/* __INCLUDE_TINYARA_NET_NETMEM_H */
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/net/netperf.h
+ *
+ * Per-layer timing of the network receive path.  Each stage a packet goes
+ * through is bracketed with netperf_begin()/netperf_end(), which accumulate
+ * the number of packets and the total and worst time spent, in cycles of
+ * up_perf_gettime().  The counters are reported in /proc/net/stats.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_NET_NETPERF_H
+#define __INCLUDE_TINYARA_NET_NETPERF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_NET_PERF_STATS
+#include <tinyara/arch.h>
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+enum netperf_stage_e {
+	NETPERF_DRIVER_RX = 0,		/* Driver receive, per frame */
+	NETPERF_TCPIP_WAIT,			/* Queued in the tcpip thread mailbox */
+	NETPERF_TCP_INPUT,			/* tcp_input() */
+	NETPERF_SOCKET_COPY,		/* Copy from pbufs to the user buffer */
+	NETPERF_NSTAGES
+};
+
+struct netperf_stage_s {
+	uint32_t count;				/* Number of samples */
+	uint32_t max;				/* Longest sample in cycles */
+	uint64_t total;				/* Sum of all samples in cycles */
+};
+
+#ifdef CONFIG_NET_PERF_STATS
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: netperf_begin
+ *
+ * Description:
+ *   Return the time stamp marking the start of a stage.
+ *
+ ****************************************************************************/
+
+#define netperf_begin()                 up_perf_gettime()
+
+/****************************************************************************
+ * Name: netperf_end
+ *
+ * Description:
+ *   Account the time elapsed since 'start' to 'stage'.  May be called from
+ *   any context.
+ *
+ ****************************************************************************/
+
+void netperf_end(enum netperf_stage_e stage, uint32_t start);
+
+/****************************************************************************
+ * Name: netperf_snapshot
+ *
+ * Description:
+ *   Copy the counters of all NETPERF_NSTAGES stages to 'stats'.
+ *
+ ****************************************************************************/
+
+void netperf_snapshot(FAR struct netperf_stage_s *stats);
+
+/****************************************************************************
+ * Name: netperf_reset
+ *
+ * Description:
+ *   Clear all counters.
+ *
+ ****************************************************************************/
+
+void netperf_reset(void);
+
+/****************************************************************************
+ * Name: netperf_name
+ *
+ * Description:
+ *   Return the name of a stage as shown in /proc/net/stats.
+ *
+ ****************************************************************************/
+
+FAR const char *netperf_name(enum netperf_stage_e stage);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#else							/* CONFIG_NET_PERF_STATS */
+
+#define netperf_begin()                 0
+#define netperf_end(s, t)               ((void)(t))
+
+#endif							/* CONFIG_NET_PERF_STATS */
+#endif							/* __INCLUDE_TINYARA_NET_NETPERF_H */
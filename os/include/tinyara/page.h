@@ -60,6 +60,7 @@
 #include <tinyara/config.h>
 
 #ifndef __ASSEMBLY__
+#include <stdint.h>
 #include <stdbool.h>
 #include <tinyara/sched.h>
 #endif
@@ -239,12 +240,32 @@
  *   Default: No timeouts monitored.
  */
 
+#ifndef CONFIG_PAGING_PREFETCH
+#define CONFIG_PAGING_PREFETCH 0
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_STATS
+/* Paging statistics returned by pg_getstats() */
+
+struct pgstats_s {
+	uint32_t nfaults;			/* Page faults reported with pg_miss() */
+	uint32_t nfills;			/* Pages filled on a fault */
+	uint32_t nprefetch;			/* Pages filled ahead by up_prefetchpage() */
+	uint32_t nprefetchused;		/* Prefetched pages that were referenced */
+	uint32_t nreplaced;			/* Mapped pages replaced by pg_lru_alloc() */
+};
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -326,6 +347,48 @@ extern "C" {
 
 void pg_miss(void);
 
+/****************************************************************************
+ * Name: pg_lru_alloc()
+ *
+ * Description:
+ *  With CONFIG_PAGING_LRU, choose the physical page that up_allocpage() or
+ *  up_prefetchpage() should use for the virtual page at vaddr: a page that
+ *  was never used if there is one, else the page that was least recently
+ *  referenced.  The page is recorded as mapped at vaddr.
+ *
+ * Input Parameters:
+ *   vaddr - The virtual address of the page being mapped.
+ *   prefetch - true if the page is being prefetched.  Prefetched pages
+ *     start out oldest so that they are the first to go if not used.
+ *   oldvaddr - Receives the virtual address that the page was mapped at
+ *     and that must be unmapped first, or zero if the page was free.
+ *
+ * Returned Value:
+ *   The index of the physical page, 0 to CONFIG_PAGING_NPPAGED - 1.
+ *
+ * Assumptions:
+ *   - Called from the page fill worker with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_LRU
+int pg_lru_alloc(uintptr_t vaddr, bool prefetch, FAR uintptr_t *oldvaddr);
+#endif
+
+/****************************************************************************
+ * Name: pg_getstats() and pg_resetstats()
+ *
+ * Description:
+ *  With CONFIG_PAGING_STATS, return a snapshot of the paging statistics or
+ *  clear them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_STATS
+void pg_getstats(FAR struct pgstats_s *stats);
+void pg_resetstats(void);
+#endif
+
 /****************************************************************************
  * Public Functions -- Provided by architecture-specific logic to common
  *                     paging logic.
@@ -473,6 +536,62 @@ typedef void (*up_pgcallback_t)(FAR struct tcb_s *tcb, int result);
 int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage, up_pgcallback_t pg_callback);
 #endif
 
+/****************************************************************************
+ * Name: up_prefetchpage()
+ *
+ * Description:
+ *  With CONFIG_PAGING_PREFETCH, the page fill worker calls this function
+ *  after a successful up_fillpage() to fill the virtual page that is
+ *  'offset' pages after the one that faulted.  The implementation allocates
+ *  the page (with pg_lru_alloc(..., true, ...) if CONFIG_PAGING_LRU is
+ *  used), maps it and fills it in the same way as up_allocpage() and the
+ *  blocking up_fillpage().
+ *
+ * Input Parameters:
+ *   tcb - The task that took the page fault being serviced.
+ *   offset - The distance in pages from the faulting page, 1 and up.
+ *
+ * Returned Value:
+ *   Zero (OK) if the page was filled.  -EEXIST if the page is already
+ *   mapped, in which case the worker goes on with the next one.  Any other
+ *   negated errno value, for example -ERANGE past the end of the paged
+ *   region, stops prefetching for this fault.
+ *
+ * Assumptions:
+ *   - Called from the page fill worker with interrupts disabled, before
+ *     the faulting task is restarted.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_PREFETCH > 0
+int up_prefetchpage(FAR struct tcb_s *tcb, int offset);
+#endif
+
+/****************************************************************************
+ * Name: up_pgreferenced()
+ *
+ * Description:
+ *  With CONFIG_PAGING_LRU, report whether the page mapped at vaddr was
+ *  accessed since the last call for the same page and clear that state,
+ *  for example by testing and clearing the access flag of its page table
+ *  entry, or by revoking the access permission so that the next access
+ *  faults and restores it.
+ *
+ * Input Parameters:
+ *   vaddr - The virtual address of a page mapped with pg_lru_alloc().
+ *
+ * Returned Value:
+ *   true if the page was referenced.
+ *
+ * Assumptions:
+ *   - Called from the page fill worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_LRU
+bool up_pgreferenced(uintptr_t vaddr);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
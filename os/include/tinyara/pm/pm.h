@@ -85,6 +85,7 @@
  ****************************************************************************/
 
 #include <tinyara/config.h>
+#include <stdint.h>
 #include <queue.h>
 
 #ifdef CONFIG_PM
@@ -353,6 +354,15 @@ struct pm_callback_s {
 	void (*notify)(FAR struct pm_callback_s *cb, int domain, enum pm_state_e pmstate);
 };
 
+#ifdef CONFIG_PM_DVFS
+/* One CPU operating point of the frequency scaling governor */
+
+struct pm_dvfs_opp_s {
+	uint32_t freq;				/* CPU clock in Hz */
+	uint16_t latency;			/* Time to switch to or from this point in usec */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -499,6 +509,58 @@ enum pm_state_e pm_checkstate(int domain);
 
 int pm_changestate(int domain, enum pm_state_e newstate);
 
+#ifdef CONFIG_PM_DVFS
+/****************************************************************************
+ * Name: pm_dvfs_boost
+ *
+ * Description:
+ *   Run the CPU at its fastest operating point for at least 'msec'
+ *   milliseconds, e.g. for a TLS handshake or while writing an OTA image.
+ *   May be called from tasks only.
+ *
+ ****************************************************************************/
+
+void pm_dvfs_boost(int msec);
+
+/****************************************************************************
+ * Name: pm_dvfs_getfreq
+ *
+ * Description:
+ *   Return the current CPU clock in Hz as set by the governor.
+ *
+ ****************************************************************************/
+
+uint32_t pm_dvfs_getfreq(void);
+
+/****************************************************************************
+ * Name: up_dvfs_getopps
+ *
+ * Description:
+ *   Provided by the architecture.  Return the number of CPU operating points
+ *   and their table, ordered from the slowest to the fastest, in 'opps'.
+ *   The system is expected to boot at the fastest point.
+ *
+ ****************************************************************************/
+
+int up_dvfs_getopps(FAR const struct pm_dvfs_opp_s **opps);
+
+/****************************************************************************
+ * Name: up_dvfs_setopp
+ *
+ * Description:
+ *   Provided by the architecture.  Switch the CPU to operating point
+ *   'index' of the table returned by up_dvfs_getopps().  Called from the
+ *   high priority work queue.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure, in which case
+ *   the previous operating point is still in effect.
+ *
+ ****************************************************************************/
+
+int up_dvfs_setopp(int index);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
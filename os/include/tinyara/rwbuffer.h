@@ -165,6 +165,21 @@ struct rwbuffer_s {
 	uint16_t rhnblocks;			/* Number of blocks in read-ahead buffer */
 	off_t rhblockstart;			/* First block in read-ahead buffer */
 #endif
+
+	/* This is the state of the asynchronous read-ahead.  The prefetch
+	 * buffer and its fields belong to the worker while pfbusy is set.
+	 */
+
+#ifdef CONFIG_DRVR_READAHEAD_ASYNC
+	uint16_t rhwindow;			/* Number of blocks to read ahead */
+	off_t rhexpected;			/* Next block of a sequential stream */
+	struct work_s rhwork;		/* Delayed work to prefetch the next window */
+	sem_t pfsem;				/* Posted when a prefetch completes */
+	uint8_t *pfbuffer;			/* Allocated prefetch buffer */
+	uint16_t pfnblocks;			/* Number of blocks in the prefetch buffer */
+	off_t pfblockstart;			/* First block in the prefetch buffer */
+	volatile bool pfbusy;		/* true: The prefetch is in progress */
+#endif
 };
 
 /**********************************************************************
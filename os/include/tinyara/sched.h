@@ -71,6 +71,9 @@
 
 #include <tinyara/irq.h>
 #include <tinyara/mm/shm.h>
+#if defined(CONFIG_MM_TASK_CACHE) || defined(CONFIG_MM_REGION_POLICY)
+#include <tinyara/mm/mm.h>
+#endif
 #include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 
@@ -331,6 +334,10 @@ struct dspace_s {
 struct join_s;					/* Forward reference                        */
 /* Defined in kernel/pthread/pthread.h       */
 #endif
+#ifndef CONFIG_DISABLE_SIGNALS
+struct sigpendq;				/* Forward reference                        */
+/* Defined in kernel/signal/signal.h         */
+#endif
 /** @brief Structure for Task Group Information */
 struct task_group_s {
 #if defined(HAVE_GROUP_MEMBERS) || defined(CONFIG_ARCH_ADDRENV)
@@ -401,14 +408,14 @@ struct task_group_s {
 #ifndef CONFIG_DISABLE_SIGNALS
 	/* POSIX Signal Control Fields *********************************************** */
 
-	sq_queue_t sigpendingq;		/* List of pending signals                  */
+	sigset_t sigpendingset;		/* Set of pending signals                   */
+	FAR struct sigpendq *sigpending[MAX_SIGNO + 1];	/* Pending signals by signo */
 #endif
 
 #ifndef CONFIG_DISABLE_ENVIRON
 	/* Environment variables ***************************************************** */
 
-	size_t tg_envsize;			/* Size of environment string allocation    */
-	FAR char *tg_envp;			/* Allocated environment strings            */
+	FAR struct env_s *tg_env;	/* Environment, shared copy-on-write        */
 #endif
 
 	/* PIC data space and address environments *********************************** */
@@ -464,9 +471,31 @@ struct task_group_s {
 };
 #endif
 
+/* struct sporadic_s *************************************************************/
+
+#ifdef CONFIG_SCHED_SPORADIC
+/** @brief Budget state of a SCHED_SPORADIC thread.  The thread runs at
+ * hi_priority until it has used 'budget' ticks in the current period, then at
+ * low_priority until the period ends and the budget is replenished.
+ */
+struct sporadic_s {
+	FAR struct tcb_s *flink;	/* Next thread in the sporadic list    */
+	uint8_t hi_priority;		/* Priority while budget remains       */
+	uint8_t low_priority;		/* Priority once the budget is used up */
+	uint8_t exhausted;			/* Running at low_priority             */
+	uint32_t budget;			/* Budget per period, in ticks         */
+	uint32_t period;			/* Replenishment period, in ticks      */
+	uint32_t remaining;			/* Budget left in this period          */
+	uint32_t elapsed;			/* Ticks into the current period       */
+};
+#endif
+
 /* struct tcb_s ******************************************************************/
 
 FAR struct wdog_s;				/* Forward reference                   */
+#ifndef CONFIG_DISABLE_SIGNALS
+struct sigq_s;					/* Forward reference                   */
+#endif
 /** @brief This is the common part of the task control block (TCB).  The TCB is the heart
  * of the TinyAra task-control logic.  Each task or thread is represented by a TCB
  * that includes these common definitions.
@@ -517,6 +546,9 @@ struct tcb_s {
 
 #if CONFIG_RR_INTERVAL > 0
 	int timeslice;				/* RR timeslice interval remaining     */
+#endif
+#ifdef CONFIG_SCHED_SPORADIC
+	struct sporadic_s sporadic;	/* SCHED_SPORADIC budget state         */
 #endif
 	FAR struct wdog_s *waitdog;	/* All timed waits used this wdog      */
 
@@ -553,6 +585,10 @@ struct tcb_s {
 	sq_queue_t sigpendactionq;	/* List of pending signal actions      */
 	sq_queue_t sigpostedq;		/* List of posted signals              */
 	siginfo_t sigunbinfo;		/* Signal info when task unblocked     */
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+	FAR struct sigq_s *sigqslots;	/* Pre-allocated signal action slots   */
+	uint8_t sigqfree;			/* Bit set of free sigqslots           */
+#endif
 #endif
 
 	/* POSIX Named Message Queue Fields ****************************************** */
@@ -579,6 +615,18 @@ struct tcb_s {
 	int peak_alloc_size;
 	int num_alloc_free;
 #endif
+
+#ifdef CONFIG_MM_TASK_CACHE
+	struct mm_taskcache_s heap_cache;	/* Small chunks cached by this thread */
+#endif
+
+#ifdef CONFIG_MM_REGION_POLICY
+	uint8_t heap_region;		/* Default region tags (0: by size)    */
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+	uint64_t cputime;			/* CPU time used, in cycle counter ticks */
+#endif
 };
 
 /* struct task_tcb_s *************************************************************/
@@ -93,6 +93,21 @@ struct nsem_inode_s {
 };
 #endif
 
+#ifdef CONFIG_SEM_LOCKSTAT
+/* Contention statistics of one semaphore.  Times are in microseconds. */
+
+struct sem_lockstat_s {
+	FAR sem_t *sem;				/* The semaphore */
+	FAR const char *name;		/* From sem_setname(), or NULL */
+	uint32_t nacquire;			/* Successful acquisitions */
+	uint32_t nwait;				/* Waits that blocked */
+	uint32_t maxwait;			/* Longest blocking wait */
+	uint64_t totalwait;			/* Sum of all blocking waits */
+	pid_t holder;				/* Last acquirer not yet released, or -1 */
+	FAR void *caller;			/* Where 'holder' called sem_wait() */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -186,6 +201,51 @@ int sem_getprotocol(FAR sem_t *sem, FAR int *protocol);
 
 int sem_setprotocol(FAR sem_t *sem, int protocol);
 
+#ifdef CONFIG_SEM_LOCKSTAT
+/****************************************************************************
+ * Function: sem_setname
+ *
+ * Description:
+ *    Start tracking the contention statistics of a semaphore under 'name'
+ *    in /proc/locks.  'name' must stay valid until the semaphore is
+ *    destroyed.
+ *
+ * Parameters:
+ *    sem  - A pointer to the semaphore
+ *    name - The name reported for the semaphore
+ *
+ * Return Value:
+ *   0 (OK) or a negated errno value if the semaphore could not be tracked.
+ *
+ ****************************************************************************/
+
+int sem_setname(FAR sem_t *sem, FAR const char *name);
+
+/****************************************************************************
+ * Function: sem_lockstat
+ *
+ * Description:
+ *    Copy the statistics of up to 'nentries' tracked semaphores to
+ *    'stats' and return their number.
+ *
+ ****************************************************************************/
+
+int sem_lockstat(FAR struct sem_lockstat_s *stats, int nentries);
+
+/****************************************************************************
+ * Function: sem_lockstat_reset
+ *
+ * Description:
+ *    Clear the counters of all tracked semaphores.  Names and holders are
+ *    kept.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_reset(void);
+#else
+#define sem_setname(sem, name)          0
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
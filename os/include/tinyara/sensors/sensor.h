@@ -114,6 +114,8 @@ typedef struct {
  */
 typedef struct sensor_device_t sensor_device_t;
 
+struct sensor_batch_s;
+
 /**
  * @brief Pointer definition to trigger callback function
  */
@@ -129,6 +131,8 @@ typedef int (*sensor_deactivate_t)(sensor_device_t *sensor);
 typedef int (*sensor_ioctl_t)(sensor_device_t *sensor, int id, sensor_ioctl_value_t *val);
 typedef int (*sensor_set_trigger_t)(sensor_device_t *sensor, sensor_trigger_info_t info, sensor_trigger_callback_t callback);
 typedef int (*sensor_get_data_t)(sensor_device_t *sensor, sensor_data_t *data);
+typedef int (*sensor_fifo_config_t)(sensor_device_t *sensor, int watermark);
+typedef int (*sensor_fifo_read_t)(sensor_device_t *sensor, sensor_data_t *data, int nsamples);
 
 /**
  * @brief Structure of sensor operations
@@ -141,6 +145,8 @@ typedef struct {
 	sensor_ioctl_t ioctl;	/* ioctl on sensor device */
 	sensor_set_trigger_t set_trigger;	/* set trigger information and calback function */
 	sensor_get_data_t get_data;	/* get sensor data from device */
+	sensor_fifo_config_t fifo_config;	/* set the hardware FIFO watermark, 0 disables the FIFO (optional) */
+	sensor_fifo_read_t fifo_read;	/* drain up to nsamples from the hardware FIFO, returns the number read (optional) */
 } sensor_operations_t;
 
 /**
@@ -150,6 +156,7 @@ struct sensor_device_t {
 	sensor_device_type_e type;	/* sensor device type */
 	sensor_operations_t *ops;	/* sensor opertaions */
 	void *priv;				/* private data of a specified device */
+	struct sensor_batch_s *batch;	/* batching state while batching is active, see sensor_batch.h */
 };
 
 /****************************************************************************
@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file sensor_batch.h
+ * @brief Sensor batching API definition
+ */
+
+#ifndef __SENSOR_BATCH_H__
+#define __SENSOR_BATCH_H__
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <time.h>
+
+#include <tinyara/wqueue.h>
+#include <tinyara/sensors/sensor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_SENSOR_BATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SENSOR_BATCH_NSAMPLES
+#define CONFIG_SENSOR_BATCH_NSAMPLES 64
+#endif
+
+#if (CONFIG_SENSOR_BATCH_NSAMPLES & (CONFIG_SENSOR_BATCH_NSAMPLES - 1)) != 0
+#error "CONFIG_SENSOR_BATCH_NSAMPLES must be a power of two"
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/**
+ * @brief Structure of sensor batching state
+ *
+ * Samples drained from the hardware FIFO of a sensor are kept in a ring
+ * until the application reads them.  The indices run freely and are masked
+ * on access.  When the ring is full the oldest samples are dropped, the
+ * hardware FIFO is always drained so that its watermark interrupt clears.
+ */
+struct sensor_batch_s {
+	sensor_device_t *sensor;	/* the batched sensor device */
+	struct work_s work;			/* drains the hardware FIFO */
+	sem_t exclsem;				/* mutual exclusion for the ring */
+	sem_t waitsem;				/* wakes up readers waiting for samples */
+	uint8_t nwaiters;			/* number of readers waiting for samples */
+	bool active;				/* batching is running */
+	bool havelast;				/* 'last' holds the time of a previous drain */
+	uint16_t watermark;			/* hardware FIFO watermark in samples */
+	uint16_t head;				/* index of the oldest sample [OUT] */
+	uint16_t tail;				/* index of the next free slot [IN] */
+	uint32_t period_ns;			/* nominal sampling period */
+	uint32_t dropped;			/* samples dropped because the ring was full */
+	struct timespec last;		/* time of the newest sample of the previous drain */
+	sensor_data_t data[CONFIG_SENSOR_BATCH_NSAMPLES];
+	struct timespec ts[CONFIG_SENSOR_BATCH_NSAMPLES];
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_batch_start
+ *
+ * Description:
+ *   start batching on a sensor that has a hardware FIFO.  the FIFO watermark
+ *   is programmed through the fifo_config operation, after which the driver
+ *   reports each watermark interrupt with sensor_batch_notify().
+ *
+ * Parameters:
+ *   sb - batching state, owned by the caller until sensor_batch_stop().
+ *   sensor - sensor device handle.
+ *   watermark - number of samples the hardware FIFO collects per interrupt.
+ *   period_us - nominal sampling period, used to time stamp the first batch.
+ *
+ * Returned Value:
+ *   on success, 0 is returned. on failure, a negated errno is returned
+ *   (-ENOSYS if the sensor has no hardware FIFO).
+ *
+ ****************************************************************************/
+int sensor_batch_start(struct sensor_batch_s *sb, sensor_device_t *sensor, int watermark, uint32_t period_us);
+
+/****************************************************************************
+ * Name: sensor_batch_stop
+ *
+ * Description:
+ *   disable the hardware FIFO and stop batching.  samples still in the ring
+ *   can be read afterwards.
+ *
+ * Parameters:
+ *   sb - batching state passed to sensor_batch_start().
+ *
+ * Returned Value:
+ *   on success, 0 is returned. on failure, a negated errno is returned.
+ *
+ ****************************************************************************/
+int sensor_batch_stop(struct sensor_batch_s *sb);
+
+/****************************************************************************
+ * Name: sensor_batch_read
+ *
+ * Description:
+ *   read batched samples, waiting until at least one is available.
+ *
+ * Parameters:
+ *   sb - batching state passed to sensor_batch_start().
+ *   data - array receiving up to nsamples samples.
+ *   ts - array receiving the time stamp of each sample, or NULL.
+ *   nsamples - size of the arrays.
+ *
+ * Returned Value:
+ *   the number of samples read. on failure, a negated errno is returned.
+ *
+ ****************************************************************************/
+int sensor_batch_read(struct sensor_batch_s *sb, sensor_data_t *data, struct timespec *ts, int nsamples);
+
+/****************************************************************************
+ * Name: sensor_batch_notify
+ *
+ * Description:
+ *   called by the sensor driver, typically from its watermark interrupt
+ *   handler, to have the hardware FIFO drained.  the bus transfers are done
+ *   on the low priority work queue.
+ *
+ * Parameters:
+ *   sensor - sensor device handle.
+ *
+ * Returned Value:
+ *   none.
+ *
+ ****************************************************************************/
+void sensor_batch_notify(sensor_device_t *sensor);
+
+#endif							/* CONFIG_SENSOR_BATCH */
+
+#ifdef __cplusplus
+}
+#endif
+#endif							/* __SENSOR_BATCH_H__ */
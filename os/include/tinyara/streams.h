@@ -74,6 +74,7 @@ typedef int (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef void (*lib_puts_t)(FAR struct lib_outstream_s *this, FAR const char *buf, int len);
 typedef int (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s {
@@ -84,6 +85,8 @@ struct lib_instream_s {
 
 struct lib_outstream_s {
 	lib_putc_t put;				/* Put one character to the outstream */
+	lib_puts_t puts;			/* Put len characters at once, or NULL to
+								 * have callers use put for each one */
 #ifdef CONFIG_STDIO_LINEBUFFER
 	lib_flush_t flush;			/* Flush any buffered characters in the outstream */
 #endif
@@ -56,7 +56,9 @@
  *
  * The RAM logging  driver is similar to a pipe in that it saves the
  * debugging output in a FIFO in RAM.  It differs from a pipe in numerous
- * details as needed to support logging.
+ * details as needed to support logging.  In particular, reading does not
+ * consume the log: each open file has its own read position, starting at
+ * the oldest byte still in the log, so several readers can tail it at once.
  *
  * This driver is built when CONFIG_RAMLOG is defined in the Nuttx
  * configuration.
@@ -99,6 +101,9 @@
  * following may also be provided:
  *
  * CONFIG_RAMLOG_BUFSIZE - Size of the console RAM log.  Default: 1024
+ * CONFIG_RAMLOG_PERSIST - Keep the console RAM log in memory that is not
+ *   cleared at start-up, so the log of the previous boot can still be read
+ *   after a warm reset.  Requires CONFIG_ARCH_HAVE_NOINIT.
  */
 
 #ifndef CONFIG_DEV_CONSOLE
@@ -125,6 +130,10 @@
 #define CONFIG_RAMLOG_BUFSIZE 1024
 #endif
 
+#ifndef CONFIG_ARCH_HAVE_NOINIT
+#undef CONFIG_RAMLOG_PERSIST
+#endif
+
 /* The normal behavior of the RAM log when used as a SYSLOG is to return
  * end-of-file if there is no data in the RAM log (rather than blocking until
  * data is available).  That allows you to 'cat' the SYSLOG with no ill
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/timepage.h
+ *
+ * User-space clock time page.  The kernel publishes the last sample of a
+ * free-running hardware counter together with CLOCK_MONOTONIC and the
+ * CLOCK_REALTIME offset at that sample.  The page and the counter are
+ * readable from user space, so clock_timepage_gettime() extrapolates the
+ * current time from the counter without a system call.  A sequence count
+ * lets the reader retry if the kernel updated the page meanwhile.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_TIMEPAGE_H
+#define __INCLUDE_TINYARA_TIMEPAGE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The page is padded and aligned to this size so that a single MPU region
+ * covers exactly the page.
+ */
+
+#define TIMEPAGE_SIZE		64
+
+/* Counter to nanoseconds conversion: ns = counts * tp_mult >> TIMEPAGE_SHIFT */
+
+#define TIMEPAGE_SHIFT		20
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The counter is 32 bits wide and a down counter reloads from UINT32_MAX.
+ * The kernel extends it to 64 bits with the number of wraps it has handled,
+ * tp_wraps.  A wrap that the kernel has not handled yet is flagged by the
+ * bits tp_wrapmask of *tp_wrapstat.
+ */
+
+struct timepage_s {
+	uint32_t tp_seq;			/* Odd while the kernel updates the page */
+	uint32_t tp_wraps;			/* Counter wraps handled by the kernel */
+	uint64_t tp_count;			/* Extended counter value at tp_mono */
+	uint64_t tp_mono;			/* CLOCK_MONOTONIC at tp_count (ns) */
+	int64_t tp_realoffset;		/* CLOCK_REALTIME - CLOCK_MONOTONIC (ns) */
+	uint32_t tp_mult;			/* Nanoseconds per count << TIMEPAGE_SHIFT */
+	bool tp_countdown;			/* The counter counts down */
+	FAR const volatile uint32_t *tp_counter;	/* Counter register */
+	FAR const volatile uint32_t *tp_wrapstat;	/* Wrap status register */
+	uint32_t tp_wrapmask;		/* Wrap pending bits in *tp_wrapstat */
+};
+
+union timepage_u {
+	struct timepage_s page;
+	uint8_t pad[TIMEPAGE_SIZE];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/* The time page, aligned to TIMEPAGE_SIZE */
+
+EXTERN union timepage_u g_timepage;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_initialize
+ *
+ * Description:
+ *   Called by the architecture timer code to describe its free-running
+ *   counter.  The counter and wrap status registers must be readable from
+ *   user space.  The page is not handed out to user space until the first
+ *   clock_timepage_update().
+ *
+ * Parameters:
+ *   counter   - Address of the 32-bit counter register
+ *   frequency - Counter frequency in Hz
+ *   countdown - True if the counter counts down
+ *   wrapstat  - Address of the register flagging a pending counter wrap
+ *   wrapmask  - Wrap pending bits in *wrapstat
+ *
+ ****************************************************************************/
+
+void clock_timepage_initialize(FAR const volatile uint32_t *counter, uint32_t frequency, bool countdown, FAR const volatile uint32_t *wrapstat, uint32_t wrapmask);
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Publish a new sample: the number of counter wraps handled so far, the
+ *   counter value and the CLOCK_MONOTONIC time at which it was read.
+ *   Called with interrupts disabled by the architecture timer code, at
+ *   least each time it handles a counter wrap.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(uint32_t wraps, uint32_t count, FAR const struct timespec *mono);
+
+/****************************************************************************
+ * Name: clock_timepage_setbase
+ *
+ * Description:
+ *   Publish the CLOCK_REALTIME offset after the time-of-day changed.
+ *
+ ****************************************************************************/
+
+void clock_timepage_setbase(void);
+
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the read-only time page, or NULL with errno set to ENOSYS if the
+ *   time is not published.
+ *
+ ****************************************************************************/
+
+FAR const struct timepage_s *clock_timepage(void);
+
+/****************************************************************************
+ * Name: clock_timepage_gettime
+ *
+ * Description:
+ *   Same as clock_gettime() for CLOCK_REALTIME and CLOCK_MONOTONIC, but
+ *   computed from the time page without entering the kernel.  Falls back to
+ *   clock_gettime() if the page is not available.
+ *
+ ****************************************************************************/
+
+int clock_timepage_gettime(clockid_t clock_id, FAR struct timespec *tp);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_CLOCK_TIMEPAGE */
+#endif							/* __INCLUDE_TINYARA_TIMEPAGE_H */
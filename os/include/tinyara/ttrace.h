@@ -56,6 +56,8 @@
 #define TTRACE_BUFFER              'b'
 #define TTRACE_DUMP                'd'
 #define TTRACE_PRINT               'p'
+#define TTRACE_GET_EVENTS          'e'
+#define TTRACE_JSON                'j'
 
 #define TTRACE_CODE_VARIABLE        0
 #define TTRACE_CODE_UNIQUE         (1 << 7)
@@ -75,6 +77,7 @@
 #define TTRACE_TAG_LOCK            (1 << 2)
 #define TTRACE_TAG_TASK            (1 << 3)
 #define TTRACE_TAG_IPC             (1 << 4)
+#define TTRACE_TAG_IRQ             (1 << 5)
 
 /****************************************************************************
  * Public Variables
@@ -169,6 +172,65 @@ int trace_sched(struct tcb_s *prev, struct tcb_s *next);
 #endif
 
 #endif /* CONFIG_TTRACE */
+
+#ifdef CONFIG_TTRACE_EVENTS
+/****************************************************************************
+ * Binary events
+ *
+ * Scheduler, interrupt and semaphore events are recorded by the kernel as
+ * fixed-size binary records, time-stamped with the CPU cycle counter, into
+ * a buffer that keeps the most recent CONFIG_TTRACE_EVENT_COUNT events.
+ * They are read with the TTRACE_GET_EVENTS ioctl.
+ ****************************************************************************/
+
+/* Event ids */
+
+#define TTRACE_EVENT_SWITCH        1	/* pid: previous task, arg: next pid, arg2: previous state */
+#define TTRACE_EVENT_IRQ_ENTER     2	/* arg: irq number */
+#define TTRACE_EVENT_IRQ_EXIT      3	/* arg: irq number */
+#define TTRACE_EVENT_SEM_BLOCK     4	/* arg: semaphore address */
+#define TTRACE_EVENT_TASK_START    5	/* pid: new task */
+#define TTRACE_EVENT_TASK_STOP     6	/* pid: terminated task */
+
+struct ttrace_event_s {        // total 12B
+	uint32_t cycles;             // 4B, CPU cycle counter
+	uint32_t arg;                // 4B, event specific
+	int16_t pid;                 // 2B, running task
+	uint8_t id;                  // 1B, TTRACE_EVENT_xxx
+	uint8_t arg2;                // 1B, event specific
+};
+
+/* Argument of the TTRACE_GET_EVENTS ioctl.  The oldest events are copied
+ * to 'events' and removed from the trace buffer.
+ */
+
+struct ttrace_eventreq_s {
+	struct ttrace_event_s *events;  /* in: destination */
+	uint32_t nevents;               /* in: size of 'events', out: events copied */
+	uint32_t nlost;                 /* out: events overwritten before being read */
+	uint32_t cycles_per_usec;       /* out: frequency of the cycle counter */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Kernel hooks.  Use the macros below */
+
+void ttrace_event(int tag, int id, int pid, uint32_t arg, int arg2);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#define ttrace_irq_enter(irq)      ttrace_event(TTRACE_TAG_IRQ, TTRACE_EVENT_IRQ_ENTER, -1, (uint32_t)(irq), 0)
+#define ttrace_irq_exit(irq)       ttrace_event(TTRACE_TAG_IRQ, TTRACE_EVENT_IRQ_EXIT, -1, (uint32_t)(irq), 0)
+#define ttrace_sem_block(sem)      ttrace_event(TTRACE_TAG_LOCK, TTRACE_EVENT_SEM_BLOCK, -1, (uint32_t)(sem), 0)
+#else
+#define ttrace_irq_enter(irq)
+#define ttrace_irq_exit(irq)
+#define ttrace_sem_block(sem)
+#endif /* CONFIG_TTRACE_EVENTS */
 #endif /* __INCLUDE_TINYARA_TTRACE_INTERNAL_H */
 /**
  * @}
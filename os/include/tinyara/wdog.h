@@ -152,6 +152,9 @@ struct wdog_s {
 	int lag;					/* Timer associated with the delay */
 	uint8_t flags;				/* See WDOGF_* definitions above */
 	uint8_t argc;				/* The number of parameters to pass */
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	uint8_t slot;				/* Timer wheel slot (level * 64 + index) */
+#endif
 	uint32_t parm[CONFIG_MAX_WDOGPARMS];
 };
 
@@ -645,6 +645,57 @@
 		   "r6", "r7", "r8", "r9", "cc"         \
 		 );
 
+#elif defined(__ARM_ARCH) && __ARM_ARCH >= 6 && defined(__ARM_FEATURE_DSP)
+
+/*
+ * UMAAL (ARMv6, ARMv7-R/A, ARMv7E-M) adds both the old digit and the
+ * carry into the 64-bit product, which is the whole inner step.
+ */
+#define MULADDC_INIT                                    \
+	asm(                                                \
+			"ldr    r0, %3                      \n\t"   \
+			"ldr    r1, %4                      \n\t"   \
+			"ldr    r2, %5                      \n\t"   \
+			"ldr    r3, %6                      \n\t"
+
+#define MULADDC_CORE                                    \
+			"ldr    r4, [r0], #4                \n\t"   \
+			"ldr    r5, [r1]                    \n\t"   \
+			"umaal  r5, r2, r3, r4              \n\t"   \
+			"str    r5, [r1], #4                \n\t"
+
+#define MULADDC_HUIT                                    \
+			"ldm    r0!, {r4, r6}               \n\t"   \
+			"ldm    r1, {r5, r7}                \n\t"   \
+			"umaal  r5, r2, r3, r4              \n\t"   \
+			"umaal  r7, r2, r3, r6              \n\t"   \
+			"stm    r1!, {r5, r7}               \n\t"   \
+			"ldm    r0!, {r4, r6}               \n\t"   \
+			"ldm    r1, {r5, r7}                \n\t"   \
+			"umaal  r5, r2, r3, r4              \n\t"   \
+			"umaal  r7, r2, r3, r6              \n\t"   \
+			"stm    r1!, {r5, r7}               \n\t"   \
+			"ldm    r0!, {r4, r6}               \n\t"   \
+			"ldm    r1, {r5, r7}                \n\t"   \
+			"umaal  r5, r2, r3, r4              \n\t"   \
+			"umaal  r7, r2, r3, r6              \n\t"   \
+			"stm    r1!, {r5, r7}               \n\t"   \
+			"ldm    r0!, {r4, r6}               \n\t"   \
+			"ldm    r1, {r5, r7}                \n\t"   \
+			"umaal  r5, r2, r3, r4              \n\t"   \
+			"umaal  r7, r2, r3, r6              \n\t"   \
+			"stm    r1!, {r5, r7}               \n\t"
+
+#define MULADDC_STOP                                    \
+			"str    r2, %0                      \n\t"   \
+			"str    r1, %1                      \n\t"   \
+			"str    r0, %2                      \n\t"   \
+		 : "=m" (c),  "=m" (d), "=m" (s)        \
+		 : "m" (s), "m" (d), "m" (c), "m" (b)   \
+		 : "r0", "r1", "r2", "r3", "r4", "r5",  \
+		   "r6", "r7", "memory", "cc"           \
+		 );
+
 #else
 
 #define MULADDC_INIT                                    \
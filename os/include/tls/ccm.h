@@ -54,6 +54,10 @@ extern "C" {
  */
 typedef struct {
 	mbedtls_cipher_context_t cipher_ctx;	/*!< cipher context used */
+#if defined(CONFIG_HW_AES_AEAD)
+	unsigned char hw_key[32];	/*!< AES key for the hardware path */
+	unsigned int hw_keylen;	/*!< AES key length, 0 if not usable */
+#endif
 } mbedtls_ccm_context;
 
 /**
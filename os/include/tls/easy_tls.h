@@ -34,8 +34,43 @@
 #include <tls/ssl_cache.h>
 #endif
 
+#if defined(MBEDTLS_SSL_TICKET_C) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+#include <tls/ssl_ticket.h>
+#define EASY_TLS_TICKETS
+#endif
+
+#ifdef MBEDTLS_THREADING_C
+#include <tls/threading.h>
+#endif
+
+#include <sys/socket.h>
+
 #define EASY_TLS_DEBUG	ndbg
 
+#ifdef CONFIG_TLS_SESSION_CACHE_SIZE
+#define EASY_TLS_CACHE_SIZE		CONFIG_TLS_SESSION_CACHE_SIZE
+#else
+#define EASY_TLS_CACHE_SIZE		8
+#endif
+
+#ifdef CONFIG_TLS_SESSION_CACHE_TIMEOUT
+#define EASY_TLS_CACHE_TIMEOUT	CONFIG_TLS_SESSION_CACHE_TIMEOUT
+#else
+#define EASY_TLS_CACHE_TIMEOUT	3600
+#endif
+
+#ifdef CONFIG_TLS_MAX_FRAG_LEN
+#define EASY_TLS_MAX_FRAG_LEN	CONFIG_TLS_MAX_FRAG_LEN
+#else
+#define EASY_TLS_MAX_FRAG_LEN	0
+#endif
+
+#ifdef CONFIG_TLS_CLIENT_SESSION_STORE
+#define EASY_TLS_SESSION_STORE	CONFIG_TLS_CLIENT_SESSION_STORE
+#else
+#define EASY_TLS_SESSION_STORE	4
+#endif
+
 enum easy_tls_error {
 	TLS_SUCCESS,
 	TLS_ALLOC_FAIL,
@@ -50,6 +85,7 @@ enum easy_tls_error {
 	TLS_INVALID_DEVCERT,
 	TLS_INVALID_DEVKEY,
 	TLS_INVALID_PSK,
+	TLS_SET_TICKET_FAIL,
 };
 
 typedef struct tls_cert_and_key {
@@ -66,6 +102,15 @@ typedef struct tls_cert_and_key {
 #endif
 } tls_cred;
 
+/* A session a client can offer on its next connection to the same peer */
+typedef struct tls_saved_session {
+	struct sockaddr_storage peer;
+	socklen_t peer_len;
+	unsigned int stamp;			///< last use, for replacing the oldest entry
+	int valid;
+	mbedtls_ssl_session session;
+} tls_saved_session;
+
 typedef struct tls_context {
 	mbedtls_ssl_config *conf;
 	mbedtls_x509_crt *crt;
@@ -77,6 +122,16 @@ typedef struct tls_context {
 #ifdef MBEDTLS_SSL_CACHE_C
 	mbedtls_ssl_cache_context *cache;
 #endif
+#ifdef EASY_TLS_TICKETS
+	mbedtls_ssl_ticket_context *ticket;
+#endif
+#if EASY_TLS_SESSION_STORE > 0
+	tls_saved_session *saved;
+	unsigned int saved_stamp;
+#ifdef MBEDTLS_THREADING_C
+	mbedtls_threading_mutex_t saved_mutex;
+#endif
+#endif
 } tls_ctx;
 
 typedef struct tls_options {
@@ -154,7 +154,7 @@ typedef struct {
 	int (*t_post)(mbedtls_ecp_point *, void *);	/*!< unused                         */
 	void *t_data;			/*!< unused                         */
 	mbedtls_ecp_point *T;	/*!<  pre-computed points for ecp_mul_comb()        */
-	size_t T_size;			/*!<  number for pre-computed points                */
+	size_t T_size;			/*!<  number for pre-computed points, 0 if T is shared */
 #if defined(CONFIG_HW_ECDH_PARAM)
 	unsigned char *key_buf;
 #endif
@@ -236,6 +236,12 @@ typedef struct {
 #define MBEDTLS_ECP_FIXED_POINT_OPTIM  1   /**< Enable fixed-point speed-up */
 #endif							/* MBEDTLS_ECP_FIXED_POINT_OPTIM */
 
+/*
+ * MBEDTLS_ECP_FIXED_POINT_CACHE keeps the fixed-point table of each named
+ * curve for the life of the program, so groups loaded later (typically one
+ * per handshake) skip the precomputation. It costs one table per curve used.
+ */
+
 /* \} name SECTION: Module settings */
 
 /*
@@ -67,6 +67,10 @@ typedef struct {
 	unsigned char y[16];	/*!< Y working value */
 	unsigned char buf[16];	/*!< buf working value */
 	int mode;				/*!< Encrypt or Decrypt */
+#if defined(CONFIG_HW_AES_AEAD)
+	unsigned char hw_key[32];	/*!< AES key for the hardware path */
+	unsigned int hw_keylen;	/*!< AES key length, 0 if not usable */
+#endif
 } mbedtls_gcm_context;
 
 /**
@@ -27,11 +27,13 @@
 
 #include <stdio.h>
 
+#include "../../arch/arm/src/s5j/sss/mb_cmd_aes.h"
 #include "../../arch/arm/src/s5j/sss/mb_cmd_dh.h"
 #include "../../arch/arm/src/s5j/sss/mb_cmd_hash.h"
 #include "../../arch/arm/src/s5j/sss/mb_cmd_rsa.h"
 
 #include "../../arch/arm/src/s5j/sss/isp_define.h"
+#include "../../arch/arm/src/s5j/sss/isp_driver_aes_securekey.h"
 #include "../../arch/arm/src/s5j/sss/isp_driver_hash.h"
 #include "../../arch/arm/src/s5j/sss/isp_driver_rng.h"
 #include "../../arch/arm/src/s5j/sss/isp_driver_secure_storage_factorykey.h"
@@ -81,6 +83,7 @@ typedef enum {
 	SEE_ECDSA_SIGN_ERROR,
 	SEE_ECDSA_VERIFY_ERROR,
 	SEE_ECDH_COMPUTE_ERROR,
+	SEE_AES_ERROR,
 } see_error;
 
 /*
@@ -92,6 +95,9 @@ typedef enum {
 #define SEE_MAX_CERT_INDEX		(0x08)
 #define ECC_KEY				(0x040000)
 
+/* Object id of an AES mode, laid out as in the comments of mb_cmd_aes.h */
+#define SEE_AES_OID(key_len, mode)	((((mode) & 0xff00) << 12) | ((key_len) << 8) | ((mode) & 0xff))
+
 #if defined(SEE_API_DEBUG)
 #define SEE_DEBUG printf
 #else
@@ -115,6 +121,15 @@ typedef struct see_mutex_s {
 
 extern see_mutex_t m_handler;
 
+/* Digest of a message of known length passed in several pieces */
+typedef struct see_hash_ctx_s {
+	unsigned int mode;			/* SHA2_256, ... */
+	unsigned int block_len;		/* input block size of mode */
+	unsigned int remain;		/* message bytes not passed in yet */
+	unsigned int buf_len;
+	unsigned char buf[MAX_HASH_BLOCK_BLEN];	/* held back for the final block */
+} see_hash_ctx;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -149,7 +164,11 @@ int see_set_certificate(unsigned char *cert, unsigned int cert_len, unsigned int
 int see_get_ecdsa_signature(struct sECC_SIGN *ecc_sign, unsigned char *hash, unsigned int hash_len, unsigned int key_index);
 int see_verify_ecdsa_signature(struct sECC_SIGN *ecc_sign, unsigned char *hash, unsigned int hash_len, unsigned int key_index);
 int see_get_hash(struct sHASH_MSG *h_param, unsigned char *hash, unsigned int mode);
+int see_hash_start(see_hash_ctx *ctx, unsigned int msg_len, unsigned int mode);
+int see_hash_update(see_hash_ctx *ctx, const unsigned char *msg, unsigned int len);
+int see_hash_finish(see_hash_ctx *ctx, unsigned char *hash);
 int see_compute_ecdh_param(struct sECC_KEY *ecc_pub, unsigned int key_index, unsigned char *output, unsigned int *olen);
+int see_aes_aead(struct sAES_PARAM *aes_param, const unsigned char *key, unsigned int key_len, unsigned int enc);
 
 /****************************************************************************
  * Name: Internal functions
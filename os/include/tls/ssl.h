@@ -815,6 +815,9 @@ struct mbedtls_ssl_context {
 	unsigned char *in_iv;	/*!< ivlen-byte IV                    */
 	unsigned char *in_msg;	/*!< message contents (in_iv+ivlen)   */
 	unsigned char *in_offt;	/*!< read offset in application data  */
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	size_t in_buf_len;		/*!< current size of in_buf           */
+#endif
 
 	int in_msgtype;			/*!< record header: message type      */
 	size_t in_msglen;		/*!< record header: message length    */
@@ -843,6 +846,9 @@ struct mbedtls_ssl_context {
 	unsigned char *out_len;	/*!< two-bytes message length field   */
 	unsigned char *out_iv;	/*!< ivlen-byte IV                    */
 	unsigned char *out_msg;	/*!< message contents (out_iv+ivlen)  */
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	size_t out_buf_len;		/*!< current size of out_buf          */
+#endif
 
 	int out_msgtype;		/*!< record header: message type      */
 	size_t out_msglen;		/*!< record header: message length    */
@@ -161,6 +161,25 @@
 								+ MBEDTLS_SSL_MAC_ADD                  \
 								+ MBEDTLS_SSL_PADDING_ADD)
 
+/* Bytes of a record buffer that are not record content */
+#define MBEDTLS_SSL_BUFFER_OVERHEAD  (MBEDTLS_SSL_BUFFER_LEN - MBEDTLS_SSL_MAX_CONTENT_LEN)
+
+/*
+ * Current size of the record buffers. With variable buffers they are
+ * shrunk to the (negotiated) fragment length once the handshake is over.
+ */
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+#if !defined(MBEDTLS_SSL_OUT_CONTENT_LEN_IDLE)
+#define MBEDTLS_SSL_OUT_CONTENT_LEN_IDLE MBEDTLS_SSL_MAX_CONTENT_LEN
+#endif
+#define MBEDTLS_SSL_IN_BUFFER_LEN(ssl)   ((ssl)->in_buf_len)
+#define MBEDTLS_SSL_OUT_BUFFER_LEN(ssl)  ((ssl)->out_buf_len)
+#else
+#define MBEDTLS_SSL_IN_BUFFER_LEN(ssl)   MBEDTLS_SSL_BUFFER_LEN
+#define MBEDTLS_SSL_OUT_BUFFER_LEN(ssl)  MBEDTLS_SSL_BUFFER_LEN
+#endif
+#define MBEDTLS_SSL_OUT_CONTENT_LEN(ssl) (MBEDTLS_SSL_OUT_BUFFER_LEN(ssl) - MBEDTLS_SSL_BUFFER_OVERHEAD)
+
 /*
  * TLS extension flags (for extensions with outgoing ServerHello content
  * that need it (e.g. for RENEGOTIATION_INFO the server already knows because
@@ -69,6 +69,7 @@
 #include <tinyara/clock.h>
 #include <tinyara/time.h>
 #include <tinyara/rtc.h>
+#include <tinyara/timepage.h>
 
 #include "clock/clock.h"
 
@@ -193,6 +194,9 @@ static void clock_inittime(void)
 	/* (Re-)initialize the time value to match the RTC */
 
 	clock_basetime(&g_basetime);
+#ifdef CONFIG_CLOCK_TIMEPAGE
+	clock_timepage_setbase();
+#endif
 #ifndef CONFIG_SCHED_TICKLESS
 	g_system_timer = 0;
 #endif
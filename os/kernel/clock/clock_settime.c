@@ -62,6 +62,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/timepage.h>
 #include <arch/irq.h>
 
 #include "clock/clock.h"
@@ -153,6 +154,10 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 		g_basetime.tv_nsec -= bias.tv_nsec;
 		g_basetime.tv_sec  -= bias.tv_sec;
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+		clock_timepage_setbase();
+#endif
+
 		/* Setup the RTC (lo- or high-res) */
 
 #ifdef CONFIG_RTC
@@ -0,0 +1,164 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/clock/clock_timepage.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/timepage.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+union timepage_u g_timepage __attribute__((aligned(TIMEPAGE_SIZE)));
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static bool g_timepage_valid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline void clock_timepage_barrier(void)
+{
+	__asm__ __volatile__("" : : : "memory");
+}
+
+/* Mark the page as being updated.  The caller has interrupts disabled and
+ * readers run on the same CPU, so a compiler barrier orders the stores.
+ */
+
+static inline void clock_timepage_begin(FAR volatile struct timepage_s *page)
+{
+	page->tp_seq++;
+	clock_timepage_barrier();
+}
+
+static inline void clock_timepage_end(FAR volatile struct timepage_s *page)
+{
+	clock_timepage_barrier();
+	page->tp_seq++;
+}
+
+static int64_t clock_timepage_realoffset(void)
+{
+	return (int64_t)g_basetime.tv_sec * NSEC_PER_SEC + g_basetime.tv_nsec;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_initialize
+ ****************************************************************************/
+
+void clock_timepage_initialize(FAR const volatile uint32_t *counter, uint32_t frequency, bool countdown, FAR const volatile uint32_t *wrapstat, uint32_t wrapmask)
+{
+	FAR volatile struct timepage_s *page = &g_timepage.page;
+	irqstate_t flags;
+
+	DEBUGASSERT(counter != NULL && frequency > 0 && sizeof(struct timepage_s) <= TIMEPAGE_SIZE);
+
+	flags = irqsave();
+	clock_timepage_begin(page);
+
+	page->tp_mult = (uint32_t)(((uint64_t)NSEC_PER_SEC << TIMEPAGE_SHIFT) / frequency);
+	page->tp_countdown = countdown;
+	page->tp_counter = counter;
+	page->tp_wrapstat = wrapstat;
+	page->tp_wrapmask = wrapmask;
+
+	clock_timepage_end(page);
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ ****************************************************************************/
+
+void clock_timepage_update(uint32_t wraps, uint32_t count, FAR const struct timespec *mono)
+{
+	FAR volatile struct timepage_s *page = &g_timepage.page;
+
+	if (page->tp_countdown) {
+		count = UINT32_MAX - count;
+	}
+
+	clock_timepage_begin(page);
+
+	page->tp_wraps = wraps;
+	page->tp_count = ((uint64_t)wraps << 32) | count;
+	page->tp_mono = (uint64_t)mono->tv_sec * NSEC_PER_SEC + mono->tv_nsec;
+	page->tp_realoffset = clock_timepage_realoffset();
+
+	clock_timepage_end(page);
+	g_timepage_valid = (page->tp_counter != NULL);
+}
+
+/****************************************************************************
+ * Name: clock_timepage_setbase
+ ****************************************************************************/
+
+void clock_timepage_setbase(void)
+{
+	FAR volatile struct timepage_s *page = &g_timepage.page;
+	irqstate_t flags;
+
+	flags = irqsave();
+	clock_timepage_begin(page);
+	page->tp_realoffset = clock_timepage_realoffset();
+	clock_timepage_end(page);
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: clock_timepage
+ ****************************************************************************/
+
+FAR const struct timepage_s *clock_timepage(void)
+{
+	if (!g_timepage_valid) {
+		set_errno(ENOSYS);
+		return NULL;
+	}
+
+	return &g_timepage.page;
+}
+
+#endif							/* CONFIG_CLOCK_TIMEPAGE */
@@ -59,6 +59,7 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sched.h>
 #include <string.h>
 #include <errno.h>
@@ -84,6 +85,10 @@
  *   that is performed when a new task is created: The new task has a private,
  *   exact duplicate of the parent task's environment.
  *
+ *   The copy is deferred: the child group only takes a reference on the
+ *   parent's environment here, and whichever group modifies it first gets
+ *   its own copy from env_unshare().
+ *
  * Parameters:
  *   group The child task group to receive the newly allocated copy of the
  *        parent task groups environment structure.
@@ -99,9 +104,7 @@
 int env_dup(FAR struct task_group_s *group)
 {
 	FAR struct tcb_s *ptcb = this_task();
-	FAR char *envp = NULL;
-	size_t envlen;
-	int ret = OK;
+	FAR struct env_s *env;
 
 	DEBUGASSERT(group && ptcb && ptcb->group);
 
@@ -113,22 +116,91 @@ int env_dup(FAR struct task_group_s *group)
 
 	/* Does the parent task have an environment? */
 
-	if (ptcb->group && ptcb->group->tg_envp) {
-		/* Yes..The parent task has an environment, duplicate it */
-
-		envlen = ptcb->group->tg_envsize;
-		envp   = (FAR char *)kumm_malloc(envlen);
-		if (!envp) {
-			ret = -ENOMEM;
-		} else {
-			group->tg_envsize = envlen;
-			group->tg_envp = envp;
-			memcpy(envp, ptcb->group->tg_envp, envlen);
-		}
+	if (ptcb->group && (env = ptcb->group->tg_env) != NULL) {
+		/* Yes..Share it with the child */
+
+		DEBUGASSERT(env->crefs < UINT16_MAX);
+		env->crefs++;
+		group->tg_env = env;
 	}
 
 	sched_unlock();
-	return ret;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the environment of a task group may be modified: create
+ *   an empty environment if the group has none, or take a private copy if
+ *   it is shared with other groups.
+ *
+ * Parameters:
+ *   group The task group about to modify its environment
+ *
+ * Return Value:
+ *   The private environment of the group, or NULL if it could not be
+ *   allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emptions is disabled by caller
+ *
+ ****************************************************************************/
+
+FAR struct env_s *env_unshare(FAR struct task_group_s *group)
+{
+	FAR struct env_s *env = group->tg_env;
+	FAR struct env_s *copy;
+
+	if (env && env->crefs == 1) {
+		return env;
+	}
+
+	copy = (FAR struct env_s *)kmm_zalloc(sizeof(struct env_s));
+	if (!copy) {
+		return NULL;
+	}
+
+	copy->crefs = 1;
+
+	if (env && env->nvars > 0) {
+		/* Copy only the strings in use; the index is copied as is since the
+		 * offsets do not change.
+		 */
+
+		copy->strings = (FAR char *)kumm_malloc(env->size);
+		copy->index = (FAR uint16_t *)kmm_malloc(env->nslots * sizeof(uint16_t));
+		if (!copy->strings || !copy->index) {
+			if (copy->strings) {
+				sched_ufree(copy->strings);
+			}
+
+			if (copy->index) {
+				sched_kfree(copy->index);
+			}
+
+			sched_kfree(copy);
+			return NULL;
+		}
+
+		memcpy(copy->strings, env->strings, env->size);
+		memcpy(copy->index, env->index, env->nslots * sizeof(uint16_t));
+		copy->nvars = env->nvars;
+		copy->nslots = env->nslots;
+		copy->size = env->size;
+		copy->alloc = env->size;
+	}
+
+	/* Drop the reference to the shared environment */
+
+	if (env) {
+		env->crefs--;
+	}
+
+	group->tg_env = copy;
+	return copy;
 }
 
 #endif							/* CONFIG_DISABLE_ENVIRON */
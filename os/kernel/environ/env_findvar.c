@@ -59,8 +59,12 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <sched.h>
+#include <errno.h>
+
+#include <tinyara/kmalloc.h>
 
 #include "environ/environ.h"
 
@@ -91,10 +95,109 @@ static bool env_cmpname(const char *pszname, const char *peqname)
 	return false;
 }
 
+/****************************************************************************
+ * Name: env_hash
+ *
+ * Description:
+ *   FNV-1a hash of a variable name, which ends either with '\0' (a name
+ *   passed by the caller) or with '=' (a name=value string).
+ *
+ ****************************************************************************/
+
+static uint32_t env_hash(FAR const char *name)
+{
+	uint32_t hash = 2166136261u;
+
+	for (; *name != '\0' && *name != '='; name++) {
+		hash = (hash ^ (uint8_t)*name) * 16777619u;
+	}
+
+	return hash;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: env_addindex
+ *
+ * Description:
+ *   Add the name=value string at the given offset of the packed strings to
+ *   the hash index.  The index must have a free slot.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emptions is disabled by caller
+ *
+ ****************************************************************************/
+
+void env_addindex(FAR struct env_s *env, uint16_t offset)
+{
+	uint16_t mask = env->nslots - 1;
+	uint16_t slot;
+
+	slot = env_hash(&env->strings[offset]) & mask;
+	while (env->index[slot] != 0) {
+		slot = (slot + 1) & mask;
+	}
+
+	env->index[slot] = offset + 1;
+}
+
+/****************************************************************************
+ * Name: env_reindex
+ *
+ * Description:
+ *   Rebuild the hash index of an environment, resizing it to nslots slots
+ *   first if it has a different size.  This is needed whenever strings are
+ *   added to a full index or moved in the packed string buffer.
+ *
+ * Parameters:
+ *   env    The environment to index
+ *   nslots The new number of index slots, a power of two at least twice
+ *          the number of variables.
+ *
+ * Return Value:
+ *   Zero on success; -ENOMEM if the new index could not be allocated, in
+ *   which case the old one is left untouched.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emptions is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_reindex(FAR struct env_s *env, uint16_t nslots)
+{
+	FAR uint16_t *index;
+	uint16_t offset;
+
+	DEBUGASSERT(env && (nslots & (nslots - 1)) == 0 && nslots >= 2 * env->nvars);
+
+	if (nslots != env->nslots) {
+		index = (FAR uint16_t *)kmm_malloc(nslots * sizeof(uint16_t));
+		if (!index) {
+			return -ENOMEM;
+		}
+
+		if (env->index) {
+			sched_kfree(env->index);
+		}
+
+		env->index = index;
+		env->nslots = nslots;
+	}
+
+	memset(env->index, 0, nslots * sizeof(uint16_t));
+
+	for (offset = 0; offset < env->size; offset += strlen(&env->strings[offset]) + 1) {
+		env_addindex(env, offset);
+	}
+
+	return OK;
+}
+
 /****************************************************************************
  * Name: env_findvar
  *
@@ -117,21 +220,33 @@ static bool env_cmpname(const char *pszname, const char *peqname)
 
 FAR char *env_findvar(FAR struct task_group_s *group, const char *pname)
 {
-	char *ptr;
-	char *end;
+	FAR struct env_s *env;
+	FAR char *pvar;
+	uint16_t mask;
+	uint16_t slot;
 
 	/* Verify input parameters */
 
 	DEBUGASSERT(group && pname);
 
-	/* Search for a name=value string with matching name */
+	env = group->tg_env;
+	if (!env || env->nvars == 0) {
+		return NULL;
+	}
 
-	end = &group->tg_envp[group->tg_envsize];
-	for (ptr = group->tg_envp; ptr < end && !env_cmpname(pname, ptr); ptr += (strlen(ptr) + 1)) ;
+	/* Probe the index from the slot of the name until an empty slot ends
+	 * the search.
+	 */
 
-	/* Check for success */
+	mask = env->nslots - 1;
+	for (slot = env_hash(pname) & mask; env->index[slot] != 0; slot = (slot + 1) & mask) {
+		pvar = &env->strings[env->index[slot] - 1];
+		if (env_cmpname(pname, pvar)) {
+			return pvar;
+		}
+	}
 
-	return (ptr < end) ? ptr : NULL;
+	return NULL;
 }
 
 #endif							/* CONFIG_DISABLE_ENVIRON */
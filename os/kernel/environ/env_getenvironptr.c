@@ -61,6 +61,7 @@
 #include <sys/types.h>
 #include <tinyara/sched.h>
 #include "sched/sched.h"
+#include "environ/environ.h"
 
 /****************************************************************************
  * Private Data
@@ -93,9 +94,9 @@ FAR char *get_environ_ptr(size_t *envsize)
 	char *ret;
 
 	group = ptcb->group;
-	if (group && group->tg_envp) {
-		*envsize = group->tg_envsize;
-		ret = group->tg_envp;
+	if (group && group->tg_env && group->tg_env->size > 0) {
+		*envsize = group->tg_env->size;
+		ret = group->tg_env->strings;
 	} else {
 		*envsize = 0;
 		set_errno(ENOENT);
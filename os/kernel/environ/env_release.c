@@ -96,22 +96,34 @@
 
 void env_release(FAR struct task_group_s *group)
 {
+	FAR struct env_s *env;
+
 	DEBUGASSERT(group);
 
-	/* Free any allocate environment strings */
+	/* The environment may be shared with other task groups */
+
+	sched_lock();
+	env = group->tg_env;
+	if (env && --env->crefs == 0) {
+		/* This was the last reference.  Free the environment */
+
+		if (env->strings) {
+			sched_ufree(env->strings);
+		}
 
-	if (group->tg_envp) {
-		/* Free the environment */
+		if (env->index) {
+			sched_kfree(env->index);
+		}
 
-		sched_ufree(group->tg_envp);
+		sched_kfree(env);
 	}
 
 	/* In any event, make sure that all environment-related varialbles in the
 	 * task group structure are reset to initial values.
 	 */
 
-	group->tg_envsize = 0;
-	group->tg_envp = NULL;
+	group->tg_env = NULL;
+	sched_unlock();
 }
 
 #endif							/* CONFIG_DISABLE_ENVIRON */
@@ -87,45 +87,37 @@
  * Assumptions:
  *   - Not called from an interrupt handler
  *   - Caller has pre-emptions disabled
- *   - Caller will reallocate the environment structure to the correct size
+ *   - The environment is private to the group (see env_unshare())
  *
  ****************************************************************************/
 
 int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
 {
+	FAR struct env_s *env;
 	FAR char *end;				/* Pointer to the end+1 of the environment */
-	int alloc;					/* Size of the allocated environment */
 	int ret = ERROR;
 
-	DEBUGASSERT(group && pvar);
+	DEBUGASSERT(group && group->tg_env && pvar);
 
-	/* Verify that the pointer lies within the environment region */
-
-	alloc = group->tg_envsize;		/* Size of the allocated environment */
-	end   = &group->tg_envp[alloc];	/* Pointer to the end+1 of the environment */
-
-	if (pvar >= group->tg_envp && pvar < end) {
-		/* Set up for the removal */
+	env = group->tg_env;
+	DEBUGASSERT(env->crefs == 1);
 
-		int   len   = strlen(pvar) + 1;	/* Length of name=value string to remove */
-		char *src   = &pvar[len];		/* Address of name=value string after */
-		char *dest  = pvar;				/* Location to move the next string */
-		int   count = end - src;		/* Number of bytes to move (might be zero) */
+	/* Verify that the pointer lies within the environment region */
 
-		/* Move all of the environment strings after the removed one 'down.'
-		 * this is inefficient, but robably not high duty.
+	end = &env->strings[env->size];
+	if (pvar >= env->strings && pvar < end) {
+		/* Move all of the environment strings after the removed one 'down'
+		 * and drop it from the index.  Since that moves the strings that
+		 * followed it, the whole index is rebuilt; its size does not change
+		 * so this cannot fail.
 		 */
 
-		while (count-- > 0) {
-			*dest++ = *src++;
-		}
-
-		/* Then set to the new allocation size.  The caller is expected to
-		 * call realloc at some point but we don't do that here because the
-		 * caller may add more stuff to the environment.
-		 */
+		int len = strlen(pvar) + 1;
 
-		group->tg_envsize -= len;
+		memmove(pvar, &pvar[len], end - &pvar[len]);
+		env->size -= len;
+		env->nvars--;
+		(void)env_reindex(env, env->nslots);
 		ret = OK;
 	}
 
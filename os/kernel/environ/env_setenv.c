@@ -60,6 +60,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <sched.h>
 #include <string.h>
 #include <errno.h>
@@ -104,10 +105,13 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 {
 	FAR struct tcb_s *rtcb;
 	FAR struct task_group_s *group;
+	FAR struct env_s *env;
 	FAR char *pvar;
-	FAR char *newenvp;
-	int newsize;
-	int varlen;
+	FAR char *newstrings;
+	size_t namelen;
+	size_t varlen;
+	size_t newalloc;
+	uint16_t nslots;
 	int ret = OK;
 
 	/* Verify input parameter */
@@ -142,60 +146,103 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
 	/* Check if the variable already exists */
 
-	if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL) {
-		/* It does! Do we have permission to overwrite the existing value? */
+	pvar = env_findvar(group, name);
+	if (pvar && !overwrite) {
+		/* It does but we have no permission to overwrite the existing value */
 
-		if (!overwrite) {
-			/* No.. then just return success */
+		sched_unlock();
+		return OK;
+	}
+
+	/* The environment is about to change, make sure that it is not shared
+	 * with another task group.  This may move the strings, so look the
+	 * variable up again in the private copy.
+	 */
+
+	env = env_unshare(group);
+	if (!env) {
+		ret = ENOMEM;
+		goto errout_with_lock;
+	}
+
+	if (pvar) {
+		pvar = env_findvar(group, name);
+	}
+
+	/* Get the size of the new name=value string.  The +2 is for the '=' and for
+	 * null terminator
+	 */
+
+	namelen = strlen(name);
+	varlen = namelen + strlen(value) + 2;
+
+	if (pvar) {
+		/* If the new value has the same length as the old one, it can simply
+		 * be replaced in place.
+		 */
 
+		if (strlen(pvar) + 1 == varlen) {
+			strcpy(&pvar[namelen + 1], value);
 			sched_unlock();
 			return OK;
 		}
 
-		/* Yes.. just remove the name=value pair from the environment.  It will
-		 * be added again below.  Note that we are responsible for reallocating
-		 * the environment buffer; this will happen below.
+		/* Otherwise, remove the name=value pair from the environment.  It
+		 * will be added again at the end below.
 		 */
 
 		(void)env_removevar(group, pvar);
 	}
 
-	/* Get the size of the new name=value string.  The +2 is for the '=' and for
-	 * null terminator
-	 */
+	if (env->size + varlen > ENV_MAXSIZE) {
+		ret = ENOMEM;
+		goto errout_with_lock;
+	}
 
-	varlen = strlen(name) + strlen(value) + 2;
+	/* Grow the string buffer geometrically so that a sequence of setenv()
+	 * calls does not reallocate it every time.
+	 */
 
-	/* Then allocate or reallocate the environment buffer */
+	if (env->size + varlen > env->alloc) {
+		newalloc = 2 * env->alloc;
+		if (newalloc < env->size + varlen) {
+			newalloc = env->size + varlen;
+		}
 
-	if (group->tg_envp) {
-		newsize = group->tg_envsize + varlen;
-		newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-		if (!newenvp) {
-			ret = ENOMEM;
-			goto errout_with_lock;
+		if (newalloc > ENV_MAXSIZE) {
+			newalloc = ENV_MAXSIZE;
 		}
 
-		pvar = &newenvp[group->tg_envsize];
-	} else {
-		newsize = varlen;
-		newenvp = (FAR char *)kumm_malloc(newsize);
-		if (!newenvp) {
+		newstrings = (FAR char *)kumm_realloc(env->strings, newalloc);
+		if (!newstrings) {
 			ret = ENOMEM;
 			goto errout_with_lock;
 		}
 
-		pvar = newenvp;
+		env->strings = newstrings;
+		env->alloc = newalloc;
 	}
 
-	/* Save the new buffer and size */
+	/* Keep the index at most half full */
 
-	group->tg_envp = newenvp;
-	group->tg_envsize = newsize;
+	if (2 * (env->nvars + 1) > env->nslots) {
+		nslots = env->nslots ? 2 * env->nslots : ENV_MINSLOTS;
+		if (env_reindex(env, nslots) < 0) {
+			ret = ENOMEM;
+			goto errout_with_lock;
+		}
+	}
 
-	/* Now, put the new name=value string into the environment buffer */
+	/* Now, put the new name=value string at the end of the environment buffer
+	 * and index it.
+	 */
 
+	pvar = &env->strings[env->size];
 	snprintf(pvar, varlen, "%s=%s", name, value);
+	env_addindex(env, env->size);
+	env->size += varlen;
+	env->nvars++;
+
 	sched_unlock();
 	return OK;
 
@@ -96,9 +96,7 @@ int unsetenv(FAR const char *name)
 {
 	FAR struct tcb_s *rtcb = this_task();
 	FAR struct task_group_s *group = rtcb->group;
-	FAR char *pvar;
-	FAR char *newenvp;
-	int newsize;
+	FAR struct env_s *env;
 	int ret = OK;
 
 	DEBUGASSERT(name && group);
@@ -106,24 +104,23 @@ int unsetenv(FAR const char *name)
 	/* Check if the variable exists */
 
 	sched_lock();
-	if (group && (pvar = env_findvar(group, name)) != NULL) {
-		/* It does!  Remove the name=value pair from the environment. */
+	if (group && env_findvar(group, name) != NULL) {
+		/* It does!  Make sure that the environment is private before
+		 * removing the name=value pair from it.
+		 */
 
-		(void)env_removevar(group, pvar);
-
-		/* Reallocate the new environment buffer */
-
-		newsize = group->tg_envsize;
-		newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-		if (!newenvp && (newsize != 0)) {
+		env = env_unshare(group);
+		if (!env) {
 			set_errno(ENOMEM);
 			ret = ERROR;
 		} else {
-			/* Save the new environment pointer (it might have changed due to
-			 * reallocation.
-			 */
+			(void)env_removevar(group, env_findvar(group, name));
+
+			/* Free the environment once the last variable is gone */
 
-			group->tg_envp = newenvp;
+			if (env->nvars == 0) {
+				env_release(group);
+			}
 		}
 	}
 
@@ -60,6 +60,8 @@
 #include <tinyara/config.h>
 #include <tinyara/sched.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -69,10 +71,37 @@
 #define env_release(group) (0)
 #else
 
+/* The hash index holds 16-bit offsets, which bounds the size of the packed
+ * strings.  It is kept at most half full so that every probe sequence ends
+ * on an empty slot.
+ */
+
+#define ENV_MAXSIZE        UINT16_MAX
+#define ENV_MINSLOTS       8
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
 
+/* The environment of a task group.  The name=value strings are packed one
+ * after another in insertion order, which is also the layout returned by
+ * get_environ_ptr().  A hash index over the names maps each name to the
+ * offset of its string, so lookups do not have to scan the strings.
+ *
+ * A new task group shares its parent's environment and only takes a private
+ * copy on its first modification (see env_unshare()).
+ */
+
+struct env_s {
+	uint16_t crefs;				/* Number of task groups sharing the environment */
+	uint16_t nvars;				/* Number of name=value strings */
+	uint16_t nslots;			/* Number of index slots, a power of two */
+	uint16_t size;				/* Bytes of name=value strings in use */
+	uint16_t alloc;				/* Bytes allocated for the strings */
+	FAR char *strings;			/* Packed name=value strings */
+	FAR uint16_t *index;		/* String offset + 1 per slot, 0 if empty */
+};
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -97,6 +126,9 @@ void env_release(FAR struct task_group_s *group);
 
 FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 int env_removevar(FAR struct task_group_s *group, FAR char *pvar);
+FAR struct env_s *env_unshare(FAR struct task_group_s *group);
+void env_addindex(FAR struct env_s *env, uint16_t offset);
+int env_reindex(FAR struct env_s *env, uint16_t nslots);
 
 #undef EXTERN
 #ifdef __cplusplus
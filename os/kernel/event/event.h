@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __KERNEL_EVENT_EVENT_H
+#define __KERNEL_EVENT_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#include <tinyara/event.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A task waiting on an event group.  It lives on the stack of the waiting
+ * task and is linked in the wait list of the group until it is satisfied,
+ * times out or is interrupted.
+ */
+
+struct event_wait_s {
+	dq_entry_t node;			/* Link in the wait list */
+	event_set_t set;			/* Awaited events */
+	int flags;					/* EVENT_WAITALL, EVENT_CLEAR */
+	event_set_t result;			/* Events posted when satisfied */
+	bool satisfied;
+	sem_t sem;					/* Posted when satisfied */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline bool event_satisfied(event_set_t posted, event_set_t set, int flags)
+{
+	if ((flags & EVENT_WAITALL) != 0) {
+		return (posted & set) == set;
+	}
+
+	return (posted & set) != 0;
+}
+
+#endif							/* __KERNEL_EVENT_EVENT_H */
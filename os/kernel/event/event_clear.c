@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/event/event_clear.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+
+#include <tinyara/event.h>
+#include <arch/irq.h>
+
+#ifdef CONFIG_EVENT_GROUPS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: event_clear
+ *
+ * Description:
+ *   Clear events of an event group.  Nobody is woken.
+ *
+ * Parameters:
+ *   event - the event group
+ *   set   - the events to clear
+ *
+ * Return Value:
+ *   OK, or ERROR with errno set to EINVAL.
+ *
+ ****************************************************************************/
+
+int event_clear(FAR event_t *event, event_set_t set)
+{
+	irqstate_t flags;
+
+	if (event == NULL) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	flags = irqsave();
+	event->set &= ~set;
+	irqrestore(flags);
+	return OK;
+}
+
+#endif							/* CONFIG_EVENT_GROUPS */
@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/event/event_destroy.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <queue.h>
+
+#include <tinyara/event.h>
+#include <arch/irq.h>
+
+#ifdef CONFIG_EVENT_GROUPS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: event_destroy
+ *
+ * Description:
+ *   Destroy an event group.
+ *
+ * Parameters:
+ *   event - the event group
+ *
+ * Return Value:
+ *   OK, or ERROR with errno set to EINVAL, or to EBUSY while tasks wait on
+ *   the group.
+ *
+ ****************************************************************************/
+
+int event_destroy(FAR event_t *event)
+{
+	irqstate_t flags;
+
+	if (event == NULL) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	flags = irqsave();
+	if (!dq_empty(&event->waitlist)) {
+		irqrestore(flags);
+		set_errno(EBUSY);
+		return ERROR;
+	}
+
+	event->set = 0;
+	irqrestore(flags);
+	return OK;
+}
+
+#endif							/* CONFIG_EVENT_GROUPS */
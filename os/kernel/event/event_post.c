@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/event/event_post.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <errno.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#include <tinyara/event.h>
+#include <arch/irq.h>
+
+#include "event/event.h"
+
+#ifdef CONFIG_EVENT_GROUPS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: event_post
+ *
+ * Description:
+ *   Post events to an event group and wake every waiting task whose wait
+ *   is satisfied.  The events cleared by the woken EVENT_CLEAR waiters are
+ *   cleared only after all the waiters have been checked, so that every
+ *   task waiting for the same event sees it.  This function may be called
+ *   from interrupt handlers.
+ *
+ * Parameters:
+ *   event - the event group
+ *   set   - the events to post
+ *
+ * Return Value:
+ *   OK, or ERROR with errno set to EINVAL.
+ *
+ ****************************************************************************/
+
+int event_post(FAR event_t *event, event_set_t set)
+{
+	FAR struct event_wait_s *wait;
+	FAR struct event_wait_s *next;
+	event_set_t clear = 0;
+	irqstate_t flags;
+
+	if (event == NULL) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	flags = irqsave();
+	event->set |= set;
+
+	for (wait = (FAR struct event_wait_s *)dq_peek(&event->waitlist); wait != NULL; wait = next) {
+		next = (FAR struct event_wait_s *)dq_next(&wait->node);
+
+		if (event_satisfied(event->set, wait->set, wait->flags)) {
+			wait->result = event->set;
+			wait->satisfied = true;
+			if ((wait->flags & EVENT_CLEAR) != 0) {
+				clear |= wait->set;
+			}
+
+			dq_rem(&wait->node, &event->waitlist);
+			sem_post(&wait->sem);
+		}
+	}
+
+	event->set &= ~clear;
+	irqrestore(flags);
+	return OK;
+}
+
+#endif							/* CONFIG_EVENT_GROUPS */
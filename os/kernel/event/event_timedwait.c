@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/event/event_timedwait.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/event.h>
+#include <tinyara/semaphore.h>
+#include <arch/irq.h>
+
+#include "event/event.h"
+
+#ifdef CONFIG_EVENT_GROUPS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: event_timedwait
+ *
+ * Description:
+ *   Wait until any of the events 'set' is posted to the event group, or
+ *   all of them with EVENT_WAITALL.  With EVENT_CLEAR the awaited events
+ *   are cleared before returning.
+ *
+ *   The waiting task queues itself on the group and blocks on a semaphore
+ *   of its own, which event_post() posts only once the wait is satisfied.
+ *   Tasks are not woken to re-check a condition that is still unmet.
+ *
+ * Parameters:
+ *   event   - the event group
+ *   set     - the awaited events
+ *   flags   - EVENT_WAITALL, EVENT_CLEAR
+ *   abstime - the absolute CLOCK_REALTIME time to give up, or NULL
+ *   result  - returns the posted events at wake up, may be NULL
+ *
+ * Return Value:
+ *   OK, or ERROR with errno set to:
+ *
+ *     EINVAL:    Invalid argument
+ *     EINTR:     The wait was interrupted by a signal
+ *     ETIMEDOUT: 'abstime' has passed
+ *
+ ****************************************************************************/
+
+int event_timedwait(FAR event_t *event, event_set_t set, int flags, FAR const struct timespec *abstime, FAR event_set_t *result)
+{
+	struct event_wait_s wait;
+	irqstate_t saved_state;
+	int errcode = OK;
+	int ret;
+
+	if (event == NULL || set == 0 || up_interrupt_context()) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	saved_state = irqsave();
+
+	/* Return at once if the events are already posted */
+
+	if (event_satisfied(event->set, set, flags)) {
+		if (result != NULL) {
+			*result = event->set;
+		}
+
+		if ((flags & EVENT_CLEAR) != 0) {
+			event->set &= ~set;
+		}
+
+		irqrestore(saved_state);
+		return OK;
+	}
+
+	wait.set = set;
+	wait.flags = flags;
+	wait.result = 0;
+	wait.satisfied = false;
+
+	/* The semaphore is used for signaling and must not boost priorities */
+
+	sem_init(&wait.sem, 0, 0);
+	sem_setprotocol(&wait.sem, SEM_PRIO_NONE);
+	dq_addlast(&wait.node, &event->waitlist);
+
+	if (abstime != NULL) {
+		ret = sem_timedwait(&wait.sem, abstime);
+	} else {
+		ret = sem_wait(&wait.sem);
+	}
+
+	if (ret < 0) {
+		errcode = get_errno();
+	}
+
+	/* The wait may have been satisfied between the timeout or the signal
+	 * and this point.  Otherwise the wait is still queued.
+	 */
+
+	if (!wait.satisfied) {
+		dq_rem(&wait.node, &event->waitlist);
+	} else {
+		errcode = OK;
+	}
+
+	irqrestore(saved_state);
+	sem_destroy(&wait.sem);
+
+	if (errcode != OK) {
+		set_errno(errcode);
+		return ERROR;
+	}
+
+	if (result != NULL) {
+		*result = wait.result;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: event_wait
+ *
+ * Description:
+ *   Same as event_timedwait() without a timeout.
+ *
+ ****************************************************************************/
+
+int event_wait(FAR event_t *event, event_set_t set, int flags, FAR event_set_t *result)
+{
+	return event_timedwait(event, set, flags, NULL, result);
+}
+
+#endif							/* CONFIG_EVENT_GROUPS */
@@ -0,0 +1,266 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/hrtimer/hrtimer.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/hrtimer.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pending timers, a binary min-heap ordered by expiry time */
+
+static FAR struct hrtimer_s *g_hrtimer_heap[CONFIG_HRTIMER_NTIMERS];
+static uint16_t g_hrtimer_count;
+
+/* True while hrtimer_expiration() runs the callbacks; the one-shot timer
+ * is re-armed once they are done.
+ */
+
+static bool g_hrtimer_expiring;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline void hrtimer_place(int index, FAR struct hrtimer_s *timer)
+{
+	g_hrtimer_heap[index] = timer;
+	timer->index = index;
+}
+
+static void hrtimer_siftup(int index)
+{
+	FAR struct hrtimer_s *timer = g_hrtimer_heap[index];
+	int parent;
+
+	while (index > 0) {
+		parent = (index - 1) / 2;
+		if (g_hrtimer_heap[parent]->expiry <= timer->expiry) {
+			break;
+		}
+
+		hrtimer_place(index, g_hrtimer_heap[parent]);
+		index = parent;
+	}
+
+	hrtimer_place(index, timer);
+}
+
+static void hrtimer_siftdown(int index)
+{
+	FAR struct hrtimer_s *timer = g_hrtimer_heap[index];
+	int child;
+
+	for (;;) {
+		child = 2 * index + 1;
+		if (child >= g_hrtimer_count) {
+			break;
+		}
+
+		if (child + 1 < g_hrtimer_count && g_hrtimer_heap[child + 1]->expiry < g_hrtimer_heap[child]->expiry) {
+			child++;
+		}
+
+		if (timer->expiry <= g_hrtimer_heap[child]->expiry) {
+			break;
+		}
+
+		hrtimer_place(index, g_hrtimer_heap[child]);
+		index = child;
+	}
+
+	hrtimer_place(index, timer);
+}
+
+static void hrtimer_remove(FAR struct hrtimer_s *timer)
+{
+	FAR struct hrtimer_s *last;
+	int index = timer->index;
+
+	last = g_hrtimer_heap[--g_hrtimer_count];
+	if (index < g_hrtimer_count) {
+		/* Move the last timer into the hole and restore the heap order */
+
+		hrtimer_place(index, last);
+		hrtimer_siftup(index);
+		hrtimer_siftdown(last->index);
+	}
+
+	timer->index = -1;
+}
+
+/* Arm the one-shot timer for the earliest pending timer */
+
+static void hrtimer_reprogram(void)
+{
+	uint64_t now;
+	uint64_t expiry;
+
+	if (g_hrtimer_expiring) {
+		return;
+	}
+
+	if (g_hrtimer_count == 0) {
+		up_hrtimer_cancel();
+		return;
+	}
+
+	now = hrtimer_now();
+	expiry = g_hrtimer_heap[0]->expiry;
+	up_hrtimer_start(expiry > now ? expiry - now : 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_init
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback, FAR void *arg)
+{
+	DEBUGASSERT(timer != NULL && callback != NULL);
+
+	timer->expiry = 0;
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->index = -1;
+}
+
+/****************************************************************************
+ * Name: hrtimer_now
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void)
+{
+	struct timespec ts;
+
+	(void)clock_systimespec(&ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t expiry)
+{
+	irqstate_t flags;
+
+	DEBUGASSERT(timer != NULL && timer->callback != NULL);
+
+	flags = irqsave();
+
+	if (timer->index >= 0) {
+		hrtimer_remove(timer);
+	} else if (g_hrtimer_count >= CONFIG_HRTIMER_NTIMERS) {
+		irqrestore(flags);
+		return -ENOSPC;
+	}
+
+	timer->expiry = expiry;
+	hrtimer_place(g_hrtimer_count++, timer);
+	hrtimer_siftup(timer->index);
+
+	/* The one-shot timer only needs to move if this timer is now first */
+
+	if (timer->index == 0) {
+		hrtimer_reprogram();
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+	irqstate_t flags;
+	bool first;
+
+	DEBUGASSERT(timer != NULL);
+
+	flags = irqsave();
+
+	if (timer->index < 0) {
+		irqrestore(flags);
+		return -ENOENT;
+	}
+
+	first = (timer->index == 0);
+	hrtimer_remove(timer);
+	if (first) {
+		hrtimer_reprogram();
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_expiration
+ ****************************************************************************/
+
+void hrtimer_expiration(void)
+{
+	FAR struct hrtimer_s *timer;
+	uint64_t now;
+
+	g_hrtimer_expiring = true;
+
+	now = hrtimer_now();
+	while (g_hrtimer_count > 0 && g_hrtimer_heap[0]->expiry <= now) {
+		timer = g_hrtimer_heap[0];
+		hrtimer_remove(timer);
+
+		/* The callback may restart this timer or any other */
+
+		timer->callback(timer);
+		now = hrtimer_now();
+	}
+
+	g_hrtimer_expiring = false;
+	hrtimer_reprogram();
+}
+
+#endif							/* CONFIG_HRTIMER */
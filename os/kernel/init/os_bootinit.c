@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/init/os_bootinit.c
+ *
+ * Parallel, dependency ordered board initialization.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kthread.h>
+#include <tinyara/bootinit.h>
+#include <tinyara/boottime.h>
+
+#ifdef CONFIG_BOOTINIT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BOOTINIT_NWORKERS
+#define CONFIG_BOOTINIT_NWORKERS 3
+#endif
+
+#ifndef CONFIG_BOOTINIT_STACKSIZE
+#define CONFIG_BOOTINIT_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_BOOTINIT_PRIORITY
+#define CONFIG_BOOTINIT_PRIORITY 240
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bootinit_s {
+	FAR const struct bootinit_step_s *steps;
+	uint32_t all;				/* Set of all the steps of the table */
+	uint32_t started;			/* Steps taken by a worker */
+	uint32_t done;				/* Steps completed */
+	int nsteps;
+	int nfailed;
+	int nwaiting;				/* Workers waiting on readysem */
+	sem_t exclsem;				/* Protects the fields above */
+	sem_t readysem;				/* Posted when a step completes */
+	sem_t exitsem;				/* Posted by each helper when it exits */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bootinit_s g_bootinit;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void bootinit_semtake(FAR sem_t *sem)
+{
+	while (sem_wait(sem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+}
+
+/* Check that every dependency is in the table and that there is no cycle,
+ * by completing the steps in dependency order on paper.
+ */
+
+static bool bootinit_validate(FAR const struct bootinit_step_s *steps, int nsteps, uint32_t all)
+{
+	uint32_t done = 0;
+	uint32_t prev;
+	int i;
+
+	do {
+		prev = done;
+		for (i = 0; i < nsteps; i++) {
+			if ((steps[i].deps & ~all) != 0) {
+				return false;
+			}
+
+			if ((steps[i].deps & ~done) == 0) {
+				done |= BOOTINIT_DEP(i);
+			}
+		}
+	} while (done != prev);
+
+	return done == all;
+}
+
+/* Take the lowest numbered step whose dependencies are complete, -1 if
+ * there is none right now.  Called with exclsem held.
+ */
+
+static int bootinit_next(FAR struct bootinit_s *priv)
+{
+	int i;
+
+	for (i = 0; i < priv->nsteps; i++) {
+		uint32_t bit = BOOTINIT_DEP(i);
+
+		if ((priv->started & bit) == 0 && (priv->steps[i].deps & ~priv->done) == 0) {
+			priv->started |= bit;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void bootinit_work(FAR struct bootinit_s *priv, int worker)
+{
+	FAR const struct bootinit_step_s *step;
+	uint32_t start;
+	int index;
+	int ret;
+
+	bootinit_semtake(&priv->exclsem);
+
+	while (priv->done != priv->all) {
+		index = bootinit_next(priv);
+		if (index < 0) {
+			/* Everything left depends on steps still running */
+
+			priv->nwaiting++;
+			sem_post(&priv->exclsem);
+			bootinit_semtake(&priv->readysem);
+			bootinit_semtake(&priv->exclsem);
+			continue;
+		}
+
+		sem_post(&priv->exclsem);
+
+		step = &priv->steps[index];
+		svdbg("%s on worker %d\n", step->name, worker);
+
+		start = boottime_now();
+		ret = step->init();
+		boottime_record(step->name, start, ret, worker);
+
+		if (ret < 0) {
+			sdbg("ERROR: %s failed: %d\n", step->name, ret);
+		}
+
+		bootinit_semtake(&priv->exclsem);
+
+		if (ret < 0) {
+			priv->nfailed++;
+		}
+
+		priv->done |= BOOTINIT_DEP(index);
+
+		/* Wake up the idle workers, new steps may have become ready or the
+		 * table may be complete.
+		 */
+
+		while (priv->nwaiting > 0) {
+			priv->nwaiting--;
+			sem_post(&priv->readysem);
+		}
+	}
+
+	sem_post(&priv->exclsem);
+}
+
+static int bootinit_worker(int argc, FAR char *argv[])
+{
+	DEBUGASSERT(argc == 2);
+
+	bootinit_work(&g_bootinit, atoi(argv[1]));
+	sem_post(&g_bootinit.exitsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootinit_run
+ ****************************************************************************/
+
+int bootinit_run(FAR const struct bootinit_step_s *steps, int nsteps)
+{
+	FAR struct bootinit_s *priv = &g_bootinit;
+	FAR char *argv[2];
+	char arg[4];
+	uint32_t all;
+	int nhelpers;
+	int pid;
+	int i;
+
+	if (nsteps <= 0 || nsteps > BOOTINIT_MAXSTEPS) {
+		return -EINVAL;
+	}
+
+	all = nsteps == BOOTINIT_MAXSTEPS ? 0xffffffff : BOOTINIT_DEP(nsteps) - 1;
+	if (!bootinit_validate(steps, nsteps, all)) {
+		sdbg("ERROR: cyclic or dangling dependencies\n");
+		return -EINVAL;
+	}
+
+	priv->steps = steps;
+	priv->nsteps = nsteps;
+	priv->all = all;
+	priv->started = 0;
+	priv->done = 0;
+	priv->nfailed = 0;
+	priv->nwaiting = 0;
+	sem_init(&priv->exclsem, 0, 1);
+	sem_init(&priv->readysem, 0, 0);
+	sem_init(&priv->exitsem, 0, 0);
+
+	/* The caller is worker 0, the helpers are started with the priority of
+	 * the board initialization thread so that none of them preempts the
+	 * others for long.
+	 */
+
+	nhelpers = 0;
+	argv[1] = NULL;
+	for (i = 1; i < CONFIG_BOOTINIT_NWORKERS && i < nsteps; i++) {
+		snprintf(arg, sizeof(arg), "%d", i);
+		argv[0] = arg;
+		pid = kernel_thread("bootinit", CONFIG_BOOTINIT_PRIORITY, CONFIG_BOOTINIT_STACKSIZE, (main_t)bootinit_worker, (FAR char *const *)argv);
+		if (pid < 0) {
+			sdbg("ERROR: failed to start worker %d\n", i);
+			break;
+		}
+
+		nhelpers++;
+	}
+
+	bootinit_work(priv, 0);
+
+	while (nhelpers-- > 0) {
+		bootinit_semtake(&priv->exitsem);
+	}
+
+	sem_destroy(&priv->exclsem);
+	sem_destroy(&priv->readysem);
+	sem_destroy(&priv->exitsem);
+
+	return priv->nfailed;
+}
+
+#endif							/* CONFIG_BOOTINIT */
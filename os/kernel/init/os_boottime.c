@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/init/os_boottime.c
+ *
+ * The boot time profile: a static table of time stamped milestones and
+ * initialization steps.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/boottime.h>
+
+#ifdef CONFIG_BOOTTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BOOTTIME_NEVENTS
+#define CONFIG_BOOTTIME_NEVENTS 32
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct boottime_event_s g_bootevents[CONFIG_BOOTTIME_NEVENTS];
+static int g_nbootevents;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Reserve the next entry, NULL once the table is full */
+
+static FAR struct boottime_event_s *boottime_newevent(void)
+{
+	FAR struct boottime_event_s *event = NULL;
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (g_nbootevents < CONFIG_BOOTTIME_NEVENTS) {
+		event = &g_bootevents[g_nbootevents++];
+	}
+	irqrestore(flags);
+
+	return event;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_now
+ ****************************************************************************/
+
+uint32_t boottime_now(void)
+{
+#ifdef CONFIG_ARCH_HAVE_BOOTTIME
+	return up_boottime();
+#else
+	return (uint32_t)TICK2USEC(clock_systimer());
+#endif
+}
+
+/****************************************************************************
+ * Name: boottime_mark
+ ****************************************************************************/
+
+void boottime_mark(FAR const char *name)
+{
+	uint32_t now = boottime_now();
+	FAR struct boottime_event_s *event;
+
+	event = boottime_newevent();
+	if (event) {
+		event->start = now;
+		event->end = now;
+		event->result = OK;
+		event->worker = -1;
+		event->name = name;
+	}
+}
+
+/****************************************************************************
+ * Name: boottime_record
+ ****************************************************************************/
+
+void boottime_record(FAR const char *name, uint32_t start, int result, int worker)
+{
+	uint32_t now = boottime_now();
+	FAR struct boottime_event_s *event;
+
+	event = boottime_newevent();
+	if (event) {
+		event->start = start;
+		event->end = now;
+		event->result = (int16_t)result;
+		event->worker = (int8_t)worker;
+		event->name = name;
+	}
+}
+
+/****************************************************************************
+ * Name: boottime_timeline
+ ****************************************************************************/
+
+FAR const struct boottime_event_s *boottime_timeline(FAR int *nevents)
+{
+	*nevents = g_nbootevents;
+	return g_bootevents;
+}
+
+#endif							/* CONFIG_BOOTTIME */
@@ -65,6 +65,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/boottime.h>
 #include <tinyara/init.h>
 #include <tinyara/kthread.h>
 #include <tinyara/userspace.h>
@@ -257,12 +258,14 @@ static inline void os_do_appstart(void)
 	 */
 
 	board_initialize();
+	boottime_mark("board");
 #endif
 
 #ifdef CONFIG_NET
 	/* Initialize the network system & Create network task if required */
 
 	net_initialize();
+	boottime_mark("net");
 #endif
 
 	/* Start the application initialization task.  In a flat build, this is
@@ -291,6 +294,7 @@ static inline void os_do_appstart(void)
 	pid = task_create("appmain", SCHED_PRIORITY_DEFAULT, CONFIG_USERMAIN_STACKSIZE, (main_t)CONFIG_USER_ENTRYPOINT, (FAR char *const *)NULL);
 #endif
 	ASSERT(pid > 0);
+	boottime_mark("appmain");
 }
 
 #elif defined(CONFIG_INIT_FILEPATH)
@@ -304,12 +308,14 @@ static inline void os_do_appstart(void)
 	 */
 
 	board_initialize();
+	boottime_mark("board");
 #endif
 
 #ifdef CONFIG_NET
 	/* Initialize the network system & Create network task if required */
 
 	net_initialize();
+	boottime_mark("net");
 #endif
 
 	/* Start the application initialization program from a program in a
@@ -321,6 +327,7 @@ static inline void os_do_appstart(void)
 
 	ret = exec(CONFIG_USER_INITPATH, NULL, CONFIG_INIT_SYMTAB, CONFIG_INIT_NEXPORTS);
 	ASSERT(ret >= 0);
+	boottime_mark("init");
 }
 
 #elif defined(CONFIG_INIT_NONE)
@@ -442,6 +449,8 @@ int os_bringup(void)
 	 * created by the IDLE task.
 	 */
 
+	boottime_mark("bringup");
+
 #if !defined(CONFIG_DISABLE_ENVIRON) && defined(CONFIG_PATH_INITIAL)
 	(void)setenv("PATH", CONFIG_PATH_INITIAL, 1);
 #endif
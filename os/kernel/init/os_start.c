@@ -70,6 +70,8 @@
 #include  <tinyara/mm/shm.h>
 #include  <tinyara/kmalloc.h>
 #include  <tinyara/init.h>
+#include  <tinyara/boottime.h>
+#include  <tinyara/metrics.h>
 
 #include  "sched/sched.h"
 #include  "signal/signal.h"
@@ -274,6 +276,7 @@ void os_start(void)
 	int i;
 
 	slldbg("Entry\n");
+	boottime_mark("os_start");
 
 	/* Initialize RTOS Data ************************************************** */
 	/* Initialize all task lists */
@@ -352,7 +355,11 @@ void os_start(void)
 
 	/* Then add the idle task's TCB to the head of the ready to run list */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	(void)sched_rtrinsert(&g_idletcb.cmn);
+#else
 	dq_addfirst((FAR dq_entry_t *)&g_idletcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
 
 	/* Initialize the processor-specific portion of the TCB */
 
@@ -402,6 +409,8 @@ void os_start(void)
 	}
 #endif
 
+	boottime_mark("mm");
+
 #if defined(CONFIG_SCHED_HAVE_PARENT) && defined(CONFIG_SCHED_CHILD_STATUS)
 	/* Initialize tasking data structures */
 
@@ -439,6 +448,9 @@ void os_start(void)
 	{
 		clock_initialize();
 	}
+
+	boottime_mark("clock");
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 #ifdef CONFIG_HAVE_WEAKFUNCTIONS
 	if (timer_initialize != NULL)
@@ -485,6 +497,7 @@ void os_start(void)
 	/* Initialize the file system (needed to support device drivers) */
 
 	fs_initialize();
+	boottime_mark("fs");
 #endif
 
 #ifdef CONFIG_NET
@@ -507,6 +520,7 @@ void os_start(void)
 	 */
 
 	up_initialize();
+	boottime_mark("up_initialize");
 
 #if defined(CONFIG_TTRACE)
 	ttrace_init();
@@ -523,6 +537,13 @@ void os_start(void)
 	 */
 
 	lib_initialize();
+	boottime_mark("lib");
+
+#ifdef CONFIG_METRICS
+	/* Register the metrics of the kernel */
+
+	metrics_initialize();
+#endif
 
 	/* IDLE Group Initialization **********************************************/
 #ifdef HAVE_TASK_GROUP
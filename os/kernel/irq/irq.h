@@ -70,6 +70,12 @@
 #define MAX_IRQNAME_SIZE 31
 #endif
 
+/* Handler durations are counted in power-of-two microsecond buckets */
+
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+#define IRQ_LATENCY_NBUCKETS 8
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -81,6 +87,14 @@ struct irq {
 	char irq_name[MAX_IRQNAME_SIZE + 1]; /* Includes the terminating Null */
 	size_t count;
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+	uint64_t cputime;			/* Cycles spent in the handler */
+#endif
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	uint32_t maxtime;			/* Longest run of the handler in cycles */
+	uint64_t totaltime;			/* Cycles of all runs of the handler */
+	uint16_t hist[IRQ_LATENCY_NBUCKETS];	/* Runs by duration */
+#endif
 };
 
 extern struct irq g_irqvector[NR_IRQS];
@@ -103,6 +117,12 @@ extern "C" {
 void weak_function irq_initialize(void);
 int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+void irq_csabort(void);
+void irq_latency_isr(int irq, uint32_t elapsed);
+void irq_latency_info(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
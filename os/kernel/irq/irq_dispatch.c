@@ -59,8 +59,12 @@
 #include <debug.h>
 #include <tinyara/arch.h>
 #include <tinyara/irq.h>
+#include <tinyara/ttrace.h>
 
 #include "irq/irq.h"
+#ifdef CONFIG_SCHED_CPUTIME
+#include "sched/sched.h"
+#endif
 
 /****************************************************************************
  * Definitions
@@ -95,10 +99,13 @@
  *   logic.
  *
  ***************************************************************************/
-void irq_dispatch(int irq, FAR void *context)
+void ramfunc_function irq_dispatch(int irq, FAR void *context)
 {
 	xcpt_t vector;
 	FAR void *arg;
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	uint32_t start;
+#endif
 
 	/* Perform some sanity checks */
 
@@ -120,5 +127,29 @@ void irq_dispatch(int irq, FAR void *context)
 
 	/* Then dispatch to the interrupt handler */
 
+	ttrace_irq_enter(irq);
+#ifdef CONFIG_SCHED_CPUTIME
+	sched_cputime_irqenter();
+#endif
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	irq_csabort();
+	start = up_perf_gettime();
+#endif
 	vector(irq, context, arg);
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	if ((unsigned)irq < NR_IRQS) {
+		irq_latency_isr(irq, up_perf_gettime() - start);
+	}
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+#if NR_IRQS > 0
+	if ((unsigned)irq < NR_IRQS) {
+		g_irqvector[irq].cputime += sched_cputime_irqleave();
+	} else
+#endif
+	{
+		(void)sched_cputime_irqleave();
+	}
+#endif
+	ttrace_irq_exit(irq);
 }
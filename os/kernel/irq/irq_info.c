@@ -61,12 +61,34 @@ void irq_info(void)
 	uint16_t i;
 	uint16_t j;
 
+#if defined(CONFIG_SCHED_CPUTIME) && defined(CONFIG_DEBUG_IRQ_LATENCY)
+	printf(" %5s | %7s | %9s | %12s | %7s | %7s | %3s \n", "INDEX", "IRQ_NUM", "INT_COUNT", "TIME(us)", "MAX(us)", "AVG(us)", "ISR_NAME");
+	printf("-------|---------|-----------|--------------|---------|---------|----------\n");
+#elif defined(CONFIG_SCHED_CPUTIME)
+	printf(" %5s | %7s | %9s | %12s | %3s \n", "INDEX", "IRQ_NUM", "INT_COUNT", "TIME(us)", "ISR_NAME");
+	printf("-------|---------|-----------|--------------|----------\n");
+#elif defined(CONFIG_DEBUG_IRQ_LATENCY)
+	printf(" %5s | %7s | %9s | %7s | %7s | %3s \n", "INDEX", "IRQ_NUM", "INT_COUNT", "MAX(us)", "AVG(us)", "ISR_NAME");
+	printf("-------|---------|-----------|---------|---------|----------\n");
+#else
 	printf(" %5s | %7s | %9s | %3s \n", "INDEX", "IRQ_NUM", "INT_COUNT", "ISR_NAME");
 	printf("-------|---------|-----------|----------\n");
+#endif
 	for (i = 0, j = 0; i < NR_IRQS; i++) {
 		if (g_irqvector[i].handler != irq_unexpected_isr) {
 			j++;
-			printf(" %5d | %7d | %9d | %s \n", j, i, g_irqvector[i].count, g_irqvector[i].irq_name);
+			printf(" %5d | %7d | %9d |", j, i, g_irqvector[i].count);
+#ifdef CONFIG_SCHED_CPUTIME
+			printf(" %12lu |", (unsigned long)(g_irqvector[i].cputime / CONFIG_ARCH_PERF_CYCLES_PER_USEC));
+#endif
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+			printf(" %7lu | %7lu |", (unsigned long)(g_irqvector[i].maxtime / CONFIG_ARCH_PERF_CYCLES_PER_USEC), g_irqvector[i].count ? (unsigned long)(g_irqvector[i].totaltime / g_irqvector[i].count / CONFIG_ARCH_PERF_CYCLES_PER_USEC) : 0ul);
+#endif
+			printf(" %s \n", g_irqvector[i].irq_name);
 		}
 	}
+
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+	irq_latency_info();
+#endif
 }
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/irq/irq_latency.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_DEBUG_IRQ_LATENCY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The critical section in progress and the longest one seen */
+
+struct irq_cs_s {
+	uint32_t start;				/* Cycle counter when IRQs were masked */
+	FAR void *caller;			/* Address of the irqsave() call */
+	bool active;				/* IRQs were masked by irqsave() */
+	uint32_t max;				/* Longest critical section in cycles */
+	FAR void *maxcaller;		/* Address of its irqsave() call */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct irq_cs_s g_irqcs;
+
+static const char *g_irqhist_labels[IRQ_LATENCY_NBUCKETS] = {
+	"<1", "<2", "<4", "<8", "<16", "<32", "<64", ">=64"
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_csbegin and irq_csend
+ *
+ * Description:
+ *   Called by irqsave() when it masks IRQs and by irqrestore() and
+ *   irqenable() when they unmask them.  The caller of the irqsave() that
+ *   began the longest critical section is kept.  These run with IRQs
+ *   masked and must not call irqsave() themselves.
+ *
+ ****************************************************************************/
+
+void irq_csbegin(void)
+{
+	g_irqcs.start = up_perf_gettime();
+	g_irqcs.caller = __builtin_return_address(0);
+	g_irqcs.active = true;
+}
+
+void irq_csend(void)
+{
+	uint32_t elapsed;
+
+	if (!g_irqcs.active) {
+		return;
+	}
+
+	elapsed = up_perf_gettime() - g_irqcs.start;
+	g_irqcs.active = false;
+	if (elapsed > g_irqcs.max) {
+		g_irqcs.max = elapsed;
+		g_irqcs.maxcaller = g_irqcs.caller;
+	}
+}
+
+/****************************************************************************
+ * Name: irq_csabort
+ *
+ * Description:
+ *   Drop the critical section in progress.  An interrupt was taken, so IRQs
+ *   were unmasked by a context switch rather than by irqrestore().
+ *
+ ****************************************************************************/
+
+void irq_csabort(void)
+{
+	g_irqcs.active = false;
+}
+
+/****************************************************************************
+ * Name: irq_latency_isr
+ *
+ * Description:
+ *   Record the duration of one run of the handler of 'irq'.
+ *
+ ****************************************************************************/
+
+void irq_latency_isr(int irq, uint32_t elapsed)
+{
+	FAR struct irq *vector = &g_irqvector[irq];
+	uint32_t usec = elapsed / CONFIG_ARCH_PERF_CYCLES_PER_USEC;
+	int bucket;
+
+	if (elapsed > vector->maxtime) {
+		vector->maxtime = elapsed;
+	}
+
+	vector->totaltime += elapsed;
+
+	for (bucket = 0; usec > 0 && bucket < IRQ_LATENCY_NBUCKETS - 1; bucket++) {
+		usec >>= 1;
+	}
+
+	if (vector->hist[bucket] < UINT16_MAX) {
+		vector->hist[bucket]++;
+	}
+}
+
+/****************************************************************************
+ * Name: irq_latency_info
+ *
+ * Description:
+ *   Display the handler duration histogram of the registered IRQs and the
+ *   longest critical section.
+ *
+ ****************************************************************************/
+
+void irq_latency_info(void)
+{
+	irqstate_t flags;
+	uint32_t max;
+	FAR void *caller;
+	uint16_t i;
+	int j;
+
+	printf("\n %7s |", "IRQ_NUM");
+	for (j = 0; j < IRQ_LATENCY_NBUCKETS; j++) {
+		printf(" %6s |", g_irqhist_labels[j]);
+	}
+
+	printf(" (us)\n---------|");
+	for (j = 0; j < IRQ_LATENCY_NBUCKETS; j++) {
+		printf("--------|");
+	}
+
+	printf("\n");
+	for (i = 0; i < NR_IRQS; i++) {
+		if (g_irqvector[i].handler != irq_unexpected_isr) {
+			printf(" %7d |", i);
+			for (j = 0; j < IRQ_LATENCY_NBUCKETS; j++) {
+				printf(" %6u |", g_irqvector[i].hist[j]);
+			}
+
+			printf("\n");
+		}
+	}
+
+	flags = irqsave();
+	max = g_irqcs.max;
+	caller = g_irqcs.maxcaller;
+	irqrestore(flags);
+
+	printf("\nLongest critical section: %lu us, irqsave() at %p\n", (unsigned long)(max / CONFIG_ARCH_PERF_CYCLES_PER_USEC), caller);
+}
+
+#endif							/* CONFIG_DEBUG_IRQ_LATENCY */
@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/irq/irq_thread.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+#include <semaphore.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/kthread.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQ_THREAD
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/* The state shared by a threaded interrupt and its thread */
+
+struct irq_thread_s {
+	int irq;
+	xcpt_t isr;					/* Top half, or NULL to mask the IRQ */
+	xcpt_t thread;				/* Bottom half, NULL when detached */
+	FAR void *arg;
+	sem_t sem;					/* Posted to run the bottom half */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The interrupt handler attached for every threaded interrupt.  It runs
+ *   the top half and wakes the thread if the top half asks for it.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+	FAR struct irq_thread_s *irqthread = (FAR struct irq_thread_s *)arg;
+
+	if (irqthread->isr != NULL) {
+		if (irqthread->isr(irq, context, irqthread->arg) != IRQ_WAKE_THREAD) {
+			return OK;
+		}
+	} else {
+		/* Keep the level triggered source quiet until the thread has run */
+
+		up_disable_irq(irq);
+	}
+
+	sem_post(&irqthread->sem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The body of an interrupt thread.  argv[1] holds the address of its
+ *   struct irq_thread_s.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+	FAR struct irq_thread_s *irqthread;
+
+	irqthread = (FAR struct irq_thread_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+	for (;;) {
+		while (sem_wait(&irqthread->sem) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		if (irqthread->thread == NULL) {
+			break;
+		}
+
+		irqthread->thread(irqthread->irq, NULL, irqthread->arg);
+
+		if (irqthread->isr == NULL) {
+			up_enable_irq(irqthread->irq);
+		}
+	}
+
+	sem_destroy(&irqthread->sem);
+	kmm_free(irqthread);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded handler to IRQ number 'irq'.  'isr' runs in interrupt
+ *   context and returns IRQ_WAKE_THREAD to have 'thread' run in a kernel
+ *   thread of the given priority.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t thread, FAR void *arg, int priority, int stacksize)
+{
+	FAR struct irq_thread_s *irqthread;
+	FAR char *argv[2];
+	char name[16];
+	char addr[2 * sizeof(uintptr_t) + 3];
+	pid_t pid;
+
+	if ((unsigned)irq >= NR_IRQS || thread == NULL) {
+		return -EINVAL;
+	}
+#if defined(CONFIG_ARCH_NOINTC) || defined(CONFIG_ARCH_VECNOTIRQ)
+	/* Without an interrupt controller the top half must quiet the source */
+
+	if (isr == NULL) {
+		return -ENOSYS;
+	}
+#endif
+
+	irqthread = (FAR struct irq_thread_s *)kmm_zalloc(sizeof(struct irq_thread_s));
+	if (irqthread == NULL) {
+		return -ENOMEM;
+	}
+
+	irqthread->irq = irq;
+	irqthread->isr = isr;
+	irqthread->thread = thread;
+	irqthread->arg = arg;
+
+	/* The semaphore is used for signaling and must not boost priorities */
+
+	sem_init(&irqthread->sem, 0, 0);
+	sem_setprotocol(&irqthread->sem, SEM_PRIO_NONE);
+
+	snprintf(name, sizeof(name), "irq%d", irq);
+	snprintf(addr, sizeof(addr), "0x%lx", (unsigned long)(uintptr_t)irqthread);
+	argv[0] = addr;
+	argv[1] = NULL;
+
+	if (stacksize <= 0) {
+		stacksize = CONFIG_IRQ_THREAD_STACKSIZE;
+	}
+
+	pid = kernel_thread(name, priority, stacksize, (main_t)irq_thread_main, (FAR char *const *)argv);
+	if (pid < 0) {
+		int errcode = get_errno();
+		slldbg("kernel_thread failed: %d\n", errcode);
+		sem_destroy(&irqthread->sem);
+		kmm_free(irqthread);
+		return -errcode;
+	}
+
+#ifdef CONFIG_DEBUG_IRQ_INFO
+	irq_attach_withname(irq, irq_thread_isr, irqthread, name);
+#else
+	irq_attach(irq, irq_thread_isr, irqthread);
+#endif
+	return OK;
+}
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a handler attached by irq_attach_thread().  The thread frees its
+ *   state and exits once it has finished any bottom half in progress.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq)
+{
+	FAR struct irq_thread_s *irqthread;
+	irqstate_t flags;
+
+	if ((unsigned)irq >= NR_IRQS) {
+		return -EINVAL;
+	}
+
+	flags = irqsave();
+	if (g_irqvector[irq].handler != irq_thread_isr) {
+		irqrestore(flags);
+		return -EINVAL;
+	}
+
+	irqthread = (FAR struct irq_thread_s *)g_irqvector[irq].arg;
+	irq_detach(irq);
+	irqthread->thread = NULL;
+	sem_post(&irqthread->sem);
+	irqrestore(flags);
+
+	return OK;
+}
+
+#endif							/* CONFIG_IRQ_THREAD */
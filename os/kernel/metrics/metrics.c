@@ -0,0 +1,271 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/metrics/metrics.c
+ *
+ * The metrics registry and its CBOR encoding.  The registry is a list that
+ * only grows: metrics are appended with interrupts disabled and the flink
+ * of a metric is set before it becomes reachable, so a snapshot walks the
+ * list without taking any lock.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/metrics.h>
+#include <arch/irq.h>
+
+#ifdef CONFIG_METRICS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CBOR major types */
+
+#define CBOR_UINT   0
+#define CBOR_NINT   1
+#define CBOR_TEXT   3
+#define CBOR_ARRAY  4
+#define CBOR_MAP    5
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct metrics_cbor_s {
+	FAR uint8_t *ptr;			/* Next byte to write */
+	FAR uint8_t *end;			/* End of the buffer */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct metric_s *g_metrics_head;
+static FAR struct metric_s *g_metrics_tail;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: metrics_cbor_head
+ *
+ * Description:
+ *   Encode the initial byte of a CBOR data item with its argument in the
+ *   shortest form.  Running out of space is detected at the end, by ptr
+ *   having moved past end.
+ *
+ ****************************************************************************/
+
+static void metrics_cbor_head(FAR struct metrics_cbor_s *cbor, uint8_t major, uint64_t arg)
+{
+	FAR uint8_t *ptr = cbor->ptr;
+	int nbytes;
+	int i;
+
+	major <<= 5;
+
+	if (arg < 24) {
+		nbytes = 0;
+	} else if (arg <= UINT8_MAX) {
+		major |= 24;
+		nbytes = 1;
+	} else if (arg <= UINT16_MAX) {
+		major |= 25;
+		nbytes = 2;
+	} else if (arg <= UINT32_MAX) {
+		major |= 26;
+		nbytes = 4;
+	} else {
+		major |= 27;
+		nbytes = 8;
+	}
+
+	cbor->ptr += 1 + nbytes;
+	if (cbor->ptr > cbor->end) {
+		return;
+	}
+
+	*ptr++ = major | (nbytes == 0 ? (uint8_t)arg : 0);
+	for (i = nbytes - 1; i >= 0; i--) {
+		*ptr++ = (uint8_t)(arg >> (8 * i));
+	}
+}
+
+static void metrics_cbor_text(FAR struct metrics_cbor_s *cbor, FAR const char *text)
+{
+	size_t len = strlen(text);
+
+	metrics_cbor_head(cbor, CBOR_TEXT, len);
+	if (cbor->ptr + len <= cbor->end) {
+		memcpy(cbor->ptr, text, len);
+	}
+
+	cbor->ptr += len;
+}
+
+static void metrics_cbor_int(FAR struct metrics_cbor_s *cbor, int32_t value)
+{
+	if (value < 0) {
+		metrics_cbor_head(cbor, CBOR_NINT, (uint64_t)(-1 - (int64_t)value));
+	} else {
+		metrics_cbor_head(cbor, CBOR_UINT, (uint64_t)value);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: metrics_register
+ ****************************************************************************/
+
+void metrics_register(FAR struct metric_s *metric)
+{
+	irqstate_t flags;
+
+	metric->flink = NULL;
+
+	flags = irqsave();
+	if (g_metrics_tail) {
+		g_metrics_tail->flink = metric;
+	} else {
+		g_metrics_head = metric;
+	}
+
+	g_metrics_tail = metric;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: metric_add
+ ****************************************************************************/
+
+void metric_add(FAR struct metric_s *metric, uint32_t n)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	metric->value += n;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: metric_set
+ ****************************************************************************/
+
+void metric_set(FAR struct metric_s *metric, int32_t value)
+{
+	metric->value = (uint32_t)value;
+}
+
+/****************************************************************************
+ * Name: metric_observe
+ ****************************************************************************/
+
+void metric_observe(FAR struct metric_s *metric, uint32_t value)
+{
+	irqstate_t flags;
+	int i;
+
+	i = 0;
+	while (i < metric->nbounds && value > metric->bounds[i]) {
+		i++;
+	}
+
+	flags = irqsave();
+	metric->buckets[i]++;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: metrics_encode
+ ****************************************************************************/
+
+ssize_t metrics_encode(FAR uint8_t *buffer, size_t buflen)
+{
+	struct metrics_cbor_s cbor;
+	FAR struct metric_s *metric;
+	size_t nmetrics = 0;
+	int i;
+
+	/* Refresh the sampled gauges first, so that a callback may also set
+	 * related metrics that have no callback of their own.
+	 */
+
+	for (metric = g_metrics_head; metric; metric = metric->flink) {
+		if (metric->sample) {
+			metric->sample(metric);
+		}
+
+		nmetrics++;
+	}
+
+	cbor.ptr = buffer;
+	cbor.end = buffer + buflen;
+
+	metrics_cbor_head(&cbor, CBOR_ARRAY, 2);
+	metrics_cbor_head(&cbor, CBOR_UINT, (uint64_t)TICK2MSEC((uint64_t)clock_systimer()));
+	metrics_cbor_head(&cbor, CBOR_MAP, nmetrics);
+
+	/* Metrics registered meanwhile are left out, as the map has a fixed
+	 * size.
+	 */
+
+	for (metric = g_metrics_head; metric && nmetrics > 0; metric = metric->flink, nmetrics--) {
+		metrics_cbor_text(&cbor, metric->name);
+
+		switch (metric->type) {
+		case METRIC_COUNTER:
+			metrics_cbor_head(&cbor, CBOR_UINT, metric->value);
+			break;
+
+		case METRIC_GAUGE:
+			metrics_cbor_int(&cbor, (int32_t)metric->value);
+			break;
+
+		default:
+			metrics_cbor_head(&cbor, CBOR_ARRAY, metric->nbounds + 1);
+			for (i = 0; i <= metric->nbounds; i++) {
+				metrics_cbor_head(&cbor, CBOR_UINT, metric->buckets[i]);
+			}
+			break;
+		}
+	}
+
+	if (cbor.ptr > cbor.end) {
+		return -ENOSPC;
+	}
+
+	return cbor.ptr - buffer;
+}
+
+#endif							/* CONFIG_METRICS */
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/metrics/metrics_sources.c
+ *
+ * The metrics of the kernel itself: heap usage, CPU load and the network
+ * buffer drops.  All of them are sampled when a snapshot is taken, so they
+ * cost nothing in between.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
+#include <tinyara/metrics.h>
+#ifdef CONFIG_NET_MEMINFO
+#include <tinyara/net/netmem.h>
+#endif
+
+#ifdef CONFIG_METRICS
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void metrics_sample_heap(FAR struct metric_s *metric);
+#ifdef CONFIG_SCHED_CPULOAD
+static void metrics_sample_cpuload(FAR struct metric_s *metric);
+#endif
+#ifdef CONFIG_NET_MEMINFO
+static void metrics_sample_netdrops(FAR struct metric_s *metric);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Heap usage in bytes.  All three are set by the sample of the first. */
+
+static struct metric_s g_heap_used = METRIC_GAUGE_INITIALIZER("mm.heap.used", metrics_sample_heap);
+static struct metric_s g_heap_free = METRIC_GAUGE_INITIALIZER("mm.heap.free", NULL);
+static struct metric_s g_heap_largest = METRIC_GAUGE_INITIALIZER("mm.heap.largest", NULL);
+
+/* Busy time over the CPU load time constant, in tenths of a percent */
+
+#ifdef CONFIG_SCHED_CPULOAD
+static struct metric_s g_cpuload = METRIC_GAUGE_INITIALIZER("sched.cpuload", metrics_sample_cpuload);
+#endif
+
+/* Packets dropped for lack of network buffers, per enum netmem_drop_e */
+
+#ifdef CONFIG_NET_MEMINFO
+static struct metric_s g_netdrops[NETMEM_NDROPS] = {
+	METRIC_COUNTER_INITIALIZER("net.drop.pbuf_pool"),
+	METRIC_COUNTER_INITIALIZER("net.drop.pbuf_ram"),
+	METRIC_COUNTER_INITIALIZER("net.drop.tcpip_mbox"),
+	METRIC_COUNTER_INITIALIZER("net.drop.sock_rcvbuf"),
+	METRIC_COUNTER_INITIALIZER("net.drop.tcp_ooseq")
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void metrics_sample_heap(FAR struct metric_s *metric)
+{
+	struct mallinfo mem;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	mem = kmm_mallinfo();
+#else
+	(void)kmm_mallinfo(&mem);
+#endif
+
+	metric_set(&g_heap_used, mem.uordblks);
+	metric_set(&g_heap_free, mem.fordblks);
+	metric_set(&g_heap_largest, mem.mxordblk);
+}
+
+#ifdef CONFIG_SCHED_CPULOAD
+static void metrics_sample_cpuload(FAR struct metric_s *metric)
+{
+	struct cpuload_s cpuload;
+
+	/* The load of the IDLE thread is the time the CPU was not busy */
+
+	if (clock_cpuload(0, &cpuload) == OK && cpuload.total > 0) {
+		metric_set(metric, 1000 - (int32_t)((1000 * (uint64_t)cpuload.active) / cpuload.total));
+	}
+}
+#endif
+
+#ifdef CONFIG_NET_MEMINFO
+static void metrics_sample_netdrops(FAR struct metric_s *metric)
+{
+	uint32_t drops[NETMEM_NDROPS];
+	int i;
+
+	netmem_drops(drops);
+	for (i = 0; i < NETMEM_NDROPS; i++) {
+		g_netdrops[i].value = drops[i];
+	}
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: metrics_initialize
+ ****************************************************************************/
+
+void metrics_initialize(void)
+{
+#ifdef CONFIG_NET_MEMINFO
+	int i;
+#endif
+
+	metrics_register(&g_heap_used);
+	metrics_register(&g_heap_free);
+	metrics_register(&g_heap_largest);
+
+#ifdef CONFIG_SCHED_CPULOAD
+	metrics_register(&g_cpuload);
+#endif
+
+#ifdef CONFIG_NET_MEMINFO
+	g_netdrops[0].sample = metrics_sample_netdrops;
+	for (i = 0; i < NETMEM_NDROPS; i++) {
+		metrics_register(&g_netdrops[i]);
+	}
+#endif
+}
+
+#endif							/* CONFIG_METRICS */
@@ -94,6 +94,12 @@ sq_queue_t g_msgfree;
 
 sq_queue_t g_msgfreeirq;
 
+#ifdef CONFIG_MM_POOL
+/* Pool of dynamically allocated messages */
+
+struct kmm_pool_s g_msgdynpool;
+#endif
+
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
  * pool is a constant.
@@ -197,6 +203,12 @@ void mq_initialize(void)
 
 	g_msgfreeirqalloc = mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS, MQ_ALLOC_IRQ);
 
+#ifdef CONFIG_MM_POOL
+	/* Set up the pool used once the pre-allocated messages run out */
+
+	(void)kmm_pool_initialize(&g_msgdynpool, sizeof(struct mqueue_msg_s), CONFIG_MQ_MSG_POOLSIZE);
+#endif
+
 	/* Allocate a block of message queue descriptors */
 
 	mq_desblockalloc();
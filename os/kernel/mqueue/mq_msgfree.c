@@ -142,7 +142,19 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 
 	else if (mqmsg->type == MQ_ALLOC_DYN) {
 		sched_kfree(mqmsg);
-	} else {
+	}
+#ifdef CONFIG_MM_POOL
+	else if (mqmsg->type == MQ_ALLOC_POOL) {
+		KMM_POOL_FREE(&g_msgdynpool, mqmsg);
+	}
+#endif
+
+	/* A reference message still queued when its queue is destroyed */
+
+	else if (mqmsg->type == MQ_ALLOC_REFQ) {
+		kumm_free(mqmsg);
+	}
+	else {
 		PANIC();
 	}
 }
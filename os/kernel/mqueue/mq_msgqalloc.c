@@ -117,8 +117,8 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 	 * larger than the configured maximum message size.
 	 */
 
-	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
-	if (attr && attr->mq_msgsize > MQ_MAX_BYTES) {
+	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES || (attr->mq_flags & MQ_REFERENCE) != 0);
+	if (attr && attr->mq_msgsize > MQ_MAX_BYTES && (attr->mq_flags & MQ_REFERENCE) == 0) {
 		return NULL;
 	}
 
@@ -130,7 +130,13 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 		/* Initialize the new named message queue */
 
 		sq_init(&msgq->msglist);
-		if (attr) {
+		if (attr && (attr->mq_flags & MQ_REFERENCE) != 0) {
+			/* Receivers of a reference queue get a buffer pointer */
+
+			msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
+			msgq->maxmsgsize = sizeof(FAR void *);
+			msgq->maxrefsize = attr->mq_msgsize;
+		} else if (attr) {
 			msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
 			msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
 		} else {
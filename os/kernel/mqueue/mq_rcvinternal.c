@@ -235,6 +235,17 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 
 	if (rcvmsg) {
 		msgq->nmsgs--;
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+		/* The head is the first message of its bucket, so it is the tail
+		 * only if it was the last message in the bucket.
+		 */
+
+		if (msgq->prtail[MQ_PRIO_BUCKET(rcvmsg->priority)] == (FAR sq_entry_t *)rcvmsg) {
+			msgq->prtail[MQ_PRIO_BUCKET(rcvmsg->priority)] = NULL;
+			msgq->prmap &= ~(1ul << MQ_PRIO_BUCKET(rcvmsg->priority));
+		}
+#endif
 	}
 
 	leave_cancellation_point();
@@ -278,23 +289,34 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	trace_begin(TTRACE_TAG_IPC, "mq_doreceive");
 
-	/* Get the length of the message (also the return value) */
+	/* Copy the message priority (if a buffer is provided) */
 
-	rcvmsglen = mqmsg->msglen;
+	if (prio) {
+		*prio = mqmsg->priority;
+	}
 
-	/* Copy the message into the caller's buffer */
+	if (mqmsg->type == MQ_ALLOC_REFQ) {
+		FAR struct mqueue_refmsg_s *ref = (FAR struct mqueue_refmsg_s *)mqmsg;
+		FAR void *buffer = MQ_REFBUF(ref);
 
-	memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+		/* Hand the buffer of a reference message over to the caller */
 
-	/* Copy the message priority as well (if a buffer is provided) */
+		rcvmsglen = ref->msglen;
+		ref->type = MQ_ALLOC_REF;
+		memcpy(ubuffer, &buffer, sizeof(FAR void *));
+	} else {
+		/* Get the length of the message (also the return value) */
 
-	if (prio) {
-		*prio = mqmsg->priority;
-	}
+		rcvmsglen = mqmsg->msglen;
 
-	/* We are done with the message.  Deallocate it now. */
+		/* Copy the message into the caller's buffer */
 
-	mq_msgfree(mqmsg);
+		memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+
+		/* We are done with the message.  Deallocate it now. */
+
+		mq_msgfree(mqmsg);
+	}
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_refmsg.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <mqueue.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_refalloc
+ *
+ * Description:
+ *   Allocate a message buffer for a message queue created with
+ *   MQ_REFERENCE.  The buffer is preceded by the header that links it into
+ *   the message list of the queue, so sending it neither copies the data
+ *   nor takes a message from g_msgfree.  The buffer is taken from the user
+ *   heap because it is handed from task to task.
+ *
+ * Parameters:
+ *   size - The size of the buffer in bytes
+ *
+ * Return Value:
+ *   The buffer, or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR void *mq_refalloc(size_t size)
+{
+	FAR struct mqueue_refmsg_s *ref;
+
+	ref = (FAR struct mqueue_refmsg_s *)kumm_malloc(sizeof(struct mqueue_refmsg_s) + size);
+	if (ref == NULL) {
+		return NULL;
+	}
+
+	ref->next = NULL;
+	ref->type = MQ_ALLOC_REF;
+	ref->priority = 0;
+	ref->msglen = 0;
+	ref->bufsize = size;
+	return MQ_REFBUF(ref);
+}
+
+/****************************************************************************
+ * Name: mq_reffree
+ *
+ * Description:
+ *   Free a buffer allocated with mq_refalloc().  A buffer that is still in
+ *   a message queue is freed when it is received or when the queue is
+ *   destroyed.
+ *
+ * Parameters:
+ *   buffer - The buffer to free
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_reffree(FAR void *buffer)
+{
+	FAR struct mqueue_refmsg_s *ref;
+
+	if (buffer == NULL) {
+		return;
+	}
+
+	ref = MQ_REFMSG(buffer);
+	if (ref->type != MQ_ALLOC_REF) {
+		sdbg("Buffer %p is queued or not a reference message\n", buffer);
+		return;
+	}
+
+	kumm_free(ref);
+}
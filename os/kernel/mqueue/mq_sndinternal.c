@@ -96,6 +96,59 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+/****************************************************************************
+ * Name: mq_msgprev
+ *
+ * Description:
+ *   Find the message after which a new message of priority 'prio' is
+ *   inserted and record the new message as the tail of its bucket.  The new
+ *   message goes behind the messages of its own bucket or, if that is
+ *   empty, behind the tail of the nearest higher priority bucket.  Only the
+ *   bucket shared by the priorities above 30 is searched.
+ *
+ *   Must be called with interrupts disabled.
+ *
+ * Parameters:
+ *   msgq - The message queue
+ *   prio - The priority of the new message
+ *   mqmsg - The new message
+ *
+ * Return Value:
+ *   The message to insert after, or NULL to insert at the head.
+ *
+ ****************************************************************************/
+
+static FAR struct mqueue_msg_s *mq_msgprev(FAR struct mqueue_inode_s *msgq, int prio, FAR struct mqueue_msg_s *mqmsg)
+{
+	FAR struct mqueue_msg_s *tail;
+	FAR struct mqueue_msg_s *prev;
+	FAR struct mqueue_msg_s *next;
+	int bucket = MQ_PRIO_BUCKET(prio);
+	uint32_t higher;
+
+	tail = (FAR struct mqueue_msg_s *)msgq->prtail[bucket];
+	if (tail && prio <= tail->priority) {
+		msgq->prtail[bucket] = (FAR sq_entry_t *)mqmsg;
+		return tail;
+	}
+
+	higher = bucket < MQ_PRIO_NBUCKETS - 1 ? msgq->prmap >> (bucket + 1) : 0;
+	prev = higher ? (FAR struct mqueue_msg_s *)msgq->prtail[bucket + 1 + __builtin_ctz(higher)] : NULL;
+
+	if (tail) {
+		/* The new message belongs before the tail of the shared bucket */
+
+		for (next = prev ? prev->next : (FAR struct mqueue_msg_s *)msgq->msglist.head; next && prio <= next->priority; prev = next, next = next->next) ;
+	} else {
+		msgq->prtail[bucket] = (FAR sq_entry_t *)mqmsg;
+		msgq->prmap |= 1ul << bucket;
+	}
+
+	return prev;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,6 +175,8 @@
  *   EPERM    Message queue opened not opened for writing.
  *   EMSGSIZE 'msglen' was greater than the maxmsgsize attribute of the
  *             message queue.
+ *   EINVAL   The message of a reference queue is not an mq_refalloc()
+ *            buffer owned by the caller.
  *
  * Assumptions:
  *
@@ -141,7 +196,23 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 		return ERROR;
 	}
 
-	if (msglen > (size_t)mqdes->msgq->maxmsgsize) {
+	if (mqdes->msgq->maxrefsize > 0) {
+		/* A reference queue takes over the buffer, which must neither be
+		 * queued already nor hold more than was allocated.
+		 */
+
+		FAR struct mqueue_refmsg_s *ref = MQ_REFMSG(msg);
+
+		if (ref->type != MQ_ALLOC_REF) {
+			set_errno(EINVAL);
+			return ERROR;
+		}
+
+		if (msglen > ref->bufsize || msglen > mqdes->msgq->maxrefsize) {
+			set_errno(EMSGSIZE);
+			return ERROR;
+		}
+	} else if (msglen > (size_t)mqdes->msgq->maxmsgsize) {
 		set_errno(EMSGSIZE);
 		return ERROR;
 	}
@@ -211,18 +282,54 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 		/* If we cannot a message from the free list, then we will have to allocate one. */
 
 		if (!mqmsg) {
-			mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc((sizeof(struct mqueue_msg_s)));
+#ifdef CONFIG_MM_POOL
+			/* Prefer the message pool, which has no heap header overhead */
 
-			/* Check if we got an allocated message */
+			mqmsg = KMM_POOL_ALLOC(&g_msgdynpool, struct mqueue_msg_s);
+			if (mqmsg) {
+				mqmsg->type = MQ_ALLOC_POOL;
+			} else
+#endif
+			{
+				mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc((sizeof(struct mqueue_msg_s)));
+
+				/* Check if we got an allocated message */
 
-			ASSERT(mqmsg);
-			mqmsg->type = MQ_ALLOC_DYN;
+				ASSERT(mqmsg);
+				mqmsg->type = MQ_ALLOC_DYN;
+			}
 		}
 	}
 
 	return mqmsg;
 }
 
+/****************************************************************************
+ * Name: mq_sndmsg
+ *
+ * Description:
+ *   Get the message structure for a message to send.  A reference queue
+ *   sends the header of the mq_refalloc() buffer itself; other queues
+ *   allocate a message with mq_msgalloc().
+ *
+ * Inputs:
+ *   mqdes - Message queue descriptor
+ *   msg - Message to send, verified by mq_verifysend()
+ *
+ * Return Value:
+ *   Reference to the message structure
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *mq_sndmsg(mqd_t mqdes, FAR const char *msg)
+{
+	if (mqdes->msgq->maxrefsize > 0) {
+		return (FAR struct mqueue_msg_s *)MQ_REFMSG(msg);
+	}
+
+	return mq_msgalloc();
+}
+
 /****************************************************************************
  * Name: mq_waitsend
  *
@@ -350,7 +457,9 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 {
 	FAR struct tcb_s *btcb;
 	FAR struct mqueue_inode_s *msgq;
+#ifndef CONFIG_MQ_PRIO_BUCKETS
 	FAR struct mqueue_msg_s *next;
+#endif
 	FAR struct mqueue_msg_s *prev;
 	irqstate_t saved_state;
 
@@ -364,21 +473,32 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	/* Construct the message header info */
 
 	mqmsg->priority = prio;
-	mqmsg->msglen = msglen;
+	if (mqmsg->type == MQ_ALLOC_REF) {
+		/* The buffer of a reference message is queued as it is */
 
-	/* Copy the message data into the message */
+		((FAR struct mqueue_refmsg_s *)mqmsg)->msglen = msglen;
+		mqmsg->type = MQ_ALLOC_REFQ;
+	} else {
+		mqmsg->msglen = msglen;
 
-	memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+		/* Copy the message data into the message */
+
+		memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	}
 
 	/* Insert the new message in the message queue */
 
 	saved_state = irqsave();
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+	prev = mq_msgprev(msgq, prio, mqmsg);
+#else
 	/* Search the message list to find the location to insert the new
 	 * message. Each is list is maintained in ascending priority order.
 	 */
 
 	for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head; next && prio <= next->priority; prev = next, next = next->next) ;
+#endif
 
 	/* Add the message at the right place */
 
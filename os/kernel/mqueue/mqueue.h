@@ -69,6 +69,9 @@
 #include <signal.h>
 
 #include <tinyara/mqueue.h>
+#ifdef CONFIG_MM_POOL
+#include <tinyara/mm/pool.h>
+#endif
 
 #if !defined(CONFIG_DISABLE_MQUEUE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -92,6 +95,12 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* The priority bucket of a message.  Low priorities map one-to-one, the
+ * rest share the last bucket.
+ */
+
+#define MQ_PRIO_BUCKET(p) ((p) < MQ_PRIO_NBUCKETS - 1 ? (p) : MQ_PRIO_NBUCKETS - 1)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -99,7 +108,10 @@
 enum mqalloc_e {
 	MQ_ALLOC_FIXED = 0,			/* pre-allocated; never freed */
 	MQ_ALLOC_DYN,				/* dynamically allocated; free when unused */
-	MQ_ALLOC_IRQ				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_IRQ,				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_POOL,				/* Allocated from g_msgdynpool; free when unused */
+	MQ_ALLOC_REF,				/* mq_refalloc() buffer owned by a task */
+	MQ_ALLOC_REFQ				/* mq_refalloc() buffer in a message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -116,6 +128,23 @@ struct mqueue_msg_s {
 	char mail[MQ_MAX_BYTES];		/* Message data */
 };
 
+/* This structure precedes the buffer of a reference message.  It begins
+ * like struct mqueue_msg_s so that it is queued in the same message list.
+ */
+
+struct mqueue_refmsg_s {
+	FAR struct mqueue_msg_s *next;	/* Forward link to next message */
+	uint8_t type;					/* MQ_ALLOC_REF or MQ_ALLOC_REFQ */
+	uint8_t priority;				/* priority of message */
+	size_t msglen;					/* Message data length */
+	size_t bufsize;					/* Size of the buffer */
+};
+
+/* Convert between a reference message and its buffer */
+
+#define MQ_REFMSG(buf) ((FAR struct mqueue_refmsg_s *)(buf) - 1)
+#define MQ_REFBUF(ref) ((FAR void *)((FAR struct mqueue_refmsg_s *)(ref) + 1))
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -139,6 +168,14 @@ EXTERN sq_queue_t g_msgfree;
 
 EXTERN sq_queue_t g_msgfreeirq;
 
+#ifdef CONFIG_MM_POOL
+/* Messages needed beyond the pre-allocated ones are taken from this pool
+ * before falling back to the kernel heap.
+ */
+
+EXTERN struct kmm_pool_s g_msgdynpool;
+#endif
+
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
  * pool is a constant.
@@ -172,6 +209,7 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
 FAR struct mqueue_msg_s *mq_msgalloc(void);
+FAR struct mqueue_msg_s *mq_sndmsg(mqd_t mqdes, FAR const char *msg);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio);
 
@@ -60,6 +60,8 @@
 #include <tinyara/config.h>
 #include <queue.h>
 
+#include <tinyara/page.h>
+
 #ifdef CONFIG_PAGING
 
 /****************************************************************************
@@ -88,6 +90,14 @@
 #warning "Page fill support requires signals"
 #endif
 
+/* Statistics */
+
+#ifdef CONFIG_PAGING_STATS
+#define pg_statinc(f)            (g_pgstats.f++)
+#else
+#define pg_statinc(f)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -117,6 +127,12 @@ extern pid_t g_pgworker;
 
 extern FAR struct tcb_s *g_pftcb;
 
+#ifdef CONFIG_PAGING_STATS
+/* The paging statistics, updated by the page fault and page fill logic */
+
+extern struct pgstats_s g_pgstats;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -138,6 +154,24 @@ extern FAR struct tcb_s *g_pftcb;
 
 int pg_worker(int argc, char *argv[]);
 
+/****************************************************************************
+ * Name: pg_lru_age
+ *
+ * Description:
+ *   Age all pages allocated with pg_lru_alloc(): shift their age right and
+ *   set its top bit if up_pgreferenced() reports a reference since the
+ *   last call.  Called each time the page fill worker wakes up.
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_LRU
+void pg_lru_age(void);
+#endif
+
 #endif							/* __ASSEMBLY__ */
 #endif							/* CONFIG_PAGING */
 #endif							/* __SCHED_PAGING_PAGING_H */
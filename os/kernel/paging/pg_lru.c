@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/paging/pg_lru.c
+ *
+ * Least recently used replacement of the physical pages of the paged text
+ * region.  Recency is approximated by aging: every page has an 8-bit age
+ * that is shifted right each time the page fill worker wakes up, with the
+ * reference reported by up_pgreferenced() shifted in at the top.  The page
+ * with the smallest age is the one replaced.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/page.h>
+
+#include "paging/paging.h"
+
+#if defined(CONFIG_PAGING) && defined(CONFIG_PAGING_LRU)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PG_LRU_USED        (1 << 0)	/* The page is mapped at vaddr */
+#define PG_LRU_PREFETCHED  (1 << 1)	/* Prefetched and not referenced yet */
+
+#define PG_LRU_AGE_NEW     0x80		/* Age of a page filled on a fault */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pg_lru_s {
+	uintptr_t vaddr;			/* The virtual address the page is mapped at */
+	uint8_t age;				/* Reference history, most recent in bit 7 */
+	uint8_t flags;				/* See PG_LRU_* definitions */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pg_lru_s g_pglru[CONFIG_PAGING_NPPAGED];
+
+/* Where the next search starts, so that pages of equal age are replaced in
+ * turn rather than always the first one.
+ */
+
+static int g_pglruhand;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pg_lru_alloc
+ ****************************************************************************/
+
+int pg_lru_alloc(uintptr_t vaddr, bool prefetch, FAR uintptr_t *oldvaddr)
+{
+	FAR struct pg_lru_s *page;
+	int victim = -1;
+	int ndx;
+	int i;
+
+	for (i = 0; i < CONFIG_PAGING_NPPAGED; i++) {
+		ndx = (g_pglruhand + i) % CONFIG_PAGING_NPPAGED;
+		page = &g_pglru[ndx];
+
+		if ((page->flags & PG_LRU_USED) == 0) {
+			victim = ndx;
+			break;
+		}
+
+		if (victim < 0 || page->age < g_pglru[victim].age) {
+			victim = ndx;
+		}
+	}
+
+	DEBUGASSERT(victim >= 0);
+	page = &g_pglru[victim];
+
+	if ((page->flags & PG_LRU_USED) != 0) {
+		pgllvdbg("Replacing page %d at %08lx, age %02x\n", victim, (unsigned long)page->vaddr, page->age);
+		*oldvaddr = page->vaddr;
+		pg_statinc(nreplaced);
+	} else {
+		*oldvaddr = 0;
+	}
+
+	page->vaddr = vaddr;
+	if (prefetch) {
+		page->age = 0;
+		page->flags = PG_LRU_USED | PG_LRU_PREFETCHED;
+	} else {
+		page->age = PG_LRU_AGE_NEW;
+		page->flags = PG_LRU_USED;
+	}
+
+	g_pglruhand = (victim + 1) % CONFIG_PAGING_NPPAGED;
+	return victim;
+}
+
+/****************************************************************************
+ * Name: pg_lru_age
+ ****************************************************************************/
+
+void pg_lru_age(void)
+{
+	FAR struct pg_lru_s *page;
+	int i;
+
+	for (i = 0; i < CONFIG_PAGING_NPPAGED; i++) {
+		page = &g_pglru[i];
+		if ((page->flags & PG_LRU_USED) == 0) {
+			continue;
+		}
+
+		page->age >>= 1;
+		if (up_pgreferenced(page->vaddr)) {
+			page->age |= PG_LRU_AGE_NEW;
+			if ((page->flags & PG_LRU_PREFETCHED) != 0) {
+				page->flags &= ~PG_LRU_PREFETCHED;
+				pg_statinc(nprefetchused);
+			}
+		}
+	}
+}
+
+#endif							/* CONFIG_PAGING && CONFIG_PAGING_LRU */
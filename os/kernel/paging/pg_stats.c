@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/paging/pg_stats.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/page.h>
+
+#include "paging/paging.h"
+
+#if defined(CONFIG_PAGING) && defined(CONFIG_PAGING_STATS)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct pgstats_s g_pgstats;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pg_getstats
+ ****************************************************************************/
+
+void pg_getstats(FAR struct pgstats_s *stats)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memcpy(stats, &g_pgstats, sizeof(struct pgstats_s));
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: pg_resetstats
+ ****************************************************************************/
+
+void pg_resetstats(void)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memset(&g_pgstats, 0, sizeof(struct pgstats_s));
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_PAGING && CONFIG_PAGING_STATS */
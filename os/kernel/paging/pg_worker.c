@@ -325,6 +325,40 @@ static inline bool pg_dequeue(void)
 	return false;
 }
 
+/****************************************************************************
+ * Name: pg_prefetch
+ *
+ * Description:
+ *   Fill up to CONFIG_PAGING_PREFETCH virtual pages following the one that
+ *   was just filled for g_pftcb.  Pages that are already mapped are
+ *   skipped; any other failure of up_prefetchpage() ends the prefetch.
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_PREFETCH > 0
+static inline void pg_prefetch(void)
+{
+	int offset;
+	int ret;
+
+	for (offset = 1; offset <= CONFIG_PAGING_PREFETCH; offset++) {
+		pgllvdbg("Call up_prefetchpage(%p, %d)\n", g_pftcb, offset);
+		ret = up_prefetchpage(g_pftcb, offset);
+		if (ret == -EEXIST) {
+			continue;
+		} else if (ret < 0) {
+			break;
+		}
+
+		pg_statinc(nprefetch);
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: pg_startfill
  *
@@ -392,6 +426,13 @@ static inline bool pg_startfill(void)
 		pgllvdbg("Call up_fillpage(%p)\n", g_pftcb);
 		result = up_fillpage(g_pftcb, vpage);
 		DEBUGASSERT(result == OK);
+		pg_statinc(nfills);
+
+#if CONFIG_PAGING_PREFETCH > 0
+		/* Fill the pages that follow before the task is restarted */
+
+		pg_prefetch();
+#endif
 #else
 		/* If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage is non-blocking
 		 * call. In this case up_fillpage() will accept an additional argument: The page
@@ -405,6 +446,7 @@ static inline bool pg_startfill(void)
 		pgllvdbg("Call up_fillpage(%p)\n", g_pftcb);
 		result = up_fillpage(g_pftcb, vpage, pg_callback);
 		DEBUGASSERT(result == OK);
+		pg_statinc(nfills);
 
 		/* Save the time that the fill was started.  These will be used to check for
 		 * timeouts.
@@ -553,6 +595,12 @@ int pg_worker(int argc, char *argv[])
 
 		usleep(CONFIG_PAGING_WORKPERIOD);
 
+#ifdef CONFIG_PAGING_LRU
+		/* Age the mapped pages with the references since the last wake-up */
+
+		pg_lru_age();
+#endif
+
 		/* The page fill worker thread will be awakened on one of three conditions:
 		 *
 		 *   - When signaled by pg_miss(), the page fill worker thread will be awakenend,
@@ -62,15 +62,27 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <pthread.h>
 #include <sched.h>
 
 #include <tinyara/compiler.h>
+#include <tinyara/irq.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* ARMv7 cores provide LDREX/STREX.  The exclusive monitor is cleared on
+ * exception entry, so a sequence interrupted by a context switch or by an
+ * interrupt handler that posts the semaphore simply retries.
+ */
+
+#if defined(CONFIG_ARCH_CORTEXR4) || defined(CONFIG_ARCH_CORTEXM3) || \
+	defined(CONFIG_ARCH_CORTEXM4)
+#define PTHREAD_HAVE_LDREX 1
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -109,6 +121,7 @@ extern "C" {
  * Public Function Prototypes
  ****************************************************************************/
 
+struct tcb_s;					/* Forward reference */
 struct pthread_tcb_s;			/* Forward reference */
 struct task_group_s;			/* Forward reference */
 
@@ -138,6 +151,16 @@ void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 #define pthread_mutex_give(m)   pthread_sem_give(&(m)->sem)
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+int pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex);
+int pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex);
+#else
+#define pthread_mutex_fasttake(m) pthread_sem_fasttake(&(m)->sem)
+#define pthread_mutex_fastgive(m) pthread_sem_fastgive(&(m)->sem)
+#endif
+#endif
+
 #if defined(CONFIG_CANCELLATION_POINTS) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 uint16_t pthread_disable_cancel(void);
 void pthread_enable_cancel(uint16_t oldstate);
@@ -150,9 +173,117 @@ void pthread_enable_cancel(uint16_t oldstate);
 int pthread_mutexattr_verifytype(int type);
 #endif
 
+#ifdef CONFIG_PTHREAD_TCBCACHE
+FAR struct pthread_tcb_s *pthread_tcballoc(size_t stack_size);
+bool pthread_tcbcache(FAR struct tcb_s *tcb);
+#else
+#define pthread_tcballoc(s) \
+	((FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s)))
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/****************************************************************************
+ * Name: pthread_sem_cas
+ *
+ * Description:
+ *   Atomically replace the count of a semaphore with 'value' if it equals
+ *   'expect'.  Returns false, leaving the count unchanged, otherwise.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_sem_cas(FAR sem_t *sem, int16_t expect, int16_t value)
+{
+#ifdef PTHREAD_HAVE_LDREX
+	uint32_t count;
+	int failed;
+
+	do {
+		__asm__ __volatile__("ldrexh %0, [%1]" : "=&r"(count) : "r"(&sem->semcount) : "memory");
+		if ((int16_t)count != expect) {
+			/* Release the reservation taken by LDREXH */
+
+			__asm__ __volatile__("clrex" : : : "memory");
+			return false;
+		}
+
+		__asm__ __volatile__("strexh %0, %2, [%1]" : "=&r"(failed) : "r"(&sem->semcount), "r"(value) : "memory");
+	} while (failed);
+
+	return true;
+#else
+	irqstate_t flags = irqsave();
+	bool ret = false;
+
+	if (sem->semcount == expect) {
+		sem->semcount = value;
+		ret = true;
+	}
+
+	irqrestore(flags);
+	return ret;
+#endif
+}
+
+/****************************************************************************
+ * Name: pthread_sem_canfast
+ *
+ * Description:
+ *   The fast path bypasses the holder bookkeeping of sem_wait() and
+ *   sem_post(), so it is only taken for semaphores without priority
+ *   inheritance.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_sem_canfast(FAR sem_t *sem)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	return (sem->flags & PRIOINHERIT_FLAGS_DISABLE) != 0;
+#else
+	return true;
+#endif
+}
+
+/****************************************************************************
+ * Name: pthread_sem_fasttake and pthread_sem_fastgive
+ *
+ * Description:
+ *   Take a free semaphore or give a semaphore nobody waits for with a
+ *   single atomic update of its count.  pthread_sem_fasttake() returns
+ *   EBUSY when the caller must fall back to pthread_sem_take();
+ *   pthread_sem_fastgive() falls back to pthread_sem_give() by itself.
+ *
+ ****************************************************************************/
+
+static inline int pthread_sem_fasttake(FAR sem_t *sem)
+{
+	if (!pthread_sem_canfast(sem) || !pthread_sem_cas(sem, 1, 0)) {
+		return EBUSY;
+	}
+
+	return OK;
+}
+
+static inline int pthread_sem_fastgive(FAR sem_t *sem)
+{
+	/* A negative count means that a thread is blocked in sem_wait() and
+	 * must be woken up by sem_post().
+	 */
+
+	if (!pthread_sem_cas(sem, 0, 1)) {
+		return pthread_sem_give(sem);
+	}
+
+	return OK;
+}
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH */
+
 #endif							/* __SCHED_PTHREAD_PTHREAD_H */
@@ -100,6 +100,49 @@ static void pthread_mutex_add(FAR struct pthread_mutex_s *mutex)
 	irqrestore(flags);
 }
 
+/****************************************************************************
+ * Name: pthread_mutex_remove
+ *
+ * Description:
+ *   Remove the mutex from the list of mutexes held by this thread.
+ *
+ * Parameters:
+ *  mutex - The mux to be unlocked
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void pthread_mutex_remove(FAR struct pthread_mutex_s *mutex)
+{
+	FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
+	FAR struct pthread_mutex_s *curr;
+	FAR struct pthread_mutex_s *prev;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	/* Remove the mutex from the list of mutexes held by this task */
+
+	for (prev = NULL, curr = rtcb->mhead; curr != NULL && curr != mutex; prev = curr, curr = curr->flink) ;
+
+	DEBUGASSERT(curr == mutex);
+
+	/* Remove the mutex from the list.  prev == NULL means that the mutex
+	 * to be removed is at the head of the list.
+	 */
+
+	if (prev == NULL) {
+		rtcb->mhead = mutex->flink;
+	} else {
+		prev->flink = mutex->flink;
+	}
+
+	mutex->flink = NULL;
+	irqrestore(flags);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -236,45 +279,76 @@ int pthread_mutex_trytake(FAR struct pthread_mutex_s *mutex)
 
 int pthread_mutex_give(FAR struct pthread_mutex_s *mutex)
 {
-	FAR struct pthread_mutex_s *curr;
-	FAR struct pthread_mutex_s *prev;
 	int ret = EINVAL;
 
 	/* Verify input parameters */
 
 	DEBUGASSERT(mutex != NULL);
 	if (mutex != NULL) {
-		FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
-		irqstate_t flags;
-
-		flags = irqsave();
-
 		/* Remove the mutex from the list of mutexes held by this task */
 
-		for (prev = NULL, curr = rtcb->mhead; curr != NULL && curr != mutex; prev = curr, curr = curr->flink) ;
+		pthread_mutex_remove(mutex);
 
-		DEBUGASSERT(curr == mutex);
+		/* Now release the underlying semaphore */
 
-		/* Remove the mutex from the list.  prev == NULL means that the mutex
-		 * to be removed is at the head of the list.
-		 */
+		ret = pthread_sem_give(&mutex->sem);
+	}
 
-		if (prev == NULL) {
-			rtcb->mhead = mutex->flink;
-		} else {
-			prev->flink = mutex->flink;
-		}
+	return ret;
+}
 
-		mutex->flink = NULL;
-		irqrestore(flags);
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/****************************************************************************
+ * Name: pthread_mutex_fasttake
+ *
+ * Description:
+ *   Take a free pthread_mutex with a single atomic update of the count of
+ *   its semaphore, without locking the scheduler.  If successful, add the
+ *   mutex to the list of mutexes held by this thread.
+ *
+ * Parameters:
+ *  mutex - The mutex to be locked
+ *
+ * Return Value:
+ *   0 on success or EBUSY if the caller must fall back to
+ *   pthread_mutex_take().
+ *
+ ****************************************************************************/
 
-		/* Now release the underlying semaphore */
+int pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex)
+{
+	/* An inconsistent mutex is reported by pthread_mutex_take() */
 
-		ret = pthread_sem_give(&mutex->sem);
+	if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0 || pthread_sem_fasttake(&mutex->sem) != OK) {
+		return EBUSY;
 	}
 
-	return ret;
+	pthread_mutex_add(mutex);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastgive
+ *
+ * Description:
+ *   Remove the mutex from the list of mutexes held by this thread and give
+ *   it back with a single atomic update of the count of its semaphore.
+ *   sem_post() is only called if a thread waits for the mutex.
+ *
+ * Parameters:
+ *  mutex - The mutex to be unlocked
+ *
+ * Return Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex)
+{
+	pthread_mutex_remove(mutex);
+	return pthread_sem_fastgive(&mutex->sem);
 }
+#endif
 
 /****************************************************************************
  * Name: pthread_disable_cancel() and pthread_enable_cancel()
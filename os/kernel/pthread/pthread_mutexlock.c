@@ -150,6 +150,22 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 	DEBUGASSERT(mutex != NULL);
 
 	if (mutex != NULL) {
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		/* If the mutex is free, claim it with one atomic update of the
+		 * semaphore count.  Nobody holds a free mutex, so none of the
+		 * ownership checks below apply.
+		 */
+
+		if (pthread_mutex_fasttake(mutex) == OK) {
+			mutex->pid = mypid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+			mutex->nlocks = 1;
+#endif
+			svdbg("Returning %d\n", OK);
+			return OK;
+		}
+#endif
+
 		/* Make sure the semaphore is stable while we make the following
 		 * checks.  This all needs to be one atomic action.
 		 */
@@ -154,6 +154,26 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 		return EINVAL;
 	}
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* The owner releasing its outermost lock gives the mutex back with one
+	 * atomic update of the semaphore count unless a thread waits for it.
+	 */
+
+	if (mutex->pid == (int)getpid() && pthread_sem_canfast(&mutex->sem)
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		&& (mutex->type != PTHREAD_MUTEX_RECURSIVE || mutex->nlocks <= 1)
+#endif
+	   ) {
+		mutex->pid = -1;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 0;
+#endif
+		ret = pthread_mutex_fastgive(mutex);
+		svdbg("Returning %d\n", ret);
+		return ret;
+	}
+#endif
+
 	/* Make sure the semaphore is stable while we make the following checks.
 	 * This all needs to be one atomic action.
 	 */
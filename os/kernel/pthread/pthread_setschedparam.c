@@ -100,18 +100,19 @@
  *   is given by 'thread' to the policy and associated parameters provided
  *   in 'policy' and 'param', respectively.
  *
- *   The policy parameter may have the value SCHED_FIFO, or SCHED_RR
- *   (SCHED_OTHER and SCHED_SPORADIC, in particular, are not supported).
+ *   The policy parameter may have the value SCHED_FIFO, SCHED_RR or, with
+ *   CONFIG_SCHED_SPORADIC, SCHED_SPORADIC (SCHED_OTHER is not supported).
  *   The SCHED_FIFO and SCHED_RR policies will have a single scheduling
- *   parameter, sched_priority.
+ *   parameter, sched_priority; SCHED_SPORADIC also uses the sched_ss_*
+ *   members.
  *
  *   If the pthread_setschedparam() function fails, the scheduling parameters
  *   will not be changed for the target thread.
  *
  * Parameters:
  *   thread - The ID of thread whose scheduling parameters will be modified.
- *   policy - The new scheduling policy of the thread.  Either SCHED_FIFO or
- *            SCHED_RR. SCHED_OTHER and SCHED_SPORADIC are not supported.
+ *   policy - The new scheduling policy of the thread.  SCHED_FIFO, SCHED_RR
+ *            or SCHED_SPORADIC. SCHED_OTHER is not supported.
  *   param  - Provides the new priority of the thread.
  *
  * Return Value:
@@ -122,8 +123,8 @@
  *           parameters associated with the scheduling policy 'policy' is
  *           invalid.
  *   ENOTSUP An attempt was made to set the policy or scheduling parameters
- *           to an unsupported value (SCHED_OTHER and SCHED_SPORADIC in
- *           particular are not supported)
+ *           to an unsupported value (SCHED_OTHER in particular is not
+ *           supported)
  *   EPERM   The caller does not have the appropriate permission to set either
  *           the scheduling parameters or the scheduling policy of the
  *           specified thread. Or, the implementation does not allow the
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/pthread/pthread_tcbcache.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/sched.h>
+
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_TCBCACHE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The TCBs of exited pthreads, each with its stack still allocated */
+
+static FAR struct pthread_tcb_s *g_pthread_tcbcache[CONFIG_PTHREAD_TCBCACHE_SIZE];
+static uint8_t g_pthread_ncached;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new pthread.  The TCB of an exited pthread
+ *   is reused if one is cached, preferably one whose stack has the
+ *   requested size.  That stack is left attached to the TCB so that
+ *   up_create_stack() keeps it; a stack of another size is replaced by
+ *   up_create_stack().
+ *
+ * Parameters:
+ *   stack_size - The stack size that will be requested for the pthread
+ *
+ * Return Value:
+ *   The TCB or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct pthread_tcb_s *pthread_tcballoc(size_t stack_size)
+{
+	FAR struct pthread_tcb_s *ptcb = NULL;
+	FAR uint32_t *stack_alloc_ptr;
+	size_t adj_stack_size;
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	if (g_pthread_ncached > 0) {
+		for (i = g_pthread_ncached - 1; i > 0; i--) {
+			if (g_pthread_tcbcache[i]->cmn.adj_stack_size == stack_size) {
+				break;
+			}
+		}
+
+		ptcb = g_pthread_tcbcache[i];
+		g_pthread_tcbcache[i] = g_pthread_tcbcache[--g_pthread_ncached];
+	}
+	irqrestore(flags);
+
+	if (ptcb == NULL) {
+		return (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+	}
+
+	stack_alloc_ptr = ptcb->cmn.stack_alloc_ptr;
+	adj_stack_size = ptcb->cmn.adj_stack_size;
+
+	memset(ptcb, 0, sizeof(struct pthread_tcb_s));
+	ptcb->cmn.stack_alloc_ptr = stack_alloc_ptr;
+	ptcb->cmn.adj_stack_size = adj_stack_size;
+	return ptcb;
+}
+
+/****************************************************************************
+ * Name: pthread_tcbcache
+ *
+ * Description:
+ *   Keep the TCB of an exited pthread together with its stack for the next
+ *   pthread_create().  This is called by sched_releasetcb() once everything
+ *   else held by the TCB has been released.
+ *
+ * Parameters:
+ *   tcb - The TCB to keep
+ *
+ * Return Value:
+ *   true if the TCB was cached; false if the cache is full and the caller
+ *   must free the stack and the TCB.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool pthread_tcbcache(FAR struct tcb_s *tcb)
+{
+	if (g_pthread_ncached >= CONFIG_PTHREAD_TCBCACHE_SIZE) {
+		return false;
+	}
+
+	g_pthread_tcbcache[g_pthread_ncached++] = (FAR struct pthread_tcb_s *)tcb;
+	return true;
+}
+
+#endif							/* CONFIG_PTHREAD_TCBCACHE */
@@ -251,6 +251,10 @@ bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+bool sched_rtrinsert(FAR struct tcb_s *tcb);
+void sched_rtrremove(FAR struct tcb_s *tcb);
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
@@ -276,6 +280,21 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_SPORADIC
+int sched_sporadic_start(FAR struct tcb_s *tcb, FAR const struct sched_param *param);
+void sched_sporadic_stop(FAR struct tcb_s *tcb);
+int sched_sporadic_setpriority(FAR struct tcb_s *tcb, int sched_priority);
+void sched_process_sporadic(void);
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+void sched_cputime_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+void sched_cputime_irqenter(void);
+uint32_t sched_cputime_irqleave(void);
+#else
+#define sched_cputime_switch(f, t)
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
@@ -115,7 +115,7 @@
  *
  ****************************************************************************/
 
-bool sched_addreadytorun(FAR struct tcb_s *btcb)
+bool ramfunc_function sched_addreadytorun(FAR struct tcb_s *btcb)
 {
 	FAR struct tcb_s *rtcb = this_task();
 	bool ret;
@@ -137,10 +137,15 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
 	/* Otherwise, add the new task to the ready-to-run task list */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	else if (sched_rtrinsert(btcb)) {
+#else
 	else if (sched_addprioritized(btcb, (FAR dq_queue_t *)&g_readytorun)) {
+#endif
 		/* Inform the instrumentation logic that we are switching tasks */
 
 		sched_note_switch(rtcb, btcb);
+		sched_cputime_switch(rtcb, btcb);
 
 		/* The new btcb was added at the head of the ready-to-run list.  It
 		 * is now to new active task!
@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_cputime.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cycle counter when the CPU time was last charged */
+
+static uint32_t g_cputime_stamp;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t sched_cputime_elapsed(void)
+{
+	uint32_t now = up_perf_gettime();
+	uint32_t elapsed = now - g_cputime_stamp;
+
+	g_cputime_stamp = now;
+	return elapsed;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cputime_switch
+ *
+ * Description:
+ *   Charge the CPU time since the last switch or interrupt to the thread
+ *   that is switched out.  A switch made by an interrupt handler charges
+ *   nothing; that time belongs to the interrupt.
+ *
+ * Inputs:
+ *   from - The thread that was running
+ *   to - The thread that runs next
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_cputime_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+	if (!up_interrupt_context()) {
+		from->cputime += sched_cputime_elapsed();
+	}
+}
+
+/****************************************************************************
+ * Name: sched_cputime_irqenter and sched_cputime_irqleave
+ *
+ * Description:
+ *   Called by irq_dispatch() around the interrupt handler.  Entry charges
+ *   the interrupted thread; leave returns the cycles spent in the handler.
+ *   Interrupts are assumed not to nest.
+ *
+ ****************************************************************************/
+
+void sched_cputime_irqenter(void)
+{
+	this_task()->cputime += sched_cputime_elapsed();
+}
+
+uint32_t sched_cputime_irqleave(void)
+{
+	return sched_cputime_elapsed();
+}
+
+/****************************************************************************
+ * Function:  clock_cputime
+ *
+ * Description:
+ *   Return the CPU time used by a thread so far, including the time since
+ *   it was last switched in if it is running.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE thread.
+ *   usec - The location to return the CPU time in microseconds
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if 'pid' does not refer to a valid thread.
+ *
+ ****************************************************************************/
+
+int clock_cputime(int pid, FAR uint64_t *usec)
+{
+	FAR struct tcb_s *tcb;
+	irqstate_t flags;
+	uint64_t cycles;
+
+	flags = irqsave();
+	tcb = sched_gettcb(pid);
+	if (tcb == NULL) {
+		irqrestore(flags);
+		return -ESRCH;
+	}
+
+	cycles = tcb->cputime;
+	if (tcb == this_task()) {
+		cycles += (uint32_t)(up_perf_gettime() - g_cputime_stamp);
+	}
+
+	irqrestore(flags);
+
+	*usec = cycles / CONFIG_ARCH_PERF_CYCLES_PER_USEC;
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_CPUTIME */
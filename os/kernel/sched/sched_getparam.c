@@ -57,9 +57,13 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <string.h>
 #include <sched.h>
 
 #include "sched/sched.h"
+#ifdef CONFIG_SCHED_SPORADIC
+#include "clock/clock.h"
+#endif
 
 /************************************************************************
  * Definitions
@@ -85,6 +89,34 @@
  * Private Functions
  ************************************************************************/
 
+/************************************************************************
+ * Name: sched_getparam_tcb
+ *
+ * Description:
+ *   Copy the scheduling parameters of one thread.  A sporadic thread
+ *   reports its high priority even while its budget is exhausted.
+ *
+ ************************************************************************/
+
+static void sched_getparam_tcb(FAR struct tcb_s *tcb, FAR struct sched_param *param)
+{
+#ifdef CONFIG_SCHED_SPORADIC
+	if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC) {
+		param->sched_priority = (int)tcb->sporadic.hi_priority;
+		param->sched_ss_low_priority = (int)tcb->sporadic.low_priority;
+		(void)clock_ticks2time((int)tcb->sporadic.period, &param->sched_ss_repl_period);
+		(void)clock_ticks2time((int)tcb->sporadic.budget, &param->sched_ss_init_budget);
+		return;
+	}
+
+	param->sched_ss_low_priority = 0;
+	memset(&param->sched_ss_repl_period, 0, sizeof(struct timespec));
+	memset(&param->sched_ss_init_budget, 0, sizeof(struct timespec));
+#endif
+
+	param->sched_priority = (int)tcb->sched_priority;
+}
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -129,7 +161,7 @@ int sched_getparam(pid_t pid, struct sched_param *param)
 	if ((pid == 0) || (pid == rtcb->pid)) {
 		/* Return the priority if the calling task. */
 
-		param->sched_priority = (int)rtcb->sched_priority;
+		sched_getparam_tcb(rtcb, param);
 	}
 
 	/* Ths pid is not for the calling task, we will have to look it up */
@@ -146,7 +178,7 @@ int sched_getparam(pid_t pid, struct sched_param *param)
 		} else {
 			/* Return the priority of the task */
 
-			param->sched_priority = (int)tcb->sched_priority;
+			sched_getparam_tcb(tcb, param);
 		}
 
 		sched_unlock();
@@ -106,7 +106,7 @@
  *
  * Return Value:
  *    On success, sched_getscheduler() returns the policy for the task
- *    (either SCHED_FIFO or SCHED_RR).  On error,  ERROR (-1) is
+ *    (SCHED_FIFO, SCHED_RR or SCHED_SPORADIC).  On error,  ERROR (-1) is
  *    returned, and errno is set appropriately:
  *
  *      ESRCH  The task whose ID is pid could not be found.
@@ -131,6 +131,11 @@ int sched_getscheduler(pid_t pid)
 		set_errno(ESRCH);
 		return ERROR;
 	}
+#ifdef CONFIG_SCHED_SPORADIC
+	else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC) {
+		return SCHED_SPORADIC;
+	}
+#endif
 #if CONFIG_RR_INTERVAL > 0
 	else if ((tcb->flags & TCB_FLAG_ROUND_ROBIN) != 0) {
 		return SCHED_RR;
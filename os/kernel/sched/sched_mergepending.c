@@ -114,9 +114,34 @@ bool sched_mergepending(void)
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
 	FAR struct tcb_s *rtrtcb;
+#ifndef CONFIG_SCHED_PRIORITY_BITMAP
 	FAR struct tcb_s *rtrprev;
+#endif
 	bool ret = false;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	/* Each pending task is inserted in constant time using the priority
+	 * index of the g_readytorun list.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+		rtrtcb = this_task();
+
+		if (sched_rtrinsert(pndtcb)) {
+			/* Inform the instrumentation layer that we are switching tasks */
+
+			sched_note_switch(rtrtcb, pndtcb);
+			sched_cputime_switch(rtrtcb, pndtcb);
+
+			rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+#else
 	/* Initialize the inner search loop */
 
 	rtrtcb = this_task();
@@ -149,6 +174,7 @@ bool sched_mergepending(void)
 			/* Inform the instrumentation layer that we are switching tasks */
 
 			sched_note_switch(rtrtcb, pndtcb);
+			sched_cputime_switch(rtrtcb, pndtcb);
 
 			/* Then insert at the head of the list */
 
@@ -173,6 +199,7 @@ bool sched_mergepending(void)
 
 		rtrtcb = pndtcb;
 	}
+#endif
 
 	/* Mark the input list empty */
 
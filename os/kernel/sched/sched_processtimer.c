@@ -223,4 +223,10 @@ void sched_process_timer(void)
 	 */
 
 	sched_process_timeslice();
+
+#ifdef CONFIG_SCHED_SPORADIC
+	/* Charge the tick against the budget of a sporadic thread */
+
+	sched_process_sporadic();
+#endif
 }
@@ -66,6 +66,9 @@
 #include "sched/sched.h"
 #include "group/group.h"
 #include "timer/timer.h"
+#ifdef CONFIG_PTHREAD_TCBCACHE
+#include "pthread/pthread.h"
+#endif
 #if defined(CONFIG_ENABLE_STACKMONITOR) && defined(CONFIG_DEBUG)
 #include <apps/system/utils.h>
 #endif
@@ -140,6 +143,14 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 		stkmon_logging(tcb);
 #endif
 
+#ifdef CONFIG_SCHED_SPORADIC
+		/* Stop charging ticks to a sporadic thread */
+
+		if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC) {
+			sched_sporadic_stop(tcb);
+		}
+#endif
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 		/* Release any timers that the task might hold.  We do this
 		 * before release the PID because it may still be trying to
@@ -165,26 +176,12 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 			sched_releasepid(tcb->pid);
 		}
 
-		/* Delete the thread's stack if one has been allocated */
+#ifdef CONFIG_MM_TASK_CACHE
+		/* Return any small chunks cached by the thread to the heap */
 
-		if (tcb->stack_alloc_ptr) {
-#ifdef CONFIG_BUILD_KERNEL
-			/* If the exiting thread is not a kernel thread, then it has an
-			 * address environment.  Don't bother to release the stack memory
-			 * in this case... There is no point since the memory lies in the
-			 * user memory region that will be destroyed anyway (and the
-			 * address environment has probably already been destroyed at
-			 * this point.. so we would crash if we even tried it).  But if
-			 * this is a privileged group, when we still have to release the
-			 * memory using the kernel allocator.
-			 */
-
-			if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
+		umm_cache_drain(tcb);
 #endif
-			{
-				up_release_stack(tcb, ttype);
-			}
-		}
+
 #ifdef CONFIG_PIC
 		/* Delete the task's allocated DSpace region (external modules only) */
 
@@ -215,6 +212,35 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 		group_leave(tcb);
 #endif
 
+#ifdef CONFIG_PTHREAD_TCBCACHE
+		/* Keep the TCB and the stack of a pthread for the next pthread */
+
+		if (ttype == TCB_FLAG_TTYPE_PTHREAD && pthread_tcbcache(tcb)) {
+			return ret;
+		}
+#endif
+
+		/* Delete the thread's stack if one has been allocated */
+
+		if (tcb->stack_alloc_ptr) {
+#ifdef CONFIG_BUILD_KERNEL
+			/* If the exiting thread is not a kernel thread, then it has an
+			 * address environment.  Don't bother to release the stack memory
+			 * in this case... There is no point since the memory lies in the
+			 * user memory region that will be destroyed anyway (and the
+			 * address environment has probably already been destroyed at
+			 * this point.. so we would crash if we even tried it).  But if
+			 * this is a privileged group, when we still have to release the
+			 * memory using the kernel allocator.
+			 */
+
+			if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
+#endif
+			{
+				up_release_stack(tcb, ttype);
+			}
+		}
+
 		/* And, finally, release the TCB itself */
 
 		sched_kfree(tcb);
@@ -107,7 +107,7 @@
  *
  ****************************************************************************/
 
-bool sched_removereadytorun(FAR struct tcb_s *rtcb)
+bool ramfunc_function sched_removereadytorun(FAR struct tcb_s *rtcb)
 {
 	FAR struct tcb_s *ntcb = NULL;
 	bool ret = false;
@@ -125,13 +125,18 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 		/* Inform the instrumentation layer that we are switching tasks */
 
 		sched_note_switch(rtcb, ntcb);
+		sched_cputime_switch(rtcb, ntcb);
 		ntcb->task_state = TSTATE_TASK_RUNNING;
 		ret = true;
 	}
 
 	/* Remove the TCB from the ready-to-run list */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	sched_rtrremove(rtcb);
+#else
 	dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
 
 	/* Since the TCB is not in any list, it is now invalid */
 
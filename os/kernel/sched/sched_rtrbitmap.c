@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_rtrbitmap.c
+ *
+ * Constant-time insertion into the g_readytorun list.  The list itself is
+ * unchanged (its head is still the running task and it is still sorted by
+ * descending priority), but it is indexed by priority:  a 256-bit bitmap
+ * records which priorities have ready-to-run tasks and, for each such
+ * priority, the last task of that priority is remembered.  Since tasks of
+ * the same priority are kept in FIFO order, a new task always goes right
+ * after the last task of the lowest priority that is greater than or equal
+ * to its own, which is found with a single bit scan.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NWORDS ((SCHED_PRIORITY_MAX >> 5) + 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Bit 'n' is set if a task of priority 'n' is in the g_readytorun list */
+
+static uint32_t g_rtrbitmap[RTR_NWORDS];
+
+/* The last task of each priority in the g_readytorun list */
+
+static FAR struct tcb_s *g_rtrtail[SCHED_PRIORITY_MAX + 1];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtrfind
+ *
+ * Description:
+ *   Return the lowest priority greater than or equal to 'priority' that has
+ *   a task in the g_readytorun list, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static inline int sched_rtrfind(int priority)
+{
+	int ndx = priority >> 5;
+	uint32_t word;
+
+	word = g_rtrbitmap[ndx] & ~((1u << (priority & 31)) - 1);
+	while (word == 0) {
+		if (++ndx >= RTR_NWORDS) {
+			return -1;
+		}
+
+		word = g_rtrbitmap[ndx];
+	}
+
+	return (ndx << 5) + __builtin_ctz(word);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtrinsert
+ *
+ * Description:
+ *   Insert a TCB into the g_readytorun list behind every ready-to-run task
+ *   of the same or higher priority.  The task state is not modified.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to be inserted
+ *
+ * Return Value:
+ *   true if the TCB was inserted at the head of the list.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool sched_rtrinsert(FAR struct tcb_s *tcb)
+{
+	int priority = tcb->sched_priority;
+	int ndx;
+	bool ret = false;
+
+	ndx = sched_rtrfind(priority);
+	if (ndx < 0) {
+		/* No other ready-to-run task has the same or higher priority */
+
+		dq_addfirst((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+		ret = true;
+	} else {
+		dq_addafter((FAR dq_entry_t *)g_rtrtail[ndx], (FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+	}
+
+	g_rtrtail[priority] = tcb;
+	g_rtrbitmap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: sched_rtrremove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list.  The task state is not
+ *   modified.  The priority of the TCB must not have been changed since it
+ *   was inserted.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to be removed
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_rtrremove(FAR struct tcb_s *tcb)
+{
+	FAR struct tcb_s *prev = tcb->blink;
+	int priority = tcb->sched_priority;
+
+	if (g_rtrtail[priority] == tcb) {
+		if (prev && prev->sched_priority == priority) {
+			g_rtrtail[priority] = prev;
+		} else {
+			/* This was the only ready-to-run task of its priority */
+
+			g_rtrtail[priority] = NULL;
+			g_rtrbitmap[priority >> 5] &= ~((uint32_t)1 << (priority & 31));
+		}
+	}
+
+	dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+#endif							/* CONFIG_SCHED_PRIORITY_BITMAP */
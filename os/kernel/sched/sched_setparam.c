@@ -163,7 +163,14 @@ int sched_setparam(pid_t pid, const struct sched_param *param)
 
 	/* Then perform the reprioritization */
 
-	ret = sched_reprioritize(tcb, param->sched_priority);
+#ifdef CONFIG_SCHED_SPORADIC
+	if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC) {
+		ret = sched_sporadic_setpriority(tcb, param->sched_priority);
+	} else
+#endif
+	{
+		ret = sched_reprioritize(tcb, param->sched_priority);
+	}
 	sched_unlock();
 	return ret;
 }
@@ -163,7 +163,17 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		else {
 			/* Change the task priority */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+			/* The task stays at the head of the list, but it must be
+			 * indexed under its new priority.
+			 */
+
+			sched_rtrremove(tcb);
+			tcb->sched_priority = (uint8_t)sched_priority;
+			(void)sched_rtrinsert(tcb);
+#else
 			tcb->sched_priority = (uint8_t)sched_priority;
+#endif
 		}
 		break;
 
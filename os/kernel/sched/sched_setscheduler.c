@@ -106,16 +106,19 @@
  * Inputs:
  *   pid - the task ID of the task to modify.  If pid is zero, the calling
  *      task is modified.
- *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
+ *   policy - Scheduling policy requested (SCHED_FIFO, SCHED_RR or
+ *      SCHED_SPORADIC)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
- *      through SCHED_PRIORITY_MAX.
+ *      through SCHED_PRIORITY_MAX.  For SCHED_SPORADIC the sched_ss_*
+ *      members give the low priority, replenishment period and budget.
  *
  * Return Value:
  *   On success, sched_setscheduler() returns OK (zero).  On error, ERROR
  *   (-1) is returned, and errno is set appropriately:
  *
- *   EINVAL The scheduling policy is not one of the recognized policies.
+ *   EINVAL The scheduling policy is not one of the recognized policies,
+ *          or the sporadic parameters are inconsistent.
  *   ESRCH  The task whose ID is pid could not be found.
  *
  * Assumptions:
@@ -132,8 +135,12 @@ int sched_setscheduler(pid_t pid, int policy, const struct sched_param *param)
 
 	/* Check for supported scheduling policy */
 
-#if CONFIG_RR_INTERVAL > 0
+#if CONFIG_RR_INTERVAL > 0 && defined(CONFIG_SCHED_SPORADIC)
+	if (policy != SCHED_FIFO && policy != SCHED_RR && policy != SCHED_SPORADIC)
+#elif CONFIG_RR_INTERVAL > 0
 	if (policy != SCHED_FIFO && policy != SCHED_RR)
+#elif defined(CONFIG_SCHED_SPORADIC)
+	if (policy != SCHED_FIFO && policy != SCHED_SPORADIC)
 #else
 	if (policy != SCHED_FIFO)
 #endif
@@ -162,6 +169,19 @@ int sched_setscheduler(pid_t pid, int policy, const struct sched_param *param)
 
 	sched_lock();
 
+#ifdef CONFIG_SCHED_SPORADIC
+	if (policy == SCHED_SPORADIC) {
+		ret = sched_sporadic_start(tcb, param);
+		if (ret != OK) {
+			sched_unlock();
+			set_errno(ret);
+			return ERROR;
+		}
+	} else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC) {
+		sched_sporadic_stop(tcb);
+	}
+#endif
+
 #if CONFIG_RR_INTERVAL > 0
 	/* Further, disable timer interrupts while we set up scheduling policy. */
 
@@ -172,7 +192,7 @@ int sched_setscheduler(pid_t pid, int policy, const struct sched_param *param)
 		tcb->flags |= TCB_FLAG_ROUND_ROBIN;
 		tcb->timeslice = MSEC2TICK(CONFIG_RR_INTERVAL);
 	} else {
-		/* Set FIFO scheduling */
+		/* Set FIFO (or sporadic) scheduling */
 
 		tcb->flags &= ~TCB_FLAG_ROUND_ROBIN;
 		tcb->timeslice = 0;
@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_sporadic.c
+ *
+ * SCHED_SPORADIC budgets.  Each sporadic thread may run at its high
+ * priority for 'budget' ticks out of every 'period' ticks.  The tick that
+ * interrupts a sporadic thread is charged to it; once the budget is used up
+ * the thread drops to its low priority, and at the end of the period the
+ * budget is refilled and the high priority restored.  This is a single
+ * replenishment per period rather than the POSIX replenishment queue.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+#include "clock/clock.h"
+
+#ifdef CONFIG_SCHED_SPORADIC
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All threads running under SCHED_SPORADIC, linked through sporadic.flink */
+
+static FAR struct tcb_s *g_sporadic_head;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_sporadic_switch
+ *
+ * Description:
+ *   Move a sporadic thread between its high and low priority.  A thread
+ *   that currently holds a priority inherited from a waiter keeps it; with
+ *   priority inheritance only the priority it returns to is changed.
+ *
+ ****************************************************************************/
+
+static void sched_sporadic_switch(FAR struct tcb_s *tcb, uint8_t from, uint8_t to)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	if (tcb->base_priority == from) {
+		tcb->base_priority = to;
+	}
+#endif
+
+	if (tcb->sched_priority == from) {
+		(void)sched_setpriority(tcb, to);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_sporadic_start
+ *
+ * Description:
+ *   Validate the sporadic parameters and put the thread under
+ *   SCHED_SPORADIC with a full budget.  The caller then sets the thread to
+ *   param->sched_priority.
+ *
+ * Inputs:
+ *   tcb - The thread to modify
+ *   param - The high priority, low priority, period and budget
+ *
+ * Return Value:
+ *   OK on success; EINVAL if the parameters are inconsistent.
+ *
+ ****************************************************************************/
+
+int sched_sporadic_start(FAR struct tcb_s *tcb, FAR const struct sched_param *param)
+{
+	irqstate_t flags;
+	int budget;
+	int period;
+
+	if (param->sched_priority < SCHED_PRIORITY_MIN || param->sched_priority > SCHED_PRIORITY_MAX || param->sched_ss_low_priority < SCHED_PRIORITY_MIN || param->sched_ss_low_priority >= param->sched_priority) {
+		return EINVAL;
+	}
+
+	if (clock_time2ticks(&param->sched_ss_init_budget, &budget) != OK || clock_time2ticks(&param->sched_ss_repl_period, &period) != OK || budget <= 0 || period < budget) {
+		return EINVAL;
+	}
+
+	flags = irqsave();
+
+	/* A thread that is already sporadic just takes the new parameters */
+
+	if ((tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_SPORADIC) {
+		tcb->sporadic.flink = g_sporadic_head;
+		g_sporadic_head = tcb;
+	}
+
+	tcb->sporadic.hi_priority = (uint8_t)param->sched_priority;
+	tcb->sporadic.low_priority = (uint8_t)param->sched_ss_low_priority;
+	tcb->sporadic.exhausted = 0;
+	tcb->sporadic.budget = (uint32_t)budget;
+	tcb->sporadic.period = (uint32_t)period;
+	tcb->sporadic.remaining = (uint32_t)budget;
+	tcb->sporadic.elapsed = 0;
+
+	tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+	tcb->flags |= TCB_FLAG_SCHED_SPORADIC;
+
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: sched_sporadic_stop
+ *
+ * Description:
+ *   Take a thread off SCHED_SPORADIC, either because its policy changes or
+ *   because it is exiting.  The thread is left as SCHED_FIFO at whatever
+ *   priority it has; the caller sets the new policy and priority.
+ *
+ ****************************************************************************/
+
+void sched_sporadic_stop(FAR struct tcb_s *tcb)
+{
+	FAR struct tcb_s **link;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	for (link = &g_sporadic_head; *link != NULL; link = &(*link)->sporadic.flink) {
+		if (*link == tcb) {
+			*link = tcb->sporadic.flink;
+			break;
+		}
+	}
+
+	tcb->sporadic.flink = NULL;
+	tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: sched_sporadic_setpriority
+ *
+ * Description:
+ *   Change the high priority of a sporadic thread.  While the budget is
+ *   exhausted the thread stays at its low priority and the new priority
+ *   takes effect at the next replenishment.
+ *
+ * Return Value:
+ *   OK on success; ERROR with errno set to EINVAL if the priority is not
+ *   above the low priority.
+ *
+ ****************************************************************************/
+
+int sched_sporadic_setpriority(FAR struct tcb_s *tcb, int sched_priority)
+{
+	irqstate_t flags;
+	int ret = OK;
+
+	if (sched_priority > SCHED_PRIORITY_MAX || sched_priority <= tcb->sporadic.low_priority) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	flags = irqsave();
+
+	tcb->sporadic.hi_priority = (uint8_t)sched_priority;
+	if (!tcb->sporadic.exhausted) {
+		ret = sched_reprioritize(tcb, sched_priority);
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: sched_process_sporadic
+ *
+ * Description:
+ *   Charge one tick to the running sporadic thread and advance the period
+ *   of every sporadic thread.  Called from sched_process_timer().
+ *
+ * Assumptions:
+ *   Called from the timer interrupt.
+ *
+ ****************************************************************************/
+
+void sched_process_sporadic(void)
+{
+	FAR struct tcb_s *rtcb = this_task();
+	FAR struct tcb_s *tcb;
+	FAR struct sporadic_s *ss;
+
+	for (tcb = g_sporadic_head; tcb != NULL; tcb = ss->flink) {
+		ss = &tcb->sporadic;
+
+		if (tcb == rtcb && ss->remaining > 0) {
+			ss->remaining--;
+		}
+
+		if (++ss->elapsed >= ss->period) {
+			/* Start a new period with a full budget */
+
+			ss->elapsed = 0;
+			ss->remaining = ss->budget;
+			if (ss->exhausted) {
+				ss->exhausted = 0;
+				sched_sporadic_switch(tcb, ss->low_priority, ss->hi_priority);
+			}
+		} else if (ss->remaining == 0 && !ss->exhausted && tcb->lockcount == 0) {
+			/* The budget is used up.  A thread with pre-emption disabled
+			 * keeps its priority until it enables pre-emption again.
+			 */
+
+			ss->exhausted = 1;
+			sched_sporadic_switch(tcb, ss->hi_priority, ss->low_priority);
+		}
+	}
+}
+
+#endif							/* CONFIG_SCHED_SPORADIC */
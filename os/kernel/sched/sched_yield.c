@@ -127,11 +127,16 @@ int sched_yield(void)
 
 		/* A context switch will occur. */
 		sched_note_switch(rtcb, ntcb);
+		sched_cputime_switch(rtcb, ntcb);
 		ntcb->task_state = TSTATE_TASK_RUNNING;
 		switch_needed = true;
 
 		/* Remove the TCB from the ready-to-run list */
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+		sched_rtrremove(rtcb);
+#else
 		dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
 
 		/* Since the current TCB is not in any list, it is now invalid */
 		rtcb->task_state = TSTATE_TASK_INVALID;
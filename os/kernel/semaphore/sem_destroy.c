@@ -131,6 +131,7 @@ int sem_destroy(FAR sem_t *sem)
 		/* Release holders of the semaphore */
 
 		sem_destroyholder(sem);
+		sem_lockstat_remove(sem);
 		return OK;
 	} else {
 		set_errno(EINVAL);
@@ -110,29 +110,28 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
 {
 	FAR struct semholder_s *pholder;
 
-	/* Check if the "built-in" holder is being used.  We have this built-in
-	 * holder to optimize for the simplest case where semaphores are only
-	 * used to implement mutexes.
+	/* Use the holder embedded in the semaphore first.  It is the only one
+	 * needed when the semaphore implements a mutex, so that finding and
+	 * releasing the holder of a mutex never walks a list.
 	 */
 
+	if (!sem->holder.htcb) {
+		pholder = &sem->holder;
+		pholder->counts = 0;
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	pholder = g_freeholders;
-	if (pholder) {
+	else if (g_freeholders) {
 		/* Remove the holder from the free list an put it into the semaphore's
 		 * holder list
 		 */
 
+		pholder = g_freeholders;
 		g_freeholders = pholder->flink;
 		pholder->flink = sem->hhead;
 		sem->hhead = pholder;
 
 		/* Make sure the initial count is zero */
 
-		pholder->counts = 0;
-	}
-#else
-	if (!sem->holder.htcb) {
-		pholder = &sem->holder;
 		pholder->counts = 0;
 	}
 #endif
@@ -152,22 +151,22 @@ static FAR struct semholder_s *sem_findholder(sem_t *sem, FAR struct tcb_s *htcb
 {
 	FAR struct semholder_s *pholder;
 
-	/* Try to find the holder in the list of holders associated with this
-	 * semaphore
+	/* Try the embedded holder before the list of further holders
+	 * associated with this semaphore
 	 */
 
+	if (sem->holder.htcb == htcb) {
+		return &sem->holder;
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	for (pholder = sem->hhead; pholder; pholder = pholder->flink)
-#else
-	pholder = &sem->holder;
-#endif
-	{
+	for (pholder = sem->hhead; pholder; pholder = pholder->flink) {
 		if (pholder->htcb == htcb) {
 			/* Got it! */
 
 			return pholder;
 		}
 	}
+#endif
 
 	/* The holder does not appear in the list */
 
@@ -205,6 +204,12 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 	pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+	/* The embedded holder is not part of the list */
+
+	if (pholder == &sem->holder) {
+		return;
+	}
+
 	/* Search the list for the matching holder */
 
 	for (prev = NULL, curr = sem->hhead; curr && curr != pholder; prev = curr, curr = curr->flink) ;
@@ -232,31 +237,29 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 
 static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler, FAR void *arg)
 {
-	FAR struct semholder_s *pholder;
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+	FAR struct semholder_s *pholder;
 	FAR struct semholder_s *next;
 #endif
 	int ret = 0;
 
+	/* The embedded holder may hold a NULL holder */
+
+	if (sem->holder.htcb) {
+		ret = handler(&sem->holder, sem, arg);
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
-#else
-	pholder = &sem->holder;
-#endif
-	{
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+	for (pholder = sem->hhead; pholder && ret == 0; pholder = next) {
 		/* In case this holder gets deleted */
 
 		next = pholder->flink;
-#endif
-		/* The initial "built-in" container may hold a NULL holder */
-
 		if (pholder->htcb) {
 			/* Call the handler */
 
 			ret = handler(pholder, sem, arg);
 		}
 	}
+#endif
 
 	return ret;
 }
@@ -394,11 +397,7 @@ static int sem_verifyholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR
 #if defined(CONFIG_DEBUG) && defined(CONFIG_SEM_PHDEBUG)
 static int sem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-	vdbg("  %08x: %08x %08x %04x\n", pholder, pholder->flink, pholder->htcb, pholder->counts);
-#else
 	vdbg("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
-#endif
 	return 0;
 }
 #endif
@@ -551,25 +550,6 @@ static int sem_restoreholderprioA(FAR struct semholder_s *pholder, FAR sem_t *se
 	return 0;
 }
 
-/****************************************************************************
- * Name: sem_restoreholderprioB
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int sem_restoreholderprioB(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
-{
-	FAR struct tcb_s *rtcb = this_task();
-	if (pholder->htcb == rtcb) {
-		(void)sem_restoreholderprio(pholder, sem, arg);
-		return 1;
-	}
-
-	return 0;
-}
-
 /****************************************************************************
  * Name: sem_restorebaseprio_irq
  *
@@ -683,10 +663,6 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb, FAR sem_t *s
 		 */
 
 		(void)sem_foreachholder(sem, sem_restoreholderprioA, stcb);
-
-		/* Now, find an reprioritize only the ready to run task */
-
-		(void)sem_foreachholder(sem, sem_restoreholderprioB, stcb);
 	}
 
 	/* If there are no tasks waiting for available counts, then all holders
@@ -706,11 +682,18 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb, FAR sem_t *s
 
 	pholder = sem_findholder(sem, rtcb);
 	if (pholder) {
+		/* Now reprioritize only the ready to run task */
+
+		if (stcb) {
+			(void)sem_restoreholderprio(pholder, sem, stcb);
+		}
+
 		/* When no more counts are held, remove the holder from the list.  The
-		 * count was decremented in sem_releaseholder.
+		 * count was decremented in sem_releaseholder.  A stale holder may
+		 * already have been freed above.
 		 */
 
-		if (pholder->counts <= 0) {
+		if (pholder->htcb == rtcb && pholder->counts <= 0) {
 			sem_freeholder(sem, pholder);
 		}
 	}
@@ -787,13 +770,13 @@ void sem_destroyholder(FAR sem_t *sem)
 		sdbg("Semaphore destroyed with holders\n");
 		(void)sem_foreachholder(sem, sem_recoverholders, NULL);
 	}
-#else
+#endif
 	if (sem->holder.htcb) {
 		sdbg("Semaphore destroyed with holder\n");
 	}
 
 	sem->holder.htcb = NULL;
-#endif
+	sem->holder.counts = 0;
 }
 
 /****************************************************************************
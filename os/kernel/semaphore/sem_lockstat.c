@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/semaphore/sem_lockstat.c
+ *
+ * Semaphore contention statistics.  Tracked semaphores are kept in a small
+ * open addressing table keyed by their address, so that sem_t keeps its
+ * layout and its static initializers.  A semaphore enters the table when
+ * it is named with sem_setname() or at its first blocking wait, and leaves
+ * it in sem_destroy().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SEM_LOCKSTAT_NENTRIES & (CONFIG_SEM_LOCKSTAT_NENTRIES - 1)) != 0
+#error "CONFIG_SEM_LOCKSTAT_NENTRIES must be a power of two"
+#endif
+
+#define LOCKSTAT_MASK     (CONFIG_SEM_LOCKSTAT_NENTRIES - 1)
+
+/* Marks a slot freed by sem_destroy(); lookups probe past it */
+
+#define LOCKSTAT_DELETED  ((FAR sem_t *)1)
+
+/* Convert a difference of sem_lockstat_now() values to microseconds */
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+#define LOCKSTAT_USEC(t)  ((t) / CONFIG_ARCH_PERF_CYCLES_PER_USEC)
+#else
+#define LOCKSTAT_USEC(t)  ((t) * USEC_PER_TICK)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sem_lockstat_s g_lockstat[CONFIG_SEM_LOCKSTAT_NENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline unsigned int lockstat_hash(FAR sem_t *sem)
+{
+	uintptr_t key = (uintptr_t)sem;
+
+	return (unsigned int)((key >> 2) ^ (key >> 9)) & LOCKSTAT_MASK;
+}
+
+/****************************************************************************
+ * Name: lockstat_find
+ *
+ * Description:
+ *   Return the entry of 'sem'.  If it is not tracked yet and 'create' is
+ *   true, a free slot is assigned to it.  Returns NULL if the semaphore
+ *   is not tracked (or the table is full).  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static FAR struct sem_lockstat_s *lockstat_find(FAR sem_t *sem, bool create)
+{
+	FAR struct sem_lockstat_s *avail = NULL;
+	unsigned int index = lockstat_hash(sem);
+	int i;
+
+	for (i = 0; i < CONFIG_SEM_LOCKSTAT_NENTRIES; i++) {
+		FAR struct sem_lockstat_s *entry = &g_lockstat[index];
+
+		if (entry->sem == sem) {
+			return entry;
+		}
+
+		if (entry->sem == LOCKSTAT_DELETED) {
+			if (avail == NULL) {
+				avail = entry;
+			}
+		} else if (entry->sem == NULL) {
+			if (avail == NULL) {
+				avail = entry;
+			}
+
+			break;
+		}
+
+		index = (index + 1) & LOCKSTAT_MASK;
+	}
+
+	if (!create || avail == NULL) {
+		return NULL;
+	}
+
+	memset(avail, 0, sizeof(struct sem_lockstat_s));
+	avail->sem = sem;
+	avail->holder = -1;
+	return avail;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_lockstat_now
+ *
+ * Description:
+ *   Return the time stamp taken before a blocking wait.
+ *
+ ****************************************************************************/
+
+uint32_t sem_lockstat_now(void)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	return up_perf_gettime();
+#else
+	return clock_systimer();
+#endif
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_acquired
+ *
+ * Description:
+ *   Account an acquisition that did not block.  Called by sem_wait() and
+ *   sem_trywait() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_acquired(FAR sem_t *sem, FAR void *caller)
+{
+	FAR struct sem_lockstat_s *entry = lockstat_find(sem, false);
+
+	if (entry != NULL) {
+		entry->nacquire++;
+		entry->holder = this_task()->pid;
+		entry->caller = caller;
+	}
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_waited
+ *
+ * Description:
+ *   Account a wait that blocked since 'start', whether or not it ended
+ *   with the semaphore acquired.  Called by sem_wait() with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_waited(FAR sem_t *sem, FAR void *caller, uint32_t start, bool acquired)
+{
+	FAR struct sem_lockstat_s *entry = lockstat_find(sem, true);
+	uint32_t elapsed;
+
+	if (entry == NULL) {
+		return;
+	}
+
+	elapsed = LOCKSTAT_USEC(sem_lockstat_now() - start);
+	entry->nwait++;
+	entry->totalwait += elapsed;
+	if (elapsed > entry->maxwait) {
+		entry->maxwait = elapsed;
+	}
+
+	if (acquired) {
+		entry->nacquire++;
+		entry->holder = this_task()->pid;
+		entry->caller = caller;
+	}
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_released
+ *
+ * Description:
+ *   Clear the holder of 'sem'.  Called by sem_post() with interrupts
+ *   disabled, before a waiter is given the semaphore.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_released(FAR sem_t *sem)
+{
+	FAR struct sem_lockstat_s *entry = lockstat_find(sem, false);
+
+	if (entry != NULL) {
+		entry->holder = -1;
+		entry->caller = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_remove
+ *
+ * Description:
+ *   Stop tracking 'sem'.  Called by sem_destroy().
+ *
+ ****************************************************************************/
+
+void sem_lockstat_remove(FAR sem_t *sem)
+{
+	FAR struct sem_lockstat_s *entry;
+	irqstate_t flags;
+
+	flags = irqsave();
+	entry = lockstat_find(sem, false);
+	if (entry != NULL) {
+		entry->sem = LOCKSTAT_DELETED;
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: sem_setname
+ ****************************************************************************/
+
+int sem_setname(FAR sem_t *sem, FAR const char *name)
+{
+	FAR struct sem_lockstat_s *entry;
+	irqstate_t flags;
+
+	if (sem == NULL) {
+		return -EINVAL;
+	}
+
+	flags = irqsave();
+	entry = lockstat_find(sem, true);
+	if (entry != NULL) {
+		entry->name = name;
+	}
+
+	irqrestore(flags);
+	return entry != NULL ? OK : -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: sem_lockstat
+ ****************************************************************************/
+
+int sem_lockstat(FAR struct sem_lockstat_s *stats, int nentries)
+{
+	irqstate_t flags;
+	int n = 0;
+	int i;
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_SEM_LOCKSTAT_NENTRIES && n < nentries; i++) {
+		if (g_lockstat[i].sem != NULL && g_lockstat[i].sem != LOCKSTAT_DELETED) {
+			stats[n++] = g_lockstat[i];
+		}
+	}
+
+	irqrestore(flags);
+	return n;
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_reset
+ ****************************************************************************/
+
+void sem_lockstat_reset(void)
+{
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_SEM_LOCKSTAT_NENTRIES; i++) {
+		g_lockstat[i].nacquire = 0;
+		g_lockstat[i].nwait = 0;
+		g_lockstat[i].maxwait = 0;
+		g_lockstat[i].totalwait = 0;
+	}
+
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_SEM_LOCKSTAT */
@@ -136,6 +136,7 @@ int sem_post(FAR sem_t *sem)
 
 		ASSERT(sem->semcount < SEM_VALUE_MAX);
 		sem_releaseholder(sem);
+		sem_lockstat_released(sem);
 		sem->semcount++;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -135,6 +135,7 @@ int sem_trywait(FAR sem_t *sem)
 
 			sem->semcount--;
 			sem_addholder(sem);
+			sem_lockstat_acquired(sem, __builtin_return_address(0));
 			rtcb->waitsem = NULL;
 			ret = OK;
 		} else {
@@ -62,6 +62,7 @@
 #include <assert.h>
 #include <tinyara/arch.h>
 #include <tinyara/cancelpt.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -149,6 +150,7 @@ int sem_wait(FAR sem_t *sem)
 
 			sem->semcount--;
 			sem_addholder(sem);
+			sem_lockstat_acquired(sem, __builtin_return_address(0));
 			rtcb->waitsem = NULL;
 
 			ret = OK;
@@ -159,6 +161,8 @@ int sem_wait(FAR sem_t *sem)
 		 */
 
 		else {
+			uint32_t start;
+
 			/* First, verify that the task is not already waiting on a
 			 * semaphore
 			 */
@@ -193,6 +197,8 @@ int sem_wait(FAR sem_t *sem)
 			/* Add the TCB to the prioritized semaphore wait queue */
 
 			set_errno(0);
+			ttrace_sem_block(sem);
+			start = sem_lockstat_now();
 			up_block_task(rtcb, TSTATE_WAIT_SEM);
 
 			/* When we resume at this point, either (1) the semaphore has been
@@ -219,6 +225,8 @@ int sem_wait(FAR sem_t *sem)
 				/* Not awakened by a signal or a timeout... We hold the semaphore */
 				ret = OK;
 			}
+
+			sem_lockstat_waited(sem, __builtin_return_address(0), start, ret == OK);
 #ifdef CONFIG_PRIORITY_INHERITANCE
 			sched_unlock();
 #endif
@@ -131,6 +131,22 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #define sem_canceled(stcb, sem)
 #endif
 
+/* Contention statistics, see sem_lockstat.c */
+
+#ifdef CONFIG_SEM_LOCKSTAT
+uint32_t sem_lockstat_now(void);
+void sem_lockstat_acquired(FAR sem_t *sem, FAR void *caller);
+void sem_lockstat_waited(FAR sem_t *sem, FAR void *caller, uint32_t start, bool acquired);
+void sem_lockstat_released(FAR sem_t *sem);
+void sem_lockstat_remove(FAR sem_t *sem);
+#else
+#define sem_lockstat_now()                          0
+#define sem_lockstat_acquired(sem, caller)
+#define sem_lockstat_waited(sem, caller, start, acquired) ((void)(start))
+#define sem_lockstat_released(sem)
+#define sem_lockstat_remove(sem)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -301,6 +301,15 @@ int sigaction(int signo, FAR const struct sigaction *act, FAR struct sigaction *
 		/* Set the new sigaction */
 
 		COPY_SIGACTION(&sigact->act, act);
+
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+		/* Set aside the signal action slots of the thread so that caught
+		 * signals can be queued without allocation.  If this fails, the
+		 * shared structures are used instead.
+		 */
+
+		(void)sig_allocateslots(rtcb);
+#endif
 	}
 
 	return OK;
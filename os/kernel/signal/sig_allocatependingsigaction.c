@@ -58,7 +58,9 @@
 
 #include <signal.h>
 #include <assert.h>
+#include <errno.h>
 #include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
 
 #include "signal/signal.h"
 
@@ -86,19 +88,88 @@
  * Public Functions
  ************************************************************************/
 
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+/************************************************************************
+ * Name: sig_allocateslots
+ *
+ * Description:
+ *   Set aside the pre-allocated signal action slots of a thread.  Called
+ *   from sigaction() when the thread installs its first signal handler.
+ *
+ * Returned Value:
+ *   0 (OK) on success or -ENOMEM.
+ *
+ ************************************************************************/
+
+int sig_allocateslots(FAR struct tcb_s *stcb)
+{
+	FAR sigq_t *slots;
+	int i;
+
+	if (stcb->sigqslots) {
+		return OK;
+	}
+
+	slots = (FAR sigq_t *)kmm_malloc(CONFIG_SIG_PREALLOC_SLOTS * sizeof(sigq_t));
+	if (!slots) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < CONFIG_SIG_PREALLOC_SLOTS; i++) {
+		slots[i].type = SIG_ALLOC_TCB;
+		slots[i].slot = (uint8_t)i;
+	}
+
+	stcb->sigqfree = (uint8_t)((1 << CONFIG_SIG_PREALLOC_SLOTS) - 1);
+	stcb->sigqslots = slots;
+	return OK;
+}
+
+/************************************************************************
+ * Name: sig_releaseslots
+ *
+ * Description:
+ *   Free the pre-allocated signal action slots of a thread.  The caller
+ *   must have released all of the queued signal actions first.
+ *
+ ************************************************************************/
+
+void sig_releaseslots(FAR struct tcb_s *stcb)
+{
+	if (stcb->sigqslots) {
+		sched_kfree(stcb->sigqslots);
+		stcb->sigqslots = NULL;
+		stcb->sigqfree = 0;
+	}
+}
+#endif
+
 /************************************************************************
  * Name: sig_allocatependingsigaction
  *
  * Description:
- *   Allocate a new element for the pending signal action queue
+ *   Allocate a new element for the pending signal action queue of the
+ *   specified thread.  The free slots of the thread are used first.
  *
  ************************************************************************/
 
-FAR sigq_t *sig_allocatependingsigaction(void)
+FAR sigq_t *sig_allocatependingsigaction(FAR struct tcb_s *stcb)
 {
 	FAR sigq_t *sigq;
 	irqstate_t saved_state;
 
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+	saved_state = irqsave();
+	if (stcb->sigqfree != 0) {
+		sigq = &stcb->sigqslots[__builtin_ctz(stcb->sigqfree)];
+		stcb->sigqfree &= ~(1 << sigq->slot);
+		irqrestore(saved_state);
+		return sigq;
+	}
+
+	irqrestore(saved_state);
+#endif
+
 	/* Check if we were called from an interrupt handler. */
 
 	if (up_interrupt_context()) {
@@ -130,6 +201,14 @@ FAR sigq_t *sig_allocatependingsigaction(void)
 		if (!sigq) {
 			/* No...Try the resource pool */
 
+#ifdef CONFIG_MM_POOL
+			sigq = KMM_POOL_ALLOC(&g_sigpendingactionpool, sigq_t);
+			if (sigq) {
+				sigq->type = SIG_ALLOC_POOL;
+				return sigq;
+			}
+#endif
+
 			if (!sigq) {
 				sigq = (FAR sigq_t *)kmm_malloc((sizeof(sigq_t)));
 			}
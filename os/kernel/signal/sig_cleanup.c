@@ -107,15 +107,21 @@ void sig_cleanup(FAR struct tcb_s *stcb)
 	/* Deallocate all entries in the list of pending signal actions */
 
 	while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpendactionq)) != NULL) {
-		sig_releasependingsigaction(sigq);
+		sig_releasependingsigaction(stcb, sigq);
 	}
 
 	/* Deallocate all entries in the list of posted signal actions */
 
 	while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpostedq)) != NULL) {
-		sig_releasependingsigaction(sigq);
+		sig_releasependingsigaction(stcb, sigq);
 	}
 
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+	/* Then the pre-allocated signal action slots themselves */
+
+	sig_releaseslots(stcb);
+#endif
+
 	/* Misc. signal-related clean-up */
 
 	stcb->sigprocmask = ALL_SIGNAL_SET;
@@ -136,10 +142,16 @@ void sig_cleanup(FAR struct tcb_s *stcb)
 void sig_release(FAR struct task_group_s *group)
 {
 	FAR sigpendq_t *sigpend;
+	int signo;
+
+	/* Deallocate all pending signals */
 
-	/* Deallocate all entries in the list of pending signals */
+	while (group->sigpendingset != NULL_SIGNAL_SET) {
+		signo = sig_lowest(&group->sigpendingset);
+		sigpend = group->sigpending[signo];
 
-	while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&group->sigpendingq)) != NULL) {
+		group->sigpending[signo] = NULL;
+		sigdelset(&group->sigpendingset, signo);
 		sig_releasependingsignal(sigpend);
 	}
 }
@@ -190,7 +190,7 @@ void sig_deliver(FAR struct tcb_s *stcb)
 
 		/* Then deallocate it */
 
-		sig_releasependingsigaction(sigq);
+		sig_releasependingsigaction(stcb, sigq);
 	}
 
 	stcb->pterrno = saved_errno;
@@ -124,7 +124,7 @@ static int sig_queueaction(FAR struct tcb_s *stcb, siginfo_t *info)
 		 * sig_allocatependingsigaction will force a system crash if it is
 		 * unable to allocate memory for the signal data */
 
-		sigq = sig_allocatependingsigaction();
+		sigq = sig_allocatependingsigaction(stcb);
 		if (!sigq) {
 			ret = -ENOMEM;
 		} else {
@@ -190,6 +190,14 @@ static FAR sigpendq_t *sig_allocatependingsignal(void)
 		if (!sigpend) {
 			/* No... Allocate the pending signal */
 
+#ifdef CONFIG_MM_POOL
+			sigpend = KMM_POOL_ALLOC(&g_sigpendingsignalpool, sigpendq_t);
+			if (sigpend) {
+				sigpend->type = SIG_ALLOC_POOL;
+				return sigpend;
+			}
+#endif
+
 			if (!sigpend) {
 				sigpend = (FAR sigpendq_t *)kmm_malloc((sizeof(sigpendq_t)));
 			}
@@ -205,33 +213,6 @@ static FAR sigpendq_t *sig_allocatependingsignal(void)
 	return sigpend;
 }
 
-/****************************************************************************
- * Name: sig_findpendingsignal
- *
- * Description:
- *   Find a specified element in the pending signal list
- *
- ****************************************************************************/
-
-static FAR sigpendq_t *sig_findpendingsignal(FAR struct task_group_s *group, int signo)
-{
-	FAR sigpendq_t *sigpend = NULL;
-	irqstate_t saved_state;
-
-	DEBUGASSERT(group);
-
-	/* Pending sigals can be added from interrupt level. */
-
-	saved_state = irqsave();
-
-	/* Seach the list for a sigpendion on this signal */
-
-	for (sigpend = (FAR sigpendq_t *)group->sigpendingq.head; (sigpend && sigpend->info.si_signo != signo); sigpend = sigpend->flink) ;
-
-	irqrestore(saved_state);
-	return sigpend;
-}
-
 /****************************************************************************
  * Name: sig_addpendingsignal
  *
@@ -251,18 +232,24 @@ static FAR sigpendq_t *sig_addpendingsignal(FAR struct tcb_s *stcb, FAR siginfo_
 
 	DEBUGASSERT(group);
 
-	/* Check if the signal is already pending */
+	/* Check if the signal is already pending.  Pending signals can be added
+	 * from interrupt level.
+	 */
 
-	sigpend = sig_findpendingsignal(group, info->si_signo);
+	saved_state = irqsave();
+	sigpend = group->sigpending[info->si_signo];
 	if (sigpend) {
 		/* The signal is already pending... retain only one copy */
 
 		memcpy(&sigpend->info, info, sizeof(siginfo_t));
+		irqrestore(saved_state);
 	}
 
 	/* No... There is nothing pending for this signo */
 
 	else {
+		irqrestore(saved_state);
+
 		/* Allocate a new pending signal entry */
 
 		sigpend = sig_allocatependingsignal();
@@ -271,11 +258,21 @@ static FAR sigpendq_t *sig_addpendingsignal(FAR struct tcb_s *stcb, FAR siginfo_
 
 			memcpy(&sigpend->info, info, sizeof(siginfo_t));
 
-			/* Add the structure to the pending signal list */
+			/* Add the structure to the pending signals unless the same
+			 * signal was made pending from an interrupt handler meanwhile.
+			 */
 
 			saved_state = irqsave();
-			sq_addlast((FAR sq_entry_t *)sigpend, &group->sigpendingq);
-			irqrestore(saved_state);
+			if (group->sigpending[info->si_signo]) {
+				memcpy(&group->sigpending[info->si_signo]->info, info, sizeof(siginfo_t));
+				irqrestore(saved_state);
+				sig_releasependingsignal(sigpend);
+				sigpend = group->sigpending[info->si_signo];
+			} else {
+				group->sigpending[info->si_signo] = sigpend;
+				sigaddset(&group->sigpendingset, info->si_signo);
+				irqrestore(saved_state);
+			}
 		}
 	}
 
@@ -105,6 +105,15 @@ sq_queue_t g_sigpendingsignal;
 
 sq_queue_t g_sigpendingirqsignal;
 
+#ifdef CONFIG_MM_POOL
+/* Pools used when the pre-allocated pending signal actions and pending
+ * signals have been exhausted.
+ */
+
+struct kmm_pool_s g_sigpendingactionpool;
+struct kmm_pool_s g_sigpendingsignalpool;
+#endif
+
 /************************************************************************
  * Private Variables
  ************************************************************************/
@@ -239,6 +248,11 @@ void sig_initialize(void)
 	g_sigpendingsignalalloc = sig_allocatependingsignalblock(&g_sigpendingsignal, NUM_SIGNALS_PENDING, SIG_ALLOC_FIXED);
 
 	g_sigpendingirqsignalalloc = sig_allocatependingsignalblock(&g_sigpendingirqsignal, NUM_INT_SIGNALS_PENDING, SIG_ALLOC_IRQ);
+
+#ifdef CONFIG_MM_POOL
+	(void)kmm_pool_initialize(&g_sigpendingactionpool, sizeof(sigq_t), NUM_POOL_PENDING_ACTIONS);
+	(void)kmm_pool_initialize(&g_sigpendingsignalpool, sizeof(sigpendq_t), NUM_POOL_SIGNALS_PENDING);
+#endif
 }
 
 /************************************************************************
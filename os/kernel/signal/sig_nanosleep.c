@@ -64,6 +64,12 @@
 #include <tinyara/clock.h>
 #include <arch/irq.h>
 #include <tinyara/cancelpt.h>
+#ifdef CONFIG_HRTIMER
+#include <stdint.h>
+#include <semaphore.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/hrtimer.h>
+#endif
 
 #include "clock/clock.h"
 
@@ -87,6 +93,70 @@
  * Private Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nanosleep_hrtimeout(FAR struct hrtimer_s *hrtimer)
+{
+	sem_post((FAR sem_t *)hrtimer->arg);
+}
+
+/****************************************************************************
+ * Name: nanosleep_hrwait
+ *
+ * Description:
+ *   Sleep on a high-resolution timer.  Used for requests that are not a
+ *   whole number of ticks, which the watchdog would round up.
+ *
+ * Returned Value:
+ *   Zero (OK) if the time elapsed, -EINTR if a signal was received, or
+ *   -ENOSPC if no high-resolution timer was available.
+ *
+ ****************************************************************************/
+
+static int nanosleep_hrwait(FAR const struct timespec *rqtp, FAR struct timespec *rmtp)
+{
+	struct hrtimer_s hrtimer;
+	uint64_t expiry;
+	uint64_t now;
+	sem_t sem;
+	int ret;
+
+	/* The semaphore is used for signaling and must not boost priorities */
+
+	sem_init(&sem, 0, 0);
+	sem_setprotocol(&sem, SEM_PRIO_NONE);
+	hrtimer_init(&hrtimer, nanosleep_hrtimeout, &sem);
+
+	expiry = hrtimer_now() + (uint64_t)rqtp->tv_sec * NSEC_PER_SEC + rqtp->tv_nsec;
+	ret = hrtimer_start(&hrtimer, expiry);
+	if (ret < 0) {
+		sem_destroy(&sem);
+		return ret;
+	}
+
+	ret = sem_wait(&sem);
+	if (ret < 0) {
+		/* Awakened by a signal.  The timer may have expired meanwhile */
+
+		ret = -get_errno();
+		if (hrtimer_cancel(&hrtimer) < 0) {
+			ret = OK;
+		} else if (rmtp) {
+			now = hrtimer_now();
+			now = expiry > now ? expiry - now : 0;
+			rmtp->tv_sec = (time_t)(now / NSEC_PER_SEC);
+			rmtp->tv_nsec = (long)(now % NSEC_PER_SEC);
+		}
+	}
+
+	sem_destroy(&sem);
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -158,6 +228,22 @@ int nanosleep(FAR const struct timespec *rqtp, FAR struct timespec *rmtp)
 		goto errout;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* Requests that are not a whole number of ticks sleep on a
+	 * high-resolution timer if one is available.
+	 */
+
+	if ((rqtp->tv_nsec % NSEC_PER_TICK) != 0) {
+		errval = -nanosleep_hrwait(rqtp, rmtp);
+		if (errval == OK) {
+			leave_cancellation_point();
+			return OK;
+		} else if (errval != ENOSPC) {
+			goto errout;
+		}
+	}
+#endif
+
 	/* Get the start time of the wait.  Interrupts are disabled to prevent
 	 * timer interrupts while we do tick-related calculations before and
 	 * after the wait.
@@ -121,27 +121,15 @@ int sigpending(FAR sigset_t *set)
  * Name: sig_pendingset
  *
  * Description:
- *   Convert the list of pending signals into a signal set
+ *   Return the set of signals pending for the group of the task
  *
  ****************************************************************************/
 
 sigset_t sig_pendingset(FAR struct tcb_s *stcb)
 {
 	FAR struct task_group_s *group = stcb->group;
-	sigset_t sigpendset;
-	FAR sigpendq_t *sigpend;
-	irqstate_t saved_state;
 
 	DEBUGASSERT(group);
 
-	sigpendset = NULL_SIGNAL_SET;
-
-	saved_state = irqsave();
-	for (sigpend = (FAR sigpendq_t *)group->sigpendingq.head; (sigpend); sigpend = sigpend->flink) {
-		sigaddset(&sigpendset, sigpend->info.si_signo);
-	}
-
-	irqrestore(saved_state);
-
-	return sigpendset;
+	return group->sigpendingset;
 }
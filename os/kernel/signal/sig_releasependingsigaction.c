@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <sched.h>
+#include <assert.h>
 
 #include "signal/signal.h"
 
@@ -88,18 +89,31 @@
  * Name: sig_releasependingsigaction
  *
  * Description:
- *   Deallocate a pending signal action Q entry
+ *   Deallocate a pending signal action Q entry of the specified thread
  *
  ************************************************************************/
 
-void sig_releasependingsigaction(FAR sigq_t *sigq)
+void sig_releasependingsigaction(FAR struct tcb_s *stcb, FAR sigq_t *sigq)
 {
 	irqstate_t saved_state;
 
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+	/* If this is one of the slots of the thread, just mark it free */
+
+	if (sigq->type == SIG_ALLOC_TCB) {
+		DEBUGASSERT(sigq == &stcb->sigqslots[sigq->slot]);
+
+		saved_state = irqsave();
+		stcb->sigqfree |= (1 << sigq->slot);
+		irqrestore(saved_state);
+	}
+
 	/* If this is a generally available pre-allocated structyre,
 	 * then just put it back in the free list.
 	 */
 
+	else
+#endif
 	if (sigq->type == SIG_ALLOC_FIXED) {
 		/* Make sure we avoid concurrent access to the free
 		 * list from interrupt handlers. */
@@ -130,4 +144,9 @@ void sig_releasependingsigaction(FAR sigq_t *sigq)
 	else if (sigq->type == SIG_ALLOC_DYN) {
 		sched_kfree(sigq);
 	}
+#ifdef CONFIG_MM_POOL
+	else if (sigq->type == SIG_ALLOC_POOL) {
+		KMM_POOL_FREE(&g_sigpendingactionpool, sigq);
+	}
+#endif
 }
@@ -141,4 +141,9 @@ void sig_releasependingsignal(FAR sigpendq_t *sigpend)
 	else if (sigpend->type == SIG_ALLOC_DYN) {
 		sched_kfree(sigpend);
 	}
+#ifdef CONFIG_MM_POOL
+	else if (sigpend->type == SIG_ALLOC_POOL) {
+		KMM_POOL_FREE(&g_sigpendingsignalpool, sigpend);
+	}
+#endif
 }
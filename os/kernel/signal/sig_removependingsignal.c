@@ -105,21 +105,16 @@ FAR sigpendq_t *sig_removependingsignal(FAR struct tcb_s *stcb, int signo)
 {
 	FAR struct task_group_s *group = stcb->group;
 	FAR sigpendq_t *currsig;
-	FAR sigpendq_t *prevsig;
 	irqstate_t saved_state;
 
-	DEBUGASSERT(group);
+	DEBUGASSERT(group && GOOD_SIGNO(signo));
 
 	saved_state = irqsave();
 
-	for (prevsig = NULL, currsig = (FAR sigpendq_t *)group->sigpendingq.head; (currsig && currsig->info.si_signo != signo); prevsig = currsig, currsig = currsig->flink) ;
-
+	currsig = group->sigpending[signo];
 	if (currsig) {
-		if (prevsig) {
-			sq_remafter((FAR sq_entry_t *)prevsig, &group->sigpendingq);
-		} else {
-			sq_remfirst(&group->sigpendingq);
-		}
+		group->sigpending[signo] = NULL;
+		sigdelset(&group->sigpendingset, signo);
 	}
 
 	irqrestore(saved_state);
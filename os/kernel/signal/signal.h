@@ -64,6 +64,9 @@
 #include <sched.h>
 
 #include <tinyara/kmalloc.h>
+#ifdef CONFIG_MM_POOL
+#include <tinyara/mm/pool.h>
+#endif
 
 /****************************************************************************
  * Definitions
@@ -79,6 +82,13 @@
 #define NUM_SIGNALS_PENDING     16
 #define NUM_INT_SIGNALS_PENDING  8
 
+/* Number of pending signal actions and pending signals that may be taken
+ * from the object pools once the pre-allocated structures run out.
+ */
+
+#define NUM_POOL_PENDING_ACTIONS 16
+#define NUM_POOL_SIGNALS_PENDING 16
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -86,7 +96,9 @@
 enum sigalloc_e {
 	SIG_ALLOC_FIXED = 0,		/* pre-allocated; never freed */
 	SIG_ALLOC_DYN,				/* dynamically allocated; free when unused */
-	SIG_ALLOC_IRQ				/* Preallocated, reserved for interrupt handling */
+	SIG_ALLOC_IRQ,				/* Preallocated, reserved for interrupt handling */
+	SIG_ALLOC_POOL,				/* Allocated from an object pool; free when unused */
+	SIG_ALLOC_TCB				/* Pre-allocated slot of the receiving thread */
 };
 typedef enum sigalloc_e sigalloc_t;
 
@@ -99,10 +111,11 @@ struct sigactq {
 };
 typedef struct sigactq sigactq_t;
 
-/* The following defines the queue structure within each TCB to hold pending
- * signals received by the task.  These are signals that cannot be processed
- * because:  (1) the task is not waiting for them, or (2) the task has no
- * action associated with the signal.
+/* The following defines the structure that holds a pending signal received
+ * by a task group.  These are signals that cannot be processed because:
+ * (1) the task is not waiting for them, or (2) the task has no action
+ * associated with the signal.  At most one signal is pending per signal
+ * number; the group indexes them by signal number.
  */
 
 struct sigpendq {
@@ -125,6 +138,7 @@ struct sigq_s {
 								 * the signal-catching function executes */
 	siginfo_t info;				/* Signal information */
 	uint8_t type;				/* (Used to manage allocations) */
+	uint8_t slot;				/* Index in the TCB slots (SIG_ALLOC_TCB) */
 };
 typedef struct sigq_s sigq_t;
 
@@ -162,6 +176,15 @@ extern sq_queue_t g_sigpendingsignal;
 
 extern sq_queue_t g_sigpendingirqsignal;
 
+#ifdef CONFIG_MM_POOL
+/* Pools of pending signal actions and pending signals that are used when
+ * the pre-allocated lists are empty.
+ */
+
+extern struct kmm_pool_s g_sigpendingactionpool;
+extern struct kmm_pool_s g_sigpendingsignalpool;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -196,7 +219,11 @@ void sig_release(FAR struct task_group_s *group);
 
 /* In files of the same name */
 
-FAR sigq_t *sig_allocatependingsigaction(void);
+FAR sigq_t *sig_allocatependingsigaction(FAR struct tcb_s *stcb);
+#if CONFIG_SIG_PREALLOC_SLOTS > 0
+int sig_allocateslots(FAR struct tcb_s *stcb);
+void sig_releaseslots(FAR struct tcb_s *stcb);
+#endif
 void sig_deliver(FAR struct tcb_s *stcb);
 FAR sigactq_t *sig_findaction(FAR struct tcb_s *stcb, int signo);
 int sig_lowest(FAR sigset_t *set);
@@ -205,7 +232,7 @@ int sig_mqnotempty(int tid, int signo, union sigval value);
 #else
 int sig_mqnotempty(int tid, int signo, FAR void *sival_ptr);
 #endif
-void sig_releasependingsigaction(FAR sigq_t *sigq);
+void sig_releasependingsigaction(FAR struct tcb_s *stcb, FAR sigq_t *sigq);
 void sig_releasependingsignal(FAR sigpendq_t *sigpend);
 FAR sigpendq_t *sig_removependingsignal(FAR struct tcb_s *stcb, int signo);
 void sig_unmaskpendingsignal(void);
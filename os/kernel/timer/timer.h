@@ -64,12 +64,16 @@
 
 #include <tinyara/compiler.h>
 #include <tinyara/wdog.h>
+#ifdef CONFIG_HRTIMER
+#include <tinyara/hrtimer.h>
+#endif
 
 /********************************************************************************
  * Definitions
  ********************************************************************************/
 
 #define PT_FLAGS_PREALLOCATED 0x01	/* Timer comes from a pool of preallocated timers */
+#define PT_FLAGS_HRTIMER      0x02	/* Timer is armed on pt_hrtimer, not pt_wdog */
 
 /********************************************************************************
  * Public Types
@@ -88,6 +92,11 @@ struct posix_timer_s {
 	int pt_last;				/* Last value used to set watchdog */
 	WDOG_ID pt_wdog;			/* The watchdog that provides the timing */
 	union sigval pt_value;		/* Data passed with notification */
+#ifdef CONFIG_HRTIMER
+	clockid_t pt_clock;			/* CLOCK_REALTIME or CLOCK_MONOTONIC */
+	uint64_t pt_interval;		/* Interval of a repetitive hrtimer (ns) */
+	struct hrtimer_s pt_hrtimer;	/* Sub-tick timing of CLOCK_MONOTONIC timers */
+#endif
 };
 
 /********************************************************************************
@@ -114,5 +123,8 @@ extern volatile sq_queue_t g_alloctimers;
 void weak_function timer_initialize(void);
 void weak_function timer_deleteall(pid_t pid);
 int timer_release(FAR struct posix_timer_s *timer);
+#ifdef CONFIG_HRTIMER
+void timer_hrtimeout(FAR struct hrtimer_s *hrtimer);
+#endif
 
 #endif							/* __SCHED_TIMER_TIMER_H */
@@ -194,9 +194,15 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 	struct posix_timer_s *ret;
 	WDOG_ID wdog;
 
-	/* Sanity checks.  Also, we support only CLOCK_REALTIME */
+	/* Sanity checks.  Also, we support only CLOCK_REALTIME, and
+	 * CLOCK_MONOTONIC if there are high-resolution timers.
+	 */
 
+#if defined(CONFIG_HRTIMER) && defined(CONFIG_CLOCK_MONOTONIC)
+	if (!timerid || (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC)) {
+#else
 	if (!timerid || clockid != CLOCK_REALTIME) {
+#endif
 		set_errno(EINVAL);
 		return ERROR;
 	}
@@ -224,6 +230,12 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp, FAR timer_t *timer
 	ret->pt_owner = getpid();
 	ret->pt_delay = 0;
 	ret->pt_wdog = wdog;
+#ifdef CONFIG_HRTIMER
+	ret->pt_flags &= ~PT_FLAGS_HRTIMER;
+	ret->pt_clock = clockid;
+	ret->pt_interval = 0;
+	hrtimer_init(&ret->pt_hrtimer, timer_hrtimeout, ret);
+#endif
 
 	if (evp) {
 		ret->pt_signo = evp->sigev_signo;
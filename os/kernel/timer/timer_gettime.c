@@ -56,9 +56,12 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <time.h>
 #include <errno.h>
 
+#include <tinyara/clock.h>
+
 #include "clock/clock.h"
 #include "timer/timer.h"
 
@@ -80,6 +83,14 @@
  * Private Functions
  ********************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+static void timer_nsec2ts(uint64_t nsec, FAR struct timespec *ts)
+{
+	ts->tv_sec = (time_t)(nsec / NSEC_PER_SEC);
+	ts->tv_nsec = (long)(nsec % NSEC_PER_SEC);
+}
+#endif
+
 /********************************************************************************
  * Public Functions
  ********************************************************************************/
@@ -125,6 +136,19 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 		return ERROR;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* A sub-tick CLOCK_MONOTONIC timer runs on its high-resolution timer */
+
+	if ((timer->pt_flags & PT_FLAGS_HRTIMER) != 0) {
+		uint64_t expiry = timer->pt_hrtimer.expiry;
+		uint64_t now = hrtimer_now();
+
+		timer_nsec2ts(expiry > now ? expiry - now : 0, &value->it_value);
+		timer_nsec2ts(timer->pt_interval, &value->it_interval);
+		return OK;
+	}
+#endif
+
 	/* Get the number of ticks before the underlying watchdog expires */
 
 	ticks = wd_gettime(timer->pt_wdog);
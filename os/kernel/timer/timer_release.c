@@ -157,6 +157,12 @@ int timer_release(FAR struct posix_timer_s *timer)
 		return 1;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* Stop the high-resolution timer, which is part of the timer structure */
+
+	(void)hrtimer_cancel(&timer->pt_hrtimer);
+#endif
+
 	/* Free the underlying watchdog instance (the timer will be canceled by the
 	 * watchdog logic before it is actually deleted)
 	 */
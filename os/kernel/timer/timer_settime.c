@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <time.h>
 #include <string.h>
 #include <errno.h>
@@ -86,6 +87,11 @@
 static inline void timer_sigqueue(FAR struct posix_timer_s *timer);
 static inline void timer_restart(FAR struct posix_timer_s *timer, uint32_t itimer);
 static void timer_timeout(int argc, uint32_t itimer);
+#ifdef CONFIG_HRTIMER
+static inline uint64_t timer_ts2nsec(FAR const struct timespec *ts);
+static inline bool timer_subtick(FAR const struct timespec *ts);
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags, FAR const struct itimerspec *value);
+#endif
 
 /********************************************************************************
  * Private Functions
@@ -237,6 +243,110 @@ static void timer_timeout(int argc, uint32_t itimer)
 #endif
 }
 
+#ifdef CONFIG_HRTIMER
+/********************************************************************************
+ * Name: timer_ts2nsec
+ ********************************************************************************/
+
+static inline uint64_t timer_ts2nsec(FAR const struct timespec *ts)
+{
+	return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/********************************************************************************
+ * Name: timer_subtick
+ *
+ * Description:
+ *   Return true if the time is not a whole number of system ticks.
+ *
+ ********************************************************************************/
+
+static inline bool timer_subtick(FAR const struct timespec *ts)
+{
+	return (ts->tv_nsec % NSEC_PER_TICK) != 0;
+}
+
+/********************************************************************************
+ * Name: timer_hrstart
+ *
+ * Description:
+ *   Arm a CLOCK_MONOTONIC timer on its high-resolution timer.
+ *
+ * Return Value:
+ *   Zero on success; -ENOSPC if the high-resolution timer queue is full.
+ *
+ ********************************************************************************/
+
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags, FAR const struct itimerspec *value)
+{
+	uint64_t expiry;
+	int ret;
+
+	expiry = timer_ts2nsec(&value->it_value);
+	if ((flags & TIMER_ABSTIME) == 0) {
+		expiry += hrtimer_now();
+	}
+
+	timer->pt_interval = timer_ts2nsec(&value->it_interval);
+	timer->pt_flags |= PT_FLAGS_HRTIMER;
+
+	ret = hrtimer_start(&timer->pt_hrtimer, expiry);
+	if (ret < 0) {
+		timer->pt_flags &= ~PT_FLAGS_HRTIMER;
+	}
+
+	return ret;
+}
+
+/********************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   Expiration of the high-resolution timer of a POSIX timer.  Same as
+ *   timer_timeout(), except that a repetitive timer is restarted relative to
+ *   its previous expiry so that the period does not drift.  Expiries that
+ *   were missed altogether are skipped.
+ *
+ * Assumptions:
+ *   This function executes in the context of the hrtimer interrupt.
+ *
+ ********************************************************************************/
+
+void timer_hrtimeout(FAR struct hrtimer_s *hrtimer)
+{
+	FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)hrtimer->arg;
+	uint64_t expiry;
+	uint64_t now;
+
+	timer->pt_crefs++;
+	timer_sigqueue(timer);
+
+	if (!timer_release(timer)) {
+		/* The timer was deleted */
+
+		return;
+	}
+
+	if (timer->pt_interval == 0) {
+		timer->pt_flags &= ~PT_FLAGS_HRTIMER;
+		return;
+	}
+
+	expiry = hrtimer->expiry + timer->pt_interval;
+	now = hrtimer_now();
+	if (expiry <= now) {
+		expiry += ((now - expiry) / timer->pt_interval + 1) * timer->pt_interval;
+	}
+
+	if (hrtimer_start(hrtimer, expiry) < 0) {
+		/* The queue is full, continue at tick resolution */
+
+		timer->pt_flags &= ~PT_FLAGS_HRTIMER;
+		timer_restart(timer, (uint32_t)((uintptr_t)timer));
+	}
+}
+#endif
+
 /********************************************************************************
  * Public Functions
  ********************************************************************************/
@@ -323,6 +433,10 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 	 */
 
 	(void)wd_cancel(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+	(void)hrtimer_cancel(&timer->pt_hrtimer);
+	timer->pt_flags &= ~PT_FLAGS_HRTIMER;
+#endif
 
 	/* If the it_value member of value is zero, the timer will not be re-armed */
 
@@ -338,6 +452,19 @@ int timer_settime(timer_t timerid, int flags, FAR const struct itimerspec *value
 		timer->pt_delay = 0;
 	}
 
+#ifdef CONFIG_HRTIMER
+	/* CLOCK_MONOTONIC timers with times that are not a whole number of ticks
+	 * use the high-resolution timer.  If its queue is full, they fall back
+	 * to the watchdog below.
+	 */
+
+	if (timer->pt_clock == CLOCK_MONOTONIC && (timer_subtick(&value->it_value) || timer_subtick(&value->it_interval))) {
+		if (timer_hrstart(timer, flags, value) == OK) {
+			return OK;
+		}
+	}
+#endif
+
 	/* We need to disable timer interrupts through the following section so
 	 * that the system timer is stable.
 	 */
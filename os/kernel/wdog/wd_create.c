@@ -158,7 +158,15 @@ WDOG_ID wd_create(void)
 		/* We do not require that interrupts be disabled to do this. */
 
 		irqrestore(state);
-		wdog = (FAR struct wdog_s *)kmm_malloc(sizeof(struct wdog_s));
+#ifdef CONFIG_MM_POOL
+		/* Prefer the watchdog pool, which has no heap header overhead */
+
+		wdog = KMM_POOL_ALLOC(&g_wddynpool, struct wdog_s);
+		if (!wdog)
+#endif
+		{
+			wdog = (FAR struct wdog_s *)kmm_malloc(sizeof(struct wdog_s));
+		}
 
 		/* Did we get one? */
 
@@ -144,7 +144,16 @@ int wd_delete(WDOG_ID wdog)
 		 */
 
 		irqrestore(state);
-		sched_kfree(wdog);
+#ifdef CONFIG_MM_POOL
+		/* Pool allocations may be released from any context */
+
+		if (kmm_pool_member(&g_wddynpool, wdog)) {
+			KMM_POOL_FREE(&g_wddynpool, wdog);
+		} else
+#endif
+		{
+			sched_kfree(wdog);
+		}
 	}
 
 	/* This was a pre-allocated timer.  This function should not be called for
@@ -78,12 +78,14 @@
 
 sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -92,6 +94,12 @@ sq_queue_t g_wdactivelist;
 
 uint16_t g_wdnfree;
 
+#ifdef CONFIG_MM_POOL
+/* Pool of dynamically allocated watchdogs */
+
+struct kmm_pool_s g_wddynpool;
+#endif
+
 /************************************************************************
  * Private Data
  ************************************************************************/
@@ -137,7 +145,11 @@ void wd_initialize(void)
 	/* Initialize watchdog lists */
 
 	sq_init(&g_wdfreelist);
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	wd_wheel_initialize();
+#else
 	sq_init(&g_wdactivelist);
+#endif
 
 	/* The g_wdfreelist must be loaded at initialization time to hold the
 	 * configured number of watchdogs.
@@ -150,4 +162,10 @@ void wd_initialize(void)
 	/* All watchdogs are free */
 
 	g_wdnfree = CONFIG_PREALLOC_WDOGS;
+
+#ifdef CONFIG_MM_POOL
+	/* Set up the pool used once the pre-allocated watchdogs run out */
+
+	(void)kmm_pool_initialize(&g_wddynpool, sizeof(struct wdog_s), CONFIG_WDOG_POOLSIZE);
+#endif
 }
@@ -111,6 +111,95 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of a watchdog that has expired.
+ *
+ * Parameters:
+ *   wdog - The expired watchdog, which is no longer active
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+	up_setpicbase(wdog->picbase);
+	switch (wdog->argc) {
+	default:
+		DEBUGPANIC();
+		break;
+
+	case 0:
+		(*((wdentry0_t)(wdog->func)))(0);
+		break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+	case 1:
+		(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+	case 2:
+		(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+	case 3:
+		(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+	case 4:
+		(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
+		break;
+#endif
+	}
+}
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   Advance the watchdog time by 'ticks' and execute every watchdog that
+ *   expires on the way.
+ *
+ * Parameters:
+ *   ticks - The number of ticks that elapsed
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static inline void wd_expiration(unsigned int ticks)
+{
+	FAR struct wdog_s *wdog;
+
+	while (ticks > 0) {
+		ticks -= wd_wheel_advance(ticks);
+
+		while ((wdog = wd_wheel_expired()) != NULL) {
+			/* Indicate that the watchdog is no longer active. */
+
+			WDOG_CLRACTIVE(wdog);
+
+			/* Execute the watchdog function */
+
+			wd_dispatch(wdog);
+		}
+	}
+}
+
+#else
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -158,40 +247,11 @@ static inline void wd_expiration(void)
 
 			/* Execute the watchdog function */
 
-			up_setpicbase(wdog->picbase);
-			switch (wdog->argc) {
-			default:
-				DEBUGPANIC();
-				break;
-
-			case 0:
-				(*((wdentry0_t)(wdog->func)))(0);
-				break;
-
-#if CONFIG_MAX_WDOGPARMS > 0
-			case 1:
-				(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-			case 2:
-				(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-			case 3:
-				(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-			case 4:
-				(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
-				break;
-#endif
-			}
+			wd_dispatch(wdog);
 		}
 	}
 }
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -233,10 +293,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 {
 	va_list ap;
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
 	FAR struct wdog_s *next;
 	int32_t now;
+#endif
 	irqstate_t state;
 	int i;
 
@@ -292,6 +354,11 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 	(void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Put the watchdog into the wheel slot of its expiration time */
+
+	wd_wheel_add(wdog, delay);
+#else
 	/* Do the easy case first -- when the watchdog timer queue is empty. */
 
 	if (g_wdactivelist.head == NULL) {
@@ -363,9 +430,13 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 		}
 	}
 
-	/* Put the lag into the watchdog structure and mark it as active. */
+	/* Put the lag into the watchdog structure */
 
 	wdog->lag = delay;
+#endif
+
+	/* Mark the watchdog as active. */
+
 	WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -409,6 +480,17 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Process the watchdogs expiring in the interval that just elapsed */
+
+	if (ticks > 0) {
+		wd_expiration(ticks);
+	}
+
+	/* Return the delay until the wheel next needs processing */
+
+	return wd_wheel_nextevent();
+#else
 	FAR struct wdog_s *wdog;
 	int decr;
 
@@ -444,11 +526,17 @@ unsigned int wd_timer(int ticks)
 	/* Return the delay for the next watchdog to expire */
 
 	return g_wdactivelist.head ? ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
 }
 
 #else
 void wd_timer(void)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Process the watchdogs expiring on this tick */
+
+	wd_expiration(1);
+#else
 	/* Check if there are any active watchdogs to process */
 
 	if (g_wdactivelist.head) {
@@ -460,5 +548,6 @@ void wd_timer(void)
 
 		wd_expiration();
 	}
+#endif
 }
 #endif							/* CONFIG_SCHED_TICKLESS */
@@ -0,0 +1,366 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wdog/wd_wheel.c
+ *
+ * Hierarchical timer wheel holding the active watchdogs.  Level 0 has one
+ * slot per tick for the next 64 ticks; each slot of level 'n' covers 64^n
+ * ticks.  The lag of an active watchdog holds its absolute expiration tick.
+ * When the time crosses a 64^n boundary, the matching slot of level 'n' is
+ * cascaded, i.e. its watchdogs are re-inserted at the lower levels.  A
+ * bitmap of non-empty slots per level gives the next tick that needs any
+ * processing without visiting the slots.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WHEEL_NLEVELS      4
+#define WHEEL_SLOT_BITS    6
+#define WHEEL_NSLOTS       (1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK    (WHEEL_NSLOTS - 1)
+
+/* Longest delay that can be placed in the wheel.  Longer delays are parked
+ * in the last slot of the highest level and re-inserted when cascaded.
+ */
+
+#define WHEEL_MAXDELAY     ((uint32_t)1 << (WHEEL_NLEVELS * WHEEL_SLOT_BITS))
+
+/* Index of time 't' at level 'l' */
+
+#define WHEEL_INDEX(t, l)  (((t) >> ((l) * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The watchdogs of each slot, in the order that they were inserted */
+
+static sq_queue_t g_wdwheel[WHEEL_NLEVELS][WHEEL_NSLOTS];
+
+/* Bit 'n' of g_wdwheelmap[l] is set if slot 'n' of level 'l' is not empty */
+
+static uint64_t g_wdwheelmap[WHEEL_NLEVELS];
+
+/* The last tick processed by the wheel */
+
+static uint32_t g_wdwheeltime;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_first
+ *
+ * Description:
+ *   Return the distance from slot 'index' to the first non-empty slot at or
+ *   after it (wrapping around) in the bitmap 'map', which must not be zero.
+ *
+ ****************************************************************************/
+
+static inline unsigned int wd_wheel_first(uint64_t map, unsigned int index)
+{
+	if (index != 0) {
+		map = (map >> index) | (map << (WHEEL_NSLOTS - index));
+	}
+
+	return __builtin_ctzll(map);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Put an active watchdog into the slot matching its expiration time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+	uint32_t expires = (uint32_t)wdog->lag;
+	int32_t delay = (int32_t)(expires - g_wdwheeltime);
+	int level;
+	int index;
+
+	if (delay <= 0) {
+		/* Already due.  This only happens when cascading a watchdog that
+		 * expires on the tick being processed.
+		 */
+
+		level = 0;
+		index = WHEEL_INDEX(g_wdwheeltime, 0);
+	} else {
+		if ((uint32_t)delay >= WHEEL_MAXDELAY) {
+			expires = g_wdwheeltime + WHEEL_MAXDELAY - 1;
+			delay = WHEEL_MAXDELAY - 1;
+		}
+
+		for (level = 0; level < WHEEL_NLEVELS - 1; level++) {
+			if ((uint32_t)delay < ((uint32_t)1 << ((level + 1) * WHEEL_SLOT_BITS))) {
+				break;
+			}
+		}
+
+		index = WHEEL_INDEX(expires, level);
+	}
+
+	sq_addlast((FAR sq_entry_t *)wdog, &g_wdwheel[level][index]);
+	g_wdwheelmap[level] |= (uint64_t)1 << index;
+	wdog->slot = (level << WHEEL_SLOT_BITS) | index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert the watchdogs of slot 'index' of 'level' at the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, int index)
+{
+	FAR sq_queue_t *slot = &g_wdwheel[level][index];
+	FAR struct wdog_s *wdog;
+	FAR struct wdog_s *next;
+
+	wdog = (FAR struct wdog_s *)slot->head;
+	sq_init(slot);
+	g_wdwheelmap[level] &= ~((uint64_t)1 << index);
+
+	for (; wdog; wdog = next) {
+		next = wdog->next;
+		wdog->next = NULL;
+		wd_wheel_insert(wdog);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+	int level;
+	int index;
+
+	for (level = 0; level < WHEEL_NLEVELS; level++) {
+		for (index = 0; index < WHEEL_NSLOTS; index++) {
+			sq_init(&g_wdwheel[level][index]);
+		}
+
+		g_wdwheelmap[level] = 0;
+	}
+
+	g_wdwheeltime = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog that expires 'delay' ticks from now to the wheel.
+ *   'delay' must be positive.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay)
+{
+	DEBUGASSERT(delay > 0);
+
+	wdog->lag = (int)(g_wdwheeltime + (uint32_t)delay);
+	wd_wheel_insert(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the wheel.  Returns true if its slot
+ *   became empty, i.e. if the next event time may have changed.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+	int level = wdog->slot >> WHEEL_SLOT_BITS;
+	int index = wdog->slot & WHEEL_SLOT_MASK;
+	FAR sq_queue_t *slot = &g_wdwheel[level][index];
+
+	sq_rem((FAR sq_entry_t *)wdog, slot);
+	wdog->next = NULL;
+
+	if (sq_empty(slot)) {
+		g_wdwheelmap[level] &= ~((uint64_t)1 << index);
+		return true;
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks until an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+	int32_t remaining = (int32_t)((uint32_t)wdog->lag - g_wdwheeltime);
+
+	return remaining > 0 ? remaining : 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks until the next tick on which a watchdog
+ *   expires or a slot must be cascaded, or zero if the wheel is empty.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_nextevent(void)
+{
+	uint32_t now = g_wdwheeltime;
+	uint32_t next;
+	uint32_t delay = 0;
+	unsigned int shift;
+	int level;
+
+	if (g_wdwheelmap[0] != 0) {
+		delay = wd_wheel_first(g_wdwheelmap[0], WHEEL_INDEX(now + 1, 0)) + 1;
+	}
+
+	for (level = 1; level < WHEEL_NLEVELS; level++) {
+		if (g_wdwheelmap[level] == 0) {
+			continue;
+		}
+
+		/* Slot 'index' is cascaded at the next multiple of 64^level with
+		 * that index.
+		 */
+
+		shift = level * WHEEL_SLOT_BITS;
+		next = (now >> shift) + 1;
+		next += wd_wheel_first(g_wdwheelmap[level], next & WHEEL_SLOT_MASK);
+		next = (next << shift) - now;
+
+		if (delay == 0 || next < delay) {
+			delay = next;
+		}
+	}
+
+	return delay;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel time by up to 'ticks' ticks, stopping at the first
+ *   tick that needs processing.  The slots due on that tick are cascaded
+ *   and the watchdogs expiring on it can then be collected with
+ *   wd_wheel_expired().  Returns the number of ticks that were consumed.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_advance(unsigned int ticks)
+{
+	unsigned int next = wd_wheel_nextevent();
+	int level;
+
+	if (next == 0 || next > ticks) {
+		/* Nothing happens in this interval */
+
+		g_wdwheeltime += ticks;
+		return ticks;
+	}
+
+	g_wdwheeltime += next;
+
+	for (level = 1; level < WHEEL_NLEVELS; level++) {
+		if (WHEEL_INDEX(g_wdwheeltime, level - 1) != 0) {
+			break;
+		}
+
+		wd_wheel_cascade(level, WHEEL_INDEX(g_wdwheeltime, level));
+	}
+
+	return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return the next watchdog that expires on the current tick,
+ *   or NULL if there is none left.  Watchdogs started while the expired
+ *   ones are being run always expire on a later tick.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+	int index = WHEEL_INDEX(g_wdwheeltime, 0);
+	FAR struct wdog_s *wdog;
+
+	if ((g_wdwheelmap[0] & ((uint64_t)1 << index)) == 0) {
+		return NULL;
+	}
+
+	wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdwheel[0][index]);
+	wdog->next = NULL;
+
+	if (sq_empty(&g_wdwheel[0][index])) {
+		g_wdwheelmap[0] &= ~((uint64_t)1 << index);
+	}
+
+	return wdog;
+}
+
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
@@ -64,6 +64,9 @@
 
 #include <tinyara/compiler.h>
 #include <tinyara/wdog.h>
+#ifdef CONFIG_MM_POOL
+#include <tinyara/mm/pool.h>
+#endif
 
 /************************************************************************
  * Pre-processor Definitions
@@ -90,12 +93,14 @@ extern "C" {
 
 extern sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -104,6 +109,14 @@ extern sq_queue_t g_wdactivelist;
 
 extern uint16_t g_wdnfree;
 
+#ifdef CONFIG_MM_POOL
+/* Watchdogs needed beyond the pre-allocated ones are taken from this pool
+ * before falling back to the kernel heap.
+ */
+
+extern struct kmm_pool_s g_wddynpool;
+#endif
+
 /************************************************************************
  * Public Function Prototypes
  ************************************************************************/
@@ -182,6 +195,36 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Timer wheel interfaces (see wd_wheel.c)
+ *
+ *   wd_wheel_initialize - Initialize the (empty) timer wheel
+ *   wd_wheel_add        - Add a watchdog expiring after 'delay' > 0 ticks
+ *   wd_wheel_remove     - Remove a watchdog.  Returns true if the next
+ *                         event time may have changed
+ *   wd_wheel_remaining  - Ticks until a watchdog expires
+ *   wd_wheel_nextevent  - Ticks until the next tick that needs processing
+ *                         (zero if there is none)
+ *   wd_wheel_advance    - Advance time by up to 'ticks' ticks, stopping on
+ *                         the next tick that needs processing.  Returns the
+ *                         number of ticks consumed
+ *   wd_wheel_expired    - Remove the next watchdog that expires on the
+ *                         current tick (NULL if none)
+ *
+ * All of these must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_initialize(void);
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+unsigned int wd_wheel_nextevent(void);
+unsigned int wd_wheel_advance(unsigned int ticks);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
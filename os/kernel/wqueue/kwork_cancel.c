@@ -112,6 +112,7 @@
 static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
 {
 	struct work_s *cur_work;
+	FAR struct dq_queue_s *queue;
 	irqstate_t flags;
 	int ret = -ENOENT;
 
@@ -124,15 +125,20 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 
 	flags = irqsave();
 	if (work->worker != NULL) {
-		/* A little test of the integrity of the work queue */
-
-		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == wqueue->q.tail);
-		DEBUGASSERT(work->dq.blink || (FAR dq_entry_t *)work == wqueue->q.head);
-
 		/* check whether requested work is in queue list or not */
-		cur_work = (struct work_s *)wqueue->q.head;
+		queue = &wqueue->q;
+		cur_work = (struct work_s *)queue->head;
 		do {
 			if (cur_work == NULL) {
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+				/* Then look in the delayed work */
+
+				if (queue == &wqueue->q) {
+					queue = &wqueue->timed;
+					cur_work = (struct work_s *)queue->head;
+					continue;
+				}
+#endif
 				irqrestore(flags);
 				return -ENOENT;
 			} else if (cur_work == work) {
@@ -142,11 +148,16 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 			cur_work = (struct work_s *)cur_work->dq.flink;
 		} while (1);
 
+		/* A little test of the integrity of the work queue */
+
+		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == queue->tail);
+		DEBUGASSERT(work->dq.blink || (FAR dq_entry_t *)work == queue->head);
+
 		/* Remove the entry from the work queue and make sure that it is
 		 * mark as available (i.e., the worker field is nullified).
 		 */
 
-		dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		dq_rem((FAR dq_entry_t *)work, queue);
 		work->worker = NULL;
 		ret = OK;
 	}
@@ -177,6 +177,9 @@ int work_hpstart(void)
 
 	g_hpwork.delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_hpwork.q);
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	dq_init(&g_hpwork.timed);
+#endif
 
 	/* Start the high-priority, kernel mode worker thread */
 
@@ -212,6 +212,9 @@ int work_lpstart(void)
 
 	g_lpwork.delay = CONFIG_SCHED_LPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_lpwork.q);
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	dq_init(&g_lpwork.timed);
+#endif
 
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
@@ -104,6 +104,42 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+/****************************************************************************
+ * Name: work_kick
+ *
+ * Description:
+ *   Signal an idle low priority worker other than the caller to take the
+ *   remaining work.  This does nothing for the single high priority worker.
+ *
+ * Input parameters:
+ *   wqueue - Describes the work queue with remaining work
+ *   wndx   - The index of the calling worker
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void work_kick(FAR struct kwork_wqueue_s *wqueue, int wndx)
+{
+#if defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 1
+	int i;
+
+	if (wqueue != (FAR struct kwork_wqueue_s *)&g_lpwork) {
+		return;
+	}
+
+	for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+		if (i != wndx && !g_lpwork.worker[i].busy) {
+			(void)kill(g_lpwork.worker[i].pid, SIGWORK);
+			return;
+		}
+	}
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -130,11 +166,13 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 	worker_t worker;
 	irqstate_t flags;
 	FAR void *arg;
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	bool pending;
+#else
 	systime_t elapsed;
-#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
 	systime_t remaining;
-#endif
 	systime_t stick;
+#endif
 	systime_t ctick;
 	systime_t next;
 
@@ -145,6 +183,58 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 	next = period;
 	flags = irqsave();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	for (;;) {
+		/* Move the delayed work that has expired to the end of the ready
+		 * list.  The delayed work is in order of expiry, so this stops at
+		 * the first one that has not.
+		 */
+
+		ctick = clock_systimer();
+		while ((work = (FAR struct work_s *)wqueue->timed.head) != NULL && ctick - work->qtime >= work->delay) {
+			(void)dq_remfirst(&wqueue->timed);
+			dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+		}
+
+		work = (FAR struct work_s *)dq_remfirst(&wqueue->q);
+		if (work == NULL) {
+			break;
+		}
+
+		/* A cancelled work may be nullified before it is removed */
+
+		worker = work->worker;
+		if (worker != NULL) {
+			arg = work->arg;
+			work->worker = NULL;
+			pending = wqueue->q.head != NULL || wqueue->timed.head != NULL;
+			irqrestore(flags);
+
+			/* Hand the rest of the work to an idle worker so that it does
+			 * not wait behind this one.
+			 */
+
+			if (pending) {
+				work_kick(wqueue, wndx);
+			}
+
+			worker(arg);
+			flags = irqsave();
+		}
+	}
+
+	/* Sleep until the next delayed work expires or, if there is none,
+	 * until new work is signalled.
+	 */
+
+	work = (FAR struct work_s *)wqueue->timed.head;
+	if (work == NULL) {
+		period = 0;
+	} else {
+		next = work->delay - (ctick - work->qtime);
+		period = next;
+	}
+#else
 	/* Get the time that we started this polling cycle in clock ticks. */
 
 	stick = clock_systimer();
@@ -228,12 +318,6 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 
 			/* Will it be ready before the next scheduled wakeup interval? */
 
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-			next = work->delay - elapsed;
-
-			/* Then break at while loop due to sorted list */
-			break;
-#else
 			remaining = work->delay - elapsed;
 			if (remaining < next) {
 				/* Yes.. Then schedule to wake up when the work is ready */
@@ -243,14 +327,8 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 			/* Then try the next in the list. */
 
 			work = (FAR struct work_s *)work->dq.flink;
-#endif
 		}
 	}
-
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-	if ((FAR struct work_s *)wqueue->q.head == NULL) {
-		period = 0;
-	}
 #endif
 
 #if (defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 0) || defined(CONFIG_SCHED_WORKQUEUE_SORTING)
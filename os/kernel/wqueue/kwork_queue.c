@@ -121,27 +121,32 @@
 static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
 	struct work_s *cur_work;
-	struct work_s *next_work;
 	irqstate_t flags;
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	systime_t ctick;
+	systime_t elapsed;
+#endif
+
 	DEBUGASSERT(work != NULL);
 
-	next_work = NULL;
 	flags = irqsave();
 
 	/* check whether requested work is in queue list or not */
-	cur_work = (struct work_s *)wqueue->q.head;
-	while (cur_work != NULL) {
+	for (cur_work = (struct work_s *)wqueue->q.head; cur_work != NULL; cur_work = (struct work_s *)cur_work->dq.flink) {
 		if (cur_work == work) {
 			irqrestore(flags);
 			return -EALREADY;
 		}
+	}
 
-		if ((cur_work->delay > delay) && (next_work == NULL)) {
-			next_work = cur_work;
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	for (cur_work = (struct work_s *)wqueue->timed.head; cur_work != NULL; cur_work = (struct work_s *)cur_work->dq.flink) {
+		if (cur_work == work) {
+			irqrestore(flags);
+			return -EALREADY;
 		}
-
-		cur_work = (struct work_s *)cur_work->dq.flink;
 	}
+#endif
 
 	work->worker = worker;		/* Work callback */
 	work->arg = arg;			/* Callback argument */
@@ -149,10 +154,26 @@ static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wor
 	work->qtime = clock_systimer();	/* Time work queued */
 
 #ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-	if (next_work) {
-		dq_addbefore((FAR dq_entry_t *)next_work, (FAR dq_entry_t *)work, &wqueue->q);
-	} else {
+	if (delay == 0) {
 		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+	} else {
+		/* Keep the delayed work in order of expiry.  Later work is usually
+		 * queued with a later expiry, so search back from the tail.
+		 */
+
+		ctick = work->qtime;
+		for (cur_work = (struct work_s *)wqueue->timed.tail; cur_work != NULL; cur_work = (struct work_s *)cur_work->dq.blink) {
+			elapsed = ctick - cur_work->qtime;
+			if (elapsed >= cur_work->delay || cur_work->delay - elapsed <= delay) {
+				break;
+			}
+		}
+
+		if (cur_work) {
+			dq_addafter((FAR dq_entry_t *)cur_work, (FAR dq_entry_t *)work, &wqueue->timed);
+		} else {
+			dq_addfirst((FAR dq_entry_t *)work, &wqueue->timed);
+		}
 	}
 #else
 	dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
@@ -89,6 +89,9 @@ struct kworker_s {
 struct kwork_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	struct dq_queue_s timed;	/* Delayed work in order of expiry */
+#endif
 	struct kworker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -100,6 +103,9 @@ struct kwork_wqueue_s {
 struct hp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	struct dq_queue_s timed;	/* Delayed work in order of expiry */
+#endif
 	struct kworker_s worker[1];	/* Describes the single high priority worker */
 };
 #endif
@@ -112,6 +118,9 @@ struct hp_wqueue_s {
 struct lp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	struct dq_queue_s timed;	/* Delayed work in order of expiry */
+#endif
 
 	/* Describes each thread in the low priority queue's thread pool */
 
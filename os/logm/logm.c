@@ -23,26 +23,36 @@
 #include <tinyara/config.h>
 #include <tinyara/logm.h>
 #include <tinyara/streams.h>
+#include <tinyara/lfring.h>
 #ifdef CONFIG_LOGM_TIMESTAMP
 #include <tinyara/clock.h>
 #endif
 #include "logm.h"
 
-int g_logm_head;
-int g_logm_tail;
+/* Messages are produced by tasks with pre-emption disabled, so that only
+ * one producer uses the ring at a time, and consumed by logm_task().
+ */
+
+struct lfring_s g_logm_ring;
 int g_logm_dropmsg_count;
 int g_logm_overflow_offset;
 
 static void logm_putc(FAR struct lib_outstream_s *this, int ch)
 {
-	if ((g_logm_tail + this->nput + 1) % logm_bufsize != g_logm_head) {
-		g_logm_rsvbuf[(g_logm_tail + this->nput++) % logm_bufsize] = ch;
+	if (lfring_putc(&g_logm_ring, ch)) {
+		this->nput++;
 	}
 }
 
+static void logm_puts(FAR struct lib_outstream_s *this, FAR const char *buf, int len)
+{
+	this->nput += lfring_write(&g_logm_ring, buf, len);
+}
+
 static void logm_outstream(FAR struct lib_outstream_s *outstream)
 {
 	outstream->put = logm_putc;
+	outstream->puts = logm_puts;
 #ifdef CONFIG_STDIO_LINEBUFFER
 	outstream->flush = lib_noflush;
 #endif
@@ -52,11 +62,17 @@ static void logm_outstream(FAR struct lib_outstream_s *outstream)
 #ifdef CONFIG_ARCH_LOWPUTC
 static void logm_flush(struct lib_outstream_s *stream)
 {
+#ifdef CONFIG_LOGM_DEFERRED
+	/* Format the queued records before the new message */
+	logm_deferred_flush(stream);
+	stream->nput = 0;
+#else
+	int ch;
+
 	sched_lock();
 
-	while (g_logm_head != g_logm_tail) {
-		stream->put(stream, g_logm_rsvbuf[g_logm_head]);
-		g_logm_head = (g_logm_head + 1) % logm_bufsize;
+	while ((ch = lfring_getc(&g_logm_ring)) >= 0) {
+		stream->put(stream, ch);
 	}
 
 	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
@@ -67,6 +83,7 @@ static void logm_flush(struct lib_outstream_s *stream)
 	stream->nput = 0;
 
 	sched_unlock();
+#endif
 }
 #endif
 
@@ -80,14 +97,28 @@ int logm_internal(int flag, int indx, int priority, const char *fmt, va_list ap)
 	struct timespec ts;
 #endif
 
+#ifdef CONFIG_LOGM_DEFERRED
+	if (LOGM_STATUS(LOGM_READY) && !LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) \
+		&& flag == LOGM_NORMAL) {
+		/* Only queue the format and its arguments, even from interrupt
+		 * handlers.  logm_task() formats the message later.
+		 */
+
+		ret = logm_deferred_put(fmt, ap);
+	} else
+#endif
 	if (LOGM_STATUS(LOGM_READY) && !LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) \
 		&& flag == LOGM_NORMAL && !up_interrupt_context()) {
 
-		flags = irqsave();
+		/* Keep other tasks from writing into the ring at the same time.
+		 * Interrupts remain enabled while the message is formatted.
+		 */
+
+		sched_lock();
 
 		if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 			g_logm_dropmsg_count++;
-			irqrestore(flags);
+			sched_unlock();
 			return 0;
 		}
 
@@ -102,14 +133,15 @@ int logm_internal(int flag, int indx, int priority, const char *fmt, va_list ap)
 #endif
 		ret = lib_vsprintf(&strm, fmt, ap);
 
-		g_logm_tail = (g_logm_tail + ret) % logm_bufsize;
-
-		if ((g_logm_tail + 1) % logm_bufsize == g_logm_head) {
+		if (lfring_space(&g_logm_ring) == 0) {
+			flags = irqsave();
 			LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
 			g_logm_dropmsg_count = 1;
-			g_logm_overflow_offset = g_logm_tail;
+			g_logm_overflow_offset = g_logm_ring.head;
+			irqrestore(flags);
 		}
-		irqrestore(flags);
+
+		sched_unlock();
 	} else {
 		/* Low Output: Sytem is not yet completely ready or this is called from interrupt handler */
 #ifdef CONFIG_ARCH_LOWPUTC
@@ -20,6 +20,9 @@
 
 #include <tinyara/config.h>
 #include <stdint.h>
+#include <stdarg.h>
+#include <tinyara/lfring.h>
+#include <tinyara/streams.h>
 
 /****************************************************************************
  * Preprocessor Definitions
@@ -65,8 +68,7 @@ extern "C" {
 #define EXTERN extern
 #endif
 
-EXTERN int g_logm_head;
-EXTERN int g_logm_tail;
+EXTERN struct lfring_s g_logm_ring;
 EXTERN int g_logm_overflow_offset;
 EXTERN int g_logm_dropmsg_count;
 EXTERN char * g_logm_rsvbuf;
@@ -80,6 +82,10 @@ EXTERN volatile int logm_print_interval;
  ************************************************************************************/
 int logm_task(int argc, char *argv[]);
 void logm_register_tashcmds(void);
+#ifdef CONFIG_LOGM_DEFERRED
+int logm_deferred_put(FAR const char *fmt, va_list ap);
+void logm_deferred_flush(FAR struct lib_outstream_s *stream);
+#endif
 static int logm_tash(int argc, char **args);
 
 #undef EXTERN
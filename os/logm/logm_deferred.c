@@ -0,0 +1,469 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/*
+ * Deferred formatting for logm.  Instead of formatting a message, the caller
+ * only queues its format pointer and the raw arguments that the format
+ * consumes; the record is formatted later by the consumer of the ring.  The
+ * record is built on the caller's stack and copied into the ring with
+ * interrupts disabled, so messages may be queued from interrupt handlers.
+ *
+ * The format is parsed the same way as lib_vsprintf() does so that the same
+ * arguments are taken from the va_list.  Strings (%s) are copied into the
+ * record since they may not exist anymore when the record is formatted.
+ */
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <arch/irq.h>
+#include <tinyara/streams.h>
+#include <tinyara/lfring.h>
+#ifdef CONFIG_LOGM_TIMESTAMP
+#include <time.h>
+#include <tinyara/clock.h>
+#endif
+#include "logm.h"
+
+#ifdef CONFIG_LOGM_DEFERRED
+
+/* Size of the arguments of one record, strings included */
+
+#define LOGM_ARGSIZE CONFIG_LOGM_DEFERRED_ARGSIZE
+
+/* Longest conversion specification that can be formatted */
+
+#define LOGM_SPECLEN 24
+
+/* Types of the arguments consumed by a conversion */
+
+enum logm_argtype_e {
+	LOGM_ARG_NONE,
+	LOGM_ARG_INT,
+	LOGM_ARG_LONG,
+	LOGM_ARG_LLONG,
+	LOGM_ARG_PTR,
+	LOGM_ARG_DOUBLE,
+	LOGM_ARG_STR
+};
+
+/* One conversion specification, from the '%' to the conversion character */
+
+struct logm_spec_s {
+	FAR const char *start;
+	FAR const char *end;
+	int nstar;					/* Number of '*' (int arguments) */
+	int type;					/* See enum logm_argtype_e */
+};
+
+/* Header of a record in the ring.  The arguments follow, unaligned */
+
+struct logm_rec_s {
+	uint16_t size;				/* Size of the record, header included */
+	FAR const char *fmt;
+#ifdef CONFIG_LOGM_TIMESTAMP
+	struct timespec ts;
+#endif
+};
+
+struct logm_recbuf_s {
+	struct logm_rec_s hdr;
+	uint8_t args[LOGM_ARGSIZE];
+};
+
+/* Parse the conversion specification whose '%' is at 'fmt' */
+
+static void logm_parsespec(FAR const char *fmt, FAR struct logm_spec_s *spec)
+{
+	bool islong = false;
+	bool islonglong = false;
+
+	spec->start = fmt++;
+	spec->nstar = 0;
+	spec->type = LOGM_ARG_NONE;
+
+	while (*fmt && !strchr("diuxXpobeEfgGlLsc%", *fmt)) {
+		if (*fmt == '*') {
+			spec->nstar++;
+		}
+		fmt++;
+	}
+
+	if (*fmt == 'L') {
+		islonglong = true;
+		fmt++;
+	} else if (*fmt == 'l') {
+		islong = true;
+		fmt++;
+		if (*fmt == 'l') {
+			islonglong = true;
+			fmt++;
+		}
+	}
+
+	if (*fmt == '\0') {
+		spec->end = fmt;
+		return;
+	}
+
+	if (*fmt == 's') {
+		spec->type = LOGM_ARG_STR;
+	} else if (*fmt == 'c') {
+		spec->type = LOGM_ARG_INT;
+	} else if (*fmt == 'p') {
+		spec->type = LOGM_ARG_PTR;
+	} else if (strchr("diuxXob", *fmt)) {
+#ifdef CONFIG_HAVE_LONG_LONG
+		if (islonglong) {
+			spec->type = LOGM_ARG_LLONG;
+		} else
+#endif
+		if (islong) {
+			spec->type = LOGM_ARG_LONG;
+		} else {
+			spec->type = LOGM_ARG_INT;
+		}
+	}
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+	else if (strchr("eEfgG", *fmt)) {
+		spec->type = LOGM_ARG_DOUBLE;
+	}
+#else
+	else if (strchr("eEfgG", *fmt)) {
+		/* lib_vsprintf() consumes nothing for these */
+	}
+#endif
+
+	spec->end = fmt + 1;
+}
+
+static int logm_argsize(int type)
+{
+	switch (type) {
+	case LOGM_ARG_INT:
+		return sizeof(int);
+	case LOGM_ARG_LONG:
+		return sizeof(long);
+#ifdef CONFIG_HAVE_LONG_LONG
+	case LOGM_ARG_LLONG:
+		return sizeof(long long);
+#endif
+	case LOGM_ARG_PTR:
+		return sizeof(FAR void *);
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+	case LOGM_ARG_DOUBLE:
+		return sizeof(double);
+#endif
+	default:
+		return 0;
+	}
+}
+
+/* Pop one record from the ring into 'rec'.  Returns false if it is empty */
+
+static bool logm_deferred_get(FAR struct logm_recbuf_s *rec)
+{
+	irqstate_t flags;
+	bool ret = false;
+
+	/* logm_task() and logm_flush() may both consume records */
+
+	flags = irqsave();
+
+	if (lfring_read(&g_logm_ring, &rec->hdr, sizeof(struct logm_rec_s)) == sizeof(struct logm_rec_s)) {
+		(void)lfring_read(&g_logm_ring, rec->args, rec->hdr.size - sizeof(struct logm_rec_s));
+		ret = true;
+	}
+
+	irqrestore(flags);
+
+	return ret;
+}
+
+/* Format one record to 'stream' */
+
+static void logm_deferred_print(FAR struct lib_outstream_s *stream, FAR struct logm_recbuf_s *rec)
+{
+	FAR const char *fmt = rec->hdr.fmt;
+	FAR const uint8_t *arg = rec->args;
+	FAR const uint8_t *argend = (FAR const uint8_t *)rec + rec->hdr.size;
+	struct logm_spec_s spec;
+	char specbuf[LOGM_SPECLEN];
+	FAR const char *src;
+	int speclen;
+	int size;
+	int value;
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+	(void)lib_sprintf(stream, "[%4d.%4d] ", rec->hdr.ts.tv_sec, rec->hdr.ts.tv_nsec / 100000);
+#endif
+
+	while (*fmt) {
+		if (*fmt != '%') {
+			stream->put(stream, *fmt++);
+			continue;
+		}
+
+		logm_parsespec(fmt, &spec);
+		fmt = spec.end;
+
+		/* Copy the specification, replacing each '*' by its value */
+
+		speclen = 0;
+		for (src = spec.start; src < spec.end; src++) {
+			if (*src != '*') {
+				if (speclen < LOGM_SPECLEN - 1) {
+					specbuf[speclen++] = *src;
+				}
+				continue;
+			}
+
+			if (arg + sizeof(int) > argend) {
+				goto truncated;
+			}
+
+			memcpy(&value, arg, sizeof(int));
+			arg += sizeof(int);
+			if (speclen < LOGM_SPECLEN - 12) {
+				speclen += snprintf(&specbuf[speclen], LOGM_SPECLEN - speclen, "%d", value);
+			}
+		}
+
+		specbuf[speclen] = '\0';
+
+		if (spec.type == LOGM_ARG_STR) {
+			size = strnlen((FAR const char *)arg, argend - arg) + 1;
+			if (arg + size > argend) {
+				goto truncated;
+			}
+		} else {
+			size = logm_argsize(spec.type);
+			if (arg + size > argend) {
+				goto truncated;
+			}
+		}
+
+		switch (spec.type) {
+		case LOGM_ARG_NONE:
+			(void)lib_sprintf(stream, specbuf);
+			break;
+		case LOGM_ARG_INT: {
+			int v;
+			memcpy(&v, arg, sizeof(v));
+			(void)lib_sprintf(stream, specbuf, v);
+			break;
+		}
+		case LOGM_ARG_LONG: {
+			long v;
+			memcpy(&v, arg, sizeof(v));
+			(void)lib_sprintf(stream, specbuf, v);
+			break;
+		}
+#ifdef CONFIG_HAVE_LONG_LONG
+		case LOGM_ARG_LLONG: {
+			long long v;
+			memcpy(&v, arg, sizeof(v));
+			(void)lib_sprintf(stream, specbuf, v);
+			break;
+		}
+#endif
+		case LOGM_ARG_PTR: {
+			FAR void *v;
+			memcpy(&v, arg, sizeof(v));
+			(void)lib_sprintf(stream, specbuf, v);
+			break;
+		}
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+		case LOGM_ARG_DOUBLE: {
+			double v;
+			memcpy(&v, arg, sizeof(v));
+			(void)lib_sprintf(stream, specbuf, v);
+			break;
+		}
+#endif
+		case LOGM_ARG_STR:
+			(void)lib_sprintf(stream, specbuf, (FAR const char *)arg);
+			break;
+		default:
+			break;
+		}
+
+		arg += size;
+	}
+
+	return;
+
+truncated:
+	/* The arguments did not fit in the record */
+	(void)lib_sprintf(stream, "...\n");
+}
+
+/* Queue a message without formatting it.  May be called from interrupt
+ * handlers.  Returns the size of the record, or 0 if it was dropped.
+ */
+
+int logm_deferred_put(FAR const char *fmt, va_list ap)
+{
+	struct logm_recbuf_s rec;
+	struct logm_spec_s spec;
+	FAR const char *str;
+	irqstate_t flags;
+	int len = 0;
+	int size;
+	int ndx;
+	int ret = 0;
+
+	rec.hdr.fmt = fmt;
+#ifdef CONFIG_LOGM_TIMESTAMP
+	if (clock_systimespec(&rec.hdr.ts) != OK) {
+		rec.hdr.ts.tv_sec = 0;
+		rec.hdr.ts.tv_nsec = 0;
+	}
+#endif
+
+	while (*fmt) {
+		if (*fmt++ != '%') {
+			continue;
+		}
+
+		logm_parsespec(fmt - 1, &spec);
+		fmt = spec.end;
+
+		for (ndx = 0; ndx < spec.nstar; ndx++) {
+			int value = va_arg(ap, int);
+			if (len + sizeof(int) > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &value, sizeof(int));
+			len += sizeof(int);
+		}
+
+		size = logm_argsize(spec.type);
+
+		switch (spec.type) {
+		case LOGM_ARG_INT: {
+			int v = va_arg(ap, int);
+			if (len + size > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &v, size);
+			break;
+		}
+		case LOGM_ARG_LONG: {
+			long v = va_arg(ap, long);
+			if (len + size > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &v, size);
+			break;
+		}
+#ifdef CONFIG_HAVE_LONG_LONG
+		case LOGM_ARG_LLONG: {
+			long long v = va_arg(ap, long long);
+			if (len + size > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &v, size);
+			break;
+		}
+#endif
+		case LOGM_ARG_PTR: {
+			FAR void *v = va_arg(ap, FAR void *);
+			if (len + size > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &v, size);
+			break;
+		}
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+		case LOGM_ARG_DOUBLE: {
+			double v = va_arg(ap, double);
+			if (len + size > LOGM_ARGSIZE) {
+				goto full;
+			}
+			memcpy(&rec.args[len], &v, size);
+			break;
+		}
+#endif
+		case LOGM_ARG_STR:
+			/* Copy as much of the string as fits */
+			str = va_arg(ap, FAR const char *);
+			if (!str) {
+				str = "(null)";
+			}
+			if (len >= LOGM_ARGSIZE) {
+				goto full;
+			}
+			size = strlen(str) + 1;
+			if (len + size > LOGM_ARGSIZE) {
+				size = LOGM_ARGSIZE - len;
+			}
+			memcpy(&rec.args[len], str, size - 1);
+			rec.args[len + size - 1] = '\0';
+			break;
+		default:
+			break;
+		}
+
+		len += size;
+	}
+
+full:
+	/* If the arguments did not all fit, the record ends where the first
+	 * missing argument would have been and its formatting stops there.
+	 */
+
+	rec.hdr.size = sizeof(struct logm_rec_s) + len;
+
+	flags = irqsave();
+	if (lfring_space(&g_logm_ring) >= rec.hdr.size) {
+		(void)lfring_write(&g_logm_ring, &rec, rec.hdr.size);
+		ret = rec.hdr.size;
+	} else {
+		g_logm_dropmsg_count++;
+	}
+	irqrestore(flags);
+
+	return ret;
+}
+
+/* Format all of the queued records to 'stream' */
+
+void logm_deferred_flush(FAR struct lib_outstream_s *stream)
+{
+	struct logm_recbuf_s rec;
+	irqstate_t flags;
+	int dropped;
+
+	while (logm_deferred_get(&rec)) {
+		logm_deferred_print(stream, &rec);
+	}
+
+	flags = irqsave();
+	dropped = g_logm_dropmsg_count;
+	g_logm_dropmsg_count = 0;
+	irqrestore(flags);
+
+	if (dropped > 0) {
+		(void)lib_sprintf(stream, "\n[LOGM BUFFER OVERFLOW] %d messages are dropped\n", dropped);
+	}
+}
+
+#endif							/* CONFIG_LOGM_DEFERRED */
@@ -23,6 +23,9 @@
 #include <arch/irq.h>
 #include <tinyara/logm.h>
 #include <tinyara/config.h>
+#ifdef CONFIG_LOGM_DEFERRED
+#include <tinyara/streams.h>
+#endif
 #include "logm.h"
 #ifdef CONFIG_LOGM_TEST
 #include "logm_test.h"
@@ -49,8 +52,7 @@ static int logm_change_bufsize(int buflen)
 	memset(g_logm_rsvbuf, 0, buflen);
 
 	/* Reinitialize all  */
-	g_logm_head = 0;
-	g_logm_tail = 0;
+	lfring_init(&g_logm_ring, g_logm_rsvbuf, buflen);
 	logm_bufsize = buflen;
 	g_logm_dropmsg_count = 0;
 	g_logm_overflow_offset = -1;
@@ -63,9 +65,15 @@ static int logm_change_bufsize(int buflen)
 int logm_task(int argc, char *argv[])
 {
 	irqstate_t flags;
+#ifdef CONFIG_LOGM_DEFERRED
+	struct lib_stdoutstream_s strm;
+#else
+	int ch;
+#endif
 
 	g_logm_rsvbuf = (char *)malloc(logm_bufsize);
 	memset(g_logm_rsvbuf, 0, logm_bufsize);
+	lfring_init(&g_logm_ring, g_logm_rsvbuf, logm_bufsize);
 
 	/* Now logm is ready */
 	LOGM_STATUS_SET(LOGM_READY);
@@ -75,17 +83,30 @@ int logm_task(int argc, char *argv[])
 #endif
 
 	while (1) {
-		while (g_logm_head != g_logm_tail) {
-			fputc(g_logm_rsvbuf[g_logm_head], stdout);
-			g_logm_head = (g_logm_head + 1) % logm_bufsize;
-			if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+#ifdef CONFIG_LOGM_DEFERRED
+		lib_stdoutstream(&strm, stdout);
+		logm_deferred_flush(&strm.public);
+#else
+		for (;;) {
+			/* logm_flush() may also consume from interrupt handlers */
+			flags = irqsave();
+			ch = lfring_getc(&g_logm_ring);
+			if (ch >= 0 && LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 				LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
 			}
-			if (g_logm_overflow_offset >= 0 && g_logm_overflow_offset == g_logm_head) {
+			irqrestore(flags);
+
+			if (ch < 0) {
+				break;
+			}
+
+			fputc(ch, stdout);
+			if (g_logm_overflow_offset >= 0 && g_logm_overflow_offset == g_logm_ring.tail) {
 				fprintf(stdout, "\n[LOGM BUFFER OVERFLOW] %d messages are dropped\n", g_logm_dropmsg_count);
 				g_logm_overflow_offset = -1;
 			}
 		}
+#endif
 
 		if (LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ)) {
 			flags = irqsave();
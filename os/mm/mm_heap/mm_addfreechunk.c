@@ -88,9 +88,21 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
 	int ndx = mm_size2ndx(node->size);
 
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* The size class lists are not sorted, so just push the new node at the
+	 * head of its list and mark the list as non-empty.
+	 */
+
+	prev = &heap->mm_nodelist[ndx];
+	next = prev->flink;
+
+	heap->mm_flbitmap |= (1 << (ndx >> MM_SLI_SHIFT));
+	heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] |= (1 << (ndx & MM_SLI_MASK));
+#else
 	/* Now put the new node int the next */
 
 	for (prev = &heap->mm_nodelist[ndx], next = heap->mm_nodelist[ndx].flink; next && next->size && next->size < node->size; prev = next, next = next->flink) ;
+#endif
 
 	/* Does it go in mid next or at the end? */
 
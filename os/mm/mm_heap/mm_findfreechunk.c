@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_findfreechunk.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes using the segregated-fit
+ *   bitmaps.  The request is first rounded up to the next size class
+ *   boundary so that the head of any non-empty list at or above that class
+ *   is guaranteed to fit; the lookup is then two bit scans and does not
+ *   depend on the number of free chunks.
+ *
+ *   Only if that fails is the request's own size class searched linearly,
+ *   so that a nearly exhausted heap can still satisfy requests that fit in
+ *   a chunk of the same class.  The last class is unbounded above and is
+ *   always searched.
+ *
+ *   The node is not removed from its list.  It is assumed that the caller
+ *   holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node;
+	uint32_t bitmap;
+	size_t rounded;
+	int ndx;
+	int fl;
+	int sl;
+
+	/* Round the request up to the next size class boundary */
+
+	rounded = size;
+	if (size < MM_MAX_CHUNK) {
+		rounded += (1 << (MM_FLS((uint32_t)size) - MM_SLI_SHIFT)) - 1;
+	}
+
+	ndx = mm_size2ndx(rounded);
+	fl  = ndx >> MM_SLI_SHIFT;
+	sl  = ndx & MM_SLI_MASK;
+
+	/* Look for a non-empty list in the same first level range, then in any
+	 * larger first level range.
+	 */
+
+	bitmap = heap->mm_slbitmap[fl] & (~0u << sl);
+	if (bitmap == 0) {
+		bitmap = (fl + 1 < MM_FLI_COUNT) ? (heap->mm_flbitmap & (~0u << (fl + 1))) : 0;
+		if (bitmap != 0) {
+			fl     = MM_FFS(bitmap);
+			bitmap = heap->mm_slbitmap[fl];
+		}
+	}
+
+	if (bitmap != 0) {
+		ndx = (fl << MM_SLI_SHIFT) + MM_FFS(bitmap);
+		node = heap->mm_nodelist[ndx].flink;
+
+		if (ndx < MM_NNODES - 1) {
+			return node;
+		}
+
+		/* The last class holds all chunks of MM_MAX_CHUNK bytes or more */
+
+		for (; node && node->size < size; node = node->flink) ;
+		if (node) {
+			return node;
+		}
+	}
+
+	/* Last resort: search the (unsorted) list of the request's own class */
+
+	ndx = mm_size2ndx(size);
+	if (ndx == MM_NNODES - 1) {
+		return NULL;
+	}
+
+	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
+	return node;
+}
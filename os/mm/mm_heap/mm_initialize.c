@@ -158,6 +158,13 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heapsi
 	heapinfo_update_node((FAR struct mm_allocnode_s *)heap->mm_heapend[IDX], 0xDEADDEAD);
 #endif
 
+#ifdef CONFIG_MM_REGION_POLICY
+	/* New regions are fast until tagged otherwise */
+
+	heap->mm_regtag[IDX] = MM_REGION_FAST;
+	heap->mm_tags |= MM_REGION_FAST;
+#endif
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -190,7 +197,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heapsi
 
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heapsize)
 {
+#ifndef CONFIG_MM_SEGREGATED_FIT
 	int i;
+#endif
 
 	mlldbg("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -211,14 +220,24 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heaps
 #if CONFIG_MM_REGIONS > 1
 	heap->mm_nregions = 0;
 #endif
+#ifdef CONFIG_MM_REGION_POLICY
+	heap->mm_tags = 0;
+#endif
 
 	/* Initialize the node array */
 
 	memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* Each size class has its own, initially empty, list */
+
+	heap->mm_flbitmap = 0;
+	memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+#else
 	for (i = 1; i < MM_NNODES; i++) {
 		heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
 		heap->mm_nodelist[i].blink = &heap->mm_nodelist[i - 1];
 	}
+#endif
 
 	/* Initialize the malloc semaphore to one (to support one-at-
 	 * a-time access to private data sets).
@@ -226,6 +245,10 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heaps
 
 	mm_seminitialize(heap);
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+	mm_profile_reset(heap);
+#endif
+
 	/* Add the initial region of memory to the heap */
 
 	mm_addregion(heap, heapstart, heapsize);
@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <debug.h>
 #include <tinyara/mm/mm.h>
@@ -98,6 +99,10 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 
 	DEBUGASSERT(info);
 
+#ifdef CONFIG_MM_REGION_POLICY
+	memset(info->regions, 0, sizeof(info->regions));
+#endif
+
 	/* Visit each region */
 
 #if CONFIG_MM_REGIONS > 1
@@ -124,6 +129,17 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 					mxordblk = node->size;
 				}
 			}
+
+#ifdef CONFIG_MM_REGION_POLICY
+			if ((node->preceding & MM_ALLOC_BIT) != 0) {
+				info->regions[region].uordblks += node->size;
+			} else {
+				info->regions[region].fordblks += node->size;
+				if (node->size > info->regions[region].mxordblk) {
+					info->regions[region].mxordblk = node->size;
+				}
+			}
+#endif
 		}
 
 		mm_givesemaphore(heap);
@@ -131,6 +147,12 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 		mvdbg("region=%d node=%p heapend=%p\n", region, node, heap->mm_heapend[region]);
 		DEBUGASSERT(node == heap->mm_heapend[region]);
 		uordblks += SIZEOF_MM_ALLOCNODE;	/* account for the tail node */
+
+#ifdef CONFIG_MM_REGION_POLICY
+		info->regions[region].uordblks += SIZEOF_MM_ALLOCNODE;
+		info->regions[region].arena = info->regions[region].uordblks + info->regions[region].fordblks;
+		info->regions[region].tag = heap->mm_regtag[region];
+#endif
 	}
 #undef region
 
@@ -141,5 +163,16 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 	info->mxordblk = mxordblk;
 	info->uordblks = uordblks;
 	info->fordblks = fordblks;
+#ifdef CONFIG_MM_TASK_CACHE
+	info->cachehits   = heap->mm_cache_hits;
+	info->cachemisses = heap->mm_cache_misses;
+#endif
+#ifdef CONFIG_MM_REGION_POLICY
+#if CONFIG_MM_REGIONS > 1
+	info->nregions = heap->mm_nregions;
+#else
+	info->nregions = 1;
+#endif
+#endif
 	return OK;
 }
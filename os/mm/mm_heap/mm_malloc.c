@@ -88,21 +88,94 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_findchunk
+ *
+ * Description:
+ *  Return the smallest free chunk of at least 'size' bytes (including the
+ *  chunk header) or NULL.  The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *mm_findchunk(FAR struct mm_heap_s *heap, size_t size)
+{
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* Find a suitable chunk in constant time using the size class bitmaps */
+
+	return mm_findfreechunk(heap, size);
+#else
+	FAR struct mm_freenode_s *node;
+	int ndx;
+
+	/* Get the location in the node list to start the search. Special case
+	 * really big allocations
+	 */
+
+	if (size >= MM_MAX_CHUNK) {
+		ndx = MM_NNODES - 1;
+	} else {
+		/* Convert the request size into a nodelist index */
+
+		ndx = mm_size2ndx(size);
+	}
+
+	/* Search for a large enough chunk in the list of nodes. This list is
+	 * ordered by size, but will have occasional zero sized nodes as we visit
+	 * other mm_nodelist[] entries.
+	 */
+
+	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
+	return node;
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_REGION_POLICY
 /****************************************************************************
  * Name: mm_malloc
  *
  * Description:
+ *  Allocate from the region class chosen by the placement policy, falling
+ *  back to any region.
+ *
+ ****************************************************************************/
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr)
+{
+	return mm_malloc_region(heap, size, mm_regionpolicy(heap, size), caller_retaddr);
+}
+#else
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+	return mm_malloc_region(heap, size, mm_regionpolicy(heap, size));
+}
+#endif
+#endif
+
+/****************************************************************************
+ * Name: mm_malloc (mm_malloc_region)
+ *
+ * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
  *  that chunk, save the remaining, smaller chunk (if any).
  *
+ *  With CONFIG_MM_REGION_POLICY, the chunk is looked for in the regions
+ *  whose tag is in 'tags' first.  Other regions are only used if 'tags'
+ *  does not include MM_REGION_STRICT.
+ *
  *  8-byte alignment of the allocated data is assured.
  *
  ****************************************************************************/
+#ifdef CONFIG_MM_REGION_POLICY
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size, uint8_t tags, mmaddress_t caller_retaddr)
+#else
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size, uint8_t tags)
+#endif
+#elif defined(CONFIG_DEBUG_MM_HEAPINFO)
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr)
 #else
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
@@ -110,7 +183,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
 	FAR struct mm_freenode_s *node;
 	void *ret = NULL;
-	int ndx;
+#ifdef CONFIG_MM_HEAP_PROFILE
+	bool sampled;
+#endif
 
 	/* Handle bad sizes */
 
@@ -128,24 +203,26 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	mm_takesemaphore(heap);
 
-	/* Get the location in the node list to start the search. Special case
-	 * really big allocations
+#ifdef CONFIG_MM_HEAP_PROFILE
+	sampled = mm_profile_begin(heap, size);
+#endif
+
+#ifdef CONFIG_MM_REGION_POLICY
+	/* A constrained search is only needed if some region has a tag that
+	 * was not asked for.
 	 */
 
-	if (size >= MM_MAX_CHUNK) {
-		ndx = MM_NNODES - 1;
+	if ((heap->mm_tags & ~tags & MM_REGION_ANY) != 0) {
+		node = mm_findregionchunk(heap, size, tags);
+		if (!node && (tags & MM_REGION_STRICT) == 0) {
+			node = mm_findchunk(heap, size);
+		}
 	} else {
-		/* Convert the request size into a nodelist index */
-
-		ndx = mm_size2ndx(size);
+		node = mm_findchunk(heap, size);
 	}
-
-	/* Search for a large enough chunk in the list of nodes. This list is
-	 * ordered by size, but will have occasional zero sized nodes as we visit
-	 * other mm_nodelist[] entries.
-	 */
-
-	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
+#else
+	node = mm_findchunk(heap, size);
+#endif
 
 	/* If we found a node with non-zero size, then this is one to use. Since
 	 * the list is ordered, we know that is must be best fitting chunk
@@ -161,11 +238,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		 * a successor node.
 		 */
 
-		DEBUGASSERT(node->blink);
-		node->blink->flink = node->flink;
-		if (node->flink) {
-			node->flink->blink = node->blink;
-		}
+		mm_remfreechunk(heap, node);
 
 		/* Check if we have to split the free node into one of the allocated
 		 * size and another smaller freenode.  In some cases, the remaining
@@ -213,6 +286,10 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		ret = (void *)((char *)node + SIZEOF_MM_ALLOCNODE);
 	}
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+	mm_profile_end(heap, sampled, ret);
+#endif
+
 	mm_givesemaphore(heap);
 
 	/* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
@@ -0,0 +1,56 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_malloc_size.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_malloc_size
+ *
+ * Description:
+ *   Return the number of bytes the caller may use in a block returned by
+ *   mm_malloc() or mm_realloc().  This is at least the requested size and
+ *   includes any alignment padding and realloc slack.  The size is read
+ *   from the chunk header, so no heap lock is needed.
+ *
+ ****************************************************************************/
+
+size_t mm_malloc_size(FAR void *mem)
+{
+	FAR struct mm_allocnode_s *node;
+
+	if (!mem) {
+		return 0;
+	}
+
+	node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+	return node->size - SIZEOF_MM_ALLOCNODE;
+}
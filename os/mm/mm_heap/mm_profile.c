@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ * Low-overhead heap profiler.  The counters are updated by mm_malloc()
+ * while it holds the heap semaphore, so no additional locking is needed.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PROFILE_MASK (MM_PROFILE_RATE - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_hist
+ *
+ * Description:
+ *   Return the size histogram bucket of a chunk of 'size' bytes.
+ *
+ ****************************************************************************/
+
+static inline int mm_profile_hist(size_t size)
+{
+	int ndx = 0;
+
+	size >>= MM_MIN_SHIFT;
+	while (size > 1 && ndx < MM_PROFILE_NHIST - 1) {
+		ndx++;
+		size >>= 1;
+	}
+
+	return ndx;
+}
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_reset
+ *
+ * Description:
+ *   Clear all profile counters of the heap.
+ *
+ ****************************************************************************/
+
+void mm_profile_reset(FAR struct mm_heap_s *heap)
+{
+	mm_takesemaphore(heap);
+	memset(&heap->mm_profile, 0, sizeof(struct mm_profile_s));
+	heap->mm_profile.mp_minlargest = (size_t)-1;
+	mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_profile_begin
+ *
+ * Description:
+ *   Account for an allocation request of 'size' bytes (already adjusted to
+ *   the chunk size).  Returns true if this request is sampled, in which
+ *   case the cycle counter is latched.  The caller must hold the heap
+ *   semaphore.
+ *
+ ****************************************************************************/
+
+bool mm_profile_begin(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_profile_s *prof = &heap->mm_profile;
+
+	prof->mp_sizehist[mm_profile_hist(size)]++;
+	if ((prof->mp_nalloc++ & PROFILE_MASK) != 0) {
+		return false;
+	}
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	prof->mp_start = up_perf_gettime();
+#endif
+	return true;
+}
+
+/****************************************************************************
+ * Name: mm_profile_end
+ *
+ * Description:
+ *   Complete the accounting of an allocation request that returned 'mem'.
+ *   The caller must hold the heap semaphore.
+ *
+ ****************************************************************************/
+
+void mm_profile_end(FAR struct mm_heap_s *heap, bool sampled, FAR void *mem)
+{
+	FAR struct mm_profile_s *prof = &heap->mm_profile;
+	size_t largest;
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	uint32_t elapsed;
+
+	if (sampled) {
+		elapsed = up_perf_gettime() - prof->mp_start;
+		if (elapsed > prof->mp_maxcycles) {
+			prof->mp_maxcycles = elapsed;
+		}
+
+		prof->mp_totcycles += elapsed;
+		prof->mp_nsampled++;
+	}
+#endif
+
+	if (!mem) {
+		prof->mp_nfail++;
+	} else if (!sampled) {
+		return;
+	}
+
+	/* Track how small the largest free chunk gets over time */
+
+	largest = mm_largestfree(heap);
+	if (largest < prof->mp_minlargest) {
+		prof->mp_minlargest = largest;
+	}
+}
+
+/****************************************************************************
+ * Name: mm_largestfree
+ *
+ * Description:
+ *   Return the size of the largest free chunk in the heap.  The caller must
+ *   hold the heap semaphore.
+ *
+ ****************************************************************************/
+
+size_t mm_largestfree(FAR struct mm_heap_s *heap)
+{
+	FAR struct mm_freenode_s *node;
+	size_t largest = 0;
+	int ndx;
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* Only the highest non-empty size class needs to be searched */
+
+	if (heap->mm_flbitmap == 0) {
+		return 0;
+	}
+
+	ndx = MM_FLS(heap->mm_flbitmap);
+	ndx = (ndx << MM_SLI_SHIFT) + MM_FLS(heap->mm_slbitmap[ndx]);
+
+	for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink) {
+		if (node->size > largest) {
+			largest = node->size;
+		}
+	}
+#else
+	/* Each list is ordered by size, so the last chunk of the highest
+	 * non-empty list is the largest one.  Lists are separated by their
+	 * zero-sized heads.
+	 */
+
+	for (ndx = MM_NNODES - 1; ndx >= 0 && largest == 0; ndx--) {
+		for (node = heap->mm_nodelist[ndx].flink; node && node->size; node = node->flink) {
+			largest = node->size;
+		}
+	}
+#endif
+
+	return largest;
+}
+
+/****************************************************************************
+ * Name: mm_ndx2size
+ *
+ * Description:
+ *   Return the smallest chunk size held by the free list 'ndx'.
+ *
+ ****************************************************************************/
+
+size_t mm_ndx2size(int ndx)
+{
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	size_t base = (size_t)1 << ((ndx >> MM_SLI_SHIFT) + MM_MIN_SHIFT);
+
+	return base + (ndx & MM_SLI_MASK) * (base >> MM_SLI_SHIFT);
+#else
+	return (size_t)1 << (ndx + MM_MIN_SHIFT);
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_heapprofile
+ *
+ * Description:
+ *   Take a consistent snapshot of the profile counters together with the
+ *   current free list lengths and largest free chunk.
+ *
+ ****************************************************************************/
+
+void mm_heapprofile(FAR struct mm_heap_s *heap, FAR struct mm_profinfo_s *info)
+{
+	FAR struct mm_freenode_s *node;
+	int ndx;
+	int count;
+
+	DEBUGASSERT(info);
+
+	mm_takesemaphore(heap);
+
+	memcpy(&info->prof, &heap->mm_profile, sizeof(struct mm_profile_s));
+
+	for (ndx = 0; ndx < MM_NNODES; ndx++) {
+		count = 0;
+		for (node = heap->mm_nodelist[ndx].flink; node && node->size; node = node->flink) {
+			count++;
+		}
+
+		info->nfree[ndx] = count > UINT16_MAX ? UINT16_MAX : count;
+	}
+
+	info->largest = mm_largestfree(heap);
+	if (info->largest < info->prof.mp_minlargest) {
+		info->prof.mp_minlargest = info->largest;
+	}
+
+	mm_givesemaphore(heap);
+}
+
+#endif							/* CONFIG_MM_HEAP_PROFILE */
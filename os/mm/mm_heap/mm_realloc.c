@@ -70,6 +70,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_MM_REALLOC_SLACK
+#define CONFIG_MM_REALLOC_SLACK 0
+#endif
+
+/* A block that grows is given CONFIG_MM_REALLOC_SLACK percent of headroom so
+ * that a sequence of small increments does not have to move or extend the
+ * chunk on every step.
+ */
+
+#define MM_REALLOC_GROW(s) MM_ALIGN_UP((s) + (s) * CONFIG_MM_REALLOC_SLACK / 100)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -91,14 +102,19 @@
  *  If the request is for more space and the current allocation can be
  *  extended, it will be extended by:
  *
- *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (1) Taking the additional space from the following free chunk, which
+ *         needs no copy, or
+ *     (2) Taking the whole following free chunk and the rest from the
+ *         preceding free chunk, moving the user data down.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
  *  and free the old buffer.
  *
+ *  A growing block is rounded up by CONFIG_MM_REALLOC_SLACK percent when
+ *  the neighbors or the heap can provide it; malloc_usable_size() reports
+ *  the space that is actually available.
+ *
  ****************************************************************************/
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size, mmaddress_t caller_retaddr)
@@ -113,6 +129,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 #endif
 	size_t newsize;
 	size_t oldsize;
+	size_t growsize;
 #ifndef CONFIG_DISABLE_REALLOC_NEIGHBOR_EXTENTION
 	size_t prevsize = 0;
 	size_t nextsize = 0;
@@ -154,6 +171,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 	oldsize = oldnode->size;
 
+	/* Size with headroom for a growing block.  Never less than newsize. */
+
+	growsize = newsize;
+	if (newsize > oldsize && MM_REALLOC_GROW(newsize) > newsize) {
+		growsize = MM_REALLOC_GROW(newsize);
+	}
+
 #ifndef CONFIG_DISABLE_REALLOC_NEIGHBOR_EXTENTION
 	if (newsize <= oldsize) {
 		/* Handle the special case where we are not going to change the size
@@ -202,6 +226,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 	if (nextsize + prevsize + oldsize >= newsize) {
 		size_t needed   = newsize - oldsize;
+		size_t wanted   = growsize - oldsize;
+		size_t datasize = oldsize - SIZEOF_MM_ALLOCNODE;
 		size_t takeprev = 0;
 		size_t takenext = 0;
 
@@ -211,49 +237,21 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		heapinfo_update_total_size(heap, (-1) * oldsize);
 #endif
 
-		/* Check if we can extend into the previous chunk and if the
-		 * previous chunk is smaller than the next chunk.
+		/* Prefer the next chunk: growing into it leaves the user data where
+		 * it is.  The slack is only taken where it is available.
 		 */
 
-		if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1)) {
-			/* Can we get everything we need from the previous chunk? */
-
-			if (needed > prevsize) {
-				/* No, take the whole previous chunk and get the
-				 * rest that we need from the next chunk.
-				 */
+		if (nextsize >= needed) {
+			takenext = wanted < nextsize ? wanted : nextsize;
+		} else {
+			/* Take the whole next chunk and the rest from the previous
+			 * chunk.
+			 */
 
+			takenext = nextsize;
+			takeprev = wanted - nextsize;
+			if (takeprev > prevsize) {
 				takeprev = prevsize;
-				takenext = needed - prevsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = needed;
-				takenext = 0;
-			}
-
-			needed = 0;
-		}
-
-		/* Check if we can extend into the next chunk and if we still need
-		 * more memory.
-		 */
-
-		if (nextsize > 0 && needed) {
-			/* Can we get everything we need from the next chunk? */
-
-			if (needed > nextsize) {
-				/* No, take the whole next chunk and get the rest that we
-				 * need from the previous chunk.
-				 */
-
-				takeprev = needed - nextsize;
-				takenext = nextsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = 0;
-				takenext = needed;
 			}
 		}
 
@@ -267,11 +265,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			 * there may not be a successor node.
 			 */
 
-			DEBUGASSERT(prev->blink);
-			prev->blink->flink = prev->flink;
-			if (prev->flink) {
-				prev->flink->blink = prev->blink;
-			}
+			mm_remfreechunk(heap, prev);
 
 			/* Extend the node into the previous free chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -301,12 +295,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			oldnode = newnode;
 			oldsize = newnode->size;
 
-			/* Now we have to move the user contents 'down' in memory.  memcpy should
-			 * should be save for this.
+			/* Now we have to move the user contents 'down' in memory.  The
+			 * regions may overlap.
 			 */
 
 			newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-			memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+			memmove(newmem, oldmem, datasize);
 		}
 
 		/* Extend into the next free chunk */
@@ -325,11 +319,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			 * may not be a successor node.
 			 */
 
-			DEBUGASSERT(next->blink);
-			next->blink->flink = next->flink;
-			if (next->flink) {
-				next->flink->blink = next->blink;
-			}
+			mm_remfreechunk(heap, next);
 
 			/* Extend the node into the next chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -375,13 +365,31 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		 * leave the original memory in place.
 		 */
 		mm_givesemaphore(heap);
+
+		/* Try with the slack first, then with the exact size */
+
+		newmem = NULL;
+		if (growsize > newsize) {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
-		newmem = (FAR void *)mm_malloc(heap, size, caller_retaddr);
+			newmem = (FAR void *)mm_malloc(heap, growsize - SIZEOF_MM_ALLOCNODE, caller_retaddr);
 #else
-		newmem = (FAR void *)mm_malloc(heap, size);
+			newmem = (FAR void *)mm_malloc(heap, growsize - SIZEOF_MM_ALLOCNODE);
 #endif
+		}
+
+		if (!newmem) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+			newmem = (FAR void *)mm_malloc(heap, size, caller_retaddr);
+#else
+			newmem = (FAR void *)mm_malloc(heap, size);
+#endif
+		}
+
 		if (newmem) {
-			memcpy(newmem, oldmem, oldsize);
+			/* Copy only the user data of the old chunk, not its header */
+
+			oldsize -= SIZEOF_MM_ALLOCNODE;
+			memcpy(newmem, oldmem, oldsize < size ? oldsize : size);
 			mm_free(heap, oldmem);
 		}
 
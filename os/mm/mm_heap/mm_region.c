@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_region.c
+ *
+ * Region tags and placement policy.  Each region of a heap is tagged fast
+ * or slow; allocation requests name the tags they prefer and are served
+ * from the matching regions first.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_REGION_POLICY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_nodetag
+ *
+ * Description:
+ *   Return the tag of the region that contains 'node'.
+ *
+ ****************************************************************************/
+
+static uint8_t mm_nodetag(FAR struct mm_heap_s *heap, FAR void *node)
+{
+#if CONFIG_MM_REGIONS > 1
+	int region;
+
+	for (region = 0; region < heap->mm_nregions; region++) {
+		if ((FAR void *)heap->mm_heapstart[region] <= node && node < (FAR void *)heap->mm_heapend[region]) {
+			return heap->mm_regtag[region];
+		}
+	}
+
+	return 0;
+#else
+	return heap->mm_regtag[0];
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_setregiontag
+ *
+ * Description:
+ *   Tag a region of the heap as MM_REGION_FAST or MM_REGION_SLOW.  Regions
+ *   are numbered in the order in which they were added.
+ *
+ ****************************************************************************/
+
+void mm_setregiontag(FAR struct mm_heap_s *heap, int region, uint8_t tag)
+{
+	uint8_t tags = 0;
+	int i;
+#if CONFIG_MM_REGIONS > 1
+	int nregions = heap->mm_nregions;
+#else
+	int nregions = 1;
+#endif
+
+	DEBUGASSERT(region >= 0 && region < nregions);
+	DEBUGASSERT(tag == MM_REGION_FAST || tag == MM_REGION_SLOW);
+
+	mm_takesemaphore(heap);
+
+	heap->mm_regtag[region] = tag;
+	for (i = 0; i < nregions; i++) {
+		tags |= heap->mm_regtag[i];
+	}
+
+	heap->mm_tags = tags;
+
+	mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_regionpolicy
+ *
+ * Description:
+ *   Return the tags that a plain allocation of 'size' bytes should prefer:
+ *   the default tags of the calling task if it set them, otherwise slow
+ *   memory for large requests and fast memory for small ones.  Returns
+ *   MM_REGION_ANY if the preference would not restrict the search.
+ *
+ ****************************************************************************/
+
+uint8_t mm_regionpolicy(FAR struct mm_heap_s *heap, size_t size)
+{
+	uint8_t tags = 0;
+
+	/* Nothing to choose from unless the heap has both kinds of region */
+
+	if (heap->mm_tags != MM_REGION_ANY) {
+		return MM_REGION_ANY;
+	}
+
+	if (!up_interrupt_context()) {
+		tags = sched_self()->heap_region;
+	}
+
+#if CONFIG_MM_REGION_LARGE_SIZE > 0
+	if (tags == 0) {
+		tags = size >= CONFIG_MM_REGION_LARGE_SIZE ? MM_REGION_SLOW : MM_REGION_FAST;
+	}
+#endif
+
+	return tags ? (tags & MM_REGION_ANY) : MM_REGION_ANY;
+}
+
+/****************************************************************************
+ * Name: mm_findregionchunk
+ *
+ * Description:
+ *   Return a free chunk of at least 'size' bytes (including the chunk
+ *   header) in a region whose tag is in 'tags', or NULL.  The free lists
+ *   are walked from the request's size class up, so the result is the
+ *   best fit with the sorted free list and a good fit with the segregated
+ *   free lists.  The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findregionchunk(FAR struct mm_heap_s *heap, size_t size, uint8_t tags)
+{
+	FAR struct mm_freenode_s *node;
+	int ndx;
+
+	ndx = mm_size2ndx(size);
+
+	/* The segregated lists are separate; otherwise all list heads are
+	 * linked into one list sorted by size.
+	 */
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	for (; ndx < MM_NNODES; ndx++)
+#endif
+	{
+		for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink) {
+			if (node->size >= size && (mm_nodetag(heap, node) & tags) != 0) {
+				return node;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+#endif							/* CONFIG_MM_REGION_POLICY */
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_remfreechunk.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_remfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the nodelist.  It is assumed that the caller
+ *   holds the mm semaphore.  There must be a predecessor, but there may not
+ *   be a successor node.
+ *
+ ****************************************************************************/
+
+void mm_remfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	FAR struct mm_freenode_s *prev = node->blink;
+	int ndx;
+#endif
+
+	DEBUGASSERT(node->blink);
+	node->blink->flink = node->flink;
+	if (node->flink) {
+		node->flink->blink = node->blink;
+	}
+
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* If the predecessor is a list head and there is no successor, then the
+	 * size class list has just become empty.  The index is recovered from the
+	 * list head itself because callers may already have modified node->size.
+	 */
+
+	if (!node->flink && prev >= heap->mm_nodelist && prev < &heap->mm_nodelist[MM_NNODES]) {
+		ndx = prev - heap->mm_nodelist;
+		heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] &= ~(1 << (ndx & MM_SLI_MASK));
+		if (heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] == 0) {
+			heap->mm_flbitmap &= ~(1 << (ndx >> MM_SLI_SHIFT));
+		}
+	}
+#endif
+}
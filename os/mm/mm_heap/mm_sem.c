@@ -61,6 +61,7 @@
 #include <assert.h>
 
 #include <tinyara/mm/mm.h>
+#include <tinyara/semaphore.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -107,6 +108,9 @@ void mm_seminitialize(FAR struct mm_heap_s *heap)
 	 */
 
 	(void)sem_init(&heap->mm_semaphore, 0, 1);
+#if !defined(CONFIG_BUILD_PROTECTED) || defined(__KERNEL__)
+	(void)sem_setname(&heap->mm_semaphore, "mm");
+#endif
 
 	heap->mm_holder      = -1;
 	heap->mm_counts_held = 0;
@@ -77,16 +77,31 @@
 int mm_size2ndx(size_t size)
 {
 	int ndx = 0;
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	int fl;
+	int sl;
+#endif
 
 	if (size >= MM_MAX_CHUNK) {
 		return MM_NNODES - 1;
 	}
 
+#ifdef CONFIG_MM_SEGREGATED_FIT
+	/* The first level index is the position of the most significant bit,
+	 * the second level index is taken from the MM_SLI_SHIFT bits just below
+	 * it.  Chunks are never smaller than MM_MIN_CHUNK.
+	 */
+
+	fl = MM_FLS((uint32_t)size);
+	sl = (size >> (fl - MM_SLI_SHIFT)) & MM_SLI_MASK;
+	ndx = ((fl - MM_MIN_SHIFT) << MM_SLI_SHIFT) + sl;
+#else
 	size >>= MM_MIN_SHIFT;
 	while (size > 1) {
 		ndx++;
 		size >>= 1;
 	}
+#endif
 
 	return ndx;
 }
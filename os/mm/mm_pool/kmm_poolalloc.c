@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/kmm_poolalloc.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/mm/gran.h>
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+#ifdef CONFIG_MM_POOL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_pool_alloc
+ *
+ * Description:
+ *   Allocate one object from the pool.  Recycled objects are taken from the
+ *   free list first; otherwise a new object is carved out of the backing
+ *   region by the granule allocator.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_pool_alloc(FAR struct kmm_pool_s *pool)
+{
+	FAR void *obj;
+#ifdef CONFIG_MM_POOL_STATS
+	irqstate_t flags;
+#endif
+
+	DEBUGASSERT(pool);
+
+	obj = pool_pop(pool);
+
+#ifndef CONFIG_GRAN_INTR
+	/* The granule allocator is protected by a semaphore and cannot be used
+	 * from interrupt level.
+	 */
+
+	if (!obj && !up_interrupt_context())
+#else
+	if (!obj)
+#endif
+	{
+		obj = gran_alloc(pool->gran, pool->objsize);
+	}
+
+#ifdef CONFIG_MM_POOL_STATS
+	flags = irqsave();
+	if (obj) {
+		pool->stats.nalloc++;
+		if (++pool->stats.ninuse > pool->stats.peak) {
+			pool->stats.peak = pool->stats.ninuse;
+		}
+	} else {
+		pool->stats.nfail++;
+	}
+
+	irqrestore(flags);
+#endif
+
+	return obj;
+}
+
+#endif							/* CONFIG_MM_POOL */
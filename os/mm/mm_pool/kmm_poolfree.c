@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/kmm_poolfree.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+#ifdef CONFIG_MM_POOL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_pool_free
+ *
+ * Description:
+ *   Return an object to the free list of the pool.  Objects are never given
+ *   back to the granule allocator; they are recycled by kmm_pool_alloc().
+ *
+ ****************************************************************************/
+
+void kmm_pool_free(FAR struct kmm_pool_s *pool, FAR void *obj)
+{
+#ifdef CONFIG_MM_POOL_STATS
+	irqstate_t flags;
+#endif
+
+	DEBUGASSERT(pool && kmm_pool_member(pool, obj));
+
+	pool_push(pool, obj);
+
+#ifdef CONFIG_MM_POOL_STATS
+	flags = irqsave();
+	pool->stats.ninuse--;
+	irqrestore(flags);
+#endif
+}
+
+#endif							/* CONFIG_MM_POOL */
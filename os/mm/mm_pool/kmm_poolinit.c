@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/kmm_poolinit.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/gran.h>
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+#ifdef CONFIG_MM_POOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The granule allocator cannot allocate more than 32 granules at once.
+ * Objects are at least pointer aligned (8 bytes so that 64-bit fields work
+ * as expected).
+ */
+
+#define POOL_MAX_GRANULES 32
+#define POOL_MIN_LOG2GRAN 3
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_pool_initialize
+ *
+ * Description:
+ *   Set up a pool that can hold up to 'nobjs' objects of 'objsize' bytes.
+ *
+ ****************************************************************************/
+
+int kmm_pool_initialize(FAR struct kmm_pool_s *pool, size_t objsize, unsigned int nobjs)
+{
+	FAR void *region;
+	size_t regionsize;
+	uint8_t log2gran;
+
+	DEBUGASSERT(pool && objsize > 0 && nobjs > 0);
+
+	/* Pick the smallest granule that lets one object fit in at most
+	 * POOL_MAX_GRANULES granules, then round the object up to it.
+	 */
+
+	for (log2gran = POOL_MIN_LOG2GRAN; objsize > (POOL_MAX_GRANULES << log2gran); log2gran++) ;
+
+	objsize = (objsize + (1 << log2gran) - 1) & ~((1 << log2gran) - 1);
+	if (objsize > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	regionsize = objsize * nobjs;
+	region = kmm_malloc(regionsize);
+	if (!region) {
+		return -ENOMEM;
+	}
+
+	memset(pool, 0, sizeof(struct kmm_pool_s));
+	pool->gran = gran_initialize(region, regionsize, log2gran, POOL_MIN_LOG2GRAN);
+	if (!pool->gran) {
+		kmm_free(region);
+		return -ENOMEM;
+	}
+
+	pool->start   = (uintptr_t)region;
+	pool->end     = (uintptr_t)region + regionsize;
+	pool->objsize = (uint16_t)objsize;
+
+	mvdbg("pool=%p objsize=%u nobjs=%u region=%p\n", pool, objsize, nobjs, region);
+	return OK;
+}
+
+#endif							/* CONFIG_MM_POOL */
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_pool.h
+ ****************************************************************************/
+
+#ifndef __MM_MM_POOL_MM_POOL_H
+#define __MM_MM_POOL_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <arch/irq.h>
+#include <tinyara/mm/pool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ARMv7 cores provide LDREX/STREX.  The exclusive monitor is cleared on
+ * exception entry (by hardware on ARMv7-M, by arm_vectorirq on ARMv7-R),
+ * so an interrupted sequence simply retries and the free list cannot
+ * suffer from the ABA problem.
+ */
+
+#if defined(CONFIG_ARCH_CORTEXR4) || defined(CONFIG_ARCH_CORTEXM3) || \
+	defined(CONFIG_ARCH_CORTEXM4)
+#define POOL_HAVE_LDREX 1
+#endif
+
+/* Get the next object linked from a free object */
+
+#define POOL_NEXT(obj) (*(FAR void **)(obj))
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_push
+ *
+ * Description:
+ *   Push an object onto the free list of the pool.
+ *
+ ****************************************************************************/
+
+static inline void pool_push(FAR struct kmm_pool_s *pool, FAR void *obj)
+{
+#ifdef POOL_HAVE_LDREX
+	FAR void *head;
+	int failed;
+
+	do {
+		__asm__ __volatile__("ldrex %0, [%1]" : "=&r"(head) : "r"(&pool->freelist) : "memory");
+		POOL_NEXT(obj) = head;
+		__asm__ __volatile__("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&pool->freelist), "r"(obj) : "memory");
+	} while (failed);
+#else
+	irqstate_t flags = irqsave();
+	POOL_NEXT(obj) = pool->freelist;
+	pool->freelist = obj;
+	irqrestore(flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: pool_pop
+ *
+ * Description:
+ *   Pop an object from the free list of the pool.  Returns NULL if the
+ *   free list is empty.
+ *
+ ****************************************************************************/
+
+static inline FAR void *pool_pop(FAR struct kmm_pool_s *pool)
+{
+#ifdef POOL_HAVE_LDREX
+	FAR void *head;
+	int failed;
+
+	do {
+		__asm__ __volatile__("ldrex %0, [%1]" : "=&r"(head) : "r"(&pool->freelist) : "memory");
+		if (head == NULL) {
+			/* Release the reservation taken by LDREX */
+
+			__asm__ __volatile__("clrex" : : : "memory");
+			break;
+		}
+
+		__asm__ __volatile__("strex %0, %2, [%1]" : "=&r"(failed) : "r"(&pool->freelist), "r"(POOL_NEXT(head)) : "memory");
+	} while (failed);
+
+	return head;
+#else
+	FAR void *head;
+	irqstate_t flags = irqsave();
+
+	head = pool->freelist;
+	if (head) {
+		pool->freelist = POOL_NEXT(head);
+	}
+
+	irqrestore(flags);
+	return head;
+#endif
+}
+
+#endif							/* __MM_MM_POOL_MM_POOL_H */
@@ -0,0 +1,296 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/umm_heap/umm_cache.c
+ *
+ * Per-task cache of small user heap chunks.  Each thread keeps a small
+ * "magazine" of recently freed chunks for the smallest size classes in its
+ * TCB.  malloc() and free() of those sizes are served from the magazine
+ * without taking the heap semaphore; the magazine is refilled from, and
+ * drained back to, the heap in batches while holding the semaphore once.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <arch/irq.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_TASK_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define USR_HEAP &g_mmheap
+
+/* Get the next chunk linked from a cached chunk */
+
+#define CACHE_NEXT(mem) (*(FAR void **)(mem))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_cache_class
+ *
+ * Description:
+ *   Return the cache class of a chunk of 'chunksize' bytes or -1 if chunks
+ *   of that size are not cached.
+ *
+ ****************************************************************************/
+
+static inline int umm_cache_class(size_t chunksize)
+{
+	int ndx = (int)(chunksize >> MM_MIN_SHIFT) - 1;
+
+	if (ndx < 0 || ndx >= MM_TASKCACHE_NCLASSES) {
+		return -1;
+	}
+
+	return ndx;
+}
+
+/****************************************************************************
+ * Name: umm_cache_sumhits
+ *
+ * Description:
+ *   sched_foreach() callback adding the cache hits of a thread to 'arg'.
+ *
+ ****************************************************************************/
+
+static void umm_cache_sumhits(FAR struct tcb_s *tcb, FAR void *arg)
+{
+	*(FAR uint32_t *)arg += tcb->heap_cache.hits;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_cache_alloc
+ *
+ * Description:
+ *   Allocate a small chunk from the cache of the calling thread.  If the
+ *   cache of that size class is empty, it is refilled with a batch of
+ *   chunks from the user heap.
+ *
+ * Return Value:
+ *   The allocated memory or NULL if the size is not cached or the heap is
+ *   exhausted.  The caller should fall back to mm_malloc() on NULL.
+ *
+ ****************************************************************************/
+
+FAR void *umm_cache_alloc(size_t size)
+{
+	FAR struct mm_heap_s *heap = USR_HEAP;
+	FAR struct mm_taskcache_s *cache;
+	FAR void *mem;
+	FAR void *next;
+	size_t chunksize;
+	int ndx;
+	int i;
+
+	if (size < 1 || up_interrupt_context()) {
+		return NULL;
+	}
+
+	chunksize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+	ndx = umm_cache_class(chunksize);
+	if (ndx < 0) {
+		return NULL;
+	}
+
+	cache = &sched_self()->heap_cache;
+
+	/* The cache, hit count included, is only ever touched by its owner
+	 * thread, so no locking is needed on the hit path.
+	 */
+
+	mem = cache->head[ndx];
+	if (mem) {
+		cache->head[ndx] = CACHE_NEXT(mem);
+		cache->count[ndx]--;
+		cache->hits++;
+		return mem;
+	}
+
+	/* Refill the magazine with one batch of chunks.  mm_malloc() is called
+	 * recursively with the semaphore already held so that it is taken only
+	 * once for the whole batch.
+	 */
+
+	mm_takesemaphore(heap);
+	heap->mm_cache_misses++;
+
+	mem = mm_malloc(heap, chunksize - SIZEOF_MM_ALLOCNODE);
+	for (i = 1; mem && i < MM_TASKCACHE_BATCH; i++) {
+		next = mm_malloc(heap, chunksize - SIZEOF_MM_ALLOCNODE);
+		if (!next) {
+			break;
+		}
+
+		CACHE_NEXT(next) = cache->head[ndx];
+		cache->head[ndx] = next;
+		cache->count[ndx]++;
+	}
+
+	mm_givesemaphore(heap);
+	return mem;
+}
+
+/****************************************************************************
+ * Name: umm_cache_free
+ *
+ * Description:
+ *   Return a chunk to the cache of the calling thread if it belongs to a
+ *   cached size class.  If the cache of that class is full, one batch of
+ *   chunks is first drained back to the user heap.
+ *
+ * Return Value:
+ *   true if the chunk was taken by the cache; false if the caller must
+ *   release it with mm_free().
+ *
+ ****************************************************************************/
+
+bool umm_cache_free(FAR void *mem)
+{
+	FAR struct mm_heap_s *heap = USR_HEAP;
+	FAR struct mm_allocnode_s *node;
+	FAR struct mm_taskcache_s *cache;
+	FAR void *next;
+	int ndx;
+	int i;
+
+	if (!mem || up_interrupt_context()) {
+		return false;
+	}
+
+	node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+	DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+	ndx = umm_cache_class(node->size);
+	if (ndx < 0) {
+		return false;
+	}
+
+	cache = &sched_self()->heap_cache;
+
+	if (cache->count[ndx] >= MM_TASKCACHE_DEPTH) {
+		mm_takesemaphore(heap);
+		for (i = 0; i < MM_TASKCACHE_BATCH && cache->head[ndx]; i++) {
+			next = cache->head[ndx];
+			cache->head[ndx] = CACHE_NEXT(next);
+			cache->count[ndx]--;
+			mm_free(heap, next);
+		}
+
+		mm_givesemaphore(heap);
+	}
+
+	CACHE_NEXT(mem) = cache->head[ndx];
+	cache->head[ndx] = mem;
+	cache->count[ndx]++;
+	return true;
+}
+
+/****************************************************************************
+ * Name: umm_cache_drain
+ *
+ * Description:
+ *   Release every chunk cached by 'tcb' back to the user heap.  This is
+ *   called when the thread is torn down.  If the heap cannot be accessed
+ *   now, the chunks are handed to the deferred deallocator.
+ *
+ ****************************************************************************/
+
+void umm_cache_drain(FAR struct tcb_s *tcb)
+{
+	FAR struct mm_heap_s *heap = USR_HEAP;
+	FAR struct mm_taskcache_s *cache = &tcb->heap_cache;
+	FAR void *mem;
+	irqstate_t flags;
+	bool locked;
+	int ndx;
+
+	locked = !up_interrupt_context() && umm_trysemaphore() == 0;
+
+	for (ndx = 0; ndx < MM_TASKCACHE_NCLASSES; ndx++) {
+		while ((mem = cache->head[ndx]) != NULL) {
+			cache->head[ndx] = CACHE_NEXT(mem);
+			if (locked) {
+				mm_free(heap, mem);
+			} else {
+				sched_ufree(mem);
+			}
+		}
+
+		cache->count[ndx] = 0;
+	}
+
+	if (locked) {
+		umm_givesemaphore();
+	}
+
+	/* Keep the hits of the thread in the heap total.  Interrupts are
+	 * disabled as in umm_cache_hits(), so that they are counted once.
+	 */
+
+	flags = irqsave();
+	heap->mm_cache_hits += cache->hits;
+	cache->hits = 0;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: umm_cache_hits
+ *
+ * Description:
+ *   Return the number of allocations served by the caches of all threads,
+ *   those that exited included.
+ *
+ ****************************************************************************/
+
+uint32_t umm_cache_hits(void)
+{
+	FAR struct mm_heap_s *heap = USR_HEAP;
+	irqstate_t flags;
+	uint32_t hits;
+
+	flags = irqsave();
+	hits = heap->mm_cache_hits;
+	sched_foreach(umm_cache_sumhits, &hits);
+	irqrestore(flags);
+
+	return hits;
+}
+
+#endif							/* CONFIG_MM_TASK_CACHE */
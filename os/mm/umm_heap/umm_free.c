@@ -102,6 +102,14 @@
 
 void free(FAR void *mem)
 {
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Small chunks are kept in the per-task cache when possible */
+
+	if (umm_cache_free(mem)) {
+		return;
+	}
+#endif
+
 	mm_free(USR_HEAP, mem);
 }
 
@@ -124,6 +124,9 @@ struct mallinfo mallinfo(void)
 {
 	struct mallinfo info;
 	mm_mallinfo(USR_HEAP, &info);
+#ifdef CONFIG_MM_TASK_CACHE
+	info.cachehits = umm_cache_hits();
+#endif
 	return info;
 }
 
@@ -131,7 +134,13 @@ struct mallinfo mallinfo(void)
 
 int mallinfo(struct mallinfo *info)
 {
-	return mm_mallinfo(USR_HEAP, info);
+	int ret;
+
+	ret = mm_mallinfo(USR_HEAP, info);
+#ifdef CONFIG_MM_TASK_CACHE
+	info->cachehits = umm_cache_hits();
+#endif
+	return ret;
 }
 
 #endif							/* CONFIG_CAN_PASS_STRUCTS */
@@ -147,6 +147,14 @@ FAR void *malloc(size_t size)
 
 	return mem;
 #else
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Try the per-task cache of small chunks first */
+
+	FAR void *mem = umm_cache_alloc(size);
+	if (mem) {
+		return mem;
+	}
+#endif
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
 	return mm_malloc(USR_HEAP, size, retaddr);
@@ -0,0 +1,59 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/umm_heap/umm_malloc_size.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdlib.h>
+
+#include <tinyara/mm/mm.h>
+
+#if !defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: malloc_usable_size
+ *
+ * Description:
+ *   Return the number of usable bytes in a block of the user heap.
+ *
+ * Parameters:
+ *   mem - A pointer returned by malloc(), calloc() or realloc(), or NULL
+ *
+ * Return Value:
+ *   The usable size of the block, which may exceed the requested size.
+ *   Zero if mem is NULL.
+ *
+ ****************************************************************************/
+
+size_t malloc_usable_size(FAR void *mem)
+{
+	return mm_malloc_size(mem);
+}
+
+#endif							/* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/umm_heap/umm_region.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdlib.h>
+
+#include <tinyara/sched.h>
+#include <tinyara/mm/mm.h>
+
+#if defined(CONFIG_MM_REGION_POLICY) && (!defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define USR_HEAP &g_mmheap
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_setregiontag
+ *
+ * Description:
+ *   Tag a region of the user heap as fast or slow memory.
+ *
+ * Parameters:
+ *   region - Index of the region, in the order in which it was added
+ *   tag    - MM_REGION_FAST or MM_REGION_SLOW
+ *
+ ****************************************************************************/
+
+void umm_setregiontag(int region, uint8_t tag)
+{
+	mm_setregiontag(USR_HEAP, region, tag);
+}
+
+/****************************************************************************
+ * Name: umm_settaskregion
+ *
+ * Description:
+ *   Set the region tags that malloc() prefers for the calling task.
+ *
+ * Parameters:
+ *   tags - MM_REGION_FAST, MM_REGION_SLOW, MM_REGION_ANY or 0 to choose by
+ *          request size
+ *
+ * Return Value:
+ *   The previous setting
+ *
+ ****************************************************************************/
+
+uint8_t umm_settaskregion(uint8_t tags)
+{
+	FAR struct tcb_s *tcb = sched_self();
+	uint8_t old = tcb->heap_region;
+
+	tcb->heap_region = tags & MM_REGION_ANY;
+	return old;
+}
+
+/****************************************************************************
+ * Name: umm_malloc_fast
+ *
+ * Description:
+ *   Allocate memory from the fast regions of the user heap only.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL if no fast region can hold
+ *   the request)
+ *
+ ****************************************************************************/
+
+FAR void *umm_malloc_fast(size_t size)
+{
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	ARCH_GET_RET_ADDRESS
+	return mm_malloc_region(USR_HEAP, size, MM_REGION_FAST | MM_REGION_STRICT, retaddr);
+#else
+	return mm_malloc_region(USR_HEAP, size, MM_REGION_FAST | MM_REGION_STRICT);
+#endif
+}
+
+#endif							/* CONFIG_MM_REGION_POLICY && (!CONFIG_BUILD_PROTECTED || !__KERNEL__) */
@@ -606,13 +606,44 @@ err_t netconn_send(struct netconn *conn, struct netbuf *buf)
  * @return ERR_OK if data was sent, any other err_t on error
  */
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+{
+	struct netvector vector;
+
+	vector.ptr = dataptr;
+	vector.len = size;
+	return netconn_write_vectors_partly(conn, &vector, 1, apiflags, bytes_written);
+}
+
+/**
+ * Send the data of several buffers over a TCP netconn, as if they were
+ * contiguous. The buffers are queued together so that they can share the
+ * same segments instead of being sent one after the other.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param vectors array of buffers to send
+ * @param vectorcnt number of buffers in the array
+ * @param apiflags combination of following flags :
+ * - NETCONN_COPY: data will be copied into memory belonging to the stack
+ * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
+ * - NETCONN_DONTBLOCK: only write the data if all dat can be written at once
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t netconn_write_vectors_partly(struct netconn *conn, const struct netvector *vectors, u16_t vectorcnt, u8_t apiflags, size_t *bytes_written)
 {
 	struct api_msg msg;
 	err_t err;
 	u8_t dontblock;
+	size_t size;
+	u16_t i;
 
 	LWIP_ERROR("netconn_write: invalid conn", (conn != NULL), return ERR_ARG;);
 	LWIP_ERROR("netconn_write: invalid conn->type", (conn->type == NETCONN_TCP), return ERR_VAL;);
+	size = 0;
+	for (i = 0; i < vectorcnt; i++) {
+		size += vectors[i].len;
+		LWIP_ERROR("netconn_write: total size overflow", (size >= vectors[i].len), return ERR_VAL;);
+	}
 	if (size == 0) {
 		return ERR_OK;
 	}
@@ -626,7 +657,9 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 	/* non-blocking write sends as much  */
 	msg.function = do_write;
 	msg.msg.conn = conn;
-	msg.msg.msg.w.dataptr = dataptr;
+	msg.msg.msg.w.vector = vectors;
+	msg.msg.msg.w.vector_cnt = vectorcnt;
+	msg.msg.msg.w.vector_off = 0;
 	msg.msg.msg.w.apiflags = apiflags;
 	msg.msg.msg.w.len = size;
 #if LWIP_SO_SNDTIMEO
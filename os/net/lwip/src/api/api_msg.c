@@ -70,18 +70,48 @@
 
 #include <string.h>
 
+#include <tinyara/net/netmem.h>
+
 #define SET_NONBLOCKING_CONNECT(conn, val)  do { if (val) { \
 	(conn)->flags |= NETCONN_FLAG_IN_NONBLOCKING_CONNECT; \
 } else { \
 	(conn)->flags &= ~ NETCONN_FLAG_IN_NONBLOCKING_CONNECT; } } while (0)
 #define IN_NONBLOCKING_CONNECT(conn) (((conn)->flags & NETCONN_FLAG_IN_NONBLOCKING_CONNECT) != 0)
 
+#if LWIP_TCP
+#if LWIP_SO_SNDBUF
+/* A netconn limited by SO_SNDBUF becomes writable again once half of its
+   send buffer is free */
+#define NETCONN_SNDLOWAT(conn) LWIP_MIN(TCP_SNDLOWAT, (conn)->send_bufsize / 2)
+#else
+#define netconn_sndbuf(conn)   tcp_sndbuf((conn)->pcb.tcp)
+#define NETCONN_SNDLOWAT(conn) TCP_SNDLOWAT
+#endif							/* LWIP_SO_SNDBUF */
+#endif							/* LWIP_TCP */
+
 /* forward declarations */
 #if LWIP_TCP
 static err_t do_writemore(struct netconn *conn);
 static void do_close_internal(struct netconn *conn);
 #endif
 
+#if LWIP_TCP && LWIP_SO_SNDBUF
+/**
+ * Space left in the send buffer of a TCP netconn: what tcp_sndbuf() reports,
+ * less what would take the bytes queued beyond conn->send_bufsize.
+ */
+static u16_t netconn_sndbuf(struct netconn *conn)
+{
+	u32_t avail = tcp_sndbuf(conn->pcb.tcp);
+	u32_t queued = (avail < TCP_SND_BUF) ? TCP_SND_BUF - avail : 0;
+
+	if (queued >= (u32_t)conn->send_bufsize) {
+		return 0;
+	}
+	return (u16_t)LWIP_MIN(avail, (u32_t)conn->send_bufsize - queued);
+}
+#endif							/* LWIP_TCP && LWIP_SO_SNDBUF */
+
 #if LWIP_RAW
 /**
  * Receive callback function for RAW netconns.
@@ -104,6 +134,7 @@ static u8_t recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p, ip_addr_t *
 		int recv_avail;
 		SYS_ARCH_GET(conn->recv_avail, recv_avail);
 		if ((recv_avail + (int)(p->tot_len)) > conn->recv_bufsize) {
+			netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 			return 0;
 		}
 #endif							/* LWIP_SO_RCVBUF */
@@ -120,6 +151,7 @@ static u8_t recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p, ip_addr_t *
 			u16_t len;
 			buf = (struct netbuf *)memp_malloc(MEMP_NETBUF);
 			if (buf == NULL) {
+				netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 				pbuf_free(q);
 				return 0;
 			}
@@ -131,6 +163,7 @@ static u8_t recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p, ip_addr_t *
 
 			len = q->tot_len;
 			if (sys_mbox_trypost(&conn->recvmbox, buf) != ERR_OK) {
+				netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 				netbuf_delete(buf);
 				return 0;
 			} else {
@@ -176,12 +209,14 @@ static void recv_udp(void *arg, struct udp_pcb *pcb, struct pbuf *p, ip_addr_t *
 #else							/* LWIP_SO_RCVBUF */
 	if ((conn == NULL) || !sys_mbox_valid(&conn->recvmbox)) {
 #endif							/* LWIP_SO_RCVBUF */
+		netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 		pbuf_free(p);
 		return;
 	}
 
 	buf = (struct netbuf *)memp_malloc(MEMP_NETBUF);
 	if (buf == NULL) {
+		netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 		pbuf_free(p);
 		return;
 	} else {
@@ -205,6 +240,7 @@ static void recv_udp(void *arg, struct udp_pcb *pcb, struct pbuf *p, ip_addr_t *
 
 	len = p->tot_len;
 	if (sys_mbox_trypost(&conn->recvmbox, buf) != ERR_OK) {
+		netmem_drop(NETMEM_DROP_SOCK_RCVBUF);
 		netbuf_delete(buf);
 		return;
 	} else {
@@ -304,7 +340,7 @@ static err_t poll_tcp(void *arg, struct tcp_pcb *pcb)
 	if (conn->flags & NETCONN_FLAG_CHECK_WRITESPACE) {
 		/* If the queued byte- or pbuf-count drops below the configured low-water limit,
 		   let select mark this pcb as writable again. */
-		if ((conn->pcb.tcp != NULL) && (tcp_sndbuf(conn->pcb.tcp) > TCP_SNDLOWAT) && (tcp_sndqueuelen(conn->pcb.tcp) < TCP_SNDQUEUELOWAT)) {
+		if ((conn->pcb.tcp != NULL) && (netconn_sndbuf(conn) > NETCONN_SNDLOWAT(conn)) && (tcp_sndqueuelen(conn->pcb.tcp) < TCP_SNDQUEUELOWAT)) {
 			conn->flags &= ~NETCONN_FLAG_CHECK_WRITESPACE;
 			API_EVENT(conn, NETCONN_EVT_SENDPLUS, 0);
 		}
@@ -336,7 +372,7 @@ static err_t sent_tcp(void *arg, struct tcp_pcb *pcb, u16_t len)
 	if (conn) {
 		/* If the queued byte- or pbuf-count drops below the configured low-water limit,
 		   let select mark this pcb as writable again. */
-		if ((conn->pcb.tcp != NULL) && (tcp_sndbuf(conn->pcb.tcp) > TCP_SNDLOWAT) && (tcp_sndqueuelen(conn->pcb.tcp) < TCP_SNDQUEUELOWAT)) {
+		if ((conn->pcb.tcp != NULL) && (netconn_sndbuf(conn) > NETCONN_SNDLOWAT(conn)) && (tcp_sndqueuelen(conn->pcb.tcp) < TCP_SNDQUEUELOWAT)) {
 			conn->flags &= ~NETCONN_FLAG_CHECK_WRITESPACE;
 			API_EVENT(conn, NETCONN_EVT_SENDPLUS, len);
 		}
@@ -645,6 +681,9 @@ struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback)
 	conn->recv_bufsize = RECV_BUFSIZE_DEFAULT;
 	conn->recv_avail = 0;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_SO_SNDBUF
+	conn->send_bufsize = SEND_BUFSIZE_DEFAULT;
+#endif							/* LWIP_SO_SNDBUF */
 	conn->flags = 0;
 	conn->crefs = 1;
 	LWIP_DEBUGF(API_MSG_DEBUG, ("Exit with netconn\n"));
@@ -677,6 +716,24 @@ void netconn_free(struct netconn *conn)
 	//LWIP_DEBUGF(API_MSG_DEBUG,("Exit"));
 }
 
+#if LWIP_TCP
+/**
+ * Return the netconn a TCP pcb belongs to.
+ * Must be called from tcpip_thread.
+ *
+ * @param pcb the tcp_pcb to look up
+ * @return the netconn, or NULL if the pcb is used through the raw API or
+ *         its netconn is already gone
+ */
+struct netconn *netconn_tcp_owner(struct tcp_pcb *pcb)
+{
+	if (pcb->recv != recv_tcp) {
+		return NULL;
+	}
+	return (struct netconn *)pcb->callback_arg;
+}
+#endif							/* LWIP_TCP */
+
 /**
  * Delete rcvmbox and acceptmbox of a netconn and free the left-over data in
  * these mboxes
@@ -1207,9 +1264,10 @@ static err_t do_writemore(struct netconn *conn)
 	void *dataptr;
 	u16_t len, available;
 	u8_t write_finished = 0;
+	u8_t write_more;
 	size_t diff;
 	u8_t dontblock = netconn_is_nonblocking(conn) || (conn->current_msg->msg.w.apiflags & NETCONN_DONTBLOCK);
-	u8_t apiflags = conn->current_msg->msg.w.apiflags;
+	u8_t apiflags;
 
 	LWIP_ASSERT("conn != NULL", conn != NULL);
 	LWIP_ASSERT("conn->state == NETCONN_WRITE", (conn->state == NETCONN_WRITE));
@@ -1232,44 +1290,70 @@ static err_t do_writemore(struct netconn *conn)
 	} else
 #endif							/* LWIP_SO_SNDTIMEO */
 	{
-		dataptr = (u8_t *)conn->current_msg->msg.w.dataptr + conn->write_offset;
-		diff = conn->current_msg->msg.w.len - conn->write_offset;
-		if (diff > 0xffffUL) {	/* max_u16_t */
-			len = 0xffff;
+		do {
+			/* skip the buffers that are empty or already written */
+			while (conn->current_msg->msg.w.vector_off == conn->current_msg->msg.w.vector->len) {
+				conn->current_msg->msg.w.vector++;
+				conn->current_msg->msg.w.vector_cnt--;
+				conn->current_msg->msg.w.vector_off = 0;
+			}
+
+			write_more = 0;
+			apiflags = conn->current_msg->msg.w.apiflags;
+			dataptr = (u8_t *)conn->current_msg->msg.w.vector->ptr + conn->current_msg->msg.w.vector_off;
+			diff = conn->current_msg->msg.w.vector->len - conn->current_msg->msg.w.vector_off;
+			if (diff > 0xffffUL) {	/* max_u16_t */
+				len = 0xffff;
 #if LWIP_TCPIP_CORE_LOCKING
-			conn->flags |= NETCONN_FLAG_WRITE_DELAYED;
+				conn->flags |= NETCONN_FLAG_WRITE_DELAYED;
 #endif
-			apiflags |= TCP_WRITE_FLAG_MORE;
-		} else {
-			len = (u16_t)diff;
-		}
-		available = tcp_sndbuf(conn->pcb.tcp);
-		if (available < len) {
-			/* don't try to write more than sendbuf */
-			len = available;
-			if (dontblock) {
-				if (!len) {
-					err = ERR_WOULDBLOCK;
-					goto err_mem;
-				}
+				apiflags |= TCP_WRITE_FLAG_MORE;
 			} else {
+				len = (u16_t)diff;
+			}
+			available = netconn_sndbuf(conn);
+			if (available < len) {
+				/* don't try to write more than sendbuf */
+				len = available;
+				if (dontblock) {
+					if (!len) {
+						/* a partial write is not an error */
+						err = (conn->write_offset == 0) ? ERR_WOULDBLOCK : ERR_OK;
+						goto err_mem;
+					}
+				} else {
 #if LWIP_TCPIP_CORE_LOCKING
-				conn->flags |= NETCONN_FLAG_WRITE_DELAYED;
+					conn->flags |= NETCONN_FLAG_WRITE_DELAYED;
 #endif
+					apiflags |= TCP_WRITE_FLAG_MORE;
+				}
+			} else if (len == diff && conn->current_msg->msg.w.vector_cnt > 1) {
+				/* the next buffer goes into the same segments: no PSH yet */
 				apiflags |= TCP_WRITE_FLAG_MORE;
+				write_more = 1;
 			}
+			LWIP_ASSERT("do_writemore: invalid length!", ((conn->write_offset + len) <= conn->current_msg->msg.w.len));
+			err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+			if (err == ERR_OK) {
+				conn->write_offset += len;
+				conn->current_msg->msg.w.vector_off += len;
+			}
+		} while (write_more && (err == ERR_OK) && (conn->write_offset < conn->current_msg->msg.w.len));
+
+		if (dontblock && (err == ERR_MEM) && (conn->write_offset != 0)) {
+			/* non-blocking write of several buffers: report what was queued */
+			err = ERR_OK;
 		}
-		LWIP_ASSERT("do_writemore: invalid length!", ((conn->write_offset + len) <= conn->current_msg->msg.w.len));
-		err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+
 		/* if OK or memory error, check available space */
 		if ((err == ERR_OK) || (err == ERR_MEM)) {
 err_mem:
-			if (dontblock && (len < conn->current_msg->msg.w.len)) {
+			if (dontblock && (conn->write_offset < conn->current_msg->msg.w.len)) {
 				/* non-blocking write did not write everything: mark the pcb non-writable
 				   and let poll_tcp check writable space to mark the pcb writable again */
 				API_EVENT(conn, NETCONN_EVT_SENDMINUS, len);
 				conn->flags |= NETCONN_FLAG_CHECK_WRITESPACE;
-			} else if ((tcp_sndbuf(conn->pcb.tcp) <= TCP_SNDLOWAT) || (tcp_sndqueuelen(conn->pcb.tcp) >= TCP_SNDQUEUELOWAT)) {
+			} else if ((netconn_sndbuf(conn) <= NETCONN_SNDLOWAT(conn)) || (tcp_sndqueuelen(conn->pcb.tcp) >= TCP_SNDQUEUELOWAT)) {
 				/* The queued byte- or pbuf-count exceeds the configured low-water limit,
 				   let select mark this pcb as non-writable. */
 				API_EVENT(conn, NETCONN_EVT_SENDMINUS, len);
@@ -1277,7 +1361,6 @@ err_mem:
 		}
 
 		if (err == ERR_OK) {
-			conn->write_offset += len;
 			if ((conn->write_offset == conn->current_msg->msg.w.len) || dontblock) {
 				/* return sent length */
 				conn->current_msg->msg.w.len = conn->write_offset;
@@ -1301,6 +1384,7 @@ err_mem:
 			/* On errors != ERR_MEM, we don't try writing any more but return
 			   the error to the application thread. */
 			write_finished = 1;
+			conn->write_offset = 0;
 			conn->current_msg->msg.w.len = 0;
 		}
 	}
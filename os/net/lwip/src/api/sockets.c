@@ -84,6 +84,7 @@
 #include <net/lwip/tcpip.h>
 #include <net/lwip/pbuf.h>
 #include <net/lwip/mem.h>
+#include <tinyara/net/netperf.h>
 #if LWIP_CHECKSUM_ON_COPY
 #include <net/lwip/ipv4/inet_chksum.h>
 #endif
@@ -346,6 +347,9 @@ int alloc_socket(struct netconn *newconn, int accepted)
 				list->sl_sockets[i].errevent = 0;
 				list->sl_sockets[i].err = 0;
 				list->sl_sockets[i].select_waiting = 0;
+#ifdef CONFIG_EPOLL
+				list->sl_sockets[i].epoll_fds = NULL;
+#endif
 				_net_semgive(list);
 
 				return i + LWIP_SOCKET_OFFSET;
@@ -648,6 +652,7 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 	void *buf = NULL;
 	struct pbuf *p;
 	u16_t buflen, copylen;
+	u32_t copystart;
 	int off = 0;
 	ip_addr_t *addr;
 	u16_t port = 0;
@@ -728,7 +733,9 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 
 		/* copy the contents of the received buffer into
 		   the supplied memory pointer mem */
+		copystart = netperf_begin();
 		pbuf_copy_partial(p, (u8_t *)mem + off, copylen, sock->lastoffset);
+		netperf_end(NETPERF_SOCKET_COPY, copystart);
 
 		off += copylen;
 
@@ -818,6 +825,175 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 	return off;
 }
 
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * Receive data without copying it: the pbuf chain that holds the data is
+ * handed to the caller, who may read it in place but not modify it, and
+ * must give it back with lwip_pbuf_release() once done.  A TCP socket
+ * returns the data queued next, starting with the rest of a segment that
+ * lwip_recvfrom() only partly read; other sockets return one datagram.
+ * MSG_PEEK is not supported.
+ *
+ * @param s the socket
+ * @param p returns the pbuf chain, NULL if none
+ * @param flags MSG_DONTWAIT or 0
+ * @param from if not NULL, returns the address of the sender
+ * @param fromlen the size of 'from', updated to the size returned
+ * @return the number of bytes in *p, 0 if the connection was closed or -1
+ *         on error
+ */
+int lwip_recvfrom_pbuf(int s, struct pbuf **p, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+	struct socket *sock;
+	void *buf = NULL;
+	struct pbuf *q;
+	struct pbuf *rest;
+	ip_addr_t fromaddr;
+	ip_addr_t *addr;
+	u16_t port = 0;
+	u16_t off;
+	err_t err;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom_pbuf(%d, 0x%x, ..)\n", s, flags));
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (p == NULL || (flags & MSG_PEEK) != 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+	*p = NULL;
+
+	if (sock->lastdata) {
+		buf = sock->lastdata;
+		sock->lastdata = NULL;
+	} else {
+		/* If this is non-blocking call, then check first */
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom_pbuf(%d): returning EWOULDBLOCK\n", s));
+			sock_set_errno(sock, EWOULDBLOCK);
+			return -1;
+		}
+
+		if (netconn_type(sock->conn) == NETCONN_TCP) {
+			err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
+		} else {
+			err = netconn_recv(sock->conn, (struct netbuf **)&buf);
+		}
+
+		if (err != ERR_OK) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom_pbuf(%d): error is \"%s\"!\n", s, lwip_strerr(err)));
+			sock_set_errno(sock, err_to_errno(err));
+			return err == ERR_CLSD ? 0 : -1;
+		}
+		LWIP_ASSERT("buf != NULL", buf != NULL);
+	}
+
+	if (netconn_type(sock->conn) == NETCONN_TCP) {
+		q = (struct pbuf *)buf;
+
+		/* Drop what lwip_recvfrom() already returned */
+		off = sock->lastoffset;
+		sock->lastoffset = 0;
+		while (off >= q->len) {
+			rest = q->next;
+			LWIP_ASSERT("offset beyond the pbuf chain", rest != NULL);
+			off -= q->len;
+			pbuf_ref(rest);
+			pbuf_free(q);
+			q = rest;
+		}
+		if (off > 0) {
+			pbuf_header(q, -(s16_t)off);
+		}
+
+		/* The data has left the stack: update the receive window */
+		netconn_recved(sock->conn, (u32_t)q->tot_len);
+
+		addr = &fromaddr;
+		if (from && fromlen) {
+			netconn_getaddr(sock->conn, addr, &port, 0);
+		}
+	} else {
+		/* Keep the pbuf chain, free the netbuf around it */
+		q = ((struct netbuf *)buf)->p;
+		pbuf_ref(q);
+		ip_addr_copy(fromaddr, *netbuf_fromaddr((struct netbuf *)buf));
+		port = netbuf_fromport((struct netbuf *)buf);
+		addr = &fromaddr;
+		netbuf_delete((struct netbuf *)buf);
+	}
+
+	if (from && fromlen) {
+		struct sockaddr_in sin;
+
+		memset(&sin, 0, sizeof(sin));
+		sin.sin_len = sizeof(sin);
+		sin.sin_family = AF_INET;
+		sin.sin_port = htons(port);
+		inet_addr_from_ipaddr(&sin.sin_addr, addr);
+
+		if (*fromlen > sizeof(sin)) {
+			*fromlen = sizeof(sin);
+		}
+
+		MEMCPY(from, &sin, *fromlen);
+	}
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom_pbuf(%d): pbuf=%p len=%" U16_F "\n", s, (void *)q, q->tot_len));
+	*p = q;
+	sock_set_errno(sock, 0);
+	return q->tot_len;
+}
+
+/**
+ * Give back a pbuf chain returned by lwip_recvfrom_pbuf().
+ *
+ * @param p the pbuf chain, may be NULL
+ */
+void lwip_pbuf_release(struct pbuf *p)
+{
+	if (p != NULL) {
+		pbuf_free(p);
+	}
+}
+
+/**
+ * Send data without copying it: the segments queued on a TCP socket
+ * refer to the data of the caller, which must therefore stay unchanged
+ * until the peer acknowledged it, such as data in flash.  Other sockets
+ * copy the data like lwip_send().
+ */
+int lwip_send_ref(int s, const void *data, size_t size, int flags)
+{
+	struct socket *sock;
+	err_t err;
+	u8_t write_flags;
+	size_t written;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_ref(%d, data=%p, size=%" SZT_F ", flags=0x%x)\n", s, data, size, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (sock->conn->type != NETCONN_TCP) {
+		return lwip_send(s, data, size, flags);
+	}
+
+	write_flags = NETCONN_NOCOPY | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+	written = 0;
+	err = netconn_write_partly(sock->conn, data, size, write_flags, &written);
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_ref(%d) err=%d written=%" SZT_F "\n", s, err, written));
+	sock_set_errno(sock, err_to_errno(err));
+	return (err == ERR_OK ? (int)written : -1);
+}
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+
 int lwip_read(int s, void *mem, size_t len)
 {
 	return lwip_recvfrom(s, mem, len, 0, NULL, NULL);
@@ -1009,6 +1185,355 @@ int lwip_sendto(int s, const void *data, size_t size, int flags, const struct so
 	return (err == ERR_OK ? short_size : -1);
 }
 
+#if LWIP_SOCKET_SENDMSG
+/**
+ * Send the buffers described by msg->msg_iov as a single write.
+ *
+ * On a TCP socket, the buffers are queued together by
+ * netconn_write_vectors_partly() so that they share the same segments; the
+ * data is still copied since it must be kept until it is acknowledged.  On
+ * a UDP or raw socket, they are sent as one datagram to msg->msg_name (or
+ * to the connected peer), the pbufs referencing the buffers directly unless
+ * the netif needs a single pbuf.
+ *
+ * @param sock the socket
+ * @param s the socket descriptor, for debug output
+ * @param msg the buffers and the destination address
+ * @param flags MSG_MORE, MSG_DONTWAIT or 0
+ * @return the number of bytes sent, or -1 on error
+ */
+static int lwip_sendmsg_sock(struct socket *sock, int s, const struct msghdr *msg, int flags)
+{
+	err_t err;
+	size_t i;
+#if LWIP_TCP
+	u8_t write_flags;
+	size_t written;
+#endif
+#if (LWIP_UDP || LWIP_RAW)
+	struct netbuf buf;
+	const struct sockaddr_in *to_in;
+	size_t size;
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	size_t off;
+#else
+	struct pbuf *p;
+#endif
+#endif							/* (LWIP_UDP || LWIP_RAW) */
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_sendmsg(%d, msg=%p, flags=0x%x)\n", s, (const void *)msg, flags));
+
+	if (msg == NULL || (msg->msg_iov == NULL && msg->msg_iovlen != 0) || msg->msg_iovlen > 0xffff) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	if (sock->conn->type == NETCONN_TCP) {
+#if LWIP_TCP
+		/* struct iovec is laid out like struct netvector */
+		LWIP_ASSERT("iovec and netvector differ", sizeof(struct iovec) == sizeof(struct netvector));
+
+		write_flags = NETCONN_COPY | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+		written = 0;
+		err = netconn_write_vectors_partly(sock->conn, (const struct netvector *)msg->msg_iov, (u16_t)msg->msg_iovlen, write_flags, &written);
+
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_sendmsg(%d) err=%d written=%" SZT_F "\n", s, err, written));
+		sock_set_errno(sock, err_to_errno(err));
+		return (err == ERR_OK ? (int)written : -1);
+#else							/* LWIP_TCP */
+		sock_set_errno(sock, err_to_errno(ERR_ARG));
+		return -1;
+#endif							/* LWIP_TCP */
+	}
+
+#if (LWIP_UDP || LWIP_RAW)
+	size = 0;
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		size += msg->msg_iov[i].iov_len;
+		if (size < msg->msg_iov[i].iov_len || size > 0xffff) {
+			sock_set_errno(sock, EMSGSIZE);
+			return -1;
+		}
+	}
+
+	LWIP_ERROR("lwip_sendmsg: invalid address", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || ((msg->msg_namelen == sizeof(struct sockaddr_in)) && (((const struct sockaddr *)msg->msg_name)->sa_family == AF_INET) && ((((mem_ptr_t)msg->msg_name) % 4) == 0))), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+	to_in = (const struct sockaddr_in *)msg->msg_name;
+
+	/* initialize a buffer */
+	buf.p = buf.ptr = NULL;
+#if LWIP_CHECKSUM_ON_COPY
+	buf.flags = 0;
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+	if (to_in) {
+		inet_addr_to_ipaddr(&buf.addr, &to_in->sin_addr);
+		netbuf_fromport(&buf) = ntohs(to_in->sin_port);
+	} else {
+		ip_addr_set_any(&buf.addr);
+		netbuf_fromport(&buf) = 0;
+	}
+
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	/* Gather the buffers into a new netbuf */
+	if (netbuf_alloc(&buf, (u16_t)size) == NULL) {
+		err = ERR_MEM;
+	} else {
+		off = 0;
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			MEMCPY((u8_t *)buf.p->payload + off, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+			off += msg->msg_iov[i].iov_len;
+		}
+		err = ERR_OK;
+	}
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	/* Chain one PBUF_REF per non-empty buffer, the first one leaving room
+	   for the headers */
+	err = ERR_OK;
+	for (i = 0; i < msg->msg_iovlen && err == ERR_OK; i++) {
+		if (msg->msg_iov[i].iov_len == 0) {
+			continue;
+		}
+
+		p = pbuf_alloc(buf.p == NULL ? PBUF_TRANSPORT : PBUF_RAW, (u16_t)msg->msg_iov[i].iov_len, PBUF_REF);
+		if (p == NULL) {
+			err = ERR_MEM;
+		} else {
+			p->payload = msg->msg_iov[i].iov_base;
+			if (buf.p == NULL) {
+				buf.p = buf.ptr = p;
+			} else {
+				pbuf_cat(buf.p, p);
+			}
+		}
+	}
+
+	if (err == ERR_OK && buf.p == NULL) {
+		/* empty datagram */
+		err = netbuf_ref(&buf, NULL, 0);
+	}
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	if (err == ERR_OK) {
+		/* send the data */
+		err = netconn_send(sock->conn, &buf);
+	}
+
+	/* deallocated the buffer */
+	netbuf_free(&buf);
+	sock_set_errno(sock, err_to_errno(err));
+	return (err == ERR_OK ? (int)size : -1);
+#else							/* (LWIP_UDP || LWIP_RAW) */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* (LWIP_UDP || LWIP_RAW) */
+}
+
+/**
+ * Send the buffers described by msg->msg_iov as a single write, see
+ * lwip_sendmsg_sock().
+ */
+int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
+{
+	struct socket *sock;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	return lwip_sendmsg_sock(sock, s, msg, flags);
+}
+#endif							/* LWIP_SOCKET_SENDMSG */
+
+#if LWIP_SOCKET_MMSG
+/**
+ * Receive one datagram of a UDP or raw socket into the buffers described by
+ * msg->msg_iov. The datagram is taken from the netbuf left by a previous
+ * MSG_PEEK or fetched from the recvmbox of the netconn.
+ *
+ * @param sock the socket
+ * @param msg the buffers, returns the address of the sender in msg_name and
+ *        MSG_TRUNC in msg_flags if the datagram did not fit
+ * @param flags MSG_PEEK, MSG_DONTWAIT or 0
+ * @return the number of bytes received, or -1 with the socket errno set
+ */
+static int lwip_recvmsg_dgram(struct socket *sock, struct msghdr *msg, int flags)
+{
+	struct netbuf *buf;
+	struct pbuf *p;
+	u16_t off;
+	u16_t copylen;
+	size_t i;
+	err_t err;
+
+	if (sock->lastdata) {
+		buf = (struct netbuf *)sock->lastdata;
+	} else {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			sock_set_errno(sock, EWOULDBLOCK);
+			return -1;
+		}
+
+		err = netconn_recv(sock->conn, &buf);
+		if (err != ERR_OK) {
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+	}
+
+	/* scatter the datagram over the buffers */
+	p = buf->p;
+	off = 0;
+	for (i = 0; i < msg->msg_iovlen && off < p->tot_len; i++) {
+		copylen = (u16_t)LWIP_MIN(msg->msg_iov[i].iov_len, (size_t)(p->tot_len - off));
+		off += pbuf_copy_partial(p, msg->msg_iov[i].iov_base, copylen, off);
+	}
+	msg->msg_flags = (off < p->tot_len) ? MSG_TRUNC : 0;
+	msg->msg_controllen = 0;
+
+	if (msg->msg_name != NULL && msg->msg_namelen > 0) {
+		struct sockaddr_in sin;
+
+		memset(&sin, 0, sizeof(sin));
+		sin.sin_len = sizeof(sin);
+		sin.sin_family = AF_INET;
+		sin.sin_port = htons(netbuf_fromport(buf));
+		inet_addr_from_ipaddr(&sin.sin_addr, netbuf_fromaddr(buf));
+
+		if (msg->msg_namelen > (int)sizeof(sin)) {
+			msg->msg_namelen = sizeof(sin);
+		}
+		MEMCPY(msg->msg_name, &sin, msg->msg_namelen);
+	}
+
+	if ((flags & MSG_PEEK) == 0) {
+		sock->lastdata = NULL;
+		sock->lastoffset = 0;
+		netbuf_delete(buf);
+	} else {
+		sock->lastdata = buf;
+	}
+
+	return off;
+}
+
+/**
+ * Receive up to vlen datagrams with a single call. Only the first one waits
+ * for data if MSG_WAITFORONE is given; the following ones are taken from
+ * what is already queued on the socket. The socket is looked up once and
+ * every datagram comes straight from the recvmbox of the netconn, without
+ * going through tcpip_thread.
+ *
+ * @param s the socket, UDP or raw
+ * @param msgvec the messages, msg_len returns the size of each datagram
+ * @param vlen the number of messages in msgvec
+ * @param flags MSG_WAITFORONE, MSG_DONTWAIT, MSG_PEEK or 0
+ * @param timeout if not NULL, no more datagrams are received once this much
+ *        time has passed; checked after each datagram
+ * @return the number of datagrams received, or -1 on error
+ */
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	struct socket *sock;
+	unsigned int i;
+	u32_t start = 0;
+	u32_t tmo = 0;
+	int len;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d, %p, %u, 0x%x)\n", s, (void *)msgvec, vlen, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (netconn_type(sock->conn) == NETCONN_TCP) {
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+
+	if (msgvec == NULL && vlen != 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	if (timeout != NULL) {
+		tmo = timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000;
+		start = sys_now();
+	}
+
+	for (i = 0; i < vlen; i++) {
+		len = lwip_recvmsg_dgram(sock, &msgvec[i].msg_hdr, flags);
+		if (len < 0) {
+			if (i > 0) {
+				/* report the datagrams already received, the error shows
+				   again on the next call */
+				break;
+			}
+			return -1;
+		}
+		msgvec[i].msg_len = len;
+
+		if ((flags & MSG_PEEK) != 0) {
+			/* the same datagram would be returned again */
+			i++;
+			break;
+		}
+		if ((flags & MSG_WAITFORONE) != 0) {
+			flags |= MSG_DONTWAIT;
+		}
+		if (timeout != NULL && (u32_t)(sys_now() - start) >= tmo) {
+			i++;
+			break;
+		}
+	}
+
+	sock_set_errno(sock, 0);
+	return (int)i;
+}
+
+/**
+ * Send up to vlen messages with a single call, each one as lwip_sendmsg()
+ * would. The socket is looked up once for all of them.
+ *
+ * @param s the socket
+ * @param msgvec the messages, msg_len returns the bytes sent for each
+ * @param vlen the number of messages in msgvec
+ * @param flags MSG_MORE, MSG_DONTWAIT or 0, applied to every message
+ * @return the number of messages sent, or -1 if the first one failed
+ */
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	struct socket *sock;
+	unsigned int i;
+	int len;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_sendmmsg(%d, %p, %u, 0x%x)\n", s, (void *)msgvec, vlen, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (msgvec == NULL && vlen != 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		len = lwip_sendmsg_sock(sock, s, &msgvec[i].msg_hdr, flags);
+		if (len < 0) {
+			if (i > 0) {
+				break;
+			}
+			return -1;
+		}
+		msgvec[i].msg_len = len;
+	}
+
+	sock_set_errno(sock, 0);
+	return (int)i;
+}
+#endif							/* LWIP_SOCKET_MMSG */
+
 int argument_validation(int domain, int type, int protocol)
 {
 	if (domain == AF_AX25 || domain == AF_X25) {
@@ -1509,6 +2034,48 @@ static int lwip_poll_teardown(int fd, struct socket * sock, struct pollfd * fds)
 	return 0;
 }
 
+#ifdef CONFIG_EPOLL
+/* An epoll registration stays on the list of the socket until it is torn
+ * down, and event_callback() reports new events to it directly instead of
+ * going through select_cb_list.
+ */
+
+static int lwip_epoll_setup(int fd, struct socket *sock, struct pollfd *fds)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	fds->flink = sock->epoll_fds;
+	sock->epoll_fds = fds;
+	SYS_ARCH_UNPROTECT(lev);
+
+	/* Report the events that are already in effect */
+	if (lwip_poll_scan(fd, sock, fds) > 0) {
+		fds->notify(fds);
+	}
+
+	return 0;
+}
+
+static int lwip_epoll_teardown(int fd, struct socket *sock, struct pollfd *fds)
+{
+	struct pollfd **prev;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	for (prev = &sock->epoll_fds; *prev != NULL; prev = &(*prev)->flink) {
+		if (*prev == fds) {
+			*prev = fds->flink;
+			break;
+		}
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	fds->flink = NULL;
+	return 0;
+}
+#endif							/* CONFIG_EPOLL */
+
 /****************************************************************************
  * Function: lwip_poll
  *
@@ -1541,6 +2108,12 @@ int lwip_poll(int fd, struct pollfd * fds, bool setup)
 		return -EBADF;
 	}
 
+#ifdef CONFIG_EPOLL
+	if (fds->notify != NULL) {
+		return setup ? lwip_epoll_setup(fd, sock, fds) : lwip_epoll_teardown(fd, sock, fds);
+	}
+#endif
+
 	/* Check if we are setting up or tearing down the poll */
 
 	if (setup) {
@@ -1626,6 +2199,31 @@ static void event_callback(struct netconn * conn, enum netconn_evt evt, u16_t le
 		break;
 	}
 
+#ifdef CONFIG_EPOLL
+	/* Report new events to the epoll registrations of this socket */
+	if (evt == NETCONN_EVT_RCVPLUS || evt == NETCONN_EVT_SENDPLUS || evt == NETCONN_EVT_ERROR) {
+		struct pollfd *fds;
+		pollevent_t revents;
+
+		for (fds = sock->epoll_fds; fds != NULL; fds = fds->flink) {
+			revents = 0;
+			if ((fds->events & POLLIN) && (sock->lastdata != NULL || sock->rcvevent > 0)) {
+				revents |= POLLIN;
+			}
+			if ((fds->events & POLLOUT) && sock->sendevent != 0) {
+				revents |= POLLOUT;
+			}
+			if ((fds->events & POLLERR) && sock->errevent != 0) {
+				revents |= POLLERR;
+			}
+			if (revents != 0) {
+				fds->revents |= revents;
+				fds->notify(fds);
+			}
+		}
+	}
+#endif
+
 	if (sock->select_waiting == 0) {
 		/* none is waiting for this socket, no need to check select_cb_list */
 		SYS_ARCH_UNPROTECT(lev);
@@ -1822,7 +2420,9 @@ int lwip_getsockopt(int s, int level, int optname, void * optval, socklen_t * op
 		case SO_RCVBUF:
 #endif							/* LWIP_SO_RCVBUF */
 			/* UNIMPL case SO_OOBINLINE: */
-			/* UNIMPL case SO_SNDBUF: */
+#if LWIP_SO_SNDBUF
+		case SO_SNDBUF:
+#endif							/* LWIP_SO_SNDBUF */
 			/* UNIMPL case SO_RCVLOWAT: */
 			/* UNIMPL case SO_SNDLOWAT: */
 #if SO_REUSE
@@ -1978,8 +2578,14 @@ int lwip_getsockopt(int s, int level, int optname, void * optval, socklen_t * op
 	data.optval = optval;
 	data.optlen = optlen;
 	data.err = err;
+#if LWIP_TCPIP_CORE_LOCKING
+	LOCK_TCPIP_CORE();
+	lwip_getsockopt_internal(&data);
+	UNLOCK_TCPIP_CORE();
+#else
 	tcpip_callback(lwip_getsockopt_internal, &data);
 	sys_arch_sem_wait(&sock->conn->op_completed, 0);
+#endif
 	/* maybe lwip_getsockopt_internal has changed err */
 	err = data.err;
 
@@ -2023,7 +2629,7 @@ static void lwip_getsockopt_internal(void * arg)
 		case SO_REUSEPORT:
 #endif							/* SO_REUSE */
 			/*case SO_USELOOPBACK: UNIMPL */
-			*(int *)optval = ip_get_option(sock->conn->pcb.ip, _SO_BIT(optname));
+			*(int *)optval = ip_get_option(sock->conn->pcb.ip, optname == SO_REUSEPORT ? SOF_REUSEPORT : _SO_BIT(optname));
 			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_getsockopt(%d, SOL_SOCKET, optname=0x%x, ..) = %s\n", data->s, optname, (*(int *)optval ? "on" : "off")));
 			break;
 
@@ -2074,6 +2680,11 @@ static void lwip_getsockopt_internal(void * arg)
 			*(int *)optval = netconn_get_recvbufsize(sock->conn);
 			break;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_SO_SNDBUF
+		case SO_SNDBUF:
+			*(int *)optval = netconn_get_sendbufsize(sock->conn);
+			break;
+#endif							/* LWIP_SO_SNDBUF */
 #if LWIP_UDP
 		case SO_NO_CHECK:
 			*(int *)optval = (udp_flags(sock->conn->pcb.udp) & UDP_FLAGS_NOCHKSUM) ? 1 : 0;
@@ -2175,7 +2786,9 @@ static void lwip_getsockopt_internal(void * arg)
 		LWIP_ASSERT("unhandled level", 0);
 		break;
 	}							/* switch (level) */
+#if !LWIP_TCPIP_CORE_LOCKING
 	sys_sem_signal(&sock->conn->op_completed);
+#endif
 }
 
 int lwip_setsockopt(int s, int level, int optname, const void * optval, socklen_t optlen)
@@ -2209,7 +2822,9 @@ int lwip_setsockopt(int s, int level, int optname, const void * optval, socklen_
 		case SO_RCVBUF:
 #endif							/* LWIP_SO_RCVBUF */
 			/* UNIMPL case SO_OOBINLINE: */
-			/* UNIMPL case SO_SNDBUF: */
+#if LWIP_SO_SNDBUF
+		case SO_SNDBUF:
+#endif							/* LWIP_SO_SNDBUF */
 			/* UNIMPL case SO_RCVLOWAT: */
 			/* UNIMPL case SO_SNDLOWAT: */
 #if SO_REUSE
@@ -2376,8 +2991,14 @@ int lwip_setsockopt(int s, int level, int optname, const void * optval, socklen_
 	data.optval = (void *)optval;
 	data.optlen = &optlen;
 	data.err = err;
+#if LWIP_TCPIP_CORE_LOCKING
+	LOCK_TCPIP_CORE();
+	lwip_setsockopt_internal(&data);
+	UNLOCK_TCPIP_CORE();
+#else
 	tcpip_callback(lwip_setsockopt_internal, &data);
 	sys_arch_sem_wait(&sock->conn->op_completed, 0);
+#endif
 	/* maybe lwip_setsockopt_internal has changed err */
 	err = data.err;
 
@@ -2422,9 +3043,9 @@ static void lwip_setsockopt_internal(void * arg)
 #endif							/* SO_REUSE */
 			/* UNIMPL case SO_USELOOPBACK: */
 			if (*(int *)optval) {
-				ip_set_option(sock->conn->pcb.ip, _SO_BIT(optname));
+				ip_set_option(sock->conn->pcb.ip, optname == SO_REUSEPORT ? SOF_REUSEPORT : _SO_BIT(optname));
 			} else {
-				ip_reset_option(sock->conn->pcb.ip, _SO_BIT(optname));
+				ip_reset_option(sock->conn->pcb.ip, optname == SO_REUSEPORT ? SOF_REUSEPORT : _SO_BIT(optname));
 			}
 			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_setsockopt(%d, SOL_SOCKET, optname=0x%x, ..) -> %s\n", data->s, optname, (*(int *)optval ? "on" : "off")));
 			break;
@@ -2449,6 +3070,13 @@ static void lwip_setsockopt_internal(void * arg)
 			netconn_set_recvbufsize(sock->conn, *(int *)optval);
 			break;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_SO_SNDBUF
+		case SO_SNDBUF:
+			/* At least one segment so that writes make progress, at most
+			   what the TCP send queue holds. Only TCP queues data. */
+			netconn_set_sendbufsize(sock->conn, LWIP_MIN(LWIP_MAX(*(int *)optval, TCP_MSS), TCP_SND_BUF));
+			break;
+#endif							/* LWIP_SO_SNDBUF */
 #if LWIP_UDP
 		case SO_NO_CHECK:
 			if (*(int *)optval) {
@@ -2585,7 +3213,9 @@ static void lwip_setsockopt_internal(void * arg)
 		LWIP_ASSERT("unhandled level", 0);
 		break;
 	}							/* switch (level) */
+#if !LWIP_TCPIP_CORE_LOCKING
 	sys_sem_signal(&sock->conn->op_completed);
+#endif
 }
 
 int lwip_ioctl(int s, long cmd, void * argp)
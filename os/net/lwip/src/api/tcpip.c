@@ -67,16 +67,51 @@
 #include <net/lwip/init.h>
 #include <net/lwip/netif/etharp.h>
 #include <net/lwip/netif/ppp_oe.h>
+#include <tinyara/net/netperf.h>
+#include <tinyara/net/netmem.h>
 
 /* global variables */
 static tcpip_init_done_fn tcpip_init_done;
 static void *tcpip_init_done_arg;
 static sys_mbox_t mbox;
 
-#if LWIP_TCPIP_CORE_LOCKING
-/** The global semaphore to lock the stack. */
-sys_mutex_t lock_tcpip_core;
-#endif							/* LWIP_TCPIP_CORE_LOCKING */
+/**
+ * Pass a received packet to ethernet_input() or ip_input(), depending on the
+ * type of the interface.
+ *
+ * @param p the received packet
+ * @param inp the network interface on which the packet was received
+ */
+static err_t tcpip_inpkt(struct pbuf *p, struct netif *inp)
+{
+#if LWIP_ETHERNET
+	if (inp->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+		return ethernet_input(p, inp);
+	}
+#endif							/* LWIP_ETHERNET */
+	return ip_input(p, inp);
+}
+
+/**
+ * Input the packets of a list passed to tcpip_input_list().
+ *
+ * @param p the first packet of the list
+ * @param inp the network interface on which the packets were received
+ */
+static void tcpip_inpkt_list(struct pbuf *p, struct netif *inp)
+{
+	struct pbuf *last;
+	struct pbuf *next;
+
+	while (p != NULL) {
+		/* the last pbuf of a packet is linked to the next packet */
+		for (last = p; last->len != last->tot_len && last->next != NULL; last = last->next) ;
+		next = last->next;
+		last->next = NULL;
+		tcpip_inpkt(p, inp);
+		p = next;
+	}
+}
 
 /**
  * The main lwIP thread. This thread has exclusive access to lwIP core functions
@@ -125,14 +160,19 @@ static void tcpip_thread(void *arg)
 #if !LWIP_TCPIP_CORE_LOCKING_INPUT
 		case TCPIP_MSG_INPKT:
 			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET %p\n", (void *)msg));
-#if LWIP_ETHERNET
-			if (msg->msg.inp.netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
-				ethernet_input(msg->msg.inp.p, msg->msg.inp.netif);
-			} else
-#endif							/* LWIP_ETHERNET */
-			{
-				ip_input(msg->msg.inp.p, msg->msg.inp.netif);
-			}
+#ifdef CONFIG_NET_PERF_STATS
+			netperf_end(NETPERF_TCPIP_WAIT, msg->msg.inp.stamp);
+#endif
+			tcpip_inpkt(msg->msg.inp.p, msg->msg.inp.netif);
+			memp_free(MEMP_TCPIP_MSG_INPKT, msg);
+			break;
+
+		case TCPIP_MSG_INPKT_LIST:
+			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET LIST %p\n", (void *)msg));
+#ifdef CONFIG_NET_PERF_STATS
+			netperf_end(NETPERF_TCPIP_WAIT, msg->msg.inp.stamp);
+#endif
+			tcpip_inpkt_list(msg->msg.inp.p, msg->msg.inp.netif);
 			memp_free(MEMP_TCPIP_MSG_INPKT, msg);
 			break;
 #endif							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
@@ -211,14 +251,19 @@ err_t tcpip_input(struct pbuf *p, struct netif *inp)
 	//LWIP_DEBUGF(TCPIP_DEBUG, ("Succesfull Validation mbox"));
 	msg = (struct tcpip_msg *)memp_malloc(MEMP_TCPIP_MSG_INPKT);
 	if (msg == NULL) {
+		netmem_drop(NETMEM_DROP_TCPIP_MBOX);
 		return ERR_MEM;
 	}
 
 	msg->type = TCPIP_MSG_INPKT;
 	msg->msg.inp.p = p;
 	msg->msg.inp.netif = inp;
+#ifdef CONFIG_NET_PERF_STATS
+	msg->msg.inp.stamp = netperf_begin();
+#endif
 	//LWIP_DEBUGF(TCPIP_DEBUG, ("posting msg to mbox"));
 	if (sys_mbox_trypost(&mbox, msg) != ERR_OK) {
+		netmem_drop(NETMEM_DROP_TCPIP_MBOX);
 		memp_free(MEMP_TCPIP_MSG_INPKT, msg);
 		return ERR_MEM;
 	}
@@ -227,6 +272,51 @@ err_t tcpip_input(struct pbuf *p, struct netif *inp)
 #endif							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
 }
 
+/**
+ * Pass several received packets to tcpip_thread with a single message.
+ * The packets are linked like on the loopback list: the last pbuf of a
+ * packet (the one with len == tot_len) is linked to the first pbuf of the
+ * next packet.
+ *
+ * @param p the first packet of the list
+ * @param inp the network interface on which all the packets were received
+ * @return ERR_OK if the packets were queued, otherwise the caller must free
+ *         them (pbuf_free(p) frees the whole list)
+ */
+err_t tcpip_input_list(struct pbuf *p, struct netif *inp)
+{
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+	LOCK_TCPIP_CORE();
+	tcpip_inpkt_list(p, inp);
+	UNLOCK_TCPIP_CORE();
+	return ERR_OK;
+#else							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
+	struct tcpip_msg *msg;
+
+	if (!sys_mbox_valid(&mbox)) {
+		return ERR_VAL;
+	}
+	msg = (struct tcpip_msg *)memp_malloc(MEMP_TCPIP_MSG_INPKT);
+	if (msg == NULL) {
+		netmem_drop(NETMEM_DROP_TCPIP_MBOX);
+		return ERR_MEM;
+	}
+
+	msg->type = TCPIP_MSG_INPKT_LIST;
+	msg->msg.inp.p = p;
+	msg->msg.inp.netif = inp;
+#ifdef CONFIG_NET_PERF_STATS
+	msg->msg.inp.stamp = netperf_begin();
+#endif
+	if (sys_mbox_trypost(&mbox, msg) != ERR_OK) {
+		netmem_drop(NETMEM_DROP_TCPIP_MBOX);
+		memp_free(MEMP_TCPIP_MSG_INPKT, msg);
+		return ERR_MEM;
+	}
+	return ERR_OK;
+#endif							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
+}
+
 /**
  * Call a specific function in the thread context of
  * tcpip_thread for easy access synchronization.
@@ -487,11 +577,6 @@ void tcpip_init(tcpip_init_done_fn initfunc, void *arg)
 		LWIP_ASSERT("failed to create tcpip_thread mbox", 0);
 	}
 	//LWIP_DEBUGF(TCPIP_DEBUG, ("mbox created"));
-#if LWIP_TCPIP_CORE_LOCKING
-	if (sys_mutex_new(&lock_tcpip_core) != ERR_OK) {
-		LWIP_ASSERT("failed to create lock_tcpip_core", 0);
-	}
-#endif							/* LWIP_TCPIP_CORE_LOCKING */
 	//LWIP_DEBUGF(TCPIP_DEBUG, ("creating new thread for tcpip"));
 	sys_kernel_thread_new(TCPIP_THREAD_NAME, tcpip_thread, NULL, TCPIP_THREAD_STACKSIZE, TCPIP_THREAD_PRIO);
 	//LWIP_DEBUGF(TCPIP_DEBUG, ("Exit"));
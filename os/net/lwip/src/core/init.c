@@ -125,9 +125,24 @@
 #error "MEMP_NUM_REASSDATA > IP_REASS_MAX_PBUFS doesn't make sense since each struct ip_reassdata must hold 2 pbufs at least!"
 #endif
 #endif							/* !MEMP_MEM_MALLOC */
+#if !LWIP_WND_SCALE
 #if (LWIP_TCP && (TCP_WND > 0xffff))
 #error "If you want to use TCP, TCP_WND must fit in an u16_t, so, you have to reduce it in your lwipopts.h"
 #endif
+#else							/* !LWIP_WND_SCALE */
+#if (LWIP_TCP && (TCP_RCV_SCALE > 14))
+#error "TCP_RCV_SCALE must not exceed 14 (RFC 7323)"
+#endif
+#if (LWIP_TCP && (TCP_WND > (0xffffUL << TCP_RCV_SCALE)))
+#error "TCP_WND is bigger than TCP_RCV_SCALE allows to advertise, increase TCP_RCV_SCALE"
+#endif
+#endif							/* !LWIP_WND_SCALE */
+#if (LWIP_TCP_RACK && !LWIP_TCP_SACK)
+#error "LWIP_TCP_RACK needs LWIP_TCP_SACK"
+#endif
+#if (LWIP_SOCKET_MMSG && !LWIP_SOCKET_SENDMSG)
+#error "LWIP_SOCKET_MMSG needs LWIP_SOCKET_SENDMSG"
+#endif
 #if (LWIP_TCP && (TCP_SND_QUEUELEN > 0xffff))
 #error "If you want to use TCP, TCP_SND_QUEUELEN must fit in an u16_t, so, you have to reduce it in your lwipopts.h"
 #endif
@@ -176,6 +191,12 @@
 #if (PBUF_POOL_BUFSIZE <= MEM_ALIGNMENT)
 #error "PBUF_POOL_BUFSIZE must be greater than MEM_ALIGNMENT or the offset may take the full first pbuf"
 #endif
+#if LWIP_PBUF_POOL_CLASSES && ((PBUF_POOL_SMALL_BUFSIZE >= PBUF_POOL_MEDIUM_BUFSIZE) || (PBUF_POOL_MEDIUM_BUFSIZE >= PBUF_POOL_BUFSIZE))
+#error "LWIP_PBUF_POOL_CLASSES needs PBUF_POOL_SMALL_BUFSIZE < PBUF_POOL_MEDIUM_BUFSIZE < PBUF_POOL_BUFSIZE"
+#endif
+#if LWIP_PBUF_POOL_CLASSES && (((PBUF_POOL_ALIGNMENT & (PBUF_POOL_ALIGNMENT - 1)) != 0) || ((PBUF_POOL_ALIGNMENT % MEM_ALIGNMENT) != 0))
+#error "PBUF_POOL_ALIGNMENT must be a power of 2 and a multiple of MEM_ALIGNMENT"
+#endif
 #if PPP_SUPPORT && !PPPOS_SUPPORT & !PPPOE_SUPPORT
 #error "PPP_SUPPORT needs either PPPOS_SUPPORT or PPPOE_SUPPORT turned on"
 #endif
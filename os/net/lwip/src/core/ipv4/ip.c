@@ -72,6 +72,7 @@
 #include <net/lwip/ipv4/autoip.h>
 #include <net/lwip/stats.h>
 #include <net/lwip/arch/perf.h>
+#include <tinyara/net/netperf.h>
 
 #include <string.h>
 
@@ -571,7 +572,11 @@ err_t ip_input(struct pbuf *p, struct netif *inp)
 #if LWIP_TCP
 		case IP_PROTO_TCP:
 			snmp_inc_ipindelivers();
-			tcp_input(p, inp);
+			{
+				u32_t start = netperf_begin();
+				tcp_input(p, inp);
+				netperf_end(NETPERF_TCP_INPUT, start);
+			}
 			break;
 #endif							/* LWIP_TCP */
 #if LWIP_ICMP
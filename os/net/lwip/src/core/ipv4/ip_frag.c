@@ -71,19 +71,16 @@
  * The IP reassembly code currently has the following limitations:
  * - IP header options are not supported
  * - fragments must not overlap (e.g. due to different routes),
- *   currently, overlapping or duplicate fragments are thrown away
- *   if IP_REASS_CHECK_OVERLAP=1 (the default)!
+ *   currently, overlapping or duplicate fragments are thrown away!
+ *
+ * Fragments are kept sorted by offset with a pointer to the one with the
+ * highest offset, so in-order fragments are appended without walking the
+ * list. Since fragments never overlap, a datagram is complete once the last
+ * fragment arrived and the received payload bytes add up to its length.
  *
  * @todo: work with IP header options
  */
 
-/** Setting this to 0, you can turn off checking the fragments for overlapping
- * regions. The code gets a little smaller. Only use this if you know that
- * overlapping won't occur on your network! */
-#ifndef IP_REASS_CHECK_OVERLAP
-#define IP_REASS_CHECK_OVERLAP 1
-#endif							/* IP_REASS_CHECK_OVERLAP */
-
 /** Set to 0 to prevent freeing the oldest datagram when the reassembly buffer is
  * full (IP_REASS_MAX_PBUFS pbufs are enqueued). The code gets a little smaller.
  * Datagrams will be freed by timeout only. Especially useful when MEMP_NUM_REASSDATA
@@ -333,19 +330,19 @@ static void ip_reass_dequeue_datagram(struct ip_reassdata *ipr, struct ip_reassd
 /**
  * Chain a new pbuf into the pbuf list that composes the datagram.  The pbuf list
  * will grow over time as  new pbufs are rx.
- * Also checks that the datagram passes basic continuity checks (if the last
- * fragment was received at least once).
- * @param root_p points to the 'root' pbuf for the current datagram being assembled.
+ * Also checks whether the datagram is complete (if the last fragment was
+ * received at least once).
+ * @param ipr points to the datagram being assembled.
  * @param new_p points to the pbuf for the current fragment
+ * @param clen number of pbufs in new_p
  * @return 0 if invalid, >0 otherwise
  */
-static int ip_reass_chain_frag_into_datagram_and_validate(struct ip_reassdata *ipr, struct pbuf *new_p)
+static int ip_reass_chain_frag_into_datagram_and_validate(struct ip_reassdata *ipr, struct pbuf *new_p, u8_t clen)
 {
-	struct ip_reass_helper *iprh, *iprh_tmp, *iprh_prev = NULL;
+	struct ip_reass_helper *iprh, *iprh_tmp = NULL, *iprh_prev = NULL;
 	struct pbuf *q;
 	u16_t offset, len;
 	struct ip_hdr *fraghdr;
-	int valid = 1;
 
 	/* Extract length and fragment offset from current fragment */
 	fraghdr = (struct ip_hdr *)new_p->payload;
@@ -361,117 +358,87 @@ static int ip_reass_chain_frag_into_datagram_and_validate(struct ip_reassdata *i
 	iprh->start = offset;
 	iprh->end = offset + len;
 
-	/* Iterate through until we either get to the end of the list (append),
-	 * or we find on with a larger offset (insert). */
-	for (q = ipr->p; q != NULL;) {
-		iprh_tmp = (struct ip_reass_helper *)q->payload;
-		if (iprh->start < iprh_tmp->start) {
-			/* the new pbuf should be inserted before this */
-			iprh->next_pbuf = q;
-			if (iprh_prev != NULL) {
-				/* not the fragment with the lowest offset */
-#if IP_REASS_CHECK_OVERLAP
-				if ((iprh->start < iprh_prev->end) || (iprh->end > iprh_tmp->start)) {
-					/* fragment overlaps with previous or following, throw away */
-					goto freepbuf;
-				}
-#endif							/* IP_REASS_CHECK_OVERLAP */
-				iprh_prev->next_pbuf = new_p;
-			} else {
-				/* fragment with the lowest offset */
-				ipr->p = new_p;
+	if ((ipr->p_last != NULL) && (iprh->start >= ((struct ip_reass_helper *)ipr->p_last->payload)->end)) {
+		/* the usual in-order case: this is the fragment with the highest
+		 * offset, chain it to the last fragment */
+		((struct ip_reass_helper *)ipr->p_last->payload)->next_pbuf = new_p;
+		ipr->p_last = new_p;
+	} else {
+		/* Iterate through until we either get to the end of the list, or we
+		 * find one with a larger offset (insert). */
+		for (q = ipr->p; q != NULL; q = iprh_tmp->next_pbuf) {
+			iprh_tmp = (struct ip_reass_helper *)q->payload;
+			if (iprh->start < iprh_tmp->start) {
+				break;
 			}
-			break;
-		} else if (iprh->start == iprh_tmp->start) {
-			/* received the same datagram twice: no need to keep the datagram */
+			iprh_prev = iprh_tmp;
+		}
+
+		/* duplicate or overlapping fragments are thrown away */
+		if ((iprh_prev != NULL) && (iprh->start < iprh_prev->end)) {
 			goto freepbuf;
-#if IP_REASS_CHECK_OVERLAP
-		} else if (iprh->start < iprh_tmp->end) {
-			/* overlap: no need to keep the new datagram */
+		}
+		if ((q != NULL) && (iprh->end > iprh_tmp->start)) {
 			goto freepbuf;
-#endif							/* IP_REASS_CHECK_OVERLAP */
-		} else {
-			/* Check if the fragments received so far have no wholes. */
-			if (iprh_prev != NULL) {
-				if (iprh_prev->end != iprh_tmp->start) {
-					/* There is a fragment missing between the current
-					 * and the previous fragment */
-					valid = 0;
-				}
-			}
 		}
-		q = iprh_tmp->next_pbuf;
-		iprh_prev = iprh_tmp;
-	}
 
-	/* If q is NULL, then we made it to the end of the list. Determine what to do now */
-	if (q == NULL) {
+		iprh->next_pbuf = q;
 		if (iprh_prev != NULL) {
-			/* this is (for now), the fragment with the highest offset:
-			 * chain it to the last fragment */
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("check fragments don't overlap", iprh_prev->end <= iprh->start);
-#endif							/* IP_REASS_CHECK_OVERLAP */
 			iprh_prev->next_pbuf = new_p;
-			if (iprh_prev->end != iprh->start) {
-				valid = 0;
-			}
 		} else {
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("no previous fragment, this must be the first fragment!", ipr->p == NULL);
-#endif							/* IP_REASS_CHECK_OVERLAP */
-			/* this is the first fragment we ever received for this ip datagram */
+			/* fragment with the lowest offset */
 			ipr->p = new_p;
 		}
+		if (q == NULL) {
+			/* this is the first fragment we ever received for this ip datagram */
+			LWIP_ASSERT("no fragment behind the last one", ipr->p_last == NULL);
+			ipr->p_last = new_p;
+		}
 	}
 
-	/* At this point, the validation part begins: */
-	/* If we already received the last fragment */
+	ipr->recv_len += len;
+	ipr->pbufs += clen;
+
+	/* The datagram is complete if the last fragment was received, nothing
+	 * lies beyond it and, as fragments don't overlap, the received bytes
+	 * cover the whole datagram. Otherwise there are still holes, such
+	 * datagrams simply time out if no more fragments are received... */
 	if ((ipr->flags & IP_REASS_FLAG_LASTFRAG) != 0) {
-		/* and had no wholes so far */
-		if (valid) {
-			/* then check if the rest of the fragments is here */
-			/* Check if the queue starts with the first datagram */
-			if ((ipr->p == NULL) || (((struct ip_reass_helper*)ipr->p->payload)->start != 0)) {
-				valid = 0;
-			} else {
-				/* and check that there are no wholes after this datagram */
-				iprh_prev = iprh;
-				q = iprh->next_pbuf;
-				while (q != NULL) {
-					iprh = (struct ip_reass_helper *)q->payload;
-					if (iprh_prev->end != iprh->start) {
-						valid = 0;
-						break;
-					}
-					iprh_prev = iprh;
-					q = iprh->next_pbuf;
-				}
-				/* if still valid, all fragments are received
-				 * (because to the MF==0 already arrived */
-				if (valid) {
-					LWIP_ASSERT("sanity check", ipr->p != NULL);
-					LWIP_ASSERT("sanity check", ((struct ip_reass_helper *)ipr->p->payload) != iprh);
-					LWIP_ASSERT("validate_datagram:next_pbuf!=NULL", iprh->next_pbuf == NULL);
-					LWIP_ASSERT("validate_datagram:datagram end!=datagram len", iprh->end == ipr->datagram_len);
-				}
-			}
+		if ((((struct ip_reass_helper *)ipr->p_last->payload)->end == ipr->datagram_len) && (ipr->recv_len == ipr->datagram_len)) {
+			LWIP_ASSERT("sanity check", ((struct ip_reass_helper *)ipr->p->payload)->start == 0);
+			return 1;
 		}
-		/* If valid is 0 here, there are some fragments missing in the middle
-		 * (since MF == 0 has already arrived). Such datagrams simply time out if
-		 * no more fragments are received... */
-		return valid;
 	}
 	/* If we come here, not all fragments were received, yet! */
 	return 0;					/* not yet valid! */
-#if IP_REASS_CHECK_OVERLAP
+
 freepbuf:
-	ip_reass_pbufcount -= pbuf_clen(new_p);
+	ip_reass_pbufcount -= clen;
 	pbuf_free(new_p);
 	return 0;
-#endif							/* IP_REASS_CHECK_OVERLAP */
 }
 
+#if IP_REASS_MAX_PBUFS_PER_SRC < IP_REASS_MAX_PBUFS
+/**
+ * Count the pbufs enqueued for datagrams from the source of a fragment.
+ *
+ * @param fraghdr IP header of the current fragment
+ * @return the number of pbufs enqueued for its source address
+ */
+static u16_t ip_reass_src_pbufcount(struct ip_hdr *fraghdr)
+{
+	struct ip_reassdata *r;
+	u16_t count = 0;
+
+	for (r = reassdatagrams; r != NULL; r = r->next) {
+		if (ip_addr_cmp(&r->iphdr.src, &fraghdr->src)) {
+			count += r->pbufs;
+		}
+	}
+	return count;
+}
+#endif							/* IP_REASS_MAX_PBUFS_PER_SRC < IP_REASS_MAX_PBUFS */
+
 /**
  * Reassembles incoming IP fragments into an IP datagram.
  *
@@ -517,6 +484,15 @@ struct pbuf *ip_reass(struct pbuf *p)
 		}
 	}
 
+#if IP_REASS_MAX_PBUFS_PER_SRC < IP_REASS_MAX_PBUFS
+	/* Check if this source is allowed to enqueue more fragments. */
+	if ((ip_reass_src_pbufcount(fraghdr) + clen) > IP_REASS_MAX_PBUFS_PER_SRC) {
+		LWIP_DEBUGF(IP_REASS_DEBUG, ("ip_reass: Source over its limit: clen=%d, MAX=%d\n", clen, IP_REASS_MAX_PBUFS_PER_SRC));
+		IPFRAG_STATS_INC(ip_frag.memerr);
+		goto nullreturn;
+	}
+#endif							/* IP_REASS_MAX_PBUFS_PER_SRC < IP_REASS_MAX_PBUFS */
+
 	/* Look for the datagram the fragment belongs to in the current datagram queue,
 	 * remembering the previous in the queue for later dequeueing. */
 	for (ipr = reassdatagrams; ipr != NULL; ipr = ipr->next) {
@@ -561,8 +537,9 @@ struct pbuf *ip_reass(struct pbuf *p)
 	}
 	/* find the right place to insert this pbuf */
 	/* @todo: trim pbufs if fragments are overlapping */
-	if (ip_reass_chain_frag_into_datagram_and_validate(ipr, p)) {
+	if (ip_reass_chain_frag_into_datagram_and_validate(ipr, p, clen)) {
 		struct ip_reassdata *ipr_prev;
+		u16_t pbufs = ipr->pbufs;
 		/* the totally last fragment (flag more fragments = 0) was received at least
 		 * once AND all fragments are received */
 		ipr->datagram_len += IP_HLEN;
@@ -581,7 +558,8 @@ struct pbuf *ip_reass(struct pbuf *p)
 
 		p = ipr->p;
 
-		/* chain together the pbufs contained within the reass_data list. */
+		/* chain together the pbufs contained within the reass_data list; the
+		 * fragments are referenced as they are, no payload is copied. */
 		while (r != NULL) {
 			iprh = (struct ip_reass_helper *)r->payload;
 
@@ -603,7 +581,7 @@ struct pbuf *ip_reass(struct pbuf *p)
 		ip_reass_dequeue_datagram(ipr, ipr_prev);
 
 		/* and adjust the number of pbufs currently queued for reassembly. */
-		ip_reass_pbufcount -= pbuf_clen(p);
+		ip_reass_pbufcount -= pbufs;
 
 		/* Return the pbuf chain */
 		return p;
@@ -68,6 +68,7 @@
 #include <net/lwip/stats.h>
 
 #include <net/lwip/arch/perf.h>
+#include <tinyara/net/netperf.h>
 
 /* ip_init:
  *
@@ -232,9 +233,12 @@ void ip_input(struct pbuf *p, struct netif *inp)
 	case IP_PROTO_UDP:
 		udp_input(p, inp);
 		break;
-	case IP_PROTO_TCP:
+	case IP_PROTO_TCP: {
+		u32_t start = netperf_begin();
 		tcp_input(p, inp);
+		netperf_end(NETPERF_TCP_INPUT, start);
 		break;
+	}
 #if LWIP_ICMP
 	case IP_PROTO_ICMP:
 		icmp_input(p, inp);
@@ -96,13 +96,23 @@
 
 #include <string.h>
 
+#include <tinyara/net/netmem.h>
+
 #define SIZEOF_STRUCT_PBUF        LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf))
 /* Since the pool is created in memp, PBUF_POOL_BUFSIZE will be automatically
    aligned there. Therefore, PBUF_POOL_BUFSIZE_ALIGNED can be used here. */
 #define PBUF_POOL_BUFSIZE_ALIGNED LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE)
 
+#if LWIP_PBUF_POOL_CLASSES
+/* The buffer of a small or medium pbuf starts on the first PBUF_POOL_ALIGNMENT
+   boundary after the pbuf header. The pools reserve PBUF_POOL_ALIGNMENT bytes
+   more than the buffer size for this. */
+#define PBUF_POOL_CLASS_BUF(p) \
+	((u8_t *)(((mem_ptr_t)(p) + SIZEOF_STRUCT_PBUF + PBUF_POOL_ALIGNMENT - 1) & ~(mem_ptr_t)(PBUF_POOL_ALIGNMENT - 1)))
+#endif
+
 #if !LWIP_TCP || !TCP_QUEUE_OOSEQ || !PBUF_POOL_FREE_OOSEQ
-#define PBUF_POOL_IS_EMPTY()
+#define PBUF_POOL_IS_EMPTY() netmem_drop(NETMEM_DROP_PBUF_POOL)
 #else							/* !LWIP_TCP || !TCP_QUEUE_OOSEQ || !PBUF_POOL_FREE_OOSEQ */
 
 #if !NO_SYS
@@ -118,7 +128,10 @@
 #endif							/* !NO_SYS */
 
 volatile u8_t pbuf_free_ooseq_pending;
-#define PBUF_POOL_IS_EMPTY() pbuf_pool_is_empty()
+#define PBUF_POOL_IS_EMPTY() do { \
+		netmem_drop(NETMEM_DROP_PBUF_POOL); \
+		pbuf_pool_is_empty(); \
+	} while (0)
 
 /**
  * Attempt to reclaim some memory from queued out-of-sequence TCP segments
@@ -144,6 +157,7 @@ void pbuf_free_ooseq(void)
 		if (NULL != pcb->ooseq) {
 			/** Free the ooseq pbufs of one PCB only */
 			LWIP_DEBUGF(PBUF_DEBUG | LWIP_DBG_TRACE, ("pbuf_free_ooseq: freeing out-of-sequence pbufs\n"));
+			netmem_drop(NETMEM_DROP_TCP_OOSEQ);
 			tcp_segs_free(pcb->ooseq);
 			pcb->ooseq = NULL;
 			return;
@@ -186,6 +200,38 @@ static void pbuf_pool_is_empty(void)
 }
 #endif							/* !LWIP_TCP || !TCP_QUEUE_OOSEQ || !PBUF_POOL_FREE_OOSEQ */
 
+#if LWIP_PBUF_POOL_CLASSES
+/**
+ * Allocate a pbuf from the smallest pbuf pool class that holds 'size' bytes,
+ * falling back to the medium pool if the small one is empty.
+ *
+ * @param size the size of the buffer, header offset included
+ * @return the pbuf with its pool flag set, or NULL if 'size' is too large
+ *         for the medium pool or no class pool has a free pbuf. The caller
+ *         then uses the full size pbuf pool.
+ */
+static struct pbuf *pbuf_alloc_class(u32_t size)
+{
+	struct pbuf *p;
+
+	if (size <= PBUF_POOL_SMALL_BUFSIZE) {
+		p = (struct pbuf *)memp_malloc(MEMP_PBUF_POOL_SMALL);
+		if (p != NULL) {
+			p->flags = PBUF_FLAG_POOL_SMALL;
+			return p;
+		}
+	}
+	if (size <= PBUF_POOL_MEDIUM_BUFSIZE) {
+		p = (struct pbuf *)memp_malloc(MEMP_PBUF_POOL_MEDIUM);
+		if (p != NULL) {
+			p->flags = PBUF_FLAG_POOL_MEDIUM;
+			return p;
+		}
+	}
+	return NULL;
+}
+#endif							/* LWIP_PBUF_POOL_CLASSES */
+
 /**
  * Allocates a pbuf of the given type (possibly a chain for PBUF_POOL type).
  *
@@ -213,6 +259,9 @@ static void pbuf_pool_is_empty(void)
  *             then pbuf_take should be called to copy the buffer.
  * - PBUF_POOL: the pbuf is allocated as a pbuf chain, with pbufs from
  *              the pbuf pool that is allocated during pbuf_init().
+ *              With LWIP_PBUF_POOL_CLASSES, a pbuf that fits in a small
+ *              or medium pbuf is allocated as a single pbuf from these
+ *              pools instead.
  *
  * @return the allocated pbuf. If multiple pbufs where allocated, this
  * is the first pbuf of a pbuf chain.
@@ -248,6 +297,20 @@ struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
 
 	switch (type) {
 	case PBUF_POOL:
+#if LWIP_PBUF_POOL_CLASSES
+		/* try a single small or medium pbuf first */
+		p = pbuf_alloc_class((u32_t)LWIP_MEM_ALIGN_SIZE(offset) + length);
+		if (p != NULL) {
+			p->type = type;
+			p->next = NULL;
+			p->payload = PBUF_POOL_CLASS_BUF(p) + LWIP_MEM_ALIGN_SIZE(offset);
+			LWIP_ASSERT("pbuf_alloc: pbuf p->payload properly aligned", ((mem_ptr_t)p->payload % MEM_ALIGNMENT) == 0);
+			p->tot_len = length;
+			p->len = length;
+			p->ref = 1;
+			break;
+		}
+#endif							/* LWIP_PBUF_POOL_CLASSES */
 		/* allocate head of pbuf chain into p */
 		p = (struct pbuf *)memp_malloc(MEMP_PBUF_POOL);
 		LWIP_DEBUGF(PBUF_DEBUG | LWIP_DBG_TRACE, ("pbuf_alloc: allocated pbuf %p\n", (void *)p));
@@ -313,6 +376,7 @@ struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
 		/* If pbuf is to be allocated in RAM, allocate memory for it. */
 		p = (struct pbuf *)mem_malloc(LWIP_MEM_ALIGN_SIZE(SIZEOF_STRUCT_PBUF + offset) + LWIP_MEM_ALIGN_SIZE(length));
 		if (p == NULL) {
+			netmem_drop(NETMEM_DROP_PBUF_RAM);
 			return NULL;
 		}
 		/* Set up internal structure of the pbuf. */
@@ -655,7 +719,16 @@ u8_t pbuf_free(struct pbuf *p)
 			{
 				/* is this a pbuf from the pool? */
 				if (type == PBUF_POOL) {
-					memp_free(MEMP_PBUF_POOL, p);
+#if LWIP_PBUF_POOL_CLASSES
+					if ((p->flags & PBUF_FLAG_POOL_SMALL) != 0) {
+						memp_free(MEMP_PBUF_POOL_SMALL, p);
+					} else if ((p->flags & PBUF_FLAG_POOL_MEDIUM) != 0) {
+						memp_free(MEMP_PBUF_POOL_MEDIUM, p);
+					} else
+#endif							/* LWIP_PBUF_POOL_CLASSES */
+					{
+						memp_free(MEMP_PBUF_POOL, p);
+					}
 					/* is this a ROM or RAM referencing pbuf? */
 				} else if (type == PBUF_ROM || type == PBUF_REF) {
 					memp_free(MEMP_PBUF, p);
@@ -131,6 +131,7 @@ void stats_display_mem(struct stats_mem *mem, const char *name)
 	LWIP_STATS_DIAG(("avail: %" U32_F "\n\t", (u32_t)mem->avail));
 	LWIP_STATS_DIAG(("used: %" U32_F "\n\t", (u32_t)mem->used));
 	LWIP_STATS_DIAG(("max: %" U32_F "\n\t", (u32_t)mem->max));
+	LWIP_STATS_DIAG(("lowwater: %" U32_F "\n\t", (u32_t)(mem->avail - mem->max)));
 	LWIP_STATS_DIAG(("err: %" U32_F "\n", (u32_t)mem->err));
 }
 
@@ -187,7 +187,7 @@ static err_t tcp_close_shutdown(struct tcp_pcb *pcb, u8_t rst_on_unacked_data)
 	err_t err;
 
 	if (rst_on_unacked_data && ((pcb->state == ESTABLISHED) || (pcb->state == CLOSE_WAIT))) {
-		if ((pcb->refused_data != NULL) || (pcb->rcv_wnd != TCP_WND)) {
+		if ((pcb->refused_data != NULL) || (pcb->rcv_wnd != TCP_WND_MAX(pcb))) {
 			/* Not all data received by application, send RST to tell the remote
 			   side about this. */
 			LWIP_ASSERT("pcb->flags & TF_RXCLOSED", pcb->flags & TF_RXCLOSED);
@@ -469,10 +469,10 @@ err_t tcp_bind(struct tcp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
 		for (cpcb = *tcp_pcb_lists[i]; cpcb != NULL; cpcb = cpcb->next) {
 			if (cpcb->local_port == port) {
 #if SO_REUSE
-				/* Omit checking for the same port if both pcbs have REUSEADDR set.
-				   For SO_REUSEADDR, the duplicate-check for a 5-tuple is done in
-				   tcp_connect. */
-				if (!ip_get_option(pcb, SOF_REUSEADDR) || !ip_get_option(cpcb, SOF_REUSEADDR))
+				/* Omit checking for the same port if both pcbs have REUSEADDR set,
+				   or both have REUSEPORT set. For SO_REUSEADDR, the duplicate-check
+				   for a 5-tuple is done in tcp_connect. */
+				if ((!ip_get_option(pcb, SOF_REUSEADDR) || !ip_get_option(cpcb, SOF_REUSEADDR)) && (!ip_get_option(pcb, SOF_REUSEPORT) || !ip_get_option(cpcb, SOF_REUSEPORT)))
 #endif							/* SO_REUSE */
 				{
 					if (ip_addr_isany(&(cpcb->local_ip)) || ip_addr_isany(ipaddr) || ip_addr_cmp(&(cpcb->local_ip), ipaddr)) {
@@ -532,12 +532,14 @@ struct tcp_pcb *tcp_listen_with_backlog(struct tcp_pcb *pcb, u8_t backlog)
 		return pcb;
 	}
 #if SO_REUSE
-	if (ip_get_option(pcb, SOF_REUSEADDR)) {
+	if (ip_get_option(pcb, SOF_REUSEADDR | SOF_REUSEPORT)) {
 		/* Since SOF_REUSEADDR allows reusing a local address before the pcb's usage
 		   is declared (listen-/connection-pcb), we have to make sure now that
-		   this port is only used once for every local IP. */
+		   this port is only used once for every local IP. Listeners that all
+		   have SOF_REUSEPORT set share the port: tcp_input() hands the new
+		   connections to them in turn. */
 		for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
-			if (lpcb->local_port == pcb->local_port) {
+			if (lpcb->local_port == pcb->local_port && (!ip_get_option(pcb, SOF_REUSEPORT) || !ip_get_option(lpcb, SOF_REUSEPORT))) {
 				if (ip_addr_cmp(&lpcb->local_ip, &pcb->local_ip)) {
 					/* this address/port is already used */
 					return NULL;
@@ -596,8 +598,8 @@ u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb)
 		} else {
 			/* keep the right edge of window constant */
 			u32_t new_rcv_ann_wnd = pcb->rcv_ann_right_edge - pcb->rcv_nxt;
-			LWIP_ASSERT("new_rcv_ann_wnd <= 0xffff", new_rcv_ann_wnd <= 0xffff);
-			pcb->rcv_ann_wnd = (u16_t)new_rcv_ann_wnd;
+			LWIP_ASSERT("new_rcv_ann_wnd <= TCP_WND", new_rcv_ann_wnd <= TCP_WND);
+			pcb->rcv_ann_wnd = (tcpwnd_size_t)new_rcv_ann_wnd;
 		}
 		return 0;
 	}
@@ -617,11 +619,11 @@ void tcp_recved(struct tcp_pcb *pcb, u16_t len)
 
 	/* pcb->state LISTEN not allowed here */
 	LWIP_ASSERT("don't call tcp_recved for listen-pcbs", pcb->state != LISTEN);
-	LWIP_ASSERT("tcp_recved: len would wrap rcv_wnd\n", len <= 0xffff - pcb->rcv_wnd);
+	LWIP_ASSERT("tcp_recved: len would wrap rcv_wnd\n", len <= TCP_WND_MAX(pcb) - pcb->rcv_wnd);
 
 	pcb->rcv_wnd += len;
-	if (pcb->rcv_wnd > TCP_WND) {
-		pcb->rcv_wnd = TCP_WND;
+	if (pcb->rcv_wnd > TCP_WND_MAX(pcb)) {
+		pcb->rcv_wnd = TCP_WND_MAX(pcb);
 	}
 
 	wnd_inflation = tcp_update_rcv_ann_wnd(pcb);
@@ -635,7 +637,7 @@ void tcp_recved(struct tcp_pcb *pcb, u16_t len)
 		tcp_output(pcb);
 	}
 
-	LWIP_DEBUGF(TCP_DEBUG, ("tcp_recved: recveived %" U16_F " bytes, wnd %" U16_F " (%" U16_F ").\n", len, pcb->rcv_wnd, TCP_WND - pcb->rcv_wnd));
+	LWIP_DEBUGF(TCP_DEBUG, ("tcp_recved: recveived %" U16_F " bytes, wnd %" TCPWNDSIZE_F " (%" TCPWNDSIZE_F ").\n", len, pcb->rcv_wnd, (tcpwnd_size_t)(TCP_WND_MAX(pcb) - pcb->rcv_wnd)));
 }
 
 /**
@@ -716,7 +718,7 @@ err_t tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, u16_t port, tcp_connec
 		}
 	}
 #if SO_REUSE
-	if (ip_get_option(pcb, SOF_REUSEADDR)) {
+	if (ip_get_option(pcb, SOF_REUSEADDR | SOF_REUSEPORT)) {
 		/* Since SOF_REUSEADDR allows reusing a local address, we have to make sure
 		   now that the 5-tuple is unique. */
 		struct tcp_pcb *cpcb;
@@ -737,10 +739,14 @@ err_t tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, u16_t port, tcp_connec
 	pcb->snd_nxt = iss;
 	pcb->lastack = iss - 1;
 	pcb->snd_lbb = iss - 1;
-	pcb->rcv_wnd = TCP_WND;
-	pcb->rcv_ann_wnd = TCP_WND;
+#if LWIP_TCP_RACK
+	pcb->rack_recover = iss;
+#endif							/* LWIP_TCP_RACK */
+	/* the full TCP_WND is only opened once the peer agrees to window scaling */
+	pcb->rcv_wnd = TCPWND16(TCP_WND);
+	pcb->rcv_ann_wnd = TCPWND16(TCP_WND);
 	pcb->rcv_ann_right_edge = pcb->rcv_nxt;
-	pcb->snd_wnd = TCP_WND;
+	pcb->snd_wnd = TCPWND16(TCP_WND);
 	/* As initial send MSS, we use TCP_MSS but limit it to 536.
 	   The send MSS is updated when an MSS option is received. */
 	pcb->mss = (TCP_MSS > 536) ? 536 : TCP_MSS;
@@ -781,7 +787,7 @@ err_t tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, u16_t port, tcp_connec
 void tcp_slowtmr(void)
 {
 	struct tcp_pcb *pcb, *prev;
-	u16_t eff_wnd;
+	tcpwnd_size_t eff_wnd;
 	u8_t pcb_remove;			/* flag if a PCB should be removed */
 	u8_t pcb_reset;				/* flag if a RST should be sent when removing */
 	err_t err;
@@ -857,7 +863,7 @@ tcp_slowtmr_start:
 						pcb->ssthresh = (pcb->mss << 1);
 					}
 					pcb->cwnd = pcb->mss;
-					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %" U16_F " ssthresh %" U16_F "\n", pcb->cwnd, pcb->ssthresh));
+					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %" TCPWNDSIZE_F " ssthresh %" TCPWNDSIZE_F "\n", pcb->cwnd, pcb->ssthresh));
 
 					/* The following needs to be called AFTER cwnd is set to one
 					   mss - STJ */
@@ -1034,6 +1040,13 @@ tcp_fasttmr_start:
 				tcp_output(pcb);
 				pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW);
 			}
+#if LWIP_TCP_RACK
+			/* retransmit segments whose reordering window ran out
+			   without a further ACK arriving */
+			if (pcb->unacked != NULL && tcp_rack_detect_loss(pcb)) {
+				tcp_output(pcb);
+			}
+#endif							/* LWIP_TCP_RACK */
 
 			next = pcb->next;
 
@@ -1068,7 +1081,7 @@ err_t tcp_process_refused_data(struct tcp_pcb *pcb)
 		if (refused_flags & PBUF_FLAG_TCP_FIN) {
 			/* correct rcv_wnd as the application won't call tcp_recved()
 			   for the FIN's seqno */
-			if (pcb->rcv_wnd != TCP_WND) {
+			if (pcb->rcv_wnd != TCP_WND_MAX(pcb)) {
 				pcb->rcv_wnd++;
 			}
 			TCP_EVENT_CLOSED(pcb, err);
@@ -1265,8 +1278,8 @@ struct tcp_pcb *tcp_alloc(u8_t prio)
 		pcb->prio = prio;
 		pcb->snd_buf = TCP_SND_BUF;
 		pcb->snd_queuelen = 0;
-		pcb->rcv_wnd = TCP_WND;
-		pcb->rcv_ann_wnd = TCP_WND;
+		pcb->rcv_wnd = TCPWND16(TCP_WND);
+		pcb->rcv_ann_wnd = TCPWND16(TCP_WND);
 		pcb->tos = 0;
 		pcb->ttl = TCP_TTL;
 		/* As initial send MSS, we use TCP_MSS but limit it to 536.
@@ -1282,6 +1295,10 @@ struct tcp_pcb *tcp_alloc(u8_t prio)
 		pcb->snd_nxt = iss;
 		pcb->lastack = iss;
 		pcb->snd_lbb = iss;
+#if LWIP_TCP_RACK
+		pcb->rack_min_rtt = TCP_RACK_NO_RTT;
+		pcb->rack_recover = iss;
+#endif							/* LWIP_TCP_RACK */
 		pcb->tmr = tcp_ticks;
 		pcb->last_timer = tcp_timer_ctr;
 
@@ -71,7 +71,9 @@
 #include <net/lwip/ipv4/inet_chksum.h>
 #include <net/lwip/stats.h>
 #include <net/lwip/snmp.h>
+#include <net/lwip/sys.h>
 #include <net/lwip/arch/perf.h>
+#include <tinyara/net/netmem.h>
 
 /* These variables are global to all functions involved in the input
    processing of TCP segments. They are set by the tcp_input()
@@ -227,7 +229,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 				if (ip_addr_cmp(&(lpcb->local_ip), &current_iphdr_dest)) {
 					/* found an exact match */
 					break;
-				} else if (ip_addr_isany(&(lpcb->local_ip))) {
+				} else if (ip_addr_isany(&(lpcb->local_ip)) && lpcb_any == NULL) {
 					/* found an ANY-match */
 					lpcb_any = lpcb;
 					lpcb_prev = prev;
@@ -250,6 +252,23 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		}
 #endif							/* SO_REUSE */
 		if (lpcb != NULL) {
+#if SO_REUSE
+			if (ip_get_option(lpcb, SOF_REUSEPORT) && (TCPH_FLAGS(tcphdr) & TCP_SYN) && lpcb->next != NULL) {
+				/* Several listeners may share this port (SO_REUSEPORT): move this
+				   one to the end of the list so that the next connection goes to
+				   the next of them. */
+				struct tcp_pcb_listen *last;
+
+				if (prev != NULL) {
+					((struct tcp_pcb_listen *)prev)->next = lpcb->next;
+				} else {
+					tcp_listen_pcbs.listen_pcbs = lpcb->next;
+				}
+				for (last = lpcb->next; last->next != NULL; last = last->next) ;
+				last->next = lpcb;
+				lpcb->next = NULL;
+			} else
+#endif							/* SO_REUSE */
 			/* Move this PCB to the front of the list so that subsequent
 			   lookups will be faster (we exploit locality in TCP segment
 			   arrivals). */
@@ -372,7 +391,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 					} else {
 						/* correct rcv_wnd as the application won't call tcp_recved()
 						   for the FIN's seqno */
-						if (pcb->rcv_wnd != TCP_WND) {
+						if (pcb->rcv_wnd != TCP_WND_MAX(pcb)) {
 							pcb->rcv_wnd++;
 						}
 						TCP_EVENT_CLOSED(pcb, err);
@@ -675,7 +694,7 @@ static err_t tcp_process(struct tcp_pcb *pcb)
 		if (flags & TCP_ACK) {
 			/* expected ACK number? */
 			if (TCP_SEQ_BETWEEN(ackno, pcb->lastack + 1, pcb->snd_nxt)) {
-				u16_t old_cwnd;
+				tcpwnd_size_t old_cwnd;
 				pcb->state = ESTABLISHED;
 				LWIP_DEBUGF(TCP_DEBUG, ("TCP connection established %" U16_F " -> %" U16_F ".\n", inseg.tcphdr->src, inseg.tcphdr->dest));
 #if LWIP_CALLBACK_API
@@ -815,6 +834,65 @@ static void tcp_oos_insert_segment(struct tcp_seg *cseg, struct tcp_seg *next)
 }
 #endif							/* TCP_QUEUE_OOSEQ */
 
+#if LWIP_TCP_RACK
+/**
+ * Feed a segment that has just been delivered, cumulatively or by SACK,
+ * into the RACK state. Retransmitted segments are skipped since their
+ * RTT is ambiguous.
+ *
+ * Called from tcp_receive() and tcp_sack_mark()
+ */
+static void tcp_rack_update(struct tcp_pcb *pcb, struct tcp_seg *seg)
+{
+	u32_t rtt;
+
+	if ((seg->flags & (TF_SEG_SENT | TF_SEG_RETRANSMITTED)) != TF_SEG_SENT) {
+		return;
+	}
+
+	rtt = sys_now() - seg->xmit_ts;
+	if (pcb->rack_min_rtt == TCP_RACK_NO_RTT || (s32_t)(seg->xmit_ts - pcb->rack_xmit_ts) >= 0) {
+		pcb->rack_xmit_ts = seg->xmit_ts;
+		pcb->rack_rtt = rtt;
+	}
+	if (pcb->rack_min_rtt == TCP_RACK_NO_RTT || rtt < pcb->rack_min_rtt) {
+		pcb->rack_min_rtt = rtt;
+	}
+}
+#endif							/* LWIP_TCP_RACK */
+
+#if LWIP_TCP_SACK
+/**
+ * Mark the unacked segments covered by the SACK block [left, right) as
+ * received by the peer.
+ *
+ * Called from tcp_parseopt()
+ */
+static void tcp_sack_mark(struct tcp_pcb *pcb, u32_t left, u32_t right)
+{
+	struct tcp_seg *seg;
+	u32_t seg_seqno;
+
+	/* ignore D-SACKs and blocks outside of the data in flight */
+	if (!TCP_SEQ_LT(left, right) || TCP_SEQ_LEQ(right, ackno) || TCP_SEQ_GT(right, pcb->snd_nxt)) {
+		return;
+	}
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		seg_seqno = ntohl(seg->tcphdr->seqno);
+		if (TCP_SEQ_GEQ(seg_seqno, right)) {
+			break;
+		}
+		if (TCP_SEQ_GEQ(seg_seqno, left) && TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), right) && !(seg->flags & TF_SEG_SACKED)) {
+			seg->flags |= TF_SEG_SACKED;
+#if LWIP_TCP_RACK
+			tcp_rack_update(pcb, seg);
+#endif							/* LWIP_TCP_RACK */
+		}
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Called by tcp_process. Checks if the given segment is an ACK for outstanding
  * data, and if so frees the memory of the buffered data. Next, is places the
@@ -850,12 +928,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 		right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
 
 		/* Update window. */
-		if (TCP_SEQ_LT(pcb->snd_wl1, seqno) || (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) || (pcb->snd_wl2 == ackno && tcphdr->wnd > pcb->snd_wnd)) {
-			pcb->snd_wnd = tcphdr->wnd;
+		if (TCP_SEQ_LT(pcb->snd_wl1, seqno) || (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) || (pcb->snd_wl2 == ackno && SND_WND_SCALE(pcb, tcphdr->wnd) > pcb->snd_wnd)) {
+			pcb->snd_wnd = SND_WND_SCALE(pcb, tcphdr->wnd);
 			/* keep track of the biggest window announced by the remote host to calculate
 			   the maximum segment size */
-			if (pcb->snd_wnd_max < tcphdr->wnd) {
-				pcb->snd_wnd_max = tcphdr->wnd;
+			if (pcb->snd_wnd_max < pcb->snd_wnd) {
+				pcb->snd_wnd_max = pcb->snd_wnd;
 			}
 			pcb->snd_wl1 = seqno;
 			pcb->snd_wl2 = ackno;
@@ -869,10 +947,10 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				/* stop persist timer */
 				pcb->persist_backoff = 0;
 			}
-			LWIP_DEBUGF(TCP_WND_DEBUG, ("tcp_receive: window update %" U16_F "\n", pcb->snd_wnd));
+			LWIP_DEBUGF(TCP_WND_DEBUG, ("tcp_receive: window update %" TCPWNDSIZE_F "\n", pcb->snd_wnd));
 #if TCP_WND_DEBUG
 		} else {
-			if (pcb->snd_wnd != tcphdr->wnd) {
+			if (pcb->snd_wnd != SND_WND_SCALE(pcb, tcphdr->wnd)) {
 				LWIP_DEBUGF(TCP_WND_DEBUG, ("tcp_receive: no window update lastack %" U32_F " ackno %" U32_F " wl1 %" U32_F " seqno %" U32_F " wl2 %" U32_F "\n", pcb->lastack, ackno, pcb->snd_wl1, seqno, pcb->snd_wl2));
 			}
 #endif							/* TCP_WND_DEBUG */
@@ -916,7 +994,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 							if (pcb->dupacks > 3) {
 								/* Inflate the congestion window, but not if it means that
 								   the value overflows. */
-								if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
+								if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 									pcb->cwnd += pcb->mss;
 								}
 							} else if (pcb->dupacks == 3) {
@@ -962,16 +1040,16 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   ssthresh). */
 			if (pcb->state >= ESTABLISHED) {
 				if (pcb->cwnd < pcb->ssthresh) {
-					if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
+					if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 						pcb->cwnd += pcb->mss;
 					}
-					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: slow start cwnd %" U16_F "\n", pcb->cwnd));
+					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: slow start cwnd %" TCPWNDSIZE_F "\n", pcb->cwnd));
 				} else {
-					u16_t new_cwnd = (pcb->cwnd + pcb->mss * pcb->mss / pcb->cwnd);
+					tcpwnd_size_t new_cwnd = (pcb->cwnd + pcb->mss * pcb->mss / pcb->cwnd);
 					if (new_cwnd > pcb->cwnd) {
 						pcb->cwnd = new_cwnd;
 					}
-					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: congestion avoidance cwnd %" U16_F "\n", pcb->cwnd));
+					LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: congestion avoidance cwnd %" TCPWNDSIZE_F "\n", pcb->cwnd));
 				}
 			}
 			LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_receive: ACK for %" U32_F ", unacked->seqno %" U32_F ":%" U32_F "\n", ackno, pcb->unacked != NULL ? ntohl(pcb->unacked->tcphdr->seqno) : 0, pcb->unacked != NULL ? ntohl(pcb->unacked->tcphdr->seqno) + TCP_TCPLEN(pcb->unacked) : 0));
@@ -992,6 +1070,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				}
 
 				pcb->snd_queuelen -= pbuf_clen(next->p);
+#if LWIP_TCP_RACK
+				if (!(next->flags & TF_SEG_SACKED)) {
+					tcp_rack_update(pcb, next);
+				}
+#endif							/* LWIP_TCP_RACK */
 				tcp_seg_free(next);
 
 				LWIP_DEBUGF(TCP_QLEN_DEBUG, ("%" U16_F " (after freeing unacked)\n", (u16_t)pcb->snd_queuelen));
@@ -1071,6 +1154,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			pcb->rttest = 0;
 		}
+#if LWIP_TCP_RACK
+		if (pcb->unacked != NULL) {
+			tcp_rack_detect_loss(pcb);
+		}
+#endif							/* LWIP_TCP_RACK */
 	}
 
 	/* If the incoming segment contains data, we must process it
@@ -1185,7 +1273,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 						TCPH_FLAGS_SET(inseg.tcphdr, TCPH_FLAGS(inseg.tcphdr) & ~TCP_FIN);
 					}
 					/* Adjust length of segment to fit in the window. */
-					inseg.len = pcb->rcv_wnd;
+					inseg.len = (u16_t)pcb->rcv_wnd;
 					if (TCPH_FLAGS(inseg.tcphdr) & TCP_SYN) {
 						inseg.len -= 1;
 					}
@@ -1309,8 +1397,10 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
-				tcp_send_empty_ack(pcb);
 #if TCP_QUEUE_OOSEQ
+#if LWIP_TCP_SACK
+				pcb->sack_last = seqno;
+#endif							/* LWIP_TCP_SACK */
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
 					pcb->ooseq = tcp_seg_copy(&inseg);
@@ -1438,6 +1528,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					ooseq_qlen += pbuf_clen(p);
 					if ((ooseq_blen > TCP_OOSEQ_MAX_BYTES) || (ooseq_qlen > TCP_OOSEQ_MAX_PBUFS)) {
 						/* too much ooseq data, dump this and everything after it */
+						netmem_drop(NETMEM_DROP_TCP_OOSEQ);
 						tcp_segs_free(next);
 						if (prev == NULL) {
 							/* first ooseq segment is too much, dump the whole queue */
@@ -1451,6 +1542,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
 #endif							/* TCP_QUEUE_OOSEQ */
+				/* Send the duplicate ACK once the segment is queued so that
+				   its SACK blocks already cover it. */
+				tcp_send_empty_ack(pcb);
 			}
 		} else {
 			/* The incoming segment is not withing the window. */
@@ -1471,7 +1565,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
  * Parses the options contained in the incoming segment.
  *
  * Called from tcp_listen_input() and tcp_process().
- * Currently, only the MSS option is supported!
+ * Supports MSS, timestamps, window scale and SACK.
  *
  * @param pcb the tcp_pcb for which a segment arrived
  */
@@ -1483,6 +1577,10 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u16_t i;
+	u32_t left, right;
+#endif
 
 	opts = (u8_t *)tcphdr + TCP_HLEN;
 
@@ -1534,6 +1632,57 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				/* Advance to next option */
 				c += 0x0A;
 				break;
+#endif
+#if LWIP_WND_SCALE
+			case 0x03:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: WND_SCALE\n"));
+				if (opts[c + 1] != 0x03 || c + 0x03 > max_c) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* Only valid on a SYN. Our SYN always carries the option and our
+				   SYN|ACK only answers it, so seeing it means scaling is in effect. */
+				if ((flags & TCP_SYN) && !(pcb->flags & TF_WND_SCALE)) {
+					pcb->snd_scale = LWIP_MIN(opts[c + 2], 14);
+					pcb->rcv_scale = TCP_RCV_SCALE;
+					pcb->flags |= TF_WND_SCALE;
+					/* the full receive window can be advertised from now on */
+					pcb->rcv_wnd = TCP_WND;
+					pcb->rcv_ann_wnd = TCP_WND;
+				}
+				c += 0x03;
+				break;
+#endif
+#if LWIP_TCP_SACK
+			case 0x04:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (opts[c + 1] != 0x02 || c + 0x02 > max_c) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				if (flags & TCP_SYN) {
+					pcb->flags |= TF_SACK;
+				}
+				c += 0x02;
+				break;
+			case 0x05:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				if (opts[c + 1] < 0x0A || ((opts[c + 1] - 2) & 0x07) != 0 || c + opts[c + 1] > max_c) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				if (!(flags & TCP_SYN) && (pcb->flags & TF_SACK)) {
+					for (i = c + 2; i < c + opts[c + 1]; i += 8) {
+						left = ((u32_t)opts[i] << 24) | ((u32_t)opts[i + 1] << 16) | ((u32_t)opts[i + 2] << 8) | opts[i + 3];
+						right = ((u32_t)opts[i + 4] << 24) | ((u32_t)opts[i + 5] << 16) | ((u32_t)opts[i + 6] << 8) | opts[i + 7];
+						tcp_sack_mark(pcb, left, right);
+					}
+				}
+				c += opts[c + 1];
+				break;
 #endif
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
@@ -119,7 +119,7 @@ static struct pbuf *tcp_output_alloc_header(struct tcp_pcb *pcb, u16_t optlen, u
 		tcphdr->seqno = seqno_be;
 		tcphdr->ackno = htonl(pcb->rcv_nxt);
 		TCPH_HDRLEN_FLAGS_SET(tcphdr, (5 + optlen / 4), TCP_ACK);
-		tcphdr->wnd = htons(pcb->rcv_ann_wnd);
+		tcphdr->wnd = htons(TCPWND16(RCV_WND_SCALE(pcb, pcb->rcv_ann_wnd)));
 		tcphdr->chksum = 0;
 		tcphdr->urgp = 0;
 
@@ -712,6 +712,17 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 
 	if (flags & TCP_SYN) {
 		optflags = TF_SEG_OPTS_MSS;
+#if LWIP_WND_SCALE
+		/* a SYN|ACK may only carry the option if the peer's SYN did */
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_WND_SCALE)) {
+			optflags |= TF_SEG_OPTS_WND_SCALE;
+		}
+#endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -797,6 +808,59 @@ static void tcp_build_timestamp_option(struct tcp_pcb *pcb, u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+/* Collect the contiguous runs of the ooseq queue as SACK blocks, the run
+ * holding the most recently received segment first (RFC 2018, section 4).
+ *
+ * @param pcb tcp_pcb
+ * @param blocks filled with max pairs of left and right edges, host order
+ * @param max number of blocks that fit into the option space
+ * @return number of blocks stored
+ */
+static u8_t tcp_get_sack_blocks(struct tcp_pcb *pcb, u32_t *blocks, u8_t max)
+{
+	struct tcp_seg *seg = pcb->ooseq;
+	u32_t left, right;
+	u8_t n = 0;
+
+	while (seg != NULL) {
+		left = seg->tcphdr->seqno;
+		right = left + TCP_TCPLEN(seg);
+		for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == right; seg = seg->next) {
+			right += TCP_TCPLEN(seg);
+		}
+
+		if (TCP_SEQ_GEQ(pcb->sack_last, left) && TCP_SEQ_LT(pcb->sack_last, right)) {
+			if (n == max) {
+				n--;
+			}
+			memmove(&blocks[2], &blocks[0], n * 2 * sizeof(u32_t));
+			blocks[0] = left;
+			blocks[1] = right;
+			n++;
+		} else if (n < max) {
+			blocks[2 * n] = left;
+			blocks[2 * n + 1] = right;
+			n++;
+		}
+	}
+	return n;
+}
+
+/* Build a SACK option, padded with two NOP options, at the specified
+ * options pointer
+ */
+static void tcp_build_sack_option(u32_t *blocks, u8_t n, u32_t *opts)
+{
+	u8_t i;
+
+	opts[0] = htonl(0x01010500 | (LWIP_TCP_SACK_OPT_LENGTH(n) - 2));
+	for (i = 0; i < 2 * n; i++) {
+		opts[i + 1] = htonl(blocks[i]);
+	}
+}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+
 /** Send an ACK without data.
  *
  * @param pcb Protocol control block for the TCP connection to send the ACK
@@ -805,13 +869,25 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 {
 	struct pbuf *p;
 	struct tcp_hdr *tcphdr;
+	u32_t *opts;
 	u8_t optlen = 0;
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u32_t sacks[2 * TCP_SACK_MAX_BLOCKS];
+	u8_t num_sacks = 0;
+#endif
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+		/* the blocks share the 40 bytes of option space with the timestamp */
+		num_sacks = tcp_get_sack_blocks(pcb, sacks, LWIP_MIN(TCP_SACK_MAX_BLOCKS, (40 - optlen - LWIP_TCP_SACK_OPT_LENGTH(0)) / 8));
+		optlen += LWIP_TCP_SACK_OPT_LENGTH(num_sacks);
+	}
+#endif
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -824,13 +900,21 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW);
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
+	opts = (u32_t *)(void *)(tcphdr + 1);
 #if LWIP_TCP_TIMESTAMPS
 	pcb->ts_lastacksent = pcb->rcv_nxt;
 
 	if (pcb->flags & TF_TIMESTAMP) {
-		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
+		tcp_build_timestamp_option(pcb, opts);
+		opts += 3;
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (num_sacks > 0) {
+		tcp_build_sack_option(sacks, num_sacks, opts);
+	}
+#endif
+	LWIP_UNUSED_ARG(opts);
 
 #if CHECKSUM_GEN_TCP
 	tcphdr->chksum = inet_chksum_pseudo(p, &(pcb->local_ip), &(pcb->remote_ip), IP_PROTO_TCP, p->tot_len);
@@ -856,6 +940,9 @@ err_t tcp_output(struct tcp_pcb *pcb)
 {
 	struct tcp_seg *seg, *useg;
 	u32_t wnd, snd_nxt;
+#if LWIP_NETIF_TX_BATCH
+	struct netif *netif = NULL;
+#endif							/* LWIP_NETIF_TX_BATCH */
 #if TCP_CWND_DEBUG
 	s16_t i = 0;
 #endif							/* TCP_CWND_DEBUG */
@@ -897,11 +984,22 @@ err_t tcp_output(struct tcp_pcb *pcb)
 #endif							/* TCP_OUTPUT_DEBUG */
 #if TCP_CWND_DEBUG
 	if (seg == NULL) {
-		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" U16_F ", cwnd %" U16_F ", wnd %" U32_F ", seg == NULL, ack %" U32_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, pcb->lastack));
+		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" TCPWNDSIZE_F ", cwnd %" TCPWNDSIZE_F ", wnd %" U32_F ", seg == NULL, ack %" U32_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, pcb->lastack));
 	} else {
-		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" U16_F ", cwnd %" U16_F ", wnd %" U32_F ", effwnd %" U32_F ", seq %" U32_F ", ack %" U32_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len, ntohl(seg->tcphdr->seqno), pcb->lastack));
+		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" TCPWNDSIZE_F ", cwnd %" TCPWNDSIZE_F ", wnd %" U32_F ", effwnd %" U32_F ", seq %" U32_F ", ack %" U32_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len, ntohl(seg->tcphdr->seqno), pcb->lastack));
 	}
 #endif							/* TCP_CWND_DEBUG */
+#if LWIP_NETIF_TX_BATCH
+	/* let the interface queue the segments and send them at once */
+	if (seg != NULL) {
+		netif = ip_route(&(pcb->remote_ip));
+		if (netif != NULL && netif->tx_batch != NULL) {
+			netif->tx_batch(netif, 1);
+		} else {
+			netif = NULL;
+		}
+	}
+#endif							/* LWIP_NETIF_TX_BATCH */
 	/* data available and window allows it to be sent? */
 	while (seg != NULL && ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len <= wnd) {
 		LWIP_ASSERT("RST not expected here!", (TCPH_FLAGS(seg->tcphdr) & TCP_RST) == 0);
@@ -916,7 +1014,7 @@ err_t tcp_output(struct tcp_pcb *pcb)
 			break;
 		}
 #if TCP_CWND_DEBUG
-		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" U16_F ", cwnd %" U16_F ", wnd %" U32_F ", effwnd %" U32_F ", seq %" U32_F ", ack %" U32_F ", i %" S16_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, ntohl(seg->tcphdr->seqno) + seg->len - pcb->lastack, ntohl(seg->tcphdr->seqno), pcb->lastack, i));
+		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" TCPWNDSIZE_F ", cwnd %" TCPWNDSIZE_F ", wnd %" U32_F ", effwnd %" U32_F ", seq %" U32_F ", ack %" U32_F ", i %" S16_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, ntohl(seg->tcphdr->seqno) + seg->len - pcb->lastack, ntohl(seg->tcphdr->seqno), pcb->lastack, i));
 		++i;
 #endif							/* TCP_CWND_DEBUG */
 
@@ -964,6 +1062,11 @@ err_t tcp_output(struct tcp_pcb *pcb)
 		}
 		seg = pcb->unsent;
 	}
+#if LWIP_NETIF_TX_BATCH
+	if (netif != NULL) {
+		netif->tx_batch(netif, 0);
+	}
+#endif							/* LWIP_NETIF_TX_BATCH */
 #if TCP_OVERSIZE
 	if (pcb->unsent == NULL) {
 		/* last unsent has been removed, reset unsent_oversize */
@@ -994,8 +1097,13 @@ static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 	   wnd fields remain. */
 	seg->tcphdr->ackno = htonl(pcb->rcv_nxt);
 
-	/* advertise our receive window size in this TCP segment */
-	seg->tcphdr->wnd = htons(pcb->rcv_ann_wnd);
+	/* advertise our receive window size in this TCP segment, the window
+	   of a SYN is never scaled */
+	if (TCPH_FLAGS(seg->tcphdr) & TCP_SYN) {
+		seg->tcphdr->wnd = htons(TCPWND16(pcb->rcv_ann_wnd));
+	} else {
+		seg->tcphdr->wnd = htons(TCPWND16(RCV_WND_SCALE(pcb, pcb->rcv_ann_wnd)));
+	}
 
 	pcb->rcv_ann_right_edge = pcb->rcv_nxt + pcb->rcv_ann_wnd;
 
@@ -1020,6 +1128,29 @@ static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 		opts += 3;
 	}
 #endif
+#if LWIP_WND_SCALE
+	if (seg->flags & TF_SEG_OPTS_WND_SCALE) {
+		/* NOP followed by the window scale option */
+		*opts = PP_HTONL(0x01030300 | TCP_RCV_SCALE);
+		opts += 1;
+	}
+#endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		/* two NOPs followed by the SACK permitted option */
+		*opts = PP_HTONL(0x01010402);
+		opts += 1;
+	}
+	/* a retransmission clears the SACK scoreboard entry (RFC 6675) */
+	seg->flags &= ~TF_SEG_SACKED;
+#endif
+#if LWIP_TCP_RACK
+	if (seg->flags & TF_SEG_SENT) {
+		seg->flags |= TF_SEG_RETRANSMITTED;
+	}
+	seg->flags |= TF_SEG_SENT;
+	seg->xmit_ts = sys_now();
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1132,7 +1263,7 @@ void tcp_rst(u32_t seqno, u32_t ackno, ip_addr_t *local_ip, ip_addr_t *remote_ip
 	tcphdr->seqno = htonl(seqno);
 	tcphdr->ackno = htonl(ackno);
 	TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, TCP_RST | TCP_ACK);
-	tcphdr->wnd = PP_HTONS(TCP_WND);
+	tcphdr->wnd = PP_HTONS(TCPWND16(TCP_WND));
 	tcphdr->chksum = 0;
 	tcphdr->urgp = 0;
 
@@ -1183,26 +1314,26 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 }
 
 /**
- * Requeue the first unacked segment for retransmission
+ * Requeue an unacked segment for retransmission
  *
- * Called by tcp_receive() for fast retramsmit.
+ * Called by tcp_rexmit() for the first unacked segment and by
+ * tcp_rack_detect_loss() for segments further down the queue.
  *
- * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ * @param pcb the tcp_pcb the segment belongs to
+ * @param seg the segment on pcb->unacked to retransmit
  */
-void tcp_rexmit(struct tcp_pcb *pcb)
+void tcp_rexmit_seg(struct tcp_pcb *pcb, struct tcp_seg *seg)
 {
-	struct tcp_seg *seg;
 	struct tcp_seg **cur_seg;
 
-	if (pcb->unacked == NULL) {
+	/* Unlink the segment from the unacked queue */
+	for (cur_seg = &(pcb->unacked); *cur_seg != NULL && *cur_seg != seg; cur_seg = &((*cur_seg)->next)) ;
+	if (*cur_seg == NULL) {
 		return;
 	}
+	*cur_seg = seg->next;
 
-	/* Move the first unacked segment to the unsent queue */
-	/* Keep the unsent queue sorted. */
-	seg = pcb->unacked;
-	pcb->unacked = seg->next;
-
+	/* Move it to the unsent queue, keeping the unsent queue sorted. */
 	cur_seg = &(pcb->unsent);
 	while (*cur_seg && TCP_SEQ_LT(ntohl((*cur_seg)->tcphdr->seqno), ntohl(seg->tcphdr->seqno))) {
 		cur_seg = &((*cur_seg)->next);
@@ -1216,13 +1347,28 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	}
 #endif							/* TCP_OVERSIZE */
 
-	++pcb->nrtx;
-
 	/* Don't take any rtt measurements after retransmitting. */
 	pcb->rttest = 0;
 
-	/* Do the actual retransmission. */
 	snmp_inc_tcpretranssegs();
+}
+
+/**
+ * Requeue the first unacked segment for retransmission
+ *
+ * Called by tcp_receive() for fast retramsmit.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ */
+void tcp_rexmit(struct tcp_pcb *pcb)
+{
+	if (pcb->unacked == NULL) {
+		return;
+	}
+
+	tcp_rexmit_seg(pcb, pcb->unacked);
+	++pcb->nrtx;
+
 	/* No need to call tcp_output: we are always called from tcp_input()
 	   and thus tcp_output directly returns. */
 }
@@ -1249,14 +1395,69 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 
 		/* The minimum value for ssthresh should be 2 MSS */
 		if (pcb->ssthresh < 2 * pcb->mss) {
-			LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: The minimum value for ssthresh %" U16_F " should be min 2 mss %" U16_F "...\n", pcb->ssthresh, 2 * pcb->mss));
+			LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: The minimum value for ssthresh %" TCPWNDSIZE_F " should be min 2 mss %" U16_F "...\n", pcb->ssthresh, 2 * pcb->mss));
 			pcb->ssthresh = 2 * pcb->mss;
 		}
 
 		pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
 		pcb->flags |= TF_INFR;
+#if LWIP_TCP_RACK
+		pcb->rack_recover = pcb->snd_nxt;
+#endif							/* LWIP_TCP_RACK */
+	}
+}
+
+#if LWIP_TCP_RACK
+/**
+ * RACK loss detection (RFC 8985): an unacked segment that was sent before
+ * the latest delivered segment and has been outstanding for longer than
+ * that segment's RTT plus a reordering window of a quarter of the minimum
+ * RTT is considered lost and requeued for retransmission. The window is
+ * reduced once per window of data, like fast retransmit.
+ *
+ * Called by tcp_receive() after processing an ACK and by tcp_fasttmr().
+ *
+ * @param pcb the tcp_pcb to check
+ * @return 1 if segments were requeued, 0 otherwise
+ */
+u8_t tcp_rack_detect_loss(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg, *next;
+	u32_t now, deadline;
+	u8_t lost = 0;
+
+	if (!(pcb->flags & TF_SACK) || pcb->rack_min_rtt == TCP_RACK_NO_RTT) {
+		return 0;
+	}
+
+	now = sys_now();
+	deadline = pcb->rack_rtt + (pcb->rack_min_rtt >> 2);
+	for (seg = pcb->unacked; seg != NULL; seg = next) {
+		next = seg->next;
+		if ((seg->flags & TF_SEG_SACKED) || (s32_t)(pcb->rack_xmit_ts - seg->xmit_ts) <= 0) {
+			continue;
+		}
+		if ((s32_t)(now - seg->xmit_ts - deadline) >= 0) {
+			LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rack_detect_loss: %" U32_F " lost\n", ntohl(seg->tcphdr->seqno)));
+			tcp_rexmit_seg(pcb, seg);
+			lost = 1;
+		}
+	}
+
+	if (lost) {
+		if (TCP_SEQ_GEQ(pcb->lastack, pcb->rack_recover)) {
+			pcb->ssthresh = LWIP_MIN(pcb->cwnd, pcb->snd_wnd) / 2;
+			if (pcb->ssthresh < 2 * pcb->mss) {
+				pcb->ssthresh = 2 * pcb->mss;
+			}
+			pcb->cwnd = pcb->ssthresh;
+			pcb->rack_recover = pcb->snd_nxt;
+		}
+		pcb->flags |= TF_INFR;
 	}
+	return lost;
 }
+#endif							/* LWIP_TCP_RACK */
 
 /**
  * Send keepalive packets to keep a connection active although
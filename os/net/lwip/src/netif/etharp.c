@@ -134,10 +134,18 @@ struct etharp_entry {
 	struct eth_addr ethaddr;
 	u8_t state;
 	u8_t ctime;
+	/** Set when a packet was sent through this entry since its last update */
+	u8_t used;
+	/** Next entry (index + 1) on the same hash chain, 0 ends the chain */
+	u8_t next;
 };
 
 static struct etharp_entry arp_table[ARP_TABLE_SIZE];
 
+/** Hash chains over arp_table, keyed by IP address. Each bucket holds the
+ *  index + 1 of its first entry, 0 for an empty bucket. */
+static u8_t arp_hash[ETHARP_HASH_SIZE];
+
 #if !LWIP_NETIF_HWADDRHINT
 static u8_t etharp_cached_entry;
 #endif							/* !LWIP_NETIF_HWADDRHINT */
@@ -161,6 +169,9 @@ static u8_t etharp_cached_entry;
 #if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7f))
 #error "ARP_TABLE_SIZE must fit in an s8_t, you have to reduce it in your lwipopts.h"
 #endif
+#if (LWIP_ARP && ((ETHARP_HASH_SIZE & (ETHARP_HASH_SIZE - 1)) != 0))
+#error "ETHARP_HASH_SIZE must be a power of two"
+#endif
 
 static err_t etharp_request_dst(struct netif *netif, const ip_addr_t *ipaddr, const struct eth_addr *hw_dst_addr);
 
@@ -190,10 +201,63 @@ static void free_etharp_q(struct etharp_q_entry *q)
 
 #endif							/* ARP_QUEUEING */
 
+/** Hash an IP address to its bucket in arp_hash */
+static u8_t etharp_hash(ip_addr_t *ipaddr)
+{
+	u32_t addr = ip4_addr_get_u32(ipaddr);
+
+	addr ^= addr >> 16;
+	addr ^= addr >> 8;
+	return (u8_t)(addr & (ETHARP_HASH_SIZE - 1));
+}
+
+/** Link entry i onto the hash chain of its IP address */
+static void etharp_hash_insert(u8_t i)
+{
+	u8_t bucket = etharp_hash(&arp_table[i].ipaddr);
+
+	arp_table[i].next = arp_hash[bucket];
+	arp_hash[bucket] = i + 1;
+}
+
+/** Unlink entry i from the hash chain of its IP address, if it is on it */
+static void etharp_hash_remove(u8_t i)
+{
+	u8_t *link = &arp_hash[etharp_hash(&arp_table[i].ipaddr)];
+
+	while (*link != 0) {
+		if (*link == i + 1) {
+			*link = arp_table[i].next;
+			arp_table[i].next = 0;
+			return;
+		}
+		link = &arp_table[*link - 1].next;
+	}
+}
+
+/** Find the pending or stable entry for an IP address on its hash chain
+ *
+ * @return the entry index, or -1 if the address is not in the table
+ */
+static s8_t etharp_hash_lookup(ip_addr_t *ipaddr)
+{
+	u8_t link = arp_hash[etharp_hash(ipaddr)];
+
+	while (link != 0) {
+		u8_t i = link - 1;
+		if ((arp_table[i].state != ETHARP_STATE_EMPTY) && ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
+			return (s8_t)i;
+		}
+		link = arp_table[i].next;
+	}
+	return -1;
+}
+
 /** Clean up ARP table entries */
 static void etharp_free_entry(int i)
 {
-	/* remove from SNMP ARP index tree */
+	/* remove from the hash chains and SNMP ARP index tree */
+	etharp_hash_remove((u8_t)i);
 	snmp_delete_arpidx_tree(arp_table[i].netif, &arp_table[i].ipaddr);
 	/* and empty packet queue */
 	if (arp_table[i].q != NULL) {
@@ -204,6 +268,7 @@ static void etharp_free_entry(int i)
 	}
 	/* recycle entry for re-use */
 	arp_table[i].state = ETHARP_STATE_EMPTY;
+	arp_table[i].used = 0;
 #ifdef LWIP_DEBUG
 	/* for debugging, clean out the complete entry */
 	arp_table[i].ctime = 0;
@@ -213,11 +278,35 @@ static void etharp_free_entry(int i)
 #endif							/* LWIP_DEBUG */
 }
 
+/**
+ * Re-request a stable ARP entry that is about to expire: first by unicast to
+ * the cached hardware address, then by broadcast for the last seconds.
+ * Only entries in ETHARP_STATE_STABLE are re-requested, to prevent flooding
+ * the network with ARP requests if this address is used frequently.
+ */
+static void etharp_rerequest(struct netif *netif, u8_t i)
+{
+	if (arp_table[i].state == ETHARP_STATE_STABLE) {
+		if (arp_table[i].ctime >= ARP_AGE_REREQUEST_USED_BROADCAST) {
+			/* issue a standard request using broadcast */
+			if (etharp_request(netif, &arp_table[i].ipaddr) == ERR_OK) {
+				arp_table[i].state = ETHARP_STATE_STABLE_REREQUESTING_1;
+			}
+		} else if (arp_table[i].ctime >= ARP_AGE_REREQUEST_USED_UNICAST) {
+			/* issue a unicast request (for 15 seconds) to prevent unnecessary broadcast */
+			if (etharp_request_dst(netif, &arp_table[i].ipaddr, &arp_table[i].ethaddr) == ERR_OK) {
+				arp_table[i].state = ETHARP_STATE_STABLE_REREQUESTING_1;
+			}
+		}
+	}
+}
+
 /**
  * Clears expired entries in the ARP table.
  *
  * This function should be called every ARP_TMR_INTERVAL milliseconds (1 second),
- * in order to expire entries in the ARP table.
+ * in order to expire entries in the ARP table. With ETHARP_PROACTIVE_REFRESH,
+ * used entries are also re-requested shortly before they would expire.
  */
 void etharp_tmr(void)
 {
@@ -249,6 +338,13 @@ void etharp_tmr(void)
 				/* still pending, resend an ARP query */
 				etharp_request(arp_table[i].netif, &arp_table[i].ipaddr);
 			}
+#if ETHARP_PROACTIVE_REFRESH
+			else if (arp_table[i].used) {
+				/* refresh a used entry before it expires, even if no packet
+				   happens to be sent to it during the re-request window */
+				etharp_rerequest(arp_table[i].netif, i);
+			}
+#endif							/* ETHARP_PROACTIVE_REFRESH */
 		}
 	}
 }
@@ -285,18 +381,33 @@ static s8_t etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 	u16_t age_queue = 0, age_pending = 0, age_stable = 0;
 
 	/**
-	 * a) do a search through the cache, remember candidates
-	 * b) select candidate entry
-	 * c) create new entry
+	 * a) look up the address on its hash chain
+	 * b) do a search through the cache, remember candidates
+	 * c) select candidate entry
+	 * d) create new entry
 	 */
 
-	/* a) in a single search sweep, do all of this
+	/* a) search for a matching IP entry, either pending or stable */
+	if (ipaddr != NULL) {
+		s8_t match = etharp_hash_lookup(ipaddr);
+		if (match >= 0) {
+			LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %" U16_F "\n", (u16_t)match));
+			/* found exact IP address match, simply bail out */
+			return match;
+		}
+	}
+
+	/* don't create new entry, only search? */
+	if ((flags & ETHARP_FLAG_FIND_ONLY) != 0) {
+		LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no matching entry found\n"));
+		return (s8_t)ERR_MEM;
+	}
+
+	/* b) in a single search sweep, do all of this
 	 * 1) remember the first empty entry (if any)
 	 * 2) remember the oldest stable entry (if any)
 	 * 3) remember the oldest pending entry without queued packets (if any)
 	 * 4) remember the oldest pending entry with queued packets (if any)
-	 * 5) search for a matching IP entry, either pending or stable
-	 *    until 5 matches, or all entries are searched for.
 	 */
 
 	for (i = 0; i < ARP_TABLE_SIZE; ++i) {
@@ -308,12 +419,6 @@ static s8_t etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 			empty = i;
 		} else if (state != ETHARP_STATE_EMPTY) {
 			LWIP_ASSERT("state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE", state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE);
-			/* if given, does IP address match IP address in ARP entry? */
-			if (ipaddr && ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
-				LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %" U16_F "\n", (u16_t)i));
-				/* found exact IP address match, simply bail out */
-				return i;
-			}
 			/* pending entry? */
 			if (state == ETHARP_STATE_PENDING) {
 				/* pending with queued packets? */
@@ -348,15 +453,13 @@ static s8_t etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 	}
 	/* { we have no match } => try to create a new entry */
 
-	/* don't create new entry, only search? */
-	if (((flags & ETHARP_FLAG_FIND_ONLY) != 0) ||
-		/* or no empty entry found and not allowed to recycle? */
-		((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_FLAG_TRY_HARD) == 0))) {
+	/* no empty entry found and not allowed to recycle? */
+	if ((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_FLAG_TRY_HARD) == 0)) {
 		LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
 		return (s8_t)ERR_MEM;
 	}
 
-	/* b) choose the least destructive entry to recycle:
+	/* c) choose the least destructive entry to recycle:
 	 * 1) empty entry
 	 * 2) oldest stable entry
 	 * 3) oldest pending entry without queued packets
@@ -369,6 +472,8 @@ static s8_t etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 	if (empty < ARP_TABLE_SIZE) {
 		i = empty;
 		LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting empty entry %" U16_F "\n", (u16_t)i));
+		/* an entry handed out earlier may have been left empty on its chain */
+		etharp_hash_remove(i);
 	} else {
 		/* 2) found recyclable stable entry? */
 		if (old_stable < ARP_TABLE_SIZE) {
@@ -403,10 +508,12 @@ static s8_t etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 
 	/* IP address given? */
 	if (ipaddr != NULL) {
-		/* set IP address */
+		/* set IP address and make the entry reachable through its hash chain */
 		ip_addr_copy(arp_table[i].ipaddr, *ipaddr);
+		etharp_hash_insert(i);
 	}
 	arp_table[i].ctime = 0;
+	arp_table[i].used = 0;
 	return (err_t)i;
 }
 
@@ -489,8 +596,9 @@ static err_t etharp_update_arp_entry(struct netif *netif, ip_addr_t *ipaddr, str
 	LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_update_arp_entry: updating stable entry %" S16_F "\n", (s16_t)i));
 	/* update address */
 	ETHADDR32_COPY(&arp_table[i].ethaddr, ethaddr);
-	/* reset time stamp */
+	/* reset time stamp and usage */
 	arp_table[i].ctime = 0;
+	arp_table[i].used = 0;
 	/* this is where we will send out queued packets! */
 #if ARP_QUEUEING
 	while (arp_table[i].q != NULL) {
@@ -830,22 +938,9 @@ static void etharp_arp_input(struct netif *netif, struct eth_addr *ethaddr, stru
 static err_t etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u8_t arp_idx)
 {
 	LWIP_ASSERT("arp_table[arp_idx].state >= ETHARP_STATE_STABLE", arp_table[arp_idx].state >= ETHARP_STATE_STABLE);
-	/* if arp table entry is about to expire: re-request it,
-	   but only if its state is ETHARP_STATE_STABLE to prevent flooding the
-	   network with ARP requests if this address is used frequently. */
-	if (arp_table[arp_idx].state == ETHARP_STATE_STABLE) {
-		if (arp_table[arp_idx].ctime >= ARP_AGE_REREQUEST_USED_BROADCAST) {
-			/* issue a standard request using broadcast */
-			if (etharp_request(netif, &arp_table[arp_idx].ipaddr) == ERR_OK) {
-				arp_table[arp_idx].state = ETHARP_STATE_STABLE_REREQUESTING_1;
-			}
-		} else if (arp_table[arp_idx].ctime >= ARP_AGE_REREQUEST_USED_UNICAST) {
-			/* issue a unicast request (for 15 seconds) to prevent unnecessary broadcast */
-			if (etharp_request_dst(netif, &arp_table[arp_idx].ipaddr, &arp_table[arp_idx].ethaddr) == ERR_OK) {
-				arp_table[arp_idx].state = ETHARP_STATE_STABLE_REREQUESTING_1;
-			}
-		}
-	}
+	arp_table[arp_idx].used = 1;
+	/* if arp table entry is about to expire: re-request it */
+	etharp_rerequest(netif, arp_idx);
 
 	return etharp_send_ip(netif, q, (struct eth_addr *)(netif->hwaddr), &arp_table[arp_idx].ethaddr);
 }
@@ -946,14 +1041,13 @@ err_t etharp_output(struct netif *netif, struct pbuf *q, ip_addr_t *ipaddr)
 		}
 #endif							/* LWIP_NETIF_HWADDRHINT */
 
-		/* find stable entry: do this here since this is a critical path for
-		   throughput and etharp_find_entry() is kind of slow */
-		for (i = 0; i < ARP_TABLE_SIZE; i++) {
-			if ((arp_table[i].state >= ETHARP_STATE_STABLE) && (ip_addr_cmp(dst_addr, &arp_table[i].ipaddr))) {
-				/* found an existing, stable entry */
-				ETHARP_SET_HINT(netif, i);
-				return etharp_output_to_arp_index(netif, q, i);
-			}
+		/* find stable entry on its hash chain: do this here since this is a
+		   critical path for throughput and etharp_find_entry() is kind of slow */
+		i = etharp_hash_lookup(dst_addr);
+		if ((i >= 0) && (arp_table[i].state >= ETHARP_STATE_STABLE)) {
+			/* found an existing, stable entry */
+			ETHARP_SET_HINT(netif, i);
+			return etharp_output_to_arp_index(netif, q, i);
 		}
 		/* no stable entry found, use the (slower) query function:
 		   queue on destination Ethernet address belonging to ipaddr */
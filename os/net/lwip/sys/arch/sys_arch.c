@@ -31,6 +31,7 @@
 #include <tinyara/cancelpt.h>
 #include <tinyara/kthread.h>
 #include <sys/types.h>
+#include <stdbool.h>
 
 /* lwIP includes. */
 #include <net/lwip/stats.h>
@@ -51,11 +52,119 @@
 
 static u16_t s_nextthread = 0;
 
+/*---------------------------------------------------------------------------*
+ * Mailbox ring
+ *---------------------------------------------------------------------------*
+ * The messages are kept in a lock-free ring: 'head' and 'tail' are free
+ * running positions that producers and consumers claim with a compare and
+ * swap, and each slot has a sequence number that tells whether it is free
+ * for the position (seq == pos) or holds its message (seq == pos + 1).
+ * A producer that claimed a slot but did not store its message yet makes
+ * the ring look empty to the consumer, and the consumer that claimed a
+ * slot makes it look full to the producers, so neither side ever waits on
+ * the other inside the ring.
+ *
+ * Posting never takes a lock.  'wait_fetch' counts the fetchers sleeping
+ * on 'mail', and a poster only signals 'mail' if it can take one of them
+ * off the count, so that the tcpip thread does not go through the
+ * scheduler for every message while it is busy.  Posters sleeping on a
+ * full mailbox are counted and woken through 'space' in the same way.
+ * A stale signal only makes a waiter look at the ring once more.
+ *---------------------------------------------------------------------------*/
+
+static bool sys_mbox_enqueue(sys_mbox_t *mbox, void *msg)
+{
+	u32_t pos = __atomic_load_n(&mbox->head, __ATOMIC_RELAXED);
+	u32_t index;
+	s16_t dif;
+
+	for (;;) {
+		index = pos & mbox->mask;
+		dif = (s16_t)(__atomic_load_n(&mbox->seq[index], __ATOMIC_ACQUIRE) - (u16_t)pos);
+		if (dif == 0) {
+			/* On failure, 'pos' is updated to the current head */
+			if (__atomic_compare_exchange_n(&mbox->head, &pos, pos + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			/* The slot still holds the message posted one lap earlier */
+			return false;
+		} else {
+			pos = __atomic_load_n(&mbox->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	mbox->msgs[index] = msg;
+	__atomic_store_n(&mbox->seq[index], (u16_t)(pos + 1), __ATOMIC_RELEASE);
+	return true;
+}
+
+static bool sys_mbox_dequeue(sys_mbox_t *mbox, void **msg)
+{
+	u32_t pos = __atomic_load_n(&mbox->tail, __ATOMIC_RELAXED);
+	u32_t index;
+	s16_t dif;
+
+	for (;;) {
+		index = pos & mbox->mask;
+		dif = (s16_t)(__atomic_load_n(&mbox->seq[index], __ATOMIC_ACQUIRE) - (u16_t)(pos + 1));
+		if (dif == 0) {
+			if (__atomic_compare_exchange_n(&mbox->tail, &pos, pos + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			/* Nothing was posted at this position yet */
+			return false;
+		} else {
+			pos = __atomic_load_n(&mbox->tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	if (msg != NULL) {
+		*msg = mbox->msgs[index];
+	}
+	__atomic_store_n(&mbox->seq[index], (u16_t)(pos + mbox->mask + 1), __ATOMIC_RELEASE);
+	return true;
+}
+
+/* Wake one of the tasks counted in 'waiting', if any */
+
+static void sys_mbox_wake(u32_t *waiting, sys_sem_t *sem)
+{
+	u32_t n;
+
+	/* Order the ring update before the load of the count; the waiter
+	   orders its count update before it looks at the ring. */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	n = __atomic_load_n(waiting, __ATOMIC_RELAXED);
+	while (n > 0) {
+		if (__atomic_compare_exchange_n(waiting, &n, n - 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			sys_sem_signal(sem);
+			return;
+		}
+	}
+}
+
+/* Stop waiting without having been woken.  If a waker took this task off
+   the count already, its signal is left to the next wait. */
+
+static void sys_mbox_unwait(u32_t *waiting)
+{
+	u32_t n = __atomic_load_n(waiting, __ATOMIC_RELAXED);
+
+	while (n > 0) {
+		if (__atomic_compare_exchange_n(waiting, &n, n - 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			return;
+		}
+	}
+}
+
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_new
  *---------------------------------------------------------------------------*
  * Description:
- *      Creates a new mailbox
+ *      Creates a new mailbox.  The mailbox holds 'queue_sz' messages
+ *      rounded up to a power of 2, at most SYS_MBOX_MAXSIZE.
  * Inputs:
  *      sys_mbox_t mbox         -- Handle of mailbox
  *      int queue_sz            -- Size of elements in the mailbox
@@ -64,16 +173,29 @@ static u16_t s_nextthread = 0;
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
 {
-
 	err_t err = ERR_OK;
+	u32_t size = 1;
+	u32_t i;
+
+	if (queue_sz <= 0 || queue_sz > SYS_MBOX_MAXSIZE) {
+		queue_sz = SYS_MBOX_MAXSIZE;
+	}
+	while (size < (u32_t)queue_sz) {
+		size <<= 1;
+	}
+
 	mbox->is_valid = 1;
 	mbox->id = lwip_stats.sys.mbox.used + 1;
-	mbox->queue_size = queue_sz;
+	mbox->mask = size - 1;
+	mbox->head = 0;
+	mbox->tail = 0;
+	for (i = 0; i < size; i++) {
+		mbox->seq[i] = (u16_t)i;
+	}
 	mbox->wait_send = 0;
 	mbox->wait_fetch = 0;
-	mbox->front = mbox->rear = 0;
 	sys_sem_new(&(mbox->mail), 0);
-	sys_sem_new(&(mbox->mutex), 1);
+	sys_sem_new(&(mbox->space), 0);
 
 #if SYS_STATS
 	SYS_STATS_INC_USED(mbox);
@@ -101,11 +223,11 @@ void sys_mbox_free(sys_mbox_t *mbox)
 
 		mbox->is_valid = 0;
 		mbox->id = 0;
-		mbox->queue_size = 0;
+		mbox->mask = 0;
 		mbox->wait_send = 0;
 		mbox->wait_fetch = 0;
 		sys_sem_free(&(mbox->mail));
-		sys_sem_free(&(mbox->mutex));
+		sys_sem_free(&(mbox->space));
 
 		LWIP_DEBUGF(SYS_DEBUG, ("Succesfully deleted MBOX with id %d", mbox->id));
 #if SYS_STATS
@@ -127,48 +249,25 @@ void sys_mbox_free(sys_mbox_t *mbox)
  *---------------------------------------------------------------------------*/
 void sys_mbox_post(sys_mbox_t *mbox, void *msg)
 {
-	u8_t first_msg = 0;
-	u32_t tmp = 0;
-	u32_t status = OK;
-	status = sys_arch_sem_wait(&(mbox->mutex), 0);
-	if (status == SYS_ARCH_CANCELED) {
-		return;
-	}
 	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+
 	/* Wait while the queue is full */
-	tmp = (mbox->rear + 1) % mbox->queue_size;
-	if (tmp == mbox->front) {
+	while (!sys_mbox_enqueue(mbox, msg)) {
 		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, Wait until gets free\n"));
-	}
-	while (tmp == mbox->front) {
-		mbox->wait_send++;
-		sys_sem_signal(&(mbox->mutex));
-		sys_arch_sem_wait(&(mbox->mail), 0);
-		status = sys_arch_sem_wait(&(mbox->mutex), 0);
-		mbox->wait_send--;
-		if (status == SYS_ARCH_CANCELED) {
+		__atomic_fetch_add(&mbox->wait_send, 1, __ATOMIC_SEQ_CST);
+		if (sys_mbox_enqueue(mbox, msg)) {
+			sys_mbox_unwait(&mbox->wait_send);
+			break;
+		}
+		if (sys_arch_sem_wait(&(mbox->space), 0) == SYS_ARCH_CANCELED) {
+			sys_mbox_unwait(&mbox->wait_send);
 			return;
 		}
 	}
-
-	if (mbox->rear == mbox->front) {
-		first_msg = 1;
-	} else {
-		first_msg = 0;
-	}
-
-	mbox->rear = tmp;
-	mbox->msgs[mbox->rear] = msg;
 	LWIP_DEBUGF(SYS_DEBUG, ("Post SUCCESS\n"));
 
-	/* If msg was posted to an empty queue, Release semaphore for
-	   some fetch api blocked on this sem due to Empty queue. */
-	if (first_msg && mbox->wait_fetch) {
-		sys_sem_signal(&(mbox->mail));
-	}
-
-	sys_sem_signal(&(mbox->mutex));
-	return;
+	/* Release a fetch api blocked on the empty queue */
+	sys_mbox_wake(&mbox->wait_fetch, &mbox->mail);
 }
 
 /*---------------------------------------------------------------------------*
@@ -186,40 +285,18 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg)
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
 {
-	err_t err = ERR_OK;
-	u8_t first_msg = 0;
-	u32_t tmp = 0;
-	sys_arch_sem_wait(&(mbox->mutex), 0);
-
 	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
-	/* Check if the queue is full */
-	tmp = (mbox->rear + 1) % mbox->queue_size;
-	if (tmp == mbox->front) {
-		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, returning error\n"));
-		err = ERR_MEM;
-		goto errout_with_mutex;
-	}
 
-	if (mbox->rear == mbox->front) {
-		first_msg = 1;
-	} else {
-		first_msg = 0;
+	if (!sys_mbox_enqueue(mbox, msg)) {
+		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, returning error\n"));
+		return ERR_MEM;
 	}
-
-	mbox->rear = tmp;
-	mbox->msgs[mbox->rear] = msg;
 	LWIP_DEBUGF(SYS_DEBUG, ("Post SUCCESS\n"));
 
-	/* If msg was posted to an empty queue, Release semaphore for
-	   some fetch api blocked on this sem due to Empty queue. */
-	if (first_msg && mbox->wait_fetch) {
-		sys_sem_signal(&(mbox->mail));
-	}
-
-errout_with_mutex:
-	sys_sem_signal(&(mbox->mutex));
+	/* Release a fetch api blocked on the empty queue */
+	sys_mbox_wake(&mbox->wait_fetch, &mbox->mail);
 
-	return err;
+	return ERR_OK;
 }
 
 /*---------------------------------------------------------------------------*
@@ -251,57 +328,46 @@ errout_with_mutex:
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
 {
 	u32_t time = 0;
-	u32_t status = OK;
-
-	/* The mutex lock is quick so we don't bother with the timeout
-	   stuff here. */
-	status = sys_arch_sem_wait(&(mbox->mutex), 0);
-	if (status == SYS_ARCH_CANCELED) {
-		return SYS_ARCH_CANCELED;
-	}
+	u32_t status;
 
 	/* wait while the queue is empty */
-	while (mbox->front == mbox->rear) {
-		mbox->wait_fetch++;
-		sys_sem_signal(&(mbox->mutex));
+	while (!sys_mbox_dequeue(mbox, msg)) {
+		__atomic_fetch_add(&mbox->wait_fetch, 1, __ATOMIC_SEQ_CST);
+		if (sys_mbox_dequeue(mbox, msg)) {
+			sys_mbox_unwait(&mbox->wait_fetch);
+			break;
+		}
 
 		/* We block while waiting for a mail to arrive in the mailbox. We
 		   must be prepared to timeout. */
 		if (timeout != 0) {
-			time = sys_arch_sem_wait(&(mbox->mail), timeout);
-
-			if (time == SYS_ARCH_TIMEOUT) {
-				sys_arch_sem_wait(&(mbox->mutex), 0);
-				mbox->wait_fetch--;
-				sys_sem_signal(&(mbox->mutex));
+			if (time >= timeout) {
+				sys_mbox_unwait(&mbox->wait_fetch);
 				return SYS_ARCH_TIMEOUT;
 			}
+			status = sys_arch_sem_wait(&(mbox->mail), timeout - time);
 		} else {
-			sys_arch_sem_wait(&(mbox->mail), 0);
+			status = sys_arch_sem_wait(&(mbox->mail), 0);
 		}
 
-		status = sys_arch_sem_wait(&(mbox->mutex), 0);
-		mbox->wait_fetch--;
-		if (status == SYS_ARCH_CANCELED) {
-			return SYS_ARCH_CANCELED;
-		}		
+		if (status == SYS_ARCH_CANCELED || status == SYS_ARCH_TIMEOUT) {
+			sys_mbox_unwait(&mbox->wait_fetch);
+			if (status == SYS_ARCH_TIMEOUT && sys_mbox_dequeue(mbox, msg)) {
+				break;
+			}
+			return status;
+		}
+		time += status;
 	}
 
-	mbox->front = (mbox->front + 1) % mbox->queue_size;
 	if (msg != NULL) {
-		*msg = mbox->msgs[mbox->front];
 		LWIP_DEBUGF(SYS_DEBUG, (" mbox %p msg %p\n", (void *)mbox, *msg));
 	} else {
 		LWIP_DEBUGF(SYS_DEBUG, (" mbox %p, null msg\n", (void *)mbox));
 	}
 
-	/* We just fetched a msg, Release semaphore for
-	   some post api blocked on this sem due to queue full. */
-	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
-	}
-
-	sys_sem_signal(&(mbox->mutex));
+	/* We just fetched a msg, Release a post api blocked on the full queue */
+	sys_mbox_wake(&mbox->wait_send, &mbox->space);
 
 	return time;
 }
@@ -322,35 +388,22 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
 {
-	u32_t err = ERR_OK;
-	/* The mutex lock is quick so we don't bother with the timeout
-	   stuff here. */
-	sys_arch_sem_wait(&(mbox->mutex), 0);
-
 	/* check if the queue is empty */
-	if (mbox->front == mbox->rear) {
+	if (!sys_mbox_dequeue(mbox, msg)) {
 		LWIP_DEBUGF(SYS_DEBUG, ("SYS_MBOX_EMPTY , returning\n"));
-		err = SYS_MBOX_EMPTY;
-		goto errout_with_mutex;
+		return SYS_MBOX_EMPTY;
 	}
 
-	mbox->front = (mbox->front + 1) % mbox->queue_size;
 	if (msg != NULL) {
 		LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, *msg));
-		*msg = mbox->msgs[mbox->front];
 	} else {
 		LWIP_DEBUGF(SYS_DEBUG, ("mbox %p, null msg\n", (void *)mbox));
 	}
 
-	/* We just fetched a msg, Release semaphore for
-	   some post api blocked on this sem due to queue full. */
-	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
-	}
+	/* We just fetched a msg, Release a post api blocked on the full queue */
+	sys_mbox_wake(&mbox->wait_send, &mbox->space);
 
-errout_with_mutex:
-	sys_sem_signal(&(mbox->mutex));
-	return err;
+	return ERR_OK;
 }
 
 /*---------------------------------------------------------------------------*
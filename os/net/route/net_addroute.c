@@ -62,6 +62,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <arpa/inet.h>
+
 #include <tinyara/net/net.h>
 #include <tinyara/net/ip.h>
 
@@ -99,6 +101,8 @@
 int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
 	FAR struct net_route_s *route;
+	FAR struct net_route_s *prev;
+	FAR struct net_route_s *curr;
 	net_lock_t save;
 
 	/* Allocate a route entry */
@@ -119,9 +123,27 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
 	save = net_lock();
 
-	/* Then add the new entry to the table */
+	/* Then add the new entry to the table after all routes with a netmask at
+	 * least as long, so that lookups find the longest prefix match first.
+	 * Netmasks are contiguous, so a longer one is a larger host order value.
+	 */
+
+	prev = NULL;
+	for (curr = (FAR struct net_route_s *)g_routes.head; curr; curr = curr->flink) {
+		if (NTOHL(curr->netmask) < NTOHL(netmask)) {
+			break;
+		}
+
+		prev = curr;
+	}
+
+	if (prev) {
+		sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
+	} else {
+		sq_addfirst((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
+	}
 
-	sq_addlast((FAR sq_entry_t *) route, (FAR sq_queue_t *)&g_routes);
+	net_flushroutecache();
 	net_unlock(save);
 	return OK;
 }
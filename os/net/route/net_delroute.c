@@ -61,6 +61,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <tinyara/net/net.h>
 #include <tinyara/net/ip.h>
 
 #include "route/route.h"
@@ -148,6 +149,8 @@ static int net_match(FAR struct net_route_s *route, FAR void *arg)
 int net_delroute(in_addr_t target, in_addr_t netmask)
 {
 	struct route_match_s match;
+	net_lock_t save;
+	int ret;
 
 	/* Set up the comparison structure */
 
@@ -155,9 +158,18 @@ int net_delroute(in_addr_t target, in_addr_t netmask)
 	net_ipv4addr_copy(match.target, target);
 	net_ipv4addr_copy(match.netmask, netmask);
 
-	/* Then remove the entry from the routing table */
+	/* Then remove the entry from the routing table, and forget any lookup
+	 * that may have been answered by it before anyone can use it again.
+	 */
+
+	save = net_lock();
+	ret = net_foreachroute(net_match, &match) ? OK : -ENOENT;
+	if (ret == OK) {
+		net_flushroutecache();
+	}
 
-	return net_foreachroute(net_match, &match) ? OK : -ENOENT;
+	net_unlock(save);
+	return ret;
 }
 
 #endif							/* CONFIG_NET && CONFIG_NET_ROUTE  */
@@ -80,12 +80,13 @@
  * Function: net_foreachroute
  *
  * Description:
- *   Traverse the route table
+ *   Traverse the route table, from the longest to the shortest netmask,
+ *   until the handler returns a non-zero value
  *
  * Parameters:
  *
  * Returned Value:
- *   0 if in use; 1 if avaialble and the new entry was added
+ *   The last value returned by the handler
  *
  ****************************************************************************/
 
@@ -102,7 +103,7 @@ int net_foreachroute(route_handler_t handler, FAR void *arg)
 
 	/* Visit each entry in the routing table */
 
-	for (route = (FAR struct net_route_s *)g_routes.head; route; route = next) {
+	for (route = (FAR struct net_route_s *)g_routes.head; route && ret == 0; route = next) {
 		/* Get the next entry in the to visit.  We do this BEFORE calling the
 		 * handler because the hanlder may delete this entry.
 		 */
@@ -61,6 +61,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <tinyara/net/net.h>
 #include <tinyara/net/ip.h>
 
 #include "route/route.h"
@@ -85,6 +86,25 @@ struct route_ipv6_match_s {
 };
 #endif
 
+#if defined(CONFIG_NET_IPv4) && CONFIG_NET_ROUTE_CACHESIZE > 0
+struct route_cache_s {
+	in_addr_t target;			/* A recently looked up IPv4 address */
+	in_addr_t router;			/* Its router; 0 if the entry is unused */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Direct mapped cache of recent IPv4 lookups, indexed by a hash of the
+ * target address.  Protected by net_lock().
+ */
+
+#if defined(CONFIG_NET_IPv4) && CONFIG_NET_ROUTE_CACHESIZE > 0
+static struct route_cache_s g_routecache[CONFIG_NET_ROUTE_CACHESIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -110,8 +130,8 @@ static int net_ipv4_match(FAR struct net_route_s *route, FAR void *arg)
 	FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
 	/* To match, the masked target addresses must be the same.  In the event
-	 * of multiple matches, only the first is returned.  There is not (yet) any
-	 * concept for the precedence of networks.
+	 * of multiple matches, only the first is returned; the table is ordered
+	 * by netmask length, so that is the longest prefix match.
 	 */
 
 	if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask)) {
@@ -123,6 +143,25 @@ static int net_ipv4_match(FAR struct net_route_s *route, FAR void *arg)
 
 	return 0;
 }
+
+/****************************************************************************
+ * Function: net_routecache_index
+ *
+ * Description:
+ *   Return the route cache slot of an IPv4 address
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+static inline unsigned int net_routecache_index(in_addr_t target)
+{
+	uint32_t hash = (uint32_t)target;
+
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+	return hash & (CONFIG_NET_ROUTE_CACHESIZE - 1);
+}
+#endif
 #endif							/* CONFIG_NET_IPv4 */
 
 /****************************************************************************
@@ -169,6 +208,28 @@ static int net_ipv6_match(FAR struct net_route_s *route, FAR void *arg)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: net_flushroutecache
+ *
+ * Description:
+ *   Forget all cached route lookups.  Must be called whenever the routing
+ *   table changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+void net_flushroutecache(void)
+{
+#ifdef CONFIG_NET_IPv4
+	net_lock_t save;
+
+	save = net_lock();
+	memset(g_routecache, 0, sizeof(g_routecache));
+	net_unlock(save);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Function: net_ipv4_router
  *
@@ -190,6 +251,10 @@ static int net_ipv6_match(FAR struct net_route_s *route, FAR void *arg)
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
 	struct route_ipv4_match_s match;
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+	FAR struct route_cache_s *cache;
+	net_lock_t save;
+#endif
 	int ret;
 
 	/* Do not route the special broadcast IP address */
@@ -198,6 +263,18 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 		return -ENOENT;
 	}
 
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+	/* Has this destination been looked up since the table last changed? */
+
+	save = net_lock();
+	cache = &g_routecache[net_routecache_index(target)];
+	if (cache->router != 0 && net_ipv4addr_cmp(cache->target, target)) {
+		net_ipv4addr_copy(*router, cache->router);
+		net_unlock(save);
+		return OK;
+	}
+#endif
+
 	/* Set up the comparison structure */
 
 	memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -213,12 +290,22 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 
 		net_ipv4addr_copy(*router, match.router);
 		ret = OK;
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+		/* Remember it for the next packet to this destination */
+
+		net_ipv4addr_copy(cache->target, target);
+		net_ipv4addr_copy(cache->router, match.router);
+#endif
 	} else {
 		/* There is no route for this address */
 
 		ret = -ENOENT;
 	}
 
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+	net_unlock(save);
+#endif
 	return ret;
 }
 #endif							/* CONFIG_NET_IPv4 */
@@ -109,8 +109,8 @@ static int net_ipv4_devmatch(FAR struct net_route_s *route, FAR void *arg)
 	/* To match, (1) the masked target addresses must be the same, and (2) the
 	 * router address must like on the network provided by the device.
 	 *
-	 * In the event of multiple matches, only the first is returned.  There
-	 * not (yet) any concept for the precedence of networks.
+	 * In the event of multiple matches, only the first is returned; the
+	 * table is ordered by netmask length, so that is the longest prefix match.
 	 */
 
 	if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) && net_ipv4addr_maskcmp(route->router, dev->d_ipaddr, dev->d_netmask)) {
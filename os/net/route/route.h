@@ -77,6 +77,14 @@
 #define CONFIG_NET_MAXROUTES 4
 #endif
 
+#ifndef CONFIG_NET_ROUTE_CACHESIZE
+#define CONFIG_NET_ROUTE_CACHESIZE 0
+#endif
+
+#if (CONFIG_NET_ROUTE_CACHESIZE & (CONFIG_NET_ROUTE_CACHESIZE - 1)) != 0
+#error CONFIG_NET_ROUTE_CACHESIZE must be a power of two
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -104,7 +112,9 @@ extern "C" {
 #define EXTERN extern
 #endif
 
-/* This is the routing table */
+/* This is the routing table, ordered from the longest to the shortest
+ * netmask so that the first matching route is the longest prefix match.
+ */
 
 EXTERN sq_queue_t g_routes;
 
@@ -195,6 +205,27 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router);
 
 int net_delroute(in_addr_t target, in_addr_t netmask);
 
+/****************************************************************************
+ * Function: net_flushroutecache
+ *
+ * Description:
+ *   Forget all cached route lookups.  Must be called whenever the routing
+ *   table changes.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+void net_flushroutecache(void);
+#else
+#define net_flushroutecache()
+#endif
+
 /****************************************************************************
  * Function: net_ipv4_router
  *
@@ -293,12 +324,13 @@ void netdev_ipv6_router(FAR struct netif *dev, FAR const net_ipv6addr_t target,
  * Function: net_foreachroute
  *
  * Description:
- *   Traverse the route table
+ *   Traverse the route table, from the longest to the shortest netmask,
+ *   until the handler returns a non-zero value
  *
  * Parameters:
  *
  * Returned Value:
- *   OK on success; Negated errno on failure.
+ *   The last value returned by the handler
  *
  ****************************************************************************/
 
@@ -158,6 +158,37 @@ int sendto(int s, const void *data, size_t size, int flags, const struct sockadd
 	return result;
 }
 
+#ifdef CONFIG_NET_SOCKET_SENDMSG
+ssize_t sendmsg(int s, const struct msghdr *msg, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_sendmsg(s, msg, flags);
+	leave_cancellation_point();
+	return result;
+}
+#endif
+
+#ifdef CONFIG_NET_SOCKET_MMSG
+int recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_recvmmsg(s, msgvec, vlen, flags, timeout);
+	leave_cancellation_point();
+	return result;
+}
+
+int sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_sendmmsg(s, msgvec, vlen, flags);
+	leave_cancellation_point();
+	return result;
+}
+#endif
+
 int socket(int domain, int type, int protocol)
 {
 	return lwip_socket(domain, type, protocol);
@@ -54,6 +54,10 @@
 
 #include <string.h>
 
+#if defined(CONFIG_HW_AES_AEAD)
+#include "tls/see_api.h"
+#endif
+
 #if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_AES_C)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "tls/platform.h"
@@ -107,6 +111,14 @@ int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx, mbedtls_cipher_id_t cipher, con
 		return (ret);
 	}
 
+#if defined(CONFIG_HW_AES_AEAD)
+	ctx->hw_keylen = 0;
+	if (cipher == MBEDTLS_CIPHER_ID_AES) {
+		memcpy(ctx->hw_key, key, keybits / 8);
+		ctx->hw_keylen = keybits / 8;
+	}
+#endif
+
 	return (0);
 }
 
@@ -317,8 +329,48 @@ static int ccm_auth_crypt(mbedtls_ccm_context *ctx, int mode, size_t length, con
 /*
  * Authenticated encryption
  */
+#if defined(CONFIG_HW_AES_AEAD)
+/*
+ * One-shot CCM on the SSS. Returns non-zero when the request does not
+ * fit the hardware, and the caller falls back to ccm_auth_crypt().
+ */
+static int ccm_hw_crypt(mbedtls_ccm_context *ctx, int mode, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input, unsigned char *output, unsigned char *tag, size_t tag_len)
+{
+	struct sAES_PARAM param;
+
+	if (ctx->hw_keylen == 0 || length < CONFIG_HW_CRYPTO_MIN_SIZE || iv_len < 7 || iv_len > 13 || add_len > MAX_AES_AAD_BLEN || tag_len < 4 || tag_len > 16 || tag_len % 2 != 0) {
+		return (-1);
+	}
+
+	memset(&param, 0, sizeof(param));
+	if (mode == CCM_ENCRYPT) {
+		param.pu8Plaintext = (unsigned char *)input;
+		param.pu8Ciphertext = output;
+	} else {
+		param.pu8Plaintext = output;
+		param.pu8Ciphertext = (unsigned char *)input;
+	}
+	param.u32Plaintext_byte_len = length;
+	param.u32Ciphertext_byte_len = length;
+	param.pu8iv = (unsigned char *)iv;
+	param.u32iv_byte_len = iv_len;
+	param.pu8aad = (unsigned char *)add;
+	param.u32aad_byte_len = add_len;
+	param.pu8Tag = tag;
+	param.u32Tag_byte_len = tag_len;
+	param.u32Mode = SEE_AES_OID(ctx->hw_keylen, AES_CCM_MODE);
+
+	return see_aes_aead(&param, ctx->hw_key, ctx->hw_keylen, mode == CCM_ENCRYPT ? AES_ENCTYPT : AES_DECRYPT);
+}
+#endif
+
 int mbedtls_ccm_encrypt_and_tag(mbedtls_ccm_context *ctx, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input, unsigned char *output, unsigned char *tag, size_t tag_len)
 {
+#if defined(CONFIG_HW_AES_AEAD)
+	if (ccm_hw_crypt(ctx, CCM_ENCRYPT, length, iv, iv_len, add, add_len, input, output, tag, tag_len) == 0) {
+		return (0);
+	}
+#endif
 	return (ccm_auth_crypt(ctx, CCM_ENCRYPT, length, iv, iv_len, add, add_len, input, output, tag, tag_len));
 }
 
@@ -332,6 +384,17 @@ int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length, const unsi
 	unsigned char i;
 	int diff;
 
+#if defined(CONFIG_HW_AES_AEAD)
+	/*
+	 * The engine is handed the received tag; it is compared again below
+	 * so a mismatch is reported the same way on both paths.
+	 */
+	memset(check_tag, 0, sizeof(check_tag));
+	if (tag_len <= 16) {
+		memcpy(check_tag, tag, tag_len);
+	}
+	if (ccm_hw_crypt(ctx, CCM_DECRYPT, length, iv, iv_len, add, add_len, input, output, check_tag, tag_len) != 0)
+#endif
 	if ((ret = ccm_auth_crypt(ctx, CCM_DECRYPT, length, iv, iv_len, add, add_len, input, output, check_tag, tag_len)) != 0) {
 		return (ret);
 	}
@@ -18,6 +18,7 @@
 
 #include <tinyara/config.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <tls/easy_tls.h>
 
@@ -58,6 +59,17 @@ static int tls_context_init(tls_ctx *ctx)
 	mbedtls_ctr_drbg_init(ctx->ctr_drbg);
 #ifdef MBEDTLS_SSL_CACHE_C
 	mbedtls_ssl_cache_init(ctx->cache);
+	mbedtls_ssl_cache_set_max_entries(ctx->cache, EASY_TLS_CACHE_SIZE);
+	mbedtls_ssl_cache_set_timeout(ctx->cache, EASY_TLS_CACHE_TIMEOUT);
+#endif
+#ifdef EASY_TLS_TICKETS
+	mbedtls_ssl_ticket_init(ctx->ticket);
+#endif
+#if EASY_TLS_SESSION_STORE > 0
+	memset(ctx->saved, 0, EASY_TLS_SESSION_STORE * sizeof(tls_saved_session));
+#ifdef MBEDTLS_THREADING_C
+	mbedtls_mutex_init(&ctx->saved_mutex);
+#endif
 #endif
 	return 0;
 }
@@ -74,6 +86,12 @@ static int tls_context_alloc(tls_ctx *ctx)
 	TLS_MALLOC(ctx->timer, sizeof(mbedtls_timing_delay_context));
 #ifdef MBEDTLS_SSL_CACHE_C
 	TLS_MALLOC(ctx->cache, sizeof(mbedtls_ssl_cache_context));
+#endif
+#ifdef EASY_TLS_TICKETS
+	TLS_MALLOC(ctx->ticket, sizeof(mbedtls_ssl_ticket_context));
+#endif
+#if EASY_TLS_SESSION_STORE > 0
+	TLS_MALLOC(ctx->saved, EASY_TLS_SESSION_STORE * sizeof(tls_saved_session));
 #endif
 	return 0;
 }
@@ -89,6 +107,12 @@ static void tls_context_free(tls_ctx *ctx)
 		TLS_FREE(ctx->timer);
 #ifdef MBEDTLS_SSL_CACHE_C
 		TLS_FREE(ctx->cache);
+#endif
+#ifdef EASY_TLS_TICKETS
+		TLS_FREE(ctx->ticket);
+#endif
+#if EASY_TLS_SESSION_STORE > 0
+		TLS_FREE(ctx->saved);
 #endif
 		if (ctx->cookie) {
 			TLS_FREE(ctx->cookie);
@@ -98,6 +122,10 @@ static void tls_context_free(tls_ctx *ctx)
 
 static void tls_context_release(tls_ctx *ctx)
 {
+#if EASY_TLS_SESSION_STORE > 0
+	int i;
+#endif
+
 	if (ctx) {
 		mbedtls_ssl_config_free(ctx->conf);
 		mbedtls_x509_crt_free(ctx->crt);
@@ -106,6 +134,17 @@ static void tls_context_release(tls_ctx *ctx)
 		mbedtls_ctr_drbg_free(ctx->ctr_drbg);
 #ifdef MBEDTLS_SSL_CACHE_C
 		mbedtls_ssl_cache_free(ctx->cache);
+#endif
+#ifdef EASY_TLS_TICKETS
+		mbedtls_ssl_ticket_free(ctx->ticket);
+#endif
+#if EASY_TLS_SESSION_STORE > 0
+		for (i = 0; i < EASY_TLS_SESSION_STORE; i++) {
+			mbedtls_ssl_session_free(&ctx->saved[i].session);
+		}
+#ifdef MBEDTLS_THREADING_C
+		mbedtls_mutex_free(&ctx->saved_mutex);
+#endif
 #endif
 		if (ctx->cookie) {
 			mbedtls_ssl_cookie_free(ctx->cookie);
@@ -113,6 +152,105 @@ static void tls_context_release(tls_ctx *ctx)
 	}
 }
 
+#if EASY_TLS_SESSION_STORE > 0
+/*
+ * Client side resumption store, keyed by the peer address of the socket.
+ * Connections without a peer address (unconnected UDP) are not stored.
+ */
+static int tls_peer_addr(int fd, struct sockaddr_storage *peer, socklen_t *peer_len)
+{
+	*peer_len = sizeof(struct sockaddr_storage);
+	memset(peer, 0, sizeof(struct sockaddr_storage));
+
+	return getpeername(fd, (struct sockaddr *)peer, peer_len);
+}
+
+static tls_saved_session *tls_saved_find(tls_ctx *ctx, struct sockaddr_storage *peer, socklen_t peer_len)
+{
+	int i;
+
+	for (i = 0; i < EASY_TLS_SESSION_STORE; i++) {
+		tls_saved_session *s = &ctx->saved[i];
+		if (s->valid && s->peer_len == peer_len && memcmp(&s->peer, peer, peer_len) == 0) {
+			return s;
+		}
+	}
+
+	return NULL;
+}
+
+static void tls_session_load(tls_ctx *ctx, tls_session *session, int fd)
+{
+	struct sockaddr_storage peer;
+	socklen_t peer_len;
+	tls_saved_session *s;
+
+	if (tls_peer_addr(fd, &peer, &peer_len) != 0) {
+		return;
+	}
+
+#ifdef MBEDTLS_THREADING_C
+	if (mbedtls_mutex_lock(&ctx->saved_mutex) != 0) {
+		return;
+	}
+#endif
+
+	s = tls_saved_find(ctx, &peer, peer_len);
+	if (s != NULL) {
+		s->stamp = ++ctx->saved_stamp;
+		if (mbedtls_ssl_set_session(session->ssl, &s->session) != 0) {
+			EASY_TLS_DEBUG("saved session rejected\n");
+		}
+	}
+
+#ifdef MBEDTLS_THREADING_C
+	mbedtls_mutex_unlock(&ctx->saved_mutex);
+#endif
+}
+
+static void tls_session_save(tls_ctx *ctx, tls_session *session, int fd)
+{
+	struct sockaddr_storage peer;
+	socklen_t peer_len;
+	tls_saved_session *s;
+	int i;
+
+	if (tls_peer_addr(fd, &peer, &peer_len) != 0) {
+		return;
+	}
+
+#ifdef MBEDTLS_THREADING_C
+	if (mbedtls_mutex_lock(&ctx->saved_mutex) != 0) {
+		return;
+	}
+#endif
+
+	s = tls_saved_find(ctx, &peer, peer_len);
+	if (s == NULL) {
+		/* Take a free entry or the least recently used one */
+		s = &ctx->saved[0];
+		for (i = 1; i < EASY_TLS_SESSION_STORE && s->valid; i++) {
+			if (!ctx->saved[i].valid || ctx->saved[i].stamp < s->stamp) {
+				s = &ctx->saved[i];
+			}
+		}
+	}
+
+	mbedtls_ssl_session_free(&s->session);
+	s->valid = 0;
+	if (mbedtls_ssl_get_session(session->ssl, &s->session) == 0) {
+		memcpy(&s->peer, &peer, peer_len);
+		s->peer_len = peer_len;
+		s->stamp = ++ctx->saved_stamp;
+		s->valid = 1;
+	}
+
+#ifdef MBEDTLS_THREADING_C
+	mbedtls_mutex_unlock(&ctx->saved_mutex);
+#endif
+}
+#endif
+
 static int tls_entropy_init(tls_ctx *ctx)
 {
 	return mbedtls_ctr_drbg_seed(ctx->ctr_drbg, mbedtls_entropy_func, ctx->entropy, NULL, 0);
@@ -195,6 +333,26 @@ static int tls_set_default(tls_session *session, tls_ctx *ctx, tls_opt *opt)
 	mbedtls_ssl_conf_session_cache(ctx->conf, ctx->cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
 #endif
 
+#ifdef EASY_TLS_TICKETS
+	if (opt->server == MBEDTLS_SSL_IS_SERVER) {
+		/* Ticket keys are made once and shared by all sessions of ctx */
+		if (ctx->ticket->f_rng == NULL) {
+			ret = mbedtls_ssl_ticket_setup(ctx->ticket, mbedtls_ctr_drbg_random, ctx->ctr_drbg, MBEDTLS_CIPHER_AES_256_GCM, EASY_TLS_CACHE_TIMEOUT);
+			if (ret) {
+				ret = TLS_SET_TICKET_FAIL;
+				goto errout;
+			}
+		}
+		mbedtls_ssl_conf_session_tickets_cb(ctx->conf, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, ctx->ticket);
+	}
+#endif
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH) && EASY_TLS_MAX_FRAG_LEN > 0
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT) {
+		mbedtls_ssl_conf_max_frag_len(ctx->conf, EASY_TLS_MAX_FRAG_LEN);
+	}
+#endif
+
 	if (opt->auth_mode <= MBEDTLS_SSL_VERIFY_UNSET) {
 		mbedtls_ssl_conf_authmode(ctx->conf, opt->auth_mode);
 	}
@@ -338,6 +496,12 @@ tls_session *TLSSession(int fd, tls_ctx *ctx, tls_opt *opt)
 
 	listen_ctx.fd = fd;
 	session->net.fd = fd;
+
+#if EASY_TLS_SESSION_STORE > 0
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT) {
+		tls_session_load(ctx, session, fd);
+	}
+#endif
 reset:
 	if (opt->server == MBEDTLS_SSL_IS_SERVER) {
 		mbedtls_ssl_session_reset(session->ssl);
@@ -377,6 +541,12 @@ reset:
 
 	}
 
+#if EASY_TLS_SESSION_STORE > 0
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT) {
+		tls_session_save(ctx, session, fd);
+	}
+#endif
+
 	EASY_TLS_DEBUG("Success !!\n");
 	return session;
 errout:
@@ -76,6 +76,10 @@
 #define mbedtls_free       free
 #endif
 
+#if defined(MBEDTLS_THREADING_C)
+#include "tls/threading.h"
+#endif
+
 #if (defined(__ARMCC_VERSION) || defined(_MSC_VER)) && \
 !defined(inline) && !defined(__cplusplus)
 #define inline __inline
@@ -346,7 +350,8 @@ void mbedtls_ecp_group_free(mbedtls_ecp_group *grp)
 		mbedtls_mpi_free(&grp->N);
 	}
 
-	if (grp->T != NULL) {
+	/* A shared generator table (T_size == 0) belongs to the cache */
+	if (grp->T != NULL && grp->T_size != 0) {
 		for (i = 0; i < grp->T_size; i++) {
 			mbedtls_ecp_point_free(&grp->T[i]);
 		}
@@ -1262,6 +1267,89 @@ static void ecp_comb_fixed(unsigned char x[], size_t d, unsigned char w, const m
 	}
 }
 
+#if MBEDTLS_ECP_FIXED_POINT_OPTIM == 1 && defined(MBEDTLS_ECP_FIXED_POINT_CACHE)
+/*
+ * Generator tables of the named curves.
+ *
+ * Every handshake loads a fresh group, so without this the comb table
+ * for G would be rebuilt on each connection. Tables are computed once,
+ * never freed, and only read afterwards.
+ */
+static struct {
+	mbedtls_ecp_group_id id;
+	unsigned char pre_len;
+	mbedtls_ecp_point *T;
+} ecp_comb_cache[MBEDTLS_ECP_DP_MAX];
+
+static mbedtls_ecp_point *ecp_comb_cache_get(mbedtls_ecp_group_id id, unsigned char pre_len)
+{
+	mbedtls_ecp_point *T = NULL;
+	size_t i;
+
+	if (id == MBEDTLS_ECP_DP_NONE) {
+		return (NULL);
+	}
+
+#if defined(MBEDTLS_THREADING_C)
+	if (mbedtls_mutex_lock(&mbedtls_threading_ecp_mutex) != 0) {
+		return (NULL);
+	}
+#endif
+
+	for (i = 0; i < MBEDTLS_ECP_DP_MAX; i++) {
+		if (ecp_comb_cache[i].id == id && ecp_comb_cache[i].pre_len == pre_len) {
+			T = ecp_comb_cache[i].T;
+			break;
+		}
+	}
+
+#if defined(MBEDTLS_THREADING_C)
+	mbedtls_mutex_unlock(&mbedtls_threading_ecp_mutex);
+#endif
+
+	return (T);
+}
+
+/*
+ * Hand T over to the cache. Returns 0 if the cache took ownership.
+ */
+static int ecp_comb_cache_put(mbedtls_ecp_group_id id, mbedtls_ecp_point *T, unsigned char pre_len)
+{
+	int ret = -1;
+	size_t i;
+
+	if (id == MBEDTLS_ECP_DP_NONE) {
+		return (ret);
+	}
+
+#if defined(MBEDTLS_THREADING_C)
+	if (mbedtls_mutex_lock(&mbedtls_threading_ecp_mutex) != 0) {
+		return (ret);
+	}
+#endif
+
+	for (i = 0; i < MBEDTLS_ECP_DP_MAX; i++) {
+		if (ecp_comb_cache[i].id == id) {
+			/* Another thread got there first */
+			break;
+		}
+		if (ecp_comb_cache[i].T == NULL) {
+			ecp_comb_cache[i].id = id;
+			ecp_comb_cache[i].pre_len = pre_len;
+			ecp_comb_cache[i].T = T;
+			ret = 0;
+			break;
+		}
+	}
+
+#if defined(MBEDTLS_THREADING_C)
+	mbedtls_mutex_unlock(&mbedtls_threading_ecp_mutex);
+#endif
+
+	return (ret);
+}
+#endif							/* MBEDTLS_ECP_FIXED_POINT_OPTIM && MBEDTLS_ECP_FIXED_POINT_CACHE */
+
 /*
  * Precompute points for the comb method
  *
@@ -1438,6 +1526,13 @@ static int ecp_mul_comb(mbedtls_ecp_group *grp, mbedtls_ecp_point *R, const mbed
 	 */
 	T = p_eq_g ? grp->T : NULL;
 
+#if MBEDTLS_ECP_FIXED_POINT_OPTIM == 1 && defined(MBEDTLS_ECP_FIXED_POINT_CACHE)
+	if (T == NULL && p_eq_g && (T = ecp_comb_cache_get(grp->id, pre_len)) != NULL) {
+		grp->T = T;
+		grp->T_size = 0;
+	}
+#endif
+
 	if (T == NULL) {
 		T = mbedtls_calloc(pre_len, sizeof(mbedtls_ecp_point));
 		if (T == NULL) {
@@ -1450,6 +1545,11 @@ static int ecp_mul_comb(mbedtls_ecp_group *grp, mbedtls_ecp_point *R, const mbed
 		if (p_eq_g) {
 			grp->T = T;
 			grp->T_size = pre_len;
+#if MBEDTLS_ECP_FIXED_POINT_OPTIM == 1 && defined(MBEDTLS_ECP_FIXED_POINT_CACHE)
+			if (ecp_comb_cache_put(grp->id, T, pre_len) == 0) {
+				grp->T_size = 0;
+			}
+#endif
 		}
 	}
 
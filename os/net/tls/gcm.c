@@ -59,6 +59,10 @@
 #include "tls/aesni.h"
 #endif
 
+#if defined(CONFIG_HW_AES_AEAD)
+#include "tls/see_api.h"
+#endif
+
 #if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_AES_C)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "tls/platform.h"
@@ -203,9 +207,52 @@ int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, con
 		return (ret);
 	}
 
+#if defined(CONFIG_HW_AES_AEAD)
+	ctx->hw_keylen = 0;
+	if (cipher == MBEDTLS_CIPHER_ID_AES) {
+		memcpy(ctx->hw_key, key, keybits / 8);
+		ctx->hw_keylen = keybits / 8;
+	}
+#endif
+
 	return (0);
 }
 
+#if defined(CONFIG_HW_AES_AEAD)
+/*
+ * One-shot GCM on the SSS. Returns non-zero when the request does not
+ * fit the hardware, and the caller falls back to the software path.
+ */
+static int gcm_hw_crypt(mbedtls_gcm_context *ctx, int mode, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input, unsigned char *output, unsigned char *tag)
+{
+	struct sAES_PARAM param;
+
+	if (ctx->hw_keylen == 0 || length < CONFIG_HW_CRYPTO_MIN_SIZE || iv_len != 12 || add_len > MAX_AES_AAD_BLEN) {
+		return (-1);
+	}
+
+	memset(&param, 0, sizeof(param));
+	if (mode == MBEDTLS_GCM_ENCRYPT) {
+		param.pu8Plaintext = (unsigned char *)input;
+		param.pu8Ciphertext = output;
+	} else {
+		param.pu8Plaintext = output;
+		param.pu8Ciphertext = (unsigned char *)input;
+	}
+	param.u32Plaintext_byte_len = length;
+	param.u32Ciphertext_byte_len = length;
+	param.pu8iv = (unsigned char *)iv;
+	param.u32iv_byte_len = iv_len;
+	param.pu8aad = (unsigned char *)add;
+	param.u32aad_byte_len = add_len;
+	param.pu8Tag = tag;
+	param.u32Tag_byte_len = 16;
+	param.u32Mode = SEE_AES_OID(ctx->hw_keylen, AES_GCM_MODE);
+
+	return see_aes_aead(&param, ctx->hw_key, ctx->hw_keylen, mode == MBEDTLS_GCM_ENCRYPT ? AES_ENCTYPT : AES_DECRYPT);
+}
+#endif
+
 /*
  * Shoup's method for multiplication use this table with
  *      last4[x] = x times P^128
@@ -438,6 +485,15 @@ int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length,
 {
 	int ret;
 
+#if defined(CONFIG_HW_AES_AEAD)
+	unsigned char hw_tag[16];
+
+	if (mode == MBEDTLS_GCM_ENCRYPT && tag_len >= 4 && tag_len <= 16 && gcm_hw_crypt(ctx, mode, length, iv, iv_len, add, add_len, input, output, hw_tag) == 0) {
+		memcpy(tag, hw_tag, tag_len);
+		return (0);
+	}
+#endif
+
 	if ((ret = mbedtls_gcm_starts(ctx, mode, iv, iv_len, add, add_len)) != 0) {
 		return (ret);
 	}
@@ -460,6 +516,17 @@ int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length, const unsi
 	size_t i;
 	int diff;
 
+#if defined(CONFIG_HW_AES_AEAD)
+	/*
+	 * The engine is handed the received tag; it is compared again below
+	 * so a mismatch is reported the same way on both paths.
+	 */
+	memset(check_tag, 0, sizeof(check_tag));
+	if (tag_len <= 16) {
+		memcpy(check_tag, tag, tag_len);
+	}
+	if (tag_len < 4 || tag_len > 16 || gcm_hw_crypt(ctx, MBEDTLS_GCM_DECRYPT, length, iv, iv_len, add, add_len, input, output, check_tag) != 0)
+#endif
 	if ((ret = mbedtls_gcm_crypt_and_tag(ctx, MBEDTLS_GCM_DECRYPT, length, iv, iv_len, add, add_len, input, output, tag_len, check_tag)) != 0) {
 		return (ret);
 	}
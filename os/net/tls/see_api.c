@@ -20,6 +20,7 @@
 /// @brief SEE api is supporting security api for using secure storage.
 
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
 
 #include "tls/see_api.h"
@@ -234,6 +235,262 @@ int see_compute_ecdh_param(struct sECC_KEY *ecc_pub, unsigned int key_index, uns
 	return SEE_OK;
 }
 
+/* The engine keeps a single running digest, set while see_hash_start() owns it */
+static int g_hash_stream;
+
+int see_get_hash(struct sHASH_MSG *h_param, unsigned char *hash, unsigned int mode)
+{
+	int r;
+
+	if (h_param == NULL || hash == NULL) {
+		return SEE_INVALID_INPUT_PARAMS;
+	}
+
+	/* Callers fall back to software while a streamed digest is running */
+	if (g_hash_stream) {
+		return SEE_GET_HASH_ERROR;
+	}
+
+	SEE_DEBUG("%s len : %d\n", __func__, h_param->msg_byte_len);
+
+	if (see_mutex_lock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_LOCK_ERROR;
+	}
+
+	ISP_CHECKBUSY();
+	if ((r = isp_hash(hash, h_param, mode)) != 0) {
+		isp_clear(0);
+		if (see_mutex_unlock(&m_handler) != SEE_OK) {
+			return SEE_MUTEX_UNLOCK_ERROR;
+		}
+		SEE_DEBUG("isp_hash fail %x\n", r);
+		return SEE_GET_HASH_ERROR;
+	}
+
+	if (see_mutex_unlock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_UNLOCK_ERROR;
+	}
+
+	return SEE_OK;
+}
+
+static unsigned int see_hash_block_len(unsigned int mode)
+{
+	switch (mode) {
+	case SHA1_160:
+	case SHA2_224:
+	case SHA2_256:
+		return 64;
+	case SHA2_384:
+	case SHA2_512:
+		return 128;
+	case SHA3_224:
+		return 144;
+	case SHA3_256:
+		return 136;
+	case SHA3_384:
+		return 104;
+	case SHA3_512:
+		return 72;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * The message length is needed up front by the engine. Whole blocks are
+ * passed on as they arrive, the last 1..block_len bytes are held back in
+ * ctx->buf for the final call.
+ */
+int see_hash_start(see_hash_ctx *ctx, unsigned int msg_len, unsigned int mode)
+{
+	int r;
+
+	if (ctx == NULL || msg_len == 0 || see_hash_block_len(mode) == 0) {
+		return SEE_INVALID_INPUT_PARAMS;
+	}
+
+	if (see_mutex_lock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_LOCK_ERROR;
+	}
+
+	if (g_hash_stream) {
+		see_mutex_unlock(&m_handler);
+		return SEE_GET_HASH_ERROR;
+	}
+
+	ISP_CHECKBUSY();
+	if ((r = mb_hash_init(mode, msg_len)) != 0) {
+		isp_clear(0);
+		see_mutex_unlock(&m_handler);
+		SEE_DEBUG("mb_hash_init fail %x\n", r);
+		return SEE_GET_HASH_ERROR;
+	}
+	g_hash_stream = 1;
+
+	if (see_mutex_unlock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_UNLOCK_ERROR;
+	}
+
+	ctx->mode = mode;
+	ctx->block_len = see_hash_block_len(mode);
+	ctx->remain = msg_len;
+	ctx->buf_len = 0;
+
+	return SEE_OK;
+}
+
+static int see_hash_blocks(const unsigned char *msg, unsigned int len)
+{
+	int r;
+
+	if (see_mutex_lock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_LOCK_ERROR;
+	}
+
+	ISP_CHECKBUSY();
+	r = mb_hash_update(len, (unsigned char *)msg);
+	if (r != 0) {
+		isp_clear(0);
+		SEE_DEBUG("mb_hash_update fail %x\n", r);
+	}
+
+	if (see_mutex_unlock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_UNLOCK_ERROR;
+	}
+
+	return r ? SEE_GET_HASH_ERROR : SEE_OK;
+}
+
+int see_hash_update(see_hash_ctx *ctx, const unsigned char *msg, unsigned int len)
+{
+	unsigned int n;
+	int r;
+
+	if (ctx == NULL || (msg == NULL && len) || len > ctx->remain) {
+		return SEE_INVALID_INPUT_PARAMS;
+	}
+
+	while (len > 0) {
+		/* A full buffered block is only passed on once more data follows */
+		if (ctx->buf_len == ctx->block_len) {
+			if ((r = see_hash_blocks(ctx->buf, ctx->block_len)) != SEE_OK) {
+				return r;
+			}
+			ctx->buf_len = 0;
+		}
+
+		if (ctx->buf_len == 0 && len > ctx->block_len) {
+			/* Straight from the caller, keeping at least one byte back */
+			n = ((len - 1) / ctx->block_len) * ctx->block_len;
+			if ((r = see_hash_blocks(msg, n)) != SEE_OK) {
+				return r;
+			}
+		} else {
+			n = ctx->block_len - ctx->buf_len;
+			if (n > len) {
+				n = len;
+			}
+			memcpy(ctx->buf + ctx->buf_len, msg, n);
+			ctx->buf_len += n;
+		}
+
+		msg += n;
+		len -= n;
+		ctx->remain -= n;
+	}
+
+	return SEE_OK;
+}
+
+int see_hash_finish(see_hash_ctx *ctx, unsigned char *hash)
+{
+	int r;
+
+	if (ctx == NULL || hash == NULL) {
+		return SEE_INVALID_INPUT_PARAMS;
+	}
+
+	if (see_mutex_lock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_LOCK_ERROR;
+	}
+
+	/* A short message is still finished to release the engine */
+	ISP_CHECKBUSY();
+	r = mb_hash_final(hash, ctx->buf_len, ctx->buf);
+	if (r != 0) {
+		isp_clear(0);
+		SEE_DEBUG("mb_hash_final fail %x\n", r);
+	}
+	g_hash_stream = 0;
+
+	if (see_mutex_unlock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_UNLOCK_ERROR;
+	}
+
+	if (r != 0 || ctx->remain != 0) {
+		return SEE_GET_HASH_ERROR;
+	}
+
+	return SEE_OK;
+}
+
+#if defined(CONFIG_HW_AES_AEAD)
+/* Session key that is loaded in the AES slot of the secure storage */
+static unsigned char g_aes_key[32];
+static unsigned int g_aes_key_len;
+
+int see_aes_aead(struct sAES_PARAM *aes_param, const unsigned char *key, unsigned int key_len, unsigned int enc)
+{
+	int r;
+
+	if (aes_param == NULL || key == NULL || key_len > sizeof(g_aes_key)) {
+		return SEE_INVALID_INPUT_PARAMS;
+	}
+
+	if (see_mutex_lock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_LOCK_ERROR;
+	}
+
+	ISP_CHECKBUSY();
+	/* Records of the same session reuse the key that is already loaded */
+	if (key_len != g_aes_key_len || memcmp(key, g_aes_key, key_len)) {
+		g_aes_key_len = 0;
+		if ((r = isp_set_securekey((unsigned char *)key, key_len, SECURE_STORAGE_TYPE_KEY_AES, CONFIG_HW_AES_KEY_INDEX)) != 0) {
+			isp_clear(0);
+			if (see_mutex_unlock(&m_handler) != SEE_OK) {
+				return SEE_MUTEX_UNLOCK_ERROR;
+			}
+			SEE_DEBUG("isp_set_securekey fail %x\n", r);
+			return SEE_AES_ERROR;
+		}
+		memcpy(g_aes_key, key, key_len);
+		g_aes_key_len = key_len;
+	}
+
+	if ((aes_param->u32Mode & ~0xff00u) == SEE_AES_OID(0, AES_GCM_MODE)) {
+		r = isp_aes_gcm_securekey(aes_param, enc, CONFIG_HW_AES_KEY_INDEX);
+	} else {
+		r = isp_aes_ccm_securekey(aes_param, enc, CONFIG_HW_AES_KEY_INDEX);
+	}
+
+	if (r != 0) {
+		isp_clear(0);
+		if (see_mutex_unlock(&m_handler) != SEE_OK) {
+			return SEE_MUTEX_UNLOCK_ERROR;
+		}
+		SEE_DEBUG("isp_aes fail %x\n", r);
+		return SEE_AES_ERROR;
+	}
+
+	if (see_mutex_unlock(&m_handler) != SEE_OK) {
+		return SEE_MUTEX_UNLOCK_ERROR;
+	}
+
+	return SEE_OK;
+}
+#endif /* CONFIG_HW_AES_AEAD */
+
 int see_mutex_init(see_mutex_t *m)
 {
 	if (m == NULL) {
@@ -50,6 +50,10 @@
 
 #include <string.h>
 
+#if defined(CONFIG_HW_SHA1)
+#include "tls/see_api.h"
+#endif
+
 #if defined(MBEDTLS_SELF_TEST)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "tls/platform.h"
@@ -371,6 +375,20 @@ void mbedtls_sha1(const unsigned char *input, size_t ilen, unsigned char output[
 {
 	mbedtls_sha1_context ctx;
 
+#if defined(CONFIG_HW_SHA1)
+	if (ilen >= CONFIG_HW_CRYPTO_MIN_SIZE) {
+		struct sHASH_MSG msg;
+
+		memset(&msg, 0, sizeof(msg));
+		msg.addr_low = (unsigned int)input;
+		msg.msg_byte_len = ilen;
+
+		if (see_get_hash(&msg, output, SHA1_160) == SEE_OK) {
+			return;
+		}
+	}
+#endif
+
 	mbedtls_sha1_init(&ctx);
 	mbedtls_sha1_starts(&ctx);
 	mbedtls_sha1_update(&ctx, input, ilen);
@@ -50,6 +50,10 @@
 
 #include <string.h>
 
+#if defined(CONFIG_HW_SHA256)
+#include "tls/see_api.h"
+#endif
+
 #if defined(MBEDTLS_SELF_TEST)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "tls/platform.h"
@@ -349,6 +353,21 @@ void mbedtls_sha256(const unsigned char *input, size_t ilen, unsigned char outpu
 {
 	mbedtls_sha256_context ctx;
 
+#if defined(CONFIG_HW_SHA256)
+	/* The hash mailbox needs the whole message, so only one-shot calls use it */
+	if (!is224 && ilen >= CONFIG_HW_CRYPTO_MIN_SIZE) {
+		struct sHASH_MSG msg;
+
+		memset(&msg, 0, sizeof(msg));
+		msg.addr_low = (unsigned int)input;
+		msg.msg_byte_len = ilen;
+
+		if (see_get_hash(&msg, output, SHA2_256) == SEE_OK) {
+			return;
+		}
+	}
+#endif
+
 	mbedtls_sha256_init(&ctx);
 	mbedtls_sha256_starts(&ctx, is224);
 	mbedtls_sha256_update(&ctx, input, ilen);
@@ -1943,7 +1943,7 @@ static int ssl_write_hello_verify_request(mbedtls_ssl_context *ssl)
 	/* Skip length byte until we know the length */
 	cookie_len_byte = p++;
 
-	if ((ret = ssl->conf->f_cookie_write(ssl->conf->p_cookie, &p, ssl->out_buf + MBEDTLS_SSL_BUFFER_LEN, ssl->cli_id, ssl->cli_id_len)) != 0) {
+	if ((ret = ssl->conf->f_cookie_write(ssl->conf->p_cookie, &p, ssl->out_buf + MBEDTLS_SSL_OUT_BUFFER_LEN(ssl), ssl->cli_id, ssl->cli_id_len)) != 0) {
 		MBEDTLS_SSL_DEBUG_RET(1, "f_cookie_write", ret);
 		return (ret);
 	}
@@ -1935,7 +1935,7 @@ int mbedtls_ssl_fetch_input(mbedtls_ssl_context *ssl, size_t nb_want)
 		return (MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
 	}
 
-	if (nb_want > MBEDTLS_SSL_BUFFER_LEN - (size_t)(ssl->in_hdr - ssl->in_buf)) {
+	if (nb_want > MBEDTLS_SSL_IN_BUFFER_LEN(ssl) - (size_t)(ssl->in_hdr - ssl->in_buf)) {
 		MBEDTLS_SSL_DEBUG_MSG(1, ("requesting more data than fits"));
 		return (MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
 	}
@@ -2003,7 +2003,7 @@ int mbedtls_ssl_fetch_input(mbedtls_ssl_context *ssl, size_t nb_want)
 		if (ssl_check_timer(ssl) != 0) {
 			ret = MBEDTLS_ERR_SSL_TIMEOUT;
 		} else {
-			len = MBEDTLS_SSL_BUFFER_LEN - (ssl->in_hdr - ssl->in_buf);
+			len = MBEDTLS_SSL_IN_BUFFER_LEN(ssl) - (ssl->in_hdr - ssl->in_buf);
 
 			if (ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
 				timeout = ssl->handshake->retransmit_timeout;
@@ -2668,7 +2668,7 @@ static int ssl_reassemble_dtls_handshake(mbedtls_ssl_context *ssl)
 		ssl->next_record_offset = new_remain - ssl->in_hdr;
 		ssl->in_left = ssl->next_record_offset + remain_len;
 
-		if (ssl->in_left > MBEDTLS_SSL_BUFFER_LEN - (size_t)(ssl->in_hdr - ssl->in_buf)) {
+		if (ssl->in_left > MBEDTLS_SSL_IN_BUFFER_LEN(ssl) - (size_t)(ssl->in_hdr - ssl->in_buf)) {
 			MBEDTLS_SSL_DEBUG_MSG(1, ("reassembled message too large for buffer"));
 			return (MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL);
 		}
@@ -2988,7 +2988,7 @@ static int ssl_handle_possible_reconnect(mbedtls_ssl_context *ssl)
 	int ret;
 	size_t len;
 
-	ret = ssl_check_dtls_clihlo_cookie(ssl->conf->f_cookie_write, ssl->conf->f_cookie_check, ssl->conf->p_cookie, ssl->cli_id, ssl->cli_id_len, ssl->in_buf, ssl->in_left, ssl->out_buf, MBEDTLS_SSL_MAX_CONTENT_LEN, &len);
+	ret = ssl_check_dtls_clihlo_cookie(ssl->conf->f_cookie_write, ssl->conf->f_cookie_check, ssl->conf->p_cookie, ssl->cli_id, ssl->cli_id_len, ssl->in_buf, ssl->in_left, ssl->out_buf, MBEDTLS_SSL_OUT_CONTENT_LEN(ssl), &len);
 
 	MBEDTLS_SSL_DEBUG_RET(2, "ssl_check_dtls_clihlo_cookie", ret);
 
@@ -3070,7 +3070,7 @@ static int ssl_parse_record_header(mbedtls_ssl_context *ssl)
 	}
 
 	/* Check length against the size of our buffer */
-	if (ssl->in_msglen > MBEDTLS_SSL_BUFFER_LEN - (size_t)(ssl->in_msg - ssl->in_buf)) {
+	if (ssl->in_msglen > MBEDTLS_SSL_IN_BUFFER_LEN(ssl) - (size_t)(ssl->in_msg - ssl->in_buf)) {
 		MBEDTLS_SSL_DEBUG_MSG(1, ("bad message length"));
 		return (MBEDTLS_ERR_SSL_INVALID_RECORD);
 	}
@@ -4721,6 +4721,10 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf)
 		ssl->in_buf = NULL;
 		return (MBEDTLS_ERR_SSL_ALLOC_FAILED);
 	}
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	ssl->in_buf_len = len;
+	ssl->out_buf_len = len;
+#endif
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 	if (conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
 		ssl->out_hdr = ssl->out_buf;
@@ -4757,6 +4761,109 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf)
 	return (0);
 }
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+/*
+ * Move a record buffer to a new allocation of new_len bytes, keeping
+ * its content (up to new_len) and rebasing the pointers into it.
+ */
+static int ssl_realloc_buffer(unsigned char **buf, size_t *buf_len, size_t new_len, unsigned char **ptrs[], size_t n_ptrs)
+{
+	unsigned char *new_buf;
+	size_t i;
+
+	if (*buf_len == new_len) {
+		return (0);
+	}
+
+	if ((new_buf = mbedtls_calloc(1, new_len)) == NULL) {
+		return (MBEDTLS_ERR_SSL_ALLOC_FAILED);
+	}
+
+	memcpy(new_buf, *buf, new_len < *buf_len ? new_len : *buf_len);
+
+	for (i = 0; i < n_ptrs; i++) {
+		if (*ptrs[i] != NULL) {
+			*ptrs[i] = new_buf + (*ptrs[i] - *buf);
+		}
+	}
+
+	mbedtls_zeroize(*buf, *buf_len);
+	mbedtls_free(*buf);
+
+	*buf = new_buf;
+	*buf_len = new_len;
+
+	return (0);
+}
+
+static int ssl_resize_buffers(mbedtls_ssl_context *ssl, size_t in_len, size_t out_len)
+{
+	int ret;
+	unsigned char **in_ptrs[] = { &ssl->in_ctr, &ssl->in_hdr, &ssl->in_len, &ssl->in_iv, &ssl->in_msg, &ssl->in_offt };
+	unsigned char **out_ptrs[] = { &ssl->out_ctr, &ssl->out_hdr, &ssl->out_len, &ssl->out_iv, &ssl->out_msg };
+
+	if ((ret = ssl_realloc_buffer(&ssl->in_buf, &ssl->in_buf_len, in_len, in_ptrs, sizeof(in_ptrs) / sizeof(in_ptrs[0]))) != 0) {
+		MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%d bytes) failed", in_len));
+		return (ret);
+	}
+
+	if ((ret = ssl_realloc_buffer(&ssl->out_buf, &ssl->out_buf_len, out_len, out_ptrs, sizeof(out_ptrs) / sizeof(out_ptrs[0]))) != 0) {
+		MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%d bytes) failed", out_len));
+		return (ret);
+	}
+
+	return (0);
+}
+
+/*
+ * Handshake messages may use full-size records, so every handshake
+ * starts with full-size buffers.
+ */
+static int ssl_grow_buffers(mbedtls_ssl_context *ssl)
+{
+	return (ssl_resize_buffers(ssl, MBEDTLS_SSL_BUFFER_LEN, MBEDTLS_SSL_BUFFER_LEN));
+}
+
+/*
+ * Once the handshake is over, incoming records are bounded by the
+ * negotiated max fragment length and outgoing ones can be split at will.
+ * The input buffer keeps its size while it holds data that would not fit.
+ */
+static void ssl_shrink_buffers(mbedtls_ssl_context *ssl)
+{
+	size_t in_len = MBEDTLS_SSL_BUFFER_LEN;
+	size_t out_len = MBEDTLS_SSL_MAX_CONTENT_LEN;
+	size_t used;
+
+	if (ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER || ssl->out_left != 0) {
+		return;
+	}
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+	/* A datagram may carry several records, so only streams are bounded */
+	if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM && ssl->session != NULL) {
+		in_len = mfl_code_to_length[ssl->session->mfl_code] + MBEDTLS_SSL_BUFFER_OVERHEAD;
+	}
+	out_len = mbedtls_ssl_get_max_frag_len(ssl);
+#endif
+	if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM && out_len > MBEDTLS_SSL_OUT_CONTENT_LEN_IDLE) {
+		out_len = MBEDTLS_SSL_OUT_CONTENT_LEN_IDLE;
+	}
+	out_len += MBEDTLS_SSL_BUFFER_OVERHEAD;
+
+	used = (size_t)(ssl->in_hdr - ssl->in_buf) + ssl->in_left;
+	if (used < (size_t)(ssl->in_msg - ssl->in_buf) + ssl->in_msglen) {
+		used = (size_t)(ssl->in_msg - ssl->in_buf) + ssl->in_msglen;
+	}
+	if (used > in_len) {
+		in_len = ssl->in_buf_len;
+	}
+
+	/* On allocation failure the current buffers stay in use */
+	(void)ssl_resize_buffers(ssl, in_len, out_len);
+}
+#endif							/* MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH */
+
 /*
  * Reset an initialized and used SSL context for re-use while retaining
  * all application-set variables, function pointers and data.
@@ -4768,6 +4875,12 @@ static int ssl_session_reset_int(mbedtls_ssl_context *ssl, int partial)
 {
 	int ret;
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	if ((ret = ssl_grow_buffers(ssl)) != 0) {
+		return (ret);
+	}
+#endif
+
 	ssl->state = MBEDTLS_SSL_HELLO_REQUEST;
 
 	/* Cancel any possibly running timer */
@@ -4816,9 +4929,9 @@ static int ssl_session_reset_int(mbedtls_ssl_context *ssl, int partial)
 	ssl->transform_in = NULL;
 	ssl->transform_out = NULL;
 
-	memset(ssl->out_buf, 0, MBEDTLS_SSL_BUFFER_LEN);
+	memset(ssl->out_buf, 0, MBEDTLS_SSL_OUT_BUFFER_LEN(ssl));
 	if (partial == 0) {
-		memset(ssl->in_buf, 0, MBEDTLS_SSL_BUFFER_LEN);
+		memset(ssl->in_buf, 0, MBEDTLS_SSL_IN_BUFFER_LEN(ssl));
 	}
 #if defined(MBEDTLS_SSL_HW_RECORD_ACCEL)
 	if (mbedtls_ssl_hw_record_reset != NULL) {
@@ -5590,6 +5703,12 @@ int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl)
 		}
 	}
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	if (ret == 0) {
+		ssl_shrink_buffers(ssl);
+	}
+#endif
+
 	MBEDTLS_SSL_DEBUG_MSG(2, ("<= handshake"));
 
 	return (ret);
@@ -5636,6 +5755,12 @@ static int ssl_start_renegotiation(mbedtls_ssl_context *ssl)
 
 	MBEDTLS_SSL_DEBUG_MSG(2, ("=> renegotiate"));
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	if ((ret = ssl_grow_buffers(ssl)) != 0) {
+		return (ret);
+	}
+#endif
+
 	if ((ret = ssl_handshake_init(ssl)) != 0) {
 		return (ret);
 	}
@@ -5964,6 +6089,12 @@ static int ssl_write_real(mbedtls_ssl_context *ssl, const unsigned char *buf, si
 #if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
 	size_t max_len = mbedtls_ssl_get_max_frag_len(ssl);
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+	if (max_len > MBEDTLS_SSL_OUT_CONTENT_LEN(ssl)) {
+		max_len = MBEDTLS_SSL_OUT_CONTENT_LEN(ssl);
+	}
+#endif
+
 	if (len > max_len) {
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 		if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
@@ -6228,12 +6359,12 @@ void mbedtls_ssl_free(mbedtls_ssl_context *ssl)
 	MBEDTLS_SSL_DEBUG_MSG(2, ("=> free"));
 
 	if (ssl->out_buf != NULL) {
-		mbedtls_zeroize(ssl->out_buf, MBEDTLS_SSL_BUFFER_LEN);
+		mbedtls_zeroize(ssl->out_buf, MBEDTLS_SSL_OUT_BUFFER_LEN(ssl));
 		mbedtls_free(ssl->out_buf);
 	}
 
 	if (ssl->in_buf != NULL) {
-		mbedtls_zeroize(ssl->in_buf, MBEDTLS_SSL_BUFFER_LEN);
+		mbedtls_zeroize(ssl->in_buf, MBEDTLS_SSL_IN_BUFFER_LEN(ssl));
 		mbedtls_free(ssl->in_buf);
 	}
 #if defined(MBEDTLS_ZLIB_SUPPORT)
@@ -131,6 +131,7 @@ void mbedtls_threading_set_alt(void (*mutex_init)(mbedtls_threading_mutex_t *),
 
 	mbedtls_mutex_init(&mbedtls_threading_readdir_mutex);
 	mbedtls_mutex_init(&mbedtls_threading_gmtime_mutex);
+	mbedtls_mutex_init(&mbedtls_threading_ecp_mutex);
 }
 
 /*
@@ -140,6 +141,7 @@ void mbedtls_threading_free_alt(void)
 {
 	mbedtls_mutex_free(&mbedtls_threading_readdir_mutex);
 	mbedtls_mutex_free(&mbedtls_threading_gmtime_mutex);
+	mbedtls_mutex_free(&mbedtls_threading_ecp_mutex);
 }
 #endif							/* MBEDTLS_THREADING_ALT */
 
@@ -151,5 +153,6 @@ void mbedtls_threading_free_alt(void)
 #endif
 mbedtls_threading_mutex_t mbedtls_threading_readdir_mutex MUTEX_INIT;
 mbedtls_threading_mutex_t mbedtls_threading_gmtime_mutex MUTEX_INIT;
+mbedtls_threading_mutex_t mbedtls_threading_ecp_mutex MUTEX_INIT;
 
 #endif							/* MBEDTLS_THREADING_C */
@@ -64,6 +64,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/net/net.h>
 
 #include "utils/utils.h"
@@ -122,6 +123,7 @@ static void _net_takesem(void)
 void net_lockinitialize(void)
 {
 	sem_init(&g_netlock, 0, 1);
+	(void)sem_setname(&g_netlock, "net_lock");
 }
 
 /****************************************************************************
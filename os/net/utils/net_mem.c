@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/utils/net_mem.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/net/netmem.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/sys.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/memp.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/api.h>
+#include <net/lwip/api_msg.h>
+#include <net/lwip/tcp_impl.h>
+
+#ifdef CONFIG_NET_MEMINFO
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Arguments of netmem_conns_walk(), run in the tcpip thread */
+
+struct netmem_walk_s {
+	FAR struct netmem_conn_s *conns;
+	int nconns;
+	int count;
+#if !LWIP_TCPIP_CORE_LOCKING
+	sys_sem_t done;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_netmem_drops[NETMEM_NDROPS];
+
+static FAR const char *const g_netmem_drop_names[NETMEM_NDROPS] = {
+	"pbuf_pool",
+	"pbuf_ram",
+	"tcpip_mbox",
+	"sock_rcvbuf",
+	"tcp_ooseq",
+};
+
+#if MEMP_STATS
+static FAR const char *const g_netmem_pool_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) desc,
+#include <net/lwip/memp_std.h>
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if LWIP_TCP
+static void netmem_conns_walk(FAR void *arg)
+{
+	FAR struct netmem_walk_s *walk = (FAR struct netmem_walk_s *)arg;
+	FAR struct tcp_pcb *pcb;
+	FAR struct tcp_seg *seg;
+
+	for (pcb = tcp_active_pcbs; pcb != NULL && walk->count < walk->nconns; pcb = pcb->next) {
+		FAR struct netmem_conn_s *c = &walk->conns[walk->count++];
+		FAR struct netconn *conn = netconn_tcp_owner(pcb);
+
+#if LWIP_SOCKET
+		c->sd = (conn != NULL && conn->socket >= 0) ? conn->socket + LWIP_SOCKET_OFFSET : -1;
+#else
+		c->sd = -1;
+#endif
+		c->state = tcp_state_str[pcb->state];
+		c->lport = pcb->local_port;
+		c->rport = pcb->remote_port;
+		c->raddr = ip4_addr_get_u32(&pcb->remote_ip);
+#if LWIP_SO_SNDBUF
+		c->sndbuf = conn != NULL ? netconn_get_sendbufsize(conn) : TCP_SND_BUF;
+#else
+		c->sndbuf = TCP_SND_BUF;
+#endif
+		c->sndq = tcp_sndbuf(pcb) < TCP_SND_BUF ? TCP_SND_BUF - tcp_sndbuf(pcb) : 0;
+		c->unsent = 0;
+		for (seg = pcb->unsent; seg != NULL; seg = seg->next) {
+			c->unsent += seg->len;
+		}
+		c->sndpbufs = tcp_sndqueuelen(pcb);
+
+		/* The receive window shrinks by what was passed up and not taken
+		 * with tcp_recved() yet, that is what waits in the socket.
+		 */
+
+		c->rcvq = TCP_WND_MAX(pcb) - pcb->rcv_wnd;
+		if (pcb->refused_data != NULL) {
+			c->rcvq += pcb->refused_data->tot_len;
+		}
+		c->ooseq = 0;
+#if TCP_QUEUE_OOSEQ
+		for (seg = pcb->ooseq; seg != NULL; seg = seg->next) {
+			c->ooseq += seg->p->tot_len;
+		}
+#endif
+	}
+
+#if !LWIP_TCPIP_CORE_LOCKING
+	sys_sem_signal(&walk->done);
+#endif
+}
+#endif							/* LWIP_TCP */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void netmem_drop(enum netmem_drop_e reason)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	g_netmem_drops[reason]++;
+	irqrestore(flags);
+}
+
+void netmem_drops(FAR uint32_t *drops)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memcpy(drops, g_netmem_drops, sizeof(g_netmem_drops));
+	irqrestore(flags);
+}
+
+FAR const char *netmem_drop_name(enum netmem_drop_e reason)
+{
+	return g_netmem_drop_names[reason];
+}
+
+int netmem_pools(FAR struct netmem_pool_s *pools, int npools)
+{
+	int count = 0;
+#if MEMP_STATS
+	int i;
+
+	for (i = 0; i < MEMP_MAX && count < npools; i++, count++) {
+		pools[count].name = g_netmem_pool_names[i];
+		pools[count].avail = lwip_stats.memp[i].avail;
+		pools[count].used = lwip_stats.memp[i].used;
+		pools[count].max = lwip_stats.memp[i].max;
+		pools[count].err = lwip_stats.memp[i].err;
+	}
+#endif
+#if MEM_STATS
+	if (count < npools) {
+		pools[count].name = "HEAP";
+		pools[count].avail = lwip_stats.mem.avail;
+		pools[count].used = lwip_stats.mem.used;
+		pools[count].max = lwip_stats.mem.max;
+		pools[count].err = lwip_stats.mem.err;
+		count++;
+	}
+#endif
+
+	return count;
+}
+
+int netmem_conns(FAR struct netmem_conn_s *conns, int nconns)
+{
+#if LWIP_TCP
+	struct netmem_walk_s walk;
+
+	walk.conns = conns;
+	walk.nconns = nconns;
+	walk.count = 0;
+
+#if LWIP_TCPIP_CORE_LOCKING
+	LOCK_TCPIP_CORE();
+	netmem_conns_walk(&walk);
+	UNLOCK_TCPIP_CORE();
+#else
+	if (sys_sem_new(&walk.done, 0) != ERR_OK) {
+		return -ENOMEM;
+	}
+
+	if (tcpip_callback(netmem_conns_walk, &walk) != ERR_OK) {
+		sys_sem_free(&walk.done);
+		return -EAGAIN;
+	}
+
+	sys_arch_sem_wait(&walk.done, 0);
+	sys_sem_free(&walk.done);
+#endif
+
+	return walk.count;
+#else
+	return 0;
+#endif							/* LWIP_TCP */
+}
+
+#endif							/* CONFIG_NET_MEMINFO */
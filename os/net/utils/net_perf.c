@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/utils/net_perf.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/net/netperf.h>
+
+#ifdef CONFIG_NET_PERF_STATS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netperf_stage_s g_netperf[NETPERF_NSTAGES];
+
+static FAR const char *const g_netperf_names[NETPERF_NSTAGES] = {
+	"driver_rx",
+	"tcpip_wait",
+	"tcp_input",
+	"socket_copy",
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void netperf_end(enum netperf_stage_e stage, uint32_t start)
+{
+	FAR struct netperf_stage_s *s = &g_netperf[stage];
+	uint32_t elapsed = up_perf_gettime() - start;
+	irqstate_t flags;
+
+	flags = irqsave();
+	s->count++;
+	s->total += elapsed;
+	if (elapsed > s->max) {
+		s->max = elapsed;
+	}
+	irqrestore(flags);
+}
+
+void netperf_snapshot(FAR struct netperf_stage_s *stats)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memcpy(stats, g_netperf, sizeof(g_netperf));
+	irqrestore(flags);
+}
+
+void netperf_reset(void)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memset(g_netperf, 0, sizeof(g_netperf));
+	irqrestore(flags);
+}
+
+FAR const char *netperf_name(enum netperf_stage_e stage)
+{
+	return g_netperf_names[stage];
+}
+
+#endif							/* CONFIG_NET_PERF_STATS */
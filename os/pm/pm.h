@@ -235,6 +235,12 @@ EXTERN struct pm_global_s g_pmglobals;
 
 void pm_update(int domain, int16_t accum);
 
+#ifdef CONFIG_PM_DVFS
+/* Start the CPU frequency scaling governor */
+
+void pm_dvfs_initialize(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,269 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * pm/pm_dvfs.c
+ *
+ * CPU frequency scaling governor.  A work item on the high priority work
+ * queue samples the CPU load and the PM activity once per time slice.  The
+ * CPU goes straight to the fastest operating point on a burst and steps
+ * down one point at a time once the load has stayed low, so short bursts
+ * get full speed and idle periods end up at the slowest point.  Transitions
+ * are spaced so that their latency stays within CONFIG_PM_DVFS_BUDGET.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/pm/pm.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM_DVFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_PM_DVFS_DOWN_THRESH >= CONFIG_PM_DVFS_UP_THRESH
+#error "CONFIG_PM_DVFS_DOWN_THRESH must be below CONFIG_PM_DVFS_UP_THRESH"
+#endif
+
+#if CONFIG_PM_DVFS_DOMAIN >= CONFIG_PM_NDOMAINS
+#error "CONFIG_PM_DVFS_DOMAIN is not a valid PM domain"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pm_dvfs_s {
+	struct work_s work;			/* Periodic governor work */
+	FAR const struct pm_dvfs_opp_s *opps;	/* Operating points, slowest first */
+	int nopps;					/* Number of operating points */
+	int level;					/* Current operating point */
+	int lowcnt;					/* Slices in a row below the down threshold */
+	systime_t stamp;			/* Time of the last transition */
+	systime_t holdoff;			/* Ticks after 'stamp' before the next one */
+	systime_t boost;			/* Start of the current boost */
+	systime_t boostlen;			/* Length of the current boost in ticks */
+#ifdef CONFIG_SCHED_CPULOAD
+	struct cpuload_s idle;		/* IDLE thread counts at the previous slice */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pm_dvfs_s g_pmdvfs;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_dvfs_load
+ *
+ * Description:
+ *   Return the CPU load in percent since the previous slice, from the time
+ *   the IDLE thread was not running.
+ *
+ ****************************************************************************/
+
+static int pm_dvfs_load(void)
+{
+#ifdef CONFIG_SCHED_CPULOAD
+	struct cpuload_s idle;
+	uint32_t total;
+	uint32_t active;
+
+	if (clock_cpuload(0, &idle) < 0) {
+		return 0;
+	}
+
+	/* The counts are halved from time to time; use the totals after that */
+
+	if (idle.total > g_pmdvfs.idle.total && idle.active >= g_pmdvfs.idle.active) {
+		total = idle.total - g_pmdvfs.idle.total;
+		active = idle.active - g_pmdvfs.idle.active;
+	} else {
+		total = idle.total;
+		active = idle.active;
+	}
+
+	g_pmdvfs.idle = idle;
+
+	if (total == 0 || active > total) {
+		return 0;
+	}
+
+	return 100 - (int)((100 * active) / total);
+#else
+	return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: pm_dvfs_setlevel
+ ****************************************************************************/
+
+static void pm_dvfs_setlevel(int level)
+{
+	FAR const struct pm_dvfs_opp_s *opps = g_pmdvfs.opps;
+	systime_t now = clock_systimer();
+	uint32_t latency;
+	int ret;
+
+	/* Keep the time spent switching within the budget */
+
+	if (now - g_pmdvfs.stamp < g_pmdvfs.holdoff) {
+		return;
+	}
+
+	ret = up_dvfs_setopp(level);
+	if (ret < 0) {
+		pmdbg("Cannot switch to %lu Hz: %d\n", (unsigned long)opps[level].freq, ret);
+		return;
+	}
+
+	latency = opps[level].latency > opps[g_pmdvfs.level].latency ? opps[level].latency : opps[g_pmdvfs.level].latency;
+	g_pmdvfs.stamp = now;
+	g_pmdvfs.holdoff = USEC2TICK((latency * 1000) / CONFIG_PM_DVFS_BUDGET);
+	g_pmdvfs.level = level;
+	g_pmdvfs.lowcnt = 0;
+}
+
+/****************************************************************************
+ * Name: pm_dvfs_worker
+ ****************************************************************************/
+
+static void pm_dvfs_worker(FAR void *arg)
+{
+	FAR struct pm_domain_s *pdom = &g_pmglobals.domain[CONFIG_PM_DVFS_DOMAIN];
+	int top = g_pmdvfs.nopps - 1;
+	int level = g_pmdvfs.level;
+	int load;
+
+	load = pm_dvfs_load();
+
+	if (clock_systimer() - g_pmdvfs.boost < g_pmdvfs.boostlen) {
+		/* An explicit boost is in effect */
+
+		level = top;
+	} else if (pdom->state != PM_NORMAL) {
+		/* The domain is going to sleep */
+
+		level = 0;
+	} else if (load >= CONFIG_PM_DVFS_UP_THRESH || pdom->accum >= CONFIG_PM_DVFS_ACTIVITY_THRESH) {
+		/* A burst: go straight to full speed */
+
+		level = top;
+		g_pmdvfs.lowcnt = 0;
+	} else if (load < CONFIG_PM_DVFS_DOWN_THRESH && level > 0) {
+		/* Step down once the load stayed low for long enough */
+
+		if (++g_pmdvfs.lowcnt >= CONFIG_PM_DVFS_DOWN_COUNT) {
+			level--;
+		}
+	} else {
+		g_pmdvfs.lowcnt = 0;
+	}
+
+	if (level != g_pmdvfs.level) {
+		pm_dvfs_setlevel(level);
+	}
+
+	(void)work_queue(HPWORK, &g_pmdvfs.work, pm_dvfs_worker, NULL, TIME_SLICE_TICKS);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_dvfs_initialize
+ *
+ * Description:
+ *   Get the operating points from the architecture and start the governor.
+ *   The system is assumed to run at the fastest point.
+ *
+ ****************************************************************************/
+
+void pm_dvfs_initialize(void)
+{
+	g_pmdvfs.nopps = up_dvfs_getopps(&g_pmdvfs.opps);
+	if (g_pmdvfs.nopps <= 0 || g_pmdvfs.opps == NULL) {
+		g_pmdvfs.nopps = 0;
+		return;
+	}
+
+	g_pmdvfs.level = g_pmdvfs.nopps - 1;
+	g_pmdvfs.stamp = clock_systimer();
+	(void)work_queue(HPWORK, &g_pmdvfs.work, pm_dvfs_worker, NULL, TIME_SLICE_TICKS);
+}
+
+/****************************************************************************
+ * Name: pm_dvfs_boost
+ *
+ * Description:
+ *   See include/tinyara/pm/pm.h
+ *
+ ****************************************************************************/
+
+void pm_dvfs_boost(int msec)
+{
+	if (g_pmdvfs.nopps == 0) {
+		return;
+	}
+
+	g_pmdvfs.boost = clock_systimer();
+	g_pmdvfs.boostlen = MSEC2TICK(msec);
+
+	/* Apply it now rather than at the end of the slice */
+
+	(void)work_cancel(HPWORK, &g_pmdvfs.work);
+	(void)work_queue(HPWORK, &g_pmdvfs.work, pm_dvfs_worker, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: pm_dvfs_getfreq
+ *
+ * Description:
+ *   See include/tinyara/pm/pm.h
+ *
+ ****************************************************************************/
+
+uint32_t pm_dvfs_getfreq(void)
+{
+	if (g_pmdvfs.nopps == 0) {
+		return 0;
+	}
+
+	return g_pmdvfs.opps[g_pmdvfs.level].freq;
+}
+
+#endif							/* CONFIG_PM_DVFS */
@@ -134,5 +134,13 @@ void pm_initialize(void)
 #endif
 	}
 	pmtest_init();
+
+#if defined(CONFIG_PM_METRICS) && defined(CONFIG_METRICS)
+	pm_metrics_register();
+#endif
+
+#ifdef CONFIG_PM_DVFS
+	pm_dvfs_initialize();
+#endif
 }
 #endif							/* CONFIG_PM */
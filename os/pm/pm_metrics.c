@@ -20,9 +20,25 @@
 #include <time.h>
 #include <queue.h>
 #include <debug.h>
+#include <tinyara/metrics.h>
 #include "pm_metrics.h"
 #include "pm.h"
 
+#ifdef CONFIG_METRICS
+static void pm_sample_metrics(FAR struct metric_s *metric);
+
+/* Seconds spent in each state by domain 0 over the last
+ * CONFIG_PM_METRICS_DURATION seconds, all set by the sample of the first.
+ */
+
+static struct metric_s g_pm_metrics[4] = {
+	METRIC_GAUGE_INITIALIZER("pm.normal", pm_sample_metrics),
+	METRIC_GAUGE_INITIALIZER("pm.idle", NULL),
+	METRIC_GAUGE_INITIALIZER("pm.standby", NULL),
+	METRIC_GAUGE_INITIALIZER("pm.sleep", NULL)
+};
+#endif
+
 time_t time_diff(time_t time1, time_t time2)
 {
 	if (time1 > time2) {
@@ -131,3 +147,25 @@ void pm_get_domainmetrics(int indx, struct pm_time_in_each_s *mtrics)
 	mtrics->standby = standby_time;
 	mtrics->sleep = sleep_time;
 }
+
+#ifdef CONFIG_METRICS
+static void pm_sample_metrics(FAR struct metric_s *metric)
+{
+	struct pm_time_in_each_s mtrics;
+
+	pm_get_domainmetrics(0, &mtrics);
+	metric_set(&g_pm_metrics[0], mtrics.normal);
+	metric_set(&g_pm_metrics[1], mtrics.idle);
+	metric_set(&g_pm_metrics[2], mtrics.standby);
+	metric_set(&g_pm_metrics[3], mtrics.sleep);
+}
+
+void pm_metrics_register(void)
+{
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		metrics_register(&g_pm_metrics[i]);
+	}
+}
+#endif
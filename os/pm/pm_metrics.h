@@ -41,6 +41,9 @@ extern struct pm_global_s g_pmglobals;
 
 void pm_get_domainmetrics(int indx, struct pm_time_in_each_s *mtrics);
 void pm_prune_history(sq_queue_t *q);
+#ifdef CONFIG_METRICS
+void pm_metrics_register(void);
+#endif
 #endif
 
 #endif
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ * sysbatch_submit() runs the system calls queued in a caller's submission
+ * ring through the same stub table as the SVC dispatcher, so a whole batch
+ * costs a single trap.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <sys/sysbatch.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL) && defined(__KERNEL__) && defined(CONFIG_SYSCALL_BATCH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every stub is called with the full parameter set, as dispatch_syscall()
+ * does; stubs that take fewer simply ignore the rest.
+ */
+
+typedef uintptr_t (*sysbatch_stub_t)(int nbr, uintptr_t parm1, uintptr_t parm2, uintptr_t parm3, uintptr_t parm4, uintptr_t parm5, uintptr_t parm6);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sysbatch_submit
+ *
+ * Description:
+ *   Run the queued submissions of a batch in order, posting a completion
+ *   for each, until the submission ring is empty, the completion ring is
+ *   full, or a call flagged SYSBATCH_F_STOP fails.
+ *
+ * Input Parameters:
+ *   batch - The caller's rings
+ *
+ * Returned Value:
+ *   The number of calls run, or ERROR with errno set to EINVAL.
+ *
+ ****************************************************************************/
+
+int sysbatch_submit(FAR struct sysbatch_s *batch)
+{
+	FAR struct sysbatch_sqe_s *sqe;
+	FAR struct sysbatch_cqe_s *cqe;
+	sysbatch_stub_t stub;
+	unsigned int index;
+	int count = 0;
+
+	if (!batch || !batch->sqes || !batch->cqes || (batch->mask & (batch->mask + 1)) != 0 || batch->sq_tail - batch->sq_head > batch->mask + 1) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	while (batch->sq_head != batch->sq_tail && batch->cq_tail - batch->cq_head <= batch->mask) {
+		sqe = &batch->sqes[batch->sq_head & batch->mask];
+		cqe = &batch->cqes[batch->cq_tail & batch->mask];
+		cqe->user_data = sqe->user_data;
+
+		index = (unsigned int)sqe->nbr - CONFIG_SYS_RESERVED;
+		if (sqe->nbr < CONFIG_SYS_RESERVED || index >= SYS_nsyscalls || sqe->nbr == SYS_sysbatch_submit) {
+			cqe->result = (uintptr_t)ERROR;
+			cqe->errcode = ENOSYS;
+		} else {
+			stub = (sysbatch_stub_t)g_stublookup[index];
+			cqe->result = stub(index, sqe->parm[0], sqe->parm[1], sqe->parm[2], sqe->parm[3], sqe->parm[4], sqe->parm[5]);
+			cqe->errcode = cqe->result == (uintptr_t)ERROR ? get_errno() : 0;
+		}
+
+		batch->sq_head++;
+		batch->cq_tail++;
+		count++;
+
+		if (cqe->errcode != 0 && (sqe->flags & SYSBATCH_F_STOP) != 0) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+#endif							/* CONFIG_LIB_SYSCALL && __KERNEL__ && CONFIG_SYSCALL_BATCH */
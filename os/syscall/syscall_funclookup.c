@@ -74,6 +74,7 @@
 #include <sys/prctl.h>
 #include <sys/socket.h>
 #include <sys/mount.h>
+#include <sys/sysbatch.h>
 
 #include <stdio.h>
 #include <stdlib.h>
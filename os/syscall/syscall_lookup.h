@@ -160,6 +160,9 @@ SYSCALL_LOOKUP(clock_getres,            2, STUB_clock_getres)
 SYSCALL_LOOKUP(clock_gettime,           2, STUB_clock_gettime)
 SYSCALL_LOOKUP(clock_settime,           2, STUB_clock_settime)
 SYSCALL_LOOKUP(gettimeofday,            2, STUB_gettimeofday)
+#ifdef CONFIG_CLOCK_TIMEPAGE
+SYSCALL_LOOKUP(clock_timepage,          0, STUB_clock_timepage)
+#endif
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -195,6 +198,15 @@ SYSCALL_LOOKUP(aio_cancel,              2, SYS_aio_cancel)
 #  ifndef CONFIG_DISABLE_POLL
 SYSCALL_LOOKUP(poll,                    3, STUB_poll)
 SYSCALL_LOOKUP(select,                  5, STUB_select)
+#    ifdef CONFIG_EPOLL
+SYSCALL_LOOKUP(epoll_create,            1, STUB_epoll_create)
+SYSCALL_LOOKUP(epoll_create1,           1, STUB_epoll_create1)
+SYSCALL_LOOKUP(epoll_ctl,               4, STUB_epoll_ctl)
+SYSCALL_LOOKUP(epoll_wait,              4, STUB_epoll_wait)
+#    endif
+#    ifdef CONFIG_EVENTFD
+SYSCALL_LOOKUP(eventfd,                 2, STUB_eventfd)
+#    endif
 #  endif
 #endif
 
@@ -207,7 +219,7 @@ SYSCALL_LOOKUP(dup2,                    2, STUB_dup2)
 SYSCALL_LOOKUP(fcntl,                   6, STUB_fcntl)
 SYSCALL_LOOKUP(lseek,                   3, STUB_lseek)
 SYSCALL_LOOKUP(mkfifo,                  2, STUB_mkfifo)
-SYSCALL_LOOKUP(mmap,                    6, NULL)
+SYSCALL_LOOKUP(mmap,                    6, STUB_mmap)
 SYSCALL_LOOKUP(open,                    6, STUB_open)
 SYSCALL_LOOKUP(opendir,                 1, STUB_opendir)
 SYSCALL_LOOKUP(pipe,                    1, STUB_pipe)
@@ -223,6 +235,11 @@ SYSCALL_LOOKUP(fdopen,                  3, STUB_fs_fdopen)
 SYSCALL_LOOKUP(sched_getstreams,        0, STUB_sched_getstreams)
 #  endif
 
+#  ifdef CONFIG_PIPE_SPLICE
+SYSCALL_LOOKUP(splice,                  6, STUB_splice)
+SYSCALL_LOOKUP(tee,                     4, STUB_tee)
+#  endif
+
 
 #  if !defined(CONFIG_DISABLE_MOUNTPOINT)
 SYSCALL_LOOKUP(fsync,                   1, STUB_fsync)
@@ -288,6 +305,8 @@ SYSCALL_LOOKUP(mq_setattr,              3, STUB_mq_setattr)
 SYSCALL_LOOKUP(mq_timedreceive,         5, STUB_mq_timedreceive)
 SYSCALL_LOOKUP(mq_timedsend,            5, STUB_mq_timedsend)
 SYSCALL_LOOKUP(mq_unlink,               1, STUB_mq_unlink)
+SYSCALL_LOOKUP(mq_refalloc,             1, STUB_mq_refalloc)
+SYSCALL_LOOKUP(mq_reffree,              1, STUB_mq_reffree)
 #endif
 
 /* The following are defined only if environment variables are supported */
@@ -323,6 +342,12 @@ SYSCALL_LOOKUP(socket,                  3, STUB_socket)
 SYSCALL_LOOKUP(prctl,                   5, STUB_prctl)
 #endif
 
+/* The following is defined only if batched system calls are supported */
+
+#ifdef CONFIG_SYSCALL_BATCH
+SYSCALL_LOOKUP(sysbatch_submit,         1, STUB_sysbatch_submit)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
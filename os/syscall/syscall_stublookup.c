@@ -163,6 +163,7 @@ uintptr_t STUB_clock_getres(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_clock_gettime(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_clock_settime(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_gettimeofday(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_clock_timepage(int nbr);
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -198,6 +199,13 @@ uintptr_t STUB_poll(int nbr, uintptr_t parm1, uintptr_t parm2,
 					uintptr_t parm3);
 uintptr_t STUB_select(int nbr, uintptr_t parm1, uintptr_t parm2,
 					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
+uintptr_t STUB_epoll_create(int nbr, uintptr_t parm1);
+uintptr_t STUB_epoll_create1(int nbr, uintptr_t parm1);
+uintptr_t STUB_epoll_ctl(int nbr, uintptr_t parm1, uintptr_t parm2,
+						 uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_epoll_wait(int nbr, uintptr_t parm1, uintptr_t parm2,
+						  uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_eventfd(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 uintptr_t STUB_aio_read(int nbr, uintptr_t parm1);
 uintptr_t STUB_aio_write(int nbr, uintptr_t parm1);
@@ -234,6 +242,12 @@ uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
 						 uintptr_t parm3);
 uintptr_t STUB_sched_getstreams(int nbr);
 
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+					  uintptr_t parm6);
+uintptr_t STUB_tee(int nbr, uintptr_t parm1, uintptr_t parm2,
+				   uintptr_t parm3, uintptr_t parm4);
+
 ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
 
 uintptr_t STUB_fsync(int nbr, uintptr_t parm1);
@@ -312,6 +326,8 @@ uintptr_t STUB_mq_timedreceive(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_mq_timedsend(int nbr, uintptr_t parm1, uintptr_t parm2,
 							uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_mq_unlink(int nbr, uintptr_t parm1);
+uintptr_t STUB_mq_refalloc(int nbr, uintptr_t parm1);
+uintptr_t STUB_mq_reffree(int nbr, uintptr_t parm1);
 
 /* The following are defined only if environment variables are supported */
 
@@ -354,6 +370,10 @@ uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_prctl(int nbr, uintptr_t parm1, uintptr_t parm2,
 					 uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 
+/* The following is defined only if batched system calls are supported */
+
+uintptr_t STUB_sysbatch_submit(int nbr, uintptr_t parm1);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,538 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/mkcromfs.c
+ *
+ * Build a CROMFS image of a directory tree.  The layout is described in
+ * fs/cromfs/fs_cromfs.h: the volume header, then all nodes in depth-first
+ * order, then the block table and blocks of each file.  Blocks are
+ * compressed with a greedy LZ4 compressor and kept as is when that does
+ * not make them smaller.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CROMFS_VHDR_LEN       32
+#define CROMFS_NODE_NAME      16
+#define CROMFS_MODE_DIRECTORY 1
+#define CROMFS_MODE_FILE      2
+#define CROMFS_MODE_EXEC      8
+#define CROMFS_MAX_BSIZE      65536
+
+#define DEFAULT_BSIZE         4096
+
+#define LZ4_MINMATCH          4
+#define LZ4_LASTLITERALS      5
+#define LZ4_MFLIMIT           12
+#define LZ4_MAXDISTANCE       65535
+#define LZ4_HASHBITS          12
+
+#define ALIGN4(n)             (((n) + 3) & ~3)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct node_s {
+	struct node_s *child;
+	struct node_s *peer;
+	char *path;
+	char *name;
+	uint32_t offset;
+	uint32_t size;
+	uint16_t mode;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t *g_image;
+static uint32_t g_imagesize;
+static uint32_t g_alloc;
+static uint32_t g_bsize = DEFAULT_BSIZE;
+static uint32_t g_nnodes;
+static uint32_t g_nblocks;
+static uint32_t g_usize;
+static uint32_t g_ncompressed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(const char *progname, int exitcode)
+{
+	fprintf(stderr, "USAGE: %s [-b <block-size>] <dir> <image>\n", progname);
+	fprintf(stderr, "\nWhere:\n");
+	fprintf(stderr, "  <block-size>: Uncompressed size of a data block (default %d)\n", DEFAULT_BSIZE);
+	fprintf(stderr, "  <dir>:        The directory tree to put in the image\n");
+	fprintf(stderr, "  <image>:      The image file to create\n");
+	exit(exitcode);
+}
+
+static void *xmalloc(size_t size)
+{
+	void *ptr = malloc(size);
+	if (!ptr) {
+		fprintf(stderr, "ERROR: Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ptr;
+}
+
+static char *xstrdup(const char *str)
+{
+	return strcpy(xmalloc(strlen(str) + 1), str);
+}
+
+/* Image buffer */
+
+static void reserve(uint32_t size)
+{
+	if (g_imagesize + size > g_alloc) {
+		while (g_imagesize + size > g_alloc) {
+			g_alloc = g_alloc ? 2 * g_alloc : 65536;
+		}
+
+		g_image = realloc(g_image, g_alloc);
+		if (!g_image) {
+			fprintf(stderr, "ERROR: Out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+static void put16(uint32_t offset, uint16_t value)
+{
+	g_image[offset] = value & 0xff;
+	g_image[offset + 1] = value >> 8;
+}
+
+static void put32(uint32_t offset, uint32_t value)
+{
+	put16(offset, value & 0xffff);
+	put16(offset + 2, value >> 16);
+}
+
+/* LZ4 block compression */
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t lz4_hash(uint32_t value)
+{
+	return (value * 2654435761u) >> (32 - LZ4_HASHBITS);
+}
+
+static bool lz4_putlength(uint8_t **pop, uint8_t *oend, uint32_t len)
+{
+	uint8_t *op = *pop;
+
+	while (len >= 255) {
+		if (op >= oend) {
+			return false;
+		}
+
+		*op++ = 255;
+		len -= 255;
+	}
+
+	if (op >= oend) {
+		return false;
+	}
+
+	*op++ = len;
+	*pop = op;
+	return true;
+}
+
+static bool lz4_sequence(uint8_t **pop, uint8_t *oend, const uint8_t *literals, uint32_t nliterals, uint32_t offset, uint32_t mlen)
+{
+	uint8_t *op = *pop;
+	uint8_t *token;
+
+	if (op >= oend) {
+		return false;
+	}
+
+	token = op++;
+	*token = (nliterals >= 15 ? 15 : nliterals) << 4;
+	if (nliterals >= 15 && !lz4_putlength(&op, oend, nliterals - 15)) {
+		return false;
+	}
+
+	if (nliterals > (uint32_t)(oend - op)) {
+		return false;
+	}
+
+	memcpy(op, literals, nliterals);
+	op += nliterals;
+
+	if (mlen > 0) {
+		if (oend - op < 2) {
+			return false;
+		}
+
+		*op++ = offset & 0xff;
+		*op++ = offset >> 8;
+
+		mlen -= LZ4_MINMATCH;
+		*token |= mlen >= 15 ? 15 : mlen;
+		if (mlen >= 15 && !lz4_putlength(&op, oend, mlen - 15)) {
+			return false;
+		}
+	}
+
+	*pop = op;
+	return true;
+}
+
+/* Return the compressed size, or 0 if the block does not get smaller */
+
+static uint32_t lz4_compress(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+	uint32_t table[1 << LZ4_HASHBITS];
+	uint8_t *op = dst;
+	uint8_t *oend = dst + len - 1;
+	uint32_t anchor = 0;
+	uint32_t ip = 0;
+	uint32_t ref;
+	uint32_t mlen;
+	uint32_t h;
+
+	memset(table, 0, sizeof(table));
+
+	while (len >= LZ4_MFLIMIT && ip + LZ4_MFLIMIT < len) {
+		h = lz4_hash(read32(&src[ip]));
+		ref = table[h];
+		table[h] = ip + 1;
+
+		if (ref == 0 || ip - (ref - 1) > LZ4_MAXDISTANCE || read32(&src[ref - 1]) != read32(&src[ip])) {
+			ip++;
+			continue;
+		}
+
+		ref--;
+
+		/* Extend the match forward, then backward over pending literals */
+
+		mlen = LZ4_MINMATCH;
+		while (ip + mlen < len - LZ4_LASTLITERALS && src[ref + mlen] == src[ip + mlen]) {
+			mlen++;
+		}
+
+		while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+			ip--;
+			ref--;
+			mlen++;
+		}
+
+		if (!lz4_sequence(&op, oend, &src[anchor], ip - anchor, ip - ref, mlen)) {
+			return 0;
+		}
+
+		ip += mlen;
+		anchor = ip;
+	}
+
+	if (!lz4_sequence(&op, oend, &src[anchor], len - anchor, 0, 0)) {
+		return 0;
+	}
+
+	return op - dst;
+}
+
+/* Directory tree */
+
+static struct node_s *scan(const char *path, const char *name)
+{
+	struct node_s *node;
+	struct node_s **pprev;
+	struct node_s *child;
+	struct dirent *entry;
+	struct stat buf;
+	char *childpath;
+	DIR *dir;
+
+	if (stat(path, &buf) < 0) {
+		fprintf(stderr, "ERROR: stat(%s) failed: %s\n", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	if (strlen(name) > 0xffff) {
+		fprintf(stderr, "ERROR: Name too long: %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	node = xmalloc(sizeof(struct node_s));
+	memset(node, 0, sizeof(struct node_s));
+	node->path = xstrdup(path);
+	node->name = xstrdup(name);
+
+	if (S_ISREG(buf.st_mode)) {
+		if ((uint64_t)buf.st_size > UINT32_MAX) {
+			fprintf(stderr, "ERROR: File too large: %s\n", path);
+			exit(EXIT_FAILURE);
+		}
+
+		node->mode = CROMFS_MODE_FILE;
+		node->size = buf.st_size;
+	} else if (S_ISDIR(buf.st_mode)) {
+		node->mode = CROMFS_MODE_DIRECTORY;
+
+		dir = opendir(path);
+		if (!dir) {
+			fprintf(stderr, "ERROR: opendir(%s) failed: %s\n", path, strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		while ((entry = readdir(dir)) != NULL) {
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+				continue;
+			}
+
+			childpath = xmalloc(strlen(path) + strlen(entry->d_name) + 2);
+			sprintf(childpath, "%s/%s", path, entry->d_name);
+			child = scan(childpath, entry->d_name);
+			free(childpath);
+
+			if (!child) {
+				continue;
+			}
+
+			/* Keep the entries sorted so that images are reproducible */
+
+			for (pprev = &node->child; *pprev && strcmp((*pprev)->name, child->name) < 0; pprev = &(*pprev)->peer) ;
+			child->peer = *pprev;
+			*pprev = child;
+		}
+
+		closedir(dir);
+	} else {
+		fprintf(stderr, "WARNING: Skipping %s: not a file or directory\n", path);
+		free(node->path);
+		free(node->name);
+		free(node);
+		return NULL;
+	}
+
+	if ((buf.st_mode & S_IXUSR) != 0) {
+		node->mode |= CROMFS_MODE_EXEC;
+	}
+
+	return node;
+}
+
+static void layout_nodes(struct node_s *node)
+{
+	for (; node; node = node->peer) {
+		node->offset = g_imagesize;
+		g_imagesize += CROMFS_NODE_NAME + ALIGN4(strlen(node->name) + 1);
+		g_nnodes++;
+
+		if (node->child) {
+			layout_nodes(node->child);
+		}
+	}
+}
+
+static void write_data(struct node_s *node, uint8_t *ubuffer, uint8_t *cbuffer)
+{
+	uint32_t nblocks;
+	uint32_t table;
+	uint32_t ulen;
+	uint32_t clen;
+	uint32_t i;
+	FILE *stream;
+
+	for (; node; node = node->peer) {
+		if (node->child) {
+			write_data(node->child, ubuffer, cbuffer);
+		}
+
+		if ((node->mode & CROMFS_MODE_FILE) == 0) {
+			continue;
+		}
+
+		stream = fopen(node->path, "rb");
+		if (!stream) {
+			fprintf(stderr, "ERROR: fopen(%s) failed: %s\n", node->path, strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+
+		nblocks = (node->size + g_bsize - 1) / g_bsize;
+		reserve((nblocks + 1) * 4);
+		table = g_imagesize;
+		g_imagesize += (nblocks + 1) * 4;
+
+		for (i = 0; i < nblocks; i++) {
+			ulen = node->size - i * g_bsize;
+			if (ulen > g_bsize) {
+				ulen = g_bsize;
+			}
+
+			if (fread(ubuffer, 1, ulen, stream) != ulen) {
+				fprintf(stderr, "ERROR: Failed to read %s\n", node->path);
+				exit(EXIT_FAILURE);
+			}
+
+			clen = lz4_compress(ubuffer, ulen, cbuffer);
+			reserve(clen ? clen : ulen);
+			put32(table + 4 * i, g_imagesize);
+			if (clen) {
+				memcpy(&g_image[g_imagesize], cbuffer, clen);
+				g_imagesize += clen;
+				g_ncompressed++;
+			} else {
+				memcpy(&g_image[g_imagesize], ubuffer, ulen);
+				g_imagesize += ulen;
+			}
+		}
+
+		put32(table + 4 * nblocks, g_imagesize);
+		fclose(stream);
+
+		g_nblocks += nblocks;
+		g_usize += node->size;
+
+		/* The node points to the block table */
+
+		put32(node->offset + 4, table);
+	}
+}
+
+static void write_nodes(struct node_s *node)
+{
+	uint32_t namelen;
+
+	for (; node; node = node->peer) {
+		namelen = strlen(node->name);
+		put32(node->offset + 0, node->peer ? node->peer->offset : 0);
+		if ((node->mode & CROMFS_MODE_DIRECTORY) != 0) {
+			put32(node->offset + 4, node->child ? node->child->offset : 0);
+		}
+
+		put32(node->offset + 8, node->size);
+		put16(node->offset + 12, node->mode);
+		put16(node->offset + 14, namelen);
+		memset(&g_image[node->offset + CROMFS_NODE_NAME], 0, ALIGN4(namelen + 1));
+		memcpy(&g_image[node->offset + CROMFS_NODE_NAME], node->name, namelen);
+
+		if (node->child) {
+			write_nodes(node->child);
+		}
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	struct node_s *root;
+	uint8_t *ubuffer;
+	uint8_t *cbuffer;
+	FILE *stream;
+	char *endptr;
+	int ch;
+
+	while ((ch = getopt(argc, argv, ":b:h")) > 0) {
+		switch (ch) {
+		case 'b':
+			g_bsize = strtoul(optarg, &endptr, 0);
+			if (*endptr != '\0' || g_bsize < 64 || g_bsize > CROMFS_MAX_BSIZE) {
+				fprintf(stderr, "ERROR: Block size must be 64..%d\n", CROMFS_MAX_BSIZE);
+				show_usage(argv[0], EXIT_FAILURE);
+			}
+			break;
+
+		case 'h':
+			show_usage(argv[0], EXIT_SUCCESS);
+
+		default:
+			show_usage(argv[0], EXIT_FAILURE);
+		}
+	}
+
+	if (optind + 2 != argc) {
+		show_usage(argv[0], EXIT_FAILURE);
+	}
+
+	root = scan(argv[optind], "");
+	if (!root || (root->mode & CROMFS_MODE_DIRECTORY) == 0) {
+		fprintf(stderr, "ERROR: %s is not a directory\n", argv[optind]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Nodes first, so that path lookups stay within the start of the image */
+
+	g_imagesize = CROMFS_VHDR_LEN;
+	layout_nodes(root);
+	reserve(0);
+	memset(g_image, 0, g_imagesize);
+
+	ubuffer = xmalloc(g_bsize);
+	cbuffer = xmalloc(g_bsize);
+	write_data(root, ubuffer, cbuffer);
+	write_nodes(root);
+
+	memcpy(&g_image[0], "-cromfs-", 8);
+	put32(8, g_imagesize);
+	put32(12, root->offset);
+	put32(16, g_bsize);
+	put32(20, g_nnodes);
+	put32(24, g_nblocks);
+	put32(28, g_usize);
+
+	stream = fopen(argv[optind + 1], "wb");
+	if (!stream) {
+		fprintf(stderr, "ERROR: fopen(%s) failed: %s\n", argv[optind + 1], strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	if (fwrite(g_image, 1, g_imagesize, stream) != g_imagesize) {
+		fprintf(stderr, "ERROR: Failed to write %s\n", argv[optind + 1]);
+		exit(EXIT_FAILURE);
+	}
+
+	fclose(stream);
+	printf("%u nodes, %u bytes in %u blocks (%u compressed) -> %u byte image\n", g_nnodes, g_usize, g_nblocks, g_ncompressed, g_imagesize);
+	return 0;
+}